@@ -56,7 +56,7 @@ check_dependencies() {
     fi
     
     # Check for required libraries via pkg-config
-    local required_libs=("sdl2" "sqlite3" "yaml-cpp" "libprojectM-4" "glm" "imgui" "taglib" "libcurl")
+    local required_libs=("sdl2" "sqlite3" "yaml-cpp" "libprojectM-4" "glm" "imgui" "taglib" "libmpg123" "libcurl")
     
     for lib in "${required_libs[@]}"; do
         if ! pkg-config --exists "$lib" 2>/dev/null; then
@@ -1,31 +1,76 @@
 #include "audio_capture.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
 #include "autovibez_app.hpp"
+#include "beat_tracker.hpp"
+#include "console_output.hpp"
+#include "device_format.hpp"
+#include "latency_model.hpp"
+#include "pcm_ingest.hpp"
+#include "pcm_ring_buffer.hpp"
+#include "realtime_guard.hpp"
+#include "task_executor.hpp"
 #include "utils/logger.hpp"
 using AutoVibez::Core::AutoVibezApp;
+using AutoVibez::Utils::TaskExecutor;
+using AutoVibez::Utils::TaskPriority;
+
+namespace {
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
 
 namespace AutoVibez::Audio {
 
 void audioInputCallbackF32(void* userData, const float* buffer, int len) {
+    AUTOVIBEZ_REALTIME_SCOPE();
     AutoVibezApp* app = static_cast<AutoVibezApp*>(userData);
+    PcmRingBuffer& ring = app->getPcmRingBuffer();
+    BeatTracker& beats = app->getBeatTracker();
 
-    // stream contains float data in native byte order, len is in bytes
-    // Convert to float pointer safely
-    const float* floatStream = static_cast<const float*>(buffer);
-    int numSamples = len / sizeof(float) / app->getAudioChannelsCount();  // Use getter method
-
-    if (app->getAudioChannelsCount() == 1) {
-        // const_cast is necessary because projectM API expects non-const pointer
-        // but SDL provides const data. This is safe as projectM only reads the data.
-        projectm_pcm_add_float(app->getProjectM(), const_cast<float*>(floatStream), numSamples, PROJECTM_MONO);
-    } else if (app->getAudioChannelsCount() == 2) {
-        // const_cast is necessary because projectM API expects non-const pointer
-        // but SDL provides const data. This is safe as projectM only reads the data.
-        projectm_pcm_add_float(app->getProjectM(), const_cast<float*>(floatStream), numSamples, PROJECTM_STEREO);
-    } else {
-        ::AutoVibez::Utils::Logger logger;
-        logger.logError("Multichannel audio not supported");
-        SDL_Quit();
+    // The layout was fixed when the device opened; len is in bytes
+    const PcmIngest& ingest = app->getPcmIngest();
+    if (!ingest.isConfigured()) {
+        return;
+    }
+
+    // Only copy here; the render loop hands the samples to projectM before each frame
+    ingest.process(buffer, len / static_cast<int>(ingest.getFrameBytes()), ring, &beats);
+}
+
+void mixOutputCallbackS16(void* userData, const int16_t* samples, int frames, int channels) {
+    AUTOVIBEZ_REALTIME_SCOPE();
+    AutoVibezApp* app = static_cast<AutoVibezApp*>(userData);
+
+    // Only forward while the internal source is selected; otherwise a capture device owns the input
+    if (!app || !app->isInternalAudioActive() || frames <= 0 || (channels != 1 && channels != 2)) {
+        return;
+    }
+
+    PcmRingBuffer& ring = app->getPcmRingBuffer();
+    float converted[Constants::PCM_CONVERT_CHUNK_SAMPLES];
+    const int framesPerChunk = Constants::PCM_CONVERT_CHUNK_SAMPLES / 2;
+    constexpr float scale = 1.0f / 32768.0f;
+
+    for (int offset = 0; offset < frames; offset += framesPerChunk) {
+        int chunkFrames = std::min(framesPerChunk, frames - offset);
+        for (int i = 0; i < chunkFrames; ++i) {
+            if (channels == 1) {
+                float value = samples[offset + i] * scale;
+                converted[2 * i] = value;
+                converted[2 * i + 1] = value;
+            } else {
+                converted[2 * i] = samples[2 * (offset + i)] * scale;
+                converted[2 * i + 1] = samples[2 * (offset + i) + 1] * scale;
+            }
+        }
+        ring.write(converted, static_cast<size_t>(chunkFrames) * 2);
+        app->getBeatTracker().process(converted, chunkFrames);
     }
 }
 
@@ -46,8 +91,46 @@ int AutoVibezApp::initializeAudioInput() {
     SDL_SetHint(SDL_HINT_AUDIO_INCLUDE_MONITORS, "1");
 #endif
 
-    // Get number of audio devices
-    _numAudioDevices = SDL_GetNumAudioDevices(SDL_TRUE);
+    // The device list is cached and only re-enumerated on hotplug events
+    if (!_audioDevices.isPopulated()) {
+        _audioDevices.refresh();
+    }
+
+    // A synthetic source stands in for all devices so benchmark runs hear the same input everywhere
+    if (!_syntheticAudioSpec.empty()) {
+        ::AutoVibez::Utils::Logger logger;
+        std::string error;
+        _syntheticCapture.stop();
+        auto source = AutoVibez::Audio::SyntheticCapture::createSource(_syntheticAudioSpec,
+                                                                       Constants::DEFAULT_SAMPLE_RATE, error);
+        _audioChannelsCount = 2;
+        _pcmIngest.configure(2, AutoVibez::Audio::PcmSampleFormat::Float32);
+        setCaptureSampleRate(Constants::DEFAULT_SAMPLE_RATE);
+        if (source && _syntheticCapture.start(&AutoVibez::Audio::audioInputCallbackF32, this, std::move(source),
+                                              _syntheticAudioSpeed)) {
+            logger.logInfo("Using synthetic audio input: " + _syntheticAudioSpec);
+            return 1;
+        }
+        logger.logWarning("Synthetic audio unavailable (" +
+                          (error.empty() ? _syntheticCapture.getLastError() : error) + "), using capture devices");
+    }
+
+    // Attach straight to the default sink monitor when selected; SDL capture is the fallback
+    if (_nativeMonitorSelected && AutoVibez::Audio::MonitorCapture::isAvailable()) {
+        ::AutoVibez::Utils::Logger logger;
+        _monitorCapture.stop();
+        _audioChannelsCount = 2;  // The native backends always deliver interleaved stereo float
+        _pcmIngest.configure(2, AutoVibez::Audio::PcmSampleFormat::Float32);
+        const int monitorRate = getPlaybackSampleRate();  // The monitor runs at the sink's rate
+        setCaptureSampleRate(monitorRate);
+        if (_monitorCapture.start(&AutoVibez::Audio::audioInputCallbackF32, this, monitorRate)) {
+            logger.logInfo("Capturing default sink monitor via " + _monitorCapture.getBackendName());
+            return 1;
+        }
+        logger.logWarning("Native monitor capture unavailable (" + _monitorCapture.getLastError() +
+                          "), falling back to SDL capture");
+        _nativeMonitorSelected = false;
+    }
 
     // Set up audio format - use AUDIO_F32 like the original
     SDL_zero(desired);
@@ -56,27 +139,46 @@ int AutoVibezApp::initializeAudioInput() {
     desired.channels = Constants::DEFAULT_CHANNELS;
     desired.samples = Constants::DEFAULT_SAMPLES;
     desired.callback = [](void* userdata, unsigned char* stream, int len) {
-        // Convert to float and call our callback
+        AUTOVIBEZ_REALTIME_SCOPE();
+        // Time the callback for the period controller, then convert to float and call our callback
+        AutoVibezApp* app = static_cast<AutoVibezApp*>(userdata);
+        const int channels = std::max<int>(1, app->getAudioChannelsCount());
+        app->_captureBuffer.onCallback(len / static_cast<int>(sizeof(float)) / channels, steadyNanos());
         const float* floatStream = static_cast<const float*>(static_cast<const void*>(stream));
         AutoVibez::Audio::audioInputCallbackF32(userdata, floatStream, len);
     };
     desired.userdata = this;
 
-    // Open audio device - handle -1 for default device like the original
-    const char* deviceName = nullptr;
-    if (_selectedAudioDeviceIndex >= 0 && _selectedAudioDeviceIndex < _numAudioDevices) {
-        deviceName = SDL_GetAudioDeviceName(_selectedAudioDeviceIndex, SDL_TRUE);
-        if (!deviceName) {
-            // Device name is null, fallback to default device
-            ::AutoVibez::Utils::Logger logger;
-            logger.logWarning("Device name is null for index " + std::to_string(_selectedAudioDeviceIndex) +
-                              ", falling back to default device");
-            deviceName = nullptr;
-            _selectedAudioDeviceIndex = -1;
+    // Open the preferred device by name (indices shift on hotplug); -1 is SDL's default device
+    if (_preferredAudioDeviceName.empty() && _selectedAudioDeviceIndex >= 0) {
+        _preferredAudioDeviceName = _audioDevices.getDeviceName(_selectedAudioDeviceIndex);
+    }
+    _selectedAudioDeviceIndex = _audioDevices.findByName(_preferredAudioDeviceName);
+    if (!_preferredAudioDeviceName.empty() && _selectedAudioDeviceIndex < 0) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logWarning("Audio device \"" + _preferredAudioDeviceName +
+                          "\" is not connected, using the default device until it returns");
+    }
+    const char* deviceName = _selectedAudioDeviceIndex >= 0 ? _preferredAudioDeviceName.c_str() : nullptr;
+
+    // Open at the device's own rate and period when allowed, so neither SDL nor the sound server resamples
+    int openFlags = SDL_AUDIO_ALLOW_CHANNELS_CHANGE;
+    if (_nativeSampleRate) {
+        AutoVibez::Audio::DeviceFormat native;
+        AutoVibez::Audio::queryDeviceFormat(deviceName, true, native);
+        desired.freq = AutoVibez::Audio::chooseSampleRate(native, Constants::DEFAULT_SAMPLE_RATE);
+        if (native.period_frames > 0 && native.period_frames <= Constants::MAX_NATIVE_PERIOD_FRAMES) {
+            desired.samples = static_cast<Uint16>(native.period_frames);
         }
+        openFlags |= SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE;
+    }
+    if (_captureBuffer.isEnabled()) {
+        // The adaptive controller owns the period; SDL may still grant something else
+        desired.samples = static_cast<Uint16>(_captureBuffer.getRequestedPeriod());
+        openFlags |= SDL_AUDIO_ALLOW_SAMPLES_CHANGE;
     }
 
-    _audioDeviceId = SDL_OpenAudioDevice(deviceName, SDL_TRUE, &desired, &obtained, SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+    _audioDeviceId = SDL_OpenAudioDevice(deviceName, SDL_TRUE, &desired, &obtained, openFlags);
     if (_audioDeviceId == 0) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError("Failed to open audio device: " + std::string(SDL_GetError()));
@@ -85,8 +187,7 @@ int AutoVibezApp::initializeAudioInput() {
         if (deviceName != nullptr) {
             logger.logInfo("Trying fallback to default audio device");
             _selectedAudioDeviceIndex = -1;
-            _audioDeviceId =
-                SDL_OpenAudioDevice(nullptr, SDL_TRUE, &desired, &obtained, SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+            _audioDeviceId = SDL_OpenAudioDevice(nullptr, SDL_TRUE, &desired, &obtained, openFlags);
             if (_audioDeviceId == 0) {
                 logger.logError("Failed to open default audio device: " + std::string(SDL_GetError()));
                 return 0;
@@ -97,11 +198,240 @@ int AutoVibezApp::initializeAudioInput() {
     }
 
     _audioChannelsCount = obtained.channels;
+    setCaptureSampleRate(obtained.freq);  // The device opens paused, so no callback is running yet
+    _captureBuffer.configure(obtained.samples, obtained.freq, steadyNanos());
+
+    // Pick the ingest kernel and downmix matrix here so the callback never has to; SDL converts to float
+    if (!_pcmIngest.configure(_audioChannelsCount, AutoVibez::Audio::PcmSampleFormat::Float32, _downmixWeights)) {
+        ::AutoVibez::Utils::Logger logger;
+        if (_pcmIngest.isConfigured()) {
+            logger.logWarning("Invalid downmix_weights for " + std::to_string(_audioChannelsCount) +
+                              " channels; using the default fold");
+        } else {
+            logger.logWarning("Unsupported capture channel count " + std::to_string(_audioChannelsCount) +
+                              "; input will be ignored");
+        }
+    }
 
     return 1;
 }
 
+void AutoVibezApp::setCaptureSampleRate(int rate) {
+    _captureSampleRate = rate > 0 ? rate : Constants::DEFAULT_SAMPLE_RATE;
+    _beatTracker.reset(_captureSampleRate);
+}
+
+int AutoVibezApp::getPlaybackSampleRate() const {
+    if (!_nativeSampleRate) {
+        return Constants::DEFAULT_SAMPLE_RATE;
+    }
+    AutoVibez::Audio::DeviceFormat native;
+    AutoVibez::Audio::queryDeviceFormat(nullptr, false, native);
+    return AutoVibez::Audio::chooseSampleRate(native, Constants::DEFAULT_SAMPLE_RATE);
+}
+
+void AutoVibezApp::handleAudioDeviceEvent(const SDL_Event& evt) {
+    if (!evt.adevice.iscapture) {
+        return;
+    }
+    _audioDevices.refresh();
+
+    // The worker owns the device while it reopens; look again once it is done
+    if (_audioReconnecting.load(std::memory_order_acquire)) {
+        _audioReconnectPending = true;
+        return;
+    }
+
+    const bool onSdlCapture = _audioDeviceId != 0;
+    const bool waitingForDevice = !onSdlCapture && !wasapi && !_internalAudioActive.load() &&
+                                  !_syntheticCapture.isRunning() && !_monitorCapture.isRunning();
+    const bool lost = evt.type == SDL_AUDIODEVICEREMOVED && onSdlCapture && evt.adevice.which == _audioDeviceId;
+    const bool preferredReturned = evt.type == SDL_AUDIODEVICEADDED && onSdlCapture &&
+                                   _selectedAudioDeviceIndex < 0 &&
+                                   _audioDevices.findByName(_preferredAudioDeviceName) >= 0;
+    const bool firstDevice = evt.type == SDL_AUDIODEVICEADDED && waitingForDevice;
+    if (lost || preferredReturned || firstDevice) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logInfo(lost ? "Capture device removed, reconnecting" : "Capture device added, reconnecting");
+        scheduleAudioReconnect();
+    }
+}
+
+void AutoVibezApp::scheduleAudioReconnect() {
+    if (_audioReconnecting.load(std::memory_order_acquire)) {
+        _audioReconnectPending = true;
+        return;
+    }
+    if (_audioReconnectTask.valid()) {
+        _audioReconnectTask.get();
+    }
+    _audioReconnectPending = false;
+    _audioReconnecting.store(true, std::memory_order_release);
+
+    // Closing and opening devices can block for a while; the render loop feeds silence meanwhile
+    _audioReconnectTask = TaskExecutor::shared().submit(TaskPriority::Interactive, [this]() {
+        endAudioCapture();
+        if (!_internalAudioActive.load() && initializeAudioInput()) {
+            beginAudioCapture();
+        }
+        _audioReconnecting.store(false, std::memory_order_release);
+    });
+}
+
+void AutoVibezApp::updateCaptureBuffer() {
+    if (_audioDeviceId == 0 || _audioReconnecting.load(std::memory_order_acquire)) {
+        return;
+    }
+    const int period = _captureBuffer.evaluate(steadyNanos());
+    if (period > 0) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logInfo("Reopening capture with a " + std::to_string(period) + "-frame period");
+        _captureBuffer.noteReopen();
+        scheduleAudioReconnect();
+    }
+}
+
+std::string AutoVibezApp::getCaptureStatsText() const {
+    if (_audioDeviceId == 0 || _audioReconnecting.load(std::memory_order_acquire)) {
+        return "";
+    }
+    const AutoVibez::Audio::CaptureStats stats = _captureBuffer.getStats(
+        _pcmRingBuffer.available(), _pcmRingBuffer.getUnderrunCount(), _pcmRingBuffer.getOverflowCount());
+    char text[160];
+    std::snprintf(text, sizeof(text), "%d frames @ %d Hz, %.1f ms, jitter %.1f ms, %llu xruns, %llu/%llu under/over",
+                  stats.period_frames, stats.sample_rate, stats.latency_ms, stats.jitter_ms,
+                  static_cast<unsigned long long>(stats.xruns), static_cast<unsigned long long>(stats.underruns),
+                  static_cast<unsigned long long>(stats.overflows));
+    return text;
+}
+
+void AutoVibezApp::setLatencyCompensation(bool enabled, int displayQueueFrames, double offsetMs) {
+    _latencyCompensation = enabled;
+    _latency.setDisplayQueueFrames(displayQueueFrames);
+    _latency.setManualOffsetMs(offsetMs);
+}
+
+void AutoVibezApp::toggleLatencyCalibration() {
+    _latencyCalibration = !_latencyCalibration;
+    _calibrationClicks.reset();
+    const bool clicks = _latencyCalibration;
+    _mixControl.post([this, clicks]() {
+        if (_mixManagerInitialized) {
+            _mixManager->setCalibrationClicks(clicks);
+        }
+    });
+    if (_latencyCalibration) {
+        AutoVibez::Utils::ConsoleOutput::info("Latency calibration: use , and . until the flashes land on the clicks");
+    } else {
+        AutoVibez::Utils::ConsoleOutput::info("Latency calibration off, keep av_offset_ms = " +
+                                              std::to_string(static_cast<int>(_latency.getManualOffsetMs())));
+    }
+}
+
+void AutoVibezApp::adjustAvOffset(double deltaMs) {
+    _latency.setManualOffsetMs(_latency.getManualOffsetMs() + deltaMs);
+    AutoVibez::Utils::ConsoleOutput::info("A/V offset: " +
+                                          std::to_string(static_cast<int>(_latency.getManualOffsetMs())) + " ms");
+}
+
+void AutoVibezApp::updateLatencyModel(std::chrono::steady_clock::time_point frameStart,
+                                      std::chrono::steady_clock::time_point swapStart) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    if (_lastFrameStart.time_since_epoch().count() != 0) {
+        _latency.noteFrameInterval(Milliseconds(frameStart - _lastFrameStart).count());
+    }
+    _lastFrameStart = frameStart;
+    _latency.noteRenderTime(Milliseconds(swapStart - frameStart).count());
+
+    const bool playback = _internalAudioActive.load(std::memory_order_relaxed);
+    _latency.setPath(playback ? AutoVibez::Audio::LatencyPath::Playback : AutoVibez::Audio::LatencyPath::Capture);
+    _latency.setStreamRate(_beatTracker.getSampleRate());
+    if (!playback) {
+        int period = 0;
+        if (_syntheticCapture.isRunning()) {
+            period = Constants::DEFAULT_SAMPLES;
+        } else if (_monitorCapture.isRunning()) {
+            period = Constants::MONITOR_CAPTURE_QUANTUM_FRAMES;
+        } else if (_audioDeviceId != 0) {
+            period = _captureBuffer.getPeriod();
+        }
+        _latency.setCapturePeriod(period, _captureSampleRate);
+    }
+
+    // Capture cannot be delayed, so the speaker delay only applies to the playback tap and slews back to 0 otherwise
+    const int outputRate = getNowPlaying()->output_rate;
+    if (outputRate > 0) {
+        _latency.setOutputBuffer(Constants::DEFAULT_BUFFER_SIZE, outputRate);
+        const int delayFrames = _latencyCompensation ? _latency.getPlaybackDelayFrames(outputRate) : 0;
+        if (delayFrames != _postedOutputDelay && _mixControl.post([this, delayFrames]() {
+                _mixManager->setOutputDelayFrames(delayFrames);
+            })) {
+            _postedOutputDelay = delayFrames;
+        }
+    }
+}
+
+std::string AutoVibezApp::getLatencyStatsText() const {
+    const AutoVibez::Audio::LatencyBreakdown latency = _latency.getBreakdown();
+    const int outputRate = getNowPlaying()->output_rate;
+    const double delayMs = _latencyCompensation && outputRate > 0
+                               ? 1000.0 * _latency.getPlaybackDelayFrames(outputRate) / outputRate
+                               : 0.0;
+    char text[192];
+    std::snprintf(text, sizeof(text),
+                  "%.0f ms (capture %.0f + queue %.0f + window %.0f + render %.0f + display %.0f - output %.0f "
+                  "+ offset %.0f), audio delayed %.0f ms%s",
+                  latency.lag_ms, latency.capture_ms, latency.queue_ms, latency.window_ms, latency.render_ms,
+                  latency.display_ms, latency.output_ms, latency.offset_ms, delayMs,
+                  _latencyCalibration ? ", calibrating" : "");
+    return text;
+}
+
+void AutoVibezApp::updateAudioReconnect() {
+    if (_audioReconnecting.load(std::memory_order_acquire) || !_audioReconnectTask.valid()) {
+        return;
+    }
+    _audioReconnectTask.get();
+    if (_audioReconnectPending) {
+        scheduleAudioReconnect();
+    }
+}
+
+void AutoVibezApp::updateAudioSource() {
+    if (!_internalAudioEnabled || !_mixManagerInitialized || _syntheticCapture.isRunning() ||
+        _audioReconnecting.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // The control thread's snapshot, so this never waits on the mix manager
+    const std::shared_ptr<const NowPlaying> nowPlaying = getNowPlaying();
+    bool mixLoaded = nowPlaying->playing || nowPlaying->paused;
+    if (mixLoaded == _internalAudioActive.load()) {
+        return;
+    }
+
+    ::AutoVibez::Utils::Logger logger;
+    if (mixLoaded) {
+        // The player feeds projectM directly, so release the capture device before the tap takes over
+        if (!wasapi) {
+            endAudioCapture();
+        }
+        _beatTracker.reset(nowPlaying->output_rate);
+        _internalAudioActive.store(true);
+        logger.logInfo("Switched visualizer input to internal mix playback");
+    } else {
+        _internalAudioActive.store(false);
+        if (!wasapi && initializeAudioInput()) {
+            beginAudioCapture();
+        }
+        logger.logInfo("Switched visualizer input back to capture device");
+    }
+}
+
 int AutoVibezApp::toggleAudioInput() {
+    if (_audioReconnecting.load(std::memory_order_acquire)) {
+        return 0;
+    }
     if (this->fakeAudio) {
         this->fakeAudio = false;
         this->endAudioCapture();
@@ -126,6 +456,8 @@ void AutoVibezApp::beginAudioCapture() {
 }
 
 void AutoVibezApp::endAudioCapture() {
+    _syntheticCapture.stop();
+    _monitorCapture.stop();
     if (_audioDeviceId != 0) {
         SDL_PauseAudioDevice(_audioDeviceId, true);
         SDL_CloseAudioDevice(_audioDeviceId);
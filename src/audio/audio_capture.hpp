@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace AutoVibez::Audio {
 
 namespace AutoVibez::Core {
@@ -8,4 +10,13 @@ class AutoVibezApp;
 
 void audioInputCallbackF32(void* userData, const float* buffer, int len);
 
+/**
+ * @brief Feed the mix player's decoded output straight into projectM
+ * @param userData AutoVibezApp instance
+ * @param samples Interleaved signed 16-bit samples from SDL_mixer
+ * @param frames Number of sample frames
+ * @param channels Number of interleaved channels
+ */
+void mixOutputCallbackS16(void* userData, const int16_t* samples, int frames, int channels);
+
 }  // namespace AutoVibez::Audio
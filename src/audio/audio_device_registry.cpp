@@ -0,0 +1,90 @@
+#include "audio_device_registry.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <utility>
+
+namespace AutoVibez::Audio {
+
+AudioDeviceRegistry::AudioDeviceRegistry(Enumerator enumerator)
+    : _enumerator(enumerator ? std::move(enumerator) : Enumerator(&AudioDeviceRegistry::enumerateSdlCaptureDevices)) {}
+
+std::vector<AudioDeviceInfo> AudioDeviceRegistry::enumerateSdlCaptureDevices() {
+    std::vector<AudioDeviceInfo> devices;
+    const int count = SDL_GetNumAudioDevices(SDL_TRUE);
+    for (int i = 0; i < count; ++i) {
+        AudioDeviceInfo info;
+        const char* name = SDL_GetAudioDeviceName(i, SDL_TRUE);
+        info.name = name ? name : "";
+#if SDL_VERSION_ATLEAST(2, 0, 16)
+        SDL_AudioSpec spec;
+        SDL_zero(spec);
+        if (SDL_GetAudioDeviceSpec(i, SDL_TRUE, &spec) == 0) {
+            info.sample_rate = spec.freq;
+            info.channels = spec.channels;
+        }
+#endif
+        devices.push_back(std::move(info));
+    }
+    return devices;
+}
+
+bool AudioDeviceRegistry::refresh() {
+    // Enumerate outside the lock; SDL may take a moment to answer
+    std::vector<AudioDeviceInfo> devices = _enumerator();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    bool changed = !_populated || devices.size() != _devices.size();
+    for (size_t i = 0; !changed && i < devices.size(); ++i) {
+        changed = devices[i].name != _devices[i].name;
+    }
+    _populated = true;
+    if (changed) {
+        _devices = std::move(devices);
+        ++_generation;
+    }
+    return changed;
+}
+
+bool AudioDeviceRegistry::isPopulated() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _populated;
+}
+
+int AudioDeviceRegistry::getDeviceCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<int>(_devices.size());
+}
+
+std::string AudioDeviceRegistry::getDeviceName(int index) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (index < 0 || index >= static_cast<int>(_devices.size())) {
+        return "";
+    }
+    return _devices[index].name;
+}
+
+int AudioDeviceRegistry::findByName(const std::string& name) const {
+    if (name.empty()) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < _devices.size(); ++i) {
+        if (_devices[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::vector<AudioDeviceInfo> AudioDeviceRegistry::getDevices() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _devices;
+}
+
+uint64_t AudioDeviceRegistry::getGeneration() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _generation;
+}
+
+}  // namespace AutoVibez::Audio
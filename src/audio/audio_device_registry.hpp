@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief One capture device as SDL listed it
+ */
+struct AudioDeviceInfo {
+    std::string name;
+    int sample_rate = 0;  //!< Native rate if SDL could tell, otherwise 0
+    int channels = 0;     //!< Native channel count if SDL could tell, otherwise 0
+};
+
+/**
+ * @brief Cached list of capture devices, refreshed only when SDL reports a hotplug
+ *
+ * SDL device indices shift whenever something is plugged in or removed, so callers
+ * remember devices by name and resolve the current index here. Lookups are guarded
+ * by a mutex so the reconnect worker can read the list while the event loop refreshes it.
+ */
+class AudioDeviceRegistry {
+public:
+    using Enumerator = std::function<std::vector<AudioDeviceInfo>()>;
+
+    /**
+     * @brief Create a registry
+     * @param enumerator Lists the current devices; defaults to SDL's capture devices
+     */
+    explicit AudioDeviceRegistry(Enumerator enumerator = nullptr);
+
+    /**
+     * @brief Re-enumerate devices (after SDL audio init or a hotplug event)
+     * @return True if the list changed
+     */
+    bool refresh();
+
+    /**
+     * @brief Whether refresh() has run at least once
+     */
+    bool isPopulated() const;
+
+    int getDeviceCount() const;
+
+    /**
+     * @brief Name at an SDL device index, or empty if out of range
+     */
+    std::string getDeviceName(int index) const;
+
+    /**
+     * @brief Current index of a device by name, or -1 if it is not connected
+     */
+    int findByName(const std::string& name) const;
+
+    std::vector<AudioDeviceInfo> getDevices() const;
+
+    /**
+     * @brief Incremented on every change, so callers can tell a list they cached is stale
+     */
+    uint64_t getGeneration() const;
+
+    /**
+     * @brief Lists SDL's capture devices (SDL audio must be initialized)
+     */
+    static std::vector<AudioDeviceInfo> enumerateSdlCaptureDevices();
+
+private:
+    Enumerator _enumerator;
+    mutable std::mutex _mutex;
+    std::vector<AudioDeviceInfo> _devices;
+    uint64_t _generation = 0;
+    bool _populated = false;
+};
+
+}  // namespace AutoVibez::Audio
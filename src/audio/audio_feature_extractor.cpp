@@ -0,0 +1,261 @@
+#include "audio_feature_extractor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUTOVIBEZ_FEATURES_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUTOVIBEZ_FEATURES_NEON 1
+#endif
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+constexpr double SILENT_POWER = 1e-9;  // Spectrum power below this counts as silence
+
+struct PowerSums {
+    float power = 0.0f;
+    float weighted = 0.0f;  // Power times bin frequency
+};
+
+// Power and frequency-weighted power of bins [begin, end)
+PowerSums sumPower(const float* re, const float* im, const float* hz, int begin, int end) {
+    PowerSums sums;
+    int k = begin;
+#if defined(AUTOVIBEZ_FEATURES_SSE2)
+    __m128 power = _mm_setzero_ps();
+    __m128 weighted = _mm_setzero_ps();
+    for (; k + 4 <= end; k += 4) {
+        __m128 r = _mm_loadu_ps(re + k);
+        __m128 i = _mm_loadu_ps(im + k);
+        __m128 p = _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(i, i));
+        power = _mm_add_ps(power, p);
+        weighted = _mm_add_ps(weighted, _mm_mul_ps(p, _mm_loadu_ps(hz + k)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, power);
+    sums.power = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_ps(lanes, weighted);
+    sums.weighted = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(AUTOVIBEZ_FEATURES_NEON)
+    float32x4_t power = vdupq_n_f32(0.0f);
+    float32x4_t weighted = vdupq_n_f32(0.0f);
+    for (; k + 4 <= end; k += 4) {
+        float32x4_t r = vld1q_f32(re + k);
+        float32x4_t i = vld1q_f32(im + k);
+        float32x4_t p = vmlaq_f32(vmulq_f32(r, r), i, i);
+        power = vaddq_f32(power, p);
+        weighted = vmlaq_f32(weighted, p, vld1q_f32(hz + k));
+    }
+    float lanes[4];
+    vst1q_f32(lanes, power);
+    sums.power = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    vst1q_f32(lanes, weighted);
+    sums.weighted = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; k < end; ++k) {
+        const float p = re[k] * re[k] + im[k] * im[k];
+        sums.power += p;
+        sums.weighted += p * hz[k];
+    }
+    return sums;
+}
+}  // namespace
+
+AudioFeatureExtractor::AudioFeatureExtractor()
+    : _fft(Constants::AUDIO_FEATURE_FFT_SIZE),
+      _window(_fft.size()),
+      _binHz(_fft.size() / 2),
+      _history(_fft.size(), 0.0f),
+      _re(_fft.size()),
+      _im(_fft.size()) {
+    const int size = _fft.size();
+    for (int i = 0; i < size; ++i) {
+        _window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / (size - 1)));
+    }
+    prepare(Constants::DEFAULT_SAMPLE_RATE);
+}
+
+const char* AudioFeatureExtractor::bandName(AudioBand band) {
+    switch (band) {
+        case AudioBand::Bass:
+            return "bass";
+        case AudioBand::LowMid:
+            return "low mid";
+        case AudioBand::Mid:
+            return "mid";
+        case AudioBand::High:
+            return "high";
+    }
+    return "unknown";
+}
+
+void AudioFeatureExtractor::prepare(int sampleRate) {
+    _sampleRate = sampleRate;
+    const int size = _fft.size();
+    const int bins = size / 2;
+    const double binHz = static_cast<double>(sampleRate) / size;
+    for (int k = 0; k < bins; ++k) {
+        _binHz[k] = static_cast<float>(k * binHz);
+    }
+
+    // DC is left out; each band starts at the first bin centred at or above its lower edge
+    const double edges[] = {Constants::AUDIO_BAND_BASS_MAX_HZ, Constants::AUDIO_BAND_LOW_MID_MAX_HZ,
+                            Constants::AUDIO_BAND_MID_MAX_HZ};
+    _bandBins[0] = 1;
+    for (size_t band = 1; band < AUDIO_BAND_COUNT; ++band) {
+        const int bin = static_cast<int>(std::ceil(edges[band - 1] / binHz));
+        _bandBins[band] = std::clamp(bin, _bandBins[band - 1], bins);
+    }
+    _bandBins[AUDIO_BAND_COUNT] = bins;
+    std::fill(_history.begin(), _history.end(), 0.0f);
+}
+
+void AudioFeatureExtractor::process(const float* samples, int frames, int sampleRate) {
+    if (frames <= 0) {
+        return;
+    }
+    if (sampleRate > 0 && sampleRate != _sampleRate) {
+        prepare(sampleRate);
+    }
+    measureLevels(samples, frames);
+    appendHistory(samples, frames);
+    measureSpectrum();
+    _features.blocks++;
+    publish();
+}
+
+void AudioFeatureExtractor::measureLevels(const float* samples, int frames) {
+    // Interleaved samples go four at a time as L R L R, so even lanes are left and odd lanes right
+    const int count = frames * 2;
+    float squares[2] = {0.0f, 0.0f};
+    float peaks[2] = {0.0f, 0.0f};
+    int i = 0;
+#if defined(AUTOVIBEZ_FEATURES_SSE2)
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 square = _mm_setzero_ps();
+    __m128 peak = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(samples + i);
+        square = _mm_add_ps(square, _mm_mul_ps(x, x));
+        peak = _mm_max_ps(peak, _mm_and_ps(x, signMask));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, square);
+    squares[0] = lanes[0] + lanes[2];
+    squares[1] = lanes[1] + lanes[3];
+    _mm_storeu_ps(lanes, peak);
+    peaks[0] = std::max(lanes[0], lanes[2]);
+    peaks[1] = std::max(lanes[1], lanes[3]);
+#elif defined(AUTOVIBEZ_FEATURES_NEON)
+    float32x4_t square = vdupq_n_f32(0.0f);
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(samples + i);
+        square = vmlaq_f32(square, x, x);
+        peak = vmaxq_f32(peak, vabsq_f32(x));
+    }
+    float lanes[4];
+    vst1q_f32(lanes, square);
+    squares[0] = lanes[0] + lanes[2];
+    squares[1] = lanes[1] + lanes[3];
+    vst1q_f32(lanes, peak);
+    peaks[0] = std::max(lanes[0], lanes[2]);
+    peaks[1] = std::max(lanes[1], lanes[3]);
+#endif
+    for (; i < count; ++i) {
+        const int channel = i & 1;
+        squares[channel] += samples[i] * samples[i];
+        peaks[channel] = std::max(peaks[channel], std::fabs(samples[i]));
+    }
+
+    _features.rms_left = std::sqrt(squares[0] / frames);
+    _features.rms_right = std::sqrt(squares[1] / frames);
+    _features.peak_left = peaks[0];
+    _features.peak_right = peaks[1];
+}
+
+void AudioFeatureExtractor::appendHistory(const float* samples, int frames) {
+    const int size = _fft.size();
+    const int kept = std::max(0, size - frames);
+    const int taken = size - kept;
+    if (kept > 0) {
+        std::memmove(_history.data(), _history.data() + taken, kept * sizeof(float));
+    }
+    const float* source = samples + static_cast<size_t>(frames - taken) * 2;
+    for (int i = 0; i < taken; ++i) {
+        _history[kept + i] = 0.5f * (source[2 * i] + source[2 * i + 1]);
+    }
+}
+
+void AudioFeatureExtractor::measureSpectrum() {
+    const int size = _fft.size();
+    for (int i = 0; i < size; ++i) {
+        _re[i] = _history[i] * _window[i];
+    }
+    std::fill(_im.begin(), _im.end(), 0.0f);
+    _fft.forward(_re.data(), _im.data());
+
+    std::array<PowerSums, AUDIO_BAND_COUNT> bands;
+    double total = 0.0;
+    double weighted = 0.0;
+    for (size_t band = 0; band < AUDIO_BAND_COUNT; ++band) {
+        bands[band] = sumPower(_re.data(), _im.data(), _binHz.data(), _bandBins[band], _bandBins[band + 1]);
+        total += bands[band].power;
+        weighted += bands[band].weighted;
+    }
+
+    if (total < SILENT_POWER) {
+        _features.bands.fill(0.0f);
+        _features.centroid_hz = 0.0f;
+        return;
+    }
+    for (size_t band = 0; band < AUDIO_BAND_COUNT; ++band) {
+        _features.bands[band] = static_cast<float>(bands[band].power / total);
+    }
+    _features.centroid_hz = static_cast<float>(weighted / total);
+}
+
+void AudioFeatureExtractor::publish() {
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _publishedRmsLeft.store(_features.rms_left, std::memory_order_relaxed);
+    _publishedRmsRight.store(_features.rms_right, std::memory_order_relaxed);
+    _publishedPeakLeft.store(_features.peak_left, std::memory_order_relaxed);
+    _publishedPeakRight.store(_features.peak_right, std::memory_order_relaxed);
+    for (size_t band = 0; band < AUDIO_BAND_COUNT; ++band) {
+        _publishedBands[band].store(_features.bands[band], std::memory_order_relaxed);
+    }
+    _publishedCentroidHz.store(_features.centroid_hz, std::memory_order_relaxed);
+    _publishedBlocks.store(_features.blocks, std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+AudioFeatures AudioFeatureExtractor::getFeatures() const {
+    AudioFeatures features;
+    uint32_t before = 0;
+    uint32_t after = 0;
+    do {
+        before = _sequence.load(std::memory_order_acquire);
+        features.rms_left = _publishedRmsLeft.load(std::memory_order_relaxed);
+        features.rms_right = _publishedRmsRight.load(std::memory_order_relaxed);
+        features.peak_left = _publishedPeakLeft.load(std::memory_order_relaxed);
+        features.peak_right = _publishedPeakRight.load(std::memory_order_relaxed);
+        for (size_t band = 0; band < AUDIO_BAND_COUNT; ++band) {
+            features.bands[band] = _publishedBands[band].load(std::memory_order_relaxed);
+        }
+        features.centroid_hz = _publishedCentroidHz.load(std::memory_order_relaxed);
+        features.blocks = _publishedBlocks.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+    return features;
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "constants.hpp"
+#include "fft.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Frequency bands the spectrum is summed into
+ */
+enum class AudioBand : uint8_t { Bass, LowMid, Mid, High };
+
+constexpr size_t AUDIO_BAND_COUNT = 4;
+
+/**
+ * @brief Levels and spectral shape of the last analyzed block
+ */
+struct AudioFeatures {
+    float rms_left = 0.0f;                        //!< Linear, 1 is a full-scale square wave
+    float rms_right = 0.0f;
+    float peak_left = 0.0f;                       //!< Largest absolute sample of the block
+    float peak_right = 0.0f;
+    std::array<float, AUDIO_BAND_COUNT> bands{};  //!< Share of the spectrum's power per AudioBand, all 0 in silence
+    float centroid_hz = 0.0f;                     //!< Power-weighted mean frequency, 0 in silence
+    uint64_t blocks = 0;                          //!< Blocks analyzed so far; unchanged means no new audio
+};
+
+/**
+ * @brief Per-block level and spectrum analysis shared by everything that reacts to the music
+ *
+ * Each block of interleaved stereo PCM drained from the ring buffer is analyzed once:
+ * the RMS and peak of both channels in one pass over the interleaved samples, then
+ * a Hann-windowed FFT of the last AUDIO_FEATURE_FFT_SIZE mono frames, summed into
+ * four bands and a spectral centroid. The level pass and the power sums use SSE2 or
+ * NEON when available, with a scalar fallback. Results are published under a
+ * sequence counter, so overlays, the preset scheduler and anything else read them
+ * without locks and never see half an update.
+ *
+ * process() allocates nothing once the sample rate is known. One producer thread at
+ * a time; getFeatures() is safe from any thread.
+ */
+class AudioFeatureExtractor {
+public:
+    AudioFeatureExtractor();
+
+    AudioFeatureExtractor(const AudioFeatureExtractor&) = delete;
+    AudioFeatureExtractor& operator=(const AudioFeatureExtractor&) = delete;
+
+    /**
+     * @brief Analyze one block of interleaved stereo samples and publish the result
+     * @param sampleRate Rate of the block; a change restarts the spectrum history
+     */
+    void process(const float* samples, int frames, int sampleRate);
+
+    AudioFeatures getFeatures() const;
+
+    static const char* bandName(AudioBand band);
+
+private:
+    void prepare(int sampleRate);
+    void measureLevels(const float* samples, int frames);
+    void appendHistory(const float* samples, int frames);
+    void measureSpectrum();
+    void publish();
+
+    Fft _fft;
+    int _sampleRate = 0;
+    std::vector<float> _window;
+    std::vector<float> _binHz;                          // Centre frequency of each bin
+    std::array<int, AUDIO_BAND_COUNT + 1> _bandBins{};  // First bin of each band, then the end
+    std::vector<float> _history;                        // Last AUDIO_FEATURE_FFT_SIZE mono frames, oldest first
+    std::vector<float> _re;
+    std::vector<float> _im;
+
+    // Producer-side result of the last block
+    AudioFeatures _features;
+
+    // Published features, guarded by a sequence counter so readers never see a torn update
+    std::atomic<uint32_t> _sequence{0};
+    std::atomic<float> _publishedRmsLeft{0.0f};
+    std::atomic<float> _publishedRmsRight{0.0f};
+    std::atomic<float> _publishedPeakLeft{0.0f};
+    std::atomic<float> _publishedPeakRight{0.0f};
+    std::array<std::atomic<float>, AUDIO_BAND_COUNT> _publishedBands{};
+    std::atomic<float> _publishedCentroidHz{0.0f};
+    std::atomic<uint64_t> _publishedBlocks{0};
+};
+
+}  // namespace AutoVibez::Audio
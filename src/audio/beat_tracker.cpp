@@ -0,0 +1,328 @@
+#include "beat_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+
+// Tempo search; same range and octave preference as the ingest TempoEstimator
+constexpr double MIN_BPM = 60.0;
+constexpr double MAX_BPM = 180.0;
+constexpr double PREFERRED_BPM = 120.0;
+constexpr double TEMPO_WEIGHT_OCTAVES = 0.9;
+
+constexpr int TEMPO_UPDATE_HOPS = 32;           // Re-estimate roughly three times a second
+constexpr int PHASE_COMB_BEATS = 4;             // Recent beats summed when fitting the phase
+constexpr double LOCK_MIN_CORRELATION = 0.2;    // Normalized autocorrelation needed to trust the tempo
+constexpr double MIN_ENVELOPE_VARIANCE = 1e-6;  // Below this the input is silence or a steady tone
+constexpr float MAGNITUDE_COMPRESSION = 100.0f;
+constexpr double BAR_STRENGTH_DECAY = 0.7;
+constexpr int BEAT_ONSET_SPREAD_HOPS = 2;  // Onsets this close to a predicted beat belong to it
+constexpr int BEATS_PER_BAR = 4;
+
+constexpr double ENERGY_SHORT_SECONDS = 1.0;  // Averaging time of the current energy
+constexpr double ENERGY_LONG_SECONDS = 30.0;  // and of the level it is compared with
+constexpr double ONSET_RATE_SECONDS = 4.0;    // Averaging time of the onset rate
+constexpr double ONSET_THRESHOLD = 1.5;       // Times the mean flux a peak must reach to count as an onset
+constexpr double MIN_ENERGY_POWER = 1e-9;     // Below this the stream is silent
+constexpr int ENERGY_PUBLISH_HOPS = 8;        // Publish the energy about ten times a second
+}  // namespace
+
+BeatTracker::BeatTracker(int sampleRate)
+    : _fft(Constants::BEAT_FFT_SIZE),
+      _window(Constants::BEAT_FFT_SIZE),
+      _re(Constants::BEAT_FFT_SIZE),
+      _im(Constants::BEAT_FFT_SIZE),
+      _centered(Constants::BEAT_ENVELOPE_HOPS, 0.0) {
+    for (int i = 0; i < Constants::BEAT_FFT_SIZE; ++i) {
+        _window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / Constants::BEAT_FFT_SIZE));
+    }
+    reset(sampleRate);
+}
+
+void BeatTracker::reset(int sampleRate) {
+    _sampleRate = std::max(1, sampleRate);
+    _hopsPerMinute = 60.0 * _sampleRate / Constants::BEAT_HOP_FRAMES;
+    const int maxLag = static_cast<int>(std::ceil(_hopsPerMinute / MIN_BPM));
+    _correlation.assign(static_cast<size_t>(maxLag) + 2, 0.0);
+
+    _input.assign(Constants::BEAT_FFT_SIZE, 0.0f);
+    _previousMagnitude.assign(Constants::BEAT_FFT_SIZE / 2 + 1, 0.0f);
+    _envelope.assign(Constants::BEAT_ENVELOPE_HOPS, 0.0f);
+    _inputPosition = 0;
+    _hopFill = 0;
+    _hop = 0;
+
+    _locked = false;
+    _periodHops = 0.0;
+    _nextBeatHop = 0.0;
+    _lastBeatHop = 0.0;
+    _beatCount = 0;
+    std::fill(std::begin(_barStrength), std::end(_barStrength), 0.0);
+    _downbeatSlot = 0;
+
+    const double hopsPerSecond = _hopsPerMinute / 60.0;
+    _shortAlpha = 1.0 / (ENERGY_SHORT_SECONDS * hopsPerSecond);
+    _longAlpha = 1.0 / (ENERGY_LONG_SECONDS * hopsPerSecond);
+    _onsetAlpha = 1.0 / (ONSET_RATE_SECONDS * hopsPerSecond);
+    _shortPower = 0.0;
+    _longPower = 0.0;
+    _fluxMean = 0.0;
+    _onsetsPerHop = 0.0;
+    _framesProcessed.store(0, std::memory_order_release);
+    publish();
+}
+
+void BeatTracker::process(const float* samples, int frames) {
+    if (!samples || frames <= 0) {
+        return;
+    }
+
+    constexpr int mask = Constants::BEAT_FFT_SIZE - 1;
+    for (int i = 0; i < frames; ++i) {
+        _input[_inputPosition] = 0.5f * (samples[2 * i] + samples[2 * i + 1]);
+        _inputPosition = (_inputPosition + 1) & mask;
+        if (++_hopFill == Constants::BEAT_HOP_FRAMES) {
+            _hopFill = 0;
+            analyzeHop();
+        }
+    }
+    _framesProcessed.fetch_add(frames, std::memory_order_release);
+}
+
+void BeatTracker::analyzeHop() {
+    // Oldest sample first, windowed
+    const int size = Constants::BEAT_FFT_SIZE;
+    for (int i = 0; i < size; ++i) {
+        _re[i] = _input[(_inputPosition + i) & (size - 1)] * _window[i];
+        _im[i] = 0.0f;
+    }
+    _fft.forward(_re.data(), _im.data());
+
+    // Positive log-magnitude change summed over bins: rises at note and drum onsets
+    float flux = 0.0f;
+    double power = 0.0;
+    for (int bin = 1; bin <= size / 2; ++bin) {
+        const float squared = _re[bin] * _re[bin] + _im[bin] * _im[bin];
+        float magnitude = std::log1p(MAGNITUDE_COMPRESSION * std::sqrt(squared));
+        flux += std::max(0.0f, magnitude - _previousMagnitude[bin]);
+        _previousMagnitude[bin] = magnitude;
+        power += squared;
+    }
+    _envelope[_hop % Constants::BEAT_ENVELOPE_HOPS] = _hop == 0 ? 0.0f : flux;
+    ++_hop;
+    updateIntensity(power);
+
+    if (_hop >= Constants::BEAT_ENVELOPE_HOPS && _hop % TEMPO_UPDATE_HOPS == 0) {
+        updateTempo();
+    }
+    advanceBeats();
+}
+
+void BeatTracker::updateIntensity(double power) {
+    // Plain means until each average has seen its time span, so the first seconds read true
+    const double mean = 1.0 / static_cast<double>(_hop);
+    const double longAlpha = std::max(_longAlpha, mean);
+    _shortPower += std::max(_shortAlpha, mean) * (power - _shortPower);
+    _longPower += longAlpha * (power - _longPower);
+
+    // The hop before last is an onset if it peaks well above the average flux
+    const double previous = envelopeAt(_hop - 2);
+    const bool onset = previous > envelopeAt(_hop - 3) && previous >= envelopeAt(_hop - 1) &&
+                       previous > ONSET_THRESHOLD * _fluxMean;
+    _fluxMean += longAlpha * (envelopeAt(_hop - 1) - _fluxMean);
+    _onsetsPerHop += std::max(_onsetAlpha, mean) * ((onset ? 1.0 : 0.0) - _onsetsPerHop);
+
+    if (_hop % ENERGY_PUBLISH_HOPS == 0) {
+        publish();
+    }
+}
+
+double BeatTracker::envelopeAt(int64_t hop) const {
+    if (hop < 0 || hop >= _hop || _hop - hop > Constants::BEAT_ENVELOPE_HOPS) {
+        return 0.0;
+    }
+    return _envelope[hop % Constants::BEAT_ENVELOPE_HOPS];
+}
+
+void BeatTracker::updateTempo() {
+    const int count = Constants::BEAT_ENVELOPE_HOPS;
+    const int64_t first = _hop - count;
+
+    // A light blur keeps onsets that straddle two hops from splitting the correlation peak
+    double mean = 0.0;
+    for (int i = 0; i < count; ++i) {
+        const int64_t hop = first + i;
+        _centered[i] = 0.25 * envelopeAt(hop - 1) + 0.5 * envelopeAt(hop) + 0.25 * envelopeAt(hop + 1);
+        mean += _centered[i];
+    }
+    mean /= count;
+    double variance = 0.0;
+    for (int i = 0; i < count; ++i) {
+        _centered[i] -= mean;
+        variance += _centered[i] * _centered[i];
+    }
+    variance /= count;
+    if (variance < MIN_ENVELOPE_VARIANCE) {
+        _locked = false;
+        publish();
+        return;
+    }
+
+    const int minLag = static_cast<int>(std::floor(_hopsPerMinute / MAX_BPM));
+    const int maxLag = static_cast<int>(_correlation.size()) - 2;
+    for (int lag = minLag - 1; lag <= maxLag + 1; ++lag) {
+        double sum = 0.0;
+        for (int i = lag; i < count; ++i) {
+            sum += _centered[i] * _centered[i - lag];
+        }
+        _correlation[lag] = sum / (count - lag) / variance;
+    }
+
+    int bestLag = 0;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        double octaves = std::log2(_hopsPerMinute / lag / PREFERRED_BPM) / TEMPO_WEIGHT_OCTAVES;
+        double score = _correlation[lag] * std::exp(-0.5 * octaves * octaves);
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0 || _correlation[bestLag] < LOCK_MIN_CORRELATION) {
+        _locked = false;
+        publish();
+        return;
+    }
+
+    double before = _correlation[bestLag - 1];
+    double peak = _correlation[bestLag];
+    double after = _correlation[bestLag + 1];
+    double denominator = before - 2.0 * peak + after;
+    double offset = denominator < 0.0 ? std::clamp(0.5 * (before - after) / denominator, -0.5, 0.5) : 0.0;
+    const double period = bestLag + offset;
+
+    // Phase: the offset back from the newest hop whose comb of beats collects the most onset energy
+    const int64_t newest = _hop - 1;
+    int bestPhase = 0;
+    double bestComb = -1.0;
+    for (int phase = 0; phase < bestLag; ++phase) {
+        double comb = 0.0;
+        for (int beat = 0; beat < PHASE_COMB_BEATS; ++beat) {
+            comb += envelopeAt(newest - phase - static_cast<int64_t>(std::lround(beat * period)));
+        }
+        if (comb > bestComb) {
+            bestComb = comb;
+            bestPhase = phase;
+        }
+    }
+
+    // The fitted grid's latest beat fires now unless the running grid already counted it
+    const auto gridBeat = static_cast<double>(newest - bestPhase);
+    double nextBeat = gridBeat + period;
+    if (_beatCount == 0 || gridBeat - _lastBeatHop >= 0.5 * period) {
+        nextBeat = gridBeat;
+    }
+    _periodHops = period;
+    _nextBeatHop = nextBeat;
+    _locked = true;
+    publish();
+}
+
+void BeatTracker::advanceBeats() {
+    const double now = static_cast<double>(_hop - 1);
+    bool fired = false;
+    while (_locked && _periodHops > 0.0 && _nextBeatHop <= now) {
+        // The onset of the previous beat is complete by now; its strength decides which slot is the downbeat
+        if (_beatCount > 0) {
+            const int slot = static_cast<int>((_beatCount - 1) % BEATS_PER_BAR);
+            const auto beatHop = static_cast<int64_t>(std::lround(_lastBeatHop));
+            double strength = 0.0;
+            for (int64_t hop = beatHop - BEAT_ONSET_SPREAD_HOPS; hop <= beatHop + BEAT_ONSET_SPREAD_HOPS; ++hop) {
+                strength = std::max(strength, envelopeAt(hop));
+            }
+            _barStrength[slot] = BAR_STRENGTH_DECAY * _barStrength[slot] + (1.0 - BAR_STRENGTH_DECAY) * strength;
+        }
+        _lastBeatHop = _nextBeatHop;
+        _nextBeatHop += _periodHops;
+
+        int strongest = 0;
+        for (int i = 1; i < BEATS_PER_BAR; ++i) {
+            if (_barStrength[i] > _barStrength[strongest]) {
+                strongest = i;
+            }
+        }
+        _downbeatSlot = strongest;
+        ++_beatCount;
+        fired = true;
+    }
+    if (fired) {
+        publish();
+    }
+}
+
+void BeatTracker::publish() {
+    // Hop h is analyzed after (h + 1) hops of input, so its window is centred half a window earlier
+    const double hopFrames = Constants::BEAT_HOP_FRAMES;
+    const double centre = hopFrames - Constants::BEAT_FFT_SIZE / 2.0;
+    const auto beatFrame = static_cast<int64_t>(std::llround(_lastBeatHop * hopFrames + centre));
+    const int lastSlot = static_cast<int>((_beatCount + BEATS_PER_BAR - 1) % BEATS_PER_BAR);
+
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _publishedLocked.store(_locked && _beatCount > 0, std::memory_order_relaxed);
+    _publishedPeriodFrames.store(_periodHops * hopFrames, std::memory_order_relaxed);
+    _publishedBpm.store(_periodHops > 0.0 ? _hopsPerMinute / _periodHops : 0.0, std::memory_order_relaxed);
+    _publishedBeatFrame.store(beatFrame, std::memory_order_relaxed);
+    _publishedBeatCount.store(_beatCount, std::memory_order_relaxed);
+    _publishedBeatInBar.store((lastSlot - _downbeatSlot + BEATS_PER_BAR) % BEATS_PER_BAR, std::memory_order_relaxed);
+    _publishedEnergy.store(_longPower > MIN_ENERGY_POWER ? std::sqrt(_shortPower / _longPower) : 0.0,
+                           std::memory_order_relaxed);
+    _publishedOnsetRate.store(_onsetsPerHop * _hopsPerMinute / 60.0, std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+BeatState BeatTracker::getState(int64_t lead_frames) const {
+    BeatState state;
+    double periodFrames = 0.0;
+    int64_t beatFrame = 0;
+    uint32_t before = 0;
+    uint32_t after = 0;
+    do {
+        before = _sequence.load(std::memory_order_acquire);
+        state.locked = _publishedLocked.load(std::memory_order_relaxed);
+        periodFrames = _publishedPeriodFrames.load(std::memory_order_relaxed);
+        state.bpm = _publishedBpm.load(std::memory_order_relaxed);
+        beatFrame = _publishedBeatFrame.load(std::memory_order_relaxed);
+        state.beat_count = _publishedBeatCount.load(std::memory_order_relaxed);
+        state.beat_in_bar = _publishedBeatInBar.load(std::memory_order_relaxed);
+        state.energy = _publishedEnergy.load(std::memory_order_relaxed);
+        state.onset_rate = _publishedOnsetRate.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    if (!state.locked || periodFrames <= 0.0) {
+        state.locked = false;
+        state.bpm = 0.0;
+        return state;
+    }
+    const int64_t lead = std::max<int64_t>(0, lead_frames);
+    const double elapsed =
+        static_cast<double>(_framesProcessed.load(std::memory_order_acquire) + lead - beatFrame);
+    state.phase = elapsed <= 0.0 ? 0.0 : std::fmod(elapsed / periodFrames, 1.0);
+
+    // Beats the lead carries past the last published one
+    if (lead > 0 && elapsed >= periodFrames) {
+        const uint64_t ahead = static_cast<uint64_t>(elapsed / periodFrames);
+        state.beat_count += ahead;
+        state.beat_in_bar = static_cast<int>((state.beat_in_bar + ahead) % BEATS_PER_BAR);
+    }
+    return state;
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "constants.hpp"
+#include "fft.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Snapshot of the tracked beat grid
+ */
+struct BeatState {
+    bool locked = false;      //!< A periodic onset pattern was found; the other fields are meaningless otherwise
+    double bpm = 0.0;         //!< Current tempo estimate
+    double phase = 0.0;       //!< 0 on a beat, rising towards 1 just before the next one
+    int beat_in_bar = 0;      //!< 0 on downbeats, assuming four beats to the bar
+    uint64_t beat_count = 0;  //!< Beats passed since the tracker was created
+    double energy = 0.0;      //!< Loudness of the last second over the stream's recent average (set when unlocked too)
+    double onset_rate = 0.0;  //!< Onsets per second over the last few seconds (set when unlocked too)
+};
+
+/**
+ * @brief Real-time spectral-flux onset detector and beat tracker for interleaved stereo PCM
+ *
+ * Every hop the latest window is transformed with a radix-2 FFT and the positive change in
+ * log magnitude is added to an onset envelope. A few times a second the envelope's
+ * autocorrelation gives the tempo (60-180 BPM, weighted towards 120) and a comb over the
+ * recent onsets gives the phase; between updates beats are predicted from that grid. The
+ * strongest of every four beats is taken as the downbeat. Alongside the grid it follows the
+ * short-term energy against the last half minute, and how often onsets stand out of the
+ * envelope, which tell drops from breakdowns whether or not a beat was found.
+ *
+ * process() allocates nothing and takes no locks, so it can run in the audio callback
+ * (a 1024-frame block costs a few tens of microseconds). getState() is safe from any thread.
+ */
+class BeatTracker {
+public:
+    explicit BeatTracker(int sampleRate = Constants::DEFAULT_SAMPLE_RATE);
+
+    BeatTracker(const BeatTracker&) = delete;
+    BeatTracker& operator=(const BeatTracker&) = delete;
+
+    /**
+     * @brief Feed interleaved stereo samples (one producer thread at a time)
+     */
+    void process(const float* samples, int frames);
+
+    /**
+     * @brief Forget the grid and analyze a stream at a new rate (only while nothing calls process())
+     */
+    void reset(int sampleRate);
+
+    int getSampleRate() const {
+        return _sampleRate;
+    }
+
+    /**
+     * @brief Latest beat grid, with the phase extrapolated to the samples fed so far
+     * @param lead_frames Extrapolate this much further, to where the listener already is when output lags
+     */
+    BeatState getState(int64_t lead_frames = 0) const;
+
+private:
+    void analyzeHop();
+    void updateTempo();
+    void advanceBeats();
+    void updateIntensity(double power);
+    void publish();
+    double envelopeAt(int64_t hop) const;
+
+    Fft _fft;
+    int _sampleRate = Constants::DEFAULT_SAMPLE_RATE;
+    double _hopsPerMinute = 0.0;
+
+    // Analysis state, owned by the producer thread
+    std::vector<float> _window;
+    std::vector<float> _input;  // Mono ring of the last BEAT_FFT_SIZE frames
+    std::vector<float> _re;
+    std::vector<float> _im;
+    std::vector<float> _previousMagnitude;
+    int _inputPosition = 0;
+    int _hopFill = 0;
+
+    std::vector<float> _envelope;  // Onset strength per hop, ring of BEAT_ENVELOPE_HOPS
+    std::vector<double> _centered;
+    std::vector<double> _correlation;
+    int64_t _hop = 0;  // Hops analyzed so far
+
+    bool _locked = false;
+    double _periodHops = 0.0;
+    double _nextBeatHop = 0.0;
+    double _lastBeatHop = 0.0;
+    uint64_t _beatCount = 0;
+    double _barStrength[4] = {0.0, 0.0, 0.0, 0.0};
+    int _downbeatSlot = 0;
+
+    // Section intensity
+    double _shortAlpha = 0.0;  // Per-hop smoothing of the averages below
+    double _longAlpha = 0.0;
+    double _onsetAlpha = 0.0;
+    double _shortPower = 0.0;
+    double _longPower = 0.0;
+    double _fluxMean = 0.0;
+    double _onsetsPerHop = 0.0;
+
+    // Published grid, guarded by a sequence counter so readers never see a torn update
+    std::atomic<uint32_t> _sequence{0};
+    std::atomic<bool> _publishedLocked{false};
+    std::atomic<double> _publishedPeriodFrames{0.0};
+    std::atomic<double> _publishedBpm{0.0};
+    std::atomic<int64_t> _publishedBeatFrame{0};
+    std::atomic<uint64_t> _publishedBeatCount{0};
+    std::atomic<int> _publishedBeatInBar{0};
+    std::atomic<double> _publishedEnergy{0.0};
+    std::atomic<double> _publishedOnsetRate{0.0};
+    std::atomic<int64_t> _framesProcessed{0};
+};
+
+}  // namespace AutoVibez::Audio
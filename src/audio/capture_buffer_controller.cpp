@@ -0,0 +1,125 @@
+#include "capture_buffer_controller.hpp"
+
+#include <algorithm>
+
+#include "metrics_registry.hpp"
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr int64_t NANOS_PER_SECOND = 1000000000;
+constexpr int64_t WINDOW_NS = 2 * NANOS_PER_SECOND;  // Callbacks judged together
+constexpr int CLEAN_WINDOWS_TO_SHRINK = 3;            // Consecutive clean windows before trying a smaller period
+constexpr double LATE_PERIODS = 2.5;                  // A gap this many periods long means audio was lost
+constexpr double MARGINAL_JITTER_PERIODS = 0.75;      // Lateness this close to a period means the next one may drop
+
+int roundToPowerOfTwo(int frames) {
+    int period = Constants::CAPTURE_PERIOD_MIN_FRAMES;
+    while (period < frames && period < Constants::MAX_NATIVE_PERIOD_FRAMES) {
+        period <<= 1;
+    }
+    return period;
+}
+
+// Looked up before main, so the audio callback never takes the registry's lock
+::AutoVibez::Utils::MetricCounter& xrunMetric = ::AutoVibez::Utils::MetricsRegistry::instance().counter(
+    "autovibez_audio_xruns_total", "Capture callbacks late enough to have lost audio");
+}  // namespace
+
+void CaptureBufferController::setRequestedPeriod(int period_frames) {
+    _requested = std::max(_floor, roundToPowerOfTwo(period_frames));
+}
+
+void CaptureBufferController::configure(int period_frames, int sample_rate, int64_t now_ns) {
+    _period = std::max(1, period_frames);
+    _sampleRate = std::max(1, sample_rate);
+
+    // A device that refused the request sets the floor: asking again would not help
+    if (_period > _requested) {
+        _floor = std::max(_floor, roundToPowerOfTwo(_period));
+    }
+    _cleanWindows = 0;
+    _windowStart = now_ns;
+    _lastCallbackNs.store(0, std::memory_order_relaxed);
+    _windowMaxDelayNs.store(0, std::memory_order_relaxed);
+    _windowLate.store(0, std::memory_order_relaxed);
+    _windowCallbacks.store(0, std::memory_order_relaxed);
+}
+
+void CaptureBufferController::onCallback(int frames, int64_t now_ns) {
+    const int64_t previous = _lastCallbackNs.exchange(now_ns, std::memory_order_relaxed);
+    _windowCallbacks.fetch_add(1, std::memory_order_relaxed);
+    if (previous == 0 || frames <= 0) {
+        return;
+    }
+
+    // Lateness relative to when this block's audio should have been complete
+    const int64_t expected = static_cast<int64_t>(frames) * NANOS_PER_SECOND / _sampleRate;
+    const int64_t interval = now_ns - previous;
+    const int64_t delay = interval - expected;
+    int64_t worst = _windowMaxDelayNs.load(std::memory_order_relaxed);
+    while (delay > worst && !_windowMaxDelayNs.compare_exchange_weak(worst, delay, std::memory_order_relaxed)) {
+    }
+    if (interval > static_cast<int64_t>(LATE_PERIODS * expected)) {
+        _windowLate.fetch_add(1, std::memory_order_relaxed);
+        _xruns.fetch_add(1, std::memory_order_relaxed);
+        xrunMetric.increment();
+    }
+}
+
+int CaptureBufferController::evaluate(int64_t now_ns) {
+    if (_period <= 0 || now_ns - _windowStart < WINDOW_NS) {
+        return 0;
+    }
+    _windowStart = now_ns;
+    const uint64_t callbacks = _windowCallbacks.exchange(0, std::memory_order_relaxed);
+    const uint64_t late = _windowLate.exchange(0, std::memory_order_relaxed);
+    const int64_t worstDelay = _windowMaxDelayNs.exchange(0, std::memory_order_relaxed);
+    _lastJitterMs = static_cast<double>(std::max<int64_t>(0, worstDelay)) / 1e6;
+
+    // No callbacks at all is a dead device, not a period problem; the hotplug path handles it
+    if (!_enabled || callbacks == 0) {
+        return 0;
+    }
+
+    const double periodNs = static_cast<double>(_period) * NANOS_PER_SECOND / _sampleRate;
+    const bool unstable = late > 0 || worstDelay > MARGINAL_JITTER_PERIODS * periodNs;
+    if (unstable) {
+        _cleanWindows = 0;
+        const int larger = std::min(Constants::MAX_NATIVE_PERIOD_FRAMES, roundToPowerOfTwo(_period) * 2);
+        if (larger <= _period) {
+            return 0;
+        }
+        _floor = std::max(_floor, larger);
+        _requested = larger;
+        return larger;
+    }
+
+    if (++_cleanWindows < CLEAN_WINDOWS_TO_SHRINK) {
+        return 0;
+    }
+    _cleanWindows = 0;
+    const int smaller = roundToPowerOfTwo(_period) / 2;
+    if (smaller < _floor) {
+        return 0;
+    }
+    _requested = smaller;
+    return smaller;
+}
+
+CaptureStats CaptureBufferController::getStats(size_t ring_available_samples, uint64_t underruns,
+                                               uint64_t overflows) const {
+    CaptureStats stats;
+    stats.period_frames = _period;
+    stats.sample_rate = _sampleRate;
+    const double bufferedFrames = _period + static_cast<double>(ring_available_samples) / 2.0;
+    stats.latency_ms = 1000.0 * bufferedFrames / _sampleRate;
+    stats.jitter_ms = _lastJitterMs;
+    stats.xruns = _xruns.load(std::memory_order_relaxed);
+    stats.underruns = underruns;
+    stats.overflows = overflows;
+    stats.reopens = _reopens;
+    return stats;
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Capture latency and glitch counters for the stats display
+ */
+struct CaptureStats {
+    int period_frames = 0;    //!< Period the device is running with
+    int sample_rate = 0;      //!< Capture rate in Hz
+    double latency_ms = 0.0;  //!< One period plus what is waiting in the ring buffer
+    double jitter_ms = 0.0;   //!< Worst callback lateness in the last window
+    uint64_t xruns = 0;       //!< Callbacks that arrived late enough to have lost audio
+    uint64_t underruns = 0;   //!< Render frames that found no new samples
+    uint64_t overflows = 0;   //!< Samples dropped because the renderer fell behind
+    uint64_t reopens = 0;     //!< Period changes applied by reopening the device
+};
+
+/**
+ * @brief Picks the smallest capture period the device delivers without glitches
+ *
+ * The audio callback reports every block (wait-free); the control thread calls
+ * evaluate() once per frame. Every couple of seconds the window is judged: a late
+ * callback or jitter close to a whole period doubles the period and makes it the new
+ * floor, while several clean windows in a row halve it, down to that floor. Periods
+ * stay powers of two between CAPTURE_PERIOD_MIN_FRAMES and MAX_NATIVE_PERIOD_FRAMES.
+ */
+class CaptureBufferController {
+public:
+    /**
+     * @brief Record the period and rate a device opened with (control thread, device paused)
+     * @param period_frames Frames per callback SDL granted
+     * @param sample_rate Capture rate in Hz
+     * @param now_ns Monotonic time in nanoseconds
+     */
+    void configure(int period_frames, int sample_rate, int64_t now_ns);
+
+    /**
+     * @brief Note one callback (audio thread)
+     */
+    void onCallback(int frames, int64_t now_ns);
+
+    /**
+     * @brief Judge the current window (control thread)
+     * @param now_ns Monotonic time in nanoseconds
+     * @return Period to reopen the device with, or 0 to keep the current one
+     */
+    int evaluate(int64_t now_ns);
+
+    /**
+     * @brief Count a reopen performed because evaluate() asked for one
+     */
+    void noteReopen() {
+        ++_reopens;
+    }
+
+    bool isEnabled() const {
+        return _enabled;
+    }
+    void setEnabled(bool enabled) {
+        _enabled = enabled;
+    }
+
+    /**
+     * @brief Period the device is running with, 0 before configure()
+     */
+    int getPeriod() const {
+        return _period;
+    }
+
+    /**
+     * @brief Period the next device open should request
+     */
+    int getRequestedPeriod() const {
+        return _requested;
+    }
+    void setRequestedPeriod(int period_frames);
+
+    /**
+     * @brief Snapshot for display; the ring counters and fill level come from the caller
+     */
+    CaptureStats getStats(size_t ring_available_samples, uint64_t underruns, uint64_t overflows) const;
+
+private:
+    bool _enabled = true;
+    int _requested = Constants::DEFAULT_SAMPLES;
+    int _floor = Constants::CAPTURE_PERIOD_MIN_FRAMES;
+    int _period = 0;
+    int _sampleRate = Constants::DEFAULT_SAMPLE_RATE;
+    int _cleanWindows = 0;
+    int64_t _windowStart = 0;
+    uint64_t _reopens = 0;
+    double _lastJitterMs = 0.0;
+
+    // Written by the audio thread
+    std::atomic<int64_t> _lastCallbackNs{0};
+    std::atomic<int64_t> _windowMaxDelayNs{0};
+    std::atomic<uint64_t> _windowLate{0};
+    std::atomic<uint64_t> _windowCallbacks{0};
+    std::atomic<uint64_t> _xruns{0};
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,198 @@
+#include "channel_downmixer.hpp"
+
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUTOVIBEZ_DOWNMIX_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUTOVIBEZ_DOWNMIX_NEON 1
+#endif
+
+#include "string_utils.hpp"
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr float CENTER_GAIN = 0.7071f;  // -3 dB
+constexpr float SURROUND_GAIN = 0.7071f;
+}  // namespace
+
+ChannelDownmixer::ChannelDownmixer() = default;
+
+void ChannelDownmixer::defaultWeights(int channels, float* left, float* right) {
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        left[i] = 0.0f;
+        right[i] = 0.0f;
+    }
+
+    if (channels == 1) {
+        left[0] = right[0] = 1.0f;
+        return;
+    }
+
+    // SMPTE/SDL order: FL FR FC LFE BL BR SL SR; LFE is dropped
+    left[0] = 1.0f;
+    right[1] = 1.0f;
+    if (channels == 3) {
+        // 2.1: third channel is LFE
+        return;
+    }
+    if (channels == 4) {
+        // Quad: FL FR BL BR
+        left[2] = SURROUND_GAIN;
+        right[3] = SURROUND_GAIN;
+        return;
+    }
+    if (channels >= 5) {
+        left[2] = right[2] = CENTER_GAIN;
+    }
+    if (channels == 5) {
+        // 4.1: FL FR LFE BL BR
+        left[2] = right[2] = 0.0f;
+        left[3] = SURROUND_GAIN;
+        right[4] = SURROUND_GAIN;
+        return;
+    }
+    if (channels >= 6) {
+        left[4] = SURROUND_GAIN;
+        right[5] = SURROUND_GAIN;
+    }
+    if (channels == 7) {
+        // 6.1: back center feeds both sides
+        left[4] = right[4] = SURROUND_GAIN;
+        left[5] = SURROUND_GAIN;
+        right[5] = 0.0f;
+        right[6] = SURROUND_GAIN;
+    }
+    if (channels == 8) {
+        left[6] = SURROUND_GAIN;
+        right[7] = SURROUND_GAIN;
+    }
+}
+
+bool ChannelDownmixer::configure(int channels) {
+    if (channels < 1 || channels > MAX_CHANNELS) {
+        _channels = 0;
+        return false;
+    }
+    defaultWeights(channels, _left.data(), _right.data());
+    _channels = channels;
+    return true;
+}
+
+bool ChannelDownmixer::configure(int channels, const std::string& weights) {
+    if (!configure(channels)) {
+        return false;
+    }
+    if (AutoVibez::Utils::StringUtils::trim(weights).empty()) {
+        return true;
+    }
+
+    std::array<float, MAX_CHANNELS> left{};
+    std::array<float, MAX_CHANNELS> right{};
+    std::stringstream stream(weights);
+    std::string pair;
+    int index = 0;
+    while (std::getline(stream, pair, ',')) {
+        size_t colon = pair.find(':');
+        if (index >= channels || colon == std::string::npos) {
+            return false;
+        }
+        try {
+            left[index] = std::stof(pair.substr(0, colon));
+            right[index] = std::stof(pair.substr(colon + 1));
+        } catch (const std::exception&) {
+            return false;
+        }
+        ++index;
+    }
+    if (index != channels) {
+        return false;
+    }
+
+    _left = left;
+    _right = right;
+    return true;
+}
+
+void ChannelDownmixer::process(const float* input, int frames, float* output) const {
+    const int channels = _channels;
+    if (channels <= 0) {
+        return;
+    }
+
+    if (channels == 2 && _left[0] == 1.0f && _right[1] == 1.0f && _left[1] == 0.0f && _right[0] == 0.0f) {
+        for (int i = 0; i < frames * 2; ++i) {
+            output[i] = input[i];
+        }
+        return;
+    }
+
+    const int vectorChannels = channels & ~3;
+
+#if defined(AUTOVIBEZ_DOWNMIX_SSE2)
+    __m128 leftWeights[MAX_CHANNELS / 4];
+    __m128 rightWeights[MAX_CHANNELS / 4];
+    for (int c = 0; c < vectorChannels; c += 4) {
+        leftWeights[c / 4] = _mm_load_ps(&_left[c]);
+        rightWeights[c / 4] = _mm_load_ps(&_right[c]);
+    }
+#elif defined(AUTOVIBEZ_DOWNMIX_NEON)
+    float32x4_t leftWeights[MAX_CHANNELS / 4];
+    float32x4_t rightWeights[MAX_CHANNELS / 4];
+    for (int c = 0; c < vectorChannels; c += 4) {
+        leftWeights[c / 4] = vld1q_f32(&_left[c]);
+        rightWeights[c / 4] = vld1q_f32(&_right[c]);
+    }
+#endif
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const float* in = input + frame * channels;
+        float left = 0.0f;
+        float right = 0.0f;
+        int c = 0;
+
+#if defined(AUTOVIBEZ_DOWNMIX_SSE2)
+        __m128 accLeft = _mm_setzero_ps();
+        __m128 accRight = _mm_setzero_ps();
+        for (; c < vectorChannels; c += 4) {
+            __m128 samples = _mm_loadu_ps(in + c);
+            accLeft = _mm_add_ps(accLeft, _mm_mul_ps(samples, leftWeights[c / 4]));
+            accRight = _mm_add_ps(accRight, _mm_mul_ps(samples, rightWeights[c / 4]));
+        }
+        // Horizontal sums: interleave so one shuffle/add pass reduces both accumulators
+        __m128 lo = _mm_unpacklo_ps(accLeft, accRight);  // l0 r0 l1 r1
+        __m128 hi = _mm_unpackhi_ps(accLeft, accRight);  // l2 r2 l3 r3
+        __m128 sum = _mm_add_ps(lo, hi);                 // l02 r02 l13 r13
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));  // l r . .
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, sum);
+        left = lanes[0];
+        right = lanes[1];
+#elif defined(AUTOVIBEZ_DOWNMIX_NEON)
+        float32x4_t accLeft = vdupq_n_f32(0.0f);
+        float32x4_t accRight = vdupq_n_f32(0.0f);
+        for (; c < vectorChannels; c += 4) {
+            float32x4_t samples = vld1q_f32(in + c);
+            accLeft = vmlaq_f32(accLeft, samples, leftWeights[c / 4]);
+            accRight = vmlaq_f32(accRight, samples, rightWeights[c / 4]);
+        }
+        float32x2_t l2 = vadd_f32(vget_low_f32(accLeft), vget_high_f32(accLeft));
+        float32x2_t r2 = vadd_f32(vget_low_f32(accRight), vget_high_f32(accRight));
+        left = vget_lane_f32(vpadd_f32(l2, l2), 0);
+        right = vget_lane_f32(vpadd_f32(r2, r2), 0);
+#endif
+
+        for (; c < channels; ++c) {
+            left += in[c] * _left[c];
+            right += in[c] * _right[c];
+        }
+
+        output[frame * 2] = left;
+        output[frame * 2 + 1] = right;
+    }
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Folds N-channel interleaved float PCM into stereo
+ *
+ * Weights are configured up front on a non-real-time thread; process() does no
+ * allocation, locking or logging and is safe to call from the audio callback.
+ * Uses SSE2 or NEON when available, with a scalar fallback.
+ */
+class ChannelDownmixer {
+public:
+    static constexpr int MAX_CHANNELS = 8;
+
+    ChannelDownmixer();
+
+    /**
+     * @brief Configure default ITU-style weights for a channel count
+     * @param channels Number of input channels (1-8)
+     * @return True if the layout is supported
+     */
+    bool configure(int channels);
+
+    /**
+     * @brief Configure explicit per-channel weights
+     * @param channels Number of input channels (1-8)
+     * @param weights Spec of the form "l:r,l:r,..." with one pair per channel
+     * @return True if the spec was valid; on failure the defaults for channels are used
+     */
+    bool configure(int channels, const std::string& weights);
+
+    /**
+     * @brief Downmix interleaved input into interleaved stereo
+     * @param input Interleaved samples, frames * getChannels() long
+     * @param frames Number of frames to process
+     * @param output Destination, frames * 2 long
+     */
+    void process(const float* input, int frames, float* output) const;
+
+    /**
+     * @brief Get the configured input channel count (0 if unconfigured)
+     */
+    int getChannels() const {
+        return _channels;
+    }
+
+    /**
+     * @brief Get the left/right weight pair for a channel
+     */
+    float getLeftWeight(int channel) const {
+        return _left[channel];
+    }
+    float getRightWeight(int channel) const {
+        return _right[channel];
+    }
+
+private:
+    static void defaultWeights(int channels, float* left, float* right);
+
+    int _channels = 0;
+    alignas(16) std::array<float, MAX_CHANNELS> _left{};
+    alignas(16) std::array<float, MAX_CHANNELS> _right{};
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,262 @@
+#include "deck_mixer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr int DECK_CHANNELS = 2;
+constexpr double HALF_PI = 1.57079632679489661923;
+constexpr float S16_TO_FLOAT = 1.0f / 32768.0f;
+
+inline int16_t toS16(float value) {
+    value = std::clamp(value, -1.0f, 1.0f);
+    return static_cast<int16_t>(std::lrint(value * 32767.0f));
+}
+}  // namespace
+
+DeckMixer::DeckMixer()
+    : _scratch(static_cast<size_t>(Constants::DECK_MIX_BLOCK_FRAMES) * DECK_CHANNELS),
+      _mix(static_cast<size_t>(Constants::DECK_MIX_BLOCK_FRAMES) * DECK_CHANNELS) {}
+
+DeckMixer::~DeckMixer() = default;
+
+void DeckMixer::play(std::unique_ptr<PcmSource> source) {
+    std::unique_ptr<PcmSource> evictedLive;
+    std::unique_ptr<PcmSource> evictedOther;
+    std::unique_ptr<PcmSource> evictedQueued;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _live = 0;
+        resetDeck(_decks[0], std::move(source), evictedLive);
+        resetDeck(_decks[1], nullptr, evictedOther);
+        evictedQueued = std::move(_queued);
+        _queuedRetired = false;
+        _fadeRunning = false;
+        _appliedGain = _gain.load(std::memory_order_relaxed);
+        publishLiveState();
+    }
+    // Evicted decoders are destroyed here, outside the audio lock
+}
+
+void DeckMixer::crossfadeTo(std::unique_ptr<PcmSource> source, int64_t fadeFrames) {
+    if (!source) {
+        return;
+    }
+
+    std::unique_ptr<PcmSource> evictedNext;
+    std::unique_ptr<PcmSource> evictedLive;
+    std::unique_ptr<PcmSource> evictedQueued;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Deck& current = _decks[_live];
+        evictedQueued = std::move(_queued);
+        _queuedRetired = false;
+        const int next = 1 - _live;
+
+        // Reuses the idle deck; during a running fade that drops the deck already fading out
+        resetDeck(_decks[next], std::move(source), evictedNext);
+
+        if (!current.source || current.ended || fadeFrames <= 0) {
+            // Nothing audible to fade from
+            resetDeck(current, nullptr, evictedLive);
+            _fadeRunning = false;
+        } else {
+            _fadeRunning = true;
+            _fadePosition = 0;
+            _fadeFrames = fadeFrames;
+        }
+        _live = next;
+        publishLiveState();
+    }
+}
+
+void DeckMixer::stop() {
+    std::unique_ptr<PcmSource> evictedA;
+    std::unique_ptr<PcmSource> evictedB;
+    std::unique_ptr<PcmSource> evictedQueued;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        resetDeck(_decks[0], nullptr, evictedA);
+        resetDeck(_decks[1], nullptr, evictedB);
+        evictedQueued = std::move(_queued);
+        _queuedRetired = false;
+        _fadeRunning = false;
+        publishLiveState();
+    }
+}
+
+void DeckMixer::queueNext(std::unique_ptr<PcmSource> source) {
+    std::unique_ptr<PcmSource> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        evicted = std::move(_queued);
+        _queued = std::move(source);
+        _queuedRetired = false;
+        publishLiveState();
+    }
+}
+
+void DeckMixer::clearQueued() {
+    queueNext(nullptr);
+}
+
+bool DeckMixer::seek(int64_t frame) {
+    std::unique_ptr<PcmSource> evicted;
+    bool moved = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Deck& live = _decks[_live];
+        if (!live.source) {
+            return false;
+        }
+        if (_fadeRunning) {
+            resetDeck(_decks[1 - _live], nullptr, evicted);
+            _fadeRunning = false;
+        }
+        moved = live.source->seek(std::max<int64_t>(0, frame));
+        if (moved) {
+            live.position = std::max<int64_t>(0, frame);
+            live.ended = false;
+        }
+        publishLiveState();
+    }
+    return moved;
+}
+
+void DeckMixer::releaseRetired() {
+    std::unique_ptr<PcmSource> evicted;
+    std::unique_ptr<PcmSource> evictedQueued;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queuedRetired) {
+            evictedQueued = std::move(_queued);
+            _queuedRetired = false;
+        }
+        Deck& idle = _decks[1 - _live];
+        if (!_fadeRunning && idle.source) {
+            resetDeck(idle, nullptr, evicted);
+        }
+    }
+}
+
+void DeckMixer::render(int16_t* out, int frames, int channels) {
+    if (!out || frames <= 0 || channels <= 0) {
+        return;
+    }
+    std::fill(out, out + static_cast<size_t>(frames) * channels, static_cast<int16_t>(0));
+
+    // Paused decks hold their position
+    if (_paused.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const float targetGain = _gain.load(std::memory_order_relaxed);
+
+    for (int offset = 0; offset < frames;) {
+        const int block = std::min(frames - offset, Constants::DECK_MIX_BLOCK_FRAMES);
+        std::fill(_mix.begin(), _mix.begin() + static_cast<size_t>(block) * DECK_CHANNELS, 0.0f);
+
+        Deck& live = _decks[_live];
+        if (_fadeRunning) {
+            // Equal-power curves: cos^2 + sin^2 = 1 keeps perceived loudness flat through the overlap
+            const double fadeFrames = static_cast<double>(_fadeFrames);
+            int got = pullDeck(_decks[1 - _live], block, false);
+            for (int i = 0; i < got; ++i) {
+                double t = std::min(1.0, static_cast<double>(_fadePosition + i) / fadeFrames);
+                float gain = static_cast<float>(std::cos(t * HALF_PI)) * S16_TO_FLOAT;
+                _mix[2 * i] += _scratch[2 * i] * gain;
+                _mix[2 * i + 1] += _scratch[2 * i + 1] * gain;
+            }
+            got = pullDeck(live, block, true);
+            for (int i = 0; i < got; ++i) {
+                double t = std::min(1.0, static_cast<double>(_fadePosition + i) / fadeFrames);
+                float gain = static_cast<float>(std::sin(t * HALF_PI)) * S16_TO_FLOAT;
+                _mix[2 * i] += _scratch[2 * i] * gain;
+                _mix[2 * i + 1] += _scratch[2 * i + 1] * gain;
+            }
+            _fadePosition += block;
+            if (_fadePosition >= _fadeFrames) {
+                _fadeRunning = false;
+            }
+        } else {
+            int got = pullDeck(live, block, true);
+            for (int i = 0; i < got * DECK_CHANNELS; ++i) {
+                _mix[i] = _scratch[i] * S16_TO_FLOAT;
+            }
+        }
+
+        // Ramp master gain across the block so volume changes never click
+        const float gainStep = (targetGain - _appliedGain) / static_cast<float>(block);
+        int16_t* dest = out + static_cast<size_t>(offset) * channels;
+        for (int i = 0; i < block; ++i) {
+            float gain = _appliedGain + gainStep * static_cast<float>(i + 1);
+            float left = _mix[2 * i] * gain;
+            float right = _mix[2 * i + 1] * gain;
+            if (channels == 1) {
+                dest[i] = toS16(0.5f * (left + right));
+            } else {
+                dest[i * channels] = toS16(left);
+                dest[i * channels + 1] = toS16(right);
+            }
+        }
+        _appliedGain = targetGain;
+        offset += block;
+    }
+
+    publishLiveState();
+}
+
+int DeckMixer::pullDeck(Deck& deck, int frames, bool allowAdvance) {
+    if (!deck.source || deck.ended) {
+        return 0;
+    }
+
+    int total = 0;
+    while (total < frames) {
+        int got = deck.source->read(_scratch.data() + static_cast<size_t>(total) * DECK_CHANNELS, frames - total);
+        if (got > 0) {
+            total += got;
+            deck.position += got;
+            continue;
+        }
+
+        if (allowAdvance && _queued && !_queuedRetired) {
+            // Gapless hand-off: swap in the queued source and park the finished one for the control thread
+            std::swap(deck.source, _queued);
+            _queuedRetired = true;
+            deck.position = 0;
+            _advanceCount.fetch_add(1, std::memory_order_acq_rel);
+            continue;
+        }
+
+        deck.ended = true;
+        break;
+    }
+    return total;
+}
+
+void DeckMixer::resetDeck(Deck& deck, std::unique_ptr<PcmSource> source, std::unique_ptr<PcmSource>& evicted) {
+    evicted = std::move(deck.source);
+    deck.source = std::move(source);
+    deck.position = 0;
+    deck.ended = !deck.source;
+}
+
+void DeckMixer::publishLiveState() {
+    const Deck& live = _decks[_live];
+    _loaded.store(live.source != nullptr, std::memory_order_release);
+    _finished.store(live.source && live.ended && !_fadeRunning, std::memory_order_release);
+    _fading.store(_fadeRunning, std::memory_order_release);
+    _fadeProgress.store(_fadeRunning && _fadeFrames > 0 ? static_cast<int>(_fadePosition * 100 / _fadeFrames) : 100,
+                        std::memory_order_relaxed);
+    _positionFrames.store(live.position, std::memory_order_relaxed);
+    _lengthFrames.store(live.source ? live.source->getLengthFrames() : -1, std::memory_order_relaxed);
+    _hasQueued.store(_queued && !_queuedRetired, std::memory_order_release);
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pcm_source.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Two-deck PCM mixer with sample-accurate equal-power crossfades
+ *
+ * The control thread loads sources onto decks; the audio thread pulls mixed output
+ * through render(), which advances the fade curve per frame. Sources are never
+ * destroyed on the audio thread: a deck that has faded out stays parked until the
+ * control thread calls releaseRetired() (or loads something new).
+ *
+ * A source can also be queued behind the live deck; when the live deck runs dry the
+ * queued one continues inside the same render block, so the hand-off has no gap.
+ */
+class DeckMixer {
+public:
+    DeckMixer();
+    ~DeckMixer();
+
+    DeckMixer(const DeckMixer&) = delete;
+    DeckMixer& operator=(const DeckMixer&) = delete;
+
+    /**
+     * @brief Replace everything with a single source at full gain (hard cut)
+     */
+    void play(std::unique_ptr<PcmSource> source);
+
+    /**
+     * @brief Fade the current deck out and the new source in over fadeFrames
+     *
+     * Falls back to play() when nothing is loaded. A fade that is still running is
+     * cut short: its outgoing deck is dropped and the previous incoming deck fades out.
+     */
+    void crossfadeTo(std::unique_ptr<PcmSource> source, int64_t fadeFrames);
+
+    /**
+     * @brief Unload both decks
+     */
+    void stop();
+
+    /**
+     * @brief Continue with this source as soon as the live deck reaches its end
+     *
+     * Replaces any previously queued source. Cleared by play(), crossfadeTo() and stop().
+     */
+    void queueNext(std::unique_ptr<PcmSource> source);
+
+    /**
+     * @brief Drop the queued source, if any
+     */
+    void clearQueued();
+
+    /**
+     * @brief Move the live deck to a frame; a running crossfade completes at once
+     * @return True if the source could seek there
+     */
+    bool seek(int64_t frame);
+
+    bool hasQueued() const {
+        return _hasQueued.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Number of gapless hand-offs to a queued source so far
+     */
+    uint32_t getAdvanceCount() const {
+        return _advanceCount.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Produce interleaved S16 output (audio thread)
+     * @param out Destination buffer of frames * channels samples
+     * @param frames Number of frames to render
+     * @param channels Output channel count; stereo is folded down for mono outputs
+     */
+    void render(int16_t* out, int frames, int channels);
+
+    /**
+     * @brief Destroy sources the audio thread has finished with (control thread)
+     */
+    void releaseRetired();
+
+    void setPaused(bool paused) {
+        _paused.store(paused, std::memory_order_relaxed);
+    }
+    bool isPaused() const {
+        return _paused.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Master gain applied after the deck mix (0.0-1.0)
+     */
+    void setGain(float gain) {
+        _gain.store(gain, std::memory_order_relaxed);
+    }
+    float getGain() const {
+        return _gain.load(std::memory_order_relaxed);
+    }
+
+    bool isLoaded() const {
+        return _loaded.load(std::memory_order_acquire);
+    }
+    bool isFinished() const {
+        return _finished.load(std::memory_order_acquire);
+    }
+    bool isCrossfading() const {
+        return _fading.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Fade progress as a percentage (100 when no fade is running)
+     */
+    int getCrossfadeProgress() const {
+        return _fadeProgress.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Frames rendered from the live deck since it was loaded
+     */
+    int64_t getPositionFrames() const {
+        return _positionFrames.load(std::memory_order_relaxed);
+    }
+    int64_t getLengthFrames() const {
+        return _lengthFrames.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Deck {
+        std::unique_ptr<PcmSource> source;
+        int64_t position = 0;
+        bool ended = false;
+    };
+
+    int pullDeck(Deck& deck, int frames, bool allowAdvance);
+    void resetDeck(Deck& deck, std::unique_ptr<PcmSource> source, std::unique_ptr<PcmSource>& evicted);
+    void publishLiveState();
+
+    std::mutex _mutex;
+    Deck _decks[2];
+    int _live = 0;             //!< Deck that is playing (or fading in)
+    bool _fadeRunning = false;  //!< Guarded by _mutex; _fading mirrors it for readers
+    int64_t _fadePosition = 0;
+    int64_t _fadeFrames = 0;
+    float _appliedGain = 1.0f;  //!< Audio-thread copy of _gain, ramped per block
+
+    // Gapless follow-up; after the hand-off it holds the finished source until releaseRetired()
+    std::unique_ptr<PcmSource> _queued;
+    bool _queuedRetired = false;
+
+    std::vector<int16_t> _scratch;
+    std::vector<float> _mix;
+
+    std::atomic<bool> _paused{false};
+    std::atomic<float> _gain{1.0f};
+    std::atomic<bool> _loaded{false};
+    std::atomic<bool> _finished{false};
+    std::atomic<bool> _fading{false};
+    std::atomic<int> _fadeProgress{100};
+    std::atomic<int64_t> _positionFrames{0};
+    std::atomic<int64_t> _lengthFrames{-1};
+    std::atomic<bool> _hasQueued{false};
+    std::atomic<uint32_t> _advanceCount{0};
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "download_progress.hpp"
+#include "error_handler.hpp"
+#include "mapped_file.hpp"
+#include "pcm_source.hpp"
+#include "seek_index.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Compressed-audio decoder behind MixPlayer: stereo S16 at a fixed output rate
+ *
+ * MixPlayer only talks to this interface, so the backend (see DecoderBackend) is
+ * chosen once per process from the configuration and hardware profile.
+ */
+class Decoder : public PcmSource, public ::AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @brief Decode from an existing mapping
+     * @param mapping Mapped file; kept alive for as long as the decoder is open
+     * @param outputRate Sample rate the decoder should produce
+     * @return True if successful, false otherwise
+     */
+    virtual bool openMapped(std::shared_ptr<const ::AutoVibez::Utils::MappedFile> mapping, int outputRate) = 0;
+
+    /**
+     * @brief Open a partially downloaded file for progressive decoding
+     * @param path Path of the file being written
+     * @param progress Download counters that bound how far the file may be read
+     * @param outputRate Sample rate the decoder should produce
+     * @return True if successful, false otherwise
+     */
+    virtual bool openGrowing(const std::string& path,
+                             std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress,
+                             int outputRate) = 0;
+
+    /**
+     * @brief Seed the decoder with a stored index: direct seeks and an exact length
+     * @return True if successful, false if it does not fit this file
+     */
+    virtual bool applySeekIndex(const SeekIndex& index) = 0;
+
+    /**
+     * @brief Scale the decoded output before conversion to S16
+     * @param linear Linear gain factor, 1.0 leaves the signal untouched
+     * @return True if successful, false otherwise
+     */
+    virtual bool setGain(double linear) = 0;
+
+    /**
+     * @brief Name of the backend and synthesis path in use, e.g. "mpg123/NEON64"
+     */
+    virtual std::string getBackendName() const = 0;
+};
+
+}  // namespace AutoVibez::Audio
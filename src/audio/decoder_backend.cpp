@@ -0,0 +1,49 @@
+#include "decoder_backend.hpp"
+
+#include "mp3_decoder.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Audio {
+
+namespace {
+// Low profile preference: SIMD synths, then the integer ARM one, then the portable fallback
+const char* const LOW_CPU_SYNTHS[] = {"NEON64", "NEON", "AVX", "x86-64", "SSE", "ARM", "generic"};
+
+const std::string* findSynth(const std::vector<std::string>& supported, const std::string& name) {
+    const std::string wanted = ::AutoVibez::Utils::StringUtils::toLower(name);
+    for (const std::string& synth : supported) {
+        if (::AutoVibez::Utils::StringUtils::toLower(synth) == wanted) {
+            return &synth;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+bool DecoderBackend::select(const std::string& configured, const std::string& profile,
+                            const std::vector<std::string>& supported, std::string& synth) {
+    synth.clear();
+    const bool automatic = ::AutoVibez::Utils::StringUtils::toLower(configured) == "auto";
+    if (!automatic) {
+        if (const std::string* match = findSynth(supported, configured)) {
+            synth = *match;
+            return true;
+        }
+    }
+
+    if (profile == "low") {
+        for (const char* name : LOW_CPU_SYNTHS) {
+            if (const std::string* match = findSynth(supported, name)) {
+                synth = *match;
+                break;
+            }
+        }
+    }
+    return automatic;
+}
+
+std::unique_ptr<Decoder> DecoderBackend::create(const std::string& synth) {
+    return std::make_unique<Mp3Decoder>(synth);
+}
+
+}  // namespace AutoVibez::Audio
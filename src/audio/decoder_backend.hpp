@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "decoder.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Chooses and creates the decoder MixPlayer plays mixes through
+ *
+ * The one backend is libmpg123; what varies is its synthesis path. Left to itself
+ * libmpg123 probes the CPU, which is what medium and high profiles get. The low
+ * profile pins the leanest path the build supports: a SIMD synth where there is
+ * one, the integer ARM synth on cores without NEON, never a dithering variant.
+ */
+class DecoderBackend {
+public:
+    /**
+     * @brief Pick the synthesis path from the decoder_backend setting and the hardware profile
+     * @param configured "auto" or a libmpg123 decoder name (case-insensitive)
+     * @param profile Hardware profile: low, medium or high
+     * @param supported Mp3Decoder::getSupportedSynths()
+     * @param synth Receives the decoder name, empty for libmpg123's own choice
+     * @return False if a configured name is not supported here; synth then follows the profile
+     */
+    static bool select(const std::string& configured, const std::string& profile,
+                       const std::vector<std::string>& supported, std::string& synth);
+
+    /**
+     * @brief New, unopened decoder on the given synth (empty for libmpg123's own choice)
+     */
+    static std::unique_ptr<Decoder> create(const std::string& synth);
+};
+
+}  // namespace AutoVibez::Audio
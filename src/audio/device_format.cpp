@@ -0,0 +1,57 @@
+#include "device_format.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstring>
+
+namespace AutoVibez::Audio {
+
+namespace {
+// Rates outside this range are more likely a backend quirk than a real device
+constexpr int MIN_NATIVE_RATE = 8000;
+constexpr int MAX_NATIVE_RATE = 192000;
+}  // namespace
+
+bool queryDeviceFormat(const char* deviceName, bool capture, DeviceFormat& format) {
+    format = DeviceFormat{};
+    SDL_AudioSpec spec;
+    SDL_zero(spec);
+    bool found = false;
+    const int iscapture = capture ? 1 : 0;
+
+    if (!deviceName) {
+#if SDL_VERSION_ATLEAST(2, 24, 0)
+        char* name = nullptr;
+        found = SDL_GetDefaultAudioInfo(&name, &spec, iscapture) == 0;
+        if (name) {
+            SDL_free(name);
+        }
+#endif
+    } else {
+#if SDL_VERSION_ATLEAST(2, 0, 16)
+        const int count = SDL_GetNumAudioDevices(iscapture);
+        for (int i = 0; i < count && !found; ++i) {
+            const char* name = SDL_GetAudioDeviceName(i, iscapture);
+            if (name && std::strcmp(name, deviceName) == 0) {
+                found = SDL_GetAudioDeviceSpec(i, iscapture, &spec) == 0;
+            }
+        }
+#endif
+    }
+
+    if (!found || spec.freq <= 0) {
+        return false;
+    }
+    format.sample_rate = spec.freq;
+    format.period_frames = spec.samples;
+    return true;
+}
+
+int chooseSampleRate(const DeviceFormat& format, int fallback) {
+    if (format.sample_rate < MIN_NATIVE_RATE || format.sample_rate > MAX_NATIVE_RATE) {
+        return fallback;
+    }
+    return format.sample_rate;
+}
+
+}  // namespace AutoVibez::Audio
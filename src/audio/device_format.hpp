@@ -0,0 +1,30 @@
+#pragma once
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Format a device runs at natively, as far as SDL can tell
+ */
+struct DeviceFormat {
+    int sample_rate = 0;    //!< Hz, 0 if unknown
+    int period_frames = 0;  //!< Frames per device period, 0 if unknown
+};
+
+/**
+ * @brief Query a device's native format so streams can be opened without resampling
+ *
+ * Needs SDL 2.0.16 for named devices and SDL 2.24 for the default device; older SDL
+ * reports nothing and callers keep their defaults. SDL audio must be initialized.
+ * @param deviceName Device name from SDL_GetAudioDeviceName, or nullptr for the default device
+ * @param capture True for a recording device, false for playback
+ * @param format Receives whatever the backend reported
+ * @return True if at least the sample rate is known
+ */
+bool queryDeviceFormat(const char* deviceName, bool capture, DeviceFormat& format);
+
+/**
+ * @brief Rate to request when opening a stream: the native rate if known and sane, else the fallback
+ */
+int chooseSampleRate(const DeviceFormat& format, int fallback);
+
+}  // namespace AutoVibez::Audio
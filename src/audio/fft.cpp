@@ -0,0 +1,114 @@
+#include "fft.hpp"
+
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUTOVIBEZ_FFT_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUTOVIBEZ_FFT_NEON 1
+#endif
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+
+// Butterflies for j in [begin, end) of one group: a = top half, b = bottom half, w = stage twiddles
+inline void scalarButterflies(float* ar, float* ai, float* br, float* bi, const float* wr, const float* wi, int begin,
+                              int end) {
+    for (int j = begin; j < end; ++j) {
+        float tr = wr[j] * br[j] - wi[j] * bi[j];
+        float ti = wr[j] * bi[j] + wi[j] * br[j];
+        br[j] = ar[j] - tr;
+        bi[j] = ai[j] - ti;
+        ar[j] += tr;
+        ai[j] += ti;
+    }
+}
+}  // namespace
+
+Fft::Fft(int size) : _size(size < 2 ? 2 : size) {
+    int bits = 0;
+    while ((1 << bits) < _size) {
+        ++bits;
+    }
+    _size = 1 << bits;
+
+    _bitReverse.resize(_size);
+    for (int i = 0; i < _size; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        _bitReverse[i] = reversed;
+    }
+
+    _twiddleRe.assign(_size, 0.0f);
+    _twiddleIm.assign(_size, 0.0f);
+    for (int half = 1; half < _size; half <<= 1) {
+        for (int j = 0; j < half; ++j) {
+            double angle = -PI * j / half;
+            _twiddleRe[half + j] = static_cast<float>(std::cos(angle));
+            _twiddleIm[half + j] = static_cast<float>(std::sin(angle));
+        }
+    }
+}
+
+void Fft::forward(float* re, float* im) const {
+    for (int i = 0; i < _size; ++i) {
+        int j = _bitReverse[i];
+        if (j > i) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    for (int half = 1; half < _size; half <<= 1) {
+        const float* wr = _twiddleRe.data() + half;
+        const float* wi = _twiddleIm.data() + half;
+        for (int group = 0; group < _size; group += 2 * half) {
+            float* ar = re + group;
+            float* ai = im + group;
+            float* br = ar + half;
+            float* bi = ai + half;
+            int j = 0;
+#if defined(AUTOVIBEZ_FFT_SSE2)
+            for (; j + 4 <= half; j += 4) {
+                __m128 twr = _mm_loadu_ps(wr + j);
+                __m128 twi = _mm_loadu_ps(wi + j);
+                __m128 xr = _mm_loadu_ps(br + j);
+                __m128 xi = _mm_loadu_ps(bi + j);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(twr, xr), _mm_mul_ps(twi, xi));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(twr, xi), _mm_mul_ps(twi, xr));
+                __m128 yr = _mm_loadu_ps(ar + j);
+                __m128 yi = _mm_loadu_ps(ai + j);
+                _mm_storeu_ps(br + j, _mm_sub_ps(yr, tr));
+                _mm_storeu_ps(bi + j, _mm_sub_ps(yi, ti));
+                _mm_storeu_ps(ar + j, _mm_add_ps(yr, tr));
+                _mm_storeu_ps(ai + j, _mm_add_ps(yi, ti));
+            }
+#elif defined(AUTOVIBEZ_FFT_NEON)
+            for (; j + 4 <= half; j += 4) {
+                float32x4_t twr = vld1q_f32(wr + j);
+                float32x4_t twi = vld1q_f32(wi + j);
+                float32x4_t xr = vld1q_f32(br + j);
+                float32x4_t xi = vld1q_f32(bi + j);
+                float32x4_t tr = vmlsq_f32(vmulq_f32(twr, xr), twi, xi);
+                float32x4_t ti = vmlaq_f32(vmulq_f32(twr, xi), twi, xr);
+                float32x4_t yr = vld1q_f32(ar + j);
+                float32x4_t yi = vld1q_f32(ai + j);
+                vst1q_f32(br + j, vsubq_f32(yr, tr));
+                vst1q_f32(bi + j, vsubq_f32(yi, ti));
+                vst1q_f32(ar + j, vaddq_f32(yr, tr));
+                vst1q_f32(ai + j, vaddq_f32(yi, ti));
+            }
+#endif
+            scalarButterflies(ar, ai, br, bi, wr, wi, j, half);
+        }
+    }
+}
+
+}  // namespace AutoVibez::Audio
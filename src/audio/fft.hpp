@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief In-place radix-2 complex FFT on split real/imaginary arrays
+ *
+ * Twiddles are stored per stage so every butterfly pass reads them contiguously; passes
+ * with four or more butterflies per group use SSE2 or NEON when available, with a scalar
+ * fallback. Tables are built in the constructor and forward() never allocates, so it is
+ * safe to call from the audio callback.
+ */
+class Fft {
+public:
+    /**
+     * @brief Prepare tables for one transform size
+     * @param size Transform length (rounded up to a power of two, at least 2)
+     */
+    explicit Fft(int size);
+
+    int size() const {
+        return _size;
+    }
+
+    /**
+     * @brief Forward transform (no scaling)
+     * @param re Real parts, size() long; replaced by the spectrum
+     * @param im Imaginary parts, size() long; replaced by the spectrum
+     */
+    void forward(float* re, float* im) const;
+
+private:
+    int _size;
+    std::vector<int> _bitReverse;
+    std::vector<float> _twiddleRe;  // Stage with half-length h uses entries [h, 2h)
+    std::vector<float> _twiddleIm;
+};
+
+}  // namespace AutoVibez::Audio
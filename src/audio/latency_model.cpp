@@ -0,0 +1,121 @@
+#include "latency_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr double SMOOTHING = 0.1;  // Weight of each new measurement
+constexpr double CLICK_FREQUENCY_HZ = 1000.0;
+constexpr double CLICK_AMPLITUDE = 0.8;
+constexpr double PI = 3.14159265358979323846;
+
+double smooth(double current, double sample) {
+    return current < 0.0 ? sample : current + SMOOTHING * (sample - current);
+}
+
+double framesToMs(double frames, int sample_rate) {
+    return sample_rate > 0 ? 1000.0 * frames / sample_rate : 0.0;
+}
+}  // namespace
+
+void LatencyModel::setCapturePeriod(int frames, int sample_rate) {
+    _captureMs = framesToMs(std::max(0, frames), sample_rate);
+}
+
+void LatencyModel::setStreamRate(int sample_rate) {
+    if (sample_rate > 0) {
+        _streamRate = sample_rate;
+    }
+}
+
+void LatencyModel::setOutputBuffer(int frames, int sample_rate) {
+    _outputMs = framesToMs(std::max(0, frames), sample_rate);
+}
+
+void LatencyModel::setDisplayQueueFrames(int frames) {
+    _displayQueueFrames = std::max(0, frames);
+}
+
+void LatencyModel::noteRingBacklog(size_t samples) {
+    _backlogFrames = smooth(_backlogFrames, static_cast<double>(samples) / 2.0);
+}
+
+void LatencyModel::noteRenderTime(double ms) {
+    _renderMs = smooth(_renderMs, std::max(0.0, ms));
+}
+
+void LatencyModel::noteFrameInterval(double ms) {
+    _frameIntervalMs = smooth(_frameIntervalMs, std::max(0.0, ms));
+}
+
+LatencyBreakdown LatencyModel::getBreakdown() const {
+    LatencyBreakdown latency;
+    latency.capture_ms = _path == LatencyPath::Capture ? _captureMs : 0.0;
+    latency.queue_ms = framesToMs(std::max(0.0, _backlogFrames), _streamRate);
+    latency.window_ms = framesToMs(Constants::PROJECTM_PCM_WINDOW_FRAMES / 2.0, _streamRate);
+    latency.render_ms = std::max(0.0, _renderMs);
+    latency.display_ms = _displayQueueFrames * std::max(0.0, _frameIntervalMs);
+    latency.output_ms = _path == LatencyPath::Playback ? _outputMs : 0.0;
+    latency.offset_ms = _offsetMs;
+
+    // The playback tap runs ahead of the speakers by the mixer buffer, which hides part of the video lag
+    latency.lag_ms = latency.capture_ms + latency.queue_ms + latency.window_ms + latency.render_ms +
+                     latency.display_ms - latency.output_ms + latency.offset_ms;
+    return latency;
+}
+
+int LatencyModel::getPlaybackDelayFrames(int sample_rate) const {
+    if (_path != LatencyPath::Playback || sample_rate <= 0) {
+        return 0;
+    }
+    const double delayMs = std::clamp(getBreakdown().lag_ms, 0.0, static_cast<double>(Constants::MAX_AV_DELAY_MS));
+    return static_cast<int>(std::lround(delayMs * sample_rate / 1000.0));
+}
+
+int64_t LatencyModel::getResidualLeadFrames(int sample_rate) const {
+    if (sample_rate <= 0) {
+        return 0;
+    }
+    const double delayedMs = framesToMs(getPlaybackDelayFrames(sample_rate), sample_rate);
+    const double residualMs = std::max(0.0, getBreakdown().lag_ms - delayedMs);
+    return static_cast<int64_t>(std::llround(residualMs * sample_rate / 1000.0));
+}
+
+bool CalibrationClickDetector::process(const float* samples, size_t count, int sample_rate) {
+    const int64_t holdoff = static_cast<int64_t>(sample_rate) * Constants::CALIBRATION_CLICK_HOLDOFF_MS / 1000;
+    bool detected = false;
+    for (size_t i = 0; i + 1 < count; i += 2) {
+        const float peak = std::max(std::fabs(samples[i]), std::fabs(samples[i + 1]));
+        if (peak >= Constants::CALIBRATION_CLICK_THRESHOLD) {
+            // A click already sounding when calibration starts is not a reference point
+            detected = detected || (_quietFrames >= holdoff);
+            _quietFrames = 0;
+        } else if (_quietFrames >= 0) {
+            ++_quietFrames;
+        } else {
+            _quietFrames = 0;
+        }
+    }
+    return detected;
+}
+
+void renderCalibrationClicks(int16_t* samples, int frames, int channels, int sample_rate, int64_t& position) {
+    if (sample_rate <= 0 || channels <= 0) {
+        return;
+    }
+    const int64_t interval = static_cast<int64_t>(sample_rate) * Constants::CALIBRATION_CLICK_INTERVAL_MS / 1000;
+    const int64_t length = static_cast<int64_t>(sample_rate) * Constants::CALIBRATION_CLICK_MS / 1000;
+    for (int frame = 0; frame < frames; ++frame, ++position) {
+        const int64_t phase = position % interval;
+        int16_t value = 0;
+        if (phase < length) {
+            const double tone = std::sin(2.0 * PI * CLICK_FREQUENCY_HZ * phase / sample_rate);
+            value = static_cast<int16_t>(std::lround(CLICK_AMPLITUDE * 32767.0 * tone));
+        }
+        std::fill_n(samples + static_cast<size_t>(frame) * channels, channels, value);
+    }
+}
+
+}  // namespace AutoVibez::Audio
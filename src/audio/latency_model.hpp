@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Where the visualizer's PCM comes from, which decides how the lag can be compensated
+ */
+enum class LatencyPath {
+    Capture,  //!< A device records what the room hears: visuals can only be made to anticipate it
+    Playback  //!< The mix player's own output: the speakers can be held back until the visuals catch up
+};
+
+/**
+ * @brief Measured components of the audio-to-video lag, all in milliseconds
+ */
+struct LatencyBreakdown {
+    double capture_ms = 0.0;  //!< One capture period (zero for the playback tap)
+    double queue_ms = 0.0;    //!< PCM still waiting in the ring buffer after a drain
+    double window_ms = 0.0;   //!< Centre of the PCM window projectM analyzes, behind its newest sample
+    double render_ms = 0.0;   //!< Drain to swap on the render thread
+    double display_ms = 0.0;  //!< Frames queued behind the swap before they reach the screen
+    double output_ms = 0.0;   //!< Mixer buffer between the playback tap and the speakers
+    double offset_ms = 0.0;   //!< Manual calibration offset
+    double lag_ms = 0.0;      //!< How far the visuals trail the sound they were drawn from
+};
+
+/**
+ * @brief Sums the audio-to-video latency from per-frame measurements
+ *
+ * The render loop reports how long each frame took, how far apart frames are and
+ * what was left in the ring buffer; the audio side reports its period and buffer.
+ * Render and frame times are smoothed so a single slow frame does not jerk the
+ * compensation. With the playback tap the lag is cancelled by delaying the speakers
+ * (getPlaybackDelayFrames); for capture it is reported as a lead for beat predictions.
+ * Not thread-safe: owned by the render thread.
+ */
+class LatencyModel {
+public:
+    void setPath(LatencyPath path) {
+        _path = path;
+    }
+    LatencyPath getPath() const {
+        return _path;
+    }
+
+    /**
+     * @brief Capture period in frames at the capture rate (0 frames for none)
+     */
+    void setCapturePeriod(int frames, int sample_rate);
+
+    /**
+     * @brief Rate of the PCM handed to projectM, used for the queue and window terms
+     */
+    void setStreamRate(int sample_rate);
+
+    /**
+     * @brief Mixer buffer in frames at the playback rate
+     */
+    void setOutputBuffer(int frames, int sample_rate);
+
+    /**
+     * @brief Frames the swap chain holds before one is scanned out (set by calibration, not measurable here)
+     */
+    void setDisplayQueueFrames(int frames);
+
+    void setManualOffsetMs(double offset_ms) {
+        _offsetMs = offset_ms;
+    }
+    double getManualOffsetMs() const {
+        return _offsetMs;
+    }
+
+    /**
+     * @brief The ring buffer held this many interleaved stereo samples after the frame's drain
+     */
+    void noteRingBacklog(size_t samples);
+
+    /**
+     * @brief Time from draining PCM to the swap for one frame
+     */
+    void noteRenderTime(double ms);
+
+    /**
+     * @brief Time between the starts of two consecutive frames (one refresh under vsync)
+     */
+    void noteFrameInterval(double ms);
+
+    LatencyBreakdown getBreakdown() const;
+
+    /**
+     * @brief Speaker delay that lines the playback tap up with the screen, capped at MAX_AV_DELAY_MS
+     * @return Frames at the given rate; 0 on the capture path or when the visuals are already ahead
+     */
+    int getPlaybackDelayFrames(int sample_rate) const;
+
+    /**
+     * @brief Lag left after the playback delay, which beat predictions should run ahead by
+     * @return Frames at the given rate, never negative
+     */
+    int64_t getResidualLeadFrames(int sample_rate) const;
+
+private:
+    LatencyPath _path = LatencyPath::Capture;
+    double _captureMs = 0.0;
+    double _outputMs = 0.0;
+    int _streamRate = Constants::DEFAULT_SAMPLE_RATE;
+    int _displayQueueFrames = Constants::DEFAULT_DISPLAY_QUEUE_FRAMES;
+    double _offsetMs = 0.0;
+
+    // Smoothed measurements; negative until the first sample arrives
+    double _backlogFrames = -1.0;
+    double _renderMs = -1.0;
+    double _frameIntervalMs = -1.0;
+};
+
+/**
+ * @brief Finds calibration clicks in drained PCM so the screen can flash when projectM sees one
+ *
+ * A click is the first sample above the threshold after at least CALIBRATION_CLICK_HOLDOFF_MS
+ * of samples below it, so one burst yields one flash however many drains it spans.
+ */
+class CalibrationClickDetector {
+public:
+    /**
+     * @brief Scan interleaved stereo samples
+     * @return True if a click starts in this block
+     */
+    bool process(const float* samples, size_t count, int sample_rate);
+
+    void reset() {
+        _quietFrames = -1;
+    }
+
+private:
+    int64_t _quietFrames = -1;  // Frames since the last loud sample; negative until the first block
+};
+
+/**
+ * @brief Overwrite an interleaved 16-bit buffer with the calibration click track
+ * @param position Running frame counter of the click track, advanced by the call
+ */
+void renderCalibrationClicks(int16_t* samples, int frames, int channels, int sample_rate, int64_t& position);
+
+}  // namespace AutoVibez::Audio
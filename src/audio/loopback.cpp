@@ -2,10 +2,16 @@
 
 #include "loopback.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 #include "autovibez_app.hpp"
 #include "utils/logger.hpp"
+
+#ifdef WASAPI_LOOPBACK
+#include <mmreg.h>
+#endif
+
 using AutoVibez::Core::AutoVibezApp;
 
 namespace AutoVibez::Audio {
@@ -17,285 +23,340 @@ std::string formatHResultError(const std::string &operation, HRESULT hr) {
     oss << operation << " failed: hr = 0x" << std::hex << std::uppercase << hr;
     return oss.str();
 }
+
+// The shared-mode mix format is float on every current Windows, but drivers may still report integer PCM
+bool sampleFormatOf(const WAVEFORMATEX *format, PcmSampleFormat &sampleFormat) {
+    DWORD tag = format->wFormatTag;
+    if (tag == WAVE_FORMAT_EXTENSIBLE && format->cbSize >= sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX)) {
+        // KSDATAFORMAT_SUBTYPE_PCM and _IEEE_FLOAT carry the plain format tag in their first field
+        tag = reinterpret_cast<const WAVEFORMATEXTENSIBLE *>(format)->SubFormat.Data1;
+    }
+    if (tag == WAVE_FORMAT_IEEE_FLOAT && format->wBitsPerSample == 32) {
+        sampleFormat = PcmSampleFormat::Float32;
+    } else if (tag == WAVE_FORMAT_PCM && format->wBitsPerSample == 16) {
+        sampleFormat = PcmSampleFormat::Int16;
+    } else if (tag == WAVE_FORMAT_PCM && format->wBitsPerSample == 32) {
+        sampleFormat = PcmSampleFormat::Int24In32;
+    } else {
+        return false;
+    }
+    return true;
+}
+#endif
+
+namespace {
+// Single process-wide loopback session, driven by the free functions below
+LoopbackCapture g_loopback;
+}  // namespace
+
+#ifdef WASAPI_LOOPBACK
+struct LoopbackCapture::WasapiState {
+    IAudioCaptureClient *captureClient = nullptr;
+    IAudioClient *audioClient = nullptr;
+    IMMDevice *device = nullptr;
+    IMMDeviceEnumerator *enumerator = nullptr;
+    WAVEFORMATEX *format = nullptr;
+    REFERENCE_TIME devicePeriod = 0;
+    UINT32 channels = 0;
+    bool comInitialized = false;
+};
+#else
+struct LoopbackCapture::WasapiState {};
 #endif
 
+LoopbackCapture::LoopbackCapture() : _wasapi(std::make_unique<WasapiState>()) {}
+
+LoopbackCapture::~LoopbackCapture() {
+    shutdown();
+}
+
 // ref
 // https://blogs.msdn.microsoft.com/matthew_van_eerde/2008/12/16/sample-wasapi-loopback-capture-record-what-you-hear/
-#ifdef WASAPI_LOOPBACK
+bool LoopbackCapture::initialize() {
+    if (_initialized) {
+        return true;
+    }
 
-// Global WASAPI resources that need cleanup
-IAudioCaptureClient *pAudioCaptureClient = nullptr;
-IAudioClient *pAudioClient = nullptr;
-IMMDevice *pMMDevice = nullptr;
-IMMDeviceEnumerator *pMMDeviceEnumerator = nullptr;
-WAVEFORMATEX *pwfx = nullptr;
-UINT32 foo = 0;
-PUINT32 pnFrames = &foo;
-UINT32 nBlockAlign = 0;
-UINT32 nPasses = 0;
-bool bFirstPacket = true;
-
-HRESULT get_default_device(IMMDevice **ppMMDevice) {
-    HRESULT hr = S_OK;
+#ifdef WASAPI_LOOPBACK
+    HRESULT hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+    if (FAILED(hr) && hr != RPC_E_CHANGED_MODE) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logError(formatHResultError("CoInitializeEx", hr));
+        return false;
+    }
+    _wasapi->comInitialized = SUCCEEDED(hr);
 
     // activate a device enumerator
     hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator),
-                          static_cast<void **>(&pMMDeviceEnumerator));
+                          reinterpret_cast<void **>(&_wasapi->enumerator));
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("CoCreateInstance(IMMDeviceEnumerator)", hr));
+        shutdown();
         return false;
     }
 
     // get the default render endpoint
-    hr = pMMDeviceEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, ppMMDevice);
+    hr = _wasapi->enumerator->GetDefaultAudioEndpoint(eRender, eConsole, &_wasapi->device);
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("IMMDeviceEnumerator::GetDefaultAudioEndpoint", hr));
+        shutdown();
         return false;
     }
 
-    return S_OK;
-}
-#endif /** WASAPI_LOOPBACK */
-
-bool initLoopback() {
-#ifdef WASAPI_LOOPBACK
-    HRESULT hr;
-
-    hr = CoInitialize(NULL);
-    if (FAILED(hr)) {
-        ::AutoVibez::Utils::Logger logger;
-        logger.logError(formatHResultError("CoInitialize", hr));
-        return false;
-    }
-
-    // open default device if not specified
-    if (NULL == pMMDevice) {
-        hr = get_default_device(&pMMDevice);
-        if (FAILED(hr)) {
-            ::AutoVibez::Utils::Logger logger;
-            logger.logError("Failed to get default audio device");
-            return false;
-        }
-    }
-
-    bool bInt16 = false;
-
     // activate an IAudioClient
-    hr = pMMDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, NULL, static_cast<void **>(&pAudioClient));
+    hr = _wasapi->device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, NULL,
+                                   reinterpret_cast<void **>(&_wasapi->audioClient));
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("IMMDevice::Activate(IAudioClient)", hr));
+        shutdown();
         return false;
     }
 
     // get the default device periodicity
-    REFERENCE_TIME hnsDefaultDevicePeriod;
-    hr = pAudioClient->GetDevicePeriod(&hnsDefaultDevicePeriod, NULL);
+    hr = _wasapi->audioClient->GetDevicePeriod(&_wasapi->devicePeriod, NULL);
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("IAudioClient::GetDevicePeriod", hr));
+        shutdown();
         return false;
     }
 
-    // get the default device format
-    hr = pAudioClient->GetMixFormat(&pwfx);
+    // get the default device format; the shared-mode mix format is 32-bit float
+    hr = _wasapi->audioClient->GetMixFormat(&_wasapi->format);
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("IAudioClient::GetMixFormat", hr));
+        shutdown();
         return false;
     }
-
-    if (bInt16) {
-        // coerce int-16 wave format
-        // can do this in-place since we're not changing the size of the format
-        // also, the engine will auto-convert from float to int for us
-        switch (pwfx->wFormatTag) {
-            case WAVE_FORMAT_IEEE_FLOAT:
-                pwfx->wFormatTag = WAVE_FORMAT_PCM;
-                pwfx->wBitsPerSample = Constants::BITS_PER_SAMPLE;
-                pwfx->nBlockAlign = pwfx->nChannels * pwfx->wBitsPerSample / 8;
-                pwfx->nAvgBytesPerSec = pwfx->nBlockAlign * pwfx->nSamplesPerSec;
-                break;
-
-            case WAVE_FORMAT_EXTENSIBLE: {
-                // naked scope for case-local variable
-                PWAVEFORMATEXTENSIBLE pEx = reinterpret_cast<PWAVEFORMATEXTENSIBLE>(pwfx);
-                if (IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat)) {
-                    pEx->SubFormat = KSDATAFORMAT_SUBTYPE_PCM;
-                    pEx->Samples.wValidBitsPerSample = Constants::BITS_PER_SAMPLE;
-                    pwfx->wBitsPerSample = Constants::BITS_PER_SAMPLE;
-                    pwfx->nBlockAlign = pwfx->nChannels * pwfx->wBitsPerSample / 8;
-                    pwfx->nAvgBytesPerSec = pwfx->nBlockAlign * pwfx->nSamplesPerSec;
-                } else {
-                    ::AutoVibez::Utils::Logger logger;
-                    logger.logError("Don't know how to coerce mix format to int-16");
-                    return E_UNEXPECTED;
-                }
-            } break;
-
-            default: {
-                ::AutoVibez::Utils::Logger logger;
-                std::ostringstream oss;
-                oss << "Don't know how to coerce WAVEFORMATEX with wFormatTag = 0x" << std::hex << std::uppercase
-                    << pwfx->wFormatTag << " to int-16";
-                logger.logError(oss.str());
-                return E_UNEXPECTED;
-            }
-        }
+    _wasapi->channels = _wasapi->format->nChannels;
+    PcmSampleFormat sampleFormat = PcmSampleFormat::Float32;
+    if (!sampleFormatOf(_wasapi->format, sampleFormat) ||
+        !_ingest.configure(static_cast<int>(_wasapi->channels), sampleFormat)) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logWarning("Loopback device format (" + std::to_string(_wasapi->channels) + " channels, " +
+                          std::to_string(_wasapi->format->wBitsPerSample) +
+                          " bits) is not supported; input will be ignored");
     }
 
-    nBlockAlign = pwfx->nBlockAlign;
-    *pnFrames = 0;
-
-    // call IAudioClient::Initialize
-    // note that AUDCLNT_STREAMFLAGS_LOOPBACK and AUDCLNT_STREAMFLAGS_EVENTCALLBACK
-    // do not work together...
-    // the "data ready" event never gets set
-    // so we're going to do a timer-driven loop
-    hr = pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_LOOPBACK, 0, 0, pwfx, 0);
+    // AUDCLNT_STREAMFLAGS_LOOPBACK and AUDCLNT_STREAMFLAGS_EVENTCALLBACK do not work together
+    // (the "data ready" event never gets set), so the capture thread is driven by a waitable
+    // timer at the device period instead
+    hr = _wasapi->audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_LOOPBACK, 0, 0,
+                                          _wasapi->format, 0);
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("pAudioClient->Initialize", hr));
+        shutdown();
         return false;
     }
 
     // activate an IAudioCaptureClient
-    hr = pAudioClient->GetService(__uuidof(IAudioCaptureClient), static_cast<void **>(&pAudioCaptureClient));
+    hr = _wasapi->audioClient->GetService(__uuidof(IAudioCaptureClient),
+                                          reinterpret_cast<void **>(&_wasapi->captureClient));
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("pAudioClient->GetService", hr));
+        shutdown();
         return false;
     }
+#endif /** WASAPI_LOOPBACK */
+
+    _initialized = true;
+    return true;
+}
+
+bool LoopbackCapture::start(PcmRingBuffer *ring) {
+#ifdef WASAPI_LOOPBACK
+    if (!_initialized || !ring) {
+        return false;
+    }
+    if (_running.load()) {
+        return true;
+    }
 
-    // call IAudioClient::Start
-    hr = pAudioClient->Start();
+    HRESULT hr = _wasapi->audioClient->Start();
     if (FAILED(hr)) {
         ::AutoVibez::Utils::Logger logger;
         logger.logError(formatHResultError("pAudioClient->Start", hr));
         return false;
     }
 
-#endif /** WASAPI_LOOPBACK */
-
+    _ring = ring;
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread(&LoopbackCapture::captureThreadMain, this);
     return true;
+#else
+    (void)ring;
+    return false;
+#endif
 }
 
-bool cleanupLoopback() {
+void LoopbackCapture::stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+    if (_thread.joinable()) {
+        _thread.join();
+    }
 #ifdef WASAPI_LOOPBACK
-    // Stop audio capture if it's running
-    if (pAudioClient) {
-        pAudioClient->Stop();
+    if (_wasapi->audioClient) {
+        _wasapi->audioClient->Stop();
     }
+#endif
+    _ring = nullptr;
+}
 
-    // Release IAudioCaptureClient
-    if (pAudioCaptureClient) {
-        pAudioCaptureClient->Release();
-        pAudioCaptureClient = nullptr;
-    }
+void LoopbackCapture::shutdown() {
+    stop();
 
-    // Release IAudioClient
-    if (pAudioClient) {
-        pAudioClient->Release();
-        pAudioClient = nullptr;
+#ifdef WASAPI_LOOPBACK
+    if (_wasapi->captureClient) {
+        _wasapi->captureClient->Release();
+        _wasapi->captureClient = nullptr;
     }
-
-    // Free WAVEFORMATEX structure
-    if (pwfx) {
-        CoTaskMemFree(pwfx);
-        pwfx = nullptr;
+    if (_wasapi->audioClient) {
+        _wasapi->audioClient->Release();
+        _wasapi->audioClient = nullptr;
+    }
+    if (_wasapi->format) {
+        CoTaskMemFree(_wasapi->format);
+        _wasapi->format = nullptr;
+    }
+    if (_wasapi->device) {
+        _wasapi->device->Release();
+        _wasapi->device = nullptr;
+    }
+    if (_wasapi->enumerator) {
+        _wasapi->enumerator->Release();
+        _wasapi->enumerator = nullptr;
     }
+    if (_wasapi->comInitialized) {
+        CoUninitialize();
+        _wasapi->comInitialized = false;
+    }
+    _wasapi->channels = 0;
+#endif
+
+    _initialized = false;
+}
 
-    // Release IMMDevice
-    if (pMMDevice) {
-        pMMDevice->Release();
-        pMMDevice = nullptr;
+void LoopbackCapture::captureThreadMain() {
+#ifdef WASAPI_LOOPBACK
+    CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+    // Register with MMCSS so capture keeps running while the render thread is busy
+    DWORD taskIndex = 0;
+    HANDLE mmcssHandle = AvSetMmThreadCharacteristicsW(L"Pro Audio", &taskIndex);
+
+    // Wake at the device period (REFERENCE_TIME is in 100 ns units)
+    HANDLE timer = CreateWaitableTimer(NULL, FALSE, NULL);
+    LONG periodMs = static_cast<LONG>(std::max<REFERENCE_TIME>(1, _wasapi->devicePeriod / 10000));
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart = -_wasapi->devicePeriod;
+    if (!timer || !SetWaitableTimer(timer, &dueTime, periodMs, NULL, NULL, FALSE)) {
+        ::AutoVibez::Utils::Logger::logRealtime(::AutoVibez::Utils::Logger::LogLevel::ERROR,
+                                                "Failed to create loopback capture timer");
+        _running.store(false);
     }
 
-    // Release IMMDeviceEnumerator
-    if (pMMDeviceEnumerator) {
-        pMMDeviceEnumerator->Release();
-        pMMDeviceEnumerator = nullptr;
+    while (_running.load(std::memory_order_acquire)) {
+        if (WaitForSingleObject(timer, 2 * static_cast<DWORD>(periodMs)) == WAIT_FAILED) {
+            break;
+        }
+        if (!drainPackets()) {
+            break;
+        }
     }
 
-    // Uninitialize COM
+    if (timer) {
+        CancelWaitableTimer(timer);
+        CloseHandle(timer);
+    }
+    if (mmcssHandle) {
+        AvRevertMmThreadCharacteristics(mmcssHandle);
+    }
     CoUninitialize();
+#endif /** WASAPI_LOOPBACK */
+}
 
-    // Reset global variables
-    nBlockAlign = 0;
-    nPasses = 0;
-    bFirstPacket = true;
-    *pnFrames = 0;
+bool LoopbackCapture::drainPackets() {
+#ifdef WASAPI_LOOPBACK
+    // drain data while it is available
+    UINT32 nNextPacketSize = 0;
+    HRESULT hr;
+    for (hr = _wasapi->captureClient->GetNextPacketSize(&nNextPacketSize); SUCCEEDED(hr) && nNextPacketSize > 0;
+         hr = _wasapi->captureClient->GetNextPacketSize(&nNextPacketSize)) {
+        BYTE *pData;
+        UINT32 nNumFramesToRead;
+        DWORD dwFlags;
 
-    return true;
+        hr = _wasapi->captureClient->GetBuffer(&pData, &nNumFramesToRead, &dwFlags, NULL, NULL);
+        if (FAILED(hr)) {
+            return false;
+        }
+
+        // A silent packet's payload is undefined, so it is replaced rather than read
+        const bool silent = (dwFlags & AUDCLNT_BUFFERFLAGS_SILENT) != 0;
+        if (!_muted.load(std::memory_order_relaxed) && _ring) {
+            if (silent) {
+                _ingest.processSilence(static_cast<int>(nNumFramesToRead), *_ring, nullptr);
+            } else {
+                _ingest.process(pData, static_cast<int>(nNumFramesToRead), *_ring, nullptr);
+            }
+        }
+
+        hr = _wasapi->captureClient->ReleaseBuffer(nNumFramesToRead);
+        if (FAILED(hr)) {
+            return false;
+        }
+    }
+
+    return SUCCEEDED(hr);
 #else
     return true;
-#endif
+#endif /** WASAPI_LOOPBACK */
+}
+
+bool initLoopback() {
+    return g_loopback.initialize();
+}
+
+bool cleanupLoopback() {
+    g_loopback.shutdown();
+    return true;
 }
 
 void configureLoopback(Core::AutoVibezApp *app) {
 #ifdef WASAPI_LOOPBACK
     // Default to WASAPI loopback if it was enabled at compilation.
     app->wasapi = true;
-    // Notify that loopback capture was started.
     ::AutoVibez::Utils::Logger logger;
-    logger.logInfo("Opened audio capture loopback.");
 
-    // Initialize the loopback
-    if (!initLoopback()) {
+    if (!g_loopback.initialize() || !g_loopback.start(&app->getPcmRingBuffer())) {
         logger.logWarning("Failed to initialize WASAPI loopback - falling back to fake audio");
         app->fakeAudio = true;
         app->wasapi = false;
     } else {
-        logger.logInfo("WASAPI loopback initialized successfully");
+        logger.logInfo("WASAPI loopback capture thread started");
     }
+#else
+    (void)app;
 #endif
 }
 
 bool processLoopbackFrame(Core::AutoVibezApp *app) {
 #ifdef WASAPI_LOOPBACK
-    HRESULT hr;
-
-    if (app->wasapi) {
-        // drain data while it is available
-        nPasses++;
-        UINT32 nNextPacketSize;
-        for (hr = pAudioCaptureClient->GetNextPacketSize(&nNextPacketSize); SUCCEEDED(hr) && nNextPacketSize > 0;
-             hr = pAudioCaptureClient->GetNextPacketSize(&nNextPacketSize)) {
-            // get the captured data
-            BYTE *pData;
-            UINT32 nNumFramesToRead;
-            DWORD dwFlags;
-
-            hr = pAudioCaptureClient->GetBuffer(&pData, &nNumFramesToRead, &dwFlags, NULL, NULL);
-            if (FAILED(hr)) {
-                return false;
-            }
-
-            LONG lBytesToWrite = nNumFramesToRead * nBlockAlign;
-
-            /** Add the waveform data */
-            projectm_pcm_add_float(app->projectM(), reinterpret_cast<float *>(pData), nNumFramesToRead,
-                                   PROJECTM_STEREO);
-
-            *pnFrames += nNumFramesToRead;
-
-            hr = pAudioCaptureClient->ReleaseBuffer(nNumFramesToRead);
-            if (FAILED(hr)) {
-                return false;
-            }
-
-            bFirstPacket = false;
-        }
-
-        if (FAILED(hr)) {
-            return false;
-        }
-    }
-#endif /** WASAPI_LOOPBACK */
-
+    // Capture runs on its own thread; just keep it out of the way of other sources
+    g_loopback.setMuted(!app->wasapi || app->isInternalAudioActive());
+    return !app->wasapi || g_loopback.isRunning();
+#else
+    (void)app;
     return true;
+#endif /** WASAPI_LOOPBACK */
 }
 
 }  // namespace AutoVibez::Audio
@@ -1,8 +1,12 @@
-
-
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
 #include "autovibez_app.hpp"
+#include "pcm_ingest.hpp"
+#include "pcm_ring_buffer.hpp"
 
 namespace AutoVibez::Core {
 class AutoVibezApp;
@@ -10,6 +14,72 @@ class AutoVibezApp;
 
 namespace AutoVibez::Audio {
 
+/**
+ * @brief WASAPI render-endpoint loopback capture
+ *
+ * Owns the COM/WASAPI objects and a dedicated MMCSS "Pro Audio" thread that
+ * wakes on a waitable timer at the device period and pushes the mix format,
+ * converted to interleaved stereo float, into a PcmRingBuffer. On platforms
+ * without WASAPI every method is a no-op.
+ */
+class LoopbackCapture {
+public:
+    LoopbackCapture();
+    ~LoopbackCapture();
+
+    LoopbackCapture(const LoopbackCapture&) = delete;
+    LoopbackCapture& operator=(const LoopbackCapture&) = delete;
+
+    /**
+     * @brief Open the default render endpoint in loopback mode (idempotent)
+     * @return True on success or when WASAPI is not compiled in
+     */
+    bool initialize();
+
+    /**
+     * @brief Start the capture thread
+     * @param ring Destination for captured PCM; must outlive the capture
+     * @return True if the thread is running
+     */
+    bool start(PcmRingBuffer* ring);
+
+    /**
+     * @brief Stop the capture thread
+     */
+    void stop();
+
+    /**
+     * @brief Stop capturing and release all WASAPI/COM resources
+     */
+    void shutdown();
+
+    /**
+     * @brief Keep draining the device but discard samples (e.g. while another source is active)
+     */
+    void setMuted(bool muted) {
+        _muted.store(muted, std::memory_order_relaxed);
+    }
+
+    bool isRunning() const {
+        return _running.load(std::memory_order_acquire);
+    }
+
+private:
+    void captureThreadMain();
+    bool drainPackets();
+
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _muted{false};
+    std::thread _thread;
+    PcmRingBuffer* _ring = nullptr;
+    PcmIngest _ingest;  // Chosen from the mix format in initialize()
+    bool _initialized = false;
+
+    // COM/WASAPI objects live in the translation unit so this header stays free of Windows types
+    struct WasapiState;
+    std::unique_ptr<WasapiState> _wasapi;
+};
+
 bool initLoopback();
 void configureLoopback(Core::AutoVibezApp *app);
 bool processLoopbackFrame(Core::AutoVibezApp *app);
@@ -0,0 +1,322 @@
+#include "mix_analyzer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "constants.hpp"
+#include "mp3_decoder.hpp"
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+constexpr double S16_SCALE = 1.0 / 32768.0;
+
+// BS.1770 gating: 400 ms blocks made of four 100 ms steps
+constexpr int STEPS_PER_BLOCK = 4;
+constexpr double ABSOLUTE_GATE_LUFS = -70.0;
+constexpr double RELATIVE_GATE_LU = -10.0;
+
+double energyToLoudness(double energy) {
+    return -0.691 + 10.0 * std::log10(energy);
+}
+
+// Onset envelope resolution (~5.8 ms at 44.1 kHz) and searched tempo range
+constexpr int ONSET_HOP_FRAMES = 256;
+constexpr double MIN_BPM = 60.0;
+constexpr double MAX_BPM = 180.0;
+constexpr double PREFERRED_BPM = 120.0;
+constexpr double TEMPO_WEIGHT_OCTAVES = 0.9;
+constexpr double ONSET_FLOOR = 0.05;  // log10 energy rise (0.5 dB) below which a hop is ripple, not an onset
+
+// Windows whose summed magnitude is below this are silence and left out of the centroid
+constexpr double CENTROID_SILENCE = 1e-3;
+}  // namespace
+
+LoudnessMeter::LoudnessMeter(int sampleRate) : _stepFrames(std::max(1, sampleRate / 10)) {
+    // K-weighting coefficients for an arbitrary rate (BS.1770 pre-filter and RLB high-pass)
+    const double rate = static_cast<double>(std::max(1, sampleRate));
+
+    double f0 = 1681.974450955533;
+    double gainDb = 3.999843853973347;
+    double q = 0.7071752369554196;
+    double k = std::tan(PI * f0 / rate);
+    double vh = std::pow(10.0, gainDb / 20.0);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+    _shelf = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+              2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+    k = std::tan(PI * f0 / rate);
+    a0 = 1.0 + k / q + k * k;
+    _highpass = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+}
+
+double LoudnessMeter::runBiquad(const Biquad& filter, FilterState& state, double input) {
+    // Transposed direct form II
+    double output = filter.b0 * input + state.z1;
+    state.z1 = filter.b1 * input - filter.a1 * output + state.z2;
+    state.z2 = filter.b2 * input - filter.a2 * output;
+    return output;
+}
+
+void LoudnessMeter::process(const int16_t* samples, int frames) {
+    if (!samples || frames <= 0) {
+        return;
+    }
+
+    for (int i = 0; i < frames; ++i) {
+        for (int channel = 0; channel < 2; ++channel) {
+            int raw = samples[2 * i + channel];
+            _peak = std::max(_peak, std::abs(raw));
+
+            double weighted = runBiquad(_shelf, _state[channel][0], raw * S16_SCALE);
+            weighted = runBiquad(_highpass, _state[channel][1], weighted);
+            _stepEnergy += weighted * weighted;
+        }
+
+        if (++_stepPosition == _stepFrames) {
+            _steps.push_back(_stepEnergy / _stepFrames);
+            _stepEnergy = 0.0;
+            _stepPosition = 0;
+        }
+    }
+}
+
+double LoudnessMeter::getIntegratedLoudness() const {
+    if (_steps.size() < static_cast<size_t>(STEPS_PER_BLOCK)) {
+        return LOUDNESS_FLOOR_LUFS;
+    }
+
+    std::vector<double> blocks;
+    blocks.reserve(_steps.size() - STEPS_PER_BLOCK + 1);
+    for (size_t i = 0; i + STEPS_PER_BLOCK <= _steps.size(); ++i) {
+        double energy = 0.0;
+        for (int j = 0; j < STEPS_PER_BLOCK; ++j) {
+            energy += _steps[i + j];
+        }
+        energy /= STEPS_PER_BLOCK;
+        if (energy > 0.0 && energyToLoudness(energy) > ABSOLUTE_GATE_LUFS) {
+            blocks.push_back(energy);
+        }
+    }
+    if (blocks.empty()) {
+        return LOUDNESS_FLOOR_LUFS;
+    }
+
+    double sum = 0.0;
+    for (double energy : blocks) {
+        sum += energy;
+    }
+    const double relativeGate = energyToLoudness(sum / blocks.size()) + RELATIVE_GATE_LU;
+
+    double gatedSum = 0.0;
+    size_t gatedCount = 0;
+    for (double energy : blocks) {
+        if (energyToLoudness(energy) > relativeGate) {
+            gatedSum += energy;
+            ++gatedCount;
+        }
+    }
+    if (gatedCount == 0) {
+        return LOUDNESS_FLOOR_LUFS;
+    }
+    return std::max(LOUDNESS_FLOOR_LUFS, energyToLoudness(gatedSum / gatedCount));
+}
+
+double LoudnessMeter::getPeakDbfs() const {
+    if (_peak == 0) {
+        return PEAK_FLOOR_DBFS;
+    }
+    return 20.0 * std::log10(_peak * S16_SCALE);
+}
+
+TempoEstimator::TempoEstimator(int sampleRate) : _sampleRate(std::max(1, sampleRate)) {}
+
+void TempoEstimator::process(const int16_t* samples, int frames) {
+    if (!samples || frames <= 0) {
+        return;
+    }
+
+    for (int i = 0; i < frames; ++i) {
+        double mono = 0.5 * (samples[2 * i] + samples[2 * i + 1]) * S16_SCALE;
+        _hopEnergy += mono * mono;
+
+        if (++_hopPosition == ONSET_HOP_FRAMES) {
+            double logEnergy = std::log10(1e-10 + _hopEnergy / ONSET_HOP_FRAMES);
+            // Only rising energy marks an onset
+            double flux = _hasPrevious ? std::max(0.0, logEnergy - _previousLogEnergy - ONSET_FLOOR) : 0.0;
+            _onsets.push_back(static_cast<float>(flux));
+            _previousLogEnergy = logEnergy;
+            _hasPrevious = true;
+            _hopEnergy = 0.0;
+            _hopPosition = 0;
+        }
+    }
+}
+
+double TempoEstimator::estimateBpm() const {
+    const double hopsPerMinute = 60.0 * _sampleRate / ONSET_HOP_FRAMES;
+    const int minLag = static_cast<int>(std::floor(hopsPerMinute / MAX_BPM));
+    const int maxLag = static_cast<int>(std::ceil(hopsPerMinute / MIN_BPM));
+    const size_t count = _onsets.size();
+    if (minLag < 2 || count < static_cast<size_t>(maxLag) * 4) {
+        return 0.0;
+    }
+
+    double mean = 0.0;
+    for (float onset : _onsets) {
+        mean += onset;
+    }
+    mean /= count;
+    if (mean <= 0.0) {
+        return 0.0;
+    }
+
+    std::vector<double> centered(count);
+    for (size_t i = 0; i < count; ++i) {
+        centered[i] = _onsets[i] - mean;
+    }
+
+    // Unbiased autocorrelation, one lag either side of the range kept for interpolation
+    std::vector<double> correlation(static_cast<size_t>(maxLag) + 2, 0.0);
+    for (int lag = minLag - 1; lag <= maxLag + 1; ++lag) {
+        double sum = 0.0;
+        for (size_t i = static_cast<size_t>(lag); i < count; ++i) {
+            sum += centered[i] * centered[i - lag];
+        }
+        correlation[lag] = sum / static_cast<double>(count - lag);
+    }
+
+    int bestLag = 0;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        double octaves = std::log2(hopsPerMinute / lag / PREFERRED_BPM) / TEMPO_WEIGHT_OCTAVES;
+        double score = correlation[lag] * std::exp(-0.5 * octaves * octaves);
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0) {
+        return 0.0;
+    }
+
+    // Parabolic interpolation recovers tempos that fall between whole hops
+    double before = correlation[bestLag - 1];
+    double peak = correlation[bestLag];
+    double after = correlation[bestLag + 1];
+    double denominator = before - 2.0 * peak + after;
+    double offset = denominator < 0.0 ? std::clamp(0.5 * (before - after) / denominator, -0.5, 0.5) : 0.0;
+    return hopsPerMinute / (bestLag + offset);
+}
+
+SpectralCentroidMeter::SpectralCentroidMeter(int sampleRate)
+    : _sampleRate(std::max(1, sampleRate)), _fft(Constants::ANALYSIS_CENTROID_FFT_SIZE) {
+    const int size = _fft.size();
+    _hann.resize(static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        _hann[static_cast<size_t>(i)] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / (size - 1)));
+    }
+    _re.assign(static_cast<size_t>(size), 0.0f);
+    _im.assign(static_cast<size_t>(size), 0.0f);
+}
+
+void SpectralCentroidMeter::process(const int16_t* samples, int frames) {
+    if (!samples || frames <= 0) {
+        return;
+    }
+
+    // The first size() frames of every hop make the window
+    const int size = _fft.size();
+    const int hop = std::max(size, Constants::ANALYSIS_CENTROID_HOP_FRAMES);
+    for (int i = 0; i < frames; ++i) {
+        if (_hopPosition < size) {
+            const size_t at = static_cast<size_t>(_hopPosition);
+            const double mono = 0.5 * (samples[2 * i] + samples[2 * i + 1]) * S16_SCALE;
+            _re[at] = static_cast<float>(mono) * _hann[at];
+            if (_hopPosition == size - 1) {
+                analyzeWindow();
+            }
+        }
+        _hopPosition = (_hopPosition + 1) % hop;
+    }
+}
+
+void SpectralCentroidMeter::analyzeWindow() {
+    const int size = _fft.size();
+    std::fill(_im.begin(), _im.end(), 0.0f);
+    _fft.forward(_re.data(), _im.data());
+
+    // DC carries no brightness; everything up to Nyquist does
+    double magnitudeSum = 0.0;
+    double weightedBins = 0.0;
+    for (int bin = 1; bin <= size / 2; ++bin) {
+        const double magnitude =
+            std::hypot(static_cast<double>(_re[static_cast<size_t>(bin)]), _im[static_cast<size_t>(bin)]);
+        magnitudeSum += magnitude;
+        weightedBins += magnitude * bin;
+    }
+    if (magnitudeSum > CENTROID_SILENCE) {
+        const double centroid = weightedBins / magnitudeSum * _sampleRate / size;
+        _weightedSum += centroid * magnitudeSum;
+        _weightTotal += magnitudeSum;
+    }
+}
+
+double SpectralCentroidMeter::getCentroidHz() const {
+    return _weightTotal > 0.0 ? _weightedSum / _weightTotal : 0.0;
+}
+
+bool MixAnalyzer::analyzeFile(const std::string& path, MixAnalysis& result, const std::atomic<bool>* cancel) {
+    clearError();
+
+    const int rate = Constants::DEFAULT_SAMPLE_RATE;
+    Mp3Decoder decoder;
+    decoder.setIndexCapture(true);
+    if (!decoder.open(path, rate)) {
+        setError("Failed to open mix for analysis: " + decoder.getLastError());
+        return false;
+    }
+
+    LoudnessMeter loudness(rate);
+    TempoEstimator tempo(rate);
+    SpectralCentroidMeter centroid(rate);
+    std::vector<int16_t> block(static_cast<size_t>(Constants::ANALYSIS_DECODE_BLOCK_FRAMES) * 2);
+    int64_t decoded = 0;
+
+    // One decode feeds every measurement
+    for (;;) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            setError("Analysis cancelled: " + path);
+            return false;
+        }
+        int got = decoder.read(block.data(), Constants::ANALYSIS_DECODE_BLOCK_FRAMES);
+        if (got <= 0) {
+            break;
+        }
+        loudness.process(block.data(), got);
+        tempo.process(block.data(), got);
+        centroid.process(block.data(), got);
+        decoded += got;
+    }
+
+    if (decoded == 0) {
+        setError("No audio decoded from: " + path);
+        return false;
+    }
+
+    result.loudness_lufs = loudness.getIntegratedLoudness();
+    result.peak_dbfs = loudness.getPeakDbfs();
+    result.bpm = tempo.estimateBpm();
+    result.spectral_centroid_hz = centroid.getCentroidHz();
+    if (!decoder.exportSeekIndex(decoded, result.seek_index)) {
+        result.seek_index = SeekIndex();
+    }
+    return true;
+}
+
+}  // namespace AutoVibez::Audio
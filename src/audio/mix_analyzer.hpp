@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "error_handler.hpp"
+#include "fft.hpp"
+#include "seek_index.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Loudness, tempo and brightness of a whole mix file
+ */
+struct MixAnalysis {
+    double loudness_lufs = 0.0;         //!< EBU R128 integrated loudness
+    double peak_dbfs = 0.0;             //!< Sample peak
+    double bpm = 0.0;                   //!< Estimated tempo, 0 if no beat was found
+    double spectral_centroid_hz = 0.0;  //!< Mean spectral centroid, 0 for silence
+    SeekIndex seek_index;               //!< Frame offsets built by the same pass, empty if unavailable
+};
+
+/**
+ * @brief EBU R128 / ITU-R BS.1770 integrated loudness meter for stereo S16 input
+ *
+ * K-weights the signal, measures 400 ms blocks with 75% overlap and applies the
+ * -70 LUFS absolute and -10 LU relative gates. Only per-100 ms energies are kept,
+ * so memory grows by a few hundred KB per hour of audio.
+ */
+class LoudnessMeter {
+public:
+    explicit LoudnessMeter(int sampleRate);
+
+    /**
+     * @brief Feed interleaved stereo samples
+     */
+    void process(const int16_t* samples, int frames);
+
+    /**
+     * @brief Gated integrated loudness of everything fed so far (LOUDNESS_FLOOR_LUFS for silence)
+     */
+    double getIntegratedLoudness() const;
+
+    /**
+     * @brief Highest absolute sample level in dBFS (PEAK_FLOOR_DBFS for silence)
+     */
+    double getPeakDbfs() const;
+
+    static constexpr double LOUDNESS_FLOOR_LUFS = -70.0;
+    static constexpr double PEAK_FLOOR_DBFS = -120.0;
+
+private:
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+    };
+    struct FilterState {
+        double z1 = 0.0;
+        double z2 = 0.0;
+    };
+
+    static double runBiquad(const Biquad& filter, FilterState& state, double input);
+
+    Biquad _shelf{};
+    Biquad _highpass{};
+    FilterState _state[2][2];  // [channel][stage]
+
+    int _stepFrames;
+    int _stepPosition = 0;
+    double _stepEnergy = 0.0;
+    std::vector<double> _steps;  // Mean-square per 100 ms, summed over channels
+    int _peak = 0;
+};
+
+/**
+ * @brief Tempo estimate from the autocorrelation of an onset envelope
+ *
+ * The envelope is the positive log-energy flux of short hops; the strongest lag in
+ * the 60-180 BPM range wins, weighted towards typical dance tempos to avoid octave errors.
+ */
+class TempoEstimator {
+public:
+    explicit TempoEstimator(int sampleRate);
+
+    /**
+     * @brief Feed interleaved stereo samples
+     */
+    void process(const int16_t* samples, int frames);
+
+    /**
+     * @brief Estimated tempo in BPM, or 0 if there is no periodic onset pattern
+     */
+    double estimateBpm() const;
+
+private:
+    int _sampleRate;
+    int _hopPosition = 0;
+    double _hopEnergy = 0.0;
+    double _previousLogEnergy = 0.0;
+    bool _hasPrevious = false;
+    std::vector<float> _onsets;
+};
+
+/**
+ * @brief Mean spectral centroid, a measure of how bright a mix sounds
+ *
+ * Transforms one Hann-windowed mono window every ANALYSIS_CENTROID_HOP_FRAMES and
+ * averages the windows' centroids weighted by their spectral magnitude, so quiet
+ * passages count for little and silence not at all.
+ */
+class SpectralCentroidMeter {
+public:
+    explicit SpectralCentroidMeter(int sampleRate);
+
+    /**
+     * @brief Feed interleaved stereo samples
+     */
+    void process(const int16_t* samples, int frames);
+
+    /**
+     * @brief Centroid in Hz of everything fed so far, 0 if it was all silence
+     */
+    double getCentroidHz() const;
+
+private:
+    int _sampleRate;
+    Fft _fft;
+    std::vector<float> _hann;
+    std::vector<float> _re;
+    std::vector<float> _im;
+    int _hopPosition = 0;
+    double _weightedSum = 0.0;  // Sum of window centroids times window magnitude
+    double _weightTotal = 0.0;
+
+    void analyzeWindow();
+};
+
+/**
+ * @brief Decodes a mix once and measures loudness, peak, tempo and brightness in the same pass
+ *
+ * The same pass captures libmpg123's frame index for later seeks. Meant for a background
+ * worker at ingest time; playback only reads the stored results.
+ */
+class MixAnalyzer : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @brief Analyze an MP3 file
+     * @param path Path to the MP3 file
+     * @param result Receives the measurements
+     * @param cancel Optional flag that aborts the decode when set
+     * @return True if successful, false otherwise
+     */
+    bool analyzeFile(const std::string& path, MixAnalysis& result, const std::atomic<bool>* cancel = nullptr);
+};
+
+}  // namespace AutoVibez::Audio
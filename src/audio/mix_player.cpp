@@ -2,20 +2,34 @@
 
 #include <SDL2/SDL_mixer.h>
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 
 #include "constants.hpp"
+#include "decoder_backend.hpp"
+#include "latency_model.hpp"
 #include "mix_metadata.hpp"
+#include "mapped_file.hpp"
+#include "opus_decoder.hpp"
+#include "opus_transcoder.hpp"
 #include "path_manager.hpp"
+#include "path_utils.hpp"
+#include "prefetched_source.hpp"
+#include "realtime_guard.hpp"
 
 using AutoVibez::Audio::MixPlayer;
 
 namespace AutoVibez::Audio {
 
-MixPlayer::MixPlayer()
-    : playing(false), current_position(0), duration(0), volume(Constants::MAX_VOLUME), current_music(nullptr) {
+MixPlayer::MixPlayer(int requested_rate)
+    : playing(false), volume(Constants::MAX_VOLUME) {
+    if (requested_rate <= 0) {
+        requested_rate = Constants::DEFAULT_SAMPLE_RATE;
+    }
+
     // Initialize SDL_mixer only if not already initialized
-    if (Mix_OpenAudio(Constants::DEFAULT_SAMPLE_RATE, MIX_DEFAULT_FORMAT, Constants::DEFAULT_CHANNELS,
+    if (Mix_OpenAudio(requested_rate, MIX_DEFAULT_FORMAT, Constants::DEFAULT_CHANNELS,
                       Constants::DEFAULT_BUFFER_SIZE) < 0) {
         // SDL_mixer might already be initialized, which is fine
         // We'll handle this gracefully
@@ -23,68 +37,205 @@ MixPlayer::MixPlayer()
         return;
     }
 
+    _audio_open = true;
+
+    // Remember the negotiated rate and channel layout for the decoders and the output tap
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    if (Mix_QuerySpec(&frequency, &format, &channels)) {
+        if (frequency > 0) {
+            _output_rate = frequency;
+        }
+        if (channels > 0) {
+            _output_channels = channels;
+        }
+    }
+
+    // Sized once for the longest delay so the audio thread never allocates
+    const size_t max_delay_frames = static_cast<size_t>(_output_rate) * Constants::MAX_AV_DELAY_MS / 1000;
+    _delay_line.assign((max_delay_frames + 1) * _output_channels, 0);
+
     // Set volume
     Mix_Volume(-1, Constants::SDL_MIXER_MAX_VOLUME);
+
+    // Replace SDL_mixer's single music stream with the deck mixer
+    Mix_HookMusic(&MixPlayer::musicHookCallback, this);
+    Mix_SetPostMix(&MixPlayer::postMixCallback, this);
 }
 
 MixPlayer::~MixPlayer() {
-    if (playing) {
-        Mix_HaltMusic();
-    }
-    if (current_music) {
-        Mix_FreeMusic(current_music);
-        current_music = nullptr;
+    if (_audio_open) {
+        Mix_SetPostMix(nullptr, nullptr);
+        Mix_HookMusic(nullptr, nullptr);
     }
+    _decks.stop();
     Mix_CloseAudio();
 }
 
-bool MixPlayer::playMix(const std::string& local_path) {
-    clearError();
+std::unique_ptr<PcmSource> MixPlayer::openSource(const std::string& local_path, const MixLoadOptions& options) {
+    std::string error;
+    std::unique_ptr<PcmSource> source = prepareSource(local_path, error, options);
+    if (!source) {
+        setError(error);
+    }
+    return source;
+}
 
+std::unique_ptr<PcmSource> MixPlayer::prepareSource(const std::string& local_path, std::string& error,
+                                                    const MixLoadOptions& options) const {
     if (!std::filesystem::exists(local_path)) {
-        setError("File does not exist: " + local_path);
-        return false;
+        error = "File does not exist: " + local_path;
+        return nullptr;
     }
 
-    // Stop any currently playing music
-    if (playing) {
-        Mix_HaltMusic();
-        if (current_music) {
-            Mix_FreeMusic(current_music);
-            current_music = nullptr;
+    // A fresh Opus copy is a fraction of the MP3's bytes to read; one that won't open falls back to the MP3
+    if (_prefer_transcoded && _output_rate == Constants::OPUS_SAMPLE_RATE &&
+        OpusTranscoder::hasFreshCopy(local_path)) {
+        if (auto source = prepareTranscodedSource(local_path, options)) {
+            return source;
         }
     }
 
+    // One mapping per play: validation and decoding both read from it
+    auto mapping = std::make_shared<AutoVibez::Utils::MappedFile>();
+    if (!mapping->open(local_path)) {
+        error = "Failed to load music: " + mapping->getLastError();
+        return nullptr;
+    }
+
     // Validate that the file is actually an MP3
-    if (!AutoVibez::Utils::AudioUtils::isValidMP3File(local_path)) {
-        setError("File is not a valid MP3: " + local_path);
+    if (!AutoVibez::Utils::PathUtils::hasExtension(local_path, "mp3") ||
+        !AutoVibez::Utils::AudioUtils::isValidMP3Data(mapping->data(), mapping->size())) {
+        error = "File is not a valid MP3: " + local_path;
+        return nullptr;
+    }
+
+    auto decoder = DecoderBackend::create(_decoder_synth);
+    if (!decoder->openMapped(std::move(mapping), _output_rate)) {
+        error = "Failed to load music: " + decoder->getLastError();
+        return nullptr;
+    }
+    if (options.gain_db != 0.0) {
+        // Set before the pre-decode below so every frame carries the correction
+        decoder->setGain(std::pow(10.0, options.gain_db / 20.0));
+    }
+    if (!options.seek_index.empty()) {
+        // A stale index is rejected and playback falls back to libmpg123's own scanning
+        decoder->applySeekIndex(options.seek_index);
+    }
+
+    // Decode the opening seconds now so the first audio-thread reads are plain copies
+    return std::make_unique<PrefetchedSource>(std::move(decoder), Constants::NEXT_MIX_PREFETCH_SECONDS * _output_rate);
+}
+
+std::unique_ptr<PcmSource> MixPlayer::prepareTranscodedSource(const std::string& local_path,
+                                                              const MixLoadOptions& options) const {
+    auto mapping = std::make_shared<AutoVibez::Utils::MappedFile>();
+    if (!mapping->open(OpusTranscoder::getCopyPath(local_path))) {
+        return nullptr;
+    }
+    auto decoder = std::make_unique<OpusDecoder>();
+    if (!decoder->openMapped(std::move(mapping), _output_rate)) {
+        return nullptr;
+    }
+    if (options.gain_db != 0.0) {
+        decoder->setGain(std::pow(10.0, options.gain_db / 20.0));
+    }
+    return std::make_unique<PrefetchedSource>(std::move(decoder), Constants::NEXT_MIX_PREFETCH_SECONDS * _output_rate);
+}
+
+std::unique_ptr<PcmSource> MixPlayer::prepareStreamingSource(
+    const std::string& partial_path, std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress,
+    std::string& error) const {
+    auto decoder = DecoderBackend::create(_decoder_synth);
+    if (!decoder->openGrowing(partial_path, std::move(progress), _output_rate)) {
+        error = "Failed to stream music: " + decoder->getLastError();
+        return nullptr;
+    }
+    return decoder;
+}
+
+void MixPlayer::queueNext(std::unique_ptr<PcmSource> source) {
+    _decks.queueNext(std::move(source));
+}
+
+void MixPlayer::clearQueuedNext() {
+    _decks.clearQueued();
+}
+
+bool MixPlayer::consumeGaplessAdvance() {
+    uint32_t advances = _decks.getAdvanceCount();
+    if (advances == _seen_advances) {
         return false;
     }
+    _seen_advances = advances;
 
-    current_music = Mix_LoadMUS(local_path.c_str());
+    // The queued mix is now the live deck
+    _decks.releaseRetired();
+    return true;
+}
+
+bool MixPlayer::playMix(const std::string& local_path, const MixLoadOptions& options) {
+    clearError();
 
-    if (!current_music) {
-        setError("Failed to load music: " + std::string(Mix_GetError()));
+    std::unique_ptr<PcmSource> source = openSource(local_path, options);
+    if (!source) {
         return false;
     }
+    return playSource(std::move(source));
+}
 
-    if (Mix_PlayMusic(current_music, 0) == -1) {
-        setError("Failed to play music: " + std::string(Mix_GetError()));
-        Mix_FreeMusic(current_music);
-        current_music = nullptr;
+bool MixPlayer::crossfadeTo(const std::string& local_path, int duration_ms, const MixLoadOptions& options) {
+    clearError();
+
+    std::unique_ptr<PcmSource> source = openSource(local_path, options);
+    if (!source) {
         return false;
     }
+    return crossfadeToSource(std::move(source), duration_ms);
+}
 
-    Mix_VolumeMusic((volume * Constants::SDL_MIXER_MAX_VOLUME) / Constants::MAX_VOLUME);
+bool MixPlayer::playSource(std::unique_ptr<PcmSource> source) {
+    if (!source) {
+        setError("No source to play");
+        return false;
+    }
+
+    _decks.setGain(static_cast<float>(volume) / Constants::MAX_VOLUME);
+    _decks.setPaused(false);
+    _decks.play(std::move(source));
+    _seen_advances = _decks.getAdvanceCount();
 
     playing = true;
-    current_position = 0;
 
-    duration = Mix_MusicDuration(current_music);
+    return true;
+}
+
+bool MixPlayer::crossfadeToSource(std::unique_ptr<PcmSource> source, int duration_ms) {
+    if (!source) {
+        setError("No source to play");
+        return false;
+    }
+
+    int64_t fade_frames = static_cast<int64_t>(duration_ms) * _output_rate / 1000;
+    _decks.setPaused(false);
+    _decks.crossfadeTo(std::move(source), playing ? fade_frames : 0);
+    _seen_advances = _decks.getAdvanceCount();
+
+    playing = true;
 
     return true;
 }
 
+bool MixPlayer::isCrossfading() const {
+    return playing && _decks.isCrossfading();
+}
+
+int MixPlayer::getCrossfadeProgress() const {
+    return _decks.getCrossfadeProgress();
+}
+
 bool MixPlayer::togglePause() {
     clearError();
 
@@ -93,12 +244,34 @@ bool MixPlayer::togglePause() {
         return false;
     }
 
-    if (Mix_PausedMusic()) {
-        Mix_ResumeMusic();
-    } else {
-        Mix_PauseMusic();
+    _decks.setPaused(!_decks.isPaused());
+
+    return true;
+}
+
+bool MixPlayer::seekTo(int seconds) {
+    return seekToFrame(static_cast<int64_t>(std::max(0, seconds)) * _output_rate);
+}
+
+bool MixPlayer::seekToFrame(int64_t frame) {
+    clearError();
+
+    if (!playing) {
+        setError("No music is currently playing");
+        return false;
     }
 
+    // Stop a second short of the end so a seek past it doesn't skip straight to the next mix
+    frame = std::max<int64_t>(0, frame);
+    const int64_t length = _decks.getLengthFrames();
+    if (length > 0) {
+        frame = std::min(frame, std::max<int64_t>(0, length - _output_rate));
+    }
+
+    if (!_decks.seek(frame)) {
+        setError("Seek is not supported for this mix");
+        return false;
+    }
     return true;
 }
 
@@ -107,13 +280,9 @@ bool MixPlayer::stop() {
         return true;
     }
 
-    Mix_HaltMusic();
-    if (current_music) {
-        Mix_FreeMusic(current_music);
-        current_music = nullptr;
-    }
+    _decks.stop();
+    _decks.setPaused(false);
     playing = false;
-    current_position = 0;
 
     return true;
 }
@@ -127,37 +296,41 @@ bool MixPlayer::setVolume(int new_volume, bool suppress_output) {
         new_volume = Constants::MAX_VOLUME;
 
     volume = new_volume;
-    Mix_VolumeMusic((volume * Constants::SDL_MIXER_MAX_VOLUME) / Constants::MAX_VOLUME);
+    _decks.setGain(static_cast<float>(volume) / Constants::MAX_VOLUME);
 
     return true;
 }
 
 int MixPlayer::getCurrentPosition() const {
-    if (!playing)
-        return 0;
+    return static_cast<int>(getPositionFrames() / _output_rate);
+}
 
-    // Get current position from SDL_mixer
-    return Mix_GetMusicPosition(nullptr);
+int64_t MixPlayer::getPositionFrames() const {
+    return playing ? _decks.getPositionFrames() : 0;
+}
+
+int64_t MixPlayer::getLengthFrames() const {
+    return playing ? _decks.getLengthFrames() : -1;
 }
 
 bool MixPlayer::isPlaying() const {
-    return playing && !Mix_PausedMusic() && Mix_PlayingMusic();
+    return playing && !_decks.isPaused() && !_decks.isFinished();
 }
 
 bool MixPlayer::hasFinished() {
-    if (playing && !Mix_PlayingMusic() && !Mix_PausedMusic()) {
+    // Free whichever deck faded out; decoders are never destroyed on the audio thread
+    _decks.releaseRetired();
+
+    if (playing && _decks.isFinished()) {
         playing = false;
-        if (current_music) {
-            Mix_FreeMusic(current_music);
-            current_music = nullptr;
-        }
+        _decks.stop();
         return true;
     }
     return false;
 }
 
 bool MixPlayer::isPaused() const {
-    return playing && Mix_PausedMusic();
+    return playing && _decks.isPaused();
 }
 
 int MixPlayer::getVolume() const {
@@ -165,11 +338,112 @@ int MixPlayer::getVolume() const {
 }
 
 int MixPlayer::getDuration() const {
-    return duration;
+    // A streamed mix only learns its length once the decoder has parsed the first frame
+    const int64_t length = getLengthFrames();
+    return length > 0 ? static_cast<int>(length / _output_rate) : 0;
 }
 
 std::string MixPlayer::getLastError() const {
     return ErrorHandler::getLastError();
 }
 
+void MixPlayer::setPcmTap(PcmTapCallback callback, void* userdata) {
+    if (!_audio_open) {
+        return;
+    }
+
+    // Mix_SetPostMix swaps the hook under the audio lock, so detach first and only
+    // touch the tap fields while no callback can be running
+    Mix_SetPostMix(nullptr, nullptr);
+    _pcm_tap = callback;
+    _pcm_tap_userdata = userdata;
+    Mix_SetPostMix(&MixPlayer::postMixCallback, this);
+}
+
+void MixPlayer::setPlaybackEventCallback(PlaybackEventCallback callback, void* userdata) {
+    if (!_audio_open) {
+        return;
+    }
+
+    // As with the tap, the fields only change while the music hook is detached
+    Mix_HookMusic(nullptr, nullptr);
+    _playback_event = callback;
+    _playback_event_userdata = userdata;
+    _reported_finished = _decks.isFinished();
+    _reported_advances = _decks.getAdvanceCount();
+    Mix_HookMusic(&MixPlayer::musicHookCallback, this);
+}
+
+void MixPlayer::setOutputDelayFrames(int frames) {
+    const int max_frames = _output_channels > 0 ? static_cast<int>(_delay_line.size()) / _output_channels - 1 : 0;
+    _output_delay_target.store(std::clamp(frames, 0, std::max(0, max_frames)), std::memory_order_relaxed);
+}
+
+void MixPlayer::musicHookCallback(void* udata, Uint8* stream, int len) {
+    AUTOVIBEZ_REALTIME_SCOPE();
+    MixPlayer* self = static_cast<MixPlayer*>(udata);
+    if (!self) {
+        return;
+    }
+
+    // MIX_DEFAULT_FORMAT is signed 16-bit in native byte order
+    int16_t* samples = reinterpret_cast<int16_t*>(stream);
+    int frames = len / static_cast<int>(sizeof(int16_t)) / self->_output_channels;
+    self->_decks.render(samples, frames, self->_output_channels);
+
+    if (self->_playback_event) {
+        const bool finished = self->_decks.isFinished();
+        const uint32_t advances = self->_decks.getAdvanceCount();
+        if ((finished && !self->_reported_finished) || advances != self->_reported_advances) {
+            self->_playback_event(self->_playback_event_userdata);
+        }
+        self->_reported_finished = finished;
+        self->_reported_advances = advances;
+    }
+}
+
+void MixPlayer::postMixCallback(void* udata, Uint8* stream, int len) {
+    AUTOVIBEZ_REALTIME_SCOPE();
+    MixPlayer* self = static_cast<MixPlayer*>(udata);
+    if (!self) {
+        return;
+    }
+
+    // MIX_DEFAULT_FORMAT is signed 16-bit in native byte order
+    int16_t* samples = reinterpret_cast<int16_t*>(stream);
+    int frames = len / static_cast<int>(sizeof(int16_t)) / self->_output_channels;
+    if (self->_calibration_clicks.load(std::memory_order_relaxed)) {
+        renderCalibrationClicks(samples, frames, self->_output_channels, self->_output_rate, self->_click_position);
+    }
+    if (self->_pcm_tap) {
+        self->_pcm_tap(self->_pcm_tap_userdata, samples, frames, self->_output_channels);
+    }
+    self->applyOutputDelay(samples, frames);
+}
+
+void MixPlayer::applyOutputDelay(int16_t* samples, int frames) {
+    const size_t size = _delay_line.size();
+    const size_t channels = static_cast<size_t>(_output_channels);
+    const int target = _output_delay_target.load(std::memory_order_relaxed);
+    if (size == 0) {
+        return;
+    }
+
+    // The line is written even at zero delay, so growing the delay never replays stale audio.
+    // Every 32nd frame the read position stretches or skips one frame towards the target delay
+    constexpr int SLEW_INTERVAL_FRAMES = 32;
+    for (int frame = 0; frame < frames; ++frame) {
+        if (target != _delay_current && frame % SLEW_INTERVAL_FRAMES == 0) {
+            _delay_current += target > _delay_current ? 1 : -1;
+        }
+        const size_t lag = static_cast<size_t>(_delay_current) * channels;
+        for (size_t c = 0; c < channels; ++c) {
+            int16_t& sample = samples[static_cast<size_t>(frame) * channels + c];
+            _delay_line[_delay_write] = sample;
+            sample = _delay_line[_delay_write >= lag ? _delay_write - lag : _delay_write + size - lag];
+            _delay_write = _delay_write + 1 == size ? 0 : _delay_write + 1;
+        }
+    }
+}
+
 }  // namespace AutoVibez::Audio
\ No newline at end of file
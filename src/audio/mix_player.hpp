@@ -2,29 +2,146 @@
 
 #include <SDL2/SDL_mixer.h>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "audio_utils.hpp"
+#include "constants.hpp"
+#include "deck_mixer.hpp"
+#include "download_progress.hpp"
 #include "error_handler.hpp"
+#include "memory_accounting.hpp"
 #include "mix_metadata.hpp"
+#include "seek_index.hpp"
 
 namespace AutoVibez::Audio {
 
+/**
+ * @brief Per-mix data from the ingest analysis, applied when a mix is opened
+ */
+struct MixLoadOptions {
+    double gain_db = 0.0;  //!< Loudness normalization, applied by the decoder
+    SeekIndex seek_index;  //!< Stored frame index; empty leaves libmpg123 to scan on seek
+};
+
 /**
  * @brief Handles audio playback of mix files
+ *
+ * Decodes mixes itself (two decks, see DeckMixer) and feeds SDL_mixer through a music
+ * hook, so a crossfade overlaps both mixes instead of cutting to the new one.
  */
 class MixPlayer : public ::AutoVibez::Utils::ErrorHandler {
 public:
-    MixPlayer();
+    /**
+     * @brief Receives the final mixed output of SDL_mixer
+     *
+     * Invoked on the SDL audio thread; implementations must not block.
+     * @param userdata Pointer passed to setPcmTap
+     * @param samples Interleaved signed 16-bit samples
+     * @param frames Number of sample frames in the buffer
+     * @param channels Number of interleaved channels
+     */
+    using PcmTapCallback = void (*)(void* userdata, const int16_t* samples, int frames, int channels);
+
+    /**
+     * @brief Told that playback ended or handed off to the queued source
+     *
+     * Invoked on the SDL audio thread; implementations must not block.
+     * @param userdata Pointer passed to setPlaybackEventCallback
+     */
+    using PlaybackEventCallback = void (*)(void* userdata);
+
+    /**
+     * @brief Open SDL_mixer for playback
+     * @param requested_rate Output rate to ask for; pass the device's native rate to avoid resampling after decode
+     */
+    explicit MixPlayer(int requested_rate = Constants::DEFAULT_SAMPLE_RATE);
     ~MixPlayer();
 
     /**
      * @brief Load and play a mix file
      * @param local_path Path to local mix file
+     * @param options Gain and seek index for this mix
+     * @return True if successful, false otherwise
+     */
+    bool playMix(const std::string& local_path, const MixLoadOptions& options = {});
+
+    /**
+     * @brief Start a mix on the idle deck and fade between decks with equal-power curves
+     * @param local_path Path to local mix file
+     * @param duration_ms Overlap length; the ramp itself is computed per sample on the audio thread
+     * @param options Gain and seek index for this mix
+     * @return True if the new mix is playing, false otherwise
+     */
+    bool crossfadeTo(const std::string& local_path, int duration_ms, const MixLoadOptions& options = {});
+
+    /**
+     * @brief Open, validate and pre-decode a mix without touching playback state
+     *
+     * Safe to call from a background thread; the result is meant for queueNext().
+     * @param local_path Path to local mix file
+     * @param error Receives the failure reason
+     * @param options Gain and seek index for this mix
+     * @return Ready-to-play source, or nullptr on failure
+     */
+    std::unique_ptr<PcmSource> prepareSource(const std::string& local_path, std::string& error,
+                                             const MixLoadOptions& options = {}) const;
+
+    /**
+     * @brief Open a mix that is still downloading for progressive playback
+     * @param partial_path File the download is writing to
+     * @param progress Counters published by the download
+     * @param error Receives the failure reason
+     * @return Forward-only source that plays silence if it catches up with the download
+     */
+    std::unique_ptr<PcmSource> prepareStreamingSource(
+        const std::string& partial_path, std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress,
+        std::string& error) const;
+
+    /**
+     * @brief Play an already opened source (hard cut)
      * @return True if successful, false otherwise
      */
-    bool playMix(const std::string& local_path);
+    bool playSource(std::unique_ptr<PcmSource> source);
+
+    /**
+     * @brief Crossfade to an already opened source
+     * @return True if the new source is playing, false otherwise
+     */
+    bool crossfadeToSource(std::unique_ptr<PcmSource> source, int duration_ms);
+
+    /**
+     * @brief Continue with this source the moment the current mix ends, with no gap
+     */
+    void queueNext(std::unique_ptr<PcmSource> source);
+
+    /**
+     * @brief Drop a queued follow-up source
+     */
+    void clearQueuedNext();
+
+    bool hasQueuedNext() const {
+        return _decks.hasQueued();
+    }
+
+    /**
+     * @brief Report (once) that the queued source took over since the last call
+     * @return True if a gapless hand-off happened
+     */
+    bool consumeGaplessAdvance();
+
+    /**
+     * @brief Check whether a crossfade is still running
+     */
+    bool isCrossfading() const;
+
+    /**
+     * @brief Crossfade progress (0-100, 100 when idle)
+     */
+    int getCrossfadeProgress() const;
 
     /**
      * @brief Pause/resume playback
@@ -32,6 +149,20 @@ public:
      */
     bool togglePause();
 
+    /**
+     * @brief Jump to a position in the current mix
+     *
+     * With a stored seek index this lands on the right frame directly, even in VBR files.
+     * @param seconds Target position, clamped to the mix
+     * @return True if successful, false otherwise
+     */
+    bool seekTo(int seconds);
+
+    /**
+     * @brief Jump to a frame of the current mix at the output rate, as seekTo() does to a second
+     */
+    bool seekToFrame(int64_t frame);
+
     /**
      * @brief Stop playback
      * @return True if successful, false otherwise
@@ -60,10 +191,23 @@ public:
 
     /**
      * @brief Get total duration
-     * @return Duration in seconds
+     * @return Duration in seconds, 0 until the decoder knows it
      */
     int getDuration() const;
 
+    /**
+     * @brief Playback clock: frames of the live mix played, as of the audio callback's last block
+     *
+     * Counted at getOutputRate() by the audio thread, so reading it is an atomic load
+     * rather than a query of the decoder. 0 when nothing is playing.
+     */
+    int64_t getPositionFrames() const;
+
+    /**
+     * @brief Length of the live mix in frames, or -1 until the decoder knows it
+     */
+    int64_t getLengthFrames() const;
+
     /**
      * @brief Check if playing
      * @return True if playing, false otherwise
@@ -92,13 +236,108 @@ public:
         _verbose = verbose;
     }
 
+    /**
+     * @brief libmpg123 synth for mixes opened from now on (see DecoderBackend::select), empty for its own choice
+     */
+    void setDecoderSynth(const std::string& synth) {
+        _decoder_synth = synth;
+    }
+
+    /**
+     * @brief Play a mix's fresh Opus copy (see OpusTranscoder) instead of its MP3 when the output runs at 48 kHz
+     */
+    void setPreferTranscoded(bool prefer) {
+        _prefer_transcoded = prefer;
+    }
+
+    /**
+     * @brief Install a tap on the decoded output stream
+     * @param callback Callback receiving each mixed buffer, or nullptr to remove the tap
+     * @param userdata Opaque pointer handed back to the callback
+     */
+    void setPcmTap(PcmTapCallback callback, void* userdata);
+
+    /**
+     * @brief Be told when the decks run dry or hand off, instead of polling hasFinished() for it
+     * @param callback Callback invoked once per event, or nullptr to remove it
+     * @param userdata Opaque pointer handed back to the callback
+     */
+    void setPlaybackEventCallback(PlaybackEventCallback callback, void* userdata);
+
+    /**
+     * @brief Rate SDL_mixer actually opened at; decoders and the PCM tap run at this rate
+     */
+    int getOutputRate() const {
+        return _output_rate;
+    }
+
+    /**
+     * @brief Hold the speakers back behind the PCM tap so visuals drawn from the tap line up with them
+     *
+     * The audio thread slews towards the new delay a frame at a time instead of jumping.
+     * @param frames Delay at the output rate, clamped to MAX_AV_DELAY_MS
+     */
+    void setOutputDelayFrames(int frames);
+
+    int getOutputDelayFrames() const {
+        return _output_delay_target.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Replace the output with the latency calibration clicks, ahead of the tap so projectM sees them too
+     */
+    void setCalibrationClicks(bool enabled) {
+        _calibration_clicks.store(enabled, std::memory_order_relaxed);
+    }
+
 private:
+    static void postMixCallback(void* udata, Uint8* stream, int len);
+    static void musicHookCallback(void* udata, Uint8* stream, int len);
+
+    /**
+     * @brief Run the output through the speaker delay line (audio thread)
+     */
+    void applyOutputDelay(int16_t* samples, int frames);
+
+    /**
+     * @brief Open the Opus copy of a mix file, or nullptr to fall back to the MP3
+     */
+    std::unique_ptr<PcmSource> prepareTranscodedSource(const std::string& local_path,
+                                                       const MixLoadOptions& options) const;
+
+    /**
+     * @brief Validate and open a decoder for a mix file, recording any error
+     */
+    std::unique_ptr<PcmSource> openSource(const std::string& local_path, const MixLoadOptions& options);
+
     bool playing;
-    int current_position;
-    int duration;
     int volume;
-    Mix_Music* current_music;
     bool _verbose = false;
+
+    // Both decks are decoded and mixed here, then handed to SDL_mixer via Mix_HookMusic
+    DeckMixer _decks;
+    int _output_rate = Constants::DEFAULT_SAMPLE_RATE;
+    uint32_t _seen_advances = 0;
+    std::string _decoder_synth;
+    bool _prefer_transcoded = false;
+
+    // Output tap state, read from the SDL audio thread
+    PcmTapCallback _pcm_tap = nullptr;
+    void* _pcm_tap_userdata = nullptr;
+    PlaybackEventCallback _playback_event = nullptr;
+    void* _playback_event_userdata = nullptr;
+    bool _reported_finished = false;  // Audio thread only
+    uint32_t _reported_advances = 0;  // Audio thread only
+    int _output_channels = Constants::DEFAULT_CHANNELS;
+    bool _audio_open = false;
+
+    // Speaker delay line and calibration clicks, applied in the post-mix hook after the tap
+    std::vector<int16_t, Utils::TaggedAllocator<int16_t, Utils::MemoryTag::PcmBuffers>> _delay_line;
+    size_t _delay_write = 0;
+    int _delay_current = 0;  // Audio thread only
+    std::atomic<int> _output_delay_target{0};
+    std::atomic<bool> _calibration_clicks{false};
+    int64_t _click_position = 0;
 };
 
 }  // namespace AutoVibez::Audio
\ No newline at end of file
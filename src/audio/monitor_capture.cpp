@@ -0,0 +1,244 @@
+// Native sink-monitor capture for Linux (PipeWire, PulseAudio fallback)
+
+#include "monitor_capture.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "constants.hpp"
+
+#ifdef HAVE_PIPEWIRE
+#include <pipewire/pipewire.h>
+#include <spa/param/audio/format-utils.h>
+#endif
+
+#ifdef HAVE_PULSEAUDIO
+#include <pulse/error.h>
+#include <pulse/simple.h>
+#endif
+
+namespace AutoVibez::Audio {
+
+namespace {
+enum class Backend { None, PipeWire, PulseAudio };
+}  // namespace
+
+struct MonitorCapture::BackendState {
+    Backend backend = Backend::None;
+#ifdef HAVE_PIPEWIRE
+    pw_thread_loop* loop = nullptr;
+    pw_stream* stream = nullptr;
+    pw_stream_events events{};
+#endif
+#ifdef HAVE_PULSEAUDIO
+    pa_simple* simple = nullptr;
+    std::thread thread;
+#endif
+};
+
+MonitorCapture::MonitorCapture() : _state(std::make_unique<BackendState>()) {}
+
+MonitorCapture::~MonitorCapture() {
+    stop();
+}
+
+bool MonitorCapture::isAvailable() {
+#if defined(HAVE_PIPEWIRE) || defined(HAVE_PULSEAUDIO)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MonitorCapture::start(SampleCallback callback, void* userData, int sampleRate) {
+    if (_running.load()) {
+        return true;
+    }
+    if (!callback) {
+        _lastError = "No sample callback";
+        return false;
+    }
+
+    _callback = callback;
+    _userData = userData;
+    _lastError.clear();
+
+    if (startPipeWire(sampleRate) || startPulseAudio(sampleRate)) {
+        return true;
+    }
+
+    if (_lastError.empty()) {
+        _lastError = "No native monitor backend compiled in";
+    }
+    return false;
+}
+
+void MonitorCapture::stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+
+#ifdef HAVE_PIPEWIRE
+    if (_state->backend == Backend::PipeWire) {
+        pw_thread_loop_stop(_state->loop);
+        pw_stream_destroy(_state->stream);
+        pw_thread_loop_destroy(_state->loop);
+        _state->stream = nullptr;
+        _state->loop = nullptr;
+        pw_deinit();
+    }
+#endif
+
+#ifdef HAVE_PULSEAUDIO
+    if (_state->backend == Backend::PulseAudio) {
+        if (_state->thread.joinable()) {
+            _state->thread.join();
+        }
+        pa_simple_free(_state->simple);
+        _state->simple = nullptr;
+    }
+#endif
+
+    _state->backend = Backend::None;
+}
+
+std::string MonitorCapture::getBackendName() const {
+    switch (_state->backend) {
+        case Backend::PipeWire:
+            return "pipewire";
+        case Backend::PulseAudio:
+            return "pulseaudio";
+        default:
+            return "";
+    }
+}
+
+bool MonitorCapture::startPipeWire(int sampleRate) {
+#ifdef HAVE_PIPEWIRE
+    pw_init(nullptr, nullptr);
+
+    _state->loop = pw_thread_loop_new("autovibez-monitor", nullptr);
+    if (!_state->loop) {
+        _lastError = "pw_thread_loop_new failed";
+        pw_deinit();
+        return false;
+    }
+
+    // Capture from the default sink's monitor rather than a source, with a small fixed quantum
+    pw_properties* props = pw_properties_new(PW_KEY_MEDIA_TYPE, "Audio", PW_KEY_MEDIA_CATEGORY, "Capture",
+                                             PW_KEY_MEDIA_ROLE, "Music", PW_KEY_STREAM_CAPTURE_SINK, "true", nullptr);
+    pw_properties_setf(props, PW_KEY_NODE_LATENCY, "%d/%d", Constants::MONITOR_CAPTURE_QUANTUM_FRAMES, sampleRate);
+
+    _state->events = pw_stream_events{};
+    _state->events.version = PW_VERSION_STREAM_EVENTS;
+    _state->events.process = [](void* data) {
+        auto* self = static_cast<MonitorCapture*>(data);
+        pw_buffer* buffer = pw_stream_dequeue_buffer(self->_state->stream);
+        if (!buffer) {
+            return;
+        }
+        spa_data& chunk = buffer->buffer->datas[0];
+        if (chunk.data && chunk.chunk->size > 0) {
+            const auto* samples = static_cast<const uint8_t*>(chunk.data) + chunk.chunk->offset;
+            self->_callback(self->_userData, reinterpret_cast<const float*>(samples),
+                            static_cast<int>(chunk.chunk->size));
+        }
+        pw_stream_queue_buffer(self->_state->stream, buffer);
+    };
+
+    // Returns null when no PipeWire daemon is reachable; props are consumed either way
+    _state->stream = pw_stream_new_simple(pw_thread_loop_get_loop(_state->loop), "AutoVibez Monitor", props,
+                                          &_state->events, this);
+    if (!_state->stream) {
+        _lastError = "PipeWire daemon not reachable";
+        pw_thread_loop_destroy(_state->loop);
+        _state->loop = nullptr;
+        pw_deinit();
+        return false;
+    }
+
+    uint8_t podBuffer[1024];
+    spa_pod_builder builder{};
+    spa_pod_builder_init(&builder, podBuffer, sizeof(podBuffer));
+
+    spa_audio_info_raw info{};
+    info.format = SPA_AUDIO_FORMAT_F32;
+    info.rate = static_cast<uint32_t>(sampleRate);
+    info.channels = 2;
+    info.position[0] = SPA_AUDIO_CHANNEL_FL;
+    info.position[1] = SPA_AUDIO_CHANNEL_FR;
+    const spa_pod* params[1] = {spa_format_audio_raw_build(&builder, SPA_PARAM_EnumFormat, &info)};
+
+    auto flags = static_cast<pw_stream_flags>(PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_MAP_BUFFERS |
+                                              PW_STREAM_FLAG_RT_PROCESS);
+    if (pw_stream_connect(_state->stream, PW_DIRECTION_INPUT, PW_ID_ANY, flags, params, 1) < 0 ||
+        pw_thread_loop_start(_state->loop) < 0) {
+        _lastError = "Failed to connect PipeWire monitor stream";
+        pw_stream_destroy(_state->stream);
+        pw_thread_loop_destroy(_state->loop);
+        _state->stream = nullptr;
+        _state->loop = nullptr;
+        pw_deinit();
+        return false;
+    }
+
+    _state->backend = Backend::PipeWire;
+    _running.store(true, std::memory_order_release);
+    return true;
+#else
+    (void)sampleRate;
+    return false;
+#endif
+}
+
+bool MonitorCapture::startPulseAudio(int sampleRate) {
+#ifdef HAVE_PULSEAUDIO
+    pa_sample_spec spec{};
+    spec.format = PA_SAMPLE_FLOAT32NE;
+    spec.rate = static_cast<uint32_t>(sampleRate);
+    spec.channels = 2;
+
+    // fragsize bounds how much the server batches before each read returns
+    pa_buffer_attr attr{};
+    attr.maxlength = static_cast<uint32_t>(-1);
+    attr.tlength = static_cast<uint32_t>(-1);
+    attr.prebuf = static_cast<uint32_t>(-1);
+    attr.minreq = static_cast<uint32_t>(-1);
+    attr.fragsize = Constants::MONITOR_CAPTURE_QUANTUM_FRAMES * 2 * sizeof(float);
+
+    int error = 0;
+    _state->simple = pa_simple_new(nullptr, "AutoVibez", PA_STREAM_RECORD, "@DEFAULT_MONITOR@", "Visualizer monitor",
+                                   &spec, nullptr, &attr, &error);
+    if (!_state->simple) {
+        _lastError = std::string("PulseAudio: ") + pa_strerror(error);
+        return false;
+    }
+
+    _state->backend = Backend::PulseAudio;
+    _running.store(true, std::memory_order_release);
+    _state->thread = std::thread(&MonitorCapture::pulseThreadMain, this);
+    return true;
+#else
+    (void)sampleRate;
+    return false;
+#endif
+}
+
+void MonitorCapture::pulseThreadMain() {
+#ifdef HAVE_PULSEAUDIO
+    std::vector<float> buffer(static_cast<size_t>(Constants::MONITOR_CAPTURE_QUANTUM_FRAMES) * 2);
+    const size_t bytes = buffer.size() * sizeof(float);
+
+    while (_running.load(std::memory_order_acquire)) {
+        int error = 0;
+        if (pa_simple_read(_state->simple, buffer.data(), bytes, &error) < 0) {
+            // Server went away; leave the stream for stop() to release
+            break;
+        }
+        _callback(_userData, buffer.data(), static_cast<int>(bytes));
+    }
+#endif
+}
+
+}  // namespace AutoVibez::Audio
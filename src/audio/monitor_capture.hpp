@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Native Linux capture of the default sink's monitor
+ *
+ * Attaches straight to the default output's monitor with a small quantum instead of
+ * going through SDL's capture device list. PipeWire is tried first, then PulseAudio
+ * (which also covers pipewire-pulse). Samples are delivered as interleaved stereo float
+ * with the same signature as audioInputCallbackF32. Without either library compiled in,
+ * start() always fails and callers fall back to SDL capture.
+ */
+class MonitorCapture {
+public:
+    /**
+     * @brief Receives captured audio on the capture thread
+     * @param userData Opaque pointer passed to start()
+     * @param buffer Interleaved stereo float samples
+     * @param len Buffer size in bytes
+     */
+    using SampleCallback = void (*)(void* userData, const float* buffer, int len);
+
+    MonitorCapture();
+    ~MonitorCapture();
+
+    MonitorCapture(const MonitorCapture&) = delete;
+    MonitorCapture& operator=(const MonitorCapture&) = delete;
+
+    /**
+     * @brief Whether any native backend was compiled in
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief Connect to the default sink monitor and start delivering samples
+     * @param callback Invoked on the capture thread for every quantum
+     * @param userData Opaque pointer handed back to the callback
+     * @param sampleRate Requested sample rate in Hz
+     * @return True if a backend is running
+     */
+    bool start(SampleCallback callback, void* userData, int sampleRate);
+
+    /**
+     * @brief Disconnect and join the capture thread (safe to call when stopped)
+     */
+    void stop();
+
+    bool isRunning() const {
+        return _running.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Name of the active backend ("pipewire", "pulseaudio") or empty when stopped
+     */
+    std::string getBackendName() const;
+
+    /**
+     * @brief Last connection error, if start() failed
+     */
+    const std::string& getLastError() const {
+        return _lastError;
+    }
+
+private:
+    bool startPipeWire(int sampleRate);
+    bool startPulseAudio(int sampleRate);
+    void pulseThreadMain();
+
+    SampleCallback _callback = nullptr;
+    void* _userData = nullptr;
+    std::atomic<bool> _running{false};
+    std::string _lastError;
+
+    // Backend handles live in the translation unit so this header stays free of PipeWire/Pulse types
+    struct BackendState;
+    std::unique_ptr<BackendState> _state;
+};
+
+}  // namespace AutoVibez::Audio
@@ -7,6 +7,7 @@
 #include <taglib/textidentificationframe.h>
 
 #include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <functional>
 #include <iomanip>
@@ -46,7 +47,19 @@ MP3Metadata MP3Analyzer::analyzeFile(const std::string& file_path) {
         return metadata;
     }
 
-    // Use TagLib to extract metadata
+    // One bounded read validates the file and usually yields every field we store
+    AutoVibez::Utils::Mp3ProbeResult probe =
+        _probeCache ? _probeCache->probe(file_path) : AutoVibez::Utils::Mp3Probe::probeFile(file_path);
+    if (!probe.valid) {
+        setError("Invalid or corrupted MP3 file: " + file_path);
+        return metadata;
+    }
+    if (applyProbe(probe, metadata)) {
+        finishMetadata(file_path, metadata);
+        return metadata;
+    }
+
+    // Tags past the probed head, ID3v1-only files and numeric genres go through TagLib
     TagLib::MPEG::File f(file_path.c_str());
     if (!f.isValid()) {
         setError("Invalid or corrupted MP3 file: " + file_path);
@@ -127,6 +140,37 @@ MP3Metadata MP3Analyzer::analyzeFile(const std::string& file_path) {
         }
     }
 
+    finishMetadata(file_path, metadata);
+    return metadata;
+}
+
+bool MP3Analyzer::applyProbe(const AutoVibez::Utils::Mp3ProbeResult& probe, MP3Metadata& metadata) {
+    // A numeric genre like "(17)" or "17" refers to the ID3v1 genre list, which TagLib resolves
+    const bool numericGenre =
+        !probe.genre.empty() && (probe.genre[0] == '(' || std::isdigit(static_cast<unsigned char>(probe.genre[0])));
+    if (probe.duration_seconds < 1.0 || (probe.title.empty() && probe.artist.empty()) || numericGenre) {
+        return false;
+    }
+
+    metadata.duration_seconds = static_cast<int>(probe.duration_seconds);
+    metadata.bitrate = probe.bitrate_kbps;
+    metadata.sample_rate = probe.sample_rate;
+    metadata.channels = probe.channels;
+    metadata.title = probe.title;
+    metadata.artist = probe.artist;
+    metadata.genre = probe.genre;
+    if (!probe.comment.empty()) {
+        metadata.description = probe.comment;
+    } else if (!metadata.title.empty()) {
+        metadata.description = metadata.title;
+    }
+    if (!metadata.genre.empty()) {
+        metadata.tags.push_back(metadata.genre);
+    }
+    return true;
+}
+
+void MP3Analyzer::finishMetadata(const std::string& file_path, MP3Metadata& metadata) {
     // Fallback to filename if no metadata found
     if (metadata.title.empty()) {
         std::string filename = AutoVibez::Utils::PathUtils::getFilenameWithoutExtension(file_path);
@@ -146,9 +190,7 @@ MP3Metadata MP3Analyzer::analyzeFile(const std::string& file_path) {
     metadata.file_size = std::filesystem::file_size(file_path);
 
     metadata.format = StringConstants::MP3_FORMAT;
-    metadata.date_added = AutoVibez::Utils::DateTimeUtils::getCurrentDateTime();
-
-    return metadata;
+    metadata.date_added_ms = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
 }
 
 }  // namespace AutoVibez::Audio
\ No newline at end of file
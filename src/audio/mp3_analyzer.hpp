@@ -7,6 +7,7 @@
 #include "base_metadata.hpp"
 #include "datetime_utils.hpp"
 #include "error_handler.hpp"
+#include "mp3_probe.hpp"
 #include "uuid_utils.hpp"
 
 namespace AutoVibez::Audio {
@@ -33,8 +34,29 @@ public:
         _verbose = verbose;
     }
 
+    /**
+     * @brief Share a probe cache so files validated elsewhere are not read again (not owned)
+     */
+    void setProbeCache(::AutoVibez::Utils::Mp3ProbeCache* cache) {
+        _probeCache = cache;
+    }
+    ::AutoVibez::Utils::Mp3ProbeCache* getProbeCache() const {
+        return _probeCache;
+    }
+
 private:
+    /**
+     * @brief Fill metadata from the probe when its ID3v2 text frames are enough to skip TagLib
+     */
+    static bool applyProbe(const ::AutoVibez::Utils::Mp3ProbeResult& probe, MP3Metadata& metadata);
+
+    /**
+     * @brief Filename and default fallbacks, file size, format and date added
+     */
+    static void finishMetadata(const std::string& file_path, MP3Metadata& metadata);
+
     bool _verbose = false;
+    ::AutoVibez::Utils::Mp3ProbeCache* _probeCache = nullptr;
 };
 
 }  // namespace AutoVibez::Audio
\ No newline at end of file
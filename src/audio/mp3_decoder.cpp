@@ -0,0 +1,365 @@
+#include "mp3_decoder.hpp"
+
+#include <mpg123.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Audio {
+
+struct Mp3Decoder::MappedCursor {
+    std::shared_ptr<const ::AutoVibez::Utils::MappedFile> mapping;
+    size_t offset = 0;
+    size_t prefetchedUntil = 0;  //!< End of the range read-ahead has been requested for
+};
+
+namespace {
+constexpr int DECODER_CHANNELS = 2;
+
+// mpg123_init is required once per process on libmpg123 < 1.27 and a no-op afterwards
+bool initMpg123() {
+    static std::once_flag once;
+    static bool ok = false;
+    std::call_once(once, []() { ok = mpg123_init() == MPG123_OK; });
+    return ok;
+}
+
+// libmpg123 reader callbacks over a mapped file; templated because the cursor type is private to Mp3Decoder
+template <typename Cursor>
+mpg123_ssize_t readMapped(void* handle, void* buffer, size_t count) {
+    Cursor* cursor = static_cast<Cursor*>(handle);
+    const size_t size = cursor->mapping->size();
+    if (cursor->offset >= size) {
+        return 0;
+    }
+
+    count = std::min(count, size - cursor->offset);
+    std::memcpy(buffer, cursor->mapping->data() + cursor->offset, count);
+    cursor->offset += count;
+
+    // Stay a full window ahead so the decoder never faults on a page still on disk
+    const size_t window = static_cast<size_t>(Constants::MAPPED_READAHEAD_BYTES);
+    if (cursor->offset + window / 2 > cursor->prefetchedUntil) {
+        cursor->mapping->prefetch(cursor->prefetchedUntil, window);
+        cursor->prefetchedUntil += window;
+    }
+    return static_cast<mpg123_ssize_t>(count);
+}
+
+template <typename Cursor>
+off_t seekMapped(void* handle, off_t offset, int whence) {
+    Cursor* cursor = static_cast<Cursor*>(handle);
+    const int64_t size = static_cast<int64_t>(cursor->mapping->size());
+    int64_t target = static_cast<int64_t>(offset);
+    if (whence == SEEK_CUR) {
+        target += static_cast<int64_t>(cursor->offset);
+    } else if (whence == SEEK_END) {
+        target += size;
+    }
+    if (target < 0 || target > size) {
+        return -1;
+    }
+
+    cursor->offset = static_cast<size_t>(target);
+    cursor->prefetchedUntil = cursor->offset;
+    return static_cast<off_t>(target);
+}
+}  // namespace
+
+Mp3Decoder::Mp3Decoder(std::string synth) : _synth(std::move(synth)) {}
+
+Mp3Decoder::~Mp3Decoder() {
+    close();
+}
+
+bool Mp3Decoder::open(const std::string& path, int outputRate) {
+    clearError();
+    close();
+
+    auto mapping = std::make_shared<::AutoVibez::Utils::MappedFile>();
+    if (!mapping->open(path)) {
+        setError("Failed to open MP3: " + mapping->getLastError());
+        return false;
+    }
+    return openMapped(std::move(mapping), outputRate);
+}
+
+bool Mp3Decoder::openMapped(std::shared_ptr<const ::AutoVibez::Utils::MappedFile> mapping, int outputRate) {
+    clearError();
+    close();
+
+    if (!mapping || !mapping->isOpen()) {
+        setError("No mapped file to decode");
+        return false;
+    }
+
+    if (!createHandle(outputRate)) {
+        return false;
+    }
+
+    _cursor = std::make_unique<MappedCursor>();
+    _cursor->mapping = std::move(mapping);
+    _cursor->prefetchedUntil = static_cast<size_t>(Constants::MAPPED_READAHEAD_BYTES);  // Requested by MappedFile::open
+
+    mpg123_replace_reader_handle(_handle, &readMapped<MappedCursor>, &seekMapped<MappedCursor>, nullptr);
+    if (mpg123_open_handle(_handle, _cursor.get()) != MPG123_OK) {
+        setError("Failed to open MP3: " + std::string(mpg123_strerror(_handle)));
+        close();
+        return false;
+    }
+
+    long rate = 0;
+    int channels = 0;
+    int encoding = 0;
+    if (mpg123_getformat(_handle, &rate, &channels, &encoding) != MPG123_OK) {
+        setError("Failed to read MP3 format: " + std::string(mpg123_strerror(_handle)));
+        close();
+        return false;
+    }
+
+    _sampleRate = static_cast<int>(rate);
+    off_t length = mpg123_length(_handle);
+    _lengthFrames = length >= 0 ? static_cast<int64_t>(length) : -1;
+    return true;
+}
+
+bool Mp3Decoder::openGrowing(const std::string& path,
+                             std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress, int outputRate) {
+    clearError();
+    close();
+
+    if (!progress) {
+        setError("No download progress for streaming playback");
+        return false;
+    }
+
+    if (!createHandle(outputRate)) {
+        return false;
+    }
+
+    // Feed mode: libmpg123 never touches the file, so it cannot read past the flushed bytes
+    if (mpg123_open_feed(_handle) != MPG123_OK) {
+        setError("Failed to open MP3 stream: " + std::string(mpg123_strerror(_handle)));
+        close();
+        return false;
+    }
+
+    _file = std::fopen(path.c_str(), "rb");
+    if (!_file) {
+        setError("Failed to open partial download: " + path);
+        close();
+        return false;
+    }
+
+    // Lets libmpg123 estimate the length from the bitrate once the first frame is parsed
+    int64_t total = progress->total_bytes.load(std::memory_order_relaxed);
+    if (total > 0) {
+        mpg123_set_filesize(_handle, static_cast<off_t>(total));
+    }
+
+    _progress = std::move(progress);
+    _feedBuffer.resize(Constants::STREAM_FEED_CHUNK_BYTES);
+    _sampleRate = outputRate;  // MPG123_FORCE_RATE makes this the output rate before any frame is seen
+    return true;
+}
+
+bool Mp3Decoder::createHandle(int outputRate) {
+    if (!initMpg123()) {
+        setError("Failed to initialize libmpg123");
+        return false;
+    }
+
+    int err = MPG123_OK;
+    _handle = mpg123_new(_synth.empty() ? nullptr : _synth.c_str(), &err);
+    if (!_handle) {
+        setError("Failed to create MP3 decoder: " + std::string(mpg123_plain_strerror(err)));
+        return false;
+    }
+
+    // Pin the output format so the mixer never has to convert: stereo S16 at the device rate
+    mpg123_param(_handle, MPG123_ADD_FLAGS, MPG123_FORCE_STEREO | MPG123_QUIET, 0.0);
+    mpg123_param(_handle, MPG123_FORCE_RATE, outputRate, 0.0);
+    if (_captureIndex) {
+        // Negative size: the index grows instead of thinning out, keeping every frame until exported
+        mpg123_param(_handle, MPG123_INDEX_SIZE, -Constants::SEEK_INDEX_GROWTH_ENTRIES, 0.0);
+    }
+    mpg123_format_none(_handle);
+    if (mpg123_format(_handle, outputRate, MPG123_STEREO, MPG123_ENC_SIGNED_16) != MPG123_OK) {
+        setError("Unsupported output format: " + std::string(mpg123_strerror(_handle)));
+        close();
+        return false;
+    }
+    return true;
+}
+
+std::string Mp3Decoder::getBackendName() const {
+    const char* synth = _handle ? mpg123_current_decoder(_handle) : nullptr;
+    if (synth) {
+        return std::string("mpg123/") + synth;
+    }
+    return _synth.empty() ? "mpg123" : "mpg123/" + _synth;
+}
+
+std::vector<std::string> Mp3Decoder::getSupportedSynths() {
+    std::vector<std::string> synths;
+    if (!initMpg123()) {
+        return synths;
+    }
+    for (const char** name = mpg123_supported_decoders(); name && *name; ++name) {
+        synths.emplace_back(*name);
+    }
+    return synths;
+}
+
+void Mp3Decoder::close() {
+    if (_handle) {
+        mpg123_close(_handle);
+        mpg123_delete(_handle);
+        _handle = nullptr;
+    }
+    _cursor.reset();
+    if (_file) {
+        std::fclose(_file);
+        _file = nullptr;
+    }
+    _progress.reset();
+    _fedBytes = 0;
+    _underruns.store(0, std::memory_order_relaxed);
+    _sampleRate = 0;
+    _lengthFrames = -1;
+}
+
+int Mp3Decoder::read(int16_t* out, int frames) {
+    if (!_handle || frames <= 0) {
+        return 0;
+    }
+
+    const size_t frameBytes = sizeof(int16_t) * DECODER_CHANNELS;
+    size_t wanted = static_cast<size_t>(frames) * frameBytes;
+    size_t filled = 0;
+    unsigned char* dest = reinterpret_cast<unsigned char*>(out);
+
+    while (filled < wanted) {
+        size_t done = 0;
+        int result = mpg123_read(_handle, dest + filled, wanted - filled, &done);
+        filled += done;
+
+        if (result == MPG123_NEED_MORE && _progress) {
+            if (feedFromFile()) {
+                continue;
+            }
+            if (_progress->isComplete()) {
+                break;  // Everything the download delivered has been decoded
+            }
+
+            // Caught up with the download: pad with silence so the deck keeps playing
+            std::fill(dest + filled, dest + wanted, static_cast<unsigned char>(0));
+            filled = wanted;
+            _underruns.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        if (result == MPG123_NEW_FORMAT && _progress && _lengthFrames < 0) {
+            off_t length = mpg123_length(_handle);
+            _lengthFrames = length > 0 ? static_cast<int64_t>(length) : -1;
+        }
+
+        if (result == MPG123_DONE || (result != MPG123_OK && result != MPG123_NEW_FORMAT && done == 0)) {
+            break;
+        }
+    }
+
+    return static_cast<int>(filled / frameBytes);
+}
+
+bool Mp3Decoder::feedFromFile() {
+    int64_t available = _progress->getBytesWritten() - _fedBytes;
+    if (available <= 0 || !_file) {
+        return false;
+    }
+
+    size_t chunk = static_cast<size_t>(std::min<int64_t>(available, static_cast<int64_t>(_feedBuffer.size())));
+    // A short read at the old end of file sets the EOF flag; the download may have appended since
+    std::clearerr(_file);
+    size_t got = std::fread(_feedBuffer.data(), 1, chunk, _file);
+    if (got == 0) {
+        return false;
+    }
+
+    _fedBytes += static_cast<int64_t>(got);
+    return mpg123_feed(_handle, _feedBuffer.data(), got) == MPG123_OK;
+}
+
+bool Mp3Decoder::seek(int64_t frame) {
+    // Progressive streams only play forward
+    if (!_handle || _progress) {
+        return false;
+    }
+    return mpg123_seek(_handle, static_cast<off_t>(frame), SEEK_SET) >= 0;
+}
+
+bool Mp3Decoder::setGain(double linear) {
+    if (!_handle) {
+        return false;
+    }
+    return mpg123_volume(_handle, linear) == MPG123_OK;
+}
+
+bool Mp3Decoder::exportSeekIndex(int64_t decodedFrames, SeekIndex& index) {
+    index = SeekIndex();
+    off_t* offsets = nullptr;
+    off_t step = 0;
+    size_t fill = 0;
+    if (!_handle || _progress || decodedFrames <= 0 || mpg123_index(_handle, &offsets, &step, &fill) != MPG123_OK ||
+        !offsets || fill == 0 || step <= 0) {
+        setError("No frame index available");
+        return false;
+    }
+
+    // Thin libmpg123's per-frame table down to one entry per interval
+    const int64_t intervalFrames = static_cast<int64_t>(Constants::SEEK_INDEX_INTERVAL_SECONDS) * _sampleRate;
+    const size_t wantedEntries = static_cast<size_t>(std::max<int64_t>(1, decodedFrames / intervalFrames));
+    const size_t stride = std::max<size_t>(1, fill / wantedEntries);
+
+    index.frames_per_entry = static_cast<int64_t>(step) * static_cast<int64_t>(stride);
+    index.length_frames = decodedFrames;
+    index.sample_rate = _sampleRate;
+    index.offsets.reserve(fill / stride + 1);
+    for (size_t i = 0; i < fill; i += stride) {
+        index.offsets.push_back(static_cast<int64_t>(offsets[i]));
+    }
+    return true;
+}
+
+bool Mp3Decoder::applySeekIndex(const SeekIndex& index) {
+    if (!_handle || !_cursor || index.empty() || index.sample_rate <= 0) {
+        return false;
+    }
+
+    // An index from an older copy of the file would send seeks to the wrong bytes
+    if (static_cast<uint64_t>(index.offsets.back()) >= _cursor->mapping->size()) {
+        setError("Seek index does not match the file");
+        return false;
+    }
+
+    std::vector<off_t> offsets(index.offsets.begin(), index.offsets.end());
+    if (mpg123_set_index(_handle, offsets.data(), static_cast<off_t>(index.frames_per_entry), offsets.size()) !=
+        MPG123_OK) {
+        setError("Failed to apply seek index: " + std::string(mpg123_strerror(_handle)));
+        return false;
+    }
+
+    // The full pass counted every frame, unlike the bitrate estimate of a VBR header
+    _lengthFrames = index.length_frames * _sampleRate / index.sample_rate;
+    return true;
+}
+
+int64_t Mp3Decoder::getLengthFrames() const {
+    return _lengthFrames;
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "decoder.hpp"
+
+// Opaque libmpg123 handle
+struct mpg123_handle_struct;
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Streaming MP3 decoder (libmpg123) delivering stereo S16 at a fixed output rate
+ *
+ * Complete files are decoded straight out of a memory mapping, so the decoder never
+ * issues small stdio reads while the audio thread waits. It can also decode a file
+ * that a download is still writing
+ * (openGrowing): bytes are fed to libmpg123 only up to what the download has flushed,
+ * and reads that catch up with the download are padded with silence instead of ending.
+ *
+ * libmpg123 ships several synthesis paths (generic, x86-64, AVX, NEON64, the integer
+ * ARM one, ...) and normally picks one by probing the CPU; a synth name pins it.
+ */
+class Mp3Decoder : public Decoder {
+public:
+    /**
+     * @param synth libmpg123 decoder name (see getSupportedSynths), empty to let libmpg123 choose
+     */
+    explicit Mp3Decoder(std::string synth = "");
+    ~Mp3Decoder() override;
+
+    Mp3Decoder(const Mp3Decoder&) = delete;
+    Mp3Decoder& operator=(const Mp3Decoder&) = delete;
+
+    /**
+     * @brief Open a file for decoding
+     * @param path Path to the MP3 file
+     * @param outputRate Sample rate the decoder should produce
+     * @return True if successful, false otherwise
+     */
+    bool open(const std::string& path, int outputRate);
+
+    /**
+     * @brief Decode from an existing mapping (e.g. one that was already validated)
+     * @param mapping Mapped MP3 file; kept alive for as long as the decoder is open
+     * @param outputRate Sample rate the decoder should produce
+     * @return True if successful, false otherwise
+     */
+    bool openMapped(std::shared_ptr<const ::AutoVibez::Utils::MappedFile> mapping, int outputRate) override;
+
+    /**
+     * @brief Open a partially downloaded file for progressive decoding
+     * @param path Path of the file being written
+     * @param progress Download counters that bound how far the file may be read
+     * @param outputRate Sample rate the decoder should produce
+     * @return True if successful, false otherwise
+     */
+    bool openGrowing(const std::string& path, std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress,
+                     int outputRate) override;
+
+    /**
+     * @brief Release the decoder handle (safe to call when closed)
+     */
+    void close();
+
+    bool isOpen() const {
+        return _handle != nullptr;
+    }
+
+    int read(int16_t* out, int frames) override;
+    bool seek(int64_t frame) override;
+    int64_t getLengthFrames() const override;
+    int getSampleRate() const override {
+        return _sampleRate;
+    }
+
+    /**
+     * @brief Keep libmpg123's frame index at full resolution so exportSeekIndex() has every frame
+     *
+     * Must be set before open(); meant for the one full pass at ingest.
+     */
+    void setIndexCapture(bool enabled) {
+        _captureIndex = enabled;
+    }
+
+    /**
+     * @brief Export the frame index built while decoding (after reading the whole file)
+     * @param decodedFrames Frames the pass produced, stored as the exact length
+     * @param index Receives one offset per SEEK_INDEX_INTERVAL_SECONDS
+     * @return True if successful, false otherwise
+     */
+    bool exportSeekIndex(int64_t decodedFrames, SeekIndex& index);
+
+    /**
+     * @brief Seed the decoder with a stored index: direct seeks and an exact length
+     * @param index Index exported from an earlier pass over the same file
+     * @return True if successful, false if it does not fit this file
+     */
+    bool applySeekIndex(const SeekIndex& index) override;
+
+    /**
+     * @brief Scale the decoded output (applied inside libmpg123 before conversion to S16)
+     * @param linear Linear gain factor, 1.0 leaves the signal untouched
+     * @return True if successful, false otherwise
+     */
+    bool setGain(double linear) override;
+
+    /**
+     * @brief "mpg123/" plus the synth in use (or the pinned one before open)
+     */
+    std::string getBackendName() const override;
+
+    /**
+     * @brief Synthesis paths this libmpg123 build can run on this CPU, in its order of preference
+     */
+    static std::vector<std::string> getSupportedSynths();
+
+    /**
+     * @brief Reads that caught up with the download and were padded with silence
+     */
+    int getUnderrunCount() const {
+        return _underruns.load(std::memory_order_relaxed);
+    }
+
+private:
+    bool createHandle(int outputRate);
+    bool feedFromFile();
+
+    // Read cursor over a mapping; libmpg123's reader callbacks receive it as their I/O handle
+    struct MappedCursor;
+
+    std::string _synth;
+    mpg123_handle_struct* _handle = nullptr;
+    int _sampleRate = 0;
+    int64_t _lengthFrames = -1;
+    bool _captureIndex = false;
+
+    std::unique_ptr<MappedCursor> _cursor;
+
+    // Progressive mode: the partial file and how much of it has been fed
+    std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> _progress;
+    FILE* _file = nullptr;
+    int64_t _fedBytes = 0;
+    std::vector<unsigned char> _feedBuffer;
+    std::atomic<int> _underruns{0};
+};
+
+}  // namespace AutoVibez::Audio
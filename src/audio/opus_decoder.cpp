@@ -0,0 +1,128 @@
+#include "opus_decoder.hpp"
+
+#ifdef HAVE_OPUS
+#include <opusfile.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Audio {
+
+OpusDecoder::OpusDecoder() = default;
+
+OpusDecoder::~OpusDecoder() {
+    close();
+}
+
+bool OpusDecoder::openMapped(std::shared_ptr<const ::AutoVibez::Utils::MappedFile> mapping, int outputRate) {
+    clearError();
+    close();
+#ifdef HAVE_OPUS
+    if (outputRate != Constants::OPUS_SAMPLE_RATE) {
+        setError("Opus decodes at 48 kHz only, not " + std::to_string(outputRate) + " Hz");
+        return false;
+    }
+    int err = 0;
+    _file = op_open_memory(mapping->data(), mapping->size(), &err);
+    if (!_file) {
+        setError("Failed to open Opus copy (error " + std::to_string(err) + ")");
+        return false;
+    }
+    _mapping = std::move(mapping);
+    return true;
+#else
+    (void)mapping;
+    (void)outputRate;
+    setError("Built without Opus support");
+    return false;
+#endif
+}
+
+bool OpusDecoder::openGrowing(const std::string& path,
+                              std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress, int outputRate) {
+    (void)path;
+    (void)progress;
+    (void)outputRate;
+    setError("Opus copies are only made of complete files");
+    return false;
+}
+
+void OpusDecoder::close() {
+#ifdef HAVE_OPUS
+    if (_file) {
+        op_free(_file);
+    }
+#endif
+    _file = nullptr;
+    _mapping.reset();
+}
+
+int OpusDecoder::read(int16_t* out, int frames) {
+    int written = 0;
+#ifdef HAVE_OPUS
+    while (_file && written < frames) {
+        const int got = op_read_stereo(_file, out + static_cast<size_t>(written) * 2, (frames - written) * 2);
+        if (got == OP_HOLE) {
+            continue;  // A damaged page is skipped rather than ending the mix
+        }
+        if (got <= 0) {
+            break;
+        }
+        written += got;
+    }
+#else
+    (void)out;
+    (void)frames;
+#endif
+    return written;
+}
+
+bool OpusDecoder::seek(int64_t frame) {
+#ifdef HAVE_OPUS
+    return _file && op_pcm_seek(_file, std::max<int64_t>(frame, 0)) == 0;
+#else
+    (void)frame;
+    return false;
+#endif
+}
+
+int64_t OpusDecoder::getLengthFrames() const {
+#ifdef HAVE_OPUS
+    const int64_t length = _file ? op_pcm_total(_file, -1) : -1;
+    return length < 0 ? -1 : length;
+#else
+    return -1;
+#endif
+}
+
+int OpusDecoder::getSampleRate() const {
+    return Constants::OPUS_SAMPLE_RATE;
+}
+
+bool OpusDecoder::applySeekIndex(const SeekIndex& index) {
+    (void)index;
+    return false;
+}
+
+bool OpusDecoder::setGain(double linear) {
+#ifdef HAVE_OPUS
+    if (!_file || linear <= 0.0) {
+        return false;
+    }
+    // Q7.8 dB on top of the header gain, which the transcoder leaves at zero
+    const double q8 = std::round(20.0 * std::log10(linear) * 256.0);
+    return op_set_gain_offset(_file, OP_HEADER_GAIN, static_cast<int>(std::clamp(q8, -32768.0, 32767.0))) == 0;
+#else
+    (void)linear;
+    return false;
+#endif
+}
+
+std::string OpusDecoder::getBackendName() const {
+    return "opusfile";
+}
+
+}  // namespace AutoVibez::Audio
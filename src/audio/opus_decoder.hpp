@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "decoder.hpp"
+
+// Opaque opusfile handle
+struct OggOpusFile;
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Plays the Opus copies OpusTranscoder writes (opusfile), stereo S16 at 48 kHz
+ *
+ * opusfile only decodes at 48 kHz, so openMapped fails for any other output rate and
+ * MixPlayer falls back to the MP3. Copies are only made of complete files, so there
+ * is no progressive mode, and opusfile bisects the Ogg pages itself instead of
+ * taking a stored seek index. Builds without HAVE_OPUS fail every open.
+ */
+class OpusDecoder : public Decoder {
+public:
+    OpusDecoder();
+    ~OpusDecoder() override;
+
+    OpusDecoder(const OpusDecoder&) = delete;
+    OpusDecoder& operator=(const OpusDecoder&) = delete;
+
+    bool openMapped(std::shared_ptr<const ::AutoVibez::Utils::MappedFile> mapping, int outputRate) override;
+    bool openGrowing(const std::string& path, std::shared_ptr<const ::AutoVibez::Utils::DownloadProgress> progress,
+                     int outputRate) override;
+
+    /**
+     * @brief Release the decoder (safe to call when closed)
+     */
+    void close();
+
+    bool isOpen() const {
+        return _file != nullptr;
+    }
+
+    int read(int16_t* out, int frames) override;
+    bool seek(int64_t frame) override;
+    int64_t getLengthFrames() const override;
+    int getSampleRate() const override;
+
+    bool applySeekIndex(const SeekIndex& index) override;
+    bool setGain(double linear) override;
+    std::string getBackendName() const override;
+
+private:
+    OggOpusFile* _file = nullptr;
+    std::shared_ptr<const ::AutoVibez::Utils::MappedFile> _mapping;  // opusfile reads straight from it
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,104 @@
+#include "opus_transcoder.hpp"
+
+#ifdef HAVE_OPUS
+#include <opusenc.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include "constants.hpp"
+#include "mp3_decoder.hpp"
+
+namespace AutoVibez::Audio {
+
+bool OpusTranscoder::isAvailable() {
+#ifdef HAVE_OPUS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string OpusTranscoder::getCopyPath(const std::string& mp3Path) {
+    return std::filesystem::path(mp3Path).replace_extension(".opus").string();
+}
+
+bool OpusTranscoder::hasFreshCopy(const std::string& mp3Path) {
+    std::error_code error;
+    const auto copyWritten = std::filesystem::last_write_time(getCopyPath(mp3Path), error);
+    if (error) {
+        return false;
+    }
+    const auto mp3Written = std::filesystem::last_write_time(mp3Path, error);
+    return !error && copyWritten >= mp3Written;
+}
+
+bool OpusTranscoder::transcode(const std::string& mp3Path, int bitrateKbps,
+                               const ::AutoVibez::Utils::CancellationToken* cancel) {
+    clearError();
+#ifdef HAVE_OPUS
+    Mp3Decoder decoder;
+    if (!decoder.open(mp3Path, Constants::OPUS_SAMPLE_RATE)) {
+        setError(decoder.getLastError());
+        return false;
+    }
+
+    const std::string copyPath = getCopyPath(mp3Path);
+    const std::string partPath = copyPath + ".part";
+    OggOpusComments* comments = ope_comments_create();
+    int err = OPE_OK;
+    OggOpusEnc* encoder = ope_encoder_create_file(partPath.c_str(), comments, Constants::OPUS_SAMPLE_RATE, 2, 0, &err);
+    ope_comments_destroy(comments);
+    if (!encoder) {
+        setError("Failed to create " + partPath + ": " + ope_strerror(err));
+        return false;
+    }
+    const int bitrate =
+        std::clamp(bitrateKbps, Constants::TRANSCODE_MIN_BITRATE_KBPS, Constants::TRANSCODE_MAX_BITRATE_KBPS);
+    ope_encoder_ctl(encoder, OPUS_SET_BITRATE(bitrate * 1000));
+    ope_encoder_ctl(encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_MUSIC));
+
+    std::vector<int16_t> block(static_cast<size_t>(Constants::TRANSCODE_BLOCK_FRAMES) * 2);
+    bool ok = true;
+    for (int frames = 0; ok && (frames = decoder.read(block.data(), Constants::TRANSCODE_BLOCK_FRAMES)) > 0;) {
+        if (cancel && cancel->isCancelled()) {
+            setError("Transcode cancelled");
+            ok = false;
+        } else if ((err = ope_encoder_write(encoder, block.data(), frames)) != OPE_OK) {
+            setError("Failed to encode " + mp3Path + ": " + ope_strerror(err));
+            ok = false;
+        }
+    }
+    if (ok && (err = ope_encoder_drain(encoder)) != OPE_OK) {
+        setError("Failed to finish " + partPath + ": " + ope_strerror(err));
+        ok = false;
+    }
+    ope_encoder_destroy(encoder);
+
+    // Only a complete copy gets the name the player looks for
+    std::error_code error;
+    if (ok) {
+        std::filesystem::rename(partPath, copyPath, error);
+        if (error) {
+            setError("Failed to rename " + partPath + ": " + error.message());
+            ok = false;
+        }
+    }
+    if (!ok) {
+        std::filesystem::remove(partPath, error);
+    }
+    return ok;
+#else
+    (void)mp3Path;
+    (void)bitrateKbps;
+    (void)cancel;
+    setError("Built without Opus support");
+    return false;
+#endif
+}
+
+}  // namespace AutoVibez::Audio
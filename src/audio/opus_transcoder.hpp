@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "cancellation_token.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Re-encodes a downloaded MP3 as a low-bitrate Opus copy that plays in its place
+ *
+ * The copy sits beside the MP3 under the same name with an .opus extension, so the
+ * mix cache can size and evict the two together without a column of its own. It is
+ * written to a .part file and renamed once complete; a copy older than its MP3 (the
+ * mix was downloaded again) counts as missing. Encoding needs libopusenc: builds
+ * without it (no HAVE_OPUS) report isAvailable() false and never write a copy.
+ */
+class OpusTranscoder : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    static bool isAvailable();
+
+    /**
+     * @brief Where the copy of a mix file goes
+     */
+    static std::string getCopyPath(const std::string& mp3Path);
+
+    /**
+     * @brief True if the copy exists and was written after the MP3
+     */
+    static bool hasFreshCopy(const std::string& mp3Path);
+
+    /**
+     * @brief Decode the MP3 at 48 kHz and encode it to its copy path
+     * @param mp3Path Downloaded mix file
+     * @param bitrateKbps Target bitrate, clamped to TRANSCODE_MIN/MAX_BITRATE_KBPS
+     * @param cancel Checked between blocks; a cancelled transcode leaves no file behind
+     * @return True if the copy was written
+     */
+    bool transcode(const std::string& mp3Path, int bitrateKbps, const ::AutoVibez::Utils::CancellationToken* cancel);
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,212 @@
+#include "pcm_ingest.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUTOVIBEZ_INGEST_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUTOVIBEZ_INGEST_NEON 1
+#endif
+
+#include "constants.hpp"
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr int CHUNK_SAMPLES = Constants::PCM_CONVERT_CHUNK_SAMPLES;
+constexpr float INT16_SCALE = 1.0f / 32768.0f;
+constexpr float INT32_SCALE = 1.0f / 2147483648.0f;
+
+template <PcmSampleFormat Format>
+struct SampleType;
+template <>
+struct SampleType<PcmSampleFormat::Float32> {
+    using type = float;
+};
+template <>
+struct SampleType<PcmSampleFormat::Int16> {
+    using type = int16_t;
+};
+template <>
+struct SampleType<PcmSampleFormat::Int24In32> {
+    using type = int32_t;
+};
+
+size_t sampleBytes(PcmSampleFormat format) {
+    switch (format) {
+        case PcmSampleFormat::Int16:
+            return sizeof(int16_t);
+        case PcmSampleFormat::Int24In32:
+            return sizeof(int32_t);
+        case PcmSampleFormat::Float32:
+        default:
+            return sizeof(float);
+    }
+}
+
+void toFloat(const int16_t* input, int count, float* output) {
+    int i = 0;
+#if defined(AUTOVIBEZ_INGEST_SSE2)
+    const __m128 scale = _mm_set1_ps(INT16_SCALE);
+    for (; i + 8 <= count; i += 8) {
+        // Sign-extend by placing each sample in the top half of a 32-bit lane and shifting back down
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#elif defined(AUTOVIBEZ_INGEST_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t samples = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), INT16_SCALE));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), INT16_SCALE));
+    }
+#endif
+    for (; i < count; ++i) {
+        output[i] = input[i] * INT16_SCALE;
+    }
+}
+
+void toFloat(const int32_t* input, int count, float* output) {
+    int i = 0;
+#if defined(AUTOVIBEZ_INGEST_SSE2)
+    const __m128 scale = _mm_set1_ps(INT32_SCALE);
+    for (; i + 4 <= count; i += 4) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), scale));
+    }
+#elif defined(AUTOVIBEZ_INGEST_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(input + i)), INT32_SCALE));
+    }
+#endif
+    for (; i < count; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT32_SCALE;
+    }
+}
+
+void duplicateMono(const float* input, int frames, float* output) {
+    int i = 0;
+#if defined(AUTOVIBEZ_INGEST_SSE2)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 samples = _mm_loadu_ps(input + i);
+        _mm_storeu_ps(output + 2 * i, _mm_unpacklo_ps(samples, samples));
+        _mm_storeu_ps(output + 2 * i + 4, _mm_unpackhi_ps(samples, samples));
+    }
+#elif defined(AUTOVIBEZ_INGEST_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4_t samples = vld1q_f32(input + i);
+        vst2q_f32(output + 2 * i, (float32x4x2_t{{samples, samples}}));
+    }
+#endif
+    for (; i < frames; ++i) {
+        output[2 * i] = input[i];
+        output[2 * i + 1] = input[i];
+    }
+}
+}  // namespace
+
+template <PcmSampleFormat Format, int Channels>
+void PcmIngest::ingest(const PcmIngest& self, const void* input, int frames, PcmRingBuffer& ring,
+                       BeatTracker* beats) {
+    using Sample = typename SampleType<Format>::type;
+    const Sample* samples = static_cast<const Sample*>(input);
+
+    if constexpr (Format == PcmSampleFormat::Float32 && Channels == 2) {
+        // Already what the ring holds
+        ring.write(samples, static_cast<size_t>(frames) * 2);
+        if (beats) {
+            beats->process(samples, frames);
+        }
+    } else {
+        const int channels = Channels > 0 ? Channels : self._channels;
+        const int framesPerChunk = CHUNK_SAMPLES / std::max(2, channels);
+        float converted[CHUNK_SAMPLES];
+        float stereo[CHUNK_SAMPLES];
+        for (int offset = 0; offset < frames; offset += framesPerChunk) {
+            const int chunkFrames = std::min(framesPerChunk, frames - offset);
+            const Sample* chunk = samples + static_cast<size_t>(offset) * channels;
+
+            const float* floats;
+            if constexpr (Format == PcmSampleFormat::Float32) {
+                floats = chunk;
+            } else {
+                toFloat(chunk, chunkFrames * channels, converted);
+                floats = converted;
+            }
+
+            const float* output;
+            if constexpr (Channels == 1) {
+                duplicateMono(floats, chunkFrames, stereo);
+                output = stereo;
+            } else if constexpr (Channels == 2) {
+                output = floats;
+            } else {
+                self._downmixer.process(floats, chunkFrames, stereo);
+                output = stereo;
+            }
+
+            ring.write(output, static_cast<size_t>(chunkFrames) * 2);
+            if (beats) {
+                beats->process(output, chunkFrames);
+            }
+        }
+    }
+}
+
+template <PcmSampleFormat Format>
+PcmIngest::Kernel PcmIngest::selectKernel(int channels) {
+    switch (channels) {
+        case 1:
+            return &ingest<Format, 1>;
+        case 2:
+            return &ingest<Format, 2>;
+        default:
+            return &ingest<Format, 0>;
+    }
+}
+
+bool PcmIngest::configure(int channels, PcmSampleFormat format, const std::string& downmixWeights) {
+    _kernel = nullptr;
+    _channels = 0;
+    _frameBytes = 0;
+    if (channels < 1 || channels > ChannelDownmixer::MAX_CHANNELS) {
+        return false;
+    }
+
+    // On bad weights the downmixer keeps the default fold for the channel count
+    const bool valid = channels <= 2 || _downmixer.configure(channels, downmixWeights);
+    _channels = channels;
+    _format = format;
+    _frameBytes = static_cast<size_t>(channels) * sampleBytes(format);
+    switch (format) {
+        case PcmSampleFormat::Float32:
+            _kernel = selectKernel<PcmSampleFormat::Float32>(channels);
+            break;
+        case PcmSampleFormat::Int16:
+            _kernel = selectKernel<PcmSampleFormat::Int16>(channels);
+            break;
+        case PcmSampleFormat::Int24In32:
+            _kernel = selectKernel<PcmSampleFormat::Int24In32>(channels);
+            break;
+    }
+    return valid;
+}
+
+void PcmIngest::processSilence(int frames, PcmRingBuffer& ring, BeatTracker* beats) const {
+    static const float zeros[CHUNK_SAMPLES] = {};
+    const int framesPerChunk = CHUNK_SAMPLES / 2;
+    for (int offset = 0; offset < frames; offset += framesPerChunk) {
+        const int chunkFrames = std::min(framesPerChunk, frames - offset);
+        ring.write(zeros, static_cast<size_t>(chunkFrames) * 2);
+        if (beats) {
+            beats->process(zeros, chunkFrames);
+        }
+    }
+}
+
+}  // namespace AutoVibez::Audio
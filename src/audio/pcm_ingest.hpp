@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "beat_tracker.hpp"
+#include "channel_downmixer.hpp"
+#include "pcm_ring_buffer.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Sample formats a capture device can hand over
+ */
+enum class PcmSampleFormat {
+    Float32,    //!< 32-bit float, -1..1
+    Int16,      //!< Signed 16-bit
+    Int24In32,  //!< Signed 24-bit left-justified in 32 bits, as WASAPI delivers it; full 32-bit samples read the same
+};
+
+/**
+ * @brief Turns a device's interleaved PCM into stereo float for the ring buffer and beat tracker
+ *
+ * configure() picks, once per device open, a kernel compiled for that channel
+ * count and sample format, so the audio callback neither divides by the channel
+ * count nor branches on the layout per buffer. Stereo float is written straight
+ * through; other layouts are converted in stack chunks (SSE2 or NEON when
+ * available) and folded by a ChannelDownmixer above two channels. process() does
+ * no allocation, locking or logging. Not thread-safe: configure only while the
+ * device is closed or paused.
+ */
+class PcmIngest {
+public:
+    /**
+     * @brief Select the kernel for a device layout
+     * @param channels Interleaved channels (1 to ChannelDownmixer::MAX_CHANNELS)
+     * @param format Sample format of the device buffers
+     * @param downmixWeights Spec for ChannelDownmixer, used above two channels
+     * @return True if the layout and weights were valid; bad weights fall back to the default fold,
+     *         an unsupported layout drops all input
+     */
+    bool configure(int channels, PcmSampleFormat format, const std::string& downmixWeights = "");
+
+    /**
+     * @brief Convert and deliver one device buffer
+     * @param input Interleaved samples, frames * getFrameBytes() bytes
+     * @param frames Number of frames
+     * @param ring Destination for stereo float
+     * @param beats Optional beat tracker fed the same stereo float
+     */
+    void process(const void* input, int frames, PcmRingBuffer& ring, BeatTracker* beats) const {
+        if (_kernel) {
+            _kernel(*this, input, frames, ring, beats);
+        }
+    }
+
+    /**
+     * @brief Deliver frames of silence without reading a payload, e.g. for a packet flagged silent
+     */
+    void processSilence(int frames, PcmRingBuffer& ring, BeatTracker* beats) const;
+
+    bool isConfigured() const {
+        return _kernel != nullptr;
+    }
+    int getChannels() const {
+        return _channels;
+    }
+    PcmSampleFormat getFormat() const {
+        return _format;
+    }
+
+    /**
+     * @brief Bytes per interleaved frame (0 if unconfigured)
+     */
+    size_t getFrameBytes() const {
+        return _frameBytes;
+    }
+
+private:
+    using Kernel = void (*)(const PcmIngest& self, const void* input, int frames, PcmRingBuffer& ring,
+                            BeatTracker* beats);
+
+    // Channels 0 stands for any count above two, folded by the downmixer
+    template <PcmSampleFormat Format, int Channels>
+    static void ingest(const PcmIngest& self, const void* input, int frames, PcmRingBuffer& ring, BeatTracker* beats);
+
+    template <PcmSampleFormat Format>
+    static Kernel selectKernel(int channels);
+
+    Kernel _kernel = nullptr;
+    int _channels = 0;
+    PcmSampleFormat _format = PcmSampleFormat::Float32;
+    size_t _frameBytes = 0;
+    ChannelDownmixer _downmixer;
+};
+
+}  // namespace AutoVibez::Audio
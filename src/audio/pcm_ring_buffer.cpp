@@ -0,0 +1,79 @@
+#include "pcm_ring_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace AutoVibez::Audio {
+
+namespace {
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+}  // namespace
+
+PcmRingBuffer::PcmRingBuffer(size_t capacity) {
+    size_t size = roundUpToPowerOfTwo(std::max<size_t>(capacity, 2));
+    _buffer.assign(size, 0.0f);
+    _mask = size - 1;
+}
+
+size_t PcmRingBuffer::write(const float* samples, size_t count) {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    const size_t tail = _tail.load(std::memory_order_acquire);
+    const size_t free_space = capacity() - (head - tail);
+    const size_t to_write = std::min(count, free_space);
+
+    if (to_write < count) {
+        _overflowCount.fetch_add(count - to_write, std::memory_order_relaxed);
+    }
+    if (to_write == 0) {
+        return 0;
+    }
+
+    // Copy in at most two spans around the wrap point
+    const size_t start = head & _mask;
+    const size_t first = std::min(to_write, capacity() - start);
+    std::memcpy(_buffer.data() + start, samples, first * sizeof(float));
+    if (first < to_write) {
+        std::memcpy(_buffer.data(), samples + first, (to_write - first) * sizeof(float));
+    }
+
+    _head.store(head + to_write, std::memory_order_release);
+    return to_write;
+}
+
+size_t PcmRingBuffer::read(float* out, size_t max_count) {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t head = _head.load(std::memory_order_acquire);
+    const size_t to_read = std::min(max_count, head - tail);
+
+    if (to_read == 0) {
+        _underrunCount.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    const size_t start = tail & _mask;
+    const size_t first = std::min(to_read, capacity() - start);
+    std::memcpy(out, _buffer.data() + start, first * sizeof(float));
+    if (first < to_read) {
+        std::memcpy(out + first, _buffer.data(), (to_read - first) * sizeof(float));
+    }
+
+    _tail.store(tail + to_read, std::memory_order_release);
+    return to_read;
+}
+
+size_t PcmRingBuffer::available() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+}
+
+void PcmRingBuffer::resetCounters() {
+    _overflowCount.store(0, std::memory_order_relaxed);
+    _underrunCount.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace AutoVibez::Audio
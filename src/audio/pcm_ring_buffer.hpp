@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Wait-free single-producer/single-consumer float ring buffer
+ *
+ * Hands PCM samples from the real-time audio callback to the render thread.
+ * The producer only copies into preallocated storage; the consumer drains in
+ * batches. Exactly one thread may call write() and exactly one may call read().
+ */
+class PcmRingBuffer {
+public:
+    /**
+     * @brief Create a ring buffer
+     * @param capacity Minimum number of samples to hold (rounded up to a power of two)
+     */
+    explicit PcmRingBuffer(size_t capacity);
+
+    PcmRingBuffer(const PcmRingBuffer&) = delete;
+    PcmRingBuffer& operator=(const PcmRingBuffer&) = delete;
+
+    /**
+     * @brief Append samples (producer side)
+     * @param samples Samples to copy
+     * @param count Number of samples
+     * @return Number of samples written; the remainder is counted as overflow
+     */
+    size_t write(const float* samples, size_t count);
+
+    /**
+     * @brief Remove up to max_count samples (consumer side)
+     * @param out Destination buffer
+     * @param max_count Capacity of the destination buffer
+     * @return Number of samples copied; zero is counted as an underrun
+     */
+    size_t read(float* out, size_t max_count);
+
+    /**
+     * @brief Number of samples currently readable
+     */
+    size_t available() const;
+
+    /**
+     * @brief Total usable capacity in samples
+     */
+    size_t capacity() const {
+        return _mask + 1;
+    }
+
+    /**
+     * @brief Samples dropped because the buffer was full
+     */
+    uint64_t getOverflowCount() const {
+        return _overflowCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drains that found no samples waiting
+     */
+    uint64_t getUnderrunCount() const {
+        return _underrunCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Reset the overflow/underrun counters
+     */
+    void resetCounters();
+
+private:
+    std::vector<float, Utils::TaggedAllocator<float, Utils::MemoryTag::PcmBuffers>> _buffer;
+    size_t _mask;
+
+    // Monotonic positions; writer owns _head, reader owns _tail
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+
+    std::atomic<uint64_t> _overflowCount{0};
+    std::atomic<uint64_t> _underrunCount{0};
+};
+
+}  // namespace AutoVibez::Audio
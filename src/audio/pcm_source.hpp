@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Pull-based stream of interleaved stereo signed 16-bit PCM
+ *
+ * Sources are created and destroyed on the control thread and read from the
+ * audio thread, so read() must not block on locks shared with the UI.
+ */
+class PcmSource {
+public:
+    virtual ~PcmSource() = default;
+
+    /**
+     * @brief Decode the next frames
+     * @param out Destination for frames * 2 interleaved samples
+     * @param frames Number of stereo frames requested
+     * @return Frames written; less than requested only at end of stream
+     */
+    virtual int read(int16_t* out, int frames) = 0;
+
+    /**
+     * @brief Move the read position
+     * @param frame Target position in output frames
+     * @return True if the source could seek
+     */
+    virtual bool seek(int64_t frame) = 0;
+
+    /**
+     * @brief Total length in output frames, or -1 if unknown
+     */
+    virtual int64_t getLengthFrames() const = 0;
+
+    /**
+     * @brief Output sample rate in Hz
+     */
+    virtual int getSampleRate() const = 0;
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,64 @@
+#include "prefetched_source.hpp"
+
+#include <algorithm>
+
+namespace AutoVibez::Audio {
+
+PrefetchedSource::PrefetchedSource(std::unique_ptr<PcmSource> inner, int prefetchFrames) : _inner(std::move(inner)) {
+    if (!_inner || prefetchFrames <= 0) {
+        return;
+    }
+
+    _head.resize(static_cast<size_t>(prefetchFrames) * 2);
+    int decoded = 0;
+    while (decoded < prefetchFrames) {
+        int got = _inner->read(_head.data() + static_cast<size_t>(decoded) * 2, prefetchFrames - decoded);
+        if (got <= 0) {
+            break;
+        }
+        decoded += got;
+    }
+    _head.resize(static_cast<size_t>(decoded) * 2);
+}
+
+int PrefetchedSource::read(int16_t* out, int frames) {
+    int copied = 0;
+    int buffered = getBufferedFrames();
+    if (buffered > 0) {
+        copied = std::min(buffered, frames);
+        std::copy_n(_head.begin() + static_cast<size_t>(_headPosition) * 2, static_cast<size_t>(copied) * 2, out);
+        _headPosition += copied;
+    }
+
+    if (copied < frames && _inner) {
+        copied += _inner->read(out + static_cast<size_t>(copied) * 2, frames - copied);
+    }
+    return copied;
+}
+
+bool PrefetchedSource::seek(int64_t frame) {
+    if (!_inner) {
+        return false;
+    }
+
+    // Seeking inside the head just moves the cursor; anything else drops it
+    const int64_t headFrames = static_cast<int64_t>(_head.size() / 2);
+    if (frame >= 0 && frame < headFrames && _inner->seek(headFrames)) {
+        _headPosition = static_cast<int>(frame);
+        return true;
+    }
+
+    _head.clear();
+    _headPosition = 0;
+    return _inner->seek(frame);
+}
+
+int64_t PrefetchedSource::getLengthFrames() const {
+    return _inner ? _inner->getLengthFrames() : -1;
+}
+
+int PrefetchedSource::getSampleRate() const {
+    return _inner ? _inner->getSampleRate() : 0;
+}
+
+}  // namespace AutoVibez::Audio
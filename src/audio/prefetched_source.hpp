@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "memory_accounting.hpp"
+#include "pcm_source.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Wraps a source whose first frames were decoded ahead of time
+ *
+ * The head is decoded on whichever thread constructs the object (normally a
+ * background lookahead task), so the audio thread's first reads after a gapless
+ * hand-off are plain copies.
+ */
+class PrefetchedSource : public PcmSource {
+public:
+    /**
+     * @brief Decode up to prefetchFrames from inner immediately
+     */
+    PrefetchedSource(std::unique_ptr<PcmSource> inner, int prefetchFrames);
+
+    int read(int16_t* out, int frames) override;
+    bool seek(int64_t frame) override;
+    int64_t getLengthFrames() const override;
+    int getSampleRate() const override;
+
+    /**
+     * @brief Frames currently held in the pre-decoded head
+     */
+    int getBufferedFrames() const {
+        return static_cast<int>(_head.size() / 2) - _headPosition;
+    }
+
+private:
+    std::unique_ptr<PcmSource> _inner;
+    std::vector<int16_t, Utils::TaggedAllocator<int16_t, Utils::MemoryTag::PcmBuffers>> _head;
+    int _headPosition = 0;
+};
+
+}  // namespace AutoVibez::Audio
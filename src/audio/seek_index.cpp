@@ -0,0 +1,74 @@
+#include "seek_index.hpp"
+
+#include <sstream>
+#include <utility>
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr const char* SEEK_INDEX_VERSION = "v1";
+}  // namespace
+
+std::string SeekIndex::serialize() const {
+    if (empty()) {
+        return "";
+    }
+
+    // Offsets only grow, so deltas keep a two-hour index to a few KB
+    std::ostringstream out;
+    out << SEEK_INDEX_VERSION << ';' << frames_per_entry << ';' << length_frames << ';' << sample_rate << ';';
+    int64_t previous = 0;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        if (i > 0) {
+            out << ',';
+        }
+        out << offsets[i] - previous;
+        previous = offsets[i];
+    }
+    return out.str();
+}
+
+bool SeekIndex::parse(const std::string& text, SeekIndex& index) {
+    index = SeekIndex();
+    if (text.empty()) {
+        return false;
+    }
+
+    std::istringstream in(text);
+    std::string version;
+    if (!std::getline(in, version, ';') || version != SEEK_INDEX_VERSION) {
+        return false;
+    }
+
+    SeekIndex parsed;
+    char separator = 0;
+    if (!(in >> parsed.frames_per_entry >> separator) || separator != ';' ||
+        !(in >> parsed.length_frames >> separator) || separator != ';' ||
+        !(in >> parsed.sample_rate >> separator) || separator != ';') {
+        return false;
+    }
+
+    int64_t offset = 0;
+    int64_t delta = 0;
+    while (in >> delta) {
+        if (delta < 0 || (delta == 0 && !parsed.offsets.empty())) {
+            return false;
+        }
+        offset += delta;
+        parsed.offsets.push_back(offset);
+        if (!(in >> separator)) {
+            break;
+        }
+        if (separator != ',') {
+            return false;
+        }
+    }
+
+    if (parsed.empty() || parsed.length_frames <= 0 || parsed.sample_rate <= 0) {
+        return false;
+    }
+    index = std::move(parsed);
+    return true;
+}
+
+}  // namespace AutoVibez::Audio
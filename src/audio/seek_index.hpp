@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Byte offsets of MPEG frames at fixed intervals, plus the exact decoded length
+ *
+ * Built by libmpg123 during one full pass over a file and stored with the mix, so later
+ * seeks jump straight to the nearest entry instead of scanning a VBR stream from the start.
+ */
+struct SeekIndex {
+    int64_t frames_per_entry = 0;  //!< MPEG frames between consecutive offsets
+    int64_t length_frames = 0;     //!< Exact decoded length in PCM frames at sample_rate
+    int sample_rate = 0;           //!< Rate length_frames was counted at
+    std::vector<int64_t> offsets;  //!< Byte offset of every frames_per_entry-th frame
+
+    bool empty() const {
+        return offsets.empty() || frames_per_entry <= 0;
+    }
+
+    /**
+     * @brief Compact text form for the database ("v1;step;length;rate;delta,delta,...")
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief Parse the serialized form
+     * @param text Output of serialize()
+     * @param index Receives the parsed index
+     * @return True if successful, false for empty or malformed text
+     */
+    static bool parse(const std::string& text, SeekIndex& index);
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,120 @@
+#include "synthetic_capture.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include "constants.hpp"
+#include "mp3_decoder.hpp"
+#include "string_utils.hpp"
+#include "test_signal.hpp"
+#include "wav_source.hpp"
+
+namespace AutoVibez::Audio {
+
+SyntheticCapture::~SyntheticCapture() {
+    stop();
+}
+
+std::unique_ptr<PcmSource> SyntheticCapture::createSource(const std::string& spec, int sampleRate,
+                                                          std::string& error) {
+    TestSignalType type;
+    if (TestSignalSource::parseType(spec, type)) {
+        return std::make_unique<TestSignalSource>(type, sampleRate);
+    }
+
+    const std::string lower = ::AutoVibez::Utils::StringUtils::toLower(spec);
+    if (::AutoVibez::Utils::StringUtils::endsWith(lower, ".wav")) {
+        auto wav = std::make_unique<WavSource>();
+        if (!wav->open(spec, sampleRate)) {
+            error = wav->getLastError();
+            return nullptr;
+        }
+        return wav;
+    }
+    if (::AutoVibez::Utils::StringUtils::endsWith(lower, ".mp3")) {
+        auto mp3 = std::make_unique<Mp3Decoder>();
+        if (!mp3->open(spec, sampleRate)) {
+            error = mp3->getLastError();
+            return nullptr;
+        }
+        return mp3;
+    }
+
+    error = "Unknown synthetic audio source: " + spec;
+    return nullptr;
+}
+
+bool SyntheticCapture::start(SampleCallback callback, void* userData, std::unique_ptr<PcmSource> source,
+                             double speed) {
+    if (_running.load()) {
+        return true;
+    }
+    stop();
+    if (!callback || !source) {
+        _lastError = !callback ? "No sample callback" : "No audio source";
+        return false;
+    }
+
+    _callback = callback;
+    _userData = userData;
+    _source = std::move(source);
+    _speed = speed > 0.0 ? speed : 0.0;
+    _framesDelivered.store(0, std::memory_order_relaxed);
+    _lastError.clear();
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread(&SyntheticCapture::threadMain, this);
+    return true;
+}
+
+void SyntheticCapture::stop() {
+    // The worker may already have exited at the end of a source that cannot loop
+    _running.store(false, std::memory_order_release);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _source.reset();
+}
+
+void SyntheticCapture::threadMain() {
+    using Clock = std::chrono::steady_clock;
+    const int blockFrames = Constants::DEFAULT_SAMPLES;
+    std::vector<int16_t> pcm(static_cast<size_t>(blockFrames) * 2);
+    std::vector<float> samples(pcm.size());
+    constexpr float scale = 1.0f / 32768.0f;
+
+    // Deadlines are computed from the frame count rather than accumulated, so pacing never drifts
+    const double framesPerSecond = _source->getSampleRate() * _speed;
+    const Clock::time_point started = Clock::now();
+    int64_t delivered = 0;
+    bool rewound = false;
+
+    while (_running.load(std::memory_order_acquire)) {
+        int frames = _source->read(pcm.data(), blockFrames);
+        if (frames <= 0) {
+            // Loop at the end; a source that cannot rewind or yields nothing after rewinding is finished
+            if (rewound || !_source->seek(0)) {
+                break;
+            }
+            rewound = true;
+            continue;
+        }
+        rewound = false;
+
+        for (int i = 0; i < frames * 2; ++i) {
+            samples[i] = pcm[i] * scale;
+        }
+        _callback(_userData, samples.data(), static_cast<int>(frames * 2 * sizeof(float)));
+        delivered += frames;
+        _framesDelivered.store(delivered, std::memory_order_relaxed);
+
+        if (framesPerSecond > 0.0) {
+            std::this_thread::sleep_until(started + std::chrono::duration_cast<Clock::duration>(
+                                                        std::chrono::duration<double>(delivered / framesPerSecond)));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    _running.store(false, std::memory_order_release);
+}
+
+}  // namespace AutoVibez::Audio
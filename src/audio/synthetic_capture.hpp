@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "pcm_source.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Replays a file or a generated signal as if it were a capture device
+ *
+ * A worker thread reads the source in DEFAULT_SAMPLES blocks, loops it at the end, and
+ * delivers interleaved stereo float with the same signature as audioInputCallbackF32.
+ * Blocks are paced against a steady clock at a multiple of real time, so projectM sees
+ * identical input on every machine. A speed of 0 drops the pacing for throughput runs; the
+ * ring buffer then discards whatever the renderer cannot keep up with.
+ */
+class SyntheticCapture {
+public:
+    /**
+     * @brief Receives samples on the worker thread
+     * @param userData Opaque pointer passed to start()
+     * @param buffer Interleaved stereo float samples
+     * @param len Buffer size in bytes
+     */
+    using SampleCallback = void (*)(void* userData, const float* buffer, int len);
+
+    SyntheticCapture() = default;
+    ~SyntheticCapture();
+
+    SyntheticCapture(const SyntheticCapture&) = delete;
+    SyntheticCapture& operator=(const SyntheticCapture&) = delete;
+
+    /**
+     * @brief Build a source from a spec
+     * @param spec Signal name ("sweep", "pink", "kicks", "sine") or a .wav/.mp3 path
+     * @param sampleRate Rate the source should produce
+     * @param error Set when no source could be created
+     * @return The source, or nullptr
+     */
+    static std::unique_ptr<PcmSource> createSource(const std::string& spec, int sampleRate, std::string& error);
+
+    /**
+     * @brief Start delivering samples
+     * @param callback Invoked on the worker thread for every block
+     * @param userData Opaque pointer handed back to the callback
+     * @param source Stream to replay; owned until stop()
+     * @param speed Multiple of real time (1 = real time, 0 = unpaced)
+     * @return True if the worker is running
+     */
+    bool start(SampleCallback callback, void* userData, std::unique_ptr<PcmSource> source, double speed = 1.0);
+
+    /**
+     * @brief Join the worker and release the source (safe to call when stopped)
+     */
+    void stop();
+
+    bool isRunning() const {
+        return _running.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Stereo frames delivered since start()
+     */
+    int64_t getFramesDelivered() const {
+        return _framesDelivered.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Last error, if start() failed
+     */
+    const std::string& getLastError() const {
+        return _lastError;
+    }
+
+private:
+    void threadMain();
+
+    SampleCallback _callback = nullptr;
+    void* _userData = nullptr;
+    std::unique_ptr<PcmSource> _source;
+    double _speed = 1.0;
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+    std::atomic<int64_t> _framesDelivered{0};
+    std::string _lastError;
+};
+
+}  // namespace AutoVibez::Audio
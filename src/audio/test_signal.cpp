@@ -0,0 +1,135 @@
+#include "test_signal.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+constexpr double LEVEL = 0.5;  // -6 dBFS peak, leaving headroom for the kick and hat to overlap
+
+constexpr double SWEEP_SECONDS = 10.0;
+constexpr double SWEEP_START_HZ = 20.0;
+constexpr double SWEEP_END_HZ = 20000.0;
+constexpr double TONE_HZ = 440.0;
+
+// Kick: 50 Hz body with a fast pitch drop from 150 Hz; hat: short noise burst between beats
+constexpr double KICK_BASE_HZ = 50.0;
+constexpr double KICK_DROP_HZ = 100.0;
+constexpr double KICK_DROP_SECONDS = 0.03;
+constexpr double KICK_DECAY_SECONDS = 0.25;
+constexpr double HAT_DECAY_SECONDS = 0.02;
+constexpr double HAT_LEVEL = 0.25;
+
+constexpr uint32_t PINK_SEED = 0x2545f491u;
+constexpr float PINK_GAIN = 0.11f;  // Brings the Kellet filter's output back to roughly unit peak
+
+// Stateless white noise for a frame index, in [-1, 1)
+float hashNoise(uint64_t frame) {
+    uint64_t x = frame * 0x9e3779b97f4a7c15ull;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return static_cast<float>(static_cast<double>(x >> 40) / static_cast<double>(1ull << 23) - 1.0);
+}
+}  // namespace
+
+TestSignalSource::TestSignalSource(TestSignalType type, int sampleRate, double bpm)
+    : _type(type), _sampleRate(std::max(1, sampleRate)), _beatFrames(60.0 * _sampleRate / std::max(1.0, bpm)) {
+    seek(0);
+}
+
+bool TestSignalSource::parseType(const std::string& name, TestSignalType& type) {
+    if (name == "sweep") {
+        type = TestSignalType::Sweep;
+    } else if (name == "pink") {
+        type = TestSignalType::PinkNoise;
+    } else if (name == "kicks") {
+        type = TestSignalType::Kicks;
+    } else if (name == "sine") {
+        type = TestSignalType::Sine;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int TestSignalSource::read(int16_t* out, int frames) {
+    if (!out || frames <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < frames; ++i) {
+        float value = std::clamp(sampleAt(_position++), -1.0f, 1.0f);
+        auto sample = static_cast<int16_t>(std::lround(value * 32767.0f));
+        out[2 * i] = sample;
+        out[2 * i + 1] = sample;
+    }
+    return frames;
+}
+
+bool TestSignalSource::seek(int64_t frame) {
+    frame = std::max<int64_t>(0, frame);
+    if (_type == TestSignalType::PinkNoise) {
+        // The filter carries state, so replay it from the seed
+        _noiseSeed = PINK_SEED;
+        std::fill(std::begin(_pink), std::end(_pink), 0.0f);
+        for (int64_t i = 0; i < frame; ++i) {
+            nextPink();
+        }
+    }
+    _position = frame;
+    return true;
+}
+
+float TestSignalSource::nextPink() {
+    _noiseSeed = _noiseSeed * 1664525u + 1013904223u;
+    const float white = static_cast<float>(_noiseSeed >> 8) / static_cast<float>(1u << 23) - 1.0f;
+
+    // Paul Kellet's economy filter: -3 dB/octave within 0.05 dB above 9 Hz
+    _pink[0] = 0.99886f * _pink[0] + white * 0.0555179f;
+    _pink[1] = 0.99332f * _pink[1] + white * 0.0750759f;
+    _pink[2] = 0.96900f * _pink[2] + white * 0.1538520f;
+    _pink[3] = 0.86650f * _pink[3] + white * 0.3104856f;
+    _pink[4] = 0.55000f * _pink[4] + white * 0.5329522f;
+    _pink[5] = -0.7616f * _pink[5] - white * 0.0168980f;
+    float pink = _pink[0] + _pink[1] + _pink[2] + _pink[3] + _pink[4] + _pink[5] + _pink[6] + white * 0.5362f;
+    _pink[6] = white * 0.115926f;
+    return pink * PINK_GAIN;
+}
+
+float TestSignalSource::sampleAt(int64_t frame) {
+    const double rate = _sampleRate;
+    switch (_type) {
+        case TestSignalType::Sweep: {
+            const double periodFrames = SWEEP_SECONDS * rate;
+            const double t = std::fmod(static_cast<double>(frame), periodFrames) / rate;
+            const double k = std::log(SWEEP_END_HZ / SWEEP_START_HZ) / SWEEP_SECONDS;
+            const double phase = 2.0 * PI * SWEEP_START_HZ * (std::exp(k * t) - 1.0) / k;
+            return static_cast<float>(LEVEL * std::sin(phase));
+        }
+        case TestSignalType::PinkNoise:
+            return static_cast<float>(LEVEL) * nextPink();
+        case TestSignalType::Kicks: {
+            const double inBeat = std::fmod(static_cast<double>(frame), _beatFrames);
+            const double t = inBeat / rate;
+            const double phase = 2.0 * PI *
+                                 (KICK_BASE_HZ * t + KICK_DROP_HZ * KICK_DROP_SECONDS *
+                                                         (1.0 - std::exp(-t / KICK_DROP_SECONDS)));
+            double value = std::exp(-t / KICK_DECAY_SECONDS) * std::sin(phase);
+
+            const double sinceHat = (inBeat - 0.5 * _beatFrames) / rate;
+            if (sinceHat >= 0.0) {
+                value += HAT_LEVEL * std::exp(-sinceHat / HAT_DECAY_SECONDS) * hashNoise(static_cast<uint64_t>(frame));
+            }
+            return static_cast<float>(LEVEL * value);
+        }
+        case TestSignalType::Sine:
+            return static_cast<float>(LEVEL * std::sin(2.0 * PI * std::fmod(TONE_HZ * frame / rate, 1.0)));
+    }
+    return 0.0f;
+}
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "constants.hpp"
+#include "pcm_source.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief Generated signals available as a synthetic audio input
+ */
+enum class TestSignalType {
+    Sweep,      //!< Logarithmic sine sweep, 20 Hz to 20 kHz every ten seconds
+    PinkNoise,  //!< Pink noise from a fixed seed
+    Kicks,      //!< Four-on-the-floor kick drum with off-beat hi-hats
+    Sine        //!< Steady 440 Hz tone
+};
+
+/**
+ * @brief Endless, deterministic test signal
+ *
+ * Every run produces the same samples for the same type, rate and tempo, so frame-time
+ * and preset-cost measurements do not depend on what a microphone happens to hear.
+ * Sweeps, kicks and tones are computed from the frame index directly; pink noise is
+ * regenerated from its seed when seeking.
+ */
+class TestSignalSource : public PcmSource {
+public:
+    /**
+     * @brief Create a generator
+     * @param type Signal to produce
+     * @param sampleRate Output rate in Hz
+     * @param bpm Tempo of the kick pattern
+     */
+    explicit TestSignalSource(TestSignalType type, int sampleRate = Constants::DEFAULT_SAMPLE_RATE,
+                              double bpm = 120.0);
+
+    int read(int16_t* out, int frames) override;
+    bool seek(int64_t frame) override;
+    int64_t getLengthFrames() const override {
+        return -1;
+    }
+    int getSampleRate() const override {
+        return _sampleRate;
+    }
+
+    TestSignalType getType() const {
+        return _type;
+    }
+
+    /**
+     * @brief Parse a signal name ("sweep", "pink", "kicks", "sine")
+     * @return True if the name is known
+     */
+    static bool parseType(const std::string& name, TestSignalType& type);
+
+private:
+    float sampleAt(int64_t frame);
+    float nextPink();
+
+    TestSignalType _type;
+    int _sampleRate;
+    double _beatFrames;
+    int64_t _position = 0;
+
+    uint32_t _noiseSeed = 0;
+    float _pink[7] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+}  // namespace AutoVibez::Audio
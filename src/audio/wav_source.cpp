@@ -0,0 +1,160 @@
+#include "wav_source.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace AutoVibez::Audio {
+
+namespace {
+constexpr uint16_t FORMAT_PCM = 1;
+constexpr uint16_t FORMAT_FLOAT = 3;
+constexpr uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t readLe16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// One sample scaled to [-1, 1]
+float decodeSample(const uint8_t* p, uint16_t format, int bytes) {
+    if (format == FORMAT_FLOAT) {
+        float value;
+        uint32_t bits = readLe32(p);
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    switch (bytes) {
+        case 2:
+            return static_cast<int16_t>(readLe16(p)) / 32768.0f;
+        case 3: {
+            int32_t value = static_cast<int32_t>((p[0] << 8) | (p[1] << 16) | (static_cast<uint32_t>(p[2]) << 24));
+            return static_cast<float>(value / 2147483648.0);
+        }
+        default:
+            return static_cast<float>(static_cast<int32_t>(readLe32(p)) / 2147483648.0);
+    }
+}
+
+int16_t toS16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+}  // namespace
+
+bool WavSource::open(const std::string& path, int outputRate) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        setError("Cannot open WAV file: " + path);
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return openData(data.data(), data.size(), outputRate);
+}
+
+bool WavSource::openData(const uint8_t* data, size_t size, int outputRate) {
+    _samples.clear();
+    _position = 0;
+    if (!data || size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        setError("Not a RIFF/WAVE file");
+        return false;
+    }
+    if (outputRate <= 0) {
+        setError("Invalid output sample rate");
+        return false;
+    }
+
+    uint16_t format = 0;
+    int channels = 0;
+    int rate = 0;
+    int bits = 0;
+    const uint8_t* pcm = nullptr;
+    size_t pcmBytes = 0;
+    for (size_t offset = 12; offset + 8 <= size;) {
+        const uint8_t* chunk = data + offset;
+        size_t chunkSize = readLe32(chunk + 4);
+        size_t available = std::min(chunkSize, size - offset - 8);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = readLe16(chunk + 8);
+            channels = readLe16(chunk + 10);
+            rate = static_cast<int>(readLe32(chunk + 12));
+            bits = readLe16(chunk + 22);
+            if (format == FORMAT_EXTENSIBLE && available >= 26) {
+                format = readLe16(chunk + 32);  // First two bytes of the sub-format GUID
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            pcm = chunk + 8;
+            pcmBytes = available;  // Truncated files keep what was written
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    const bool integer = format == FORMAT_PCM && (bits == 16 || bits == 24 || bits == 32);
+    const bool floating = format == FORMAT_FLOAT && bits == 32;
+    if (!pcm || channels <= 0 || rate <= 0 || (!integer && !floating)) {
+        setError("Unsupported WAV format (need 16/24/32-bit PCM or 32-bit float)");
+        return false;
+    }
+
+    const int sampleBytes = bits / 8;
+    const size_t frameBytes = static_cast<size_t>(sampleBytes) * channels;
+    const size_t inputFrames = pcmBytes / frameBytes;
+    if (inputFrames == 0) {
+        setError("WAV file has no audio");
+        return false;
+    }
+
+    auto channelAt = [&](size_t frame, int channel) {
+        return decodeSample(pcm + frame * frameBytes + static_cast<size_t>(channel) * sampleBytes, format,
+                            sampleBytes);
+    };
+    const int right = channels > 1 ? 1 : 0;
+
+    const double step = static_cast<double>(rate) / outputRate;
+    const auto outputFrames = static_cast<size_t>(std::floor((inputFrames - 1) / step)) + 1;
+    _samples.resize(outputFrames * 2);
+    for (size_t i = 0; i < outputFrames; ++i) {
+        const double position = i * step;
+        const auto index = static_cast<size_t>(position);
+        const size_t nextIndex = std::min(index + 1, inputFrames - 1);
+        const auto fraction = static_cast<float>(position - index);
+        for (int c = 0; c < 2; ++c) {
+            const int channel = c == 0 ? 0 : right;
+            float a = channelAt(index, channel);
+            float b = channelAt(nextIndex, channel);
+            _samples[2 * i + c] = toS16(a + (b - a) * fraction);
+        }
+    }
+    _sampleRate = outputRate;
+    setSuccess(true);
+    return true;
+}
+
+int WavSource::read(int16_t* out, int frames) {
+    if (!out || frames <= 0) {
+        return 0;
+    }
+    const int64_t total = getLengthFrames();
+    const int count = static_cast<int>(std::min<int64_t>(frames, total - _position));
+    if (count <= 0) {
+        return 0;
+    }
+    std::copy_n(_samples.data() + _position * 2, static_cast<size_t>(count) * 2, out);
+    _position += count;
+    return count;
+}
+
+bool WavSource::seek(int64_t frame) {
+    if (_samples.empty()) {
+        return false;
+    }
+    _position = std::clamp<int64_t>(frame, 0, getLengthFrames());
+    return true;
+}
+
+}  // namespace AutoVibez::Audio
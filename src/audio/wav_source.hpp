@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "error_handler.hpp"
+#include "pcm_source.hpp"
+
+namespace AutoVibez::Audio {
+
+/**
+ * @brief WAV file loaded into memory as stereo S16 at a fixed output rate
+ *
+ * Accepts 16/24/32-bit integer and 32-bit float PCM (plain or WAVE_FORMAT_EXTENSIBLE).
+ * Mono is duplicated to both channels, extra channels are dropped, and other sample
+ * rates are converted once with linear interpolation at load time, so read() is a copy.
+ */
+class WavSource : public PcmSource, public ::AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @brief Load a file
+     * @param path Path to the WAV file
+     * @param outputRate Sample rate read() should produce
+     * @return True if successful, false otherwise
+     */
+    bool open(const std::string& path, int outputRate);
+
+    /**
+     * @brief Load from bytes already in memory
+     * @param data Contents of a WAV file
+     * @param size Number of bytes
+     * @param outputRate Sample rate read() should produce
+     * @return True if successful, false otherwise
+     */
+    bool openData(const uint8_t* data, size_t size, int outputRate);
+
+    int read(int16_t* out, int frames) override;
+    bool seek(int64_t frame) override;
+    int64_t getLengthFrames() const override {
+        return static_cast<int64_t>(_samples.size() / 2);
+    }
+    int getSampleRate() const override {
+        return _sampleRate;
+    }
+
+private:
+    std::vector<int16_t> _samples;  // Interleaved stereo
+    int _sampleRate = 0;
+    int64_t _position = 0;
+};
+
+}  // namespace AutoVibez::Audio
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "app_config.hpp"
+#include "mix_metadata.hpp"
+#include "preset_manifest.hpp"
+#include "startup_graph.hpp"
+#include "system_volume_controller.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief The work startup runs beside window and GL creation, and what it produces
+ *
+ * Only GL and projectM stand between launch and the first frame; everything here is
+ * picked up when its task is done. Each result is written by the task named next to
+ * it and may be read once graph reports that task done.
+ */
+struct AppStartup {
+    static constexpr const char* CONFIG_TASK = "config";
+    static constexpr const char* ASSETS_TASK = "assets";
+    static constexpr const char* PRESETS_TASK = "presets";
+    static constexpr const char* PRESET_RESCAN_TASK = "preset_rescan";
+    static constexpr const char* VOLUME_TASK = "volume";
+    static constexpr const char* MANIFEST_TASK = "manifest";
+
+    std::chrono::steady_clock::time_point launched = std::chrono::steady_clock::now();
+
+    std::string config_path;                                   // CONFIG_TASK; empty without a config file
+    std::shared_ptr<const AutoVibez::Data::AppConfig> config;  // CONFIG_TASK; read by everyone, null without a file
+    std::string preset_path;                                   // ASSETS_TASK
+    std::string texture_path;                                  // ASSETS_TASK
+    AutoVibez::Data::PresetManifest presets;                   // PRESETS_TASK
+    bool presets_from_manifest = false;                        // PRESETS_TASK; false if the tree was walked instead
+    std::vector<AutoVibez::Data::Mix> manifest_mixes;          // MANIFEST_TASK
+    bool manifest_loaded = false;                              // MANIFEST_TASK; false without a mixes URL or on failure
+    bool manifest_unchanged = false;                           // MANIFEST_TASK
+
+    // VOLUME_TASK; null until then, as the probe shells out
+    std::unique_ptr<AutoVibez::Utils::ISystemVolumeController> volume_controller;
+
+    // Last, so it is destroyed first: its tasks write the fields above until it joins
+    StartupGraph graph;
+};
+
+}  // namespace AutoVibez::Core
@@ -2,19 +2,31 @@
 
 #include <backends/imgui_impl_sdl2.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
 #include <filesystem>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-#include "config_manager.hpp"
+#include "app_config.hpp"
 #include "console_output.hpp"
 #include "constants.hpp"
+#include "imgui_manager.hpp"
+#include "json_utils.hpp"
+#include "memory_accounting.hpp"
 #include "mix_downloader.hpp"
 #include "mix_manager.hpp"
 #include "mix_metadata.hpp"
 #include "overlay_messages.hpp"
 #include "path_manager.hpp"
 #include "setup.hpp"
+#include "trace_recorder.hpp"
 #include "utils/logger.hpp"
 #if defined _MSC_VER
 #include <direct.h>
@@ -24,24 +36,29 @@
 
 using AutoVibez::Data::MixManager;
 
-using AutoVibez::Data::ConfigFile;
+using AutoVibez::Data::AppConfig;
 using AutoVibez::Data::Mix;
 using AutoVibez::UI::HelpOverlay;
 
 namespace AutoVibez::Core {
 
-AutoVibezApp::AutoVibezApp(SDL_GLContext glCtx, const std::string& presetPath, const std::string& texturePath,
-                           int audioDeviceIndex, bool showFps)
+AutoVibezApp::AutoVibezApp(SDL_GLContext glCtx, std::shared_ptr<AppStartup> startup, int audioDeviceIndex,
+                           bool showFps)
     : _openGlContext(glCtx),
+      _startup(std::move(startup)),
       _projectM(projectm_create()),
       _playlist(projectm_playlist_create(_projectM)),
       _selectedAudioDeviceIndex(audioDeviceIndex),
-      _mixManagerInitialized(false),
+      _showPerformanceHud(showFps),
+      _presetManifest(_startup->presets),
       _hadMixesOnStartup(false) {
+    AUTOVIBEZ_TRACE_SCOPE("startup", "AutoVibezApp");
     projectm_get_window_size(_projectM, &_width, &_height);
+    _texturePath = _startup->texture_path;
+    const char* texturePaths[] = {_texturePath.c_str()};
+    projectm_set_texture_search_paths(_projectM, texturePaths, 1);
     projectm_playlist_set_preset_switched_event_callback(_playlist, &AutoVibezApp::presetSwitchedEvent,
                                                          static_cast<void*>(this));
-    projectm_playlist_add_path(_playlist, presetPath.c_str(), true, false);
 
     // Initialize PresetManager
     _presetManager = std::make_unique<PresetManager>(_playlist);
@@ -49,38 +66,66 @@ AutoVibezApp::AutoVibezApp(SDL_GLContext glCtx, const std::string& presetPath, c
     // Initialize KeyBindingManager
     _keyBindingManager = std::make_unique<KeyBindingManager>();
 
-    // Initialize System Volume Controller
-    _systemVolumeController = AutoVibez::Utils::SystemVolumeControllerFactory::create();
-
-    // Load a random preset on startup (lightweight operation)
-    if (_presetManager) {
-        _presetManager->randomPreset();
-    }
-
-    // Heavy operations (database, mix loading) will be deferred to initialize()
+    // The preset list and the volume backend arrive from their startup tasks through finishStartup; projectM
+    // draws its idle preset until then. Heavy operations (database, mix loading) will be deferred to initialize()
 }
 
 AutoVibezApp::~AutoVibezApp() {
-    // Stop any playing music and clean up MixManager
+    AUTOVIBEZ_TRACE_INSTANT("app", "shutdown", std::string());
+    // A control thread in the startup load or a retry wait gives up instead of holding up the join; downloads
+    // cut short keep their partial files to resume next time
+    _shutdownToken.cancel();
+    _remoteControl.stop();
+    // Once the control thread has joined, the mix manager is safe to touch from here
+    _mixControl.stop();
+
+    // Detach the output tap before projectM goes away, then stop any playing music; the wake handler goes
+    // too, as download workers may still call it after _mixControl is destroyed
+    _internalAudioActive.store(false);
     if (_mixManager) {
+        _mixManager->setPcmTap(nullptr, nullptr);
+        _mixManager->setWakeHandler(nullptr);
         _mixManager->stop();
     }
 
-    if (_backgroundTaskRunning.load()) {
-        if (_backgroundTask.valid()) {
-            _backgroundTask.wait();
-        }
-        _backgroundTaskRunning.store(false);
+    // The queries of the session are all in by now
+    if (_queryStats) {
+        dumpQueryStats();
+    }
+    if (_dumpDownloadStats) {
+        dumpDownloadStats();
+    }
+
+    // A device reopen in flight touches the capture state below
+    if (_audioReconnectTask.valid()) {
+        _audioReconnectTask.wait();
+    }
+
+    // Workers save what they finished, so the next start picks up from there
+    _textureCache.stop();
+
+    // Keeps costs measured this session for the next start; the rescan may still be writing the manifest
+    _startup->graph.waitAll();
+    if (_presetManifestScanned.load()) {
+        _presetManifest.save(PathManager::getPresetManifestPath());
     }
 
     projectm_playlist_destroy(_playlist);
     _playlist = nullptr;
     projectm_destroy(_projectM);
     _projectM = nullptr;
+
+#ifdef AUTOVIBEZ_TRACING
+    // Shutdown is part of the lifecycle too, so the exit trace is written last
+    dumpTrace();
+#endif
 }
 
 /* Stretch projectM across multiple monitors */
 void AutoVibezApp::stretchMonitors() {
+    if (_multiOutput) {
+        return;  // Multi-output owns the window placement
+    }
     int displayCount = SDL_GetNumVideoDisplays();
     if (displayCount >= 2) {
         std::vector<SDL_Rect> displayBounds;
@@ -121,6 +166,9 @@ void AutoVibezApp::stretchMonitors() {
 
 /* Moves projectM to the next monitor */
 void AutoVibezApp::nextMonitor() {
+    if (_multiOutput) {
+        return;
+    }
     int displayCount = SDL_GetNumVideoDisplays();
     int currentWindowIndex = SDL_GetWindowDisplayIndex(_sdlWindow);
     if (displayCount >= 2) {
@@ -165,6 +213,7 @@ void AutoVibezApp::toggleFullScreen() {
 void AutoVibezApp::resizeWindow(unsigned int width_, unsigned int height_) {
     _width = width_;
     _height = height_;
+    _resizeCoalescer.setApplied(static_cast<int>(width_), static_cast<int>(height_));
 
     // Hide cursor if window size equals desktop size
     SDL_DisplayMode dm;
@@ -172,7 +221,8 @@ void AutoVibezApp::resizeWindow(unsigned int width_, unsigned int height_) {
         SDL_ShowCursor(_isFullScreen ? SDL_DISABLE : SDL_ENABLE);
     }
 
-    projectm_set_window_size(_projectM, _width, _height);
+    _resolutionGovernor.reset();
+    applyRenderSize();
 
     // Update message overlay window size
     if (_messageOverlay) {
@@ -180,9 +230,42 @@ void AutoVibezApp::resizeWindow(unsigned int width_, unsigned int height_) {
     }
 }
 
+void AutoVibezApp::queueResize(int width, int height) {
+    if (!_resizeCoalescer.onResize(width, height, std::chrono::steady_clock::now())) {
+        return;
+    }
+    // Blits and overlays follow the window at once; only projectM's targets wait
+    _width = static_cast<size_t>(width);
+    _height = static_cast<size_t>(height);
+    if (_messageOverlay) {
+        _messageOverlay->setWindowSize(_width, _height);
+    }
+#ifdef HAVE_PROJECTM_RENDER_FBO
+    // Keep drawing at the old size offscreen and stretch it over the window meanwhile
+    if (!_renderScaled) {
+        if (!_renderScaler) {
+            _renderScaler = RenderScaler::create();
+        }
+        _renderScaled = _renderScaler && _renderScaler->setSize(static_cast<int>(_renderWidth),
+                                                                static_cast<int>(_renderHeight));
+    }
+#endif
+}
+
+void AutoVibezApp::updatePendingResize() {
+    int width = 0;
+    int height = 0;
+    if (_resizeCoalescer.poll(std::chrono::steady_clock::now(), width, height)) {
+        resizeWindow(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+    }
+}
+
 void AutoVibezApp::pollEvents() {
+    updateAudioReconnect();
+    updateCaptureBuffer();
+
     SDL_Event evt;
-    while (SDL_PollEvent(&evt)) {
+    while (nextEvent(evt)) {
         // Pass events to ImGui when help overlay is visible and ImGui is ready
         if (_helpOverlay && _helpOverlay->isVisible() && _helpOverlay->isImGuiReady()) {
             ImGui_ImplSDL2_ProcessEvent(&evt);
@@ -190,6 +273,10 @@ void AutoVibezApp::pollEvents() {
             if (evt.type == SDL_MOUSEWHEEL) {
                 continue;
             }
+            // Typing into the search box is not a key binding
+            if ((evt.type == SDL_KEYDOWN || evt.type == SDL_KEYUP) && _helpOverlay->isTextInputActive()) {
+                continue;
+            }
         }
 
         switch (evt.type) {
@@ -211,13 +298,56 @@ void AutoVibezApp::pollEvents() {
             case SDL_QUIT:
                 handleQuitEvent();
                 break;
+            case SDL_AUDIODEVICEADDED:
+            case SDL_AUDIODEVICEREMOVED:
+                handleAudioDeviceEvent(evt);
+                break;
             default:
                 break;
         }
     }
+    if (_keyBindingManager) {
+        _keyBindingManager->flushCoalescedActions();
+    }
+    updatePendingResize();
+}
+
+bool AutoVibezApp::nextEvent(SDL_Event& event) {
+    return _eventForwarder.isInstalled() ? _eventForwarder.poll(event) : SDL_PollEvent(&event) != 0;
+}
+
+bool AutoVibezApp::usesRenderThread() const {
+#ifdef __APPLE__
+    return false;  // Cocoa only takes window calls on the main thread
+#else
+    return _renderThreadEnabled;
+#endif
+}
+
+void AutoVibezApp::beginRenderThread() {
+    _eventForwarder.install();
+    detachContext();
+}
+
+void AutoVibezApp::endRenderThread() {
+    _eventForwarder.uninstall();
+    attachContext();
+}
+
+void AutoVibezApp::attachContext() {
+    SDL_GL_MakeCurrent(_sdlWindow, _openGlContext);
+}
+
+void AutoVibezApp::detachContext() {
+    SDL_GL_MakeCurrent(_sdlWindow, nullptr);
 }
 
 void AutoVibezApp::handleWindowEvent(const SDL_Event& evt) {
+    // Secondary outputs report their own windows, which say nothing about the main one
+    if (evt.window.windowID == SDL_GetWindowID(_sdlWindow) && _powerPolicy.onWindowEvent(evt.window.event)) {
+        onPowerStateChanged();
+    }
+
     int w, h;
     SDL_GL_GetDrawableSize(_sdlWindow, &w, &h);
     switch (evt.window.event) {
@@ -225,7 +355,19 @@ void AutoVibezApp::handleWindowEvent(const SDL_Event& evt) {
         case SDL_WINDOWEVENT_SIZE_CHANGED:
             // Ensure positive values before casting to unsigned
             if (w > 0 && h > 0) {
-                resizeWindow(static_cast<unsigned int>(w), static_cast<unsigned int>(h));
+                queueResize(w, h);
+            }
+            break;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        case SDL_WINDOWEVENT_DISPLAY_CHANGED:
+            // A monitor with another refresh rate needs a new frame interval
+            applyFramePacing();
+            break;
+#endif
+        case SDL_WINDOWEVENT_CLOSE:
+            // With several windows SDL only quits when the last one closes
+            if (_multiOutput) {
+                handleQuitEvent();
             }
             break;
         default:
@@ -234,11 +376,7 @@ void AutoVibezApp::handleWindowEvent(const SDL_Event& evt) {
 }
 
 void AutoVibezApp::handleKeyDownEvent(const SDL_Event& evt) {
-    // Ensure mix manager is initialized before handling any keys
-    if (!_mixManagerInitialized) {
-        initMixManager();
-    }
-
+    // Mix commands posted before the control thread finishes loading run after it, in order
     // Try KeyBindingManager first - this should handle ALL keys
     if (_keyBindingManager && _keyBindingManager->handleKey(const_cast<SDL_Event*>(&evt))) {
         return;  // Key was handled successfully
@@ -275,22 +413,478 @@ void AutoVibezApp::handleQuitEvent() {
     done = true;
 }
 
+void AutoVibezApp::onPowerStateChanged() {
+    if (_powerPolicy.getState() == PowerState::Full) {
+        // Restarts the pacer, so the idle gap is not counted as missed frames
+        applyFramePacing();
+    } else {
+        // A hidden window's swap can block until it is shown again
+        SDL_GL_SetSwapInterval(0);
+    }
+}
+
+void AutoVibezApp::paceFrame() {
+    if (_powerPolicy.getState() == PowerState::Full) {
+        _framePacer.endFrame();
+        return;
+    }
+    // Pumping belongs to the main thread when it forwards events
+    if (_eventForwarder.isInstalled()) {
+        _eventForwarder.wait(_powerPolicy.getIdleIntervalMs());
+    } else {
+        SDL_WaitEventTimeout(nullptr, _powerPolicy.getIdleIntervalMs());
+    }
+}
+
 void AutoVibezApp::renderFrame() {
+    if (_powerPolicy.getState() == PowerState::Paused) {
+        // Nothing is drawn, but the audio analysis and beat clock keep up for when the window returns
+        FrameProfiler::Scope phase(_frameProfiler, FramePhase::PcmDrain);
+        drainPcmToProjectM();
+        updateNodeSync();
+        updatePresetScheduling();
+        updateBeatSync();
+        return;
+    }
+
+    const auto frameStart = std::chrono::steady_clock::now();
     glClearColor(0.0, 0.0, 0.0, 0.0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    projectm_opengl_render_frame(_projectM);
+    {
+        FrameProfiler::Scope phase(_frameProfiler, FramePhase::PcmDrain);
+        drainPcmToProjectM();
+        updateNodeSync();
+        updatePresetScheduling();
+        updateBeatSync();
+    }
+    {
+        FrameProfiler::Scope phase(_frameProfiler, FramePhase::Render);
+#ifdef HAVE_PROJECTM_RENDER_FBO
+        if (_renderScaled) {
+            _renderScaler->bind();
+            projectm_opengl_render_frame_fbo(_projectM, _renderScaler->getFramebuffer());
+        } else {
+            projectm_opengl_render_frame(_projectM);
+        }
+#else
+        projectm_opengl_render_frame(_projectM);
+#endif
+        if (_latencyCalibration) {
+            renderCalibrationFlash();
+        }
+        // Overlays are drawn after the upscale, at native resolution
+        if (_renderScaled && _multiOutput) {
+            _multiOutput->blitMain(*_renderScaler, static_cast<int>(_width), static_cast<int>(_height));
+        } else if (_renderScaled) {
+            _renderScaler->blitToBackbuffer(static_cast<int>(_width), static_cast<int>(_height));
+        }
+    }
+    // Screenshots are taken at native resolution, before the overlays
+    _frameCapture.onFrame(static_cast<int>(_width), static_cast<int>(_height));
+    {
+        FrameProfiler::Scope phase(_frameProfiler, FramePhase::Overlays);
+        renderOverlays();
+    }
 
-    // Render overlays
-    renderHelpOverlay();
-    renderMessageOverlay();
+    const auto swapStart = std::chrono::steady_clock::now();
+    {
+        FrameProfiler::Scope phase(_frameProfiler, FramePhase::Swap);
+        // The other outputs swap without vsync, so the main window's swap still paces the frame
+        if (_renderScaled && _multiOutput) {
+            _multiOutput->presentSecondary(*_renderScaler);
+        }
+        SDL_GL_SwapWindow(_sdlWindow);
+    }
+    updateLatencyModel(frameStart, swapStart);
+    if (!_firstFrameShown) {
+        reportFirstFrame();
+    }
+}
+
+void AutoVibezApp::applyFramePacing() {
+    double refreshHz = 0.0;
+    SDL_DisplayMode displayMode;
+    const int displayIndex = _sdlWindow ? SDL_GetWindowDisplayIndex(_sdlWindow) : 0;
+    if (SDL_GetCurrentDisplayMode(displayIndex < 0 ? 0 : displayIndex, &displayMode) == 0) {
+        refreshHz = displayMode.refresh_rate;
+    }
+
+    // Only one thing may pace the loop: either the swap blocks on vsync or the pacer sleeps, never both
+    FramePacingMode mode = _framePacingMode;
+    if (SDL_GL_SetSwapInterval(mode == FramePacingMode::Vsync ? 1 : 0) != 0 && mode == FramePacingMode::Vsync) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logWarning("Vsync unavailable (" + std::string(SDL_GetError()) + "), pacing to the refresh rate");
+        SDL_GL_SetSwapInterval(0);
+        mode = FramePacingMode::Fixed;
+    }
+    _framePacer.configure(mode, mode == FramePacingMode::Fixed ? _framePacingFps : 0.0, refreshHz);
+
+    // projectM's time-based effects assume the rate frames are actually delivered at
+    if (_framePacer.getTargetFps() > 0.0) {
+        projectm_set_fps(_projectM, static_cast<int32_t>(std::lround(_framePacer.getTargetFps())));
+    }
+}
+
+std::string AutoVibezApp::getFrameStatsText() const {
+    const FrameTimingStats stats = _framePacer.getStats();
+    char text[160];
+    std::snprintf(text, sizeof(text), "%s %.0f fps, %.2f ms avg, jitter %.2f ms, worst %.1f ms, %llu missed",
+                  FramePacer::modeName(_framePacer.getMode()), _framePacer.getTargetFps(), stats.mean_frame_ms,
+                  stats.jitter_ms, stats.worst_ms, static_cast<unsigned long long>(stats.missed));
+    std::string result = text;
+    if (_renderScaled) {
+        char scaled[48];
+        std::snprintf(scaled, sizeof(scaled), ", rendering %zux%zu", _renderWidth, _renderHeight);
+        result += scaled;
+    }
+    if (_qualityGoverned) {
+        result += ", mesh " + std::to_string(_appliedQuality.mesh_x) + "x" + std::to_string(_appliedQuality.mesh_y);
+    }
+    return result;
+}
+
+void AutoVibezApp::togglePerformanceHud() {
+    if (_performanceHud) {
+        _performanceHud->toggle();
+    }
+}
+
+bool AutoVibezApp::dumpFrameProfile() {
+    char stamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    const std::string path = getConfigDirectory() + "/frame_profile_" + stamp + ".csv";
+
+    if (!_frameProfiler.writeCsv(path)) {
+        AutoVibez::Utils::ConsoleOutput::error(_frameProfiler.getLastError());
+        return false;
+    }
+    AutoVibez::Utils::ConsoleOutput::info("Frame profile written to " + path);
+    return true;
+}
+
+#ifdef AUTOVIBEZ_TRACING
+bool AutoVibezApp::dumpTrace() {
+    char stamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    const std::string path = getConfigDirectory() + "/trace_" + stamp + ".json";
+
+    AutoVibez::Utils::TraceRecorder& recorder = AutoVibez::Utils::TraceRecorder::instance();
+    if (!recorder.writeJson(path)) {
+        AutoVibez::Utils::ConsoleOutput::error(recorder.getLastError());
+        return false;
+    }
+    std::string message = "Trace written to " + path;
+    if (recorder.getDroppedCount() > 0) {
+        message += " (" + std::to_string(recorder.getDroppedCount()) + " events dropped)";
+    }
+    AutoVibez::Utils::ConsoleOutput::info(message);
+    return true;
+}
+#endif
+
+bool AutoVibezApp::dumpQueryStats() {
+    if (!_queryStats) {
+        return false;
+    }
+    char stamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    const std::string path = getConfigDirectory() + "/query_stats_" + stamp + ".csv";
+
+    if (!_queryStats->writeCsv(path)) {
+        AutoVibez::Utils::ConsoleOutput::error(_queryStats->getLastError());
+        return false;
+    }
+    AutoVibez::Utils::ConsoleOutput::info("Query stats written to " + path);
+    return true;
+}
+
+bool AutoVibezApp::dumpDownloadStats() {
+    if (!_mixManager) {
+        return false;
+    }
+    char stamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    const std::string path = getConfigDirectory() + "/download_stats_" + stamp + ".csv";
+
+    AutoVibez::Data::DownloadTelemetry& telemetry = _mixManager->getDownloadTelemetry();
+    if (!telemetry.writeCsv(path)) {
+        AutoVibez::Utils::ConsoleOutput::error(telemetry.getLastError());
+        return false;
+    }
+    AutoVibez::Utils::ConsoleOutput::info("Download stats written to " + path);
+    return true;
+}
+
+void AutoVibezApp::showDownloadStatus() {
+    if (!_mixManagerInitialized) {
+        return;
+    }
+    const std::string summary = AutoVibez::Data::DownloadTelemetry::formatSummary(_mixManager->getDownloadStats());
+    postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("download_status", summary));
+}
+
+void AutoVibezApp::requestScreenshot(const std::string& path) {
+    _frameCapture.request(path);
+}
+
+void AutoVibezApp::setScreenshotFormat(ImageFormat format, int quality) {
+    _frameCapture.setFormat(format, quality);
+}
+
+void AutoVibezApp::setMetricsExport(const std::string& statsdAddress, const std::string& textfilePath) {
+    if (statsdAddress.empty() && textfilePath.empty()) {
+        return;
+    }
+    if (!_metricsExporter.start(statsdAddress, textfilePath)) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logWarning("Metrics export disabled: " + _metricsExporter.getLastError());
+    }
+}
+
+void AutoVibezApp::setRemoteControl(int port, const std::string& token) {
+    if (port <= 0 || port > 65535) {
+        return;
+    }
+    // Actions run on the render thread like key presses, so held volume and seek commands coalesce per frame
+    const bool started = _remoteControl.start(static_cast<uint16_t>(port), token, [this](KeyAction action) {
+        return _mixControl.postEvent([this, action]() { _keyBindingManager->triggerAction(action); });
+    });
+    ::AutoVibez::Utils::Logger logger;
+    if (!started) {
+        logger.logWarning("Remote control disabled: " + _remoteControl.getLastError());
+    } else if (token.empty()) {
+        logger.logWarning("Remote control on port " + std::to_string(port) + " accepts anyone on the network");
+    }
+}
+
+void AutoVibezApp::setTextureCache(bool enabled) {
+#ifdef USE_GLES
+    enabled = false;  // BC formats are a desktop extension; GLES drivers rarely take them
+#endif
+    if (!enabled || _texturePath.empty()) {
+        return;
+    }
+    // Switching the search path reloads every texture, so the cache only takes over at startup
+    if (_textureCache.open(_texturePath, PathManager::getTextureCacheDirectory(),
+                           PathManager::getTextureCacheIndexPath())) {
+        const char* texturePaths[] = {_textureCache.getSearchPath().c_str()};
+        projectm_set_texture_search_paths(_projectM, texturePaths, 1);
+    }
+    if (_presetManager) {
+        _presetManager->setPreloadCallback([this](const std::string& contents) { _textureCache.prefetch(contents); });
+    }
+
+    if (_textureCache.getPendingCount() > 0) {
+        const int cores = static_cast<int>(std::thread::hardware_concurrency());
+        const int workers = std::clamp(cores / 2, 1, Constants::TEXTURE_CACHE_MAX_WORKERS);
+        _textureCache.start(static_cast<size_t>(workers), [this](size_t transcoded, size_t failed) {
+            _mixControl.postEvent([transcoded, failed]() {
+                AutoVibez::Utils::ConsoleOutput::info("Texture cache: " + std::to_string(transcoded) +
+                                                      " textures transcoded, used from the next start");
+                if (failed > 0) {
+                    AutoVibez::Utils::ConsoleOutput::warning("Texture cache: " + std::to_string(failed) +
+                                                             " textures could not be transcoded");
+                }
+            });
+        });
+    }
+}
+
+void AutoVibezApp::initFrameCapture() {
+    _frameCapture.setDirectory(getConfigDirectory() + "/screenshots");
+    // Results arrive on the encoding worker; report them from the render thread
+    _frameCapture.setResultCallback([this](bool ok, const std::string& message) {
+        _mixControl.postEvent([this, ok, message]() {
+            if (ok) {
+                AutoVibez::Utils::ConsoleOutput::info("Screenshot saved to " + message);
+            } else {
+                AutoVibez::Utils::ConsoleOutput::error("Screenshot failed: " + message);
+            }
+            if (_messageOverlay) {
+                _messageOverlay->showMessage(ok ? "Screenshot saved" : "Screenshot failed");
+            }
+        });
+    });
+}
+
+void AutoVibezApp::renderCalibrationFlash() {
+    const bool flash = std::chrono::steady_clock::now() < _calibrationFlashUntil;
+    const float level = flash ? 1.0f : 0.0f;
+    glClearColor(level, level, level, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void AutoVibezApp::drainPcmToProjectM() {
+    size_t count = _pcmRingBuffer.read(_pcmDrainBuffer.data(), _pcmDrainBuffer.size());
+    _latency.noteRingBacklog(_pcmRingBuffer.available());
+    if (_latencyCalibration &&
+        _calibrationClicks.process(_pcmDrainBuffer.data(), count, _beatTracker.getSampleRate())) {
+        _calibrationFlashUntil =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(Constants::CALIBRATION_FLASH_MS);
+    }
+    if (count >= 2) {
+        _audioFeatures.process(_pcmDrainBuffer.data(), static_cast<int>(count / 2), _beatTracker.getSampleRate());
+        projectm_pcm_add_float(_projectM, _pcmDrainBuffer.data(), static_cast<unsigned int>(count / 2),
+                               PROJECTM_STEREO);
+    } else if (_audioReconnecting.load(std::memory_order_acquire)) {
+        // No device while it reopens: feed a frame's worth of silence so the visuals settle instead of freezing
+        const int fps = std::max(1, static_cast<int>(projectm_get_fps(_projectM)));
+        const size_t frames = std::min(static_cast<size_t>(Constants::DEFAULT_SAMPLE_RATE / fps),
+                                       _pcmDrainBuffer.size() / 2);
+        std::fill_n(_pcmDrainBuffer.begin(), frames * 2, 0.0f);
+        projectm_pcm_add_float(_projectM, _pcmDrainBuffer.data(), static_cast<unsigned int>(frames), PROJECTM_STEREO);
+    }
+}
+
+void AutoVibezApp::setBeatSyncedPresets(bool enabled, int bars, double fallbackSeconds) {
+    _beatSyncedPresets = enabled;
+    _presetCutBars = std::max(1, bars);
+    _presetFallbackSeconds = std::max(1.0, fallbackSeconds);
+    _barsSincePresetCut = 0;
+    _lastPresetCut = std::chrono::steady_clock::now();
+
+    if (enabled || _nodeSync) {
+        // The app decides when presets change; projectM's own timer and beat-triggered cuts stay out of the way
+        projectm_set_hard_cut_enabled(_projectM, false);
+        projectm_set_preset_duration(_projectM, Constants::BEAT_SYNC_PROJECTM_PRESET_DURATION);
+    }
+}
 
-    SDL_GL_SwapWindow(_sdlWindow);
+void AutoVibezApp::applyPresetTiming(const AppConfig& config) {
+    projectm_set_soft_cut_duration(_projectM, config.soft_cut_duration);
+    projectm_set_preset_duration(_projectM, config.preset_duration);
+    projectm_set_hard_cut_enabled(_projectM, config.hard_cuts_enabled);
+    projectm_set_hard_cut_duration(_projectM, config.hard_cut_duration);
+    projectm_set_hard_cut_sensitivity(_projectM, config.hard_cut_sensitivity);
+    projectm_set_beat_sensitivity(_projectM, config.beat_sensitivity);
+    // Last, as beat sync takes preset timing back from projectM
+    setBeatSyncedPresets(config.beat_synced_presets, config.preset_cut_bars, config.preset_duration);
+}
+
+void AutoVibezApp::updateBeatSync() {
+    // With sync on projectM's timer is off, so a node times its own cuts unless it follows a leader
+    if ((!_beatSyncedPresets && !_nodeSync) || _syncFollowing || !_presetManager ||
+        projectm_get_preset_locked(_projectM)) {
+        return;
+    }
+
+    // Predict from where the listener is, not where the (possibly lagging) renderer is
+    const int64_t lead = _latencyCompensation ? _latency.getResidualLeadFrames(_beatTracker.getSampleRate()) : 0;
+    AutoVibez::Audio::BeatState beat = _beatTracker.getState(lead);
+    bool cut = false;
+    if (beat.locked && _beatSyncedPresets) {
+        if (beat.beat_count != _lastBeatCount) {
+            _lastBeatCount = beat.beat_count;
+            if (beat.beat_in_bar == 0 && ++_barsSincePresetCut >= _presetCutBars) {
+                cut = true;
+            }
+        }
+    } else {
+        // No tempo to follow (silence, ambient passages): fall back to the configured preset duration
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _lastPresetCut;
+        cut = elapsed.count() >= _presetFallbackSeconds;
+    }
+
+    if (cut) {
+        cutPreset();
+    }
+}
+
+void AutoVibezApp::cutPreset() {
+    if (!_presetManager) {
+        return;
+    }
+    if (!_nodeSync || _nodeSync->getRole() != SyncRole::Leader) {
+        _presetManager->randomPreset();
+        return;
+    }
+    if (_syncCutPending) {
+        return;  // One is already on its way
+    }
+    const uint32_t index = _presetManager->peekUpcoming();
+    if (index == UINT32_MAX) {
+        return;
+    }
+    // Followers have it a few state packets ahead, so every screen makes it on the same frame
+    ++_syncVisuals.cut_count;
+    _syncVisuals.preset_index = index;
+    _syncVisuals.preset_seed = _syncRandom();
+    _syncVisuals.cut_time_ns = NodeSync::nowNs() + int64_t{Constants::SYNC_CUT_LEAD_MS} * 1000000;
+    _syncCutPending = true;
+}
+
+void AutoVibezApp::updateNodeSync() {
+    if (!_nodeSync || !_presetManager) {
+        return;
+    }
+    const int64_t now = NodeSync::nowNs();
+
+    if (_nodeSync->getRole() == SyncRole::Leader) {
+        if (_syncCutPending && now >= _syncVisuals.cut_time_ns) {
+            _syncCutPending = false;
+            _presetManager->playPreset(_syncVisuals.preset_index, _syncVisuals.preset_seed);
+        } else if (!_syncCutPending && _presetsAdopted) {
+            // A switch made here by hand takes the followers along straight away
+            const uint32_t position = projectm_playlist_get_position(_playlist);
+            if (position != _syncVisuals.preset_index) {
+                ++_syncVisuals.cut_count;
+                _syncVisuals.preset_index = position;
+                _syncVisuals.preset_seed = _syncRandom();
+                _syncVisuals.cut_time_ns = now;
+            }
+        }
+        const AutoVibez::Audio::BeatState beat = _beatTracker.getState();
+        _syncVisuals.time_ns = now;
+        _syncVisuals.beat_locked = beat.locked;
+        _syncVisuals.bpm = static_cast<float>(beat.bpm);
+        _syncVisuals.beat_phase = static_cast<float>(beat.phase);
+        _syncVisuals.beat_in_bar = static_cast<uint8_t>(beat.beat_in_bar);
+        _syncVisuals.beat_count = static_cast<uint32_t>(beat.beat_count);
+        _nodeSync->publishVisuals(_syncVisuals);
+        return;
+    }
+
+    SyncVisuals leader;
+    SyncMix mix;
+    // Without a leader this node cuts on its own again
+    _syncFollowing = _nodeSync->getLeaderState(leader, mix);
+    if (_syncFollowing && _presetsAdopted && leader.cut_count != _syncAppliedCut && now >= leader.cut_time_ns) {
+        // The first frame at or past the leader's cut; one that happened before this node joined is made at once
+        _syncAppliedCut = leader.cut_count;
+        _manualPresetChange = false;
+        _presetManager->playPreset(leader.preset_index, leader.preset_seed);
+    }
+}
+
+void AutoVibezApp::setNodeSync(const std::string& roleName) {
+    ::AutoVibez::Utils::Logger logger;
+    SyncRole role = SyncRole::Off;
+    if (!NodeSync::parseRole(roleName, role)) {
+        logger.logWarning("Unknown sync_role '" + roleName + "', multi-node sync stays off");
+        return;
+    }
+    if (role == SyncRole::Off || _nodeSync) {
+        return;
+    }
+    auto sync = std::make_unique<NodeSync>(role);
+    if (!sync->start()) {
+        logger.logWarning("Multi-node sync disabled: " + sync->getLastError());
+        return;
+    }
+    _nodeSync = std::move(sync);
+    projectm_set_hard_cut_enabled(_projectM, false);
+    projectm_set_preset_duration(_projectM, Constants::BEAT_SYNC_PROJECTM_PRESET_DURATION);
 }
 
 void AutoVibezApp::initialize(SDL_Window* window) {
     _sdlWindow = window;
-    projectm_set_window_size(_projectM, _width, _height);
+    applyRenderSize();
+    applyFramePacing();
 
 #ifdef WASAPI_LOOPBACK
     wasapi = true;
@@ -302,20 +896,437 @@ void AutoVibezApp::initialize(SDL_Window* window) {
     // Initialize message overlay
     initMessageOverlay();
 
-    // Initialize key binding manager actions
-    initKeyBindingManager();
+    // Phase timings (GPU ones need the context) and the HUD that shows them
+    _frameProfiler.setGpuTimer(GlTimerQueries::create(2 * FRAME_PHASE_COUNT));
+    initPerformanceHud();
+    initPresetCostProfiling();
+    initMultiOutput();
+    initRenderScaling();
+    initQualityGovernor();
+    initFrameCapture();
+
+    // Initialize key binding manager actions
+    initKeyBindingManager();
+
+    // Start progressive loading in background after UI is ready
+    startProgressiveLoading();
+}
+
+void AutoVibezApp::initHelpOverlay() {
+    if (!_helpOverlay) {
+        _helpOverlay = std::make_unique<HelpOverlay>();
+        if (_helpOverlay) {
+            _helpOverlay->init(_sdlWindow, _openGlContext);
+            _helpOverlay->setSearchHandler([this](const std::string& query) { requestMixSearch(query); });
+        }
+    }
+}
+
+void AutoVibezApp::initPerformanceHud() {
+    if (!_performanceHud) {
+        _performanceHud = std::make_unique<AutoVibez::UI::PerformanceHud>(_frameProfiler);
+        _performanceHud->setAudioFeatures(&_audioFeatures);
+        _performanceHud->init(_sdlWindow, _openGlContext);
+        _performanceHud->setVisible(_showPerformanceHud);
+    }
+}
+
+void AutoVibezApp::setPresetCostProfiling(bool profile, bool skipSlow) {
+    _profilePresetCost = profile;
+    _skipSlowPresets = skipSlow;
+}
+
+double AutoVibezApp::getFrameBudgetMs() const {
+    const double fps = _framePacer.getTargetFps();
+    return 1000.0 / (fps > 0.0 ? fps : Constants::DEFAULT_FPS_VALUE);
+}
+
+void AutoVibezApp::setRenderScale(double scale, bool dynamic, double minScale) {
+    _renderScale = std::clamp(scale, Constants::RENDER_SCALE_QUANTUM, 1.0);
+    _dynamicRenderScale = dynamic;
+    _resolutionGovernor.setLimits(minScale, _renderScale);
+}
+
+void AutoVibezApp::setQualityGovernor(const QualityBounds& bounds, double meshAspect, const std::string& profile) {
+    _qualityGoverned = true;
+    _qualityBounds = bounds;
+    _qualityMeshAspect = meshAspect;
+    _qualityProfile = profile;
+}
+
+void AutoVibezApp::setMultiOutput(const std::string& displays, int bezel, int contentWidth) {
+    _multiOutputDisplays = displays == "off" ? "" : displays;
+    _multiOutputBezel = std::max(0, bezel);
+    _multiOutputWidth = std::max(0, contentWidth);
+}
+
+void AutoVibezApp::initMultiOutput() {
+    if (_multiOutputDisplays.empty()) {
+        return;
+    }
+    std::vector<int> displays;
+    std::string error;
+    if (!MultiOutput::parseDisplays(_multiOutputDisplays, SDL_GetNumVideoDisplays(), displays, error)) {
+        AutoVibez::Utils::ConsoleOutput::warning("multi_output ignored: " + error);
+        return;
+    }
+#ifdef HAVE_PROJECTM_RENDER_FBO
+    _renderScaler = RenderScaler::create();
+#endif
+    if (!_renderScaler) {
+        AutoVibez::Utils::ConsoleOutput::warning(
+            "Multi-output needs projectM 4.1 and framebuffer blits; stretching one window over the displays");
+        stretchMonitors();
+        return;
+    }
+    _multiOutput = MultiOutput::open(_sdlWindow, _openGlContext, displays, _multiOutputBezel, _multiOutputWidth,
+                                     error);
+    if (!_multiOutput) {
+        AutoVibez::Utils::ConsoleOutput::warning("Multi-output failed: " + error);
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    SDL_GL_GetDrawableSize(_sdlWindow, &width, &height);
+    if (width > 0 && height > 0) {
+        resizeWindow(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+    }
+    AutoVibez::Utils::ConsoleOutput::info("Multi-output: " + std::to_string(_multiOutput->getOutputCount()) +
+                                          " displays from one " + std::to_string(_multiOutput->getContentWidth()) +
+                                          "x" + std::to_string(_multiOutput->getContentHeight()) + " frame");
+}
+
+void AutoVibezApp::initRenderScaling() {
+    const bool governedScale = _qualityGoverned && _qualityBounds.min_render_scale < 1.0;
+    if (!_multiOutput && _renderScale >= 1.0 && !_dynamicRenderScale && !governedScale) {
+        return;
+    }
+#ifdef HAVE_PROJECTM_RENDER_FBO
+    if (!_renderScaler) {
+        _renderScaler = RenderScaler::create();
+    }
+#endif
+    if (!_renderScaler) {
+        AutoVibez::Utils::ConsoleOutput::warning(
+            "Render scaling needs projectM 4.1 and framebuffer blits; rendering at native resolution");
+        return;
+    }
+
+    if (_dynamicRenderScale && !_qualityGoverned) {
+        _resolutionGovernor.setBudgetMs(getFrameBudgetMs());
+        _frameProfiler.addFrameListener([this](const FrameRecord& record) {
+            // The blit is part of the render phase, so upscaling cost is budgeted too
+            const size_t render = static_cast<size_t>(FramePhase::Render);
+            if (_resolutionGovernor.addFrame(std::max(record.cpu_ms[render], record.gpu_ms[render]))) {
+                applyRenderSize();
+            }
+        });
+    }
+    applyRenderSize();
+}
+
+void AutoVibezApp::initQualityGovernor() {
+    if (!_qualityGoverned) {
+        return;
+    }
+
+    // Vsync and uncapped pacing take their rate from the display, so only fixed pacing lets the fps move
+    QualityBounds bounds = _qualityBounds;
+    const int fps = static_cast<int>(std::lround(_framePacer.getTargetFps()));
+    if (fps > 0) {
+        bounds.max_fps = fps;
+    }
+    if (_framePacer.getMode() != FramePacingMode::Fixed) {
+        bounds.min_fps = bounds.max_fps;
+    }
+    if (!_renderScaler) {
+        bounds.min_render_scale = 1.0;
+        bounds.max_render_scale = 1.0;
+    }
+    _qualityGovernor.setBounds(bounds, _qualityMeshAspect);
+    _appliedQuality = _qualityGovernor.getSettings();
+    projectm_set_mesh_size(_projectM, _appliedQuality.mesh_x, _appliedQuality.mesh_y);
+    applyRenderSize();
+
+    const QualityBounds& applied = _qualityGovernor.getBounds();
+    char range[160];
+    std::snprintf(range, sizeof(range), "Quality governor (%s): mesh %d-%d, %d-%d fps, render scale %.2f-%.2f",
+                  _qualityProfile.c_str(), applied.min_mesh_x, applied.max_mesh_x, applied.min_fps, applied.max_fps,
+                  applied.min_render_scale, applied.max_render_scale);
+    AutoVibez::Utils::ConsoleOutput::info(range);
+
+    _frameProfiler.addFrameListener([this](const FrameRecord& record) {
+        // The swap blocks on the display under vsync, so it is not work the settings can shed
+        const size_t swap = static_cast<size_t>(FramePhase::Swap);
+        const size_t render = static_cast<size_t>(FramePhase::Render);
+        const size_t overlays = static_cast<size_t>(FramePhase::Overlays);
+        const double cpuMs = record.total_ms - std::max(0.0, record.cpu_ms[swap]);
+        const double gpuMs = std::max(0.0, record.gpu_ms[render]) + std::max(0.0, record.gpu_ms[overlays]);
+        if (_qualityGovernor.addFrame(cpuMs, gpuMs)) {
+            const std::string decision = "Quality governor: " + _qualityGovernor.getLastDecision();
+            AutoVibez::Utils::ConsoleOutput::info(decision);
+            _mixControl.post([decision]() {
+                ::AutoVibez::Utils::Logger logger;
+                logger.logInfo(decision);
+            });
+            applyQualitySettings();
+        }
+    });
+}
+
+void AutoVibezApp::applyQualitySettings() {
+    const QualitySettings settings = _qualityGovernor.getSettings();
+    if (settings.mesh_x != _appliedQuality.mesh_x || settings.mesh_y != _appliedQuality.mesh_y) {
+        projectm_set_mesh_size(_projectM, settings.mesh_x, settings.mesh_y);
+    }
+    if (settings.fps != _appliedQuality.fps) {
+        _framePacingFps = settings.fps;
+        applyFramePacing();
+    }
+    if (settings.render_scale != _appliedQuality.render_scale) {
+        applyRenderSize();
+    }
+    _appliedQuality = settings;
+}
+
+double AutoVibezApp::getCurrentRenderScale() const {
+    if (_qualityGoverned) {
+        return _qualityGovernor.getSettings().render_scale;
+    }
+    return _dynamicRenderScale ? _resolutionGovernor.getScale() : _renderScale;
+}
+
+void AutoVibezApp::applyRenderSize() {
+    // Multi-output renders the content frame, which is always offscreen
+    const double scale = getCurrentRenderScale();
+    const double baseWidth = _multiOutput ? _multiOutput->getContentWidth() : static_cast<double>(_width);
+    const double baseHeight = _multiOutput ? _multiOutput->getContentHeight() : static_cast<double>(_height);
+    const int width = std::max(1, static_cast<int>(std::lround(baseWidth * scale)));
+    const int height = std::max(1, static_cast<int>(std::lround(baseHeight * scale)));
+
+    _renderScaled = _renderScaler && (scale < 1.0 || _multiOutput) && _renderScaler->setSize(width, height);
+    const size_t renderWidth = _renderScaled ? static_cast<size_t>(width) : _width;
+    const size_t renderHeight = _renderScaled ? static_cast<size_t>(height) : _height;
+    // Every call rebuilds projectM's targets, even for the size it already has
+    if (renderWidth != _renderWidth || renderHeight != _renderHeight) {
+        _renderWidth = renderWidth;
+        _renderHeight = renderHeight;
+        projectm_set_window_size(_projectM, _renderWidth, _renderHeight);
+    }
+}
+
+void AutoVibezApp::finishStartup() {
+    if (_startupFinished) {
+        return;
+    }
+    StartupGraph& graph = _startup->graph;
+    if (!_presetsAdopted && graph.isDone(AppStartup::PRESETS_TASK)) {
+        adoptPresets();
+    }
+    if (!_systemVolumeController && graph.isDone(AppStartup::VOLUME_TASK)) {
+        _systemVolumeController = std::move(_startup->volume_controller);
+    }
+    _startupFinished = _presetsAdopted && graph.isDone(AppStartup::VOLUME_TASK);
+    if (_startupFinished) {
+        // Build the ImGui context and font atlas between frames now, not on the frame that first shows a message
+        AutoVibez::UI::ImGuiManager::prewarm();
+    }
+}
+
+void AutoVibezApp::adoptPresets() {
+    _presetsAdopted = true;
+    const std::vector<std::string> paths = _presetManifest.getPaths();
+    std::vector<const char*> names;
+    names.reserve(paths.size());
+    for (const std::string& path : paths) {
+        names.push_back(path.c_str());
+    }
+    projectm_playlist_add_presets(_playlist, names.data(), static_cast<uint32_t>(names.size()), true);
+    _presetTable.rebuild(_playlist);
+    schedulePresets();
+    if (_presetManager) {
+        _presetManager->randomPreset();
+    }
+
+    // A first run just walked the tree, so the manifest already matches it
+    if (!_startup->presets_from_manifest) {
+        _presetManifestScanned.store(true);
+        return;
+    }
+    const std::string presetPath = _startup->preset_path;
+    _startup->graph.add(AppStartup::PRESET_RESCAN_TASK, {AppStartup::PRESETS_TASK}, [this, presetPath]() {
+        const AutoVibez::Data::PresetManifestChanges changes = _presetManifest.rescan(presetPath);
+        _presetManifestScanned.store(true);
+        if (changes.empty()) {
+            return;
+        }
+        _presetManifest.save(PathManager::getPresetManifestPath());
+        _mixControl.postEvent([this, changes]() { applyPresetChanges(changes); });
+    });
+}
+
+void AutoVibezApp::reportFirstFrame() {
+    _firstFrameShown = true;
+    AUTOVIBEZ_TRACE_INSTANT("startup", "first_frame", std::string());
+    const double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _startup->launched).count();
+    std::string tasks;
+    for (const StartupTaskTiming& timing : _startup->graph.getTimings()) {
+        tasks += (tasks.empty() ? "" : ", ") + timing.name + " " + std::to_string(std::lround(timing.duration_ms)) +
+                 (timing.ok ? " ms" : " ms (failed)");
+    }
+
+    ::AutoVibez::Utils::Logger logger;
+    const std::string summary = "First frame after " + std::to_string(std::lround(ms)) + " ms";
+    logger.logInfo(summary + "; startup tasks done by then: " + (tasks.empty() ? "none" : tasks));
+    if (ms > Constants::STARTUP_FIRST_FRAME_TARGET_MS) {
+        logger.logWarning(summary + ", over the " + std::to_string(Constants::STARTUP_FIRST_FRAME_TARGET_MS) +
+                          " ms target");
+    }
+    AutoVibez::Utils::ConsoleOutput::info(summary);
+}
+
+void AutoVibezApp::applyPresetChanges(const AutoVibez::Data::PresetManifestChanges& changes) {
+    if (!changes.added.empty()) {
+        std::vector<const char*> names;
+        for (const std::string& path : changes.added) {
+            names.push_back(path.c_str());
+        }
+        projectm_playlist_add_presets(_playlist, names.data(), static_cast<uint32_t>(names.size()), true);
+    }
+    if (!changes.removed.empty()) {
+        const std::unordered_set<std::string> removed(changes.removed.begin(), changes.removed.end());
+        // The table still matches the playlist up to the presets just appended, which are not removed
+        for (uint32_t index = static_cast<uint32_t>(_presetTable.size()); index-- > 0;) {
+            if (removed.count(_presetTable.getPath(index)) > 0) {
+                projectm_playlist_remove_preset(_playlist, index);
+            }
+        }
+        if (_presetManager) {
+            _presetManager->onPlaylistChanged();
+        }
+    }
+    _presetTable.rebuild(_playlist);
+    schedulePresets();
+    AutoVibez::Utils::ConsoleOutput::info("Preset library changed: " + std::to_string(changes.added.size()) +
+                                          " added, " + std::to_string(changes.removed.size()) + " removed");
+}
+
+void AutoVibezApp::initPresetCostProfiling() {
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    _glRenderer = renderer ? reinterpret_cast<const char*>(renderer) : "unknown";
+
+    if (_profilePresetCost) {
+        // Each frame is tagged with the preset path by presetSwitchedEvent
+        _frameProfiler.addFrameListener([this](const FrameRecord& record) {
+            const size_t render = static_cast<size_t>(FramePhase::Render);
+            _presetCostTracker.addFrame(_frameProfiler.getTagName(record.tag), record.cpu_ms[render],
+                                        record.gpu_ms[render]);
+        });
+        _presetCostTracker.setSink([this](const AutoVibez::Data::PresetCost& measured) {
+            AutoVibez::Data::PresetCost sample = measured;
+            sample.renderer = _glRenderer;
+            const double budgetMs = getFrameBudgetMs();
+            _mixControl.post([this, sample, budgetMs]() {
+                if (!openPresetCostDatabase() || !_presetCostDatabase->recordCost(sample)) {
+                    return;
+                }
+                const double costMs = _presetCostDatabase->getCost(sample.path, sample.renderer).getCostMs();
+                _presetManifest.setCost(sample.path, costMs);
+                const bool slow = _skipSlowPresets && costMs > budgetMs;
+                if (slow || _presetScheduling) {
+                    _mixControl.postEvent([this, path = sample.path, costMs, slow]() {
+                        if (_presetManager) {
+                            _presetManager->setPresetCost(path, costMs);
+                        }
+                        if (!slow) {
+                            return;
+                        }
+                        if (_presetManager) {
+                            _presetManager->addSlowPreset(path);
+                        }
+                        AutoVibez::Utils::ConsoleOutput::warning("Skipping slow preset (" +
+                                                                 std::to_string(static_cast<int>(costMs)) +
+                                                                 " ms per frame): " + path);
+                    });
+                }
+            });
+        });
+    }
+
+    if (_presetScheduling) {
+        _presetRenderBudgetMs = getFrameBudgetMs();
+        _frameProfiler.addFrameListener([this](const FrameRecord& record) {
+            // A preset gets what the other phases leave; the swap only waits on the display
+            const size_t swap = static_cast<size_t>(FramePhase::Swap);
+            const size_t render = static_cast<size_t>(FramePhase::Render);
+            const double otherMs =
+                record.total_ms - std::max(0.0, record.cpu_ms[swap]) - std::max(0.0, record.cpu_ms[render]);
+            const double budgetMs = getFrameBudgetMs() - std::max(0.0, otherMs);
+            _presetRenderBudgetMs += Constants::PRESET_RENDER_BUDGET_SMOOTHING * (budgetMs - _presetRenderBudgetMs);
+        });
+    }
+
+    if (_skipSlowPresets) {
+        _mixControl.post([this, renderer = _glRenderer, budgetMs = getFrameBudgetMs()]() {
+            if (!openPresetCostDatabase()) {
+                return;
+            }
+            std::unordered_set<std::string> slow;
+            for (const auto& cost : _presetCostDatabase->getCosts(renderer)) {
+                if (cost.getCostMs() > budgetMs) {
+                    slow.insert(cost.path);
+                }
+            }
+            if (!slow.empty()) {
+                _mixControl.postEvent([this, slow]() {
+                    if (_presetManager) {
+                        _presetManager->setSlowPresets(slow);
+                    }
+                    AutoVibez::Utils::ConsoleOutput::info("Skipping " + std::to_string(slow.size()) +
+                                                          " presets slower than the frame budget");
+                });
+            }
+        });
+    }
+}
+
+void AutoVibezApp::schedulePresets() {
+    if (!_presetScheduling || !_presetManager) {
+        return;
+    }
+    std::unordered_map<std::string, double> costs;
+    AutoVibez::Data::PresetManifestEntry entry;
+    for (const std::string& path : _presetTable.getPaths()) {
+        if (_presetManifest.find(path, entry) && entry.cost_ms >= 0.0) {
+            costs[path] = entry.cost_ms;
+        }
+    }
+    _presetManager->schedulePresets(_presetTable.getPaths(), costs, getFrameBudgetMs());
+}
 
-    // Start progressive loading in background after UI is ready
-    startProgressiveLoading();
+void AutoVibezApp::updatePresetScheduling() {
+    if (!_presetScheduling || !_presetManager) {
+        return;
+    }
+    const AutoVibez::Audio::BeatState beat = _beatTracker.getState();
+    _presetManager->updateConditions(beat.energy, beat.onset_rate, _presetRenderBudgetMs,
+                                     _audioFeatures.getFeatures().centroid_hz);
 }
 
-void AutoVibezApp::initHelpOverlay() {
-    if (!_helpOverlay) {
-        _helpOverlay = std::make_unique<HelpOverlay>();
-        if (_helpOverlay) {
-            _helpOverlay->init(_sdlWindow, _openGlContext);
-        }
+bool AutoVibezApp::openPresetCostDatabase() {
+    if (_presetCostDatabase) {
+        return true;
+    }
+    auto database = std::make_unique<AutoVibez::Data::PresetCostDatabase>(PathManager::getPresetCostDatabasePath());
+    if (!database->initialize()) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logWarning(database->getLastError());
+        return false;
     }
+    _presetCostDatabase = std::move(database);
+    return true;
 }
 
 void AutoVibezApp::initMessageOverlay() {
@@ -324,11 +1335,6 @@ void AutoVibezApp::initMessageOverlay() {
         if (_messageOverlay) {
             _messageOverlay->init(_sdlWindow, _openGlContext);
 
-            // Connect message overlay to mix manager
-            if (_mixManager) {
-                _mixManager->setMessageOverlay(_messageOverlay.get());
-            }
-
             // Connect help overlay to message overlay for coordination
             if (_helpOverlay) {
                 _helpOverlay->setMessageOverlay(_messageOverlay->getMessageOverlay());
@@ -342,8 +1348,13 @@ void AutoVibezApp::initKeyBindingManager() {
         return;
     }
 
-    // Register action callbacks for mix management
-    _keyBindingManager->registerAction(KeyAction::PREVIOUS_MIX, [this]() {
+    // Register action callbacks for mix management; they query SQLite and may download, so they run on the
+    // mix control thread
+    auto mixAction = [this](KeyAction action, std::function<void()> command) {
+        _keyBindingManager->registerAction(action, [this, command]() { _mixControl.post(command); });
+    };
+
+    mixAction(KeyAction::PREVIOUS_MIX, [this]() {
         if (!_mixManagerInitialized)
             return;
         Mix prevMix = _mixManager->getPreviousMix(_currentMix.id);
@@ -354,7 +1365,7 @@ void AutoVibezApp::initKeyBindingManager() {
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::NEXT_MIX, [this]() {
+    mixAction(KeyAction::NEXT_MIX, [this]() {
         if (!_mixManagerInitialized)
             return;
         Mix nextMix = _mixManager->getNextMix(_currentMix.id);
@@ -365,8 +1376,8 @@ void AutoVibezApp::initKeyBindingManager() {
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::TOGGLE_FAVORITE, [this]() {
-        if (!_currentMix.id.empty()) {
+    mixAction(KeyAction::TOGGLE_FAVORITE, [this]() {
+        if (_mixManagerInitialized && !_currentMix.id.empty()) {
             bool wasFavorite = _currentMix.is_favorite;
             _mixManager->toggleFavorite(_currentMix.id);
             _currentMix.is_favorite = !wasFavorite;  // Update local state
@@ -380,15 +1391,18 @@ void AutoVibezApp::initKeyBindingManager() {
     });
 
     _keyBindingManager->registerAction(KeyAction::SHOW_MIX_INFO, [this]() {
-        if (!_currentMix.id.empty() && _messageOverlay) {
-            auto config =
-                AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist, _currentMix.title);
+        const std::shared_ptr<const NowPlaying> nowPlaying = getNowPlaying();
+        const Mix& mix = nowPlaying->mix;
+        if (!mix.id.empty() && _messageOverlay) {
+            auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", mix.artist, mix.title);
             _messageOverlay->showMessage(config);
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::SOFT_DELETE_MIX, [this]() {
-        if (!_currentMix.id.empty()) {
+    mixAction(KeyAction::SHOW_DOWNLOAD_STATUS, [this]() { showDownloadStatus(); });
+
+    mixAction(KeyAction::SOFT_DELETE_MIX, [this]() {
+        if (_mixManagerInitialized && !_currentMix.id.empty()) {
             _mixManager->softDeleteMix(_currentMix.id);
             // Skip to next mix since current one is now deleted
             Mix nextMix = _mixManager->getNextMix(_currentMix.id);
@@ -405,7 +1419,7 @@ void AutoVibezApp::initKeyBindingManager() {
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::RANDOM_MIX_CURRENT_GENRE, [this]() {
+    mixAction(KeyAction::RANDOM_MIX_CURRENT_GENRE, [this]() {
         if (!_mixManagerInitialized)
             return;
         if (!_currentMix.id.empty() && !_currentMix.genre.empty()) {
@@ -415,21 +1429,17 @@ void AutoVibezApp::initKeyBindingManager() {
                 AutoVibez::Utils::ConsoleOutput::mixInfo(genreMix.artist, genreMix.title, genreMix.genre);
                 if (_mixManager->downloadAndPlayMix(genreMix)) {
                     _currentMix = genreMix;
-                    if (_messageOverlay) {
-                        auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist,
-                                                                                       _currentMix.title);
-                        _messageOverlay->showMessage(config);
-                    }
+                    postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist,
+                                                                                        _currentMix.title));
                 } else {
-                    if (_messageOverlay) {
-                        _messageOverlay->showMessage("Failed to load new mix");
-                    }
+                    postOverlayMessage(AutoVibez::Utils::OverlayMessages::createText(
+                        "Failed to load new mix", AutoVibez::Utils::OverlayPriority::Alert));
                 }
             }
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::RANDOM_GENRE_AND_MIX, [this]() {
+    mixAction(KeyAction::RANDOM_GENRE_AND_MIX, [this]() {
         if (!_mixManagerInitialized)
             return;
         std::string newGenre = _mixManager->getRandomGenre();
@@ -440,25 +1450,34 @@ void AutoVibezApp::initKeyBindingManager() {
             AutoVibez::Utils::ConsoleOutput::mixInfo(genreMix.artist, genreMix.title, genreMix.genre);
             if (_mixManager->downloadAndPlayMix(genreMix)) {
                 _currentMix = genreMix;
-                if (_messageOverlay) {
-                    auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist,
-                                                                                   _currentMix.title);
-                    _messageOverlay->showMessage(config);
-                }
+                postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist,
+                                                                                    _currentMix.title));
             } else {
-                if (_messageOverlay) {
-                    _messageOverlay->showMessage("Failed to load mix from " + newGenre + " genre");
-                }
+                postOverlayMessage(AutoVibez::Utils::OverlayMessages::createText(
+                    "Failed to load mix from " + newGenre + " genre", AutoVibez::Utils::OverlayPriority::Alert));
             }
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::PAUSE_RESUME_MIX, [this]() {
+    mixAction(KeyAction::PAUSE_RESUME_MIX, [this]() {
         if (_mixManagerInitialized) {
             _mixManager->togglePause();
         }
     });
 
+    // Seek, volume and beat sensitivity keys repeat when held; each frame applies their presses as one step
+    auto seekAction = [this](KeyAction action, int direction) {
+        _keyBindingManager->registerCoalescedAction(action, [this, direction](int count) {
+            _mixControl.post([this, direction, count]() {
+                if (_mixManagerInitialized) {
+                    _mixManager->seekBy(direction * _seekIncrement * count);
+                }
+            });
+        });
+    };
+    seekAction(KeyAction::SEEK_FORWARD, 1);
+    seekAction(KeyAction::SEEK_BACKWARD, -1);
+
     // Register action callbacks for visualizer controls
     _keyBindingManager->registerAction(KeyAction::TOGGLE_HELP_OVERLAY, [this]() {
         if (_helpOverlay) {
@@ -470,40 +1489,25 @@ void AutoVibezApp::initKeyBindingManager() {
 
     _keyBindingManager->registerAction(KeyAction::RANDOM_PRESET, [this]() {
         if (_presetManager) {
-            _presetManager->randomPreset();
-            std::string preset_name = getActivePresetName();
-            size_t last_slash = preset_name.find_last_of('/');
-            if (last_slash != std::string::npos) {
-                preset_name = preset_name.substr(last_slash + 1);
-            }
-            AutoVibez::Utils::ConsoleOutput::presetChange(preset_name);
+            cutPreset();
+            AutoVibez::Utils::ConsoleOutput::presetChange(getActivePresetDisplayName());
         }
     });
 
     _keyBindingManager->registerAction(KeyAction::PREVIOUS_PRESET_BRACKET, [this]() {
         _manualPresetChange = true;
         projectm_playlist_play_previous(_playlist, true);
-        std::string preset_name = getActivePresetName();
-        size_t last_slash = preset_name.find_last_of('/');
-        if (last_slash != std::string::npos) {
-            preset_name = preset_name.substr(last_slash + 1);
-        }
-        AutoVibez::Utils::ConsoleOutput::presetChange(preset_name);
+        AutoVibez::Utils::ConsoleOutput::presetChange(getActivePresetDisplayName());
     });
 
     _keyBindingManager->registerAction(KeyAction::NEXT_PRESET_BRACKET, [this]() {
         _manualPresetChange = true;
         projectm_playlist_play_next(_playlist, true);
-        std::string preset_name = getActivePresetName();
-        size_t last_slash = preset_name.find_last_of('/');
-        if (last_slash != std::string::npos) {
-            preset_name = preset_name.substr(last_slash + 1);
-        }
-        AutoVibez::Utils::ConsoleOutput::presetChange(preset_name);
+        AutoVibez::Utils::ConsoleOutput::presetChange(getActivePresetDisplayName());
     });
 
-    _keyBindingManager->registerAction(KeyAction::INCREASE_BEAT_SENSITIVITY, [this]() {
-        float newSensitivity = getBeatSensitivity() + 0.1f;
+    _keyBindingManager->registerCoalescedAction(KeyAction::INCREASE_BEAT_SENSITIVITY, [this](int count) {
+        float newSensitivity = getBeatSensitivity() + 0.1f * count;
         if (newSensitivity > 1.0f)
             newSensitivity = 1.0f;
         setBeatSensitivity(newSensitivity);
@@ -511,8 +1515,8 @@ void AutoVibezApp::initKeyBindingManager() {
             "Beat sensitivity: " + std::to_string(static_cast<int>(newSensitivity * 100)) + "%");
     });
 
-    _keyBindingManager->registerAction(KeyAction::DECREASE_BEAT_SENSITIVITY, [this]() {
-        float newSensitivity = getBeatSensitivity() - 0.1f;
+    _keyBindingManager->registerCoalescedAction(KeyAction::DECREASE_BEAT_SENSITIVITY, [this](int count) {
+        float newSensitivity = getBeatSensitivity() - 0.1f * count;
         if (newSensitivity < 0.0f)
             newSensitivity = 0.0f;
         setBeatSensitivity(newSensitivity);
@@ -524,7 +1528,7 @@ void AutoVibezApp::initKeyBindingManager() {
     _keyBindingManager->registerAction(KeyAction::QUIT_WITH_MODIFIER, [this]() { done = true; });
 
     // Register action callbacks for audio controls
-    _keyBindingManager->registerAction(KeyAction::TOGGLE_MUTE, [this]() {
+    mixAction(KeyAction::TOGGLE_MUTE, [this]() {
         if (!_mixManagerInitialized)
             return;
         int currentVolume = _mixManager->getVolume();
@@ -538,105 +1542,115 @@ void AutoVibezApp::initKeyBindingManager() {
         }
     });
 
-    _keyBindingManager->registerAction(KeyAction::VOLUME_UP, [this]() {
+    _keyBindingManager->registerCoalescedAction(KeyAction::VOLUME_UP, [this](int count) {
         if (_systemVolumeController && _systemVolumeController->isAvailable()) {
             int oldVolume = _systemVolumeController->getCurrentVolume();
-            _systemVolumeController->increaseVolume(Constants::VOLUME_STEP_SIZE);
+            _systemVolumeController->increaseVolume(Constants::VOLUME_STEP_SIZE * count);
             int newVolume = _systemVolumeController->getCurrentVolume();
             AutoVibez::Utils::ConsoleOutput::volumeChange(oldVolume, newVolume);
+            postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("volume_change", newVolume));
         }
         _volumeKeyPressed = true;
     });
 
-    _keyBindingManager->registerAction(KeyAction::VOLUME_DOWN, [this]() {
+    _keyBindingManager->registerCoalescedAction(KeyAction::VOLUME_DOWN, [this](int count) {
         if (_systemVolumeController && _systemVolumeController->isAvailable()) {
             int oldVolume = _systemVolumeController->getCurrentVolume();
-            _systemVolumeController->decreaseVolume(Constants::VOLUME_STEP_SIZE);
+            _systemVolumeController->decreaseVolume(Constants::VOLUME_STEP_SIZE * count);
             int newVolume = _systemVolumeController->getCurrentVolume();
             AutoVibez::Utils::ConsoleOutput::volumeChange(oldVolume, newVolume);
+            postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("volume_change", newVolume));
         }
         _volumeKeyPressed = true;
     });
 
     _keyBindingManager->registerAction(KeyAction::CYCLE_AUDIO_DEVICE, [this]() { cycleAudioDevice(); });
+
+    _keyBindingManager->registerAction(KeyAction::TOGGLE_LATENCY_CALIBRATION, [this]() { toggleLatencyCalibration(); });
+    _keyBindingManager->registerAction(KeyAction::INCREASE_AV_OFFSET,
+                                       [this]() { adjustAvOffset(Constants::AV_OFFSET_STEP_MS); });
+    _keyBindingManager->registerAction(KeyAction::DECREASE_AV_OFFSET,
+                                       [this]() { adjustAvOffset(-Constants::AV_OFFSET_STEP_MS); });
+    _keyBindingManager->registerAction(KeyAction::TOGGLE_PERFORMANCE_HUD, [this]() { togglePerformanceHud(); });
+    _keyBindingManager->registerAction(KeyAction::DUMP_FRAME_PROFILE, [this]() { dumpFrameProfile(); });
+#ifdef AUTOVIBEZ_TRACING
+    _keyBindingManager->registerAction(KeyAction::DUMP_TRACE, [this]() { dumpTrace(); });
+#endif
+    _keyBindingManager->registerAction(KeyAction::TAKE_SCREENSHOT, [this]() { requestScreenshot(); });
 }
 
-void AutoVibezApp::renderHelpOverlay() {
-    if (_helpOverlay) {
-        // Update help overlay with current information
+void AutoVibezApp::renderOverlays() {
+    // Only refresh the help text while someone can read it
+    if (_helpOverlay && _helpOverlay->isVisible()) {
         updateHelpOverlayInfo();
-        _helpOverlay->render();
     }
-}
-
-void AutoVibezApp::renderMessageOverlay() {
-    if (_messageOverlay) {
-        _messageOverlay->render();
+    if (_performanceHud && _performanceHud->isVisible()) {
+        const double fps = _framePacer.getTargetFps();
+        _performanceHud->setBudgetMs(fps > 0.0 ? 1000.0 / fps : 0.0);
     }
+    AutoVibez::UI::ImGuiManager::renderLayers();
 }
 
 void AutoVibezApp::updateHelpOverlayInfo() {
     if (!_helpOverlay)
         return;
 
-    // Update current preset
-    std::string currentPreset = getActivePresetName();
+    // The overlay only rebuilds its text for values that changed, so these are cheap when nothing did
+    const std::string& currentPreset = getActivePresetDisplayName();
     if (!currentPreset.empty()) {
-        // Extract just the filename for display
-        size_t last_slash = currentPreset.find_last_of('/');
-        if (last_slash != std::string::npos) {
-            currentPreset = currentPreset.substr(last_slash + 1);
-        }
         _helpOverlay->setCurrentPreset(currentPreset);
     }
+    _helpOverlay->setBeatSensitivity(getBeatSensitivity());
 
-    // Update current mix info
-    if (_mixManager && !_currentMix.id.empty()) {
-        _helpOverlay->setCurrentMix(_currentMix.artist, _currentMix.title, _currentMix.genre);
+    // Mix and queue change only with a new snapshot from the control thread
+    const std::shared_ptr<const NowPlaying> nowPlaying = getNowPlaying();
+    if (nowPlaying != _helpNowPlaying) {
+        _helpNowPlaying = nowPlaying;
+        if (!nowPlaying->mix.id.empty()) {
+            _helpOverlay->setCurrentMix(nowPlaying->mix.artist, nowPlaying->mix.title, nowPlaying->mix.genre);
+        }
+        _helpOverlay->setComingUp(nowPlaying->coming_up);
     }
 
-    // Update volume level
-    if (_systemVolumeController && _systemVolumeController->isAvailable()) {
-        int systemVolume = _systemVolumeController->getCurrentVolume();
-        if (systemVolume >= 0) {
-            _helpOverlay->setVolumeLevel(systemVolume);
+    // Volume, device and stats are polled and formatted, so a few times a second rather than every frame
+    Uint32 now = SDL_GetTicks();
+    if (now - _lastHelpStatsUpdate >= static_cast<Uint32>(Constants::HELP_OVERLAY_STATS_REFRESH_MS)) {
+        _lastHelpStatsUpdate = now;
+
+        if (_systemVolumeController && _systemVolumeController->isAvailable()) {
+            int systemVolume = _systemVolumeController->getCurrentVolume();
+            if (systemVolume >= 0) {
+                _helpOverlay->setVolumeLevel(systemVolume);
+            }
+        } else if (_mixManagerInitialized) {
+            // Fallback to mix volume if system volume not available
+            _helpOverlay->setVolumeLevel(nowPlaying->volume);
         }
-    } else if (_mixManager) {
-        // Fallback to mix volume if system volume not available
-        _helpOverlay->setVolumeLevel(_mixManager->getVolume());
-    }
 
-    // Update audio device
-    const char* deviceName = nullptr;
-    if (_selectedAudioDeviceIndex >= 0 && _selectedAudioDeviceIndex < _numAudioDevices) {
-        deviceName = SDL_GetAudioDeviceName(_selectedAudioDeviceIndex, SDL_TRUE);
-    }
-    if (deviceName) {
-        _helpOverlay->setAudioDevice(deviceName);
-    } else {
-        // Show default device indicator
-        _helpOverlay->setAudioDevice(StringConstants::DEFAULT_AUDIO_DEVICE);
+        // Update audio device
+        std::string deviceName = _audioDevices.getDeviceName(_selectedAudioDeviceIndex);
+        if (!deviceName.empty()) {
+            _helpOverlay->setAudioDevice(deviceName);
+        } else {
+            // Show default device indicator
+            _helpOverlay->setAudioDevice(StringConstants::DEFAULT_AUDIO_DEVICE);
+        }
+
+        _helpOverlay->setCaptureStats(getCaptureStatsText());
+        _helpOverlay->setLatencyStats(getLatencyStatsText());
+        _helpOverlay->setFrameStats(getFrameStatsText());
     }
 
-    // Update beat sensitivity
-    _helpOverlay->setBeatSensitivity(getBeatSensitivity());
+    // Update mix table data (arrives as an event)
+    requestMixTable();
+}
 
-    // Update mix table data
-    if (_mixManager) {
-        auto mixes = _mixManager->getAllMixes();
-        _helpOverlay->setMixTableData(mixes);
-    }
+const std::string& AutoVibezApp::getActivePresetName() const {
+    return _presetTable.getPath(projectm_playlist_get_position(_playlist));
 }
 
-std::string AutoVibezApp::getActivePresetName() {
-    unsigned int index = projectm_playlist_get_position(_playlist);
-    if (index) {
-        auto presetName = projectm_playlist_item(_playlist, index);
-        std::string presetNameString(presetName);
-        projectm_playlist_free_string(presetName);
-        return presetNameString;
-    }
-    return {};
+const std::string& AutoVibezApp::getActivePresetDisplayName() const {
+    return _presetTable.getDisplayName(projectm_playlist_get_position(_playlist));
 }
 
 void AutoVibezApp::presetSwitchedEvent(bool isHardCut, unsigned int index, void* context) {
@@ -645,26 +1659,23 @@ void AutoVibezApp::presetSwitchedEvent(bool isHardCut, unsigned int index, void*
         return;
     }
 
-    // Get the current preset name
-    const char* presetName = projectm_playlist_item(app->_playlist, index);
-    if (presetName) {
-        std::string presetNameString(presetName);
-        app->_presetName = presetNameString;
+    // Looked up in the table: hard cuts can fire several times a second
+    const std::string& presetPath = app->_presetTable.getPath(index);
+    AUTOVIBEZ_TRACE_INSTANT("preset", isHardCut ? "hard_cut" : "switch", presetPath);
+    if (!presetPath.empty()) {
+        app->_frameProfiler.setTag(presetPath);
 
         // Add console output for automatic preset changes (only if not manual)
         if (!app->_manualPresetChange) {
-            std::string displayName = presetNameString;
-            size_t lastSlash = displayName.find_last_of('/');
-            if (lastSlash != std::string::npos) {
-                displayName = displayName.substr(lastSlash + 1);
-            }
-            AutoVibez::Utils::ConsoleOutput::presetChange(displayName);
+            AutoVibez::Utils::ConsoleOutput::presetChange(app->_presetTable.getDisplayName(index));
         }
 
         // Reset the manual preset change flag
         app->_manualPresetChange = false;
 
-        projectm_playlist_free_string(const_cast<char*>(presetName));
+        // Any switch, manual or scheduled, restarts the bar count
+        app->_barsSincePresetCut = 0;
+        app->_lastPresetCut = std::chrono::steady_clock::now();
     }
 }
 
@@ -690,7 +1701,15 @@ void AutoVibezApp::UpdateWindowTitle() {
 }
 
 void AutoVibezApp::cycleAudioDevice() {
-    int numDevices = SDL_GetNumAudioDevices(SDL_TRUE);
+    if (_audioReconnecting.load(std::memory_order_acquire)) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logInfo("Audio device is reconnecting; try again in a moment");
+        return;
+    }
+    if (!_audioDevices.isPopulated()) {
+        _audioDevices.refresh();
+    }
+    int numDevices = _audioDevices.getDeviceCount();
 
     // Handle edge cases - no devices available
     if (numDevices <= 0) {
@@ -708,99 +1727,24 @@ void AutoVibezApp::cycleAudioDevice() {
         nextAudioDeviceId = -1;
     }
 
-    // Start recording with new device
-    _selectedAudioDeviceIndex = nextAudioDeviceId;
-    if (initializeAudioInput()) {
-        beginAudioCapture();
-    }
-}
-
-// Mix management methods
-void AutoVibezApp::initMixManager() {
-    if (_mixManagerInitialized)
-        return;
-
-    std::string db_path = PathManager::getStateDirectory() + "/autovibez_mixes.db";
-    std::string mixes_dir = PathManager::getMixesDirectory();
-
-    _mixManager = std::make_unique<MixManager>(db_path, mixes_dir);
-
-    // Connect message overlay to mix manager
-    if (_messageOverlay) {
-        _mixManager->setMessageOverlay(_messageOverlay.get());
-    }
-
-    // Set up callback for when first mix is added to empty database
-    _mixManager->setFirstMixAddedCallback([this](const AutoVibez::Data::Mix& mix) {
-        // Only auto-play if we started with an empty database
-        if (!_hadMixesOnStartup) {
-            if (_mixManager->playMix(mix)) {
-                _currentMix = mix;
-            }
-        }
-    });
-
-    // Initialize database first (fast operation)
-    if (!_mixManager->initialize()) {
-        return;
-    }
-
-    // Load configuration (fast operation)
-    std::string configFilePath = findConfigFile();
-    std::string yaml_url;
-    std::string preferred_genre;
-
-    if (!configFilePath.empty()) {
-        ConfigFile config(configFilePath);
-
-        // Load preferred genre from config
-        config.readInto(preferred_genre, "preferred_genre");
-        _mixManager->setCurrentGenre(preferred_genre);
-
-        // Show current audio device
-        int audioDeviceIndex = config.getAudioDeviceIndex();
-
-        // Get YAML URL
-        yaml_url = config.getMixesUrl();
-    }
-
-    // Mark as initialized early so UI can work
-    _mixManagerInitialized = true;
-
-    // Check if there were mixes in the database when the app started
-    _hadMixesOnStartup = !_mixManager->getAllMixes().empty();
-
-    // Store config for later autoplay (after UI initialization)
-    _shouldAutoPlay = false;
-    if (!configFilePath.empty()) {
-        ConfigFile config(configFilePath);
-        if (config.getAutoDownload()) {
-            _shouldAutoPlay = true;
-        }
+    // The native sink monitor sits just before SDL's default device in the cycle
+    if (_nativeMonitorSelected) {
+        _nativeMonitorSelected = false;
+        nextAudioDeviceId = -1;
+    } else if (_nativeMonitorEnabled && nextAudioDeviceId == -1 && AutoVibez::Audio::MonitorCapture::isAvailable()) {
+        _nativeMonitorSelected = true;
     }
 
-    // Load mix metadata in background (non-blocking)
-    if (!yaml_url.empty() && !_backgroundTaskRunning.load()) {
-        _backgroundTaskRunning.store(true);
-        _backgroundTask = std::async(std::launch::async, [this, yaml_url, configFilePath]() {
-            // Load mix metadata from YAML
-            if (_mixManager->loadMixMetadata(yaml_url)) {
-                // Check for new mixes from remote YAML in background (non-blocking)
-                _mixManager->checkForNewMixes(yaml_url);
-
-                // Start background downloads if no local mixes were found
-                if (!configFilePath.empty()) {
-                    ConfigFile config(configFilePath);
-                    if (config.getAutoDownload()) {
-                        startBackgroundDownloads();
-                    }
-                }
-            }
-            _backgroundTaskRunning.store(false);
-        });
+    // Start recording with new device (deferred while the mix player is the input)
+    _selectedAudioDeviceIndex = nextAudioDeviceId;
+    _preferredAudioDeviceName = _audioDevices.getDeviceName(nextAudioDeviceId);
+    endAudioCapture();
+    if (!_internalAudioActive.load() && initializeAudioInput()) {
+        beginAudioCapture();
     }
 }
 
+// Mix management methods (control thread)
 void AutoVibezApp::startBackgroundDownloads() {
     if (!_mixManagerInitialized) {
         return;
@@ -816,34 +1760,39 @@ void AutoVibezApp::checkAndAutoPlayNext() {
     }
 
     // Check if music has stopped playing (not just paused)
-    if (!_mixManager->isPlaying() && !_mixManager->isPaused()) {
-        // Music has ended or stopped, play next random mix
-        Mix nextMix = _mixManager->getSmartRandomMix(_currentMix.id, _mixManager->getCurrentGenre());
-        if (!nextMix.id.empty()) {
+    if (_mixManager->isPlaying() || _mixManager->isPaused()) {
+        return;
+    }
+
+    // Music has ended or stopped: take the next queued mix, and the one after it if that fails to start
+    for (int attempt = 0; attempt < Constants::AUTO_PLAY_ATTEMPTS; ++attempt) {
+        Mix nextMix = _mixManager->takeNextMix();
+        if (nextMix.id.empty()) {
+            return;
+        }
+        if (attempt == 0) {
             AutoVibez::Utils::ConsoleOutput::info("Auto-playing next mix...");
-            AutoVibez::Utils::ConsoleOutput::mixInfo(nextMix.artist, nextMix.title, nextMix.genre);
-            if (_mixManager->downloadAndPlayMix(nextMix)) {
-                _currentMix = nextMix;
-            } else {
-                // Auto-play failed, try another mix
-                AutoVibez::Utils::ConsoleOutput::warning("Failed to play mix, trying another...");
-                nextMix = _mixManager->getSmartRandomMix(nextMix.id, _mixManager->getCurrentGenre());
-                if (!nextMix.id.empty()) {
-                    AutoVibez::Utils::ConsoleOutput::mixInfo(nextMix.artist, nextMix.title, nextMix.genre);
-                    if (_mixManager->downloadAndPlayMix(nextMix)) {
-                        _currentMix = nextMix;
-                    }
-                }
-            }
         } else {
-            // No more mixes available, try to get any mix
-            nextMix = _mixManager->getRandomMix(_currentMix.id);
-            if (!nextMix.id.empty()) {
-                if (_mixManager->downloadAndPlayMix(nextMix)) {
-                    _currentMix = nextMix;
-                }
-            }
+            AutoVibez::Utils::ConsoleOutput::warning("Failed to play mix, trying another...");
         }
+        AutoVibez::Utils::ConsoleOutput::mixInfo(nextMix.artist, nextMix.title, nextMix.genre);
+        if (_mixManager->downloadAndPlayMix(nextMix)) {
+            _currentMix = nextMix;
+            return;
+        }
+    }
+}
+
+void AutoVibezApp::updateMixLookahead() {
+    if (!_mixManagerInitialized || !_mixManager) {
+        return;
+    }
+
+    if (_mixManager->updatePrefetch()) {
+        // The prefetched mix started without a gap; checkAndAutoPlayNext never sees an ended track
+        _currentMix = _mixManager->getCurrentMix();
+        AutoVibez::Utils::ConsoleOutput::info("Auto-playing next mix...");
+        AutoVibez::Utils::ConsoleOutput::mixInfo(_currentMix.artist, _currentMix.title, _currentMix.genre);
     }
 }
 
@@ -860,10 +1809,8 @@ void AutoVibezApp::autoPlayFromLocalDatabase() {
             _currentMix = randomMix;
             AutoVibez::Utils::ConsoleOutput::mixInfo(randomMix.artist, randomMix.title, randomMix.genre);
             // Show message overlay for the initial mix
-            if (_messageOverlay) {
-                auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist, _currentMix.title);
-                _messageOverlay->showMessage(config);
-            }
+            postOverlayMessage(
+                AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist, _currentMix.title));
         } else {
             // Play failed, try another mix
             randomMix = _mixManager->getSmartRandomMix(randomMix.id, _mixManager->getCurrentGenre());
@@ -872,10 +1819,8 @@ void AutoVibezApp::autoPlayFromLocalDatabase() {
                     _currentMix = randomMix;
                     AutoVibez::Utils::ConsoleOutput::mixInfo(randomMix.artist, randomMix.title, randomMix.genre);
                     // Show message overlay for the fallback mix
-                    if (_messageOverlay) {
-                        auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist, _currentMix.title);
-                        _messageOverlay->showMessage(config);
-                    }
+                    postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist,
+                                                                                        _currentMix.title));
                 }
             }
         }
@@ -887,110 +1832,420 @@ void AutoVibezApp::autoPlayFromLocalDatabase() {
                 _currentMix = randomMix;
                 AutoVibez::Utils::ConsoleOutput::mixInfo(randomMix.artist, randomMix.title, randomMix.genre);
                 // Show message overlay for the random mix
-                if (_messageOverlay) {
-                    auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist, _currentMix.title);
-                    _messageOverlay->showMessage(config);
-                }
+                postOverlayMessage(AutoVibez::Utils::OverlayMessages::createMessage("mix_info", _currentMix.artist,
+                                                                                    _currentMix.title));
+            }
+        } else if (_mixManager->isStreamingEnabled()) {
+            // Nothing downloaded yet: start a catalogue mix while it downloads
+            randomMix = _mixManager->getRandomAvailableMix();
+            if (!randomMix.id.empty() && _mixManager->downloadAndPlayMix(randomMix)) {
+                _currentMix = randomMix;
+                AutoVibez::Utils::ConsoleOutput::mixInfo(randomMix.artist, randomMix.title, randomMix.genre);
             }
         }
     }
 }
 
-void AutoVibezApp::checkPendingAutoPlay() {
-    if (_pendingAutoPlay && _mixManagerInitialized && _messageOverlay) {
-        _pendingAutoPlay = false;
-        autoPlayFromLocalDatabase();
+void AutoVibezApp::startProgressiveLoading() {
+    if (_mixControl.isRunning()) {
+        return;
     }
+
+    // Opening the database, fetching the YAML and autoplay all happen on the control thread; key commands
+    // posted meanwhile queue behind them
+    _mixControl.post([this]() {
+        initMixManagerAsync();
+        if (_shouldAutoPlay && _mixManagerInitialized && !_mixManager->isPlaying() && !_mixManager->isPaused()) {
+            autoPlayFromLocalDatabase();
+        }
+    });
+    _mixControl.start([this]() { runMixHousekeeping(); },
+                      std::chrono::milliseconds(Constants::MIX_CONTROL_INTERVAL_MS));
 }
 
-void AutoVibezApp::startProgressiveLoading() {
-    // Start database initialization in background thread
-    if (!_backgroundTaskRunning.load()) {
-        _backgroundTaskRunning.store(true);
-        _backgroundTask = std::async(std::launch::async, [this]() {
-            // Phase 1: Initialize mix manager (database operations)
-            initMixManagerAsync();
-            
-            // Phase 2: Auto-play if configured (after database is ready)
-            if (_shouldAutoPlay && _mixManagerInitialized) {
-                // Schedule autoplay on main thread to ensure UI safety
-                _pendingAutoPlay = true;
+void AutoVibezApp::runMixHousekeeping() {
+    sampleMemory();
+    if (!_mixManagerInitialized) {
+        return;
+    }
+
+    if (_mixManager->hasFinished()) {
+        checkAndAutoPlayNext();
+    }
+
+    Uint32 now = SDL_GetTicks();
+    if (now - _lastAutoPlayCheck > Constants::DEFAULT_CHECK_INTERVAL_MS) {
+        if (!_mixManager->isPlaying() && !_mixManager->isPaused()) {
+            checkAndAutoPlayNext();
+        }
+        _lastAutoPlayCheck = now;
+    }
+
+    _mixManager->updateCrossfade();
+    updateMixLookahead();
+    _mixManager->updateQueueDownloads();
+    _mixManager->updateDownloadBandwidth();
+    _mixManager->updateSharedCatalog();
+    _mixManager->updateResumeState();
+    _mixManager->updateMaintenance();
+
+    if (_configWatcher && now - _lastConfigCheck > Constants::CONFIG_RELOAD_CHECK_MS) {
+        _lastConfigCheck = now;
+        checkConfigReload();
+    }
+
+    publishNowPlaying();
+    syncMix();
+    if (_eventDrivenLoop) {
+        scheduleMixHousekeeping(now);
+    }
+}
+
+void AutoVibezApp::scheduleMixHousekeeping(Uint32 now) {
+    const auto clockNow = std::chrono::steady_clock::now();
+    auto dueIn = [&](Uint32 last, int interval) {
+        const Uint32 elapsed = now - last;
+        const int left = elapsed >= static_cast<Uint32>(interval) ? 0 : interval - static_cast<int>(elapsed);
+        return clockNow + std::chrono::milliseconds(left);
+    };
+
+    // The memory sample and anything without a signal of its own are looked at on the idle interval
+    _mixControl.tickBy(clockNow + std::chrono::milliseconds(Constants::MIX_CONTROL_IDLE_INTERVAL_MS));
+    _mixControl.tickBy(_mixManager->getNextUpdate());
+    if (!_mixManager->isPlaying() && !_mixManager->isPaused()) {
+        _mixControl.tickBy(dueIn(_lastAutoPlayCheck, Constants::DEFAULT_CHECK_INTERVAL_MS));
+    }
+    if (_configWatcher) {
+        _mixControl.tickBy(dueIn(_lastConfigCheck, Constants::CONFIG_RELOAD_CHECK_MS));
+    }
+    if (_nodeSync) {
+        _mixControl.tickBy(clockNow);  // A leader publishes its position every tick
+    }
+}
+
+void AutoVibezApp::syncMix() {
+    if (!_nodeSync) {
+        return;
+    }
+    if (_nodeSync->getRole() == SyncRole::Leader) {
+        if (_syncSelectionSeed == 0) {
+            std::random_device device;
+            _syncSelectionSeed = std::uniform_int_distribution<uint32_t>(1)(device);  // 0 stands for none
+            _mixManager->setSelectionSeed(_syncSelectionSeed);
+        }
+        SyncMix mix;
+        mix.time_ns = NodeSync::nowNs();
+        AutoVibez::Utils::HashId::parse(_currentMix.id, mix.id);  // All zero when nothing has played
+        mix.position_ms = _mixManager->getPositionMs();
+        mix.position_seconds = static_cast<int32_t>(mix.position_ms / 1000);
+        mix.playing = _mixManager->isPlaying() && !_mixManager->isPaused();
+        mix.selection_seed = _syncSelectionSeed;
+        _nodeSync->publishMix(mix);
+        return;
+    }
+
+    const Uint32 now = SDL_GetTicks();
+    if (now - _lastSyncMixCheck < static_cast<Uint32>(Constants::SYNC_MIX_CHECK_INTERVAL_MS)) {
+        return;
+    }
+    _lastSyncMixCheck = now;
+    SyncVisuals visuals;
+    SyncMix leader;
+    if (!_nodeSync->getLeaderState(visuals, leader)) {
+        return;
+    }
+    if (leader.selection_seed != 0 && leader.selection_seed != _syncSelectionSeed) {
+        // Same library, same seed: the picks from here on tend to match the leader's
+        _syncSelectionSeed = leader.selection_seed;
+        _mixManager->setSelectionSeed(_syncSelectionSeed);
+    }
+
+    // Playback is only kept in step on the leader's own mix; both sides read their sample clocks
+    AutoVibez::Utils::HashId current;
+    if (!leader.playing || !_mixManager->isPlaying() || _mixManager->isPaused() ||
+        !AutoVibez::Utils::HashId::parse(_currentMix.id, current) || current != leader.id) {
+        _syncMixSeeking = false;
+        return;
+    }
+    const int64_t leaderMs =
+        leader.position_ms > 0 ? leader.position_ms : static_cast<int64_t>(leader.position_seconds) * 1000;
+    const int64_t target = leaderMs + (NodeSync::nowNs() - leader.time_ns) / 1000000;
+    const int64_t drift = std::abs(target - _mixManager->getPositionMs());
+    if (drift <= Constants::SYNC_MIX_SETTLED_MS) {
+        _syncMixSeeking = false;
+        return;
+    }
+    // A seek that lands a little off (output latency, a coarse seek) is not chased every check
+    if (drift >= (_syncMixSeeking ? Constants::SYNC_MIX_RESEEK_MS : Constants::SYNC_MIX_DRIFT_MS)) {
+        _mixManager->seekToMs(target);
+        _syncMixSeeking = true;
+    }
+}
+
+void AutoVibezApp::sampleMemory() {
+    const Uint32 now = SDL_GetTicks();
+    if (now - _lastMemorySample < static_cast<Uint32>(Constants::MEMORY_SAMPLE_INTERVAL_MS)) {
+        return;
+    }
+    _lastMemorySample = now;
+
+    // Growth leaves a trail in the log, so what grew is on record even after an OOM kill
+    const AutoVibez::Utils::ProcessMemory process = AutoVibez::Utils::MemoryAccounting::sample();
+    const int64_t step = static_cast<int64_t>(Constants::MEMORY_LOG_STEP_MB) * 1024 * 1024;
+    if (process.resident_bytes >= _loggedResidentHigh + step) {
+        _loggedResidentHigh = process.resident_bytes;
+        ::AutoVibez::Utils::Logger logger;
+        logger.logInfo("Memory high: " + AutoVibez::Utils::MemoryAccounting::formatBreakdown(process));
+    }
+}
+
+void AutoVibezApp::applyMixSettings(const AppConfig& config) {
+    _mixManager->setStreamingEnabled(config.stream_while_downloading);
+    _mixManager->setPlayQueueDepth(config.play_queue_depth);
+    _mixManager->setSimilarMixProbability(config.similar_mix_probability);
+    _mixManager->setStreamStartBytes(static_cast<int64_t>(config.stream_start_kb) * 1024);
+    _mixManager->setPlayingDownloadLimit(static_cast<int64_t>(config.playing_download_limit_kb) * 1024);
+    _mixManager->setMixCacheQuota(static_cast<int64_t>(config.mix_cache_quota_gb) * 1024 * 1024 * 1024);
+    _mixManager->setLoudnessNormalization(config.loudness_normalization, config.loudness_target_lufs);
+    _seekIncrement = config.seek_increment;
+}
+
+void AutoVibezApp::checkConfigReload() {
+    if (!_configWatcher->poll()) {
+        return;
+    }
+    // Settings read once at startup (window, audio devices, database, renderer) still need a restart
+    const std::shared_ptr<const AppConfig> config = _configWatcher->current();
+    applyMixSettings(*config);
+    _mixControl.postEvent([this, config]() { applyPresetTiming(*config); });
+    postOverlayMessage("Config reloaded");
+}
+
+void AutoVibezApp::publishNowPlaying() {
+    auto snapshot = std::make_shared<NowPlaying>();
+    snapshot->mix = _currentMix;
+    snapshot->playing = _mixManager->isPlaying();
+    snapshot->paused = _mixManager->isPaused();
+    snapshot->volume = _mixManager->getVolume();
+    snapshot->output_rate = _mixManager->getOutputRate();
+
+    // The queue is copied out only when it changed since the last publish
+    _comingUp.update(_mixManager->getPlayQueueRevision(), [this]() { return _mixManager->getUpcomingMixes(); });
+    snapshot->coming_up = _comingUp.get();
+
+    const NowPlaying* published = _publishedNowPlaying.get();
+
+    if (published && snapshot->mix.id == published->mix.id && snapshot->playing == published->playing &&
+        snapshot->paused == published->paused && snapshot->volume == published->volume &&
+        snapshot->output_rate == published->output_rate && snapshot->coming_up == published->coming_up) {
+        return;
+    }
+    // Readers holding the previous snapshot keep it until they let go
+    _publishedNowPlaying = snapshot;
+    std::atomic_store(&_nowPlaying, std::shared_ptr<const NowPlaying>(snapshot));
+
+    if (_remoteControl.isRunning()) {
+        using AutoVibez::Utils::JsonUtils;
+        const Mix& mix = snapshot->mix;
+        std::string json = "{\"id\":\"" + JsonUtils::escapeJsonString(mix.id) + '"';
+        json += ",\"title\":\"" + JsonUtils::escapeJsonString(mix.title) + '"';
+        json += ",\"artist\":\"" + JsonUtils::escapeJsonString(mix.artist) + '"';
+        json += ",\"genre\":\"" + JsonUtils::escapeJsonString(mix.genre) + '"';
+        json += std::string(",\"playing\":") + (snapshot->playing ? "true" : "false");
+        json += std::string(",\"paused\":") + (snapshot->paused ? "true" : "false");
+        json += ",\"volume\":" + std::to_string(snapshot->volume);
+        json += ",\"coming_up\":" + JsonUtils::vectorToJsonArray(snapshot->coming_up) + '}';
+        _remoteControl.publish("now_playing", json);
+    }
+}
+
+void AutoVibezApp::processMixEvents() {
+    _mixControl.runEvents(std::chrono::microseconds(Constants::MIX_EVENT_FRAME_BUDGET_US));
+}
+
+void AutoVibezApp::postOverlayMessage(const AutoVibez::Utils::NamedMessageConfig& config) {
+    _mixControl.postEvent([this, config]() {
+        if (_messageOverlay) {
+            _messageOverlay->showMessage(config);
+        }
+    });
+}
+
+void AutoVibezApp::postOverlayMessage(const std::string& message) {
+    _mixControl.postEvent([this, message]() {
+        if (_messageOverlay) {
+            _messageOverlay->showMessage(message);
+        }
+    });
+}
+
+void AutoVibezApp::requestMixTable() {
+    Uint32 now = SDL_GetTicks();
+    if (!_mixManagerInitialized || _mixTableRequested.load() ||
+        now - _lastMixTableRequest < static_cast<Uint32>(Constants::MIX_TABLE_REFRESH_MS)) {
+        return;
+    }
+    _lastMixTableRequest = now;
+    _mixTableRequested.store(true);
+
+    bool posted = _mixControl.post([this]() {
+        // Unchanged since the last reload: the overlay already shows this library
+        auto snapshot = _mixManager->getCatalogSnapshot();
+        if (snapshot == _mixTableSnapshot) {
+            _mixTableRequested.store(false);
+            return;
+        }
+        _mixTableSnapshot = snapshot;
+        auto mixes = snapshot->toVector();
+        bool delivered = _mixControl.postEvent([this, mixes = std::move(mixes)]() {
+            if (_helpOverlay) {
+                _helpOverlay->setMixTableData(mixes);
             }
-            
-            _backgroundTaskRunning.store(false);
+            _mixTableRequested.store(false);
         });
+        if (!delivered) {
+            _mixTableSnapshot.reset();
+            _mixTableRequested.store(false);
+        }
+    });
+    if (!posted) {
+        _mixTableRequested.store(false);
+    }
+}
+
+void AutoVibezApp::requestMixSearch(const std::string& query) {
+    const unsigned generation = ++_mixSearchGeneration;
+    if (!_mixManagerInitialized || query.empty()) {
+        return;
     }
+    _mixControl.post([this, query, generation]() {
+        // Typed over by a newer query still in the queue
+        if (generation != _mixSearchGeneration.load()) {
+            return;
+        }
+        auto mixes = _mixManager->searchMixes(query);
+        _mixControl.postEvent([this, query, mixes = std::move(mixes)]() {
+            if (_helpOverlay) {
+                _helpOverlay->setSearchResults(query, mixes);
+            }
+        });
+    });
 }
 
 void AutoVibezApp::initMixManagerAsync() {
     if (_mixManagerInitialized)
         return;
+    AUTOVIBEZ_TRACE_SCOPE("mixes", "initMixManagerAsync");
 
     std::string db_path = PathManager::getStateDirectory() + "/autovibez_mixes.db";
     std::string mixes_dir = PathManager::getMixesDirectory();
 
     _mixManager = std::make_unique<MixManager>(db_path, mixes_dir);
+    _mixManager->setCancellationToken(_shutdownToken);
 
-    // Connect message overlay to mix manager (if available)
-    if (_messageOverlay) {
-        _mixManager->setMessageOverlay(_messageOverlay.get());
-    }
+    // Let the player feed projectM directly while a mix is playing
+    _mixManager->setPcmTap(&AutoVibez::Audio::mixOutputCallbackS16, this);
+    _mixManager->setRequestedOutputRate(getPlaybackSampleRate());
+    _mixManager->setDecoderSynth(_decoderSynth);
+
+    // Messages reach the overlay as events drained on the render thread
+    _mixManager->setMessageHandler(
+        [this](const AutoVibez::Utils::NamedMessageConfig& config) { postOverlayMessage(config); });
 
-    // Set up callback for when first mix is added to empty database
+    // Set up callback for when first mix is added to empty database (fired from a download thread)
     _mixManager->setFirstMixAddedCallback([this](const AutoVibez::Data::Mix& mix) {
-        // Only auto-play if we started with an empty database
-        if (!_hadMixesOnStartup) {
-            if (_mixManager->playMix(mix)) {
-                _currentMix = mix;
+        _mixControl.post([this, mix]() {
+            // Only auto-play if we started with an empty database (and nothing is streaming already)
+            if (!_hadMixesOnStartup && !_mixManager->isPlaying()) {
+                if (_mixManager->playMix(mix)) {
+                    _currentMix = mix;
+                }
             }
-        }
+        });
     });
 
+    // The database profile is needed before the database opens
+    const AppConfig* config = _startup->config.get();
+    if (config) {
+        AutoVibez::Data::SqliteTuning tuning = AutoVibez::Data::SqliteTuning::fast();
+        if (!AutoVibez::Data::SqliteTuning::parseProfile(config->mix_database_profile, tuning)) {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown mix_database_profile '" + config->mix_database_profile + "', using fast");
+        }
+        if (config->mix_database_query_stats || config->mix_database_log_plans) {
+            _queryStats = std::make_shared<AutoVibez::Data::SqliteQueryStats>(config->mix_database_log_plans);
+            tuning.query_stats = _queryStats;
+        }
+        _mixManager->setDatabaseTuning(tuning);
+        _mixManager->setSharedCatalogEnabled(config->shared_catalog);
+        _mixManager->setTranscodeCache(config->transcode_cache, config->transcode_bitrate_kbps);
+        _eventDrivenLoop = config->event_driven_loop;
+        if (_eventDrivenLoop) {
+            _mixManager->setWakeHandler([this]() { _mixControl.wake(); });
+        }
+        _mixManager->setMixSync(config->mix_sync_url, config->mix_sync_interval_seconds);
+        if (config->resume_playback) {
+            _mixManager->setResumeStatePath(PathManager::getResumeStatePath());
+        }
+    }
+
+    // Audio is back from the resume record while the database is still opening
+    const bool resumed = _mixManager->resumePlayback();
+    if (resumed) {
+        _currentMix = _mixManager->getCurrentMix();
+        AutoVibez::Utils::ConsoleOutput::mixInfo(_currentMix.artist, _currentMix.title, _currentMix.genre);
+    }
+
     // Initialize database (this can be slow)
     if (!_mixManager->initialize()) {
         return;
     }
 
     // Load configuration
-    std::string configFilePath = findConfigFile();
     std::string yaml_url;
-    std::string preferred_genre;
-
-    if (!configFilePath.empty()) {
-        ConfigFile config(configFilePath);
 
-        // Load preferred genre from config
-        config.readInto(preferred_genre, "preferred_genre");
-        _mixManager->setCurrentGenre(preferred_genre);
+    if (config) {
+        // A resumed session keeps the genre it was playing
+        if (!resumed) {
+            _mixManager->setCurrentGenre(config->preferred_genre);
+        }
+        applyMixSettings(*config);
+        _mixManager->setPeerCacheEnabled(config->peer_cache);
+        _dumpDownloadStats = config->download_stats;
 
         // Get YAML URL
-        yaml_url = config.getMixesUrl();
+        yaml_url = config->mixes_url;
         
         // Set autoplay flag for later
-        if (config.getAutoDownload()) {
+        if (config->auto_download) {
             _shouldAutoPlay = true;
         }
+
+        if (config->config_hot_reload) {
+            _configWatcher = std::make_unique<AutoVibez::Data::AppConfigWatcher>(_startup->config);
+        }
     }
 
     // Mark as initialized
     _mixManagerInitialized = true;
 
     // Check if there were mixes in the database when the app started
-    _hadMixesOnStartup = !_mixManager->getAllMixes().empty();
+    _hadMixesOnStartup = !_mixManager->getCatalogSnapshot()->empty();
 
-    // Load mix metadata in background if available
+    // The startup task fetched the manifest while the database opened; if that failed, fetch it with retries
     if (!yaml_url.empty()) {
-        // Load mix metadata from YAML
-        if (_mixManager->loadMixMetadata(yaml_url)) {
+        _startup->graph.wait(AppStartup::MANIFEST_TASK);
+        const bool loaded = _startup->manifest_loaded
+                                ? _mixManager->syncMixMetadata(yaml_url, std::move(_startup->manifest_mixes),
+                                                               _startup->manifest_unchanged)
+                                : _mixManager->loadMixMetadata(yaml_url);
+        if (loaded) {
             // Check for new mixes from remote YAML
             _mixManager->checkForNewMixes(yaml_url);
 
             // Start background downloads if no local mixes were found
-            if (!configFilePath.empty()) {
-                ConfigFile config(configFilePath);
-                if (config.getAutoDownload()) {
-                    startBackgroundDownloads();
-                }
+            if (config->auto_download) {
+                startBackgroundDownloads();
             }
         }
     }
@@ -14,23 +14,55 @@
 
 // projectM SDL
 #include "audio_capture.hpp"
+#include "audio_feature_extractor.hpp"
+#include "audio_device_registry.hpp"
+#include "beat_tracker.hpp"
+#include "capture_buffer_controller.hpp"
+#include "latency_model.hpp"
 #include "loopback.hpp"
+#include "monitor_capture.hpp"
+#include "pcm_ingest.hpp"
+#include "pcm_ring_buffer.hpp"
+#include "synthetic_capture.hpp"
 #include "opengl.h"
 #include "setup.hpp"
 
 // Mix management
-#include "config_manager.hpp"
+#include "app_config.hpp"
+#include "app_startup.hpp"
+#include "event_forwarder.hpp"
+#include "frame_capture.hpp"
+#include "frame_pacer.hpp"
+#include "frame_profiler.hpp"
 #include "help_overlay.hpp"
 #include "imgui_manager.hpp"
 #include "key_binding_manager.hpp"
 #include "message_overlay_wrapper.hpp"
+#include "mix_control_thread.hpp"
+#include "multi_output.hpp"
+#include "node_sync.hpp"
+#include "performance_hud.hpp"
+#include "power_policy.hpp"
+#include "preset_cost_tracker.hpp"
+#include "preset_table.hpp"
+#include "quality_governor.hpp"
+#include "remote_control_server.hpp"
+#include "render_scaler.hpp"
+#include "resize_coalescer.hpp"
+#include "resolution_governor.hpp"
+#include "texture_cache.hpp"
+#include "upcoming_titles.hpp"
 #include "mix_downloader.hpp"
 #include "mix_manager.hpp"
 #include "mix_metadata.hpp"
 
 // New modular components
+#include "cancellation_token.hpp"
 #include "constants.hpp"
+#include "metrics_exporter.hpp"
 #include "path_manager.hpp"
+#include "preset_cost_database.hpp"
+#include "preset_manifest.hpp"
 #include "preset_manager.hpp"
 #include "system_volume_controller.hpp"
 
@@ -41,14 +73,17 @@
 #endif
 
 #include <atomic>
+#include <chrono>
 #include <fstream>
 #include <future>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <mutex>
+#include <random>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #ifdef WASAPI_LOOPBACK
@@ -75,10 +110,28 @@
 
 namespace AutoVibez::Core {
 
+/**
+ * @brief Playback state published by the mix control thread for every other thread
+ *
+ * Immutable once published: the control thread builds a new one and swaps the pointer,
+ * so a reader holding one sees every field from the same moment.
+ */
+struct NowPlaying {
+    AutoVibez::Data::Mix mix;
+    bool playing = false;
+    bool paused = false;
+    int volume = 0;
+    int output_rate = 0;                 //!< Rate of the player's output stream (0 before the mix manager exists)
+    std::vector<std::string> coming_up;  //!< "Artist - Title" of the queued mixes, next first
+};
+
 class AutoVibezApp {
 public:
-    AutoVibezApp(SDL_GLContext glCtx, const std::string& presetPath, const std::string& texturePath,
-                 int audioDeviceIndex = 0, bool showFps = false);
+    /**
+     * @param startup Its asset paths must be done; the other results are picked up by finishStartup
+     */
+    AutoVibezApp(SDL_GLContext glCtx, std::shared_ptr<AppStartup> startup, int audioDeviceIndex = 0,
+                 bool showFps = false);
 
     ~AutoVibezApp();
 
@@ -88,6 +141,38 @@ public:
     int initializeAudioInput();
     void beginAudioCapture();
     void endAudioCapture();
+
+    /**
+     * @brief Select internal mix playback or a capture device as the visualizer input
+     *
+     * Switches to the MixPlayer output tap whenever a mix is loaded and reopens the
+     * capture device once playback stops.
+     */
+    void updateAudioSource();
+    void setInternalAudioEnabled(bool enabled) {
+        _internalAudioEnabled = enabled;
+    }
+    bool isInternalAudioActive() const {
+        return _internalAudioActive.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Prefer native capture of the default sink monitor (Linux PipeWire/PulseAudio) over SDL devices
+     */
+    void setNativeMonitorEnabled(bool enabled) {
+        _nativeMonitorEnabled = enabled;
+        _nativeMonitorSelected = enabled;
+    }
+
+    /**
+     * @brief Replace capture with a generated signal or audio file for reproducible benchmarks
+     * @param spec "sweep", "pink", "kicks", "sine", or a .wav/.mp3 path; empty uses capture devices
+     * @param speed Multiple of real time to replay at (0 = unpaced)
+     */
+    void setSyntheticAudio(const std::string& spec, double speed) {
+        _syntheticAudioSpec = spec;
+        _syntheticAudioSpeed = speed;
+    }
     void stretchMonitors();
     void nextMonitor();
     void toggleFullScreen();
@@ -97,16 +182,23 @@ public:
     void renderFrame();
     void pollEvents();
     bool keymod = false;
-    std::string getActivePresetName();
+    /**
+     * @brief Path of the preset at the playlist position (empty with no presets)
+     */
+    const std::string& getActivePresetName() const;
+
+    /**
+     * @brief File name of the preset at the playlist position
+     */
+    const std::string& getActivePresetDisplayName() const;
     projectm_handle projectM();
     float getBeatSensitivity() const;
 
     // Help and UI
     void cycleAudioDevice();
 
-    // Mix management
+    // Mix management (the mix control thread owns MixManager; everything below touching it runs there)
 
-    void initMixManager();
     void initKeyBindingManager();
 
     KeyBindingManager* getKeyBindingManager() {
@@ -116,10 +208,30 @@ public:
     void autoPlayFromLocalDatabase();
     void startBackgroundDownloads();
     void checkAndAutoPlayNext();
-    void checkPendingAutoPlay();
+
+    /**
+     * @brief Drive the gapless next-mix lookahead and follow the player across hand-offs
+     */
+    void updateMixLookahead();
+
+    /**
+     * @brief Apply events from the mix control thread (now-playing updates, overlay messages); render thread only
+     */
+    void processMixEvents();
+
+    /**
+     * @brief Take on the startup results that are in since the last frame (preset list, volume backend); render
+     *        thread only, cheap once they all are
+     */
+    void finishStartup();
+
     bool isMixManagerInitialized() const {
         return _mixManagerInitialized;
     }
+
+    /**
+     * @brief The mix manager, for code running on the mix control thread
+     */
     AutoVibez::Data::MixManager* getMixManager() {
         return _mixManager.get();
     }
@@ -131,12 +243,18 @@ public:
 
     // Help Overlay
     void initHelpOverlay();
-    void renderHelpOverlay();
     void updateHelpOverlayInfo();
 
     // Message Overlay
     void initMessageOverlay();
-    void renderMessageOverlay();
+
+    // Performance HUD
+    void initPerformanceHud();
+
+    /**
+     * @brief Composite every visible overlay in one ImGui frame (none when all are hidden)
+     */
+    void renderOverlays();
 
     // New modular component accessors
     PresetManager* getPresetManager() {
@@ -146,7 +264,7 @@ public:
     // Beat sensitivity
     void setBeatSensitivity(float sensitivity);
 
-    bool done{false};
+    std::atomic<bool> done{false};  //!< Set on the render thread, read by the main thread's event pump
     bool mouseDown{false};
     bool wasapi{false};  // Used to track if wasapi is currently active. This bool will allow us to run a WASAPI app and
                          // still toggle to microphone inputs.
@@ -168,6 +286,329 @@ public:
         return _projectM;
     }
 
+    /**
+     * @brief Interleaved stereo PCM handed from the audio thread to the render loop
+     */
+    AutoVibez::Audio::PcmRingBuffer& getPcmRingBuffer() {
+        return _pcmRingBuffer;
+    }
+
+    /**
+     * @brief Live beat tracker fed by the audio callbacks alongside the ring buffer
+     */
+    AutoVibez::Audio::BeatTracker& getBeatTracker() {
+        return _beatTracker;
+    }
+    AutoVibez::Audio::BeatState getBeatState() const {
+        return _beatTracker.getState();
+    }
+
+    /**
+     * @brief Levels, band energies and spectral centroid of the last PCM block drained for projectM
+     */
+    const AutoVibez::Audio::AudioFeatureExtractor& getAudioFeatures() const {
+        return _audioFeatures;
+    }
+
+    /**
+     * @brief Open capture and playback at the devices' native rate and period instead of 44.1 kHz
+     */
+    void setNativeSampleRateEnabled(bool enabled) {
+        _nativeSampleRate = enabled;
+    }
+
+    /**
+     * @brief Rate the current capture source delivers at
+     */
+    int getCaptureSampleRate() const {
+        return _captureSampleRate;
+    }
+
+    /**
+     * @brief Period the SDL capture device opens with, and whether it adapts to callback jitter
+     * @param adaptive Pick the smallest glitch-free period at run time
+     * @param periodFrames Starting period (rounded to a power of two)
+     */
+    void setCaptureBufferSizing(bool adaptive, int periodFrames) {
+        _captureBuffer.setEnabled(adaptive);
+        _captureBuffer.setRequestedPeriod(periodFrames);
+    }
+
+    /**
+     * @brief One-line capture period, latency and xrun summary, or empty without an SDL capture device
+     */
+    std::string getCaptureStatsText() const;
+
+    /**
+     * @brief Choose how the render loop is paced (applied when the window is initialized)
+     * @param mode Vsync, fixed-rate or uncapped
+     * @param targetFps Rate for fixed mode; 0 follows the display refresh rate
+     */
+    void setFramePacing(FramePacingMode mode, double targetFps) {
+        _framePacingMode = mode;
+        _framePacingFps = targetFps;
+    }
+
+    /**
+     * @brief Set the swap interval and pacer for the window's current display
+     */
+    void applyFramePacing();
+
+    /**
+     * @brief Render on a thread of its own while the main thread pumps events (ignored on macOS)
+     *
+     * Keeps frames coming while Windows runs a window drag or resize in a modal loop.
+     */
+    void setRenderThread(bool enabled) {
+        _renderThreadEnabled = enabled;
+    }
+    bool usesRenderThread() const;
+
+    /**
+     * @brief Route events through the forwarder and release the GL context (main thread, before the render thread)
+     */
+    void beginRenderThread();
+
+    /**
+     * @brief Take events and the GL context back (main thread, after the render thread joined)
+     */
+    void endRenderThread();
+
+    /**
+     * @brief Make the GL context current on, or release it from, the calling thread
+     */
+    void attachContext();
+    void detachContext();
+
+    /**
+     * @brief Hand an event pumped on the main thread to the render thread
+     */
+    void forwardEvent(const SDL_Event& event) {
+        _eventForwarder.push(event);
+    }
+
+    /**
+     * @brief Throttle or pause rendering while the window is minimized or hidden (or unfocused, if enabled)
+     * @param idleFps Render rate while throttled
+     */
+    void setPowerSaving(PowerSavingMode mode, double idleFps, bool whenUnfocused) {
+        _powerPolicy.configure(mode, idleFps, whenUnfocused);
+    }
+
+    /**
+     * @brief Finish a loop iteration: wait for the frame deadline and record its timing
+     *
+     * While saving power, waits out the idle tick instead; any event ends the wait early.
+     */
+    void paceFrame();
+
+    const FramePacer& getFramePacer() const {
+        return _framePacer;
+    }
+
+    /**
+     * @brief One-line pacing mode, frame interval and jitter summary for the status panel
+     */
+    std::string getFrameStatsText() const;
+
+    /**
+     * @brief Per-phase CPU/GPU timings of the main loop, read by the performance HUD
+     */
+    FrameProfiler& getFrameProfiler() {
+        return _frameProfiler;
+    }
+
+    /**
+     * @brief Latest playback snapshot, never null; lock-free and safe from any thread
+     */
+    std::shared_ptr<const NowPlaying> getNowPlaying() const {
+        return std::atomic_load(&_nowPlaying);
+    }
+
+    void togglePerformanceHud();
+
+    /**
+     * @brief Write the profiling window to a timestamped CSV in the config directory
+     * @return True if the file was written
+     */
+    bool dumpFrameProfile();
+
+#ifdef AUTOVIBEZ_TRACING
+    /**
+     * @brief Write the trace recorded so far to a timestamped JSON file in the config directory
+     * @return True if the file was written
+     */
+    bool dumpTrace();
+#endif
+
+    /**
+     * @brief Mix database query timings (nullptr unless mix_database_query_stats or mix_database_log_plans is set)
+     */
+    std::shared_ptr<AutoVibez::Data::SqliteQueryStats> getQueryStats() const {
+        return _queryStats;
+    }
+
+    /**
+     * @brief Write the query timings to a timestamped CSV in the config directory
+     * @return True if the file was written
+     */
+    bool dumpQueryStats();
+
+    /**
+     * @brief Write the per-host download totals to a timestamped CSV in the config directory
+     * @return True if the file was written
+     */
+    bool dumpDownloadStats();
+
+    /**
+     * @brief Show the download queue, its rate and the host failing most in the message overlay
+     *
+     * Runs on the mix control thread, which owns the mix manager; the overlay gets the line as an event.
+     */
+    void showDownloadStatus();
+
+    /**
+     * @brief Save the next frame, without overlays, as an image; encoding happens off the render thread
+     * @param path Output file; empty writes a time-stamped file to the screenshots folder
+     */
+    void requestScreenshot(const std::string& path = "");
+
+    /**
+     * @brief Format and JPEG quality of screenshots without an explicit file name
+     */
+    void setScreenshotFormat(ImageFormat format, int quality);
+
+    /**
+     * @brief Load textures from the transcoded cache once it is complete, and bring it up to date in the background
+     */
+    void setTextureCache(bool enabled);
+
+    /**
+     * @brief Push the metrics registry to a StatsD collector and/or a Prometheus text file; both empty exports nothing
+     */
+    void setMetricsExport(const std::string& statsdAddress, const std::string& textfilePath);
+
+    /**
+     * @brief Take key actions over HTTP and a WebSocket, and push now-playing and metrics events; port 0 is off
+     * @param token Required of every request when not empty
+     */
+    void setRemoteControl(int port, const std::string& token);
+
+    /**
+     * @brief Keep this screen in step with the others in the room: "leader", "follower" or "off"
+     *
+     * The leader decides every preset cut, follower or not; projectM's own timer and hard cuts
+     * are turned off on each node. Call before initialize.
+     */
+    void setNodeSync(const std::string& role);
+
+    /**
+     * @brief Line the visuals up with the sound using the measured latency model
+     * @param enabled Delay internal playback and lead beat predictions by the measured lag
+     * @param displayQueueFrames Swapped frames assumed to wait for scanout
+     * @param offsetMs Manual correction found with the calibration pattern
+     */
+    void setLatencyCompensation(bool enabled, int displayQueueFrames, double offsetMs);
+
+    /**
+     * @brief Start or stop the click/flash test pattern used to find the manual offset
+     */
+    void toggleLatencyCalibration();
+
+    bool isLatencyCalibrating() const {
+        return _latencyCalibration;
+    }
+
+    /**
+     * @brief Nudge the manual offset; positive values mean the visuals still trail the sound
+     */
+    void adjustAvOffset(double deltaMs);
+
+    /**
+     * @brief One-line latency breakdown and applied correction for the status panel
+     */
+    std::string getLatencyStatsText() const;
+
+    /**
+     * @brief Schedule preset cuts onto tracked downbeats instead of projectM's timer and hard cuts
+     * @param enabled Whether the app owns preset timing
+     * @param bars Bars between cuts while the beat is locked
+     * @param fallbackSeconds Seconds between cuts while no beat is locked
+     */
+    void setBeatSyncedPresets(bool enabled, int bars, double fallbackSeconds);
+
+    /**
+     * @brief Preset durations, hard cuts, beat sensitivity and beat sync from a config snapshot (render thread)
+     */
+    void applyPresetTiming(const AutoVibez::Data::AppConfig& config);
+
+    /**
+     * @brief Measure what each preset costs to render and keep presets over the frame budget out of rotation
+     * @param profile Record per-preset render timings in the preset cost database
+     * @param skipSlow Leave presets slower than the frame budget on this GPU out of random selection
+     */
+    void setPresetCostProfiling(bool profile, bool skipSlow);
+
+    /**
+     * @brief Draw presets by measured cost and the music's energy instead of uniformly
+     *
+     * Heavy presets go to loud, busy passages when the frame has room for them, light
+     * ones to breakdowns (see PresetScheduler).
+     */
+    void setPresetScheduling(bool enabled) {
+        _presetScheduling = enabled;
+    }
+
+    /**
+     * @brief Render projectM below the window size and upscale it to the window
+     * @param scale Fraction of the window size to render at (1 = native)
+     * @param dynamic Let the resolution governor move the scale to hold the frame rate
+     * @param minScale Lowest scale the governor may choose
+     */
+    void setRenderScale(double scale, bool dynamic, double minScale);
+
+    /**
+     * @brief Render one frame at a content resolution and present its regions on several displays
+     * @param displays "all" or comma-separated display indices; empty or "off" keeps a single window
+     * @param bezel Desktop pixels hidden behind the bezel between neighbouring displays
+     * @param contentWidth Width of the rendered frame (0 = the widest display)
+     */
+    void setMultiOutput(const std::string& displays, int bezel, int contentWidth);
+
+    /**
+     * @brief Let the quality governor trade mesh size, frame rate and render scale for a steady frame time
+     * @param bounds Ranges for each setting; the frame rate only moves under fixed pacing
+     * @param meshAspect Mesh rows per column
+     * @param profile Hardware profile the floors came from (for the log)
+     */
+    void setQualityGovernor(const QualityBounds& bounds, double meshAspect, const std::string& profile);
+
+    /**
+     * @brief Conversion to stereo float used by the capture callback, chosen when the device opens
+     */
+    const AutoVibez::Audio::PcmIngest& getPcmIngest() const {
+        return _pcmIngest;
+    }
+
+    /**
+     * @brief Set custom downmix weights ("l:r,l:r,..." per channel), applied on next device open
+     */
+    void setDownmixWeights(const std::string& weights) {
+        _downmixWeights = weights;
+    }
+
+    /**
+     * @brief libmpg123 synth mixes are decoded with (see DecoderBackend::select), empty for its own choice
+     */
+    void setDecoderSynth(const std::string& synth) {
+        _decoderSynth = synth;
+    }
+
+    /**
+     * @brief Move all buffered PCM into projectM in one batch (render thread only)
+     */
+    void drainPcmToProjectM();
+
     // Friend function for audio callback
     friend void AutoVibez::Audio::audioInputCallbackF32(void* userData, const float* buffer, int len);
 
@@ -176,6 +617,10 @@ private:
 
     // Mouse wheel function declarations removed
 
+    std::shared_ptr<AppStartup> _startup;  //!< Declared first, as members below read its results
+    bool _startupFinished{false};          //!< Render thread: everything of _startup taken on
+    bool _firstFrameShown{false};          //!< Render thread
+
     projectm_handle _projectM{nullptr};
     projectm_playlist_handle _playlist{nullptr};
 
@@ -184,22 +629,219 @@ private:
     size_t _height{0};
 
     unsigned short _audioChannelsCount{0};
-    unsigned int _numAudioDevices{0};
     SDL_AudioDeviceID _audioDeviceId{0};
-
-    std::string _presetName;  //!< Current preset name
-
-    int _selectedAudioDeviceIndex{0};  //!< Selected audio device index
+    bool _internalAudioEnabled{true};              //!< Feed projectM from the mix player when possible
+    std::atomic<bool> _internalAudioActive{false};  //!< Mix player output is the current input
+
+    // Audio thread -> render thread PCM handoff
+    AutoVibez::Audio::PcmRingBuffer _pcmRingBuffer{Constants::PCM_RING_BUFFER_SAMPLES};
+    std::vector<float> _pcmDrainBuffer = std::vector<float>(Constants::PCM_RING_BUFFER_SAMPLES);
+    AutoVibez::Audio::BeatTracker _beatTracker;
+    AutoVibez::Audio::AudioFeatureExtractor _audioFeatures;  //!< Analyzed once per drained block
+
+    // Beat-synced preset cuts (render thread)
+    bool _beatSyncedPresets{false};
+    int _presetCutBars{Constants::DEFAULT_PRESET_CUT_BARS};
+    double _presetFallbackSeconds{Constants::DEFAULT_PRESET_DURATION};
+    uint64_t _lastBeatCount{0};
+    int _barsSincePresetCut{0};
+    std::chrono::steady_clock::time_point _lastPresetCut{std::chrono::steady_clock::now()};
+
+    // Capture format and multichannel support
+    AutoVibez::Audio::PcmIngest _pcmIngest;
+    std::string _downmixWeights;
+    std::string _decoderSynth;  //!< Handed to the mix manager when it starts
+
+    // Native sink-monitor capture; declared after the ring buffer so it stops before the buffer goes away
+    AutoVibez::Audio::MonitorCapture _monitorCapture;
+    bool _nativeMonitorEnabled{true};   //!< Native monitor is part of the device cycle
+    bool _nativeMonitorSelected{true};  //!< Native monitor is the current capture choice
+
+    // Synthetic input replaces every capture device while a spec is set
+    AutoVibez::Audio::SyntheticCapture _syntheticCapture;
+    std::string _syntheticAudioSpec;
+    double _syntheticAudioSpeed{1.0};
+
+    bool _nativeSampleRate{true};                            //!< Negotiate device rates instead of resampling
+    int _captureSampleRate{Constants::DEFAULT_SAMPLE_RATE};  //!< Rate of the active capture source
+
+    PresetTable _presetTable;  //!< Playlist paths and display names by index, rebuilt when the playlist changes
+
+    int _selectedAudioDeviceIndex{0};       //!< Selected audio device index
+    std::string _preferredAudioDeviceName;  //!< Device to reconnect to by name; empty for the default device
+
+    // Cached capture devices and hotplug reconnects (device state belongs to the worker while it runs)
+    AutoVibez::Audio::AudioDeviceRegistry _audioDevices;
+    std::future<void> _audioReconnectTask;
+    std::atomic<bool> _audioReconnecting{false};
+    bool _audioReconnectPending{false};
+    AutoVibez::Audio::CaptureBufferController _captureBuffer;
+
+    // Render loop pacing
+    FramePacer _framePacer;
+    FramePacingMode _framePacingMode{FramePacingMode::Vsync};
+    double _framePacingFps{0.0};
+    PowerPolicy _powerPolicy;
+#ifdef _WIN32
+    bool _renderThreadEnabled{true};
+#else
+    bool _renderThreadEnabled{false};
+#endif
+    EventForwarder _eventForwarder;  //!< Installed only while the render thread runs
+    FrameProfiler _frameProfiler;
+    bool _showPerformanceHud{false};  //!< Open the HUD at startup (show_fps)
+    std::shared_ptr<AutoVibez::Data::SqliteQueryStats> _queryStats;  //!< Shared with every database connection
+    bool _dumpDownloadStats{false};                                  //!< download_stats: write them on exit
+
+    // Preset cost profiling: frames are folded on the render thread, the database lives on the mix control thread
+    PresetCostTracker _presetCostTracker;
+    bool _profilePresetCost{true};
+    bool _skipSlowPresets{true};
+    std::string _glRenderer;  //!< Presets are measured per GPU/driver
+    std::unique_ptr<AutoVibez::Data::PresetCostDatabase> _presetCostDatabase;  //!< Control thread
+
+    void initPresetCostProfiling();
+
+    // Preset scheduling (render thread)
+    bool _presetScheduling{true};
+    double _presetRenderBudgetMs{0.0};  //!< Frame budget less what the other phases take, averaged
+
+    /**
+     * @brief Hand the playlist and the manifest's measured costs to the preset manager's scheduler
+     */
+    void schedulePresets();
+
+    /**
+     * @brief Pass the music's energy and the render budget to the scheduler (every frame)
+     */
+    void updatePresetScheduling();
+
+    // Preset manifest: loaded by a startup task, it fills the playlist; a rescan task then picks up library changes
+    AutoVibez::Data::PresetManifest& _presetManifest;  //!< Lives in _startup
+    bool _presetsAdopted{false};                       //!< Render thread: the playlist has the manifest's presets
+    std::atomic<bool> _presetManifestScanned{false};   //!< The manifest matches the tree and may be saved
+
+    // Texture cache: outlives _presetManager, whose preloader prefetches through it
+    std::string _texturePath;
+    TextureCache _textureCache;
+
+    // Metrics export (metrics_statsd, metrics_textfile)
+    AutoVibez::Utils::MetricsExporter _metricsExporter;
+
+    // Remote control (remote_control_port): stopped first at shutdown, so no action arrives mid-teardown
+    RemoteControlServer _remoteControl;
+
+    // Multi-node sync (sync_role); null when off
+    std::unique_ptr<NodeSync> _nodeSync;
+    SyncVisuals _syncVisuals;        //!< Render thread (leader): published every frame
+    bool _syncCutPending{false};     //!< Render thread (leader): an announced cut it has yet to make
+    bool _syncFollowing{false};      //!< Render thread (follower): a timed leader was heard this frame
+    uint32_t _syncAppliedCut{0};     //!< Render thread (follower): the leader's cut_count last made
+    uint32_t _syncSelectionSeed{0};  //!< Control thread: seed of the random mix picks in use, 0 before one
+    Uint32 _lastSyncMixCheck{0};     //!< Control thread (follower)
+    bool _syncMixSeeking{false};     //!< Control thread (follower): seeked, and not yet back in step since
+    // Render thread (leader): seeds of the draws after cuts
+    std::mt19937 _syncRandom{std::random_device{}()};
+
+    /**
+     * @brief Fill the playlist from the manifest the startup task loaded and, if it was saved by an earlier run,
+     *        rescan the tree for changes on the startup pool (render thread)
+     */
+    void adoptPresets();
+
+    /**
+     * @brief Log the time to first frame against STARTUP_FIRST_FRAME_TARGET_MS and what startup had done by then
+     */
+    void reportFirstFrame();
+
+    /**
+     * @brief Add and remove playlist entries after a rescan (render thread)
+     */
+    void applyPresetChanges(const AutoVibez::Data::PresetManifestChanges& changes);
+
+    /**
+     * @brief Open the preset cost database on first use (control thread)
+     */
+    bool openPresetCostDatabase();
+
+    /**
+     * @brief Frame interval the pacer aims for, in milliseconds
+     */
+    double getFrameBudgetMs() const;
+
+    // Render scaling: projectM draws into _renderScaler's target, blitted up before the overlays
+    std::unique_ptr<RenderScaler> _renderScaler;
+    ResolutionGovernor _resolutionGovernor;
+    double _renderScale{Constants::DEFAULT_RENDER_SCALE};
+    bool _dynamicRenderScale{false};
+    bool _renderScaled{false};  //!< projectM renders offscreen at _renderWidth x _renderHeight
+    size_t _renderWidth{0};
+    size_t _renderHeight{0};
+    ResizeCoalescer _resizeCoalescer;  //!< Window sizes wait here until a drag ends
+
+    void initRenderScaling();
+
+    // Multi-output: _renderScaler's frame is split across one window per display
+    std::unique_ptr<MultiOutput> _multiOutput;
+    std::string _multiOutputDisplays;
+    int _multiOutputBezel{0};
+    int _multiOutputWidth{0};
+
+    void initMultiOutput();
+
+    // Quality governor (render thread): owns the mesh, fps and render scale while enabled
+    QualityGovernor _qualityGovernor;
+    bool _qualityGoverned{false};
+    QualityBounds _qualityBounds;
+    double _qualityMeshAspect{1.0};
+    std::string _qualityProfile;
+    QualitySettings _appliedQuality;
+
+    void initQualityGovernor();
+
+    /**
+     * @brief Push the governor's settings that changed to projectM, the pacer and the render target
+     */
+    void applyQualitySettings();
+
+    /**
+     * @brief Render scale in effect: the quality governor's, the resolution governor's or the configured one
+     */
+    double getCurrentRenderScale() const;
+
+    /**
+     * @brief Size projectM (and the offscreen target when scaling) for the window and current scale
+     */
+    void applyRenderSize();
+
+    /**
+     * @brief Take a size from a window event; projectM keeps its size, stretched, until the size settles
+     */
+    void queueResize(int width, int height);
+
+    /**
+     * @brief Apply a queued size once it has settled
+     */
+    void updatePendingResize();
+
+    // Audio-to-video latency compensation and its calibration pattern (render thread)
+    AutoVibez::Audio::LatencyModel _latency;
+    bool _latencyCompensation{true};
+    bool _latencyCalibration{false};
+    AutoVibez::Audio::CalibrationClickDetector _calibrationClicks;
+    std::chrono::steady_clock::time_point _calibrationFlashUntil;
+    std::chrono::steady_clock::time_point _lastFrameStart;
 
     // Mix management
     std::unique_ptr<AutoVibez::Data::MixManager> _mixManager;
 
+    // _currentMix and the startup flags belong to the mix control thread; other threads read getNowPlaying()
     AutoVibez::Data::Mix _currentMix;
-    bool _mixManagerInitialized;
+    std::atomic<bool> _mixManagerInitialized{false};
     bool _hadMixesOnStartup;
     bool _shouldAutoPlay{false};                 // Whether to autoplay on startup
-    bool _pendingAutoPlay{false};                // Autoplay pending from background thread
     bool _volumeKeyPressed{false};               // Track if volume key is being held
+    int _seekIncrement{60};                      // Seconds per seek key press (seek_increment)
     bool _manualPresetChange{false};             // Track if preset change was manual
     int _previousVolume{Constants::MAX_VOLUME};  // Store volume before mute
 
@@ -209,16 +851,151 @@ private:
     // Message Overlay
     std::unique_ptr<AutoVibez::UI::MessageOverlayWrapper> _messageOverlay;
 
+    // Performance HUD (reads _frameProfiler, so it is declared after it)
+    std::unique_ptr<AutoVibez::UI::PerformanceHud> _performanceHud;
+
     // New modular components
     std::unique_ptr<PresetManager> _presetManager;
     std::unique_ptr<KeyBindingManager> _keyBindingManager;
     std::unique_ptr<AutoVibez::Utils::ISystemVolumeController> _systemVolumeController;
 
-    // Thread safety members
-    std::future<void> _backgroundTask;
-    std::atomic<bool> _backgroundTaskRunning{false};
-
+    // Mix control thread: owns _mixManager and _currentMix, talks to the render thread through its queues
+    AutoVibez::Utils::CancellationToken _shutdownToken;  //!< Cancelled first at shutdown, so mix work stops early
+    MixControlThread _mixControl;
+    std::shared_ptr<const NowPlaying> _nowPlaying{std::make_shared<const NowPlaying>()};  //!< Swapped atomically
+    std::shared_ptr<const NowPlaying> _publishedNowPlaying;  //!< Control thread: last built here, null before
+    UpcomingTitles _comingUp;                                //!< Control thread: coming_up as last read
+    Uint32 _lastAutoPlayCheck{0};                            //!< Control thread
+    Uint32 _lastMemorySample{0};                             //!< Control thread
+    bool _eventDrivenLoop{false};                            //!< Control thread: the event_driven_loop setting
+    int64_t _loggedResidentHigh{0};                     //!< Control thread: resident size of the last logged breakdown
+    std::atomic<bool> _mixTableRequested{false};        //!< A mix table reload is queued or running
+    Uint32 _lastMixTableRequest{0};                     //!< Render thread
+    Uint32 _lastHelpStatsUpdate{0};                     //!< Render thread
+    std::shared_ptr<const NowPlaying> _helpNowPlaying;  //!< Render thread: snapshot the help overlay shows
+    AutoVibez::Data::MixCatalog::Snapshot _mixTableSnapshot;  //!< Control thread: catalog the table was built from
+    std::atomic<unsigned> _mixSearchGeneration{0};  //!< Bumped per search box edit; older queued searches skip
+    int _postedOutputDelay{-1};                     //!< Render thread: last speaker delay sent to the player
+
+    // Screenshots: the worker reports through _mixControl, so the capture is declared (and joined) after it
+    FrameCapture _frameCapture;
+
+    void initFrameCapture();
+
+    // Config hot reload (config_hot_reload): the control thread polls the file and applies what changed
+    std::unique_ptr<AutoVibez::Data::AppConfigWatcher> _configWatcher;  //!< Control thread
+    Uint32 _lastConfigCheck{0};                                         //!< Control thread
+
+    /**
+     * @brief Mix manager settings that may change while running (control thread)
+     */
+    void applyMixSettings(const AutoVibez::Data::AppConfig& config);
+
+    /**
+     * @brief Apply the config file again if it changed; preset timing goes to the render thread
+     */
+    void checkConfigReload();
+
+    /**
+     * @brief Control thread tick: autoplay, lookahead, crossfade state, downloads, now-playing snapshot
+     */
+    void runMixHousekeeping();
+
+    /**
+     * @brief With event_driven_loop, sleep after the tick until one of its timers is due
+     *
+     * Mix endings, settled downloads and commands wake the control thread sooner.
+     */
+    void scheduleMixHousekeeping(Uint32 now);
+    void publishNowPlaying();
+
+    /**
+     * @brief Control thread: read the resident size once a second, logging a breakdown at each new high a step up
+     */
+    void sampleMemory();
+
+    /**
+     * @brief Show a message from the control thread (forwarded to the render thread)
+     */
+    void postOverlayMessage(const AutoVibez::Utils::NamedMessageConfig& config);
+    void postOverlayMessage(const std::string& text);
+
+    /**
+     * @brief Ask the control thread for the help overlay's mix table (at most every MIX_TABLE_REFRESH_MS)
+     */
+    void requestMixTable();
+
+    /**
+     * @brief Run a help overlay search on the control thread and hand the ranked matches back
+     */
+    void requestMixSearch(const std::string& query);
+
+    /**
+     * @brief Cut to a new preset on the downbeat that completes the configured bar count
+     */
+    void updateBeatSync();
+
+    /**
+     * @brief Cut to the upcoming random preset; a sync leader announces the cut and makes it SYNC_CUT_LEAD_MS later
+     */
+    void cutPreset();
+
+    /**
+     * @brief Render thread: publish the leader's beat and cuts, or make the leader's cuts on a follower
+     */
+    void updateNodeSync();
+
+    /**
+     * @brief Control thread: publish the leader's mix, or seek a follower playing it back in step
+     */
+    void syncMix();
+
+    /**
+     * @brief Record the rate of a capture source about to start and retune the beat tracker to it
+     */
+    void setCaptureSampleRate(int rate);
+
+    /**
+     * @brief Rate to open playback (and the sink monitor) at: the default output's native rate when enabled
+     */
+    int getPlaybackSampleRate() const;
+
+    bool nextEvent(SDL_Event& event);
     void handleWindowEvent(const SDL_Event& evt);
+    void onPowerStateChanged();
+
+    /**
+     * @brief Refresh the device cache on hotplug and reopen capture if the current or preferred device changed
+     */
+    void handleAudioDeviceEvent(const SDL_Event& evt);
+
+    /**
+     * @brief Reopen capture on a background thread (coalesces requests made while one is running)
+     */
+    void scheduleAudioReconnect();
+
+    /**
+     * @brief Collect a finished reconnect and start any that was requested meanwhile
+     */
+    void updateAudioReconnect();
+
+    /**
+     * @brief Let the capture period controller judge the last window and reopen the device if it asks
+     */
+    void updateCaptureBuffer();
+
+    /**
+     * @brief Feed this frame's timings to the latency model and apply the resulting speaker delay
+     * @param frameStart When the frame began draining PCM
+     * @param swapStart When the frame was handed to the swap
+     */
+    void updateLatencyModel(std::chrono::steady_clock::time_point frameStart,
+                            std::chrono::steady_clock::time_point swapStart);
+
+    /**
+     * @brief Cover the visuals with the calibration pattern: white while a click is on screen, black otherwise
+     */
+    void renderCalibrationFlash();
     // Mouse wheel event handler removed
     void handleKeyDownEvent(const SDL_Event& evt);
     void handleKeyUpEvent(const SDL_Event& evt);
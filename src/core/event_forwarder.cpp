@@ -0,0 +1,68 @@
+#include "event_forwarder.hpp"
+
+#include <chrono>
+
+namespace AutoVibez::Core {
+
+EventForwarder::EventForwarder(size_t limit) : _limit(limit) {}
+
+EventForwarder::~EventForwarder() {
+    uninstall();
+}
+
+void EventForwarder::install() {
+    if (!_installed) {
+        SDL_SetEventFilter(&EventForwarder::filter, this);
+        _installed = true;
+    }
+}
+
+void EventForwarder::uninstall() {
+    if (_installed) {
+        SDL_SetEventFilter(nullptr, nullptr);
+        _installed = false;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _events.clear();
+    }
+}
+
+bool EventForwarder::push(const SDL_Event& event) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_events.size() >= _limit && event.type == SDL_MOUSEMOTION) {
+            ++_dropped;
+            return false;
+        }
+        _events.push_back(event);
+    }
+    _queued.notify_one();
+    return true;
+}
+
+bool EventForwarder::poll(SDL_Event& event) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_events.empty()) {
+        return false;
+    }
+    event = _events.front();
+    _events.pop_front();
+    return true;
+}
+
+void EventForwarder::wait(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _queued.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return !_events.empty(); });
+}
+
+size_t EventForwarder::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dropped;
+}
+
+int EventForwarder::filter(void* userdata, SDL_Event* event) {
+    // Runs on whichever thread generated the event; returning 0 keeps it out of SDL's queue
+    static_cast<EventForwarder*>(userdata)->push(*event);
+    return 0;
+}
+
+}  // namespace AutoVibez::Core
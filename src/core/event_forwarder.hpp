@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Carries SDL events from the thread that pumps them to the render thread
+ *
+ * Installed as SDL's event filter, it takes every event as SDL generates it, including
+ * the ones Windows delivers from inside the modal loop of a window drag or resize,
+ * when the main thread is stuck in SDL_PumpEvents. The filter drops them from SDL's own
+ * queue, so the render thread reads them from here in order. A full queue drops mouse
+ * motion, which the next motion event supersedes, but keeps everything else.
+ */
+class EventForwarder {
+public:
+    explicit EventForwarder(size_t limit = Constants::EVENT_FORWARD_QUEUE_LIMIT);
+    ~EventForwarder();
+
+    EventForwarder(const EventForwarder&) = delete;
+    EventForwarder& operator=(const EventForwarder&) = delete;
+
+    /**
+     * @brief Become SDL's event filter (from the main thread)
+     */
+    void install();
+
+    /**
+     * @brief Give SDL's queue its events back; forwarded events not yet read are discarded
+     */
+    void uninstall();
+
+    bool isInstalled() const {
+        return _installed;
+    }
+
+    /**
+     * @brief Queue an event for the render thread (from any thread)
+     * @return False if it was dropped because the queue is full
+     */
+    bool push(const SDL_Event& event);
+
+    /**
+     * @brief Take the oldest queued event
+     * @return False if none is waiting
+     */
+    bool poll(SDL_Event& event);
+
+    /**
+     * @brief Block until an event is queued or the timeout passes
+     */
+    void wait(int timeoutMs);
+
+    size_t getDroppedCount() const;
+
+private:
+    static int filter(void* userdata, SDL_Event* event);
+
+    size_t _limit;
+    bool _installed = false;
+    mutable std::mutex _mutex;
+    std::condition_variable _queued;
+    std::deque<SDL_Event> _events;
+    size_t _dropped = 0;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,149 @@
+#include "frame_capture.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+namespace AutoVibez::Core {
+
+FrameCapture::~FrameCapture() {
+    {
+        std::lock_guard<std::mutex> lock(_jobMutex);
+        _stopping = true;
+    }
+    _jobReady.notify_one();
+    // Captures already read back are still written
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void FrameCapture::setFormat(ImageFormat format, int quality) {
+    _format = format;
+    _quality = quality;
+}
+
+void FrameCapture::setDirectory(const std::string& directory) {
+    _directory = directory;
+}
+
+void FrameCapture::setResultCallback(ResultCallback callback) {
+    std::lock_guard<std::mutex> lock(_jobMutex);
+    _callback = std::move(callback);
+}
+
+void FrameCapture::request(const std::string& path) {
+    std::lock_guard<std::mutex> lock(_requestMutex);
+    _requests.push_back(path);
+    _requested.store(true, std::memory_order_release);
+}
+
+void FrameCapture::onFrame(int width, int height) {
+    ++_frame;
+
+    // Map the reads the GPU has had frames to finish
+    while (!_inFlight.empty() && _frame - _inFlight.front().frame >= Constants::CAPTURE_READBACK_DELAY_FRAMES) {
+        std::vector<uint8_t> image;
+        _readback->pop(image);
+        submit(std::move(_inFlight.front()), std::move(image), _readbackWidth, _readbackHeight);
+        _inFlight.pop_front();
+    }
+
+    if (!_requested.load(std::memory_order_acquire) || width <= 0 || height <= 0) {
+        return;
+    }
+    // After a resize the buffers are reallocated once the reads of the old size are out
+    if (!_readback || width != _readbackWidth || height != _readbackHeight) {
+        if (!_inFlight.empty()) {
+            return;
+        }
+        _readback = FrameReadback::create(width, height, Constants::CAPTURE_MAX_IN_FLIGHT);
+        _readbackWidth = width;
+        _readbackHeight = height;
+    }
+
+    std::vector<std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        const size_t room = Constants::CAPTURE_MAX_IN_FLIGHT - _inFlight.size();
+        const size_t count = std::min(room, _requests.size());
+        paths.assign(_requests.begin(), _requests.begin() + static_cast<std::ptrdiff_t>(count));
+        _requests.erase(_requests.begin(), _requests.begin() + static_cast<std::ptrdiff_t>(count));
+        _requested.store(!_requests.empty(), std::memory_order_release);
+    }
+    for (const std::string& path : paths) {
+        Target target = resolveTarget(path);
+        target.frame = _frame;
+        std::vector<uint8_t> image;
+        if (_readback->push(image)) {
+            // Synchronous fallback: the image is already here
+            submit(std::move(target), std::move(image), width, height);
+        } else {
+            _inFlight.push_back(std::move(target));
+        }
+    }
+}
+
+std::string FrameCapture::makeFileName(std::time_t time, unsigned sequence, ImageFormat format) {
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&time));
+    return std::string("autovibez-") + stamp + "-" + std::to_string(sequence) +
+           ImageEncoder::getExtension(format);
+}
+
+FrameCapture::Target FrameCapture::resolveTarget(const std::string& path) {
+    Target target;
+    target.quality = _quality;
+    if (path.empty()) {
+        target.format = _format;
+        target.path = (std::filesystem::path(_directory) / makeFileName(std::time(nullptr), ++_sequence, _format))
+                          .string();
+        return target;
+    }
+    target.path = path;
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension.empty() || !ImageEncoder::parseFormat(extension.substr(1), target.format)) {
+        target.format = _format;
+    }
+    return target;
+}
+
+void FrameCapture::submit(Target target, std::vector<uint8_t> image, int width, int height) {
+    {
+        std::lock_guard<std::mutex> lock(_jobMutex);
+        _jobs.push_back(Job{std::move(target), std::move(image), width, height});
+        if (!_worker.joinable()) {
+            _worker = std::thread(&FrameCapture::workerLoop, this);
+        }
+    }
+    _jobReady.notify_one();
+}
+
+void FrameCapture::workerLoop() {
+    std::unique_lock<std::mutex> lock(_jobMutex);
+    while (true) {
+        _jobReady.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+        if (_jobs.empty()) {
+            return;
+        }
+        Job job = std::move(_jobs.front());
+        _jobs.pop_front();
+        const ResultCallback callback = _callback;
+        lock.unlock();
+
+        std::string error;
+        const std::filesystem::path parent = std::filesystem::path(job.target.path).parent_path();
+        std::error_code ignored;
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ignored);
+        }
+        const bool ok = ImageEncoder::write(job.target.path, job.target.format, job.image, job.width, job.height,
+                                            job.target.quality, error);
+        if (callback) {
+            callback(ok, ok ? job.target.path : error);
+        }
+        lock.lock();
+    }
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "constants.hpp"
+#include "frame_readback.hpp"
+#include "image_encoder.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Screenshots that never make the render loop wait on the GPU
+ *
+ * request() may be called from any thread. On the next frame the render thread copies
+ * the finished backbuffer into a pixel buffer object through FrameReadback and carries
+ * on; CAPTURE_READBACK_DELAY_FRAMES frames later, when the GPU is long done with it, the
+ * buffer is mapped and the image handed to a worker thread that encodes and writes it.
+ * At most CAPTURE_MAX_IN_FLIGHT reads are outstanding; further requests wait their turn.
+ * Without pixel buffer objects the read falls back to a synchronous glReadPixels, but
+ * encoding still happens on the worker.
+ */
+class FrameCapture {
+public:
+    /**
+     * @brief Called on the worker thread with the written path, or the error when writing failed
+     */
+    using ResultCallback = std::function<void(bool ok, const std::string& message)>;
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * @brief Format and JPEG quality for screenshots without an explicit file name (render thread)
+     */
+    void setFormat(ImageFormat format, int quality);
+
+    /**
+     * @brief Directory for screenshots without an explicit file name, created on first use (render thread)
+     */
+    void setDirectory(const std::string& directory);
+
+    void setResultCallback(ResultCallback callback);
+
+    /**
+     * @brief Capture the next rendered frame (any thread)
+     * @param path Output file, whose .png/.jpg extension picks the format; empty names a file by time
+     */
+    void request(const std::string& path = "");
+
+    /**
+     * @brief Start captures and retire finished ones; call with the frame complete in the backbuffer
+     */
+    void onFrame(int width, int height);
+
+    /**
+     * @brief Time-stamped screenshot file name, e.g. autovibez-20250101-120000-1.png
+     */
+    static std::string makeFileName(std::time_t time, unsigned sequence, ImageFormat format);
+
+private:
+    struct Target {
+        std::string path;
+        ImageFormat format = ImageFormat::Png;
+        int quality = Constants::DEFAULT_JPEG_QUALITY;
+        uint64_t frame = 0;  // Frame the read was issued on
+    };
+
+    struct Job {
+        Target target;
+        std::vector<uint8_t> image;
+        int width = 0;
+        int height = 0;
+    };
+
+    Target resolveTarget(const std::string& path);
+    void submit(Target target, std::vector<uint8_t> image, int width, int height);
+    void workerLoop();
+
+    // Render thread
+    std::unique_ptr<FrameReadback> _readback;
+    int _readbackWidth = 0;
+    int _readbackHeight = 0;
+    std::deque<Target> _inFlight;
+    uint64_t _frame = 0;
+    unsigned _sequence = 0;
+    ImageFormat _format = ImageFormat::Png;
+    int _quality = Constants::DEFAULT_JPEG_QUALITY;
+    std::string _directory = ".";
+
+    // Requests from any thread
+    std::mutex _requestMutex;
+    std::vector<std::string> _requests;
+    std::atomic<bool> _requested{false};
+
+    // Encoding worker, started with the first capture
+    std::mutex _jobMutex;
+    std::condition_variable _jobReady;
+    std::deque<Job> _jobs;
+    bool _stopping = false;
+    std::thread _worker;
+    ResultCallback _callback;
+};
+
+}  // namespace AutoVibez::Core
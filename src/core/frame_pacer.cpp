@@ -0,0 +1,130 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "constants.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+constexpr double MISSED_FRAME_FACTOR = 1.5;  // An interval this many targets long dropped a refresh
+
+double toMs(FramePacer::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+}  // namespace
+
+FramePacer::FramePacer(NowFunction now, WaitFunction wait)
+    : _now(now ? std::move(now) : NowFunction(&Clock::now)),
+      _wait(wait ? std::move(wait) : WaitFunction(&FramePacer::spinSleepUntil)) {}
+
+bool FramePacer::parseMode(const std::string& name, FramePacingMode& mode) {
+    const std::string lower = AutoVibez::Utils::StringUtils::toLower(name);
+    if (lower == "vsync") {
+        mode = FramePacingMode::Vsync;
+    } else if (lower == "fixed") {
+        mode = FramePacingMode::Fixed;
+    } else if (lower == "uncapped") {
+        mode = FramePacingMode::Uncapped;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* FramePacer::modeName(FramePacingMode mode) {
+    switch (mode) {
+        case FramePacingMode::Vsync:
+            return "vsync";
+        case FramePacingMode::Fixed:
+            return "fixed";
+        case FramePacingMode::Uncapped:
+            return "uncapped";
+    }
+    return "vsync";
+}
+
+void FramePacer::configure(FramePacingMode mode, double target_fps, double refresh_hz) {
+    _mode = mode;
+    const double refresh = refresh_hz > 0.0 ? refresh_hz : static_cast<double>(Constants::DEFAULT_FPS_VALUE);
+    double fps = 0.0;
+    if (mode == FramePacingMode::Vsync) {
+        fps = refresh;
+    } else if (mode == FramePacingMode::Fixed) {
+        fps = target_fps > 0.0 ? target_fps : refresh;
+    }
+    _intervalMs = fps > 0.0 ? 1000.0 / fps : 0.0;
+    _interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(_intervalMs));
+
+    _started = false;
+    _stats = FrameTimingStats();
+    _stats.target_ms = _intervalMs;
+    _windowSum = 0.0;
+    _windowJitter = 0.0;
+    _windowWorst = 0.0;
+    _windowFrames = 0;
+}
+
+double FramePacer::getTargetFps() const {
+    return _intervalMs > 0.0 ? 1000.0 / _intervalMs : 0.0;
+}
+
+void FramePacer::endFrame() {
+    if (_mode == FramePacingMode::Fixed) {
+        const Clock::time_point now = _now();
+        _deadline = _started ? _deadline + _interval : now + _interval;
+        if (now > _deadline + _interval) {
+            // A whole interval behind: start a fresh schedule rather than rushing frames out to catch up
+            _deadline = now;
+        } else if (now < _deadline) {
+            _wait(_deadline);
+        }
+    }
+    record(_now());
+}
+
+void FramePacer::record(Clock::time_point start) {
+    if (!_started) {
+        _started = true;
+        _lastStart = start;
+        return;
+    }
+
+    const double interval = toMs(start - _lastStart);
+    const double reference = _intervalMs > 0.0 ? _intervalMs : _stats.last_frame_ms;
+    _lastStart = start;
+    _stats.last_frame_ms = interval;
+    ++_stats.frames;
+    if (_intervalMs > 0.0 && interval > MISSED_FRAME_FACTOR * _intervalMs) {
+        ++_stats.missed;
+    }
+
+    _windowSum += interval;
+    _windowJitter += std::fabs(interval - reference);
+    _windowWorst = std::max(_windowWorst, interval);
+    if (++_windowFrames >= Constants::FRAME_STATS_WINDOW) {
+        _stats.mean_frame_ms = _windowSum / _windowFrames;
+        _stats.jitter_ms = _windowJitter / _windowFrames;
+        _stats.worst_ms = _windowWorst;
+        _windowSum = 0.0;
+        _windowJitter = 0.0;
+        _windowWorst = 0.0;
+        _windowFrames = 0;
+    }
+}
+
+void FramePacer::spinSleepUntil(Clock::time_point deadline) {
+    const Clock::time_point sleepUntil = deadline - std::chrono::microseconds(Constants::FRAME_SPIN_MARGIN_US);
+    if (Clock::now() < sleepUntil) {
+        std::this_thread::sleep_until(sleepUntil);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief How the render loop is paced
+ */
+enum class FramePacingMode {
+    Vsync,    //!< The swap blocks on the display; the pacer never sleeps
+    Fixed,    //!< Swap without vsync and hold a target rate with a sleep-then-spin wait
+    Uncapped  //!< Swap without vsync and render as fast as possible (benchmarking)
+};
+
+/**
+ * @brief Frame interval and jitter over the last reporting window, in milliseconds
+ */
+struct FrameTimingStats {
+    double target_ms = 0.0;      //!< Interval the pacer aims for (the refresh period under vsync, 0 uncapped)
+    double last_frame_ms = 0.0;  //!< Most recent start-to-start interval
+    double mean_frame_ms = 0.0;  //!< Average interval in the window
+    double jitter_ms = 0.0;      //!< Mean distance of an interval from the target (from the previous one uncapped)
+    double worst_ms = 0.0;       //!< Longest interval in the window
+    uint64_t frames = 0;         //!< Frames paced since configure()
+    uint64_t missed = 0;         //!< Intervals over 1.5 targets long (a dropped refresh)
+};
+
+/**
+ * @brief Paces the render loop against absolute deadlines on a high-resolution clock
+ *
+ * In fixed mode each frame's deadline is the previous deadline plus the target
+ * interval, so the average rate is exact (no integer-millisecond drift) and a
+ * late frame is absorbed by the next one. A frame that overruns a whole interval
+ * resynchronizes instead of bursting to catch up. The wait sleeps until shortly
+ * before the deadline and spins the rest, since OS sleeps overshoot by up to a
+ * millisecond or more. Timings are reported per frame; window statistics roll over
+ * every FRAME_STATS_WINDOW frames.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using NowFunction = std::function<Clock::time_point()>;
+    using WaitFunction = std::function<void(Clock::time_point)>;
+
+    /**
+     * @brief Create a pacer
+     * @param now Clock to read; defaults to steady_clock
+     * @param wait Blocks until the given time; defaults to spinSleepUntil()
+     */
+    explicit FramePacer(NowFunction now = nullptr, WaitFunction wait = nullptr);
+
+    /**
+     * @brief Parse "vsync", "fixed" or "uncapped" (case-insensitive)
+     * @return True if the name was recognized
+     */
+    static bool parseMode(const std::string& name, FramePacingMode& mode);
+
+    static const char* modeName(FramePacingMode mode);
+
+    /**
+     * @brief Start pacing in a mode
+     * @param mode Pacing mode
+     * @param target_fps Rate for fixed mode; 0 or less uses the refresh rate
+     * @param refresh_hz Display refresh rate; 0 or less assumes DEFAULT_FPS_VALUE
+     */
+    void configure(FramePacingMode mode, double target_fps, double refresh_hz);
+
+    FramePacingMode getMode() const {
+        return _mode;
+    }
+
+    /**
+     * @brief Frames per second the loop should run at (0 when uncapped)
+     */
+    double getTargetFps() const;
+
+    /**
+     * @brief Swap interval the GL context should use: 1 under vsync, 0 otherwise
+     */
+    int getSwapInterval() const {
+        return _mode == FramePacingMode::Vsync ? 1 : 0;
+    }
+
+    /**
+     * @brief End the current frame: wait for its deadline (fixed mode) and record its timing
+     */
+    void endFrame();
+
+    FrameTimingStats getStats() const {
+        return _stats;
+    }
+
+    /**
+     * @brief Sleep until slightly before a deadline, then spin (yielding) until it passes
+     */
+    static void spinSleepUntil(Clock::time_point deadline);
+
+private:
+    void record(Clock::time_point start);
+
+    NowFunction _now;
+    WaitFunction _wait;
+    FramePacingMode _mode = FramePacingMode::Vsync;
+    Clock::duration _interval{};
+    double _intervalMs = 0.0;
+    Clock::time_point _deadline;
+    Clock::time_point _lastStart;
+    bool _started = false;
+
+    FrameTimingStats _stats;
+    double _windowSum = 0.0;
+    double _windowJitter = 0.0;
+    double _windowWorst = 0.0;
+    int _windowFrames = 0;
+};
+
+}  // namespace AutoVibez::Core
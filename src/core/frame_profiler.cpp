@@ -0,0 +1,326 @@
+#include "frame_profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <utility>
+
+#include "metrics_registry.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+constexpr size_t GPU_FRAMES_IN_FLIGHT = 2;  // Query sets alternated by frame parity
+constexpr size_t MIN_WINDOW = GPU_FRAMES_IN_FLIGHT;
+
+double msSince(FrameProfiler::Clock::time_point start, FrameProfiler::Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Nearest-rank percentile of sorted values
+double rank(const std::vector<double>& sorted, double fraction) {
+    const size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(index, 1)) - 1];
+}
+
+void writeCsvField(std::ostream& out, const std::string& field) {
+    if (field.find_first_of(",\"\n") == std::string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        out << c;
+        if (c == '"') {
+            out << '"';
+        }
+    }
+    out << '"';
+}
+
+void writeCsvTime(std::ostream& out, double ms) {
+    out << ',';
+    if (ms >= 0.0) {
+        out << ms;
+    }
+}
+
+FrameRecord emptyRecord() {
+    FrameRecord record;
+    record.cpu_ms.fill(-1.0);
+    record.gpu_ms.fill(-1.0);
+    return record;
+}
+}  // namespace
+
+FrameProfiler::FrameProfiler(size_t window, NowFunction now)
+    : _now(now ? std::move(now) : NowFunction(&Clock::now)),
+      _records(std::max(window, MIN_WINDOW)),
+      _current(emptyRecord()),
+      _tags{""},
+      _tagIndex{{"", 0}} {}
+
+const char* FrameProfiler::phaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::PcmDrain:
+            return "pcm_drain";
+        case FramePhase::Render:
+            return "render";
+        case FramePhase::Overlays:
+            return "overlays";
+        case FramePhase::Swap:
+            return "swap";
+        case FramePhase::Events:
+            return "events";
+        case FramePhase::Housekeeping:
+            return "housekeeping";
+        default:
+            return "unknown";
+    }
+}
+
+bool FrameProfiler::isGpuPhase(FramePhase phase) {
+    return phase == FramePhase::Render || phase == FramePhase::Overlays;
+}
+
+void FrameProfiler::setGpuTimer(std::unique_ptr<GpuTimer> timer) {
+    if (_gpuActive) {
+        _gpuTimer->end();
+        _gpuActive = false;
+    }
+    if (timer && timer->getSlotCount() < GPU_FRAMES_IN_FLIGHT * FRAME_PHASE_COUNT) {
+        timer.reset();
+    }
+    _gpuTimer = std::move(timer);
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+    if (!enabled && _inFrame) {
+        if (_gpuActive) {
+            _gpuTimer->end();
+            _gpuActive = false;
+        }
+        _inFrame = false;
+    }
+    _enabled = enabled;
+}
+
+void FrameProfiler::setTag(const std::string& tag) {
+    // Hashed, so switching between many presets stays O(1) and only a new tag allocates
+    const auto it = _tagIndex.find(tag);
+    if (it != _tagIndex.end()) {
+        _tag = it->second;
+    } else {
+        _tag = static_cast<uint32_t>(_tags.size());
+        _tags.push_back(tag);
+        _tagIndex.emplace(tag, _tag);
+    }
+    _current.tag = _tag;
+}
+
+const std::string& FrameProfiler::getTagName(uint32_t tag) const {
+    return tag < _tags.size() ? _tags[tag] : _tags.front();
+}
+
+size_t FrameProfiler::gpuSlot(uint64_t frame, FramePhase phase) const {
+    return static_cast<size_t>(frame % GPU_FRAMES_IN_FLIGHT) * FRAME_PHASE_COUNT + static_cast<size_t>(phase);
+}
+
+void FrameProfiler::resolveGpuResults(uint64_t frame) {
+    if (!_gpuTimer || frame >= _frames) {
+        return;
+    }
+    FrameRecord& record = _records[frame % _records.size()];
+    if (record.frame != frame) {
+        return;
+    }
+    for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        const FramePhase phase = static_cast<FramePhase>(i);
+        double ms = 0.0;
+        if (isGpuPhase(phase) && _gpuTimer->poll(gpuSlot(frame, phase), ms)) {
+            record.gpu_ms[i] = ms;
+        }
+    }
+}
+
+void FrameProfiler::notifyFrame(uint64_t frame) {
+    const FrameRecord& record = _records[frame % _records.size()];
+    if (frame < _nextNotify || record.frame != frame) {
+        return;
+    }
+    _nextNotify = frame + 1;
+    for (const auto& listener : _frameListeners) {
+        listener(record);
+    }
+}
+
+void FrameProfiler::beginFrame() {
+    if (!_enabled) {
+        return;
+    }
+    if (_inFrame) {
+        endFrame();
+    }
+
+    // Last chance for the frame whose query slots this one is about to reuse; the previous frame may be early
+    for (uint64_t back = GPU_FRAMES_IN_FLIGHT; back > 0; --back) {
+        if (_frames >= back) {
+            resolveGpuResults(_frames - back);
+        }
+    }
+    if (_gpuTimer && _frames >= GPU_FRAMES_IN_FLIGHT) {
+        notifyFrame(_frames - GPU_FRAMES_IN_FLIGHT);
+    }
+
+    _current = emptyRecord();
+    _current.frame = _frames;
+    _current.tag = _tag;
+    _inFrame = true;
+    _frameStart = _now();
+}
+
+void FrameProfiler::endFrame() {
+    if (!_enabled || !_inFrame) {
+        return;
+    }
+    if (_gpuActive) {
+        _gpuTimer->end();
+        _gpuActive = false;
+    }
+    _current.total_ms = msSince(_frameStart, _now());
+    static ::AutoVibez::Utils::MetricHistogram& frameTimes = ::AutoVibez::Utils::MetricsRegistry::instance().histogram(
+        "autovibez_frame_time_ms", "Wall time of each frame", {4, 8, 12, 16.7, 20, 25, 33.4, 50, 100, 250});
+    frameTimes.observe(_current.total_ms);
+    _records[_frames % _records.size()] = _current;
+    ++_frames;
+    _inFrame = false;
+    if (!_gpuTimer) {
+        notifyFrame(_frames - 1);
+    }
+}
+
+void FrameProfiler::beginPhase(FramePhase phase) {
+    if (!_enabled || !_inFrame || phase >= FramePhase::Count) {
+        return;
+    }
+    const size_t index = static_cast<size_t>(phase);
+    // One query per phase and frame, and queries cannot nest
+    if (_gpuTimer && isGpuPhase(phase) && !_gpuActive && _current.gpu_ms[index] < 0.0) {
+        _gpuTimer->begin(gpuSlot(_current.frame, phase));
+        _gpuActive = true;
+        _gpuPhase = phase;
+        _current.gpu_ms[index] = 0.0;  // Marks the slot as used; the result replaces it two frames later
+    }
+    _phaseStart[index] = _now();
+}
+
+void FrameProfiler::endPhase(FramePhase phase) {
+    if (!_enabled || !_inFrame || phase >= FramePhase::Count) {
+        return;
+    }
+    const size_t index = static_cast<size_t>(phase);
+    const double elapsed = msSince(_phaseStart[index], _now());
+    _current.cpu_ms[index] = std::max(0.0, _current.cpu_ms[index]) + elapsed;
+    if (_gpuActive && _gpuPhase == phase) {
+        _gpuTimer->end();
+        _gpuActive = false;
+    }
+}
+
+size_t FrameProfiler::getSampleCount() const {
+    return static_cast<size_t>(std::min<uint64_t>(_frames, _records.size()));
+}
+
+template <typename Select>
+PhasePercentiles FrameProfiler::percentiles(Select select) const {
+    std::vector<double> values;
+    values.reserve(getSampleCount());
+    for (uint64_t frame = _frames - getSampleCount(); frame < _frames; ++frame) {
+        const double value = select(_records[frame % _records.size()]);
+        if (value >= 0.0) {
+            values.push_back(value);
+        }
+    }
+
+    PhasePercentiles result;
+    result.samples = values.size();
+    if (values.empty()) {
+        return result;
+    }
+    std::sort(values.begin(), values.end());
+    result.p50_ms = rank(values, 0.50);
+    result.p95_ms = rank(values, 0.95);
+    result.p99_ms = rank(values, 0.99);
+    result.max_ms = values.back();
+    return result;
+}
+
+PhasePercentiles FrameProfiler::getCpuPercentiles(FramePhase phase) const {
+    const size_t index = static_cast<size_t>(phase);
+    return percentiles([index](const FrameRecord& record) { return record.cpu_ms[index]; });
+}
+
+PhasePercentiles FrameProfiler::getGpuPercentiles(FramePhase phase) const {
+    const size_t index = static_cast<size_t>(phase);
+    // A slot still marked 0 never got its result back
+    return percentiles([index](const FrameRecord& record) {
+        return record.gpu_ms[index] > 0.0 ? record.gpu_ms[index] : -1.0;
+    });
+}
+
+PhasePercentiles FrameProfiler::getFramePercentiles() const {
+    return percentiles([](const FrameRecord& record) { return record.total_ms; });
+}
+
+void FrameProfiler::getFrameHistory(std::vector<float>& out) const {
+    out.clear();
+    for (uint64_t frame = _frames - getSampleCount(); frame < _frames; ++frame) {
+        out.push_back(static_cast<float>(_records[frame % _records.size()].total_ms));
+    }
+}
+
+void FrameProfiler::writeCsv(std::ostream& out) const {
+    out << "frame,preset,total_ms";
+    for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        out << ',' << phaseName(static_cast<FramePhase>(i)) << "_ms";
+    }
+    for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        if (isGpuPhase(static_cast<FramePhase>(i))) {
+            out << ',' << phaseName(static_cast<FramePhase>(i)) << "_gpu_ms";
+        }
+    }
+    out << '\n';
+
+    for (uint64_t frame = _frames - getSampleCount(); frame < _frames; ++frame) {
+        const FrameRecord& record = _records[frame % _records.size()];
+        out << record.frame << ',';
+        writeCsvField(out, getTagName(record.tag));
+        writeCsvTime(out, record.total_ms);
+        for (double ms : record.cpu_ms) {
+            writeCsvTime(out, ms);
+        }
+        for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+            if (isGpuPhase(static_cast<FramePhase>(i))) {
+                writeCsvTime(out, record.gpu_ms[i] > 0.0 ? record.gpu_ms[i] : -1.0);
+            }
+        }
+        out << '\n';
+    }
+}
+
+bool FrameProfiler::writeCsv(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        setError("Cannot open profile file: " + path);
+        return false;
+    }
+    writeCsv(out);
+    if (!out.good()) {
+        setError("Failed to write profile file: " + path);
+        return false;
+    }
+    setSuccess(true);
+    return true;
+}
+
+}  // namespace AutoVibez::Core
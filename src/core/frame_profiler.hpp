@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+#include "gpu_timer.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief The timed stages of one main-loop iteration, in loop order
+ */
+enum class FramePhase : size_t {
+    PcmDrain,      //!< Ring buffer to projectM, beat tracking
+    Render,        //!< projectm_opengl_render_frame (CPU and GPU)
+    Overlays,      //!< ImGui overlay compositing (CPU and GPU)
+    Swap,          //!< SDL_GL_SwapWindow, which blocks on the display under vsync
+    Events,        //!< pollEvents
+    Housekeeping,  //!< Mix manager autoplay, crossfade, lookahead and download cleanup
+    Count
+};
+
+constexpr size_t FRAME_PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+
+/**
+ * @brief Distribution of one measurement over the profiling window, in milliseconds
+ */
+struct PhasePercentiles {
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    size_t samples = 0;  //!< Frames the phase ran in (0 leaves the other fields at 0)
+};
+
+/**
+ * @brief Timings of one frame; a negative time means the phase did not run or has no GPU result
+ */
+struct FrameRecord {
+    uint64_t frame = 0;
+    uint32_t tag = 0;     //!< Index into the profiler's tags (the preset that was showing)
+    double total_ms = 0;  //!< beginFrame() to endFrame(), excluding the pacing wait
+    std::array<double, FRAME_PHASE_COUNT> cpu_ms{};
+    std::array<double, FRAME_PHASE_COUNT> gpu_ms{};
+};
+
+/**
+ * @brief Per-phase CPU and GPU timings of the main loop over a rolling window
+ *
+ * Each phase is bracketed by a Scope. CPU time comes from steady_clock; phases
+ * that submit GL work (isGpuPhase) are also wrapped in a timer query. Queries are
+ * double-buffered by frame parity and read back two frames later, just before
+ * their slots are reused, so the CPU never waits on the GPU; a result that is
+ * still not ready then is dropped instead. The last FRAME_PROFILE_WINDOW frames
+ * are kept for percentiles and the CSV dump. Not thread-safe: render thread only.
+ */
+class FrameProfiler : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using NowFunction = std::function<Clock::time_point()>;
+    using FrameListener = std::function<void(const FrameRecord&)>;
+
+    /**
+     * @brief Times one phase for as long as it lives
+     */
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, FramePhase phase) : _profiler(profiler), _phase(phase) {
+            _profiler.beginPhase(_phase);
+        }
+        ~Scope() {
+            _profiler.endPhase(_phase);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler& _profiler;
+        FramePhase _phase;
+    };
+
+    /**
+     * @brief Create a profiler
+     * @param window Frames kept for statistics (at least 2)
+     * @param now Clock to read; defaults to steady_clock
+     */
+    explicit FrameProfiler(size_t window = Constants::FRAME_PROFILE_WINDOW, NowFunction now = nullptr);
+
+    static const char* phaseName(FramePhase phase);
+
+    /**
+     * @brief Whether a phase issues GL work worth a GPU timer query
+     */
+    static bool isGpuPhase(FramePhase phase);
+
+    /**
+     * @brief Use a GPU timer; it needs 2 * FRAME_PHASE_COUNT slots, otherwise GPU timing stays off
+     */
+    void setGpuTimer(std::unique_ptr<GpuTimer> timer);
+    bool hasGpuTimer() const {
+        return _gpuTimer != nullptr;
+    }
+
+    /**
+     * @brief Stop or resume recording; while disabled every call returns immediately
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const {
+        return _enabled;
+    }
+
+    /**
+     * @brief Label the following frames (the active preset), reported in the CSV
+     */
+    void setTag(const std::string& tag);
+
+    /**
+     * @brief The tag a record refers to (empty for an unknown index)
+     */
+    const std::string& getTagName(uint32_t tag) const;
+
+    /**
+     * @brief Receive each frame once its timings are final: at endFrame() without a GPU timer, otherwise two
+     * frames later when its queries are read back (a GPU time still 0 then never arrived). Listeners are called
+     * in the order they were added.
+     */
+    void addFrameListener(FrameListener listener) {
+        _frameListeners.push_back(std::move(listener));
+    }
+
+    void beginFrame();
+    void endFrame();
+    void beginPhase(FramePhase phase);
+    void endPhase(FramePhase phase);
+
+    PhasePercentiles getCpuPercentiles(FramePhase phase) const;
+    PhasePercentiles getGpuPercentiles(FramePhase phase) const;
+    PhasePercentiles getFramePercentiles() const;
+
+    /**
+     * @brief Frames currently held in the window
+     */
+    size_t getSampleCount() const;
+
+    /**
+     * @brief Frame totals in the window, oldest first (for plotting)
+     */
+    void getFrameHistory(std::vector<float>& out) const;
+
+    /**
+     * @brief Write the window as CSV, one row per frame, oldest first
+     */
+    void writeCsv(std::ostream& out) const;
+
+    /**
+     * @brief Write the window to a CSV file
+     * @return True on success; the error is available from getLastError() otherwise
+     */
+    bool writeCsv(const std::string& path);
+
+private:
+    template <typename Select>
+    PhasePercentiles percentiles(Select select) const;
+    void resolveGpuResults(uint64_t frame);
+    void notifyFrame(uint64_t frame);
+    size_t gpuSlot(uint64_t frame, FramePhase phase) const;
+
+    NowFunction _now;
+    std::unique_ptr<GpuTimer> _gpuTimer;
+    bool _enabled = true;
+
+    std::vector<FrameRecord> _records;  // Ring: frame f lives at f % size
+    uint64_t _frames = 0;               // Frames committed so far
+    FrameRecord _current;
+    bool _inFrame = false;
+    Clock::time_point _frameStart;
+    std::array<Clock::time_point, FRAME_PHASE_COUNT> _phaseStart{};
+    bool _gpuActive = false;
+    FramePhase _gpuPhase = FramePhase::Render;
+
+    std::vector<std::string> _tags;
+    std::unordered_map<std::string, uint32_t> _tagIndex;  // Tag name to its index in _tags
+    uint32_t _tag = 0;
+    std::vector<FrameListener> _frameListeners;
+    uint64_t _nextNotify = 0;  // Frames before this were already reported
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,112 @@
+#include "frame_readback.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstring>
+
+#include "gl_entry_points.hpp"
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+GlEntryPoints& entryPoints = GlEntryPoints::get();
+
+bool hasPixelBuffers() {
+#ifdef USE_GLES
+    return true;  // Core in GLES 3.0
+#else
+    int major = 0;
+    SDL_GL_GetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, &major);
+    return major >= 3 || (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object") &&
+                          SDL_GL_ExtensionSupported("GL_ARB_map_buffer_range"));
+#endif
+}
+}  // namespace
+
+std::unique_ptr<FrameReadback> FrameReadback::create(int width, int height, size_t depth) {
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+    std::unique_ptr<FrameReadback> readback(new FrameReadback());
+    readback->_width = width;
+    readback->_height = height;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (depth > 0 && hasPixelBuffers() && entryPoints.loadPixelBuffers()) {
+        std::vector<GLuint> buffers(depth, 0);
+        entryPoints.genBuffers(static_cast<GLsizei>(depth), buffers.data());
+        for (GLuint buffer : buffers) {
+            entryPoints.bindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+            entryPoints.bufferData(GL_PIXEL_PACK_BUFFER, static_cast<ptrdiff_t>(readback->getFrameBytes()), nullptr,
+                                   GL_STREAM_READ);
+        }
+        entryPoints.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback->_buffers.assign(buffers.begin(), buffers.end());
+        readback->_memory.set(depth * readback->getFrameBytes());
+    }
+    return readback;
+}
+
+bool FrameReadback::push(std::vector<uint8_t>& frame) {
+    if (_buffers.empty()) {
+        std::vector<uint8_t> rows(getFrameBytes());
+        glReadPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, rows.data());
+        copyFlipped(rows.data(), _width, _height, frame);
+        return true;
+    }
+
+    // The slot about to be reused holds the oldest frame
+    bool retired = false;
+    if (_queued == _buffers.size()) {
+        retire(_next, frame);
+        retired = true;
+    }
+    entryPoints.bindBuffer(GL_PIXEL_PACK_BUFFER, _buffers[_next]);
+    glReadPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    entryPoints.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    _next = (_next + 1) % _buffers.size();
+    ++_queued;
+    return retired;
+}
+
+bool FrameReadback::pop(std::vector<uint8_t>& frame) {
+    if (_queued == 0) {
+        return false;
+    }
+    retire((_next + _buffers.size() - _queued) % _buffers.size(), frame);
+    return true;
+}
+
+void FrameReadback::retire(size_t slot, std::vector<uint8_t>& frame) {
+    entryPoints.bindBuffer(GL_PIXEL_PACK_BUFFER, _buffers[slot]);
+    const void* rows = entryPoints.mapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                  static_cast<ptrdiff_t>(getFrameBytes()), GL_MAP_READ_BIT);
+    if (rows) {
+        copyFlipped(static_cast<const uint8_t*>(rows), _width, _height, frame);
+        entryPoints.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        frame.assign(getFrameBytes(), 0);
+    }
+    entryPoints.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    --_queued;
+}
+
+void FrameReadback::copyFlipped(const uint8_t* rows, int width, int height, std::vector<uint8_t>& image) {
+    const size_t stride = static_cast<size_t>(width) * 4;
+    image.resize(stride * height);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(image.data() + stride * y, rows + stride * (height - 1 - y), stride);
+    }
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Reads rendered frames back to the CPU through a ring of pixel buffer objects
+ *
+ * push() starts an asynchronous glReadPixels of the bound read framebuffer into the
+ * next buffer. Only when the ring is full does it map the oldest buffer, which the GPU
+ * finished frames ago, so the render loop never waits on its own frame. Frames come
+ * out in order, top row first, as tightly packed RGBA. Without pixel buffer objects
+ * (GL 2.1 lacking ARB_pixel_buffer_object) every read is synchronous. Entry points come
+ * from SDL_GL_GetProcAddress like GlTimerQueries; the buffers are released with the
+ * context.
+ */
+class FrameReadback {
+public:
+    /**
+     * @brief Allocate the ring in the current context
+     * @param depth Frames in flight before the oldest is mapped
+     */
+    static std::unique_ptr<FrameReadback> create(int width, int height, size_t depth);
+
+    /**
+     * @brief Queue a read of the current frame
+     * @param frame Receives the oldest queued frame when one had to be retired
+     * @return True if frame was filled
+     */
+    bool push(std::vector<uint8_t>& frame);
+
+    /**
+     * @brief Retire the oldest queued frame (to drain the ring at the end)
+     * @return False when nothing is queued
+     */
+    bool pop(std::vector<uint8_t>& frame);
+
+    bool isAsync() const {
+        return !_buffers.empty();
+    }
+    size_t getFrameBytes() const {
+        return static_cast<size_t>(_width) * _height * 4;
+    }
+
+    /**
+     * @brief Copy bottom-up GL rows into a top-down image
+     */
+    static void copyFlipped(const uint8_t* rows, int width, int height, std::vector<uint8_t>& image);
+
+private:
+    FrameReadback() = default;
+
+    void retire(size_t slot, std::vector<uint8_t>& frame);
+
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint32_t> _buffers;
+    size_t _next = 0;    // Slot the next read goes into
+    size_t _queued = 0;  // Reads waiting to be retired
+    Utils::MemoryCharge _memory{Utils::MemoryTag::GpuPixelBuffers};
+};
+
+}  // namespace AutoVibez::Core
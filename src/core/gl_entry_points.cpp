@@ -0,0 +1,58 @@
+#include "gl_entry_points.hpp"
+
+#include <SDL2/SDL.h>
+
+namespace AutoVibez::Core {
+
+namespace {
+template <typename Proc>
+bool resolve(Proc& proc, const char* name) {
+    proc = reinterpret_cast<Proc>(SDL_GL_GetProcAddress(name));
+    return proc != nullptr;
+}
+}  // namespace
+
+GlEntryPoints& GlEntryPoints::get() {
+    static GlEntryPoints entryPoints;
+    return entryPoints;
+}
+
+bool GlEntryPoints::loadPixelBuffers() {
+    return resolve(genBuffers, "glGenBuffers") && resolve(bindBuffer, "glBindBuffer") &&
+           resolve(bufferData, "glBufferData") && resolve(mapBufferRange, "glMapBufferRange") &&
+           resolve(unmapBuffer, "glUnmapBuffer");
+}
+
+bool GlEntryPoints::loadTimerQueries() {
+    return resolve(genQueries, "glGenQueries") && resolve(beginQuery, "glBeginQuery") &&
+           resolve(endQuery, "glEndQuery") && resolve(getQueryObjectiv, "glGetQueryObjectiv") &&
+           resolve(getQueryObjectui64v, "glGetQueryObjectui64v");
+}
+
+bool GlEntryPoints::loadFramebuffers() {
+    return resolve(genFramebuffers, "glGenFramebuffers") && resolve(bindFramebuffer, "glBindFramebuffer") &&
+           resolve(framebufferTexture2D, "glFramebufferTexture2D") &&
+           resolve(checkFramebufferStatus, "glCheckFramebufferStatus") &&
+           resolve(blitFramebuffer, "glBlitFramebuffer");
+}
+
+bool GlEntryPoints::loadShaders() {
+    return resolve(createShader, "glCreateShader") && resolve(shaderSource, "glShaderSource") &&
+           resolve(compileShader, "glCompileShader") && resolve(getShaderiv, "glGetShaderiv") &&
+           resolve(deleteShader, "glDeleteShader") && resolve(createProgram, "glCreateProgram") &&
+           resolve(attachShader, "glAttachShader") && resolve(bindAttribLocation, "glBindAttribLocation") &&
+           resolve(linkProgram, "glLinkProgram") && resolve(getProgramiv, "glGetProgramiv") &&
+           resolve(deleteProgram, "glDeleteProgram") && resolve(getUniformLocation, "glGetUniformLocation") &&
+           resolve(useProgram, "glUseProgram") && resolve(uniform1i, "glUniform1i") &&
+           resolve(uniformMatrix4fv, "glUniformMatrix4fv") && resolve(genBuffers, "glGenBuffers") &&
+           resolve(bindBuffer, "glBindBuffer") && resolve(bufferData, "glBufferData") &&
+           resolve(bufferSubData, "glBufferSubData") && resolve(deleteBuffers, "glDeleteBuffers") &&
+           resolve(genVertexArrays, "glGenVertexArrays") && resolve(bindVertexArray, "glBindVertexArray") &&
+           resolve(deleteVertexArrays, "glDeleteVertexArrays") &&
+           resolve(enableVertexAttribArray, "glEnableVertexAttribArray") &&
+           resolve(vertexAttribPointer, "glVertexAttribPointer") && resolve(activeTexture, "glActiveTexture") &&
+           resolve(blendEquationSeparate, "glBlendEquationSeparate") &&
+           resolve(blendFuncSeparate, "glBlendFuncSeparate");
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+
+#include "opengl.h"
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief The GL functions past 1.1 the renderers call, looked up through SDL_GL_GetProcAddress
+ *
+ * There is one context per process, so one table serves every caller. Each load*() resolves
+ * the group it names and reports whether the context has all of it.
+ */
+struct GlEntryPoints {
+    using GenBuffersProc = void(APIENTRY*)(GLsizei, GLuint*);
+    using BindBufferProc = void(APIENTRY*)(GLenum, GLuint);
+    using BufferDataProc = void(APIENTRY*)(GLenum, GLsizeiptr, const void*, GLenum);
+    using BufferSubDataProc = void(APIENTRY*)(GLenum, GLintptr, GLsizeiptr, const void*);
+    using DeleteBuffersProc = void(APIENTRY*)(GLsizei, const GLuint*);
+    using MapBufferRangeProc = void*(APIENTRY*)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+    using UnmapBufferProc = GLboolean(APIENTRY*)(GLenum);
+
+    using GenQueriesProc = void(APIENTRY*)(GLsizei, GLuint*);
+    using BeginQueryProc = void(APIENTRY*)(GLenum, GLuint);
+    using EndQueryProc = void(APIENTRY*)(GLenum);
+    using GetQueryObjectivProc = void(APIENTRY*)(GLuint, GLenum, GLint*);
+    using GetQueryObjectui64vProc = void(APIENTRY*)(GLuint, GLenum, uint64_t*);
+
+    using GenFramebuffersProc = void(APIENTRY*)(GLsizei, GLuint*);
+    using BindFramebufferProc = void(APIENTRY*)(GLenum, GLuint);
+    using FramebufferTexture2DProc = void(APIENTRY*)(GLenum, GLenum, GLenum, GLuint, GLint);
+    using CheckFramebufferStatusProc = GLenum(APIENTRY*)(GLenum);
+    using BlitFramebufferProc = void(APIENTRY*)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield,
+                                                GLenum);
+
+    using CreateShaderProc = GLuint(APIENTRY*)(GLenum);
+    using ShaderSourceProc = void(APIENTRY*)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+    using CompileShaderProc = void(APIENTRY*)(GLuint);
+    using GetShaderivProc = void(APIENTRY*)(GLuint, GLenum, GLint*);
+    using DeleteShaderProc = void(APIENTRY*)(GLuint);
+    using CreateProgramProc = GLuint(APIENTRY*)();
+    using AttachShaderProc = void(APIENTRY*)(GLuint, GLuint);
+    using BindAttribLocationProc = void(APIENTRY*)(GLuint, GLuint, const GLchar*);
+    using LinkProgramProc = void(APIENTRY*)(GLuint);
+    using GetProgramivProc = void(APIENTRY*)(GLuint, GLenum, GLint*);
+    using DeleteProgramProc = void(APIENTRY*)(GLuint);
+    using GetUniformLocationProc = GLint(APIENTRY*)(GLuint, const GLchar*);
+    using UseProgramProc = void(APIENTRY*)(GLuint);
+    using Uniform1iProc = void(APIENTRY*)(GLint, GLint);
+    using UniformMatrix4fvProc = void(APIENTRY*)(GLint, GLsizei, GLboolean, const GLfloat*);
+    using GenVertexArraysProc = void(APIENTRY*)(GLsizei, GLuint*);
+    using BindVertexArrayProc = void(APIENTRY*)(GLuint);
+    using DeleteVertexArraysProc = void(APIENTRY*)(GLsizei, const GLuint*);
+    using EnableVertexAttribArrayProc = void(APIENTRY*)(GLuint);
+    using VertexAttribPointerProc = void(APIENTRY*)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    using ActiveTextureProc = void(APIENTRY*)(GLenum);
+    using BlendEquationSeparateProc = void(APIENTRY*)(GLenum, GLenum);
+    using BlendFuncSeparateProc = void(APIENTRY*)(GLenum, GLenum, GLenum, GLenum);
+
+    // Buffer objects
+    GenBuffersProc genBuffers = nullptr;
+    BindBufferProc bindBuffer = nullptr;
+    BufferDataProc bufferData = nullptr;
+    BufferSubDataProc bufferSubData = nullptr;
+    DeleteBuffersProc deleteBuffers = nullptr;
+    MapBufferRangeProc mapBufferRange = nullptr;
+    UnmapBufferProc unmapBuffer = nullptr;
+
+    // Timer queries
+    GenQueriesProc genQueries = nullptr;
+    BeginQueryProc beginQuery = nullptr;
+    EndQueryProc endQuery = nullptr;
+    GetQueryObjectivProc getQueryObjectiv = nullptr;
+    GetQueryObjectui64vProc getQueryObjectui64v = nullptr;
+
+    // Framebuffer objects
+    GenFramebuffersProc genFramebuffers = nullptr;
+    BindFramebufferProc bindFramebuffer = nullptr;
+    FramebufferTexture2DProc framebufferTexture2D = nullptr;
+    CheckFramebufferStatusProc checkFramebufferStatus = nullptr;
+    BlitFramebufferProc blitFramebuffer = nullptr;
+
+    // Shaders and vertex arrays
+    CreateShaderProc createShader = nullptr;
+    ShaderSourceProc shaderSource = nullptr;
+    CompileShaderProc compileShader = nullptr;
+    GetShaderivProc getShaderiv = nullptr;
+    DeleteShaderProc deleteShader = nullptr;
+    CreateProgramProc createProgram = nullptr;
+    AttachShaderProc attachShader = nullptr;
+    BindAttribLocationProc bindAttribLocation = nullptr;
+    LinkProgramProc linkProgram = nullptr;
+    GetProgramivProc getProgramiv = nullptr;
+    DeleteProgramProc deleteProgram = nullptr;
+    GetUniformLocationProc getUniformLocation = nullptr;
+    UseProgramProc useProgram = nullptr;
+    Uniform1iProc uniform1i = nullptr;
+    UniformMatrix4fvProc uniformMatrix4fv = nullptr;
+    GenVertexArraysProc genVertexArrays = nullptr;
+    BindVertexArrayProc bindVertexArray = nullptr;
+    DeleteVertexArraysProc deleteVertexArrays = nullptr;
+    EnableVertexAttribArrayProc enableVertexAttribArray = nullptr;
+    VertexAttribPointerProc vertexAttribPointer = nullptr;
+    ActiveTextureProc activeTexture = nullptr;
+    BlendEquationSeparateProc blendEquationSeparate = nullptr;
+    BlendFuncSeparateProc blendFuncSeparate = nullptr;
+
+    /**
+     * @brief The process's table; nothing is resolved until a load*() with the context current
+     */
+    static GlEntryPoints& get();
+
+    /**
+     * @brief Buffers mapped for reading: gen, bind, data, map range and unmap
+     */
+    bool loadPixelBuffers();
+
+    bool loadTimerQueries();
+
+    /**
+     * @brief Framebuffers with a 2D texture attached, and blits between them
+     */
+    bool loadFramebuffers();
+
+    /**
+     * @brief Everything a shader-drawn vertex array needs, buffers included
+     */
+    bool loadShaders();
+};
+
+}  // namespace AutoVibez::Core
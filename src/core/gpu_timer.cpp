@@ -0,0 +1,60 @@
+#include "gpu_timer.hpp"
+
+#include <SDL2/SDL.h>
+
+#include "gl_entry_points.hpp"
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+GlEntryPoints& entryPoints = GlEntryPoints::get();
+}  // namespace
+
+std::unique_ptr<GlTimerQueries> GlTimerQueries::create(size_t slots) {
+    if (slots == 0 || !SDL_GL_ExtensionSupported("GL_ARB_timer_query") || !entryPoints.loadTimerQueries()) {
+        return nullptr;
+    }
+    std::unique_ptr<GlTimerQueries> timer(new GlTimerQueries());
+    std::vector<GLuint> queries(slots, 0);
+    entryPoints.genQueries(static_cast<GLsizei>(slots), queries.data());
+    timer->_queries.assign(queries.begin(), queries.end());
+    timer->_pending.assign(slots, false);
+    return timer;
+}
+
+void GlTimerQueries::begin(size_t slot) {
+    entryPoints.beginQuery(GL_TIME_ELAPSED, _queries[slot]);
+    _pending[slot] = true;
+}
+
+void GlTimerQueries::end() {
+    entryPoints.endQuery(GL_TIME_ELAPSED);
+}
+
+bool GlTimerQueries::poll(size_t slot, double& ms) {
+    if (slot >= _queries.size() || !_pending[slot]) {
+        return false;
+    }
+    GLint available = 0;
+    entryPoints.getQueryObjectiv(_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+    uint64_t nanoseconds = 0;
+    entryPoints.getQueryObjectui64v(_queries[slot], GL_QUERY_RESULT, &nanoseconds);
+    _pending[slot] = false;
+    ms = static_cast<double>(nanoseconds) / 1.0e6;
+    return true;
+}
+
+}  // namespace AutoVibez::Core
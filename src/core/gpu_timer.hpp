@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief A pool of GPU elapsed-time queries addressed by slot
+ *
+ * Only one slot may be timing at a time (GL_TIME_ELAPSED queries cannot nest).
+ * Results are read back without blocking: poll() reports false while the GPU is
+ * still working, so callers keep enough slots in flight to never wait on one.
+ */
+class GpuTimer {
+public:
+    virtual ~GpuTimer() = default;
+
+    virtual size_t getSlotCount() const = 0;
+
+    /**
+     * @brief Start timing GPU work into a slot (its previous result is discarded)
+     */
+    virtual void begin(size_t slot) = 0;
+
+    /**
+     * @brief Stop the slot started by the last begin()
+     */
+    virtual void end() = 0;
+
+    /**
+     * @brief Read a finished slot without stalling
+     * @param ms Receives the GPU time in milliseconds
+     * @return True if a result was available; each begin() yields at most one result
+     */
+    virtual bool poll(size_t slot, double& ms) = 0;
+};
+
+/**
+ * @brief GpuTimer backed by GL_TIME_ELAPSED queries (ARB_timer_query / GL 3.3)
+ *
+ * Entry points are resolved through SDL_GL_GetProcAddress, so the legacy GL
+ * context projectM renders into needs no loader. The queries belong to the
+ * context and are released with it.
+ */
+class GlTimerQueries : public GpuTimer {
+public:
+    /**
+     * @brief Allocate the queries in the current context
+     * @return nullptr when the context has no timer queries
+     */
+    static std::unique_ptr<GlTimerQueries> create(size_t slots);
+
+    size_t getSlotCount() const override {
+        return _queries.size();
+    }
+    void begin(size_t slot) override;
+    void end() override;
+    bool poll(size_t slot, double& ms) override;
+
+private:
+    GlTimerQueries() = default;
+
+    std::vector<uint32_t> _queries;
+    std::vector<bool> _pending;  // Issued and not yet read back
+};
+
+}  // namespace AutoVibez::Core
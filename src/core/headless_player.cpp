@@ -0,0 +1,450 @@
+#include "headless_player.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <csignal>
+#include <utility>
+#include <vector>
+
+#include "console_output.hpp"
+#include "json_utils.hpp"
+#include "path_manager.hpp"
+#include "sqlite_connection.hpp"
+#include "trace_recorder.hpp"
+#include "utils/logger.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using AutoVibez::Data::AppConfig;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixManager;
+
+namespace AutoVibez::Core {
+
+namespace {
+
+constexpr int STOP_SIGNALS[] = {SIGINT, SIGTERM};
+
+#ifndef _WIN32
+std::atomic<int> g_signalWake{-1};  // Write end of the running player's pipe
+
+void onStopSignal(int) {
+    const int fd = g_signalWake.load();
+    if (fd >= 0) {
+        const char byte = 1;
+        [[maybe_unused]] const ssize_t wrote = write(fd, &byte, 1);
+    }
+}
+#else
+std::atomic<HeadlessPlayer*> g_signalPlayer{nullptr};
+
+// Windows runs the handler on a thread of its own, so it may take the player's lock
+void onStopSignal(int signal) {
+    if (HeadlessPlayer* player = g_signalPlayer.load()) {
+        player->requestStop();
+    }
+    std::signal(signal, onStopSignal);
+}
+#endif
+
+}  // namespace
+
+HeadlessPlayer::HeadlessPlayer(std::shared_ptr<AppStartup> startup) : _startup(std::move(startup)) {
+#ifndef _WIN32
+    int fds[2];
+    if (pipe(fds) == 0) {
+        _wakeRead = fds[0];
+        _wakeWrite = fds[1];
+        fcntl(_wakeWrite, F_SETFL, O_NONBLOCK);  // A full pipe already means stop
+    }
+#endif
+}
+
+HeadlessPlayer::~HeadlessPlayer() {
+    // Downloads and retry waits give up rather than hold up the joins below
+    _shutdownToken.cancel();
+    _remoteControl.stop();
+    _mixControl.stop();
+    _metricsExporter.stop();
+
+    // The control thread has joined, so the mix manager is safe to touch from here
+    if (_mixManager) {
+        _mixManager->stop();
+        _mixManager.reset();
+    }
+    if (_sdlAudio) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+#ifndef _WIN32
+    if (_wakeRead >= 0) {
+        close(_wakeRead);
+        close(_wakeWrite);
+    }
+#endif
+}
+
+bool HeadlessPlayer::start() {
+    AUTOVIBEZ_TRACE_SCOPE("startup", "HeadlessPlayer");
+    // Ours are installed around run(), where a signal only wakes the wait
+    SDL_SetHint(SDL_HINT_NO_SIGNAL_HANDLERS, "1");
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logError("Failed to initialize SDL audio: " + std::string(SDL_GetError()));
+        return false;
+    }
+    _sdlAudio = true;
+
+    _startup->graph.wait(AppStartup::CONFIG_TASK);
+    const AppConfig* config = _startup->config.get();
+    if (config) {
+        if (!config->metrics_statsd.empty() || !config->metrics_textfile.empty()) {
+            if (!_metricsExporter.start(config->metrics_statsd, config->metrics_textfile)) {
+                ::AutoVibez::Utils::Logger logger;
+                logger.logWarning("Metrics export disabled: " + _metricsExporter.getLastError());
+            }
+        }
+
+        const int port = config->remote_control_port;
+        if (port > 0 && port <= 65535) {
+            // With no frames to coalesce them in, actions go straight to the control thread
+            const bool started = _remoteControl.start(
+                static_cast<uint16_t>(port), config->remote_control_token,
+                [this](KeyAction action) { return _mixControl.post([this, action]() { runAction(action); }); });
+            ::AutoVibez::Utils::Logger logger;
+            if (!started) {
+                logger.logWarning("Remote control disabled: " + _remoteControl.getLastError());
+            } else if (config->remote_control_token.empty()) {
+                logger.logWarning("Remote control on port " + std::to_string(port) +
+                                  " accepts anyone on the network");
+            }
+        }
+    }
+
+    // Opening the database and syncing the manifest run on the control thread, then autoplay starts a mix
+    _mixControl.post([this]() {
+        initMixManager();
+        if (_mixManagerInitialized && !_mixManager->isPlaying() && !_mixManager->isPaused()) {
+            autoPlay();
+        }
+    });
+    _mixControl.start([this]() { runHousekeeping(); },
+                      std::chrono::milliseconds(Constants::HEADLESS_CONTROL_INTERVAL_MS));
+    return true;
+}
+
+void HeadlessPlayer::run() {
+#ifndef _WIN32
+    std::vector<std::pair<int, struct sigaction>> previous;
+    g_signalWake.store(_wakeWrite);
+    for (int signal : STOP_SIGNALS) {
+        struct sigaction action {};
+        action.sa_handler = onStopSignal;
+        action.sa_flags = SA_RESTART;  // A worker the signal lands on carries on with its read
+        sigemptyset(&action.sa_mask);
+        previous.emplace_back(signal, action);
+        sigaction(signal, &action, &previous.back().second);
+    }
+
+    // No timeout: nothing here runs until a byte arrives
+    pollfd wake{_wakeRead, POLLIN, 0};
+    while (!_stopRequested.load() && _wakeRead >= 0) {
+        if (poll(&wake, 1, -1) > 0) {
+            char byte;
+            [[maybe_unused]] const ssize_t got = read(_wakeRead, &byte, 1);
+            _stopRequested.store(true);
+        }
+    }
+
+    g_signalWake.store(-1);
+    for (const auto& [signal, action] : previous) {
+        sigaction(signal, &action, nullptr);
+    }
+#else
+    std::vector<std::pair<int, void (*)(int)>> previous;
+    g_signalPlayer.store(this);
+    for (int signal : STOP_SIGNALS) {
+        previous.emplace_back(signal, std::signal(signal, onStopSignal));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_stopMutex);
+        _stop.wait(lock, [this]() { return _stopRequested.load(); });
+    }
+
+    g_signalPlayer.store(nullptr);
+    for (const auto& [signal, handler] : previous) {
+        std::signal(signal, handler);
+    }
+#endif
+    AutoVibez::Utils::ConsoleOutput::info("Stopping playback...");
+}
+
+void HeadlessPlayer::requestStop() {
+    {
+        std::lock_guard<std::mutex> lock(_stopMutex);
+        _stopRequested.store(true);
+    }
+    _stop.notify_all();
+#ifndef _WIN32
+    if (_wakeWrite >= 0) {
+        const char byte = 1;
+        [[maybe_unused]] const ssize_t wrote = write(_wakeWrite, &byte, 1);
+    }
+#endif
+}
+
+void HeadlessPlayer::initMixManager() {
+    AUTOVIBEZ_TRACE_SCOPE("mixes", "HeadlessPlayer::initMixManager");
+
+    _mixManager = std::make_unique<MixManager>(PathManager::getStateDirectory() + "/autovibez_mixes.db",
+                                               PathManager::getMixesDirectory());
+    _mixManager->setCancellationToken(_shutdownToken);
+
+    // No overlay to show them on; the console gets them instead
+    _mixManager->setMessageHandler([](const AutoVibez::Utils::NamedMessageConfig& message) {
+        if (message.formatter) {
+            AutoVibez::Utils::ConsoleOutput::info(AutoVibez::Utils::OverlayMessages::format(message));
+        }
+    });
+
+    const AppConfig* config = _startup->config.get();
+    if (config) {
+        AutoVibez::Data::SqliteTuning tuning = AutoVibez::Data::SqliteTuning::fast();
+        if (!AutoVibez::Data::SqliteTuning::parseProfile(config->mix_database_profile, tuning)) {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown mix_database_profile '" + config->mix_database_profile + "', using fast");
+        }
+        _mixManager->setDatabaseTuning(tuning);
+        _mixManager->setSharedCatalogEnabled(config->shared_catalog);
+        _eventDrivenLoop = config->event_driven_loop;
+        if (_eventDrivenLoop) {
+            _mixManager->setWakeHandler([this]() { _mixControl.wake(); });
+        }
+        _mixManager->setMixSync(config->mix_sync_url, config->mix_sync_interval_seconds);
+        if (config->resume_playback) {
+            _mixManager->setResumeStatePath(PathManager::getResumeStatePath());
+        }
+    }
+
+    const bool resumed = _mixManager->resumePlayback();
+    if (resumed) {
+        _currentMix = _mixManager->getCurrentMix();
+        AutoVibez::Utils::ConsoleOutput::mixInfo(_currentMix.artist, _currentMix.title, _currentMix.genre);
+    }
+
+    if (!_mixManager->initialize()) {
+        AutoVibez::Utils::ConsoleOutput::error("Failed to open the mix database: " + _mixManager->getLastError());
+        return;
+    }
+
+    std::string yaml_url;
+    if (config) {
+        if (!resumed) {
+            _mixManager->setCurrentGenre(config->preferred_genre);
+        }
+        _mixManager->setStreamingEnabled(config->stream_while_downloading);
+        _mixManager->setPlayQueueDepth(config->play_queue_depth);
+        _mixManager->setSimilarMixProbability(config->similar_mix_probability);
+        _mixManager->setStreamStartBytes(static_cast<int64_t>(config->stream_start_kb) * 1024);
+        _mixManager->setPlayingDownloadLimit(static_cast<int64_t>(config->playing_download_limit_kb) * 1024);
+        _mixManager->setMixCacheQuota(static_cast<int64_t>(config->mix_cache_quota_gb) * 1024 * 1024 * 1024);
+        _mixManager->setLoudnessNormalization(config->loudness_normalization, config->loudness_target_lufs);
+        _mixManager->setPeerCacheEnabled(config->peer_cache);
+        _seekIncrement = config->seek_increment;
+        yaml_url = config->mixes_url;
+    }
+    _mixManagerInitialized = true;
+
+    if (!yaml_url.empty()) {
+        _startup->graph.wait(AppStartup::MANIFEST_TASK);
+        const bool loaded = _startup->manifest_loaded
+                                ? _mixManager->syncMixMetadata(yaml_url, std::move(_startup->manifest_mixes),
+                                                               _startup->manifest_unchanged)
+                                : _mixManager->loadMixMetadata(yaml_url);
+        if (loaded) {
+            _mixManager->checkForNewMixes(yaml_url);
+            if (config->auto_download) {
+                _mixManager->downloadMissingMixesBackground();
+            }
+        }
+    }
+
+    // The sound server probe shells out, so it is picked up only once the mixes are under way
+    _startup->graph.wait(AppStartup::VOLUME_TASK);
+    _volumeController = std::move(_startup->volume_controller);
+}
+
+void HeadlessPlayer::autoPlay() {
+    Mix mix = _mixManager->getSmartRandomMix("", _mixManager->getCurrentGenre());
+    if (mix.id.empty()) {
+        mix = _mixManager->getRandomMix("");
+    }
+    if (!mix.id.empty() && _mixManager->playMix(mix)) {
+        _currentMix = mix;
+        AutoVibez::Utils::ConsoleOutput::mixInfo(mix.artist, mix.title, mix.genre);
+        return;
+    }
+    // Nothing downloaded yet: start a catalogue mix while it downloads, or the housekeeping tick tries again
+    if (_mixManager->isStreamingEnabled()) {
+        mix = _mixManager->getRandomAvailableMix();
+        if (!mix.id.empty() && _mixManager->downloadAndPlayMix(mix)) {
+            _currentMix = mix;
+            AutoVibez::Utils::ConsoleOutput::mixInfo(mix.artist, mix.title, mix.genre);
+        }
+    }
+}
+
+bool HeadlessPlayer::playNext() {
+    for (int attempt = 0; attempt < Constants::AUTO_PLAY_ATTEMPTS; ++attempt) {
+        Mix next = _mixManager->takeNextMix();
+        if (next.id.empty()) {
+            return false;
+        }
+        if (attempt > 0) {
+            AutoVibez::Utils::ConsoleOutput::warning("Failed to play mix, trying another...");
+        }
+        AutoVibez::Utils::ConsoleOutput::mixInfo(next.artist, next.title, next.genre);
+        if (_mixManager->downloadAndPlayMix(next)) {
+            _currentMix = next;
+            return true;
+        }
+    }
+    return false;
+}
+
+void HeadlessPlayer::runHousekeeping() {
+    if (!_mixManagerInitialized) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (_mixManager->hasFinished()) {
+        playNext();
+    } else if (now - _lastAutoPlayCheck > std::chrono::milliseconds(Constants::DEFAULT_CHECK_INTERVAL_MS)) {
+        _lastAutoPlayCheck = now;
+        if (!_mixManager->isPlaying() && !_mixManager->isPaused() && !playNext() && _currentMix.id.empty()) {
+            autoPlay();
+        }
+    }
+
+    _mixManager->updateCrossfade();
+    if (_mixManager->updatePrefetch()) {
+        _currentMix = _mixManager->getCurrentMix();
+        AutoVibez::Utils::ConsoleOutput::mixInfo(_currentMix.artist, _currentMix.title, _currentMix.genre);
+    }
+    _mixManager->updateQueueDownloads();
+    _mixManager->updateDownloadBandwidth();
+    _mixManager->updateSharedCatalog();
+    _mixManager->updateResumeState();
+    _mixManager->updateMaintenance();
+
+    publishNowPlaying();
+
+    // Mix endings, settled downloads and remote commands wake the thread before these
+    if (_eventDrivenLoop) {
+        _mixControl.tickBy(now + std::chrono::milliseconds(Constants::MIX_CONTROL_IDLE_INTERVAL_MS));
+        _mixControl.tickBy(_mixManager->getNextUpdate());
+        if (!_mixManager->isPlaying() && !_mixManager->isPaused()) {
+            _mixControl.tickBy(_lastAutoPlayCheck + std::chrono::milliseconds(Constants::DEFAULT_CHECK_INTERVAL_MS));
+        }
+    }
+}
+
+void HeadlessPlayer::runAction(KeyAction action) {
+    if (!_mixManagerInitialized) {
+        return;
+    }
+    switch (action) {
+        case KeyAction::NEXT_MIX:
+        case KeyAction::PREVIOUS_MIX: {
+            Mix mix = action == KeyAction::NEXT_MIX ? _mixManager->getNextMix(_currentMix.id)
+                                                     : _mixManager->getPreviousMix(_currentMix.id);
+            if (!mix.id.empty() && _mixManager->downloadAndPlayMix(mix)) {
+                _currentMix = mix;
+                AutoVibez::Utils::ConsoleOutput::mixInfo(mix.artist, mix.title, mix.genre);
+            }
+            break;
+        }
+        case KeyAction::RANDOM_MIX_CURRENT_GENRE:
+        case KeyAction::RANDOM_GENRE_AND_MIX: {
+            const std::string genre = action == KeyAction::RANDOM_GENRE_AND_MIX ? _mixManager->getRandomGenre()
+                                                                                 : _currentMix.genre;
+            Mix mix = genre.empty() ? Mix() : _mixManager->getRandomMixByGenre(genre, _currentMix.id);
+            if (!mix.id.empty() && _mixManager->downloadAndPlayMix(mix)) {
+                _currentMix = mix;
+                AutoVibez::Utils::ConsoleOutput::mixInfo(mix.artist, mix.title, mix.genre);
+            }
+            break;
+        }
+        case KeyAction::TOGGLE_FAVORITE:
+            if (!_currentMix.id.empty() && _mixManager->toggleFavorite(_currentMix.id)) {
+                _currentMix.is_favorite = !_currentMix.is_favorite;
+                AutoVibez::Utils::ConsoleOutput::info(
+                    (_currentMix.is_favorite ? "Added to favorites: " : "Removed from favorites: ") +
+                    _currentMix.title);
+            }
+            break;
+        case KeyAction::PAUSE_RESUME_MIX:
+            _mixManager->togglePause();
+            break;
+        case KeyAction::SEEK_FORWARD:
+        case KeyAction::SEEK_BACKWARD:
+            _mixManager->seekBy(action == KeyAction::SEEK_FORWARD ? _seekIncrement : -_seekIncrement);
+            break;
+        case KeyAction::TOGGLE_MUTE: {
+            const int volume = _mixManager->getVolume();
+            if (volume > 0) {
+                _previousVolume = volume;
+            }
+            _mixManager->setVolume(volume > 0 ? 0 : _previousVolume, true);
+            break;
+        }
+        case KeyAction::VOLUME_UP:
+        case KeyAction::VOLUME_DOWN: {
+            const int step =
+                action == KeyAction::VOLUME_UP ? Constants::VOLUME_STEP_SIZE : -Constants::VOLUME_STEP_SIZE;
+            // The sound server's volume where there is one, as on the visualizer; else the player's own
+            if (_volumeController && _volumeController->isAvailable()) {
+                if (step > 0) {
+                    _volumeController->increaseVolume(step);
+                } else {
+                    _volumeController->decreaseVolume(-step);
+                }
+            } else {
+                _mixManager->setVolume(std::clamp(_mixManager->getVolume() + step, 0, Constants::MAX_VOLUME), true);
+            }
+            break;
+        }
+        default:
+            // Presets, overlays and the rest of the visuals do not exist here
+            break;
+    }
+}
+
+void HeadlessPlayer::publishNowPlaying() {
+    if (!_remoteControl.isRunning()) {
+        return;
+    }
+    using AutoVibez::Utils::JsonUtils;
+    // The queue is copied out only when it changed since the last publish
+    _comingUp.update(_mixManager->getPlayQueueRevision(), [this]() { return _mixManager->getUpcomingMixes(); });
+    std::string json = "{\"id\":\"" + JsonUtils::escapeJsonString(_currentMix.id) + '"';
+    json += ",\"title\":\"" + JsonUtils::escapeJsonString(_currentMix.title) + '"';
+    json += ",\"artist\":\"" + JsonUtils::escapeJsonString(_currentMix.artist) + '"';
+    json += ",\"genre\":\"" + JsonUtils::escapeJsonString(_currentMix.genre) + '"';
+    json += std::string(",\"playing\":") + (_mixManager->isPlaying() ? "true" : "false");
+    json += std::string(",\"paused\":") + (_mixManager->isPaused() ? "true" : "false");
+    json += ",\"volume\":" + std::to_string(_mixManager->getVolume());
+    json += ",\"coming_up\":" + JsonUtils::vectorToJsonArray(_comingUp.get()) + '}';
+    if (json != _publishedNowPlaying) {
+        _remoteControl.publish("now_playing", json);
+        _publishedNowPlaying = std::move(json);
+    }
+}
+
+}  // namespace AutoVibez::Core
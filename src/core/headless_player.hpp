@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "app_startup.hpp"
+#include "cancellation_token.hpp"
+#include "key_binding_manager.hpp"
+#include "metrics_exporter.hpp"
+#include "mix_control_thread.hpp"
+#include "mix_manager.hpp"
+#include "remote_control_server.hpp"
+#include "system_volume_controller.hpp"
+#include "upcoming_titles.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief The auto-DJ without a screen: mix selection, downloads and crossfades feeding the audio output
+ *
+ * Only SDL's audio subsystem is brought up; no window, GL context, projectM or ImGui
+ * exists in this mode. The mix manager lives on the control thread as in the
+ * visualizer, ticked every HEADLESS_CONTROL_INTERVAL_MS since no frame waits on it,
+ * and the remote control and metrics export run as usual. Actions that only touch
+ * the visuals are accepted and ignored. The calling thread sleeps in run() until
+ * SIGINT, SIGTERM or requestStop(), so between audio buffers only the mixer's own
+ * callback wakes the CPU.
+ */
+class HeadlessPlayer {
+public:
+    explicit HeadlessPlayer(std::shared_ptr<AppStartup> startup);
+
+    /**
+     * @brief Stops the remote control and the control thread, then the player
+     */
+    ~HeadlessPlayer();
+
+    HeadlessPlayer(const HeadlessPlayer&) = delete;
+    HeadlessPlayer& operator=(const HeadlessPlayer&) = delete;
+
+    /**
+     * @brief Open the audio output and start the control thread, the remote control and metrics
+     * @return False if SDL audio could not be initialized
+     */
+    bool start();
+
+    /**
+     * @brief Sleep until SIGINT, SIGTERM or requestStop(); the signals are only handled in here
+     */
+    void run();
+
+    /**
+     * @brief Make run() return; safe from any thread
+     */
+    void requestStop();
+
+    bool isStopRequested() const {
+        return _stopRequested.load();
+    }
+
+private:
+    void initMixManager();
+    void runHousekeeping();
+    void autoPlay();
+    bool playNext();
+    void runAction(KeyAction action);
+    void publishNowPlaying();
+
+    std::shared_ptr<AppStartup> _startup;
+    AutoVibez::Utils::CancellationToken _shutdownToken;
+    std::unique_ptr<AutoVibez::Data::MixManager> _mixManager;  // Control thread only
+    std::unique_ptr<AutoVibez::Utils::ISystemVolumeController> _volumeController;
+    AutoVibez::Data::Mix _currentMix;  // Control thread only
+    bool _mixManagerInitialized = false;
+    bool _sdlAudio = false;
+    int _seekIncrement{60};  // Seconds per seek action (seek_increment)
+    int _previousVolume{Constants::MAX_VOLUME};
+    std::chrono::steady_clock::time_point _lastAutoPlayCheck;
+    bool _eventDrivenLoop = false;  // Control thread only; housekeeping sleeps until its next timer (event_driven_loop)
+    UpcomingTitles _comingUp;          // Control thread only
+    std::string _publishedNowPlaying;  // Last now_playing JSON sent, so an unchanged one is not sent again
+
+    std::atomic<bool> _stopRequested{false};
+    int _wakeRead = -1;  // Self-pipe: requestStop() and the signal handler write a byte to end run()
+    int _wakeWrite = -1;
+    std::mutex _stopMutex;  // Where there are no pipes, run() waits on the condition instead
+    std::condition_variable _stop;
+
+    MixControlThread _mixControl;
+    AutoVibez::Utils::MetricsExporter _metricsExporter;
+    RemoteControlServer _remoteControl;  // Last, so it stops first and its actions never outlive the rest
+};
+
+}  // namespace AutoVibez::Core
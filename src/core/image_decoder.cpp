@@ -0,0 +1,146 @@
+#include "image_decoder.hpp"
+
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "string_utils.hpp"
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
+#ifdef HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+using AutoVibez::Utils::StringUtils;
+
+std::string getExtension(const std::string& path) {
+    return StringUtils::toLower(std::filesystem::path(path).extension().string());
+}
+
+bool isPng(const std::string& path) {
+    return getExtension(path) == ".png";
+}
+
+bool isJpeg(const std::string& path) {
+    const std::string extension = getExtension(path);
+    return extension == ".jpg" || extension == ".jpeg";
+}
+
+#ifdef HAVE_LIBPNG
+bool readPng(const std::string& path, std::vector<uint8_t>& rgba, int& width, int& height, std::string& error) {
+    png_image image;
+    std::memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&image, path.c_str())) {
+        error = "Failed to read " + path + ": " + image.message;
+        return false;
+    }
+    image.format = PNG_FORMAT_RGBA;
+    rgba.resize(PNG_IMAGE_SIZE(image));
+    if (!png_image_finish_read(&image, nullptr, rgba.data(), 0, nullptr)) {
+        error = "Failed to decode " + path + ": " + image.message;
+        png_image_free(&image);
+        return false;
+    }
+    width = static_cast<int>(image.width);
+    height = static_cast<int>(image.height);
+    return true;
+}
+#endif
+
+#ifdef HAVE_LIBJPEG
+// The default error manager exits the process, so errors jump back out of the decode instead
+struct JpegErrorManager {
+    jpeg_error_mgr manager;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void onJpegError(j_common_ptr info) {
+    auto* errors = reinterpret_cast<JpegErrorManager*>(info->err);
+    (*info->err->format_message)(info, errors->message);
+    std::longjmp(errors->jump, 1);
+}
+
+bool readJpeg(const std::string& path, std::vector<uint8_t>& rgba, int& width, int& height, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "Cannot read " + path;
+        return false;
+    }
+    jpeg_decompress_struct decompress;
+    JpegErrorManager errors;
+    decompress.err = jpeg_std_error(&errors.manager);
+    errors.manager.error_exit = onJpegError;
+    std::vector<uint8_t> row;
+    if (setjmp(errors.jump)) {
+        error = "Failed to decode " + path + ": " + errors.message;
+        jpeg_destroy_decompress(&decompress);
+        std::fclose(file);
+        return false;
+    }
+    jpeg_create_decompress(&decompress);
+    jpeg_stdio_src(&decompress, file);
+    jpeg_read_header(&decompress, TRUE);
+    decompress.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&decompress);
+
+    width = static_cast<int>(decompress.output_width);
+    height = static_cast<int>(decompress.output_height);
+    rgba.resize(static_cast<size_t>(width) * height * 4);
+    row.resize(static_cast<size_t>(width) * 3);
+    while (decompress.output_scanline < decompress.output_height) {
+        uint8_t* out = rgba.data() + static_cast<size_t>(decompress.output_scanline) * width * 4;
+        JSAMPROW rows = row.data();
+        jpeg_read_scanlines(&decompress, &rows, 1);
+        for (int x = 0; x < width; ++x) {
+            std::memcpy(out + x * 4, row.data() + x * 3, 3);
+            out[x * 4 + 3] = 255;
+        }
+    }
+    jpeg_finish_decompress(&decompress);
+    jpeg_destroy_decompress(&decompress);
+    std::fclose(file);
+    return true;
+}
+#endif
+}  // namespace
+
+bool ImageDecoder::canRead([[maybe_unused]] const std::string& path) {
+#ifdef HAVE_LIBPNG
+    if (isPng(path)) {
+        return true;
+    }
+#endif
+#ifdef HAVE_LIBJPEG
+    if (isJpeg(path)) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool ImageDecoder::read(const std::string& path, [[maybe_unused]] std::vector<uint8_t>& rgba,
+                        [[maybe_unused]] int& width, [[maybe_unused]] int& height, std::string& error) {
+#ifdef HAVE_LIBPNG
+    if (isPng(path)) {
+        return readPng(path, rgba, width, height, error);
+    }
+#endif
+#ifdef HAVE_LIBJPEG
+    if (isJpeg(path)) {
+        return readJpeg(path, rgba, width, height, error);
+    }
+#endif
+    error = isPng(path) || isJpeg(path) ? "This build cannot read " + getExtension(path) + " files"
+                                        : "Not a PNG or JPEG file: " + path;
+    return false;
+}
+
+}  // namespace AutoVibez::Core
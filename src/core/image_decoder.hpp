@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Reads PNG and JPEG files into RGBA images
+ *
+ * The counterpart of ImageEncoder, with the same library switches (HAVE_LIBPNG /
+ * HAVE_LIBJPEG); a format built without its library fails to read. The format is
+ * taken from the extension. Corrupt files are reported, never fatal. Stateless and
+ * safe to call from any thread.
+ */
+class ImageDecoder {
+public:
+    /**
+     * @brief Whether this build can read the file, judging by its extension
+     */
+    static bool canRead(const std::string& path);
+
+    /**
+     * @brief Decode to a top-down, tightly packed RGBA image (opaque for JPEG)
+     * @return False with error set if the file could not be decoded
+     */
+    static bool read(const std::string& path, std::vector<uint8_t>& rgba, int& width, int& height,
+                     std::string& error);
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,141 @@
+#include "image_encoder.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
+#ifdef HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+std::vector<uint8_t> dropAlpha(const std::vector<uint8_t>& rgba, int width, int height) {
+    const size_t pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> rgb(pixels * 3);
+    for (size_t i = 0; i < pixels; ++i) {
+        std::memcpy(rgb.data() + i * 3, rgba.data() + i * 4, 3);
+    }
+    return rgb;
+}
+
+#ifdef HAVE_LIBPNG
+bool writePng(const std::string& path, const std::vector<uint8_t>& rgb, int width, int height, std::string& error) {
+    png_image image;
+    std::memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    image.width = static_cast<png_uint_32>(width);
+    image.height = static_cast<png_uint_32>(height);
+    image.format = PNG_FORMAT_RGB;
+    if (!png_image_write_to_file(&image, path.c_str(), 0, rgb.data(), width * 3, nullptr)) {
+        error = "Failed to write " + path + ": " + image.message;
+        return false;
+    }
+    return true;
+}
+#endif
+
+#ifdef HAVE_LIBJPEG
+bool writeJpeg(const std::string& path, const std::vector<uint8_t>& rgb, int width, int height, int quality,
+               std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "Cannot write " + path;
+        return false;
+    }
+    // The default error manager exits the process; nothing here can fail once the file is open
+    jpeg_compress_struct compress;
+    jpeg_error_mgr errorManager;
+    compress.err = jpeg_std_error(&errorManager);
+    jpeg_create_compress(&compress);
+    jpeg_stdio_dest(&compress, file);
+    compress.image_width = static_cast<JDIMENSION>(width);
+    compress.image_height = static_cast<JDIMENSION>(height);
+    compress.input_components = 3;
+    compress.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&compress);
+    jpeg_set_quality(&compress, std::clamp(quality, 1, 100), TRUE);
+    jpeg_start_compress(&compress, TRUE);
+    const size_t stride = static_cast<size_t>(width) * 3;
+    while (compress.next_scanline < compress.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(rgb.data() + stride * compress.next_scanline);
+        jpeg_write_scanlines(&compress, &row, 1);
+    }
+    jpeg_finish_compress(&compress);
+    jpeg_destroy_compress(&compress);
+    if (std::fclose(file) != 0) {
+        error = "Failed writing " + path;
+        return false;
+    }
+    return true;
+}
+#endif
+}  // namespace
+
+bool ImageEncoder::parseFormat(const std::string& name, ImageFormat& format) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "png") {
+        format = ImageFormat::Png;
+        return true;
+    }
+    if (lower == "jpg" || lower == "jpeg") {
+        format = ImageFormat::Jpeg;
+        return true;
+    }
+    return false;
+}
+
+const char* ImageEncoder::getExtension(ImageFormat format) {
+    return format == ImageFormat::Jpeg ? ".jpg" : ".png";
+}
+
+bool ImageEncoder::isSupported(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::Png:
+#ifdef HAVE_LIBPNG
+            return true;
+#else
+            return false;
+#endif
+        case ImageFormat::Jpeg:
+#ifdef HAVE_LIBJPEG
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+bool ImageEncoder::write([[maybe_unused]] const std::string& path, ImageFormat format,
+                         const std::vector<uint8_t>& rgba, int width, int height, [[maybe_unused]] int quality,
+                         std::string& error) {
+    if (width <= 0 || height <= 0 || rgba.size() < static_cast<size_t>(width) * height * 4) {
+        error = "Image data does not match its size";
+        return false;
+    }
+    if (!isSupported(format)) {
+        error = std::string("This build cannot write ") + (format == ImageFormat::Jpeg ? "JPEG" : "PNG") + " files";
+        return false;
+    }
+    const std::vector<uint8_t> rgb = dropAlpha(rgba, width, height);
+#ifdef HAVE_LIBPNG
+    if (format == ImageFormat::Png) {
+        return writePng(path, rgb, width, height, error);
+    }
+#endif
+#ifdef HAVE_LIBJPEG
+    if (format == ImageFormat::Jpeg) {
+        return writeJpeg(path, rgb, width, height, quality, error);
+    }
+#endif
+    return false;
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+enum class ImageFormat { Png, Jpeg };
+
+/**
+ * @brief Writes RGBA frames to PNG or JPEG files
+ *
+ * The alpha channel is dropped: projectM leaves it undefined, so a screenshot would
+ * otherwise come out partly transparent. PNG needs libpng and JPEG needs libjpeg
+ * (HAVE_LIBPNG / HAVE_LIBJPEG); a format built without its library fails to write.
+ * Stateless and safe to call from any thread.
+ */
+class ImageEncoder {
+public:
+    /**
+     * @brief Parse "png", "jpg" or "jpeg" (any case)
+     * @return False if the name is not a known format
+     */
+    static bool parseFormat(const std::string& name, ImageFormat& format);
+
+    /**
+     * @brief File extension including the dot
+     */
+    static const char* getExtension(ImageFormat format);
+
+    /**
+     * @brief Whether this build can write the format
+     */
+    static bool isSupported(ImageFormat format);
+
+    /**
+     * @brief Encode a top-down, tightly packed RGBA image
+     * @param quality JPEG quality (1-100), ignored for PNG
+     * @return False with error set if the file could not be written
+     */
+    static bool write(const std::string& path, ImageFormat format, const std::vector<uint8_t>& rgba, int width,
+                      int height, int quality, std::string& error);
+};
+
+}  // namespace AutoVibez::Core
@@ -25,12 +25,20 @@ KeyBindingManager::KeyBindingManager() : _currentContext("default") {
 }
 
 void KeyBindingManager::registerAction(KeyAction action, ActionCallback callback) {
-    _actionCallbacks[action] = callback;
+    const size_t index = static_cast<size_t>(action);
+    _actionCallbacks[index] = std::move(callback);
+    _coalescedCallbacks[index] = nullptr;
+}
+
+void KeyBindingManager::registerCoalescedAction(KeyAction action, CoalescedCallback callback) {
+    const size_t index = static_cast<size_t>(action);
+    _coalescedCallbacks[index] = std::move(callback);
+    _actionCallbacks[index] = nullptr;
 }
 
 void KeyBindingManager::registerBinding(const KeyBinding& binding) {
     _bindings[binding.action] = binding;
-    rebuildKeyToActionMap();
+    rebuildDispatchTable();
 }
 
 bool KeyBindingManager::handleKey(SDL_Event* event) {
@@ -38,35 +46,60 @@ bool KeyBindingManager::handleKey(SDL_Event* event) {
         return false;
     }
 
-    SDL_Keycode keycode = event->key.keysym.sym;
-    SDL_Keymod modifiers = static_cast<SDL_Keymod>(event->key.keysym.mod);
+    const KeyAction action =
+        findAction(dispatchKey(event->key.keysym.sym, static_cast<SDL_Keymod>(event->key.keysym.mod)));
+    if (action == KeyAction::UNKNOWN) {
+        return false;
+    }
 
-    // Find matching action
-    for (const auto& [action, binding] : _bindings) {
-        if (binding.keycode == keycode && modifiersMatch(modifiers, binding.modifiers)) {
-            auto callbackIt = _actionCallbacks.find(action);
-            if (callbackIt != _actionCallbacks.end()) {
-                callbackIt->second();
-            }
-            return true;  // Key binding found and recognized, regardless of callback existence
+    triggerAction(action);
+    return true;  // Key binding found and recognized, regardless of callback existence
+}
+
+bool KeyBindingManager::triggerAction(KeyAction action) {
+    const size_t index = static_cast<size_t>(action);
+    if (index >= ACTION_COUNT - 1) {
+        return false;  // UNKNOWN or out of range
+    }
+    if (_coalescedCallbacks[index]) {
+        if (_pendingCounts[index]++ == 0) {
+            _pendingActions.push_back(action);
         }
+        return true;
+    }
+    if (_actionCallbacks[index]) {
+        _actionCallbacks[index]();
+        return true;
     }
-
     return false;
 }
 
+void KeyBindingManager::flushCoalescedActions() {
+    // Swapped out first, so presses made by a callback wait for the next flush
+    _flushingActions.swap(_pendingActions);
+    for (KeyAction action : _flushingActions) {
+        const size_t index = static_cast<size_t>(action);
+        const int count = _pendingCounts[index];
+        _pendingCounts[index] = 0;
+        if (_coalescedCallbacks[index]) {
+            _coalescedCallbacks[index](count);
+        }
+    }
+    _flushingActions.clear();
+}
+
 void KeyBindingManager::rebindKey(KeyAction action, SDL_Keycode keycode, SDL_Keymod modifiers) {
     auto it = _bindings.find(action);
     if (it != _bindings.end()) {
         it->second.keycode = keycode;
         it->second.modifiers = modifiers;
-        rebuildKeyToActionMap();
+        rebuildDispatchTable();
     }
 }
 
 void KeyBindingManager::clearBinding(KeyAction action) {
     _bindings.erase(action);
-    rebuildKeyToActionMap();
+    rebuildDispatchTable();
 }
 
 void KeyBindingManager::setContext(const std::string& context) {
@@ -139,16 +172,44 @@ std::map<KeyAction, std::string> KeyBindingManager::getBindingsWithDisplayString
     return result;
 }
 
-bool KeyBindingManager::modifiersMatch(SDL_Keymod current, SDL_Keymod required) const {
-    // Mask out caps lock, num lock, etc.
-    SDL_Keymod relevantMods = static_cast<SDL_Keymod>(KMOD_CTRL | KMOD_ALT | KMOD_SHIFT | KMOD_GUI);
-    return (current & relevantMods) == (required & relevantMods);
+size_t KeyBindingManager::homeSlot(uint64_t key) {
+    // Fibonacci hashing: the top bits of the product are well mixed
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - DISPATCH_BITS));
+}
+
+uint64_t KeyBindingManager::dispatchKey(SDL_Keycode keycode, SDL_Keymod modifiers) {
+    // One bit per modifier, either side; caps lock, num lock, etc. are left out
+    uint64_t mods = 0;
+    mods |= (modifiers & KMOD_CTRL) ? 1u : 0u;
+    mods |= (modifiers & KMOD_ALT) ? 2u : 0u;
+    mods |= (modifiers & KMOD_SHIFT) ? 4u : 0u;
+    mods |= (modifiers & KMOD_GUI) ? 8u : 0u;
+    return (static_cast<uint64_t>(static_cast<uint32_t>(keycode)) << 4) | mods;
 }
 
-void KeyBindingManager::rebuildKeyToActionMap() {
-    _keyToAction.clear();
+KeyAction KeyBindingManager::findAction(uint64_t key) const {
+    size_t slot = homeSlot(key);
+    while (_dispatch[slot].action != KeyAction::UNKNOWN) {
+        if (_dispatch[slot].key == key) {
+            return _dispatch[slot].action;
+        }
+        slot = (slot + 1) & (DISPATCH_SLOTS - 1);
+    }
+    return KeyAction::UNKNOWN;
+}
+
+void KeyBindingManager::rebuildDispatchTable() {
+    _dispatch.fill(DispatchSlot{});
+    // In action order, so when two actions share a key the earlier one keeps it
     for (const auto& [action, binding] : _bindings) {
-        _keyToAction[{binding.keycode, binding.modifiers}] = action;
+        const uint64_t key = dispatchKey(binding.keycode, binding.modifiers);
+        size_t slot = homeSlot(key);
+        while (_dispatch[slot].action != KeyAction::UNKNOWN && _dispatch[slot].key != key) {
+            slot = (slot + 1) & (DISPATCH_SLOTS - 1);
+        }
+        if (_dispatch[slot].action == KeyAction::UNKNOWN) {
+            _dispatch[slot] = {key, action};
+        }
     }
 }
 
@@ -228,7 +289,7 @@ void KeyBindingManager::loadDefaultBindings() {
     setupUIBindings();
     setupApplicationBindings();
     setupAudioBindings();
-    rebuildKeyToActionMap();
+    rebuildDispatchTable();
 }
 
 void KeyBindingManager::setupMixManagementBindings() {
@@ -237,12 +298,15 @@ void KeyBindingManager::setupMixManagementBindings() {
     registerBinding({SDLK_f, KMOD_NONE, KeyAction::TOGGLE_FAVORITE, "Toggle favorite", "MIX MANAGEMENT"});
     registerBinding({SDLK_d, KMOD_NONE, KeyAction::SOFT_DELETE_MIX, "Delete current mix", "MIX MANAGEMENT"});
     registerBinding({SDLK_i, KMOD_NONE, KeyAction::SHOW_MIX_INFO, "Show current mix info", "MIX MANAGEMENT"});
+    registerBinding({SDLK_i, KMOD_SHIFT, KeyAction::SHOW_DOWNLOAD_STATUS, "Show download status", "MIX MANAGEMENT"});
     registerBinding(
         {SDLK_l, KMOD_NONE, KeyAction::TOGGLE_MIX_TABLE_FILTER, "Toggle favorites filter", "MIX MANAGEMENT"});
     registerBinding(
         {SDLK_g, KMOD_NONE, KeyAction::RANDOM_MIX_CURRENT_GENRE, "Play random mix in current genre", "MIX MANAGEMENT"});
     registerBinding({SDLK_g, KMOD_SHIFT, KeyAction::RANDOM_GENRE_AND_MIX, "Switch to random genre", "MIX MANAGEMENT"});
     registerBinding({SDLK_SPACE, KMOD_NONE, KeyAction::PAUSE_RESUME_MIX, "Pause/Resume playbook", "MIX MANAGEMENT"});
+    registerBinding({SDLK_RIGHT, KMOD_SHIFT, KeyAction::SEEK_FORWARD, "Seek forward", "MIX MANAGEMENT"});
+    registerBinding({SDLK_LEFT, KMOD_SHIFT, KeyAction::SEEK_BACKWARD, "Seek backward", "MIX MANAGEMENT"});
 }
 
 void KeyBindingManager::setupVisualizerBindings() {
@@ -251,6 +315,15 @@ void KeyBindingManager::setupVisualizerBindings() {
     registerBinding(
         {SDLK_F11, KMOD_NONE, KeyAction::TOGGLE_FULLSCREEN, "Toggle fullscreen mode", "VISUALIZER CONTROLS"});
     registerBinding({SDLK_r, KMOD_NONE, KeyAction::RANDOM_PRESET, "Load random preset", "VISUALIZER CONTROLS"});
+    registerBinding(
+        {SDLK_p, KMOD_NONE, KeyAction::TOGGLE_PERFORMANCE_HUD, "Toggle performance HUD", "VISUALIZER CONTROLS"});
+    registerBinding(
+        {SDLK_p, KMOD_SHIFT, KeyAction::DUMP_FRAME_PROFILE, "Save frame profile as CSV", "VISUALIZER CONTROLS"});
+#ifdef AUTOVIBEZ_TRACING
+    registerBinding(
+        {SDLK_t, KMOD_SHIFT, KeyAction::DUMP_TRACE, "Save trace (chrome://tracing)", "VISUALIZER CONTROLS"});
+#endif
+    registerBinding({SDLK_F12, KMOD_NONE, KeyAction::TAKE_SCREENSHOT, "Save screenshot", "VISUALIZER CONTROLS"});
     registerBinding(
         {SDLK_LEFTBRACKET, KMOD_NONE, KeyAction::PREVIOUS_PRESET_BRACKET, "Previous preset", "VISUALIZER CONTROLS"});
     registerBinding(
@@ -277,6 +350,10 @@ void KeyBindingManager::setupAudioBindings() {
     registerBinding({SDLK_DOWN, KMOD_NONE, KeyAction::VOLUME_DOWN, "Volume down", "AUDIO CONTROLS"});
     registerBinding(
         {SDLK_TAB, KMOD_NONE, KeyAction::CYCLE_AUDIO_DEVICE, "Cycle through audio devices", "AUDIO CONTROLS"});
+    registerBinding({SDLK_c, KMOD_NONE, KeyAction::TOGGLE_LATENCY_CALIBRATION, "Toggle latency calibration",
+                     "AUDIO CONTROLS"});
+    registerBinding({SDLK_PERIOD, KMOD_NONE, KeyAction::INCREASE_AV_OFFSET, "Increase A/V offset", "AUDIO CONTROLS"});
+    registerBinding({SDLK_COMMA, KMOD_NONE, KeyAction::DECREASE_AV_OFFSET, "Decrease A/V offset", "AUDIO CONTROLS"});
 }
 
 }  // namespace AutoVibez::Core
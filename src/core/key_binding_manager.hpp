@@ -2,6 +2,8 @@
 
 #include <SDL2/SDL.h>
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -19,6 +21,7 @@ enum class KeyAction {
     PREVIOUS_MIX,
     TOGGLE_FAVORITE,
     SHOW_MIX_INFO,
+    SHOW_DOWNLOAD_STATUS,
 
     // Visualizer Controls
     NEXT_PRESET,
@@ -42,6 +45,9 @@ enum class KeyAction {
     VOLUME_DOWN,
     TOGGLE_AUDIO_INPUT,
     CYCLE_AUDIO_DEVICE,
+    TOGGLE_LATENCY_CALIBRATION,
+    INCREASE_AV_OFFSET,
+    DECREASE_AV_OFFSET,
 
     // Beat/Visualization Controls
     INCREASE_BEAT_SENSITIVITY,
@@ -55,10 +61,16 @@ enum class KeyAction {
     SOFT_DELETE_MIX,
     RANDOM_MIX_CURRENT_GENRE,
     RANDOM_GENRE_AND_MIX,
+    SEEK_FORWARD,
+    SEEK_BACKWARD,
 
     // Display Controls
     STRETCH_MONITORS,
     CHANGE_MONITOR,
+    TOGGLE_PERFORMANCE_HUD,
+    DUMP_FRAME_PROFILE,
+    DUMP_TRACE,
+    TAKE_SCREENSHOT,
 
     // Help Overlay Controls
     TOGGLE_MIX_TABLE_FILTER,
@@ -101,6 +113,7 @@ struct KeyBinding {
 class KeyBindingManager {
 public:
     using ActionCallback = std::function<void()>;
+    using CoalescedCallback = std::function<void(int count)>;
 
     KeyBindingManager();
     ~KeyBindingManager() = default;
@@ -110,6 +123,25 @@ public:
     void registerBinding(const KeyBinding& binding);
     bool handleKey(SDL_Event* event);
 
+    /**
+     * @brief Register an action whose presses and key repeats are counted instead of run
+     *
+     * flushCoalescedActions() hands the count over once per frame, so a held key costs
+     * one call per frame however fast it repeats. Replaces any plain callback for the action.
+     */
+    void registerCoalescedAction(KeyAction action, CoalescedCallback callback);
+
+    /**
+     * @brief Run each coalesced action that fired since the last flush, once, with its count
+     */
+    void flushCoalescedActions();
+
+    /**
+     * @brief Run an action as if its key were pressed, e.g. for the remote control
+     * @return False if nothing is registered for it
+     */
+    bool triggerAction(KeyAction action);
+
     // Binding management
     void rebindKey(KeyAction action, SDL_Keycode keycode, SDL_Keymod modifiers);
     void clearBinding(KeyAction action);
@@ -131,15 +163,32 @@ public:
     std::map<KeyAction, std::string> getBindingsWithDisplayStrings(const std::string& category) const;
 
 private:
+    static constexpr size_t ACTION_COUNT = static_cast<size_t>(KeyAction::UNKNOWN) + 1;
+    static constexpr int DISPATCH_BITS = 8;
+    static constexpr size_t DISPATCH_SLOTS = size_t{1} << DISPATCH_BITS;
+    static_assert(ACTION_COUNT * 2 <= DISPATCH_SLOTS, "Keep the dispatch table at most half full");
+
+    // An empty slot holds UNKNOWN
+    struct DispatchSlot {
+        uint64_t key = 0;
+        KeyAction action = KeyAction::UNKNOWN;
+    };
+
     // Internal data structures
     std::map<KeyAction, KeyBinding> _bindings;
-    std::map<KeyAction, ActionCallback> _actionCallbacks;
-    std::map<std::pair<SDL_Keycode, SDL_Keymod>, KeyAction> _keyToAction;
+    std::array<ActionCallback, ACTION_COUNT> _actionCallbacks;
+    std::array<CoalescedCallback, ACTION_COUNT> _coalescedCallbacks;
+    std::array<int, ACTION_COUNT> _pendingCounts{};
+    std::vector<KeyAction> _pendingActions;   // In order of first press since the last flush
+    std::vector<KeyAction> _flushingActions;  // Reused by flushCoalescedActions()
+    std::array<DispatchSlot, DISPATCH_SLOTS> _dispatch{};  // Open-addressed, rebuilt when a binding changes
     std::string _currentContext;
 
     // Helper methods
-    bool modifiersMatch(SDL_Keymod current, SDL_Keymod required) const;
-    void rebuildKeyToActionMap();
+    static uint64_t dispatchKey(SDL_Keycode keycode, SDL_Keymod modifiers);
+    static size_t homeSlot(uint64_t key);
+    KeyAction findAction(uint64_t key) const;
+    void rebuildDispatchTable();
     std::string keyToString(SDL_Keycode keycode) const;
     std::string modifiersToString(SDL_Keymod modifiers) const;
 
@@ -31,32 +31,77 @@
  *
  */
 
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "app_config.hpp"
 #include "autovibez_app.hpp"
 #include "constants.hpp"
+#include "headless_player.hpp"
 using AutoVibez::Core::AutoVibezApp;
 
 #include "console_output.hpp"
+#include "library_importer.hpp"
 #include "mix_downloader.hpp"
 #include "mix_manager.hpp"
 #include "mix_metadata.hpp"
 #include "mix_player.hpp"
 #include "path_manager.hpp"
+#include "preset_cost_database.hpp"
 #include "setup.hpp"
+#include "sqlite_backup.hpp"
+#include "trace_recorder.hpp"
 #include "utils/logger.hpp"
+#include "video_exporter.hpp"
 
 using AutoVibez::Audio::cleanupLoopback;
 using AutoVibez::Audio::MixPlayer;
 using AutoVibez::Audio::processLoopbackFrame;
+using AutoVibez::Core::FramePhase;
+using AutoVibez::Core::ExportOptions;
+using AutoVibez::Core::FrameProfiler;
+using AutoVibez::Core::VideoExporter;
+using AutoVibez::Data::AppConfig;
+using AutoVibez::Data::LibraryImporter;
+using AutoVibez::Data::LibraryImportStats;
 using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixDatabase;
 using AutoVibez::Data::MixDownloader;
 using AutoVibez::Data::MixManager;
 using AutoVibez::Data::MixMetadata;
+using AutoVibez::Data::PresetCostDatabase;
+using AutoVibez::Data::SqliteBackup;
+
+static void renderLoop(AutoVibez::Core::AutoVibezApp* app) {
+    FrameProfiler& profiler = app->getFrameProfiler();
+
+    // loop
+    while (!app->done) {
+        profiler.beginFrame();
+
+        // render
+        app->renderFrame();
+
+        {
+            FrameProfiler::Scope phase(profiler, FramePhase::Housekeeping);
+            processLoopbackFrame(app);
 
-// Helper function to execute code only if mix manager is initialized
-template <typename Func>
-static void executeIfMixManagerInitialized(AutoVibez::Core::AutoVibezApp* app, Func&& func) {
-    if (app->isMixManagerInitialized()) {
-        func();
+            // Mix housekeeping runs on the control thread; only its results are applied here
+            app->processMixEvents();
+            app->updateAudioSource();
+            app->finishStartup();
+        }
+
+        {
+            FrameProfiler::Scope phase(profiler, FramePhase::Events);
+            app->pollEvents();
+        }
+        profiler.endFrame();
+
+        // Vsync, a fixed deadline or nothing, depending on frame_pacing
+        app->paceFrame();
     }
 }
 
@@ -65,56 +110,193 @@ static int mainLoop(void* userData) {
         static_cast<std::unique_ptr<AutoVibez::Core::AutoVibezApp>*>(userData);
     AutoVibez::Core::AutoVibezApp* app = appRef->get();
 
-    // frame rate limiter
-    const Uint32 frame_delay = Constants::FRAME_DELAY_MS;
-    Uint32 last_time = SDL_GetTicks();
+    // The mix manager is initialized on the mix control thread
 
-    // Mix manager is now initialized before mainLoop
+    if (!app->usesRenderThread()) {
+        renderLoop(app);
+        return 0;
+    }
 
-    // loop
+    // Windows runs window drags and resizes in a modal loop inside the event pump; with rendering on its
+    // own thread, frames keep coming while the main thread is stuck there
+    app->beginRenderThread();
+    std::thread renderer([app]() {
+        AUTOVIBEZ_TRACE_THREAD("render");
+        app->attachContext();
+        renderLoop(app);
+        app->detachContext();
+    });
+    SDL_Event evt;
     while (!app->done) {
-        // Check for pending autoplay (from background thread)
-        app->checkPendingAutoPlay();
-        
-        // render
-        app->renderFrame();
+        // Events reach the render thread through the filter; one queued before it was installed is passed on here
+        if (SDL_WaitEventTimeout(&evt, Constants::EVENT_PUMP_TIMEOUT_MS)) {
+            app->forwardEvent(evt);
+        }
+    }
+    renderer.join();
+    app->endRenderThread();
+    return 0;
+}
 
-        processLoopbackFrame(app);
+// autovibez --preset-report [N]: the slowest presets measured with profile_preset_cost
+static int printPresetReport(int limit) {
+    using AutoVibez::Utils::ConsoleOutput;
 
-        executeIfMixManagerInitialized(app, [&]() {
-            if (app->getMixManager()->hasFinished()) {
-                app->checkAndAutoPlayNext();
-            }
+    PresetCostDatabase database(PathManager::getPresetCostDatabasePath());
+    if (!database.initialize()) {
+        ConsoleOutput::error(database.getLastError());
+        return 1;
+    }
+    auto costs = database.getMostExpensive(limit);
+    if (costs.empty()) {
+        ConsoleOutput::info("No preset timings recorded yet (enable profile_preset_cost and run the visualizer)");
+        return 0;
+    }
 
-            static Uint32 last_check = 0;
-            Uint32 current_time = SDL_GetTicks();
-            if (current_time - last_check > Constants::DEFAULT_CHECK_INTERVAL_MS) {
-                if (!app->getMixManager()->isPlaying() && !app->getMixManager()->isPaused()) {
-                    app->checkAndAutoPlayNext();
-                }
+    ConsoleOutput::printSection("Most expensive presets (95th percentile render time)");
+    for (const auto& cost : costs) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "%7.2f ms  cpu %6.2f  gpu %6.2f  %7d frames  ", cost.getCostMs(),
+                      cost.cpu_p95_ms, cost.gpu_p95_ms, cost.frames);
+        ConsoleOutput::println(line + cost.path + "  [" + cost.renderer + "]");
+    }
+    return 0;
+}
 
-                last_check = current_time;
-            }
-        });
+// autovibez --backup-db <output> [--compact]: copy the mix database, safe to run while the visualizer uses it
+static int backupMixDatabase(int argc, char* argv[]) {
+    using AutoVibez::Utils::ConsoleOutput;
 
-        executeIfMixManagerInitialized(app, [&]() { app->getMixManager()->updateCrossfade(); });
+    if (argc < 3) {
+        ConsoleOutput::info("Usage: autovibez --backup-db <out.db> [--compact]");
+        return 1;
+    }
+    const bool compact = argc > 3 && std::string(argv[3]) == "--compact";
+    SqliteBackup backup(PathManager::getDatabasePath(), argv[2],
+                        compact ? AutoVibez::Data::BackupMode::Compact : AutoVibez::Data::BackupMode::Online);
+    if (!backup.start() || !backup.wait()) {
+        ConsoleOutput::error(backup.getLastError());
+        return 1;
+    }
+    ConsoleOutput::success("Mix database backed up to " + std::string(argv[2]) + " (" +
+                           std::to_string(backup.getTotalPages()) + " pages)");
+    return 0;
+}
 
-        executeIfMixManagerInitialized(app, [&]() { app->getMixManager()->cleanupCompletedDownloads(); });
+static std::string describeImport(const LibraryImportStats& stats) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%llu files: %llu imported, %llu unchanged, %llu failed (%.0f files/s)",
+                  static_cast<unsigned long long>(stats.files), static_cast<unsigned long long>(stats.imported),
+                  static_cast<unsigned long long>(stats.unchanged), static_cast<unsigned long long>(stats.failed),
+                  stats.filesPerSecond());
+    return line;
+}
 
-        app->pollEvents();
-        Uint32 elapsed = SDL_GetTicks() - last_time;
-        if (elapsed < frame_delay) {
-            SDL_Delay(frame_delay - elapsed);
-        }
-        last_time = SDL_GetTicks();
+// autovibez --import <directory>: add every MP3 under a directory to the library, played from where it is
+static int importLibrary(int argc, char* argv[]) {
+    using AutoVibez::Utils::ConsoleOutput;
+
+    if (argc < 3) {
+        ConsoleOutput::info("Usage: autovibez --import <directory>");
+        return 1;
+    }
+    MixDatabase database(PathManager::getDatabasePath());
+    if (!database.initialize()) {
+        ConsoleOutput::error(database.getLastError());
+        return 1;
     }
+    MixDownloader downloader(PathManager::getMixesDirectory());
+    AutoVibez::Utils::Mp3ProbeCache scan_cache;
+    scan_cache.load(PathManager::getLibraryScanCachePath());
 
+    LibraryImporter importer(database, downloader, scan_cache);
+    importer.setProgressCallback(
+        [](const LibraryImportStats& stats) { ConsoleOutput::info("Importing... " + describeImport(stats)); });
+    LibraryImportStats stats;
+    if (!importer.importDirectory(argv[2], stats)) {
+        ConsoleOutput::error(importer.getLastError());
+        return 1;
+    }
+    scan_cache.save(PathManager::getLibraryScanCachePath());
+    ConsoleOutput::success("Imported " + std::string(argv[2]) + ": " + describeImport(stats));
+    return 0;
+}
+
+// autovibez --export <output> --audio <source> [options]: render a video offline, faster than real time
+static int runExport(int argc, char* argv[]) {
+    using AutoVibez::Utils::ConsoleOutput;
+
+    // Mesh, frame rate and preset timing default to the visualizer's settings
+    ExportOptions options;
+    const std::string configFilePath = findConfigFile();
+    const std::shared_ptr<const AppConfig> config = configFilePath.empty() ? nullptr : AppConfig::load(configFilePath);
+    if (config) {
+        options.mesh_x = config->mesh_x;
+        options.mesh_y = config->mesh_y;
+        options.fps = static_cast<int>(config->fps);
+        options.preset_duration = config->preset_duration;
+    }
+
+    std::string error;
+    if (!VideoExporter::parseArgs(argc, argv, 2, options, error)) {
+        ConsoleOutput::error(error);
+        ConsoleOutput::info(
+            "Usage: autovibez --export <out.mp4|out.rgba> --audio <file.wav|file.mp3|sweep|pink|kicks|sine>"
+            " [--size WxH] [--fps N] [--seconds S] [--preset file.milk]");
+        return 1;
+    }
+
+    std::string presetPath;
+    std::string texturePath;
+    findAssetPaths(config.get(), presetPath, texturePath);
+    VideoExporter exporter(options);
+    if (!exporter.run(presetPath, texturePath)) {
+        ConsoleOutput::error(exporter.getLastError());
+        return 1;
+    }
+    return 0;
+}
+
+// autovibez --headless: the auto-DJ alone, for a playback node with no screen
+static int runHeadless() {
+    using AutoVibez::Utils::ConsoleOutput;
+
+    AutoVibez::Utils::Logger logger;
+    logger.logInfo("AutoVibez headless player starting...");
+    ConsoleOutput::printBanner("AutoVibez Headless Player");
+
+    AutoVibez::Core::HeadlessPlayer player(beginStartup(false));
+    if (!player.start()) {
+        ConsoleOutput::error("Failed to start the headless player");
+        return 1;
+    }
+    ConsoleOutput::success("Playing; press Ctrl+C to stop");
+    player.run();
+
+    logger.logInfo("AutoVibez headless player shutdown completed");
     return 0;
 }
 
 int main(int argc, char* argv[]) {
     using namespace AutoVibez::Utils;
 
+    if (argc > 1 && std::string(argv[1]) == "--preset-report") {
+        const int limit = argc > 2 ? std::atoi(argv[2]) : 0;
+        return printPresetReport(limit > 0 ? limit : Constants::PRESET_REPORT_DEFAULT_LIMIT);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--export") {
+        return runExport(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--backup-db") {
+        return backupMixDatabase(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--import") {
+        return importLibrary(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--headless") {
+        return runHeadless();
+    }
+
     // Initialize logger for application lifecycle tracking
     AutoVibez::Utils::Logger logger;
     logger.logInfo("AutoVibez application starting...");
@@ -0,0 +1,179 @@
+#include "mix_control_thread.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "trace_recorder.hpp"
+
+namespace AutoVibez::Core {
+
+MixControlThread::MixControlThread(size_t capacity) : _commands(capacity), _events(capacity) {
+#ifndef _WIN32
+    int fds[2];
+    if (pipe(fds) == 0) {
+        _wakeRead = fds[0];
+        _wakeWrite = fds[1];
+        // Neither end ever blocks: the reader drains what is there, and one unread byte is already a wake-up
+        fcntl(_wakeRead, F_SETFL, O_NONBLOCK);
+        fcntl(_wakeWrite, F_SETFL, O_NONBLOCK);
+    }
+#endif
+}
+
+MixControlThread::~MixControlThread() {
+    stop();
+#ifndef _WIN32
+    if (_wakeRead >= 0) {
+        close(_wakeRead);
+        close(_wakeWrite);
+    }
+#endif
+}
+
+void MixControlThread::start(Task tick, std::chrono::milliseconds interval) {
+    if (_thread.joinable()) {
+        return;
+    }
+    _tick = std::move(tick);
+    _interval = interval;
+    _stop.store(false);
+    _thread = std::thread(&MixControlThread::run, this);
+}
+
+void MixControlThread::stop() {
+    if (!_thread.joinable()) {
+        return;
+    }
+    _stop.store(true);
+    signalWake();
+    _thread.join();
+    _threadId.store(std::thread::id(), std::memory_order_release);
+
+    Task discarded;
+    while (_commands.tryPop(discarded)) {
+    }
+}
+
+bool MixControlThread::post(Task command) {
+    if (!_commands.tryPush(command)) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    signalWake();
+    return true;
+}
+
+void MixControlThread::wake() {
+    if (_wakeWrite >= 0) {
+        signalWake();
+        return;
+    }
+    // The audio callback must not wait on the lock; the sleep looks for this once per interval instead
+    _wakePending.store(true, std::memory_order_release);
+    _wake.notify_one();
+}
+
+void MixControlThread::signalWake() {
+#ifndef _WIN32
+    if (_wakeWrite >= 0) {
+        if (!_wakePending.exchange(true, std::memory_order_acq_rel)) {
+            const char byte = 1;
+            [[maybe_unused]] const ssize_t wrote = write(_wakeWrite, &byte, 1);
+        }
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _wakePending.store(true, std::memory_order_release);
+    }
+    _wake.notify_one();
+}
+
+void MixControlThread::sleepUntil(std::chrono::steady_clock::time_point deadline) {
+    const auto now = std::chrono::steady_clock::now();
+#ifndef _WIN32
+    if (_wakeRead >= 0) {
+        // Rounded up, so a deadline a fraction of a millisecond away is not a busy loop
+        const auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+        pollfd wake{_wakeRead, POLLIN, 0};
+        if (poll(&wake, 1, static_cast<int>(std::clamp<int64_t>(wait, 0, INT_MAX))) > 0) {
+            // Cleared before draining: a wake-up from here on writes a byte the next poll() sees
+            _wakePending.store(false, std::memory_order_release);
+            char bytes[64];
+            while (read(_wakeRead, bytes, sizeof(bytes)) > 0) {
+            }
+        }
+        return;
+    }
+#endif
+    // A lock-free wake() can slip in between the check and the wait, so it is looked for again every interval
+    std::unique_lock<std::mutex> lock(_wakeMutex);
+    auto until = now;
+    do {
+        until = std::min(deadline, until + _interval);
+        if (_wake.wait_until(lock, until, [this] {
+                return _stop.load() || _wakePending.exchange(false, std::memory_order_acq_rel);
+            })) {
+            return;
+        }
+    } while (until < deadline);
+}
+
+void MixControlThread::tickBy(std::chrono::steady_clock::time_point deadline) {
+    _nextTick = std::min(_nextTick, deadline);
+}
+
+bool MixControlThread::postEvent(Task event) {
+    if (!_events.tryPush(event)) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+size_t MixControlThread::runEvents(std::chrono::microseconds budget) {
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    size_t count = 0;
+    Task event;
+    while (_events.tryPop(event)) {
+        event();
+        ++count;
+        if (budget.count() > 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+    return count;
+}
+
+void MixControlThread::run() {
+    AUTOVIBEZ_TRACE_THREAD("mix control");
+    _threadId.store(std::this_thread::get_id(), std::memory_order_release);
+    Task command;
+    while (!_stop.load()) {
+        while (!_stop.load() && _commands.tryPop(command)) {
+            command();
+        }
+        if (_stop.load()) {
+            break;
+        }
+        _nextTick = std::chrono::steady_clock::time_point::max();
+        if (_tick) {
+            _tick();
+        }
+        // Without a tickBy() the next tick is one interval away
+        const auto earliest = std::chrono::steady_clock::now() + _interval;
+        const bool scheduled = _nextTick != std::chrono::steady_clock::time_point::max();
+        const auto deadline = scheduled ? std::max(_nextTick, earliest) : earliest;
+        sleepUntil(deadline);
+    }
+}
+
+}  // namespace AutoVibez::Core
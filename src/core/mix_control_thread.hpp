@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "constants.hpp"
+#include "lock_free_queue.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Worker thread that owns mix management, fed by lock-free queues
+ *
+ * Commands posted from any thread run on the control thread in order, followed
+ * by the periodic tick (autoplay, lookahead, download cleanup). Work the render
+ * thread must do, such as showing overlay messages, comes back as events that
+ * runEvents() executes, within a time budget so a burst of completions is spread
+ * over several frames instead of stalling one. Posting never blocks: a full queue drops the task and
+ * counts it. The control thread sleeps on a self-pipe that post(), wake() and stop()
+ * write a byte to, so no wake-up is lost to it going to sleep and wake() takes no lock.
+ * Where there is no pipe (Windows) the thread waits on a condition variable instead and
+ * looks for a wake() once per tick interval, which bounds what a racing one can cost.
+ *
+ * A tick may stretch the sleep after it with tickBy(), up to the earliest deadline it
+ * names, so an idle thread only wakes for posted commands, wake() and its timers.
+ */
+class MixControlThread {
+public:
+    using Task = std::function<void()>;
+
+    explicit MixControlThread(size_t capacity = Constants::MIX_CONTROL_QUEUE_CAPACITY);
+    ~MixControlThread();
+
+    MixControlThread(const MixControlThread&) = delete;
+    MixControlThread& operator=(const MixControlThread&) = delete;
+
+    /**
+     * @brief Start the thread; commands posted before this run first
+     * @param tick Called after each batch of commands and at least once per interval
+     * @param interval Longest sleep between ticks
+     */
+    void start(Task tick, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Finish the running task and join; commands still queued are discarded
+     */
+    void stop();
+
+    bool isRunning() const {
+        return _thread.joinable();
+    }
+
+    /**
+     * @brief Whether the caller is the control thread
+     */
+    bool isCurrentThread() const {
+        return std::this_thread::get_id() == _threadId.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Queue a command for the control thread (from any thread)
+     * @return False if the queue was full and the command was dropped
+     */
+    bool post(Task command);
+
+    /**
+     * @brief Run the tick soon without posting a command (from any thread, including the audio callback)
+     */
+    void wake();
+
+    /**
+     * @brief Sleep after this tick until a deadline instead of the interval (from the tick)
+     *
+     * Several calls keep the earliest deadline; the sleep never gets shorter than the
+     * interval, so a deadline already due ticks again one interval later.
+     */
+    void tickBy(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Queue an event for the thread that calls runEvents()
+     * @return False if the queue was full and the event was dropped
+     */
+    bool postEvent(Task event);
+
+    /**
+     * @brief Run queued events in order until the budget is spent; the rest wait for the next call
+     * @param budget Time to spend, zero for no limit; at least one event runs either way
+     * @return Number of events run
+     */
+    size_t runEvents(std::chrono::microseconds budget = std::chrono::microseconds::zero());
+
+    /**
+     * @brief Commands and events dropped because a queue was full
+     */
+    uint64_t getDroppedCount() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    void run();
+
+    /**
+     * @brief Make the sleeping thread look again; lock-free with the pipe
+     */
+    void signalWake();
+
+    /**
+     * @brief Sleep until the deadline or a wake-up, whichever comes first
+     */
+    void sleepUntil(std::chrono::steady_clock::time_point deadline);
+
+    AutoVibez::Utils::LockFreeQueue<Task> _commands;
+    AutoVibez::Utils::LockFreeQueue<Task> _events;
+    Task _tick;
+    std::chrono::milliseconds _interval{Constants::MIX_CONTROL_INTERVAL_MS};
+    std::chrono::steady_clock::time_point _nextTick;  // Control thread only; max() until tickBy() is called
+
+    std::thread _thread;
+    std::atomic<std::thread::id> _threadId{};  // Published by the thread, as start() may still be writing _thread
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _wakePending{false};  // Set until the thread looks, so a burst of wake-ups writes one byte
+    int _wakeRead = -1;                     // Self-pipe, -1 without one
+    int _wakeWrite = -1;
+    std::mutex _wakeMutex;  // Without the pipe: the sleep, and post() and stop() setting _wakePending
+    std::condition_variable _wake;
+    std::atomic<uint64_t> _dropped{0};
+};
+
+}  // namespace AutoVibez::Core
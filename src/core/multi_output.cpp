@@ -0,0 +1,207 @@
+#include "multi_output.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#include "render_scaler.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+// Desktop rects moved apart by one bezel per column and row to their left and above
+std::vector<OutputRect> insertBezels(const std::vector<OutputRect>& displays, int bezel) {
+    std::vector<int> columns;
+    std::vector<int> rows;
+    for (const OutputRect& display : displays) {
+        columns.push_back(display.x);
+        rows.push_back(display.y);
+    }
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    std::vector<OutputRect> placed = displays;
+    for (OutputRect& rect : placed) {
+        const auto column = std::lower_bound(columns.begin(), columns.end(), rect.x) - columns.begin();
+        const auto row = std::lower_bound(rows.begin(), rows.end(), rect.y) - rows.begin();
+        rect.x += bezel * static_cast<int>(column);
+        rect.y += bezel * static_cast<int>(row);
+    }
+    return placed;
+}
+}  // namespace
+
+MultiOutput::~MultiOutput() {
+    for (size_t i = 1; i < _windows.size(); ++i) {
+        SDL_DestroyWindow(_windows[i]);
+    }
+}
+
+bool MultiOutput::parseDisplays(const std::string& text, int displayCount, std::vector<int>& displays,
+                                std::string& error) {
+    displays.clear();
+    const std::string trimmed = AutoVibez::Utils::StringUtils::trim(text);
+    if (trimmed == "all") {
+        for (int i = 0; i < displayCount; ++i) {
+            displays.push_back(i);
+        }
+        return true;
+    }
+
+    std::stringstream stream(trimmed);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = AutoVibez::Utils::StringUtils::trim(item);
+        char* end = nullptr;
+        const long index = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || index < 0 || index >= displayCount) {
+            error = "No display '" + item + "' (" + std::to_string(displayCount) + " connected)";
+            return false;
+        }
+        if (std::find(displays.begin(), displays.end(), static_cast<int>(index)) != displays.end()) {
+            error = "Display " + item + " is listed twice";
+            return false;
+        }
+        displays.push_back(static_cast<int>(index));
+    }
+    if (displays.empty()) {
+        error = "No displays listed";
+        return false;
+    }
+    return true;
+}
+
+OutputRect MultiOutput::getCanvas(const std::vector<OutputRect>& displays, int bezel) {
+    const std::vector<OutputRect> placed = insertBezels(displays, bezel);
+    if (placed.empty()) {
+        return {};
+    }
+    int left = placed[0].x;
+    int top = placed[0].y;
+    int right = placed[0].x + placed[0].w;
+    int bottom = placed[0].y + placed[0].h;
+    for (const OutputRect& rect : placed) {
+        left = std::min(left, rect.x);
+        top = std::min(top, rect.y);
+        right = std::max(right, rect.x + rect.w);
+        bottom = std::max(bottom, rect.y + rect.h);
+    }
+    return {left, top, right - left, bottom - top};
+}
+
+std::vector<OutputRect> MultiOutput::computeSources(const std::vector<OutputRect>& displays, int bezel,
+                                                    int contentWidth, int contentHeight) {
+    const OutputRect canvas = getCanvas(displays, bezel);
+    std::vector<OutputRect> sources;
+    if (canvas.w <= 0 || canvas.h <= 0) {
+        return sources;
+    }
+    const double scaleX = static_cast<double>(contentWidth) / canvas.w;
+    const double scaleY = static_cast<double>(contentHeight) / canvas.h;
+    // Both edges are rounded, so neighbouring regions meet without gaps or overlap
+    auto toContentX = [&](int x) { return static_cast<int>(std::lround((x - canvas.x) * scaleX)); };
+    auto toContentY = [&](int y) { return static_cast<int>(std::lround((y - canvas.y) * scaleY)); };
+    for (const OutputRect& rect : insertBezels(displays, bezel)) {
+        const int x = toContentX(rect.x);
+        const int y = toContentY(rect.y);
+        sources.push_back(
+            {x, y, std::max(1, toContentX(rect.x + rect.w) - x), std::max(1, toContentY(rect.y + rect.h) - y)});
+    }
+    return sources;
+}
+
+int MultiOutput::fitContentHeight(const OutputRect& canvas, int contentWidth) {
+    if (canvas.w <= 0) {
+        return 0;
+    }
+    return std::max(1, static_cast<int>(std::lround(static_cast<double>(contentWidth) * canvas.h / canvas.w)));
+}
+
+std::unique_ptr<MultiOutput> MultiOutput::open(SDL_Window* mainWindow, SDL_GLContext context,
+                                               const std::vector<int>& displays, int bezel, int contentWidth,
+                                               std::string& error) {
+    std::vector<OutputRect> bounds;
+    int widest = 0;
+    for (int display : displays) {
+        SDL_Rect rect;
+        if (SDL_GetDisplayBounds(display, &rect) != 0) {
+            error = "Cannot read the bounds of display " + std::to_string(display) + ": " + SDL_GetError();
+            return nullptr;
+        }
+        bounds.push_back({rect.x, rect.y, rect.w, rect.h});
+        widest = std::max(widest, rect.w);
+    }
+    if (bounds.empty()) {
+        error = "No displays to output to";
+        return nullptr;
+    }
+
+    std::unique_ptr<MultiOutput> output(new MultiOutput());
+    output->_context = context;
+    output->_contentWidth = contentWidth > 0 ? contentWidth : widest;
+    output->_contentHeight = fitContentHeight(getCanvas(bounds, bezel), output->_contentWidth);
+    output->_sources = computeSources(bounds, bezel, output->_contentWidth, output->_contentHeight);
+
+    SDL_SetWindowFullscreen(mainWindow, 0);
+    SDL_SetWindowBordered(mainWindow, SDL_FALSE);
+    SDL_SetWindowPosition(mainWindow, bounds[0].x, bounds[0].y);
+    SDL_SetWindowSize(mainWindow, bounds[0].w, bounds[0].h);
+    output->_windows.push_back(mainWindow);
+
+    for (size_t i = 1; i < bounds.size(); ++i) {
+        SDL_Window* window =
+            SDL_CreateWindow("AutoVibez", bounds[i].x, bounds[i].y, bounds[i].w, bounds[i].h,
+                             SDL_WINDOW_OPENGL | SDL_WINDOW_BORDERLESS | SDL_WINDOW_ALLOW_HIGHDPI);
+        if (!window) {
+            error = "Cannot open a window on display " + std::to_string(displays[i]) + ": " + SDL_GetError();
+            SDL_GL_MakeCurrent(mainWindow, context);
+            return nullptr;
+        }
+        output->_windows.push_back(window);
+        // Only the main window's swap waits for vsync
+        if (SDL_GL_MakeCurrent(window, context) == 0) {
+            SDL_GL_SetSwapInterval(0);
+        }
+    }
+    SDL_GL_MakeCurrent(mainWindow, context);
+    return output;
+}
+
+void MultiOutput::blitMain(RenderScaler& target, int width, int height) {
+    blitRegion(target, 0, width, height);
+}
+
+void MultiOutput::presentSecondary(RenderScaler& target) {
+    for (size_t i = 1; i < _windows.size(); ++i) {
+        if (SDL_GL_MakeCurrent(_windows[i], _context) != 0) {
+            continue;
+        }
+        int width = 0;
+        int height = 0;
+        SDL_GL_GetDrawableSize(_windows[i], &width, &height);
+        blitRegion(target, i, width, height);
+        SDL_GL_SwapWindow(_windows[i]);
+    }
+    SDL_GL_MakeCurrent(_windows[0], _context);
+}
+
+void MultiOutput::blitRegion(RenderScaler& target, size_t output, int width, int height) {
+    if (output >= _sources.size() || _contentWidth <= 0 || _contentHeight <= 0) {
+        return;
+    }
+    // The target may be smaller than the content (render scale) and is stored bottom-up
+    const OutputRect& source = _sources[output];
+    const double scaleX = static_cast<double>(target.getWidth()) / _contentWidth;
+    const double scaleY = static_cast<double>(target.getHeight()) / _contentHeight;
+    const int x = static_cast<int>(std::lround(source.x * scaleX));
+    const int y = static_cast<int>(std::lround((_contentHeight - source.y - source.h) * scaleY));
+    const int regionWidth = std::max(1, static_cast<int>(std::lround(source.w * scaleX)));
+    const int regionHeight = std::max(1, static_cast<int>(std::lround(source.h * scaleY)));
+    target.blitRegionToBackbuffer(x, y, regionWidth, regionHeight, width, height);
+}
+
+}  // namespace AutoVibez::Core
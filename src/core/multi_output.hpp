@@ -0,0 +1,107 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+class RenderScaler;
+
+/**
+ * @brief Rectangle in desktop or content pixels, top-left origin
+ */
+struct OutputRect {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+};
+
+/**
+ * @brief Presents one projectM frame on several displays, each through its own window
+ *
+ * Instead of one window stretched over the bounding box of every display, projectM
+ * renders a single frame at the content resolution into a RenderScaler target, and
+ * each display's window gets its region of that frame with one bilinear blit. GPU
+ * cost follows the content resolution, not the desktop size, and the dead space of
+ * non-rectangular layouts is never drawn at full resolution. The content canvas is
+ * the display layout with bezel pixels inserted between neighbouring columns and
+ * rows, so imagery hidden behind a bezel is cropped instead of squeezed. The main
+ * window becomes the first output and keeps the overlays; the other windows share
+ * its GL context and swap without vsync so only the main window paces the loop.
+ */
+class MultiOutput {
+public:
+    ~MultiOutput();
+
+    MultiOutput(const MultiOutput&) = delete;
+    MultiOutput& operator=(const MultiOutput&) = delete;
+
+    /**
+     * @brief Parse "all" or a comma-separated list of display indices, first one being the main window
+     * @return False with error set for unknown or repeated displays
+     */
+    static bool parseDisplays(const std::string& text, int displayCount, std::vector<int>& displays,
+                              std::string& error);
+
+    /**
+     * @brief Bounding box of the displays once bezel gaps are inserted between columns and rows
+     */
+    static OutputRect getCanvas(const std::vector<OutputRect>& displays, int bezel);
+
+    /**
+     * @brief Region of a contentWidth x contentHeight frame that each display shows
+     */
+    static std::vector<OutputRect> computeSources(const std::vector<OutputRect>& displays, int bezel,
+                                                  int contentWidth, int contentHeight);
+
+    /**
+     * @brief Content height keeping the canvas aspect at the given width
+     */
+    static int fitContentHeight(const OutputRect& canvas, int contentWidth);
+
+    /**
+     * @brief Move the main window onto the first display and open borderless windows on the others
+     * @param contentWidth Width projectM renders at; 0 uses the widest display
+     * @return nullptr with error set if a window could not be created
+     */
+    static std::unique_ptr<MultiOutput> open(SDL_Window* mainWindow, SDL_GLContext context,
+                                             const std::vector<int>& displays, int bezel, int contentWidth,
+                                             std::string& error);
+
+    int getContentWidth() const {
+        return _contentWidth;
+    }
+    int getContentHeight() const {
+        return _contentHeight;
+    }
+    size_t getOutputCount() const {
+        return _windows.size();
+    }
+
+    /**
+     * @brief Blit the first output's region into the main window's backbuffer
+     */
+    void blitMain(RenderScaler& target, int width, int height);
+
+    /**
+     * @brief Blit and swap every other output, then make the main window current again
+     */
+    void presentSecondary(RenderScaler& target);
+
+private:
+    MultiOutput() = default;
+
+    void blitRegion(RenderScaler& target, size_t output, int width, int height);
+
+    SDL_GLContext _context = nullptr;
+    std::vector<SDL_Window*> _windows;  // [0] is the main window, owned by the app
+    std::vector<OutputRect> _sources;
+    int _contentWidth = 0;
+    int _contentHeight = 0;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,400 @@
+#include "node_sync.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+constexpr uint32_t PACKET_MAGIC = 0x41565359;  // "AVSY"
+constexpr uint8_t PACKET_VERSION = 1;
+constexpr uint8_t FLAG_BEAT_LOCKED = 0x01;
+constexpr uint8_t FLAG_MIX_PLAYING = 0x02;
+constexpr int RECEIVE_POLL_MS = 200;  // How soon stop() is noticed while a follower hears nothing
+
+uint64_t randomNodeId() {
+    std::random_device device;
+    std::uniform_int_distribution<uint64_t> distribution(1);  // 0 stands for no node
+    return distribution(device);
+}
+
+// Fixed offsets into the packet, big-endian
+void put(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> ((bytes - 1 - i) * 8));
+    }
+}
+
+uint64_t get(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+void putFloat(uint8_t* out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(out, bits, 4);
+}
+
+float getFloat(const uint8_t* in) {
+    const auto bits = static_cast<uint32_t>(get(in, 4));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+}  // namespace
+
+void SyncPacket::encode(std::array<uint8_t, BYTES>& out) const {
+    out.fill(0);
+    uint8_t* p = out.data();
+    put(p + 0, PACKET_MAGIC, 4);
+    p[4] = PACKET_VERSION;
+    p[5] = static_cast<uint8_t>(kind);
+    p[6] = static_cast<uint8_t>((visuals.beat_locked ? FLAG_BEAT_LOCKED : 0) | (mix.playing ? FLAG_MIX_PLAYING : 0));
+    p[7] = visuals.beat_in_bar;
+    put(p + 8, node_id, 8);
+    put(p + 16, target_id, 8);
+    put(p + 24, static_cast<uint64_t>(sent_ns), 8);
+    put(p + 32, static_cast<uint64_t>(echoed_ns), 8);
+    put(p + 40, static_cast<uint64_t>(received_ns), 8);
+    put(p + 48, static_cast<uint64_t>(visuals.time_ns), 8);
+    putFloat(p + 56, visuals.bpm);
+    putFloat(p + 60, visuals.beat_phase);
+    put(p + 64, visuals.beat_count, 4);
+    put(p + 68, visuals.cut_count, 4);
+    put(p + 72, visuals.preset_index, 4);
+    put(p + 76, visuals.preset_seed, 4);
+    put(p + 80, static_cast<uint64_t>(visuals.cut_time_ns), 8);
+    put(p + 88, static_cast<uint64_t>(mix.time_ns), 8);
+    put(p + 96, static_cast<uint32_t>(mix.position_seconds), 4);
+    put(p + 100, mix.selection_seed, 4);
+    std::memcpy(p + 104, mix.id.bytes.data(), mix.id.bytes.size());
+    put(p + 120, static_cast<uint64_t>(mix.position_ms), 8);
+}
+
+bool SyncPacket::decode(const uint8_t* data, size_t size, SyncPacket& packet) {
+    if (size != BYTES || get(data, 4) != PACKET_MAGIC || data[4] != PACKET_VERSION || data[5] < 1 || data[5] > 3) {
+        return false;
+    }
+    packet.kind = static_cast<Kind>(data[5]);
+    packet.visuals.beat_locked = (data[6] & FLAG_BEAT_LOCKED) != 0;
+    packet.mix.playing = (data[6] & FLAG_MIX_PLAYING) != 0;
+    packet.visuals.beat_in_bar = data[7];
+    packet.node_id = get(data + 8, 8);
+    packet.target_id = get(data + 16, 8);
+    packet.sent_ns = static_cast<int64_t>(get(data + 24, 8));
+    packet.echoed_ns = static_cast<int64_t>(get(data + 32, 8));
+    packet.received_ns = static_cast<int64_t>(get(data + 40, 8));
+    packet.visuals.time_ns = static_cast<int64_t>(get(data + 48, 8));
+    packet.visuals.bpm = getFloat(data + 56);
+    packet.visuals.beat_phase = getFloat(data + 60);
+    packet.visuals.beat_count = static_cast<uint32_t>(get(data + 64, 4));
+    packet.visuals.cut_count = static_cast<uint32_t>(get(data + 68, 4));
+    packet.visuals.preset_index = static_cast<uint32_t>(get(data + 72, 4));
+    packet.visuals.preset_seed = static_cast<uint32_t>(get(data + 76, 4));
+    packet.visuals.cut_time_ns = static_cast<int64_t>(get(data + 80, 8));
+    packet.mix.time_ns = static_cast<int64_t>(get(data + 88, 8));
+    packet.mix.position_seconds = static_cast<int32_t>(static_cast<uint32_t>(get(data + 96, 4)));
+    packet.mix.selection_seed = static_cast<uint32_t>(get(data + 100, 4));
+    std::memcpy(packet.mix.id.bytes.data(), data + 104, packet.mix.id.bytes.size());
+    packet.mix.position_ms = static_cast<int64_t>(get(data + 120, 8));
+    return true;
+}
+
+void ClockOffsetEstimator::addSample(int64_t requestSent, int64_t leaderReceived, int64_t leaderSent,
+                                     int64_t replyReceived) {
+    const int64_t delay = (replyReceived - requestSent) - (leaderSent - leaderReceived);
+    if (delay < 0) {
+        return;  // Times from a reordered or forged exchange
+    }
+    _samples[_next] = Sample{((leaderReceived - requestSent) + (leaderSent - replyReceived)) / 2, delay};
+    _next = (_next + 1) % _samples.size();
+    _count = std::min(_count + 1, _samples.size());
+}
+
+const ClockOffsetEstimator::Sample* ClockOffsetEstimator::best() const {
+    if (_count == 0) {
+        return nullptr;
+    }
+    return &*std::min_element(_samples.begin(), _samples.begin() + static_cast<std::ptrdiff_t>(_count),
+                              [](const Sample& a, const Sample& b) { return a.delay < b.delay; });
+}
+
+int64_t ClockOffsetEstimator::getOffsetNs() const {
+    const Sample* sample = best();
+    return sample ? sample->offset : 0;
+}
+
+int64_t ClockOffsetEstimator::getDelayNs() const {
+    const Sample* sample = best();
+    return sample ? sample->delay : 0;
+}
+
+NodeSync::NodeSync(SyncRole role) : _nodeId(randomNodeId()), _role(role) {}
+
+NodeSync::~NodeSync() {
+    stop();
+}
+
+bool NodeSync::parseRole(const std::string& text, SyncRole& role) {
+    if (text == "off") {
+        role = SyncRole::Off;
+    } else if (text == "leader") {
+        role = SyncRole::Leader;
+    } else if (text == "follower") {
+        role = SyncRole::Follower;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int64_t NodeSync::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void NodeSync::publishVisuals(const SyncVisuals& visuals) {
+    std::lock_guard<std::mutex> lock(_stateMutex);
+    _visuals = visuals;
+}
+
+void NodeSync::publishMix(const SyncMix& mix) {
+    std::lock_guard<std::mutex> lock(_stateMutex);
+    _mix = mix;
+}
+
+bool NodeSync::getLeaderState(SyncVisuals& visuals, SyncMix& mix) const {
+    if (_role != SyncRole::Follower || !_clockMeasured.load()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_stateMutex);
+    if (_leaderId == 0 || nowNs() - _leaderHeardNs > int64_t{Constants::SYNC_LEADER_TIMEOUT_MS} * 1000000) {
+        return false;
+    }
+    const int64_t offset = _clockOffsetNs.load();
+    visuals = _visuals;
+    mix = _mix;
+    visuals.time_ns -= offset;
+    visuals.cut_time_ns -= offset;
+    mix.time_ns -= offset;
+    return true;
+}
+
+SyncPacket NodeSync::buildState(int64_t nowNs) const {
+    SyncPacket packet;
+    packet.kind = SyncPacket::Kind::State;
+    packet.node_id = _nodeId;
+    packet.sent_ns = nowNs;
+    std::lock_guard<std::mutex> lock(_stateMutex);
+    packet.visuals = _visuals;
+    packet.mix = _mix;
+    return packet;
+}
+
+SyncPacket NodeSync::buildTimeRequest(int64_t nowNs) const {
+    SyncPacket packet;
+    packet.kind = SyncPacket::Kind::TimeRequest;
+    packet.node_id = _nodeId;
+    packet.sent_ns = nowNs;
+    std::lock_guard<std::mutex> lock(_stateMutex);
+    packet.target_id = _leaderId;
+    return packet;
+}
+
+bool NodeSync::receive(const uint8_t* data, size_t size, int64_t receivedNs, SyncPacket& reply) {
+    SyncPacket packet;
+    if (!SyncPacket::decode(data, size, packet) || packet.node_id == _nodeId) {
+        return false;
+    }
+
+    if (_role == SyncRole::Leader) {
+        if (packet.kind != SyncPacket::Kind::TimeRequest || packet.target_id != _nodeId) {
+            return false;
+        }
+        reply = SyncPacket{};
+        reply.kind = SyncPacket::Kind::TimeReply;
+        reply.node_id = _nodeId;
+        reply.target_id = packet.node_id;
+        reply.echoed_ns = packet.sent_ns;
+        reply.received_ns = receivedNs;
+        reply.sent_ns = receivedNs;  // Stamped again as it goes out
+        return true;
+    }
+    if (_role != SyncRole::Follower) {
+        return false;
+    }
+
+    if (packet.kind == SyncPacket::Kind::State) {
+        std::lock_guard<std::mutex> lock(_stateMutex);
+        // Stay with the leader followed until it goes quiet, should two claim the room
+        const bool lost = receivedNs - _leaderHeardNs > int64_t{Constants::SYNC_LEADER_TIMEOUT_MS} * 1000000;
+        if (packet.node_id != _leaderId) {
+            if (_leaderId != 0 && !lost) {
+                return false;
+            }
+            _leaderId = packet.node_id;
+            _clock.reset();
+            _clockMeasured = false;
+        }
+        _leaderHeardNs = receivedNs;
+        _visuals = packet.visuals;
+        _mix = packet.mix;
+        return false;
+    }
+    if (packet.kind == SyncPacket::Kind::TimeReply && packet.target_id == _nodeId) {
+        {
+            std::lock_guard<std::mutex> lock(_stateMutex);
+            if (packet.node_id != _leaderId) {
+                return false;
+            }
+        }
+        _clock.addSample(packet.echoed_ns, packet.received_ns, packet.sent_ns, receivedNs);
+        if (_clock.hasEstimate()) {
+            _clockOffsetNs = _clock.getOffsetNs();
+            _clockMeasured = true;
+        }
+    }
+    return false;
+}
+
+#ifdef _WIN32
+
+bool NodeSync::start(uint16_t port) {
+    (void)port;
+    setError("Multi-node sync is not supported on this platform");
+    return false;
+}
+
+void NodeSync::stop() {}
+void NodeSync::networkLoop() {}
+bool NodeSync::send(const SyncPacket& packet) {
+    (void)packet;
+    return false;
+}
+
+#else
+
+bool NodeSync::start(uint16_t port) {
+    if (isRunning()) {
+        return true;
+    }
+    if (_role == SyncRole::Off) {
+        setError("Multi-node sync has no role");
+        return false;
+    }
+
+    const int udp = socket(AF_INET, SOCK_DGRAM, 0);
+    int reuse = 1;
+    unsigned char ttl = 1;   // Never past the first router
+    unsigned char loop = 1;  // Nodes on one host, as in testing, hear each other
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    ip_mreq membership{};
+    inet_pton(AF_INET, StringConstants::SYNC_MULTICAST_GROUP, &membership.imr_multiaddr);
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+    bool ready = udp >= 0;
+    if (ready) {
+        // Every node on the host binds the group's port
+        setsockopt(udp, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#ifdef SO_REUSEPORT
+        setsockopt(udp, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+#endif
+        ready = bind(udp, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                setsockopt(udp, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0;
+        setsockopt(udp, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(udp, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    if (!ready) {
+        setError(std::string("Cannot join the sync multicast group: ") + std::strerror(errno));
+        if (udp >= 0) {
+            close(udp);
+        }
+        return false;
+    }
+
+    _socket = udp;
+    _port = port;
+    _stopping = false;
+    _thread = std::thread(&NodeSync::networkLoop, this);
+    setSuccess(true);
+    return true;
+}
+
+void NodeSync::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    _stopping = true;
+    _thread.join();
+    close(_socket);
+    _socket = -1;
+}
+
+bool NodeSync::send(const SyncPacket& packet) {
+    sockaddr_in group{};
+    group.sin_family = AF_INET;
+    group.sin_port = htons(_port);
+    inet_pton(AF_INET, StringConstants::SYNC_MULTICAST_GROUP, &group.sin_addr);
+    std::array<uint8_t, SyncPacket::BYTES> datagram;
+    packet.encode(datagram);
+    return sendto(_socket, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&group), sizeof(group)) ==
+           static_cast<ssize_t>(datagram.size());
+}
+
+void NodeSync::networkLoop() {
+    const int64_t interval = int64_t{_role == SyncRole::Leader ? Constants::SYNC_STATE_INTERVAL_MS
+                                                                : Constants::SYNC_TIME_REQUEST_INTERVAL_MS} *
+                             1000000;
+    int64_t nextSend = nowNs();
+    // One larger than a packet, so an oversized datagram reads as the wrong size instead of a cut-off packet
+    std::array<uint8_t, SyncPacket::BYTES + 1> datagram;
+    SyncPacket reply;
+
+    while (!_stopping) {
+        int64_t now = nowNs();
+        if (now >= nextSend) {
+            if (_role == SyncRole::Leader) {
+                send(buildState(now));
+            } else {
+                const SyncPacket request = buildTimeRequest(now);
+                if (request.target_id != 0) {
+                    send(request);
+                }
+            }
+            nextSend = now + interval;
+        }
+
+        const int64_t waitMs = std::min<int64_t>((nextSend - now) / 1000000 + 1, RECEIVE_POLL_MS);
+        pollfd ready{_socket, POLLIN, 0};
+        if (poll(&ready, 1, static_cast<int>(waitMs)) <= 0) {
+            continue;
+        }
+        const ssize_t got = recv(_socket, datagram.data(), datagram.size(), 0);
+        // Stamped straight away: time spent here would read as network delay
+        now = nowNs();
+        if (got > 0 && receive(datagram.data(), static_cast<size_t>(got), now, reply)) {
+            reply.sent_ns = nowNs();
+            send(reply);
+        }
+    }
+}
+
+#endif
+
+}  // namespace AutoVibez::Core
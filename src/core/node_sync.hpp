@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+#include "uuid_utils.hpp"
+
+namespace AutoVibez::Core {
+
+enum class SyncRole { Off, Leader, Follower };
+
+/**
+ * @brief What the render thread shows, as the leader hands it on
+ */
+struct SyncVisuals {
+    int64_t time_ns = 0;  //!< When the beat fields were read, on the leader's clock
+    bool beat_locked = false;
+    float bpm = 0.0f;
+    float beat_phase = 0.0f;  //!< 0 on a beat, rising towards 1
+    uint8_t beat_in_bar = 0;
+    uint32_t beat_count = 0;
+    uint32_t cut_count = 0;     //!< Bumped by every preset cut, announced or not
+    uint32_t preset_index = 0;  //!< Playlist position from the latest cut on
+    uint32_t preset_seed = 0;   //!< Seeds the draw of the preset after preset_index
+    int64_t cut_time_ns = 0;    //!< When the latest cut happens, on the leader's clock
+};
+
+/**
+ * @brief What the leader is playing, from its control thread
+ */
+struct SyncMix {
+    int64_t time_ns = 0;          //!< When position_seconds was read, on the leader's clock
+    AutoVibez::Utils::HashId id;  //!< All zero with nothing playing
+    int32_t position_seconds = 0;
+    int64_t position_ms = 0;  //!< From the player's sample clock; older leaders leave it 0 and send only seconds
+    bool playing = false;
+    uint32_t selection_seed = 0;  //!< The leader's seed for random mix picks
+};
+
+/**
+ * @brief One datagram of the sync protocol, always SyncPacket::BYTES long on the wire
+ *
+ * Encoded field by field in network byte order into a fixed buffer, so neither side
+ * allocates and nodes of any architecture read each other.
+ */
+struct SyncPacket {
+    static constexpr size_t BYTES = 128;
+
+    enum class Kind : uint8_t {
+        State = 1,        //!< Leader to all: visuals and mix
+        TimeRequest = 2,  //!< Follower to leader: sent_ns is the follower's send time
+        TimeReply = 3,    //!< Leader to follower: echoes that, with its own receive and send times
+    };
+
+    Kind kind = Kind::State;
+    uint64_t node_id = 0;     //!< Sender
+    uint64_t target_id = 0;   //!< TimeReply: the follower that asked
+    int64_t sent_ns = 0;      //!< Sender's clock as it sent
+    int64_t echoed_ns = 0;    //!< TimeReply: the request's sent_ns
+    int64_t received_ns = 0;  //!< TimeReply: the leader's clock as the request arrived
+    SyncVisuals visuals;      //!< State only
+    SyncMix mix;              //!< State only
+
+    void encode(std::array<uint8_t, BYTES>& out) const;
+
+    /**
+     * @return False for anything but a whole packet of this protocol version
+     */
+    static bool decode(const uint8_t* data, size_t size, SyncPacket& packet);
+};
+
+/**
+ * @brief PTP-lite estimate of how far the leader's clock is ahead of this node's
+ *
+ * Each exchange gives four times: request sent (t1, local), received (t2, leader),
+ * reply sent (t3, leader) and received (t4, local). Assuming the path is as long both
+ * ways, the offset is ((t2 - t1) + (t3 - t4)) / 2 and the round trip (t4 - t1) - (t3 - t2).
+ * Queueing only ever lengthens a trip, and lopsidedly, so of the last SYNC_CLOCK_SAMPLES
+ * the sample with the shortest round trip is taken.
+ */
+class ClockOffsetEstimator {
+public:
+    void addSample(int64_t requestSent, int64_t leaderReceived, int64_t leaderSent, int64_t replyReceived);
+
+    bool hasEstimate() const {
+        return _count > 0;
+    }
+
+    /**
+     * @brief Leader clock minus local clock, 0 without an estimate
+     */
+    int64_t getOffsetNs() const;
+
+    /**
+     * @brief Round trip of the sample the offset comes from
+     */
+    int64_t getDelayNs() const;
+
+    void reset() {
+        _count = 0;
+        _next = 0;
+    }
+
+private:
+    struct Sample {
+        int64_t offset = 0;
+        int64_t delay = 0;
+    };
+
+    const Sample* best() const;
+
+    std::array<Sample, Constants::SYNC_CLOCK_SAMPLES> _samples{};
+    size_t _next = 0;
+    size_t _count = 0;
+};
+
+/**
+ * @brief Keeps the screens in one room in step over UDP multicast
+ *
+ * The leader multicasts its state to SYNC_MULTICAST_GROUP every SYNC_STATE_INTERVAL_MS:
+ * beat clock, the latest preset cut and the seed for the draw after it, and the mix it
+ * plays. Preset cuts are announced SYNC_CUT_LEAD_MS before they happen, so every
+ * follower has them in hand in time to cut on the same frame. Followers time themselves
+ * against the leader with ClockOffsetEstimator and hand the state on with its times
+ * moved onto their own clock. Clock exchanges are multicast too, which keeps a node's
+ * socket the only one it needs and works with several nodes on one host.
+ *
+ * Everything happens on one network thread; packets are fixed-size and neither the
+ * thread nor the publish/read calls allocate. POSIX only: start() fails on Windows.
+ */
+class NodeSync : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    explicit NodeSync(SyncRole role);
+
+    /**
+     * @brief Stops the network thread
+     */
+    ~NodeSync();
+
+    NodeSync(const NodeSync&) = delete;
+    NodeSync& operator=(const NodeSync&) = delete;
+
+    /**
+     * @brief Read "off", "leader" or "follower"
+     * @return False, leaving role alone, for anything else
+     */
+    static bool parseRole(const std::string& text, SyncRole& role);
+
+    /**
+     * @brief This node's steady clock, as every time in the protocol is given
+     */
+    static int64_t nowNs();
+
+    /**
+     * @brief Join the group and start the network thread
+     * @return False, with nothing running, if the socket could not be set up
+     */
+    bool start(uint16_t port = Constants::SYNC_MULTICAST_PORT);
+
+    void stop();
+
+    bool isRunning() const {
+        return _thread.joinable();
+    }
+    SyncRole getRole() const {
+        return _role;
+    }
+    uint64_t getNodeId() const {
+        return _nodeId;
+    }
+
+    /**
+     * @brief Leader: what to send from the next state packet on, from any thread
+     */
+    void publishVisuals(const SyncVisuals& visuals);
+    void publishMix(const SyncMix& mix);
+
+    /**
+     * @brief Follower: the leader's latest state, with its times moved onto this node's clock
+     * @return False while no leader is heard or its clock is not measured yet
+     */
+    bool getLeaderState(SyncVisuals& visuals, SyncMix& mix) const;
+
+    /**
+     * @brief Follower: leader clock minus this node's, 0 until measured
+     */
+    int64_t getClockOffsetNs() const {
+        return _clockOffsetNs.load();
+    }
+
+    /**
+     * @brief Leader: the state packet to send now
+     */
+    SyncPacket buildState(int64_t nowNs) const;
+
+    /**
+     * @brief Follower: a clock exchange to start now
+     */
+    SyncPacket buildTimeRequest(int64_t nowNs) const;
+
+    /**
+     * @brief Take in one datagram, as the network thread does; this node's own are ignored
+     * @param reply Filled in when the datagram calls for one
+     * @return True if reply is to be sent
+     */
+    bool receive(const uint8_t* data, size_t size, int64_t receivedNs, SyncPacket& reply);
+
+private:
+    void networkLoop();
+    bool send(const SyncPacket& packet);
+
+    const uint64_t _nodeId;
+    const SyncRole _role;
+    uint16_t _port = 0;
+    int _socket = -1;
+    std::atomic<bool> _stopping{false};
+    std::thread _thread;
+
+    mutable std::mutex _stateMutex;  // Guards the state below
+    SyncVisuals _visuals;            // Leader: its own; follower: the leader's, on the leader's clock
+    SyncMix _mix;
+    uint64_t _leaderId = 0;      // Follower: the leader followed, 0 for none
+    int64_t _leaderHeardNs = 0;  // Follower: local time of its latest state
+
+    ClockOffsetEstimator _clock;  // Network thread
+    std::atomic<int64_t> _clockOffsetNs{0};
+    std::atomic<bool> _clockMeasured{false};
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,92 @@
+#include "power_policy.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Core {
+
+bool PowerPolicy::parseMode(const std::string& name, PowerSavingMode& mode) {
+    const std::string lower = AutoVibez::Utils::StringUtils::toLower(name);
+    if (lower == "off") {
+        mode = PowerSavingMode::Off;
+    } else if (lower == "throttle") {
+        mode = PowerSavingMode::Throttle;
+    } else if (lower == "pause") {
+        mode = PowerSavingMode::Pause;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* PowerPolicy::modeName(PowerSavingMode mode) {
+    switch (mode) {
+        case PowerSavingMode::Off:
+            return "off";
+        case PowerSavingMode::Throttle:
+            return "throttle";
+        case PowerSavingMode::Pause:
+            return "pause";
+    }
+    return "off";
+}
+
+void PowerPolicy::configure(PowerSavingMode mode, double idle_fps, bool when_unfocused) {
+    _mode = mode;
+    _idleFps = std::clamp(idle_fps, static_cast<double>(Constants::POWER_SAVING_MIN_FPS),
+                          static_cast<double>(Constants::DEFAULT_FPS_VALUE));
+    _whenUnfocused = when_unfocused;
+}
+
+bool PowerPolicy::onWindowEvent(uint8_t event) {
+    const PowerState before = getState();
+    switch (event) {
+        case SDL_WINDOWEVENT_MINIMIZED:
+            _minimized = true;
+            break;
+        case SDL_WINDOWEVENT_HIDDEN:
+            _hidden = true;
+            break;
+        case SDL_WINDOWEVENT_SHOWN:
+        case SDL_WINDOWEVENT_EXPOSED:
+        case SDL_WINDOWEVENT_RESTORED:
+        case SDL_WINDOWEVENT_MAXIMIZED:
+            // Whichever arrives first means something is on screen again
+            _minimized = false;
+            _hidden = false;
+            break;
+        case SDL_WINDOWEVENT_FOCUS_GAINED:
+            _focused = true;
+            break;
+        case SDL_WINDOWEVENT_FOCUS_LOST:
+            _focused = false;
+            break;
+        default:
+            break;
+    }
+    return getState() != before;
+}
+
+PowerState PowerPolicy::getState() const {
+    if (_mode == PowerSavingMode::Off) {
+        return PowerState::Full;
+    }
+    if (_minimized || _hidden) {
+        return _mode == PowerSavingMode::Pause ? PowerState::Paused : PowerState::Throttled;
+    }
+    // Still visible, so never paused
+    return !_focused && _whenUnfocused ? PowerState::Throttled : PowerState::Full;
+}
+
+int PowerPolicy::getIdleIntervalMs() const {
+    // Paused still ticks to drain the PCM ring, which must not fill in between
+    const double fps = getState() == PowerState::Paused ? 0.0 : _idleFps;
+    return static_cast<int>(std::lround(1000.0 / std::max(fps, static_cast<double>(Constants::POWER_SAVING_MIN_FPS))));
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief What the render loop does while nobody can see the window
+ */
+enum class PowerSavingMode {
+    Off,       //!< Always render at the paced rate
+    Throttle,  //!< Keep rendering, at the idle rate
+    Pause      //!< Stop drawing; audio is still drained at the idle tick
+};
+
+/**
+ * @brief How the loop should run right now
+ */
+enum class PowerState {
+    Full,       //!< Paced as configured
+    Throttled,  //!< Render at the idle rate without vsync
+    Paused      //!< Drain audio and handle events only
+};
+
+/**
+ * @brief Turns the main window's visibility and focus into a render rate
+ *
+ * Fed with SDL_WINDOWEVENT_* codes for the main window. A minimized or hidden window
+ * throttles or pauses depending on the mode; losing focus only throttles, and only
+ * when enabled, because a visualizer beside the focused application is still watched.
+ * SDL 2 reports no occlusion as such; compositors that track it send hidden and shown.
+ * Any event that makes the window visible again reports Full at once.
+ */
+class PowerPolicy {
+public:
+    /**
+     * @brief Parse "off", "throttle" or "pause" (case-insensitive)
+     * @return True if the name was recognized
+     */
+    static bool parseMode(const std::string& name, PowerSavingMode& mode);
+
+    static const char* modeName(PowerSavingMode mode);
+
+    /**
+     * @brief Choose what happens when the window cannot be seen
+     * @param idle_fps Rate while throttled (clamped to POWER_SAVING_MIN_FPS to DEFAULT_FPS_VALUE)
+     * @param when_unfocused Also throttle while another application has focus
+     */
+    void configure(PowerSavingMode mode, double idle_fps, bool when_unfocused);
+
+    /**
+     * @brief Track one SDL_WINDOWEVENT_* of the main window
+     * @return True if getState() changed
+     */
+    bool onWindowEvent(uint8_t event);
+
+    PowerState getState() const;
+
+    /**
+     * @brief Milliseconds between loop iterations while not Full
+     */
+    int getIdleIntervalMs() const;
+
+private:
+    PowerSavingMode _mode = PowerSavingMode::Off;
+    double _idleFps = 0.0;
+    bool _whenUnfocused = false;
+    bool _minimized = false;
+    bool _hidden = false;
+    bool _focused = true;
+};
+
+}  // namespace AutoVibez::Core
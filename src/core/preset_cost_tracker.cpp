@@ -0,0 +1,61 @@
+#include "preset_cost_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace AutoVibez::Core {
+
+namespace {
+double mean(const std::vector<double>& values) {
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+// Nearest-rank 95th percentile; sorts in place
+double p95(std::vector<double>& values) {
+    std::sort(values.begin(), values.end());
+    const size_t index = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(values.size())));
+    return values[std::min(values.size(), std::max<size_t>(index, 1)) - 1];
+}
+}  // namespace
+
+PresetCostTracker::PresetCostTracker(int warmupFrames, int minFrames, int maxFrames)
+    : _warmupFrames(std::max(0, warmupFrames)),
+      _minFrames(std::max(1, minFrames)),
+      _maxFrames(static_cast<size_t>(std::max(minFrames, maxFrames))) {}
+
+void PresetCostTracker::addFrame(const std::string& preset, double cpu_ms, double gpu_ms) {
+    if (preset != _preset) {
+        flush();
+        _preset = preset;
+    }
+    if (_preset.empty() || cpu_ms < 0.0 || ++_seenFrames <= _warmupFrames || _cpu.size() >= _maxFrames) {
+        return;
+    }
+    _cpu.push_back(cpu_ms);
+    if (gpu_ms > 0.0) {
+        _gpu.push_back(gpu_ms);
+    }
+}
+
+void PresetCostTracker::flush() {
+    if (_sink && !_preset.empty() && static_cast<int>(_cpu.size()) >= _minFrames) {
+        AutoVibez::Data::PresetCost cost;
+        cost.path = _preset;
+        cost.frames = static_cast<int>(_cpu.size());
+        cost.cpu_ms = mean(_cpu);
+        cost.cpu_p95_ms = p95(_cpu);
+        // GPU timings only count when most frames have one
+        if (_gpu.size() * 2 >= _cpu.size()) {
+            cost.gpu_ms = mean(_gpu);
+            cost.gpu_p95_ms = p95(_gpu);
+        }
+        _sink(cost);
+    }
+    _preset.clear();
+    _seenFrames = 0;
+    _cpu.clear();
+    _gpu.clear();
+}
+
+}  // namespace AutoVibez::Core
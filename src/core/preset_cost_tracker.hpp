@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "constants.hpp"
+#include "preset_cost_database.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Turns per-frame render timings into one cost sample per preset visit
+ *
+ * Frames arrive tagged with the preset that was showing. The first warm-up
+ * frames of a visit are ignored: they carry the shader compile hitch and, with
+ * soft cuts, the blend with the outgoing preset. When the preset changes, a
+ * visit with enough measured frames is reduced to means and 95th percentiles and
+ * handed to the sink. Render thread only; the sink should defer any I/O.
+ */
+class PresetCostTracker {
+public:
+    using Sink = std::function<void(const AutoVibez::Data::PresetCost&)>;
+
+    explicit PresetCostTracker(int warmupFrames = Constants::PRESET_COST_WARMUP_FRAMES,
+                               int minFrames = Constants::PRESET_COST_MIN_FRAMES,
+                               int maxFrames = Constants::PRESET_COST_MAX_FRAMES);
+
+    void setSink(Sink sink) {
+        _sink = std::move(sink);
+    }
+
+    /**
+     * @brief Add one frame's render timings
+     * @param preset Preset that rendered the frame
+     * @param cpu_ms CPU time in projectM's render call (negative if it did not run)
+     * @param gpu_ms GPU time of the same call (0 or negative when unknown)
+     */
+    void addFrame(const std::string& preset, double cpu_ms, double gpu_ms);
+
+    /**
+     * @brief End the current visit now, emitting it if it has enough frames
+     */
+    void flush();
+
+    const std::string& getCurrentPreset() const {
+        return _preset;
+    }
+
+private:
+    int _warmupFrames;
+    int _minFrames;
+    size_t _maxFrames;
+    Sink _sink;
+
+    std::string _preset;
+    int _seenFrames = 0;  // Including warm-up
+    std::vector<double> _cpu;
+    std::vector<double> _gpu;
+};
+
+}  // namespace AutoVibez::Core
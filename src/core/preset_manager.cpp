@@ -3,8 +3,11 @@
 #include <random>  // Added for random preset selection
 
 #include "autovibez_app.hpp"
+#include "constants.hpp"
 #include "mix_manager.hpp"
 
+using AutoVibez::Core::PresetPreloader;
+
 PresetManager::PresetManager(projectm_playlist_handle playlist)
     : _playlist(playlist), _randomGenerator(std::random_device{}()) {}
 
@@ -13,9 +16,93 @@ void PresetManager::randomPreset() {
         // Use a different approach for random preset since projectm_playlist_play_random doesn't exist
         uint32_t preset_count = projectm_playlist_size(_playlist);
         if (preset_count > 0) {
-            std::uniform_int_distribution<uint32_t> dis(0, preset_count - 1);
-            uint32_t random_index = dis(_randomGenerator);
-            projectm_playlist_set_position(_playlist, random_index, true);
+            if (_upcomingPath.empty() || _upcomingIndex >= preset_count) {
+                chooseUpcoming(preset_count);
+            }
+
+            // A preset the preloader could not read would fail on the render thread too; its replacement is
+            // not preloaded yet, so the switch reads it as before
+            if (_preloader.getState(_upcomingPath) == PresetPreloader::State::Failed) {
+                chooseUpcoming(_upcomingIndex);
+            }
+
+            uint32_t index = _upcomingIndex;
+            chooseUpcoming(index);
+            projectm_playlist_set_position(_playlist, index, true);
+        }
+    }
+}
+
+uint32_t PresetManager::peekUpcoming() {
+    if (!_playlist) {
+        return UINT32_MAX;
+    }
+    uint32_t preset_count = projectm_playlist_size(_playlist);
+    if (preset_count == 0) {
+        return UINT32_MAX;
+    }
+    if (_upcomingPath.empty() || _upcomingIndex >= preset_count) {
+        chooseUpcoming(projectm_playlist_get_position(_playlist));
+    }
+    if (_preloader.getState(_upcomingPath) == PresetPreloader::State::Failed) {
+        chooseUpcoming(_upcomingIndex);
+    }
+    return _upcomingIndex;
+}
+
+void PresetManager::playPreset(uint32_t index, uint32_t seed) {
+    if (!_playlist || index >= projectm_playlist_size(_playlist)) {
+        return;
+    }
+    _randomGenerator.seed(seed);
+    chooseUpcoming(index);
+    projectm_playlist_set_position(_playlist, index, true);
+}
+
+void PresetManager::onPlaylistChanged() {
+    if (_playlist) {
+        chooseUpcoming(projectm_playlist_get_position(_playlist));
+    }
+}
+
+void PresetManager::updateConditions(double energy, double onsetRate, double renderBudgetMs, double centroidHz) {
+    if (!_playlist || _scheduler.size() == 0) {
+        return;
+    }
+    const bool fitted = _scheduler.fits(_upcomingIndex);
+    const bool sectionChanged = _scheduler.update(energy, onsetRate, renderBudgetMs, centroidHz);
+    if (!_upcomingPath.empty() && (sectionChanged || (fitted && !_scheduler.fits(_upcomingIndex)))) {
+        chooseUpcoming(projectm_playlist_get_position(_playlist));
+    }
+}
+
+void PresetManager::chooseUpcoming(uint32_t current) {
+    uint32_t preset_count = projectm_playlist_size(_playlist);
+    if (preset_count == 0) {
+        _upcomingPath.clear();
+        return;
+    }
+
+    std::uniform_int_distribution<uint32_t> dis(0, preset_count - 1);
+    const bool scheduled = _scheduler.size() == preset_count;
+    // Redraw past presets measured as too slow, but give up rather than loop when most of them are
+    for (int draw = 0; draw < Constants::PRESET_SLOW_REDRAWS; ++draw) {
+        _upcomingIndex = scheduled ? _scheduler.draw(_randomGenerator, current) : UINT32_MAX;
+        if (_upcomingIndex == UINT32_MAX) {
+            _upcomingIndex = dis(_randomGenerator);
+            if (preset_count > 1 && _upcomingIndex == current) {
+                _upcomingIndex = (_upcomingIndex + 1 + dis(_randomGenerator) % (preset_count - 1)) % preset_count;
+            }
+        }
+
+        char* path = projectm_playlist_item(_playlist, _upcomingIndex);
+        _upcomingPath = path ? path : "";
+        if (path) {
+            projectm_playlist_free_string(path);
+        }
+        if (_slowPresets.count(_upcomingPath) == 0) {
+            break;
         }
     }
-}
\ No newline at end of file
+    _preloader.request(_upcomingPath);
+}
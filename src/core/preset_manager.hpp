@@ -2,8 +2,16 @@
 
 #include <projectM-4/playlist.h>
 
+#include <cstdint>
 #include <random>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "preset_preloader.hpp"
+#include "preset_scheduler.hpp"
 
 class PresetManager {
 public:
@@ -11,10 +19,106 @@ public:
 
     /**
      * Jump to random preset
+     *
+     * The preset is the one chosen on the previous call (so it has been preloaded),
+     * after which the next one is chosen and handed to the preloader.
      */
     void randomPreset();
 
+    /**
+     * @brief Playlist index the next randomPreset() switches to, redrawn first if its preload failed
+     * @return UINT32_MAX with no presets
+     */
+    uint32_t peekUpcoming();
+
+    /**
+     * @brief Switch to a preset, then draw the one after it from the given seed
+     *
+     * Nodes with the same playlist that play the same index with the same seed go on to
+     * preload the same upcoming preset, which is how synced screens cut in step.
+     */
+    void playPreset(uint32_t index, uint32_t seed);
+
+    /**
+     * @brief Draw the upcoming preset again after playlist entries were removed (its index may have moved)
+     */
+    void onPlaylistChanged();
+
+    /**
+     * @brief Path of the preset the next randomPreset() will switch to (empty with no presets)
+     */
+    std::string getUpcomingPreset() const {
+        return _upcomingPath;
+    }
+
+    /**
+     * @brief Where the preloader is with the upcoming preset
+     */
+    AutoVibez::Core::PresetPreloader::State getUpcomingState() const {
+        return _preloader.getState(_upcomingPath);
+    }
+
+    /**
+     * @brief Pass each preloaded preset's text on, on the preloader's thread
+     */
+    void setPreloadCallback(AutoVibez::Core::PresetPreloader::ReadCallback callback) {
+        _preloader.setReadCallback(std::move(callback));
+    }
+
+    /**
+     * @brief Presets too slow for this machine; random draws avoid them while others remain
+     */
+    void setSlowPresets(std::unordered_set<std::string> paths) {
+        _slowPresets = std::move(paths);
+    }
+    void addSlowPreset(const std::string& path) {
+        _slowPresets.insert(path);
+    }
+    size_t getSlowPresetCount() const {
+        return _slowPresets.size();
+    }
+
+    /**
+     * @brief Draw presets by render cost and musical intensity instead of uniformly (see PresetScheduler)
+     *
+     * Call again whenever presets are added or removed; until the playlist matches
+     * the paths given here, draws are uniform again.
+     * @param paths Preset paths in playlist order
+     * @param costs Measured render cost per path in ms
+     * @param budgetMs Frame budget
+     */
+    void schedulePresets(const std::vector<std::string>& paths, const std::unordered_map<std::string, double>& costs,
+                         double budgetMs) {
+        _scheduler.rebuild(paths, costs, budgetMs);
+    }
+    void setPresetCost(const std::string& path, double costMs) {
+        _scheduler.setCost(path, costMs);
+    }
+
+    /**
+     * @brief Feed the music and the frame time to the scheduler (once per frame)
+     *
+     * The upcoming preset is drawn again when the section changes or it no longer fits
+     * the render budget, early enough to be preloaded before the cut.
+     */
+    void updateConditions(double energy, double onsetRate, double renderBudgetMs, double centroidHz = 0.0);
+
+    const AutoVibez::Core::PresetScheduler& getScheduler() const {
+        return _scheduler;
+    }
+
 private:
+    /**
+     * @brief Draw the preset after the current one and start preloading it
+     * @param current Playlist position to avoid repeating
+     */
+    void chooseUpcoming(uint32_t current);
+
     projectm_playlist_handle _playlist;
     std::mt19937 _randomGenerator;  // Persistent random generator for better randomness
-};
\ No newline at end of file
+    uint32_t _upcomingIndex = 0;
+    std::string _upcomingPath;  // Empty until chosen
+    AutoVibez::Core::PresetPreloader _preloader;
+    std::unordered_set<std::string> _slowPresets;
+    AutoVibez::Core::PresetScheduler _scheduler;  // Empty (uniform draws) unless schedulePresets was called
+};
@@ -0,0 +1,97 @@
+#include "preset_preloader.hpp"
+
+#include <fstream>
+#include <utility>
+
+namespace AutoVibez::Core {
+
+PresetPreloader::PresetPreloader() : _thread(&PresetPreloader::run, this) {}
+
+PresetPreloader::~PresetPreloader() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void PresetPreloader::request(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (path == _path && _state != State::Idle) {
+            return;
+        }
+        _path = path;
+        _state = path.empty() ? State::Idle : State::Loading;
+        _pending = !path.empty();
+    }
+    _wake.notify_one();
+}
+
+void PresetPreloader::setReadCallback(ReadCallback callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _readCallback = std::move(callback);
+}
+
+PresetPreloader::State PresetPreloader::getState(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return path == _path ? _state : State::Idle;
+}
+
+uint64_t PresetPreloader::getLoadedBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _loadedBytes;
+}
+
+bool PresetPreloader::readPreset(const std::string& path, uint64_t& bytes, std::string* contents) {
+    bytes = 0;
+    if (contents) {
+        contents->clear();
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    char buffer[16384];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        bytes += static_cast<uint64_t>(file.gcount());
+        if (contents) {
+            contents->append(buffer, static_cast<size_t>(file.gcount()));
+        }
+    }
+    return bytes > 0;
+}
+
+void PresetPreloader::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _wake.wait(lock, [this] { return _stop || _pending; });
+        if (_stop) {
+            return;
+        }
+        const std::string path = _path;
+        const ReadCallback callback = _readCallback;
+        _pending = false;
+
+        lock.unlock();
+        uint64_t bytes = 0;
+        std::string contents;
+        const bool ok = readPreset(path, bytes, callback ? &contents : nullptr);
+        if (ok && callback) {
+            callback(contents);
+        }
+        lock.lock();
+
+        // A newer request owns the state now
+        if (path != _path || _pending) {
+            continue;
+        }
+        _state = ok ? State::Ready : State::Failed;
+        if (ok) {
+            _loadedBytes = bytes;
+        }
+    }
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Reads the upcoming preset on a worker thread before the switch that needs it
+ *
+ * projectM parses and compiles a preset inside the call that loads it, on the
+ * render thread's context, and has no way to accept a program built elsewhere.
+ * What can move off the render thread is the file read: the worker pulls the
+ * whole file through the OS cache, so the switch reads it from memory, and
+ * reports presets that cannot be read so they are skipped before they would
+ * cost a failed switch. Only the most recent request matters; an older one that
+ * has not started yet is replaced.
+ */
+class PresetPreloader {
+public:
+    enum class State {
+        Idle,     //!< Not the requested preset (or nothing requested)
+        Loading,  //!< Queued or being read
+        Ready,    //!< Read completely; the switch will hit the cache
+        Failed    //!< Missing, unreadable or empty
+    };
+
+    /**
+     * @brief Called on the worker with the text of each preset read completely
+     */
+    using ReadCallback = std::function<void(const std::string& contents)>;
+
+    PresetPreloader();
+    ~PresetPreloader();
+
+    PresetPreloader(const PresetPreloader&) = delete;
+    PresetPreloader& operator=(const PresetPreloader&) = delete;
+
+    /**
+     * @brief Start reading a preset, replacing any earlier request
+     */
+    void request(const std::string& path);
+
+    /**
+     * @brief Hand each preset's text on once it has been read (the texture cache prefetches what it samples)
+     */
+    void setReadCallback(ReadCallback callback);
+
+    /**
+     * @brief Where the preloader is with a preset
+     */
+    State getState(const std::string& path) const;
+
+    /**
+     * @brief Size of the preset read last, in bytes (0 until one is Ready)
+     */
+    uint64_t getLoadedBytes() const;
+
+    /**
+     * @brief Read a preset file to the end
+     * @param bytes Set to the number of bytes read
+     * @param contents Receives the text when not null
+     * @return True if the file opened and was not empty
+     */
+    static bool readPreset(const std::string& path, uint64_t& bytes, std::string* contents = nullptr);
+
+private:
+    void run();
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::string _path;  // Most recent request
+    State _state = State::Idle;
+    bool _pending = false;  // _path has not been picked up by the worker yet
+    uint64_t _loadedBytes = 0;
+    ReadCallback _readCallback;
+    bool _stop = false;
+    std::thread _thread;
+};
+
+}  // namespace AutoVibez::Core
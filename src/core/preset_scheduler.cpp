@@ -0,0 +1,154 @@
+#include "preset_scheduler.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+// Share of draws per bucket (light, medium, heavy) in each section
+constexpr uint32_t TIER_WEIGHTS[3][PresetScheduler::TIER_COUNT] = {
+    {70, 25, 5},   // Breakdown
+    {30, 50, 20},  // Groove
+    {10, 30, 60},  // Peak
+};
+
+constexpr double GROOVE_FROM = 1.0 / 3.0;  // Intensity boundaries between the sections
+constexpr double PEAK_FROM = 2.0 / 3.0;
+
+size_t tierOf(PresetTier tier) {
+    return static_cast<size_t>(tier);
+}
+}  // namespace
+
+void PresetScheduler::rebuild(const std::vector<std::string>& paths,
+                              const std::unordered_map<std::string, double>& costs, double budgetMs) {
+    _budgetMs = budgetMs;
+    _costs.assign(paths.size(), -1.0);
+    _indexOf.clear();
+    for (uint32_t index = 0; index < paths.size(); ++index) {
+        _indexOf[paths[index]] = index;
+        auto cost = costs.find(paths[index]);
+        if (cost != costs.end()) {
+            _costs[index] = cost->second;
+        }
+    }
+    sortBuckets();
+}
+
+void PresetScheduler::setCost(const std::string& path, double costMs) {
+    auto index = _indexOf.find(path);
+    if (index == _indexOf.end() || _costs[index->second] == costMs) {
+        return;
+    }
+    _costs[index->second] = costMs;
+    sortBuckets();
+}
+
+void PresetScheduler::sortBuckets() {
+    for (auto& bucket : _buckets) {
+        bucket.clear();
+    }
+    _slots.assign(_costs.size(), Slot());
+    for (uint32_t index = 0; index < _costs.size(); ++index) {
+        const double cost = _costs[index];
+        PresetTier tier = PresetTier::Medium;
+        if (cost >= 0.0 && cost <= Constants::PRESET_LIGHT_BUDGET_SHARE * _budgetMs) {
+            tier = PresetTier::Light;
+        } else if (cost > Constants::PRESET_HEAVY_BUDGET_SHARE * _budgetMs) {
+            tier = PresetTier::Heavy;
+        }
+        _buckets[tierOf(tier)].push_back({index, std::max(0.0, cost)});
+        _slots[index].tier = tier;
+    }
+    for (auto& bucket : _buckets) {
+        std::stable_sort(bucket.begin(), bucket.end(),
+                         [](const Entry& a, const Entry& b) { return a.cost_ms < b.cost_ms; });
+        for (uint32_t position = 0; position < bucket.size(); ++position) {
+            _slots[bucket[position].index].position = position;
+        }
+    }
+    updateEligible();
+}
+
+void PresetScheduler::updateEligible() {
+    for (size_t tier = 0; tier < TIER_COUNT; ++tier) {
+        const auto& bucket = _buckets[tier];
+        auto end = std::upper_bound(bucket.begin(), bucket.end(), _renderBudgetMs,
+                                    [](double budget, const Entry& entry) { return budget < entry.cost_ms; });
+        _eligible[tier] = static_cast<size_t>(end - bucket.begin());
+    }
+}
+
+bool PresetScheduler::update(double energy, double onsetRate, double renderBudgetMs, double centroidHz) {
+    const double loudness = std::clamp((energy - Constants::PRESET_ENERGY_LOW) /
+                                           (Constants::PRESET_ENERGY_HIGH - Constants::PRESET_ENERGY_LOW),
+                                       0.0, 1.0);
+    const double busyness = std::clamp(onsetRate / Constants::PRESET_ONSET_RATE_HIGH, 0.0, 1.0);
+    if (centroidHz > 0.0) {
+        const double range = Constants::PRESET_CENTROID_BRIGHT_HZ - Constants::PRESET_CENTROID_DARK_HZ;
+        const double brightness = std::clamp((centroidHz - Constants::PRESET_CENTROID_DARK_HZ) / range, 0.0, 1.0);
+        _intensity = (loudness + busyness + brightness) / 3.0;
+    } else {
+        _intensity = 0.5 * (loudness + busyness);
+    }
+
+    // Only a clear move past a boundary changes the section, so music hovering on one does not flap
+    const double margin = Constants::PRESET_SECTION_HYSTERESIS;
+    MusicSection section = _section;
+    if (_intensity < GROOVE_FROM - margin) {
+        section = MusicSection::Breakdown;
+    } else if (_intensity > PEAK_FROM + margin) {
+        section = MusicSection::Peak;
+    } else if ((_section == MusicSection::Breakdown && _intensity > GROOVE_FROM + margin) ||
+               (_section == MusicSection::Peak && _intensity < PEAK_FROM - margin)) {
+        section = MusicSection::Groove;
+    }
+
+    if (renderBudgetMs != _renderBudgetMs) {
+        _renderBudgetMs = renderBudgetMs;
+        updateEligible();
+    }
+    const bool changed = section != _section;
+    _section = section;
+    return changed;
+}
+
+bool PresetScheduler::fits(uint32_t index) const {
+    return index < _slots.size() && _slots[index].position < _eligible[tierOf(_slots[index].tier)];
+}
+
+uint32_t PresetScheduler::draw(std::mt19937& random, uint32_t avoid) const {
+    const bool skip = fits(avoid);
+    std::array<size_t, TIER_COUNT> counts{};
+    uint32_t total = 0;
+    for (size_t tier = 0; tier < TIER_COUNT; ++tier) {
+        counts[tier] = _eligible[tier] - (skip && tierOf(_slots[avoid].tier) == tier ? 1 : 0);
+        if (counts[tier] > 0) {
+            total += TIER_WEIGHTS[static_cast<size_t>(_section)][tier];
+        }
+    }
+    if (total == 0) {
+        return UINT32_MAX;
+    }
+
+    uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(random);
+    size_t tier = 0;
+    for (; tier < TIER_COUNT - 1; ++tier) {
+        const uint32_t weight = counts[tier] > 0 ? TIER_WEIGHTS[static_cast<size_t>(_section)][tier] : 0;
+        if (pick < weight) {
+            break;
+        }
+        pick -= weight;
+    }
+
+    // Uniform over the eligible entries with the avoided one taken out
+    size_t position = std::uniform_int_distribution<size_t>(0, counts[tier] - 1)(random);
+    if (skip && tierOf(_slots[avoid].tier) == tier && position >= _slots[avoid].position) {
+        ++position;
+    }
+    return _buckets[tier][position].index;
+}
+
+}  // namespace AutoVibez::Core
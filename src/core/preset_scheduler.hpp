@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief How heavy a preset is to render, as a share of the frame budget
+ */
+enum class PresetTier : uint8_t { Light, Medium, Heavy };
+
+/**
+ * @brief How intense the music is at the moment
+ */
+enum class MusicSection : uint8_t { Breakdown, Groove, Peak };
+
+/**
+ * @brief Random preset draws weighted by render cost and by how intense the music is
+ *
+ * Presets are sorted into light, medium and heavy buckets by their measured cost as a
+ * share of the frame budget (unmeasured ones count as medium), each bucket cheapest
+ * first. The beat tracker's energy and onset rate place the music in a breakdown, a
+ * groove or a peak, with the spectral centroid adding brightness when it is known (filter
+ * sweeps darken breakdowns), which sets how often each bucket is drawn from: heavy presets
+ * mostly at peaks, light ones in breakdowns. Only the part of each bucket that fits the render
+ * time the rest of the frame leaves is eligible. Those bounds are found when the
+ * conditions change, so a draw is one weighted pick among three buckets and one uniform
+ * index, whatever the size of the library. Render thread only.
+ */
+class PresetScheduler {
+public:
+    static constexpr size_t TIER_COUNT = 3;
+
+    /**
+     * @brief Sort a playlist into the buckets
+     * @param paths Preset paths in playlist order
+     * @param costs Measured render cost per path in ms; presets missing from it are unmeasured
+     * @param budgetMs Frame budget the tiers are shares of
+     */
+    void rebuild(const std::vector<std::string>& paths, const std::unordered_map<std::string, double>& costs,
+                 double budgetMs);
+
+    /**
+     * @brief Move a preset to the bucket its new measurement puts it in
+     */
+    void setCost(const std::string& path, double costMs);
+
+    /**
+     * @brief Take in the music and the frame time
+     * @param energy BeatState::energy (1 is the stream's usual level)
+     * @param onsetRate BeatState::onset_rate
+     * @param renderBudgetMs Render time the rest of the frame leaves a preset
+     * @param centroidHz AudioFeatures::centroid_hz, 0 when unknown (then only energy and onsets count)
+     * @return True if the section changed
+     */
+    bool update(double energy, double onsetRate, double renderBudgetMs, double centroidHz = 0.0);
+
+    /**
+     * @brief Draw a preset for the current section among those that fit the render budget
+     * @param avoid Playlist index not to draw (the current preset), if another is eligible
+     * @return Playlist index, or UINT32_MAX if no other preset is eligible
+     */
+    uint32_t draw(std::mt19937& random, uint32_t avoid) const;
+
+    /**
+     * @brief Whether a preset fits the render budget of the last update
+     */
+    bool fits(uint32_t index) const;
+
+    PresetTier getTier(uint32_t index) const {
+        return index < _slots.size() ? _slots[index].tier : PresetTier::Medium;
+    }
+    MusicSection getSection() const {
+        return _section;
+    }
+
+    /**
+     * @brief Intensity of the music from the last update, 0 (silence) to 1 (loud and busy)
+     */
+    double getIntensity() const {
+        return _intensity;
+    }
+
+    /**
+     * @brief Presets sorted, 0 before the first rebuild
+     */
+    size_t size() const {
+        return _slots.size();
+    }
+
+private:
+    struct Entry {
+        uint32_t index = 0;
+        double cost_ms = 0.0;  // Unmeasured presets sort and fit as free
+    };
+    struct Slot {
+        PresetTier tier = PresetTier::Medium;
+        uint32_t position = 0;  // In its bucket
+    };
+
+    void sortBuckets();
+    void updateEligible();
+
+    double _budgetMs = 0.0;
+    std::vector<double> _costs;  // By playlist index, negative when unmeasured
+    std::unordered_map<std::string, uint32_t> _indexOf;
+    std::array<std::vector<Entry>, TIER_COUNT> _buckets;
+    std::vector<Slot> _slots;                    // By playlist index
+    std::array<size_t, TIER_COUNT> _eligible{};  // Leading entries of each bucket that fit the render budget
+    double _renderBudgetMs = std::numeric_limits<double>::infinity();
+    double _intensity = 0.5;
+    MusicSection _section = MusicSection::Groove;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,38 @@
+#include "preset_table.hpp"
+
+#include <utility>
+
+namespace AutoVibez::Core {
+
+void PresetTable::rebuild(projectm_playlist_handle playlist) {
+    std::vector<std::string> paths;
+    const uint32_t count = playlist ? projectm_playlist_size(playlist) : 0;
+    if (count > 0) {
+        // One call copies the whole list, instead of one allocation per item
+        char** items = projectm_playlist_items(playlist, 0, count);
+        if (items) {
+            paths.reserve(count);
+            for (char** item = items; *item; ++item) {
+                paths.emplace_back(*item);
+            }
+            projectm_playlist_free_string_array(items);
+        }
+    }
+    assign(std::move(paths));
+}
+
+void PresetTable::assign(std::vector<std::string> paths) {
+    _paths = std::move(paths);
+    _names.clear();
+    _names.reserve(_paths.size());
+    for (const std::string& path : _paths) {
+        _names.push_back(makeDisplayName(path));
+    }
+}
+
+std::string PresetTable::makeDisplayName(const std::string& path) {
+    const size_t separator = path.find_last_of("/\\");
+    return separator == std::string::npos ? path : path.substr(separator + 1);
+}
+
+}  // namespace AutoVibez::Core
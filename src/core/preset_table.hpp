@@ -0,0 +1,67 @@
+#pragma once
+
+#include <projectM-4/playlist.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Playlist paths and display names by playlist index, built once per playlist change
+ *
+ * projectm_playlist_item allocates a copy of the path on every call. The switch callback,
+ * key handlers and overlays look presets up here instead: a vector index returning a
+ * reference, with the display name (the file name) cut out in advance. Rebuild it
+ * whenever presets are added to or removed from the playlist. Render thread only.
+ */
+class PresetTable {
+public:
+    /**
+     * @brief Replace the table with every item of the playlist
+     */
+    void rebuild(projectm_playlist_handle playlist);
+
+    /**
+     * @brief Replace the table with the given paths, in playlist order
+     */
+    void assign(std::vector<std::string> paths);
+
+    size_t size() const {
+        return _paths.size();
+    }
+
+    /**
+     * @brief Every path, in playlist order
+     */
+    const std::vector<std::string>& getPaths() const {
+        return _paths;
+    }
+
+    /**
+     * @brief Path at a playlist index (empty when out of range)
+     */
+    const std::string& getPath(uint32_t index) const {
+        return index < _paths.size() ? _paths[index] : _empty;
+    }
+
+    /**
+     * @brief File name at a playlist index (empty when out of range)
+     */
+    const std::string& getDisplayName(uint32_t index) const {
+        return index < _names.size() ? _names[index] : _empty;
+    }
+
+    /**
+     * @brief The part of a path after its last separator
+     */
+    static std::string makeDisplayName(const std::string& path);
+
+private:
+    std::vector<std::string> _paths;
+    std::vector<std::string> _names;
+    std::string _empty;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,214 @@
+#include "quality_governor.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+
+namespace AutoVibez::Core {
+
+namespace {
+struct QualityProfile {
+    const char* name;
+    int min_mesh_x;
+    int min_fps;
+    double min_render_scale;
+};
+
+// Floors only: the configured Mesh X, FPS and render_scale are the ceilings
+constexpr QualityProfile PROFILES[] = {
+    {"low", 12, 30, 0.5},
+    {"medium", 24, 30, 0.6},
+    {"high", 32, 45, 0.75},
+};
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string formatChange(const char* what, double from, double to, int precision) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "%s %.*f -> %.*f", what, precision, from, precision, to);
+    return text;
+}
+}  // namespace
+
+QualityGovernor::QualityGovernor()
+    : _meshAspect(static_cast<double>(Constants::DEFAULT_MESH_Y) / Constants::DEFAULT_MESH_X) {
+    setBounds(QualityBounds(), _meshAspect);
+}
+
+void QualityGovernor::setBounds(const QualityBounds& bounds, double meshAspect) {
+    _bounds = bounds;
+    _bounds.max_mesh_x = std::max(1, _bounds.max_mesh_x);
+    _bounds.min_mesh_x = std::clamp(_bounds.min_mesh_x, 1, _bounds.max_mesh_x);
+    _bounds.max_fps = std::max(1, _bounds.max_fps);
+    _bounds.min_fps = std::clamp(_bounds.min_fps, 1, _bounds.max_fps);
+    _bounds.max_render_scale = std::clamp(_bounds.max_render_scale, Constants::RENDER_SCALE_QUANTUM, 1.0);
+    _bounds.min_render_scale =
+        std::clamp(_bounds.min_render_scale, Constants::RENDER_SCALE_QUANTUM, _bounds.max_render_scale);
+    _meshAspect = meshAspect > 0.0 ? meshAspect : 1.0;
+
+    setMesh(_bounds.max_mesh_x);
+    _settings.fps = _bounds.max_fps;
+    _settings.render_scale = _bounds.max_render_scale;
+    _cpuSumMs = 0.0;
+    _gpuSumMs = 0.0;
+    _frames = 0;
+    _calmWindows = 0;
+    _settleFrames = Constants::QUALITY_SETTLE_FRAMES;
+    _lastDecision.clear();
+}
+
+bool QualityGovernor::getProfileBounds(const std::string& profile, QualityBounds& bounds) {
+    for (const auto& entry : PROFILES) {
+        if (profile == entry.name) {
+            bounds.min_mesh_x = entry.min_mesh_x;
+            bounds.min_fps = entry.min_fps;
+            bounds.min_render_scale = entry.min_render_scale;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string QualityGovernor::detectProfile(const std::string& renderer) {
+    const std::string name = toLower(renderer);
+    for (const char* software : {"llvmpipe", "softpipe", "swrast", "software"}) {
+        if (name.find(software) != std::string::npos) {
+            return "low";
+        }
+    }
+    // Integrated and embedded GPUs
+    for (const char* integrated : {"intel", "mali", "adreno", "videocore", "v3d", "powervr", "vivante"}) {
+        if (name.find(integrated) != std::string::npos) {
+            return "medium";
+        }
+    }
+    return "high";
+}
+
+bool QualityGovernor::addFrame(double cpuMs, double gpuMs) {
+    if (cpuMs <= 0.0) {
+        return false;
+    }
+    if (_settleFrames > 0) {
+        --_settleFrames;
+        return false;
+    }
+    _cpuSumMs += cpuMs;
+    _gpuSumMs += std::max(0.0, gpuMs);
+    if (++_frames < Constants::QUALITY_WINDOW_FRAMES) {
+        return false;
+    }
+
+    const double cpuShare = _cpuSumMs / _frames / getBudgetMs();
+    const double gpuShare = _gpuSumMs / _frames / getBudgetMs();
+    _cpuSumMs = 0.0;
+    _gpuSumMs = 0.0;
+    _frames = 0;
+
+    const double share = std::max(cpuShare, gpuShare);
+    bool changed = false;
+    if (share > Constants::QUALITY_HIGH_SHARE) {
+        _calmWindows = 0;
+        changed = stepDown(cpuShare, gpuShare);
+    } else if (share < Constants::QUALITY_LOW_SHARE) {
+        if (++_calmWindows >= Constants::QUALITY_UPGRADE_WINDOWS) {
+            _calmWindows = 0;
+            changed = stepUp(cpuShare, gpuShare);
+        }
+    } else {
+        _calmWindows = 0;
+    }
+
+    if (changed) {
+        _settleFrames = Constants::QUALITY_SETTLE_FRAMES;
+    }
+    return changed;
+}
+
+bool QualityGovernor::stepDown(double cpuShare, double gpuShare) {
+    const QualitySettings before = _settings;
+    const bool gpuBound = gpuShare > cpuShare;
+
+    // The render scale only relieves the GPU
+    if (gpuBound && _settings.render_scale > _bounds.min_render_scale) {
+        _settings.render_scale =
+            std::max(_bounds.min_render_scale, _settings.render_scale - Constants::QUALITY_SCALE_STEP);
+        decide(formatChange("render scale", before.render_scale, _settings.render_scale, 2), cpuShare, gpuShare);
+        return true;
+    }
+    if (setMesh(static_cast<int>(std::lround(_settings.mesh_x * Constants::QUALITY_MESH_STEP)))) {
+        decide("mesh " + std::to_string(before.mesh_x) + "x" + std::to_string(before.mesh_y) + " -> " +
+                   std::to_string(_settings.mesh_x) + "x" + std::to_string(_settings.mesh_y),
+               cpuShare, gpuShare);
+        return true;
+    }
+    if (_settings.fps > _bounds.min_fps) {
+        _settings.fps = std::max(_bounds.min_fps, _settings.fps - Constants::QUALITY_FPS_STEP);
+        decide(formatChange("fps", before.fps, _settings.fps, 0), cpuShare, gpuShare);
+        return true;
+    }
+    return false;
+}
+
+bool QualityGovernor::stepUp(double cpuShare, double gpuShare) {
+    const QualitySettings before = _settings;
+
+    // Frame rate first, then the settings that only cost detail; each predicted to stay under the high mark
+    if (_settings.fps < _bounds.max_fps) {
+        const int fps = std::min(_bounds.max_fps, _settings.fps + Constants::QUALITY_FPS_STEP);
+        if (std::max(cpuShare, gpuShare) * fps / _settings.fps < Constants::QUALITY_HIGH_SHARE) {
+            _settings.fps = fps;
+            decide(formatChange("fps", before.fps, _settings.fps, 0), cpuShare, gpuShare);
+            return true;
+        }
+        return false;
+    }
+    if (_settings.render_scale < _bounds.max_render_scale) {
+        const double scale =
+            std::min(_bounds.max_render_scale, _settings.render_scale + Constants::QUALITY_SCALE_STEP);
+        const double ratio = scale / _settings.render_scale;
+        if (std::max(cpuShare, gpuShare * ratio * ratio) < Constants::QUALITY_HIGH_SHARE) {
+            _settings.render_scale = scale;
+            decide(formatChange("render scale", before.render_scale, _settings.render_scale, 2), cpuShare,
+                   gpuShare);
+            return true;
+        }
+    }
+    if (_settings.mesh_x < _bounds.max_mesh_x) {
+        const int meshX = std::min(_bounds.max_mesh_x,
+                                   static_cast<int>(std::lround(_settings.mesh_x / Constants::QUALITY_MESH_STEP)));
+        const double ratio = static_cast<double>(meshX) / _settings.mesh_x;
+        if (std::max(cpuShare * ratio * ratio, gpuShare) < Constants::QUALITY_HIGH_SHARE && setMesh(meshX)) {
+            decide("mesh " + std::to_string(before.mesh_x) + "x" + std::to_string(before.mesh_y) + " -> " +
+                       std::to_string(_settings.mesh_x) + "x" + std::to_string(_settings.mesh_y),
+                   cpuShare, gpuShare);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QualityGovernor::setMesh(int meshX) {
+    meshX = std::clamp(meshX, _bounds.min_mesh_x, _bounds.max_mesh_x);
+    const int meshY = std::max(1, static_cast<int>(std::lround(meshX * _meshAspect)));
+    if (meshX == _settings.mesh_x && meshY == _settings.mesh_y) {
+        return false;
+    }
+    _settings.mesh_x = meshX;
+    _settings.mesh_y = meshY;
+    return true;
+}
+
+void QualityGovernor::decide(const std::string& change, double cpuShare, double gpuShare) {
+    char load[96];
+    std::snprintf(load, sizeof(load), "CPU %.0f%%, GPU %.0f%% of the frame budget: ", cpuShare * 100.0,
+                  gpuShare * 100.0);
+    _lastDecision = load + change;
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief The projectM settings the quality governor controls
+ */
+struct QualitySettings {
+    int mesh_x = Constants::DEFAULT_MESH_X;
+    int mesh_y = Constants::DEFAULT_MESH_Y;
+    int fps = Constants::DEFAULT_FPS_VALUE;
+    double render_scale = 1.0;
+};
+
+/**
+ * @brief Range each setting may move in; the maxima are where the governor starts
+ */
+struct QualityBounds {
+    int min_mesh_x = Constants::DEFAULT_MESH_X / 2;
+    int max_mesh_x = Constants::DEFAULT_MESH_X;
+    int min_fps = Constants::DEFAULT_FPS_VALUE / 2;
+    int max_fps = Constants::DEFAULT_FPS_VALUE;
+    double min_render_scale = Constants::DEFAULT_MIN_RENDER_SCALE;
+    double max_render_scale = 1.0;
+};
+
+/**
+ * @brief Closed-loop control of projectM's mesh size, frame rate and render scale
+ *
+ * Each window of frames is compared with the budget of the current frame rate.
+ * One window above QUALITY_HIGH_SHARE drops one setting a step. GPU-bound frames
+ * drop the render scale first; CPU-bound frames drop the mesh first (its per-vertex
+ * equations run on the CPU). The frame rate goes last. Quality comes back only after
+ * QUALITY_UPGRADE_WINDOWS windows in a row below QUALITY_LOW_SHARE, and only when
+ * the predicted cost of the next step still fits under QUALITY_HIGH_SHARE. That
+ * gap keeps it from oscillating. Pure logic; the render thread feeds it.
+ */
+class QualityGovernor {
+public:
+    QualityGovernor();
+
+    /**
+     * @brief Set the ranges and restart at the top of them
+     * @param meshAspect Mesh rows per column, kept as the mesh is resized
+     */
+    void setBounds(const QualityBounds& bounds, double meshAspect);
+
+    /**
+     * @brief Built-in floors for a hardware profile ("low", "medium" or "high")
+     * @return False for an unknown profile, leaving bounds untouched
+     */
+    static bool getProfileBounds(const std::string& profile, QualityBounds& bounds);
+
+    /**
+     * @brief Pick a profile from the GL_RENDERER string
+     */
+    static std::string detectProfile(const std::string& renderer);
+
+    /**
+     * @brief Add one frame's cost
+     * @param cpuMs CPU time of the frame, excluding the swap and the pacing wait
+     * @param gpuMs GPU time of the frame (0 when unknown)
+     * @return True if the settings changed on this frame (getLastDecision() says why)
+     */
+    bool addFrame(double cpuMs, double gpuMs);
+
+    const QualitySettings& getSettings() const {
+        return _settings;
+    }
+    const QualityBounds& getBounds() const {
+        return _bounds;
+    }
+    const std::string& getLastDecision() const {
+        return _lastDecision;
+    }
+
+    double getBudgetMs() const {
+        return 1000.0 / _settings.fps;
+    }
+
+private:
+    bool stepDown(double cpuShare, double gpuShare);
+    bool stepUp(double cpuShare, double gpuShare);
+    bool setMesh(int meshX);
+    void decide(const std::string& change, double cpuShare, double gpuShare);
+
+    QualityBounds _bounds;
+    QualitySettings _settings;
+    double _meshAspect;
+    std::string _lastDecision;
+
+    double _cpuSumMs = 0.0;
+    double _gpuSumMs = 0.0;
+    int _frames = 0;
+    int _calmWindows = 0;
+    int _settleFrames = 0;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,804 @@
+#include "remote_control_server.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+#include "constants.hpp"
+#include "json_utils.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+// WebSocket opcodes (RFC 6455)
+constexpr uint8_t OPCODE_TEXT = 0x1;
+constexpr uint8_t OPCODE_CLOSE = 0x8;
+constexpr uint8_t OPCODE_PING = 0x9;
+constexpr uint8_t OPCODE_PONG = 0xA;
+
+constexpr const char* WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;  // SO_NOSIGPIPE is set on each socket instead
+#endif
+#endif
+
+uint32_t rotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// SHA-1 is only used for the handshake's Sec-WebSocket-Accept, as the protocol requires
+std::array<uint8_t, 20> sha1(std::string_view data) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::string message(data);
+    const uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+    message += static_cast<char>(0x80);
+    while (message.size() % 64 != 56) {
+        message += '\0';
+    }
+    for (int i = 7; i >= 0; --i) {
+        message += static_cast<char>(bits >> (i * 8));
+    }
+
+    for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const uint8_t*>(message.data() + chunk + i * 4);
+            w[i] = (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3];
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f;
+            uint32_t k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t next = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = next;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest{};
+    for (int i = 0; i < 20; ++i) {
+        digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+    }
+    return digest;
+}
+
+std::string base64(const uint8_t* data, size_t length) {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    text.reserve((length + 2) / 3 * 4);
+    for (size_t i = 0; i < length; i += 3) {
+        const uint32_t chunk = (uint32_t{data[i]} << 16) | (i + 1 < length ? uint32_t{data[i + 1]} << 8 : 0) |
+                               (i + 2 < length ? uint32_t{data[i + 2]} : 0);
+        text += ALPHABET[(chunk >> 18) & 0x3F];
+        text += ALPHABET[(chunk >> 12) & 0x3F];
+        text += i + 1 < length ? ALPHABET[(chunk >> 6) & 0x3F] : '=';
+        text += i + 2 < length ? ALPHABET[chunk & 0x3F] : '=';
+    }
+    return text;
+}
+
+// A server frame: final, unmasked
+std::string frame(uint8_t opcode, std::string_view payload) {
+    std::string out;
+    out.reserve(payload.size() + 10);
+    out += static_cast<char>(0x80 | opcode);
+    if (payload.size() < 126) {
+        out += static_cast<char>(payload.size());
+    } else if (payload.size() <= 0xFFFF) {
+        out += static_cast<char>(126);
+        out += static_cast<char>(payload.size() >> 8);
+        out += static_cast<char>(payload.size() & 0xFF);
+    } else {
+        out += static_cast<char>(127);
+        for (int i = 7; i >= 0; --i) {
+            out += static_cast<char>(static_cast<uint64_t>(payload.size()) >> (i * 8));
+        }
+    }
+    out.append(payload.data(), payload.size());
+    return out;
+}
+
+std::string eventJson(std::string_view type, std::string_view data) {
+    std::string json = "{\"type\":\"";
+    json += type;
+    json += "\",\"data\":";
+    json += data;
+    json += '}';
+    return json;
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.10g", value);
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Looks at every byte whatever the mismatch, so the time taken says nothing about how much of a guess was right
+bool tokenEquals(std::string_view given, std::string_view token) {
+    if (given.size() != token.size()) {
+        return false;
+    }
+    unsigned char diff = 0;
+    for (size_t i = 0; i < token.size(); ++i) {
+        diff |= static_cast<unsigned char>(given[i] ^ token[i]);
+    }
+    return diff == 0;
+}
+
+// A message is an action name, or a JSON object with an "action" string
+std::string_view actionNameOf(std::string_view message) {
+    message = trim(message);
+    if (message.empty() || message.front() != '{') {
+        return message;
+    }
+    const size_t key = message.find("\"action\"");
+    if (key == std::string_view::npos) {
+        return {};
+    }
+    const size_t open = message.find('"', message.find(':', key));
+    const size_t close = open == std::string_view::npos ? open : message.find('"', open + 1);
+    if (close == std::string_view::npos) {
+        return {};
+    }
+    return message.substr(open + 1, close - open - 1);
+}
+
+const char* statusText(int status) {
+    switch (status) {
+        case 200:
+            return "200 OK";
+        case 202:
+            return "202 Accepted";
+        case 400:
+            return "400 Bad Request";
+        case 401:
+            return "401 Unauthorized";
+        case 405:
+            return "405 Method Not Allowed";
+        case 503:
+            return "503 Service Unavailable";
+        default:
+            return "404 Not Found";
+    }
+}
+}  // namespace
+
+struct RemoteControlServer::Client {
+    int socket = -1;
+    bool websocket = false;
+    bool closing = false;  // Close once the output is sent
+    std::string input;
+    std::string output;
+    Clock::time_point deadline;  // For the request to arrive, before the upgrade
+};
+
+RemoteControlServer::RemoteControlServer(AutoVibez::Utils::MetricsRegistry& registry) : _registry(registry) {}
+
+RemoteControlServer::~RemoteControlServer() {
+    stop();
+}
+
+const std::vector<std::pair<std::string, KeyAction>>& RemoteControlServer::getRemoteActions() {
+    // Quitting, rebinding and file dumps stay on the node's own keyboard
+    static const std::vector<std::pair<std::string, KeyAction>> actions = {
+        {"next_mix", KeyAction::NEXT_MIX},
+        {"previous_mix", KeyAction::PREVIOUS_MIX},
+        {"toggle_favorite", KeyAction::TOGGLE_FAVORITE},
+        {"random_mix_in_genre", KeyAction::RANDOM_MIX_CURRENT_GENRE},
+        {"random_genre", KeyAction::RANDOM_GENRE_AND_MIX},
+        {"pause_resume", KeyAction::PAUSE_RESUME_MIX},
+        {"seek_forward", KeyAction::SEEK_FORWARD},
+        {"seek_backward", KeyAction::SEEK_BACKWARD},
+        {"next_preset", KeyAction::NEXT_PRESET_BRACKET},
+        {"previous_preset", KeyAction::PREVIOUS_PRESET_BRACKET},
+        {"random_preset", KeyAction::RANDOM_PRESET},
+        {"volume_up", KeyAction::VOLUME_UP},
+        {"volume_down", KeyAction::VOLUME_DOWN},
+        {"toggle_mute", KeyAction::TOGGLE_MUTE},
+        {"increase_beat_sensitivity", KeyAction::INCREASE_BEAT_SENSITIVITY},
+        {"decrease_beat_sensitivity", KeyAction::DECREASE_BEAT_SENSITIVITY},
+        {"show_mix_info", KeyAction::SHOW_MIX_INFO},
+        {"toggle_help_overlay", KeyAction::TOGGLE_HELP_OVERLAY},
+        {"toggle_performance_hud", KeyAction::TOGGLE_PERFORMANCE_HUD},
+        {"take_screenshot", KeyAction::TAKE_SCREENSHOT},
+    };
+    return actions;
+}
+
+KeyAction RemoteControlServer::findRemoteAction(std::string_view name) {
+    for (const auto& [actionName, action] : getRemoteActions()) {
+        if (actionName == name) {
+            return action;
+        }
+    }
+    return KeyAction::UNKNOWN;
+}
+
+void RemoteControlServer::publish(const std::string& type, const std::string& data) {
+    if (!isRunning()) {
+        return;
+    }
+    std::string framed = frame(OPCODE_TEXT, eventJson(type, data));
+    std::lock_guard<std::mutex> lock(_eventMutex);
+    if (!isRunning()) {
+        return;
+    }
+    _pendingFrames.push_back(framed);
+    _latest[type] = {data, std::move(framed)};
+    wake();
+}
+
+bool RemoteControlServer::authorized(std::string_view header, std::string_view query) const {
+    if (_token.empty()) {
+        return true;
+    }
+    constexpr std::string_view BEARER = "Bearer ";
+    constexpr std::string_view TOKEN_PARAM = "token=";
+    const std::string_view credentials = trim(header);
+    if (credentials.substr(0, BEARER.size()) == BEARER && tokenEquals(credentials.substr(BEARER.size()), _token)) {
+        return true;
+    }
+    while (!query.empty()) {
+        const size_t end = std::min(query.find('&'), query.size());
+        const std::string_view param = query.substr(0, end);
+        if (param.substr(0, TOKEN_PARAM.size()) == TOKEN_PARAM &&
+            tokenEquals(param.substr(TOKEN_PARAM.size()), _token)) {
+            return true;
+        }
+        query.remove_prefix(std::min(end + 1, query.size()));
+    }
+    return false;
+}
+
+std::string RemoteControlServer::collectMetrics() {
+    std::string json = "{";
+    for (const AutoVibez::Utils::MetricSample& sample : _registry.collect()) {
+        if (json.size() > 1) {
+            json += ',';
+        }
+        json += '"' + AutoVibez::Utils::JsonUtils::escapeJsonString(sample.name) + "\":";
+        if (sample.kind == AutoVibez::Utils::MetricKind::Histogram) {
+            json += "{\"count\":" + std::to_string(sample.histogram.count) +
+                    ",\"sum\":" + jsonNumber(sample.histogram.sum) + '}';
+        } else {
+            json += jsonNumber(sample.value);
+        }
+    }
+    json += '}';
+    return json;
+}
+
+void RemoteControlServer::runAction(Client& client, std::string_view name) {
+    const KeyAction action = findRemoteAction(name);
+    std::string reply;
+    if (action == KeyAction::UNKNOWN) {
+        reply = eventJson("error", "\"Unknown action\"");
+    } else if (!_handler || !_handler(action)) {
+        reply = eventJson("error", "\"Action queue full\"");
+    } else {
+        reply = eventJson("ack", "\"" + std::string(name) + "\"");
+    }
+    client.output += frame(OPCODE_TEXT, reply);
+}
+
+#ifdef _WIN32
+
+bool RemoteControlServer::start(uint16_t port, const std::string& token, ActionHandler handler) {
+    (void)port, (void)token, (void)handler;
+    setError("The remote control is not supported on this platform");
+    return false;
+}
+
+void RemoteControlServer::stop() {}
+void RemoteControlServer::wake() {}
+void RemoteControlServer::run() {}
+void RemoteControlServer::acceptClients(std::vector<std::unique_ptr<Client>>& clients) {
+    (void)clients;
+}
+bool RemoteControlServer::readClient(Client& client) {
+    (void)client;
+    return false;
+}
+bool RemoteControlServer::handleRequest(Client& client) {
+    (void)client;
+    return false;
+}
+bool RemoteControlServer::handleMessages(Client& client) {
+    (void)client;
+    return false;
+}
+bool RemoteControlServer::writeClient(Client& client) {
+    (void)client;
+    return false;
+}
+void RemoteControlServer::respond(Client& client, int status, const std::string& body) {
+    (void)client, (void)status, (void)body;
+}
+
+#else
+
+bool RemoteControlServer::start(uint16_t port, const std::string& token, ActionHandler handler) {
+    if (_thread.joinable()) {
+        return true;
+    }
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        setError(std::string("Cannot create the remote control socket: ") + std::strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    int wakePipe[2] = {-1, -1};
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, Constants::REMOTE_CONTROL_MAX_CLIENTS) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0 || pipe(wakePipe) != 0) {
+        setError(std::string("Cannot listen for remote control: ") + std::strerror(errno));
+        close(listener);
+        return false;
+    }
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL, 0) | O_NONBLOCK);
+    fcntl(wakePipe[0], F_SETFL, fcntl(wakePipe[0], F_GETFL, 0) | O_NONBLOCK);
+    fcntl(wakePipe[1], F_SETFL, fcntl(wakePipe[1], F_GETFL, 0) | O_NONBLOCK);
+
+    // A client that hangs up mid-reply should fail the send, not kill the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    _listener = listener;
+    _wakeRead = wakePipe[0];
+    _wakeWrite = wakePipe[1];
+    _port = ntohs(address.sin_port);
+    _token = token;
+    _handler = std::move(handler);
+    _stopping = false;
+    _thread = std::thread(&RemoteControlServer::run, this);
+    {
+        std::lock_guard<std::mutex> lock(_eventMutex);
+        _running = true;
+    }
+    setSuccess(true);
+    return true;
+}
+
+void RemoteControlServer::stop() {
+    if (!_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_eventMutex);
+        _running = false;
+    }
+    _stopping = true;
+    wake();
+    _thread.join();
+    close(_listener);
+    close(_wakeRead);
+    close(_wakeWrite);
+    _listener = _wakeRead = _wakeWrite = -1;
+    _port = 0;
+    std::lock_guard<std::mutex> lock(_eventMutex);
+    _pendingFrames.clear();
+    _latest.clear();
+}
+
+void RemoteControlServer::wake() {
+    const char byte = 1;
+    // A full pipe already has a wake-up waiting
+    [[maybe_unused]] const ssize_t wrote = write(_wakeWrite, &byte, 1);
+}
+
+void RemoteControlServer::run() {
+    std::vector<std::unique_ptr<Client>> clients;
+    std::vector<pollfd> polled;
+    std::vector<std::string> frames;
+    Clock::time_point nextMetrics = Clock::now();
+
+    while (!_stopping.load()) {
+        const bool listening =
+            std::any_of(clients.begin(), clients.end(), [](const auto& client) { return client->websocket; });
+
+        // Sleep until a socket is ready, an event is published, a request times out or metrics are due
+        Clock::time_point deadline =
+            Clock::now() + std::chrono::milliseconds(Constants::REMOTE_CONTROL_REQUEST_TIMEOUT_MS);
+        if (listening) {
+            deadline = std::min(deadline, nextMetrics);
+        }
+        polled.clear();
+        polled.push_back({_wakeRead, POLLIN, 0});
+        polled.push_back({_listener, POLLIN, 0});
+        for (const auto& client : clients) {
+            if (!client->websocket) {
+                deadline = std::min(deadline, client->deadline);
+            }
+            const short events = static_cast<short>(client->closing ? 0 : POLLIN);
+            polled.push_back({client->socket, static_cast<short>(events | (client->output.empty() ? 0 : POLLOUT)), 0});
+        }
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (poll(polled.data(), static_cast<nfds_t>(polled.size()), static_cast<int>(std::max<int64_t>(wait, 0))) < 0 &&
+            errno != EINTR) {
+            break;
+        }
+
+        if (polled[0].revents & POLLIN) {
+            char drain[64];
+            while (read(_wakeRead, drain, sizeof(drain)) > 0) {
+            }
+            {
+                std::lock_guard<std::mutex> lock(_eventMutex);
+                frames.swap(_pendingFrames);
+            }
+            for (const std::string& framed : frames) {
+                for (const auto& client : clients) {
+                    if (client->websocket && !client->closing) {
+                        client->output += framed;
+                    }
+                }
+            }
+            frames.clear();
+        }
+
+        const Clock::time_point now = Clock::now();
+        std::vector<bool> keep(clients.size(), true);
+        for (size_t i = 0; i < clients.size(); ++i) {
+            Client& client = *clients[i];
+            const short revents = polled[i + 2].revents;
+            if (revents & (POLLERR | POLLNVAL)) {
+                keep[i] = false;
+                continue;
+            }
+            if ((revents & (POLLIN | POLLHUP)) && !readClient(client)) {
+                keep[i] = false;
+                continue;
+            }
+            if ((revents & POLLOUT) && !writeClient(client)) {
+                keep[i] = false;
+                continue;
+            }
+            // A stalled request, or a listener too slow for the events
+            if ((!client.websocket && now >= client.deadline) ||
+                client.output.size() > static_cast<size_t>(Constants::REMOTE_CONTROL_BACKLOG_MAX_BYTES) ||
+                (client.closing && client.output.empty())) {
+                keep[i] = false;
+            }
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < clients.size(); ++i) {
+            if (keep[i]) {
+                clients[kept++] = std::move(clients[i]);
+            } else {
+                close(clients[i]->socket);
+            }
+        }
+        clients.resize(kept);
+
+        if (polled[1].revents & POLLIN) {
+            acceptClients(clients);
+        }
+
+        if (listening && now >= nextMetrics) {
+            nextMetrics = now + std::chrono::milliseconds(Constants::REMOTE_CONTROL_METRICS_INTERVAL_MS);
+            publish("metrics", collectMetrics());
+        }
+    }
+
+    for (const auto& client : clients) {
+        close(client->socket);
+    }
+}
+
+void RemoteControlServer::acceptClients(std::vector<std::unique_ptr<Client>>& clients) {
+    for (;;) {
+        const int socket = accept(_listener, nullptr, nullptr);
+        if (socket < 0) {
+            return;  // EAGAIN once the backlog is empty
+        }
+        if (clients.size() >= static_cast<size_t>(Constants::REMOTE_CONTROL_MAX_CLIENTS)) {
+            close(socket);
+            continue;
+        }
+        fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+        // Commands and events are small; send each at once instead of waiting to batch
+        int noDelay = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+#ifdef SO_NOSIGPIPE
+        int noSigpipe = 1;
+        setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &noSigpipe, sizeof(noSigpipe));
+#endif
+        auto client = std::make_unique<Client>();
+        client->socket = socket;
+        client->deadline = Clock::now() + std::chrono::milliseconds(Constants::REMOTE_CONTROL_REQUEST_TIMEOUT_MS);
+        clients.push_back(std::move(client));
+    }
+}
+
+bool RemoteControlServer::readClient(Client& client) {
+    char buffer[4096];
+    for (;;) {
+        const ssize_t got = recv(client.socket, buffer, sizeof(buffer), 0);
+        if (got == 0) {
+            return false;  // Hung up
+        }
+        if (got < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return errno == EINTR;
+        }
+        if (!client.closing) {
+            client.input.append(buffer, static_cast<size_t>(got));
+        }
+    }
+    if (client.closing) {
+        return true;
+    }
+    return client.websocket ? handleMessages(client) : handleRequest(client);
+}
+
+bool RemoteControlServer::writeClient(Client& client) {
+    while (!client.output.empty()) {
+        const ssize_t wrote = send(client.socket, client.output.data(), client.output.size(), SEND_FLAGS);
+        if (wrote < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        client.output.erase(0, static_cast<size_t>(wrote));
+    }
+    return true;
+}
+
+void RemoteControlServer::respond(Client& client, int status, const std::string& body) {
+    client.output += std::string("HTTP/1.1 ") + statusText(status) +
+                     "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+                     "\r\nConnection: close\r\n\r\n" + body;
+    client.closing = true;
+}
+
+bool RemoteControlServer::handleRequest(Client& client) {
+    const size_t headerEnd = client.input.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        if (client.input.size() > static_cast<size_t>(Constants::REMOTE_CONTROL_REQUEST_MAX_BYTES)) {
+            respond(client, 400, "{\"error\":\"Request too large\"}");
+        }
+        return true;
+    }
+
+    const std::string_view head(client.input.data(), headerEnd);
+    const size_t lineEnd = std::min(head.find("\r\n"), head.size());
+    const std::string_view requestLine = head.substr(0, lineEnd);
+    const size_t methodEnd = requestLine.find(' ');
+    const size_t targetEnd = methodEnd == std::string_view::npos ? methodEnd : requestLine.find(' ', methodEnd + 1);
+    if (targetEnd == std::string_view::npos) {
+        respond(client, 400, "{\"error\":\"Bad request line\"}");
+        return true;
+    }
+    const std::string_view method = requestLine.substr(0, methodEnd);
+    const std::string_view target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    const size_t queryStart = std::min(target.find('?'), target.size());
+    const std::string_view path = target.substr(0, queryStart);
+    const std::string_view query = target.substr(std::min(queryStart + 1, target.size()));
+
+    std::string_view authorization;
+    std::string_view upgrade;
+    std::string_view websocketKey;
+    size_t position = lineEnd + 2;
+    while (position < head.size()) {
+        const size_t end = std::min(head.find("\r\n", position), head.size());
+        const std::string_view line = head.substr(position, end - position);
+        const size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            const std::string_view name = line.substr(0, colon);
+            const std::string_view value = trim(line.substr(colon + 1));
+            if (equalsIgnoreCase(name, "Authorization")) {
+                authorization = value;
+            } else if (equalsIgnoreCase(name, "Upgrade")) {
+                upgrade = value;
+            } else if (equalsIgnoreCase(name, "Sec-WebSocket-Key")) {
+                websocketKey = value;
+            }
+        }
+        position = end + 2;
+    }
+
+    if (!authorized(authorization, query)) {
+        respond(client, 401, "{\"error\":\"Missing or wrong token\"}");
+        return true;
+    }
+
+    const std::string actionsPath = StringConstants::REMOTE_ACTIONS_PATH;
+    if (path == StringConstants::REMOTE_EVENTS_PATH) {
+        if (method != "GET" || !equalsIgnoreCase(upgrade, "websocket") || websocketKey.empty()) {
+            respond(client, 400, "{\"error\":\"Expected a WebSocket upgrade\"}");
+            return true;
+        }
+        const std::array<uint8_t, 20> digest = sha1(std::string(websocketKey) + WEBSOCKET_GUID);
+        client.output += "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                         "Sec-WebSocket-Accept: " +
+                         base64(digest.data(), digest.size()) + "\r\n\r\n";
+        client.websocket = true;
+        {
+            std::lock_guard<std::mutex> lock(_eventMutex);
+            for (const auto& [type, latest] : _latest) {
+                client.output += latest.second;
+            }
+        }
+        client.input.erase(0, headerEnd + 4);
+        return handleMessages(client);
+    }
+
+    if (path == actionsPath) {
+        if (method != "GET") {
+            respond(client, 405, "{\"error\":\"Use GET\"}");
+            return true;
+        }
+        std::vector<std::string> names;
+        for (const auto& [name, action] : getRemoteActions()) {
+            names.push_back(name);
+        }
+        respond(client, 200, "{\"actions\":" + AutoVibez::Utils::JsonUtils::vectorToJsonArray(names) + "}");
+        return true;
+    }
+
+    if (path.size() > actionsPath.size() + 1 && path.substr(0, actionsPath.size()) == actionsPath &&
+        path[actionsPath.size()] == '/') {
+        if (method != "POST") {
+            respond(client, 405, "{\"error\":\"Use POST\"}");
+            return true;
+        }
+        const std::string_view name = path.substr(actionsPath.size() + 1);
+        const KeyAction action = findRemoteAction(name);
+        if (action == KeyAction::UNKNOWN) {
+            respond(client, 404, "{\"error\":\"Unknown action\"}");
+        } else if (!_handler || !_handler(action)) {
+            respond(client, 503, "{\"error\":\"Action queue full\"}");
+        } else {
+            respond(client, 202, "{\"action\":\"" + std::string(name) + "\"}");
+        }
+        return true;
+    }
+
+    if (path == StringConstants::REMOTE_NOW_PLAYING_PATH) {
+        std::string data = "null";
+        {
+            std::lock_guard<std::mutex> lock(_eventMutex);
+            const auto it = _latest.find("now_playing");
+            if (it != _latest.end()) {
+                data = it->second.first;
+            }
+        }
+        respond(client, 200, data);
+        return true;
+    }
+
+    respond(client, 404, "{\"error\":\"Not found\"}");
+    return true;
+}
+
+bool RemoteControlServer::handleMessages(Client& client) {
+    for (;;) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(client.input.data());
+        const size_t available = client.input.size();
+        if (available < 2) {
+            return true;
+        }
+        const bool final = (bytes[0] & 0x80) != 0;
+        const uint8_t opcode = bytes[0] & 0x0F;
+        const bool masked = (bytes[1] & 0x80) != 0;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) {
+                return true;
+            }
+            length = (uint64_t{bytes[2]} << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) {
+                return true;
+            }
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | bytes[2 + i];
+            }
+            header = 10;
+        }
+        // Clients must mask; commands are short and never fragmented
+        if (!masked || !final || length > static_cast<uint64_t>(Constants::REMOTE_CONTROL_REQUEST_MAX_BYTES)) {
+            return false;
+        }
+        if (available < header + 4 + length) {
+            return true;
+        }
+
+        std::string payload(client.input, header + 4, static_cast<size_t>(length));
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<char>(payload[i] ^ bytes[header + (i % 4)]);
+        }
+        client.input.erase(0, header + 4 + static_cast<size_t>(length));
+
+        switch (opcode) {
+            case OPCODE_TEXT:
+                runAction(client, actionNameOf(payload));
+                break;
+            case OPCODE_PING:
+                client.output += frame(OPCODE_PONG, payload);
+                break;
+            case OPCODE_PONG:
+                break;
+            case OPCODE_CLOSE:
+                client.output += frame(OPCODE_CLOSE, std::string_view(payload).substr(0, 2));
+                client.closing = true;
+                client.input.clear();
+                return true;
+            default:
+                return false;  // Binary messages and continuations are not part of the protocol
+        }
+    }
+}
+
+#endif
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "error_handler.hpp"
+#include "key_binding_manager.hpp"
+#include "metrics_registry.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief HTTP and WebSocket remote control for one node
+ *
+ * A single thread runs a poll() loop over non-blocking sockets, so a slow or stalled
+ * client never holds up another and nothing here touches the render thread:
+ *
+ *     GET  /api/actions         names of the actions a client may run
+ *     POST /api/actions/<name>  run one; 202 once it is queued
+ *     GET  /api/now-playing     data of the latest now_playing event
+ *     GET  /api/events          WebSocket; the server sends {"type": ..., "data": ...}
+ *                               events, the client sends action names
+ *
+ * Actions go to the handler, which queues them for the main thread. Events published
+ * from any thread are framed once and queued for every WebSocket client, and the latest
+ * of each type greets a client as it connects. While anyone listens, the metrics registry
+ * goes out as a "metrics" event every REMOTE_CONTROL_METRICS_INTERVAL_MS. HTTP requests
+ * are answered and closed; a controller driving many nodes keeps a WebSocket to each.
+ * With a token set, every request needs "Authorization: Bearer <token>" or "?token=<token>"
+ * (browsers cannot set headers on a WebSocket). POSIX only: start() fails on Windows.
+ */
+class RemoteControlServer : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @brief Queue an action for the main thread; called on the server thread
+     * @return False if the action was dropped
+     */
+    using ActionHandler = std::function<bool(KeyAction action)>;
+
+    explicit RemoteControlServer(
+        AutoVibez::Utils::MetricsRegistry& registry = AutoVibez::Utils::MetricsRegistry::instance());
+
+    /**
+     * @brief Stops serving; connections are closed
+     */
+    ~RemoteControlServer();
+
+    RemoteControlServer(const RemoteControlServer&) = delete;
+    RemoteControlServer& operator=(const RemoteControlServer&) = delete;
+
+    /**
+     * @brief Listen on every interface
+     * @param port 0 for any free port, which getPort then reports
+     * @param token Required of every request when not empty
+     * @return False, with nothing running, if the socket could not be set up
+     */
+    bool start(uint16_t port, const std::string& token, ActionHandler handler);
+
+    void stop();
+
+    bool isRunning() const {
+        return _running.load();
+    }
+    uint16_t getPort() const {
+        return _port;
+    }
+
+    /**
+     * @brief Send an event to every WebSocket client, from any thread; a no-op while stopped
+     * @param type Event name, e.g. "now_playing"
+     * @param data Any JSON value
+     */
+    void publish(const std::string& type, const std::string& data);
+
+    /**
+     * @brief Names a client may send, with the action each runs
+     */
+    static const std::vector<std::pair<std::string, KeyAction>>& getRemoteActions();
+
+    /**
+     * @brief The remote action with this name, or UNKNOWN
+     */
+    static KeyAction findRemoteAction(std::string_view name);
+
+private:
+    struct Client;
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    void acceptClients(std::vector<std::unique_ptr<Client>>& clients);
+    bool readClient(Client& client);
+    bool handleRequest(Client& client);
+    bool handleMessages(Client& client);
+    bool writeClient(Client& client);
+    void respond(Client& client, int status, const std::string& body);
+    void runAction(Client& client, std::string_view name);
+    bool authorized(std::string_view header, std::string_view query) const;
+    std::string collectMetrics();
+    void wake();
+
+    AutoVibez::Utils::MetricsRegistry& _registry;
+    ActionHandler _handler;
+    std::string _token;
+    int _listener = -1;
+    int _wakeRead = -1;  // Self-pipe: publish() and stop() write a byte to break the poll
+    int _wakeWrite = -1;
+    uint16_t _port = 0;
+    std::atomic<bool> _running{false};  // Set and cleared under _eventMutex, so publish() never wakes a closed pipe
+    std::atomic<bool> _stopping{false};
+    std::thread _thread;
+
+    std::mutex _eventMutex;                   // Guards the two members below
+    std::vector<std::string> _pendingFrames;  // Framed events the loop has yet to hand out
+    // Newest data of each event type, and its frame
+    std::map<std::string, std::pair<std::string, std::string>> _latest;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,30 @@
+#include <SDL2/SDL.h>
+
+#include <string>
+
+#include "console_output.hpp"
+#include "render_benchmark.hpp"
+
+using AutoVibez::Core::BenchmarkOptions;
+using AutoVibez::Core::RenderBenchmark;
+using AutoVibez::Utils::ConsoleOutput;
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    std::string error;
+    if (!RenderBenchmark::parseArgs(argc, argv, 1, options, error)) {
+        ConsoleOutput::error(error);
+        ConsoleOutput::println(
+            "Usage: autovibez_render_bench <preset dir | list.txt> [--audio kicks|sweep|pink|sine|file.wav|file.mp3]\n"
+            "       [--frames N] [--warmup N] [--size WxH] [--mesh XxY] [--fps N] [--textures DIR]\n"
+            "       [--output report.json]");
+        return 2;
+    }
+
+    RenderBenchmark benchmark(options);
+    if (!benchmark.run()) {
+        ConsoleOutput::error(benchmark.getLastError());
+        return 1;
+    }
+    return 0;
+}
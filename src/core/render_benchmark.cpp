@@ -0,0 +1,470 @@
+#include "render_benchmark.hpp"
+
+#include <SDL2/SDL.h>
+#include <projectM-4/projectM.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+#include "console_output.hpp"
+#include "gpu_timer.hpp"
+#include "memory_accounting.hpp"
+#include "opengl.h"
+#include "render_scaler.hpp"
+#include "string_utils.hpp"
+#include "synthetic_capture.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+using AutoVibez::Utils::ConsoleOutput;
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool isPresetFile(const std::filesystem::path& path) {
+    const std::string extension = AutoVibez::Utils::StringUtils::toLower(path.extension().string());
+    return extension == ".milk" || extension == ".prjm";
+}
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                quoted += "\\\"";
+                break;
+            case '\\':
+                quoted += "\\\\";
+                break;
+            case '\n':
+                quoted += "\\n";
+                break;
+            case '\t':
+                quoted += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    quoted += escaped;
+                } else {
+                    quoted += c;
+                }
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string jsonNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.4f", value);
+    return text;
+}
+
+std::string jsonTiming(const TimingSummary& timing) {
+    if (timing.samples == 0) {
+        return "null";
+    }
+    return "{\"mean\": " + jsonNumber(timing.mean_ms) + ", \"p50\": " + jsonNumber(timing.p50_ms) +
+           ", \"p99\": " + jsonNumber(timing.p99_ms) + ", \"max\": " + jsonNumber(timing.max_ms) +
+           ", \"samples\": " + std::to_string(timing.samples) + "}";
+}
+
+// The context the visualizer runs in (initGL() in setup.cpp)
+void requestContext() {
+#ifdef USE_GLES
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+#else
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+#endif
+}
+
+void onSwitchFailed(const char* /*filename*/, const char* message, void* userData) {
+    *static_cast<std::string*>(userData) = message && *message ? message : "preset failed to load";
+}
+}  // namespace
+
+RenderBenchmark::RenderBenchmark(BenchmarkOptions options) : _options(std::move(options)) {}
+
+bool RenderBenchmark::parseArgs(int argc, char* argv[], int first, BenchmarkOptions& options, std::string& error) {
+    for (int i = first; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg.rfind("--", 0) == 0 && !hasValue) {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--audio") {
+            options.audio = argv[++i];
+        } else if (arg == "--output") {
+            options.output = argv[++i];
+        } else if (arg == "--textures") {
+            options.textures = argv[++i];
+        } else if (arg == "--size") {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 ||
+                options.height <= 0) {
+                error = "--size expects WIDTHxHEIGHT, e.g. 1920x1080";
+                return false;
+            }
+        } else if (arg == "--mesh") {
+            if (std::sscanf(argv[++i], "%dx%d", &options.mesh_x, &options.mesh_y) != 2 || options.mesh_x <= 0 ||
+                options.mesh_y <= 0) {
+                error = "--mesh expects XxY, e.g. 48x32";
+                return false;
+            }
+        } else if (arg == "--frames") {
+            options.frames = std::atoi(argv[++i]);
+            if (options.frames <= 0) {
+                error = "--frames expects a positive frame count";
+                return false;
+            }
+        } else if (arg == "--warmup") {
+            options.warmup = std::atoi(argv[++i]);
+            if (options.warmup < 0) {
+                error = "--warmup expects a frame count";
+                return false;
+            }
+        } else if (arg == "--fps") {
+            options.fps = std::atoi(argv[++i]);
+            if (options.fps <= 0) {
+                error = "--fps expects a positive frame rate";
+                return false;
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            error = "Unknown option " + arg;
+            return false;
+        } else if (options.presets.empty()) {
+            options.presets = arg;
+        } else {
+            error = "Unexpected argument " + arg;
+            return false;
+        }
+    }
+
+    if (options.presets.empty()) {
+        error = "Give a preset directory or a file listing presets";
+        return false;
+    }
+    return true;
+}
+
+bool RenderBenchmark::listPresets(const std::string& source, std::vector<std::string>& presets, std::string& error) {
+    presets.clear();
+    std::error_code ec;
+    const std::filesystem::path root(source);
+    if (std::filesystem::is_directory(root, ec)) {
+        for (std::filesystem::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec) && isPresetFile(it->path())) {
+                presets.push_back(it->path().string());
+            }
+        }
+        // Directory order differs between file systems
+        std::sort(presets.begin(), presets.end());
+    } else {
+        std::ifstream list(root);
+        if (!list) {
+            error = "Cannot read preset list " + source;
+            return false;
+        }
+        std::string line;
+        while (std::getline(list, line)) {
+            line = AutoVibez::Utils::StringUtils::trim(line.substr(0, line.find('#')));
+            if (line.empty()) {
+                continue;
+            }
+            std::filesystem::path path(line);
+            if (path.is_relative()) {
+                path = root.parent_path() / path;
+            }
+            presets.push_back(path.string());
+        }
+    }
+
+    if (presets.empty()) {
+        error = "No presets in " + source;
+        return false;
+    }
+    return true;
+}
+
+TimingSummary RenderBenchmark::summarize(std::vector<double> samples) {
+    TimingSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    // Nearest rank, as in the frame profiler
+    auto rank = [&samples](double fraction) {
+        const size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(samples.size())));
+        return samples[std::min(samples.size(), std::max<size_t>(index, 1)) - 1];
+    };
+    summary.samples = samples.size();
+    summary.mean_ms = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    summary.p50_ms = rank(0.50);
+    summary.p99_ms = rank(0.99);
+    summary.max_ms = samples.back();
+    return summary;
+}
+
+int64_t RenderBenchmark::getPeakMemoryKb() {
+    const int64_t peak = Utils::MemoryAccounting::getPeakResidentBytes();
+    return peak > 0 ? peak / 1024 : 0;
+}
+
+std::string RenderBenchmark::toJson(const BenchmarkOptions& options, const std::vector<PresetBenchmark>& results,
+                                    const std::string& renderer, bool gpuTiming) {
+    int64_t peak = 0;
+    for (const PresetBenchmark& result : results) {
+        peak = std::max(peak, result.peak_memory_kb);
+    }
+
+    std::string json = "{\n";
+    json += "  \"format\": \"autovibez-render-bench-1\",\n";
+    json += "  \"renderer\": " + jsonString(renderer) + ",\n";
+    json += "  \"audio\": " + jsonString(options.audio) + ",\n";
+    json += "  \"width\": " + std::to_string(options.width) + ", \"height\": " + std::to_string(options.height) +
+            ", \"fps\": " + std::to_string(options.fps) + ",\n";
+    json += "  \"mesh\": [" + std::to_string(options.mesh_x) + ", " + std::to_string(options.mesh_y) + "],\n";
+    json += "  \"frames\": " + std::to_string(options.frames) + ", \"warmup\": " + std::to_string(options.warmup) +
+            ",\n";
+    json += std::string("  \"gpu_timing\": ") + (gpuTiming ? "true" : "false") + ",\n";
+    json += "  \"peak_memory_kb\": " + std::to_string(peak) + ",\n";
+    json += "  \"presets\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const PresetBenchmark& result = results[i];
+        json += i == 0 ? "\n" : ",\n";
+        json += "    {\"path\": " + jsonString(result.path);
+        if (!result.error.empty()) {
+            json += ", \"error\": " + jsonString(result.error) + "}";
+            continue;
+        }
+        json += ", \"load_ms\": " + jsonNumber(result.load_ms) +
+                ", \"first_frame_ms\": " + jsonNumber(result.first_frame_ms) + ",\n";
+        json += "     \"cpu_ms\": " + jsonTiming(result.cpu) + ",\n";
+        json += "     \"gpu_ms\": " + jsonTiming(result.gpu) + ",\n";
+        json += "     \"peak_memory_kb\": " + std::to_string(result.peak_memory_kb) + "}";
+    }
+    json += results.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return json;
+}
+
+bool RenderBenchmark::run() {
+    std::vector<std::string> presets;
+    std::string error;
+    if (!listPresets(_options.presets, presets, error)) {
+        setError(error);
+        return false;
+    }
+    // Fail before opening a window when the audio spec is wrong
+    if (!AutoVibez::Audio::SyntheticCapture::createSource(_options.audio, Constants::DEFAULT_SAMPLE_RATE, error)) {
+        setError(error);
+        return false;
+    }
+
+    // A hidden window only provides the context; nothing is presented, so nothing waits for vsync
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        setError("Failed to initialize SDL video: " + std::string(SDL_GetError()));
+        return false;
+    }
+    requestContext();
+    SDL_Window* window = SDL_CreateWindow("AutoVibez render benchmark", SDL_WINDOWPOS_UNDEFINED,
+                                          SDL_WINDOWPOS_UNDEFINED, _options.width, _options.height,
+                                          SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+    if (!context) {
+        setError("Failed to create an OpenGL context: " + std::string(SDL_GetError()));
+        if (window) {
+            SDL_DestroyWindow(window);
+        }
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
+        return false;
+    }
+    SDL_GL_MakeCurrent(window, context);
+    SDL_GL_SetSwapInterval(0);
+#if defined(_WIN32)
+    glewInit();
+#endif
+
+    const char* rendererName = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    const std::string renderer = rendererName ? rendererName : "unknown";
+    std::unique_ptr<RenderScaler> target;
+#ifdef HAVE_PROJECTM_RENDER_FBO
+    target = RenderScaler::create();
+    if (target && !target->setSize(_options.width, _options.height)) {
+        target.reset();
+    }
+#endif
+    if (!target) {
+        ConsoleOutput::warning("No offscreen render target (needs projectM 4.1 and framebuffer objects); "
+                               "rendering into the hidden window");
+    }
+#ifndef HAVE_PROJECTM_FRAME_TIME
+    ConsoleOutput::warning("projectM before 4.1 animates on the wall clock, so runs are not frame-identical");
+#endif
+    const size_t slots = static_cast<size_t>(Constants::BENCH_GPU_TIMER_SLOTS);
+    auto timer = GlTimerQueries::create(slots);
+    if (!timer) {
+        ConsoleOutput::warning("No GPU timer queries; the report has CPU times only");
+    }
+    const bool gpuTiming = timer != nullptr;
+
+    bool ok = true;
+    _results.clear();
+    const int totalFrames = _options.warmup + _options.frames;
+    std::vector<int16_t> pcm;
+    std::vector<double> cpuSamples;
+    std::vector<double> gpuSamples;
+    std::vector<int> slotFrame(slots, -1);  // Frame whose GPU time a slot holds (-1 = none pending)
+    for (const std::string& presetPath : presets) {
+        PresetBenchmark result;
+        result.path = presetPath;
+        ConsoleOutput::info("Benchmarking " + presetPath);
+
+        auto source =
+            AutoVibez::Audio::SyntheticCapture::createSource(_options.audio, Constants::DEFAULT_SAMPLE_RATE, error);
+        projectm_handle projectM = projectm_create();
+        if (!projectM || !source) {
+            setError(!projectM ? "Failed to create projectM" : error);
+            ok = false;
+            if (projectM) {
+                projectm_destroy(projectM);
+            }
+            break;
+        }
+        projectm_set_window_size(projectM, _options.width, _options.height);
+        projectm_set_mesh_size(projectM, _options.mesh_x, _options.mesh_y);
+        projectm_set_fps(projectM, _options.fps);
+        projectm_set_hard_cut_enabled(projectM, false);
+        projectm_set_preset_locked(projectM, true);
+        if (!_options.textures.empty()) {
+            const char* texturePaths[] = {_options.textures.c_str()};
+            projectm_set_texture_search_paths(projectM, texturePaths, 1);
+        }
+        projectm_set_preset_switch_failed_event_callback(projectM, onSwitchFailed, &result.error);
+
+        glFinish();
+        const auto loadStart = Clock::now();
+        projectm_load_preset_file(projectM, presetPath.c_str(), false);
+        glFinish();
+        result.load_ms = millisecondsSince(loadStart);
+
+        const int sampleRate = source->getSampleRate();
+        int64_t samplesFed = 0;
+        cpuSamples.clear();
+        gpuSamples.clear();
+        std::fill(slotFrame.begin(), slotFrame.end(), -1);
+        auto collect = [&](size_t slot, bool wait) {
+            double ms = 0.0;
+            while (slotFrame[slot] >= 0) {
+                if (timer->poll(slot, ms)) {
+                    if (slotFrame[slot] >= _options.warmup) {
+                        gpuSamples.push_back(ms);
+                    }
+                    slotFrame[slot] = -1;
+                } else if (!wait) {
+                    return;
+                }
+            }
+        };
+
+        for (int frame = 0; result.error.empty() && frame < totalFrames; ++frame) {
+            // Exactly the audio that plays during this frame, as in the video export
+            const int64_t sampleEnd = (static_cast<int64_t>(frame) + 1) * sampleRate / _options.fps;
+            const int count = static_cast<int>(sampleEnd - samplesFed);
+            samplesFed = sampleEnd;
+            pcm.assign(static_cast<size_t>(count) * 2, 0);
+            source->read(pcm.data(), count);
+            if (count > 0) {
+                projectm_pcm_add_int16(projectM, pcm.data(), static_cast<unsigned int>(count), PROJECTM_STEREO);
+            }
+#ifdef HAVE_PROJECTM_FRAME_TIME
+            projectm_set_frame_time(projectM, static_cast<double>(frame) / _options.fps);
+#endif
+
+            const size_t slot = static_cast<size_t>(frame) % slots;
+            if (timer) {
+                // Reusing the slot needs its previous result; with several frames in flight it is there already
+                collect(slot, true);
+                timer->begin(slot);
+                slotFrame[slot] = frame;
+            }
+            const auto renderStart = Clock::now();
+#ifdef HAVE_PROJECTM_RENDER_FBO
+            if (target) {
+                target->bind();
+                projectm_opengl_render_frame_fbo(projectM, target->getFramebuffer());
+            } else
+#endif
+            {
+                glViewport(0, 0, _options.width, _options.height);
+                projectm_opengl_render_frame(projectM);
+            }
+            const double cpuMs = millisecondsSince(renderStart);
+            if (timer) {
+                timer->end();
+            }
+
+            if (frame == 0) {
+                glFinish();
+                result.first_frame_ms = millisecondsSince(renderStart);
+            }
+            if (frame >= _options.warmup) {
+                cpuSamples.push_back(cpuMs);
+            }
+        }
+        if (timer) {
+            glFinish();
+            for (size_t slot = 0; slot < slots; ++slot) {
+                collect(slot, true);
+            }
+        }
+
+        result.cpu = summarize(cpuSamples);
+        result.gpu = summarize(gpuSamples);
+        projectm_destroy(projectM);
+        result.peak_memory_kb = getPeakMemoryKb();
+        if (!result.error.empty()) {
+            ConsoleOutput::warning(presetPath + ": " + result.error);
+            setError("Preset failed to load: " + presetPath);
+            ok = false;
+        }
+        _results.push_back(std::move(result));
+    }
+
+    timer.reset();
+    target.reset();
+    SDL_GL_DeleteContext(context);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+
+    const std::string report = toJson(_options, _results, renderer, gpuTiming);
+    if (_options.output.empty()) {
+        std::fputs(report.c_str(), stdout);
+    } else {
+        std::ofstream file(_options.output, std::ios::binary);
+        file << report;
+        if (!file) {
+            setError("Cannot write " + _options.output);
+            return false;
+        }
+        ConsoleOutput::success("Wrote " + std::to_string(_results.size()) + " preset timings to " + _options.output);
+    }
+    return ok;
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief What autovibez_render_bench renders
+ */
+struct BenchmarkOptions {
+    std::string presets;          //!< Directory of presets, or a text file listing one path per line
+    std::string audio = "kicks";  //!< .wav/.mp3 path or a generated signal (sweep, pink, kicks, sine)
+    std::string output;           //!< JSON report; empty writes it to stdout
+    std::string textures;         //!< Texture search path (empty = none)
+    int frames = Constants::BENCH_DEFAULT_FRAMES;
+    int warmup = Constants::BENCH_DEFAULT_WARMUP_FRAMES;
+    int width = Constants::EXPORT_DEFAULT_WIDTH;
+    int height = Constants::EXPORT_DEFAULT_HEIGHT;
+    int fps = Constants::EXPORT_DEFAULT_FPS;  //!< Frame time step and audio per frame, not a limit
+    int mesh_x = Constants::DEFAULT_MESH_X;
+    int mesh_y = Constants::DEFAULT_MESH_Y;
+};
+
+/**
+ * @brief Mean and tail of one series of frame times, in milliseconds
+ */
+struct TimingSummary {
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    size_t samples = 0;  //!< 0 leaves the other fields at 0
+};
+
+/**
+ * @brief Measurements of one preset
+ */
+struct PresetBenchmark {
+    std::string path;
+    std::string error;            //!< Why projectM rejected the preset (empty when it loaded)
+    double load_ms = 0.0;         //!< Parsing and shader compilation, to GPU completion
+    double first_frame_ms = 0.0;  //!< First frame to GPU completion, including shaders compiled lazily
+    TimingSummary cpu;            //!< Time spent in the render call
+    TimingSummary gpu;            //!< GPU time of the frame (no samples without timer queries)
+    int64_t peak_memory_kb = 0;   //!< Process peak resident memory after the preset
+};
+
+/**
+ * @brief Deterministic offscreen render benchmark over a fixed preset list
+ *
+ * Every preset gets a fresh projectM instance, the same audio from its first sample
+ * and, with projectM 4.1, the same frame times, so two runs on one machine render the
+ * same frames and differences between builds show up in the timings. Frames are drawn
+ * into an offscreen target of a hidden window with no swap and no limiter; the GPU
+ * side is timed with GL_TIME_ELAPSED queries. The report is JSON with one entry
+ * per preset, in list order.
+ */
+class RenderBenchmark : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    explicit RenderBenchmark(BenchmarkOptions options);
+
+    /**
+     * @brief Parse the command line
+     * @param first Index of the first argument to read
+     * @return False with error set when the arguments are incomplete or malformed
+     */
+    static bool parseArgs(int argc, char* argv[], int first, BenchmarkOptions& options, std::string& error);
+
+    /**
+     * @brief Resolve the preset list: a directory is searched recursively and sorted, a list file
+     * keeps its order ('#' starts a comment, relative paths are taken from the file's directory)
+     */
+    static bool listPresets(const std::string& source, std::vector<std::string>& presets, std::string& error);
+
+    static TimingSummary summarize(std::vector<double> samples);
+
+    /**
+     * @brief Peak resident memory of this process so far (0 where unknown)
+     */
+    static int64_t getPeakMemoryKb();
+
+    /**
+     * @brief The report for results measured with options on the named GL renderer
+     */
+    static std::string toJson(const BenchmarkOptions& options, const std::vector<PresetBenchmark>& results,
+                              const std::string& renderer, bool gpuTiming);
+
+    /**
+     * @brief Render every preset and write the report
+     * @return False if the context could not be created, a preset failed to load or the report was not written
+     */
+    bool run();
+
+    const std::vector<PresetBenchmark>& getResults() const {
+        return _results;
+    }
+
+private:
+    BenchmarkOptions _options;
+    std::vector<PresetBenchmark> _results;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,104 @@
+#include "render_scaler.hpp"
+
+#include <SDL2/SDL.h>
+
+#include "gl_entry_points.hpp"
+
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+
+namespace AutoVibez::Core {
+
+namespace {
+GlEntryPoints& entryPoints = GlEntryPoints::get();
+
+bool hasFramebufferBlit() {
+#ifdef USE_GLES
+    return true;  // Core in GLES 3.0
+#else
+    int major = 0;
+    SDL_GL_GetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, &major);
+    return major >= 3 || SDL_GL_ExtensionSupported("GL_ARB_framebuffer_object");
+#endif
+}
+}  // namespace
+
+std::unique_ptr<RenderScaler> RenderScaler::create() {
+    if (!hasFramebufferBlit() || !entryPoints.loadFramebuffers()) {
+        return nullptr;
+    }
+    std::unique_ptr<RenderScaler> scaler(new RenderScaler());
+    GLuint framebuffer = 0;
+    GLuint texture = 0;
+    entryPoints.genFramebuffers(1, &framebuffer);
+    glGenTextures(1, &texture);
+    scaler->_framebuffer = framebuffer;
+    scaler->_texture = texture;
+    return scaler;
+}
+
+bool RenderScaler::setSize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    if (width == _width && height == _height) {
+        return true;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    _memory.set(static_cast<size_t>(width) * height * 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    entryPoints.bindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    entryPoints.framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture, 0);
+    const bool complete = entryPoints.checkFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    entryPoints.bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    _width = complete ? width : 0;
+    _height = complete ? height : 0;
+    return complete;
+}
+
+void RenderScaler::bind() {
+    entryPoints.bindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glViewport(0, 0, _width, _height);
+}
+
+void RenderScaler::blitToBackbuffer(int width, int height) {
+    blitRegionToBackbuffer(0, 0, _width, _height, width, height);
+}
+
+void RenderScaler::blitRegionToBackbuffer(int x, int y, int regionWidth, int regionHeight, int width, int height) {
+    entryPoints.bindFramebuffer(GL_READ_FRAMEBUFFER, _framebuffer);
+    entryPoints.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    entryPoints.blitFramebuffer(x, y, x + regionWidth, y + regionHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+                                GL_LINEAR);
+    entryPoints.bindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Offscreen colour target that projectM renders into at a reduced size
+ *
+ * The image is stretched onto the default framebuffer with one bilinear blit, so
+ * overlays drawn afterwards stay at native resolution. The video exporter renders
+ * into one at the export size and reads it back instead, and MultiOutput blits one
+ * region of it to each display's window. Needs framebuffer blits
+ * (GL 3.0, ARB_framebuffer_object or GLES 3.0); entry points come from
+ * SDL_GL_GetProcAddress like GlTimerQueries. The objects belong to the context
+ * and are released with it.
+ */
+class RenderScaler {
+public:
+    /**
+     * @brief Resolve the framebuffer entry points in the current context
+     * @return nullptr when the context cannot blit between framebuffers
+     */
+    static std::unique_ptr<RenderScaler> create();
+
+    /**
+     * @brief (Re)allocate the target if the size changed
+     * @return True if the framebuffer is complete
+     */
+    bool setSize(int width, int height);
+
+    int getWidth() const {
+        return _width;
+    }
+    int getHeight() const {
+        return _height;
+    }
+    uint32_t getFramebuffer() const {
+        return _framebuffer;
+    }
+
+    /**
+     * @brief Direct drawing into the target and size the viewport to it
+     */
+    void bind();
+
+    /**
+     * @brief Stretch the target onto the default framebuffer, which is left bound
+     */
+    void blitToBackbuffer(int width, int height);
+
+    /**
+     * @brief Stretch part of the target (GL coordinates, bottom-left origin) onto the current default framebuffer
+     */
+    void blitRegionToBackbuffer(int x, int y, int regionWidth, int regionHeight, int width, int height);
+
+private:
+    RenderScaler() = default;
+
+    uint32_t _framebuffer = 0;
+    uint32_t _texture = 0;
+    int _width = 0;
+    int _height = 0;
+    Utils::MemoryCharge _memory{Utils::MemoryTag::GpuRenderTargets};
+};
+
+}  // namespace AutoVibez::Core
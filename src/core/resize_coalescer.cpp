@@ -0,0 +1,38 @@
+#include "resize_coalescer.hpp"
+
+namespace AutoVibez::Core {
+
+ResizeCoalescer::ResizeCoalescer(std::chrono::milliseconds settle) : _settle(settle) {}
+
+bool ResizeCoalescer::onResize(int width, int height, Clock::time_point now) {
+    const int currentWidth = _pending ? _pendingWidth : _appliedWidth;
+    const int currentHeight = _pending ? _pendingHeight : _appliedHeight;
+    if (width == currentWidth && height == currentHeight) {
+        return false;
+    }
+    _pending = true;
+    _pendingWidth = width;
+    _pendingHeight = height;
+    _changedAt = now;
+    return true;
+}
+
+bool ResizeCoalescer::poll(Clock::time_point now, int& width, int& height) {
+    if (!_pending || now - _changedAt < _settle) {
+        return false;
+    }
+    _pending = false;
+    _appliedWidth = _pendingWidth;
+    _appliedHeight = _pendingHeight;
+    width = _appliedWidth;
+    height = _appliedHeight;
+    return true;
+}
+
+void ResizeCoalescer::setApplied(int width, int height) {
+    _pending = false;
+    _appliedWidth = width;
+    _appliedHeight = height;
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Holds back window resizes until the size stops changing
+ *
+ * Dragging a window edge reports a new drawable size on nearly every frame, and
+ * each projectm_set_window_size() rebuilds projectM's render targets. Sizes are
+ * collected here instead; poll() hands out the last one once it has held for the
+ * settle interval, so a drag ends in one rebuild. A size that repeats the pending
+ * or applied one (SDL sends RESIZED and SIZE_CHANGED for each change, and a
+ * fullscreen round trip ends where it started) is not a change at all.
+ */
+class ResizeCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ResizeCoalescer(std::chrono::milliseconds settle = std::chrono::milliseconds(Constants::RESIZE_SETTLE_MS));
+
+    /**
+     * @brief Record a drawable size reported by the window
+     * @return True if it differs from the size pending or, with none pending, the size applied
+     */
+    bool onResize(int width, int height, Clock::time_point now);
+
+    /**
+     * @brief Take the pending size once it has been stable for the settle interval
+     * @return True (once per settled size) with width and height set
+     */
+    bool poll(Clock::time_point now, int& width, int& height);
+
+    /**
+     * @brief Note a size applied directly, dropping anything pending
+     */
+    void setApplied(int width, int height);
+
+    bool isPending() const {
+        return _pending;
+    }
+
+private:
+    std::chrono::milliseconds _settle;
+    bool _pending = false;
+    int _pendingWidth = 0;
+    int _pendingHeight = 0;
+    int _appliedWidth = 0;
+    int _appliedHeight = 0;
+    Clock::time_point _changedAt;
+};
+
+}  // namespace AutoVibez::Core
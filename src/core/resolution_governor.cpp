@@ -0,0 +1,57 @@
+#include "resolution_governor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AutoVibez::Core {
+
+ResolutionGovernor::ResolutionGovernor(double minScale, double maxScale) : _minScale(0.0), _maxScale(1.0), _scale(1.0) {
+    setLimits(minScale, maxScale);
+    _scale = _maxScale;
+}
+
+void ResolutionGovernor::setLimits(double minScale, double maxScale) {
+    _maxScale = std::clamp(maxScale, Constants::RENDER_SCALE_QUANTUM, 1.0);
+    _minScale = std::clamp(minScale, Constants::RENDER_SCALE_QUANTUM, _maxScale);
+    _scale = std::clamp(_scale, _minScale, _maxScale);
+}
+
+bool ResolutionGovernor::addFrame(double renderMs) {
+    if (renderMs <= 0.0 || _budgetMs <= 0.0) {
+        return false;
+    }
+    if (_settleFrames > 0) {
+        --_settleFrames;
+        return false;
+    }
+    _sumMs += renderMs;
+    if (++_frames < Constants::RENDER_SCALE_WINDOW_FRAMES) {
+        return false;
+    }
+
+    const double meanShare = _sumMs / _frames / _budgetMs;
+    _sumMs = 0.0;
+    _frames = 0;
+    if (meanShare <= Constants::RENDER_SCALE_HIGH_SHARE && meanShare >= Constants::RENDER_SCALE_LOW_SHARE) {
+        return false;
+    }
+
+    double target = _scale * std::sqrt(Constants::RENDER_SCALE_TARGET_SHARE / meanShare);
+    target = std::clamp(target, _scale - Constants::RENDER_SCALE_MAX_STEP, _scale + Constants::RENDER_SCALE_MAX_STEP);
+    target = std::round(target / Constants::RENDER_SCALE_QUANTUM) * Constants::RENDER_SCALE_QUANTUM;
+    target = std::clamp(target, _minScale, _maxScale);
+    if (std::abs(target - _scale) < Constants::RENDER_SCALE_QUANTUM / 2) {
+        return false;
+    }
+    _scale = target;
+    _settleFrames = Constants::RENDER_SCALE_SETTLE_FRAMES;
+    return true;
+}
+
+void ResolutionGovernor::reset() {
+    _sumMs = 0.0;
+    _frames = 0;
+    _settleFrames = Constants::RENDER_SCALE_SETTLE_FRAMES;
+}
+
+}  // namespace AutoVibez::Core
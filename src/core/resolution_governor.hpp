@@ -0,0 +1,60 @@
+#pragma once
+
+#include "constants.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief Picks projectM's render scale from the measured cost of its render phase
+ *
+ * Render times are averaged over a window of frames. When the average takes more
+ * than RENDER_SCALE_HIGH_SHARE of the frame budget the scale drops, and when it
+ * takes less than RENDER_SCALE_LOW_SHARE the scale rises. Render cost follows the
+ * pixel count, so the new scale aims the average at RENDER_SCALE_TARGET_SHARE
+ * through the square root of the ratio. Each change moves at most one step and
+ * snaps to RENDER_SCALE_QUANTUM. The next few frames pay for the new framebuffer
+ * and are skipped. Pure logic; the render thread feeds it.
+ */
+class ResolutionGovernor {
+public:
+    explicit ResolutionGovernor(double minScale = Constants::DEFAULT_MIN_RENDER_SCALE, double maxScale = 1.0);
+
+    /**
+     * @brief Set the scale bounds, clamping the current scale into them
+     */
+    void setLimits(double minScale, double maxScale);
+
+    /**
+     * @brief Set the frame time the governor budgets against
+     */
+    void setBudgetMs(double budgetMs) {
+        _budgetMs = budgetMs;
+    }
+
+    /**
+     * @brief Add one frame's render phase time (the slower of its CPU and GPU times)
+     * @return True if the scale changed on this frame
+     */
+    bool addFrame(double renderMs);
+
+    /**
+     * @brief Restart measuring, e.g. after the window was resized
+     */
+    void reset();
+
+    double getScale() const {
+        return _scale;
+    }
+
+private:
+    double _minScale;
+    double _maxScale;
+    double _scale;
+    double _budgetMs = 1000.0 / Constants::DEFAULT_FPS_VALUE;
+
+    double _sumMs = 0.0;
+    int _frames = 0;
+    int _settleFrames = 0;
+};
+
+}  // namespace AutoVibez::Core
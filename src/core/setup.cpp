@@ -1,11 +1,26 @@
 #include "setup.hpp"
 
+#include "app_config.hpp"
 #include "autovibez_app.hpp"
-#include "config_manager.hpp"
 #include "constants.hpp"
+#include "decoder_backend.hpp"
+#include "imgui_manager.hpp"
+#include "mp3_decoder.hpp"
 #include "path_manager.hpp"
+#include "string_utils.hpp"
+#include "trace_recorder.hpp"
 #include "utils/logger.hpp"
+using AutoVibez::Core::AppStartup;
 using AutoVibez::Core::AutoVibezApp;
+using AutoVibez::Core::FramePacer;
+using AutoVibez::Core::FramePacingMode;
+using AutoVibez::Core::ImageEncoder;
+using AutoVibez::Core::ImageFormat;
+using AutoVibez::Core::PowerPolicy;
+using AutoVibez::Core::PowerSavingMode;
+using AutoVibez::Core::QualityBounds;
+using AutoVibez::Core::QualityGovernor;
+using AutoVibez::Core::StartupGraph;
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_hints.h>
 
@@ -15,9 +30,12 @@ using AutoVibez::Core::AutoVibezApp;
 #include <fstream>
 
 using AutoVibez::Audio::configureLoopback;
+using AutoVibez::Audio::DecoderBackend;
 using AutoVibez::Audio::initLoopback;
-using AutoVibez::Data::ConfigFile;
+using AutoVibez::Audio::Mp3Decoder;
+using AutoVibez::Data::AppConfig;
 using AutoVibez::Data::MixManager;
+using AutoVibez::Data::MixMetadata;
 
 std::string expandTilde(const std::string& path) {
     if (path.empty() || path[0] != '~') {
@@ -196,9 +214,132 @@ void enableGLDebugOutput() {
 #endif
 }
 
+void findAssetPaths(const AppConfig* config, std::string& presetPath, std::string& texturePath) {
+    std::string xdg_assets = getAssetsDirectory();
+    presetPath = xdg_assets + "/presets";
+    texturePath = xdg_assets + "/textures";
+
+    if (std::filesystem::exists(xdg_assets + "/presets")) {
+        presetPath = xdg_assets + "/presets";
+        texturePath = xdg_assets + "/textures";
+    } else {
+        std::string local_assets = "assets";
+        if (std::filesystem::exists(local_assets + "/presets")) {
+            presetPath = local_assets + "/presets";
+            texturePath = local_assets + "/textures";
+        }
+    }
+
+    if (config) {
+        const std::string& configPreset = config->preset_path;
+        const std::string& configTexture = config->texture_path;
+
+        if (!configPreset.empty()) {
+            std::string expandedPreset = expandTilde(configPreset);
+            if (std::filesystem::exists(expandedPreset)) {
+                presetPath = expandedPreset;
+            }
+        }
+        if (!configTexture.empty()) {
+            std::string expandedTexture = expandTilde(configTexture);
+            if (std::filesystem::exists(expandedTexture)) {
+                texturePath = expandedTexture;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Hardware profile: the configured quality_profile, or one detected from the GPU name
+ */
+static std::string readHardwareProfile(const AppConfig& config) {
+    if (config.quality_profile != "auto") {
+        return config.quality_profile;
+    }
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    return QualityGovernor::detectProfile(renderer ? reinterpret_cast<const char*>(renderer) : "");
+}
+
+/**
+ * @brief Quality governor ranges: the configured settings are the ceilings, the hardware profile the floors
+ */
+static QualityBounds readQualityBounds(const AppConfig& config, std::string& profile) {
+    profile = readHardwareProfile(config);
+
+    QualityBounds bounds;
+    if (!QualityGovernor::getProfileBounds(profile, bounds)) {
+        ::AutoVibez::Utils::Logger logger;
+        logger.logWarning("Unknown quality_profile '" + profile + "', using medium");
+        profile = "medium";
+        QualityGovernor::getProfileBounds(profile, bounds);
+    }
+    // Which keys apply depends on the GPU, so these few are read here rather than parsed up front
+    config.file->readInto(bounds.min_mesh_x, "quality_" + profile + "_min_mesh");
+    config.file->readInto(bounds.min_fps, "quality_" + profile + "_min_fps");
+    config.file->readInto(bounds.min_render_scale, "quality_" + profile + "_min_render_scale");
+
+    bounds.max_mesh_x = config.mesh_x;
+    bounds.max_fps = static_cast<int>(config.fps);
+    bounds.max_render_scale = config.render_scale;
+    return bounds;
+}
+
+std::shared_ptr<AppStartup> beginStartup(bool visuals) {
+    auto startup = std::make_shared<AppStartup>();
+    AppStartup* state = startup.get();
+    StartupGraph& graph = startup->graph;
+
+    graph.add(AppStartup::CONFIG_TASK, {}, [state]() {
+        state->config_path = findConfigFile();
+        if (!state->config_path.empty()) {
+            state->config = AppConfig::load(state->config_path);
+        }
+    });
+    if (visuals) {
+        graph.add(AppStartup::ASSETS_TASK, {AppStartup::CONFIG_TASK},
+                  [state]() { findAssetPaths(state->config.get(), state->preset_path, state->texture_path); });
+
+        // One file to read on most starts; the first one walks the tree here rather than in projectM on the main
+        // thread
+        graph.add(AppStartup::PRESETS_TASK, {AppStartup::ASSETS_TASK}, [state]() {
+            AutoVibez::Data::PresetManifest& presets = state->presets;
+            state->presets_from_manifest =
+                presets.load(PathManager::getPresetManifestPath(), state->preset_path) && presets.size() > 0;
+            if (!state->presets_from_manifest) {
+                presets.rescan(state->preset_path);
+                presets.save(PathManager::getPresetManifestPath());
+            }
+        });
+    }
+
+    // Connects to the sound server and waits for the first volume reading
+    graph.add(AppStartup::VOLUME_TASK, {},
+              [state]() { state->volume_controller = AutoVibez::Utils::SystemVolumeControllerFactory::create(); });
+
+    // Fetched while the database opens; the mix control thread syncs it once both are done
+    graph.add(AppStartup::MANIFEST_TASK, {AppStartup::CONFIG_TASK}, [state]() {
+        const std::string url = state->config ? state->config->mixes_url : "";
+        if (url.empty()) {
+            return;
+        }
+        MixMetadata metadata;
+        metadata.setCachePath(PathManager::getManifestCachePath());
+        metadata.setSnapshotPath(PathManager::getManifestSnapshotPath());
+        state->manifest_mixes = metadata.loadFromYaml(url);
+        state->manifest_loaded = metadata.isSuccess();
+        state->manifest_unchanged = metadata.isUnchanged();
+    });
+
+    graph.start();
+    return startup;
+}
+
 AutoVibezApp* setupSDLApp() {
+    AUTOVIBEZ_TRACE_THREAD("main");
+    AUTOVIBEZ_TRACE_SCOPE("startup", "setupSDLApp");
     AutoVibezApp* app;
     seedRand();
+    const std::shared_ptr<AppStartup> startup = beginStartup();
 
     if (!initLoopback()) {
         ::AutoVibez::Utils::Logger logger;
@@ -244,92 +385,104 @@ AutoVibezApp* setupSDLApp() {
 
     SDL_SetWindowTitle(win, "AutoVibez");
 
-    SDL_GL_MakeCurrent(win, glCtx);           // associate GL context with main window
-    int avsync = SDL_GL_SetSwapInterval(-1);  // try to enable adaptive vsync
-    if (avsync == -1) {                       // adaptive vsync not supported
-        SDL_GL_SetSwapInterval(1);            // enable updates synchronized with vertical retrace
-    }
-
-    std::string base_path = getAssetsDirectory();
-
-    std::string configFilePath = findConfigFile();
-    if (configFilePath.empty()) {
-        // Continue with defaults instead of returning early
-    }
-
-    std::string presetURL = base_path + "/presets";
-    std::string textureURL = base_path + "/textures";
-
-    std::string xdg_assets = getAssetsDirectory();
-    if (std::filesystem::exists(xdg_assets + "/presets")) {
-        presetURL = xdg_assets + "/presets";
-        textureURL = xdg_assets + "/textures";
-    } else {
-        std::string local_assets = "assets";
-        if (std::filesystem::exists(local_assets + "/presets")) {
-            presetURL = local_assets + "/presets";
-            textureURL = local_assets + "/textures";
-        }
-    }
+    SDL_GL_MakeCurrent(win, glCtx);  // associate GL context with main window; the frame pacer sets the swap interval
 
-    if (!configFilePath.empty()) {
-        ConfigFile config(configFilePath);
-        std::string configPreset = config.getPresetPath();
-        std::string configTexture = config.getTexturePath();
-
-        if (!configPreset.empty()) {
-            std::string expandedPreset = expandTilde(configPreset);
-            if (std::filesystem::exists(expandedPreset)) {
-                presetURL = expandedPreset;
-            }
-        }
-        if (!configTexture.empty()) {
-            std::string expandedTexture = expandTilde(configTexture);
-            if (std::filesystem::exists(expandedTexture)) {
-                textureURL = expandedTexture;
-            }
-        }
+    // The window and context were made while the config was read; without a file the defaults apply
+    {
+        AUTOVIBEZ_TRACE_SCOPE("startup", "wait_assets");
+        startup->graph.wait(AppStartup::ASSETS_TASK);
     }
-
     int audioDeviceIndex = 0;
     bool showFps = false;
 
-    if (!configFilePath.empty()) {
-        ConfigFile config(configFilePath);
-
-        audioDeviceIndex = config.getAudioDeviceIndex();
-        showFps = config.getShowFps();
+    if (startup->config) {
+        audioDeviceIndex = startup->config->audio_device;
+        showFps = startup->config->show_fps;
     }
 
-    app = new AutoVibezApp(glCtx, presetURL, textureURL, audioDeviceIndex, showFps);
+    app = new AutoVibezApp(glCtx, startup, audioDeviceIndex, showFps);
 
-    if (!configFilePath.empty()) {
-        ConfigFile config(configFilePath);
+    if (startup->config) {
+        const AppConfig& config = *startup->config;
         auto* projectMHandle = app->projectM();
 
-        projectm_set_mesh_size(projectMHandle,
-                               config.read<uint32_t>(StringConstants::MESH_X_KEY, Constants::DEFAULT_MESH_X),
-                               config.read<uint32_t>(StringConstants::MESH_Y_KEY, Constants::DEFAULT_MESH_Y));
+        projectm_set_mesh_size(projectMHandle, static_cast<uint32_t>(config.mesh_x),
+                               static_cast<uint32_t>(config.mesh_y));
 
         // Get window size from config
-        int configWidth = config.read<uint32_t>(StringConstants::WINDOW_WIDTH_KEY, Constants::DEFAULT_WINDOW_SIZE);
-        int configHeight = config.read<uint32_t>(StringConstants::WINDOW_HEIGHT_KEY, Constants::DEFAULT_WINDOW_SIZE);
+        int configWidth = config.window_width;
+        int configHeight = config.window_height;
         SDL_SetWindowSize(win, configWidth, configHeight);
-        projectm_set_soft_cut_duration(projectMHandle, config.read<double>("Smooth Preset Duration", 3));
-        projectm_set_preset_duration(projectMHandle, config.read<double>(StringConstants::PRESET_DURATION_KEY,
-                                                                         Constants::DEFAULT_PRESET_DURATION));
-        projectm_set_easter_egg(projectMHandle, config.read<float>("Easter Egg Parameter", 0.0));
-        projectm_set_hard_cut_enabled(projectMHandle, config.read<bool>("hard_cuts_enabled", false));
-        projectm_set_hard_cut_duration(projectMHandle, config.read<double>(StringConstants::HARD_CUT_DURATION_KEY,
-                                                                           Constants::DEFAULT_HARD_CUT_DURATION));
-        projectm_set_hard_cut_sensitivity(projectMHandle, config.read<float>("hard_cut_sensitivity", 1.0));
-        projectm_set_beat_sensitivity(projectMHandle, config.read<float>("beat_sensitivity", 1.0));
-        projectm_set_aspect_correction(projectMHandle, config.read<bool>("Aspect Correction", true));
-        projectm_set_fps(projectMHandle, config.read<int32_t>(StringConstants::FPS_KEY, Constants::DEFAULT_FPS_VALUE));
+        app->applyPresetTiming(config);
+        projectm_set_easter_egg(projectMHandle, config.easter_egg);
+        projectm_set_aspect_correction(projectMHandle, config.aspect_correction);
+        projectm_set_fps(projectMHandle, static_cast<int32_t>(config.fps));
+
+        app->setInternalAudioEnabled(config.internal_audio);
+        app->setDownmixWeights(config.downmix_weights);
+        std::string decoderSynth;
+        if (!DecoderBackend::select(config.decoder_backend, readHardwareProfile(config),
+                                    Mp3Decoder::getSupportedSynths(), decoderSynth)) {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown decoder_backend '" + config.decoder_backend + "', using auto");
+        }
+        app->setDecoderSynth(decoderSynth);
+        app->setNativeMonitorEnabled(config.native_monitor);
+        app->setNativeSampleRateEnabled(config.native_sample_rate);
+        app->setCaptureBufferSizing(config.adaptive_capture_period, config.capture_period_frames);
+        app->setLatencyCompensation(config.latency_compensation, config.display_queue_frames,
+                                    config.av_offset_ms);
+        app->setSyntheticAudio(config.synthetic_audio, config.synthetic_audio_speed);
+
+        FramePacingMode pacing = FramePacingMode::Vsync;
+        if (!FramePacer::parseMode(config.frame_pacing, pacing)) {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown frame_pacing '" + config.frame_pacing + "', using vsync");
+        }
+        app->setFramePacing(pacing, config.fps);
+        const std::string renderThread = ::AutoVibez::Utils::StringUtils::toLower(config.render_thread);
+        if (renderThread == "on" || renderThread == "off") {
+            app->setRenderThread(renderThread == "on");
+        } else if (renderThread != "auto") {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown render_thread '" + config.render_thread + "', using auto");
+        }
+        const std::string overlayRenderer = ::AutoVibez::Utils::StringUtils::toLower(config.overlay_renderer);
+        if (overlayRenderer == "gl2") {
+            ::AutoVibez::UI::ImGuiManager::setLegacyBackend(true);
+        } else if (overlayRenderer != "gl3") {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown overlay_renderer '" + config.overlay_renderer + "', using gl3");
+        }
+        PowerSavingMode powerSaving = PowerSavingMode::Pause;
+        if (!PowerPolicy::parseMode(config.power_saving, powerSaving)) {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown power_saving '" + config.power_saving + "', using pause");
+        }
+        app->setPowerSaving(powerSaving, config.power_saving_fps, config.power_saving_unfocused);
+        app->setPresetCostProfiling(config.profile_preset_cost, config.skip_slow_presets);
+        app->setPresetScheduling(config.preset_scheduling);
+        app->setRenderScale(config.render_scale, config.dynamic_render_scale, config.min_render_scale);
+        app->setMultiOutput(config.multi_output, config.multi_output_bezel, config.multi_output_width);
+        if (config.quality_governor) {
+            std::string profile;
+            const QualityBounds bounds = readQualityBounds(config, profile);
+            const double meshAspect = static_cast<double>(config.mesh_y) / bounds.max_mesh_x;
+            app->setQualityGovernor(bounds, meshAspect, profile);
+        }
+        ImageFormat screenshotFormat = ImageFormat::Png;
+        if (!ImageEncoder::parseFormat(config.screenshot_format, screenshotFormat)) {
+            ::AutoVibez::Utils::Logger logger;
+            logger.logWarning("Unknown screenshot_format '" + config.screenshot_format + "', using png");
+        }
+        app->setScreenshotFormat(screenshotFormat, config.screenshot_jpeg_quality);
+        app->setTextureCache(config.texture_cache);
+        app->setMetricsExport(config.metrics_statsd, config.metrics_textfile);
+        app->setRemoteControl(config.remote_control_port, config.remote_control_token);
+        app->setNodeSync(config.sync_role);
 
         // Handle fullscreen setting
-        bool fullscreen = config.read<bool>("fullscreen", false);
-        if (fullscreen) {
+        if (config.fullscreen) {
             SDL_SetWindowFullscreen(win, SDL_WINDOW_FULLSCREEN_DESKTOP);
         } else {
             // Center the window on screen
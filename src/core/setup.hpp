@@ -1,7 +1,9 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
+#include "app_startup.hpp"
 #include "autovibez_app.hpp"
 
 namespace AutoVibez::Core {
@@ -13,6 +15,19 @@ void debugGL();
 std::string getConfigDirectory();
 std::string getConfigFilePath(std::string datadir_path);
 std::string findConfigFile();
+
+/**
+ * @brief Preset and texture directories: the config's if they exist, else the installed or local assets
+ * @param config Null without a config file
+ */
+void findAssetPaths(const AutoVibez::Data::AppConfig* config, std::string& presetPath, std::string& texturePath);
+
+/**
+ * @brief Start what the first frame does not need on a StartupGraph: config, asset paths, the preset list, the
+ *        volume backend probe and the mix manifest fetch
+ * @param visuals False to leave out the asset paths and the preset list, for the headless player
+ */
+std::shared_ptr<AutoVibez::Core::AppStartup> beginStartup(bool visuals = true);
 void seedRand();
 void initGL();
 void enableGLDebugOutput();
@@ -0,0 +1,168 @@
+#include "startup_graph.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "trace_recorder.hpp"
+#include "utils/logger.hpp"
+
+namespace AutoVibez::Core {
+
+StartupGraph::StartupGraph(size_t workers) {
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    _workers = workers > 0 ? workers : std::min(cores, static_cast<size_t>(Constants::STARTUP_MAX_WORKERS));
+}
+
+StartupGraph::~StartupGraph() {
+    // Tasks queued on a pool that never started would never finish
+    if (!_threads.empty()) {
+        waitAll();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _ready.notify_all();
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+bool StartupGraph::add(const std::string& name, const std::vector<std::string>& after, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_nodes.count(name) > 0) {
+            return false;
+        }
+        for (const std::string& dependency : after) {
+            if (_nodes.count(dependency) == 0) {
+                return false;
+            }
+        }
+
+        Node node;
+        node.task = std::move(task);
+        for (const std::string& dependency : after) {
+            Node& needed = _nodes[dependency];
+            if (!needed.done) {
+                needed.dependents.push_back(name);
+                node.waiting++;
+            } else if (needed.failed) {
+                node.failed = true;
+            }
+        }
+        const bool ready = node.waiting == 0;
+        _nodes.emplace(name, std::move(node));
+        _pending++;
+        if (!ready) {
+            return true;
+        }
+        _queue.push_back(name);
+    }
+    _ready.notify_one();
+    return true;
+}
+
+void StartupGraph::start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_threads.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < _workers; ++i) {
+        _threads.emplace_back(&StartupGraph::run, this);
+    }
+}
+
+bool StartupGraph::wait(const std::string& name) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _nodes.find(name);
+    if (it == _nodes.end()) {
+        return false;
+    }
+    // Nodes are never erased, and a rehash keeps references to them valid
+    const Node& node = it->second;
+    _finished.wait(lock, [&node]() { return node.done; });
+    return !node.failed;
+}
+
+bool StartupGraph::isDone(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _nodes.find(name);
+    return it != _nodes.end() && it->second.done;
+}
+
+void StartupGraph::waitAll() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [this]() { return _pending == 0; });
+}
+
+std::vector<StartupTaskTiming> StartupGraph::getTimings() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _timings;
+}
+
+double StartupGraph::elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - _created).count();
+}
+
+void StartupGraph::run() {
+    AUTOVIBEZ_TRACE_THREAD("startup");
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _ready.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+        if (_queue.empty()) {
+            break;
+        }
+        const std::string name = std::move(_queue.front());
+        _queue.pop_front();
+        Node& node = _nodes[name];
+        const double start_ms = elapsedMs();
+        if (node.failed) {
+            finish(name, false, start_ms);
+            continue;
+        }
+
+        Task task = std::move(node.task);
+        lock.unlock();
+        bool ok = true;
+        try {
+#ifdef AUTOVIBEZ_TRACING
+            // Task names are the event names, so each task gets its own row label in the viewer
+            ::AutoVibez::Utils::TraceScope trace("startup", ::AutoVibez::Utils::TraceRecorder::instance().intern(name));
+#endif
+            task();
+        } catch (const std::exception& e) {
+            ok = false;
+            ::AutoVibez::Utils::Logger logger;
+            logger.logError("Startup task " + name + " failed: " + e.what());
+        }
+        task = nullptr;  // Whatever it captured is released outside the lock
+        lock.lock();
+        finish(name, ok, start_ms);
+    }
+}
+
+void StartupGraph::finish(const std::string& name, bool ok, double start_ms) {
+    Node& node = _nodes[name];
+    node.done = true;
+    node.failed = !ok;
+    _pending--;
+    _timings.push_back({name, start_ms, elapsedMs() - start_ms, ok});
+
+    size_t queued = 0;
+    for (const std::string& dependent : node.dependents) {
+        Node& next = _nodes[dependent];
+        next.failed = next.failed || !ok;
+        if (--next.waiting == 0) {
+            _queue.push_back(dependent);
+            queued++;
+        }
+    }
+    for (size_t i = 0; i < queued; ++i) {
+        _ready.notify_one();
+    }
+    _finished.notify_all();
+}
+
+}  // namespace AutoVibez::Core
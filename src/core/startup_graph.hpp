@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief When one startup task ran, relative to the graph's creation
+ */
+struct StartupTaskTiming {
+    std::string name;
+    double start_ms = 0.0;
+    double duration_ms = 0.0;
+    bool ok = true;  // False if it threw, or was skipped after a task it needs failed
+};
+
+/**
+ * @brief Startup work as named tasks that run on a small pool as soon as what they need is done
+ *
+ * A task can only depend on tasks added before it, so the graph never has a cycle. Tasks
+ * may be added before or after start(); one whose dependencies are already done is
+ * queued at once. The thread that needs a result waits for just that task. A task that
+ * throws counts as failed, and everything that depends on it is skipped. Thread-safe.
+ */
+class StartupGraph {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param workers 0 for one per core, within STARTUP_MAX_WORKERS
+     */
+    explicit StartupGraph(size_t workers = 0);
+
+    /**
+     * @brief Waits for every task, then joins
+     */
+    ~StartupGraph();
+
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    /**
+     * @brief Add a task that runs once every task in after is done
+     * @return False if the name is taken or a dependency was never added
+     */
+    bool add(const std::string& name, const std::vector<std::string>& after, Task task);
+
+    /**
+     * @brief Start the pool; tasks added so far with nothing to wait for run first
+     */
+    void start();
+
+    /**
+     * @brief Block until a task has run or been skipped
+     * @return Whether it ran without throwing; false for a name never added
+     */
+    bool wait(const std::string& name);
+
+    bool isDone(const std::string& name) const;
+
+    /**
+     * @brief Block until every task added so far has run or been skipped
+     */
+    void waitAll();
+
+    /**
+     * @brief Finished tasks, in the order they finished
+     */
+    std::vector<StartupTaskTiming> getTimings() const;
+
+    /**
+     * @brief Milliseconds since the graph was created
+     */
+    double elapsedMs() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        Task task;
+        std::vector<std::string> dependents;
+        size_t waiting = 0;  // Dependencies not done yet
+        bool done = false;
+        bool failed = false;
+    };
+
+    Clock::time_point _created = Clock::now();
+    size_t _workers;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _ready;     // A task to run, or stopping
+    std::condition_variable _finished;  // A task finished
+    std::unordered_map<std::string, Node> _nodes;
+    std::deque<std::string> _queue;
+    std::vector<StartupTaskTiming> _timings;
+    size_t _pending = 0;  // Added and not done
+    bool _stopping = false;
+    std::vector<std::thread> _threads;
+
+    void run();
+    void finish(const std::string& name, bool ok, double start_ms);
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,327 @@
+#include "texture_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <unordered_set>
+
+#include "image_decoder.hpp"
+#include "string_utils.hpp"
+#include "texture_compressor.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+using AutoVibez::Utils::StringUtils;
+
+constexpr const char* INDEX_VERSION = "texturecache1";
+constexpr const char* SAMPLER_PREFIX = "sampler_";
+
+bool statFile(const std::filesystem::path& path, uintmax_t& size, int64_t& mtime) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto written = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(written.time_since_epoch().count());
+    return true;
+}
+
+std::string getTextureName(const std::string& relative) {
+    return StringUtils::toLower(std::filesystem::path(relative).stem().string());
+}
+
+bool isBuiltInTexture(const std::string& name) {
+    static const std::unordered_set<std::string> builtIn = {"main",     "noise_lq",    "noise_lq_lite", "noise_mq",
+                                                            "noise_hq", "noisevol_lq", "noisevol_hq",   "blur1",
+                                                            "blur2",    "blur3"};
+    // rand00 to rand15 pick a random texture at load time, so there is nothing to prefetch
+    return builtIn.count(name) > 0 || name.rfind("rand", 0) == 0;
+}
+}  // namespace
+
+TextureCache::~TextureCache() {
+    stop();
+}
+
+bool TextureCache::isTextureFile(const std::string& path) {
+    static const std::set<std::string> extensions = {".jpg", ".jpeg", ".dds", ".png", ".tga", ".bmp", ".dib"};
+    return extensions.count(StringUtils::toLower(std::filesystem::path(path).extension().string())) > 0;
+}
+
+bool TextureCache::open(const std::string& source_dir, const std::string& cache_dir, const std::string& index_path) {
+    _sourceDir = source_dir;
+    _cacheDir = cache_dir;
+    _indexPath = index_path;
+    _current = false;
+    _jobs.clear();
+    _prefetchPaths.clear();
+
+    // What earlier runs left, if it was built from this directory
+    std::map<std::string, TextureCacheEntry> indexed;
+    std::ifstream file(index_path);
+    std::string line;
+    bool sameRoot = false;
+    if (std::getline(file, line) && line == INDEX_VERSION && std::getline(file, line)) {
+        std::vector<std::string> fields = StringUtils::splitFields(line, '\t');
+        sameRoot = fields.size() == 2 && fields[0] == "R" && StringUtils::unescapeField(fields[1]) == source_dir;
+    }
+    while (sameRoot && std::getline(file, line)) {
+        std::vector<std::string> fields = StringUtils::splitFields(line, '\t');
+        if (fields.size() != 5 || fields[0] != "T") {
+            indexed.clear();
+            break;
+        }
+        try {
+            TextureCacheEntry entry;
+            entry.source = StringUtils::unescapeField(fields[1]);
+            entry.size = std::stoull(fields[2]);
+            entry.mtime = std::stoll(fields[3]);
+            entry.cached = StringUtils::unescapeField(fields[4]);
+            indexed[entry.source] = std::move(entry);
+        } catch (const std::exception&) {
+            indexed.clear();
+            break;
+        }
+    }
+
+    // Keep what is still up to date; everything else becomes a job
+    std::map<std::string, TextureCacheEntry> entries;
+    std::vector<TextureCacheEntry> pending;
+    std::error_code error;
+    const std::filesystem::path root(source_dir);
+    for (std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+        if (!it->is_regular_file(error) || !isTextureFile(it->path().string())) {
+            continue;
+        }
+        TextureCacheEntry entry;
+        entry.source = it->path().lexically_relative(root).generic_string();
+        if (!statFile(it->path(), entry.size, entry.mtime)) {
+            continue;
+        }
+        auto known = indexed.find(entry.source);
+        if (known != indexed.end() && known->second.size == entry.size && known->second.mtime == entry.mtime &&
+            std::filesystem::is_regular_file(std::filesystem::path(cache_dir) / known->second.cached, error)) {
+            entries[entry.source] = known->second;
+        } else {
+            pending.push_back(std::move(entry));
+        }
+    }
+
+    // Copies of textures that went away would still be found by projectM
+    for (const auto& [source, entry] : indexed) {
+        if (entries.count(source) == 0) {
+            std::filesystem::remove(std::filesystem::path(cache_dir) / entry.cached, error);
+        }
+    }
+
+    // Names are claimed in order: a second "clouds" image keeps its own extension instead of overwriting clouds.dds
+    std::set<std::string> claimed;
+    for (const auto& [source, entry] : entries) {
+        claimed.insert(entry.cached);
+    }
+    std::sort(pending.begin(), pending.end(),
+              [](const TextureCacheEntry& a, const TextureCacheEntry& b) { return a.source < b.source; });
+    for (auto& entry : pending) {
+        Job job;
+        const std::string compressed = std::filesystem::path(entry.source).replace_extension(".dds").generic_string();
+        job.compress = ImageDecoder::canRead(entry.source) && claimed.count(compressed) == 0;
+        entry.cached = job.compress ? compressed : entry.source;
+        if (!claimed.insert(entry.cached).second) {
+            continue;  // Only reachable for the same name under a different extension; projectM picks one anyway
+        }
+        job.entry = std::move(entry);
+        _jobs.push_back(std::move(job));
+    }
+
+    _current = _jobs.empty() && !entries.empty();
+    for (const auto& [source, entry] : entries) {
+        _prefetchPaths.emplace(getTextureName(source), (std::filesystem::path(cache_dir) / entry.cached).string());
+    }
+    if (!_current) {
+        // projectM reads the texture directory this run
+        _prefetchPaths.clear();
+        for (const auto& [source, entry] : entries) {
+            _prefetchPaths.emplace(getTextureName(source), (root / source).string());
+        }
+        for (const auto& job : _jobs) {
+            _prefetchPaths.emplace(getTextureName(job.entry.source), (root / job.entry.source).string());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries = std::move(entries);
+    return _current;
+}
+
+void TextureCache::start(size_t threads, CompletionCallback done) {
+    if (_jobs.empty() || !_threads.empty()) {
+        return;
+    }
+    _done = std::move(done);
+    _stop = false;
+    _nextJob = 0;
+    threads = std::clamp<size_t>(threads, 1, _jobs.size());
+    _running = threads;
+    for (size_t i = 0; i < threads; ++i) {
+        _threads.emplace_back(&TextureCache::work, this);
+    }
+}
+
+void TextureCache::stop() {
+    _stop = true;
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void TextureCache::work() {
+    for (size_t next = _nextJob++; next < _jobs.size() && !_stop; next = _nextJob++) {
+        const Job& job = _jobs[next];
+        std::string error;
+        const bool ok = transcode((std::filesystem::path(_sourceDir) / job.entry.source).string(),
+                                  (std::filesystem::path(_cacheDir) / job.entry.cached).string(), job.compress, error);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (ok) {
+            _entries[job.entry.source] = job.entry;
+            ++_transcoded;
+        } else {
+            ++_failed;
+        }
+    }
+    if (--_running == 0) {
+        finish();
+    }
+}
+
+void TextureCache::finish() {
+    // Saved even when stopped early, so the next run only does the rest
+    save();
+    if (_done) {
+        size_t transcoded = 0;
+        size_t failed = 0;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            transcoded = _transcoded;
+            failed = _failed;
+        }
+        _done(transcoded, failed);
+    }
+}
+
+bool TextureCache::transcode(const std::string& source, const std::string& target, bool compress,
+                             std::string& error) {
+    std::error_code fsError;
+    const std::filesystem::path targetPath(target);
+    std::filesystem::create_directories(targetPath.parent_path(), fsError);
+
+    // Written beside the target and renamed so projectM never finds half a file
+    const std::string tempPath = target + ".tmp";
+    if (compress) {
+        std::vector<uint8_t> rgba;
+        int width = 0;
+        int height = 0;
+        if (!ImageDecoder::read(source, rgba, width, height, error)) {
+            return false;
+        }
+        const BlockFormat format = TextureCompressor::chooseFormat(rgba);
+        if (!TextureCompressor::writeDds(tempPath, format, width, height,
+                                         TextureCompressor::compress(rgba, width, height, format), error)) {
+            return false;
+        }
+    } else if (!std::filesystem::copy_file(source, tempPath, std::filesystem::copy_options::overwrite_existing,
+                                           fsError)) {
+        error = "Cannot copy " + source + ": " + fsError.message();
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, targetPath, fsError);
+    if (fsError) {
+        error = "Cannot write " + target + ": " + fsError.message();
+        std::filesystem::remove(tempPath, fsError);
+        return false;
+    }
+    return true;
+}
+
+bool TextureCache::save() const {
+    std::error_code error;
+    auto parent = std::filesystem::path(_indexPath).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    const std::string tempPath = _indexPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << INDEX_VERSION << '\n' << "R\t" << StringUtils::escapeField(_sourceDir) << '\n';
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& [source, entry] : _entries) {
+            file << "T\t" << StringUtils::escapeField(source) << '\t' << entry.size << '\t' << entry.mtime << '\t'
+                 << StringUtils::escapeField(entry.cached) << '\n';
+        }
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, _indexPath, error);
+    return !error;
+}
+
+void TextureCache::prefetch(const std::string& preset_text) const {
+    char buffer[65536];
+    for (const std::string& name : findTextureReferences(preset_text)) {
+        auto path = _prefetchPaths.find(name);
+        if (path == _prefetchPaths.end()) {
+            continue;
+        }
+        // Only the read matters: the file is in memory when projectM opens it
+        std::ifstream file(path->second, std::ios::binary);
+        while (file.read(buffer, sizeof(buffer))) {
+            continue;
+        }
+    }
+}
+
+std::vector<std::string> TextureCache::findTextureReferences(const std::string& preset_text) {
+    std::vector<std::string> names;
+    const std::string lower = StringUtils::toLower(preset_text);
+    const size_t prefixLength = std::char_traits<char>::length(SAMPLER_PREFIX);
+    for (size_t found = lower.find(SAMPLER_PREFIX); found != std::string::npos;
+         found = lower.find(SAMPLER_PREFIX, found + prefixLength)) {
+        // Part of a longer identifier, e.g. "mysampler_x"
+        if (found > 0 && (std::isalnum(static_cast<unsigned char>(lower[found - 1])) || lower[found - 1] == '_')) {
+            continue;
+        }
+        size_t end = found + prefixLength;
+        while (end < lower.size() && (std::isalnum(static_cast<unsigned char>(lower[end])) || lower[end] == '_')) {
+            ++end;
+        }
+        std::string name = lower.substr(found + prefixLength, end - found - prefixLength);
+        // Filter and wrap mode prefixes select how the same texture is sampled
+        for (const char* mode : {"fw_", "fc_", "pw_", "pc_"}) {
+            if (name.rfind(mode, 0) == 0) {
+                name.erase(0, 3);
+                break;
+            }
+        }
+        if (!name.empty() && !isBuiltInTexture(name) && std::find(names.begin(), names.end(), name) == names.end()) {
+            names.push_back(std::move(name));
+        }
+    }
+    return names;
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief One texture as the cache index knows it
+ */
+struct TextureCacheEntry {
+    std::string source;  //!< Path relative to the texture directory
+    uintmax_t size = 0;
+    int64_t mtime = 0;
+    std::string cached;  //!< Path relative to the cache directory
+};
+
+/**
+ * @brief Mirror of the texture directory with PNG and JPEG files transcoded to BC1/BC3 DDS
+ *
+ * projectM decodes every texture a preset samples on the render thread, the first time
+ * the preset is loaded, and uploads it itself; there is no hook to hand it a decoded or
+ * already uploaded texture. What can move off that thread is the decode: worker threads
+ * transcode the textures into block-compressed DDS files once, so the switch only reads
+ * a file a quarter the size of the RGBA image and uploads it without inflating or
+ * IDCT'ing anything. Other files are copied through, so the cache can stand in for the
+ * texture directory as projectM's search path. An index keyed on size and mtime carries
+ * the work across runs; the cache is only used once it covers every texture, because
+ * projectM reloads all textures whenever its search path changes. The preset preloader
+ * also hands over each upcoming preset, whose textures are read into the OS cache
+ * before the switch.
+ */
+class TextureCache {
+public:
+    /**
+     * @brief Called once the workers finish (or stop), from the last worker thread
+     * @param transcoded Textures written this run
+     * @param failed Textures that could not be read or written
+     */
+    using CompletionCallback = std::function<void(size_t transcoded, size_t failed)>;
+
+    TextureCache() = default;
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Load the index and compare it with the texture directory
+     * @param index_path Index file written by earlier runs
+     * @return True if every texture has an up-to-date copy in the cache
+     */
+    bool open(const std::string& source_dir, const std::string& cache_dir, const std::string& index_path);
+
+    /**
+     * @brief Whether the cache covered every texture when opened
+     */
+    bool isCurrent() const {
+        return _current;
+    }
+
+    /**
+     * @brief Textures open() found missing or out of date
+     */
+    size_t getPendingCount() const {
+        return _jobs.size();
+    }
+
+    /**
+     * @brief Directory to give projectM: the cache when current, the texture directory otherwise
+     */
+    const std::string& getSearchPath() const {
+        return _current ? _cacheDir : _sourceDir;
+    }
+
+    /**
+     * @brief Transcode the pending textures on worker threads, saving the index when done
+     * @param threads Worker count (at least one)
+     */
+    void start(size_t threads, CompletionCallback done);
+
+    /**
+     * @brief Stop the workers after their current texture and wait for them
+     */
+    void stop();
+
+    /**
+     * @brief Read the textures a preset samples, as projectM will find them, into the OS cache
+     *
+     * Safe from any thread once open() has returned.
+     */
+    void prefetch(const std::string& preset_text) const;
+
+    /**
+     * @brief Write the index (atomically, through a rename)
+     */
+    bool save() const;
+
+    /**
+     * @brief Texture names sampled by a preset's shaders ("sampler_fw_clouds" -> "clouds")
+     *
+     * Lower case, in order of first use; projectM's built-in and random textures are left out.
+     */
+    static std::vector<std::string> findTextureReferences(const std::string& preset_text);
+
+    /**
+     * @brief Whether projectM would load the file as a texture, judging by its extension
+     */
+    static bool isTextureFile(const std::string& path);
+
+    /**
+     * @brief Decode a texture and write it as DDS, or copy it unchanged
+     * @param compress Write a DDS (the source must be readable by ImageDecoder)
+     * @return False with error set if the target could not be written
+     */
+    static bool transcode(const std::string& source, const std::string& target, bool compress, std::string& error);
+
+private:
+    struct Job {
+        TextureCacheEntry entry;
+        bool compress = false;
+    };
+
+    void work();
+    void finish();
+
+    std::string _sourceDir;
+    std::string _cacheDir;
+    std::string _indexPath;
+    bool _current = false;
+    std::vector<Job> _jobs;
+    std::unordered_map<std::string, std::string> _prefetchPaths;  // Lower-case name to the file projectM loads
+
+    mutable std::mutex _mutex;
+    std::map<std::string, TextureCacheEntry> _entries;  // By source path
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _nextJob{0};
+    std::atomic<size_t> _running{0};
+    std::atomic<bool> _stop{false};
+    size_t _transcoded = 0;
+    size_t _failed = 0;
+    CompletionCallback _done;
+};
+
+}  // namespace AutoVibez::Core
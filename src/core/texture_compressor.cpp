@@ -0,0 +1,225 @@
+#include "texture_compressor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+
+namespace AutoVibez::Core {
+
+namespace {
+constexpr int BLOCK_PIXELS = 16;
+
+// DDS_HEADER flags: caps, height, width, pixel format and linear size
+constexpr uint32_t DDS_HEADER_FLAGS = 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000;
+constexpr uint32_t DDS_PIXEL_FORMAT_FOURCC = 0x4;
+constexpr uint32_t DDS_CAPS_TEXTURE = 0x1000;
+
+uint32_t makeFourCc(const char* code) {
+    return static_cast<uint32_t>(code[0]) | static_cast<uint32_t>(code[1]) << 8 |
+           static_cast<uint32_t>(code[2]) << 16 | static_cast<uint32_t>(code[3]) << 24;
+}
+
+uint16_t pack565(const std::array<int, 3>& color) {
+    return static_cast<uint16_t>((color[0] >> 3) << 11 | (color[1] >> 2) << 5 | (color[2] >> 3));
+}
+
+std::array<int, 3> unpack565(uint16_t packed) {
+    const int r = packed >> 11 & 31;
+    const int g = packed >> 5 & 63;
+    const int b = packed & 31;
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+void writeLittleEndian(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void compressColor(const uint8_t* pixels, uint8_t* out) {
+    std::array<int, 3> low{255, 255, 255};
+    std::array<int, 3> high{0, 0, 0};
+    std::array<int, 3> mean{0, 0, 0};
+    for (int i = 0; i < BLOCK_PIXELS; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            low[c] = std::min<int>(low[c], pixels[i * 4 + c]);
+            high[c] = std::max<int>(high[c], pixels[i * 4 + c]);
+            mean[c] += pixels[i * 4 + c];
+        }
+    }
+
+    // The box diagonal runs along the widest channel; channels falling as it rises take the other corner
+    int axis = 0;
+    for (int c = 1; c < 3; ++c) {
+        if (high[c] - low[c] > high[axis] - low[axis]) {
+            axis = c;
+        }
+    }
+    std::array<int, 3> first = high;
+    std::array<int, 3> second = low;
+    for (int c = 0; c < 3; ++c) {
+        if (c == axis) {
+            continue;
+        }
+        long covariance = 0;
+        for (int i = 0; i < BLOCK_PIXELS; ++i) {
+            covariance += static_cast<long>(pixels[i * 4 + axis] * BLOCK_PIXELS - mean[axis]) *
+                          (pixels[i * 4 + c] * BLOCK_PIXELS - mean[c]);
+        }
+        if (covariance < 0) {
+            std::swap(first[c], second[c]);
+        }
+    }
+    // Pulling the endpoints in slightly spends the palette on the pixels rather than the outliers
+    for (int c = 0; c < 3; ++c) {
+        const int inset = (first[c] - second[c]) / 16;
+        first[c] -= inset;
+        second[c] += inset;
+    }
+
+    uint16_t color0 = pack565(first);
+    uint16_t color1 = pack565(second);
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+    writeLittleEndian(out, color0, 2);
+    writeLittleEndian(out + 2, color1, 2);
+    if (color0 == color1) {
+        writeLittleEndian(out + 4, 0, 4);
+        return;
+    }
+
+    // color0 > color1 selects the four-colour palette
+    std::array<std::array<int, 3>, 4> palette;
+    palette[0] = unpack565(color0);
+    palette[1] = unpack565(color1);
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    uint32_t indices = 0;
+    for (int i = 0; i < BLOCK_PIXELS; ++i) {
+        int best = 0;
+        int bestDistance = 1 << 30;
+        for (int p = 0; p < 4; ++p) {
+            int distance = 0;
+            for (int c = 0; c < 3; ++c) {
+                const int delta = pixels[i * 4 + c] - palette[p][c];
+                distance += delta * delta;
+            }
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = p;
+            }
+        }
+        indices |= static_cast<uint32_t>(best) << (2 * i);
+    }
+    writeLittleEndian(out + 4, indices, 4);
+}
+
+void compressAlpha(const uint8_t* pixels, uint8_t* out) {
+    int low = 255;
+    int high = 0;
+    for (int i = 0; i < BLOCK_PIXELS; ++i) {
+        low = std::min<int>(low, pixels[i * 4 + 3]);
+        high = std::max<int>(high, pixels[i * 4 + 3]);
+    }
+    out[0] = static_cast<uint8_t>(high);
+    out[1] = static_cast<uint8_t>(low);
+    if (high == low) {
+        writeLittleEndian(out + 2, 0, 6);
+        return;
+    }
+
+    // alpha0 > alpha1 selects six interpolated steps between them
+    std::array<int, 8> palette{high, low};
+    for (int step = 1; step <= 6; ++step) {
+        palette[step + 1] = ((7 - step) * high + step * low) / 7;
+    }
+    uint64_t indices = 0;
+    for (int i = 0; i < BLOCK_PIXELS; ++i) {
+        int best = 0;
+        for (int p = 1; p < 8; ++p) {
+            if (std::abs(pixels[i * 4 + 3] - palette[p]) < std::abs(pixels[i * 4 + 3] - palette[best])) {
+                best = p;
+            }
+        }
+        indices |= static_cast<uint64_t>(best) << (3 * i);
+    }
+    writeLittleEndian(out + 2, indices, 6);
+}
+}  // namespace
+
+BlockFormat TextureCompressor::chooseFormat(const std::vector<uint8_t>& rgba) {
+    for (size_t i = 3; i < rgba.size(); i += 4) {
+        if (rgba[i] != 255) {
+            return BlockFormat::Bc3;
+        }
+    }
+    return BlockFormat::Bc1;
+}
+
+size_t TextureCompressor::getCompressedSize(int width, int height, BlockFormat format) {
+    const size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+    return blocks * (format == BlockFormat::Bc1 ? 8 : 16);
+}
+
+std::vector<uint8_t> TextureCompressor::compress(const std::vector<uint8_t>& rgba, int width, int height,
+                                                 BlockFormat format) {
+    std::vector<uint8_t> blocks(getCompressedSize(width, height, format));
+    const size_t blockBytes = format == BlockFormat::Bc1 ? 8 : 16;
+    uint8_t* out = blocks.data();
+    uint8_t pixels[BLOCK_PIXELS * 4];
+    for (int blockY = 0; blockY < height; blockY += 4) {
+        for (int blockX = 0; blockX < width; blockX += 4) {
+            for (int i = 0; i < BLOCK_PIXELS; ++i) {
+                const int x = std::min(blockX + i % 4, width - 1);
+                const int y = std::min(blockY + i / 4, height - 1);
+                std::copy_n(rgba.data() + (static_cast<size_t>(y) * width + x) * 4, 4, pixels + i * 4);
+            }
+            compressBlock(pixels, format, out);
+            out += blockBytes;
+        }
+    }
+    return blocks;
+}
+
+void TextureCompressor::compressBlock(const uint8_t* pixels, BlockFormat format, uint8_t* out) {
+    if (format == BlockFormat::Bc3) {
+        compressAlpha(pixels, out);
+        out += 8;
+    }
+    compressColor(pixels, out);
+}
+
+bool TextureCompressor::writeDds(const std::string& path, BlockFormat format, int width, int height,
+                                 const std::vector<uint8_t>& blocks, std::string& error) {
+    // "DDS " then the 124-byte DDS_HEADER with its 32-byte DDS_PIXELFORMAT, all little-endian words
+    std::array<uint32_t, 32> header{};
+    header[0] = makeFourCc("DDS ");
+    header[1] = 124;
+    header[2] = DDS_HEADER_FLAGS;
+    header[3] = static_cast<uint32_t>(height);
+    header[4] = static_cast<uint32_t>(width);
+    header[5] = static_cast<uint32_t>(blocks.size());
+    header[19] = 32;
+    header[20] = DDS_PIXEL_FORMAT_FOURCC;
+    header[21] = makeFourCc(format == BlockFormat::Bc1 ? "DXT1" : "DXT5");
+    header[27] = DDS_CAPS_TEXTURE;
+
+    std::array<uint8_t, sizeof(header)> bytes;
+    for (size_t i = 0; i < header.size(); ++i) {
+        writeLittleEndian(bytes.data() + i * 4, header[i], 4);
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    file.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size()));
+    if (!file) {
+        error = "Cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace AutoVibez::Core
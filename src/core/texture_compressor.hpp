@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Core {
+
+enum class BlockFormat {
+    Bc1,  //!< DXT1: 4 bits per pixel, opaque
+    Bc3   //!< DXT5: 8 bits per pixel, BC1 colour plus an interpolated alpha block
+};
+
+/**
+ * @brief Compresses RGBA images into BC1/BC3 blocks and writes them as DDS files
+ *
+ * Each 4x4 block takes the corners of its colour bounding box as endpoints, which is
+ * fast and good enough for the soft photographs presets sample; edges are padded by
+ * repeating the last row and column. The DDS holds one level without mipmaps, so the
+ * loader builds those as it does for PNG and JPEG. Stateless and safe to call from any
+ * thread.
+ */
+class TextureCompressor {
+public:
+    /**
+     * @brief BC3 when any pixel is not fully opaque, otherwise BC1
+     */
+    static BlockFormat chooseFormat(const std::vector<uint8_t>& rgba);
+
+    /**
+     * @brief Bytes of block data for an image
+     */
+    static size_t getCompressedSize(int width, int height, BlockFormat format);
+
+    /**
+     * @brief Compress a top-down, tightly packed RGBA image
+     */
+    static std::vector<uint8_t> compress(const std::vector<uint8_t>& rgba, int width, int height,
+                                         BlockFormat format);
+
+    /**
+     * @brief Compress one block of 16 RGBA pixels (row by row) into 8 (BC1) or 16 (BC3) bytes
+     */
+    static void compressBlock(const uint8_t* pixels, BlockFormat format, uint8_t* out);
+
+    /**
+     * @brief Write block data as a DDS file
+     * @return False with error set if the file could not be written
+     */
+    static bool writeDds(const std::string& path, BlockFormat format, int width, int height,
+                         const std::vector<uint8_t>& blocks, std::string& error);
+};
+
+}  // namespace AutoVibez::Core
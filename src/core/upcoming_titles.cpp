@@ -0,0 +1,18 @@
+#include "upcoming_titles.hpp"
+
+namespace AutoVibez::Core {
+
+bool UpcomingTitles::update(uint64_t revision, const QueueReader& readQueue) {
+    if (_read && revision == _revision) {
+        return false;
+    }
+    _read = true;
+    _revision = revision;
+    _titles.clear();
+    for (const AutoVibez::Data::Mix& mix : readQueue()) {
+        _titles.push_back(mix.artist + " - " + mix.title);
+    }
+    return true;
+}
+
+}  // namespace AutoVibez::Core
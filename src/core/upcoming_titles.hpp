@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief "Artist - Title" of the queued mixes, next first, for the now-playing snapshot
+ *
+ * Published every housekeeping tick, but the queue seldom changes between two, so the
+ * mixes are only read again when the play queue revision moves.
+ */
+class UpcomingTitles {
+public:
+    using QueueReader = std::function<std::vector<AutoVibez::Data::Mix>()>;
+
+    /**
+     * @brief Read the queue through readQueue unless revision is the one last read
+     * @return True if the titles were read again
+     */
+    bool update(uint64_t revision, const QueueReader& readQueue);
+
+    const std::vector<std::string>& get() const {
+        return _titles;
+    }
+
+private:
+    std::vector<std::string> _titles;
+    uint64_t _revision = 0;
+    bool _read = false;  // The first update reads whatever the revision
+};
+
+}  // namespace AutoVibez::Core
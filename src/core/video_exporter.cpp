@@ -0,0 +1,318 @@
+#include "video_exporter.hpp"
+
+#include <SDL2/SDL.h>
+#include <projectM-4/playlist.h>
+#include <projectM-4/projectM.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include "console_output.hpp"
+#include "frame_readback.hpp"
+#include "opengl.h"
+#include "render_scaler.hpp"
+#include "setup.hpp"
+#include "synthetic_capture.hpp"
+
+namespace AutoVibez::Core {
+
+namespace {
+using AutoVibez::Utils::ConsoleOutput;
+
+std::string shellQuote(const std::string& text) {
+#ifdef _WIN32
+    return "\"" + text + "\"";
+#else
+    std::string quoted = "'";
+    for (char c : text) {
+        quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    }
+    return quoted + "'";
+#endif
+}
+
+FILE* openPipe(const std::string& command) {
+#ifdef _WIN32
+    return _popen(command.c_str(), "wb");
+#else
+    // A dead ffmpeg should fail the write, not kill the process
+    std::signal(SIGPIPE, SIG_IGN);
+    return popen(command.c_str(), "w");
+#endif
+}
+
+int closePipe(FILE* pipe) {
+#ifdef _WIN32
+    return _pclose(pipe);
+#else
+    return pclose(pipe);
+#endif
+}
+}  // namespace
+
+VideoExporter::VideoExporter(ExportOptions options) : _options(std::move(options)) {}
+
+bool VideoExporter::parseArgs(int argc, char* argv[], int first, ExportOptions& options, std::string& error) {
+    for (int i = first; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg.rfind("--", 0) == 0 && !hasValue) {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--audio") {
+            options.audio = argv[++i];
+        } else if (arg == "--preset") {
+            options.preset = argv[++i];
+        } else if (arg == "--size") {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 ||
+                options.height <= 0) {
+                error = "--size expects WIDTHxHEIGHT, e.g. 1920x1080";
+                return false;
+            }
+        } else if (arg == "--fps") {
+            options.fps = std::atoi(argv[++i]);
+            if (options.fps <= 0) {
+                error = "--fps expects a positive frame rate";
+                return false;
+            }
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(argv[++i]);
+            if (options.seconds <= 0.0) {
+                error = "--seconds expects a positive length";
+                return false;
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            error = "Unknown export option " + arg;
+            return false;
+        } else if (options.output.empty()) {
+            options.output = arg;
+        } else {
+            error = "Unexpected argument " + arg;
+            return false;
+        }
+    }
+
+    if (options.output.empty()) {
+        error = "--export needs an output file";
+        return false;
+    }
+    if (options.audio.empty()) {
+        error = "--export needs --audio with a .wav/.mp3 file or a signal (sweep, pink, kicks, sine)";
+        return false;
+    }
+    // yuv420p halves both dimensions for chroma
+    if (!isRawOutput(options.output) && (options.width % 2 != 0 || options.height % 2 != 0)) {
+        error = "Video export sizes must be even";
+        return false;
+    }
+    return true;
+}
+
+bool VideoExporter::isRawOutput(const std::string& output) {
+    const std::string extension = std::filesystem::path(output).extension().string();
+    return extension == ".rgba" || extension == ".raw";
+}
+
+std::string VideoExporter::buildFfmpegCommand(const ExportOptions& options, bool muxAudio) {
+    std::string command = "ffmpeg -hide_banner -loglevel error -y -f rawvideo -pix_fmt rgba -s " +
+                          std::to_string(options.width) + "x" + std::to_string(options.height) + " -r " +
+                          std::to_string(options.fps) + " -i -";
+    if (muxAudio) {
+        command += " -i " + shellQuote(options.audio) + " -map 0:v -map 1:a -c:a aac -shortest";
+    }
+    return command + " -c:v libx264 -pix_fmt yuv420p " + shellQuote(options.output);
+}
+
+int64_t VideoExporter::getSampleEnd(int64_t frame, int sampleRate, int fps) {
+    return (frame + 1) * sampleRate / fps;
+}
+
+bool VideoExporter::run(const std::string& presetPath, const std::string& texturePath) {
+    std::string error;
+    auto source = AutoVibez::Audio::SyntheticCapture::createSource(_options.audio, Constants::DEFAULT_SAMPLE_RATE,
+                                                                    error);
+    if (!source) {
+        setError(error);
+        return false;
+    }
+    const int sampleRate = source->getSampleRate();
+    double seconds = _options.seconds;
+    if (seconds <= 0.0) {
+        const int64_t length = source->getLengthFrames();
+        seconds = length > 0 ? static_cast<double>(length) / sampleRate : Constants::EXPORT_DEFAULT_SECONDS;
+    }
+    const int64_t totalFrames = std::max<int64_t>(1, std::llround(seconds * _options.fps));
+
+    // A hidden window only provides the context; nothing is presented
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        setError("Failed to initialize SDL video: " + std::string(SDL_GetError()));
+        return false;
+    }
+    initGL();
+    SDL_Window* window = SDL_CreateWindow("AutoVibez export", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          _options.width, _options.height, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+    if (!context) {
+        setError("Failed to create an OpenGL context: " + std::string(SDL_GetError()));
+        if (window) {
+            SDL_DestroyWindow(window);
+        }
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
+        return false;
+    }
+    SDL_GL_MakeCurrent(window, context);
+    SDL_GL_SetSwapInterval(0);
+#if defined(_WIN32)
+    glewInit();
+#endif
+
+    projectm_handle projectM = projectm_create();
+    bool ok = projectM != nullptr;
+    if (!ok) {
+        setError("Failed to create projectM");
+    }
+    projectm_playlist_handle playlist = nullptr;
+    if (ok) {
+        projectm_set_window_size(projectM, _options.width, _options.height);
+        projectm_set_mesh_size(projectM, _options.mesh_x, _options.mesh_y);
+        projectm_set_fps(projectM, _options.fps);
+        projectm_set_preset_duration(projectM, _options.preset_duration);
+        const char* texturePaths[] = {texturePath.c_str()};
+        projectm_set_texture_search_paths(projectM, texturePaths, 1);
+        if (!_options.preset.empty()) {
+            projectm_load_preset_file(projectM, _options.preset.c_str(), false);
+        } else {
+            playlist = projectm_playlist_create(projectM);
+            projectm_playlist_add_path(playlist, presetPath.c_str(), true, false);
+            projectm_playlist_set_shuffle(playlist, true);
+            projectm_playlist_play_next(playlist, true);
+        }
+    }
+
+    // Render offscreen at the export size; projectM before 4.1 can only draw to the window
+    std::unique_ptr<RenderScaler> target;
+#ifdef HAVE_PROJECTM_RENDER_FBO
+    target = RenderScaler::create();
+    if (target && !target->setSize(_options.width, _options.height)) {
+        target.reset();
+    }
+#endif
+    if (ok && !target) {
+        ConsoleOutput::warning("No offscreen render target (needs projectM 4.1 and framebuffer objects); "
+                               "reading back the hidden window, which some drivers leave undefined");
+    }
+#ifndef HAVE_PROJECTM_FRAME_TIME
+    ConsoleOutput::warning("projectM before 4.1 animates on the wall clock, so motion runs fast in the export");
+#endif
+
+    const bool raw = isRawOutput(_options.output);
+    const bool muxAudio = !raw && std::filesystem::is_regular_file(_options.audio);
+    if (!raw && !muxAudio) {
+        ConsoleOutput::warning("Generated signals are not muxed: the video has no audio track");
+    }
+    FILE* sink = nullptr;
+    if (ok) {
+        sink = raw ? std::fopen(_options.output.c_str(), "wb") : openPipe(buildFfmpegCommand(_options, muxAudio));
+        if (!sink) {
+            setError(raw ? "Cannot write " + _options.output : "Cannot start ffmpeg (is it installed?)");
+            ok = false;
+        }
+    }
+
+    auto readback = FrameReadback::create(_options.width, _options.height, Constants::EXPORT_READBACK_BUFFERS);
+    std::vector<int16_t> pcm;
+    std::vector<uint8_t> image;
+    auto writeFrame = [&]() {
+        if (std::fwrite(image.data(), 1, image.size(), sink) != image.size()) {
+            setError(raw ? "Failed writing " + _options.output : "ffmpeg stopped accepting frames");
+            return false;
+        }
+        return true;
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    const int64_t progressFrames = static_cast<int64_t>(Constants::EXPORT_PROGRESS_SECONDS) * _options.fps;
+    int64_t samplesFed = 0;
+    for (int64_t frame = 0; ok && frame < totalFrames; ++frame) {
+        // Exactly the audio that plays during this frame; silence once the source runs out
+        const int64_t sampleEnd = getSampleEnd(frame, sampleRate, _options.fps);
+        const int count = static_cast<int>(sampleEnd - samplesFed);
+        samplesFed = sampleEnd;
+        pcm.assign(static_cast<size_t>(count) * 2, 0);
+        source->read(pcm.data(), count);
+        if (count > 0) {
+            projectm_pcm_add_int16(projectM, pcm.data(), static_cast<unsigned int>(count), PROJECTM_STEREO);
+        }
+
+#ifdef HAVE_PROJECTM_FRAME_TIME
+        projectm_set_frame_time(projectM, static_cast<double>(frame) / _options.fps);
+#endif
+#ifdef HAVE_PROJECTM_RENDER_FBO
+        if (target) {
+            target->bind();
+            projectm_opengl_render_frame_fbo(projectM, target->getFramebuffer());
+            target->bind();  // As the read framebuffer
+        } else
+#endif
+        {
+            glViewport(0, 0, _options.width, _options.height);
+            projectm_opengl_render_frame(projectM);
+        }
+
+        if (readback->push(image)) {
+            ok = writeFrame();
+        }
+        if ((frame + 1) % progressFrames == 0) {
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            const double rendered = static_cast<double>(frame + 1) / _options.fps;
+            char line[96];
+            std::snprintf(line, sizeof(line), "Rendered %.0f s of %.0f s (%.1fx real time)", rendered, seconds,
+                          elapsed > 0.0 ? rendered / elapsed : 0.0);
+            ConsoleOutput::info(line);
+        }
+    }
+    while (ok && readback->pop(image)) {
+        ok = writeFrame();
+    }
+
+    if (sink) {
+        const int status = raw ? std::fclose(sink) : closePipe(sink);
+        if (ok && status != 0) {
+            setError(raw ? "Failed closing " + _options.output : "ffmpeg failed (exit status " +
+                                                                     std::to_string(status) + ")");
+            ok = false;
+        }
+    }
+    if (ok) {
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        char line[64];
+        std::snprintf(line, sizeof(line), " in %.1f s (%.1fx real time)", elapsed,
+                      elapsed > 0.0 ? seconds / elapsed : 0.0);
+        ConsoleOutput::success("Exported " + std::to_string(totalFrames) + " frames to " + _options.output + line);
+        if (raw) {
+            ConsoleOutput::info("Raw RGBA " + std::to_string(_options.width) + "x" + std::to_string(_options.height) +
+                                " at " + std::to_string(_options.fps) + " fps, top row first");
+        }
+    }
+
+    if (playlist) {
+        projectm_playlist_destroy(playlist);
+    }
+    if (projectM) {
+        projectm_destroy(projectM);
+    }
+    SDL_GL_DeleteContext(context);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+    return ok;
+}
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Core {
+
+/**
+ * @brief What autovibez --export renders
+ */
+struct ExportOptions {
+    std::string output;  //!< Video file for ffmpeg, or a .rgba/.raw file of bare frames
+    std::string audio;   //!< .wav/.mp3 path or a generated signal (sweep, pink, kicks, sine)
+    std::string preset;  //!< One preset file to render; empty shuffles the preset directory
+    int width = Constants::EXPORT_DEFAULT_WIDTH;
+    int height = Constants::EXPORT_DEFAULT_HEIGHT;
+    int fps = Constants::EXPORT_DEFAULT_FPS;
+    double seconds = 0.0;  //!< 0 = the length of the audio
+    int mesh_x = Constants::DEFAULT_MESH_X;
+    int mesh_y = Constants::DEFAULT_MESH_Y;
+    double preset_duration = Constants::DEFAULT_PRESET_DURATION;
+};
+
+/**
+ * @brief Renders projectM offline, as fast as the GPU allows, into a video
+ *
+ * A hidden window supplies the GL context; projectM draws into an offscreen target at
+ * the export size, so the window never needs to be shown or vsynced. Each frame is fed
+ * exactly the audio samples that fall within it and, with projectM 4.1, is stamped with
+ * its video time, so the output is independent of how fast frames are rendered. Frames
+ * come back through a FrameReadback ring and are streamed either into an ffmpeg pipe,
+ * which also muxes the audio file, or into a file of raw RGBA frames.
+ */
+class VideoExporter : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    explicit VideoExporter(ExportOptions options);
+
+    /**
+     * @brief Parse the arguments following --export
+     * @param first Index of the first argument after --export
+     * @return False with error set when the arguments are incomplete or malformed
+     */
+    static bool parseArgs(int argc, char* argv[], int first, ExportOptions& options, std::string& error);
+
+    /**
+     * @brief Whether frames go to a raw file instead of ffmpeg
+     */
+    static bool isRawOutput(const std::string& output);
+
+    /**
+     * @brief ffmpeg command line reading RGBA frames on stdin
+     * @param muxAudio Add the audio file as a second input
+     */
+    static std::string buildFfmpegCommand(const ExportOptions& options, bool muxAudio);
+
+    /**
+     * @brief Audio frames that play before the end of a video frame
+     */
+    static int64_t getSampleEnd(int64_t frame, int sampleRate, int fps);
+
+    /**
+     * @brief Render the whole export
+     * @return True if every frame was written
+     */
+    bool run(const std::string& presetPath, const std::string& texturePath);
+
+private:
+    ExportOptions _options;
+};
+
+}  // namespace AutoVibez::Core
@@ -0,0 +1,159 @@
+#include "app_config.hpp"
+
+#include <system_error>
+#include <utility>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Data {
+
+std::shared_ptr<const AppConfig> AppConfig::parse(std::shared_ptr<const ConfigFile> file, const std::string& path) {
+    auto config = std::make_shared<AppConfig>();
+    const ConfigFile& in = *file;
+    config->path = path;
+    config->file = std::move(file);
+
+    config->preset_path = in.getPresetPath();
+    config->texture_path = in.getTexturePath();
+    config->audio_device = in.getAudioDeviceIndex();
+    config->show_fps = in.getShowFps();
+    config->mesh_x = in.read<int>(StringConstants::MESH_X_KEY, Constants::DEFAULT_MESH_X);
+    config->mesh_y = in.read<int>(StringConstants::MESH_Y_KEY, Constants::DEFAULT_MESH_Y);
+    config->window_width = in.read<int>(StringConstants::WINDOW_WIDTH_KEY, Constants::DEFAULT_WINDOW_SIZE);
+    config->window_height = in.read<int>(StringConstants::WINDOW_HEIGHT_KEY, Constants::DEFAULT_WINDOW_SIZE);
+    config->fullscreen = in.read<bool>("fullscreen", false);
+    config->fps = in.read<double>(StringConstants::FPS_KEY, Constants::DEFAULT_FPS_VALUE);
+    config->aspect_correction = in.read<bool>("Aspect Correction", true);
+    config->easter_egg = in.read<float>("Easter Egg Parameter", 0.0f);
+
+    config->soft_cut_duration = in.read<double>("Smooth Preset Duration", 3);
+    config->preset_duration = in.read<double>(StringConstants::PRESET_DURATION_KEY, Constants::DEFAULT_PRESET_DURATION);
+    config->hard_cuts_enabled = in.read<bool>("hard_cuts_enabled", false);
+    config->hard_cut_duration =
+        in.read<double>(StringConstants::HARD_CUT_DURATION_KEY, Constants::DEFAULT_HARD_CUT_DURATION);
+    config->hard_cut_sensitivity = in.read<float>("hard_cut_sensitivity", 1.0f);
+    config->beat_sensitivity = in.read<float>("beat_sensitivity", 1.0f);
+    config->beat_synced_presets = in.getBeatSyncedPresets();
+    config->preset_cut_bars = in.getPresetCutBars();
+
+    config->internal_audio = in.getInternalAudio();
+    config->downmix_weights = in.getDownmixWeights();
+    config->native_monitor = in.getNativeMonitor();
+    config->native_sample_rate = in.getNativeSampleRate();
+    config->adaptive_capture_period = in.getAdaptiveCapturePeriod();
+    config->capture_period_frames = in.getCapturePeriodFrames();
+    config->latency_compensation = in.getLatencyCompensation();
+    config->display_queue_frames = in.getDisplayQueueFrames();
+    config->av_offset_ms = in.getAvOffsetMs();
+    config->synthetic_audio = in.getSyntheticAudio();
+    config->synthetic_audio_speed = in.getSyntheticAudioSpeed();
+
+    config->frame_pacing = in.getFramePacing();
+    config->render_thread = in.getRenderThread();
+    config->overlay_renderer = in.getOverlayRenderer();
+    config->power_saving = in.getPowerSaving();
+    config->power_saving_fps = in.getPowerSavingFps();
+    config->power_saving_unfocused = in.getPowerSavingUnfocused();
+    config->event_driven_loop = in.getEventDrivenLoop();
+    config->profile_preset_cost = in.getProfilePresetCost();
+    config->skip_slow_presets = in.getSkipSlowPresets();
+    config->preset_scheduling = in.getPresetScheduling();
+    config->render_scale = in.getRenderScale();
+    config->dynamic_render_scale = in.getDynamicRenderScale();
+    config->min_render_scale = in.getMinRenderScale();
+    config->quality_governor = in.getQualityGovernor();
+    config->quality_profile = in.getQualityProfile();
+    config->multi_output = in.getMultiOutput();
+    config->multi_output_bezel = in.getMultiOutputBezel();
+    config->multi_output_width = in.getMultiOutputWidth();
+    config->screenshot_format = in.getScreenshotFormat();
+    config->screenshot_jpeg_quality = in.getScreenshotJpegQuality();
+    config->texture_cache = in.getTextureCache();
+
+    config->mixes_url = in.getMixesUrl();
+    config->preferred_genre = in.getPreferredGenre();
+    config->auto_download = in.getAutoDownload();
+    config->stream_while_downloading = in.getStreamWhileDownloading();
+    config->stream_start_kb = in.getStreamStartKb();
+    config->playing_download_limit_kb = in.getPlayingDownloadLimitKb();
+    config->mix_cache_quota_gb = in.getMixCacheQuotaGb();
+    config->peer_cache = in.getPeerCache();
+    config->download_stats = in.getDownloadStats();
+    config->play_queue_depth = in.getPlayQueueDepth();
+    config->similar_mix_probability = in.getSimilarMixProbability();
+    config->loudness_normalization = in.getLoudnessNormalization();
+    config->loudness_target_lufs = in.getLoudnessTargetLufs();
+    config->decoder_backend = in.getDecoderBackend();
+    config->transcode_cache = in.getTranscodeCache();
+    config->transcode_bitrate_kbps = in.getTranscodeBitrateKbps();
+    config->seek_increment = in.getSeekIncrement();
+    config->mix_database_profile = in.getMixDatabaseProfile();
+    config->mix_database_query_stats = in.getMixDatabaseQueryStats();
+    config->mix_database_log_plans = in.getMixDatabaseLogPlans();
+    config->shared_catalog = in.getSharedCatalog();
+    config->resume_playback = in.getResumePlayback();
+    config->mix_sync_url = in.getMixSyncUrl();
+    config->mix_sync_interval_seconds = in.getMixSyncIntervalSeconds();
+    config->metrics_statsd = in.getMetricsStatsd();
+    config->metrics_textfile = in.getMetricsTextfile();
+    config->remote_control_port = in.getRemoteControlPort();
+    config->remote_control_token = in.getRemoteControlToken();
+    config->sync_role = in.getSyncRole();
+
+    config->config_hot_reload = in.getConfigHotReload();
+    return config;
+}
+
+std::shared_ptr<const AppConfig> AppConfig::load(const std::string& path) {
+    std::error_code error;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return nullptr;
+    }
+    std::shared_ptr<const ConfigFile> file;
+    try {
+        file = std::make_shared<const ConfigFile>(path);
+    } catch (const ConfigFile::file_not_found&) {
+        return nullptr;
+    }
+    auto config = std::const_pointer_cast<AppConfig>(parse(std::move(file), path));
+    config->modified = modified;
+    return config;
+}
+
+AppConfigWatcher::AppConfigWatcher(std::shared_ptr<const AppConfig> initial)
+    : current_(std::move(initial)), path_(current_ ? current_->path : ""),
+      published_(current_ ? current_->modified : std::filesystem::file_time_type{}), seen_(published_) {}
+
+std::shared_ptr<const AppConfig> AppConfigWatcher::current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+bool AppConfigWatcher::poll() {
+    if (path_.empty()) {
+        return false;
+    }
+    std::error_code error;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path_, error);
+    if (error || modified == published_) {
+        seen_ = published_;
+        return false;
+    }
+    // Wait a poll for the writer to finish
+    if (modified != seen_) {
+        seen_ = modified;
+        return false;
+    }
+
+    std::shared_ptr<const AppConfig> config = AppConfig::load(path_);
+    if (!config) {
+        return false;
+    }
+    published_ = config->modified;
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_ = std::move(config);
+    return true;
+}
+
+}  // namespace AutoVibez::Data
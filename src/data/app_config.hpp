@@ -0,0 +1,167 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "config_manager.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Every setting the app reads, parsed once from the config file into typed fields
+ *
+ * Immutable once built and handed around by shared_ptr, so any thread can keep one and
+ * read it without a lock or another string conversion. A reload builds a new snapshot
+ * instead of changing this one. The few keys whose names are only known at run time
+ * (the per-profile quality floors) are read from file, parsed alongside.
+ */
+struct AppConfig {
+    std::string path;
+    std::filesystem::file_time_type modified{};
+    std::shared_ptr<const ConfigFile> file;
+
+    // Assets and window
+    std::string preset_path;
+    std::string texture_path;
+    int audio_device = 0;
+    bool show_fps = false;
+    int mesh_x = 0;
+    int mesh_y = 0;
+    int window_width = 0;
+    int window_height = 0;
+    bool fullscreen = false;
+    double fps = 0.0;  // Kept fractional for the fixed frame pacer; projectM takes it truncated
+    bool aspect_correction = true;
+    float easter_egg = 0.0f;
+
+    // Preset timing
+    double soft_cut_duration = 0.0;
+    double preset_duration = 0.0;
+    bool hard_cuts_enabled = false;
+    double hard_cut_duration = 0.0;
+    float hard_cut_sensitivity = 0.0f;
+    float beat_sensitivity = 0.0f;
+    bool beat_synced_presets = true;
+    int preset_cut_bars = 0;
+
+    // Audio
+    bool internal_audio = true;
+    std::string downmix_weights;
+    bool native_monitor = true;
+    bool native_sample_rate = true;
+    bool adaptive_capture_period = true;
+    int capture_period_frames = 0;
+    bool latency_compensation = true;
+    int display_queue_frames = 0;
+    double av_offset_ms = 0.0;
+    std::string synthetic_audio;
+    double synthetic_audio_speed = 0.0;
+
+    // Rendering
+    std::string frame_pacing;
+    std::string render_thread;
+    std::string overlay_renderer;
+    std::string power_saving;
+    double power_saving_fps = 0.0;
+    bool power_saving_unfocused = false;
+    bool event_driven_loop = false;
+    bool profile_preset_cost = true;
+    bool skip_slow_presets = true;
+    bool preset_scheduling = true;
+    double render_scale = 0.0;
+    bool dynamic_render_scale = false;
+    double min_render_scale = 0.0;
+    bool quality_governor = false;
+    std::string quality_profile;
+    std::string multi_output;
+    int multi_output_bezel = 0;
+    int multi_output_width = 0;
+    std::string screenshot_format;
+    int screenshot_jpeg_quality = 0;
+    bool texture_cache = true;
+
+    // Mixes
+    std::string mixes_url;
+    std::string preferred_genre;
+    bool auto_download = true;
+    bool stream_while_downloading = true;
+    int stream_start_kb = 0;
+    int playing_download_limit_kb = 0;
+    int mix_cache_quota_gb = 0;
+    bool peer_cache = false;
+    bool download_stats = false;
+    int play_queue_depth = 0;
+    int similar_mix_probability = 0;
+    bool loudness_normalization = true;
+    double loudness_target_lufs = 0.0;
+    std::string decoder_backend;
+    bool transcode_cache = false;
+    int transcode_bitrate_kbps = 0;
+    int seek_increment = 0;
+    std::string mix_database_profile;
+    bool mix_database_query_stats = false;
+    bool mix_database_log_plans = false;
+    bool shared_catalog = false;
+    bool resume_playback = true;
+    std::string mix_sync_url;
+    int mix_sync_interval_seconds = 0;
+
+    // Monitoring
+    std::string metrics_statsd;
+    std::string metrics_textfile;
+
+    // Remote control
+    int remote_control_port = 0;
+    std::string remote_control_token;
+
+    // Multi-node sync
+    std::string sync_role;
+
+    bool config_hot_reload = false;
+
+    /**
+     * @brief Snapshot of a parsed file; missing keys take ConfigFile's defaults
+     */
+    static std::shared_ptr<const AppConfig> parse(std::shared_ptr<const ConfigFile> file, const std::string& path = "");
+
+    /**
+     * @brief Read and parse a config file
+     * @return Null if the file cannot be read
+     */
+    static std::shared_ptr<const AppConfig> load(const std::string& path);
+};
+
+/**
+ * @brief Current AppConfig, replaced by a new snapshot when the file on disk changes
+ *
+ * poll() compares the file's modification time and does nothing else while it is
+ * unchanged, so it is cheap to call from a periodic tick. A changed file is parsed only
+ * once its time has held still for one poll, so a save in progress is not read half
+ * written. Readers call current() from any thread and keep the snapshot they got.
+ */
+class AppConfigWatcher {
+public:
+    explicit AppConfigWatcher(std::shared_ptr<const AppConfig> initial);
+
+    /**
+     * @brief Latest published snapshot
+     */
+    std::shared_ptr<const AppConfig> current() const;
+
+    /**
+     * @brief Re-read the file if it changed
+     * @return True if a new snapshot was published
+     */
+    bool poll();
+
+private:
+    mutable std::mutex mutex_;  // Guards current_ only; poll() runs on one thread
+    std::shared_ptr<const AppConfig> current_;
+    std::string path_;
+    std::filesystem::file_time_type published_{};  // Time of the file current_ was parsed from
+    std::filesystem::file_time_type seen_{};       // Time found by the last poll, for the settle check
+};
+
+}  // namespace AutoVibez::Data
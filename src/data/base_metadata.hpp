@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -22,8 +23,8 @@ struct BaseMetadata {
     std::string description;        ///< Track description
     std::string local_path;         ///< Local file path
     int duration_seconds;           ///< Track duration in seconds
-    std::string date_added;         ///< Date when added to library
-    std::string last_played;        ///< Date when last played
+    int64_t date_added_ms;          ///< When added to library, Unix epoch ms (0 if unknown)
+    int64_t last_played_ms;         ///< When last played, Unix epoch ms (0 if never)
     int play_count;                 ///< Number of times played
     bool is_favorite;               ///< Whether track is marked as favorite
     bool is_deleted;                ///< Whether track is soft deleted
@@ -31,7 +32,13 @@ struct BaseMetadata {
     /**
      * @brief Default constructor initializes all fields
      */
-    BaseMetadata() : duration_seconds(0), play_count(0), is_favorite(false), is_deleted(false) {}
+    BaseMetadata()
+        : duration_seconds(0),
+          date_added_ms(0),
+          last_played_ms(0),
+          play_count(0),
+          is_favorite(false),
+          is_deleted(false) {}
 
     /**
      * @brief Virtual destructor for proper inheritance
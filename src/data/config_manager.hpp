@@ -123,7 +123,124 @@ public:
         return read<int>("audio_device", 0);
     }
     bool getShowFps() const {
-        return read<bool>("show_fps", false);
+        return read<bool>("show_fps", false);  // Performance HUD visible at startup
+    }
+    std::string getDownmixWeights() const {
+        return read<std::string>("downmix_weights", "");  // Per-channel "left:right" pairs; empty uses defaults
+    }
+    bool getInternalAudio() const {
+        return read<bool>("internal_audio", true);  // Visualize mix playback without a capture device
+    }
+    bool getNativeMonitor() const {
+        return read<bool>("native_monitor", true);  // Linux: capture the default sink monitor via PipeWire/PulseAudio
+    }
+    bool getNativeSampleRate() const {
+        return read<bool>("native_sample_rate", true);  // Capture and play at the devices' own rate
+    }
+    bool getAdaptiveCapturePeriod() const {
+        return read<bool>("adaptive_capture_period", true);  // Shrink/grow the capture period with callback jitter
+    }
+    int getCapturePeriodFrames() const {
+        return read<int>("capture_period_frames", 512);  // Starting (or fixed) SDL capture period
+    }
+    bool getLatencyCompensation() const {
+        return read<bool>("latency_compensation", true);  // Delay playback / lead beat cuts by the measured A/V lag
+    }
+    int getDisplayQueueFrames() const {
+        return read<int>("display_queue_frames", 2);  // Frames between swap and scanout under vsync
+    }
+    std::string getFramePacing() const {
+        return read<std::string>("frame_pacing", "vsync");  // vsync, fixed (FPS with spin-sleep) or uncapped
+    }
+    std::string getRenderThread() const {
+        return read<std::string>("render_thread", "auto");  // auto (on for Windows), on or off
+    }
+    std::string getOverlayRenderer() const {
+        return read<std::string>("overlay_renderer", "gl3");  // gl3 (retained, falls back to gl2) or gl2
+    }
+    std::string getPowerSaving() const {
+        return read<std::string>("power_saving", "pause");  // off, throttle or pause while minimized/hidden
+    }
+    double getPowerSavingFps() const {
+        return read<double>("power_saving_fps", 10.0);  // Render rate while throttled
+    }
+    bool getPowerSavingUnfocused() const {
+        return read<bool>("power_saving_unfocused", false);  // Also throttle while another app has focus
+    }
+    bool getEventDrivenLoop() const {
+        return read<bool>("event_driven_loop", false);  // Mix housekeeping sleeps until there is work
+    }
+    double getAvOffsetMs() const {
+        return read<double>("av_offset_ms", 0.0);  // Manual correction found with the calibration pattern
+    }
+    bool getLoudnessNormalization() const {
+        return read<bool>("loudness_normalization", true);  // Level mixes using their ingest loudness analysis
+    }
+    double getLoudnessTargetLufs() const {
+        return read<double>("loudness_target_lufs", -14.0);  // Integrated loudness normalized mixes play at
+    }
+    std::string getDecoderBackend() const {
+        return read<std::string>("decoder_backend", "auto");  // auto or a libmpg123 decoder name, e.g. NEON64
+    }
+    bool getTranscodeCache() const {
+        return read<bool>("transcode_cache", false);  // Keep and play an Opus copy of each downloaded mix
+    }
+    int getTranscodeBitrateKbps() const {
+        return read<int>("transcode_bitrate_kbps", 96);  // Opus copy bitrate, 32 to 256
+    }
+    std::string getSyntheticAudio() const {
+        return read<std::string>("synthetic_audio", "");  // Benchmark input: sweep, pink, kicks, sine or a file path
+    }
+    double getSyntheticAudioSpeed() const {
+        return read<double>("synthetic_audio_speed", 1.0);  // Replay rate as a multiple of real time (0 = unpaced)
+    }
+    bool getBeatSyncedPresets() const {
+        return read<bool>("beat_synced_presets", true);  // Cut presets on tracked downbeats
+    }
+    int getPresetCutBars() const {
+        return read<int>("preset_cut_bars", 8);  // Bars between beat-synced preset cuts
+    }
+    bool getProfilePresetCost() const {
+        return read<bool>("profile_preset_cost", true);  // Record per-preset render timings (--preset-report)
+    }
+    bool getSkipSlowPresets() const {
+        return read<bool>("skip_slow_presets", true);  // Leave presets slower than the frame budget out of rotation
+    }
+    bool getPresetScheduling() const {
+        return read<bool>("preset_scheduling", true);  // Match preset cost to the music's energy and frame headroom
+    }
+    double getRenderScale() const {
+        return read<double>("render_scale", 1.0);  // Fraction of the window size projectM renders at
+    }
+    bool getDynamicRenderScale() const {
+        return read<bool>("dynamic_render_scale", false);  // Lower the render scale when frames run over budget
+    }
+    double getMinRenderScale() const {
+        return read<double>("min_render_scale", 0.5);  // Floor for the dynamic render scale
+    }
+    bool getQualityGovernor() const {
+        return read<bool>("quality_governor", false);  // Trade mesh, fps and render scale for a steady frame time
+    }
+    std::string getQualityProfile() const {
+        return read<std::string>("quality_profile", "auto");  // low, medium, high or auto (from the GPU name)
+    }
+    std::string getMultiOutput() const {
+        return read<std::string>("multi_output", "off");  // off, all or display indices such as 0,1,2
+    }
+    int getMultiOutputBezel() const {
+        return read<int>("multi_output_bezel", 0);  // Desktop pixels hidden between neighbouring displays
+    }
+    int getMultiOutputWidth() const {
+        return read<int>("multi_output_width", 0);  // Content frame width (0 = the widest display)
+    }
+    std::string getScreenshotFormat() const {
+        return read<std::string>("screenshot_format", "png");  // png or jpeg
+    }
+    int getScreenshotJpegQuality() const {
+        return read<int>("screenshot_jpeg_quality", 90);  // 1-100
+    }
+    bool getTextureCache() const {
+        return read<bool>("texture_cache", true);  // Load preset textures from a transcoded copy
     }
 
     // Mix Management Settings
@@ -136,6 +253,66 @@ public:
     bool getAutoDownload() const {
         return read<bool>("auto_download", true);
     }
+    bool getStreamWhileDownloading() const {
+        return read<bool>("stream_while_downloading", true);  // Start new mixes before the download finishes
+    }
+    int getStreamStartKb() const {
+        return read<int>("stream_start_kb", 512);  // KB buffered before streamed playback starts
+    }
+    int getPlayingDownloadLimitKb() const {
+        return read<int>("playing_download_limit_kb", 1024);  // KB/s for background downloads during playback
+    }
+    int getMixCacheQuotaGb() const {
+        return read<int>("mix_cache_quota_gb", 0);  // Disk space for downloaded mixes, 0 keeps every one
+    }
+    bool getPeerCache() const {
+        return read<bool>("peer_cache", false);  // Share downloaded mixes with other nodes on the LAN
+    }
+    bool getDownloadStats() const {
+        return read<bool>("download_stats", false);  // Per-host download totals, dumped on exit
+    }
+    int getPlayQueueDepth() const {
+        return read<int>("play_queue_depth", 5);  // Upcoming mixes picked and downloaded ahead, 0 disables
+    }
+    int getSimilarMixProbability() const {
+        return read<int>("similar_mix_probability", 50);  // Percentage of picks close to the previous mix
+    }
+    std::string getMixDatabaseProfile() const {
+        return read<std::string>("mix_database_profile", "fast");  // fast (WAL, relaxed sync) or safe
+    }
+    bool getMixDatabaseQueryStats() const {
+        return read<bool>("mix_database_query_stats", false);  // Time each query, dump on exit
+    }
+    bool getMixDatabaseLogPlans() const {
+        return read<bool>("mix_database_log_plans", false);  // Log each query's plan once, flag full scans
+    }
+    bool getSharedCatalog() const {
+        return read<bool>("shared_catalog", false);  // Map one library catalog across the instances on a host
+    }
+    bool getResumePlayback() const {
+        return read<bool>("resume_playback", true);  // Carry on with the mix and queue playing at the last exit
+    }
+    std::string getMixSyncUrl() const {
+        return read<std::string>("mix_sync_url", "");  // Server play stats and favorites are synced with
+    }
+    int getMixSyncIntervalSeconds() const {
+        return read<int>("mix_sync_interval_seconds", 300);  // Between exchanges; failures back off to an hour
+    }
+    std::string getMetricsStatsd() const {
+        return read<std::string>("metrics_statsd", "");  // host:port to push metrics to as StatsD
+    }
+    std::string getMetricsTextfile() const {
+        return read<std::string>("metrics_textfile", "");  // Prometheus text file kept current for a collector
+    }
+    int getRemoteControlPort() const {
+        return read<int>("remote_control_port", 0);  // 0 = no remote control
+    }
+    std::string getRemoteControlToken() const {
+        return read<std::string>("remote_control_token", "");  // Bearer token every request must carry
+    }
+    std::string getSyncRole() const {
+        return read<std::string>("sync_role", "off");  // off, leader or follower
+    }
     int getSeekIncrement() const {
         return read<int>("seek_increment", 60);  // 60 seconds default
     }
@@ -156,6 +333,9 @@ public:
     std::string getFontPath() const {
         return read<std::string>("font_path", "");
     }
+    bool getConfigHotReload() const {
+        return read<bool>("config_hot_reload", false);  // Apply edits to this file without a restart
+    }
 
 protected:
     template <class T>
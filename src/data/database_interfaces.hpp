@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace AutoVibez::Data {
@@ -27,6 +29,20 @@ public:
      */
     virtual void bindInt(int index, int value) = 0;
 
+    /**
+     * @brief Bind 64-bit integer parameter to statement
+     * @param index Parameter index (1-based)
+     * @param value Integer value to bind
+     */
+    virtual void bindInt64(int index, int64_t value) = 0;
+
+    /**
+     * @brief Bind floating-point parameter to statement
+     * @param index Parameter index (1-based)
+     * @param value Double value to bind
+     */
+    virtual void bindDouble(int index, double value) = 0;
+
     /**
      * @brief Execute the statement
      * @return True if successful, false otherwise
@@ -53,6 +69,27 @@ public:
      */
     virtual std::string getText(const std::string& columnName) const = 0;
 
+    /**
+     * @brief Get text from current row without copying it
+     * @param column Column index (0-based)
+     * @return View of the statement's buffer, valid until the next step; empty if null
+     */
+    virtual std::string_view getTextView(int column) const = 0;
+
+    /**
+     * @brief Get a BLOB from current row without copying it
+     * @param column Column index (0-based)
+     * @return View of the statement's buffer, valid until the next step; empty unless the value is a BLOB
+     */
+    virtual std::string_view getBlobView(int column) const = 0;
+
+    /**
+     * @brief Find a result column, so rows can be read by index
+     * @param columnName Column name
+     * @return Column index (0-based) or -1 if there is no such column
+     */
+    virtual int getColumnIndex(const std::string& columnName) const = 0;
+
     /**
      * @brief Get integer from current row by column index
      * @param column Column index (0-based)
@@ -67,6 +104,27 @@ public:
      */
     virtual int getInt(const std::string& columnName) const = 0;
 
+    /**
+     * @brief Get 64-bit integer from current row by column index
+     * @param column Column index (0-based)
+     * @return Integer value or 0 if null
+     */
+    virtual int64_t getInt64(int column) const = 0;
+
+    /**
+     * @brief Get floating-point value from current row by column index
+     * @param column Column index (0-based)
+     * @return Double value or 0.0 if null
+     */
+    virtual double getDouble(int column) const = 0;
+
+    /**
+     * @brief Get floating-point value from current row by column name
+     * @param columnName Column name
+     * @return Double value or 0.0 if null
+     */
+    virtual double getDouble(const std::string& columnName) const = 0;
+
     /**
      * @brief Check if column value is null by column index
      * @param column Column index (0-based)
@@ -86,6 +144,11 @@ public:
      * @return Number of affected rows
      */
     virtual int getChanges() const = 0;
+
+    /**
+     * @brief Make the statement ready to execute again; bindings are kept until rebound
+     */
+    virtual void reset() = 0;
 };
 
 /**
@@ -0,0 +1,55 @@
+#include "download_backoff.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Data {
+
+DownloadBackoff::DownloadBackoff() : random_(std::random_device{}()) {}
+
+void DownloadBackoff::load(const std::vector<DownloadFailure>& failures) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failures_.clear();
+    for (const DownloadFailure& failure : failures) {
+        failures_[failure.mix_id] = failure;
+    }
+}
+
+bool DownloadBackoff::mayAttempt(const std::string& mix_id, int64_t now_ms) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = failures_.find(mix_id);
+    return it == failures_.end() || now_ms >= it->second.retry_after_ms;
+}
+
+DownloadFailure DownloadBackoff::recordFailure(const std::string& mix_id, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DownloadFailure& failure = failures_[mix_id];
+    failure.mix_id = mix_id;
+    failure.failures++;
+    const double jitter = std::uniform_real_distribution<double>(0.0, 1.0)(random_);
+    failure.retry_after_ms = now_ms + retryDelayMs(failure.failures, jitter);
+    return failure;
+}
+
+bool DownloadBackoff::recordSuccess(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failures_.erase(mix_id) > 0;
+}
+
+size_t DownloadBackoff::getBackedOffCount(int64_t now_ms) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(
+        std::count_if(failures_.begin(), failures_.end(),
+                      [now_ms](const auto& entry) { return now_ms < entry.second.retry_after_ms; }));
+}
+
+int64_t DownloadBackoff::retryDelayMs(int failures, double jitter) {
+    const int doublings = std::clamp(failures - 1, 0, 30);
+    const int64_t delay_ms = std::min<int64_t>(int64_t{Constants::DOWNLOAD_RETRY_BASE_SECONDS} << doublings,
+                                               Constants::DOWNLOAD_RETRY_MAX_SECONDS) *
+                             1000;
+    return delay_ms - static_cast<int64_t>(static_cast<double>(delay_ms) * Constants::DOWNLOAD_RETRY_JITTER * jitter);
+}
+
+}  // namespace AutoVibez::Data
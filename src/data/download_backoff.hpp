@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief A mix whose downloads keep failing, and when it may be tried again
+ */
+struct DownloadFailure {
+    std::string mix_id;
+    int failures = 0;            // In a row
+    int64_t retry_after_ms = 0;  // Epoch ms
+};
+
+/**
+ * @brief Exponential backoff with jitter for mixes whose downloads fail
+ *
+ * After a mix's n-th failure in a row it waits DOWNLOAD_RETRY_BASE_SECONDS times 2^(n-1),
+ * at most DOWNLOAD_RETRY_MAX_SECONDS, less up to DOWNLOAD_RETRY_JITTER of that at random,
+ * so mixes that failed together don't all come back at once. Times are epoch ms, so the
+ * owner can store each failure and load them again after a restart. Thread-safe.
+ */
+class DownloadBackoff {
+public:
+    DownloadBackoff();
+
+    /**
+     * @brief Take in failures stored by an earlier run, replacing what is held
+     */
+    void load(const std::vector<DownloadFailure>& failures);
+
+    /**
+     * @brief Whether the mix's wait is over, or it never failed
+     */
+    bool mayAttempt(const std::string& mix_id, int64_t now_ms) const;
+
+    /**
+     * @return The mix's failure as it now stands, for the owner to store
+     */
+    DownloadFailure recordFailure(const std::string& mix_id, int64_t now_ms);
+
+    /**
+     * @return True if the mix had failed before, so the owner has a stored failure to drop
+     */
+    bool recordSuccess(const std::string& mix_id);
+
+    size_t getBackedOffCount(int64_t now_ms) const;
+
+    /**
+     * @brief The wait after a number of failures in a row
+     * @param jitter In [0, 1): the share of DOWNLOAD_RETRY_JITTER taken off
+     */
+    static int64_t retryDelayMs(int failures, double jitter);
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, DownloadFailure> failures_;
+    std::mt19937 random_;
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,174 @@
+#include "download_scheduler.hpp"
+
+namespace AutoVibez::Data {
+
+DownloadScheduler::DownloadScheduler(size_t workers, size_t per_host_limit)
+    : per_host_limit_(per_host_limit > 0 ? per_host_limit : 1) {
+    workers_.reserve(workers + 1);
+    workers_.emplace_back(&DownloadScheduler::run, this, true);
+    for (size_t i = 0; i < (workers > 0 ? workers : 1); ++i) {
+        workers_.emplace_back(&DownloadScheduler::run, this, false);
+    }
+}
+
+DownloadScheduler::~DownloadScheduler() {
+    shutdown();
+}
+
+bool DownloadScheduler::schedule(const std::string& id, const std::string& host, DownloadPriority priority,
+                                 Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || id.empty() || queued_.count(id) || running_.count(id)) {
+            return false;
+        }
+        const Key key{priority, next_sequence_++};
+        queue_.emplace(key, Job{id, host, std::move(task)});
+        queued_.emplace(id, key);
+    }
+    // Any idle worker may be the one allowed to run it
+    wake_.notify_all();
+    return true;
+}
+
+bool DownloadScheduler::reprioritize(const std::string& id, DownloadPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = queued_.find(id);
+        if (it == queued_.end()) {
+            return false;
+        }
+        auto node = queue_.extract(it->second);
+        node.key() = Key{priority, next_sequence_++};
+        it->second = node.key();
+        queue_.insert(std::move(node));
+    }
+    wake_.notify_all();
+    return true;
+}
+
+bool DownloadScheduler::cancel(const std::string& id) {
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = queued_.find(id);
+        if (it == queued_.end()) {
+            return false;
+        }
+        queue_.erase(it->second);
+        queued_.erase(it);
+        idle = queue_.empty() && running_.empty();
+    }
+    if (idle) {
+        idle_.notify_all();
+    }
+    return true;
+}
+
+void DownloadScheduler::cancelAll() {
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        queued_.clear();
+        idle = running_.empty();
+    }
+    if (idle) {
+        idle_.notify_all();
+    }
+}
+
+void DownloadScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+        queued_.clear();
+    }
+    wake_.notify_all();
+    idle_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+bool DownloadScheduler::isQueued(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_.count(id) > 0;
+}
+
+bool DownloadScheduler::isRunning(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_.count(id) > 0;
+}
+
+size_t DownloadScheduler::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+size_t DownloadScheduler::getRunningCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_.size();
+}
+
+void DownloadScheduler::waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return stopping_ || (queue_.empty() && running_.empty()); });
+}
+
+bool DownloadScheduler::takeLocked(bool playing_only, Job& job) {
+    // Ordered by priority, so the scan stops at the first job this worker may run
+    for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        const bool playing = it->first.first == DownloadPriority::Playing;
+        if (playing_only && !playing) {
+            return false;
+        }
+        if (!playing && !it->second.host.empty()) {
+            auto host = host_running_.find(it->second.host);
+            if (host != host_running_.end() && host->second >= per_host_limit_) {
+                continue;
+            }
+        }
+        job = std::move(it->second);
+        queued_.erase(job.id);
+        queue_.erase(it);
+        running_.insert(job.id);
+        if (!job.host.empty()) {
+            host_running_[job.host]++;
+        }
+        return true;
+    }
+    return false;
+}
+
+void DownloadScheduler::run(bool playing_only) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Job job;
+        wake_.wait(lock, [&]() { return stopping_ || takeLocked(playing_only, job); });
+        if (job.id.empty()) {
+            return;
+        }
+
+        lock.unlock();
+        job.task();
+        job.task = nullptr;  // Whatever the task captured is released outside the lock
+        lock.lock();
+
+        running_.erase(job.id);
+        if (!job.host.empty() && --host_running_[job.host] == 0) {
+            host_running_.erase(job.host);
+        }
+        // A finished job may unblock its host for another worker
+        wake_.notify_all();
+        if (queue_.empty() && running_.empty()) {
+            idle_.notify_all();
+        }
+    }
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "bandwidth_governor.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Which downloads DownloadScheduler starts first
+ */
+enum class DownloadPriority {
+    Playing,     //!< Playback is waiting for it: a worker of its own and no host limit
+    UpNext,      //!< In the play queue
+    Favorite,    //!< A favorite the library is missing
+    Background,  //!< Everything else from the manifest
+};
+
+/**
+ * @brief A fixed pool of download workers fed from a priority queue
+ *
+ * Jobs run highest priority first and in the order they were scheduled within a
+ * priority. A host never has more than the per-host limit running at once, so
+ * one mirror cannot take every worker; a worker skips jobs for a saturated host
+ * and takes the next one that may run. Playing jobs are exempt from that limit
+ * and one extra worker takes nothing else, so playback never waits behind a
+ * manifest's worth of background transfers.
+ *
+ * The jobs' transfers draw on one BandwidthGovernor, whose ceiling the owner
+ * sets from playback state; the scheduler itself never throttles.
+ *
+ * Jobs are keyed by an id (the mix ID) and an id is queued or running once at
+ * most. Cancelling only drops queued jobs; a running task stops on its own terms.
+ * Thread-safe.
+ */
+class DownloadScheduler {
+public:
+    using Task = std::function<bool()>;
+
+    /**
+     * @param workers Threads for queued downloads, besides the one reserved for Playing jobs
+     * @param per_host_limit Jobs for one host running at once
+     */
+    DownloadScheduler(size_t workers, size_t per_host_limit);
+
+    /**
+     * @brief Drops the queue and joins the workers once their running tasks return
+     */
+    ~DownloadScheduler();
+
+    DownloadScheduler(const DownloadScheduler&) = delete;
+    DownloadScheduler& operator=(const DownloadScheduler&) = delete;
+
+    /**
+     * @brief Queue a task
+     * @param host Jobs with the same host share its limit; empty for one with no host
+     * @return False if id is empty, already queued or running, or the scheduler is shutting down
+     */
+    bool schedule(const std::string& id, const std::string& host, DownloadPriority priority, Task task);
+
+    /**
+     * @brief Move a queued job to the back of another priority
+     * @return False if id is not queued (never scheduled, already running or done)
+     */
+    bool reprioritize(const std::string& id, DownloadPriority priority);
+
+    /**
+     * @brief Drop a queued job
+     * @return False if id is not queued
+     */
+    bool cancel(const std::string& id);
+
+    /**
+     * @brief Drop every queued job
+     */
+    void cancelAll();
+
+    /**
+     * @brief Drop the queue, refuse new jobs and join the workers
+     */
+    void shutdown();
+
+    bool isQueued(const std::string& id) const;
+    bool isRunning(const std::string& id) const;
+    size_t getQueuedCount() const;
+    size_t getRunningCount() const;
+
+    /**
+     * @brief Block until nothing is queued or running
+     */
+    void waitUntilIdle();
+
+    /**
+     * @brief The ceiling shared by the transfers of this scheduler's jobs
+     */
+    std::shared_ptr<AutoVibez::Utils::BandwidthGovernor> getBandwidthGovernor() const {
+        return governor_;
+    }
+
+private:
+    using Key = std::pair<DownloadPriority, uint64_t>;  // Priority, then scheduling order
+
+    struct Job {
+        std::string id;
+        std::string host;
+        Task task;
+    };
+
+    const size_t per_host_limit_;
+    const std::shared_ptr<AutoVibez::Utils::BandwidthGovernor> governor_ =
+        std::make_shared<AutoVibez::Utils::BandwidthGovernor>();
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::map<Key, Job> queue_;  // Next to run first
+    std::unordered_map<std::string, Key> queued_;
+    std::unordered_set<std::string> running_;
+    std::unordered_map<std::string, size_t> host_running_;
+    uint64_t next_sequence_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    bool takeLocked(bool playing_only, Job& job);
+    void run(bool playing_only);
+};
+
+}  // namespace AutoVibez::Data
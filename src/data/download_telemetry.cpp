@@ -0,0 +1,164 @@
+#include "download_telemetry.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include "constants.hpp"
+#include "metrics_registry.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr int64_t MEGABYTE = 1024 * 1024;
+
+std::string formatRate(int64_t bytes_per_second) {
+    char text[32];
+    if (bytes_per_second >= MEGABYTE) {
+        std::snprintf(text, sizeof(text), "%.1f MB/s", static_cast<double>(bytes_per_second) / MEGABYTE);
+    } else {
+        std::snprintf(text, sizeof(text), "%lld KB/s", static_cast<long long>(bytes_per_second / 1024));
+    }
+    return text;
+}
+
+std::string formatDuration(int64_t seconds) {
+    char text[32];
+    if (seconds >= 3600) {
+        std::snprintf(text, sizeof(text), "%lld:%02lld:%02lld", static_cast<long long>(seconds / 3600),
+                      static_cast<long long>(seconds / 60 % 60), static_cast<long long>(seconds % 60));
+    } else {
+        std::snprintf(text, sizeof(text), "%lld:%02lld", static_cast<long long>(seconds / 60),
+                      static_cast<long long>(seconds % 60));
+    }
+    return text;
+}
+
+// Fleet-wide totals; the per-host breakdown stays in the telemetry
+void recordDownloadMetrics(bool ok, int64_t bytes, double seconds) {
+    using AutoVibez::Utils::MetricsRegistry;
+    static AutoVibez::Utils::MetricCounter& bytesTotal =
+        MetricsRegistry::instance().counter("autovibez_download_bytes_total", "Bytes fetched by mix downloads");
+    static AutoVibez::Utils::MetricCounter& completed =
+        MetricsRegistry::instance().counter("autovibez_downloads_completed_total", "Mix downloads that finished");
+    static AutoVibez::Utils::MetricCounter& failed =
+        MetricsRegistry::instance().counter("autovibez_downloads_failed_total", "Mix downloads that gave up");
+    static AutoVibez::Utils::MetricHistogram& durations = MetricsRegistry::instance().histogram(
+        "autovibez_download_seconds", "Wall time of each mix download", {1, 5, 15, 30, 60, 120, 300, 600});
+    bytesTotal.increment(static_cast<uint64_t>(std::max<int64_t>(bytes, 0)));
+    (ok ? completed : failed).increment();
+    durations.observe(std::max(seconds, 0.0));
+}
+}  // namespace
+
+void DownloadTelemetry::record(const std::string& host, bool ok, int64_t bytes, double seconds, int retries,
+                               Clock::time_point now) {
+    recordDownloadMetrics(ok, bytes, seconds);
+    std::lock_guard<std::mutex> lock(mutex_);
+    DownloadHostStats& stats = hosts_[host];
+    stats.host = host;
+    if (ok) {
+        stats.completed++;
+        completions_.push_back(now);
+    } else {
+        stats.failed++;
+    }
+    stats.retries += static_cast<uint64_t>(std::max(retries, 0));
+    stats.bytes += std::max<int64_t>(bytes, 0);
+    stats.seconds += std::max(seconds, 0.0);
+
+    const auto window = std::chrono::seconds(Constants::DOWNLOAD_STATS_WINDOW_SECONDS);
+    while (!completions_.empty() && now - completions_.front() > window) {
+        completions_.pop_front();
+    }
+}
+
+uint64_t DownloadTelemetry::getCompletedRecently(Clock::time_point now) const {
+    const auto since = now - std::chrono::seconds(Constants::DOWNLOAD_STATS_WINDOW_SECONDS);
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto first = std::lower_bound(completions_.begin(), completions_.end(), since);
+    return static_cast<uint64_t>(completions_.end() - first);
+}
+
+std::vector<DownloadHostStats> DownloadTelemetry::snapshot() const {
+    std::vector<DownloadHostStats> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.reserve(hosts_.size());
+        for (const auto& host : hosts_) {
+            result.push_back(host.second);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), [](const DownloadHostStats& a, const DownloadHostStats& b) {
+        return a.failed != b.failed ? a.failed > b.failed : a.completed > b.completed;
+    });
+    return result;
+}
+
+std::string DownloadTelemetry::formatSummary(const DownloadStats& stats) {
+    std::string summary;
+    if (stats.running == 0 && stats.queued == 0) {
+        summary = "Downloads idle";
+    } else {
+        summary = "Downloads: " + std::to_string(stats.running) + " running at " + formatRate(stats.bytes_per_second) +
+                  ", " + std::to_string(stats.queued) + " queued";
+    }
+    for (const DownloadTransferStats& transfer : stats.transfers) {
+        // The one playback waits on is what counts; the rest finish when the ceiling lets them
+        if (transfer.full_speed && transfer.eta_seconds >= 0) {
+            summary += ", next mix in " + formatDuration(transfer.eta_seconds);
+            break;
+        }
+    }
+    summary += ", " + std::to_string(stats.completed_last_hour) + " done in the last hour";
+    if (!stats.hosts.empty() && stats.hosts.front().failed > 0) {
+        const DownloadHostStats& worst = stats.hosts.front();
+        summary += ", " + worst.host + " failed " + std::to_string(worst.failed) + " of " +
+                   std::to_string(worst.completed + worst.failed);
+    }
+    if (stats.hosts_down > 0) {
+        summary += ", " + std::to_string(stats.hosts_down) + (stats.hosts_down == 1 ? " host" : " hosts") + " down";
+    }
+    if (stats.backed_off > 0) {
+        summary += ", " + std::to_string(stats.backed_off) + " waiting to retry";
+    }
+    for (const IngestStageStats& stage : stats.stages) {
+        if (stage.busy > 0 || stage.queued > 0) {
+            summary += ", " + stage.name + " " + std::to_string(stage.busy) + "/" + std::to_string(stage.workers) +
+                       " busy with " + std::to_string(stage.queued) + " queued";
+        }
+    }
+    return summary;
+}
+
+void DownloadTelemetry::writeCsv(std::ostream& out) const {
+    out << "host,completed,failed,failure_rate,retries,bytes,seconds,bytes_per_second\n";
+    for (const DownloadHostStats& stats : snapshot()) {
+        out << stats.host << ',' << stats.completed << ',' << stats.failed << ',' << stats.getFailureRate() << ','
+            << stats.retries << ',' << stats.bytes << ',' << stats.seconds << ',' << stats.getBytesPerSecond()
+            << '\n';
+    }
+}
+
+bool DownloadTelemetry::writeCsv(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        setError("Cannot open download stats file: " + path);
+        return false;
+    }
+    writeCsv(out);
+    if (!out.good()) {
+        setError("Failed to write download stats file: " + path);
+        return false;
+    }
+    setSuccess(true);
+    return true;
+}
+
+void DownloadTelemetry::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hosts_.clear();
+    completions_.clear();
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "error_handler.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief One download in flight, read off its DownloadProgress
+ */
+struct DownloadTransferStats {
+    std::string mix_id;
+    int64_t bytes = 0;
+    int64_t total_bytes = -1;  //!< -1 until the server reports it
+    int64_t bytes_per_second = 0;
+    int64_t eta_seconds = -1;  //!< -1 while the length or the rate is unknown
+    int retries = 0;
+    bool full_speed = false;  //!< Playing or next up, past the bandwidth ceiling
+};
+
+/**
+ * @brief Finished downloads from one host
+ */
+struct DownloadHostStats {
+    std::string host;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t retries = 0;
+    int64_t bytes = 0;     //!< Received by completed and failed downloads alike
+    double seconds = 0.0;  //!< Spent on them
+
+    double getFailureRate() const {
+        const uint64_t finished = completed + failed;
+        return finished > 0 ? static_cast<double>(failed) / static_cast<double>(finished) : 0.0;
+    }
+    int64_t getBytesPerSecond() const {
+        return seconds > 0.0 ? static_cast<int64_t>(static_cast<double>(bytes) / seconds) : 0;
+    }
+};
+
+/**
+ * @brief One stage of the ingest pipeline a finished fetch goes through
+ */
+struct IngestStageStats {
+    std::string name;
+    size_t workers = 0;
+    size_t queued = 0;    //!< Mixes waiting for a worker
+    size_t capacity = 0;  //!< Queued mixes at which the stage before it blocks
+    size_t busy = 0;      //!< Workers on a mix now
+    uint64_t processed = 0;
+    uint64_t failed = 0;
+    double busy_seconds = 0.0;     //!< Worker time spent on mixes
+    double blocked_seconds = 0.0;  //!< Time the stage before spent waiting for room in the queue
+};
+
+/**
+ * @brief The download queue at a glance, as MixManager::getDownloadStats puts it together
+ */
+struct DownloadStats {
+    size_t queued = 0;
+    size_t running = 0;
+    uint64_t completed_last_hour = 0;
+    int64_t bytes_per_second = 0;  //!< Of every transfer in flight together
+    std::vector<DownloadTransferStats> transfers;
+    std::vector<DownloadHostStats> hosts;  //!< Most failures first
+    size_t hosts_down = 0;                 //!< Hosts whose circuit breaker fails downloads at once
+    size_t backed_off = 0;                 //!< Mixes waiting out a failure before they are tried again
+    std::vector<IngestStageStats> stages;  //!< After the fetch, in pipeline order
+};
+
+/**
+ * @brief Per-host totals of finished downloads, shared by the download workers
+ *
+ * Transfers in flight publish their bytes, rate and retries through the atomics of
+ * their DownloadProgress; only a finished download takes this lock, once. Completions
+ * of the last DOWNLOAD_STATS_WINDOW_SECONDS are kept as times, for the recent rate.
+ * Thread-safe.
+ */
+class DownloadTelemetry : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Add a download that ended, ok or not; cancelled ones say nothing of the host and aren't recorded
+     * @param bytes The file as far as it got, a prefix resumed from an earlier attempt included
+     */
+    void record(const std::string& host, bool ok, int64_t bytes, double seconds, int retries,
+                Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Downloads completed within DOWNLOAD_STATS_WINDOW_SECONDS of now
+     */
+    uint64_t getCompletedRecently(Clock::time_point now = Clock::now()) const;
+
+    /**
+     * @return Every host seen, most failures first, then most completed
+     */
+    std::vector<DownloadHostStats> snapshot() const;
+
+    /**
+     * @brief One overlay line: what is running, how fast, and the host failing most
+     */
+    static std::string formatSummary(const DownloadStats& stats);
+
+    void writeCsv(std::ostream& out) const;
+
+    /**
+     * @brief Write the snapshot to a file
+     * @return True on success; the error is kept otherwise
+     */
+    bool writeCsv(const std::string& path);
+
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, DownloadHostStats> hosts_;
+    std::deque<Clock::time_point> completions_;  // Oldest first
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,177 @@
+#include "ingest_pipeline.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Data {
+
+IngestPipeline::IngestPipeline(Analyzer analyzer, Indexer indexer, size_t analysis_workers, size_t index_batch)
+    : analyzer_(std::move(analyzer)),
+      indexer_(std::move(indexer)),
+      analysis_workers_(analysis_workers > 0 ? analysis_workers : defaultAnalysisWorkers()),
+      index_batch_(index_batch > 0 ? index_batch : static_cast<size_t>(Constants::INGEST_INDEX_BATCH)),
+      analyze_capacity_(analysis_workers_ * static_cast<size_t>(Constants::INGEST_QUEUE_PER_WORKER)),
+      index_capacity_(std::max(static_cast<size_t>(Constants::INGEST_INDEX_QUEUE), index_batch_)) {
+    analyzers_running_ = analysis_workers_;
+    for (size_t i = 0; i < analysis_workers_; ++i) {
+        analysis_threads_.emplace_back(&IngestPipeline::runAnalysis, this);
+    }
+    index_thread_ = std::thread(&IngestPipeline::runIndex, this);
+}
+
+IngestPipeline::~IngestPipeline() {
+    stop();
+}
+
+size_t IngestPipeline::defaultAnalysisWorkers() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    const size_t spare = cores > 1 ? cores - 1 : 1;
+    return std::min(spare, static_cast<size_t>(Constants::INGEST_ANALYSIS_MAX_WORKERS));
+}
+
+bool IngestPipeline::submit(IngestJob job) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!stopping_ && analyze_queue_.size() >= analyze_capacity_) {
+            const auto start = Clock::now();
+            analyze_room_.wait(lock, [this]() { return stopping_ || analyze_queue_.size() < analyze_capacity_; });
+            analyze_.blocked_seconds += secondsSince(start);
+        }
+        if (!stopping_) {
+            analyze_queue_.push_back(std::move(job));
+            lock.unlock();
+            analyze_ready_.notify_one();
+            return true;
+        }
+    }
+    settle(job, false);
+    return false;
+}
+
+void IngestPipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    analyze_ready_.notify_all();
+    analyze_room_.notify_all();
+    for (std::thread& thread : analysis_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    if (index_thread_.joinable()) {
+        index_thread_.join();
+    }
+}
+
+std::vector<IngestStageStats> IngestPipeline::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto describe = [](const char* name, size_t workers, size_t queued, size_t capacity, const StageCounters& stage) {
+        IngestStageStats stats;
+        stats.name = name;
+        stats.workers = workers;
+        stats.queued = queued;
+        stats.capacity = capacity;
+        stats.busy = stage.busy;
+        stats.processed = stage.processed;
+        stats.failed = stage.failed;
+        stats.busy_seconds = stage.busy_seconds;
+        stats.blocked_seconds = stage.blocked_seconds;
+        return stats;
+    };
+    return {describe("analyze", analysis_workers_, analyze_queue_.size(), analyze_capacity_, analyze_),
+            describe("index", 1, index_queue_.size(), index_capacity_, index_)};
+}
+
+void IngestPipeline::runAnalysis() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        analyze_ready_.wait(lock, [this]() { return stopping_ || !analyze_queue_.empty(); });
+        if (analyze_queue_.empty()) {
+            break;  // Stopping with nothing left to analyze
+        }
+        IngestJob job = std::move(analyze_queue_.front());
+        analyze_queue_.pop_front();
+        analyze_.busy++;
+        analyze_room_.notify_one();
+
+        lock.unlock();
+        const auto start = Clock::now();
+        const bool ok = analyzer_(job);
+        const double seconds = secondsSince(start);
+        if (!ok) {
+            settle(job, false);
+        }
+        lock.lock();
+
+        analyze_.busy--;
+        analyze_.busy_seconds += seconds;
+        if (!ok) {
+            analyze_.failed++;
+            continue;
+        }
+        analyze_.processed++;
+        if (index_queue_.size() >= index_capacity_) {
+            const auto blocked = Clock::now();
+            index_room_.wait(lock, [this]() { return index_queue_.size() < index_capacity_; });
+            index_.blocked_seconds += secondsSince(blocked);
+        }
+        index_queue_.push_back(std::move(job));
+        index_ready_.notify_one();
+    }
+    // The writer finishes once the last analysis thread can hand it nothing more
+    analyzers_running_--;
+    index_ready_.notify_one();
+}
+
+void IngestPipeline::runIndex() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        index_ready_.wait(lock, [this]() { return !index_queue_.empty() || analyzers_running_ == 0; });
+        if (index_queue_.empty()) {
+            break;
+        }
+        // Whatever piled up while the last batch was written goes in the next transaction
+        const size_t count = std::min(index_queue_.size(), index_batch_);
+        std::vector<IngestJob> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(index_queue_.front()));
+            index_queue_.pop_front();
+        }
+        index_.busy = 1;
+        index_room_.notify_all();
+
+        lock.unlock();
+        const auto start = Clock::now();
+        indexer_(batch);
+        const double seconds = secondsSince(start);
+        uint64_t failed = 0;
+        for (IngestJob& job : batch) {
+            failed += job.ok ? 0 : 1;
+            settle(job, job.ok);
+        }
+        batch.clear();  // Whatever the jobs captured is released outside the lock
+        lock.lock();
+
+        index_.busy = 0;
+        index_.busy_seconds += seconds;
+        index_.failed += failed;
+        index_.processed += count - failed;
+    }
+}
+
+void IngestPipeline::settle(IngestJob& job, bool ok) {
+    job.ok = ok;
+    if (job.done) {
+        job.done(job);
+    }
+}
+
+double IngestPipeline::secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace AutoVibez::Data
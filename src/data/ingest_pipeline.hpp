@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "download_telemetry.hpp"
+#include "mix_downloader.hpp"
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief One fetched mix on its way into the library
+ */
+struct IngestJob {
+    Mix mix;                   // As the manifest lists it
+    FetchedMix fetched;        // Its bytes on disk, checked and hashed in flight
+    DownloadedMix downloaded;  // Filled by the analyze stage
+    Mix record;                // The row the index stage adds, filled by the analyze stage
+    bool ok = false;           // Set by the stage that settles the job
+    // Runs once the job is indexed or has failed, on the thread of the stage that settled it
+    std::function<void(IngestJob&)> done;
+};
+
+/**
+ * @brief Analysis and indexing of fetched mixes, each stage on its own threads
+ *
+ * The network stage stays with the download workers, which hand each fetched mix to
+ * submit and move on to the next transfer. A pool sized to the cores reads tags and
+ * renames files, and one writer thread adds what it finishes to the database a batch
+ * per transaction. Both queues are bounded: a full analysis queue blocks submit, and
+ * a full index queue blocks the analysis threads, so a burst of fast downloads slows
+ * the fetching instead of piling up files and memory. Thread-safe.
+ */
+class IngestPipeline {
+public:
+    using Analyzer = std::function<bool(IngestJob& job)>;
+    // Sets ok on each job of the batch it wrote
+    using Indexer = std::function<void(std::vector<IngestJob>& batch)>;
+
+    /**
+     * @param analyzer Runs on the analysis threads; false settles the job as failed
+     * @param indexer Runs on the writer thread with up to index_batch jobs
+     * @param analysis_workers 0 for defaultAnalysisWorkers()
+     * @param index_batch 0 for INGEST_INDEX_BATCH; the index queue holds at least one batch
+     */
+    IngestPipeline(Analyzer analyzer, Indexer indexer, size_t analysis_workers = 0, size_t index_batch = 0);
+
+    /**
+     * @brief Finishes what is queued, then joins
+     */
+    ~IngestPipeline();
+
+    IngestPipeline(const IngestPipeline&) = delete;
+    IngestPipeline& operator=(const IngestPipeline&) = delete;
+
+    /**
+     * @brief Queue a fetched mix, waiting while the analysis queue is full
+     *
+     * The job's done callback runs exactly once either way.
+     * @return False if the pipeline is stopping; the job was settled as failed on this thread
+     */
+    bool submit(IngestJob job);
+
+    /**
+     * @brief Refuse new jobs, finish the queued ones and join the threads
+     */
+    void stop();
+
+    /**
+     * @brief The analyze and index stages, in that order
+     */
+    std::vector<IngestStageStats> getStats() const;
+
+    size_t getAnalysisWorkers() const {
+        return analysis_workers_;
+    }
+
+    /**
+     * @brief One analysis thread per core but one, left to playback and rendering, within INGEST_ANALYSIS_MAX_WORKERS
+     */
+    static size_t defaultAnalysisWorkers();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct StageCounters {
+        size_t busy = 0;
+        uint64_t processed = 0;
+        uint64_t failed = 0;
+        double busy_seconds = 0.0;
+        double blocked_seconds = 0.0;
+    };
+
+    Analyzer analyzer_;
+    Indexer indexer_;
+    size_t analysis_workers_;
+    size_t index_batch_;
+    size_t analyze_capacity_;
+    size_t index_capacity_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable analyze_ready_;  // A job to analyze, or stopping
+    std::condition_variable analyze_room_;   // Room in the analysis queue, or stopping
+    std::condition_variable index_ready_;    // A job to index, or the last analysis thread gone
+    std::condition_variable index_room_;     // Room in the index queue
+    std::deque<IngestJob> analyze_queue_;
+    std::deque<IngestJob> index_queue_;
+    StageCounters analyze_;
+    StageCounters index_;
+    size_t analyzers_running_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> analysis_threads_;
+    std::thread index_thread_;
+
+    void runAnalysis();
+    void runIndex();
+    static void settle(IngestJob& job, bool ok);
+    static double secondsSince(Clock::time_point start);
+};
+
+}  // namespace AutoVibez::Data
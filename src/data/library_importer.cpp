@@ -0,0 +1,221 @@
+#include "library_importer.hpp"
+
+#include <filesystem>
+#include <thread>
+#include <utility>
+
+#include "constants.hpp"
+#include "content_hash.hpp"
+#include "datetime_utils.hpp"
+#include "mp3_analyzer.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+bool isMp3(const std::filesystem::path& path) {
+    return AutoVibez::Utils::StringUtils::toLower(path.extension().string()) == StringConstants::MP3_EXTENSION;
+}
+}  // namespace
+
+LibraryImporter::LibraryImporter(MixDatabase& database, MixDownloader& downloader,
+                                 AutoVibez::Utils::Mp3ProbeCache& scan_cache)
+    : database_(database), downloader_(downloader), scan_cache_(scan_cache) {}
+
+std::string LibraryImporter::mixIdForPath(const std::string& path) {
+    AutoVibez::Utils::ContentHasher hasher;
+    hasher.update(path.data(), path.size());
+    return "local-" + hasher.hexDigest();
+}
+
+bool LibraryImporter::importDirectory(const std::string& root, LibraryImportStats& stats) {
+    stats = LibraryImportStats();
+    clearError();
+    std::error_code error;
+    const std::filesystem::path root_path = std::filesystem::canonical(root, error);
+    if (error || !std::filesystem::is_directory(root_path, error)) {
+        setError("Not a readable directory: " + root);
+        return false;
+    }
+
+    files_ = 0;
+    imported_ = 0;
+    unchanged_ = 0;
+    failed_ = 0;
+    started_ = std::chrono::steady_clock::now();
+    last_report_ = started_;
+    directories_ = {root_path.string()};
+    listing_ = 0;
+
+    const MixCatalog::Snapshot library = database_.getCatalog()->snapshot();
+    {
+        IngestPipeline pipeline([this](IngestJob& job) { return scanFile(job); },
+                                [this](std::vector<IngestJob>& batch) { indexFiles(batch); }, scanners_,
+                                static_cast<size_t>(Constants::LIBRARY_IMPORT_BATCH));
+        std::vector<std::thread> walkers;
+        for (size_t i = 0; i < walkers_; ++i) {
+            walkers.emplace_back([this, &pipeline, &library]() { walk(pipeline, library); });
+        }
+        for (std::thread& walker : walkers) {
+            walker.join();
+        }
+        pipeline.stop();
+    }
+
+    stats = snapshotStats();
+    return true;
+}
+
+void LibraryImporter::walk(IngestPipeline& pipeline, const MixCatalog::Snapshot& library) {
+    std::unique_lock<std::mutex> lock(walk_mutex_);
+    while (true) {
+        // Done once nothing is left to list and no walker is still listing one that may hold more
+        walk_cv_.wait(lock, [this]() { return !directories_.empty() || listing_ == 0; });
+        if (directories_.empty()) {
+            break;
+        }
+        const std::string directory = std::move(directories_.back());
+        directories_.pop_back();
+        listing_++;
+        lock.unlock();
+
+        std::vector<std::string> subdirectories;
+        std::error_code error;
+        std::filesystem::directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied,
+                                               error);
+        for (; !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+            // Links are not followed, so one pointing back up the tree can't loop the walk
+            std::error_code status_error;
+            const std::filesystem::file_status status = it->symlink_status(status_error);
+            if (status_error) {
+                continue;
+            }
+            if (std::filesystem::is_directory(status)) {
+                subdirectories.push_back(it->path().string());
+                continue;
+            }
+            if (!std::filesystem::is_regular_file(status) || !isMp3(it->path())) {
+                continue;
+            }
+
+            files_++;
+            const std::string path = it->path().string();
+            const std::string mix_id = mixIdForPath(path);
+            const MixRecord* existing = library->findById(mix_id);
+            if (existing && existing->localPath() == path && scan_cache_.isCurrent(path)) {
+                unchanged_++;
+                continue;
+            }
+            IngestJob job;
+            job.mix.id = mix_id;
+            job.mix.url = StringConstants::FILE_PROTOCOL + path;
+            job.fetched.mix_id = mix_id;
+            job.fetched.local_path = path;
+            pipeline.submit(std::move(job));  // Waits while the scanners are behind
+        }
+
+        lock.lock();
+        listing_--;
+        for (std::string& subdirectory : subdirectories) {
+            directories_.push_back(std::move(subdirectory));
+        }
+        walk_cv_.notify_all();
+    }
+}
+
+bool LibraryImporter::scanFile(IngestJob& job) {
+    // The analyzer keeps its last error, so each scan thread has its own
+    thread_local AutoVibez::Audio::MP3Analyzer analyzer;
+    analyzer.setProbeCache(&scan_cache_);
+
+    const std::string& path = job.fetched.local_path;
+    AutoVibez::Audio::MP3Metadata metadata = analyzer.analyzeFile(path);
+    if (metadata.duration_seconds <= 0) {
+        failed_++;
+        return false;
+    }
+    // Untagged sets are mostly filed under the DJ's name
+    if (metadata.artist == StringConstants::UNKNOWN_ARTIST) {
+        const std::string folder = std::filesystem::path(path).parent_path().filename().string();
+        if (!folder.empty()) {
+            metadata.artist = folder;
+        }
+    }
+
+    Mix& record = job.record;
+    record.id = job.mix.id;
+    record.title = metadata.title;
+    record.artist = metadata.artist;
+    record.genre = metadata.genre;
+    record.url = job.mix.url;
+    record.local_path = path;
+    record.duration_seconds = metadata.duration_seconds;
+    record.description = metadata.description;
+    record.tags = metadata.tags;
+    record.date_added_ms = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
+    return true;
+}
+
+void LibraryImporter::indexFiles(std::vector<IngestJob>& batch) {
+    const MixCatalog::Snapshot library = database_.getCatalog()->snapshot();
+    std::vector<Mix> additions;
+    std::vector<size_t> added_jobs;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        IngestJob& job = batch[i];
+        const MixRecord* existing = library->findById(job.record.id);
+        if (!existing) {
+            additions.push_back(job.record);
+            added_jobs.push_back(i);
+            continue;
+        }
+        // A file that changed since the last run keeps its plays and favorite
+        Mix mix = library->toMix(*existing);
+        mix.title = job.record.title;
+        mix.artist = job.record.artist;
+        mix.genre = job.record.genre;
+        mix.url = job.record.url;
+        mix.local_path = job.record.local_path;
+        mix.duration_seconds = job.record.duration_seconds;
+        mix.description = job.record.description;
+        mix.tags = job.record.tags;
+        job.ok = database_.updateMix(mix);
+    }
+    std::vector<bool> added;
+    if (database_.addMixes(additions, {}, added)) {
+        for (size_t i = 0; i < added_jobs.size(); ++i) {
+            batch[added_jobs[i]].ok = added[i];
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> references;
+    for (const IngestJob& job : batch) {
+        if (job.ok) {
+            references.emplace_back(job.record.id, job.record.local_path);
+            imported_++;
+        } else {
+            failed_++;
+        }
+    }
+    if (!downloader_.referenceFiles(references)) {
+        setError("Failed to record where the imported files are");
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (progress_ && std::chrono::duration<double>(now - last_report_).count() >=
+                         Constants::LIBRARY_IMPORT_PROGRESS_SECONDS) {
+        last_report_ = now;
+        progress_(snapshotStats());
+    }
+}
+
+LibraryImportStats LibraryImporter::snapshotStats() const {
+    LibraryImportStats stats;
+    stats.files = files_.load();
+    stats.imported = imported_.load();
+    stats.unchanged = unchanged_.load();
+    stats.failed = failed_.load();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    return stats;
+}
+
+}  // namespace AutoVibez::Data
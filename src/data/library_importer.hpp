@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+#include "ingest_pipeline.hpp"
+#include "mix_database.hpp"
+#include "mix_downloader.hpp"
+#include "mp3_probe.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief What one LibraryImporter::importDirectory run did
+ */
+struct LibraryImportStats {
+    uint64_t files = 0;      // MP3 files found
+    uint64_t imported = 0;   // Added to the library, or updated after the file changed
+    uint64_t unchanged = 0;  // In the library at the size and mtime scanned last time, so not read
+    uint64_t failed = 0;     // Unreadable, not MP3 or rejected by validation
+    double seconds = 0.0;
+
+    /**
+     * @brief Files found per second, skipped ones included; 0 before anything was timed
+     */
+    double filesPerSecond() const {
+        return seconds > 0.0 ? static_cast<double>(files) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Brings a directory tree of MP3s into the library, playing them from where they are
+ *
+ * LIBRARY_IMPORT_WALKERS threads list directories from a shared stack, so a tree on a
+ * share is walked many folders at a time. Each file goes through an IngestPipeline:
+ * tags are read on a LIBRARY_IMPORT_SCAN_WORKERS pool and the rows are written up to
+ * LIBRARY_IMPORT_BATCH per transaction. Files are not copied: a mix's URL is file://
+ * and its local path the file itself, which the mix cache never counts or evicts.
+ *
+ * A file already in the library whose size and mtime match the scan cache is skipped
+ * without being read, so re-running an import costs a stat per file. One that changed
+ * is read again and keeps its plays and favorite. Each file's id derives from its path.
+ */
+class LibraryImporter : public AutoVibez::Utils::ErrorHandler {
+public:
+    using ProgressCallback = std::function<void(const LibraryImportStats& stats)>;
+
+    /**
+     * @param scan_cache Verdicts keyed on size and mtime; the caller loads and saves it
+     */
+    LibraryImporter(MixDatabase& database, MixDownloader& downloader, AutoVibez::Utils::Mp3ProbeCache& scan_cache);
+
+    void setWorkers(size_t walkers, size_t scanners) {
+        walkers_ = walkers > 0 ? walkers : 1;
+        scanners_ = scanners > 0 ? scanners : 1;
+    }
+
+    /**
+     * @brief Called on the writer thread at most every LIBRARY_IMPORT_PROGRESS_SECONDS while the import runs
+     */
+    void setProgressCallback(ProgressCallback callback) {
+        progress_ = std::move(callback);
+    }
+
+    /**
+     * @brief Import every MP3 under root
+     * @param stats Filled with the counts and time taken
+     * @return False if root is not a readable directory
+     */
+    bool importDirectory(const std::string& root, LibraryImportStats& stats);
+
+    /**
+     * @brief The id a file imported from this absolute path gets, the same on every run
+     */
+    static std::string mixIdForPath(const std::string& path);
+
+private:
+    MixDatabase& database_;
+    MixDownloader& downloader_;
+    AutoVibez::Utils::Mp3ProbeCache& scan_cache_;
+    size_t walkers_ = static_cast<size_t>(Constants::LIBRARY_IMPORT_WALKERS);
+    size_t scanners_ = static_cast<size_t>(Constants::LIBRARY_IMPORT_SCAN_WORKERS);
+    ProgressCallback progress_;
+
+    // Counters of the run in progress, bumped from the walker, scan and writer threads
+    std::atomic<uint64_t> files_{0};
+    std::atomic<uint64_t> imported_{0};
+    std::atomic<uint64_t> unchanged_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point last_report_;
+
+    // Directories still to list, shared by the walkers, and how many are being listed now
+    std::mutex walk_mutex_;
+    std::condition_variable walk_cv_;
+    std::vector<std::string> directories_;
+    size_t listing_ = 0;
+
+    void walk(IngestPipeline& pipeline, const MixCatalog::Snapshot& library);
+    bool scanFile(IngestJob& job);
+    void indexFiles(std::vector<IngestJob>& batch);
+    LibraryImportStats snapshotStats() const;
+};
+
+}  // namespace AutoVibez::Data
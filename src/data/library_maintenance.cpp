@@ -0,0 +1,238 @@
+#include "library_maintenance.hpp"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "uuid_utils.hpp"
+
+namespace AutoVibez::Data {
+
+LibraryMaintenance::LibraryMaintenance(MixDatabase& database, AutoVibez::Utils::Mp3ProbeCache& probe_cache,
+                                       std::string mixes_dir)
+    : database_(database), probe_cache_(probe_cache), mixes_dir_(std::move(mixes_dir)) {
+    std::error_code error;
+    if (std::filesystem::is_directory(mixes_dir_, error)) {
+        watcher_ = std::make_unique<AutoVibez::Utils::DirectoryWatcher>(mixes_dir_);
+    }
+}
+
+void LibraryMaintenance::touch(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(touched_mutex_);
+    if (touched_ids_.insert(mix_id).second) {
+        touched_.push_front(mix_id);
+    }
+}
+
+bool LibraryMaintenance::nextTouched(std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(touched_mutex_);
+    if (touched_.empty()) {
+        return false;
+    }
+    mix_id = std::move(touched_.front());
+    touched_.pop_front();
+    touched_ids_.erase(mix_id);
+    return true;
+}
+
+LibraryMaintenance::Clock::time_point LibraryMaintenance::getNextDue() const {
+    {
+        std::lock_guard<std::mutex> lock(touched_mutex_);
+        if (!touched_.empty()) {
+            return Clock::time_point::min();
+        }
+    }
+    if (sweeping_ || !written_.empty()) {
+        return Clock::time_point::min();
+    }
+    return removals_.empty() ? next_sweep_ : std::min(next_sweep_, removals_.front().due);
+}
+
+void LibraryMaintenance::fileRemoved(const std::string& path, Clock::time_point now) {
+    removals_.push_back({path, now + std::chrono::milliseconds(Constants::MAINTENANCE_REMOVAL_SETTLE_MS)});
+}
+
+void LibraryMaintenance::fileWritten(const std::string& path) {
+    written_.push_back(path);
+}
+
+size_t LibraryMaintenance::tick(Clock::time_point now) {
+    if (watcher_) {
+        std::vector<AutoVibez::Utils::DirectoryEvent> events;
+        if (!watcher_->poll(events)) {
+            // Events were lost; a sweep finds what they were
+            resweep_ = sweeping_;
+            next_sweep_ = now;
+        }
+        for (const auto& event : events) {
+            if (event.type == AutoVibez::Utils::DirectoryEvent::Type::Removed) {
+                fileRemoved(event.path, now);
+            } else {
+                fileWritten(event.path);
+            }
+        }
+    }
+
+    if (now - window_start_ >= std::chrono::seconds(1)) {
+        window_start_ = now;
+        window_spent_ = Clock::duration::zero();
+    }
+    const auto tick_budget = std::chrono::milliseconds(Constants::MAINTENANCE_TICK_BUDGET_MS);
+    const auto second_budget = std::chrono::milliseconds(Constants::MAINTENANCE_BUDGET_MS_PER_SECOND);
+    const Clock::time_point started = Clock::now();
+    Clock::duration spent = Clock::duration::zero();
+    size_t checks = 0;
+    while (spent < tick_budget && window_spent_ + spent < second_budget && step(now)) {
+        checks++;
+        spent = Clock::now() - started;
+    }
+    window_spent_ += spent;
+    return checks;
+}
+
+bool LibraryMaintenance::step(Clock::time_point now) {
+    if (!removals_.empty() && removals_.front().due <= now) {
+        const std::string path = std::move(removals_.front().path);
+        removals_.pop_front();
+        removeMixesAt(path);
+        return true;
+    }
+    std::string mix_id;
+    if (nextTouched(mix_id)) {
+        checkMix(mix_id, now);
+        return true;
+    }
+    if (!written_.empty()) {
+        const std::string path = std::move(written_.front());
+        written_.pop_front();
+        checkFile(path, now);
+        return true;
+    }
+    return sweepStep(now);
+}
+
+void LibraryMaintenance::checkMix(const std::string& mix_id, Clock::time_point now) {
+    const MixCatalog::Snapshot catalog = database_.getCatalog()->snapshot();
+    const MixRecord* record = catalog->findById(mix_id);
+    if (!record) {
+        return;
+    }
+    stats_.mixes_checked++;
+
+    // A missing file is confirmed once it has settled; see removeMixesAt
+    if (!record->localPath().empty()) {
+        std::error_code error;
+        if (!std::filesystem::exists(std::filesystem::path(record->localPath()), error) && !error) {
+            fileRemoved(std::string(record->localPath()), now);
+            return;
+        }
+    }
+
+    // Ids from older versions are rewritten as the hash of the URL; the old id is retired in the same write
+    if (record->url().empty()) {
+        return;
+    }
+    const std::string correct_id = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(std::string(record->url()));
+    if (record->id() == correct_id) {
+        return;
+    }
+    Mix corrected = catalog->toMix(*record);
+    corrected.id = correct_id;
+    MixIngestStats ingest_stats;
+    if (database_.ingestMixes({corrected}, {mix_id}, ingest_stats)) {
+        stats_.ids_corrected++;
+    }
+}
+
+void LibraryMaintenance::checkFile(const std::string& path, Clock::time_point now) {
+    std::error_code error;
+    if (std::filesystem::path(path).extension() != ".mp3" || !std::filesystem::is_regular_file(path, error)) {
+        return;
+    }
+    stats_.files_checked++;
+
+    // Unchanged files reuse the stored verdict; new or rewritten ones get one bounded read
+    if (probe_cache_.probe(path).valid) {
+        return;
+    }
+    if (std::filesystem::remove(path, error)) {
+        stats_.files_removed++;
+        fileRemoved(path, now);
+    }
+    probe_cache_.forget(path);
+}
+
+void LibraryMaintenance::removeMixesAt(const std::string& path) {
+    // Back again, e.g. replaced by a rename; or the whole directory is gone, as with an unmounted share
+    const std::filesystem::path file(path);
+    std::error_code error;
+    if (std::filesystem::exists(file, error) || error || !std::filesystem::exists(file.parent_path(), error)) {
+        return;
+    }
+
+    const MixCatalog::Snapshot catalog = database_.getCatalog()->snapshot();
+    if (catalog != paths_catalog_) {
+        paths_.clear();
+        for (const auto& entry : catalog->entries()) {
+            if (!entry->localPath().empty()) {
+                paths_.emplace(entry->localPath(), entry->id());
+            }
+        }
+        paths_catalog_ = catalog;
+    }
+    std::vector<std::string> mix_ids;
+    const auto range = paths_.equal_range(path);
+    for (auto it = range.first; it != range.second; ++it) {
+        mix_ids.emplace_back(it->second);
+    }
+    for (const std::string& mix_id : mix_ids) {
+        if (database_.deleteMix(mix_id)) {
+            stats_.rows_removed++;
+        }
+    }
+}
+
+bool LibraryMaintenance::sweepStep(Clock::time_point now) {
+    if (!sweeping_) {
+        if (now < next_sweep_) {
+            return false;
+        }
+        sweeping_ = true;
+        sweeping_files_ = false;
+        sweep_catalog_ = database_.getCatalog()->snapshot();
+        sweep_position_ = 0;
+    }
+
+    std::error_code error;
+    if (!sweeping_files_) {
+        if (sweep_position_ < sweep_catalog_->size()) {
+            const std::string mix_id(sweep_catalog_->entries()[sweep_position_++]->id());
+            checkMix(mix_id, now);
+            return true;
+        }
+        sweeping_files_ = true;
+        sweep_catalog_.reset();
+        sweep_files_ = std::filesystem::directory_iterator(mixes_dir_, error);
+        return true;
+    }
+    while (sweep_files_ != std::filesystem::directory_iterator()) {
+        const std::string path = sweep_files_->path().string();
+        sweep_files_.increment(error);
+        if (error) {
+            sweep_files_ = std::filesystem::directory_iterator();
+        }
+        if (std::filesystem::path(path).extension() == ".mp3") {
+            checkFile(path, now);
+            return true;
+        }
+    }
+
+    sweeping_ = false;
+    stats_.sweeps++;
+    next_sweep_ = resweep_ ? now : now + std::chrono::milliseconds(Constants::MAINTENANCE_SWEEP_INTERVAL_MS);
+    resweep_ = false;
+    return true;
+}
+
+}  // namespace AutoVibez::Data
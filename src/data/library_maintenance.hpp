@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "constants.hpp"
+#include "directory_watcher.hpp"
+#include "mix_database.hpp"
+#include "mp3_probe.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief What LibraryMaintenance has checked and repaired so far
+ */
+struct LibraryMaintenanceStats {
+    uint64_t mixes_checked = 0;
+    uint64_t files_checked = 0;
+    uint64_t rows_removed = 0;   // Mixes whose file was deleted
+    uint64_t ids_corrected = 0;  // Mixes stored under an id that no longer matches their URL
+    uint64_t files_removed = 0;  // Corrupted files deleted from the mixes directory
+    uint64_t sweeps = 0;         // Full passes finished
+};
+
+/**
+ * @brief Keeps the library consistent with the mixes directory a few checks at a time
+ *
+ * Replaces whole-library passes at startup with work spread over idle ticks. Each
+ * tick() runs single checks until it has taken MAINTENANCE_TICK_BUDGET_MS, and no
+ * more than MAINTENANCE_BUDGET_MS_PER_SECOND is spent in any second. Work is taken
+ * in order of urgency:
+ *  - files reported gone, by the directory watcher or by a check, once they have
+ *    stayed gone for MAINTENANCE_REMOVAL_SETTLE_MS (so a file the cache evicts is
+ *    not mistaken for a deleted mix before its row is updated); their mixes are
+ *    removed unless the whole directory is missing, as with an unmounted share
+ *  - mixes touched by playback, queueing or downloads, most recent first, checked
+ *    for a missing file and for an id that no longer matches their URL
+ *  - files written into the directory, probed for corruption
+ *  - a resumable sweep over the catalog and then the directory's .mp3 files, which
+ *    starts again MAINTENANCE_SWEEP_INTERVAL_MS after it ends, or at once if the
+ *    watcher lost events
+ *
+ * Corrupted files are deleted and forgotten by the probe cache, and their mixes go as
+ * for any other missing file. Where no watcher is available the sweep finds every
+ * change, only later. touch() may be called from any thread; the rest from one.
+ */
+class LibraryMaintenance {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param mixes_dir Watched for deletions and swept for corrupted files
+     */
+    LibraryMaintenance(MixDatabase& database, AutoVibez::Utils::Mp3ProbeCache& probe_cache, std::string mixes_dir);
+
+    /**
+     * @brief Check a mix ahead of the sweep, e.g. because it is about to play
+     */
+    void touch(const std::string& mix_id);
+
+    /**
+     * @brief A file in the mixes directory was deleted (as the watcher reports it)
+     */
+    void fileRemoved(const std::string& path, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief A file in the mixes directory was written (as the watcher reports it)
+     */
+    void fileWritten(const std::string& path);
+
+    /**
+     * @brief Read the watcher and run checks within the time budget
+     * @return Checks run
+     */
+    size_t tick(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Run the most urgent check whatever the budget
+     * @return False if nothing is due
+     */
+    bool step(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief When a check is next due; Clock::time_point::min() while one is waiting now
+     *
+     * Watcher events are not counted, as they are only seen when tick() polls for them.
+     */
+    Clock::time_point getNextDue() const;
+
+    bool isWatching() const {
+        return watcher_ && watcher_->isWatching();
+    }
+
+    const LibraryMaintenanceStats& getStats() const {
+        return stats_;
+    }
+
+private:
+    struct Removal {
+        std::string path;
+        Clock::time_point due;
+    };
+
+    bool nextTouched(std::string& mix_id);
+    void checkMix(const std::string& mix_id, Clock::time_point now);
+    void checkFile(const std::string& path, Clock::time_point now);
+    void removeMixesAt(const std::string& path);
+    bool sweepStep(Clock::time_point now);
+
+    MixDatabase& database_;
+    AutoVibez::Utils::Mp3ProbeCache& probe_cache_;
+    std::string mixes_dir_;
+    std::unique_ptr<AutoVibez::Utils::DirectoryWatcher> watcher_;
+
+    mutable std::mutex touched_mutex_;  // Guards touched_ and touched_ids_
+    std::deque<std::string> touched_;   // Most recent at the front
+    std::unordered_set<std::string> touched_ids_;
+    std::deque<Removal> removals_;      // In due order
+    std::deque<std::string> written_;
+
+    // Local path to mix ids, built from paths_catalog_ when a removal needs it
+    MixCatalog::Snapshot paths_catalog_;
+    std::unordered_multimap<std::string, std::string> paths_;
+
+    // The sweep holds the catalog it started on
+    bool sweeping_ = false;
+    bool sweeping_files_ = false;
+    bool resweep_ = false;  // Events were lost during this sweep, so another follows it
+    MixCatalog::Snapshot sweep_catalog_;
+    size_t sweep_position_ = 0;
+    std::filesystem::directory_iterator sweep_files_;
+    Clock::time_point next_sweep_{};
+
+    Clock::time_point window_start_{};
+    Clock::duration window_spent_{};
+
+    LibraryMaintenanceStats stats_;
+};
+
+}  // namespace AutoVibez::Data
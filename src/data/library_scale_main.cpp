@@ -0,0 +1,356 @@
+// Where the mix library stops scaling: the MixManager lifecycle (startup, manifest load and diff, genre listing,
+// selection, search, shutdown and a warm restart) against synthetic catalogs of growing size, with the resident
+// memory after each stage. Each size runs in a process of its own, so one size's heap does not inflate the next.
+// Usage: autovibez_scale_bench [--sizes N,N,...] [--changed PERCENT] [--picks N] [--json PATH]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cancellation_token.hpp"
+#include "manifest_diff.hpp"
+#include "metrics_registry.hpp"
+#include "mix_database.hpp"
+#include "mix_manager.hpp"
+#include "path_manager.hpp"
+#include "synthetic_library.hpp"
+
+using AutoVibez::Data::ManifestDiff;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Data::MixIngestStats;
+using AutoVibez::Data::MixManager;
+using AutoVibez::Data::SyntheticLibrary;
+using AutoVibez::Data::SyntheticLibraryOptions;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+struct Settings {
+    std::vector<int> sizes = {10000, 100000, 1000000};
+    double changed_percent = 1.0;  // Of the manifest between the seeded run and this one
+    int picks = 200;               // Selections timed per kind
+    std::string json;
+    int child_mixes = 0;  // Set in the per-size processes
+    std::string child_out;
+};
+
+// One size's numbers, written by its process in this order and read back by the parent
+struct ScaleResult {
+    int mixes = 0;
+    int library = 0;
+    double seed_s = 0.0;
+    double init_ms = 0.0;
+    double manifest_ms = 0.0;
+    double diff_ms = 0.0;
+    double genres_ms = 0.0;
+    double pick_p50_ms = 0.0;
+    double pick_p99_ms = 0.0;
+    double available_p50_ms = 0.0;
+    double available_p99_ms = 0.0;
+    double search_ms = 0.0;
+    double shutdown_ms = 0.0;
+    double restart_ms = 0.0;
+    double rss_base_mb = 0.0;
+    double rss_init_mb = 0.0;
+    double rss_loaded_mb = 0.0;
+    double rss_peak_mb = 0.0;
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Nearest rank, as the frame profiler reports
+double rank(std::vector<double> samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(samples.size())));
+    return samples[std::min(samples.size(), std::max<size_t>(index, 1)) - 1];
+}
+
+double residentMb(double& peak) {
+    const double mb = static_cast<double>(AutoVibez::Utils::MetricsRegistry::getResidentBytes()) / (1024.0 * 1024.0);
+    peak = std::max(peak, mb);
+    return mb;
+}
+
+// A few silent MPEG-1 Layer III frames behind an ID3v2 tag, enough to pass the startup probe
+void writeCachedFile(const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const unsigned char tag[10] = {'I', 'D', '3', 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    file.write(reinterpret_cast<const char*>(tag), sizeof(tag));
+    std::string frame(417, '\0');  // 144 * 128000 / 44100 bytes, unpadded
+    frame[0] = static_cast<char>(0xFF);
+    frame[1] = static_cast<char>(0xFB);
+    frame[2] = static_cast<char>(0x90);
+    frame[3] = static_cast<char>(0x44);
+    for (int i = 0; i < 8; ++i) {
+        file.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    }
+}
+
+// Startup as the app runs it: open the library, load the manifest, apply what changed since last time
+std::unique_ptr<MixManager> startManager(const AutoVibez::Utils::CancellationToken& shutdown,
+                                         const std::string& manifest, ScaleResult* result, double& peak) {
+    auto manager = std::make_unique<MixManager>(PathManager::getDatabasePath(), PathManager::getMixesDirectory());
+    manager->setCancellationToken(shutdown);
+    auto start = Clock::now();
+    if (!manager->initialize()) {
+        std::fprintf(stderr, "initialize: %s\n", manager->getLastError().c_str());
+        return nullptr;
+    }
+    if (result) {
+        result->init_ms = msSince(start);
+        result->rss_init_mb = residentMb(peak);
+    }
+
+    start = Clock::now();
+    if (!manager->loadMixMetadata(manifest)) {
+        std::fprintf(stderr, "loadMixMetadata: %s\n", manager->getLastError().c_str());
+        return nullptr;
+    }
+    if (result) {
+        result->manifest_ms = msSince(start);
+    }
+    start = Clock::now();
+    if (!manager->checkForNewMixes(manifest)) {
+        std::fprintf(stderr, "checkForNewMixes: %s\n", manager->getLastError().c_str());
+        return nullptr;
+    }
+    if (result) {
+        result->diff_ms = msSince(start);
+        result->rss_loaded_mb = residentMb(peak);
+    }
+    return manager;
+}
+
+bool runSize(const Settings& settings, ScaleResult& result) {
+    const std::filesystem::path root =
+        std::filesystem::temp_directory_path() / ("autovibez_scale_" + std::to_string(settings.child_mixes));
+    std::filesystem::remove_all(root);
+    PathManager::setDirectories({(root / "config").string(), (root / "assets").string(), (root / "data").string(),
+                                 (root / "cache").string(), (root / "state").string()});
+    const std::string manifest = (root / "manifest.yaml").string();
+    result.mixes = settings.child_mixes;
+
+    // Last run's manifest and the library it left behind, then the manifest as published since
+    {
+        SyntheticLibraryOptions options;
+        options.mixes = settings.child_mixes;
+        const SyntheticLibrary generator(options);
+        const std::vector<Mix> previous = generator.generateManifest();
+        const std::vector<Mix> library = generator.generateLibrary(previous, PathManager::getMixesDirectory());
+        if (!SyntheticLibrary::writeManifest(generator.evolveManifest(previous, settings.changed_percent / 100.0),
+                                             manifest)) {
+            std::fprintf(stderr, "Could not write %s\n", manifest.c_str());
+            return false;
+        }
+        PathManager::ensureDirectoryExists(PathManager::getMixesDirectory());
+        for (const Mix& mix : library) {
+            if (!mix.local_path.empty()) {
+                writeCachedFile(mix.local_path);
+            }
+        }
+        result.library = static_cast<int>(library.size());
+
+        const auto start = Clock::now();
+        MixDatabase database(PathManager::getDatabasePath());
+        MixIngestStats stats;
+        if (!database.initialize() || !database.ingestManifest(ManifestDiff::compute(previous, {}), stats) ||
+            !database.ingestMixes(library, {}, stats)) {
+            std::fprintf(stderr, "Seeding the library failed: %s\n", database.getLastError().c_str());
+            return false;
+        }
+        result.seed_s = msSince(start) / 1000.0;
+    }
+
+    double peak = 0.0;
+    result.rss_base_mb = residentMb(peak);
+    AutoVibez::Utils::CancellationToken shutdown;
+    std::unique_ptr<MixManager> manager = startManager(shutdown, manifest, &result, peak);
+    if (!manager) {
+        return false;
+    }
+
+    auto start = Clock::now();
+    const std::vector<std::string> genres = manager->getAvailableGenres();
+    result.genres_ms = msSince(start);
+    const std::string genre = genres.empty() ? "" : genres.front();
+
+    std::vector<double> picks;
+    std::vector<double> available;
+    std::string previous;
+    for (int i = 0; i < settings.picks; ++i) {
+        start = Clock::now();
+        previous = manager->getSmartRandomMix(previous, genre).id;
+        picks.push_back(msSince(start));
+        start = Clock::now();
+        manager->getRandomAvailableMixByGenre(genre, previous);
+        available.push_back(msSince(start));
+    }
+    result.pick_p50_ms = rank(picks, 0.50);
+    result.pick_p99_ms = rank(picks, 0.99);
+    result.available_p50_ms = rank(available, 0.50);
+    result.available_p99_ms = rank(available, 0.99);
+
+    const int searches = 10;
+    start = Clock::now();
+    for (int i = 0; i < searches; ++i) {
+        manager->searchMixes("warehouse");
+    }
+    result.search_ms = msSince(start) / searches;
+    residentMb(peak);
+
+    start = Clock::now();
+    shutdown.cancel();
+    manager.reset();
+    result.shutdown_ms = msSince(start);
+
+    // Second start over the same files: the manifest snapshot is warm and the diff is empty
+    AutoVibez::Utils::CancellationToken restart_shutdown;
+    start = Clock::now();
+    manager = startManager(restart_shutdown, manifest, nullptr, peak);
+    if (!manager) {
+        return false;
+    }
+    result.restart_ms = msSince(start);
+    restart_shutdown.cancel();
+    manager.reset();
+    result.rss_peak_mb = peak;
+
+    std::filesystem::remove_all(root);
+    return true;
+}
+
+void writeResult(const ScaleResult& r, std::ostream& out) {
+    out << r.mixes << ' ' << r.library << ' ' << r.seed_s << ' ' << r.init_ms << ' ' << r.manifest_ms << ' '
+        << r.diff_ms << ' ' << r.genres_ms << ' ' << r.pick_p50_ms << ' ' << r.pick_p99_ms << ' '
+        << r.available_p50_ms << ' ' << r.available_p99_ms << ' ' << r.search_ms << ' ' << r.shutdown_ms << ' '
+        << r.restart_ms << ' ' << r.rss_base_mb << ' ' << r.rss_init_mb << ' ' << r.rss_loaded_mb << ' '
+        << r.rss_peak_mb << '\n';
+}
+
+bool readResult(std::istream& in, ScaleResult& r) {
+    return static_cast<bool>(in >> r.mixes >> r.library >> r.seed_s >> r.init_ms >> r.manifest_ms >> r.diff_ms >>
+                             r.genres_ms >> r.pick_p50_ms >> r.pick_p99_ms >> r.available_p50_ms >>
+                             r.available_p99_ms >> r.search_ms >> r.shutdown_ms >> r.restart_ms >> r.rss_base_mb >>
+                             r.rss_init_mb >> r.rss_loaded_mb >> r.rss_peak_mb);
+}
+
+bool writeJson(const std::vector<ScaleResult>& results, const Settings& settings, const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    out << "{\n  \"changed_percent\": " << settings.changed_percent << ",\n  \"picks\": " << settings.picks
+        << ",\n  \"sizes\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const ScaleResult& r = results[i];
+        out << "    {\"mixes\": " << r.mixes << ", \"library\": " << r.library << ", \"seed_s\": " << r.seed_s
+            << ", \"init_ms\": " << r.init_ms << ", \"manifest_ms\": " << r.manifest_ms
+            << ", \"diff_ms\": " << r.diff_ms << ", \"genres_ms\": " << r.genres_ms
+            << ", \"pick_p50_ms\": " << r.pick_p50_ms << ", \"pick_p99_ms\": " << r.pick_p99_ms
+            << ", \"available_p50_ms\": " << r.available_p50_ms << ", \"available_p99_ms\": " << r.available_p99_ms
+            << ", \"search_ms\": " << r.search_ms << ", \"shutdown_ms\": " << r.shutdown_ms
+            << ", \"restart_ms\": " << r.restart_ms << ", \"rss_base_mb\": " << r.rss_base_mb
+            << ", \"rss_init_mb\": " << r.rss_init_mb << ", \"rss_loaded_mb\": " << r.rss_loaded_mb
+            << ", \"rss_peak_mb\": " << r.rss_peak_mb << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out.flush());
+}
+
+bool parseSizes(const std::string& text, std::vector<int>& sizes) {
+    sizes.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const int size = std::atoi(item.c_str());
+        if (size <= 0) {
+            return false;
+        }
+        sizes.push_back(size);
+    }
+    return !sizes.empty();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    bool valid = true;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--sizes") {
+            valid = parseSizes(value, settings.sizes) && valid;
+        } else if (arg == "--changed") {
+            settings.changed_percent = std::atof(value.c_str());
+        } else if (arg == "--picks") {
+            settings.picks = std::atoi(value.c_str());
+        } else if (arg == "--json") {
+            settings.json = value;
+        } else if (arg == "--child-mixes") {
+            settings.child_mixes = std::atoi(value.c_str());
+        } else if (arg == "--child-out") {
+            settings.child_out = value;
+        }
+    }
+    if (!valid || settings.picks <= 0 || settings.changed_percent < 0.0 || settings.changed_percent > 100.0) {
+        std::fprintf(stderr,
+                     "Usage: autovibez_scale_bench [--sizes N,N,...] [--changed PERCENT] [--picks N] [--json PATH]\n");
+        return 2;
+    }
+
+    if (settings.child_mixes > 0) {
+        ScaleResult result;
+        if (!runSize(settings, result)) {
+            return 1;
+        }
+        std::ofstream out(settings.child_out, std::ios::trunc);
+        writeResult(result, out);
+        return out ? 0 : 1;
+    }
+
+    std::vector<ScaleResult> results;
+    const std::string out = (std::filesystem::temp_directory_path() / "autovibez_scale_result.txt").string();
+    for (int size : settings.sizes) {
+        std::printf("Running %d mixes...\n", size);
+        std::fflush(stdout);
+        const std::string command = "\"" + std::string(argv[0]) + "\" --child-mixes " + std::to_string(size) +
+                                    " --child-out \"" + out + "\" --changed " +
+                                    std::to_string(settings.changed_percent) + " --picks " +
+                                    std::to_string(settings.picks);
+        std::filesystem::remove(out);
+        ScaleResult result;
+        std::ifstream in;
+        if (std::system(command.c_str()) != 0 || (in.open(out), !readResult(in, result))) {
+            std::fprintf(stderr, "%d mixes: run failed, larger sizes skipped\n", size);
+            break;
+        }
+        results.push_back(result);
+    }
+    std::filesystem::remove(out);
+
+    std::printf("\n%9s %8s %7s %9s %9s %8s %8s %17s %17s %8s %9s %9s %13s\n", "mixes", "library", "seed s", "init ms",
+                "load ms", "diff ms", "genre ms", "pick p50/p99 ms", "avail p50/p99 ms", "find ms", "stop ms",
+                "restart", "rss MB i/l/pk");
+    for (const ScaleResult& r : results) {
+        std::printf("%9d %8d %7.1f %9.1f %9.1f %8.1f %8.3f %8.3f/%8.3f %8.3f/%8.3f %8.2f %9.1f %9.1f "
+                    "%4.0f/%4.0f/%4.0f\n",
+                    r.mixes, r.library, r.seed_s, r.init_ms, r.manifest_ms, r.diff_ms, r.genres_ms, r.pick_p50_ms,
+                    r.pick_p99_ms, r.available_p50_ms, r.available_p99_ms, r.search_ms, r.shutdown_ms, r.restart_ms,
+                    r.rss_init_mb - r.rss_base_mb, r.rss_loaded_mb - r.rss_base_mb, r.rss_peak_mb - r.rss_base_mb);
+    }
+    if (!settings.json.empty() && !writeJson(results, settings, settings.json)) {
+        std::fprintf(stderr, "Could not write %s\n", settings.json.c_str());
+        return 1;
+    }
+    return results.size() == settings.sizes.size() ? 0 : 1;
+}
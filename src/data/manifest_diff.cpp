@@ -0,0 +1,66 @@
+#include "manifest_diff.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+constexpr unsigned char FIELD_SEPARATOR = 0x1F;  // Keeps "ab" + "c" apart from "a" + "bc"
+
+void mix(uint64_t& hash, const std::string& field) {
+    for (unsigned char c : field) {
+        hash = (hash ^ c) * FNV_PRIME;
+    }
+    hash = (hash ^ FIELD_SEPARATOR) * FNV_PRIME;
+}
+}  // namespace
+
+uint64_t ManifestDiff::hashEntry(const Mix& entry) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    mix(hash, entry.id);
+    mix(hash, entry.url);
+    mix(hash, entry.original_filename);
+    mix(hash, entry.title);
+    mix(hash, entry.artist);
+    mix(hash, entry.genre);
+    mix(hash, entry.description);
+    mix(hash, std::to_string(entry.duration_seconds));
+    for (const std::string& tag : entry.tags) {
+        mix(hash, tag);
+    }
+    return hash;
+}
+
+ManifestDiff ManifestDiff::compute(const std::vector<Mix>& manifest,
+                                   const std::unordered_map<std::string, uint64_t>& stored) {
+    ManifestDiff diff;
+    std::unordered_set<std::string> listed;
+    listed.reserve(manifest.size());
+    for (const Mix& entry : manifest) {
+        if (!listed.insert(entry.id).second) {
+            continue;
+        }
+        auto it = stored.find(entry.id);
+        if (it == stored.end()) {
+            diff.added.push_back(entry);
+        } else if (it->second != hashEntry(entry)) {
+            diff.updated.push_back(entry);
+        }
+    }
+
+    // Nothing left to look for once every stored id was matched
+    if (listed.size() - diff.added.size() < stored.size()) {
+        for (const auto& entry : stored) {
+            if (!listed.count(entry.first)) {
+                diff.removed.push_back(entry.first);
+            }
+        }
+        std::sort(diff.removed.begin(), diff.removed.end());
+    }
+    return diff;
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief How a manifest differs from the one whose entry hashes the database keeps
+ *
+ * Each entry is reduced to one 64-bit hash of its id, URL and metadata, so telling an
+ * unchanged manifest from a changed one costs a hash and a map lookup per entry.
+ * The hashes are stable across runs and builds: a change to hashEntry needs a
+ * migration that clears the stored ones.
+ */
+struct ManifestDiff {
+    std::vector<Mix> added;            // Ids the stored hashes lack
+    std::vector<Mix> updated;          // Same id, other URL or metadata
+    std::vector<std::string> removed;  // Stored ids the manifest no longer lists
+
+    bool empty() const {
+        return added.empty() && updated.empty() && removed.empty();
+    }
+
+    /**
+     * @brief Entry hash over what the manifest says about a mix, not what the library adds to it
+     */
+    static uint64_t hashEntry(const Mix& mix);
+
+    /**
+     * @brief Sort a manifest against the stored entry hashes; a repeated id counts once
+     */
+    static ManifestDiff compute(const std::vector<Mix>& manifest,
+                                const std::unordered_map<std::string, uint64_t>& stored);
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,310 @@
+#include "manifest_snapshot.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr char MAGIC[8] = {'A', 'V', 'M', 'A', 'N', 'I', 'F', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t EMPTY_BUCKET = 0xFFFFFFFF;
+
+// FNV-1a; the stored bucket layout depends on it, so a change needs a new VERSION
+uint64_t hashId(std::string_view id) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : id) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+size_t alignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+}  // namespace
+
+struct ManifestSnapshot::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t mix_count;
+    uint32_t tag_count;
+    uint32_t bucket_count;  // A power of two, at least twice mix_count
+    uint32_t reserved;
+    uint64_t records_offset;
+    uint64_t tags_offset;
+    uint64_t buckets_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    StringRef source;
+    StringRef stamp;
+};
+
+struct ManifestSnapshot::Record {
+    enum Field { Id, Url, OriginalFilename, Title, Artist, Genre, Description, FIELD_COUNT };
+
+    StringRef fields[FIELD_COUNT];
+    int32_t duration_seconds;
+    uint32_t first_tag;  // Into the tag references
+    uint32_t tag_count;
+    uint32_t reserved;
+};
+
+bool ManifestSnapshot::write(const std::string& path, const std::vector<Mix>& mixes, const std::string& source,
+                             const std::string& stamp) {
+    static_assert(std::is_trivially_copyable<Header>::value && std::is_trivially_copyable<Record>::value,
+                  "snapshot structs are copied as bytes");
+
+    // Genres and artists repeat across the manifest, so each distinct string is stored once
+    std::string strings;
+    std::unordered_map<std::string, StringRef> interned;
+    auto intern = [&](const std::string& value) {
+        auto it = interned.find(value);
+        if (it != interned.end()) {
+            return it->second;
+        }
+        const StringRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+        strings += value;
+        interned.emplace(value, ref);
+        return ref;
+    };
+
+    std::vector<Record> records;
+    std::vector<StringRef> tags;
+    records.reserve(mixes.size());
+    for (const Mix& mix : mixes) {
+        Record record{};
+        record.fields[Record::Id] = intern(mix.id);
+        record.fields[Record::Url] = intern(mix.url);
+        record.fields[Record::OriginalFilename] = intern(mix.original_filename);
+        record.fields[Record::Title] = intern(mix.title);
+        record.fields[Record::Artist] = intern(mix.artist);
+        record.fields[Record::Genre] = intern(mix.genre);
+        record.fields[Record::Description] = intern(mix.description);
+        record.duration_seconds = mix.duration_seconds;
+        record.first_tag = static_cast<uint32_t>(tags.size());
+        record.tag_count = static_cast<uint32_t>(mix.tags.size());
+        for (const std::string& tag : mix.tags) {
+            tags.push_back(intern(tag));
+        }
+        records.push_back(record);
+    }
+
+    uint32_t bucket_count = 1;
+    while (bucket_count < records.size() * 2) {
+        bucket_count <<= 1;
+    }
+    std::vector<uint32_t> buckets(bucket_count, EMPTY_BUCKET);
+    for (uint32_t index = 0; index < records.size(); ++index) {
+        const std::string& id = mixes[index].id;
+        for (uint64_t slot = hashId(id);; ++slot) {
+            uint32_t& bucket = buckets[slot & (bucket_count - 1)];
+            if (bucket == EMPTY_BUCKET) {
+                bucket = index;
+                break;
+            }
+            if (mixes[bucket].id == id) {
+                break;  // A repeated id keeps its first mix
+            }
+        }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.mix_count = static_cast<uint32_t>(records.size());
+    header.tag_count = static_cast<uint32_t>(tags.size());
+    header.bucket_count = bucket_count;
+    header.source = intern(source);
+    header.stamp = intern(stamp);
+    header.records_offset = alignUp(sizeof(Header));
+    header.tags_offset = alignUp(header.records_offset + records.size() * sizeof(Record));
+    header.buckets_offset = alignUp(header.tags_offset + tags.size() * sizeof(StringRef));
+    header.strings_offset = alignUp(header.buckets_offset + buckets.size() * sizeof(uint32_t));
+    header.strings_size = strings.size();
+
+    std::string image(header.strings_offset + strings.size(), '\0');
+    auto place = [&image](uint64_t offset, const void* data, size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(&image[offset], data, bytes);
+        }
+    };
+    place(0, &header, sizeof(header));
+    place(header.records_offset, records.data(), records.size() * sizeof(Record));
+    place(header.tags_offset, tags.data(), tags.size() * sizeof(StringRef));
+    place(header.buckets_offset, buckets.data(), buckets.size() * sizeof(uint32_t));
+    place(header.strings_offset, strings.data(), strings.size());
+
+    std::error_code error;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Written beside the target and renamed so a reader never maps half a snapshot
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(image.data(), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+bool ManifestSnapshot::open(const std::string& path) {
+    close();
+    clearError();
+    if (!file_.open(path)) {
+        setError(file_.getLastError());
+        return false;
+    }
+
+    auto reject = [this](const std::string& reason) {
+        setError("Invalid manifest snapshot: " + reason);
+        file_.close();
+        return false;
+    };
+    const uint64_t size = file_.size();
+    if (size < sizeof(Header)) {
+        return reject("too short");
+    }
+    const Header* head = header();
+    if (std::memcmp(head->magic, MAGIC, sizeof(MAGIC)) != 0 || head->byte_order != BYTE_ORDER_MARK) {
+        return reject("not a snapshot of this machine's format");
+    }
+    if (head->version != VERSION) {
+        return reject("version " + std::to_string(head->version));
+    }
+
+    // Every section inside the file and aligned for in-place reads; offsets first, so the sums can't wrap
+    const bool sections_fit =
+        head->records_offset <= size && head->tags_offset <= size && head->buckets_offset <= size &&
+        head->records_offset % 8 == 0 && head->tags_offset % 8 == 0 && head->buckets_offset % 8 == 0 &&
+        head->records_offset + uint64_t{head->mix_count} * sizeof(Record) <= size &&
+        head->tags_offset + uint64_t{head->tag_count} * sizeof(StringRef) <= size &&
+        head->buckets_offset + uint64_t{head->bucket_count} * sizeof(uint32_t) <= size &&
+        head->strings_offset <= size && head->strings_size <= size - head->strings_offset;
+    const bool buckets_sized = head->bucket_count != 0 && (head->bucket_count & (head->bucket_count - 1)) == 0 &&
+                               head->bucket_count >= uint64_t{head->mix_count} * 2;
+    if (!sections_fit || !buckets_sized || !validRef(head->source) || !validRef(head->stamp)) {
+        return reject("damaged header");
+    }
+
+    // Checked once here, so readers index without checks
+    const auto* tags = reinterpret_cast<const StringRef*>(file_.data() + head->tags_offset);
+    for (uint32_t i = 0; i < head->tag_count; ++i) {
+        if (!validRef(tags[i])) {
+            return reject("damaged tag");
+        }
+    }
+    const Record* all = records();
+    for (uint32_t i = 0; i < head->mix_count; ++i) {
+        const Record& record = all[i];
+        for (const StringRef& field : record.fields) {
+            if (!validRef(field)) {
+                return reject("damaged mix");
+            }
+        }
+        if (uint64_t{record.first_tag} + record.tag_count > head->tag_count) {
+            return reject("damaged mix");
+        }
+    }
+    const auto* buckets = reinterpret_cast<const uint32_t*>(file_.data() + head->buckets_offset);
+    for (uint32_t i = 0; i < head->bucket_count; ++i) {
+        if (buckets[i] != EMPTY_BUCKET && buckets[i] >= head->mix_count) {
+            return reject("damaged index");
+        }
+    }
+    return true;
+}
+
+void ManifestSnapshot::close() {
+    file_.close();
+}
+
+bool ManifestSnapshot::matches(const std::string& source, const std::string& stamp) const {
+    return isOpen() && text(header()->source) == source && text(header()->stamp) == stamp;
+}
+
+size_t ManifestSnapshot::size() const {
+    return isOpen() ? header()->mix_count : 0;
+}
+
+Mix ManifestSnapshot::mixAt(size_t index) const {
+    const Record& record = records()[index];
+    Mix mix;
+    mix.id = std::string(text(record.fields[Record::Id]));
+    mix.url = std::string(text(record.fields[Record::Url]));
+    mix.original_filename = std::string(text(record.fields[Record::OriginalFilename]));
+    mix.title = std::string(text(record.fields[Record::Title]));
+    mix.artist = std::string(text(record.fields[Record::Artist]));
+    mix.genre = std::string(text(record.fields[Record::Genre]));
+    mix.description = std::string(text(record.fields[Record::Description]));
+    mix.duration_seconds = record.duration_seconds;
+    const auto* tags = reinterpret_cast<const StringRef*>(file_.data() + header()->tags_offset);
+    mix.tags.reserve(record.tag_count);
+    for (uint32_t i = 0; i < record.tag_count; ++i) {
+        mix.tags.emplace_back(text(tags[record.first_tag + i]));
+    }
+    return mix;
+}
+
+bool ManifestSnapshot::find(std::string_view id, Mix& mix) const {
+    if (!isOpen()) {
+        return false;
+    }
+    const Header* head = header();
+    const auto* buckets = reinterpret_cast<const uint32_t*>(file_.data() + head->buckets_offset);
+    const uint64_t mask = head->bucket_count - 1;
+    uint64_t slot = hashId(id);
+    for (uint32_t probes = 0; probes < head->bucket_count; ++probes, ++slot) {
+        const uint32_t index = buckets[slot & mask];
+        if (index == EMPTY_BUCKET) {
+            return false;
+        }
+        if (text(records()[index].fields[Record::Id]) == id) {
+            mix = mixAt(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Mix> ManifestSnapshot::toMixes() const {
+    std::vector<Mix> mixes;
+    mixes.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        mixes.push_back(mixAt(i));
+    }
+    return mixes;
+}
+
+const ManifestSnapshot::Header* ManifestSnapshot::header() const {
+    return reinterpret_cast<const Header*>(file_.data());
+}
+
+const ManifestSnapshot::Record* ManifestSnapshot::records() const {
+    return reinterpret_cast<const Record*>(file_.data() + header()->records_offset);
+}
+
+std::string_view ManifestSnapshot::text(const StringRef& ref) const {
+    return std::string_view(reinterpret_cast<const char*>(file_.data() + header()->strings_offset) + ref.offset,
+                            ref.length);
+}
+
+bool ManifestSnapshot::validRef(const StringRef& ref) const {
+    return uint64_t{ref.offset} + ref.length <= header()->strings_size;
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "error_handler.hpp"
+#include "mapped_file.hpp"
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief A parsed mixes manifest compiled to a flat binary file, read in place through a mapping
+ *
+ * The file is a header, fixed-size mix records, tag references, an open-addressing
+ * hash table of ids and one string table; every string is an offset and length into
+ * the table. Loading is a mapping and a bounds check, with no parsing. The header
+ * names the source the snapshot was compiled from and a stamp of that source (size
+ * and mtime of a file, or a server's validators), so a changed source is noticed
+ * and compiled again. Written in the host's byte order; the version and a byte
+ * order mark reject any other file.
+ */
+class ManifestSnapshot : public AutoVibez::Utils::ErrorHandler {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    ManifestSnapshot() = default;
+
+    ManifestSnapshot(const ManifestSnapshot&) = delete;
+    ManifestSnapshot& operator=(const ManifestSnapshot&) = delete;
+
+    /**
+     * @brief Compile mixes to a snapshot file, replacing it only once the whole file is written
+     * @param source Path or URL the mixes were parsed from
+     * @param stamp What identifies this version of the source
+     * @return True if successful, false otherwise
+     */
+    static bool write(const std::string& path, const std::vector<Mix>& mixes, const std::string& source,
+                      const std::string& stamp);
+
+    /**
+     * @brief Map a snapshot and check that every offset in it stays inside the file
+     * @return False if the file is missing, of another version, or damaged
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    bool isOpen() const {
+        return file_.isOpen();
+    }
+
+    /**
+     * @brief Whether the snapshot was compiled from this version of this source
+     */
+    bool matches(const std::string& source, const std::string& stamp) const;
+
+    size_t size() const;
+
+    Mix mixAt(size_t index) const;
+
+    /**
+     * @return False if no mix has the id
+     */
+    bool find(std::string_view id, Mix& mix) const;
+
+    /**
+     * @brief Every mix, in manifest order
+     */
+    std::vector<Mix> toMixes() const;
+
+private:
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Header;
+    struct Record;
+
+    const Header* header() const;
+    const Record* records() const;
+    std::string_view text(const StringRef& ref) const;
+    bool validRef(const StringRef& ref) const;
+
+    AutoVibez::Utils::MappedFile file_;
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,187 @@
+#include "mix_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+
+#include "console_output.hpp"
+#include "constants.hpp"
+#include "datetime_utils.hpp"
+#include "opus_transcoder.hpp"
+
+using AutoVibez::Audio::OpusTranscoder;
+using AutoVibez::Utils::DateTimeUtils;
+
+namespace AutoVibez::Data {
+
+namespace {
+// Sized as the cache records it: the file's bytes plus its transcoded copy's, last written at cached_ms;
+// a missing file counts as empty
+CachedMixFile sizeFile(const std::string& mix_id, const std::string& local_path) {
+    CachedMixFile file;
+    file.mix_id = mix_id;
+    file.local_path = local_path;
+    file.cached_ms = DateTimeUtils::nowEpochMs();
+
+    std::error_code error;
+    const auto bytes = std::filesystem::file_size(local_path, error);
+    if (error) {
+        return file;
+    }
+    file.bytes = static_cast<int64_t>(bytes);
+    const auto written = std::filesystem::last_write_time(local_path, error);
+    if (!error) {
+        const auto age = std::filesystem::file_time_type::clock::now() - written;
+        file.cached_ms -= std::chrono::duration_cast<std::chrono::milliseconds>(age).count();
+    }
+    const auto copy_bytes = std::filesystem::file_size(OpusTranscoder::getCopyPath(local_path), error);
+    if (!error) {
+        file.bytes += static_cast<int64_t>(copy_bytes);
+    }
+    return file;
+}
+}  // namespace
+
+MixCache::MixCache(MixDatabase& database) : database_(database) {}
+
+MixCache::~MixCache() {
+    stop();
+}
+
+void MixCache::setQuota(int64_t bytes) {
+    quota_ = std::max<int64_t>(bytes, 0);
+    wake();
+}
+
+void MixCache::setEvictedCallback(EvictedCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    evicted_ = std::move(callback);
+}
+
+void MixCache::setProtected(const std::vector<std::string>& mix_ids) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        protected_ = std::unordered_set<std::string>(mix_ids.begin(), mix_ids.end());
+    }
+    // What was protected may be what the cache was waiting to evict
+    wake();
+}
+
+bool MixCache::recordFile(const std::string& mix_id, const std::string& local_path) {
+    const CachedMixFile file = sizeFile(mix_id, local_path);
+    if (file.bytes == 0 || !database_.recordMixFiles({file})) {
+        return false;
+    }
+    wake();
+    return true;
+}
+
+int64_t MixCache::getUsedBytes() const {
+    int64_t bytes = 0;
+    int64_t files = 0;
+    database_.getMixCacheUsage(bytes, files);
+    return bytes;
+}
+
+size_t MixCache::backfillStep() {
+    std::vector<CachedMixFile> files = database_.getUnsizedMixFiles(Constants::MIX_CACHE_BACKFILL_BATCH);
+    for (CachedMixFile& file : files) {
+        file = sizeFile(file.mix_id, file.local_path);
+    }
+    if (files.empty() || !database_.recordMixFiles(files)) {
+        return 0;
+    }
+    return files.size();
+}
+
+size_t MixCache::trimStep() {
+    const int64_t quota = quota_.load();
+    int64_t used = 0;
+    int64_t files = 0;
+    if (quota == 0 || !database_.getMixCacheUsage(used, files) || used <= quota) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Enough candidates that the protected ones among them still leave a whole batch
+    const int limit = Constants::MIX_CACHE_EVICTION_BATCH + static_cast<int>(protected_.size());
+    size_t evicted = 0;
+    for (const CachedMixFile& file : database_.getEvictionCandidates(limit)) {
+        if (used <= quota || evicted == static_cast<size_t>(Constants::MIX_CACHE_EVICTION_BATCH)) {
+            break;
+        }
+        if (protected_.count(file.mix_id)) {
+            continue;
+        }
+
+        // A file already gone is only forgotten; one another mix shares stays for it
+        std::error_code error;
+        if (!file.local_path.empty() && !database_.isLocalPathShared(file.local_path, file.mix_id)) {
+            std::filesystem::remove(file.local_path, error);
+            if (!error) {
+                std::error_code copy_error;
+                std::filesystem::remove(OpusTranscoder::getCopyPath(file.local_path), copy_error);
+            }
+        }
+        if (error) {
+            AutoVibez::Utils::ConsoleOutput::warning("Could not evict " + file.local_path + ": " + error.message());
+            continue;
+        }
+        if (!database_.clearLocalPath(file.mix_id)) {
+            continue;
+        }
+        used -= file.bytes;
+        evicted++;
+        if (evicted_) {
+            evicted_(file);
+        }
+    }
+    return evicted;
+}
+
+void MixCache::wake() {
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        if (stopping_.load()) {
+            return;
+        }
+        woken_ = true;
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&MixCache::run, this);
+        }
+    }
+    wake_cv_.notify_one();
+}
+
+void MixCache::stop() {
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        stopping_ = true;
+    }
+    wake_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void MixCache::run() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(worker_mutex_);
+            wake_cv_.wait(lock, [this]() { return stopping_.load() || woken_; });
+            if (stopping_.load()) {
+                return;
+            }
+            woken_ = false;
+        }
+
+        // One batch at a time, so other writers get the database between them
+        while (!stopping_.load() && backfillStep() > 0) {
+        }
+        while (!stopping_.load() && trimStep() > 0) {
+        }
+    }
+}
+
+}  // namespace AutoVibez::Data
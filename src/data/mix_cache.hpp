@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "mix_database.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Holds the downloaded mix files to a disk quota by evicting the least valued ones
+ *
+ * The database keeps each file's size and their running total, so checking the quota
+ * is one row read rather than a walk of the mixes directory. Once the total is over the
+ * quota, files go in MixDatabase::getEvictionCandidates order: deleted mixes first, then
+ * by last use with each play counting as a later use. Favorites and the protected mixes
+ * (the one playing and the next) are never evicted. An evicted mix stays in the library
+ * with no local path and is downloaded again when it is played or queued. A mix's
+ * transcoded copy (see OpusTranscoder) counts towards its file's size and goes with it.
+ *
+ * A worker thread, started on the first wake, sizes the files recorded before the cache
+ * existed and then evicts MIX_CACHE_EVICTION_BATCH files at a time, reading the total
+ * again between batches, until the cache fits. A file that can't be removed is
+ * reported and left. A file shared by mixes with the same content counts once for
+ * each of them and is removed with the last. Thread-safe.
+ */
+class MixCache {
+public:
+    using EvictedCallback = std::function<void(const CachedMixFile& file)>;
+
+    explicit MixCache(MixDatabase& database);
+    ~MixCache();
+
+    MixCache(const MixCache&) = delete;
+    MixCache& operator=(const MixCache&) = delete;
+
+    /**
+     * @brief Bytes the mix files may take; 0 never evicts
+     */
+    void setQuota(int64_t bytes);
+    int64_t getQuota() const {
+        return quota_.load();
+    }
+
+    /**
+     * @brief Called on the worker thread after each file is evicted
+     */
+    void setEvictedCallback(EvictedCallback callback);
+
+    /**
+     * @brief Mixes that must stay, replacing the previous set
+     *
+     * Once this returns no eviction of them is in progress.
+     */
+    void setProtected(const std::vector<std::string>& mix_ids);
+
+    /**
+     * @brief Account for a file that was just downloaded, and evict if it took the cache over its quota
+     * @return False if the file could not be sized or recorded
+     */
+    bool recordFile(const std::string& mix_id, const std::string& local_path);
+
+    /**
+     * @brief The running total of the recorded files
+     */
+    int64_t getUsedBytes() const;
+
+    /**
+     * @brief Size the files recorded before the cache existed, at most one batch of them
+     * @return Files sized; 0 once every downloaded mix has a size
+     */
+    size_t backfillStep();
+
+    /**
+     * @brief Evict at most one batch of files while the cache is over its quota
+     * @return Files evicted; 0 when the cache fits or nothing more may go
+     */
+    size_t trimStep();
+
+    /**
+     * @brief Ask the worker to backfill and trim
+     */
+    void wake();
+
+    /**
+     * @brief Stop the worker, finishing the batch it is on; the steps can still be run by hand
+     */
+    void stop();
+
+private:
+    void run();
+
+    MixDatabase& database_;
+    std::atomic<int64_t> quota_{0};
+
+    // Held while a file is evicted, so the protected set can't change under it
+    std::mutex mutex_;
+    std::unordered_set<std::string> protected_;
+    EvictedCallback evicted_;
+
+    std::thread worker_;
+    std::mutex worker_mutex_;
+    std::condition_variable wake_cv_;
+    bool woken_ = false;
+    std::atomic<bool> stopping_{false};  // Also read by the worker between batches
+};
+
+}  // namespace AutoVibez::Data
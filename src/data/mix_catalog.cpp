@@ -0,0 +1,283 @@
+#include "mix_catalog.hpp"
+
+#include <algorithm>
+#include <set>
+
+#include "string_utils.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+bool titleOrder(const std::shared_ptr<const MixRecord>& a, const std::shared_ptr<const MixRecord>& b) {
+    return a->title() != b->title() ? a->title() < b->title() : a->id() < b->id();
+}
+
+// Buckets plus one node per element, as libstdc++ and libc++ lay them out (next pointer and cached hash)
+template <typename Map>
+size_t hashMapBytes(const Map& map) {
+    return map.bucket_count() * sizeof(void*) +
+           map.size() * (sizeof(typename Map::value_type) + sizeof(void*) + sizeof(size_t));
+}
+
+size_t heapBytes(const std::string& value) {
+    return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+}
+}  // namespace
+
+MixCatalogSnapshot::MixCatalogSnapshot(Entries entries, std::shared_ptr<const MixStringPool> strings)
+    : entries_(std::move(entries)), strings_(strings ? std::move(strings) : std::make_shared<const MixStringPool>()) {
+    // Genres repeat across thousands of rows, so each is lowered once
+    std::unordered_map<uint32_t, std::vector<uint32_t>*> genre_lists;
+    by_id_.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const MixRecord& record = *entries_[i];
+        const auto position = static_cast<uint32_t>(i);
+        by_id_.emplace(record.id(), position);
+        auto list = genre_lists.find(record.genre);
+        if (list == genre_lists.end()) {
+            const std::string key = ::AutoVibez::Utils::StringUtils::toLower(genreOf(record));
+            list = genre_lists.emplace(record.genre, &by_genre_[key]).first;
+        }
+        list->second->push_back(position);
+        by_artist_[record.artist].push_back(position);
+    }
+
+    std::set<std::string> genres;
+    for (const auto& [genre, list] : genre_lists) {
+        if (genre != 0) {
+            genres.insert(strings_->get(genre));
+        }
+    }
+    genres_.assign(genres.begin(), genres.end());
+    for (size_t i = 0; i < genres_.size(); ++i) {
+        genre_exact_.emplace(genres_[i], static_cast<uint32_t>(i));
+        genre_folded_.emplace(::AutoVibez::Utils::StringUtils::toLower(genres_[i]), static_cast<uint32_t>(i));
+    }
+    memory_.set(indexBytes());
+}
+
+size_t MixCatalogSnapshot::indexBytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entries::value_type) + hashMapBytes(by_id_) +
+                   hashMapBytes(by_genre_) + hashMapBytes(by_artist_) + hashMapBytes(genre_exact_) +
+                   hashMapBytes(genre_folded_) + genres_.capacity() * sizeof(std::string);
+    for (const auto& [genre, positions] : by_genre_) {
+        bytes += heapBytes(genre) + positions.capacity() * sizeof(uint32_t);
+    }
+    for (const auto& [artist, positions] : by_artist_) {
+        bytes += positions.capacity() * sizeof(uint32_t);
+    }
+    for (const std::string& genre : genres_) {
+        bytes += 3 * heapBytes(genre);  // The list, the exact key and the folded key
+    }
+    return bytes;
+}
+
+const MixRecord* MixCatalogSnapshot::findById(std::string_view id) const {
+    auto it = by_id_.find(id);
+    return it != by_id_.end() ? entries_[it->second].get() : nullptr;
+}
+
+bool MixCatalogSnapshot::positionOf(std::string_view id, uint32_t& position) const {
+    auto it = by_id_.find(id);
+    if (it == by_id_.end()) {
+        return false;
+    }
+    position = it->second;
+    return true;
+}
+
+const std::vector<uint32_t>& MixCatalogSnapshot::genrePositions(const std::string& genre) const {
+    static const std::vector<uint32_t> none;
+    auto it = by_genre_.find(::AutoVibez::Utils::StringUtils::toLower(genre));
+    return it != by_genre_.end() ? it->second : none;
+}
+
+bool MixCatalogSnapshot::genrePosition(const std::string& genre, size_t& position) const {
+    auto it = genre_exact_.find(genre);
+    if (it == genre_exact_.end()) {
+        it = genre_folded_.find(::AutoVibez::Utils::StringUtils::toLower(genre));
+        if (it == genre_folded_.end()) {
+            return false;
+        }
+    }
+    position = it->second;
+    return true;
+}
+
+const std::string* MixCatalogSnapshot::findGenre(const std::string& genre) const {
+    auto it = genre_folded_.find(::AutoVibez::Utils::StringUtils::toLower(genre));
+    return it != genre_folded_.end() ? &genres_[it->second] : nullptr;
+}
+
+std::vector<const MixRecord*> MixCatalogSnapshot::findByGenre(const std::string& genre) const {
+    return collect(&genrePositions(genre));
+}
+
+std::vector<const MixRecord*> MixCatalogSnapshot::findByArtist(const std::string& artist) const {
+    uint32_t id = 0;
+    if (!strings_->find(artist, id)) {
+        return {};
+    }
+    auto it = by_artist_.find(id);
+    return collect(it != by_artist_.end() ? &it->second : nullptr);
+}
+
+std::vector<Mix> MixCatalogSnapshot::toVector() const {
+    std::vector<Mix> mixes;
+    mixes.reserve(entries_.size());
+    for (const auto& record : entries_) {
+        mixes.push_back(toMix(*record));
+    }
+    return mixes;
+}
+
+std::vector<const MixRecord*> MixCatalogSnapshot::collect(const std::vector<uint32_t>* positions) const {
+    std::vector<const MixRecord*> records;
+    if (positions) {
+        records.reserve(positions->size());
+        for (uint32_t i : *positions) {
+            records.push_back(entries_[i].get());
+        }
+    }
+    return records;
+}
+
+MixCatalogBuilder::MixCatalogBuilder() : strings_(std::make_shared<MixStringPool>()) {}
+
+void MixCatalogBuilder::add(const Mix& mix) {
+    if (mix.is_deleted || mix.id.empty() || positions_.count(mix.id)) {
+        return;
+    }
+    strings_->internFields(mix);
+    records_.push_back(std::allocate_shared<MixRecord>(CatalogAllocator<MixRecord>(), mix, *strings_));
+    positions_.emplace(records_.back()->id(), static_cast<uint32_t>(records_.size() - 1));
+}
+
+void MixCatalogBuilder::addTag(std::string_view id, std::string_view tag) {
+    if (!tagged_ || tagged_->id() != id) {
+        auto it = positions_.find(id);
+        tagged_ = it != positions_.end() ? records_[it->second].get() : nullptr;
+    }
+    if (tagged_) {
+        tagged_->tags.push_back(strings_->intern(tag));
+    }
+}
+
+std::shared_ptr<const MixCatalogSnapshot> MixCatalogBuilder::build() {
+    MixCatalogSnapshot::Entries entries;
+    entries.reserve(records_.size());
+    for (std::shared_ptr<MixRecord>& record : records_) {
+        record->tags.shrink_to_fit();
+        entries.push_back(std::move(record));
+    }
+    std::sort(entries.begin(), entries.end(), titleOrder);
+    auto snapshot = std::make_shared<const MixCatalogSnapshot>(std::move(entries), std::move(strings_));
+
+    strings_ = std::make_shared<MixStringPool>();
+    records_.clear();
+    positions_.clear();
+    tagged_ = nullptr;
+    return snapshot;
+}
+
+MixCatalog::MixCatalog() : current_(std::make_shared<const MixCatalogSnapshot>(MixCatalogSnapshot::Entries())) {}
+
+void MixCatalog::load(const std::vector<Mix>& mixes) {
+    MixCatalogBuilder builder;
+    for (const Mix& mix : mixes) {
+        builder.add(mix);
+    }
+    load(builder);
+}
+
+void MixCatalog::load(MixCatalogBuilder& builder) {
+    load(builder.build());
+}
+
+void MixCatalog::load(Snapshot snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_ = std::move(snapshot);
+    }
+    notify({MixCatalogChange::Type::Loaded, ""});
+}
+
+void MixCatalog::put(const Mix& mix) {
+    if (mix.is_deleted) {
+        remove(mix.id);
+        return;
+    }
+
+    bool existed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Published snapshots read their pool, so new strings go into a copy
+        std::shared_ptr<const MixStringPool> strings = current_->strings();
+        if (!strings->hasFields(mix)) {
+            auto grown = std::make_shared<MixStringPool>(*strings);
+            grown->internFields(mix);
+            strings = std::move(grown);
+        }
+        std::shared_ptr<const MixRecord> added =
+            std::allocate_shared<MixRecord>(CatalogAllocator<MixRecord>(), mix, *strings);
+
+        MixCatalogSnapshot::Entries entries = current_->entries();
+        if (const MixRecord* old = current_->findById(mix.id)) {
+            existed = true;
+            entries.erase(std::find_if(entries.begin(), entries.end(), [old](const auto& entry) {
+                return entry.get() == old;
+            }));
+        }
+        entries.insert(std::lower_bound(entries.begin(), entries.end(), added, titleOrder), added);
+        current_ = std::make_shared<const MixCatalogSnapshot>(std::move(entries), std::move(strings));
+    }
+    notify({existed ? MixCatalogChange::Type::Updated : MixCatalogChange::Type::Added, mix.id});
+}
+
+void MixCatalog::remove(const std::string& id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const MixRecord* old = current_->findById(id);
+        if (!old) {
+            return;
+        }
+        MixCatalogSnapshot::Entries entries = current_->entries();
+        entries.erase(std::find_if(entries.begin(), entries.end(),
+                                   [old](const auto& entry) { return entry.get() == old; }));
+        current_ = std::make_shared<const MixCatalogSnapshot>(std::move(entries), current_->strings());
+    }
+    notify({MixCatalogChange::Type::Removed, id});
+}
+
+MixCatalog::Snapshot MixCatalog::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+int MixCatalog::subscribe(Listener listener) {
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    const int id = next_listener_id_++;
+    listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void MixCatalog::unsubscribe(int id) {
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                    [id](const std::pair<int, Listener>& entry) { return entry.first == id; }),
+                     listeners_.end());
+}
+
+void MixCatalog::notify(const MixCatalogChange& change) {
+    // Copied so a listener may subscribe or unsubscribe from its callback
+    std::vector<std::pair<int, Listener>> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        listeners = listeners_;
+    }
+    for (const auto& [id, listener] : listeners) {
+        listener(change);
+    }
+}
+
+}  // namespace AutoVibez::Data
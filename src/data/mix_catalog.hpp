@@ -0,0 +1,227 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mix_metadata.hpp"
+#include "mix_record.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief One immutable view of the library, ordered by title as SELECT_ALL_MIXES is
+ *
+ * Mixes are held as compact records and shared between snapshots, so a new
+ * snapshot after a write copies pointers rather than mixes; toMix builds a full
+ * Mix for callers that need one. Lookups by id, genre (case-insensitive, as the
+ * SQL NOCASE match) and artist (exact) go through hash indexes. The records count
+ * toward MemoryTag::Catalog through their allocator, the indexes through an
+ * estimate charged for as long as the snapshot lives.
+ */
+class MixCatalogSnapshot {
+public:
+    using Entries = std::vector<std::shared_ptr<const MixRecord>>;
+
+    /**
+     * @param entries Records sorted by title, then id
+     * @param strings Pool the records were built against (nullptr for an empty snapshot)
+     */
+    explicit MixCatalogSnapshot(Entries entries, std::shared_ptr<const MixStringPool> strings = nullptr);
+
+    const Entries& entries() const {
+        return entries_;
+    }
+
+    size_t size() const {
+        return entries_.size();
+    }
+
+    bool empty() const {
+        return entries_.empty();
+    }
+
+    const std::shared_ptr<const MixStringPool>& strings() const {
+        return strings_;
+    }
+
+    /**
+     * @return The record, or nullptr if the mix is not in the library
+     */
+    const MixRecord* findById(std::string_view id) const;
+
+    /**
+     * @return False if the mix is not in the library
+     */
+    bool positionOf(std::string_view id, uint32_t& position) const;
+
+    /**
+     * @brief Positions in entries() of the mixes of one genre, ascending, empty if there are none
+     */
+    const std::vector<uint32_t>& genrePositions(const std::string& genre) const;
+
+    std::vector<const MixRecord*> findByGenre(const std::string& genre) const;
+    std::vector<const MixRecord*> findByArtist(const std::string& artist) const;
+
+    Mix toMix(const MixRecord& record) const {
+        return record.toMix(*strings_);
+    }
+
+    const std::string& genreOf(const MixRecord& record) const {
+        return strings_->get(record.genre);
+    }
+
+    const std::string& artistOf(const MixRecord& record) const {
+        return strings_->get(record.artist);
+    }
+
+    /**
+     * @brief Distinct non-empty genres with their stored casing, sorted
+     */
+    const std::vector<std::string>& getGenres() const {
+        return genres_;
+    }
+
+    /**
+     * @brief Position of a genre in getGenres(), an exact match first, else the first spelled the same ignoring case
+     * @return False if no mix has the genre
+     */
+    bool genrePosition(const std::string& genre, size_t& position) const;
+
+    /**
+     * @brief The stored casing of a genre matched ignoring case, nullptr if no mix has it
+     */
+    const std::string* findGenre(const std::string& genre) const;
+
+    /**
+     * @brief Number of mixes of a genre, matched ignoring case
+     */
+    size_t genreCount(const std::string& genre) const {
+        return genrePositions(genre).size();
+    }
+
+    /**
+     * @brief Copy the mixes out, for callers that keep their own list
+     */
+    std::vector<Mix> toVector() const;
+
+private:
+    Entries entries_;
+    std::shared_ptr<const MixStringPool> strings_;
+    std::unordered_map<std::string_view, uint32_t> by_id_;  // Views into the shared records
+    std::unordered_map<std::string, std::vector<uint32_t>> by_genre_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> by_artist_;  // Keyed by pool id
+    std::vector<std::string> genres_;
+    std::unordered_map<std::string, uint32_t> genre_exact_;   // Into genres_
+    std::unordered_map<std::string, uint32_t> genre_folded_;  // Lowercased, into genres_ (first casing wins)
+    Utils::MemoryCharge memory_{Utils::MemoryTag::Catalog};
+
+    std::vector<const MixRecord*> collect(const std::vector<uint32_t>* positions) const;
+    size_t indexBytes() const;
+};
+
+/**
+ * @brief Builds a snapshot one row at a time, so a load never holds every Mix at once
+ */
+class MixCatalogBuilder {
+public:
+    MixCatalogBuilder();
+
+    /**
+     * @brief Add a mix; deleted ones, ones without an id and repeated ids are skipped
+     */
+    void add(const Mix& mix);
+
+    /**
+     * @brief Append a tag to a mix added before (unknown ids are ignored)
+     *
+     * Cheapest when the tags of one mix come together, as SELECT_ALL_MIX_TAGS orders them.
+     */
+    void addTag(std::string_view id, std::string_view tag);
+
+    size_t size() const {
+        return records_.size();
+    }
+
+    /**
+     * @brief Sort what was added by title and hand it over; the builder is left empty
+     */
+    std::shared_ptr<const MixCatalogSnapshot> build();
+
+private:
+    std::shared_ptr<MixStringPool> strings_;
+    std::vector<std::shared_ptr<MixRecord>> records_;
+    std::unordered_map<std::string_view, uint32_t> positions_;  // Views into the records
+    MixRecord* tagged_ = nullptr;                                // Mix of the last addTag
+};
+
+/**
+ * @brief What a catalog write did to one mix
+ */
+struct MixCatalogChange {
+    enum class Type { Loaded, Added, Updated, Removed };
+
+    Type type;
+    std::string id;  // Empty for Loaded
+};
+
+/**
+ * @brief Shared in-memory copy of the non-deleted mixes
+ *
+ * Loaded once from the database and kept coherent by its owner writing each
+ * changed row through. Readers take a snapshot, which stays valid and unchanged
+ * however long they hold it; a write publishes a new snapshot and then tells the
+ * listeners, outside the lock, on the writing thread.
+ */
+class MixCatalog {
+public:
+    using Snapshot = std::shared_ptr<const MixCatalogSnapshot>;
+    using Listener = std::function<void(const MixCatalogChange&)>;
+
+    MixCatalog();
+
+    /**
+     * @brief Replace the contents (deleted rows are skipped)
+     */
+    void load(const std::vector<Mix>& mixes);
+
+    /**
+     * @brief Replace the contents with what builder collected
+     */
+    void load(MixCatalogBuilder& builder);
+
+    /**
+     * @brief Replace the contents with a snapshot built elsewhere
+     */
+    void load(Snapshot snapshot);
+
+    /**
+     * @brief Insert or replace one mix; a deleted one is removed
+     */
+    void put(const Mix& mix);
+
+    void remove(const std::string& id);
+
+    Snapshot snapshot() const;
+
+    /**
+     * @return Id for unsubscribe
+     */
+    int subscribe(Listener listener);
+    void unsubscribe(int id);
+
+private:
+    mutable std::mutex mutex_;
+    Snapshot current_;
+    std::mutex listeners_mutex_;
+    std::vector<std::pair<int, Listener>> listeners_;
+    int next_listener_id_ = 1;
+
+    void notify(const MixCatalogChange& change);
+};
+
+}  // namespace AutoVibez::Data
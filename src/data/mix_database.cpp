@@ -1,18 +1,275 @@
 #include "mix_database.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <random>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "constants.hpp"
+#include "datetime_utils.hpp"
 #include "json_utils.hpp"
 #include "mix_query_builder.hpp"
+#include "mix_row_mapper.hpp"
 #include "path_manager.hpp"
+#include "schema_migrator.hpp"
 #include "sqlite_connection.hpp"
+#include "string_utils.hpp"
+#include "trace_recorder.hpp"
+#include "uuid_utils.hpp"
 
 namespace AutoVibez::Data {
 
-MixDatabase::MixDatabase(const std::string& db_path) : db_path_(db_path) {
-    connection_ = std::make_shared<SqliteConnection>(db_path);
+namespace {
+// Set while this thread merges in another instance's catalog, which is no write to report
+thread_local bool merging_shared = false;
+
+bool sameRecord(const MixRecord& a, const MixCatalogSnapshot& in_a, const MixRecord& b,
+                const MixCatalogSnapshot& in_b) {
+    if (a.text != b.text || a.ends != b.ends || a.date_added_ms != b.date_added_ms ||
+        a.last_played_ms != b.last_played_ms || a.loudness_lufs != b.loudness_lufs || a.peak_dbfs != b.peak_dbfs ||
+        a.bpm != b.bpm || a.spectral_centroid_hz != b.spectral_centroid_hz ||
+        a.duration_seconds != b.duration_seconds || a.play_count != b.play_count || a.is_favorite != b.is_favorite ||
+        a.has_analysis != b.has_analysis || a.tags.size() != b.tags.size()) {
+        return false;
+    }
+    // Pool ids differ between snapshots built apart, so the strings are compared
+    if (in_a.genreOf(a) != in_b.genreOf(b) || in_a.artistOf(a) != in_b.artistOf(b)) {
+        return false;
+    }
+    for (size_t i = 0; i < a.tags.size(); ++i) {
+        if (in_a.strings()->get(a.tags[i]) != in_b.strings()->get(b.tags[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// sync_state keys
+constexpr const char* SYNC_NODE_KEY = "node";
+constexpr const char* SYNC_CURSOR_KEY = "cursor";
+constexpr const char* SYNC_LAST_EVENT_KEY = "last_event";  // Rowid of the last play event sent
+
+// A random id in the UUID form, naming this library to the sync server
+std::string makeNodeId() {
+    std::random_device random;
+    AutoVibez::Utils::HashId id;
+    for (uint8_t& byte : id.bytes) {
+        byte = static_cast<uint8_t>(random());
+    }
+    return id.toString();
+}
+
+std::future<bool> readyFuture(bool value) {
+    std::promise<bool> promise;
+    promise.set_value(value);
+    return promise.get_future();
+}
+
+void bindPlayEvent(IStatement& stmt, const PlayEvent& event) {
+    stmt.bindText(1, event.mix_id);
+    stmt.bindInt64(2, event.ts_epoch_ms);
+    stmt.bindInt(3, event.duration_played);
+    stmt.bindInt(4, event.skipped ? 1 : 0);
+}
+
+// Columns in the order of SELECT_MIX_PLAY_STATS
+MixPlayStats readPlayStats(const IStatement& stmt) {
+    MixPlayStats stats;
+    stats.mix_id = MixRowMapper::readId(stmt, 0);
+    stats.plays = stmt.getInt(1);
+    stats.skips = stmt.getInt(2);
+    stats.skip_streak = stmt.getInt(3);
+    stats.played_seconds = stmt.getInt64(4);
+    stats.last_played_ms = stmt.getInt64(5);
+    return stats;
+}
+
+// Every word must appear in some field; a hit in the title counts most, as in SEARCH_MIXES' bm25 weights
+std::vector<Mix> searchCatalog(const MixCatalogSnapshot& snapshot, const std::string& query, int limit) {
+    using AutoVibez::Utils::StringUtils;
+    std::vector<std::string> words;
+    std::istringstream stream(StringUtils::toLower(query));
+    for (std::string word; stream >> word;) {
+        words.push_back(word);
+    }
+
+    const MixStringPool& strings = *snapshot.strings();
+    std::vector<std::pair<double, const MixRecord*>> scored;
+    for (const auto& record : snapshot.entries()) {
+        const std::string title = StringUtils::toLower(std::string(record->title()));
+        const std::string artist = StringUtils::toLower(strings.get(record->artist));
+        const std::string description = StringUtils::toLower(std::string(record->description()));
+        std::string tags;
+        for (uint32_t tag : record->tags) {
+            tags += StringUtils::toLower(strings.get(tag)) + ' ';
+        }
+
+        double score = 0.0;
+        for (const std::string& word : words) {
+            double best = 0.0;
+            if (title.find(word) != std::string::npos) {
+                best = Constants::SEARCH_WEIGHT_TITLE;
+            } else if (artist.find(word) != std::string::npos) {
+                best = Constants::SEARCH_WEIGHT_ARTIST;
+            } else if (tags.find(word) != std::string::npos) {
+                best = Constants::SEARCH_WEIGHT_TAGS;
+            } else if (description.find(word) != std::string::npos) {
+                best = Constants::SEARCH_WEIGHT_DESCRIPTION;
+            }
+            if (best == 0.0) {
+                score = 0.0;
+                break;
+            }
+            score += best;
+        }
+        if (score > 0.0) {
+            scored.emplace_back(score, record.get());
+        }
+    }
+
+    // Stable, so equal scores keep the catalog's title order
+    std::stable_sort(scored.begin(), scored.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<Mix> mixes;
+    for (size_t i = 0; i < scored.size() && i < static_cast<size_t>(limit); ++i) {
+        mixes.push_back(snapshot.toMix(*scored[i].second));
+    }
+    return mixes;
+}
+
+// The old hash wrote its 8 bytes twice, then set the version and variant bits; an id from a manifest has no such
+// repeat, bar a chance of one in 2^56
+bool madeByOldHash(const Utils::HashId& id) {
+    const auto& bytes = id.bytes;
+    for (size_t i = 1; i < 8; ++i) {
+        if (i != 6 && bytes[i + 8] != bytes[i]) {
+            return false;
+        }
+    }
+    return bytes[6] == ((bytes[14] & Constants::UUID_VERSION_MASK) | Constants::UUID_VERSION_5) &&
+           bytes[8] == ((bytes[0] & Constants::UUID_VARIANT_MASK) | Constants::UUID_VARIANT_1);
+}
+
+// MixDownloader finds files by id in its journal, so each re-keyed mix gets a line under its new id for the file
+// it had. Lines are only appended: should the migration roll back, the old ones still hold.
+bool remapFiles(const std::string& mappings_path, const std::vector<std::pair<std::string, std::string>>& keys,
+                const std::unordered_map<std::string, std::string>& local_paths) {
+    if (mappings_path.empty() || keys.empty()) {
+        return true;
+    }
+    std::unordered_map<std::string, std::string> filenames;
+    {
+        std::ifstream file(mappings_path);
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t pos = line.find(':');
+            if (pos != std::string::npos && pos + 1 < line.size()) {
+                filenames[line.substr(0, pos)] = line.substr(pos + 1);
+            }
+        }
+    }
+    std::string lines;
+    for (const auto& [old_id, new_id] : keys) {
+        auto it = filenames.find(old_id);
+        if (it != filenames.end()) {
+            lines += new_id + ":" + it->second + '\n';
+            continue;
+        }
+        // Not renamed, so the file was named for the old id; the row says where it is
+        auto path = local_paths.find(old_id);
+        if (path != local_paths.end()) {
+            lines += new_id + ":" + std::filesystem::path(path->second).filename().string() + '\n';
+        }
+    }
+    if (lines.empty()) {
+        return true;
+    }
+    std::ofstream mapping(mappings_path, std::ios::app);
+    mapping << lines;
+    return static_cast<bool>(mapping);
+}
+
+// See SELECT_MIX_KEYS
+bool rekeyHashIds(IDatabaseConnection& connection, const std::string& mappings_path) {
+    std::vector<std::pair<std::string, std::string>> keys;  // Old id, new id
+    std::unordered_map<std::string, std::string> local_paths;
+    {
+        auto select = connection.prepare(StringConstants::SELECT_MIX_KEYS);
+        if (!select) {
+            return false;
+        }
+        Utils::HashId id;
+        while (select->step()) {
+            // Packed already, or not in UUID form at all: kept as it is
+            if (!select->getBlobView(0).empty() || !Utils::HashId::parse(select->getTextView(0), id)) {
+                continue;
+            }
+            // One a manifest gave is only packed, or the next manifest would add the mix again under it
+            const std::string old_id(select->getTextView(0));
+            const std::string url(select->getTextView(1));
+            const bool rehash = madeByOldHash(id) && !url.empty();
+            keys.emplace_back(old_id, rehash ? Utils::HashIdUtils::generateIdFromUrl(url) : old_id);
+            if (!select->getTextView(2).empty()) {
+                local_paths.emplace(old_id, select->getTextView(2));
+            }
+        }
+    }
+
+    auto rekey = connection.prepare(StringConstants::REKEY_MIX);
+    auto drop = connection.prepare(StringConstants::DELETE_REKEYED_DUPLICATE);
+    std::vector<std::unique_ptr<IStatement>> references;
+    for (const char* sql : StringConstants::REKEY_MIX_REFERENCES) {
+        references.push_back(connection.prepare(sql));
+        if (!references.back()) {
+            return false;
+        }
+    }
+    if (!rekey || !drop) {
+        return false;
+    }
+
+    std::unordered_set<std::string> taken;
+    std::vector<std::pair<std::string, std::string>> moved;  // Those re-keyed rather than dropped
+    for (const auto& [old_id, new_id] : keys) {
+        if (!taken.insert(new_id).second) {
+            drop->reset();
+            drop->bindText(1, old_id);
+            if (!drop->execute()) {
+                return false;
+            }
+            continue;
+        }
+        rekey->reset();
+        rekey->bindText(1, old_id);
+        rekey->bindText(2, new_id);
+        if (!rekey->execute()) {
+            return false;
+        }
+        for (const auto& reference : references) {
+            reference->reset();
+            reference->bindText(1, old_id);
+            reference->bindText(2, new_id);
+            if (!reference->execute()) {
+                return false;
+            }
+        }
+        if (new_id != old_id) {
+            moved.emplace_back(old_id, new_id);
+        }
+    }
+    return connection.execute(StringConstants::CLEAR_MANIFEST_KEYED_TABLES) &&
+           remapFiles(mappings_path, moved, local_paths);
+}
+}  // namespace
+
+MixDatabase::MixDatabase(const std::string& db_path, const SqliteTuning& tuning)
+    : db_path_(db_path), query_stats_(tuning.query_stats) {
+    connection_ = std::make_shared<SqliteConnectionPool>(db_path, tuning);
     validator_ = std::make_unique<MixValidator>();
     // Smart selector will be created after connection is initialized
 }
@@ -22,9 +279,25 @@ MixDatabase::MixDatabase(std::shared_ptr<IDatabaseConnection> connection) : conn
     // Smart selector will be created after connection is initialized
 }
 
-MixDatabase::~MixDatabase() = default;
+MixDatabase::~MixDatabase() {
+    // SQLite asks for an optimize before closing; the writer is drained first so it runs last
+    if (writes_) {
+        writes_->flush();
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        connection_->execute(StringConstants::OPTIMIZE_DATABASE);
+    }
+    if (shared_listener_) {
+        catalog_->unsubscribe(shared_listener_);
+    }
+}
+
+void MixDatabase::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    ErrorHandler::setError(error);
+}
 
 bool MixDatabase::initialize() {
+    AUTOVIBEZ_TRACE_SCOPE("db", "initialize");
     if (!connection_->initialize()) {
         setError("Failed to initialize database: " + connection_->getLastError());
         return false;
@@ -35,25 +308,169 @@ bool MixDatabase::initialize() {
     }
 
     // Initialize smart selector now that connection is ready
-    selector_ = std::make_unique<SmartMixSelector>(connection_);
+    // In-memory views of the table; writes below keep them current
+    SmartSelectionConfig config;
+    config.similar_mix_probability = Constants::DEFAULT_SIMILAR_MIX_PROBABILITY;
+    catalog_ = std::make_shared<MixCatalog>();
+    index_ = std::make_shared<MixSelectionIndex>(config.prefer_unplayed, config.prefer_least_played);
+    similarity_ = std::make_shared<MixSimilarityIndex>();
+    // The catalog owns the listener, so the raw pointer lives as long as it is called
+    catalog_->subscribe([similarity = similarity_, catalog = catalog_.get()](const MixCatalogChange& change) {
+        const MixCatalog::Snapshot snapshot = catalog->snapshot();
+        if (change.type == MixCatalogChange::Type::Loaded) {
+            similarity->rebuild(*snapshot);
+        } else if (change.type == MixCatalogChange::Type::Removed) {
+            similarity->remove(change.id);
+        } else if (const MixRecord* record = snapshot->findById(change.id)) {
+            similarity->upsert(snapshot->toMix(*record));
+        }
+    });
+    if (!loadSharedCatalog()) {
+        reloadCaches();
+    }
+    selector_ = std::make_unique<SmartMixSelector>(connection_, config);
+    selector_->setIndex(index_);
+    selector_->setSimilarityIndex(similarity_);
+
+    writes_ = std::make_unique<MixWriteQueue>(
+        [this](const std::vector<MixWrite>& batch) { return executeWrites(batch); },
+        [this](const std::vector<MixWrite>& batch, bool ok) { settleWrites(batch, ok); });
 
     return true;
 }
 
-bool MixDatabase::createTables() {
-    // Create the main table
-    if (!connection_->execute(StringConstants::CREATE_MIXES_TABLE)) {
-        setError("Failed to create tables: " + connection_->getLastError());
-        return false;
+void MixDatabase::setSimilarMixProbability(int probability) {
+    if (selector_) {
+        selector_->setSimilarMixProbability(probability);
     }
+}
 
-    // Try to add is_deleted column (will fail silently if it already exists)
-    connection_->execute(StringConstants::ALTER_ADD_IS_DELETED);
+void MixDatabase::setSelectionSeed(uint32_t seed) {
+    if (selector_) {
+        selector_->setSeed(seed);
+    }
+}
 
+bool MixDatabase::createTables() {
+    // Each step tolerates a library from before versioning, which already has part of it
+    SchemaMigrator migrator(connection_);
+    migrator.addStep(1, "mixes table", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_MIXES_TABLE);
+    });
+    migrator.addStep(2, "deletion and analysis columns", [](IDatabaseConnection& connection) {
+        const std::pair<const char*, const char*> columns[] = {
+            {"is_deleted", StringConstants::ALTER_ADD_IS_DELETED},
+            {"loudness_lufs", StringConstants::ALTER_ADD_LOUDNESS_LUFS},
+            {"peak_dbfs", StringConstants::ALTER_ADD_PEAK_DBFS},
+            {"bpm", StringConstants::ALTER_ADD_BPM},
+            {"seek_index", StringConstants::ALTER_ADD_SEEK_INDEX},
+        };
+        for (const auto& [name, alter] : columns) {
+            auto stmt = connection.prepare(StringConstants::SELECT_MIXES_COLUMN_EXISTS);
+            if (!stmt) {
+                return false;
+            }
+            stmt->bindText(1, name);
+            if (!stmt->step() && !connection.execute(alter)) {
+                return false;
+            }
+        }
+        return connection.execute(StringConstants::CREATE_MIXES_DELETED_INDEX);
+    });
+    // Tags moved out of the JSON column; a library from before gets them copied over once
+    migrator.addStep(3, "mix_tags table", [this](IDatabaseConnection& connection) {
+        auto stmt = connection.prepare(StringConstants::SELECT_MIX_TAGS_EXISTS);
+        const bool existed = stmt && stmt->step();
+        stmt.reset();
+        return connection.execute(StringConstants::CREATE_MIX_TAGS_TABLE) && (existed || migrateTags());
+    });
+    // Plays gained a log; a library from before starts its aggregate from the last plays it recorded
+    migrator.addStep(4, "play history", [](IDatabaseConnection& connection) {
+        auto stmt = connection.prepare(StringConstants::SELECT_PLAY_HISTORY_EXISTS);
+        const bool existed = stmt && stmt->step();
+        stmt.reset();
+        return connection.execute(StringConstants::CREATE_PLAY_HISTORY) &&
+               (existed || connection.execute(StringConstants::SEED_MIX_PLAY_STATS));
+    });
+    // Keyword search index; an SQLite built without FTS5 leaves search to a catalog scan, so this step never fails
+    migrator.addStep(5, "search index", [](IDatabaseConnection& connection) {
+        auto stmt = connection.prepare(StringConstants::SELECT_MIXES_FTS_SYNCED);
+        const bool synced = stmt && stmt->step();
+        stmt.reset();
+        if (!connection.execute(StringConstants::CREATE_MIXES_FTS) ||
+            (!synced && !connection.execute(StringConstants::FILL_MIXES_FTS))) {
+            connection.execute(StringConstants::DROP_MIXES_FTS_TRIGGERS);
+        }
+        return true;
+    });
+
+    migrator.addStep(6, "selection indexes", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_MIXES_SELECTION_INDEXES);
+    });
+    // Analyzed mixes from before the column are measured again in the background, as it stays NULL
+    migrator.addStep(7, "spectral centroid column", [](IDatabaseConnection& connection) {
+        auto stmt = connection.prepare(StringConstants::SELECT_MIXES_COLUMN_EXISTS);
+        if (!stmt) {
+            return false;
+        }
+        stmt->bindText(1, "spectral_centroid_hz");
+        return stmt->step() || connection.execute(StringConstants::ALTER_ADD_SPECTRAL_CENTROID);
+    });
+    // Timestamps compare as numbers, so recency filters are index range scans
+    migrator.addStep(8, "epoch millisecond timestamps", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CONVERT_MIX_TIMESTAMPS);
+    });
+
+    // Manifest checks from before the table treat every entry as added once, which queues nothing already here
+    migrator.addStep(9, "manifest entry hashes", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_MANIFEST_ENTRIES);
+    });
+    // Files downloaded before the table are sized by the mix cache as it starts
+    migrator.addStep(10, "mix file sizes", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_MIX_FILES);
+    });
+    // Files downloaded before the table have no hash and are never matched; only new downloads dedupe
+    migrator.addStep(11, "mix content hashes", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_MIX_HASHES);
+    });
+
+    // Failures from before the table are forgotten; those mixes are tried again without waiting
+    migrator.addStep(12, "download failures", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_DOWNLOAD_FAILURES);
+    });
+
+    // Ids become 16-byte keys from a hash that is the same everywhere; those made by the old one are made again,
+    // and their downloaded files are journalled under the new ones
+    migrator.addStep(13, "binary mix ids", [this](IDatabaseConnection& connection) {
+        return rekeyHashIds(connection, file_mappings_path_);
+    });
+
+    // Favorites set before the table count as never changed, so the first one any node sends wins
+    migrator.addStep(14, "sync state", [](IDatabaseConnection& connection) {
+        return connection.execute(StringConstants::CREATE_SYNC_STATE);
+    });
+
+    if (!migrator.migrate()) {
+        setError(migrator.getLastError());
+        return false;
+    }
     return true;
 }
 
+bool MixDatabase::isSearchIndexed() {
+    // Read from the schema on first use, so a current schema costs startup nothing more
+    int state = search_indexed_.load();
+    if (state < 0) {
+        auto stmt = connection_->prepare(StringConstants::SELECT_MIXES_FTS_SYNCED);
+        state = stmt && stmt->step() ? 1 : 0;
+        search_indexed_ = state;
+    }
+    return state == 1;
+}
+
 bool MixDatabase::addMix(const Mix& mix) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "addMix");
+    std::lock_guard<std::mutex> lock(write_mutex_);
     auto validation_result = validator_->validate(mix);
     if (!validation_result) {
         setError(validation_result.errorMessage);
@@ -68,15 +485,123 @@ bool MixDatabase::addMix(const Mix& mix) {
 
     bindMixToStatement(*stmt, mix, false);
 
-    if (!stmt->execute()) {
+    if (!connection_->beginTransaction()) {
+        setError("Failed to begin transaction: " + connection_->getLastError());
+        return false;
+    }
+    std::unique_ptr<IStatement> clear_tags;
+    std::unique_ptr<IStatement> insert_tag;
+    if (!stmt->execute() || !replaceTags(mix, clear_tags, insert_tag)) {
         setError("Failed to insert mix: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+    stmt.reset();
+    clear_tags.reset();
+    insert_tag.reset();
+    if (!connection_->commitTransaction()) {
+        setError("Failed to commit mix: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+
+    if (index_) {
+        index_->upsert(mix);
+    }
+    writeThrough(mix.id);
+    return true;
+}
+
+bool MixDatabase::addMixes(const std::vector<Mix>& mixes, const std::vector<std::string>& content_hashes,
+                           std::vector<bool>& added) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "addMixes");
+    added.assign(mixes.size(), false);
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    if (mixes.empty()) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!connection_->beginTransaction()) {
+        setError("Failed to begin transaction: " + connection_->getLastError());
+        return false;
+    }
+
+    // Prepared on first use and reused for every row of their kind
+    std::unique_ptr<IStatement> insert;
+    std::unique_ptr<IStatement> upsert_hash;
+    std::unique_ptr<IStatement> clear_tags;
+    std::unique_ptr<IStatement> insert_tag;
+    for (size_t i = 0; i < mixes.size(); ++i) {
+        const Mix& mix = mixes[i];
+        auto validation_result = validator_->validate(mix);
+        if (!validation_result) {
+            setError(validation_result.errorMessage);
+            continue;
+        }
+        if (!insert) {
+            insert = connection_->prepare(StringConstants::INSERT_OR_REPLACE_MIX);
+        }
+        if (!insert) {
+            setError("Failed to prepare statement: " + connection_->getLastError());
+            continue;
+        }
+        insert->reset();
+        bindMixToStatement(*insert, mix, false);
+        if (!insert->execute() || !replaceTags(mix, clear_tags, insert_tag)) {
+            setError("Failed to insert mix: " + connection_->getLastError());
+            continue;
+        }
+        added[i] = true;
+
+        const std::string hash = i < content_hashes.size() ? content_hashes[i] : std::string();
+        if (hash.empty()) {
+            continue;
+        }
+        if (!upsert_hash) {
+            upsert_hash = connection_->prepare(StringConstants::UPSERT_MIX_HASH);
+        }
+        if (upsert_hash) {
+            upsert_hash->reset();
+            upsert_hash->bindText(1, mix.id);
+            upsert_hash->bindText(2, hash);
+        }
+        // The mix plays without its hash; it only goes unmatched against twins and peers
+        if (!upsert_hash || !upsert_hash->execute()) {
+            setError("Failed to store content hash: " + connection_->getLastError());
+        }
+    }
+
+    // Statements go back to the cache before the commit
+    insert.reset();
+    upsert_hash.reset();
+    clear_tags.reset();
+    insert_tag.reset();
+    if (!connection_->commitTransaction()) {
+        setError("Failed to commit mix batch: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        added.assign(mixes.size(), false);
         return false;
     }
 
+    for (size_t i = 0; i < mixes.size(); ++i) {
+        if (!added[i]) {
+            continue;
+        }
+        if (index_) {
+            index_->upsert(mixes[i]);
+        }
+        writeThrough(mixes[i].id);
+    }
     return true;
 }
 
 bool MixDatabase::updateMix(const Mix& mix) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "updateMix");
+    std::lock_guard<std::mutex> lock(write_mutex_);
     auto validation_result = validator_->validate(mix);
     if (!validation_result) {
         setError(validation_result.errorMessage);
@@ -91,11 +616,229 @@ bool MixDatabase::updateMix(const Mix& mix) {
 
     bindMixToStatement(*stmt, mix, true);
 
-    if (!stmt->execute()) {
+    if (!connection_->beginTransaction()) {
+        setError("Failed to begin transaction: " + connection_->getLastError());
+        return false;
+    }
+    std::unique_ptr<IStatement> clear_tags;
+    std::unique_ptr<IStatement> insert_tag;
+    if (!stmt->execute() || (stmt->getChanges() > 0 && !replaceTags(mix, clear_tags, insert_tag))) {
         setError("Failed to update mix: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+    const bool changed = stmt->getChanges() > 0;
+    stmt.reset();
+    clear_tags.reset();
+    insert_tag.reset();
+    if (!connection_->commitTransaction()) {
+        setError("Failed to commit mix: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+
+    if (index_ && changed) {
+        index_->upsert(mix);
+        writeThrough(mix.id);
+    }
+    return true;
+}
+
+bool MixDatabase::ingestMixes(const std::vector<Mix>& upserts, const std::vector<std::string>& soft_delete_ids,
+                              MixIngestStats& stats) {
+    return ingest(upserts, soft_delete_ids, nullptr, stats);
+}
+
+bool MixDatabase::getManifestHashes(std::unordered_map<std::string, uint64_t>& hashes) {
+    hashes.clear();
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    auto stmt = connection_->prepare(StringConstants::SELECT_MANIFEST_ENTRIES);
+    if (!stmt) {
+        setError("Failed to read manifest hashes: " + connection_->getLastError());
+        return false;
+    }
+    while (stmt->step()) {
+        hashes.emplace(MixRowMapper::readId(*stmt, 0), static_cast<uint64_t>(stmt->getInt64(1)));
+    }
+    return true;
+}
+
+bool MixDatabase::ingestManifest(const ManifestDiff& diff, MixIngestStats& stats) {
+    if (!catalog_) {
+        stats = MixIngestStats();
+        setError("Database not initialized");
+        return false;
+    }
+
+    // A changed entry rewrites what the manifest says about a library mix and keeps what playing it added
+    const MixCatalog::Snapshot existing = catalog_->snapshot();
+    std::vector<Mix> upserts;
+    for (const Mix& entry : diff.updated) {
+        const MixRecord* record = existing->findById(entry.id);
+        if (!record) {
+            continue;
+        }
+        Mix mix = existing->toMix(*record);
+        mix.url = entry.url;
+        mix.original_filename = entry.original_filename;
+        mix.title = entry.title;
+        mix.artist = entry.artist;
+        mix.genre = entry.genre;
+        mix.description = entry.description;
+        mix.duration_seconds = entry.duration_seconds;
+        mix.tags = entry.tags;
+        upserts.push_back(std::move(mix));
+    }
+    return ingest(upserts, {}, &diff, stats);
+}
+
+bool MixDatabase::ingest(const std::vector<Mix>& upserts, const std::vector<std::string>& soft_delete_ids,
+                         const ManifestDiff* manifest, MixIngestStats& stats) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "ingest");
+    stats = MixIngestStats();
+    if (!catalog_) {
+        setError("Database not initialized");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const auto start = std::chrono::steady_clock::now();
+    if (!connection_->beginTransaction()) {
+        setError("Failed to begin transaction: " + connection_->getLastError());
+        return false;
+    }
+
+    // Prepared on first use and reused for every row of their kind
+    std::unique_ptr<IStatement> insert;
+    std::unique_ptr<IStatement> update;
+    std::unique_ptr<IStatement> soft_delete;
+    std::unique_ptr<IStatement> clear_tags;
+    std::unique_ptr<IStatement> insert_tag;
+    const MixCatalog::Snapshot existing = catalog_->snapshot();
+
+    // The search triggers cost more per row than one refill per batch of this size
+    const bool refill_search =
+        !upserts.empty() && isSearchIndexed() &&
+        upserts.size() * static_cast<size_t>(Constants::SEARCH_REFILL_BATCH_SHARE) >= existing->size() + upserts.size();
+    if (refill_search && !connection_->execute(StringConstants::DROP_MIXES_FTS_TRIGGERS)) {
+        setError("Failed to suspend search index: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+
+    for (const Mix& mix : upserts) {
+        if (!validator_->validate(mix)) {
+            stats.failed++;
+            continue;
+        }
+        const bool in_library = existing->findById(mix.id) != nullptr;
+        std::unique_ptr<IStatement>& stmt = in_library ? update : insert;
+        if (!stmt) {
+            stmt = connection_->prepare(in_library ? StringConstants::UPDATE_MIX
+                                                   : StringConstants::INSERT_OR_REPLACE_MIX);
+        }
+        if (!stmt) {
+            stats.failed++;
+            continue;
+        }
+        stmt->reset();
+        bindMixToStatement(*stmt, mix, in_library);
+        if (!stmt->execute() || !replaceTags(mix, clear_tags, insert_tag)) {
+            stats.failed++;
+        } else if (in_library) {
+            stats.updated++;
+        } else {
+            stats.inserted++;
+        }
+    }
+
+    for (const std::string& id : soft_delete_ids) {
+        if (!soft_delete) {
+            soft_delete = connection_->prepare(StringConstants::SOFT_DELETE_MIX);
+        }
+        if (!soft_delete) {
+            stats.failed++;
+            continue;
+        }
+        soft_delete->reset();
+        soft_delete->bindText(1, id);
+        if (soft_delete->execute() && soft_delete->getChanges() > 0) {
+            stats.soft_deleted++;
+        } else {
+            stats.failed++;
+        }
+    }
+
+    // Statements go back to the cache before the commit
+    insert.reset();
+    update.reset();
+    soft_delete.reset();
+    clear_tags.reset();
+    insert_tag.reset();
+
+    // In the same transaction as the rows, so a failed batch is diffed again next time
+    if (manifest && !writeManifestHashes(*manifest)) {
+        setError("Failed to store manifest hashes: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        stats = MixIngestStats();
+        return false;
+    }
+
+    // Still inside the transaction, so other connections never see the index without its triggers
+    if (refill_search && (!connection_->execute(StringConstants::FILL_MIXES_FTS) ||
+                          !connection_->execute(StringConstants::CREATE_MIXES_FTS))) {
+        setError("Failed to refill search index: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        stats = MixIngestStats();
+        return false;
+    }
+
+    if (!connection_->commitTransaction()) {
+        setError("Failed to commit mix batch: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        stats = MixIngestStats();
         return false;
     }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (upserts.empty() && soft_delete_ids.empty()) {
+        return true;  // Only manifest hashes changed; the mixes and their caches are as they were
+    }
+
+    // A batch can change the row counts the planner's statistics were taken at
+    connection_->execute(StringConstants::OPTIMIZE_DATABASE);
+    last_optimize_ = std::chrono::steady_clock::now();
 
+    // One full read instead of a row lookup per write
+    reloadCaches();
+    return true;
+}
+
+bool MixDatabase::writeManifestHashes(const ManifestDiff& diff) {
+    auto upsert = connection_->prepare(StringConstants::UPSERT_MANIFEST_ENTRY);
+    auto remove = connection_->prepare(StringConstants::DELETE_MANIFEST_ENTRY);
+    if (!upsert || !remove) {
+        return false;
+    }
+    for (const std::vector<Mix>* entries : {&diff.added, &diff.updated}) {
+        for (const Mix& entry : *entries) {
+            upsert->reset();
+            upsert->bindText(1, entry.id);
+            upsert->bindInt64(2, static_cast<int64_t>(ManifestDiff::hashEntry(entry)));
+            if (!upsert->execute()) {
+                return false;
+            }
+        }
+    }
+    for (const std::string& id : diff.removed) {
+        remove->reset();
+        remove->bindText(1, id);
+        if (!remove->execute()) {
+            return false;
+        }
+    }
     return true;
 }
 
@@ -104,6 +847,7 @@ bool MixDatabase::deleteMix(const std::string& id) {
         setError("Database not initialized");
         return false;
     }
+    std::lock_guard<std::mutex> lock(write_mutex_);
 
     auto stmt = connection_->prepare(StringConstants::DELETE_MIX);
     if (!stmt) {
@@ -123,23 +867,154 @@ bool MixDatabase::deleteMix(const std::string& id) {
         return false;
     }
 
+    if (index_) {
+        index_->remove(id);
+        catalog_->remove(id);
+    }
     return true;
 }
 
 Mix MixDatabase::getMixById(const std::string& id) {
+    // Live mixes come from the catalog, with any queued writes applied
+    if (catalog_) {
+        auto snapshot = catalog_->snapshot();
+        if (const MixRecord* record = snapshot->findById(id)) {
+            return snapshot->toMix(*record);
+        }
+    }
     return executeQueryForSingleMix(StringConstants::SELECT_MIX_BY_ID, {id});
 }
 
 std::vector<Mix> MixDatabase::getAllMixes() {
+    AUTOVIBEZ_TRACE_SCOPE("db", "getAllMixes");
+    if (catalog_) {
+        return catalog_->snapshot()->toVector();
+    }
     return executeQueryForMixes(StringConstants::SELECT_ALL_MIXES);
 }
 
 std::vector<Mix> MixDatabase::getMixesByGenre(const std::string& genre) {
-    return executeQueryForMixes(StringConstants::SELECT_MIXES_BY_GENRE, {genre});
+    if (!catalog_) {
+        return executeQueryForMixes(StringConstants::SELECT_MIXES_BY_GENRE, {genre});
+    }
+    const MixCatalog::Snapshot snapshot = catalog_->snapshot();  // Owns the records pointed to
+    std::vector<Mix> mixes;
+    for (const MixRecord* record : snapshot->findByGenre(genre)) {
+        mixes.push_back(snapshot->toMix(*record));
+    }
+    return mixes;
 }
 
 std::vector<Mix> MixDatabase::getMixesByArtist(const std::string& artist) {
-    return executeQueryForMixes(StringConstants::SELECT_MIXES_BY_ARTIST, {artist});
+    if (!catalog_) {
+        return executeQueryForMixes(StringConstants::SELECT_MIXES_BY_ARTIST, {artist});
+    }
+    const MixCatalog::Snapshot snapshot = catalog_->snapshot();  // Owns the records pointed to
+    std::vector<Mix> mixes;
+    for (const MixRecord* record : snapshot->findByArtist(artist)) {
+        mixes.push_back(snapshot->toMix(*record));
+    }
+    return mixes;
+}
+
+std::vector<Mix> MixDatabase::getMixesByTag(const std::string& tag) {
+    SelectionCriteria criteria;
+    criteria.tag = tag;
+    if (!catalog_) {
+        std::vector<Mix> mixes =
+            executeQueryForMixes(MixQueryBuilder::buildQuery(criteria), MixQueryBuilder::buildParameters(criteria));
+        attachTags(mixes);
+        return mixes;
+    }
+
+    std::vector<Mix> mixes;
+    auto stmt = connection_->prepare(MixQueryBuilder::buildQuery(criteria));
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return mixes;
+    }
+    stmt->bindText(1, tag);
+    const MixCatalog::Snapshot snapshot = catalog_->snapshot();
+    const int id_column = stmt->getColumnIndex("id");
+    char id[Utils::HashId::TEXT_LENGTH];
+    while (stmt->step()) {
+        if (const MixRecord* record = snapshot->findById(MixRowMapper::readId(*stmt, id_column, id))) {
+            mixes.push_back(snapshot->toMix(*record));
+        }
+    }
+    return mixes;
+}
+
+std::vector<Mix> MixDatabase::searchMixes(const std::string& query, int limit) {
+    std::vector<Mix> mixes;
+    const std::string match = MixQueryBuilder::buildSearchMatch(query);
+    if (match.empty() || limit <= 0 || !catalog_) {
+        return mixes;
+    }
+    const MixCatalog::Snapshot snapshot = catalog_->snapshot();
+    if (!isSearchIndexed()) {
+        return searchCatalog(*snapshot, query, limit);
+    }
+
+    auto stmt = connection_->prepare(StringConstants::SEARCH_MIXES);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return mixes;
+    }
+    stmt->bindText(1, match);
+    stmt->bindInt(2, limit);
+    char id[Utils::HashId::TEXT_LENGTH];
+    while (stmt->step()) {
+        // The catalog copy carries writes still queued, and a mix whose deletion is queued is skipped
+        if (const MixRecord* record = snapshot->findById(MixRowMapper::readId(*stmt, 0, id))) {
+            mixes.push_back(snapshot->toMix(*record));
+        }
+    }
+    return mixes;
+}
+
+bool MixDatabase::forEachMix(const SelectionCriteria& criteria, const std::function<bool(const Mix&)>& visit,
+                             OrderBy order) {
+    auto stmt = connection_->prepare(MixQueryBuilder::buildQuery(criteria, order));
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+    const std::vector<std::string> parameters = MixQueryBuilder::buildParameters(criteria);
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        stmt->bindText(static_cast<int>(i + 1), parameters[i]);
+    }
+
+    const MixRowMapper mapper(*stmt);
+    while (stmt->step()) {
+        Mix mix;
+        try {
+            mix = mapper.map(*stmt);
+        } catch (const std::exception&) {
+            continue;  // Skip malformed rows
+        }
+        if (!visit(mix)) {
+            break;
+        }
+    }
+    return true;
+}
+
+std::vector<Mix> MixDatabase::getMixPage(const std::string& after_id, int limit, SelectionCriteria criteria) {
+    std::vector<Mix> page;
+    if (limit <= 0) {
+        return page;
+    }
+    criteria.after_id = after_id;
+    criteria.limit = limit;
+    forEachMix(
+        criteria,
+        [&page](const Mix& mix) {
+            page.push_back(mix);
+            return true;
+        },
+        OrderBy::Id);
+    return page;
 }
 
 Mix MixDatabase::getRandomMix(const std::string& exclude_mix_id) {
@@ -199,6 +1074,7 @@ Mix MixDatabase::getRandomMixByArtist(const std::string& artist, const std::stri
 }
 
 bool MixDatabase::toggleFavorite(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
     auto stmt = connection_->prepare(StringConstants::TOGGLE_FAVORITE);
     if (!stmt) {
         setError("Failed to prepare statement: " + connection_->getLastError());
@@ -206,10 +1082,19 @@ bool MixDatabase::toggleFavorite(const std::string& mix_id) {
     }
 
     stmt->bindText(1, mix_id);
-    return stmt->execute();
+    if (!stmt->execute()) {
+        return false;
+    }
+
+    if (index_) {
+        index_->toggleFavorite(mix_id);
+    }
+    writeThrough(mix_id);
+    return true;
 }
 
 bool MixDatabase::softDeleteMix(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
     auto stmt = connection_->prepare(StringConstants::SOFT_DELETE_MIX);
     if (!stmt) {
         setError("Failed to prepare statement: " + connection_->getLastError());
@@ -223,10 +1108,19 @@ bool MixDatabase::softDeleteMix(const std::string& mix_id) {
         return false;
     }
 
-    return stmt->getChanges() > 0;
-}
+    if (stmt->getChanges() == 0) {
+        return false;
+    }
+
+    if (index_) {
+        index_->remove(mix_id);
+        catalog_->remove(mix_id);
+    }
+    return true;
+}
 
 bool MixDatabase::updatePlayStats(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
     auto stmt = connection_->prepare(StringConstants::UPDATE_PLAY_STATS);
     if (!stmt) {
         setError("Failed to prepare statement: " + connection_->getLastError());
@@ -234,10 +1128,308 @@ bool MixDatabase::updatePlayStats(const std::string& mix_id) {
     }
 
     stmt->bindText(1, mix_id);
-    return stmt->execute();
+    if (!stmt->execute()) {
+        return false;
+    }
+
+    if (index_) {
+        index_->recordPlay(mix_id);
+    }
+    writeThrough(mix_id);
+    return true;
+}
+
+bool MixDatabase::recordPlayEvent(const PlayEvent& event) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::INSERT_PLAY_EVENT);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+
+    bindPlayEvent(*stmt, event);
+    if (!stmt->execute()) {
+        setError("Failed to record play: " + connection_->getLastError());
+        return false;
+    }
+
+    if (index_) {
+        index_->recordPlayEvent(event);
+    }
+    return true;
+}
+
+MixPlayStats MixDatabase::getPlayStats(const std::string& mix_id) {
+    MixPlayStats stats;
+    stats.mix_id = mix_id;
+    auto stmt = connection_->prepare(StringConstants::SELECT_MIX_PLAY_STATS);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return stats;
+    }
+    stmt->bindText(1, mix_id);
+    if (stmt->step()) {
+        stats = readPlayStats(*stmt);
+    }
+    return stats;
+}
+
+std::vector<PlayEvent> MixDatabase::getPlayEventsSince(int64_t since_ms) {
+    std::vector<PlayEvent> events;
+    auto stmt = connection_->prepare(StringConstants::SELECT_PLAY_EVENTS_SINCE);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return events;
+    }
+    stmt->bindInt64(1, since_ms);
+    while (stmt->step()) {
+        PlayEvent event;
+        event.mix_id = MixRowMapper::readId(*stmt, 0);
+        event.ts_epoch_ms = stmt->getInt64(1);
+        event.duration_played = stmt->getInt(2);
+        event.skipped = stmt->getInt(3) != 0;
+        events.push_back(std::move(event));
+    }
+    return events;
+}
+
+bool MixDatabase::getSyncDelta(MixSyncDelta& delta, int max_events, int max_favorites) {
+    delta = MixSyncDelta();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto state = connection_->prepare(StringConstants::SELECT_SYNC_STATE);
+    if (!state) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+    auto read = [&state](const char* key) {
+        state->reset();
+        state->bindText(1, key);
+        return state->step();
+    };
+    if (read(SYNC_NODE_KEY)) {
+        delta.node = state->getText(0);
+    }
+    delta.cursor = read(SYNC_CURSOR_KEY) ? state->getInt64(0) : 0;
+    delta.after_event = read(SYNC_LAST_EVENT_KEY) ? state->getInt64(0) : 0;
+    delta.last_event = delta.after_event;
+    state.reset();
+
+    if (delta.node.empty()) {
+        delta.node = makeNodeId();
+        auto store = connection_->prepare(StringConstants::UPSERT_SYNC_STATE);
+        if (!store) {
+            return false;
+        }
+        store->bindText(1, SYNC_NODE_KEY);
+        store->bindText(2, delta.node);
+        if (!store->execute()) {
+            setError("Failed to store the sync node id: " + connection_->getLastError());
+            return false;
+        }
+    }
+
+    auto plays = connection_->prepare(StringConstants::SELECT_SYNC_PLAYS);
+    if (!plays) {
+        return false;
+    }
+    plays->bindInt64(1, delta.after_event);
+    plays->bindInt(2, max_events);
+    while (plays->step()) {
+        MixSyncPlays entry;
+        entry.mix_id = MixRowMapper::readId(*plays, 0);
+        entry.plays = plays->getInt64(1);
+        entry.skips = plays->getInt64(2);
+        entry.played_seconds = plays->getInt64(3);
+        entry.last_played_ms = plays->getInt64(4);
+        delta.last_event = plays->getInt64(5);
+        delta.events = plays->getInt64(6);
+        delta.plays.push_back(std::move(entry));
+    }
+    plays.reset();
+
+    auto favorites = connection_->prepare(StringConstants::SELECT_SYNC_FAVORITES);
+    if (!favorites) {
+        return false;
+    }
+    favorites->bindInt(1, max_favorites);
+    while (favorites->step()) {
+        MixSyncFavorite entry;
+        entry.mix_id = MixRowMapper::readId(*favorites, 0);
+        entry.favorite = favorites->getInt(1) != 0;
+        entry.changed_ms = favorites->getInt64(2);
+        delta.favorites.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool MixDatabase::applySyncReply(const MixSyncDelta& sent, const MixSyncReply& reply) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "applySyncReply");
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!connection_->beginTransaction()) {
+        return false;
+    }
+
+    std::vector<std::string> merged;
+    bool ok = true;
+    auto prepare = [this, &ok](const char* sql) {
+        auto stmt = connection_->prepare(sql);
+        ok = ok && stmt != nullptr;
+        return stmt;
+    };
+    auto state = prepare(StringConstants::UPSERT_SYNC_STATE);
+    auto synced = prepare(StringConstants::MARK_FAVORITE_SYNCED);
+    auto totals = prepare(StringConstants::MERGE_SYNC_TOTALS);
+    auto changed = prepare(StringConstants::SELECT_FAVORITE_CHANGED);
+    auto favorite = prepare(StringConstants::SET_FAVORITE);
+    auto stamp = prepare(StringConstants::STAMP_REMOTE_FAVORITE);
+
+    if (ok) {
+        for (const auto& [key, value] :
+             {std::make_pair(SYNC_LAST_EVENT_KEY, sent.last_event), std::make_pair(SYNC_CURSOR_KEY, reply.cursor)}) {
+            state->reset();
+            state->bindText(1, key);
+            state->bindInt64(2, value);
+            ok = state->execute() && ok;
+        }
+        for (const MixSyncFavorite& entry : sent.favorites) {
+            synced->reset();
+            synced->bindText(1, entry.mix_id);
+            synced->bindInt64(2, entry.changed_ms);
+            ok = synced->execute() && ok;
+        }
+        for (const MixSyncPlays& entry : reply.totals) {
+            totals->reset();
+            totals->bindInt64(1, entry.plays);
+            totals->bindInt64(2, entry.last_played_ms);
+            totals->bindText(3, entry.mix_id);
+            ok = totals->execute() && ok;
+            if (totals->getChanges() > 0) {
+                merged.push_back(entry.mix_id);
+            }
+        }
+        for (const MixSyncFavorite& entry : reply.favorites) {
+            // A change made here at the same time or later stands
+            changed->reset();
+            changed->bindText(1, entry.mix_id);
+            if (changed->step() && changed->getInt64(0) >= entry.changed_ms) {
+                continue;
+            }
+            // The trigger stamps the flag as a local change, which the server's time then replaces
+            favorite->reset();
+            favorite->bindInt(1, entry.favorite ? 1 : 0);
+            favorite->bindText(2, entry.mix_id);
+            ok = favorite->execute() && ok;
+            if (favorite->getChanges() > 0) {
+                merged.push_back(entry.mix_id);
+            }
+            stamp->reset();
+            stamp->bindInt(1, entry.favorite ? 1 : 0);
+            stamp->bindText(2, entry.mix_id);
+            stamp->bindInt64(3, entry.changed_ms);
+            ok = stamp->execute() && ok;
+        }
+    }
+
+    // Statements go back to the cache before the commit
+    state.reset();
+    synced.reset();
+    totals.reset();
+    changed.reset();
+    favorite.reset();
+    stamp.reset();
+
+    if (!ok || !connection_->commitTransaction()) {
+        setError("Failed to apply the sync reply: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+
+    for (const std::string& id : merged) {
+        writeThrough(id);
+        if (!index_) {
+            continue;
+        }
+        const MixCatalog::Snapshot snapshot = catalog_->snapshot();
+        if (const MixRecord* record = snapshot->findById(id)) {
+            index_->upsert(snapshot->toMix(*record));
+        }
+    }
+    return true;
+}
+
+std::future<bool> MixDatabase::queueToggleFavorite(const std::string& mix_id) {
+    if (!writes_) {
+        return readyFuture(toggleFavorite(mix_id));
+    }
+    return writes_->enqueue(
+        mix_id, [](MixWrite& write) { write.toggle_favorite = !write.toggle_favorite; },
+        [this, mix_id]() {
+            index_->toggleFavorite(mix_id);
+            previewMix(mix_id, [](Mix& mix) { mix.is_favorite = !mix.is_favorite; });
+        });
+}
+
+std::future<bool> MixDatabase::queueSoftDelete(const std::string& mix_id) {
+    if (!writes_) {
+        return readyFuture(softDeleteMix(mix_id));
+    }
+    return writes_->enqueue(
+        mix_id, [](MixWrite& write) { write.soft_delete = true; },
+        [this, mix_id]() {
+            index_->remove(mix_id);
+            catalog_->remove(mix_id);
+        });
+}
+
+std::future<bool> MixDatabase::queueRecordPlay(const std::string& mix_id) {
+    if (!writes_) {
+        return readyFuture(updatePlayStats(mix_id));
+    }
+    return writes_->enqueue(
+        mix_id, [](MixWrite& write) { write.plays++; },
+        [this, mix_id]() {
+            index_->recordPlay(mix_id);
+            previewMix(mix_id, [](Mix& mix) {
+                mix.play_count++;
+                mix.last_played_ms = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
+            });
+        });
+}
+
+std::future<bool> MixDatabase::queuePlayEvent(const PlayEvent& event) {
+    if (!writes_) {
+        return readyFuture(recordPlayEvent(event));
+    }
+    return writes_->enqueue(
+        event.mix_id, [event](MixWrite& write) { write.play_events.push_back(event); },
+        [this, event]() { index_->recordPlayEvent(event); });
+}
+
+std::future<bool> MixDatabase::queueLocalPath(const std::string& mix_id, const std::string& local_path) {
+    if (!writes_) {
+        return readyFuture(setLocalPath(mix_id, local_path));
+    }
+    return writes_->enqueue(
+        mix_id,
+        [local_path](MixWrite& write) {
+            write.set_local_path = true;
+            write.local_path = local_path;
+        },
+        [this, mix_id, local_path]() {
+            index_->setLocalPath(mix_id, local_path);
+            previewMix(mix_id, [&local_path](Mix& mix) { mix.local_path = local_path; });
+        });
+}
+
+void MixDatabase::flushWrites() {
+    AUTOVIBEZ_TRACE_SCOPE("db", "flushWrites");
+    if (writes_) {
+        writes_->flush();
+    }
 }
 
 bool MixDatabase::setLocalPath(const std::string& mix_id, const std::string& local_path) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
     auto stmt = connection_->prepare(StringConstants::SET_LOCAL_PATH);
     if (!stmt) {
         setError("Failed to prepare statement: " + connection_->getLastError());
@@ -247,88 +1439,365 @@ bool MixDatabase::setLocalPath(const std::string& mix_id, const std::string& loc
     stmt->bindText(1, local_path);
     stmt->bindText(2, mix_id);
 
-    return stmt->execute();
+    if (!stmt->execute()) {
+        return false;
+    }
+
+    if (index_) {
+        index_->setLocalPath(mix_id, local_path);
+    }
+    writeThrough(mix_id);
+    return true;
 }
 
-std::vector<Mix> MixDatabase::getDownloadedMixes() {
-    return executeQueryForMixes(StringConstants::SELECT_DOWNLOADED_MIXES);
+bool MixDatabase::recordMixFiles(const std::vector<CachedMixFile>& files) {
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!connection_->beginTransaction()) {
+        setError("Failed to begin transaction: " + connection_->getLastError());
+        return false;
+    }
+    auto stmt = connection_->prepare(StringConstants::UPSERT_MIX_FILE);
+    bool ok = stmt != nullptr;
+    for (size_t i = 0; ok && i < files.size(); ++i) {
+        stmt->reset();
+        stmt->bindText(1, files[i].mix_id);
+        stmt->bindInt64(2, files[i].bytes);
+        stmt->bindInt64(3, files[i].cached_ms);
+        ok = stmt->execute();
+    }
+    stmt.reset();
+    if (!ok || !connection_->commitTransaction()) {
+        setError("Failed to record mix files: " + connection_->getLastError());
+        connection_->rollbackTransaction();
+        return false;
+    }
+    return true;
 }
 
-std::vector<Mix> MixDatabase::getFavoriteMixes() {
-    return executeQueryForMixes(StringConstants::SELECT_FAVORITE_MIXES);
+bool MixDatabase::getMixCacheUsage(int64_t& total_bytes, int64_t& file_count) {
+    total_bytes = 0;
+    file_count = 0;
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    auto stmt = connection_->prepare(StringConstants::SELECT_MIX_CACHE_USAGE);
+    if (!stmt || !stmt->step()) {
+        setError("Failed to read mix cache usage: " + connection_->getLastError());
+        return false;
+    }
+    total_bytes = stmt->getInt64(0);
+    file_count = stmt->getInt64(1);
+    return true;
 }
 
-std::vector<Mix> MixDatabase::getRecentlyPlayed(int limit) {
-    auto stmt = connection_->prepare(StringConstants::SELECT_RECENTLY_PLAYED);
+std::vector<CachedMixFile> MixDatabase::getUnsizedMixFiles(int limit) {
+    std::vector<CachedMixFile> files;
+    if (!connection_) {
+        return files;
+    }
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_UNSIZED_MIX_FILES)) {
+        stmt->bindInt(1, limit);
+        while (stmt->step()) {
+            CachedMixFile file;
+            file.mix_id = MixRowMapper::readId(*stmt, 0);
+            file.local_path = stmt->getText(1);
+            files.push_back(std::move(file));
+        }
+    }
+    return files;
+}
+
+std::vector<CachedMixFile> MixDatabase::getEvictionCandidates(int limit) {
+    std::vector<CachedMixFile> files;
+    if (!connection_) {
+        return files;
+    }
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_EVICTION_CANDIDATES)) {
+        stmt->bindInt(1, Constants::MIX_CACHE_MAX_PLAY_CREDITS);
+        stmt->bindInt64(2, int64_t{Constants::MIX_CACHE_PLAY_CREDIT_DAYS} * 24 * 60 * 60 * 1000);
+        stmt->bindInt(3, limit);
+        while (stmt->step()) {
+            CachedMixFile file;
+            file.mix_id = MixRowMapper::readId(*stmt, 0);
+            file.local_path = stmt->getText(1);
+            file.bytes = stmt->getInt64(2);
+            file.cached_ms = stmt->getInt64(3);
+            files.push_back(std::move(file));
+        }
+    }
+    return files;
+}
+
+bool MixDatabase::clearLocalPath(const std::string& mix_id) {
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::CLEAR_LOCAL_PATH);
     if (!stmt) {
         setError("Failed to prepare statement: " + connection_->getLastError());
-        return std::vector<Mix>();
+        return false;
+    }
+    stmt->bindText(1, mix_id);
+    if (!stmt->execute()) {
+        return false;
     }
 
-    stmt->bindInt(1, limit);
+    // A deleted mix is not in the catalog, and must not come back to it
+    if (catalog_ && catalog_->snapshot()->findById(mix_id)) {
+        if (index_) {
+            index_->setLocalPath(mix_id, "");
+        }
+        writeThrough(mix_id);
+    }
+    return true;
+}
 
-    std::vector<Mix> mixes;
-    while (stmt->step()) {
-        try {
-            Mix mix = statementToMix(*stmt);
-            mixes.push_back(mix);
-        } catch (const std::exception& e) {
-            // Skip malformed rows
+bool MixDatabase::setContentHash(const std::string& mix_id, const std::string& content_hash) {
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::UPSERT_MIX_HASH);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+    stmt->bindText(1, mix_id);
+    stmt->bindText(2, content_hash);
+    if (!stmt->execute()) {
+        setError("Failed to store content hash: " + connection_->getLastError());
+        return false;
+    }
+    return true;
+}
+
+std::string MixDatabase::getContentHash(const std::string& mix_id) {
+    if (!connection_) {
+        return "";
+    }
+    auto stmt = connection_->prepare(StringConstants::SELECT_MIX_HASH);
+    if (!stmt) {
+        return "";
+    }
+    stmt->bindText(1, mix_id);
+    return stmt->step() ? stmt->getText(0) : "";
+}
+
+Mix MixDatabase::findMixByContentHash(const std::string& content_hash, const std::string& exclude_mix_id) {
+    if (!connection_ || content_hash.empty()) {
+        return Mix();
+    }
+    std::string mix_id;
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_MIX_BY_CONTENT_HASH)) {
+        stmt->bindText(1, content_hash);
+        stmt->bindText(2, exclude_mix_id);
+        if (stmt->step()) {
+            mix_id = MixRowMapper::readId(*stmt, 0);
         }
     }
+    return mix_id.empty() ? Mix() : getMixById(mix_id);
+}
 
-    return mixes;
+std::vector<MixFileHash> MixDatabase::getMixFileHashes() {
+    std::vector<MixFileHash> files;
+    if (!connection_) {
+        return files;
+    }
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_MIX_FILE_HASHES)) {
+        while (stmt->step()) {
+            MixFileHash file;
+            file.mix_id = MixRowMapper::readId(*stmt, 0);
+            file.content_hash = stmt->getText(1);
+            file.local_path = stmt->getText(2);
+            files.push_back(std::move(file));
+        }
+    }
+    return files;
+}
+
+bool MixDatabase::setDownloadFailure(const DownloadFailure& failure) {
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::UPSERT_DOWNLOAD_FAILURE);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+    stmt->bindText(1, failure.mix_id);
+    stmt->bindInt(2, failure.failures);
+    stmt->bindInt64(3, failure.retry_after_ms);
+    if (!stmt->execute()) {
+        setError("Failed to store download failure: " + connection_->getLastError());
+        return false;
+    }
+    return true;
 }
 
-Mix MixDatabase::statementToMix(IStatement& stmt) {
-    Mix mix;
+bool MixDatabase::clearDownloadFailure(const std::string& mix_id) {
+    if (!connection_) {
+        setError("Database not initialized");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::DELETE_DOWNLOAD_FAILURE);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+    stmt->bindText(1, mix_id);
+    return stmt->execute();
+}
 
-    // Use column names instead of magic number indices
-    if (!stmt.isNull("id")) {
-        mix.id = stmt.getText("id");
+std::vector<DownloadFailure> MixDatabase::getDownloadFailures() {
+    std::vector<DownloadFailure> failures;
+    if (!connection_) {
+        return failures;
     }
-    if (!stmt.isNull("title")) {
-        mix.title = stmt.getText("title");
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_DOWNLOAD_FAILURES)) {
+        while (stmt->step()) {
+            DownloadFailure failure;
+            failure.mix_id = MixRowMapper::readId(*stmt, 0);
+            failure.failures = stmt->getInt(1);
+            failure.retry_after_ms = stmt->getInt64(2);
+            failures.push_back(std::move(failure));
+        }
     }
-    if (!stmt.isNull("artist")) {
-        mix.artist = stmt.getText("artist");
+    return failures;
+}
+
+bool MixDatabase::isLocalPathShared(const std::string& local_path, const std::string& mix_id) {
+    if (!connection_) {
+        return false;
     }
-    if (!stmt.isNull("genre")) {
-        mix.genre = stmt.getText("genre");
+    auto stmt = connection_->prepare(StringConstants::SELECT_LOCAL_PATH_SHARED);
+    if (!stmt) {
+        return false;
     }
-    if (!stmt.isNull("url")) {
-        mix.url = stmt.getText("url");
+    stmt->bindText(1, local_path);
+    stmt->bindText(2, mix_id);
+    return stmt->step();
+}
+
+bool MixDatabase::setMixAnalysis(const std::string& mix_id, double loudness_lufs, double peak_dbfs, double bpm,
+                                 double spectral_centroid_hz) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::SET_MIX_ANALYSIS);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
     }
-    if (!stmt.isNull("local_path")) {
-        mix.local_path = stmt.getText("local_path");
+
+    stmt->bindDouble(1, loudness_lufs);
+    stmt->bindDouble(2, peak_dbfs);
+    stmt->bindDouble(3, bpm);
+    stmt->bindDouble(4, spectral_centroid_hz);
+    stmt->bindText(5, mix_id);
+
+    if (!stmt->execute()) {
+        return false;
     }
 
-    mix.duration_seconds = stmt.getInt("duration_seconds");
+    writeThrough(mix_id);
+    return true;
+}
 
-    if (!stmt.isNull("tags")) {
-        std::string tags_json = stmt.getText("tags");
-        mix.tags = AutoVibez::Utils::JsonUtils::jsonArrayToVector(tags_json);
+bool MixDatabase::setSeekIndex(const std::string& mix_id, const std::string& seek_index) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto stmt = connection_->prepare(StringConstants::SET_SEEK_INDEX);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
     }
 
-    if (!stmt.isNull("description")) {
-        mix.description = stmt.getText("description");
+    stmt->bindText(1, seek_index);
+    stmt->bindText(2, mix_id);
+
+    return stmt->execute();
+}
+
+std::string MixDatabase::getSeekIndex(const std::string& mix_id) {
+    auto stmt = connection_->prepare(StringConstants::SELECT_SEEK_INDEX);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return "";
     }
-    if (!stmt.isNull("date_added")) {
-        mix.date_added = stmt.getText("date_added");
+
+    stmt->bindText(1, mix_id);
+    if (!stmt->step() || stmt->isNull("seek_index")) {
+        return "";
+    }
+    return stmt->getText("seek_index");
+}
+
+std::vector<Mix> MixDatabase::getUnanalyzedMixes() {
+    return executeQueryForMixes(StringConstants::SELECT_UNANALYZED_MIXES);
+}
+
+std::vector<Mix> MixDatabase::getDownloadedMixes() {
+    if (!catalog_) {
+        return executeQueryForMixes(StringConstants::SELECT_DOWNLOADED_MIXES);
+    }
+    const MixCatalog::Snapshot snapshot = catalog_->snapshot();
+    std::vector<Mix> mixes;
+    for (const auto& record : snapshot->entries()) {
+        if (!record->localPath().empty()) {
+            mixes.push_back(snapshot->toMix(*record));
+        }
+    }
+    return mixes;
+}
+
+std::vector<Mix> MixDatabase::getFavoriteMixes() {
+    if (!catalog_) {
+        return executeQueryForMixes(StringConstants::SELECT_FAVORITE_MIXES);
     }
-    if (!stmt.isNull("last_played")) {
-        mix.last_played = stmt.getText("last_played");
+    const MixCatalog::Snapshot snapshot = catalog_->snapshot();
+    std::vector<Mix> mixes;
+    for (const auto& record : snapshot->entries()) {
+        if (record->is_favorite) {
+            mixes.push_back(snapshot->toMix(*record));
+        }
     }
+    return mixes;
+}
 
-    mix.play_count = stmt.getInt("play_count");
-    mix.is_favorite = stmt.getInt("is_favorite") != 0;
-    mix.is_deleted = stmt.getInt("is_deleted") != 0;
+std::vector<Mix> MixDatabase::getRecentlyPlayed(int limit, int64_t since_ms) {
+    auto stmt = connection_->prepare(StringConstants::SELECT_RECENTLY_PLAYED);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return std::vector<Mix>();
+    }
 
-    return mix;
+    stmt->bindInt64(1, since_ms);
+    stmt->bindInt(2, limit);
+
+    const MixRowMapper mapper(*stmt);
+    std::vector<Mix> mixes;
+    while (stmt->step()) {
+        try {
+            mixes.push_back(mapper.map(*stmt));
+        } catch (const std::exception& e) {
+            // Skip malformed rows
+        }
+    }
+
+    return mixes;
 }
 
 std::vector<Mix> MixDatabase::executeQueryForMixes(const std::string& query,
                                                    const std::vector<std::string>& parameters) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "query");
     auto stmt = connection_->prepare(query);
     if (!stmt) {
         setError("Failed to prepare statement: " + connection_->getLastError());
@@ -340,11 +1809,11 @@ std::vector<Mix> MixDatabase::executeQueryForMixes(const std::string& query,
         stmt->bindText(static_cast<int>(i + 1), parameters[i]);
     }
 
+    const MixRowMapper mapper(*stmt);
     std::vector<Mix> mixes;
     while (stmt->step()) {
         try {
-            Mix mix = statementToMix(*stmt);
-            mixes.push_back(mix);
+            mixes.push_back(mapper.map(*stmt));
         } catch (const std::exception& e) {
             // Skip malformed rows
         }
@@ -366,13 +1835,348 @@ Mix MixDatabase::executeQueryForSingleMix(const std::string& query, const std::v
     }
 
     if (stmt->step()) {
-        return statementToMix(*stmt);
+        return MixRowMapper(*stmt).map(*stmt);
     }
 
     return Mix();
 }
 
+bool MixDatabase::executeWrites(const std::vector<MixWrite>& batch) {
+    AUTOVIBEZ_TRACE_SCOPE("db", "executeWrites");
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!connection_->beginTransaction()) {
+        return false;
+    }
+
+    // One statement per kind of change, reused across the batch
+    std::unique_ptr<IStatement> path;
+    std::unique_ptr<IStatement> plays;
+    std::unique_ptr<IStatement> favorite;
+    std::unique_ptr<IStatement> soft_delete;
+    std::unique_ptr<IStatement> play_event;
+    bool ok = true;
+    auto run = [this, &ok](std::unique_ptr<IStatement>& stmt, const char* sql,
+                           const std::function<void(IStatement&)>& bind) {
+        if (!stmt) {
+            stmt = connection_->prepare(sql);
+        }
+        if (!stmt) {
+            ok = false;
+            return;
+        }
+        stmt->reset();
+        bind(*stmt);
+        ok = stmt->execute() && ok;
+    };
+
+    for (const MixWrite& write : batch) {
+        if (write.set_local_path) {
+            run(path, StringConstants::SET_LOCAL_PATH, [&write](IStatement& stmt) {
+                stmt.bindText(1, write.local_path);
+                stmt.bindText(2, write.id);
+            });
+        }
+        if (write.plays > 0) {
+            run(plays, StringConstants::ADD_PLAY_STATS, [&write](IStatement& stmt) {
+                stmt.bindInt(1, write.plays);
+                stmt.bindText(2, write.id);
+            });
+        }
+        if (write.toggle_favorite) {
+            run(favorite, StringConstants::TOGGLE_FAVORITE, [&write](IStatement& stmt) { stmt.bindText(1, write.id); });
+        }
+        if (write.soft_delete) {
+            run(soft_delete, StringConstants::SOFT_DELETE_MIX,
+                [&write](IStatement& stmt) { stmt.bindText(1, write.id); });
+        }
+        for (const PlayEvent& event : write.play_events) {
+            run(play_event, StringConstants::INSERT_PLAY_EVENT,
+                [&event](IStatement& stmt) { bindPlayEvent(stmt, event); });
+        }
+    }
+
+    // Statements go back to the cache before the commit
+    path.reset();
+    plays.reset();
+    favorite.reset();
+    soft_delete.reset();
+    play_event.reset();
+
+    if (!ok || !connection_->commitTransaction()) {
+        connection_->rollbackTransaction();
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_optimize_ >= std::chrono::milliseconds(Constants::MIX_DB_OPTIMIZE_INTERVAL_MS)) {
+        connection_->execute(StringConstants::OPTIMIZE_DATABASE);
+        last_optimize_ = now;
+    }
+    return true;
+}
+
+void MixDatabase::settleWrites(const std::vector<MixWrite>& batch, bool ok) {
+    if (!ok) {
+        reloadCaches();
+        return;
+    }
+    for (const MixWrite& write : batch) {
+        writeThrough(write.id);
+    }
+}
+
+void MixDatabase::previewMix(const std::string& id, const std::function<void(Mix&)>& change) {
+    auto snapshot = catalog_->snapshot();
+    if (const MixRecord* current = snapshot->findById(id)) {
+        Mix mix = snapshot->toMix(*current);
+        change(mix);
+        catalog_->put(mix);
+    }
+}
+
+void MixDatabase::reloadCaches() {
+    MixCatalogBuilder builder;
+    readCatalog(builder);
+    loadCaches(builder.build());
+}
+
+void MixDatabase::readCatalog(MixCatalogBuilder& builder) {
+    // Row by row into compact records: the library is never held as full Mix objects
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_ALL_MIXES)) {
+        const MixRowMapper mapper(*stmt);
+        while (stmt->step()) {
+            try {
+                builder.add(mapper.map(*stmt));
+            } catch (const std::exception&) {
+                // Skip malformed rows
+            }
+        }
+    }
+    if (builder.size() > 0) {
+        if (auto stmt = connection_->prepare(StringConstants::SELECT_ALL_MIX_TAGS)) {
+            char id[Utils::HashId::TEXT_LENGTH];
+            while (stmt->step()) {
+                builder.addTag(MixRowMapper::readId(*stmt, 0, id), stmt->getTextView(1));
+            }
+        }
+    }
+}
+
+void MixDatabase::loadCaches(MixCatalog::Snapshot snapshot) {
+    catalog_->load(std::move(snapshot));
+    index_->rebuild(*catalog_->snapshot());
+
+    std::vector<MixPlayStats> stats;
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_ALL_MIX_PLAY_STATS)) {
+        while (stmt->step()) {
+            stats.push_back(readPlayStats(*stmt));
+        }
+    }
+    index_->loadPlayStats(stats);
+}
+
+bool MixDatabase::loadSharedCatalog() {
+    if (shared_catalog_path_.empty()) {
+        return false;
+    }
+    auto shared = std::make_unique<SharedCatalog>();
+    if (!shared->open(shared_catalog_path_)) {
+        setError("Shared catalog disabled: " + shared->getLastError());
+        return false;
+    }
+    shared_ = std::move(shared);
+    // The publisher republishes every change; the others' own writes are the publisher's cue to read the table
+    shared_listener_ = catalog_->subscribe([this](const MixCatalogChange&) {
+        if (shared_publishing_.load()) {
+            shared_stale_.store(true);
+        } else if (!merging_shared) {
+            shared_->noteWrite();
+        }
+    });
+
+    if (shared_->claimPublisher()) {
+        shared_publishing_.store(true);
+        shared_writes_ = shared_->getWriteCount();
+        return false;  // Reads the table and publishes it on the first sync
+    }
+    if (!shared_->isMapped()) {
+        return false;  // Nothing published yet; the publisher's first version is merged in when it comes
+    }
+    MixCatalogBuilder builder;
+    shared_->load(builder);
+    merging_shared = true;
+    loadCaches(builder.build());
+    merging_shared = false;
+    return true;
+}
+
+bool MixDatabase::mergeCatalog(const MixCatalog::Snapshot& fresh) {
+    const MixCatalog::Snapshot existing = catalog_->snapshot();
+    std::vector<const MixRecord*> changed;
+    std::vector<std::string> removed;
+    for (const auto& entry : fresh->entries()) {
+        const MixRecord* current = existing->findById(entry->id());
+        if (!current || !sameRecord(*current, *existing, *entry, *fresh)) {
+            changed.push_back(entry.get());
+        }
+    }
+    for (const auto& entry : existing->entries()) {
+        if (!fresh->findById(entry->id())) {
+            removed.emplace_back(entry->id());
+        }
+    }
+    if (changed.empty() && removed.empty()) {
+        return false;
+    }
+
+    merging_shared = true;
+    if (changed.size() + removed.size() > static_cast<size_t>(Constants::SHARED_CATALOG_MERGE_LIMIT)) {
+        loadCaches(fresh);
+    } else {
+        for (const MixRecord* record : changed) {
+            const Mix mix = fresh->toMix(*record);
+            catalog_->put(mix);
+            index_->upsert(mix);
+        }
+        for (const std::string& id : removed) {
+            catalog_->remove(id);
+            index_->remove(id);
+        }
+    }
+    merging_shared = false;
+    return true;
+}
+
+void MixDatabase::syncSharedCatalog() {
+    if (!shared_) {
+        return;
+    }
+    bool reread = false;
+    if (!shared_publishing_.load()) {
+        if (!shared_->claimPublisher()) {
+            if (shared_->refresh()) {
+                MixCatalogBuilder builder;
+                shared_->load(builder);
+                mergeCatalog(builder.build());
+            }
+            return;
+        }
+        shared_publishing_.store(true);
+        reread = true;  // The last publisher may have missed writes before it exited
+    }
+
+    // A change the merge makes marks the catalog stale through the listener
+    const uint64_t writes = shared_->getWriteCount();
+    if (reread || writes != shared_writes_) {
+        shared_writes_ = writes;
+        MixCatalogBuilder builder;
+        readCatalog(builder);
+        mergeCatalog(builder.build());
+    }
+    if (shared_stale_.exchange(false) && !shared_->publish(*catalog_->snapshot())) {
+        shared_stale_.store(true);
+        setError("Failed to publish the shared catalog: " + shared_->getLastError());
+    }
+}
+
+void MixDatabase::writeThrough(const std::string& id) {
+    if (!catalog_) {
+        return;
+    }
+    Mix mix = executeQueryForSingleMix(StringConstants::SELECT_MIX_BY_ID, {id});
+    if (mix.id.empty()) {
+        catalog_->remove(id);
+        return;
+    }
+    if (auto stmt = connection_->prepare(StringConstants::SELECT_MIX_TAGS)) {
+        stmt->bindText(1, id);
+        while (stmt->step()) {
+            mix.tags.push_back(stmt->getText(0));
+        }
+    }
+    catalog_->put(mix);
+}
+
+void MixDatabase::attachTags(std::vector<Mix>& mixes) {
+    if (mixes.empty()) {
+        return;
+    }
+    auto stmt = connection_->prepare(StringConstants::SELECT_ALL_MIX_TAGS);
+    if (!stmt) {
+        return;
+    }
+    std::unordered_map<std::string_view, Mix*> by_id;
+    by_id.reserve(mixes.size());
+    for (Mix& mix : mixes) {
+        by_id.emplace(mix.id, &mix);
+    }
+    // Rows come grouped by mix, so each mix is looked up once
+    std::string current_id;
+    Mix* current = nullptr;
+    char id[Utils::HashId::TEXT_LENGTH];
+    while (stmt->step()) {
+        const std::string_view mix_id = MixRowMapper::readId(*stmt, 0, id);
+        if (current_id != mix_id) {
+            current_id.assign(mix_id.data(), mix_id.size());
+            auto it = by_id.find(current_id);
+            current = it == by_id.end() ? nullptr : it->second;
+        }
+        if (current) {
+            current->tags.emplace_back(stmt->getTextView(1));
+        }
+    }
+}
+
+bool MixDatabase::migrateTags() {
+    auto legacy = connection_->prepare(StringConstants::SELECT_LEGACY_MIX_TAGS);
+    if (!legacy) {
+        return false;
+    }
+    const MixRowMapper mapper(*legacy, true);
+    std::unique_ptr<IStatement> clear_tags;
+    std::unique_ptr<IStatement> insert_tag;
+    while (legacy->step()) {
+        const Mix mix = mapper.map(*legacy);
+        if (!mix.tags.empty() && !replaceTags(mix, clear_tags, insert_tag)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MixDatabase::replaceTags(const Mix& mix, std::unique_ptr<IStatement>& clear, std::unique_ptr<IStatement>& insert) {
+    if (!clear) {
+        clear = connection_->prepare(StringConstants::CLEAR_MIX_TAGS);
+    }
+    if (!clear) {
+        return false;
+    }
+    clear->reset();
+    clear->bindText(1, mix.id);
+    if (!clear->execute()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < mix.tags.size(); ++i) {
+        if (!insert) {
+            insert = connection_->prepare(StringConstants::INSERT_MIX_TAG);
+        }
+        if (!insert) {
+            return false;
+        }
+        insert->reset();
+        insert->bindText(1, mix.id);
+        insert->bindInt(2, static_cast<int>(i));
+        insert->bindText(3, mix.tags[i]);
+        if (!insert->execute()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void MixDatabase::bindMixToStatement(IStatement& stmt, const Mix& mix, bool include_id) {
+    // Copy for the search index; tags are read back from mix_tags
     std::string tags_json = AutoVibez::Utils::JsonUtils::vectorToJsonArray(mix.tags);
 
     int param_index = 1;
@@ -390,8 +2194,8 @@ void MixDatabase::bindMixToStatement(IStatement& stmt, const Mix& mix, bool incl
     stmt.bindInt(param_index++, mix.duration_seconds);
     stmt.bindText(param_index++, tags_json);
     stmt.bindText(param_index++, mix.description);
-    stmt.bindText(param_index++, mix.date_added);
-    stmt.bindText(param_index++, mix.last_played);
+    stmt.bindInt64(param_index++, mix.date_added_ms);
+    stmt.bindInt64(param_index++, mix.last_played_ms);
     stmt.bindInt(param_index++, mix.play_count);
     stmt.bindInt(param_index++, mix.is_favorite ? 1 : 0);
     stmt.bindInt(param_index++, mix.is_deleted ? 1 : 0);
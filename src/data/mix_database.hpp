@@ -1,23 +1,78 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "database_interfaces.hpp"
+#include "download_backoff.hpp"
 #include "error_handler.hpp"
+#include "manifest_diff.hpp"
+#include "mix_catalog.hpp"
 #include "mix_metadata.hpp"
+#include "mix_similarity_index.hpp"
+#include "mix_sync_delta.hpp"
 #include "mix_validator.hpp"
+#include "mix_write_queue.hpp"
+#include "shared_catalog.hpp"
 #include "smart_mix_selector.hpp"
+#include "sqlite_connection.hpp"
 
 namespace AutoVibez::Data {
 
+/**
+ * @brief What one MixDatabase::ingestMixes call wrote
+ */
+struct MixIngestStats {
+    int inserted = 0;
+    int updated = 0;
+    int soft_deleted = 0;
+    int failed = 0;        // Rows rejected by validation or by their statement
+    double seconds = 0.0;  // Including the commit
+
+    /**
+     * @brief Rows written per second, 0 before anything was timed
+     */
+    double rowsPerSecond() const {
+        return seconds > 0.0 ? (inserted + updated + soft_deleted) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief A downloaded mix file as the cache accounts for it
+ */
+struct CachedMixFile {
+    std::string mix_id;
+    std::string local_path;
+    int64_t bytes = 0;
+    int64_t cached_ms = 0;  // Epoch ms it was recorded at
+};
+
+/**
+ * @brief A downloaded mix's file with its content hash, as the LAN peer cache shares it
+ */
+struct MixFileHash {
+    std::string mix_id;
+    std::string content_hash;
+    std::string local_path;
+};
+
 /**
  * @brief Manages SQLite database operations for mix metadata and user data
  */
 class MixDatabase : public AutoVibez::Utils::ErrorHandler {
 public:
-    explicit MixDatabase(const std::string& db_path);
+    /**
+     * @brief Open db_path with one connection per calling thread
+     * @param tuning Journal and sync pragmas for each connection
+     */
+    explicit MixDatabase(const std::string& db_path, const SqliteTuning& tuning = SqliteTuning::fast());
     explicit MixDatabase(std::shared_ptr<IDatabaseConnection> connection);
     ~MixDatabase();
 
@@ -27,6 +82,34 @@ public:
      */
     bool initialize();
 
+    /**
+     * @brief Share the catalog with the other instances on this host through a SharedCatalog at path
+     *
+     * Call before initialize. The instance that becomes the publisher reads the library
+     * from the table and publishes it; the others load it from the mapping instead.
+     */
+    void setSharedCatalogPath(const std::string& path) {
+        shared_catalog_path_ = path;
+    }
+
+    /**
+     * @brief The MixDownloader journal to carry downloaded files over to new ids when a migration re-keys mixes
+     *
+     * Call before initialize. Unset, the journal is left alone.
+     */
+    void setFileMappingsPath(const std::string& path) {
+        file_mappings_path_ = path;
+    }
+
+    /**
+     * @brief Keep the shared catalog in step; call now and then, from one thread
+     *
+     * The publisher publishes once its catalog changed, first reading the table again
+     * if another instance wrote to it. The others take in each new version, mix by mix
+     * when few differ. Once the publisher exits, the next instance to call takes over.
+     */
+    void syncSharedCatalog();
+
     /**
      * @brief Add a mix to the database
      * @param mix Mix to add
@@ -34,6 +117,18 @@ public:
      */
     bool addMix(const Mix& mix);
 
+    /**
+     * @brief Add newly downloaded mixes, with their content hashes, in one transaction
+     *
+     * As addMix for each, but the rows share one commit and one prepared statement of
+     * each kind. A row that fails validation or its statement is skipped and the rest go in.
+     * @param content_hashes One per mix, or empty; an empty hash is not stored
+     * @param added Set per mix to whether its row was written
+     * @return False if the transaction could not be started or committed, in which case nothing was written
+     */
+    bool addMixes(const std::vector<Mix>& mixes, const std::vector<std::string>& content_hashes,
+                  std::vector<bool>& added);
+
     /**
      * @brief Update a mix in the database
      * @param mix Mix to update
@@ -41,6 +136,39 @@ public:
      */
     bool updateMix(const Mix& mix);
 
+    /**
+     * @brief Write a batch of mixes in one transaction
+     *
+     * Mixes already in the library are updated in place (keeping their analysis
+     * and seek index), others are inserted or replace a deleted row; each kind
+     * goes through one prepared statement reused for every row. A row that fails
+     * is counted and skipped; if the transaction itself fails nothing is written.
+     * @param upserts Whole rows to write
+     * @param soft_delete_ids Mixes to mark deleted
+     * @param stats Filled with the row counts and time taken
+     * @return False if the transaction could not be started or committed
+     */
+    bool ingestMixes(const std::vector<Mix>& upserts, const std::vector<std::string>& soft_delete_ids,
+                     MixIngestStats& stats);
+
+    /**
+     * @brief The entry hashes of the manifest as last applied, keyed by mix id
+     * @return False if they could not be read
+     */
+    bool getManifestHashes(std::unordered_map<std::string, uint64_t>& hashes);
+
+    /**
+     * @brief Apply a manifest diff and store its entry hashes, in one ingestMixes transaction
+     *
+     * Changed entries whose mix is in the library update its URL, metadata and
+     * tags; the rest are only remembered, as mixes join the library once
+     * downloaded. A removed entry forgets its hash and leaves a downloaded mix
+     * where it is.
+     * @param stats Filled as by ingestMixes
+     * @return False if the transaction failed, in which case no hash was stored
+     */
+    bool ingestManifest(const ManifestDiff& diff, MixIngestStats& stats);
+
     /**
      * @brief Delete a mix from the database
      * @param id Mix ID to delete
@@ -61,6 +189,34 @@ public:
      */
     std::vector<Mix> getAllMixes();
 
+    /**
+     * @brief In-memory copy of the non-deleted mixes, kept in step with every write made here
+     *
+     * Null until initialize. Prefer its snapshots to getAllMixes, which copies every mix.
+     */
+    std::shared_ptr<MixCatalog> getCatalog() const {
+        return catalog_;
+    }
+
+    /**
+     * @brief Feature vectors of the catalog's mixes, following it through a listener
+     *
+     * Null until initialize.
+     */
+    std::shared_ptr<MixSimilarityIndex> getSimilarityIndex() const {
+        return similarity_;
+    }
+
+    /**
+     * @brief Percentage of smart picks that follow on from the excluded mix with a similar one, 0 to never
+     */
+    void setSimilarMixProbability(int probability);
+
+    /**
+     * @brief Reseed the random picks
+     */
+    void setSelectionSeed(uint32_t seed);
+
     /**
      * @brief Get mixes by genre
      * @param genre Genre to filter by
@@ -75,6 +231,51 @@ public:
      */
     std::vector<Mix> getMixesByArtist(const std::string& artist);
 
+    /**
+     * @brief Get mixes carrying a tag, through the mix_tags index
+     * @param tag Tag to filter by, matched case-insensitively
+     * @return Vector of mixes with the tag, ordered by title
+     */
+    std::vector<Mix> getMixesByTag(const std::string& tag);
+
+    /**
+     * @brief Find mixes by keyword in their title, artist, description or tags
+     *
+     * Goes through the FTS5 index, ranked by bm25 with title matches first; each
+     * word is a prefix, so a half-typed query already finds mixes.
+     * @param query Words as typed; all must match
+     * @param limit Maximum number of mixes to return
+     * @return Best matches first, empty for an empty query
+     */
+    std::vector<Mix> searchMixes(const std::string& query, int limit = Constants::SEARCH_RESULT_LIMIT);
+
+    /**
+     * @brief Stream the stored mixes matching the criteria, one row at a time
+     *
+     * Nothing is collected, so a pass over the whole library runs in constant
+     * memory. Rows come from the table, not the catalog: writes still queued
+     * are not seen yet, and tags are not loaded.
+     * @param criteria Selection criteria; its limit and after_id apply too
+     * @param visit Called for each mix; returning false ends the pass
+     * @param order Ordering option
+     * @return False if the query could not be run
+     */
+    bool forEachMix(const SelectionCriteria& criteria, const std::function<bool(const Mix&)>& visit,
+                    OrderBy order = OrderBy::None);
+
+    /**
+     * @brief Read one page of mixes in id order
+     *
+     * Pages by keyset (id > after_id) rather than OFFSET, so each page costs
+     * the same however deep into the library it is.
+     * @param after_id Last id of the previous page, empty for the first page
+     * @param limit Page size
+     * @param criteria Further filters for every page
+     * @return Up to limit mixes; a short page is the last one
+     */
+    std::vector<Mix> getMixPage(const std::string& after_id, int limit,
+                                SelectionCriteria criteria = SelectionCriteria());
+
     /**
      * @brief Get a random mix
      * @return Random mix, or empty mix if none available
@@ -127,6 +328,66 @@ public:
      */
     bool updatePlayStats(const std::string& mix_id);
 
+    /**
+     * @brief Append an ended play to the play history
+     *
+     * The mix's aggregate row (plays, skips, skip streak, last play) follows by
+     * trigger, and the selection index weights the mix down from now on.
+     * @param event The play, stamped with its start time
+     * @return True if successful, false otherwise
+     */
+    bool recordPlayEvent(const PlayEvent& event);
+
+    /**
+     * @brief Aggregate over a mix's play events
+     * @return The stats, all zero if the mix was never played
+     */
+    MixPlayStats getPlayStats(const std::string& mix_id);
+
+    /**
+     * @brief Play events starting at or after a time, oldest first
+     * @param since_ms Epoch milliseconds
+     */
+    std::vector<PlayEvent> getPlayEventsSince(int64_t since_ms);
+
+    /**
+     * @brief The next batch of changes for the sync server
+     *
+     * Play events after the last one sent, folded per mix, and favorite changes not
+     * sent yet, oldest first. The node id is made on first use.
+     * @return False if they could not be read; nothing to send is not an error
+     */
+    bool getSyncDelta(MixSyncDelta& delta, int max_events, int max_favorites);
+
+    /**
+     * @brief Mark a delta the server took as sent and merge its reply, in one transaction
+     *
+     * Play counts and last plays take the larger of the local and the fleet-wide value;
+     * a favorite goes to whichever node set it last, so a newer local change stands until
+     * it is sent. Merged mixes are written through to the catalog and the selection index.
+     */
+    bool applySyncReply(const MixSyncDelta& sent, const MixSyncReply& reply);
+
+    /**
+     * @brief Queued versions of the per-mix writes, for threads that must not wait on SQLite
+     *
+     * The catalog and the selection index show the change as soon as it is queued;
+     * a writer thread then commits it in one transaction with whatever else is
+     * queued, folding repeated changes to the same mix. Before initialize they write
+     * synchronously.
+     * @return Resolved once the batch holding the change is committed (false if it failed)
+     */
+    std::future<bool> queueToggleFavorite(const std::string& mix_id);
+    std::future<bool> queueSoftDelete(const std::string& mix_id);
+    std::future<bool> queueRecordPlay(const std::string& mix_id);
+    std::future<bool> queuePlayEvent(const PlayEvent& event);
+    std::future<bool> queueLocalPath(const std::string& mix_id, const std::string& local_path);
+
+    /**
+     * @brief Wait until every queued write has been committed
+     */
+    void flushWrites();
+
     /**
      * @brief Set local file path for a mix
      * @param mix_id Mix ID
@@ -135,6 +396,114 @@ public:
      */
     bool setLocalPath(const std::string& mix_id, const std::string& local_path);
 
+    /**
+     * @brief Store the size of each downloaded mix file, which the running total follows, in one transaction
+     * @return True if successful, false otherwise
+     */
+    bool recordMixFiles(const std::vector<CachedMixFile>& files);
+
+    /**
+     * @brief The running total of the recorded mix files
+     * @return False if it could not be read
+     */
+    bool getMixCacheUsage(int64_t& total_bytes, int64_t& file_count);
+
+    /**
+     * @brief Downloaded mixes whose file has no recorded size, e.g. ones from before the cache
+     */
+    std::vector<CachedMixFile> getUnsizedMixFiles(int limit);
+
+    /**
+     * @brief Recorded files in the order they are to be evicted; favorites are never among them
+     */
+    std::vector<CachedMixFile> getEvictionCandidates(int limit);
+
+    /**
+     * @brief Forget the file of an evicted mix, which stays in the library to be downloaded again
+     * @return True if successful, false otherwise
+     */
+    bool clearLocalPath(const std::string& mix_id);
+
+    /**
+     * @brief Store the content hash of a mix's downloaded file, replacing any earlier one
+     * @param content_hash Hex XXH64 of the file, as ContentHasher::hexDigest gives it
+     * @return True if successful, false otherwise
+     */
+    bool setContentHash(const std::string& mix_id, const std::string& content_hash);
+
+    /**
+     * @brief The content hash of a mix's downloaded file; empty if none was stored
+     */
+    std::string getContentHash(const std::string& mix_id);
+
+    /**
+     * @brief Another live, downloaded mix whose file has this content hash
+     * @return The mix, or one with an empty id if there is none
+     */
+    Mix findMixByContentHash(const std::string& content_hash, const std::string& exclude_mix_id);
+
+    /**
+     * @brief Every live, downloaded mix that has a content hash
+     */
+    std::vector<MixFileHash> getMixFileHashes();
+
+    /**
+     * @brief Store a mix's run of failed downloads, replacing any earlier one
+     * @return True if successful, false otherwise
+     */
+    bool setDownloadFailure(const DownloadFailure& failure);
+
+    /**
+     * @brief Forget a mix's failed downloads, once one succeeded
+     * @return True if successful, false otherwise
+     */
+    bool clearDownloadFailure(const std::string& mix_id);
+
+    /**
+     * @brief Every stored run of failed downloads, for DownloadBackoff::load
+     */
+    std::vector<DownloadFailure> getDownloadFailures();
+
+    /**
+     * @brief Whether a mix other than mix_id has local_path as its file
+     */
+    bool isLocalPathShared(const std::string& local_path, const std::string& mix_id);
+
+    /**
+     * @brief Store the ingest analysis of a mix file
+     * @param mix_id Mix ID
+     * @param loudness_lufs Integrated loudness (EBU R128)
+     * @param peak_dbfs Sample peak
+     * @param bpm Estimated tempo, 0 if unknown
+     * @param spectral_centroid_hz Mean spectral centroid, 0 if unknown
+     * @return True if successful, false otherwise
+     */
+    bool setMixAnalysis(const std::string& mix_id, double loudness_lufs, double peak_dbfs, double bpm,
+                        double spectral_centroid_hz = 0.0);
+
+    /**
+     * @brief Store the serialized seek index of a mix file
+     * @param mix_id Mix ID
+     * @param seek_index Output of SeekIndex::serialize
+     * @return True if successful, false otherwise
+     */
+    bool setSeekIndex(const std::string& mix_id, const std::string& seek_index);
+
+    /**
+     * @brief Get the serialized seek index of a mix
+     *
+     * Kept out of Mix so list queries don't carry every index along.
+     * @param mix_id Mix ID
+     * @return Serialized index, or empty string if none is stored
+     */
+    std::string getSeekIndex(const std::string& mix_id);
+
+    /**
+     * @brief Get downloaded mixes that have not been analyzed yet
+     * @return Vector of mixes without loudness data or seek index
+     */
+    std::vector<Mix> getUnanalyzedMixes();
+
     /**
      * @brief Get mixes that are downloaded locally
      * @return Vector of downloaded mixes
@@ -148,17 +517,27 @@ public:
     std::vector<Mix> getFavoriteMixes();
 
     /**
-     * @brief Get recently played mixes
+     * @brief Get recently played mixes, most recent first
      * @param limit Maximum number of mixes to return
+     * @param since_ms Only mixes last played at or after this epoch ms, 0 for any played mix
      * @return Vector of recently played mixes
      */
-    std::vector<Mix> getRecentlyPlayed(int limit = 10);
+    std::vector<Mix> getRecentlyPlayed(int limit = 10, int64_t since_ms = 0);
+
+    /**
+     * @brief Per-query latency and row counts, when the tuning asked for them
+     * @return nullptr unless opened with SqliteTuning::query_stats
+     */
+    std::shared_ptr<SqliteQueryStats> getQueryStats() const {
+        return query_stats_;
+    }
 
     /**
      * @brief Get the last error message
      * @return Error message string
      */
     std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(error_mutex_);
         return last_error;
     }
 
@@ -167,6 +546,7 @@ public:
      * @return True if successful, false otherwise
      */
     bool isSuccess() const {
+        std::lock_guard<std::mutex> lock(error_mutex_);
         return success;
     }
 
@@ -174,20 +554,115 @@ private:
     std::shared_ptr<IDatabaseConnection> connection_;
     std::unique_ptr<MixValidator> validator_;
     std::unique_ptr<SmartMixSelector> selector_;
+    std::shared_ptr<MixSelectionIndex> index_;        // Follows every write below; the selector samples it
+    std::shared_ptr<MixCatalog> catalog_;             // Same, with whole rows
+    std::shared_ptr<MixSimilarityIndex> similarity_;  // Follows the catalog
     std::string db_path_;
+    std::shared_ptr<SqliteQueryStats> query_stats_;
+    std::atomic<int> search_indexed_{-1};  // 1 if mixes_fts is kept in step, 0 to scan the catalog, -1 until read
+    mutable std::mutex error_mutex_;       // Downloads, the writer thread and the caller all report errors
+    std::mutex write_mutex_;               // Single writer: write transactions take turns on the file
+    // When PRAGMA optimize last ran, under write_mutex_
+    std::chrono::steady_clock::time_point last_optimize_;
+    std::string shared_catalog_path_;
+    std::string file_mappings_path_;
+    std::unique_ptr<SharedCatalog> shared_;  // Null unless the catalog is shared
+    int shared_listener_ = 0;
+    std::atomic<bool> shared_publishing_{false};
+    std::atomic<bool> shared_stale_{false};  // Publisher: the catalog changed since it was published
+    uint64_t shared_writes_ = 0;             // Publisher: the write count when the table was last read
+    std::unique_ptr<MixWriteQueue> writes_;  // Last: drained before the members it writes through go away
+
+    /**
+     * @brief Hides ErrorHandler::setError to take error_mutex_
+     */
+    void setError(const std::string& error);
 
     /**
-     * @brief Create database tables
+     * @brief Bring the schema to the current version through SchemaMigrator
      * @return True if successful, false otherwise
      */
     bool createTables();
 
     /**
-     * @brief Convert database row to mix
-     * @param stmt Database statement
-     * @return Mix object
+     * @brief Whether searches can go through mixes_fts
+     */
+    bool isSearchIndexed();
+
+    /**
+     * @brief Re-read one row into the catalog after a write to it
+     */
+    void writeThrough(const std::string& id);
+
+    /**
+     * @brief Rebuild the catalog and the selection index from one full read
+     */
+    void reloadCaches();
+
+    /**
+     * @brief Every non-deleted row with its tags, row by row into builder
+     */
+    void readCatalog(MixCatalogBuilder& builder);
+
+    /**
+     * @brief Replace the catalog and rebuild the selection index around it, with the stored play history
+     */
+    void loadCaches(MixCatalog::Snapshot snapshot);
+
+    /**
+     * @brief Open the shared catalog and, unless this instance publishes, load the catalog from it
+     * @return True if the catalog was loaded
+     */
+    bool loadSharedCatalog();
+
+    /**
+     * @brief Bring the catalog and the selection index to another version of the library
+     *
+     * Mix by mix up to SHARED_CATALOG_MERGE_LIMIT changes, so readers keep their queues; past that reloaded.
+     * @return False if the versions hold the same mixes
+     */
+    bool mergeCatalog(const MixCatalog::Snapshot& fresh);
+
+    /**
+     * @brief Fill in the tags of the given mixes from one pass over mix_tags
+     */
+    void attachTags(std::vector<Mix>& mixes);
+
+    /**
+     * @brief Copy the tags of a library from before mix_tags out of the JSON column
+     */
+    bool migrateTags();
+
+    /**
+     * @brief ingestMixes, also storing a manifest diff's hashes when one is given
+     */
+    bool ingest(const std::vector<Mix>& upserts, const std::vector<std::string>& soft_delete_ids,
+                const ManifestDiff* manifest, MixIngestStats& stats);
+
+    /**
+     * @brief Inside ingest's transaction: record the added and changed entries, forget the removed
+     */
+    bool writeManifestHashes(const ManifestDiff& diff);
+
+    /**
+     * @brief Replace a mix's rows in mix_tags, preparing the statements on first use
+     */
+    bool replaceTags(const Mix& mix, std::unique_ptr<IStatement>& clear, std::unique_ptr<IStatement>& insert);
+
+    /**
+     * @brief Writer thread: commit one batch of queued writes in a transaction
+     */
+    bool executeWrites(const std::vector<MixWrite>& batch);
+
+    /**
+     * @brief Replace the catalog's previews with the stored rows, or drop them all if the batch failed
+     */
+    void settleWrites(const std::vector<MixWrite>& batch, bool ok);
+
+    /**
+     * @brief Show a queued change in the catalog before it is written
      */
-    Mix statementToMix(IStatement& stmt);
+    void previewMix(const std::string& id, const std::function<void(Mix&)>& change);
 
     /**
      * @brief Execute a query and return vector of mixes
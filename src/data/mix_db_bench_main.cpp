@@ -0,0 +1,229 @@
+// Bulk ingest rate, keyword search time and write latency of the mix database while other connections read it,
+// per journal profile, and the time of a similar-mix query over the same library.
+// Usage: autovibez_db_bench [--mixes N] [--writes N] [--readers N] [--top N]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mix_database.hpp"
+#include "mix_similarity_index.hpp"
+#include "sqlite_connection.hpp"
+#include "uuid_utils.hpp"
+
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Data::SelectionCriteria;
+using AutoVibez::Data::SqliteTuning;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+struct Settings {
+    int mixes = 1000;
+    int writes = 500;
+    int readers = 2;
+    int top = 0;  // Slowest queries by total time to list per profile
+};
+
+std::string benchUrl(int index) {
+    return "https://example.com/bench-" + std::to_string(index) + ".mp3";
+}
+
+// Keyed as manifest mixes are, so the table and its indexes hold the packed ids
+std::string benchId(int index) {
+    return AutoVibez::Utils::HashIdUtils::generateIdFromUrl(benchUrl(index));
+}
+
+Mix makeMix(int index) {
+    Mix mix;
+    mix.url = benchUrl(index);
+    mix.id = benchId(index);
+    mix.title = "Benchmark mix " + std::to_string(index);
+    mix.artist = "Artist " + std::to_string(index % 50);
+    mix.genre = index % 2 ? "Techno" : "House";
+    mix.duration_seconds = 3600;
+    mix.tags = {"bench", "tag"};
+    // Enough vocabulary that common words match many mixes and rare pairs few
+    static const char* const words[] = {"deep",  "acid",   "warehouse", "sunrise", "vinyl", "minimal",
+                                        "disco", "garage", "melodic",   "dub",     "live",  "festival"};
+    const size_t count = sizeof(words) / sizeof(words[0]);
+    mix.description = std::string(words[index % count]) + " " + words[(index / count) % count] + " session";
+    return mix;
+}
+
+// Nearest rank, as the frame profiler reports
+double rank(const std::vector<double>& sorted, double fraction) {
+    const size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(index, 1)) - 1];
+}
+
+void printTopQueries(const char* name, const AutoVibez::Data::SqliteQueryStats& stats, int top) {
+    const std::vector<AutoVibez::Data::QueryStats> queries = stats.snapshot();
+    for (size_t i = 0; i < queries.size() && i < static_cast<size_t>(top); ++i) {
+        const AutoVibez::Data::QueryStats& query = queries[i];
+        std::string sql = query.sql;
+        std::replace(sql.begin(), sql.end(), '\n', ' ');
+        std::printf("%-5s query %9.1f ms %7llu calls  p99 %8.3f ms%s  %.80s\n", name, query.total_ms,
+                    static_cast<unsigned long long>(query.calls), query.p99_ms, query.full_scan ? "  SCAN" : "",
+                    sql.c_str());
+    }
+}
+
+// In memory only, so once rather than per profile; every mix downloaded and analyzed, so each one is a candidate
+void runSimilarity(const Settings& settings) {
+    AutoVibez::Data::MixCatalogBuilder builder;
+    for (int i = 0; i < settings.mixes; ++i) {
+        Mix mix = makeMix(i);
+        mix.local_path = "/bench/" + mix.id + ".mp3";
+        mix.has_analysis = true;
+        mix.bpm = 90.0 + (i * 37) % 80;
+        mix.loudness_lufs = -20.0 + (i * 13) % 14;
+        mix.spectral_centroid_hz = 1000.0 + (i * 211) % 4000;
+        builder.add(mix);
+    }
+    const auto build_start = Clock::now();
+    AutoVibez::Data::MixSimilarityIndex index;
+    index.rebuild(*builder.build());
+    const double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+
+    const int runs = 200;
+    std::vector<double> latencies;
+    latencies.reserve(runs);
+    for (int i = 0; i < runs; ++i) {
+        const std::string id = benchId((i * 7919) % settings.mixes);
+        const auto start = Clock::now();
+        index.nearest(id, "", 8);
+        latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("similar index built in %.1f ms, nearest 8 ms p50 %7.3f  p99 %7.3f\n", build_ms, rank(latencies, 0.50),
+                rank(latencies, 0.99));
+}
+
+bool runProfile(const char* name, SqliteTuning tuning, const Settings& settings) {
+    if (settings.top > 0) {
+        tuning.query_stats = std::make_shared<AutoVibez::Data::SqliteQueryStats>(true);
+    }
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "autovibez_db_bench.db";
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::filesystem::remove(path.string() + suffix);
+    }
+
+    bool ok = true;
+    {
+        MixDatabase writer(path.string(), tuning);
+        if (!writer.initialize()) {
+            std::fprintf(stderr, "%s: %s\n", name, writer.getLastError().c_str());
+            return false;
+        }
+        std::vector<Mix> library;
+        for (int i = 0; i < settings.mixes; ++i) {
+            library.push_back(makeMix(i));
+        }
+        AutoVibez::Data::MixIngestStats ingest;
+        if (!writer.ingestMixes(library, {}, ingest)) {
+            std::fprintf(stderr, "%s: %s\n", name, writer.getLastError().c_str());
+            return false;
+        }
+        std::printf("%-5s ingest %d rows in %.3f s (%.0f rows/s)\n", name, ingest.inserted, ingest.seconds,
+                    ingest.rowsPerSecond());
+
+        // From a mix number that matches one mix to a word that matches them all
+        for (const char* query : {"mix 4242", "acid vinyl", "artist 7", "deep", "benchmark"}) {
+            const int runs = 20;
+            size_t found = 0;
+            const auto searchStart = Clock::now();
+            for (int i = 0; i < runs; ++i) {
+                found = writer.searchMixes(query).size();
+            }
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - searchStart).count() / runs;
+            std::printf("%-5s search %-12s %3zu results in %7.3f ms\n", name, query, found, ms);
+        }
+
+        // Readers on their own connections, as the UI and download threads would be
+        std::atomic<bool> stop{false};
+        std::atomic<long> reads{0};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < settings.readers; ++r) {
+            readers.emplace_back([&]() {
+                MixDatabase reader(path.string(), tuning);
+                if (!reader.initialize()) {
+                    return;
+                }
+                // Streamed from the table; the catalog would answer without touching SQLite
+                while (!stop.load()) {
+                    reader.forEachMix(SelectionCriteria(), [](const Mix&) { return true; });
+                    reads.fetch_add(1);
+                }
+            });
+        }
+
+        std::vector<double> latencies;
+        latencies.reserve(static_cast<size_t>(settings.writes));
+        const auto start = Clock::now();
+        for (int i = 0; i < settings.writes; ++i) {
+            const std::string id = benchId(i % settings.mixes);
+            const auto writeStart = Clock::now();
+            if (!writer.updatePlayStats(id)) {
+                ok = false;
+            }
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - writeStart).count());
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        stop.store(true);
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("%-5s write ms p50 %8.3f  p99 %8.3f  max %8.3f  | %6.1f full reads/s%s\n", name,
+                    rank(latencies, 0.50), rank(latencies, 0.99), latencies.back(),
+                    static_cast<double>(reads.load()) / seconds, ok ? "" : "  (some writes failed)");
+    }
+
+    if (tuning.query_stats) {
+        printTopQueries(name, *tuning.query_stats, settings.top);
+    }
+
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::filesystem::remove(path.string() + suffix);
+    }
+    return ok;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        const int value = std::atoi(argv[i + 1]);
+        if (arg == "--mixes") {
+            settings.mixes = value;
+        } else if (arg == "--writes") {
+            settings.writes = value;
+        } else if (arg == "--readers") {
+            settings.readers = value;
+        } else if (arg == "--top") {
+            settings.top = value;
+        }
+    }
+    if (settings.mixes <= 0 || settings.writes <= 0 || settings.readers < 0 || settings.top < 0) {
+        std::fprintf(stderr, "Usage: autovibez_db_bench [--mixes N] [--writes N] [--readers N] [--top N]\n");
+        return 2;
+    }
+
+    std::printf("%d mixes, %d play-count updates, %d reader threads\n", settings.mixes, settings.writes,
+                settings.readers);
+    const bool safe = runProfile("safe", SqliteTuning::safe(), settings);
+    const bool fast = runProfile("fast", SqliteTuning::fast(), settings);
+    runSimilarity(settings);
+    return safe && fast ? 0 : 1;
+}
@@ -1,17 +1,23 @@
 #include "mix_downloader.hpp"
 
-#include <curl/curl.h>
-
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <vector>
 
 #include "console_output.hpp"
 #include "constants.hpp"
+#include "download_writer.hpp"
 #include "mix_metadata.hpp"
 #include "mp3_analyzer.hpp"
 #include "path_manager.hpp"
 #include "path_utils.hpp"
+#include "rate_meter.hpp"
+#include "trace_recorder.hpp"
+#include "transfer_engine.hpp"
 
 using AutoVibez::Data::FileHandle;
 using AutoVibez::Data::MixDownloader;
@@ -20,18 +26,11 @@ using AutoVibez::Data::MixDownloader;
 constexpr size_t FILE_PROTOCOL_LENGTH = 7;
 constexpr const char* INVALID_FILENAME_CHARS = "\\/:*?\"<>|";
 
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    userp->append(static_cast<const char*>(contents), size * nmemb);
-    return size * nmemb;
-}
-
-static size_t WriteFileCallback(void* contents, size_t size, size_t nmemb, FILE* file) {
-    return fwrite(contents, size, nmemb, file);
-}
-
-static int ProgressCallback(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow) {
-    (void)clientp, (void)ultotal, (void)ulnow, (void)dltotal, (void)dlnow;
-    return 0;
+static void markDownloadComplete(AutoVibez::Utils::DownloadProgress* progress, bool failed) {
+    if (progress) {
+        progress->failed.store(failed, std::memory_order_relaxed);
+        progress->complete.store(true, std::memory_order_release);
+    }
 }
 
 // FileHandle RAII implementation
@@ -64,29 +63,35 @@ FileHandle& FileHandle::operator=(FileHandle&& other) noexcept {
 namespace AutoVibez {
 namespace Data {
 
-MixDownloader::MixDownloader(const std::string& mixes_dir) : mixes_dir(mixes_dir) {
-    initializeCurl();
+MixDownloader::MixDownloader(const std::string& mixes_dir)
+    : mixes_dir(mixes_dir), mappings_path_(PathManager::getFileMappingsPath()) {}
+
+MixDownloader::~MixDownloader() = default;
+
+void MixDownloader::setSegmentedDownload(int64_t min_bytes, int64_t segment_bytes) {
+    segmented_min_bytes_ = min_bytes;
+    segment_bytes_ = std::max<int64_t>(segment_bytes, 1);
 }
 
-MixDownloader::~MixDownloader() {
-    cleanupCurl();
+void MixDownloader::setBandwidthGovernor(std::shared_ptr<AutoVibez::Utils::BandwidthGovernor> governor) {
+    governor_ = std::move(governor);
 }
 
-bool MixDownloader::initializeCurl() {
-    CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
-    if (res != CURLE_OK) {
-        // CURL might already be initialized, which is fine
-        // We'll handle this gracefully
-        setError(std::string(StringConstants::CURL_INIT_ERROR) + ": " + curl_easy_strerror(res));
-        return false;
-    }
-    return true;
+void MixDownloader::setPeerCache(std::shared_ptr<PeerCache> peer_cache) {
+    // Download threads read it as they start each mix
+    std::atomic_store(&peer_cache_, std::move(peer_cache));
 }
 
-void MixDownloader::cleanupCurl() {
-    // Cleanup CURL - this is safe to call even if not initialized
-    // or if other parts of the application are using CURL
-    curl_global_cleanup();
+void MixDownloader::governRequest(AutoVibez::Utils::TransferRequest& request,
+                                  AutoVibez::Utils::DownloadProgress* progress) const {
+    if (!governor_) {
+        return;
+    }
+    request.governor = governor_;
+    request.timeout_seconds = 0;
+    if (progress) {
+        request.uncapped = [progress]() { return progress->full_speed.load(std::memory_order_relaxed); };
+    }
 }
 
 bool MixDownloader::isValidMixId(const std::string& mix_id) {
@@ -112,45 +117,478 @@ bool MixDownloader::copyLocalFile(const std::string& source_path, const std::str
     }
 }
 
-bool MixDownloader::downloadFileWithCurl(const std::string& url, const std::string& file_path) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        setError(StringConstants::CURL_INIT_ERROR);
-        return false;
+void MixDownloader::StreamDigest::feed(const char* data, size_t size) {
+    hasher.update(data, size);
+    check.feed(reinterpret_cast<const unsigned char*>(data), size);
+}
+
+void MixDownloader::StreamDigest::feedFile(FILE* file, int64_t from, int64_t to) {
+    std::vector<char> chunk(static_cast<size_t>(std::min<int64_t>(to - from, Constants::CONTENT_HASH_READ_BYTES)));
+    if (std::fseek(file, static_cast<long>(from), SEEK_SET) != 0) {
+        failed = true;
+        return;
     }
+    while (from < to) {
+        const size_t want = static_cast<size_t>(std::min<int64_t>(to - from, static_cast<int64_t>(chunk.size())));
+        if (fread(chunk.data(), 1, want, file) != want) {
+            failed = true;
+            return;
+        }
+        feed(chunk.data(), want);
+        from += static_cast<int64_t>(want);
+    }
+}
 
-    // Use RAII for file handle
-    FileHandle file_handle(file_path, "wb");
-    if (!file_handle.isValid()) {
-        setError(std::string(StringConstants::FILE_CREATE_ERROR) + ": " + file_path);
-        curl_easy_cleanup(curl);
+bool MixDownloader::downloadFile(const std::string& url, const std::string& file_path,
+                                 AutoVibez::Utils::DownloadProgress* progress, bool resumable, StreamDigest* digest,
+                                 bool governed) {
+    const std::string state_path = file_path + StringConstants::RESUME_STATE_EXTENSION;
+    ResumeState state;
+    int64_t resume_from = 0;
+    if (resumable) {
+        state = loadResumeState(state_path);
+        std::error_code size_error;
+        const auto partial = static_cast<int64_t>(std::filesystem::file_size(file_path, size_error));
+        // A partial file shorter than recorded was truncated or replaced; it can't be continued
+        if (!size_error && state.url == url && !state.validator.empty() && partial > 0 && state.received <= partial) {
+            resume_from = partial;
+        }
+    }
+    if (resume_from == 0) {
+        std::error_code remove_error;
+        std::filesystem::remove(state_path, remove_error);
+        state = ResumeState{url, std::string(), 0};
+    }
+    if (resumable && resume_from == 0 && segmented_min_bytes_ > 0) {
+        const RangeProbe probe = probeRanges(url);
+        if (probe.total >= segmented_min_bytes_) {
+            return downloadSegmented(url, file_path, probe, progress, digest);
+        }
+    }
+    if (digest && resume_from > 0) {
+        // The bytes from the earlier attempt were not seen by this digest; they are still in the page cache
+        FileHandle prefix(file_path, "rb");
+        if (prefix.isValid()) {
+            digest->feedFile(prefix.get(), 0, resume_from);
+        } else {
+            digest->failed = true;
+        }
+    }
+
+    AutoVibez::Utils::TransferResult result;
+    int64_t written = resume_from;
+    std::string etag;
+    std::string last_modified;
+    int64_t content_length = 0;
+    {
+        // Use RAII for file handle
+        FileHandle file_handle(file_path, resume_from > 0 ? "ab" : "wb");
+        if (!file_handle.isValid()) {
+            setError(std::string(StringConstants::FILE_CREATE_ERROR) + ": " + file_path);
+            return false;
+        }
+
+        // The shared engine runs the transfer on its own thread, on a connection it may already have open
+        AutoVibez::Utils::DownloadWriter writer(file_handle.get(), resume_from);
+        AutoVibez::Utils::TransferRequest request;
+        request.url = url;
+        request.timeout_seconds = Constants::DOWNLOAD_TIMEOUT_SECONDS;
+        request.low_speed_limit = Constants::MIN_DOWNLOAD_SPEED_BYTES_PER_SEC;
+        request.low_speed_seconds = Constants::DOWNLOAD_LOW_SPEED_TIME_SECONDS;
+        if (governed) {
+            governRequest(request, progress);
+        }
+        if (resume_from > 0) {
+            // The server sends the rest only while the file is unchanged, else all of it, which curl refuses
+            request.resume_from = resume_from;
+            request.headers.push_back("If-Range: " + state.validator);
+            request.fail_on_http_error = true;
+            if (progress) {
+                progress->bytes_written.store(resume_from, std::memory_order_release);
+                progress->retries.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        request.on_header = [&](const std::string& name, const std::string& value) {
+            if (name == "etag") {
+                etag = value;
+            } else if (name == "last-modified") {
+                last_modified = value;
+            } else if (name == "content-length") {
+                content_length = std::strtoll(value.c_str(), nullptr, 10);  // Of the remainder when resumed
+            }
+        };
+        bool first_chunk = true;
+        request.on_data = [&, progress](const char* data, size_t size) {
+            if (first_chunk) {
+                // Written before the first byte, so a crash mid-transfer still leaves a resumable file
+                if (resumable) {
+                    state.validator = resumeValidator(etag, last_modified);
+                    if (!state.validator.empty()) {
+                        saveResumeState(state_path, state);
+                    }
+                }
+                writer.reserve(resume_from + content_length);
+                first_chunk = false;
+            }
+
+            // Playback reads the file as it grows, and soon: write it in small pieces and keep it cached
+            const bool streamed = progress && progress->full_speed.load(std::memory_order_relaxed);
+            writer.setDropCache(!streamed);
+            const size_t flush_bytes =
+                streamed ? Constants::DOWNLOAD_STREAMING_FLUSH_BYTES : Constants::DOWNLOAD_WRITE_BUFFER_BYTES;
+            if (!writer.write(data, size, flush_bytes)) {
+                return false;
+            }
+            if (digest) {
+                digest->feed(data, size);
+            }
+            if (progress) {
+                // Bytes only count once a reader of the partial file can see them
+                progress->bytes_written.store(writer.getFlushedBytes(), std::memory_order_release);
+            }
+            return true;
+        };
+        AutoVibez::Utils::RateMeter rate;
+        request.on_progress = [progress, resume_from, &rate](int64_t received, int64_t total) {
+            if (!progress) {
+                return true;
+            }
+            if (total > 0) {
+                // A resumed transfer reports the length of the remainder only
+                progress->total_bytes.store(resume_from + total, std::memory_order_relaxed);
+            }
+            if (rate.sample(received)) {
+                progress->bytes_per_second.store(rate.getBytesPerSecond(), std::memory_order_relaxed);
+            }
+            return !progress->cancelled.load(std::memory_order_relaxed);
+        };
+
+        result = AutoVibez::Utils::TransferEngine::shared().perform(request);
+        if (!writer.flush() && result.ok) {
+            result.ok = false;
+            result.code = CURLE_WRITE_ERROR;
+            result.error = "Failed to write " + file_path;
+        }
+        written = writer.getFlushedBytes();
+        if (progress) {
+            progress->bytes_written.store(written, std::memory_order_release);
+        }
+    }
+
+    if (!result.ok) {
+        std::error_code remove_error;
+        const bool refused =
+            resume_from > 0 && (result.code == CURLE_RANGE_ERROR || result.code == CURLE_HTTP_RETURNED_ERROR);
+        if (refused && !(progress && progress->cancelled.load(std::memory_order_relaxed))) {
+            // No ranges, or the file changed since the partial one was written: start over once
+            std::filesystem::remove(file_path, remove_error);
+            std::filesystem::remove(state_path, remove_error);
+            if (progress) {
+                progress->bytes_written.store(0, std::memory_order_release);
+                progress->total_bytes.store(0, std::memory_order_relaxed);
+                progress->retries.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (digest) {
+                *digest = StreamDigest();
+            }
+            return downloadFile(url, file_path, progress, false, digest, governed);
+        }
+
+        setError(std::string(StringConstants::CURL_DOWNLOAD_ERROR) + ": " + result.error);
+        if (!refused && !state.validator.empty() && written > 0) {
+            // Keep the partial file for the next attempt
+            state.received = written;
+            saveResumeState(state_path, state);
+        } else {
+            // Clean up partial file
+            std::filesystem::remove(file_path, remove_error);
+            std::filesystem::remove(state_path, remove_error);
+        }
         return false;
     }
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteFileCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, file_handle.get());
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
-    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, ProgressCallback);
-    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, nullptr);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, Constants::DOWNLOAD_TIMEOUT_SECONDS);
-    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, Constants::MIN_DOWNLOAD_SPEED_BYTES_PER_SEC);
-    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, Constants::DOWNLOAD_LOW_SPEED_TIME_SECONDS);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        setError(std::string(StringConstants::CURL_DOWNLOAD_ERROR) + ": " + curl_easy_strerror(res));
-        // Clean up partial file
-        std::filesystem::remove(file_path);
+    std::error_code remove_error;
+    std::filesystem::remove(state_path, remove_error);
+    return true;
+}
+
+MixDownloader::RangeProbe MixDownloader::probeRanges(const std::string& url) {
+    RangeProbe probe;
+    std::string content_range;
+    std::string etag;
+    std::string last_modified;
+    size_t received = 0;
+    AutoVibez::Utils::TransferRequest request;
+    request.url = url;
+    request.range = "0-0";
+    request.timeout_seconds = Constants::DOWNLOAD_TIMEOUT_SECONDS;
+    request.on_header = [&](const std::string& name, const std::string& value) {
+        if (name == "content-range") {
+            content_range = value;
+        } else if (name == "etag") {
+            etag = value;
+        } else if (name == "last-modified") {
+            last_modified = value;
+        }
+    };
+    // A server without ranges starts sending the whole file; stop it at once
+    request.on_data = [&received](const char*, size_t size) {
+        received += size;
+        return received <= 1;
+    };
+
+    const AutoVibez::Utils::TransferResult result = AutoVibez::Utils::TransferEngine::shared().perform(request);
+    const size_t slash = content_range.rfind('/');
+    if (!result.ok || result.response_code != 206 || slash == std::string::npos) {
+        return probe;
+    }
+    probe.total = std::strtoll(content_range.c_str() + slash + 1, nullptr, 10);  // "*" when unknown reads as 0
+    probe.validator = resumeValidator(etag, last_modified);
+    return probe;
+}
+
+bool MixDownloader::downloadSegmented(const std::string& url, const std::string& file_path, const RangeProbe& probe,
+                                      AutoVibez::Utils::DownloadProgress* progress, StreamDigest* digest) {
+    struct Segment {
+        int64_t offset;
+        int64_t length;
+        int64_t received = 0;
+        uint64_t transfer = 0;
+        bool ranged = false;  // The response is this range, not the whole file
+        bool done = false;
+    };
+    std::vector<Segment> segments;
+    for (int64_t offset = 0; offset < probe.total; offset += segment_bytes_) {
+        segments.push_back(Segment{offset, std::min(segment_bytes_, probe.total - offset)});
+    }
+    if (progress) {
+        progress->total_bytes.store(probe.total, std::memory_order_relaxed);
+    }
+
+    // Full length up front, its blocks reserved below where the file system allows, so ranges landing anywhere
+    // don't leave it in fragments
+    std::error_code size_error;
+    std::ofstream(file_path, std::ios::binary | std::ios::trunc).close();
+    std::filesystem::resize_file(file_path, static_cast<std::uintmax_t>(probe.total), size_error);
+
+    // Ranges write on the engine thread, the loop below starts and sizes them; the mutex covers both
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next = 0;
+    size_t running = 0;
+    size_t finished = 0;
+    int64_t received = 0;
+    int64_t contiguous = 0;
+    int64_t dropped = 0;  // Start of the unbroken run still in the page cache
+    std::string error;
+    AutoVibez::Utils::RateMeter rate;
+    auto contiguousBytes = [&segments]() {
+        int64_t bytes = 0;
+        for (const Segment& segment : segments) {
+            bytes += segment.received;
+            if (segment.received < segment.length) {
+                break;
+            }
+        }
+        return bytes;
+    };
+
+    {
+        FileHandle file_handle(file_path, "r+b");
+        if (size_error || !file_handle.isValid()) {
+            setError(std::string(StringConstants::FILE_CREATE_ERROR) + ": " + file_path);
+            std::filesystem::remove(file_path, size_error);
+            return false;
+        }
+        FILE* file = file_handle.get();
+        AutoVibez::Utils::DownloadWriter::reserveBlocks(file, 0, probe.total);
+
+        auto startSegment = [&](size_t index) {
+            const Segment& segment = segments[index];
+            AutoVibez::Utils::TransferRequest request;
+            request.url = url;
+            request.range = std::to_string(segment.offset) + "-" + std::to_string(segment.offset + segment.length - 1);
+            request.timeout_seconds = Constants::DOWNLOAD_TIMEOUT_SECONDS;
+            request.low_speed_limit = Constants::MIN_DOWNLOAD_SPEED_BYTES_PER_SEC;
+            request.low_speed_seconds = Constants::DOWNLOAD_LOW_SPEED_TIME_SECONDS;
+            governRequest(request, progress);
+            if (!probe.validator.empty()) {
+                // A file changed since the probe comes back whole, without the Content-Range a write needs
+                request.headers.push_back("If-Range: " + probe.validator);
+            }
+            const std::string expected_range = "bytes " + std::to_string(segment.offset) + "-";
+            request.on_header = [&, index, expected_range](const std::string& name, const std::string& value) {
+                if (name == "content-range") {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    segments[index].ranged = value.rfind(expected_range, 0) == 0;
+                }
+            };
+            request.on_data = [&, index, file](const char* data, size_t size) {
+                std::lock_guard<std::mutex> lock(mutex);
+                Segment& target = segments[index];
+                if (!target.ranged || target.received + static_cast<int64_t>(size) > target.length) {
+                    return false;
+                }
+                const int64_t at = target.offset + target.received;
+                if (std::fseek(file, static_cast<long>(at), SEEK_SET) != 0 || fwrite(data, 1, size, file) != size) {
+                    return false;
+                }
+                target.received += static_cast<int64_t>(size);
+                received += static_cast<int64_t>(size);
+                if (progress && rate.sample(received)) {
+                    progress->bytes_per_second.store(rate.getBytesPerSecond(), std::memory_order_relaxed);
+                }
+                const int64_t unbroken = contiguousBytes();
+                if (progress) {
+                    // Streaming reads from the start, so only the unbroken run counts
+                    fflush(file);
+                    progress->bytes_written.store(unbroken, std::memory_order_release);
+                }
+                if (digest && !digest->failed) {
+                    // Bytes that extend the unbroken start go in as they are; ranges that came ahead of it are
+                    // read back once it reaches them
+                    if (digest->getBytesFed() == at) {
+                        digest->feed(data, size);
+                    }
+                    if (digest->getBytesFed() < unbroken) {
+                        digest->feedFile(file, digest->getBytesFed(), unbroken);
+                    }
+                }
+                // Once hashed, the unbroken start of a background download leaves the page cache
+                const bool streamed = progress && progress->full_speed.load(std::memory_order_relaxed);
+                if (!streamed && unbroken - dropped >= Constants::DOWNLOAD_WRITE_BUFFER_BYTES) {
+                    AutoVibez::Utils::DownloadWriter::dropCachedPages(file, dropped, unbroken);
+                    dropped = std::max(dropped, unbroken - Constants::DOWNLOAD_WRITE_BUFFER_BYTES);
+                }
+                return true;
+            };
+            request.on_progress = [progress](int64_t, int64_t) {
+                return !progress || !progress->cancelled.load(std::memory_order_relaxed);
+            };
+            return AutoVibez::Utils::TransferEngine::shared().start(
+                request, [&, index](const AutoVibez::Utils::TransferResult& result) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    Segment& target = segments[index];
+                    target.done = result.ok && result.response_code == 206 && target.received == target.length;
+                    if (!target.done && error.empty()) {
+                        error = result.ok ? "Incomplete range from server" : result.error;
+                    }
+                    running--;
+                    finished++;
+                    changed.notify_all();
+                });
+        };
+
+        // Add a stream after each round of ranges while the round came in faster than the best one before
+        size_t streams = Constants::SEGMENTED_INITIAL_STREAMS;
+        bool growing = true;
+        double best_rate = 0.0;
+        auto round_start = std::chrono::steady_clock::now();
+        int64_t round_bytes = 0;
+        size_t round_finished = 0;
+        bool cancelled = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            while (error.empty() && running < streams && next < segments.size()) {
+                const size_t index = next++;
+                running++;
+                lock.unlock();
+                const uint64_t transfer = startSegment(index);
+                lock.lock();
+                segments[index].transfer = transfer;
+            }
+            if (running == 0) {
+                break;
+            }
+            const size_t seen = finished;
+            changed.wait(lock, [&]() { return finished != seen; });
+
+            if (!error.empty() && !cancelled) {
+                // One range failed: the rest can't complete the file, so stop them
+                cancelled = true;
+                for (size_t i = 0; i < next; ++i) {
+                    if (!segments[i].done) {
+                        AutoVibez::Utils::TransferEngine::shared().cancel(segments[i].transfer);
+                    }
+                }
+            }
+            if (growing && finished >= round_finished + streams) {
+                const auto now = std::chrono::steady_clock::now();
+                const double seconds = std::chrono::duration<double>(now - round_start).count();
+                const double rate = seconds > 0.0 ? static_cast<double>(received - round_bytes) / seconds : 0.0;
+                if (rate > best_rate * Constants::SEGMENTED_GROWTH_SPEEDUP) {
+                    best_rate = rate;
+                    streams = std::min<size_t>(streams + 1, Constants::SEGMENTED_MAX_STREAMS);
+                } else {
+                    // The last stream added did not pay for itself
+                    streams = std::max<size_t>(streams - 1, 1);
+                    growing = false;
+                }
+                round_start = now;
+                round_bytes = received;
+                round_finished = finished;
+            }
+        }
+        contiguous = contiguousBytes();
+    }
+
+    const std::string state_path = file_path + StringConstants::RESUME_STATE_EXTENSION;
+    std::error_code file_error;
+    if (!error.empty() || contiguous != probe.total) {
+        const std::string reason = error.empty() ? std::string("Incomplete file") : error;
+        setError(std::string(StringConstants::CURL_DOWNLOAD_ERROR) + ": " + reason);
+        if (!probe.validator.empty() && contiguous > 0) {
+            // Past the first gap the file holds holes; a single stream continues from there next time
+            std::filesystem::resize_file(file_path, static_cast<std::uintmax_t>(contiguous), file_error);
+            saveResumeState(state_path, ResumeState{url, probe.validator, contiguous});
+        } else {
+            std::filesystem::remove(file_path, file_error);
+        }
         return false;
     }
 
+    std::filesystem::remove(state_path, file_error);
     return true;
 }
 
+MixDownloader::ResumeState MixDownloader::loadResumeState(const std::string& state_path) {
+    ResumeState state;
+    std::ifstream file(state_path);
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        const std::string key = line.substr(0, equals);
+        const std::string value = line.substr(equals + 1);
+        if (key == "url") {
+            state.url = value;
+        } else if (key == "validator") {
+            state.validator = value;
+        } else if (key == "received") {
+            state.received = std::strtoll(value.c_str(), nullptr, 10);
+        }
+    }
+    return state;
+}
+
+void MixDownloader::saveResumeState(const std::string& state_path, const ResumeState& state) {
+    std::ofstream file(state_path, std::ios::trunc);
+    file << "url=" << state.url << "\n"
+         << "validator=" << state.validator << "\n"
+         << "received=" << state.received << "\n";
+}
+
+std::string MixDownloader::resumeValidator(const std::string& etag, const std::string& last_modified) {
+    // If-Range takes a strong ETag or a date; a weak ETag can't vouch for byte ranges
+    if (!etag.empty() && etag.rfind("W/", 0) != 0) {
+        return etag;
+    }
+    return last_modified;
+}
+
 bool MixDownloader::downloadMix(const Mix& mix) {
     clearError();
 
@@ -184,7 +622,7 @@ bool MixDownloader::downloadMix(const Mix& mix) {
         return false;
     }
 
-    return downloadFileWithCurl(mix.url, local_path);
+    return downloadFile(mix.url, local_path);
 }
 
 bool MixDownloader::isMixDownloaded(const std::string& mix_id) {
@@ -192,55 +630,110 @@ bool MixDownloader::isMixDownloaded(const std::string& mix_id) {
         return false;
     }
 
-    std::string local_path = getLocalPath(mix_id);
-    if (std::filesystem::exists(local_path)) {
-        return true;
+    return std::filesystem::exists(getLocalPath(mix_id));
+}
+
+std::string MixDownloader::getLocalPath(const std::string& mix_id) {
+    if (!isValidMixId(mix_id)) {
+        return "";
     }
 
-    std::string mapping_file = PathManager::getFileMappingsPath();
-    if (std::filesystem::exists(mapping_file)) {
-        std::ifstream file(mapping_file);
-        std::string line;
-        while (std::getline(file, line)) {
-            size_t pos = line.find(':');
-            if (pos != std::string::npos) {
-                std::string stored_id = line.substr(0, pos);
-                std::string filename = line.substr(pos + 1);
-                if (stored_id == mix_id) {
-                    std::string mapped_path = mixes_dir + "/" + filename;
-                    if (std::filesystem::exists(mapped_path)) {
-                        return true;
-                    }
-                }
-            }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loadMappingsLocked();
+        auto it = mappings_.find(mix_id);
+        if (it != mappings_.end()) {
+            return AutoVibez::Utils::PathUtils::joinPath(mixes_dir, it->second);
         }
     }
 
-    return false;
+    return AutoVibez::Utils::PathUtils::joinPath(mixes_dir, mix_id + StringConstants::MP3_EXTENSION);
 }
 
-std::string MixDownloader::getLocalPath(const std::string& mix_id) {
-    if (!isValidMixId(mix_id)) {
-        return "";
+void MixDownloader::setFileMappingsPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mappings_path_ = path;
+    mappings_.clear();
+    mappings_loaded_ = false;
+}
+
+void MixDownloader::loadMappingsLocked() {
+    if (mappings_loaded_) {
+        return;
+    }
+    mappings_loaded_ = true;
+
+    // A journal of "id:filename" lines; a mix renamed again appends a line, so the last one wins
+    std::ifstream file(mappings_path_);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find(':');
+        if (pos != std::string::npos && pos + 1 < line.size()) {
+            mappings_[line.substr(0, pos)] = line.substr(pos + 1);
+        }
     }
+}
 
-    std::string mapping_file = PathManager::getFileMappingsPath();
-    if (std::filesystem::exists(mapping_file)) {
-        std::ifstream file(mapping_file);
-        std::string line;
-        while (std::getline(file, line)) {
-            size_t pos = line.find(':');
-            if (pos != std::string::npos) {
-                std::string stored_id = line.substr(0, pos);
-                std::string filename = line.substr(pos + 1);
-                if (stored_id == mix_id) {
-                    return AutoVibez::Utils::PathUtils::joinPath(mixes_dir, filename);
-                }
-            }
+void MixDownloader::recordMappingLocked(const std::string& mix_id, const std::string& filename) {
+    auto it = mappings_.find(mix_id);
+    if (it != mappings_.end() && it->second == filename) {
+        return;
+    }
+    mappings_[mix_id] = filename;
+
+    // One line per write, under the caller's lock, so concurrent downloads never interleave theirs
+    std::ofstream mapping(mappings_path_, std::ios::app);
+    if (mapping.is_open()) {
+        mapping << mix_id << ":" << filename << '\n';
+    }
+}
+
+bool MixDownloader::shareFile(const std::string& mix_id, const std::string& downloaded_path,
+                              const std::string& existing_path) {
+    const std::filesystem::path existing(existing_path);
+    std::error_code error;
+    if (!isValidMixId(mix_id) || !std::filesystem::is_regular_file(existing, error) ||
+        !std::filesystem::equivalent(existing.parent_path(), mixes_dir, error)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loadMappingsLocked();
+        recordMappingLocked(mix_id, existing.filename().string());
+    }
+    if (!std::filesystem::equivalent(downloaded_path, existing, error)) {
+        std::filesystem::remove(downloaded_path, error);
+    }
+    return true;
+}
+
+bool MixDownloader::referenceFiles(const std::vector<std::pair<std::string, std::string>>& files) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loadMappingsLocked();
+    std::string lines;
+    for (const auto& file : files) {
+        if (!isValidMixId(file.first) || file.second.empty()) {
+            continue;
+        }
+        auto it = mappings_.find(file.first);
+        if (it != mappings_.end() && it->second == file.second) {
+            continue;
         }
+        mappings_[file.first] = file.second;
+        lines += file.first + ":" + file.second + '\n';
+    }
+    if (lines.empty()) {
+        return true;
     }
+    std::ofstream mapping(mappings_path_, std::ios::app);
+    mapping << lines;
+    return static_cast<bool>(mapping);
+}
 
-    return AutoVibez::Utils::PathUtils::joinPath(mixes_dir, mix_id + StringConstants::MP3_EXTENSION);
+bool MixDownloader::ownsFile(const std::string& path) const {
+    std::error_code error;
+    return std::filesystem::equivalent(std::filesystem::path(path).parent_path(), mixes_dir, error);
 }
 
 std::string MixDownloader::getTemporaryPath(const std::string& mix_id) {
@@ -262,8 +755,31 @@ std::string MixDownloader::getLastError() const {
     return last_error;
 }
 
-bool MixDownloader::downloadMixWithTitleNaming(const Mix& mix, AutoVibez::Audio::MP3Analyzer* mp3_analyzer) {
+bool MixDownloader::downloadMixWithTitleNaming(const Mix& mix, AutoVibez::Audio::MP3Analyzer* mp3_analyzer,
+                                               AutoVibez::Utils::DownloadProgress* progress, DownloadedMix* result) {
+    if (!mp3_analyzer) {
+        clearError();
+        setError(StringConstants::MP3_ANALYZER_REQUIRED_ERROR);
+        AutoVibez::Utils::ConsoleOutput::error("Download failed: MP3 analyzer not available");
+        return false;
+    }
+    FetchedMix fetched;
+    DownloadedMix downloaded;
+    if (!fetchMix(mix, progress, fetched) || !finishMix(fetched, mp3_analyzer, downloaded)) {
+        return false;
+    }
+    if (result) {
+        *result = std::move(downloaded);
+    }
+    return true;
+}
+
+bool MixDownloader::fetchMix(const Mix& mix, AutoVibez::Utils::DownloadProgress* progress, FetchedMix& fetched) {
+    AUTOVIBEZ_TRACE_SCOPE_DETAIL("download", "fetchMix", mix.id);
     clearError();
+    fetched = FetchedMix();
+    fetched.mix_id = mix.id;
+    fetched.title = mix.title;
 
     if (mix.url.empty()) {
         setError(StringConstants::EMPTY_URL_ERROR);
@@ -277,38 +793,32 @@ bool MixDownloader::downloadMixWithTitleNaming(const Mix& mix, AutoVibez::Audio:
         return false;
     }
 
-    if (!mp3_analyzer) {
-        setError(StringConstants::MP3_ANALYZER_REQUIRED_ERROR);
-        AutoVibez::Utils::ConsoleOutput::error("Download failed: MP3 analyzer not available");
-        return false;
-    }
-
-    std::string temp_path = getTemporaryPath(mix.id);
-    std::string final_path = getLocalPath(mix.id);
-
     if (isMixDownloaded(mix.id)) {
+        // On disk from before but new to the caller, which still needs it analyzed once
+        fetched.local_path = getLocalPath(mix.id);
         return true;
     }
+    fetched.temp_path = getTemporaryPath(mix.id);
 
-    AutoVibez::Utils::ConsoleOutput::info("Downloading: " + mix.title);
+    AutoVibez::Utils::ConsoleOutput::info("Downloading: " + mix.title, AutoVibez::Utils::ConsoleCategory::Download);
 
     std::filesystem::create_directories(mixes_dir);
 
     if (mix.url.substr(0, FILE_PROTOCOL_LENGTH) == StringConstants::FILE_PROTOCOL) {
         std::string source_path = mix.url.substr(FILE_PROTOCOL_LENGTH);
-        if (copyLocalFile(source_path, temp_path)) {
-            AutoVibez::Audio::MP3Metadata mp3_metadata = mp3_analyzer->analyzeFile(temp_path);
-            if (!mp3_metadata.title.empty()) {
-                std::string safe_title = AutoVibez::Utils::PathUtils::createSafeFilename(mp3_metadata.title);
-                final_path = AutoVibez::Utils::PathUtils::joinPath(mixes_dir, safe_title + ".mp3");
-            }
-
-            if (std::filesystem::exists(temp_path)) {
-                std::filesystem::rename(temp_path, final_path);
+        if (copyLocalFile(source_path, fetched.temp_path)) {
+            if (progress) {
+                std::error_code size_error;
+                auto copied = std::filesystem::file_size(fetched.temp_path, size_error);
+                if (!size_error) {
+                    progress->total_bytes.store(static_cast<int64_t>(copied), std::memory_order_relaxed);
+                    progress->bytes_written.store(static_cast<int64_t>(copied), std::memory_order_release);
+                }
             }
-            AutoVibez::Utils::ConsoleOutput::success("Downloaded: " + mix.title);
+            markDownloadComplete(progress, false);
             return true;
         } else {
+            markDownloadComplete(progress, true);
             AutoVibez::Utils::ConsoleOutput::error("Failed to copy local file: " + mix.title);
             return false;
         }
@@ -320,29 +830,138 @@ bool MixDownloader::downloadMixWithTitleNaming(const Mix& mix, AutoVibez::Audio:
         return false;
     }
 
-    if (!downloadFileWithCurl(mix.url, temp_path)) {
+    StreamDigest digest;
+    fetched.from_peer = fetchFromPeers(mix.id, fetched.temp_path, progress, digest);
+    const bool ok = fetched.from_peer || downloadFile(mix.url, fetched.temp_path, progress, true, &digest);
+    markDownloadComplete(progress, !ok);
+    if (!ok) {
         AutoVibez::Utils::ConsoleOutput::error("Download failed: " + mix.title);
         return false;
     }
+    if (!digest.failed) {
+        // Settled here, on the transfer's thread, so whoever finishes the mix needs only the verdict
+        fetched.streamed_bytes = digest.getBytesFed();
+        fetched.report = digest.check.finish();
+        fetched.content_hash = digest.hasher.hexDigest();
+    }
+    return true;
+}
+
+bool MixDownloader::finishMix(const FetchedMix& fetched, AutoVibez::Audio::MP3Analyzer* mp3_analyzer,
+                              DownloadedMix& downloaded) {
+    AUTOVIBEZ_TRACE_SCOPE_DETAIL("download", "finishMix", fetched.mix_id);
+    if (!mp3_analyzer) {
+        setError(StringConstants::MP3_ANALYZER_REQUIRED_ERROR);
+        return false;
+    }
+    downloaded = DownloadedMix();
+    if (!fetched.local_path.empty()) {
+        downloaded.local_path = fetched.local_path;
+        downloaded.metadata = mp3_analyzer->analyzeFile(downloaded.local_path);
+        downloaded.content_hash = AutoVibez::Utils::ContentHasher::hashFile(downloaded.local_path);
+        return true;
+    }
+    downloaded.from_peer = fetched.from_peer;
+    if (!moveToTitledPath(fetched, mp3_analyzer, downloaded)) {
+        AutoVibez::Utils::ConsoleOutput::error("Download failed: " + fetched.title);
+        return false;
+    }
+    AutoVibez::Utils::ConsoleOutput::success("Downloaded: " + fetched.title,
+                                             AutoVibez::Utils::ConsoleCategory::Download);
+    return true;
+}
 
-    AutoVibez::Audio::MP3Metadata mp3_metadata = mp3_analyzer->analyzeFile(temp_path);
-    if (!mp3_metadata.title.empty()) {
-        std::string safe_title = AutoVibez::Utils::PathUtils::createSafeFilename(mp3_metadata.title);
-        final_path = AutoVibez::Utils::PathUtils::joinPath(mixes_dir, safe_title + StringConstants::MP3_EXTENSION);
+bool MixDownloader::fetchFromPeers(const std::string& mix_id, const std::string& temp_path,
+                                   AutoVibez::Utils::DownloadProgress* progress, StreamDigest& digest) {
+    const std::shared_ptr<PeerCache> peer_cache = std::atomic_load(&peer_cache_);
+    std::error_code state_error;
+    if (!peer_cache || std::filesystem::exists(temp_path + StringConstants::RESUME_STATE_EXTENSION, state_error)) {
+        // A partial download from the origin is closer to done than a peer's file from the start
+        return false;
+    }
+    for (const PeerSource& source : peer_cache->findSources(mix_id)) {
+        if (progress && progress->cancelled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        // The ceiling guards the internet link, which a transfer between nodes doesn't cross
+        if (downloadFile(source.url, temp_path, progress, false, &digest, false) && !digest.failed &&
+            digest.hasher.hexDigest() == source.content_hash) {
+            AutoVibez::Utils::ConsoleOutput::info("Fetched " + mix_id + " from a LAN peer",
+                                                  AutoVibez::Utils::ConsoleCategory::Download);
+            clearError();
+            return true;
+        }
+        std::filesystem::remove(temp_path, state_error);
+        digest = StreamDigest();
+        if (progress) {
+            progress->bytes_written.store(0, std::memory_order_release);
+            progress->total_bytes.store(-1, std::memory_order_relaxed);
+            progress->retries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    clearError();
+    return false;
+}
 
-        std::string mapping_file = PathManager::getFileMappingsPath();
-        std::ofstream mapping(mapping_file, std::ios::app);
-        if (mapping.is_open()) {
-            mapping << mix.id << ":" << safe_title << StringConstants::MP3_EXTENSION << std::endl;
-            mapping.close();
+bool MixDownloader::moveToTitledPath(const FetchedMix& fetched, AutoVibez::Audio::MP3Analyzer* mp3_analyzer,
+                                     DownloadedMix& downloaded) {
+    const std::string& mix_id = fetched.mix_id;
+    const std::string& temp_path = fetched.temp_path;
+    std::error_code size_error;
+    const auto file_size = static_cast<int64_t>(std::filesystem::file_size(temp_path, size_error));
+    if (!fetched.content_hash.empty() && !size_error && fetched.streamed_bytes == file_size) {
+        const AutoVibez::Utils::Mp3StreamReport& report = fetched.report;
+        auto* cache = mp3_analyzer->getProbeCache();
+        if (report.probed && cache) {
+            cache->store(temp_path, report.probe);
+        }
+        if (report.probe.valid && (report.lost_bytes > 0 || report.truncated)) {
+            AutoVibez::Utils::ConsoleOutput::warning(mix_id + ": " + std::to_string(report.lost_bytes) +
+                                                     " bytes out of frame sync" +
+                                                     (report.truncated ? ", last frame cut short" : ""));
         }
+        downloaded.content_hash = fetched.content_hash;
+    } else {
+        downloaded.content_hash = AutoVibez::Utils::ContentHasher::hashFile(temp_path);
+    }
+    downloaded.metadata = mp3_analyzer->analyzeFile(temp_path);
+    const std::string own_filename = mix_id + StringConstants::MP3_EXTENSION;
+    const std::string stem = downloaded.metadata.title.empty()
+                                 ? mix_id
+                                 : AutoVibez::Utils::PathUtils::createSafeFilename(downloaded.metadata.title);
+
+    // Choosing the name and taking it happen under one lock, so two downloads never pick the same free name
+    std::lock_guard<std::mutex> lock(mutex_);
+    loadMappingsLocked();
+    auto mapped = mappings_.find(mix_id);
+    auto ownedByThisMix = [&](const std::string& filename) {
+        return filename == own_filename || (mapped != mappings_.end() && mapped->second == filename);
+    };
+
+    // Another mix with the same title keeps its file; this one gets a numbered name beside it
+    std::string filename = stem + StringConstants::MP3_EXTENSION;
+    std::string final_path = AutoVibez::Utils::PathUtils::joinPath(mixes_dir, filename);
+    for (int copy = 2; std::filesystem::exists(final_path) && !ownedByThisMix(filename); ++copy) {
+        filename = stem + " (" + std::to_string(copy) + ")" + StringConstants::MP3_EXTENSION;
+        final_path = AutoVibez::Utils::PathUtils::joinPath(mixes_dir, filename);
     }
 
-    if (std::filesystem::exists(temp_path)) {
-        std::filesystem::rename(temp_path, final_path);
+    std::error_code error;
+    std::filesystem::rename(temp_path, final_path, error);
+    if (error) {
+        setError("Failed to move download into place: " + error.message());
+        return false;
+    }
+    // A rename keeps size and mtime, so the probe done above still holds
+    if (auto* cache = mp3_analyzer->getProbeCache()) {
+        cache->moved(temp_path, final_path);
     }
 
-    AutoVibez::Utils::ConsoleOutput::success("Downloaded: " + mix.title);
+    // Recorded once the file is in place, so a mapping never names a file that was not moved there
+    if (filename != own_filename) {
+        recordMappingLocked(mix_id, filename);
+    }
+    downloaded.local_path = final_path;
     return true;
 }
 
@@ -1,15 +1,25 @@
 #pragma once
 
-#include <curl/curl.h>
-
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "bandwidth_governor.hpp"
+#include "constants.hpp"
+#include "content_hash.hpp"
+#include "download_progress.hpp"
 #include "error_handler.hpp"
 #include "mix_metadata.hpp"
+#include "mp3_analyzer.hpp"
+#include "mp3_stream_check.hpp"
+#include "peer_cache.hpp"
 
-namespace AutoVibez::Audio {
-class MP3Analyzer;
+namespace AutoVibez::Utils {
+struct TransferRequest;
 }
 
 namespace AutoVibez::Data {
@@ -41,6 +51,33 @@ private:
     FILE* file_;
 };
 
+/**
+ * @brief Where a finished download was put and what analyzing it there found
+ */
+struct DownloadedMix {
+    std::string local_path;
+    AutoVibez::Audio::MP3Metadata metadata;
+    std::string content_hash;  // Hex XXH64 of the file, empty if it could not be read
+    bool from_peer = false;    // Fetched from another node on the LAN rather than the mix's URL
+};
+
+/**
+ * @brief A mix's bytes on disk, before anything has analyzed or renamed them
+ *
+ * What fetchMix leaves for finishMix, so the two can run on different threads. The stream
+ * check and hash were settled while the bytes streamed in; finishing needs only to read tags.
+ */
+struct FetchedMix {
+    std::string mix_id;
+    std::string title;
+    std::string temp_path;                     // Where the bytes landed; empty when local_path is set
+    std::string local_path;                    // Already on disk under its final name from before
+    bool from_peer = false;                    // Fetched from another node on the LAN rather than the mix's URL
+    int64_t streamed_bytes = 0;                // Bytes the stream check and hash saw
+    AutoVibez::Utils::Mp3StreamReport report;  // Only meaningful when content_hash is set
+    std::string content_hash;                  // Hashed in flight; empty if it must be hashed from the file
+};
+
 /**
  * @brief Handles downloading of mix files from URLs
  */
@@ -65,11 +102,22 @@ public:
 
     /**
      * @brief Get local path for a mix
+     *
+     * A mix renamed after its MP3 title is looked up in the file mappings, which are read
+     * once and then kept in memory; no file is read per call.
      * @param mix_id Mix ID
      * @return Local file path
      */
     std::string getLocalPath(const std::string& mix_id);
 
+    /**
+     * @brief Keep the id to file name journal somewhere other than PathManager::getFileMappingsPath
+     *
+     * The journal is read again on next use. Only this downloader's own renames are
+     * seen after that, so one downloader should own a journal.
+     */
+    void setFileMappingsPath(const std::string& path);
+
     /**
      * @brief Get local path for a mix using original filename
      * @param mix Mix object containing original filename
@@ -79,11 +127,62 @@ public:
 
     /**
      * @brief Download a mix to a temporary file and rename based on MP3 title
+     *
+     * A download that fails midway keeps its temporary file, and the next call continues it
+     * where it stopped instead of fetching the whole mix again.
      * @param mix Mix to download
      * @param mp3_analyzer MP3Analyzer instance to extract title
+     * @param progress Optional counters updated as bytes reach the temporary file
+     * @param result Optional; filled with the final path and the one analysis of the file, so the caller
+     *        need not search for or parse it again
      * @return True if successful, false otherwise
      */
-    bool downloadMixWithTitleNaming(const Mix& mix, AutoVibez::Audio::MP3Analyzer* mp3_analyzer);
+    bool downloadMixWithTitleNaming(const Mix& mix, AutoVibez::Audio::MP3Analyzer* mp3_analyzer,
+                                    AutoVibez::Utils::DownloadProgress* progress = nullptr,
+                                    DownloadedMix* result = nullptr);
+
+    /**
+     * @brief The network half of downloadMixWithTitleNaming: get the bytes to a temporary file
+     *
+     * Checks and hashes them as they stream in and reports through progress, but leaves them
+     * unanalyzed under their temporary name; finishMix does the rest.
+     * @return True if the bytes are on disk, or the mix was downloaded before
+     */
+    bool fetchMix(const Mix& mix, AutoVibez::Utils::DownloadProgress* progress, FetchedMix& fetched);
+
+    /**
+     * @brief The CPU half of downloadMixWithTitleNaming: analyze a fetched mix and rename it by its title
+     *
+     * Touches only the fetched file, so finishes of different mixes may run in parallel.
+     * @return True if downloaded holds the mix's final path and analysis
+     */
+    bool finishMix(const FetchedMix& fetched, AutoVibez::Audio::MP3Analyzer* mp3_analyzer, DownloadedMix& downloaded);
+
+    /**
+     * @brief Point a mix at a file another mix already has, dropping the identical one just downloaded for it
+     *
+     * The mapping records the shared file like any renamed download, so getLocalPath and
+     * isMixDownloaded answer for both mixes from then on.
+     * @param downloaded_path The mix's own copy, removed once the mapping is in place
+     * @param existing_path The file to share, in mixes_dir
+     * @return False, leaving the download in place, if existing_path is not a file in mixes_dir
+     */
+    bool shareFile(const std::string& mix_id, const std::string& downloaded_path, const std::string& existing_path);
+
+    /**
+     * @brief Point mixes at files outside mixes_dir, which they play from where they are
+     *
+     * The mappings hold the absolute paths, so getLocalPath and isMixDownloaded answer for
+     * these mixes as for downloaded ones. All are appended to the journal in one write.
+     * @param files Mix id and absolute path pairs
+     * @return False if the journal could not be written
+     */
+    bool referenceFiles(const std::vector<std::pair<std::string, std::string>>& files);
+
+    /**
+     * @brief True if the file is in mixes_dir, where eviction, cleanup and corruption checks may delete it
+     */
+    bool ownsFile(const std::string& path) const;
 
     /**
      * @brief Get temporary path for a mix during download
@@ -105,25 +204,121 @@ public:
      */
     static bool isValidMixId(const std::string& mix_id);
 
+    /**
+     * @brief Fetch files of at least min_bytes as concurrent ranges of segment_bytes each
+     * @param min_bytes Smallest file to split; 0 downloads everything in one stream
+     * @param segment_bytes Length of one range request
+     */
+    void setSegmentedDownload(int64_t min_bytes, int64_t segment_bytes);
+
+    /**
+     * @brief Receive every download through this governor's ceiling, except while its progress asks for full speed
+     *
+     * A governed download has no whole-transfer timeout, as the ceiling decides how long it
+     * takes; the low-speed limit still ends one that stalls. Null lifts the ceiling.
+     */
+    void setBandwidthGovernor(std::shared_ptr<AutoVibez::Utils::BandwidthGovernor> governor);
+
+    /**
+     * @brief Look for a mix on the LAN before fetching it from its URL
+     *
+     * A peer's file is kept only if it hashes to what the peer announced; otherwise the next
+     * peer, then the URL, is tried. A partial download from the URL is continued instead.
+     * Null fetches every mix from its URL.
+     */
+    void setPeerCache(std::shared_ptr<PeerCache> peer_cache);
+
 private:
     /**
-     * @brief Initialize CURL with proper error handling
-     * @return True if successful, false otherwise
+     * @brief What a one-byte range request found out about a file
      */
-    bool initializeCurl();
+    struct RangeProbe {
+        int64_t total = 0;  // Whole length; 0 when the server does not serve ranges
+        std::string validator;
+    };
 
     /**
-     * @brief Cleanup CURL resources
+     * @brief How far a partial download got, kept next to it in a RESUME_STATE_EXTENSION file
      */
-    void cleanupCurl();
+    struct ResumeState {
+        std::string url;
+        std::string validator;  // Strong ETag or Last-Modified of the response, sent back as If-Range
+        int64_t received = 0;
+    };
 
     /**
-     * @brief Download file using CURL with proper resource management
+     * @brief A download's bytes hashed and frame-checked in file order as they arrive
+     *
+     * Rides along in the write callbacks, so the verdict and hash of a finished download
+     * cost no read of the file afterwards; only a resumed prefix, or ranges that landed
+     * ahead of the unbroken start, are read back, and those from the page cache.
+     */
+    struct StreamDigest {
+        AutoVibez::Utils::ContentHasher hasher;
+        AutoVibez::Utils::Mp3StreamCheck check;
+        bool failed = false;  // Bytes on disk could not be read back; the file must be hashed afresh
+
+        void feed(const char* data, size_t size);
+
+        /**
+         * @brief Feed what file holds from from to to, which the digest has not seen
+         */
+        void feedFile(FILE* file, int64_t from, int64_t to);
+
+        int64_t getBytesFed() const {
+            return static_cast<int64_t>(hasher.getLength());
+        }
+    };
+
+    /**
+     * @brief Download a file through the shared TransferEngine, blocking until it ends
      * @param url URL to download from
      * @param file_path Local file path to save to
-     * @return True if successful, false otherwise
+     * @param progress Optional counters; every chunk is flushed before it is counted, and cancelled aborts
+     * @param resumable Keep a failed partial file with its resume state and continue it with a Range request
+     *        next time; a server without ranges, or a file changed since, gets a full fetch instead. A fresh
+     *        download of a large file from a server with ranges goes through downloadSegmented.
+     * @param digest Optional; fed the whole file in order, a resumed prefix included
+     * @param governed Receive through the bandwidth governor, if there is one
+     * @return True if successful, false otherwise; progress is not marked complete either way
+     */
+    bool downloadFile(const std::string& url, const std::string& file_path,
+                      AutoVibez::Utils::DownloadProgress* progress = nullptr, bool resumable = false,
+                      StreamDigest* digest = nullptr, bool governed = true);
+
+    /**
+     * @brief Fetch a mix from the first LAN peer whose file matches its announced hash
+     * @param digest Fed the kept file; reset after each rejected one
+     * @return False, with no file at temp_path, if no peer had a matching file
+     */
+    bool fetchFromPeers(const std::string& mix_id, const std::string& temp_path,
+                        AutoVibez::Utils::DownloadProgress* progress, StreamDigest& digest);
+
+    /**
+     * @brief Ask for the first byte to learn whether the server serves ranges, and the file's length
      */
-    bool downloadFileWithCurl(const std::string& url, const std::string& file_path);
+    RangeProbe probeRanges(const std::string& url);
+
+    /**
+     * @brief Fetch a file as byte ranges in flight at once, written at their offsets into a preallocated file
+     *
+     * Starts with a few ranges and keeps adding one while a round of them comes in faster than the round before.
+     * A failure leaves the unbroken start of the file with its resume state, for downloadFile to continue.
+     * @param progress Optional counters; bytes_written covers the unbroken start of the file only
+     * @param digest Optional; fed the unbroken start of the file as it grows
+     * @return True if every range arrived in full, false otherwise
+     */
+    bool downloadSegmented(const std::string& url, const std::string& file_path, const RangeProbe& probe,
+                           AutoVibez::Utils::DownloadProgress* progress, StreamDigest* digest);
+
+    /**
+     * @brief Put a download under the governor, if there is one
+     */
+    void governRequest(AutoVibez::Utils::TransferRequest& request, AutoVibez::Utils::DownloadProgress* progress) const;
+
+    static ResumeState loadResumeState(const std::string& state_path);
+    static void saveResumeState(const std::string& state_path, const ResumeState& state);
+    static std::string resumeValidator(const std::string& etag, const std::string& last_modified);
 
     /**
      * @brief Copy local file with proper error handling
@@ -133,8 +328,37 @@ private:
      */
     bool copyLocalFile(const std::string& source_path, const std::string& dest_path);
 
+    /**
+     * @brief Read the mappings journal on first use; the caller holds mutex_
+     */
+    void loadMappingsLocked();
+
+    /**
+     * @brief Map a mix to a file in mixes_dir, appending the entry to the journal; the caller holds mutex_
+     */
+    void recordMappingLocked(const std::string& mix_id, const std::string& filename);
+
+    /**
+     * @brief Analyze a finished download, rename it after its MP3 title and map it
+     *
+     * A name another mix's file already has gets a number, as in "Title (2).mp3".
+     * When the fetch hashed the whole file in flight, its stream verdict goes to the analyzer's probe cache,
+     * so the analysis does not read the file to validate it, and its hash to downloaded. Otherwise the file
+     * is hashed from disk.
+     * @return False if the file could not be moved
+     */
+    bool moveToTitledPath(const FetchedMix& fetched, AutoVibez::Audio::MP3Analyzer* mp3_analyzer,
+                          DownloadedMix& downloaded);
+
     std::string mixes_dir;
-    mutable std::mutex mutex_;  // For thread safety
+    int64_t segmented_min_bytes_ = Constants::SEGMENTED_DOWNLOAD_MIN_BYTES;
+    int64_t segment_bytes_ = Constants::DOWNLOAD_SEGMENT_BYTES;
+    std::shared_ptr<AutoVibez::Utils::BandwidthGovernor> governor_;
+    std::shared_ptr<PeerCache> peer_cache_;
+    std::string mappings_path_;
+    std::unordered_map<std::string, std::string> mappings_;  // Mix id to file name in mixes_dir
+    bool mappings_loaded_ = false;
+    mutable std::mutex mutex_;  // Guards the mappings, which download threads add to
 };
 
 }  // namespace AutoVibez::Data
\ No newline at end of file
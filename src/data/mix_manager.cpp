@@ -3,61 +3,128 @@
 #include <SDL2/SDL.h>
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <future>
 #include <random>
-#include <set>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "console_output.hpp"
 #include "constants.hpp"
-#include "message_overlay_wrapper.hpp"
+#include "mix_analyzer.hpp"
 #include "mix_database.hpp"
 #include "mix_downloader.hpp"
 #include "mix_metadata.hpp"
+#include "metrics_registry.hpp"
 #include "mix_player.hpp"
 #include "mp3_analyzer.hpp"
+#include "opus_transcoder.hpp"
 #include "overlay_messages.hpp"
 #include "path_manager.hpp"
 #include "string_utils.hpp"
-#include "uuid_utils.hpp"
+#include "task_executor.hpp"
+#include "url_utils.hpp"
 
 using AutoVibez::Audio::MixPlayer;
 using AutoVibez::Audio::MP3Analyzer;
 using AutoVibez::Audio::MP3Metadata;
+using AutoVibez::Audio::OpusTranscoder;
+using AutoVibez::Utils::CancellationToken;
+using AutoVibez::Utils::DownloadProgress;
+using AutoVibez::Utils::MetricCounter;
+using AutoVibez::Utils::MetricsRegistry;
+using AutoVibez::Utils::TaskExecutor;
+using AutoVibez::Utils::TaskPriority;
+using AutoVibez::Utils::UrlUtils;
 
 namespace AutoVibez::Data {
 
+namespace {
+// Whether a mix about to play was already on disk; the fleet's mix cache hit rate
+void recordMixCacheLookup(bool hit) {
+    static MetricCounter& hits =
+        MetricsRegistry::instance().counter("autovibez_mix_cache_hits_total", "Mixes already on disk when needed");
+    static MetricCounter& misses =
+        MetricsRegistry::instance().counter("autovibez_mix_cache_misses_total", "Mixes downloaded before playing");
+    (hit ? hits : misses).increment();
+}
+}  // namespace
+
 // Static member definitions
 std::random_device MixManager::_random_device;
 std::mt19937 MixManager::_random_generator(MixManager::_random_device());
+std::mutex MixManager::_random_mutex;
 
 MixManager::MixManager(const std::string& db_path, const std::string& data_dir)
-    : db_path(db_path), data_dir(data_dir) {}
+    : db_path(db_path),
+      data_dir(data_dir),
+      available_mixes(std::make_shared<const MixCatalogSnapshot>(MixCatalogSnapshot::Entries())) {}
 
 MixManager::~MixManager() {
+    // Transfers, retry waits and the lookahead see this at their next check instead of running to completion
+    _shutdown.cancel();
+
+    // The play queue picks from the database on its own thread
+    if (database && _catalog_listener) {
+        database->getCatalog()->unsubscribe(_catalog_listener);
+        _catalog_listener = 0;
+    }
+    // Download workers use the downloader, the database and the play queue, and hand off to the
+    // ingest pipeline, which finishes the mixes already fetched before it goes
+    stopDownloads();
+    _ingest_pipeline.reset();
+    _play_queue.reset();
+    if (_peer_cache) {
+        _peer_cache->stop();
+    }
+    _mix_sync.reset();  // Merges replies into the database
+
+    // The analysis, transcode and cache workers write to the database
+    stopAnalysis();
+    _transcode_queue.reset();
+    _mix_cache.reset();
+
+    // The lookahead task uses the downloader and player
+    if (_prefetch_future.valid()) {
+        _prefetch_future.wait();
+    }
+
     // Stop any playing music
     if (player) {
         player->stop();
     }
+    closePlayEvent();
 
-    // Wait for any background downloads to complete
-    cleanupCompletedDownloads();
+    // Keep this run's verdicts for the next startup cleanup
+    if (database) {
+        _probe_cache.save(PathManager::getProbeCachePath());
+    }
 
     // Clean up resources
     player.reset();
     downloader.reset();
     mp3_analyzer.reset();
     metadata.reset();
+    if (database && _catalog_listener) {
+        database->getCatalog()->unsubscribe(_catalog_listener);
+    }
+    _maintenance.reset();
     database.reset();
 }
 
 bool MixManager::initialize() {
-    // Clean up any corrupted files
-    cleanupCorruptedMixFiles();
+    // Verdicts of the previous run, reused by the maintenance sweep where files are unchanged
+    _probe_cache.load(PathManager::getProbeCachePath());
 
-    database = std::make_unique<MixDatabase>(db_path);
+    database = std::make_unique<MixDatabase>(db_path, _database_tuning);
+    database->setFileMappingsPath(PathManager::getFileMappingsPath());
+    if (_shared_catalog) {
+        database->setSharedCatalogPath(PathManager::getSharedCatalogPath());
+    }
     if (!database->initialize()) {
         setError("Failed to initialize database: " + database->getLastError());
         AutoVibez::Utils::ConsoleOutput::error("Failed to initialize music database");
@@ -65,20 +132,110 @@ bool MixManager::initialize() {
     }
 
     AutoVibez::Utils::ConsoleOutput::success("Music database initialized successfully");
+    database->setSimilarMixProbability(_similar_mix_probability);
+    if (!_mix_sync_url.empty()) {
+        _mix_sync = std::make_unique<MixSyncAgent>(*database, _mix_sync_url);
+        _mix_sync->start(std::chrono::seconds(std::max(1, _mix_sync_interval_seconds)));
+    }
+    if (_play_queue_depth > 0) {
+        _play_queue = std::make_unique<PlayQueue>(
+            [this](const std::string& genre, const std::string& exclude_id) { return pickNextMix(genre, exclude_id); },
+            _play_queue_depth, [this]() {
+                _play_queue_revision++;
+                _queue_downloads_stale = true;
+            });
+        _play_queue->setGenre(_current_genre);
+        // A resumed mix is already playing; the queue saved with it comes after it
+        if (!current_mix.id.empty()) {
+            _play_queue->setCurrent(current_mix.id);
+        }
+        std::vector<Mix> resumed_queue;
+        for (const std::string& mix_id : _resume_queue) {
+            resumed_queue.push_back(database->getMixById(mix_id));
+        }
+        _play_queue->restore(std::move(resumed_queue));
+    }
+    _resume_queue.clear();
+    _catalog_listener = database->getCatalog()->subscribe([this](const MixCatalogChange& change) {
+        if (!_play_queue) {
+            return;
+        }
+        // Deleted mixes leave the queue; a reload or new mixes may offer picks it ran out of
+        if (change.type == MixCatalogChange::Type::Removed) {
+            _play_queue->remove(change.id);
+        } else if (change.type == MixCatalogChange::Type::Loaded) {
+            _play_queue->clear();
+        } else if (change.type == MixCatalogChange::Type::Added) {
+            _play_queue->refill();
+        }
+    });
 
     metadata = std::make_unique<MixMetadata>();
+    metadata->setCancellationToken(_shutdown);
+    metadata->setCachePath(PathManager::getManifestCachePath());
+    metadata->setSnapshotPath(PathManager::getManifestSnapshotPath());
 
     downloader = std::make_unique<MixDownloader>(PathManager::getMixesDirectory());
+    _download_scheduler =
+        std::make_unique<DownloadScheduler>(Constants::DOWNLOAD_WORKERS, Constants::DOWNLOADS_PER_HOST);
+    downloader->setBandwidthGovernor(_download_scheduler->getBandwidthGovernor());
 
     mp3_analyzer = std::make_unique<MP3Analyzer>();
+    mp3_analyzer->setProbeCache(&_probe_cache);
+    _ingest_pipeline = std::make_unique<IngestPipeline>(
+        [this](IngestJob& job) { return analyzeFetchedMix(job); },
+        [this](std::vector<IngestJob>& batch) { indexFetchedMixes(batch); });
 
-    player = std::make_unique<MixPlayer>();
+    if (!player) {
+        player = std::make_unique<MixPlayer>(_requested_output_rate);
+        player->setDecoderSynth(_decoder_synth);
+        player->setPreferTranscoded(_transcode_enabled);
+        if (_pcm_tap) {
+            player->setPcmTap(_pcm_tap, _pcm_tap_userdata);
+        }
+        attachPlaybackEvents();
+    }
+
+    // Missing files, ids from previous versions and corrupted files are found a few at a time by
+    // updateMaintenance; the mixes about to play are checked first
+    _maintenance = std::make_unique<LibraryMaintenance>(*database, _probe_cache, data_dir);
+    if (_play_queue) {
+        const std::vector<Mix> upcoming = _play_queue->upcoming();
+        for (auto it = upcoming.rbegin(); it != upcoming.rend(); ++it) {
+            _maintenance->touch(it->id);
+        }
+    }
+    if (!current_mix.id.empty()) {
+        _maintenance->touch(current_mix.id);
+    }
 
-    // Clean up any inconsistent IDs from previous versions
-    cleanupInconsistentIds();
+    // Measure mixes downloaded before they had loudness data
+    for (const auto& mix : database->getUnanalyzedMixes()) {
+        queueAnalysis(mix);
+    }
+
+    // Sizes any files from before the cache, then holds them to the quota
+    _mix_cache = std::make_unique<MixCache>(*database);
+    _mix_cache->setEvictedCallback([this](const CachedMixFile& file) {
+        _probe_cache.forget(file.local_path);
+        if (auto peer_cache = std::atomic_load(&_peer_cache)) {
+            peer_cache->unshare(file.mix_id);
+        }
+    });
+    _mix_cache->setQuota(_mix_cache_quota);
+    protectPlayingMixes();
+
+    // Copies for mixes downloaded before transcoding was on, or whose copy is older than the file
+    if (_transcode_enabled && OpusTranscoder::isAvailable()) {
+        _transcode_queue = std::make_unique<TranscodeQueue>(
+            [this](const Mix& mix, const CancellationToken& cancel) { transcodeMix(mix, cancel); });
+        for (const auto& mix : database->getDownloadedMixes()) {
+            queueTranscode(mix);
+        }
+    }
 
-    // Clean up any missing files from the database
-    cleanupMissingFiles();
+    // Mixes that failed last run wait out what is left of their backoff
+    _download_backoff.load(database->getDownloadFailures());
 
     // Start downloading missing mixes in the background
     downloadMissingMixesBackground();
@@ -98,20 +255,17 @@ bool MixManager::loadMixMetadata(const std::string& yaml_url) {
         std::vector<Mix> mixes = metadata->loadFromYaml(yaml_url);
 
         if (metadata->isSuccess()) {
-            try {
-                syncMixesWithDatabase(mixes);
-                return true;
-            } catch (const std::exception& e) {
-                setError("Database sync failed: " + std::string(e.what()));
-                return false;
-            }
+            return syncMixMetadata(yaml_url, std::move(mixes), metadata->isUnchanged());
         }
 
         // If this is not the last attempt, wait before retrying
         if (attempt < max_retries) {
             // Exponential backoff: 1s, 2s, 4s
             int delay_ms = (1 << (attempt - 1)) * Constants::DEFAULT_TIMEOUT_SECONDS * 1000;
-            SDL_Delay(delay_ms);
+            if (!_shutdown.sleepFor(std::chrono::milliseconds(delay_ms))) {
+                setError("Metadata load cancelled");
+                return false;
+            }
         }
     }
 
@@ -120,57 +274,128 @@ bool MixManager::loadMixMetadata(const std::string& yaml_url) {
     return false;
 }
 
+bool MixManager::syncMixMetadata(const std::string& yaml_url, std::vector<Mix> mixes, bool unchanged) {
+    try {
+        syncMixesWithDatabase(mixes);
+        _manifest_url = yaml_url;
+        _manifest_mixes = std::move(mixes);
+        _manifest_unchanged = unchanged;
+        return true;
+    } catch (const std::exception& e) {
+        setError("Database sync failed: " + std::string(e.what()));
+        return false;
+    }
+}
+
 bool MixManager::checkForNewMixes(const std::string& yaml_url) {
     if (!metadata) {
         setError("Metadata parser not initialized");
         return false;
     }
 
-    // Load current mixes from remote YAML
-    std::vector<Mix> new_mixes = metadata->loadFromYaml(yaml_url);
+    std::vector<Mix> new_mixes;
+    if (yaml_url == _manifest_url) {
+        // loadMixMetadata has just fetched and parsed this manifest
+        const bool unchanged = _manifest_unchanged;
+        new_mixes = std::move(_manifest_mixes);
+        _manifest_url.clear();
+        _manifest_mixes.clear();
+        if (unchanged) {
+            return true;  // Same manifest as the last run saw, so its new mixes were queued then
+        }
+    } else {
+        // Load current mixes from remote YAML
+        new_mixes = metadata->loadFromYaml(yaml_url);
+        if (!metadata->isSuccess()) {
+            setError("Failed to check for new mixes: " + metadata->getLastError());
+            return false;
+        }
+    }
 
-    if (!metadata->isSuccess()) {
-        setError("Failed to check for new mixes: " + metadata->getLastError());
+    if (!database) {
+        setError("Database not initialized");
         return false;
     }
 
-    // Get existing mix IDs from database
-    std::vector<Mix> existing_mixes = database ? database->getAllMixes() : std::vector<Mix>();
-    std::set<std::string> existing_ids;
-    for (const auto& mix : existing_mixes) {
-        existing_ids.insert(mix.id);
+    // Only the entries whose hash differs from the one stored last time are looked at further
+    std::unordered_map<std::string, uint64_t> hashes;
+    if (!database->getManifestHashes(hashes)) {
+        setError("Failed to check for new mixes: " + database->getLastError());
+        return false;
+    }
+    const ManifestDiff diff = ManifestDiff::compute(new_mixes, hashes);
+    if (diff.empty()) {
+        return true;
+    }
+    MixIngestStats stats;
+    if (!database->ingestManifest(diff, stats)) {
+        setError("Failed to apply manifest changes: " + database->getLastError());
+        return false;
     }
 
-    // Find new mixes that aren't in the database
-    std::vector<Mix> new_mixes_to_add;
-    for (const auto& mix : new_mixes) {
-        if (existing_ids.find(mix.id) == existing_ids.end()) {
-            new_mixes_to_add.push_back(mix);
+    // Entries not in the library are downloaded; a changed one from its new URL
+    const MixCatalog::Snapshot existing = getCatalogSnapshot();
+    std::vector<Mix> to_download;
+    std::unordered_set<std::string> replaced(diff.removed.begin(), diff.removed.end());
+    for (const std::vector<Mix>* entries : {&diff.added, &diff.updated}) {
+        for (const Mix& mix : *entries) {
+            replaced.insert(mix.id);
+            if (!existing->findById(mix.id)) {
+                to_download.push_back(mix);
+            }
         }
     }
 
-    if (!new_mixes_to_add.empty()) {
-        // Add new mixes to available_mixes for background download
-        available_mixes.insert(available_mixes.end(), new_mixes_to_add.begin(), new_mixes_to_add.end());
+    // The download list follows the manifest: removed entries leave it, changed ones are replaced
+    const MixCatalog::Snapshot available = std::atomic_load(&available_mixes);
+    MixCatalogBuilder builder;
+    for (const auto& record : available->entries()) {
+        if (!replaced.count(std::string(record->id()))) {
+            builder.add(available->toMix(*record));
+        }
+    }
+    for (const std::vector<Mix>* entries : {&diff.added, &diff.updated}) {
+        for (const Mix& mix : *entries) {
+            builder.add(mix);
+        }
+    }
+    std::atomic_store(&available_mixes, builder.build());
 
-        // Start background download of new mixes (silently)
-        for (const auto& mix : new_mixes_to_add) {
-            downloadMixBackground(mix);
+    if (_download_scheduler) {
+        for (const std::string& id : diff.removed) {
+            _download_scheduler->cancel(id);
+        }
+        for (const Mix& mix : diff.updated) {
+            _download_scheduler->cancel(mix.id);  // Queued with the old URL
         }
     }
 
+    // Start background download of new mixes (silently)
+    for (const auto& mix : to_download) {
+        downloadMixBackground(mix);
+    }
+
     return true;
 }
 
 // Audio functionality
 bool MixManager::downloadAndPlayMix(const Mix& mix) {
     // Check if already downloaded
-    if (!downloader->isMixDownloaded(mix.id)) {
+    const bool cached = downloader->isMixDownloaded(mix.id);
+    recordMixCacheLookup(cached);
+    if (!cached) {
+        // A mix the database doesn't know yet can start from the partial download
+        if (_streaming_enabled && database && database->getMixById(mix.id).id.empty()) {
+            return playMixWhileDownloading(mix);
+        }
         if (!downloadAndAnalyzeMix(mix)) {
             return false;
         }
     }
+    return playLocalMix(mix);
+}
 
+bool MixManager::playLocalMix(const Mix& mix) {
     // Use crossfade if enabled and we're currently playing
     if (_crossfade_enabled && isPlaying() && !_crossfade_active) {
         return startCrossfade(mix);
@@ -179,109 +404,760 @@ bool MixManager::downloadAndPlayMix(const Mix& mix) {
     return playMix(mix);
 }
 
-bool MixManager::startCrossfade(const Mix& new_mix, int crossfade_duration_ms) {
+bool MixManager::playMixWhileDownloading(const Mix& mix) {
     if (!player) {
         setError("Player not initialized");
         return false;
     }
 
-    // Store current mix as old mix
-    _crossfade_old_mix = current_mix;
-    _crossfade_new_mix = new_mix;
-    _crossfade_duration_ms = crossfade_duration_ms;
-    _crossfade_active = true;
-    _crossfade_progress = 0;
-    _crossfade_start_time = SDL_GetTicks();
+    // Reuse a background download of the same mix rather than fetching it twice
+    std::shared_ptr<DownloadProgress> progress = findActiveDownload(mix.id);
+    if (!progress) {
+        // This fetch replaces one still waiting in the queue
+        if (_download_scheduler) {
+            _download_scheduler->cancel(mix.id);
+        }
+        progress = beginDownload(mix.id);
+        if (progress) {
+            // The worker moves on once the file is fetched; the stream ends when the mix is indexed
+            auto task = [this, mix, progress]() { return runDownload(mix, progress, [](bool) {}); };
+            if (!_download_scheduler ||
+                !_download_scheduler->schedule(mix.id, UrlUtils::getDomain(mix.url), DownloadPriority::Playing, task)) {
+                // A worker took the queued download just before it was cancelled
+                endDownload(mix.id);
+                setError("Mix is already downloading: " + mix.title);
+                return false;
+            }
+        } else {
+            progress = findActiveDownload(mix.id);
+        }
+    }
+    if (!progress) {
+        // The other download finished between the two lookups
+        return downloadAndPlayMix(mix);
+    }
+    // Playback waits on this one, while the others keep to the ceiling that loading and playing share
+    progress->full_speed = true;
+    if (_download_scheduler) {
+        _download_scheduler->getBandwidthGovernor()->setCeiling(_playing_download_limit);
+    }
 
-    // Store current volume
-    _old_volume = getVolume();
-    _new_volume = _old_volume;  // Start new mix at same volume
+    AutoVibez::Utils::ConsoleOutput::info("Buffering: " + mix.title);
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(Constants::STREAM_START_TIMEOUT_SECONDS);
+    auto waitOrGiveUp = [this, &deadline]() {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        return _shutdown.sleepFor(std::chrono::milliseconds(Constants::STREAM_START_POLL_MS));
+    };
 
-    // Start the new mix at 0 volume
-    if (!playMix(new_mix)) {
-        _crossfade_active = false;
+    while (progress->getBytesWritten() < _stream_start_bytes && !progress->isComplete() &&
+           isDownloadActive(mix.id)) {
+        if (!waitOrGiveUp()) {
+            setError("Timed out buffering mix: " + mix.title);
+            return false;
+        }
+    }
+
+    if (!progress->isComplete() && isDownloadActive(mix.id)) {
+        std::string error;
+        std::unique_ptr<AutoVibez::Audio::PcmSource> source =
+            player->prepareStreamingSource(downloader->getTemporaryPath(mix.id), progress, error);
+        if (source) {
+            bool crossfade = _crossfade_enabled && isPlaying() && !_crossfade_active;
+            bool started = crossfade ? player->crossfadeToSource(std::move(source), _crossfade_duration_ms)
+                                     : player->playSource(std::move(source));
+            if (!started) {
+                setError("Failed to play mix: " + player->getLastError());
+                return false;
+            }
+
+            _crossfade_active = player->isCrossfading();
+            _crossfade_progress = player->getCrossfadeProgress();
+            clearPrefetch();
+            _streaming_mix_id = mix.id;
+            onMixStarted(mix, "");
+            return true;
+        }
+        if (!progress->isComplete()) {
+            setError("Failed to play mix: " + error);
+            return false;
+        }
+        // The transfer completed and the file moved while it was being opened
+    }
+
+    if (progress->failed.load(std::memory_order_relaxed)) {
+        setError("Failed to download mix: " + mix.title);
+        return false;
+    }
+
+    // Short files finish before the threshold; wait for analysis and the rename, then play normally
+    while (isDownloadActive(mix.id)) {
+        if (!waitOrGiveUp()) {
+            setError("Timed out finishing download: " + mix.title);
+            return false;
+        }
+    }
+    if (!downloader->isMixDownloaded(mix.id)) {
+        setError("Mix not downloaded: " + mix.title);
+        return false;
+    }
+    return playLocalMix(mix);
+}
+
+void MixManager::collectStreamedMix() {
+    if (_streaming_mix_id.empty() || isDownloadActive(_streaming_mix_id)) {
+        return;
+    }
+
+    // The streamed download has been analyzed and stored; count the play now that the row exists
+    std::string mix_id = _streaming_mix_id;
+    _streaming_mix_id.clear();
+    Mix stored = getMixById(mix_id);
+    if (stored.id.empty()) {
+        return;
+    }
+    updatePlayStats(mix_id);
+    if (current_mix.id == mix_id) {
+        current_mix = stored;
+    }
+}
+
+std::shared_ptr<DownloadProgress> MixManager::beginDownload(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(_downloads_mutex);
+    auto inserted = _active_downloads.emplace(mix_id, std::make_shared<DownloadProgress>());
+    if (!inserted.second) {
+        return nullptr;
+    }
+    inserted.first->second->full_speed = mix_id == _next_mix_id;
+    // A download begun during shutdown stops at its first chunk, like the ones cancelled in stopDownloads
+    inserted.first->second->cancelled = _shutdown.isCancelled();
+    return inserted.first->second;
+}
+
+void MixManager::setNextToPlay(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(_downloads_mutex);
+    if (mix_id == _next_mix_id) {
+        return;
+    }
+    // A download already running for the previous next mix goes back under the ceiling
+    auto previous = _active_downloads.find(_next_mix_id);
+    if (previous != _active_downloads.end() && _next_mix_id != current_mix.id) {
+        previous->second->full_speed = false;
+    }
+    _next_mix_id = mix_id;
+    auto next = _active_downloads.find(mix_id);
+    if (next != _active_downloads.end()) {
+        next->second->full_speed = true;
+    }
+}
+
+void MixManager::protectPlayingMixes() {
+    if (!_mix_cache) {
+        return;
+    }
+    std::string next_mix_id;
+    {
+        std::lock_guard<std::mutex> lock(_downloads_mutex);
+        next_mix_id = _next_mix_id;
+    }
+    _mix_cache->setProtected({current_mix.id, next_mix_id});
+}
+
+void MixManager::updateDownloadBandwidth() {
+    if (!_download_scheduler) {
+        return;
+    }
+    const bool playing = isPlaying() && !isPaused();
+    _download_scheduler->getBandwidthGovernor()->setCeiling(playing ? _playing_download_limit : 0);
+}
+
+void MixManager::updateMaintenance() {
+    if (_maintenance) {
+        _maintenance->tick();
+    }
+}
+
+void MixManager::updateSharedCatalog() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto interval = std::chrono::milliseconds(Constants::SHARED_CATALOG_SYNC_INTERVAL_MS);
+    if (!database || now - _last_shared_catalog_sync < interval) {
+        return;
+    }
+    _last_shared_catalog_sync = now;
+    database->syncSharedCatalog();
+}
+
+std::chrono::steady_clock::time_point MixManager::getNextUpdate() const {
+    using Clock = std::chrono::steady_clock;
+    if (_crossfade_active) {
+        return Clock::time_point::min();  // The fade's progress is mirrored every tick
+    }
+    Clock::time_point next = Clock::time_point::max();
+    if (_maintenance) {
+        next = std::min(next, _maintenance->getNextDue());
+    }
+    if (_shared_catalog && database) {
+        const auto interval = std::chrono::milliseconds(Constants::SHARED_CATALOG_SYNC_INTERVAL_MS);
+        next = std::min(next, _last_shared_catalog_sync + interval);
+    }
+    if (!_resume_state_path.empty() && (isPlaying() || isPaused())) {
+        const auto interval = std::chrono::milliseconds(Constants::RESUME_SAVE_INTERVAL_MS);
+        next = std::min(next, _last_resume_save + interval);
+    }
+    return next;
+}
+
+bool MixManager::resumePlayback() {
+    ResumeState state;
+    if (_resume_state_path.empty() || !ResumeState::load(_resume_state_path, state)) {
+        return false;
+    }
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(state.mix.local_path, error)) {
         return false;
     }
 
-    // Set new mix volume to 0 initially
-    player->setVolume(0, true);
+    if (!player) {
+        player = std::make_unique<MixPlayer>(_requested_output_rate);
+        player->setDecoderSynth(_decoder_synth);
+        player->setPreferTranscoded(_transcode_enabled);
+        if (_pcm_tap) {
+            player->setPcmTap(_pcm_tap, _pcm_tap_userdata);
+        }
+        attachPlaybackEvents();
+    }
+    AutoVibez::Audio::MixLoadOptions options;
+    options.gain_db = state.gain_db;
+    AutoVibez::Audio::SeekIndex::parse(state.seek_index, options.seek_index);
+    if (!player->playMix(state.mix.local_path, options)) {
+        return false;
+    }
+    player->setVolume(state.volume, true);
+    if (state.position_seconds > 0) {
+        player->seekTo(state.position_seconds);
+    }
+    if (state.paused) {
+        player->togglePause();
+    }
 
+    // The play history picks up from here; the play count was taken when the mix first started
+    current_mix = state.mix;
+    _current_genre = state.genre;
+    _resume_queue = state.queue;
+    _resume_options = state;
+    _saved_resume_state = state.encode();
+    _play_started_ms = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
+    _play_started = std::chrono::steady_clock::now();
     return true;
 }
 
-void MixManager::updateCrossfade() {
-    if (!_crossfade_active || !player) {
+void MixManager::updateResumeState() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto interval = std::chrono::milliseconds(Constants::RESUME_SAVE_INTERVAL_MS);
+    if (_resume_state_path.empty() || !database || now - _last_resume_save < interval) {
+        return;
+    }
+    _last_resume_save = now;
+    if (current_mix.id.empty() || current_mix.local_path.empty() || !(isPlaying() || isPaused())) {
         return;
     }
 
-    Uint32 current_time = SDL_GetTicks();
-    Uint32 elapsed = current_time - _crossfade_start_time;
+    // Gain and seek index only change when the mix does
+    if (_resume_options.mix.id != current_mix.id) {
+        _resume_options.mix.id = current_mix.id;
+        _resume_options.gain_db = loadOptions(current_mix).gain_db;
+        _resume_options.seek_index = database->getSeekIndex(current_mix.id);
+    }
+    ResumeState state;
+    state.mix = current_mix;
+    state.position_seconds = player->getCurrentPosition();
+    state.paused = isPaused();
+    state.gain_db = _resume_options.gain_db;
+    state.seek_index = _resume_options.seek_index;
+    state.genre = _current_genre;
+    state.volume = player->getVolume();
+    if (_play_queue) {
+        for (const Mix& mix : _play_queue->upcoming()) {
+            state.queue.push_back(mix.id);
+        }
+    }
 
-    if (elapsed >= static_cast<Uint32>(_crossfade_duration_ms)) {
-        // Crossfade complete
-        _crossfade_active = false;
-        _crossfade_progress = Constants::MAX_VOLUME;
+    std::string encoded = state.encode();
+    if (encoded != _saved_resume_state && state.save(_resume_state_path)) {
+        _saved_resume_state = std::move(encoded);
+    }
+}
+
+std::shared_ptr<DownloadProgress> MixManager::findActiveDownload(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(_downloads_mutex);
+    auto it = _active_downloads.find(mix_id);
+    return it != _active_downloads.end() ? it->second : nullptr;
+}
+
+void MixManager::endDownload(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(_downloads_mutex);
+    _active_downloads.erase(mix_id);
+    // A streamed mix is collected on the next update; the handler only signals, so it runs under the lock
+    if (_wake_handler) {
+        _wake_handler();
+    }
+}
+
+bool MixManager::scheduleDownload(const Mix& mix, DownloadPriority priority) {
+    if (!_download_scheduler) {
+        return false;
+    }
+    // Until its wait is over a mix that failed is left alone; playback asking for it goes ahead regardless
+    if (priority != DownloadPriority::Playing &&
+        !_download_backoff.mayAttempt(mix.id, AutoVibez::Utils::DateTimeUtils::nowEpochMs())) {
+        return false;
+    }
+    const std::string host = UrlUtils::getDomain(mix.url);
+    auto task = [this, mix, host]() {
+        // A mix that will not download cannot play either
+        auto dequeueIfFailed = [this, mix_id = mix.id](bool ok) {
+            if (!ok && _play_queue) {
+                _play_queue->remove(mix_id);
+            }
+        };
+        // While the host is down the worker moves on at once instead of sitting out a timeout
+        const bool ok = _host_breaker.allow(host) && downloadAndAnalyzeMix(mix, dequeueIfFailed);
+        _host_breaker.release(host);  // A probe that never reached the host is not its verdict
+        dequeueIfFailed(ok);
+        return ok;
+    };
+    return _download_scheduler->schedule(mix.id, host, priority, task);
+}
 
-        // Ensure final volumes are correct
-        player->setVolume(_new_volume, true);
+bool MixManager::cancelDownload(const std::string& mix_id) {
+    if (_download_scheduler && _download_scheduler->cancel(mix_id)) {
+        return true;
+    }
+    std::shared_ptr<DownloadProgress> progress = findActiveDownload(mix_id);
+    if (!progress) {
+        return false;
+    }
+    progress->cancelled = true;
+    return true;
+}
 
+void MixManager::stopDownloads() {
+    if (!_download_scheduler) {
         return;
     }
+    _download_scheduler->cancelAll();
+    {
+        std::lock_guard<std::mutex> lock(_downloads_mutex);
+        for (auto& download : _active_downloads) {
+            download.second->cancelled = true;
+        }
+    }
+    _download_scheduler.reset();
+}
 
-    // Calculate progress (0-Constants::PROGRESS_PERCENTAGE_MAX)
-    _crossfade_progress = (elapsed * Constants::MAX_VOLUME) / _crossfade_duration_ms;
+bool MixManager::isDownloadActive(const std::string& mix_id) {
+    return findActiveDownload(mix_id) != nullptr;
+}
 
-    // Calculate new volume level
-    int new_volume = (_new_volume * _crossfade_progress / Constants::MAX_VOLUME);
+DownloadStats MixManager::getDownloadStats() {
+    DownloadStats stats;
+    if (_download_scheduler) {
+        stats.queued = _download_scheduler->getQueuedCount();
+        stats.running = _download_scheduler->getRunningCount();
+    }
+    stats.completed_last_hour = _download_telemetry.getCompletedRecently();
+    stats.hosts = _download_telemetry.snapshot();
+    stats.hosts_down = _host_breaker.getOpenCount();
+    stats.backed_off = _download_backoff.getBackedOffCount(AutoVibez::Utils::DateTimeUtils::nowEpochMs());
+    if (_ingest_pipeline) {
+        stats.stages = _ingest_pipeline->getStats();
+    }
+
+    std::lock_guard<std::mutex> lock(_downloads_mutex);
+    for (const auto& download : _active_downloads) {
+        const DownloadProgress& progress = *download.second;
+        if (progress.isComplete()) {
+            continue;  // Being analyzed, or about to be gone
+        }
+        DownloadTransferStats transfer;
+        transfer.mix_id = download.first;
+        transfer.bytes = progress.getBytesWritten();
+        transfer.total_bytes = progress.total_bytes.load(std::memory_order_relaxed);
+        transfer.bytes_per_second = progress.bytes_per_second.load(std::memory_order_relaxed);
+        transfer.eta_seconds = progress.getEtaSeconds();
+        transfer.retries = progress.retries.load(std::memory_order_relaxed);
+        transfer.full_speed = progress.full_speed.load(std::memory_order_relaxed);
+        stats.bytes_per_second += transfer.bytes_per_second;
+        stats.transfers.push_back(std::move(transfer));
+    }
+    return stats;
+}
 
-    // Apply volume with suppressed output
-    player->setVolume(new_volume, true);
+void MixManager::queueAnalysis(const Mix& mix) {
+    if (mix.local_path.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_analysis_mutex);
+        if (_analysis_stop.load(std::memory_order_relaxed)) {
+            return;
+        }
+        _analysis_queue.push_back(mix);
+        if (!_analysis_thread.joinable()) {
+            _analysis_thread = std::thread(&MixManager::analysisLoop, this);
+        }
+    }
+    _analysis_cv.notify_one();
+}
+
+void MixManager::analysisLoop() {
+    AutoVibez::Audio::MixAnalyzer analyzer;
+    for (;;) {
+        Mix mix;
+        {
+            std::unique_lock<std::mutex> lock(_analysis_mutex);
+            _analysis_cv.wait(lock, [this]() { return _analysis_stop.load() || !_analysis_queue.empty(); });
+            if (_analysis_stop.load()) {
+                return;
+            }
+            mix = _analysis_queue.front();
+            _analysis_queue.pop_front();
+        }
 
-    // Update current mix reference
-    current_mix = _crossfade_new_mix;
+        // A failed file stays unanalyzed and is retried on the next start
+        AutoVibez::Audio::MixAnalysis result;
+        if (!analyzer.analyzeFile(mix.local_path, result, &_analysis_stop)) {
+            continue;
+        }
+        database->setMixAnalysis(mix.id, result.loudness_lufs, result.peak_dbfs, result.bpm,
+                                 result.spectral_centroid_hz);
+        // Stored even when empty so files libmpg123 can't index are not re-queued on every start
+        database->setSeekIndex(mix.id, result.seek_index.serialize());
+    }
 }
 
-bool MixManager::playMix(const Mix& mix) {
+void MixManager::stopAnalysis() {
+    {
+        std::lock_guard<std::mutex> lock(_analysis_mutex);
+        _analysis_stop = true;
+        _analysis_queue.clear();
+    }
+    _analysis_cv.notify_all();
+    if (_analysis_thread.joinable()) {
+        _analysis_thread.join();
+    }
+}
+
+void MixManager::queueTranscode(const Mix& mix) {
+    // Mixes imported in place stay untouched in the library they came from
+    if (!_transcode_queue || mix.local_path.empty() || !downloader->ownsFile(mix.local_path) ||
+        OpusTranscoder::hasFreshCopy(mix.local_path)) {
+        return;
+    }
+    _transcode_queue->enqueue(mix);
+}
+
+void MixManager::transcodeMix(const Mix& mix, const CancellationToken& cancel) {
+    // Queued a while ago: the mix may have been transcoded or evicted since
+    std::error_code error;
+    if (OpusTranscoder::hasFreshCopy(mix.local_path) || !std::filesystem::is_regular_file(mix.local_path, error)) {
+        return;
+    }
+    OpusTranscoder transcoder;
+    if (!transcoder.transcode(mix.local_path, _transcode_bitrate_kbps, &cancel)) {
+        if (!cancel.isCancelled()) {
+            AutoVibez::Utils::ConsoleOutput::warning("Could not transcode " + mix.title + ": " +
+                                                     transcoder.getLastError());
+        }
+        return;
+    }
+
+    // Evicted while it was encoding: the copy goes the same way
+    if (!std::filesystem::is_regular_file(mix.local_path, error)) {
+        std::filesystem::remove(OpusTranscoder::getCopyPath(mix.local_path), error);
+        return;
+    }
+    if (_mix_cache) {
+        _mix_cache->recordFile(mix.id, mix.local_path);  // Now counts the copy too
+    }
+}
+
+double MixManager::getPlaybackGainDb(const Mix& mix) const {
+    if (!_normalization_enabled || !mix.has_analysis) {
+        return 0.0;
+    }
+    double gain_db = _loudness_target_lufs - mix.loudness_lufs;
+    // Never lift a mix so far that its loudest sample would clip
+    gain_db = std::min(gain_db, Constants::LOUDNESS_PEAK_CEILING_DBFS - mix.peak_dbfs);
+    return std::clamp(gain_db, -Constants::MAX_LOUDNESS_GAIN_DB, Constants::MAX_LOUDNESS_GAIN_DB);
+}
+
+AutoVibez::Audio::MixLoadOptions MixManager::loadOptions(const Mix& mix) {
+    AutoVibez::Audio::MixLoadOptions options;
+    if (!database) {
+        return options;
+    }
+
+    // Callers may hold a copy taken before the analysis finished
+    const bool stale = _normalization_enabled && !mix.has_analysis;
+    options.gain_db = getPlaybackGainDb(stale ? database->getMixById(mix.id) : mix);
+    AutoVibez::Audio::SeekIndex::parse(database->getSeekIndex(mix.id), options.seek_index);
+    return options;
+}
+
+bool MixManager::startCrossfade(const Mix& new_mix, int crossfade_duration_ms) {
     if (!player) {
         setError("Player not initialized");
         return false;
     }
 
-    std::string local_path = downloader->getLocalPath(mix.id);
+    std::string local_path;
+    if (!resolvePlayablePath(new_mix, local_path)) {
+        return false;
+    }
 
-    if (!downloader->isMixDownloaded(mix.id)) {
-        setError("Mix not downloaded: " + mix.title);
+    // Both mixes overlap on separate decks; the gain ramp runs on the audio thread
+    _crossfade_duration_ms = crossfade_duration_ms;
+    if (!player->crossfadeTo(local_path, crossfade_duration_ms, loadOptions(new_mix))) {
+        setError("Failed to play mix: " + player->getLastError());
+        discardIfCorrupted(new_mix, local_path);
+        return false;
+    }
+
+    _crossfade_active = player->isCrossfading();
+    _crossfade_progress = player->getCrossfadeProgress();
+    clearPrefetch();
+    onMixStarted(new_mix, local_path);
+    return true;
+}
+
+void MixManager::updateCrossfade() {
+    if (!_crossfade_active || !player) {
+        return;
+    }
+
+    // Only mirrors the player's state; no volume is driven from here
+    _crossfade_progress = player->getCrossfadeProgress();
+    if (!player->isCrossfading()) {
+        _crossfade_active = false;
+        _crossfade_progress = Constants::MAX_VOLUME;
+    }
+}
+
+bool MixManager::updatePrefetch() {
+    if (!player || !database) {
         return false;
     }
 
-    // Validate that the file is actually a valid MP3 before attempting playback
-    if (!AutoVibez::Utils::AudioUtils::isValidMP3File(local_path)) {
-        setError("Mix file is corrupted or invalid: " + mix.title);
+    collectStreamedMix();
+
+    bool advanced = false;
+    if (player->consumeGaplessAdvance() && !_queued_mix.id.empty()) {
+        // The queued mix took over at the end-of-track boundary
+        Mix started = _queued_mix;
+        std::string started_path = _queued_path;
+        _queued_mix = Mix();
+        _queued_path.clear();
+        onMixStarted(started, started_path);
+        advanced = true;
+    }
+
+    // Collect a finished lookahead; drop it if playback moved on while it was being prepared
+    if (_prefetch_future.valid() &&
+        _prefetch_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        PreparedMix prepared = _prefetch_future.get();
+        bool still_relevant = prepared.after_mix_id == current_mix.id && (isPlaying() || isPaused());
+        if (prepared.source && still_relevant && _gapless_enabled) {
+            _queued_mix = prepared.mix;
+            _queued_path = prepared.local_path;
+            player->queueNext(std::move(prepared.source));
+        }
+    }
 
-        // Clean up the corrupted file
-        try {
-            std::filesystem::remove(local_path);
-        } catch (const std::exception& e) {
+    // Start one lookahead per playing mix
+    bool mix_loaded = isPlaying() || isPaused();
+    if (_gapless_enabled && mix_loaded && !current_mix.id.empty() && !_prefetch_future.valid() &&
+        !player->hasQueuedNext() && _prefetch_for_mix_id != current_mix.id) {
+        _prefetch_for_mix_id = current_mix.id;
+        // Prepare the head of the play queue; it leaves the queue when it starts
+        Mix next = _play_queue ? _play_queue->peek() : Mix();
+        if (next.id.empty()) {
+            next = pickNextMix(_current_genre, current_mix.id);
         }
+        if (!next.id.empty() && next.id != current_mix.id) {
+            startPrefetch(next);
+        }
+    }
 
+    return advanced;
+}
+
+void MixManager::clearPrefetch() {
+    if (player) {
+        player->clearQueuedNext();
+    }
+    _queued_mix = Mix();
+    _queued_path.clear();
+    _prefetch_for_mix_id.clear();
+}
+
+void MixManager::startPrefetch(const Mix& next) {
+    setNextToPlay(next.id);
+    protectPlayingMixes();
+    std::string after_mix_id = current_mix.id;
+    _prefetch_future = TaskExecutor::shared().submit(TaskPriority::Prefetch, [this, next, after_mix_id]() {
+        PreparedMix prepared;
+        prepared.mix = next;
+        prepared.after_mix_id = after_mix_id;
+        if (_shutdown.isCancelled()) {
+            return prepared;  // Queued behind other work until shutdown; an empty result is dropped
+        }
+
+        // Make sure the file is local before opening it
+        const bool cached = downloader->isMixDownloaded(next.id);
+        recordMixCacheLookup(cached);
+        if (!cached && !downloadAndAnalyzeMix(next)) {
+            return prepared;
+        }
+        if (!downloader->isMixDownloaded(next.id)) {
+            return prepared;
+        }
+
+        prepared.local_path = downloader->getLocalPath(next.id);
+        std::string error;
+        prepared.source = player->prepareSource(prepared.local_path, error, loadOptions(next));
+        return prepared;
+    });
+}
+
+bool MixManager::resolvePlayablePath(const Mix& mix, std::string& local_path) {
+    local_path = downloader->getLocalPath(mix.id);
+
+    if (!downloader->isMixDownloaded(mix.id)) {
+        setError("Mix not downloaded: " + mix.title);
         return false;
     }
 
-    if (player->playMix(local_path)) {
-        current_mix = mix;
-        updatePlayStats(mix.id);
+    // The player maps, validates and decodes the file in one pass; see discardIfCorrupted
+    return true;
+}
+
+void MixManager::discardIfCorrupted(const Mix& mix, const std::string& local_path) {
+    // Only reached after a failed open, so the second read of the file is off the happy path
+    if (AutoVibez::Utils::AudioUtils::isValidMP3File(local_path, &_probe_cache)) {
+        return;
+    }
+    setError("Mix file is corrupted or invalid: " + mix.title);
+
+    // Clean up the corrupted file, unless it is in an imported library rather than one we downloaded
+    _probe_cache.forget(local_path);
+    if (!downloader->ownsFile(local_path)) {
+        return;
+    }
+    try {
+        std::filesystem::remove(local_path);
+        std::filesystem::remove(OpusTranscoder::getCopyPath(local_path));
+    } catch (const std::exception& e) {
+    }
+}
+
+void MixManager::onMixStarted(const Mix& mix, const std::string& local_path) {
+    closePlayEvent();
+    current_mix = mix;
+    if (!local_path.empty()) {
+        current_mix.local_path = local_path;
+    }
+    protectPlayingMixes();
+    if (_maintenance) {
+        _maintenance->touch(mix.id);
+    }
+    if (_play_queue) {
+        _play_queue->setCurrent(mix.id);
+    }
+    _play_started_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    _play_started = std::chrono::steady_clock::now();
+    updatePlayStats(mix.id);
+    if (!local_path.empty()) {
         setLocalPath(mix.id, local_path);
+    }
 
-        if (_messageOverlay) {
-            auto config = AutoVibez::Utils::OverlayMessages::createMessage("mix_info", mix.artist, mix.title);
-            _messageOverlay->showMessage(config);
-        }
+    if (_message_handler) {
+        _message_handler(AutoVibez::Utils::OverlayMessages::createMessage("mix_info", mix.artist, mix.title));
+    }
+}
+
+void MixManager::closePlayEvent() {
+    if (_play_started_ms == 0) {
+        return;
+    }
+
+    // Listening time, paused time included; a mix left well before its end counts as skipped
+    PlayEvent event;
+    event.mix_id = current_mix.id;
+    event.ts_epoch_ms = _play_started_ms;
+    event.duration_played = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _play_started).count());
+    if (current_mix.duration_seconds > 0) {
+        event.duration_played = std::min(event.duration_played, current_mix.duration_seconds);
+        event.skipped = event.duration_played < current_mix.duration_seconds * Constants::PLAY_SKIP_FRACTION;
+    }
+    _play_started_ms = 0;
+
+    // A streamed mix that never made it into the library has no history to keep
+    if (database && getCatalogSnapshot()->findById(event.mix_id)) {
+        database->queuePlayEvent(event);
+    }
+}
 
+bool MixManager::playMix(const Mix& mix) {
+    if (!player) {
+        setError("Player not initialized");
+        return false;
+    }
+
+    std::string local_path;
+    if (!resolvePlayablePath(mix, local_path)) {
+        return false;
+    }
+
+    if (player->playMix(local_path, loadOptions(mix))) {
+        _crossfade_active = false;
+        clearPrefetch();
+        onMixStarted(mix, local_path);
         return true;
     } else {
         setError("Failed to play mix: " + player->getLastError());
+        discardIfCorrupted(mix, local_path);
+        return false;
+    }
+}
+
+bool MixManager::seekBy(int seconds) {
+    if (!player) {
+        setError("Player not initialized");
+        return false;
+    }
+    if (!player->seekTo(player->getCurrentPosition() + seconds)) {
+        setError("Failed to seek: " + player->getLastError());
+        return false;
+    }
+    return true;
+}
+
+bool MixManager::seekToMs(int64_t position_ms) {
+    if (!player) {
+        setError("Player not initialized");
+        return false;
+    }
+    if (!player->seekToFrame(position_ms * player->getOutputRate() / 1000)) {
+        setError("Failed to seek: " + player->getLastError());
         return false;
     }
+    return true;
 }
 
 bool MixManager::togglePause() {
@@ -297,6 +1173,8 @@ bool MixManager::stop() {
         setError("Player not initialized");
         return false;
     }
+    clearPrefetch();
+    closePlayEvent();
     return player->stop();
 }
 
@@ -317,105 +1195,142 @@ bool MixManager::clearMixFiles() {
 }
 
 size_t MixManager::getMixFilesSize() const {
-    if (!std::filesystem::exists(data_dir)) {
-        return 0;
-    }
+    return _mix_cache ? static_cast<size_t>(_mix_cache->getUsedBytes()) : 0;
+}
 
-    size_t total_size = 0;
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(data_dir)) {
-        if (entry.is_regular_file()) {
-            total_size += entry.file_size();
-        }
+void MixManager::setMixCacheQuota(int64_t bytes) {
+    _mix_cache_quota = bytes;
+    if (_mix_cache) {
+        _mix_cache->setQuota(bytes);
     }
-    return total_size;
 }
 
-bool MixManager::cleanupCorruptedMixFiles() {
-    if (!std::filesystem::exists(data_dir)) {
-        return true;
+void MixManager::setSelectionSeed(uint32_t seed) {
+    if (database) {
+        database->setSelectionSeed(seed);
     }
+}
 
-    int cleaned_count = 0;
-    for (const auto& entry : std::filesystem::directory_iterator(data_dir)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".mp3") {
-            std::string file_path = entry.path().string();
-
-            // Check if file is actually an MP3
-            std::ifstream file(file_path, std::ios::binary);
-            if (!file.is_open()) {
-                continue;
-            }
-
-            char header[Constants::ID3V2_HEADER_SIZE];
-            file.read(header, Constants::ID3V2_HEADER_SIZE);
-
-            if (file.gcount() < Constants::ID3V2_HEADER_SIZE) {
-                // File too small, likely corrupted
-                std::filesystem::remove(file_path);
-                cleaned_count++;
-                continue;
-            }
-
-            // Check for MP3 sync word or ID3 header
-            bool is_valid_mp3 = false;
-            if ((header[0] & 0xFF) == 0xFF && ((header[1] & 0xE0) == 0xE0 || (header[1] & 0xF0) == 0xF0)) {
-                is_valid_mp3 = true;
-            } else if (header[0] == 'I' && header[1] == 'D' && header[2] == '3') {
-                is_valid_mp3 = true;
-            }
+void MixManager::setPeerCacheEnabled(bool enabled) {
+    if (!downloader || enabled == (_peer_cache != nullptr)) {
+        return;
+    }
+    if (!enabled) {
+        downloader->setPeerCache(nullptr);
+        _peer_cache->stop();
+        std::atomic_store(&_peer_cache, std::shared_ptr<PeerCache>());
+        return;
+    }
 
-            if (!is_valid_mp3) {
-                // Not a valid MP3, remove it
-                std::filesystem::remove(file_path);
-                cleaned_count++;
-            }
+    auto peer_cache = std::make_shared<PeerCache>();
+    if (!peer_cache->start()) {
+        AutoVibez::Utils::ConsoleOutput::warning("LAN peer cache unavailable: " + peer_cache->getLastError());
+        return;
+    }
+    if (database) {
+        for (const MixFileHash& file : database->getMixFileHashes()) {
+            peer_cache->share(file.mix_id, file.content_hash, file.local_path);
         }
     }
-
-    return true;
+    std::atomic_store(&_peer_cache, peer_cache);
+    downloader->setPeerCache(peer_cache);
 }
 
 // Private helper methods
-bool MixManager::downloadAndAnalyzeMix(const Mix& mix) {
+bool MixManager::downloadAndAnalyzeMix(const Mix& mix, std::function<void(bool)> settled) {
     // Check if already in database
     Mix existing_mix = database->getMixById(mix.id);
     if (!existing_mix.id.empty()) {
         return true;
     }
 
-    // Step 1: Download the mix with title-based naming
-    if (!downloader->downloadMixWithTitleNaming(mix, mp3_analyzer.get())) {
-        setError("Failed to download mix: " + downloader->getLastError());
+    // Two writers on the same temporary file would corrupt it
+    std::shared_ptr<DownloadProgress> progress = beginDownload(mix.id);
+    if (!progress) {
+        setError("Mix is already downloading: " + mix.title);
         return false;
     }
+    return runDownload(mix, progress, std::move(settled));
+}
 
-    // Step 2: Find the actual file path (it may have been renamed based on title)
-    std::string local_path = downloader->getLocalPath(mix.id);
-
-    // Check if the file exists at the expected path, if not, search for it
-    if (!std::filesystem::exists(local_path)) {
-        // The file may have been renamed based on title, so we need to find it
-        for (const auto& entry : std::filesystem::directory_iterator(data_dir)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".mp3") {
-                // This could be our file, let's analyze it to confirm
-                MP3Metadata temp_metadata = mp3_analyzer->analyzeFile(entry.path().string());
-                if (!temp_metadata.title.empty() && !temp_metadata.artist.empty()) {
-                    local_path = entry.path().string();
-                    break;
-                }
-            }
+bool MixManager::runDownload(const Mix& mix, std::shared_ptr<DownloadProgress> progress,
+                             std::function<void(bool)> settled) {
+    // Step 1: Fetch the file on this network worker; it is frame-checked and hashed as it streams in
+    FetchedMix fetched;
+    const auto started = std::chrono::steady_clock::now();
+    const bool ok = downloader->fetchMix(mix, progress.get(), fetched);
+    const bool ran = progress->isComplete() && !progress->cancelled.load(std::memory_order_relaxed);
+    if (ran) {
+        // Only a transfer that ran says something about its host; a cancelled one says nothing
+        const std::string origin = UrlUtils::getDomain(mix.url);
+        const std::string host = fetched.from_peer ? std::string(StringConstants::PEER_TELEMETRY_HOST) : origin;
+        if (!host.empty()) {
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            _download_telemetry.record(host, ok, progress->getBytesWritten(), seconds,
+                                       progress->retries.load(std::memory_order_relaxed));
+        }
+        if (!origin.empty() && !fetched.from_peer) {
+            _host_breaker.record(origin, ok);
+        }
+    }
+    if (!ok) {
+        endDownload(mix.id);
+        setError("Failed to download mix: " + downloader->getLastError());
+        if (ran) {
+            recordDownloadFailure(mix.id);
         }
+        return false;
     }
 
-    // Step 3: Analyze the downloaded file to extract ALL metadata
-    MP3Metadata mp3_metadata = mp3_analyzer->analyzeFile(local_path);
+    // Steps 2 and 3 run in the ingest pipeline. The download stays registered until the mix is in
+    // the database, since streamed playback takes its end as the sign the row is there.
+    auto outcome = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = outcome->get_future();
+    IngestJob job;
+    job.mix = mix;
+    job.fetched = std::move(fetched);
+    job.done = [this, outcome, settled](IngestJob& done) {
+        endDownload(done.mix.id);
+        outcome->set_value(done.ok);
+        if (settled) {
+            settled(done.ok);
+        }
+    };
+    const bool queued = _ingest_pipeline->submit(std::move(job));
+    return settled ? queued : result.get();
+}
+
+bool MixManager::analyzeFetchedMix(IngestJob& job) {
+    const Mix& mix = job.mix;
+    if (!downloader->finishMix(job.fetched, mp3_analyzer.get(), job.downloaded)) {
+        setError("Failed to download mix: " + downloader->getLastError());
+        recordDownloadFailure(mix.id);
+        return false;
+    }
+    std::string local_path = job.downloaded.local_path;
+    const MP3Metadata& mp3_metadata = job.downloaded.metadata;
     if (mp3_metadata.title.empty() && mp3_metadata.artist.empty()) {
         setError("Failed to analyze MP3 file: " + mp3_analyzer->getLastError());
+        recordDownloadFailure(mix.id);
         return false;
     }
 
-    // Step 4: Create complete mix with extracted metadata
-    Mix updated_mix;
+    // The same file published under another id plays from the copy already on disk
+    if (database && !job.downloaded.content_hash.empty()) {
+        const Mix twin = database->findMixByContentHash(job.downloaded.content_hash, mix.id);
+        std::error_code error;
+        const auto own_bytes = std::filesystem::file_size(local_path, error);
+        const auto twin_bytes = twin.id.empty() || error ? 0 : std::filesystem::file_size(twin.local_path, error);
+        if (!twin.id.empty() && !error && twin_bytes == own_bytes && twin.local_path != local_path &&
+            downloader->shareFile(mix.id, local_path, twin.local_path)) {
+            AutoVibez::Utils::ConsoleOutput::info("Sharing the file of " + twin.title + " with " + mix.title);
+            _probe_cache.forget(local_path);
+            local_path = twin.local_path;
+        }
+    }
+
+    // Step 2: Create complete mix with extracted metadata
+    Mix& updated_mix = job.record;
     updated_mix.id = mix.id;  // Use original ID from YAML
     updated_mix.title = mp3_metadata.title;
     updated_mix.artist = mp3_metadata.artist;
@@ -428,23 +1343,74 @@ bool MixManager::downloadAndAnalyzeMix(const Mix& mix) {
 
     updated_mix.play_count = 0;
     updated_mix.is_favorite = false;
-    updated_mix.date_added = AutoVibez::Utils::DateTimeUtils::getCurrentDateTime();
-    updated_mix.last_played = "";
-
-    // Step 5: Add the mix to the database with complete metadata
-    if (database) {
-        // Check if this is the first mix being added
-        bool is_first_mix = database->getAllMixes().empty();
+    updated_mix.date_added_ms = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
+    updated_mix.last_played_ms = 0;
+    return true;
+}
 
-        database->addMix(updated_mix);
+void MixManager::indexFetchedMixes(std::vector<IngestJob>& batch) {
+    if (!database) {
+        for (IngestJob& job : batch) {
+            job.ok = true;
+        }
+        return;
+    }
 
-        // If this is the first mix and we have a callback, call it
-        if (is_first_mix && _first_mix_callback) {
-            _first_mix_callback(updated_mix);
+    // Step 3: Add the batch to the database with complete metadata, in one transaction
+    const bool is_first_mix = getCatalogSnapshot()->empty();
+    std::vector<Mix> mixes;
+    std::vector<std::string> content_hashes;
+    mixes.reserve(batch.size());
+    content_hashes.reserve(batch.size());
+    for (const IngestJob& job : batch) {
+        mixes.push_back(job.record);
+        content_hashes.push_back(job.downloaded.content_hash);
+    }
+    std::vector<bool> added;
+    database->addMixes(mixes, content_hashes, added);
+
+    const Mix* first_added = nullptr;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        IngestJob& job = batch[i];
+        job.ok = added[i];
+        if (!job.ok) {
+            setError("Failed to add mix: " + database->getLastError());
+            continue;
+        }
+        const Mix& updated_mix = job.record;
+        if (_download_backoff.recordSuccess(updated_mix.id)) {
+            database->clearDownloadFailure(updated_mix.id);
+        }
+        if (!job.downloaded.content_hash.empty()) {
+            if (auto peer_cache = std::atomic_load(&_peer_cache)) {
+                peer_cache->share(updated_mix.id, job.downloaded.content_hash, updated_mix.local_path);
+            }
+        }
+        queueAnalysis(updated_mix);
+        if (_mix_cache) {
+            _mix_cache->recordFile(updated_mix.id, updated_mix.local_path);
+        }
+        queueTranscode(updated_mix);
+        if (_maintenance) {
+            _maintenance->touch(updated_mix.id);
+        }
+        if (!first_added) {
+            first_added = &updated_mix;
         }
     }
 
-    return true;
+    // If this is the first mix and we have a callback, call it
+    if (is_first_mix && first_added && _first_mix_callback) {
+        _first_mix_callback(*first_added);
+    }
+}
+
+void MixManager::recordDownloadFailure(const std::string& mix_id) {
+    const DownloadFailure failure =
+        _download_backoff.recordFailure(mix_id, AutoVibez::Utils::DateTimeUtils::nowEpochMs());
+    if (database) {
+        database->setDownloadFailure(failure);
+    }
 }
 
 // Convenience methods for common operations
@@ -473,6 +1439,38 @@ bool MixManager::setVolume(int volume, bool suppress_output) {
     return result;
 }
 
+void MixManager::setPcmTap(MixPlayer::PcmTapCallback callback, void* userdata) {
+    _pcm_tap = callback;
+    _pcm_tap_userdata = userdata;
+    if (player) {
+        player->setPcmTap(callback, userdata);
+    }
+}
+
+void MixManager::setWakeHandler(std::function<void()> handler) {
+    // The audio thread reads the handler without a lock, so it is detached while the handler changes
+    if (player) {
+        player->setPlaybackEventCallback(nullptr, nullptr);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_downloads_mutex);
+        _wake_handler = std::move(handler);
+    }
+    if (player) {
+        attachPlaybackEvents();
+    }
+}
+
+void MixManager::attachPlaybackEvents() {
+    if (_wake_handler) {
+        player->setPlaybackEventCallback(&MixManager::onPlaybackEvent, this);
+    }
+}
+
+void MixManager::onPlaybackEvent(void* userdata) {
+    static_cast<MixManager*>(userdata)->_wake_handler();
+}
+
 int MixManager::getVolume() const {
     return player ? player->getVolume() : 0;
 }
@@ -493,25 +1491,47 @@ int MixManager::getCurrentPosition() const {
     return player ? player->getCurrentPosition() : 0;
 }
 
+int64_t MixManager::getPositionMs() const {
+    return player ? player->getPositionFrames() * 1000 / player->getOutputRate() : 0;
+}
+
 int MixManager::getDuration() const {
     return player ? player->getDuration() : 0;
 }
 
 // User data update methods
+// Queued: the catalog shows these at once and the database's writer thread commits them
+
 bool MixManager::toggleFavorite(const std::string& mix_id) {
-    return database ? database->toggleFavorite(mix_id) : false;
+    if (!database) {
+        return false;
+    }
+    database->queueToggleFavorite(mix_id);
+    return true;
 }
 
 bool MixManager::softDeleteMix(const std::string& mix_id) {
-    return database ? database->softDeleteMix(mix_id) : false;
+    if (!database || !getCatalogSnapshot()->findById(mix_id)) {
+        return false;
+    }
+    database->queueSoftDelete(mix_id);
+    return true;
 }
 
 bool MixManager::updatePlayStats(const std::string& mix_id) {
-    return database ? database->updatePlayStats(mix_id) : false;
+    if (!database) {
+        return false;
+    }
+    database->queueRecordPlay(mix_id);
+    return true;
 }
 
 bool MixManager::setLocalPath(const std::string& mix_id, const std::string& local_path) {
-    return database ? database->setLocalPath(mix_id, local_path) : false;
+    if (!database) {
+        return false;
+    }
+    database->queueLocalPath(mix_id, local_path);
+    return true;
 }
 
 // Additional convenience methods
@@ -537,93 +1557,74 @@ Mix MixManager::getSmartRandomMix(const std::string& exclude_mix_id, const std::
 }
 
 Mix MixManager::getRandomAvailableMix() {
-    if (available_mixes.empty()) {
-        return Mix();
-    }
-
-    // Use a simple random selection
-    size_t random_index = getRandomIndex(available_mixes.size());
-    return available_mixes[random_index];
+    return getRandomAvailableMix("");
 }
 
 Mix MixManager::getRandomAvailableMix(const std::string& exclude_mix_id) {
-    if (available_mixes.empty()) {
-        return Mix();
-    }
-
-    // Filter out the excluded mix
-    std::vector<Mix> filtered_mixes;
-    for (const auto& mix : available_mixes) {
-        if (mix.id != exclude_mix_id) {
-            filtered_mixes.push_back(mix);
-        }
-    }
-
-    if (filtered_mixes.empty()) {
-        return Mix();
-    }
-
-    // Use a simple random selection
-    size_t random_index = getRandomIndex(filtered_mixes.size());
-    return filtered_mixes[random_index];
+    const MixCatalog::Snapshot mixes = std::atomic_load(&available_mixes);
+    const MixRecord* record = pickExcluding(*mixes, nullptr, exclude_mix_id);
+    return record ? mixes->toMix(*record) : Mix();
 }
 
 Mix MixManager::getRandomAvailableMixByGenre(const std::string& genre) {
-    if (available_mixes.empty()) {
-        return Mix();
-    }
-
-    // Filter available mixes by genre (case-insensitive)
-    std::vector<Mix> genre_mixes;
-    std::string genre_lower = AutoVibez::Utils::StringUtils::toLower(genre);
-
-    for (const auto& mix : available_mixes) {
-        if (!mix.genre.empty()) {
-            std::string mix_genre_lower = AutoVibez::Utils::StringUtils::toLower(mix.genre);
-            if (mix_genre_lower == genre_lower) {
-                genre_mixes.push_back(mix);
-            }
-        }
-    }
+    return getRandomAvailableMixByGenre(genre, "");
+}
 
-    if (genre_mixes.empty()) {
+Mix MixManager::getRandomAvailableMixByGenre(const std::string& genre, const std::string& exclude_mix_id) {
+    if (genre.empty()) {
         return Mix();
     }
+    // The snapshot's genre lookup is case-insensitive
+    const MixCatalog::Snapshot mixes = std::atomic_load(&available_mixes);
+    const MixRecord* record = pickExcluding(*mixes, &mixes->genrePositions(genre), exclude_mix_id);
+    return record ? mixes->toMix(*record) : Mix();
+}
 
-    // Use a simple random selection from genre mixes
-    size_t random_index = getRandomIndex(genre_mixes.size());
-    return genre_mixes[random_index];
+MixCatalog::Snapshot MixManager::getAvailableMixes() const {
+    return std::atomic_load(&available_mixes);
 }
 
-Mix MixManager::getRandomAvailableMixByGenre(const std::string& genre, const std::string& exclude_mix_id) {
-    if (available_mixes.empty()) {
+Mix MixManager::takeNextMix() {
+    if (!database) {
         return Mix();
     }
+    return _play_queue ? _play_queue->pop() : pickNextMix(_current_genre, current_mix.id);
+}
 
-    // Filter available mixes by genre (case-insensitive) and exclude the specified mix
-    std::vector<Mix> genre_mixes;
-    std::string genre_lower = AutoVibez::Utils::StringUtils::toLower(genre);
+std::vector<Mix> MixManager::getUpcomingMixes() const {
+    return _play_queue ? _play_queue->upcoming() : std::vector<Mix>();
+}
 
-    for (const auto& mix : available_mixes) {
-        if (!mix.genre.empty() && mix.id != exclude_mix_id) {
-            std::string mix_genre_lower = AutoVibez::Utils::StringUtils::toLower(mix.genre);
-            if (mix_genre_lower == genre_lower) {
-                genre_mixes.push_back(mix);
-            }
-        }
+void MixManager::updateQueueDownloads() {
+    if (!_play_queue || !downloader || !_download_scheduler) {
+        return;
     }
-
-    if (genre_mixes.empty()) {
-        return Mix();
+    if (!_queue_downloads_stale.exchange(false)) {
+        return;
     }
 
-    // Use a simple random selection from genre mixes
-    size_t random_index = getRandomIndex(genre_mixes.size());
-    return genre_mixes[random_index];
+    // In queue order, so the head never waits behind a later mix; already queued ones move up
+    const MixCatalog::Snapshot library = getCatalogSnapshot();
+    for (const Mix& mix : _play_queue->upcoming()) {
+        if (mix.url.empty() || library->findById(mix.id) || downloader->isMixDownloaded(mix.id)) {
+            continue;
+        }
+        if (!_download_scheduler->reprioritize(mix.id, DownloadPriority::UpNext)) {
+            scheduleDownload(mix, DownloadPriority::UpNext);
+        }
+    }
 }
 
-std::vector<Mix> MixManager::getAvailableMixes() {
-    return available_mixes;
+Mix MixManager::pickNextMix(const std::string& genre, const std::string& exclude_mix_id) {
+    Mix next = getSmartRandomMix(exclude_mix_id, genre);
+    if (next.id.empty()) {
+        next = getRandomMix(exclude_mix_id);
+    }
+    if (next.id.empty() && _streaming_enabled) {
+        // Nothing downloaded yet: a catalogue mix, fetched ahead by updateQueueDownloads or streamed
+        next = getRandomAvailableMix(exclude_mix_id);
+    }
+    return next;
 }
 
 Mix MixManager::getMixById(const std::string& id) {
@@ -638,6 +1639,13 @@ std::vector<Mix> MixManager::getAllMixes() {
     return database ? database->getAllMixes() : std::vector<Mix>();
 }
 
+MixCatalog::Snapshot MixManager::getCatalogSnapshot() const {
+    if (database && database->getCatalog()) {
+        return database->getCatalog()->snapshot();
+    }
+    return std::make_shared<const MixCatalogSnapshot>(MixCatalogSnapshot::Entries());
+}
+
 std::vector<Mix> MixManager::getMixesByGenre(const std::string& genre) {
     return database ? database->getMixesByGenre(genre) : std::vector<Mix>();
 }
@@ -646,6 +1654,10 @@ std::vector<Mix> MixManager::getMixesByArtist(const std::string& artist) {
     return database ? database->getMixesByArtist(artist) : std::vector<Mix>();
 }
 
+std::vector<Mix> MixManager::searchMixes(const std::string& query, int limit) {
+    return database ? database->searchMixes(query, limit) : std::vector<Mix>();
+}
+
 std::vector<Mix> MixManager::getDownloadedMixes() {
     return database ? database->getDownloadedMixes() : std::vector<Mix>();
 }
@@ -655,17 +1667,7 @@ std::vector<Mix> MixManager::getFavoriteMixes() {
 }
 
 Mix MixManager::getRandomFavoriteMix() {
-    if (!database) {
-        return Mix();
-    }
-
-    std::vector<Mix> favorite_mixes = database->getFavoriteMixes();
-    if (favorite_mixes.empty()) {
-        return Mix();
-    }
-
-    size_t random_index = getRandomIndex(favorite_mixes.size());
-    return favorite_mixes[random_index];
+    return getRandomFavoriteMix("");
 }
 
 Mix MixManager::getRandomFavoriteMix(const std::string& exclude_mix_id) {
@@ -673,46 +1675,21 @@ Mix MixManager::getRandomFavoriteMix(const std::string& exclude_mix_id) {
         return Mix();
     }
 
-    std::vector<Mix> favorite_mixes = database->getFavoriteMixes();
-    if (favorite_mixes.empty()) {
-        return Mix();
-    }
-
-    // Filter out the excluded mix
-    std::vector<Mix> filtered_mixes;
-    for (const auto& mix : favorite_mixes) {
-        if (mix.id != exclude_mix_id) {
-            filtered_mixes.push_back(mix);
+    // Favorites have no index of their own: one reservoir pass over the catalog, copying nothing
+    const MixCatalog::Snapshot mixes = getCatalogSnapshot();
+    const MixRecord* chosen = nullptr;
+    size_t seen = 0;
+    for (const auto& record : mixes->entries()) {
+        if (record->is_favorite && record->id() != exclude_mix_id && getRandomIndex(++seen) == 0) {
+            chosen = record.get();
         }
     }
-
-    if (filtered_mixes.empty()) {
-        return Mix();
-    }
-
-    size_t random_index = getRandomIndex(filtered_mixes.size());
-    return filtered_mixes[random_index];
+    return chosen ? mixes->toMix(*chosen) : Mix();
 }
 
 bool MixManager::downloadMixBackground(const Mix& mix) {
-    // Launch download in background thread
-    auto future = std::async(std::launch::async, [this, mix]() { return downloadAndAnalyzeMix(mix); });
-
-    // Store the future for later checking
-    _download_futures.push_back(std::move(future));
-
-    // Return true immediately (download started)
-    return true;
-}
-
-void MixManager::cleanupCompletedDownloads() {
-    // Remove completed futures
-    _download_futures.erase(std::remove_if(_download_futures.begin(), _download_futures.end(),
-                                           [](const std::future<bool>& future) {
-                                               return future.wait_for(std::chrono::seconds(0)) ==
-                                                      std::future_status::ready;
-                                           }),
-                            _download_futures.end());
+    // Queued and started by the worker pool; false only if it is already queued or running
+    return scheduleDownload(mix, mix.is_favorite ? DownloadPriority::Favorite : DownloadPriority::Background);
 }
 
 void MixManager::syncMixesWithDatabase(const std::vector<Mix>& mixes) {
@@ -722,7 +1699,12 @@ void MixManager::syncMixesWithDatabase(const std::vector<Mix>& mixes) {
 
     // Store the mixes for later download, but don't add to database yet
     // The database will only be updated after successful download and analysis
-    available_mixes = mixes;
+    MixCatalogBuilder builder;
+    for (const auto& mix : mixes) {
+        builder.add(mix);
+    }
+    // The play queue's worker reads the list too
+    std::atomic_store(&available_mixes, builder.build());
 }
 
 std::vector<std::string> MixManager::getAvailableGenres() {
@@ -730,19 +1712,8 @@ std::vector<std::string> MixManager::getAvailableGenres() {
         return std::vector<std::string>();
     }
 
-    // Get all mixes and extract unique genres
-    std::vector<Mix> all_mixes = database->getAllMixes();
-    std::set<std::string> genres;
-
-    for (const auto& mix : all_mixes) {
-        if (!mix.genre.empty()) {
-            // Use original casing from database
-            genres.insert(mix.genre);
-        }
-    }
-
-    _available_genres = std::vector<std::string>(genres.begin(), genres.end());
-    return _available_genres;
+    // Unique genres in their original casing, as the catalog keeps them
+    return getCatalogSnapshot()->getGenres();
 }
 
 std::string MixManager::getCurrentGenre() const {
@@ -752,71 +1723,54 @@ std::string MixManager::getCurrentGenre() const {
 void MixManager::setCurrentGenre(const std::string& genre) {
     // Use case-insensitive matching to find the actual genre name
     std::string actual_genre = findGenreCaseInsensitive(genre);
-    if (!actual_genre.empty()) {
-        _current_genre = actual_genre;
-    } else {
+    switchGenre(!actual_genre.empty() ? actual_genre : genre);
+}
+
+const std::string& MixManager::switchGenre(const std::string& genre) {
+    // A follow-up picked for the old genre no longer fits
+    if (genre != _current_genre) {
         _current_genre = genre;
+        clearPrefetch();
+        if (_play_queue) {
+            _play_queue->setGenre(_current_genre);
+        }
     }
+    return _current_genre;
 }
 
 std::string MixManager::getNextGenre() {
-    if (_available_genres.empty()) {
-        getAvailableGenres();
-    }
-
-    if (_available_genres.empty()) {
+    // The snapshot's genre index answers without walking the library
+    const MixCatalog::Snapshot catalog = getCatalogSnapshot();
+    const std::vector<std::string>& genres = catalog->getGenres();
+    if (genres.empty()) {
         return "techno";  // fallback
     }
 
-    // Find current genre in list
-    auto it = std::find(_available_genres.begin(), _available_genres.end(), _current_genre);
-    if (it == _available_genres.end()) {
-        _current_genre = _available_genres[0];
-        return _current_genre;
-    }
-
-    // Move to next genre
-    ++it;
-    if (it == _available_genres.end()) {
-        it = _available_genres.begin();  // wrap around
+    // Move to the genre after the current one, wrapping around
+    size_t position = 0;
+    if (!catalog->genrePosition(_current_genre, position)) {
+        return switchGenre(genres[0]);
     }
-
-    _current_genre = *it;
-    return _current_genre;
+    return switchGenre(genres[(position + 1) % genres.size()]);
 }
 
 std::string MixManager::getRandomGenre() {
-    if (_available_genres.empty()) {
-        getAvailableGenres();
-    }
-
-    if (_available_genres.empty()) {
+    const MixCatalog::Snapshot catalog = getCatalogSnapshot();
+    const std::vector<std::string>& genres = catalog->getGenres();
+    if (genres.empty()) {
         return "techno";  // fallback
     }
 
-    // If there's only one genre, return it
-    if (_available_genres.size() == 1) {
-        _current_genre = _available_genres[0];
-        return _current_genre;
-    }
-
-    // Create a list of genres excluding the current one
-    std::vector<std::string> other_genres;
-    for (const auto& genre : _available_genres) {
-        if (genre != _current_genre) {
-            other_genres.push_back(genre);
-        }
+    // Any genre but the current one, when there is another
+    size_t current = 0;
+    if (genres.size() == 1 || !catalog->genrePosition(_current_genre, current)) {
+        return switchGenre(genres[getRandomIndex(genres.size())]);
     }
-
-    // If all genres are the same as current, just pick any random one
-    if (other_genres.empty()) {
-        other_genres = _available_genres;
+    size_t pick = getRandomIndex(genres.size() - 1);
+    if (pick >= current) {
+        pick++;
     }
-
-    // Pick random genre from the filtered list
-    size_t random_index = getRandomIndex(other_genres.size());
-    _current_genre = other_genres[random_index];
-    return _current_genre;
+    return switchGenre(genres[pick]);
 }
 
 std::string MixManager::findGenreCaseInsensitive(const std::string& target_genre) {
@@ -824,125 +1778,10 @@ std::string MixManager::findGenreCaseInsensitive(const std::string& target_genre
         return "";
     }
 
-    // Get all mixes and extract unique genres
-    std::vector<Mix> all_mixes = database->getAllMixes();
-    std::set<std::string> genres;
-
-    for (const auto& mix : all_mixes) {
-        if (!mix.genre.empty()) {
-            genres.insert(mix.genre);
-        }
-    }
-
-    // Convert target to lowercase for comparison
-    std::string target_lower = AutoVibez::Utils::StringUtils::toLower(target_genre);
-
-    // Find matching genre (case-insensitive)
-    for (const auto& genre : genres) {
-        std::string genre_lower = AutoVibez::Utils::StringUtils::toLower(genre);
-
-        if (genre_lower == target_lower) {
-            return genre;  // Return the actual genre name from database
-        }
-    }
-
-    return "";  // Not found
-}
-
-bool MixManager::cleanupInconsistentIds() {
-    if (!database) {
-        setError("Database not initialized");
-        return false;
-    }
-
-    // Get all mixes from database
-    auto all_mixes = database->getAllMixes();
-    int cleaned_count = 0;
-
-    for (const auto& mix : all_mixes) {
-        // Check if this mix has a URL (should always have one)
-        if (!mix.url.empty()) {
-            // Generate the correct ID from URL
-            std::string correct_id = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(mix.url);
-
-            // If the current ID doesn't match the correct one, update it
-            if (mix.id != correct_id) {
-                // Create updated mix with correct ID
-                Mix updated_mix = mix;
-                updated_mix.id = correct_id;
-
-                // Remove old entry and add new one
-                if (database->deleteMix(mix.id) && database->addMix(updated_mix)) {
-                    cleaned_count++;
-                }
-            }
-        }
-    }
-
-    return true;
-}
-
-bool MixManager::cleanupMissingFiles() {
-    if (!database) {
-        setError("Database not initialized");
-        return false;
-    }
-
-    std::vector<Mix> all_mixes = database->getAllMixes();
-    int removed_count = 0;
-
-    for (const auto& mix : all_mixes) {
-        if (!mix.local_path.empty()) {
-            // Check if the file actually exists at the stored path
-            if (!std::filesystem::exists(mix.local_path)) {
-                // File is missing, remove from database
-                if (database->deleteMix(mix.id)) {
-                    removed_count++;
-                }
-            }
-        }
-    }
-
-    return true;
-}
-
-bool MixManager::validateDatabaseFileConsistency() {
-    if (!database) {
-        setError("Database not initialized");
-        return false;
-    }
-
-    std::vector<Mix> all_mixes = database->getAllMixes();
-    int total_mixes = 0;
-    int existing_files = 0;
-    int missing_files = 0;
-    std::vector<std::string> missing_mix_ids;
-
-    for (const auto& mix : all_mixes) {
-        if (!mix.local_path.empty()) {
-            total_mixes++;
-
-            // Check if the file actually exists at the stored path
-            if (std::filesystem::exists(mix.local_path)) {
-                existing_files++;
-            } else {
-                missing_files++;
-                missing_mix_ids.push_back(mix.id);
-            }
-        }
-    }
-
-    // Log the validation results
-    if (total_mixes > 0) {
-        // But we can still return false if there are missing files
-        if (missing_files > 0) {
-            setError("Found " + std::to_string(missing_files) + " missing files out of " + std::to_string(total_mixes) +
-                     " total mixes");
-            return false;
-        }
-    }
-
-    return true;
+    // Return the actual genre name from the database, or nothing if no mix has it
+    const MixCatalog::Snapshot catalog = getCatalogSnapshot();
+    const std::string* genre = catalog->findGenre(target_genre);
+    return genre ? *genre : "";
 }
 
 bool MixManager::downloadMissingMixesBackground() {
@@ -951,19 +1790,24 @@ bool MixManager::downloadMissingMixesBackground() {
         return false;
     }
 
-    std::vector<Mix> all_mixes = database->getAllMixes();
+    const MixCatalog::Snapshot catalog = getCatalogSnapshot();
     int download_count = 0;
 
-    for (const auto& mix : all_mixes) {
+    for (const auto& entry : catalog->entries()) {
         // Skip mixes that don't have a URL (can't download them)
-        if (mix.url.empty()) {
+        if (entry->url().empty()) {
+            continue;
+        }
+
+        // Evicted by the cache: it comes back when played or queued, not all at once
+        if (entry->localPath().empty()) {
             continue;
         }
 
         // Check if the mix is missing locally
-        if (!downloader->isMixDownloaded(mix.id)) {
-            // Start background download
-            if (downloadMixBackground(mix)) {
+        if (!downloader->isMixDownloaded(std::string(entry->id()))) {
+            // Queue a background download
+            if (downloadMixBackground(catalog->toMix(*entry))) {
                 download_count++;
             }
         }
@@ -975,11 +1819,39 @@ bool MixManager::downloadMissingMixesBackground() {
     return true;
 }
 
+const MixRecord* MixManager::pickExcluding(const MixCatalogSnapshot& mixes, const std::vector<uint32_t>* positions,
+                                           const std::string& exclude_mix_id) const {
+    const size_t total = positions ? positions->size() : mixes.size();
+    size_t excluded = total;  // Past the end when the excluded mix is not a candidate
+    uint32_t entry = 0;
+    if (!exclude_mix_id.empty() && mixes.positionOf(exclude_mix_id, entry)) {
+        if (!positions) {
+            excluded = entry;
+        } else {
+            auto it = std::lower_bound(positions->begin(), positions->end(), entry);
+            if (it != positions->end() && *it == entry) {
+                excluded = static_cast<size_t>(it - positions->begin());
+            }
+        }
+    }
+    const size_t candidates = total - (excluded < total ? 1 : 0);
+    if (candidates == 0) {
+        return nullptr;
+    }
+    // Draw over the other candidates and step over the excluded one
+    size_t pick = getRandomIndex(candidates);
+    if (pick >= excluded) {
+        pick++;
+    }
+    return mixes.entries()[positions ? (*positions)[pick] : pick].get();
+}
+
 size_t MixManager::getRandomIndex(size_t max_index) const {
     if (max_index == 0) {
         return 0;
     }
     std::uniform_int_distribution<size_t> dis(0, max_index - 1);
+    std::lock_guard<std::mutex> lock(_random_mutex);
     return dis(_random_generator);
 }
 
@@ -1,30 +1,52 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "cancellation_token.hpp"
+#include "circuit_breaker.hpp"
 #include "constants.hpp"
+#include "download_backoff.hpp"
+#include "download_progress.hpp"
+#include "download_scheduler.hpp"
+#include "download_telemetry.hpp"
 #include "error_handler.hpp"
+#include "ingest_pipeline.hpp"
+#include "library_maintenance.hpp"
+#include "mix_cache.hpp"
 #include "mix_database.hpp"
 #include "mix_downloader.hpp"
 #include "mix_metadata.hpp"
 #include "mix_player.hpp"
+#include "mix_sync_agent.hpp"
 #include "mp3_analyzer.hpp"
-
-// Forward declaration
-namespace AutoVibez::UI {
-class MessageOverlayWrapper;
-}
+#include "mp3_probe.hpp"
+#include "overlay_messages.hpp"
+#include "peer_cache.hpp"
+#include "play_queue.hpp"
+#include "resume_state.hpp"
+#include "transcode_queue.hpp"
 
 namespace AutoVibez::Data {
 
 // Callback function type for first mix added
 using FirstMixAddedCallback = std::function<void(const Mix&)>;
 
+// Callback function type for user-facing messages (mix started, ...)
+using MessageHandler = std::function<void(const AutoVibez::Utils::NamedMessageConfig&)>;
+
 /**
  * @brief Main orchestrator for mix management functionality
  */
@@ -35,11 +57,49 @@ public:
 
     // Core functionality
     bool initialize();
+    /**
+     * @brief Fetch the manifest and offer its mixes for download; a remote one is fetched only if it changed
+     */
     bool loadMixMetadata(const std::string& yaml_url);
+
+    /**
+     * @brief loadMixMetadata for a manifest fetched elsewhere, as startup does while the database opens
+     * @param unchanged The fetch found the manifest the last run saw
+     */
+    bool syncMixMetadata(const std::string& yaml_url, std::vector<Mix> mixes, bool unchanged);
+
+    /**
+     * @brief Apply what changed in the manifest since the last check and queue the mixes the library lacks
+     *
+     * Entries are diffed against the hashes the database stored: added ones are queued,
+     * changed ones update their library mix or requeue from the new URL, and removed ones
+     * leave the download list. An unchanged manifest writes nothing. Right after
+     * loadMixMetadata on the same URL this reuses that fetch, and does nothing at all
+     * when the server reported the manifest unchanged since the last run.
+     */
     bool checkForNewMixes(const std::string& yaml_url);
-    bool downloadAndAnalyzeMix(const Mix& mix);
+
+    /**
+     * @brief Download a mix the library lacks, analyze it and add it
+     * @param settled Optional; with it this returns once the file is fetched, with whether it was, and a
+     *        fetched mix is settled once it is in the library or has failed. Without it this waits.
+     * @return True if the mix is in the library (or on its way there, with settled)
+     */
+    bool downloadAndAnalyzeMix(const Mix& mix, std::function<void(bool)> settled = {});
+
     void syncMixesWithDatabase(const std::vector<Mix>& mixes);
 
+    /**
+     * @brief Token whose cancel() makes downloads, manifest fetches, retry waits and the lookahead stop early
+     *
+     * Cancelled partial downloads keep their resume state for the next start. The manager
+     * cancels it itself when destroyed; the app cancels first, so a control thread busy in
+     * the startup load returns before it is joined. Call before initialize.
+     */
+    void setCancellationToken(AutoVibez::Utils::CancellationToken token) {
+        _shutdown = std::move(token);
+    }
+
     // Callback for first mix added
     void setFirstMixAddedCallback(FirstMixAddedCallback callback) {
         _first_mix_callback = callback;
@@ -48,8 +108,10 @@ public:
     // Mix retrieval - direct database access
     Mix getMixById(const std::string& id);
     std::vector<Mix> getAllMixes();
+    MixCatalog::Snapshot getCatalogSnapshot() const;  // Shared and immutable; empty before initialize
     std::vector<Mix> getMixesByGenre(const std::string& genre);
     std::vector<Mix> getMixesByArtist(const std::string& artist);
+    std::vector<Mix> searchMixes(const std::string& query, int limit = Constants::SEARCH_RESULT_LIMIT);
     std::vector<Mix> getDownloadedMixes();
     std::vector<Mix> getFavoriteMixes();
 
@@ -76,6 +138,11 @@ public:
     int getCurrentPosition() const;
     int getDuration() const;
 
+    /**
+     * @brief Position from the player's sample clock, to the millisecond
+     */
+    int64_t getPositionMs() const;
+
     // User data update methods
     bool toggleFavorite(const std::string& mix_id);
     bool softDeleteMix(const std::string& mix_id);
@@ -87,12 +154,117 @@ public:
     Mix getRandomAvailableMix(const std::string& exclude_mix_id);
     Mix getRandomAvailableMixByGenre(const std::string& genre);
     Mix getRandomAvailableMixByGenre(const std::string& genre, const std::string& exclude_mix_id);
-    std::vector<Mix> getAvailableMixes();
+    MixCatalog::Snapshot getAvailableMixes() const;  // Shared and immutable, like getCatalogSnapshot
+
+    // Play queue
+    /**
+     * @brief Mixes picked ahead of playback (call before initialize(); 0 picks each one when it is needed)
+     */
+    void setPlayQueueDepth(int depth) {
+        _play_queue_depth = depth > 0 ? static_cast<size_t>(depth) : 0;
+    }
+
+    /**
+     * @brief Percentage of picks that follow on from the previous mix with a similar one (call before initialize())
+     */
+    void setSimilarMixProbability(int probability) {
+        _similar_mix_probability = probability;
+    }
+
+    /**
+     * @brief Take the next mix to play: the head of the play queue, or one picked now
+     *
+     * Picks follow the smart-selection rules for the current genre, then any mix, then
+     * (when streaming) a catalogue mix that is not downloaded yet.
+     */
+    Mix takeNextMix();
+
+    /**
+     * @brief Mixes queued to follow the current one, next first
+     */
+    std::vector<Mix> getUpcomingMixes() const;
+
+    /**
+     * @brief Changes each time the queued mixes do, so callers can tell when to read them again
+     */
+    uint64_t getPlayQueueRevision() const {
+        return _play_queue_revision.load();
+    }
+
+    /**
+     * @brief Move queued mixes that are not local yet to the front of the downloads, next first (control thread)
+     */
+    void updateQueueDownloads();
+
+    /**
+     * @brief Hold background downloads to the playing limit while a mix plays, full speed otherwise (control thread)
+     *
+     * The mix being streamed and the next one to play download at full speed either way.
+     */
+    void updateDownloadBandwidth();
+
+    /**
+     * @brief Run library consistency checks within their time budget; see LibraryMaintenance (control thread)
+     */
+    void updateMaintenance();
+
+    /**
+     * @brief Publish or take in the shared catalog, at most every SHARED_CATALOG_SYNC_INTERVAL_MS (control thread)
+     */
+    void updateSharedCatalog();
+
+    /**
+     * @brief When the update calls next have work, for a control thread that sleeps in between
+     *
+     * The past while a crossfade runs. Mix endings and settled downloads are not timed;
+     * they call the wake handler instead.
+     */
+    std::chrono::steady_clock::time_point getNextUpdate() const;
+
+    /**
+     * @brief Where the resume record is kept; empty (the default) neither saves nor resumes one
+     */
+    void setResumeStatePath(const std::string& path) {
+        _resume_state_path = path;
+    }
+
+    /**
+     * @brief Carry on with the mix the resume record names, at its saved position, before initialize
+     *
+     * Opens the file directly with the gain and seek index the record keeps, so no
+     * database or catalog is needed and audio is back long before either has loaded.
+     * The saved genre and volume are applied; initialize() restores the saved queue.
+     * @return True if a mix is playing (or paused, as it was saved)
+     */
+    bool resumePlayback();
+
+    /**
+     * @brief Rewrite the resume record, at most every RESUME_SAVE_INTERVAL_MS and only when it changed (control thread)
+     */
+    void updateResumeState();
+
+    /**
+     * @brief Bytes per second the background downloads share while a mix plays; 0 never limits them
+     */
+    void setPlayingDownloadLimit(int64_t bytes_per_second) {
+        _playing_download_limit = bytes_per_second;
+    }
 
     // Audio functionality
     bool downloadAndPlayMix(const Mix& mix);
     bool playMix(const Mix& mix);
     bool togglePause();
+    /**
+     * @brief Move playback of the current mix forwards or backwards
+     * @param seconds Offset from the current position (negative seeks back)
+     * @return True if successful, false otherwise
+     */
+    bool seekBy(int seconds);
+    /**
+     * @brief Seek to a position given to the millisecond, such as a sync leader's
+     * @return True if successful, false otherwise
+     */
+    bool seekToMs(int64_t position_ms);
     /**
      * @brief Stop playback
      * @return True if successful, false otherwise
@@ -121,17 +293,153 @@ public:
         return _crossfade_duration_ms;
     }
 
+    // Gapless lookahead
+    /**
+     * @brief Advance the next-mix lookahead (main thread, once per frame)
+     *
+     * Picks the follow-up mix while the current one plays, prepares it in the background
+     * (download, validation, decoder open and pre-decode) and queues it on the player.
+     * @return True if the queued mix took over at the end of the previous one
+     */
+    bool updatePrefetch();
+
+    /**
+     * @brief Discard any prepared or in-flight follow-up mix
+     */
+    void clearPrefetch();
+
+    void setGaplessEnabled(bool enabled) {
+        _gapless_enabled = enabled;
+        if (!enabled) {
+            clearPrefetch();
+        }
+    }
+    bool isGaplessEnabled() const {
+        return _gapless_enabled;
+    }
+    const Mix& getCurrentMix() const {
+        return current_mix;
+    }
+    const Mix& getQueuedMix() const {
+        return _queued_mix;
+    }
+
+    // Progressive playback
+    /**
+     * @brief Let downloadAndPlayMix start a new mix before its download has finished
+     */
+    void setStreamingEnabled(bool enabled) {
+        _streaming_enabled = enabled;
+    }
+    bool isStreamingEnabled() const {
+        return _streaming_enabled;
+    }
+
+    /**
+     * @brief Bytes that must be on disk before a streamed mix starts playing
+     */
+    void setStreamStartBytes(int64_t bytes) {
+        _stream_start_bytes = bytes;
+    }
+    int64_t getStreamStartBytes() const {
+        return _stream_start_bytes;
+    }
+
+    /**
+     * @brief Check whether a download of this mix is running
+     */
+    bool isDownloadActive(const std::string& mix_id);
+
+    /**
+     * @brief The download queue and each transfer in flight now, with per-host totals of finished ones
+     */
+    DownloadStats getDownloadStats();
+
+    /**
+     * @brief Per-host totals of the downloads that ended this session
+     */
+    DownloadTelemetry& getDownloadTelemetry() {
+        return _download_telemetry;
+    }
+
+    // Loudness normalization
+    /**
+     * @brief Level mixes to a common integrated loudness using their ingest analysis
+     * @param enabled Apply the per-mix gain when a mix is loaded
+     * @param target_lufs Integrated loudness every mix is brought to
+     */
+    void setLoudnessNormalization(bool enabled, double target_lufs) {
+        _normalization_enabled = enabled;
+        _loudness_target_lufs = target_lufs;
+    }
+    bool isLoudnessNormalizationEnabled() const {
+        return _normalization_enabled;
+    }
+
+    /**
+     * @brief Keep an Opus copy of each downloaded mix and play it instead of the MP3 (call before initialize())
+     *
+     * Copies are made one at a time at TaskPriority::Maintenance after ingest, and for
+     * mixes downloaded earlier from initialize(); they count towards the cache quota.
+     * Without Opus support in the build nothing is transcoded.
+     * @param bitrate_kbps Copy bitrate, clamped to TRANSCODE_MIN/MAX_BITRATE_KBPS
+     */
+    void setTranscodeCache(bool enabled, int bitrate_kbps) {
+        _transcode_enabled = enabled;
+        _transcode_bitrate_kbps = bitrate_kbps;
+    }
+
+    /**
+     * @brief Mixes waiting for or in the middle of their transcode
+     */
+    size_t getPendingTranscodes() const {
+        return _transcode_queue ? _transcode_queue->getPendingCount() : 0;
+    }
+
+    /**
+     * @brief Gain a mix is played with: towards the target, capped by its peak headroom
+     * @param mix Mix with stored analysis
+     * @return Gain in dB, 0 if the mix has not been analyzed or normalization is off
+     */
+    double getPlaybackGainDb(const Mix& mix) const;
+
     // Mix files management
     bool clearMixFiles();
+    /**
+     * @brief Bytes the downloaded mixes take, from the running total the cache keeps
+     */
     size_t getMixFilesSize() const;
-    bool cleanupCorruptedMixFiles();
-    bool cleanupMissingFiles();              // New method to remove database entries for missing files
-    bool validateDatabaseFileConsistency();  // New method to check database-file consistency
 
-    // Background downloads
+    /**
+     * @brief Disk quota for the downloaded mixes; 0 keeps every one
+     *
+     * Over it, the mix cache evicts in the background. Favorites and the mixes playing
+     * and next are kept; evicted mixes are downloaded again when played or queued.
+     */
+    void setMixCacheQuota(int64_t bytes);
+
+    /**
+     * @brief Share downloaded mixes with other AutoVibez nodes on the LAN and fetch from them first
+     *
+     * Starts the PeerCache, offers it every downloaded mix with a content hash and each new
+     * one as it lands, and has the downloader look there before a mix's URL. A cache that
+     * can't start is logged and left off. Call after initialize.
+     */
+    void setPeerCacheEnabled(bool enabled);
+
+    /**
+     * @brief Reseed the random mix picks, so synced nodes with the same library pick alike (call after initialize)
+     */
+    void setSelectionSeed(uint32_t seed);
+
+    // Background downloads, run by a fixed pool of workers; favorites are fetched first
     bool downloadMixBackground(const Mix& mix);
-    void cleanupCompletedDownloads();
-    bool cleanupInconsistentIds();
+
+    /**
+     * @brief Drop a queued download or abort the transfer of a running one
+     * @return False if the mix is not downloading
+     */
+    bool cancelDownload(const std::string& mix_id);
     bool downloadMissingMixesBackground();  // New method to download missing mixes
 
     /**
@@ -172,47 +480,264 @@ public:
      */
     std::string findGenreCaseInsensitive(const std::string& target_genre);
 
-    // Message overlay
-    void setMessageOverlay(AutoVibez::UI::MessageOverlayWrapper* messageOverlay) {
-        _messageOverlay = messageOverlay;
+    /**
+     * @brief Route the player's decoded output to a PCM consumer
+     * @param callback Tap invoked on the audio thread, or nullptr to remove it
+     * @param userdata Opaque pointer handed back to the callback
+     */
+    void setPcmTap(AutoVibez::Audio::MixPlayer::PcmTapCallback callback, void* userdata);
+
+    /**
+     * @brief Called when a mix ends or hands off (on the audio thread) and when a download settles
+     *
+     * Lets a control thread that sleeps until getNextUpdate() react at once; the handler must not block.
+     */
+    void setWakeHandler(std::function<void()> handler);
+
+    /**
+     * @brief Playback rate to request when the player is created (call before initialize())
+     */
+    void setRequestedOutputRate(int rate) {
+        _requested_output_rate = rate;
+    }
+
+    /**
+     * @brief libmpg123 synth the player decodes with (call before initialize()), empty for its own choice
+     */
+    void setDecoderSynth(const std::string& synth) {
+        _decoder_synth = synth;
+    }
+
+    /**
+     * @brief Journal and sync pragmas for the mix database (call before initialize())
+     */
+    void setDatabaseTuning(const SqliteTuning& tuning) {
+        _database_tuning = tuning;
+    }
+
+    /**
+     * @brief Share the library catalog with the other instances on this host (call before initialize())
+     */
+    void setSharedCatalogEnabled(bool enabled) {
+        _shared_catalog = enabled;
+    }
+
+    /**
+     * @brief Trade play stats and favorites with a sync server every interval (call before initialize())
+     * @param url Empty to keep them on this node
+     */
+    void setMixSync(const std::string& url, int interval_seconds) {
+        _mix_sync_url = url;
+        _mix_sync_interval_seconds = interval_seconds;
+    }
+
+    /**
+     * @brief Rate the player's output and PCM tap run at, or 0 before initialize()
+     */
+    int getOutputRate() const {
+        return player ? player->getOutputRate() : 0;
+    }
+
+    /**
+     * @brief Delay the speakers behind the PCM tap (frames at the output rate)
+     */
+    void setOutputDelayFrames(int frames) {
+        if (player) {
+            player->setOutputDelayFrames(frames);
+        }
+    }
+
+    /**
+     * @brief Replace playback with the latency calibration clicks
+     */
+    void setCalibrationClicks(bool enabled) {
+        if (player) {
+            player->setCalibrationClicks(enabled);
+        }
+    }
+
+    /**
+     * @brief Receive user feedback messages; called on the thread that started the mix
+     */
+    void setMessageHandler(MessageHandler handler) {
+        _message_handler = std::move(handler);
     }
 
 private:
     std::unique_ptr<MixDatabase> database;
+    std::unique_ptr<MixCache> _mix_cache;
+    std::unique_ptr<LibraryMaintenance> _maintenance;
+    int64_t _mix_cache_quota{0};
+    std::shared_ptr<PeerCache> _peer_cache;  // Shared with the downloader
     std::unique_ptr<MixMetadata> metadata;
     std::unique_ptr<MixDownloader> downloader;
     std::unique_ptr<AutoVibez::Audio::MixPlayer> player;
     std::unique_ptr<AutoVibez::Audio::MP3Analyzer> mp3_analyzer;
+    AutoVibez::Utils::Mp3ProbeCache _probe_cache;  // Shared by maintenance, ingest and corruption checks
     std::string db_path;
     std::string data_dir;
     Mix current_mix;
-    std::vector<Mix> available_mixes;
-    std::vector<std::future<bool>> _download_futures;
+    MixCatalog::Snapshot available_mixes;  // The remote list, compact as the library is
+    // The manifest loadMixMetadata fetched, handed to the checkForNewMixes after it
+    std::string _manifest_url;
+    std::vector<Mix> _manifest_mixes;
+    bool _manifest_unchanged = false;
+    std::unique_ptr<DownloadScheduler> _download_scheduler;
     std::string _current_genre;
-    std::vector<std::string> _available_genres;
+    int _catalog_listener = 0;
     FirstMixAddedCallback _first_mix_callback;
 
-    // Message overlay for user feedback
-    AutoVibez::UI::MessageOverlayWrapper* _messageOverlay = nullptr;
+    // PCM tap forwarded to the player once it exists
+    AutoVibez::Audio::MixPlayer::PcmTapCallback _pcm_tap = nullptr;
+    void* _pcm_tap_userdata = nullptr;
+    std::function<void()> _wake_handler;  // Swapped under _downloads_mutex with the player's events detached
+    int _requested_output_rate = Constants::DEFAULT_SAMPLE_RATE;
+    std::string _decoder_synth;
+    SqliteTuning _database_tuning = SqliteTuning::fast();
+    bool _shared_catalog{false};
+    std::chrono::steady_clock::time_point _last_shared_catalog_sync;
+    std::string _resume_state_path;
+    std::chrono::steady_clock::time_point _last_resume_save;
+    std::string _saved_resume_state;         // As last written, so an unchanged record is not written again
+    ResumeState _resume_options;             // Gain and seek index of the mix in _resume_options.mix.id
+    std::vector<std::string> _resume_queue;  // Restored into the play queue by initialize()
+    std::string _mix_sync_url;
+    int _mix_sync_interval_seconds{Constants::MIX_SYNC_DEFAULT_INTERVAL_SECONDS};
+    std::unique_ptr<MixSyncAgent> _mix_sync;  //!< Writes to the database on its own thread
+
+    // User feedback (the app forwards it to the message overlay)
+    MessageHandler _message_handler;
+
+    // Next-mix lookahead, prepared off the render thread
+    struct PreparedMix {
+        Mix mix;
+        std::string local_path;
+        std::string after_mix_id;  //!< Mix that was playing when the lookahead started
+        std::unique_ptr<AutoVibez::Audio::PcmSource> source;
+    };
+    AutoVibez::Utils::CancellationToken _shutdown;
+    bool _gapless_enabled{true};
+    std::future<PreparedMix> _prefetch_future;
+    std::string _prefetch_for_mix_id;
+    Mix _queued_mix;
+    std::string _queued_path;
+
+    // Downloads in flight, keyed by mix ID; streamed playback reads their progress
+    std::mutex _downloads_mutex;
+    std::map<std::string, std::shared_ptr<AutoVibez::Utils::DownloadProgress>> _active_downloads;
+    std::string _next_mix_id;  // Its download runs past the bandwidth ceiling
+    std::atomic<bool> _streaming_enabled{true};  //!< Read by the play queue's picks
+    int64_t _stream_start_bytes{static_cast<int64_t>(Constants::DEFAULT_STREAM_START_KB) * 1024};
+    int64_t _playing_download_limit{static_cast<int64_t>(Constants::PLAYING_DOWNLOAD_LIMIT_KB) * 1024};
+    std::string _streaming_mix_id;  //!< Mix playing from a partial file
+    DownloadTelemetry _download_telemetry;
+    DownloadBackoff _download_backoff;               //!< Mixes whose downloads failed, loaded from the database
+    AutoVibez::Utils::CircuitBreaker _host_breaker;  //!< Background downloads from a host that is down fail at once
+    std::unique_ptr<IngestPipeline> _ingest_pipeline;  //!< Analyzes and indexes what the download workers fetch
+
+    // Ingest analysis worker: one decode per new file for loudness, tempo and the seek index
+    std::thread _analysis_thread;
+    std::mutex _analysis_mutex;
+    std::condition_variable _analysis_cv;
+    std::deque<Mix> _analysis_queue;
+    std::atomic<bool> _analysis_stop{false};
+    bool _normalization_enabled{true};
+    double _loudness_target_lufs{Constants::DEFAULT_LOUDNESS_TARGET_LUFS};
+
+    // Low-bitrate copies, made in idle time after ingest
+    bool _transcode_enabled{false};
+    int _transcode_bitrate_kbps{Constants::TRANSCODE_DEFAULT_BITRATE_KBPS};
+    std::unique_ptr<TranscodeQueue> _transcode_queue;
+
+    // The play in progress, logged to the play history when it ends
+    int64_t _play_started_ms{0};  //!< Epoch ms, 0 when nothing is playing
+    std::chrono::steady_clock::time_point _play_started;
 
     // Crossfade state
     bool _crossfade_enabled{false};
     bool _crossfade_active{false};
     int _crossfade_duration_ms{Constants::DEFAULT_CROSSFADE_DURATION_MS};
     int _crossfade_progress{0};
-    Mix _crossfade_new_mix;
-    Mix _crossfade_old_mix;
-    Uint32 _crossfade_start_time{0};
-    int _old_volume{0};
-    int _new_volume{0};
-    bool _suppress_volume_output{false};
 
     // Static random number generator to eliminate code duplication
     static std::random_device _random_device;
     static std::mt19937 _random_generator;
+    static std::mutex _random_mutex;  //!< The play queue draws from its own thread
+
+    // Upcoming mixes, picked on the queue's thread; downloads of them go ahead of the background ones
+    size_t _play_queue_depth{Constants::DEFAULT_PLAY_QUEUE_DEPTH};
+    int _similar_mix_probability{Constants::DEFAULT_SIMILAR_MIX_PROBABILITY};
+    std::unique_ptr<PlayQueue> _play_queue;
+    std::atomic<uint64_t> _play_queue_revision{0};
+    std::atomic<bool> _queue_downloads_stale{true};
 
     // Helper method for random selection
     size_t getRandomIndex(size_t max_index) const;
+
+    /**
+     * @brief Uniform pick among positions of a snapshot (every entry when null), never exclude_mix_id
+     * @return nullptr when nothing else is left; nothing is copied either way
+     */
+    const MixRecord* pickExcluding(const MixCatalogSnapshot& mixes, const std::vector<uint32_t>* positions,
+                                   const std::string& exclude_mix_id) const;
+
+    // Next-mix selection shared by the play queue and the lookahead
+    Mix pickNextMix(const std::string& genre, const std::string& exclude_mix_id);
+    const std::string& switchGenre(const std::string& genre);
+
+    // Playback helpers shared by playMix and startCrossfade
+    bool resolvePlayablePath(const Mix& mix, std::string& local_path);
+    void onMixStarted(const Mix& mix, const std::string& local_path);
+    void closePlayEvent();
+    void discardIfCorrupted(const Mix& mix, const std::string& local_path);
+    void startPrefetch(const Mix& next);
+
+    /**
+     * @brief Hand the player the wake handler, through onPlaybackEvent
+     */
+    void attachPlaybackEvents();
+    static void onPlaybackEvent(void* userdata);
+
+    // Download bookkeeping and progressive playback helpers
+    std::shared_ptr<AutoVibez::Utils::DownloadProgress> beginDownload(const std::string& mix_id);
+    std::shared_ptr<AutoVibez::Utils::DownloadProgress> findActiveDownload(const std::string& mix_id);
+
+    /**
+     * @brief Let the next mix's download, running or still to start, past the bandwidth ceiling
+     */
+    void setNextToPlay(const std::string& mix_id);
+
+    /**
+     * @brief Keep the current and next mixes' files from the cache's eviction
+     */
+    void protectPlayingMixes();
+    void endDownload(const std::string& mix_id);
+    bool runDownload(const Mix& mix, std::shared_ptr<AutoVibez::Utils::DownloadProgress> progress,
+                     std::function<void(bool)> settled = {});
+
+    // Ingest pipeline stages after the fetch: tags and renaming on the pool, then the batched insert
+    bool analyzeFetchedMix(IngestJob& job);
+    void indexFetchedMixes(std::vector<IngestJob>& batch);
+    bool scheduleDownload(const Mix& mix, DownloadPriority priority);
+
+    /**
+     * @brief Back the mix off before its next attempt, and store that for after a restart
+     */
+    void recordDownloadFailure(const std::string& mix_id);
+    void stopDownloads();
+    bool playMixWhileDownloading(const Mix& mix);
+    bool playLocalMix(const Mix& mix);  // The file is on disk: crossfade to it or start it
+    void collectStreamedMix();
+
+    // Loudness/tempo analysis helpers
+    void queueAnalysis(const Mix& mix);
+    void analysisLoop();
+    void stopAnalysis();
+    AutoVibez::Audio::MixLoadOptions loadOptions(const Mix& mix);
+
+    // Transcoded copies
+    void queueTranscode(const Mix& mix);
+    void transcodeMix(const Mix& mix, const AutoVibez::Utils::CancellationToken& cancel);
 };
 
 }  // namespace AutoVibez::Data
\ No newline at end of file
@@ -1,43 +1,61 @@
 #include "mix_metadata.hpp"
 
-#include <curl/curl.h>
 #include <yaml-cpp/yaml.h>
 
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 
 #include "constants.hpp"
+#include "manifest_snapshot.hpp"
+#include "memory_accounting.hpp"
 #include "path_manager.hpp"
+#include "trace_recorder.hpp"
+#include "transfer_engine.hpp"
 #include "url_utils.hpp"
 
 using AutoVibez::Data::Mix;
 using AutoVibez::Data::MixMetadata;
 
-namespace AutoVibez {
-namespace Data {
-
-// Callback function for CURL to write data to string
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    userp->append(static_cast<const char*>(contents), size * nmemb);
-    return size * nmemb;
+namespace {
+// Size and mtime, which change whenever the file is rewritten
+bool fileStamp(const std::string& path, std::string& stamp) {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    const auto written = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    stamp = std::to_string(size) + ":" + std::to_string(written.time_since_epoch().count());
+    return true;
 }
 
-MixMetadata::MixMetadata() {
-    // Initialize CURL only if not already initialized
-    CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
-    if (res != CURLE_OK) {
-        // CURL might already be initialized, which is fine
-        // We'll handle this gracefully
-    }
+// A server's validators name one version of a remote manifest; empty when it sent none
+std::string validatorStamp(const std::string& etag, const std::string& last_modified) {
+    return etag.empty() && last_modified.empty() ? std::string() : etag + "\n" + last_modified;
 }
 
-MixMetadata::~MixMetadata() {
-    // Cleanup CURL - this is safe to call even if not initialized
-    // or if other parts of the application are using CURL
-    curl_global_cleanup();
+// The text and the node tree parsed from it, which dwarfs it
+size_t manifestBytes(const std::string& text) {
+    return text.capacity() + text.size() * Constants::YAML_TREE_BYTES_PER_TEXT_BYTE;
 }
+}  // namespace
+
+namespace AutoVibez {
+namespace Data {
+
+MixMetadata::MixMetadata() = default;
+
+MixMetadata::~MixMetadata() = default;
 
 std::vector<Mix> MixMetadata::loadFromYaml(const std::string& yaml_url) {
+    AUTOVIBEZ_TRACE_SCOPE_DETAIL("manifest", "loadFromYaml", yaml_url);
     clearError();
+    unchanged_ = false;
+    from_snapshot_ = false;
 
     // Check if it's a URL or local file using proper URL validation
     if (AutoVibez::Utils::UrlUtils::isValidUrl(yaml_url)) {
@@ -49,8 +67,15 @@ std::vector<Mix> MixMetadata::loadFromYaml(const std::string& yaml_url) {
 
 std::vector<Mix> MixMetadata::loadFromLocalFile(const std::string& file_path) {
     clearError();
+    unchanged_ = false;
+    from_snapshot_ = false;
     std::vector<Mix> mixes;
 
+    std::string stamp;
+    if (fileStamp(file_path, stamp) && loadSnapshot(file_path, stamp, mixes)) {
+        return mixes;
+    }
+
     try {
         // Check if file exists and is readable
         std::ifstream file(file_path);
@@ -74,6 +99,7 @@ std::vector<Mix> MixMetadata::loadFromLocalFile(const std::string& file_path) {
             return mixes;
         }
 
+        AutoVibez::Utils::MemoryCharge memory(AutoVibez::Utils::MemoryTag::Manifest, manifestBytes(content));
         YAML::Node config = YAML::Load(content);
 
         if (!config["mixes"]) {
@@ -103,6 +129,9 @@ std::vector<Mix> MixMetadata::loadFromLocalFile(const std::string& file_path) {
             }
         }
 
+        if (isSuccess() && !stamp.empty()) {
+            storeSnapshot(file_path, stamp, mixes);
+        }
         return mixes;
     } catch (const YAML::Exception& e) {
         setError("YAML parsing error: " + std::string(e.what()));
@@ -114,34 +143,100 @@ std::vector<Mix> MixMetadata::loadFromLocalFile(const std::string& file_path) {
     return mixes;
 }
 
+void MixMetadata::setCachePath(const std::string& cache_path) {
+    cache_path_ = cache_path;
+}
+
+bool MixMetadata::isUnchanged() const {
+    return unchanged_;
+}
+
+void MixMetadata::setSnapshotPath(const std::string& snapshot_path) {
+    snapshot_path_ = snapshot_path;
+}
+
+bool MixMetadata::isFromSnapshot() const {
+    return from_snapshot_;
+}
+
+bool MixMetadata::loadSnapshot(const std::string& source, const std::string& stamp, std::vector<Mix>& mixes) {
+    if (snapshot_path_.empty()) {
+        return false;
+    }
+    ManifestSnapshot snapshot;
+    if (!snapshot.open(snapshot_path_) || !snapshot.matches(source, stamp)) {
+        return false;
+    }
+    mixes = snapshot.toMixes();
+    from_snapshot_ = true;
+    return true;
+}
+
+void MixMetadata::storeSnapshot(const std::string& source, const std::string& stamp,
+                                const std::vector<Mix>& mixes) const {
+    if (!snapshot_path_.empty()) {
+        ManifestSnapshot::write(snapshot_path_, mixes, source, stamp);
+    }
+}
+
 std::vector<Mix> MixMetadata::loadFromRemoteFile(const std::string& url) {
     clearError();
+    unchanged_ = false;
+    from_snapshot_ = false;
     std::vector<Mix> mixes;
 
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        setError("Failed to initialize CURL");
-        return mixes;
+    CachedManifest cached = readCache();
+    if (cached.url != url) {
+        cached = CachedManifest();
     }
 
     std::string response;
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, Constants::HTTP_TIMEOUT_SECONDS);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, Constants::HTTP_CONNECT_TIMEOUT_SECONDS);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "AutoVibez/1.0");
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        setError("HTTP request failed: " + std::string(curl_easy_strerror(res)));
+    CachedManifest fetched;
+    fetched.url = url;
+    AutoVibez::Utils::TransferRequest request;
+    request.url = url;
+    request.timeout_seconds = Constants::HTTP_TIMEOUT_SECONDS;
+    request.connect_timeout_seconds = Constants::HTTP_CONNECT_TIMEOUT_SECONDS;
+    request.user_agent = "AutoVibez/1.0";
+    if (!cached.body.empty() && !cached.etag.empty()) {
+        request.headers.push_back("If-None-Match: " + cached.etag);
+    }
+    if (!cached.body.empty() && !cached.last_modified.empty()) {
+        request.headers.push_back("If-Modified-Since: " + cached.last_modified);
+    }
+    request.on_header = [&fetched](const std::string& name, const std::string& value) {
+        if (name == "etag") {
+            fetched.etag = value;
+        } else if (name == "last-modified") {
+            fetched.last_modified = value;
+        }
+    };
+    request.on_data = [&response](const char* data, size_t size) {
+        response.append(data, size);
+        return true;
+    };
+    request.on_progress = [this](int64_t, int64_t) { return !cancel_.isCancelled(); };
+
+    const AutoVibez::Utils::TransferResult result = AutoVibez::Utils::TransferEngine::shared().perform(request);
+    if (!result.ok) {
+        setError("HTTP request failed: " + result.error);
         return mixes;
     }
 
+    std::string stamp = validatorStamp(fetched.etag, fetched.last_modified);
+    if (result.response_code == Constants::HTTP_NOT_MODIFIED && !cached.body.empty()) {
+        // The server still has the manifest we kept; no body came
+        unchanged_ = true;
+        stamp = validatorStamp(cached.etag, cached.last_modified);
+        if (loadSnapshot(url, stamp, mixes)) {
+            return mixes;
+        }
+        response = std::move(cached.body);
+    } else if (!fetched.etag.empty() || !fetched.last_modified.empty()) {
+        fetched.body = response;
+        writeCache(fetched);
+    }
+
     // Check if response is empty or too small for a valid YAML file
     if (response.empty() || response.length() < Constants::MIN_YAML_RESPONSE_LENGTH) {
         setError("Empty or invalid response from server");
@@ -149,6 +244,7 @@ std::vector<Mix> MixMetadata::loadFromRemoteFile(const std::string& url) {
     }
 
     try {
+        AutoVibez::Utils::MemoryCharge memory(AutoVibez::Utils::MemoryTag::Manifest, manifestBytes(response));
         YAML::Node config = YAML::Load(response);
 
         if (!config["mixes"]) {
@@ -178,6 +274,9 @@ std::vector<Mix> MixMetadata::loadFromRemoteFile(const std::string& url) {
             }
         }
 
+        if (isSuccess() && !stamp.empty()) {
+            storeSnapshot(url, stamp, mixes);
+        }
         return mixes;
     } catch (const YAML::Exception& e) {
         setError("YAML parsing error: " + std::string(e.what()));
@@ -188,6 +287,61 @@ std::vector<Mix> MixMetadata::loadFromRemoteFile(const std::string& url) {
     return mixes;
 }
 
+MixMetadata::CachedManifest MixMetadata::readCache() const {
+    CachedManifest cached;
+    if (cache_path_.empty()) {
+        return cached;
+    }
+    std::ifstream file(cache_path_, std::ios::binary);
+    std::string line;
+    // Validators, one per line, then a blank line and the body as it came
+    while (std::getline(file, line) && !line.empty()) {
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        const std::string key = line.substr(0, equals);
+        const std::string value = line.substr(equals + 1);
+        if (key == "url") {
+            cached.url = value;
+        } else if (key == "etag") {
+            cached.etag = value;
+        } else if (key == "last_modified") {
+            cached.last_modified = value;
+        }
+    }
+    cached.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return cached;
+}
+
+void MixMetadata::writeCache(const CachedManifest& manifest) const {
+    if (cache_path_.empty()) {
+        return;
+    }
+    std::error_code error;
+    auto parent = std::filesystem::path(cache_path_).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Written beside the target and renamed so a crash never leaves a body without its validators
+    const std::string temp_path = cache_path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        file << "url=" << manifest.url << '\n'
+             << "etag=" << manifest.etag << '\n'
+             << "last_modified=" << manifest.last_modified << "\n\n"
+             << manifest.body;
+        if (!file) {
+            return;
+        }
+    }
+    std::filesystem::rename(temp_path, cache_path_, error);
+}
+
 Mix MixMetadata::parseMixFromYaml(const YAML::Node& mix_node) {
     Mix mix;
 
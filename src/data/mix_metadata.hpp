@@ -3,9 +3,11 @@
 #include <yaml-cpp/yaml.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base_metadata.hpp"
+#include "cancellation_token.hpp"
 #include "error_handler.hpp"
 #include "url_utils.hpp"
 #include "uuid_utils.hpp"
@@ -20,6 +22,13 @@ struct Mix : public BaseMetadata {
     std::string url;                // Download URL
     std::string original_filename;  // Original filename from URL
 
+    // Ingest analysis; only meaningful when has_analysis is set
+    bool has_analysis = false;
+    double loudness_lufs = 0.0;         // EBU R128 integrated loudness
+    double peak_dbfs = 0.0;             // Sample peak
+    double bpm = 0.0;                   // Estimated tempo, 0 if none was found
+    double spectral_centroid_hz = 0.0;  // Mean spectral centroid, 0 if not measured
+
     Mix() {}
 };
 
@@ -52,7 +61,55 @@ public:
      */
     std::vector<Mix> loadFromRemoteFile(const std::string& url);
 
+    /**
+     * @brief Keep the last remote manifest on disk and ask the server for it only if it changed since
+     * @param cache_path File for the manifest body with its ETag and Last-Modified; empty keeps nothing
+     */
+    void setCachePath(const std::string& cache_path);
+
+    /**
+     * @brief Whether the last remote load got a 304, so its mixes are the cached manifest's
+     */
+    bool isUnchanged() const;
+
+    /**
+     * @brief Compile each parsed manifest to a binary snapshot and load an unchanged one from it
+     * @param snapshot_path File for the ManifestSnapshot; empty parses the YAML every time
+     */
+    void setSnapshotPath(const std::string& snapshot_path);
+
+    /**
+     * @brief Whether the last load came from the snapshot rather than the YAML
+     */
+    bool isFromSnapshot() const;
+
+    /**
+     * @brief Abort a remote load in flight once the token is cancelled (at shutdown)
+     */
+    void setCancellationToken(AutoVibez::Utils::CancellationToken token) {
+        cancel_ = std::move(token);
+    }
+
 private:
+    /**
+     * @brief A manifest body as the server sent it, with the validators for asking again
+     */
+    struct CachedManifest {
+        std::string url;
+        std::string etag;
+        std::string last_modified;
+        std::string body;
+    };
+
+    CachedManifest readCache() const;
+    void writeCache(const CachedManifest& manifest) const;
+
+    /**
+     * @brief Fill mixes from the snapshot if it was compiled from this version of source
+     */
+    bool loadSnapshot(const std::string& source, const std::string& stamp, std::vector<Mix>& mixes);
+    void storeSnapshot(const std::string& source, const std::string& stamp, const std::vector<Mix>& mixes) const;
+
     /**
      * @brief Parse a single mix from YAML node
      * @param mix_node YAML node containing mix data
@@ -69,6 +126,11 @@ public:
     bool validateMix(const Mix& mix);
 
 private:
+    std::string cache_path_;
+    std::string snapshot_path_;
+    bool unchanged_ = false;
+    bool from_snapshot_ = false;
+    AutoVibez::Utils::CancellationToken cancel_;
 };
 
 }  // namespace AutoVibez::Data
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "mix_query_builder.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <sstream>
 
 namespace AutoVibez {
@@ -27,14 +29,26 @@ MixQueryBuilder& MixQueryBuilder::whereArtist() {
     return *this;
 }
 
+MixQueryBuilder& MixQueryBuilder::whereTag() {
+    addWhereCondition("id IN (SELECT mix_id FROM mix_tags WHERE tag = ?)");
+    parameter_count_++;
+    return *this;
+}
+
 MixQueryBuilder& MixQueryBuilder::whereId() {
-    addWhereCondition("id = ?");
+    addWhereCondition("id = mix_key(?)");
     parameter_count_++;
     return *this;
 }
 
 MixQueryBuilder& MixQueryBuilder::whereNotId() {
-    addWhereCondition("id != ?");
+    addWhereCondition("id != mix_key(?)");
+    parameter_count_++;
+    return *this;
+}
+
+MixQueryBuilder& MixQueryBuilder::whereIdAfter() {
+    addWhereCondition("id > mix_key(?)");
     parameter_count_++;
     return *this;
 }
@@ -54,6 +68,18 @@ MixQueryBuilder& MixQueryBuilder::whereHasBeenPlayed() {
     return *this;
 }
 
+MixQueryBuilder& MixQueryBuilder::whereNotPlayedSince() {
+    addWhereCondition("id NOT IN (SELECT mix_id FROM mix_play_stats WHERE last_played_ms >= ?)");
+    parameter_count_++;
+    return *this;
+}
+
+MixQueryBuilder& MixQueryBuilder::whereSkipStreakBelow() {
+    addWhereCondition("id NOT IN (SELECT mix_id FROM mix_play_stats WHERE skip_streak >= ?)");
+    parameter_count_++;
+    return *this;
+}
+
 MixQueryBuilder& MixQueryBuilder::orderBy(OrderBy order, bool ascending) {
     std::string direction = ascending ? "ASC" : "DESC";
 
@@ -79,6 +105,9 @@ MixQueryBuilder& MixQueryBuilder::orderBy(OrderBy order, bool ascending) {
         case OrderBy::Random:
             order_clause_ = "ORDER BY RANDOM()";
             break;
+        case OrderBy::Id:
+            order_clause_ = "ORDER BY id " + direction;
+            break;
         case OrderBy::None:
         default:
             order_clause_.clear();
@@ -146,10 +175,18 @@ std::string MixQueryBuilder::buildQuery(const SelectionCriteria& criteria, Order
         builder.whereArtist();
     }
 
+    if (!criteria.tag.empty()) {
+        builder.whereTag();
+    }
+
     if (!criteria.exclude_mix_id.empty()) {
         builder.whereNotId();
     }
 
+    if (!criteria.after_id.empty()) {
+        builder.whereIdAfter();
+    }
+
     if (criteria.favorites_only) {
         builder.whereFavorites();
     }
@@ -158,6 +195,14 @@ std::string MixQueryBuilder::buildQuery(const SelectionCriteria& criteria, Order
         builder.whereDownloaded();
     }
 
+    if (criteria.not_played_since_ms > 0) {
+        builder.whereNotPlayedSince();
+    }
+
+    if (criteria.max_skip_streak > 0) {
+        builder.whereSkipStreakBelow();
+    }
+
     builder.orderBy(order);
 
     if (criteria.limit > 0) {
@@ -167,6 +212,47 @@ std::string MixQueryBuilder::buildQuery(const SelectionCriteria& criteria, Order
     return builder.build();
 }
 
+std::vector<std::string> MixQueryBuilder::buildParameters(const SelectionCriteria& criteria) {
+    std::vector<std::string> parameters;
+    for (const std::string* value :
+         {&criteria.genre, &criteria.artist, &criteria.tag, &criteria.exclude_mix_id, &criteria.after_id}) {
+        if (!value->empty()) {
+            parameters.push_back(*value);
+        }
+    }
+    if (criteria.not_played_since_ms > 0) {
+        parameters.push_back(std::to_string(criteria.not_played_since_ms));
+    }
+    if (criteria.max_skip_streak > 0) {
+        parameters.push_back(std::to_string(criteria.max_skip_streak));
+    }
+    return parameters;
+}
+
+std::string MixQueryBuilder::buildSearchMatch(const std::string& text) {
+    std::istringstream words(text);
+    std::ostringstream match;
+    std::string word;
+    while (words >> word) {
+        // Punctuation alone holds no token, and FTS5 rejects an empty phrase
+        if (std::none_of(word.begin(), word.end(), [](unsigned char c) { return c >= 0x80 || std::isalnum(c); })) {
+            continue;
+        }
+        if (match.tellp() > 0) {
+            match << ' ';
+        }
+        match << '"';
+        for (char c : word) {
+            if (c == '"') {
+                match << '"';  // Doubled inside an FTS5 string
+            }
+            match << c;
+        }
+        match << "\"*";
+    }
+    return match.str();
+}
+
 void MixQueryBuilder::addWhereCondition(const std::string& condition) {
     where_conditions_.push_back(condition);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -11,11 +12,15 @@ namespace AutoVibez::Data {
 struct SelectionCriteria {
     std::string genre;
     std::string artist;
+    std::string tag;  // Case-insensitive, through the mix_tags index
     std::string exclude_mix_id;
+    std::string after_id;  // Keyset cursor: only ids after this one, for use with OrderBy::Id
     bool favorites_only = false;
     bool downloaded_only = false;
     bool include_deleted = false;
-    int limit = 0;  // 0 means no limit
+    int64_t not_played_since_ms = 0;  // Epoch ms; leaves out mixes with a play event since, 0 for no filter
+    int max_skip_streak = 0;          // Leaves out mixes skipped this many times running, 0 for no filter
+    int limit = 0;                    // 0 means no limit
 
     SelectionCriteria() = default;
 };
@@ -23,7 +28,7 @@ struct SelectionCriteria {
 /**
  * @brief Ordering options for queries
  */
-enum class OrderBy { None, Title, Artist, Genre, LastPlayed, PlayCount, DateAdded, Random };
+enum class OrderBy { None, Title, Artist, Genre, LastPlayed, PlayCount, DateAdded, Random, Id };
 
 /**
  * @brief Builder pattern for constructing SQL queries for Mix operations
@@ -57,6 +62,12 @@ public:
      */
     MixQueryBuilder& whereArtist();
 
+    /**
+     * @brief Add WHERE clause for mixes carrying a tag
+     * @return Reference to this builder for chaining
+     */
+    MixQueryBuilder& whereTag();
+
     /**
      * @brief Add WHERE clause for specific mix ID
      * @return Reference to this builder for chaining
@@ -69,6 +80,12 @@ public:
      */
     MixQueryBuilder& whereNotId();
 
+    /**
+     * @brief Add WHERE clause for ids after a keyset cursor
+     * @return Reference to this builder for chaining
+     */
+    MixQueryBuilder& whereIdAfter();
+
     /**
      * @brief Add WHERE clause for favorites only
      * @return Reference to this builder for chaining
@@ -87,6 +104,18 @@ public:
      */
     MixQueryBuilder& whereHasBeenPlayed();
 
+    /**
+     * @brief Add WHERE clause for mixes not played since a time, through the play aggregate
+     * @return Reference to this builder for chaining
+     */
+    MixQueryBuilder& whereNotPlayedSince();
+
+    /**
+     * @brief Add WHERE clause for mixes whose run of skips is below a limit
+     * @return Reference to this builder for chaining
+     */
+    MixQueryBuilder& whereSkipStreakBelow();
+
     /**
      * @brief Add ORDER BY clause
      * @param order Ordering option
@@ -122,12 +151,32 @@ public:
 
     /**
      * @brief Build a query based on selection criteria
+     *
+     * Placeholders come in the order genre, artist, tag, exclude_mix_id,
+     * after_id, not_played_since_ms, max_skip_streak, for the criteria that are set.
      * @param criteria Selection criteria
      * @param order Ordering option
      * @return Complete SQL query
      */
     static std::string buildQuery(const SelectionCriteria& criteria, OrderBy order = OrderBy::Title);
 
+    /**
+     * @brief Values for the placeholders of buildQuery, in order
+     * @param criteria Selection criteria
+     * @return One value per placeholder
+     */
+    static std::vector<std::string> buildParameters(const SelectionCriteria& criteria);
+
+    /**
+     * @brief Turn what a user typed into an FTS5 MATCH expression
+     *
+     * Every word becomes a quoted prefix term, so operators and quotes in the
+     * input are matched as text and a half-typed last word still finds mixes.
+     * @param text Search box contents
+     * @return Expression for SEARCH_MIXES, or empty string if there are no words
+     */
+    static std::string buildSearchMatch(const std::string& text);
+
 private:
     std::string query_parts_;
     std::vector<std::string> where_conditions_;
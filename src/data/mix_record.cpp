@@ -0,0 +1,123 @@
+#include "mix_record.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+uint32_t idOf(const MixStringPool& strings, const std::string& value) {
+    uint32_t id = 0;
+    strings.find(value, id);
+    return id;
+}
+}  // namespace
+
+MixStringPool::MixStringPool() {
+    intern("");
+}
+
+MixStringPool::MixStringPool(const MixStringPool& other) : values_(other.values_) {
+    // The copied index would view the other pool's strings
+    ids_.reserve(values_.size());
+    for (size_t i = 0; i < values_.size(); ++i) {
+        ids_.emplace(values_[i], static_cast<uint32_t>(i));
+    }
+}
+
+uint32_t MixStringPool::intern(std::string_view value) {
+    auto it = ids_.find(value);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<uint32_t>(values_.size());
+    values_.emplace_back(value);
+    ids_.emplace(values_.back(), id);
+    return id;
+}
+
+void MixStringPool::internFields(const Mix& mix) {
+    intern(mix.genre);
+    intern(mix.artist);
+    for (const std::string& tag : mix.tags) {
+        intern(tag);
+    }
+}
+
+bool MixStringPool::hasFields(const Mix& mix) const {
+    if (!ids_.count(mix.genre) || !ids_.count(mix.artist)) {
+        return false;
+    }
+    for (const std::string& tag : mix.tags) {
+        if (!ids_.count(tag)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MixStringPool::find(std::string_view value, uint32_t& id) const {
+    auto it = ids_.find(value);
+    if (it == ids_.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+MixRecord::MixRecord(const Mix& mix, const MixStringPool& strings)
+    : genre(idOf(strings, mix.genre)),
+      artist(idOf(strings, mix.artist)),
+      date_added_ms(mix.date_added_ms),
+      last_played_ms(mix.last_played_ms),
+      loudness_lufs(mix.loudness_lufs),
+      peak_dbfs(mix.peak_dbfs),
+      bpm(mix.bpm),
+      spectral_centroid_hz(mix.spectral_centroid_hz),
+      duration_seconds(mix.duration_seconds),
+      play_count(mix.play_count),
+      is_favorite(mix.is_favorite),
+      has_analysis(mix.has_analysis) {
+    const std::string* values[] = {&mix.id,          &mix.title,      &mix.url, &mix.local_path,
+                                   &mix.description, &mix.original_filename};
+    size_t length = 0;
+    for (const std::string* value : values) {
+        length += value->size();
+    }
+    text.reserve(length);
+    for (size_t i = 0; i < FIELD_COUNT; ++i) {
+        text += *values[i];
+        ends[i] = static_cast<uint32_t>(text.size());
+    }
+
+    tags.reserve(mix.tags.size());
+    for (const std::string& tag : mix.tags) {
+        tags.push_back(idOf(strings, tag));
+    }
+}
+
+Mix MixRecord::toMix(const MixStringPool& strings) const {
+    Mix mix;
+    mix.id = id();
+    mix.title = title();
+    mix.artist = strings.get(artist);
+    mix.genre = strings.get(genre);
+    mix.url = url();
+    mix.local_path = localPath();
+    mix.description = description();
+    mix.original_filename = field(OriginalFilename);
+    mix.date_added_ms = date_added_ms;
+    mix.last_played_ms = last_played_ms;
+    mix.tags.reserve(tags.size());
+    for (uint32_t tag : tags) {
+        mix.tags.push_back(strings.get(tag));
+    }
+    mix.duration_seconds = duration_seconds;
+    mix.play_count = play_count;
+    mix.is_favorite = is_favorite;
+    mix.has_analysis = has_analysis;
+    mix.loudness_lufs = loudness_lufs;
+    mix.peak_dbfs = peak_dbfs;
+    mix.bpm = bpm;
+    mix.spectral_centroid_hz = spectral_centroid_hz;
+    return mix;
+}
+
+}  // namespace AutoVibez::Data
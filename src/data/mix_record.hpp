@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "memory_accounting.hpp"
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Interned genre, artist and tag strings, each stored once and named by an id
+ *
+ * Id 0 is the empty string. Records only hold ids, so a pool is shared by every
+ * record built against it and must outlive them; the catalog copies the pool
+ * rather than change one a published snapshot reads.
+ */
+class MixStringPool {
+public:
+    MixStringPool();
+    MixStringPool(const MixStringPool& other);
+    MixStringPool& operator=(const MixStringPool&) = delete;
+
+    /**
+     * @return The id of value, added if it is new
+     */
+    uint32_t intern(std::string_view value);
+
+    /**
+     * @brief Intern the genre, artist and tags of a mix
+     */
+    void internFields(const Mix& mix);
+
+    /**
+     * @return True if the genre, artist and tags of mix are all interned already
+     */
+    bool hasFields(const Mix& mix) const;
+
+    /**
+     * @return False if value was never interned
+     */
+    bool find(std::string_view value, uint32_t& id) const;
+
+    const std::string& get(uint32_t id) const {
+        return values_[id];
+    }
+
+    size_t size() const {
+        return values_.size();
+    }
+
+private:
+    std::deque<std::string> values_;  // Growing never moves the strings the index views
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+/**
+ * @brief Allocator for everything a catalog record owns, so records count once however many snapshots share them
+ */
+template <typename T>
+using CatalogAllocator = Utils::TaggedAllocator<T, Utils::MemoryTag::Catalog>;
+
+/**
+ * @brief One mix as the in-memory library holds it
+ *
+ * Genre, artist and tags are pool ids and every other string shares one buffer,
+ * so a record costs a fraction of a Mix. Build the Mix with toMix when one is needed.
+ * Create records with allocate_shared and a CatalogAllocator so the record itself
+ * is counted along with its buffers.
+ */
+struct MixRecord {
+    enum Field : uint8_t {
+        Id,
+        Title,
+        Url,
+        LocalPath,
+        Description,
+        OriginalFilename,
+        FIELD_COUNT
+    };
+
+    std::basic_string<char, std::char_traits<char>, CatalogAllocator<char>> text;  // Every field back to back
+    std::array<uint32_t, FIELD_COUNT> ends{};                                       // Where each field ends in text
+    uint32_t genre = 0;                                                             // Pool ids
+    uint32_t artist = 0;
+    std::vector<uint32_t, CatalogAllocator<uint32_t>> tags;
+    int64_t date_added_ms = 0;   // Epoch ms, 0 if unknown
+    int64_t last_played_ms = 0;  // Epoch ms, 0 if never played
+    double loudness_lufs = 0.0;
+    double peak_dbfs = 0.0;
+    double bpm = 0.0;
+    double spectral_centroid_hz = 0.0;
+    int duration_seconds = 0;
+    int play_count = 0;
+    bool is_favorite = false;
+    bool has_analysis = false;
+
+    MixRecord() = default;
+
+    /**
+     * @param strings Must hold the genre, artist and tags of mix (see MixStringPool::internFields)
+     */
+    MixRecord(const Mix& mix, const MixStringPool& strings);
+
+    std::string_view field(Field name) const {
+        const uint32_t begin = name == Id ? 0 : ends[name - 1];
+        return std::string_view(text).substr(begin, ends[name] - begin);
+    }
+
+    std::string_view id() const {
+        return field(Id);
+    }
+    std::string_view title() const {
+        return field(Title);
+    }
+    std::string_view url() const {
+        return field(Url);
+    }
+    std::string_view localPath() const {
+        return field(LocalPath);
+    }
+    std::string_view description() const {
+        return field(Description);
+    }
+
+    Mix toMix(const MixStringPool& strings) const;
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,104 @@
+#include "mix_row_mapper.hpp"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "json_utils.hpp"
+#include "uuid_utils.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+void readText(const IStatement& stmt, int column, std::string& field) {
+    if (column >= 0) {
+        const std::string_view text = stmt.getTextView(column);
+        field.assign(text.data(), text.size());
+    }
+}
+
+int readInt(const IStatement& stmt, int column) {
+    return column >= 0 ? stmt.getInt(column) : 0;
+}
+
+// NULL reads as 0, the unset timestamp
+int64_t readInt64(const IStatement& stmt, int column) {
+    return column >= 0 ? stmt.getInt64(column) : 0;
+}
+}  // namespace
+
+MixRowMapper::MixRowMapper(const IStatement& stmt, bool with_tags)
+    : id_(stmt.getColumnIndex("id")),
+      title_(stmt.getColumnIndex("title")),
+      artist_(stmt.getColumnIndex("artist")),
+      genre_(stmt.getColumnIndex("genre")),
+      url_(stmt.getColumnIndex("url")),
+      local_path_(stmt.getColumnIndex("local_path")),
+      duration_seconds_(stmt.getColumnIndex("duration_seconds")),
+      tags_(with_tags ? stmt.getColumnIndex("tags") : -1),
+      description_(stmt.getColumnIndex("description")),
+      date_added_(stmt.getColumnIndex("date_added")),
+      last_played_(stmt.getColumnIndex("last_played")),
+      play_count_(stmt.getColumnIndex("play_count")),
+      is_favorite_(stmt.getColumnIndex("is_favorite")),
+      is_deleted_(stmt.getColumnIndex("is_deleted")),
+      loudness_lufs_(stmt.getColumnIndex("loudness_lufs")),
+      peak_dbfs_(stmt.getColumnIndex("peak_dbfs")),
+      bpm_(stmt.getColumnIndex("bpm")),
+      spectral_centroid_hz_(stmt.getColumnIndex("spectral_centroid_hz")) {}
+
+Mix MixRowMapper::map(const IStatement& stmt) const {
+    Mix mix;
+
+    // NULL text reads as empty, which is what an unset field holds
+    if (id_ >= 0) {
+        mix.id = readId(stmt, id_);
+    }
+    readText(stmt, title_, mix.title);
+    readText(stmt, artist_, mix.artist);
+    readText(stmt, genre_, mix.genre);
+    readText(stmt, url_, mix.url);
+    readText(stmt, local_path_, mix.local_path);
+    mix.duration_seconds = readInt(stmt, duration_seconds_);
+
+    if (tags_ >= 0 && !stmt.isNull(tags_)) {
+        mix.tags = AutoVibez::Utils::JsonUtils::jsonArrayToVector(stmt.getTextView(tags_));
+    }
+
+    readText(stmt, description_, mix.description);
+    mix.date_added_ms = readInt64(stmt, date_added_);
+    mix.last_played_ms = readInt64(stmt, last_played_);
+
+    mix.play_count = readInt(stmt, play_count_);
+    mix.is_favorite = readInt(stmt, is_favorite_) != 0;
+    mix.is_deleted = readInt(stmt, is_deleted_) != 0;
+
+    // Columns stay NULL until the ingest analysis has run
+    if (loudness_lufs_ >= 0 && !stmt.isNull(loudness_lufs_)) {
+        mix.has_analysis = true;
+        mix.loudness_lufs = stmt.getDouble(loudness_lufs_);
+        mix.peak_dbfs = peak_dbfs_ >= 0 ? stmt.getDouble(peak_dbfs_) : 0.0;
+        mix.bpm = bpm_ >= 0 ? stmt.getDouble(bpm_) : 0.0;
+        mix.spectral_centroid_hz = spectral_centroid_hz_ >= 0 ? stmt.getDouble(spectral_centroid_hz_) : 0.0;
+    }
+
+    return mix;
+}
+
+std::string_view MixRowMapper::readId(const IStatement& stmt, int column, char* buffer) {
+    const std::string_view blob = stmt.getBlobView(column);
+    if (blob.size() != Utils::HashId::BYTE_LENGTH) {
+        return stmt.getTextView(column);
+    }
+    Utils::HashId id;
+    std::copy(blob.begin(), blob.end(), id.bytes.begin());
+    id.format(buffer);
+    return std::string_view(buffer, Utils::HashId::TEXT_LENGTH);
+}
+
+std::string MixRowMapper::readId(const IStatement& stmt, int column) {
+    char buffer[Utils::HashId::TEXT_LENGTH];
+    return std::string(readId(stmt, column, buffer));
+}
+
+}  // namespace AutoVibez::Data
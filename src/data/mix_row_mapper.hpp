@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "database_interfaces.hpp"
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Reads mixes table rows into Mix by column index
+ *
+ * The column names are looked up once when the mapper is built for a prepared
+ * statement; each row is then read by index, and text is copied straight from the
+ * statement's buffer into the Mix fields. Columns the query does not select keep
+ * their default values, as NULL columns do.
+ *
+ * Tags live in mix_tags; the JSON copy in the tags column is only parsed when
+ * asked for, as the one-time migration into that table does.
+ *
+ * Ids are stored as 16-byte BLOBs and go in through the mix_key() SQL function;
+ * readId turns one back into the text the rest of the app uses.
+ */
+class MixRowMapper {
+public:
+    /**
+     * @param with_tags Parse the tags column into Mix::tags; otherwise it is skipped
+     */
+    explicit MixRowMapper(const IStatement& stmt, bool with_tags = false);
+
+    /**
+     * @brief Convert the statement's current row
+     */
+    Mix map(const IStatement& stmt) const;
+
+    /**
+     * @brief A mix id column as text: a packed id is formatted into buffer, any other value is viewed in place
+     * @param buffer Room for Utils::HashId::TEXT_LENGTH characters
+     * @return Valid until the next step, or until buffer is written again
+     */
+    static std::string_view readId(const IStatement& stmt, int column, char* buffer);
+
+    static std::string readId(const IStatement& stmt, int column);
+
+private:
+    int id_;
+    int title_;
+    int artist_;
+    int genre_;
+    int url_;
+    int local_path_;
+    int duration_seconds_;
+    int tags_;
+    int description_;
+    int date_added_;
+    int last_played_;
+    int play_count_;
+    int is_favorite_;
+    int is_deleted_;
+    int loudness_lufs_;
+    int peak_dbfs_;
+    int bpm_;
+    int spectral_centroid_hz_;
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,454 @@
+#include "mix_selection_index.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "constants.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Data {
+
+MixSelectionIndex::MixSelectionIndex(bool prefer_unplayed, bool prefer_least_played)
+    : prefer_unplayed_(prefer_unplayed),
+      prefer_least_played_(prefer_least_played),
+      available_(InAvailable),
+      downloaded_(InDownloaded),
+      favorites_(InFavorites),
+      clock_([]() {
+          return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count());
+      }) {}
+
+void MixSelectionIndex::rebuild(const std::vector<Mix>& mixes) {
+    std::vector<Row> rows;
+    rows.reserve(mixes.size());
+    for (const Mix& mix : mixes) {
+        if (!mix.is_deleted && !mix.id.empty()) {
+            rows.push_back({mix.id, mix.genre, !mix.local_path.empty(), mix.is_favorite, mix.play_count,
+                            mix.last_played_ms});
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    rebuildLocked(rows);
+}
+
+void MixSelectionIndex::rebuild(const MixCatalogSnapshot& catalog) {
+    std::vector<Row> rows;
+    rows.reserve(catalog.size());
+    for (const auto& record : catalog.entries()) {
+        rows.push_back({record->id(), catalog.genreOf(*record), !record->localPath().empty(), record->is_favorite,
+                        record->play_count, record->last_played_ms});
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    rebuildLocked(rows);
+}
+
+void MixSelectionIndex::rebuildLocked(const std::vector<Row>& rows) {
+    entries_.clear();
+    free_entries_.clear();
+    ids_.clear();
+    ids_.reserve(rows.size());
+    available_ = Pool(InAvailable);
+    downloaded_ = Pool(InDownloaded);
+    favorites_ = Pool(InFavorites);
+    genre_pools_.clear();
+    genre_ids_.clear();
+
+    std::vector<const Row*> played;
+    for (const Row& row : rows) {
+        if (row.last_played_ms != 0) {
+            played.push_back(&row);
+        }
+    }
+    std::sort(played.begin(), played.end(),
+              [](const Row* a, const Row* b) { return a->last_played_ms < b->last_played_ms; });
+    std::unordered_map<std::string_view, long> sequence;
+    for (const Row* row : played) {
+        sequence[row->id] = static_cast<long>(sequence.size()) + 1;
+    }
+    play_sequence_ = static_cast<long>(sequence.size());
+
+    for (const Row& row : rows) {
+        Entry entry;
+        entry.id = row.id;
+        entry.downloaded = row.downloaded;
+        entry.favorite = row.favorite;
+        entry.play_count = row.play_count;
+        auto it = sequence.find(row.id);
+        entry.last_play = it != sequence.end() ? it->second : 0;
+        insertLocked(std::move(entry), std::string(row.genre));
+    }
+}
+
+void MixSelectionIndex::upsert(const Mix& mix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    long last_play = 0;
+    const Entry* existing = findLocked(mix.id);
+    if (mix.last_played_ms != 0) {
+        // A row written with a play time keeps its place in the play order, or counts as the oldest play
+        last_play = existing && existing->last_play > 0 ? existing->last_play : 1;
+    }
+    // The row carries no play history, so the entry's is kept
+    std::pair<int64_t, int> history;
+    if (existing) {
+        history = {existing->last_played_ms, existing->skip_streak};
+    }
+    eraseLocked(mix.id);
+    if (mix.is_deleted || mix.id.empty()) {
+        return;
+    }
+
+    Entry entry;
+    entry.id = mix.id;
+    entry.downloaded = !mix.local_path.empty();
+    entry.favorite = mix.is_favorite;
+    entry.play_count = mix.play_count;
+    entry.last_play = last_play;
+    entry.last_played_ms = history.first;
+    entry.skip_streak = history.second;
+    insertLocked(std::move(entry), mix.genre);
+}
+
+void MixSelectionIndex::remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eraseLocked(id);
+}
+
+void MixSelectionIndex::recordPlay(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = findLocked(id);
+    if (!entry) {
+        return;
+    }
+    entry->play_count++;
+    entry->last_play = ++play_sequence_;
+    // Every played mix is one play further from its last one
+    markWeightsStale();
+}
+
+void MixSelectionIndex::toggleFavorite(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(id);
+    if (it == ids_.end()) {
+        return;
+    }
+    unplaceLocked(it->second);
+    entries_[it->second].favorite = !entries_[it->second].favorite;
+    placeLocked(it->second);
+}
+
+void MixSelectionIndex::setLocalPath(const std::string& id, const std::string& local_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(id);
+    if (it == ids_.end()) {
+        return;
+    }
+    unplaceLocked(it->second);
+    entries_[it->second].downloaded = !local_path.empty();
+    placeLocked(it->second);
+}
+
+void MixSelectionIndex::recordPlayEvent(const PlayEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = findLocked(event.mix_id);
+    if (!entry) {
+        return;
+    }
+    entry->last_played_ms = std::max(entry->last_played_ms, event.ts_epoch_ms);
+    entry->skip_streak = event.skipped ? entry->skip_streak + 1 : 0;
+    markWeightsStale();
+}
+
+void MixSelectionIndex::loadPlayStats(const std::vector<MixPlayStats>& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const MixPlayStats& mix : stats) {
+        Entry* entry = findLocked(mix.mix_id);
+        if (entry) {
+            entry->last_played_ms = mix.last_played_ms;
+            entry->skip_streak = mix.skip_streak;
+        }
+    }
+    markWeightsStale();
+}
+
+void MixSelectionIndex::setClock(std::function<int64_t()> now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    clock_ = std::move(now_ms);
+    markWeightsStale();
+}
+
+size_t MixSelectionIndex::count(SelectionPool pool, const std::string& genre, const std::string& exclude_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Pool* found = findPool(pool, genre);
+    if (!found) {
+        return 0;
+    }
+    uint32_t excluded = 0;
+    return found->entries.size() - (holds(*found, exclude_id, excluded) ? 1 : 0);
+}
+
+std::string MixSelectionIndex::sampleWeighted(SelectionPool pool, const std::string& genre,
+                                              const std::string& exclude_id, std::mt19937& rng) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Pool* found = findPool(pool, genre);
+    if (!found || found->entries.empty()) {
+        return "";
+    }
+    uint32_t excluded = 0;
+    const bool excluding = holds(*found, exclude_id, excluded);
+    if (excluding && found->entries.size() == 1) {
+        return "";
+    }
+    const int64_t now_ms = clock_();
+    if (found->stale || now_ms - found->built_ms >= Constants::PLAY_WEIGHT_REFRESH_MS) {
+        buildAliasTable(*found, now_ms);
+    }
+
+    std::uniform_int_distribution<size_t> slot(0, found->entries.size() - 1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (int attempt = 0; attempt < Constants::INDEX_SAMPLE_ATTEMPTS; ++attempt) {
+        const size_t i = slot(rng);
+        const uint32_t index = found->entries[coin(rng) < found->probability[i] ? i : found->alias[i]];
+        if (!excluding || index != excluded) {
+            return entries_[index].id;
+        }
+    }
+
+    // The excluded mix carries most of the weight: draw from the rest directly
+    double total = 0.0;
+    for (uint32_t index : found->entries) {
+        total += index == excluded ? 0.0 : weight(entries_[index], now_ms);
+    }
+    double target = std::uniform_real_distribution<double>(0.0, total)(rng);
+    for (uint32_t index : found->entries) {
+        if (index == excluded) {
+            continue;
+        }
+        target -= weight(entries_[index], now_ms);
+        if (target <= 0.0) {
+            return entries_[index].id;
+        }
+    }
+    const uint32_t last = found->entries.back() != excluded ? found->entries.back() : found->entries.front();
+    return entries_[last].id;
+}
+
+std::string MixSelectionIndex::sampleUniform(SelectionPool pool, const std::string& genre,
+                                             const std::string& exclude_id, std::mt19937& rng) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Pool* found = findPool(pool, genre);
+    return found ? drawUniform(*found, exclude_id, rng) : "";
+}
+
+double MixSelectionIndex::getWeight(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(id);
+    if (it == ids_.end() || !entries_[it->second].downloaded) {
+        return 0.0;
+    }
+    return weight(entries_[it->second], clock_());
+}
+
+std::string MixSelectionIndex::genreKey(const std::string& genre) {
+    return ::AutoVibez::Utils::StringUtils::toLower(genre);
+}
+
+std::string MixSelectionIndex::drawUniform(const Pool& pool, const std::string& exclude_id,
+                                           std::mt19937& rng) const {
+    uint32_t excluded = 0;
+    const bool excluding = holds(pool, exclude_id, excluded);
+    const size_t candidates = pool.entries.size() - (excluding ? 1 : 0);
+    if (candidates == 0) {
+        return "";
+    }
+    // Draw over the other slots and step over the excluded one
+    size_t position = std::uniform_int_distribution<size_t>(0, candidates - 1)(rng);
+    if (excluding && position >= entries_[excluded].positions[pool.kind]) {
+        position++;
+    }
+    return entries_[pool.entries[position]].id;
+}
+
+void MixSelectionIndex::insertLocked(Entry entry, const std::string& genre) {
+    const std::string key = genreKey(genre);
+    auto genre_id = genre_ids_.find(key);
+    if (genre_id == genre_ids_.end()) {
+        genre_id = genre_ids_.emplace(key, static_cast<uint32_t>(genre_pools_.size())).first;
+        genre_pools_.emplace_back(InGenre);
+    }
+    entry.genre = genre_id->second;
+
+    uint32_t index = 0;
+    if (!free_entries_.empty()) {
+        index = free_entries_.back();
+        free_entries_.pop_back();
+        entries_[index] = std::move(entry);
+    } else {
+        index = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(std::move(entry));
+    }
+    ids_.emplace(entries_[index].id, index);
+    placeLocked(index);
+}
+
+void MixSelectionIndex::eraseLocked(const std::string& id) {
+    auto it = ids_.find(id);
+    if (it == ids_.end()) {
+        return;
+    }
+    const uint32_t index = it->second;
+    unplaceLocked(index);
+    ids_.erase(it);
+    entries_[index] = Entry();
+    free_entries_.push_back(index);
+}
+
+MixSelectionIndex::Entry* MixSelectionIndex::findLocked(const std::string& id) {
+    auto it = ids_.find(id);
+    return it != ids_.end() ? &entries_[it->second] : nullptr;
+}
+
+void MixSelectionIndex::placeLocked(uint32_t index) {
+    const Entry& entry = entries_[index];
+    addTo(available_, index);
+    if (!entry.downloaded) {
+        return;
+    }
+    addTo(downloaded_, index);
+    if (entry.favorite) {
+        addTo(favorites_, index);
+    }
+    addTo(genre_pools_[entry.genre], index);
+}
+
+void MixSelectionIndex::unplaceLocked(uint32_t index) {
+    removeFrom(available_, index);
+    removeFrom(downloaded_, index);
+    removeFrom(favorites_, index);
+    removeFrom(genre_pools_[entries_[index].genre], index);
+}
+
+void MixSelectionIndex::addTo(Pool& pool, uint32_t index) {
+    uint32_t& position = entries_[index].positions[pool.kind];
+    if (position != NOT_IN_POOL) {
+        return;
+    }
+    position = static_cast<uint32_t>(pool.entries.size());
+    pool.entries.push_back(index);
+    pool.stale = true;
+}
+
+void MixSelectionIndex::removeFrom(Pool& pool, uint32_t index) {
+    uint32_t& position = entries_[index].positions[pool.kind];
+    if (position == NOT_IN_POOL) {
+        return;
+    }
+    // Swap with the last entry so removal stays O(1)
+    const uint32_t last = pool.entries.back();
+    pool.entries[position] = last;
+    entries_[last].positions[pool.kind] = position;
+    pool.entries.pop_back();
+    position = NOT_IN_POOL;
+    pool.stale = true;
+}
+
+bool MixSelectionIndex::holds(const Pool& pool, const std::string& id, uint32_t& index) const {
+    auto it = ids_.find(id);
+    if (it == ids_.end() || entries_[it->second].positions[pool.kind] == NOT_IN_POOL) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+void MixSelectionIndex::markWeightsStale() {
+    available_.stale = true;
+    downloaded_.stale = true;
+    favorites_.stale = true;
+    for (Pool& pool : genre_pools_) {
+        pool.stale = true;
+    }
+}
+
+const MixSelectionIndex::Pool* MixSelectionIndex::findPool(SelectionPool pool, const std::string& genre) const {
+    switch (pool) {
+        case SelectionPool::Available:
+            return &available_;
+        case SelectionPool::Downloaded:
+            return &downloaded_;
+        case SelectionPool::Favorites:
+            return &favorites_;
+        case SelectionPool::Genre: {
+            auto it = genre_ids_.find(genreKey(genre));
+            return it != genre_ids_.end() ? &genre_pools_[it->second] : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+MixSelectionIndex::Pool* MixSelectionIndex::findPool(SelectionPool pool, const std::string& genre) {
+    return const_cast<Pool*>(static_cast<const MixSelectionIndex*>(this)->findPool(pool, genre));
+}
+
+double MixSelectionIndex::weight(const Entry& entry, int64_t now_ms) const {
+    // Skips count against a mix whatever the play preferences
+    const double skips = std::pow(Constants::SKIP_STREAK_WEIGHT, entry.skip_streak);
+    if (entry.last_play == 0 && entry.last_played_ms == 0) {
+        return (prefer_unplayed_ ? Constants::UNPLAYED_MIX_WEIGHT : 1.0) * skips;
+    }
+    if (!prefer_least_played_) {
+        return skips;
+    }
+
+    double recency = 1.0;
+    if (entry.last_play > 0) {
+        const double plays_since = static_cast<double>(play_sequence_ - entry.last_play) + 1.0;
+        recency = std::min(1.0, plays_since / Constants::RECENT_PLAY_WINDOW);
+    }
+    if (entry.last_played_ms > 0) {
+        const double hours = static_cast<double>(now_ms - entry.last_played_ms) / (60.0 * 60.0 * 1000.0);
+        recency *= hours < Constants::PLAY_RECENT_HOURS ? Constants::RECENTLY_PLAYED_WEIGHT
+                                                        : std::min(1.0, hours / Constants::PLAY_RECOVERY_HOURS);
+    }
+    return recency / (1.0 + entry.play_count) * skips;
+}
+
+void MixSelectionIndex::buildAliasTable(Pool& pool, int64_t now_ms) const {
+    // Vose's method: split every slot between its own id and one heavier id
+    const size_t n = pool.entries.size();
+    pool.probability.assign(n, 1.0);
+    pool.alias.resize(n);
+
+    std::vector<double> scaled(n);
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = weight(entries_[pool.entries[i]], now_ms);
+        total += scaled[i];
+    }
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t i = 0; i < n; ++i) {
+        pool.alias[i] = i;
+        scaled[i] = total > 0.0 ? scaled[i] * static_cast<double>(n) / total : 1.0;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        const uint32_t light = small.back();
+        small.pop_back();
+        const uint32_t heavy = large.back();
+        pool.probability[light] = scaled[light];
+        pool.alias[light] = heavy;
+        scaled[heavy] -= 1.0 - scaled[light];
+        if (scaled[heavy] < 1.0) {
+            large.pop_back();
+            small.push_back(heavy);
+        }
+    }
+    // Whatever is left is 1 up to rounding and keeps its own slot
+    pool.stale = false;
+    pool.built_ms = now_ms;
+}
+
+}  // namespace AutoVibez::Data
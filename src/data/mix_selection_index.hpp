@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mix_catalog.hpp"
+#include "mix_metadata.hpp"
+#include "play_history.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Which candidate set a pick is drawn from
+ */
+enum class SelectionPool {
+    Available,   // Every mix that is not deleted
+    Downloaded,  // Not deleted and has a local file
+    Favorites,   // Downloaded favorites
+    Genre        // Downloaded mixes of one genre (case-insensitive)
+};
+
+/**
+ * @brief In-memory candidate sets for random mix selection
+ *
+ * Keeps the ids of every selectable mix in the pools above, each with a weight
+ * from its play history, so a pick is an array draw instead of an
+ * ORDER BY RANDOM() scan. Weighted draws use an alias table per pool: O(1) per
+ * pick, rebuilt in one pass over the pool the first time it is sampled after a
+ * write changed its weights. Uniform draws need no table. MixDatabase applies
+ * each of its writes here, so the index follows the table without reloading it;
+ * a pick whose id has gone stale is simply not found by the caller.
+ *
+ * The play history adds time to the weights: a mix played in the last
+ * PLAY_RECENT_HOURS is all but left out and recovers over PLAY_RECOVERY_HOURS,
+ * and every consecutive skip scales it by SKIP_STREAK_WEIGHT. As those weights drift with the
+ * clock alone, a pool's table is also rebuilt once PLAY_WEIGHT_REFRESH_MS old.
+ */
+class MixSelectionIndex {
+public:
+    /**
+     * @param prefer_unplayed Never-played mixes get UNPLAYED_MIX_WEIGHT
+     * @param prefer_least_played Weight falls with play count and recovers over RECENT_PLAY_WINDOW plays
+     */
+    explicit MixSelectionIndex(bool prefer_unplayed = true, bool prefer_least_played = true);
+
+    /**
+     * @brief Replace the contents with these rows (deleted rows are skipped)
+     */
+    void rebuild(const std::vector<Mix>& mixes);
+
+    /**
+     * @brief Replace the contents with the mixes of a catalog snapshot
+     */
+    void rebuild(const MixCatalogSnapshot& catalog);
+
+    /**
+     * @brief Insert or replace one mix, as INSERT OR REPLACE and UPDATE of a whole row do
+     */
+    void upsert(const Mix& mix);
+
+    void remove(const std::string& id);
+    void recordPlay(const std::string& id);
+    void toggleFavorite(const std::string& id);
+    void setLocalPath(const std::string& id, const std::string& local_path);
+
+    /**
+     * @brief Fold one ended play into the mix's recency and skip streak
+     */
+    void recordPlayEvent(const PlayEvent& event);
+
+    /**
+     * @brief Set the play history of the mixes already in the index, after a rebuild
+     */
+    void loadPlayStats(const std::vector<MixPlayStats>& stats);
+
+    /**
+     * @brief Replace the wall clock the weights are computed against, for tests
+     * @param now_ms Milliseconds since the Unix epoch
+     */
+    void setClock(std::function<int64_t()> now_ms);
+
+    /**
+     * @brief Number of mixes in a pool, not counting exclude_id
+     */
+    size_t count(SelectionPool pool, const std::string& genre = "", const std::string& exclude_id = "") const;
+
+    /**
+     * @brief Draw an id weighted by play history
+     * @return Empty when the pool holds nothing but exclude_id
+     */
+    std::string sampleWeighted(SelectionPool pool, const std::string& genre, const std::string& exclude_id,
+                               std::mt19937& rng);
+
+    /**
+     * @brief Draw an id with every mix equally likely, as ORDER BY RANDOM() does
+     */
+    std::string sampleUniform(SelectionPool pool, const std::string& genre, const std::string& exclude_id,
+                              std::mt19937& rng);
+
+    /**
+     * @brief The play-history weight sampleWeighted() draws a mix with
+     * @return 0 for a mix that is not in the index or not downloaded
+     */
+    double getWeight(const std::string& id) const;
+
+private:
+    // What a rebuild reads of one mix, from either source
+    struct Row {
+        std::string_view id;
+        std::string_view genre;
+        bool downloaded = false;
+        bool favorite = false;
+        int play_count = 0;
+        int64_t last_played_ms = 0;  // From the mixes row, 0 if never played
+    };
+
+    // The pools an entry can sit in, each keeping its position there
+    enum PoolKind : uint8_t { InAvailable, InDownloaded, InFavorites, InGenre, POOL_KINDS };
+
+    static constexpr uint32_t NOT_IN_POOL = UINT32_MAX;
+
+    struct Entry {
+        std::string id;
+        uint32_t genre = 0;  // Into genre_pools_
+        bool downloaded = false;
+        bool favorite = false;
+        int play_count = 0;
+        long last_play = 0;          // Play sequence number of the last play, 0 if never played
+        int64_t last_played_ms = 0;  // From the play history, 0 if none
+        int skip_streak = 0;
+        std::array<uint32_t, POOL_KINDS> positions{NOT_IN_POOL, NOT_IN_POOL, NOT_IN_POOL, NOT_IN_POOL};
+    };
+
+    struct Pool {
+        PoolKind kind;
+        std::vector<uint32_t> entries;    // Into entries_
+        std::vector<double> probability;  // Alias table: keep slot i with this probability...
+        std::vector<uint32_t> alias;      // ...otherwise take alias[i]
+        bool stale = true;
+        int64_t built_ms = 0;  // Clock time the weights in the table were computed at
+
+        explicit Pool(PoolKind pool_kind) : kind(pool_kind) {}
+    };
+
+    bool prefer_unplayed_;
+    bool prefer_least_played_;
+    std::deque<Entry> entries_;  // Growing never moves the ids that ids_ views
+    std::vector<uint32_t> free_entries_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    Pool available_;
+    Pool downloaded_;
+    Pool favorites_;
+    std::vector<Pool> genre_pools_;  // One per lowercased genre ever seen, kept when it empties
+    std::unordered_map<std::string, uint32_t> genre_ids_;
+    long play_sequence_ = 0;
+    std::function<int64_t()> clock_;
+    mutable std::mutex mutex_;
+
+    static std::string genreKey(const std::string& genre);
+
+    void rebuildLocked(const std::vector<Row>& rows);
+    void insertLocked(Entry entry, const std::string& genre);
+    void eraseLocked(const std::string& id);
+    Entry* findLocked(const std::string& id);
+    void placeLocked(uint32_t index);
+    void unplaceLocked(uint32_t index);
+    void addTo(Pool& pool, uint32_t index);
+    void removeFrom(Pool& pool, uint32_t index);
+    bool holds(const Pool& pool, const std::string& id, uint32_t& index) const;
+    std::string drawUniform(const Pool& pool, const std::string& exclude_id, std::mt19937& rng) const;
+    void markWeightsStale();
+    const Pool* findPool(SelectionPool pool, const std::string& genre) const;
+    Pool* findPool(SelectionPool pool, const std::string& genre);
+    double weight(const Entry& entry, int64_t now_ms) const;
+    void buildAliasTable(Pool& pool, int64_t now_ms) const;
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,326 @@
+#include "mix_similarity_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUTOVIBEZ_SIMILARITY_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUTOVIBEZ_SIMILARITY_NEON 1
+#endif
+
+namespace AutoVibez::Data {
+
+namespace {
+// Layout of a vector: three measured dimensions, then the hashed genre and tag blocks
+constexpr int TEMPO_DIM = 0;
+constexpr int LOUDNESS_DIM = 1;
+constexpr int BRIGHTNESS_DIM = 2;
+constexpr int GENRE_FIRST = 3;
+constexpr int GENRE_DIMS = 13;
+constexpr int TAG_FIRST = GENRE_FIRST + GENRE_DIMS;
+constexpr int TAG_DIMS = MixSimilarityIndex::DIMENSIONS - TAG_FIRST;
+
+// How far apart each feature puts two mixes (a full range step is worth its weight squared)
+constexpr double TEMPO_WEIGHT = 1.0;
+constexpr double LOUDNESS_WEIGHT = 0.5;
+constexpr double BRIGHTNESS_WEIGHT = 0.7;
+constexpr double GENRE_WEIGHT = 0.8;
+constexpr double TAG_WEIGHT = 0.6;
+
+// Measured features are mapped onto [-1, 1] around a typical dance mix
+constexpr double CENTER_BPM = 124.0;
+constexpr double TEMPO_RANGE_OCTAVES = 0.5;
+constexpr double CENTER_LUFS = -12.0;
+constexpr double LOUDNESS_RANGE_LU = 8.0;
+constexpr double CENTER_CENTROID_HZ = 2500.0;
+constexpr double BRIGHTNESS_RANGE_OCTAVES = 1.5;
+
+constexpr float SCALE = 127.0f;  // Quantized value of 1.0
+
+constexpr uint8_t LIVE = 1;
+constexpr uint8_t DOWNLOADED = 2;
+
+std::string lowered(std::string_view text) {
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+// FNV-1a of the lowercased text, so "House" and "house" share a bucket
+uint32_t hashLowered(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : text) {
+        hash ^= static_cast<uint32_t>(std::tolower(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+double unitRange(double value) {
+    return std::clamp(value, -1.0, 1.0);
+}
+
+// The query side of the scan, prepared once so that each slot costs one pass over its own bytes
+struct Query {
+#if defined(AUTOVIBEZ_SIMILARITY_SSE2)
+    __m128i lanes[MixSimilarityIndex::DIMENSIONS / 8];  // Sign-extended to 16 bits
+#elif defined(AUTOVIBEZ_SIMILARITY_NEON)
+    int8x16_t lanes[MixSimilarityIndex::DIMENSIONS / 16];
+#else
+    const int8_t* values;
+#endif
+
+    explicit Query(const int8_t* query) {
+#if defined(AUTOVIBEZ_SIMILARITY_SSE2)
+        for (int i = 0; i < MixSimilarityIndex::DIMENSIONS / 16; ++i) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(query + i * 16));
+            // SSE2 has no byte sign extension: pair each byte with itself and shift the high copy down
+            lanes[2 * i] = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+            lanes[2 * i + 1] = _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8);
+        }
+#elif defined(AUTOVIBEZ_SIMILARITY_NEON)
+        for (int i = 0; i < MixSimilarityIndex::DIMENSIONS / 16; ++i) {
+            lanes[i] = vld1q_s8(query + i * 16);
+        }
+#else
+        values = query;
+#endif
+    }
+
+    int32_t dot(const int8_t* other) const {
+#if defined(AUTOVIBEZ_SIMILARITY_SSE2)
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < MixSimilarityIndex::DIMENSIONS / 16; ++i) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other + i * 16));
+            const __m128i low = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+            const __m128i high = _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(lanes[2 * i], low));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(lanes[2 * i + 1], high));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+#elif defined(AUTOVIBEZ_SIMILARITY_NEON)
+        int32x4_t sum = vdupq_n_s32(0);
+        for (int i = 0; i < MixSimilarityIndex::DIMENSIONS / 16; ++i) {
+            const int8x16_t bytes = vld1q_s8(other + i * 16);
+            sum = vpadalq_s16(sum, vmull_s8(vget_low_s8(lanes[i]), vget_low_s8(bytes)));
+            sum = vpadalq_s16(sum, vmull_s8(vget_high_s8(lanes[i]), vget_high_s8(bytes)));
+        }
+        const int32x2_t pair = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+        return vget_lane_s32(vpadd_s32(pair, pair), 0);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < MixSimilarityIndex::DIMENSIONS; ++i) {
+            sum += static_cast<int32_t>(values[i]) * other[i];
+        }
+        return sum;
+#endif
+    }
+};
+}  // namespace
+
+MixSimilarityIndex::MixSimilarityIndex() = default;
+
+void MixSimilarityIndex::rebuild(const MixCatalogSnapshot& catalog) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    clearLocked();
+    vectors_.reserve(catalog.size() * DIMENSIONS);
+    Features features;
+    for (const auto& record : catalog.entries()) {
+        features.analyzed = record->has_analysis;
+        features.bpm = record->bpm;
+        features.loudness_lufs = record->loudness_lufs;
+        features.spectral_centroid_hz = record->spectral_centroid_hz;
+        features.genre = catalog.genreOf(*record);
+        features.tags.clear();
+        for (uint32_t tag : record->tags) {
+            features.tags.push_back(catalog.strings()->get(tag));
+        }
+        putLocked(record->id(), features, !record->localPath().empty());
+    }
+}
+
+void MixSimilarityIndex::upsert(const Mix& mix) {
+    if (mix.id.empty()) {
+        return;
+    }
+    if (mix.is_deleted) {
+        remove(mix.id);
+        return;
+    }
+    Features features;
+    features.analyzed = mix.has_analysis;
+    features.bpm = mix.bpm;
+    features.loudness_lufs = mix.loudness_lufs;
+    features.spectral_centroid_hz = mix.spectral_centroid_hz;
+    features.genre = mix.genre;
+    features.tags.assign(mix.tags.begin(), mix.tags.end());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    putLocked(mix.id, features, !mix.local_path.empty());
+}
+
+void MixSimilarityIndex::remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        return;
+    }
+    const uint32_t slot = it->second;
+    slots_.erase(it);
+    flags_[slot] = 0;
+    free_slots_.push_back(slot);
+}
+
+size_t MixSimilarityIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_.size();
+}
+
+std::vector<SimilarMix> MixSimilarityIndex::nearest(const std::string& mix_id, const std::string& genre,
+                                                    size_t count) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto self = slots_.find(mix_id);
+    if (count == 0 || self == slots_.end()) {
+        return {};
+    }
+    uint32_t genre_id = 0;
+    if (!genre.empty()) {
+        auto it = genre_ids_.find(lowered(genre));
+        if (it == genre_ids_.end()) {
+            return {};
+        }
+        genre_id = it->second;
+    }
+
+    // |q - v|^2 = |q|^2 - (2 q.v - |v|^2): the nearest mixes have the highest score
+    const uint32_t query_slot = self->second;
+    const Query query(&vectors_[static_cast<size_t>(query_slot) * DIMENSIONS]);
+    std::vector<std::pair<int32_t, uint32_t>> best;  // Score and slot, highest score first
+    best.reserve(count + 1);
+    const uint32_t slots = static_cast<uint32_t>(flags_.size());
+    for (uint32_t slot = 0; slot < slots; ++slot) {
+        if (flags_[slot] != (LIVE | DOWNLOADED) || slot == query_slot || (genre_id != 0 && genres_[slot] != genre_id)) {
+            continue;
+        }
+        const int32_t score = 2 * query.dot(&vectors_[static_cast<size_t>(slot) * DIMENSIONS]) - norms_[slot];
+        if (best.size() == count && score <= best.back().first) {
+            continue;
+        }
+        auto at = std::upper_bound(best.begin(), best.end(), score,
+                                   [](int32_t value, const std::pair<int32_t, uint32_t>& entry) {
+                                       return value > entry.first;
+                                   });
+        best.insert(at, {score, slot});
+        if (best.size() > count) {
+            best.pop_back();
+        }
+    }
+
+    std::vector<SimilarMix> result;
+    result.reserve(best.size());
+    for (const auto& [score, slot] : best) {
+        SimilarMix similar;
+        similar.id = slot_ids_[slot];
+        similar.distance = static_cast<float>(norms_[query_slot] - score) / (SCALE * SCALE);
+        result.push_back(std::move(similar));
+    }
+    return result;
+}
+
+MixSimilarityIndex::Vector MixSimilarityIndex::featuresOf(const Mix& mix) {
+    Features features;
+    features.analyzed = mix.has_analysis;
+    features.bpm = mix.bpm;
+    features.loudness_lufs = mix.loudness_lufs;
+    features.spectral_centroid_hz = mix.spectral_centroid_hz;
+    features.genre = mix.genre;
+    features.tags.assign(mix.tags.begin(), mix.tags.end());
+    return quantize(features);
+}
+
+MixSimilarityIndex::Vector MixSimilarityIndex::quantize(const Features& features) {
+    std::array<double, DIMENSIONS> values{};
+    if (features.analyzed) {
+        if (features.bpm > 0.0) {
+            values[TEMPO_DIM] = TEMPO_WEIGHT * unitRange(std::log2(features.bpm / CENTER_BPM) / TEMPO_RANGE_OCTAVES);
+        }
+        values[LOUDNESS_DIM] = LOUDNESS_WEIGHT * unitRange((features.loudness_lufs - CENTER_LUFS) / LOUDNESS_RANGE_LU);
+        if (features.spectral_centroid_hz > 0.0) {
+            values[BRIGHTNESS_DIM] = BRIGHTNESS_WEIGHT * unitRange(std::log2(features.spectral_centroid_hz /
+                                                                             CENTER_CENTROID_HZ) /
+                                                                   BRIGHTNESS_RANGE_OCTAVES);
+        }
+    }
+    if (!features.genre.empty()) {
+        values[GENRE_FIRST + hashLowered(features.genre) % GENRE_DIMS] = GENRE_WEIGHT;
+    }
+    // Signed buckets, so colliding tags partly cancel instead of piling up; a mix's tags weigh as much as one tag
+    if (!features.tags.empty()) {
+        const double share = TAG_WEIGHT / std::sqrt(static_cast<double>(features.tags.size()));
+        for (std::string_view tag : features.tags) {
+            const uint32_t hash = hashLowered(tag);
+            values[TAG_FIRST + hash % TAG_DIMS] += (hash >> 31) ? -share : share;
+        }
+    }
+
+    Vector vector{};
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        vector[i] = static_cast<int8_t>(std::lrint(unitRange(values[i]) * SCALE));
+    }
+    return vector;
+}
+
+uint32_t MixSimilarityIndex::genreIdLocked(std::string_view genre) {
+    if (genre.empty()) {
+        return 0;
+    }
+    const auto inserted = genre_ids_.emplace(lowered(genre), static_cast<uint32_t>(genre_ids_.size() + 1));
+    return inserted.first->second;
+}
+
+void MixSimilarityIndex::putLocked(std::string_view id, const Features& features, bool downloaded) {
+    uint32_t slot = 0;
+    auto it = slots_.find(id);
+    if (it != slots_.end()) {
+        slot = it->second;
+    } else {
+        if (!free_slots_.empty()) {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+            slot_ids_[slot] = std::string(id);
+        } else {
+            slot = static_cast<uint32_t>(flags_.size());
+            vectors_.resize(vectors_.size() + DIMENSIONS);
+            norms_.push_back(0);
+            genres_.push_back(0);
+            flags_.push_back(0);
+            slot_ids_.emplace_back(id);
+        }
+        slots_.emplace(slot_ids_[slot], slot);
+    }
+
+    const Vector vector = quantize(features);
+    std::copy(vector.begin(), vector.end(), vectors_.begin() + static_cast<std::ptrdiff_t>(slot) * DIMENSIONS);
+    norms_[slot] = Query(vector.data()).dot(vector.data());
+    genres_[slot] = genreIdLocked(features.genre);
+    flags_[slot] = downloaded ? (LIVE | DOWNLOADED) : LIVE;
+}
+
+void MixSimilarityIndex::clearLocked() {
+    vectors_.clear();
+    norms_.clear();
+    genres_.clear();
+    flags_.clear();
+    slot_ids_.clear();
+    free_slots_.clear();
+    slots_.clear();
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,182 @@
+#include "mix_sync_agent.hpp"
+
+#include <algorithm>
+
+#include "console_output.hpp"
+#include "constants.hpp"
+#include "datetime_utils.hpp"
+#include "transfer_engine.hpp"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace AutoVibez::Data {
+
+namespace {
+
+#ifdef HAVE_ZLIB
+constexpr int GZIP_WINDOW_BITS = 15 + 16;  // The largest window, with a gzip wrapper
+constexpr int DEFLATE_MEMORY_LEVEL = 8;    // zlib's default
+
+bool gzip(const std::string& in, std::string& out) {
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, DEFLATE_MEMORY_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    // One call compresses it all into a buffer of the bound's size
+    out.resize(deflateBound(&stream, static_cast<uLong>(in.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    stream.avail_in = static_cast<uInt>(in.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+#endif
+
+}  // namespace
+
+MixSyncAgent::MixSyncAgent(MixDatabase& database, std::string url, Transport transport)
+    : database_(database), url_(std::move(url)), transport_(std::move(transport)) {
+    if (!transport_) {
+        transport_ = [this](const std::string& delta, std::string& reply) { return post(delta, reply); };
+    }
+}
+
+MixSyncAgent::~MixSyncAgent() {
+    stop();
+}
+
+void MixSyncAgent::start(std::chrono::seconds interval) {
+    if (thread_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    thread_ = std::thread([this, interval]() { run(interval); });
+}
+
+void MixSyncAgent::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+void MixSyncAgent::syncSoon() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    wake_.notify_all();
+}
+
+bool MixSyncAgent::exchange() {
+    for (int batch = 0; batch < Constants::MIX_SYNC_MAX_BATCHES && !stopping_; ++batch) {
+        MixSyncDelta delta;
+        if (!database_.getSyncDelta(delta, Constants::MIX_SYNC_BATCH_EVENTS, Constants::MIX_SYNC_BATCH_FAVORITES)) {
+            setError("Failed to read the sync delta: " + database_.getLastError());
+            return false;
+        }
+        std::string text;
+        clearError();
+        if (!transport_(delta.encode(), text)) {
+            if (getLastError().empty()) {
+                setError("No sync reply from " + url_);
+            }
+            return false;
+        }
+        MixSyncReply reply;
+        if (!MixSyncReply::parse(text, reply)) {
+            setError("Malformed sync reply from " + url_);
+            return false;
+        }
+        if (!database_.applySyncReply(delta, reply)) {
+            setError(database_.getLastError());
+            return false;
+        }
+        last_sync_ms_ = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
+
+        // A batch short of full was the last of the backlog
+        if (delta.events < Constants::MIX_SYNC_BATCH_EVENTS &&
+            delta.favorites.size() < static_cast<size_t>(Constants::MIX_SYNC_BATCH_FAVORITES)) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool MixSyncAgent::post(const std::string& delta, std::string& reply) {
+    AutoVibez::Utils::TransferRequest request;
+    request.url = url_;
+    request.timeout_seconds = Constants::HTTP_TIMEOUT_SECONDS;
+    request.connect_timeout_seconds = Constants::HTTP_CONNECT_TIMEOUT_SECONDS;
+    request.user_agent = "AutoVibez/1.0";
+    request.fail_on_http_error = true;
+    request.decode_response = true;
+    request.headers.push_back(std::string("Content-Type: ") + StringConstants::MIX_SYNC_CONTENT_TYPE);
+#ifdef HAVE_ZLIB
+    if (gzip(delta, request.body)) {
+        request.headers.push_back("Content-Encoding: gzip");
+    } else {
+        request.body = delta;
+    }
+#else
+    request.body = delta;
+#endif
+
+    bool too_long = false;
+    reply.clear();
+    request.on_data = [&reply, &too_long](const char* data, size_t size) {
+        if (static_cast<int64_t>(reply.size() + size) > Constants::MIX_SYNC_MAX_REPLY_BYTES) {
+            too_long = true;
+            return false;
+        }
+        reply.append(data, size);
+        return true;
+    };
+    request.on_progress = [this](int64_t, int64_t) { return !stopping_.load(); };
+
+    const AutoVibez::Utils::TransferResult result =
+        AutoVibez::Utils::TransferEngine::shared().perform(std::move(request));
+    if (!result.ok) {
+        setError(too_long ? "Sync reply from " + url_ + " is too long" : "Sync request failed: " + result.error);
+        return false;
+    }
+    return true;
+}
+
+void MixSyncAgent::run(std::chrono::seconds interval) {
+    const std::chrono::seconds max_backoff(Constants::MIX_SYNC_MAX_BACKOFF_SECONDS);
+    std::chrono::seconds wait(0);
+    bool reachable = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, wait, [this]() { return stopping_.load() || woken_; });
+        if (stopping_) {
+            break;
+        }
+        woken_ = false;
+        lock.unlock();
+        const bool ok = exchange();
+        // Only the change is reported, so a node that stays offline says so once
+        if (ok && !reachable) {
+            AutoVibez::Utils::ConsoleOutput::info("Play stats and favorites synced again");
+        } else if (!ok && reachable && !stopping_) {
+            AutoVibez::Utils::ConsoleOutput::warning(getLastError() + "; changes are kept until the server answers");
+        }
+        reachable = ok;
+        lock.lock();
+        wait = ok ? interval : std::min(std::max(wait * 2, interval), max_backoff);
+    }
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "error_handler.hpp"
+#include "mix_database.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Trades this node's play stats and favorites with a central server, on a thread of its own
+ *
+ * Each exchange POSTs the next delta the database gives, gzip-compressed where the
+ * build has zlib, and merges the reply into the database; while a full batch leaves a
+ * backlog it goes on, up to MIX_SYNC_MAX_BATCHES deltas. The database marks a delta
+ * sent only once its reply is merged, so an offline node keeps its changes in its own
+ * tables and sends them once the server answers again, and no more than one batch is
+ * ever held in memory. A failed exchange doubles the wait before the next, up to
+ * MIX_SYNC_MAX_BACKOFF_SECONDS.
+ */
+class MixSyncAgent : public AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @brief Send an encoded delta and read back the encoded reply
+     * @return False if no reply came
+     */
+    using Transport = std::function<bool(const std::string& delta, std::string& reply)>;
+
+    /**
+     * @param transport Empty for a POST to url through TransferEngine
+     */
+    MixSyncAgent(MixDatabase& database, std::string url, Transport transport = {});
+
+    /**
+     * @brief Aborts an exchange in flight and joins the thread
+     */
+    ~MixSyncAgent() override;
+
+    MixSyncAgent(const MixSyncAgent&) = delete;
+    MixSyncAgent& operator=(const MixSyncAgent&) = delete;
+
+    /**
+     * @brief Exchange at once, then every interval
+     */
+    void start(std::chrono::seconds interval);
+
+    void stop();
+
+    /**
+     * @brief Exchange now instead of at the end of the wait
+     */
+    void syncSoon();
+
+    /**
+     * @brief One exchange on the calling thread; the thread runs the same
+     * @return False if a delta could not be sent or its reply not merged; errors are for the calling thread
+     */
+    bool exchange();
+
+    /**
+     * @brief Epoch ms of the last exchange that succeeded, 0 before one has
+     */
+    int64_t getLastSyncMs() const {
+        return last_sync_ms_.load();
+    }
+
+private:
+    bool post(const std::string& delta, std::string& reply);
+    void run(std::chrono::seconds interval);
+
+    MixDatabase& database_;
+    std::string url_;
+    Transport transport_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool woken_ = false;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int64_t> last_sync_ms_{0};
+};
+
+}  // namespace AutoVibez::Data
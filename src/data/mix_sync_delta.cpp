@@ -0,0 +1,176 @@
+#include "mix_sync_delta.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+
+/**
+ * @brief The space-separated fields of one line
+ */
+std::vector<std::string_view> splitFields(std::string_view line) {
+    std::vector<std::string_view> fields;
+    size_t start = 0;
+    while (start <= line.size()) {
+        const size_t end = std::min(line.find(' ', start), line.size());
+        fields.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+    return fields;
+}
+
+bool parseNumber(std::string_view field, int64_t& value) {
+    const char* end = field.data() + field.size();
+    const auto result = std::from_chars(field.data(), end, value);
+    return !field.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+void appendPlays(std::string& out, const MixSyncPlays& plays) {
+    out += "p ";
+    out += plays.mix_id;
+    for (int64_t value : {plays.plays, plays.skips, plays.played_seconds, plays.last_played_ms}) {
+        out += ' ';
+        out += std::to_string(value);
+    }
+    out += '\n';
+}
+
+void appendFavorite(std::string& out, const MixSyncFavorite& favorite) {
+    out += "f ";
+    out += favorite.mix_id;
+    out += favorite.favorite ? " 1 " : " 0 ";
+    out += std::to_string(favorite.changed_ms);
+    out += '\n';
+}
+
+bool parsePlays(const std::vector<std::string_view>& fields, std::vector<MixSyncPlays>& out) {
+    MixSyncPlays plays;
+    if (fields.size() != 6 || fields[1].empty() || !parseNumber(fields[2], plays.plays) ||
+        !parseNumber(fields[3], plays.skips) || !parseNumber(fields[4], plays.played_seconds) ||
+        !parseNumber(fields[5], plays.last_played_ms)) {
+        return false;
+    }
+    plays.mix_id = std::string(fields[1]);
+    out.push_back(std::move(plays));
+    return true;
+}
+
+bool parseFavorite(const std::vector<std::string_view>& fields, std::vector<MixSyncFavorite>& out) {
+    MixSyncFavorite favorite;
+    if (fields.size() != 4 || fields[1].empty() || (fields[2] != "0" && fields[2] != "1") ||
+        !parseNumber(fields[3], favorite.changed_ms)) {
+        return false;
+    }
+    favorite.mix_id = std::string(fields[1]);
+    favorite.favorite = fields[2] == "1";
+    out.push_back(std::move(favorite));
+    return true;
+}
+
+/**
+ * @brief Hand each line after the magic line to visit, as fields; blank lines are skipped
+ * @return False if the magic line is missing or visit turned a line down
+ */
+template <typename Visit>
+bool forEachLine(std::string_view text, Visit visit) {
+    const std::string_view magic = StringConstants::MIX_SYNC_MAGIC;
+    size_t start = text.find('\n');
+    std::string_view first = text.substr(0, start);
+    if (!first.empty() && first.back() == '\r') {
+        first.remove_suffix(1);
+    }
+    if (first != magic) {
+        return false;
+    }
+    while (start != std::string_view::npos) {
+        const size_t end = text.find('\n', start + 1);
+        std::string_view line = text.substr(start + 1, end == std::string_view::npos ? end : end - start - 1);
+        start = end;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (!line.empty() && !visit(splitFields(line))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+std::string MixSyncDelta::encode() const {
+    std::string out = StringConstants::MIX_SYNC_MAGIC;
+    out += "\nnode " + node;
+    out += "\ncursor " + std::to_string(cursor);
+    out += "\nevents " + std::to_string(after_event) + ' ' + std::to_string(last_event) + ' ' + std::to_string(events);
+    out += '\n';
+    for (const MixSyncPlays& entry : plays) {
+        appendPlays(out, entry);
+    }
+    for (const MixSyncFavorite& entry : favorites) {
+        appendFavorite(out, entry);
+    }
+    return out;
+}
+
+bool MixSyncDelta::parse(std::string_view text, MixSyncDelta& delta) {
+    delta = MixSyncDelta();
+    return forEachLine(text, [&delta](const std::vector<std::string_view>& fields) {
+        if (fields[0] == "node") {
+            if (fields.size() != 2) {
+                return false;
+            }
+            delta.node = std::string(fields[1]);
+            return true;
+        }
+        if (fields[0] == "cursor") {
+            return fields.size() == 2 && parseNumber(fields[1], delta.cursor);
+        }
+        if (fields[0] == "events") {
+            return fields.size() == 4 && parseNumber(fields[1], delta.after_event) &&
+                   parseNumber(fields[2], delta.last_event) && parseNumber(fields[3], delta.events);
+        }
+        if (fields[0] == "p") {
+            return parsePlays(fields, delta.plays);
+        }
+        if (fields[0] == "f") {
+            return parseFavorite(fields, delta.favorites);
+        }
+        return true;
+    });
+}
+
+std::string MixSyncReply::encode() const {
+    std::string out = StringConstants::MIX_SYNC_MAGIC;
+    out += "\ncursor " + std::to_string(cursor);
+    out += '\n';
+    for (const MixSyncPlays& entry : totals) {
+        appendPlays(out, entry);
+    }
+    for (const MixSyncFavorite& entry : favorites) {
+        appendFavorite(out, entry);
+    }
+    return out;
+}
+
+bool MixSyncReply::parse(std::string_view text, MixSyncReply& reply) {
+    reply = MixSyncReply();
+    return forEachLine(text, [&reply](const std::vector<std::string_view>& fields) {
+        if (fields[0] == "cursor") {
+            return fields.size() == 2 && parseNumber(fields[1], reply.cursor);
+        }
+        if (fields[0] == "p") {
+            return parsePlays(fields, reply.totals);
+        }
+        if (fields[0] == "f") {
+            return parseFavorite(fields, reply.favorites);
+        }
+        return true;
+    });
+}
+
+}  // namespace AutoVibez::Data
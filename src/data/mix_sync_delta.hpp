@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief A mix's plays since the last delta, or in a reply its totals across every node
+ */
+struct MixSyncPlays {
+    std::string mix_id;
+    int64_t plays = 0;
+    int64_t skips = 0;
+    int64_t played_seconds = 0;
+    int64_t last_played_ms = 0;
+};
+
+/**
+ * @brief A mix's favorite flag as last set, on this node in a delta or on any node in a reply
+ */
+struct MixSyncFavorite {
+    std::string mix_id;
+    bool favorite = false;
+    int64_t changed_ms = 0;  // Epoch ms; of two settings the later wins
+};
+
+/**
+ * @brief One batch of a node's changes for the sync server
+ *
+ * On the wire it is text, one record per line and fields split by single spaces,
+ * after the MIX_SYNC_MAGIC line:
+ *   node <id>
+ *   cursor <server cursor>
+ *   events <after rowid> <last rowid> <count>
+ *   p <mix id> <plays> <skips> <played seconds> <last played ms>
+ *   f <mix id> <0|1> <changed ms>
+ * The play events a delta folds in are named by rowid, so a server that took it
+ * before its reply was lost can tell it apart when the node sends it again.
+ * Lines of a kind the reader does not know are skipped.
+ */
+struct MixSyncDelta {
+    std::string node;         // Made once per database and kept in it
+    int64_t cursor = 0;       // From the server's last reply, 0 before the first
+    int64_t after_event = 0;  // The play events after this rowid...
+    int64_t last_event = 0;   // ...up to this one are folded into plays
+    int64_t events = 0;       // How many they are
+    std::vector<MixSyncPlays> plays;
+    std::vector<MixSyncFavorite> favorites;
+
+    bool empty() const {
+        return plays.empty() && favorites.empty();
+    }
+
+    std::string encode() const;
+
+    /**
+     * @brief Read a delta as encode() writes it
+     * @return False if the magic line is missing or a known line is malformed
+     */
+    static bool parse(std::string_view text, MixSyncDelta& delta);
+};
+
+/**
+ * @brief What the sync server sends back: every mix that changed anywhere after the delta's cursor
+ *
+ * Written as a delta is, with a cursor line and the p lines holding totals.
+ */
+struct MixSyncReply {
+    int64_t cursor = 0;  // Goes out with the next delta
+    std::vector<MixSyncPlays> totals;
+    std::vector<MixSyncFavorite> favorites;
+
+    std::string encode() const;
+
+    /**
+     * @brief Read a reply as encode() writes it
+     * @return False if the magic line is missing or a known line is malformed
+     */
+    static bool parse(std::string_view text, MixSyncReply& reply);
+};
+
+}  // namespace AutoVibez::Data
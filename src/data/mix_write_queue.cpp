@@ -0,0 +1,96 @@
+#include "mix_write_queue.hpp"
+
+#include "trace_recorder.hpp"
+
+namespace AutoVibez::Data {
+
+MixWriteQueue::MixWriteQueue(Executor executor, Settler settle)
+    : executor_(std::move(executor)), settle_(std::move(settle)) {
+    thread_ = std::thread(&MixWriteQueue::run, this);
+}
+
+MixWriteQueue::~MixWriteQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::future<bool> MixWriteQueue::enqueue(const std::string& id, const std::function<void(MixWrite&)>& change,
+                                         const std::function<void()>& preview) {
+    std::promise<bool> promise;
+    std::future<bool> result = promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = positions_.find(id);
+        if (it == positions_.end()) {
+            it = positions_.emplace(id, pending_.size()).first;
+            pending_.emplace_back();
+            pending_.back().id = id;
+        }
+        change(pending_[it->second]);
+        waiters_.push_back(std::move(promise));
+        if (preview) {
+            preview();
+        }
+    }
+    wake_.notify_one();
+    return result;
+}
+
+void MixWriteQueue::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return pending_.empty() && !executing_; });
+}
+
+size_t MixWriteQueue::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void MixWriteQueue::run() {
+    AUTOVIBEZ_TRACE_THREAD("db writes");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            break;  // Stopping with nothing left to write
+        }
+
+        std::vector<MixWrite> batch;
+        batch.swap(pending_);
+        positions_.clear();
+        std::vector<std::promise<bool>> waiters;
+        waiters.swap(waiters_);
+        executing_ = true;
+
+        lock.unlock();
+        const bool ok = executor_(batch);
+        lock.lock();
+
+        // Mixes changed again meanwhile keep their newer preview
+        std::vector<MixWrite> settled;
+        for (MixWrite& write : batch) {
+            if (!positions_.count(write.id)) {
+                settled.push_back(std::move(write));
+            }
+        }
+        if (settle_) {
+            settle_(settled, ok);
+        }
+        executing_ = false;
+        for (std::promise<bool>& waiter : waiters) {
+            waiter.set_value(ok);
+        }
+        if (pending_.empty()) {
+            idle_.notify_all();
+        }
+    }
+    idle_.notify_all();
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "play_history.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Everything queued for one mix since its last batch, folded together
+ */
+struct MixWrite {
+    std::string id;
+    bool toggle_favorite = false;  // An odd number of toggles is pending
+    int plays = 0;                 // Plays to add to play_count
+    bool set_local_path = false;
+    std::string local_path;  // Last path set wins
+    bool soft_delete = false;
+    std::vector<PlayEvent> play_events;  // Every ended play, in order
+};
+
+/**
+ * @brief Single writer thread for small per-mix updates
+ *
+ * Callers on any thread queue a change and get a future; the writer hands every
+ * mix with pending changes to the executor as one batch, which should run it in a
+ * single transaction. Changes queued while a batch runs wait for the next one, so
+ * a burst coalesces: toggles cancel in pairs, plays add up, the last path wins,
+ * and play events are all kept. The preview and settle hooks run under the queue
+ * lock, so an optimistic copy updated in preview is never overwritten in settle by
+ * a row that is already out of date again.
+ */
+class MixWriteQueue {
+public:
+    using Executor = std::function<bool(const std::vector<MixWrite>& batch)>;
+    using Settler = std::function<void(const std::vector<MixWrite>& batch, bool ok)>;
+
+    /**
+     * @param executor Writes one batch on the writer thread; false fails every future of the batch
+     * @param settle After each batch, with the writes whose mix has nothing queued again
+     */
+    MixWriteQueue(Executor executor, Settler settle);
+
+    /**
+     * @brief Executes what is still queued, then joins
+     */
+    ~MixWriteQueue();
+
+    MixWriteQueue(const MixWriteQueue&) = delete;
+    MixWriteQueue& operator=(const MixWriteQueue&) = delete;
+
+    /**
+     * @brief Queue a change to one mix
+     * @param change Folds the change into the mix's pending write
+     * @param preview Runs under the queue lock once the change is queued (may be empty)
+     * @return Resolved with the result of the batch that writes the change
+     */
+    std::future<bool> enqueue(const std::string& id, const std::function<void(MixWrite&)>& change,
+                              const std::function<void()>& preview = {});
+
+    /**
+     * @brief Block until everything queued before the call has been executed
+     */
+    void flush();
+
+    size_t getPendingCount() const;
+
+private:
+    Executor executor_;
+    Settler settle_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::vector<MixWrite> pending_;
+    std::unordered_map<std::string, size_t> positions_;
+    std::vector<std::promise<bool>> waiters_;
+    bool executing_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void run();
+};
+
+}  // namespace AutoVibez::Data
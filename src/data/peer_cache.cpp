@@ -0,0 +1,304 @@
+#include "peer_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <sstream>
+
+#include "constants.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr int HASH_DIGITS = 16;
+constexpr int RECEIVE_POLL_MS = 200;  // How soon stop() is noticed between datagrams
+
+std::string randomNodeId() {
+    std::random_device device;
+    std::uniform_int_distribution<uint64_t> distribution;
+    std::ostringstream id;
+    id << std::hex << distribution(device) << distribution(device);
+    return id.str();
+}
+
+// Ids go into announcements between spaces and into URLs unescaped
+bool isShareableId(const std::string& id) {
+    return !id.empty() && std::all_of(id.begin(), id.end(), [](unsigned char c) {
+        return std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~';
+    });
+}
+
+bool isContentHash(const std::string& hash) {
+    return hash.size() == HASH_DIGITS && std::all_of(hash.begin(), hash.end(), [](unsigned char c) {
+        return std::isdigit(c) || (c >= 'a' && c <= 'f');
+    });
+}
+}  // namespace
+
+PeerCache::PeerCache()
+    : node_id_(randomNodeId()), server_([this](const std::string& mix_id) { return resolve(mix_id); }) {}
+
+PeerCache::~PeerCache() {
+    stop();
+}
+
+void PeerCache::share(const std::string& mix_id, const std::string& content_hash, const std::string& local_path) {
+    if (!isShareableId(mix_id) || !isContentHash(content_hash) || local_path.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    shared_[mix_id] = Shared{content_hash, local_path};
+}
+
+void PeerCache::unshare(const std::string& mix_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shared_.erase(mix_id);
+}
+
+std::string PeerCache::resolve(const std::string& mix_id) {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = shared_.find(mix_id);
+        if (it == shared_.end()) {
+            return "";
+        }
+        path = it->second.local_path;
+    }
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        // Evicted or deleted since: stop announcing it
+        unshare(mix_id);
+        return "";
+    }
+    return path;
+}
+
+std::vector<PeerSource> PeerCache::findSources(const std::string& mix_id, Clock::time_point now) const {
+    std::vector<Holder> holders;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = holders_.find(mix_id);
+        if (it == holders_.end()) {
+            return {};
+        }
+        holders = it->second;
+    }
+    const auto expiry = std::chrono::milliseconds(Constants::PEER_EXPIRY_MS);
+    holders.erase(std::remove_if(holders.begin(), holders.end(),
+                                 [&](const Holder& holder) { return now - holder.seen > expiry; }),
+                  holders.end());
+    std::sort(holders.begin(), holders.end(), [](const Holder& a, const Holder& b) { return a.seen > b.seen; });
+
+    std::vector<PeerSource> sources;
+    for (const Holder& holder : holders) {
+        if (sources.size() >= static_cast<size_t>(Constants::PEER_MAX_SOURCES)) {
+            break;
+        }
+        sources.push_back(PeerSource{holder.url, holder.content_hash});
+    }
+    return sources;
+}
+
+size_t PeerCache::getPeerCount(Clock::time_point now) const {
+    const auto expiry = std::chrono::milliseconds(Constants::PEER_EXPIRY_MS);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(nodes_.begin(), nodes_.end(),
+                                             [&](const auto& node) { return now - node.second <= expiry; }));
+}
+
+std::vector<std::string> PeerCache::buildAnnouncements() const {
+    const std::string header = std::string(StringConstants::PEER_ANNOUNCE_MAGIC) + " " + node_id_ + " " +
+                               std::to_string(server_.getPort()) + "\n";
+    std::vector<std::string> datagrams{header};
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [mix_id, shared] : shared_) {
+        const std::string line = mix_id + " " + shared.content_hash + "\n";
+        if (datagrams.back().size() + line.size() > static_cast<size_t>(Constants::PEER_DATAGRAM_BYTES)) {
+            datagrams.push_back(header);
+        }
+        datagrams.back() += line;
+    }
+    return datagrams;
+}
+
+bool PeerCache::receiveAnnouncement(const std::string& datagram, const std::string& address, Clock::time_point now) {
+    std::istringstream lines(datagram);
+    std::string header;
+    std::getline(lines, header);
+    std::istringstream fields(header);
+    std::string magic;
+    std::string node_id;
+    long port = 0;
+    if (!(fields >> magic >> node_id >> port) || magic != StringConstants::PEER_ANNOUNCE_MAGIC ||
+        node_id == node_id_ || port <= 0 || port > 65535 || address.empty()) {
+        return false;
+    }
+    const std::string base = "http://" + address + ":" + std::to_string(port) + StringConstants::PEER_MIX_PATH;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool known = nodes_.count(node_id) > 0;
+    nodes_[node_id] = now;
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream entry(line);
+        std::string mix_id;
+        std::string content_hash;
+        if (!(entry >> mix_id >> content_hash) || !isShareableId(mix_id) || !isContentHash(content_hash)) {
+            continue;
+        }
+        std::vector<Holder>& holders = holders_[mix_id];
+        auto holder = std::find_if(holders.begin(), holders.end(),
+                                   [&](const Holder& existing) { return existing.node_id == node_id; });
+        if (holder == holders.end()) {
+            holders.push_back(Holder{node_id, base + mix_id, content_hash, now});
+        } else {
+            // The node may have come back on another address or port
+            *holder = Holder{node_id, base + mix_id, content_hash, now};
+        }
+    }
+    return !known;
+}
+
+void PeerCache::expire(Clock::time_point now) {
+    const auto expiry = std::chrono::milliseconds(Constants::PEER_EXPIRY_MS);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = holders_.begin(); it != holders_.end();) {
+        std::vector<Holder>& holders = it->second;
+        holders.erase(std::remove_if(holders.begin(), holders.end(),
+                                     [&](const Holder& holder) { return now - holder.seen > expiry; }),
+                      holders.end());
+        it = holders.empty() ? holders_.erase(it) : std::next(it);
+    }
+    for (auto it = nodes_.begin(); it != nodes_.end();) {
+        it = now - it->second > expiry ? nodes_.erase(it) : std::next(it);
+    }
+}
+
+#ifdef _WIN32
+
+bool PeerCache::start(uint16_t server_port) {
+    (void)server_port;
+    setError("The peer cache is not supported on this platform");
+    return false;
+}
+
+void PeerCache::stop() {}
+void PeerCache::discoveryLoop() {}
+
+#else
+
+bool PeerCache::start(uint16_t server_port) {
+    if (isRunning()) {
+        return true;
+    }
+    if (!server_.start(server_port)) {
+        setError(server_.getLastError());
+        return false;
+    }
+
+    const int udp = socket(AF_INET, SOCK_DGRAM, 0);
+    int reuse = 1;
+    unsigned char ttl = 1;  // Never past the first router
+    unsigned char loop = 1;  // Nodes on one host, as in testing, hear each other
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(Constants::PEER_MULTICAST_PORT);
+    ip_mreq membership{};
+    inet_pton(AF_INET, StringConstants::PEER_MULTICAST_GROUP, &membership.imr_multiaddr);
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+    bool ready = udp >= 0;
+    if (ready) {
+        // Every node on the host binds the group's port
+        setsockopt(udp, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#ifdef SO_REUSEPORT
+        setsockopt(udp, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+#endif
+        ready = bind(udp, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                setsockopt(udp, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0;
+        setsockopt(udp, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(udp, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    if (!ready) {
+        setError(std::string("Cannot join the peer multicast group: ") + std::strerror(errno));
+        if (udp >= 0) {
+            close(udp);
+        }
+        server_.stop();
+        return false;
+    }
+
+    socket_ = udp;
+    stopping_ = false;
+    discovery_ = std::thread(&PeerCache::discoveryLoop, this);
+    setSuccess(true);
+    return true;
+}
+
+void PeerCache::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    stopping_ = true;
+    discovery_.join();
+    close(socket_);
+    socket_ = -1;
+    server_.stop();
+}
+
+void PeerCache::discoveryLoop() {
+    sockaddr_in group{};
+    group.sin_family = AF_INET;
+    group.sin_port = htons(Constants::PEER_MULTICAST_PORT);
+    inet_pton(AF_INET, StringConstants::PEER_MULTICAST_GROUP, &group.sin_addr);
+    const auto interval = std::chrono::milliseconds(Constants::PEER_ANNOUNCE_INTERVAL_MS);
+
+    auto next_announce = Clock::now();
+    std::vector<char> datagram(Constants::PEER_DATAGRAM_BYTES * 2);
+    while (!stopping_) {
+        auto now = Clock::now();
+        if (now >= next_announce) {
+            for (const std::string& announcement : buildAnnouncements()) {
+                sendto(socket_, announcement.data(), announcement.size(), 0, reinterpret_cast<sockaddr*>(&group),
+                       sizeof(group));
+            }
+            expire(now);
+            next_announce = now + interval;
+        }
+
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_announce - now).count();
+        pollfd ready{socket_, POLLIN, 0};
+        if (poll(&ready, 1, static_cast<int>(std::min<int64_t>(wait, RECEIVE_POLL_MS))) <= 0) {
+            continue;
+        }
+        sockaddr_in sender{};
+        socklen_t sender_length = sizeof(sender);
+        const ssize_t got = recvfrom(socket_, datagram.data(), datagram.size(), 0,
+                                     reinterpret_cast<sockaddr*>(&sender), &sender_length);
+        if (got <= 0) {
+            continue;
+        }
+        char address[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &sender.sin_addr, address, sizeof(address));
+        if (receiveAnnouncement(std::string(datagram.data(), static_cast<size_t>(got)), address)) {
+            // A node just joined: tell it what this one holds now rather than an interval from now
+            next_announce = Clock::now();
+        }
+    }
+}
+
+#endif
+
+}  // namespace AutoVibez::Data
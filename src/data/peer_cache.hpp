@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "error_handler.hpp"
+#include "peer_file_server.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief A node on the LAN that holds a mix, as findSources offers it
+ */
+struct PeerSource {
+    std::string url;           //!< The file on the node's PeerFileServer
+    std::string content_hash;  //!< What the node says the file hashes to; the fetch must match it
+};
+
+/**
+ * @brief Mixes held by the AutoVibez nodes of one LAN, so each file crosses the internet once per venue
+ *
+ * Every PEER_ANNOUNCE_INTERVAL_MS a node multicasts the ids and content hashes of the
+ * mixes it shares, with the port of its PeerFileServer, in datagrams of at most
+ * PEER_DATAGRAM_BYTES to PEER_MULTICAST_GROUP. Announcements from other nodes fill a
+ * table of holders per mix; a holder not heard from for PEER_EXPIRY_MS drops out, so a
+ * node that went away or evicted a file stops being offered. Hearing a node for the
+ * first time brings the next announcement forward, which gets a node that just started
+ * the whole table within a round trip instead of an interval.
+ *
+ * The announced hash is only as trustworthy as the LAN: the downloader checks a fetched
+ * file against it, which catches truncated and mixed-up files, not a hostile node.
+ * POSIX only, as the file server. Thread-safe.
+ */
+class PeerCache : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PeerCache();
+
+    /**
+     * @brief Stops announcing and serving
+     */
+    ~PeerCache();
+
+    PeerCache(const PeerCache&) = delete;
+    PeerCache& operator=(const PeerCache&) = delete;
+
+    /**
+     * @brief Serve shared files and join the multicast group
+     * @param server_port 0 for any free port; it is announced either way
+     * @return False, with nothing running, if either socket could not be set up
+     */
+    bool start(uint16_t server_port = 0);
+
+    void stop();
+
+    bool isRunning() const {
+        return discovery_.joinable();
+    }
+
+    /**
+     * @brief Offer a downloaded mix to the other nodes, from the next announcement on
+     */
+    void share(const std::string& mix_id, const std::string& content_hash, const std::string& local_path);
+
+    void unshare(const std::string& mix_id);
+
+    /**
+     * @return Other nodes holding the mix, most recently heard first; at most PEER_MAX_SOURCES
+     */
+    std::vector<PeerSource> findSources(const std::string& mix_id, Clock::time_point now = Clock::now()) const;
+
+    /**
+     * @brief Other nodes heard from within PEER_EXPIRY_MS
+     */
+    size_t getPeerCount(Clock::time_point now = Clock::now()) const;
+
+    const std::string& getNodeId() const {
+        return node_id_;
+    }
+
+    /**
+     * @brief The datagrams that announce every shared mix
+     */
+    std::vector<std::string> buildAnnouncements() const;
+
+    /**
+     * @brief Take in another node's announcement; this node's own are ignored
+     * @param address Where the datagram came from, which is where the node serves
+     * @return True if it came from a node not heard from before
+     */
+    bool receiveAnnouncement(const std::string& datagram, const std::string& address,
+                             Clock::time_point now = Clock::now());
+
+private:
+    struct Shared {
+        std::string content_hash;
+        std::string local_path;
+    };
+
+    struct Holder {
+        std::string node_id;
+        std::string url;
+        std::string content_hash;
+        Clock::time_point seen;
+    };
+
+    /**
+     * @brief The file to serve for a mix, forgetting one that went since it was shared
+     */
+    std::string resolve(const std::string& mix_id);
+
+    void discoveryLoop();
+    void expire(Clock::time_point now);
+
+    const std::string node_id_;
+    PeerFileServer server_;
+    int socket_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread discovery_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Shared> shared_;  // Ordered, so announcements list mixes in a stable order
+    std::unordered_map<std::string, std::vector<Holder>> holders_;
+    std::unordered_map<std::string, Clock::time_point> nodes_;  // Other nodes, last heard
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,280 @@
+#include "peer_file_server.hpp"
+
+#include <csignal>
+#include <cstring>
+#include <sstream>
+
+#include "constants.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#elif defined(__APPLE__)
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr int ACCEPT_POLL_MS = 200;  // How soon stop() is noticed by the acceptor
+
+#ifndef _WIN32
+bool sendAll(int connection, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t wrote = send(connection, data.data() + sent, data.size() - sent, 0);
+        if (wrote <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(wrote);
+    }
+    return true;
+}
+
+std::string statusLine(int status) {
+    switch (status) {
+        case 200:
+            return "HTTP/1.1 200 OK\r\n";
+        case 400:
+            return "HTTP/1.1 400 Bad Request\r\n";
+        case 405:
+            return "HTTP/1.1 405 Method Not Allowed\r\n";
+        default:
+            return "HTTP/1.1 404 Not Found\r\n";
+    }
+}
+#endif
+}  // namespace
+
+PeerFileServer::PeerFileServer(Resolver resolver) : resolver_(std::move(resolver)) {}
+
+PeerFileServer::~PeerFileServer() {
+    stop();
+}
+
+#ifdef _WIN32
+
+bool PeerFileServer::start(uint16_t port) {
+    (void)port;
+    setError("The peer cache is not supported on this platform");
+    return false;
+}
+
+void PeerFileServer::stop() {}
+void PeerFileServer::acceptLoop() {}
+void PeerFileServer::workLoop() {}
+void PeerFileServer::serve(int connection) {
+    (void)connection;
+}
+bool PeerFileServer::sendFile(int connection, int file, int64_t length) {
+    (void)connection, (void)file, (void)length;
+    return false;
+}
+
+#else
+
+bool PeerFileServer::start(uint16_t port) {
+    if (isRunning()) {
+        return true;
+    }
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        setError(std::string("Cannot create the peer server socket: ") + std::strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, Constants::PEER_UPLOAD_WORKERS * 4) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        setError(std::string("Cannot listen for peers: ") + std::strerror(errno));
+        close(listener);
+        return false;
+    }
+
+    // A node that hangs up mid-file should fail the send, not kill the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    listener_ = listener;
+    port_ = ntohs(address.sin_port);
+    stopping_ = false;
+    for (int i = 0; i < Constants::PEER_UPLOAD_WORKERS; ++i) {
+        workers_.emplace_back(&PeerFileServer::workLoop, this);
+    }
+    acceptor_ = std::thread(&PeerFileServer::acceptLoop, this);
+    setSuccess(true);
+    return true;
+}
+
+void PeerFileServer::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (acceptor_.joinable()) {
+        acceptor_.join();
+    }
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    for (int connection : connections_) {
+        close(connection);
+    }
+    connections_.clear();
+    close(listener_);
+    listener_ = -1;
+    port_ = 0;
+}
+
+void PeerFileServer::acceptLoop() {
+    while (!stopping_) {
+        pollfd ready{listener_, POLLIN, 0};
+        if (poll(&ready, 1, ACCEPT_POLL_MS) <= 0 || !(ready.revents & POLLIN)) {
+            continue;
+        }
+        const int connection = accept(listener_, nullptr, nullptr);
+        if (connection < 0) {
+            continue;
+        }
+        // A stalled peer holds a worker no longer than this
+        timeval timeout{Constants::PEER_IO_TIMEOUT_SECONDS, 0};
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+        int no_sigpipe = 1;
+        setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.push_back(connection);
+        }
+        wake_.notify_one();
+    }
+}
+
+void PeerFileServer::workLoop() {
+    for (;;) {
+        int connection = -1;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !connections_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            connection = connections_.front();
+            connections_.pop_front();
+        }
+        serve(connection);
+        close(connection);
+    }
+}
+
+void PeerFileServer::serve(int connection) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        if (request.size() >= static_cast<size_t>(Constants::PEER_REQUEST_MAX_BYTES)) {
+            sendAll(connection, statusLine(400) + "Content-Length: 0\r\nConnection: close\r\n\r\n");
+            return;
+        }
+        const ssize_t got = recv(connection, buffer, sizeof(buffer), 0);
+        if (got <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(got));
+    }
+
+    std::istringstream line(request.substr(0, request.find("\r\n")));
+    std::string method;
+    std::string target;
+    line >> method >> target;
+    const std::string prefix = StringConstants::PEER_MIX_PATH;
+    auto reply = [connection](int status) {
+        sendAll(connection, statusLine(status) + "Content-Length: 0\r\nConnection: close\r\n\r\n");
+    };
+    if (method != "GET" && method != "HEAD") {
+        reply(405);
+        return;
+    }
+    if (target.rfind(prefix, 0) != 0 || target.size() == prefix.size()) {
+        reply(404);
+        return;
+    }
+
+    const std::string path = resolver_ ? resolver_(target.substr(prefix.size())) : std::string();
+    const int file = path.empty() ? -1 : open(path.c_str(), O_RDONLY);
+    struct stat info {};
+    if (file < 0 || fstat(file, &info) != 0 || !S_ISREG(info.st_mode)) {
+        if (file >= 0) {
+            close(file);
+        }
+        reply(404);
+        return;
+    }
+    const auto length = static_cast<int64_t>(info.st_size);
+    const std::string header = statusLine(200) + "Content-Type: audio/mpeg\r\nContent-Length: " +
+                               std::to_string(length) + "\r\nConnection: close\r\n\r\n";
+    if (sendAll(connection, header) && method == "GET") {
+        sendFile(connection, file, length);
+    }
+    close(file);
+}
+
+bool PeerFileServer::sendFile(int connection, int file, int64_t length) {
+    int64_t sent = 0;
+#if defined(__linux__)
+    off_t offset = 0;
+    while (sent < length) {
+        const ssize_t wrote = sendfile(connection, file, &offset, static_cast<size_t>(length - sent));
+        if (wrote <= 0) {
+            return false;
+        }
+        sent += wrote;
+    }
+    return true;
+#elif defined(__APPLE__)
+    while (sent < length) {
+        off_t chunk = static_cast<off_t>(length - sent);
+        // Reports what went out even when it stops early, e.g. on the send timeout
+        sendfile(file, connection, static_cast<off_t>(sent), &chunk, nullptr, 0);
+        if (chunk <= 0) {
+            return false;
+        }
+        sent += chunk;
+    }
+    return true;
+#else
+    std::vector<char> chunk(64 * 1024);
+    while (sent < length) {
+        const ssize_t got = pread(file, chunk.data(), chunk.size(), static_cast<off_t>(sent));
+        if (got <= 0 || !sendAll(connection, std::string(chunk.data(), static_cast<size_t>(got)))) {
+            return false;
+        }
+        sent += got;
+    }
+    return true;
+#endif
+}
+
+#endif
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "error_handler.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Minimal HTTP/1.1 endpoint that hands this node's mix files to other nodes on the LAN
+ *
+ * Answers "GET <PEER_MIX_PATH><mix id>" (and HEAD) with the whole file and closes the
+ * connection; anything else gets a 404 or 400. The body goes out with sendfile where
+ * the platform has it, so the bytes go from the page cache to the socket without a
+ * copy through user space. An acceptor thread hands connections to PEER_UPLOAD_WORKERS
+ * workers; a node fetching a file waits while they are busy. POSIX only: start() fails
+ * on Windows. Thread-safe.
+ */
+class PeerFileServer : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @brief The file to serve for a mix id, empty if this node doesn't share it; called on the workers
+     */
+    using Resolver = std::function<std::string(const std::string& mix_id)>;
+
+    explicit PeerFileServer(Resolver resolver);
+
+    /**
+     * @brief Stops serving; a transfer in flight is cut off
+     */
+    ~PeerFileServer();
+
+    PeerFileServer(const PeerFileServer&) = delete;
+    PeerFileServer& operator=(const PeerFileServer&) = delete;
+
+    /**
+     * @brief Listen on every interface
+     * @param port 0 for any free port, which getPort then reports
+     * @return False, with nothing running, if the socket could not be set up
+     */
+    bool start(uint16_t port = 0);
+
+    void stop();
+
+    bool isRunning() const {
+        return listener_ >= 0;
+    }
+    uint16_t getPort() const {
+        return port_;
+    }
+
+private:
+    void acceptLoop();
+    void workLoop();
+    void serve(int connection);
+
+    /**
+     * @brief Send length bytes of file from its start
+     */
+    static bool sendFile(int connection, int file, int64_t length);
+
+    Resolver resolver_;
+    int listener_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::thread acceptor_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<int> connections_;  // Accepted, waiting for a worker
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief One play of a mix, appended to play_events when the play ends
+ */
+struct PlayEvent {
+    std::string mix_id;
+    int64_t ts_epoch_ms = 0;  // When the play started
+    int duration_played = 0;  // Seconds
+    bool skipped = false;     // Ended well before the mix did
+};
+
+/**
+ * @brief Per-mix totals over its play events, kept in mix_play_stats
+ */
+struct MixPlayStats {
+    std::string mix_id;
+    int plays = 0;
+    int skips = 0;
+    int skip_streak = 0;  // Skips since the mix was last played through
+    int64_t played_seconds = 0;
+    int64_t last_played_ms = 0;  // 0 if never played
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,234 @@
+#include "play_queue.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Data {
+
+PlayQueue::PlayQueue(Picker picker, size_t depth, Listener listener)
+    : picker_(std::move(picker)), depth_(depth), listener_(std::move(listener)) {
+    thread_ = std::thread(&PlayQueue::run, this);
+}
+
+PlayQueue::~PlayQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PlayQueue::setGenre(const std::string& genre) {
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (genre == genre_) {
+            return;
+        }
+        genre_ = genre;
+        dropped = !queue_.empty();
+        queue_.clear();
+        generation_++;
+        changedLocked();
+    }
+    if (dropped) {
+        notifyListener();
+    }
+}
+
+void PlayQueue::setCurrent(const std::string& mix_id) {
+    bool removed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_id_ = mix_id;
+        removed = eraseLocked(mix_id);
+        changedLocked();
+    }
+    if (removed) {
+        notifyListener();
+    }
+}
+
+void PlayQueue::remove(const std::string& mix_id) {
+    bool removed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        removed = eraseLocked(mix_id);
+        changedLocked();
+    }
+    if (removed) {
+        notifyListener();
+    }
+}
+
+void PlayQueue::clear() {
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped = !queue_.empty();
+        queue_.clear();
+        generation_++;
+        changedLocked();
+    }
+    if (dropped) {
+        notifyListener();
+    }
+}
+
+void PlayQueue::refill() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    changedLocked();
+}
+
+void PlayQueue::restore(std::vector<Mix> mixes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Mix> queue;
+        auto queued = [&queue](const std::string& mix_id) {
+            return std::any_of(queue.begin(), queue.end(), [&mix_id](const Mix& mix) { return mix.id == mix_id; });
+        };
+        for (Mix& mix : mixes) {
+            if (queue.size() < depth_ && !mix.id.empty() && mix.id != current_id_ && !queued(mix.id)) {
+                queue.push_back(std::move(mix));
+            }
+        }
+        for (Mix& mix : queue_) {
+            if (queue.size() < depth_ && !queued(mix.id)) {
+                queue.push_back(std::move(mix));
+            }
+        }
+        queue_ = std::move(queue);
+        generation_++;
+        changedLocked();
+    }
+    notifyListener();
+}
+
+Mix PlayQueue::pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!queue_.empty()) {
+        Mix next = std::move(queue_.front());
+        queue_.erase(queue_.begin());
+        current_id_ = next.id;
+        changedLocked();
+        lock.unlock();
+        notifyListener();
+        return next;
+    }
+
+    // Nothing queued yet: pick here rather than wait for the worker
+    const std::string genre = genre_;
+    const std::string current_id = current_id_;
+    lock.unlock();
+    Mix next = picker_(genre, current_id);
+    if (!next.id.empty()) {
+        setCurrent(next.id);
+    }
+    return next;
+}
+
+Mix PlayQueue::peek() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.empty() ? Mix() : queue_.front();
+}
+
+std::vector<Mix> PlayQueue::upcoming() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_;
+}
+
+void PlayQueue::waitUntilSettled() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    settled_.wait(lock, [this]() { return stopping_ || (!picking_ && !needsPickLocked()); });
+}
+
+bool PlayQueue::needsPickLocked() const {
+    return !exhausted_ && queue_.size() < depth_;
+}
+
+bool PlayQueue::isTakenLocked(const std::string& mix_id) const {
+    return mix_id == current_id_ ||
+           std::any_of(queue_.begin(), queue_.end(), [&mix_id](const Mix& mix) { return mix.id == mix_id; });
+}
+
+bool PlayQueue::eraseLocked(const std::string& mix_id) {
+    auto it = std::find_if(queue_.begin(), queue_.end(), [&mix_id](const Mix& mix) { return mix.id == mix_id; });
+    if (it == queue_.end()) {
+        return false;
+    }
+    queue_.erase(it);
+    return true;
+}
+
+void PlayQueue::changedLocked() {
+    revision_++;
+    exhausted_ = false;
+    wake_.notify_one();
+}
+
+void PlayQueue::notifyListener() {
+    if (listener_) {
+        listener_();
+    }
+}
+
+void PlayQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this]() { return stopping_ || needsPickLocked(); });
+        if (stopping_) {
+            break;
+        }
+
+        const uint64_t generation = generation_;
+        const uint64_t revision = revision_;
+        const std::string genre = genre_;
+        const std::string current_id = current_id_;
+        std::vector<std::string> taken;
+        for (const Mix& mix : queue_) {
+            taken.push_back(mix.id);
+        }
+        picking_ = true;
+        lock.unlock();
+
+        // A small library keeps offering what is already queued, so give up after a few tries
+        Mix picked;
+        for (int attempt = 0; attempt < Constants::PLAY_QUEUE_PICK_ATTEMPTS && picked.id.empty(); ++attempt) {
+            Mix mix = picker_(genre, current_id);
+            if (mix.id.empty()) {
+                break;
+            }
+            if (mix.id != current_id && std::find(taken.begin(), taken.end(), mix.id) == taken.end()) {
+                picked = std::move(mix);
+            }
+        }
+
+        lock.lock();
+        bool queued = false;
+        if (generation == generation_) {
+            if (!picked.id.empty() && !isTakenLocked(picked.id)) {
+                queue_.push_back(std::move(picked));
+                queued = true;
+            } else if (picked.id.empty() && revision == revision_) {
+                exhausted_ = true;
+            }
+        }
+        if (queued) {
+            // Still picking until the listener has seen the new mix, so waitUntilSettled covers it
+            lock.unlock();
+            notifyListener();
+            lock.lock();
+        }
+        picking_ = false;
+        if (!needsPickLocked()) {
+            settled_.notify_all();
+        }
+    }
+    settled_.notify_all();
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief The next few mixes, picked ahead of playback
+ *
+ * A worker thread keeps up to depth picks materialized, so starting the next mix
+ * takes the head rather than running the selection while playback waits. Picks
+ * never repeat the current mix or one already queued; when the picker keeps
+ * returning those the library is too small, and the queue stays short until
+ * something changes. A new genre drops the queue and refills it, a removed mix
+ * leaves it and is replaced, and a pick that was running across a genre change is
+ * discarded rather than queued.
+ */
+class PlayQueue {
+public:
+    /**
+     * @brief Pick one mix, preferring genre, other than exclude_id; an empty Mix when there is none
+     */
+    using Picker = std::function<Mix(const std::string& genre, const std::string& exclude_id)>;
+
+    /**
+     * @brief Called after each change to the queued mixes, on the thread that made it, outside the lock
+     */
+    using Listener = std::function<void()>;
+
+    /**
+     * @param picker Runs on the worker thread, and on the caller's in pop() when the queue is empty
+     * @param depth Mixes kept queued
+     */
+    PlayQueue(Picker picker, size_t depth, Listener listener = {});
+
+    /**
+     * @brief Joins the worker; a pick in progress is finished and dropped
+     */
+    ~PlayQueue();
+
+    PlayQueue(const PlayQueue&) = delete;
+    PlayQueue& operator=(const PlayQueue&) = delete;
+
+    /**
+     * @brief Refill for another genre (nothing happens when it is the current one)
+     */
+    void setGenre(const std::string& genre);
+
+    /**
+     * @brief The mix now playing: never picked, and taken off the queue if it was on it
+     */
+    void setCurrent(const std::string& mix_id);
+
+    /**
+     * @brief Take a mix off the queue, e.g. when it was deleted; the worker replaces it
+     */
+    void remove(const std::string& mix_id);
+
+    /**
+     * @brief Drop every queued mix and pick again, e.g. after the library reloaded
+     */
+    void clear();
+
+    /**
+     * @brief Let a queue that ran out of distinct mixes try again, e.g. after mixes were added
+     */
+    void refill();
+
+    /**
+     * @brief Put mixes at the head of the queue, e.g. the queue saved before a restart
+     *
+     * The current mix and repeats are skipped; picks already queued follow them up to
+     * the depth, and a pick in progress is dropped.
+     */
+    void restore(std::vector<Mix> mixes);
+
+    /**
+     * @brief Take the head of the queue and make it the current mix
+     *
+     * Picks on the caller's thread when the worker has not queued anything yet, so
+     * this only comes back empty when the picker has nothing.
+     */
+    Mix pop();
+
+    /**
+     * @return The head without taking it, or an empty Mix
+     */
+    Mix peek() const;
+
+    /**
+     * @brief Queued mixes, next first
+     */
+    std::vector<Mix> upcoming() const;
+
+    size_t getDepth() const {
+        return depth_;
+    }
+
+    /**
+     * @brief Block until the queue is full or the picker has run out
+     */
+    void waitUntilSettled();
+
+private:
+    Picker picker_;
+    const size_t depth_;
+    Listener listener_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable settled_;
+    std::vector<Mix> queue_;
+    std::string genre_;
+    std::string current_id_;
+    uint64_t generation_ = 0;  // Bumped when the queued mixes no longer fit (genre, clear)
+    uint64_t revision_ = 0;    // Bumped by every change, so a pick that ran across one is not final
+    bool exhausted_ = false;   // The last pick found nothing new
+    bool picking_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    bool needsPickLocked() const;
+    bool isTakenLocked(const std::string& mix_id) const;
+    bool eraseLocked(const std::string& mix_id);
+    void changedLocked();
+    void notifyListener();
+    void run();
+};
+
+}  // namespace AutoVibez::Data
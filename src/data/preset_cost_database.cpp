@@ -0,0 +1,136 @@
+#include "preset_cost_database.hpp"
+
+#include <utility>
+
+#include "constants.hpp"
+#include "sqlite_connection.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+// Frame-weighted mean of two measurements; a negative value is a missing GPU time
+double combine(double stored, int storedFrames, double sample, int sampleFrames) {
+    if (stored < 0.0 || storedFrames <= 0) {
+        return sample;
+    }
+    if (sample < 0.0 || sampleFrames <= 0) {
+        return stored;
+    }
+    return (stored * storedFrames + sample * sampleFrames) / (storedFrames + sampleFrames);
+}
+
+void readCost(const IStatement& stmt, PresetCost& cost) {
+    cost.frames = stmt.getInt("frames");
+    cost.cpu_ms = stmt.getDouble("cpu_ms");
+    cost.gpu_ms = stmt.getDouble("gpu_ms");
+    cost.cpu_p95_ms = stmt.getDouble("cpu_p95_ms");
+    cost.gpu_p95_ms = stmt.getDouble("gpu_p95_ms");
+    cost.measured_at = stmt.getText("measured_at");
+}
+}  // namespace
+
+PresetCostDatabase::PresetCostDatabase(const std::string& db_path)
+    : connection_(std::make_shared<SqliteConnection>(db_path)) {}
+
+PresetCostDatabase::PresetCostDatabase(std::shared_ptr<IDatabaseConnection> connection)
+    : connection_(std::move(connection)) {}
+
+bool PresetCostDatabase::initialize() {
+    if (!connection_->initialize()) {
+        setError("Failed to initialize preset cost database: " + connection_->getLastError());
+        return false;
+    }
+    if (!connection_->execute(StringConstants::CREATE_PRESET_COSTS_TABLE)) {
+        setError("Failed to create preset cost table: " + connection_->getLastError());
+        return false;
+    }
+    return true;
+}
+
+bool PresetCostDatabase::recordCost(const PresetCost& sample) {
+    if (sample.path.empty() || sample.frames <= 0) {
+        setError("Preset cost sample has no path or frames");
+        return false;
+    }
+
+    PresetCost stored = getCost(sample.path, sample.renderer);
+    PresetCost merged = sample;
+    merged.frames = stored.frames + sample.frames;
+    merged.cpu_ms = combine(stored.cpu_ms, stored.frames, sample.cpu_ms, sample.frames);
+    merged.gpu_ms = combine(stored.gpu_ms, stored.frames, sample.gpu_ms, sample.frames);
+    merged.cpu_p95_ms = combine(stored.cpu_p95_ms, stored.frames, sample.cpu_p95_ms, sample.frames);
+    merged.gpu_p95_ms = combine(stored.gpu_p95_ms, stored.frames, sample.gpu_p95_ms, sample.frames);
+
+    auto stmt = connection_->prepare(StringConstants::INSERT_OR_REPLACE_PRESET_COST);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return false;
+    }
+    stmt->bindText(1, merged.path);
+    stmt->bindText(2, merged.renderer);
+    stmt->bindInt(3, merged.frames);
+    stmt->bindDouble(4, merged.cpu_ms);
+    stmt->bindDouble(5, merged.gpu_ms);
+    stmt->bindDouble(6, merged.cpu_p95_ms);
+    stmt->bindDouble(7, merged.gpu_p95_ms);
+
+    if (!stmt->execute()) {
+        setError("Failed to record preset cost: " + connection_->getLastError());
+        return false;
+    }
+    clearError();
+    return true;
+}
+
+PresetCost PresetCostDatabase::getCost(const std::string& path, const std::string& renderer) {
+    auto stmt = connection_->prepare(StringConstants::SELECT_PRESET_COST);
+    PresetCost cost;
+    cost.path = path;
+    cost.renderer = renderer;
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return cost;
+    }
+
+    stmt->bindText(1, path);
+    stmt->bindText(2, renderer);
+    if (stmt->step()) {
+        readCost(*stmt, cost);
+    }
+    return cost;
+}
+
+std::vector<PresetCost> PresetCostDatabase::getCosts(const std::string& renderer) {
+    return executeQuery(StringConstants::SELECT_PRESET_COSTS_FOR_RENDERER, renderer, 0);
+}
+
+std::vector<PresetCost> PresetCostDatabase::getMostExpensive(int limit) {
+    return executeQuery(StringConstants::SELECT_MOST_EXPENSIVE_PRESETS, "", limit);
+}
+
+std::vector<PresetCost> PresetCostDatabase::executeQuery(const std::string& sql, const std::string& text,
+                                                         int limit) {
+    std::vector<PresetCost> costs;
+    auto stmt = connection_->prepare(sql);
+    if (!stmt) {
+        setError("Failed to prepare statement: " + connection_->getLastError());
+        return costs;
+    }
+
+    // Each query takes either a renderer or a limit
+    if (limit > 0) {
+        stmt->bindInt(1, limit);
+    } else {
+        stmt->bindText(1, text);
+    }
+    while (stmt->step()) {
+        PresetCost cost;
+        cost.path = stmt->getText("path");
+        cost.renderer = stmt->getText("renderer");
+        readCost(*stmt, cost);
+        costs.push_back(cost);
+    }
+    return costs;
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "database_interfaces.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Measured render cost of one preset on one GPU/driver
+ *
+ * Times are for projectm_opengl_render_frame, in milliseconds. GPU times are -1
+ * when the driver has no timer queries.
+ */
+struct PresetCost {
+    std::string path;      //!< Preset path as the playlist reports it
+    std::string renderer;  //!< GL_RENDERER string the preset was measured on
+    int frames = 0;        //!< Frames measured (0 means no record)
+    double cpu_ms = 0.0;
+    double gpu_ms = -1.0;
+    double cpu_p95_ms = 0.0;
+    double gpu_p95_ms = -1.0;
+    std::string measured_at;
+
+    /**
+     * @brief The slower of the CPU and GPU 95th percentiles
+     */
+    double getCostMs() const {
+        return std::max(cpu_p95_ms, gpu_p95_ms);
+    }
+};
+
+/**
+ * @brief SQLite store of per-preset render costs, keyed by preset path and renderer
+ */
+class PresetCostDatabase : public AutoVibez::Utils::ErrorHandler {
+public:
+    explicit PresetCostDatabase(const std::string& db_path);
+    explicit PresetCostDatabase(std::shared_ptr<IDatabaseConnection> connection);
+
+    /**
+     * @brief Open the database and create its table
+     * @return True if successful, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Fold a new measurement into the stored cost (frame-weighted)
+     * @param sample Measurement of one or more preset visits
+     * @return True if successful, false otherwise
+     */
+    bool recordCost(const PresetCost& sample);
+
+    /**
+     * @brief Stored cost of a preset
+     * @return The cost, with frames = 0 if the preset was never measured on this renderer
+     */
+    PresetCost getCost(const std::string& path, const std::string& renderer);
+
+    /**
+     * @brief All presets measured on a renderer
+     */
+    std::vector<PresetCost> getCosts(const std::string& renderer);
+
+    /**
+     * @brief The most expensive presets on any renderer, slowest first
+     * @param limit Maximum number of presets to return
+     */
+    std::vector<PresetCost> getMostExpensive(int limit);
+
+private:
+    std::vector<PresetCost> executeQuery(const std::string& sql, const std::string& text, int limit);
+
+    std::shared_ptr<IDatabaseConnection> connection_;
+};
+
+}  // namespace AutoVibez::Data
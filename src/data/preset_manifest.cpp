@@ -0,0 +1,270 @@
+#include "preset_manifest.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "string_utils.hpp"
+
+namespace AutoVibez::Data {
+
+using AutoVibez::Utils::StringUtils;
+
+namespace {
+constexpr const char* MANIFEST_VERSION = "presetmanifest1";
+
+bool statTime(const std::filesystem::path& path, int64_t& mtime) {
+    std::error_code error;
+    auto written = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(written.time_since_epoch().count());
+    return true;
+}
+
+std::string getChildPrefix(const std::string& directory) {
+    return (std::filesystem::path(directory) / "").string();
+}
+}  // namespace
+
+bool PresetManifest::isPresetFile(const std::string& path) {
+    const std::string extension = StringUtils::toLower(std::filesystem::path(path).extension().string());
+    return extension == ".milk" || extension == ".prjm";
+}
+
+bool PresetManifest::load(const std::string& file_path, const std::string& root) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != MANIFEST_VERSION || !std::getline(file, line)) {
+        return false;
+    }
+    std::vector<std::string> fields = StringUtils::splitFields(line, '\t');
+    if (fields.size() != 2 || fields[0] != "R" || StringUtils::unescapeField(fields[1]) != root) {
+        return false;
+    }
+
+    std::map<std::string, Directory> directories;
+    std::map<std::string, PresetManifestEntry> presets;
+    while (std::getline(file, line)) {
+        fields = StringUtils::splitFields(line, '\t');
+        try {
+            if (fields.size() == 3 && fields[0] == "D") {
+                directories[StringUtils::unescapeField(fields[1])].mtime = std::stoll(fields[2]);
+            } else if (fields.size() == 6 && fields[0] == "P") {
+                PresetManifestEntry entry;
+                entry.path = StringUtils::unescapeField(fields[1]);
+                entry.size = std::stoull(fields[2]);
+                entry.mtime = std::stoll(fields[3]);
+                entry.name = StringUtils::unescapeField(fields[4]);
+                entry.cost_ms = std::stod(fields[5]);
+                presets[entry.path] = std::move(entry);
+            } else {
+                return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    // Subdirectory lists follow from the directories' parents
+    for (auto& [path, directory] : directories) {
+        if (path == root) {
+            continue;
+        }
+        auto parent = directories.find(std::filesystem::path(path).parent_path().string());
+        if (parent != directories.end()) {
+            parent->second.subdirectories.push_back(path);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _root = root;
+    _directories = std::move(directories);
+    _presets = std::move(presets);
+    return true;
+}
+
+bool PresetManifest::save(const std::string& file_path) const {
+    std::error_code error;
+    auto parent = std::filesystem::path(file_path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Written beside the target and renamed so a crash never leaves a half-written manifest
+    const std::string temp_path = file_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.precision(17);
+        file << MANIFEST_VERSION << '\n';
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        file << "R\t" << StringUtils::escapeField(_root) << '\n';
+        for (const auto& [path, directory] : _directories) {
+            file << "D\t" << StringUtils::escapeField(path) << '\t' << directory.mtime << '\n';
+        }
+        for (const auto& [path, entry] : _presets) {
+            file << "P\t" << StringUtils::escapeField(path) << '\t' << entry.size << '\t' << entry.mtime << '\t'
+                 << StringUtils::escapeField(entry.name) << '\t' << entry.cost_ms << '\n';
+        }
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, file_path, error);
+    return !error;
+}
+
+PresetManifestChanges PresetManifest::rescan(const std::string& root) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    PresetManifestChanges changes;
+    if (root != _root) {
+        for (const auto& [path, entry] : _presets) {
+            changes.removed.push_back(path);
+        }
+        _presets.clear();
+        _directories.clear();
+        _root = root;
+    }
+
+    std::map<std::string, Directory> seen;
+    scanDirectory(root, seen, changes);
+    for (const auto& [path, directory] : _directories) {
+        if (seen.find(path) == seen.end()) {
+            forgetDirectory(path, changes);
+        }
+    }
+    _directories = std::move(seen);
+    return changes;
+}
+
+void PresetManifest::scanDirectory(const std::string& directory, std::map<std::string, Directory>& seen,
+                                   PresetManifestChanges& changes) {
+    int64_t mtime = 0;
+    if (seen.find(directory) != seen.end() || !statTime(directory, mtime)) {
+        return;
+    }
+
+    // An untouched directory has the same entries: walk on into the subdirectories it had
+    auto known = _directories.find(directory);
+    if (known != _directories.end() && known->second.mtime == mtime) {
+        const Directory& unchanged = seen[directory] = known->second;
+        for (const std::string& subdirectory : unchanged.subdirectories) {
+            scanDirectory(subdirectory, seen, changes);
+        }
+        return;
+    }
+
+    Directory listed;
+    listed.mtime = mtime;
+    std::vector<std::string> present;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(
+             directory, std::filesystem::directory_options::skip_permission_denied, error)) {
+        std::error_code itemError;
+        const std::string path = item.path().string();
+        if (item.is_directory(itemError) && !item.is_symlink(itemError)) {
+            listed.subdirectories.push_back(path);
+            continue;
+        }
+        if (!isPresetFile(path) || !item.is_regular_file(itemError)) {
+            continue;
+        }
+        const uintmax_t size = item.file_size(itemError);
+        int64_t fileTime = 0;
+        if (itemError || !statTime(item.path(), fileTime)) {
+            continue;
+        }
+        present.push_back(path);
+
+        auto existing = _presets.find(path);
+        if (existing == _presets.end()) {
+            PresetManifestEntry entry;
+            entry.path = path;
+            entry.size = size;
+            entry.mtime = fileTime;
+            entry.name = item.path().stem().string();
+            _presets[path] = std::move(entry);
+            changes.added.push_back(path);
+        } else if (existing->second.size != size || existing->second.mtime != fileTime) {
+            // A rewritten preset has to be measured again
+            existing->second.size = size;
+            existing->second.mtime = fileTime;
+            existing->second.cost_ms = -1.0;
+        }
+    }
+
+    // Presets of this directory that were not listed are gone
+    std::sort(present.begin(), present.end());
+    const std::string prefix = getChildPrefix(directory);
+    for (auto it = _presets.lower_bound(prefix); it != _presets.end() && StringUtils::startsWith(it->first, prefix);) {
+        const bool direct = std::filesystem::path(it->first).parent_path().string() == directory;
+        if (direct && !std::binary_search(present.begin(), present.end(), it->first)) {
+            changes.removed.push_back(it->first);
+            it = _presets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const Directory& stored = seen[directory] = std::move(listed);
+    for (const std::string& subdirectory : stored.subdirectories) {
+        scanDirectory(subdirectory, seen, changes);
+    }
+}
+
+void PresetManifest::forgetDirectory(const std::string& directory, PresetManifestChanges& changes) {
+    const std::string prefix = getChildPrefix(directory);
+    for (auto it = _presets.lower_bound(prefix); it != _presets.end() && StringUtils::startsWith(it->first, prefix);) {
+        if (std::filesystem::path(it->first).parent_path().string() == directory) {
+            changes.removed.push_back(it->first);
+            it = _presets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::vector<std::string> PresetManifest::getPaths() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<std::string> paths;
+    paths.reserve(_presets.size());
+    for (const auto& [path, entry] : _presets) {
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+bool PresetManifest::find(const std::string& path, PresetManifestEntry& entry) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _presets.find(path);
+    if (it == _presets.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+void PresetManifest::setCost(const std::string& path, double cost_ms) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _presets.find(path);
+    if (it != _presets.end()) {
+        it->second.cost_ms = cost_ms;
+    }
+}
+
+size_t PresetManifest::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _presets.size();
+}
+
+}  // namespace AutoVibez::Data
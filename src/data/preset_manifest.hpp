@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief One preset file as the manifest knows it
+ */
+struct PresetManifestEntry {
+    std::string path;  //!< Full path, as the playlist holds it
+    uintmax_t size = 0;
+    int64_t mtime = 0;
+    std::string name;       //!< Display name (file name without extension)
+    double cost_ms = -1.0;  //!< Last measured render cost on this machine, -1 if never measured
+};
+
+/**
+ * @brief Presets added and removed by a rescan
+ */
+struct PresetManifestChanges {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+
+    bool empty() const {
+        return added.empty() && removed.empty();
+    }
+};
+
+/**
+ * @brief Thread-safe list of every preset under a directory, persisted between runs
+ *
+ * Startup fills the playlist from the saved manifest instead of walking the preset tree.
+ * A rescan then validates it by directory mtimes: adding, removing or renaming an entry
+ * touches its directory, so unchanged directories are skipped without being listed and
+ * their known subdirectories are visited from the manifest. Only changed directories are
+ * read and their presets stat'ed. Files are .milk or .prjm, as projectM's playlist takes.
+ */
+class PresetManifest {
+public:
+    /**
+     * @brief Replace the contents with a file written by save()
+     * @param root Preset directory the manifest must describe
+     * @return True if successful, false if the file is missing, malformed or for another root
+     */
+    bool load(const std::string& file_path, const std::string& root);
+
+    /**
+     * @brief Write the manifest to a file (atomically, through a rename)
+     */
+    bool save(const std::string& file_path) const;
+
+    /**
+     * @brief Bring the manifest up to date with the tree under root
+     * @return Presets that appeared or disappeared since the last scan
+     */
+    PresetManifestChanges rescan(const std::string& root);
+
+    /**
+     * @brief Every preset path, sorted
+     */
+    std::vector<std::string> getPaths() const;
+
+    /**
+     * @brief Entry for a preset
+     * @return False if the preset is not in the manifest
+     */
+    bool find(const std::string& path, PresetManifestEntry& entry) const;
+
+    /**
+     * @brief Remember a preset's measured render cost (kept until the file changes)
+     */
+    void setCost(const std::string& path, double cost_ms);
+
+    size_t size() const;
+
+    /**
+     * @brief Whether a file name has a preset extension
+     */
+    static bool isPresetFile(const std::string& path);
+
+private:
+    struct Directory {
+        int64_t mtime = 0;
+        std::vector<std::string> subdirectories;
+    };
+
+    void scanDirectory(const std::string& directory, std::map<std::string, Directory>& seen,
+                       PresetManifestChanges& changes);
+    void forgetDirectory(const std::string& directory, PresetManifestChanges& changes);
+
+    mutable std::mutex _mutex;
+    std::string _root;
+    std::map<std::string, Directory> _directories;
+    std::map<std::string, PresetManifestEntry> _presets;
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,110 @@
+#include "resume_state.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "string_utils.hpp"
+
+namespace AutoVibez::Data {
+
+using AutoVibez::Utils::StringUtils;
+
+namespace {
+constexpr const char* RESUME_VERSION = "resume1";
+}  // namespace
+
+std::string ResumeState::encode() const {
+    std::ostringstream out;
+    out.precision(17);
+    out << RESUME_VERSION << '\n';
+    out << "mix\t" << StringUtils::escapeField(mix.id) << '\t' << StringUtils::escapeField(mix.title) << '\t'
+        << StringUtils::escapeField(mix.artist) << '\t' << StringUtils::escapeField(mix.genre) << '\t'
+        << mix.duration_seconds << '\t' << (mix.is_favorite ? 1 : 0) << '\t'
+        << StringUtils::escapeField(mix.local_path) << '\n';
+    out << "position\t" << position_seconds << '\t' << (paused ? 1 : 0) << '\n';
+    out << "gain\t" << gain_db << '\n';
+    out << "seek\t" << StringUtils::escapeField(seek_index) << '\n';
+    out << "genre\t" << StringUtils::escapeField(genre) << '\n';
+    out << "volume\t" << volume << '\n';
+    for (const std::string& id : queue) {
+        out << "queue\t" << StringUtils::escapeField(id) << '\n';
+    }
+    return out.str();
+}
+
+bool ResumeState::parse(const std::string& text, ResumeState& state) {
+    state = ResumeState();
+    std::istringstream in(text);
+    std::string line;
+    if (!std::getline(in, line) || line != RESUME_VERSION) {
+        return false;
+    }
+    while (std::getline(in, line)) {
+        const std::vector<std::string> fields = StringUtils::splitFields(line, '\t');
+        try {
+            if (fields.size() == 8 && fields[0] == "mix") {
+                state.mix.id = StringUtils::unescapeField(fields[1]);
+                state.mix.title = StringUtils::unescapeField(fields[2]);
+                state.mix.artist = StringUtils::unescapeField(fields[3]);
+                state.mix.genre = StringUtils::unescapeField(fields[4]);
+                state.mix.duration_seconds = std::stoi(fields[5]);
+                state.mix.is_favorite = fields[6] == "1";
+                state.mix.local_path = StringUtils::unescapeField(fields[7]);
+            } else if (fields.size() == 3 && fields[0] == "position") {
+                state.position_seconds = std::stoi(fields[1]);
+                state.paused = fields[2] == "1";
+            } else if (fields.size() == 2 && fields[0] == "gain") {
+                state.gain_db = std::stod(fields[1]);
+            } else if (fields.size() == 2 && fields[0] == "seek") {
+                state.seek_index = StringUtils::unescapeField(fields[1]);
+            } else if (fields.size() == 2 && fields[0] == "genre") {
+                state.genre = StringUtils::unescapeField(fields[1]);
+            } else if (fields.size() == 2 && fields[0] == "volume") {
+                state.volume = std::stoi(fields[1]);
+            } else if (fields.size() == 2 && fields[0] == "queue") {
+                state.queue.push_back(StringUtils::unescapeField(fields[1]));
+            } else {
+                return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !state.mix.id.empty() && !state.mix.local_path.empty();
+}
+
+bool ResumeState::save(const std::string& path) const {
+    std::error_code error;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Written beside the target and renamed so a crash never leaves a half-written record
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << encode();
+        if (!file) {
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+bool ResumeState::load(const std::string& path, ResumeState& state) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return parse(text.str(), state);
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief What was playing, kept on disk so a restart after a crash or power cut carries on from it
+ *
+ * Holds everything needed to reopen the mix without the database: its file, the
+ * loudness gain it played with and its serialized seek index, so the player lands on
+ * the saved position directly while the catalog is still loading. The file is a few
+ * tab-separated lines after a version line, written beside the target and renamed over
+ * it, so a crash mid-write leaves the previous record intact.
+ */
+struct ResumeState {
+    Mix mix;  // Id, title, artist, genre, duration, favorite flag and local_path
+    int position_seconds = 0;
+    bool paused = false;
+    double gain_db = 0.0;    // Loudness gain the mix played with, 0 without normalization
+    std::string seek_index;  // SeekIndex::serialize() of the file, empty without one
+    std::string genre;       // Preferred genre
+    int volume = Constants::MAX_VOLUME;
+    std::vector<std::string> queue;  // Ids of the queued mixes, next first
+
+    std::string encode() const;
+
+    /**
+     * @brief Read a record as encode() writes it
+     * @return False for another version, a malformed line or a record without a mix file
+     */
+    static bool parse(const std::string& text, ResumeState& state);
+
+    /**
+     * @brief Write the record atomically, through a rename
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @return False if the file is missing or parse() turns it down
+     */
+    static bool load(const std::string& path, ResumeState& state);
+};
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,70 @@
+#include "schema_migrator.hpp"
+
+#include <utility>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Data {
+
+SchemaMigrator::SchemaMigrator(std::shared_ptr<IDatabaseConnection> connection) : connection_(std::move(connection)) {}
+
+void SchemaMigrator::addStep(int version, const std::string& name, Apply apply) {
+    steps_.push_back({version, name, std::move(apply)});
+}
+
+int SchemaMigrator::getLatestVersion() const {
+    return steps_.empty() ? 0 : steps_.back().version;
+}
+
+int SchemaMigrator::getCurrentVersion() const {
+    auto stmt = connection_->prepare(StringConstants::SELECT_USER_VERSION);
+    if (!stmt || !stmt->step()) {
+        return -1;
+    }
+    return stmt->getInt(0);
+}
+
+bool SchemaMigrator::migrate() {
+    applied_count_ = 0;
+    const int current = getCurrentVersion();
+    if (current < 0) {
+        return fail("Failed to read schema version: " + connection_->getLastError());
+    }
+    if (current >= getLatestVersion()) {
+        return true;
+    }
+
+    if (!connection_->beginTransaction()) {
+        return fail("Failed to begin transaction: " + connection_->getLastError());
+    }
+    int applied = 0;
+    for (const Step& step : steps_) {
+        if (step.version <= current) {
+            continue;
+        }
+        if (!step.apply(*connection_)) {
+            const std::string error = connection_->getLastError();
+            connection_->rollbackTransaction();
+            return fail("Schema migration to version " + std::to_string(step.version) + " (" + step.name +
+                        ") failed: " + error);
+        }
+        applied++;
+    }
+
+    // The pragma takes no placeholder; the version is ours, not input
+    if (!connection_->execute("PRAGMA user_version = " + std::to_string(getLatestVersion())) ||
+        !connection_->commitTransaction()) {
+        const std::string error = connection_->getLastError();
+        connection_->rollbackTransaction();
+        return fail("Failed to commit schema migration: " + error);
+    }
+    applied_count_ = applied;
+    return true;
+}
+
+bool SchemaMigrator::fail(const std::string& error) {
+    last_error_ = error;
+    return false;
+}
+
+}  // namespace AutoVibez::Data
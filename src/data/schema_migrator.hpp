@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "database_interfaces.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Ordered schema steps keyed on PRAGMA user_version
+ *
+ * Each step brings the schema from the version before it to its own. migrate
+ * reads the stored version and applies every step above it in one transaction,
+ * together with the new version, so a library is either fully upgraded or left
+ * as it was. When the schema is current the pragma read is all startup costs.
+ *
+ * Libraries from before versioning read as version 0 and get every step, so a
+ * step must tolerate a schema that already has its changes.
+ */
+class SchemaMigrator {
+public:
+    using Apply = std::function<bool(IDatabaseConnection& connection)>;
+
+    explicit SchemaMigrator(std::shared_ptr<IDatabaseConnection> connection);
+
+    /**
+     * @brief Register the step that brings the schema to a version
+     * @param version Must be above the version of the step added before
+     * @param name For error messages
+     * @param apply Returns false to abandon the whole migration
+     */
+    void addStep(int version, const std::string& name, Apply apply);
+
+    /**
+     * @return Version of the last step added, 0 if there are none
+     */
+    int getLatestVersion() const;
+
+    /**
+     * @return The stored user_version, -1 if it cannot be read
+     */
+    int getCurrentVersion() const;
+
+    /**
+     * @brief Apply the steps the database has not seen yet
+     *
+     * A database at a newer version than any step, written by a later build, is
+     * left alone.
+     * @return True if the schema is at or above the latest version
+     */
+    bool migrate();
+
+    /**
+     * @return Steps applied by the last migrate, 0 when the schema was current
+     */
+    int getAppliedCount() const {
+        return applied_count_;
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    struct Step {
+        int version;
+        std::string name;
+        Apply apply;
+    };
+
+    std::shared_ptr<IDatabaseConnection> connection_;
+    std::vector<Step> steps_;
+    int applied_count_ = 0;
+    std::string last_error_;
+
+    bool fail(const std::string& error);
+};
+
+}  // namespace AutoVibez::Data
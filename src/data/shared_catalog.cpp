@@ -0,0 +1,397 @@
+#include "shared_catalog.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr char MAGIC[8] = {'A', 'V', 'C', 'A', 'T', 'L', 'G', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t CONTROL_BYTES = 64;  // The counters, padded to a cache line
+
+size_t alignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+}  // namespace
+
+struct SharedCatalog::Control {
+    std::atomic<uint64_t> generation;  // Of the version last published
+    std::atomic<uint64_t> writes;
+};
+
+struct SharedCatalog::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t generation;
+    uint32_t mix_count;
+    uint32_t tag_count;
+    uint64_t records_offset;
+    uint64_t tags_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+};
+
+struct SharedCatalog::Record {
+    enum Field { Id, Title, Url, LocalPath, Description, OriginalFilename, Genre, Artist, FIELD_COUNT };
+
+    StringRef fields[FIELD_COUNT];
+    int64_t date_added_ms;
+    int64_t last_played_ms;
+    double loudness_lufs;
+    double peak_dbfs;
+    double bpm;
+    double spectral_centroid_hz;
+    int32_t duration_seconds;
+    int32_t play_count;
+    uint32_t first_tag;  // Into the tag references
+    uint32_t tag_count;
+    uint8_t is_favorite;
+    uint8_t has_analysis;
+    uint8_t reserved[6];
+};
+
+SharedCatalog::~SharedCatalog() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool SharedCatalog::open(const std::string& path) {
+    (void)path;
+    setError("The shared catalog is not supported on this platform");
+    return false;
+}
+
+void SharedCatalog::close() {
+    file_.close();
+}
+
+bool SharedCatalog::claimPublisher() {
+    return false;
+}
+
+#else
+
+bool SharedCatalog::open(const std::string& path) {
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && sizeof(Control) <= CONTROL_BYTES,
+                  "the counters are shared between processes");
+    close();
+    clearError();
+    path_ = path;
+
+    std::error_code error;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    const std::string control_path = path + ".gen";
+    control_fd_ = ::open(control_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (control_fd_ < 0) {
+        setError("Failed to open " + control_path + ": " + std::strerror(errno));
+        return false;
+    }
+    // Only ever grown, so an instance that got here first keeps its count
+    struct stat status {};
+    if (fstat(control_fd_, &status) != 0 ||
+        (status.st_size < static_cast<off_t>(CONTROL_BYTES) && ftruncate(control_fd_, CONTROL_BYTES) != 0)) {
+        setError("Failed to size " + control_path + ": " + std::strerror(errno));
+        close();
+        return false;
+    }
+    void* control = mmap(nullptr, CONTROL_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, control_fd_, 0);
+    if (control == MAP_FAILED) {
+        setError("Failed to map " + control_path + ": " + std::strerror(errno));
+        close();
+        return false;
+    }
+    control_ = static_cast<Control*>(control);
+
+    refresh();
+    return true;
+}
+
+void SharedCatalog::close() {
+    file_.close();
+    if (control_) {
+        munmap(control_, CONTROL_BYTES);
+        control_ = nullptr;
+    }
+    if (control_fd_ >= 0) {
+        ::close(control_fd_);  // Drops the publisher's lock
+        control_fd_ = -1;
+    }
+    publisher_ = false;
+    seen_ = 0;
+}
+
+bool SharedCatalog::claimPublisher() {
+    if (!publisher_ && control_fd_ >= 0) {
+        publisher_ = flock(control_fd_, LOCK_EX | LOCK_NB) == 0;
+    }
+    return publisher_;
+}
+
+#endif
+
+bool SharedCatalog::publish(const MixCatalogSnapshot& snapshot) {
+    static_assert(std::is_trivially_copyable<Header>::value && std::is_trivially_copyable<Record>::value,
+                  "catalog structs are copied as bytes");
+    if (!publisher_) {
+        setError("Only the publisher writes the shared catalog");
+        return false;
+    }
+
+    // Genres, artists and tags repeat across the library, so each is stored once; the rest is unique
+    std::string strings;
+    std::unordered_map<std::string_view, StringRef> interned;
+    auto append = [&strings](std::string_view value) {
+        const StringRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+        strings.append(value.data(), value.size());
+        return ref;
+    };
+    auto intern = [&](const std::string& value) {  // Pool strings outlive the map
+        auto it = interned.find(value);
+        if (it == interned.end()) {
+            it = interned.emplace(value, append(value)).first;
+        }
+        return it->second;
+    };
+
+    std::vector<Record> records;
+    std::vector<StringRef> tags;
+    records.reserve(snapshot.size());
+    const MixStringPool& pool = *snapshot.strings();
+    for (const auto& entry : snapshot.entries()) {
+        const MixRecord& mix = *entry;
+        Record record{};
+        record.fields[Record::Id] = append(mix.id());
+        record.fields[Record::Title] = append(mix.title());
+        record.fields[Record::Url] = append(mix.url());
+        record.fields[Record::LocalPath] = append(mix.localPath());
+        record.fields[Record::Description] = append(mix.description());
+        record.fields[Record::OriginalFilename] = append(mix.field(MixRecord::OriginalFilename));
+        record.fields[Record::Genre] = intern(pool.get(mix.genre));
+        record.fields[Record::Artist] = intern(pool.get(mix.artist));
+        record.date_added_ms = mix.date_added_ms;
+        record.last_played_ms = mix.last_played_ms;
+        record.loudness_lufs = mix.loudness_lufs;
+        record.peak_dbfs = mix.peak_dbfs;
+        record.bpm = mix.bpm;
+        record.spectral_centroid_hz = mix.spectral_centroid_hz;
+        record.duration_seconds = mix.duration_seconds;
+        record.play_count = mix.play_count;
+        record.first_tag = static_cast<uint32_t>(tags.size());
+        record.tag_count = static_cast<uint32_t>(mix.tags.size());
+        record.is_favorite = mix.is_favorite ? 1 : 0;
+        record.has_analysis = mix.has_analysis ? 1 : 0;
+        for (uint32_t tag : mix.tags) {
+            tags.push_back(intern(pool.get(tag)));
+        }
+        records.push_back(record);
+    }
+
+    const uint64_t generation = control_->generation.load(std::memory_order_acquire) + 1;
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.generation = generation;
+    header.mix_count = static_cast<uint32_t>(records.size());
+    header.tag_count = static_cast<uint32_t>(tags.size());
+    header.records_offset = alignUp(sizeof(Header));
+    header.tags_offset = alignUp(header.records_offset + records.size() * sizeof(Record));
+    header.strings_offset = alignUp(header.tags_offset + tags.size() * sizeof(StringRef));
+    header.strings_size = strings.size();
+
+    std::string image(header.strings_offset + strings.size(), '\0');
+    auto place = [&image](uint64_t offset, const void* data, size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(&image[offset], data, bytes);
+        }
+    };
+    place(0, &header, sizeof(header));
+    place(header.records_offset, records.data(), records.size() * sizeof(Record));
+    place(header.tags_offset, tags.data(), tags.size() * sizeof(StringRef));
+    place(header.strings_offset, strings.data(), strings.size());
+
+    // Renamed into place before the count moves, so whoever sees the new count finds the new file
+    const std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(image.data(), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            setError("Failed to write " + temp_path);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path_, error);
+    if (error) {
+        setError("Failed to replace " + path_ + ": " + error.message());
+        return false;
+    }
+    control_->generation.store(generation, std::memory_order_release);
+    return true;
+}
+
+uint64_t SharedCatalog::getPublishedGeneration() const {
+    return control_ ? control_->generation.load(std::memory_order_acquire) : 0;
+}
+
+bool SharedCatalog::hasNewer() const {
+    return getPublishedGeneration() != seen_;
+}
+
+void SharedCatalog::noteWrite() {
+    if (control_) {
+        control_->writes.fetch_add(1, std::memory_order_release);
+    }
+}
+
+uint64_t SharedCatalog::getWriteCount() const {
+    return control_ ? control_->writes.load(std::memory_order_acquire) : 0;
+}
+
+bool SharedCatalog::refresh() {
+    if (!hasNewer()) {
+        return false;
+    }
+    // A damaged version is tried once, not on every call until the next one
+    seen_ = getPublishedGeneration();
+    return map();
+}
+
+bool SharedCatalog::map() {
+    file_.close();
+    if (!file_.open(path_)) {
+        setError(file_.getLastError());
+        return false;
+    }
+
+    auto reject = [this](const std::string& reason) {
+        setError("Invalid shared catalog: " + reason);
+        file_.close();
+        return false;
+    };
+    const uint64_t size = file_.size();
+    if (size < sizeof(Header)) {
+        return reject("too short");
+    }
+    const Header* head = header();
+    if (std::memcmp(head->magic, MAGIC, sizeof(MAGIC)) != 0 || head->byte_order != BYTE_ORDER_MARK) {
+        return reject("not a catalog of this machine's format");
+    }
+    if (head->version != VERSION) {
+        return reject("version " + std::to_string(head->version));
+    }
+
+    // Every section inside the file and aligned for in-place reads; offsets first, so the sums can't wrap
+    const bool sections_fit = head->records_offset <= size && head->tags_offset <= size &&
+                              head->records_offset % 8 == 0 && head->tags_offset % 8 == 0 &&
+                              head->records_offset + uint64_t{head->mix_count} * sizeof(Record) <= size &&
+                              head->tags_offset + uint64_t{head->tag_count} * sizeof(StringRef) <= size &&
+                              head->strings_offset <= size && head->strings_size <= size - head->strings_offset;
+    if (!sections_fit) {
+        return reject("damaged header");
+    }
+
+    // Checked once here, so readers index without checks
+    const auto* tags = reinterpret_cast<const StringRef*>(file_.data() + head->tags_offset);
+    for (uint32_t i = 0; i < head->tag_count; ++i) {
+        if (!validRef(tags[i])) {
+            return reject("damaged tag");
+        }
+    }
+    const Record* all = records();
+    for (uint32_t i = 0; i < head->mix_count; ++i) {
+        const Record& record = all[i];
+        for (const StringRef& field : record.fields) {
+            if (!validRef(field)) {
+                return reject("damaged mix");
+            }
+        }
+        if (uint64_t{record.first_tag} + record.tag_count > head->tag_count) {
+            return reject("damaged mix");
+        }
+    }
+    return true;
+}
+
+uint64_t SharedCatalog::getGeneration() const {
+    return isMapped() ? header()->generation : 0;
+}
+
+size_t SharedCatalog::size() const {
+    return isMapped() ? header()->mix_count : 0;
+}
+
+Mix SharedCatalog::mixAt(size_t index) const {
+    const Record& record = records()[index];
+    Mix mix;
+    mix.id = std::string(text(record.fields[Record::Id]));
+    mix.title = std::string(text(record.fields[Record::Title]));
+    mix.url = std::string(text(record.fields[Record::Url]));
+    mix.local_path = std::string(text(record.fields[Record::LocalPath]));
+    mix.description = std::string(text(record.fields[Record::Description]));
+    mix.original_filename = std::string(text(record.fields[Record::OriginalFilename]));
+    mix.genre = std::string(text(record.fields[Record::Genre]));
+    mix.artist = std::string(text(record.fields[Record::Artist]));
+    mix.date_added_ms = record.date_added_ms;
+    mix.last_played_ms = record.last_played_ms;
+    mix.loudness_lufs = record.loudness_lufs;
+    mix.peak_dbfs = record.peak_dbfs;
+    mix.bpm = record.bpm;
+    mix.spectral_centroid_hz = record.spectral_centroid_hz;
+    mix.duration_seconds = record.duration_seconds;
+    mix.play_count = record.play_count;
+    mix.is_favorite = record.is_favorite != 0;
+    mix.has_analysis = record.has_analysis != 0;
+    const auto* tags = reinterpret_cast<const StringRef*>(file_.data() + header()->tags_offset);
+    mix.tags.reserve(record.tag_count);
+    for (uint32_t i = 0; i < record.tag_count; ++i) {
+        mix.tags.emplace_back(text(tags[record.first_tag + i]));
+    }
+    return mix;
+}
+
+void SharedCatalog::load(MixCatalogBuilder& builder) const {
+    for (size_t i = 0; i < size(); ++i) {
+        builder.add(mixAt(i));
+    }
+}
+
+const SharedCatalog::Header* SharedCatalog::header() const {
+    return reinterpret_cast<const Header*>(file_.data());
+}
+
+const SharedCatalog::Record* SharedCatalog::records() const {
+    return reinterpret_cast<const Record*>(file_.data() + header()->records_offset);
+}
+
+std::string_view SharedCatalog::text(const StringRef& ref) const {
+    return std::string_view(reinterpret_cast<const char*>(file_.data() + header()->strings_offset) + ref.offset,
+                            ref.length);
+}
+
+bool SharedCatalog::validRef(const StringRef& ref) const {
+    return uint64_t{ref.offset} + ref.length <= header()->strings_size;
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "error_handler.hpp"
+#include "mapped_file.hpp"
+#include "mix_catalog.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief The library catalog in a flat binary file that every instance on the host maps read-only
+ *
+ * One instance, the publisher, holds an exclusive lock on a small control file beside
+ * the catalog and writes each new version of its catalog there: the file is a header,
+ * fixed-size records, tag references and one string table, laid out as ManifestSnapshot's.
+ * The control file holds two counters shared through a writable mapping. The publisher
+ * renames each new version into place and then bumps the generation, so other instances
+ * notice it with one atomic load and map it, with no SQL read of the library. The others
+ * bump the write count after writing to the library, for the publisher to read it again.
+ * A mapping stays readable after the file is replaced, so a version in use is never torn.
+ * Written in the host's byte order; the version and a byte order mark reject any other
+ * file. POSIX only: open() fails on Windows.
+ */
+class SharedCatalog : public AutoVibez::Utils::ErrorHandler {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    SharedCatalog() = default;
+
+    /**
+     * @brief Unmaps both files; the publisher lock goes with the control file
+     */
+    ~SharedCatalog() override;
+
+    SharedCatalog(const SharedCatalog&) = delete;
+    SharedCatalog& operator=(const SharedCatalog&) = delete;
+
+    /**
+     * @brief Map the control file, creating it if needed, and whatever version is published
+     * @return False if the control file could not be set up; no published version is not an error
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    /**
+     * @brief Take the publisher's lock if no other instance holds it; never blocks
+     * @return True if this instance is the publisher, now or from before
+     */
+    bool claimPublisher();
+
+    bool isPublisher() const {
+        return publisher_;
+    }
+
+    /**
+     * @brief Publisher: write the snapshot as the next version and tell the other instances
+     */
+    bool publish(const MixCatalogSnapshot& snapshot);
+
+    /**
+     * @brief Map the latest version if it is not the one mapped already
+     * @return True if another version is now mapped
+     */
+    bool refresh();
+
+    /**
+     * @brief Whether a version is published that is not the one mapped
+     */
+    bool hasNewer() const;
+
+    /**
+     * @brief Version of the mapped catalog, 0 with none mapped
+     */
+    uint64_t getGeneration() const;
+
+    /**
+     * @brief Version last published by any instance, 0 before the first
+     */
+    uint64_t getPublishedGeneration() const;
+
+    /**
+     * @brief Tell the publisher this instance wrote to the library; from any thread
+     */
+    void noteWrite();
+
+    /**
+     * @brief Writes noted by every instance so far
+     */
+    uint64_t getWriteCount() const;
+
+    bool isMapped() const {
+        return file_.isOpen();
+    }
+
+    size_t size() const;
+
+    Mix mixAt(size_t index) const;
+
+    /**
+     * @brief Add every mix of the mapped catalog to builder
+     */
+    void load(MixCatalogBuilder& builder) const;
+
+private:
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Control;
+    struct Header;
+    struct Record;
+
+    bool map();
+    const Header* header() const;
+    const Record* records() const;
+    std::string_view text(const StringRef& ref) const;
+    bool validRef(const StringRef& ref) const;
+
+    std::string path_;
+    AutoVibez::Utils::MappedFile file_;
+    int control_fd_ = -1;
+    Control* control_ = nullptr;  // The control file's shared mapping
+    uint64_t seen_ = 0;           // Published version last mapped, or tried and found damaged
+    bool publisher_ = false;
+};
+
+}  // namespace AutoVibez::Data
@@ -1,10 +1,12 @@
 #include "smart_mix_selector.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <tuple>
 
 #include "constants.hpp"
-#include "json_utils.hpp"
+#include "mix_row_mapper.hpp"
 
 namespace AutoVibez {
 namespace Data {
@@ -22,6 +24,14 @@ Mix SmartMixSelector::getSmartRandomMix(const std::string& exclude_mix_id, const
         return Mix();
     }
 
+    if (index_) {
+        bool found = false;
+        Mix mix = getSmartRandomMixFromIndex(exclude_mix_id, preferred_genre, found);
+        if (found) {
+            return mix;
+        }
+    }
+
     // Get counts for decision making
     SelectionCriteria criteria;
     criteria.exclude_mix_id = exclude_mix_id;
@@ -47,14 +57,7 @@ Mix SmartMixSelector::getSmartRandomMix(const std::string& exclude_mix_id, const
         SelectionCriteria genre_criteria = criteria;
         genre_criteria.genre = preferred_genre;
 
-        std::string query = buildSmartSelectionQuery(genre_criteria);
-        std::vector<std::string> params;
-        params.push_back(preferred_genre);
-        if (!exclude_mix_id.empty()) {
-            params.push_back(exclude_mix_id);
-        }
-
-        Mix result = executeSingleMixQuery(query, params);
+        Mix result = selectSmart(genre_criteria);
         if (!result.id.empty()) {
             return result;
         }
@@ -65,26 +68,14 @@ Mix SmartMixSelector::getSmartRandomMix(const std::string& exclude_mix_id, const
         SelectionCriteria fav_criteria = criteria;
         fav_criteria.favorites_only = true;
 
-        std::string query = buildSmartSelectionQuery(fav_criteria);
-        std::vector<std::string> params;
-        if (!exclude_mix_id.empty()) {
-            params.push_back(exclude_mix_id);
-        }
-
-        Mix result = executeSingleMixQuery(query, params);
+        Mix result = selectSmart(fav_criteria);
         if (!result.id.empty()) {
             return result;
         }
     }
 
     // Fallback to any downloaded mix
-    std::string query = buildSmartSelectionQuery(criteria);
-    std::vector<std::string> params;
-    if (!exclude_mix_id.empty()) {
-        params.push_back(exclude_mix_id);
-    }
-
-    Mix result = executeSingleMixQuery(query, params);
+    Mix result = selectSmart(criteria);
     if (!result.id.empty()) {
         return result;
     }
@@ -94,6 +85,15 @@ Mix SmartMixSelector::getSmartRandomMix(const std::string& exclude_mix_id, const
 }
 
 Mix SmartMixSelector::getRandomMix(const std::string& exclude_mix_id) {
+    if (index_) {
+        for (SelectionPool pool : {SelectionPool::Downloaded, SelectionPool::Available}) {
+            Mix mix = getIndexedMix(index_->sampleUniform(pool, "", exclude_mix_id, rng_));
+            if (!mix.id.empty()) {
+                return mix;
+            }
+        }
+    }
+
     SelectionCriteria criteria;
     criteria.exclude_mix_id = exclude_mix_id;
     criteria.downloaded_only = true;  // Try downloaded first
@@ -150,7 +150,7 @@ Mix SmartMixSelector::getNextMix(const std::string& current_mix_id) {
     if (current_mix_id.empty()) {
         query = "SELECT * FROM mixes WHERE is_deleted = 0 ORDER BY id LIMIT 1";
     } else {
-        query = "SELECT * FROM mixes WHERE id > ? AND is_deleted = 0 ORDER BY id LIMIT 1";
+        query = "SELECT * FROM mixes WHERE id > mix_key(?) AND is_deleted = 0 ORDER BY id LIMIT 1";
         params.push_back(current_mix_id);
     }
 
@@ -171,7 +171,7 @@ Mix SmartMixSelector::getPreviousMix(const std::string& current_mix_id) {
     if (current_mix_id.empty()) {
         query = "SELECT * FROM mixes WHERE is_deleted = 0 ORDER BY id DESC LIMIT 1";
     } else {
-        query = "SELECT * FROM mixes WHERE id < ? AND is_deleted = 0 ORDER BY id DESC LIMIT 1";
+        query = "SELECT * FROM mixes WHERE id < mix_key(?) AND is_deleted = 0 ORDER BY id DESC LIMIT 1";
         params.push_back(current_mix_id);
     }
 
@@ -189,6 +189,111 @@ void SmartMixSelector::setSeed(unsigned int seed) {
     rng_.seed(seed);
 }
 
+void SmartMixSelector::setIndex(std::shared_ptr<MixSelectionIndex> index) {
+    index_ = std::move(index);
+}
+
+void SmartMixSelector::setSimilarityIndex(std::shared_ptr<MixSimilarityIndex> similarity) {
+    similarity_ = std::move(similarity);
+}
+
+void SmartMixSelector::setSimilarMixProbability(int probability) {
+    config_.similar_mix_probability = std::clamp(probability, 0, 100);
+}
+
+Mix SmartMixSelector::getSmartRandomMixFromIndex(const std::string& exclude_mix_id, const std::string& preferred_genre,
+                                                 bool& found) {
+    found = false;
+    if (index_->count(SelectionPool::Downloaded, "", exclude_mix_id) == 0) {
+        return Mix();
+    }
+
+    // Same decisions as the SQL path, with the counts read from the index
+    const bool prefer_genre = !preferred_genre.empty() &&
+                              index_->count(SelectionPool::Genre, preferred_genre, exclude_mix_id) > 0 &&
+                              (getRandomPercentage() < config_.preferred_genre_probability);
+    const bool prefer_favorites = !prefer_genre && index_->count(SelectionPool::Favorites, "", exclude_mix_id) > 0 &&
+                                  (getRandomPercentage() < config_.favorite_mix_probability);
+
+    // Follow on from the mix that just played, within the preferred genre when that won the roll
+    if (similarity_ && !exclude_mix_id.empty() && config_.similar_mix_probability > 0 &&
+        getRandomPercentage() < config_.similar_mix_probability) {
+        Mix mix = getIndexedMix(sampleSimilar(exclude_mix_id, prefer_genre ? preferred_genre : ""));
+        if (!mix.id.empty()) {
+            found = true;
+            return mix;
+        }
+    }
+
+    SelectionPool pool = SelectionPool::Downloaded;
+    if (prefer_genre) {
+        pool = SelectionPool::Genre;
+    } else if (prefer_favorites) {
+        pool = SelectionPool::Favorites;
+    }
+
+    Mix mix = getIndexedMix(index_->sampleWeighted(pool, preferred_genre, exclude_mix_id, rng_));
+    found = !mix.id.empty();
+    return mix;
+}
+
+std::string SmartMixSelector::sampleSimilar(const std::string& mix_id, const std::string& genre) {
+    const auto neighbours = similarity_->nearest(mix_id, genre, Constants::SIMILAR_MIX_CANDIDATES);
+    if (neighbours.empty()) {
+        return "";
+    }
+    // Relative to the nearest, so a mix with no close neighbour still gets a spread of them
+    const double nearest = neighbours.front().distance;
+    std::vector<double> weights;
+    weights.reserve(neighbours.size());
+    double total = 0.0;
+    for (const auto& neighbour : neighbours) {
+        const double closeness = std::exp(-(neighbour.distance - nearest) / Constants::SIMILAR_MIX_TEMPERATURE);
+        weights.push_back(closeness * index_->getWeight(neighbour.id));
+        total += weights.back();
+    }
+    if (total <= 0.0) {
+        return "";
+    }
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+    return neighbours[pick(rng_)].id;
+}
+
+Mix SmartMixSelector::selectSmart(SelectionCriteria criteria) {
+    if (config_.prefer_least_played && hasPlayHistory()) {
+        // Range lookups in the play aggregate leave out recent plays and skip runs; if nothing is left, the
+        // plain pick below still plays something
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        SelectionCriteria rested = criteria;
+        rested.not_played_since_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now).count() -
+                                     int64_t{Constants::PLAY_RECENT_HOURS} * 3600 * 1000;
+        rested.max_skip_streak = Constants::SKIP_STREAK_LIMIT;
+        Mix result =
+            executeSingleMixQuery(buildSmartSelectionQuery(rested), MixQueryBuilder::buildParameters(rested));
+        if (!result.id.empty()) {
+            return result;
+        }
+    }
+    return executeSingleMixQuery(buildSmartSelectionQuery(criteria), MixQueryBuilder::buildParameters(criteria));
+}
+
+bool SmartMixSelector::hasPlayHistory() {
+    // Only a found table is remembered, so one created after the first pick is still seen
+    if (!has_play_history_) {
+        auto stmt = connection_->prepare(StringConstants::SELECT_PLAY_HISTORY_EXISTS);
+        has_play_history_ = stmt && stmt->step();
+    }
+    return has_play_history_;
+}
+
+Mix SmartMixSelector::getIndexedMix(const std::string& id) const {
+    if (id.empty()) {
+        return Mix();
+    }
+    Mix mix = executeSingleMixQuery(StringConstants::SELECT_MIX_BY_ID, {id});
+    return mix.is_deleted ? Mix() : mix;
+}
+
 std::tuple<int, int, int> SmartMixSelector::getMixCounts(const SelectionCriteria& criteria) const {
     // Build count query
     std::string count_query = "SELECT COUNT(*) as total, SUM(CASE WHEN is_favorite = 1 THEN 1 ELSE 0 END) as favorites";
@@ -206,7 +311,7 @@ std::tuple<int, int, int> SmartMixSelector::getMixCounts(const SelectionCriteria
     }
 
     if (!criteria.exclude_mix_id.empty()) {
-        count_query += " AND id != ?";
+        count_query += " AND id != mix_key(?)";
         params.push_back(criteria.exclude_mix_id);
     }
 
@@ -243,55 +348,23 @@ Mix SmartMixSelector::executeSingleMixQuery(const std::string& query,
     }
 
     if (stmt->step()) {
-        return statementToMix(*stmt);
+        return MixRowMapper(*stmt).map(*stmt);
     }
 
     return Mix();
 }
 
 std::string SmartMixSelector::buildSmartSelectionQuery(const SelectionCriteria& criteria) const {
-    MixQueryBuilder builder;
-    builder.select();
-
-    if (!criteria.include_deleted) {
-        builder.whereNotDeleted();
-    }
-
-    if (!criteria.genre.empty()) {
-        builder.whereGenre();
-    }
-
-    if (!criteria.artist.empty()) {
-        builder.whereArtist();
-    }
-
-    if (!criteria.exclude_mix_id.empty()) {
-        builder.whereNotId();
-    }
-
-    if (criteria.favorites_only) {
-        builder.whereFavorites();
-    }
-
-    if (criteria.downloaded_only) {
-        builder.whereDownloaded();
-    }
-
     // Smart ordering: prefer unplayed, then least played, then random
-    std::string query = builder.build();
+    std::string query = MixQueryBuilder::buildQuery(criteria, OrderBy::None);
 
     if (config_.prefer_unplayed || config_.prefer_least_played) {
-        // Replace the ORDER BY clause with smart ordering
-        size_t order_pos = query.find("ORDER BY");
-        if (order_pos != std::string::npos) {
-            query = query.substr(0, order_pos);
-        }
-
         query += " ORDER BY ";
         if (config_.prefer_unplayed) {
             query += "CASE WHEN last_played IS NULL THEN 0 ELSE 1 END, ";
         }
-        if (config_.prefer_least_played) {
+        // With a play history, recency is already filtered through its indexes instead of sorted here
+        if (config_.prefer_least_played && !has_play_history_) {
             query += "last_played ASC, play_count ASC, ";
         }
         query += "RANDOM() LIMIT 1";
@@ -310,52 +383,5 @@ int SmartMixSelector::getRandomPercentage() const {
     return dist(rng_);
 }
 
-Mix SmartMixSelector::statementToMix(IStatement& stmt) const {
-    Mix mix;
-
-    // Use column names instead of magic number indices
-    if (!stmt.isNull("id")) {
-        mix.id = stmt.getText("id");
-    }
-    if (!stmt.isNull("title")) {
-        mix.title = stmt.getText("title");
-    }
-    if (!stmt.isNull("artist")) {
-        mix.artist = stmt.getText("artist");
-    }
-    if (!stmt.isNull("genre")) {
-        mix.genre = stmt.getText("genre");
-    }
-    if (!stmt.isNull("url")) {
-        mix.url = stmt.getText("url");
-    }
-    if (!stmt.isNull("local_path")) {
-        mix.local_path = stmt.getText("local_path");
-    }
-
-    mix.duration_seconds = stmt.getInt("duration_seconds");
-
-    if (!stmt.isNull("tags")) {
-        std::string tags_json = stmt.getText("tags");
-        mix.tags = AutoVibez::Utils::JsonUtils::jsonArrayToVector(tags_json);
-    }
-
-    if (!stmt.isNull("description")) {
-        mix.description = stmt.getText("description");
-    }
-    if (!stmt.isNull("date_added")) {
-        mix.date_added = stmt.getText("date_added");
-    }
-    if (!stmt.isNull("last_played")) {
-        mix.last_played = stmt.getText("last_played");
-    }
-
-    mix.play_count = stmt.getInt("play_count");
-    mix.is_favorite = stmt.getInt("is_favorite") != 0;
-    mix.is_deleted = stmt.getInt("is_deleted") != 0;
-
-    return mix;
-}
-
 }  // namespace Data
 }  // namespace AutoVibez
@@ -7,6 +7,8 @@
 #include "database_interfaces.hpp"
 #include "mix_metadata.hpp"
 #include "mix_query_builder.hpp"
+#include "mix_selection_index.hpp"
+#include "mix_similarity_index.hpp"
 
 namespace AutoVibez::Data {
 
@@ -17,7 +19,8 @@ struct SmartSelectionConfig {
     int preferred_genre_probability = 80;  // Percentage chance to prefer genre
     int favorite_mix_probability = 70;     // Percentage chance to prefer favorites
     bool prefer_unplayed = true;           // Prefer mixes that haven't been played
-    bool prefer_least_played = true;       // Prefer mixes with lower play count
+    bool prefer_least_played = true;       // Rest recent and skipped mixes (least played first without history)
+    int similar_mix_probability = 0;       // Percentage chance to pick near the excluded (last) mix
 
     SmartSelectionConfig() = default;
 };
@@ -89,10 +92,63 @@ public:
      */
     void setSeed(unsigned int seed);
 
+    /**
+     * @brief Draw smart and random picks from an in-memory index instead of ORDER BY RANDOM()
+     *
+     * The index must be kept in step with the table by its owner; a drawn id that is
+     * no longer in the table falls back to the SQL selection.
+     * @param index Index to sample, or nullptr to go back to SQL
+     */
+    void setIndex(std::shared_ptr<MixSelectionIndex> index);
+
+    /**
+     * @brief Let smart picks follow on from the excluded mix with one of its nearest neighbours
+     *
+     * Only used together with setIndex(), whose play-history weights still apply to the neighbours.
+     * @param similarity Feature index to query, or nullptr for none
+     */
+    void setSimilarityIndex(std::shared_ptr<MixSimilarityIndex> similarity);
+
+    /**
+     * @brief Percentage of smart picks drawn near the excluded mix, 0 to never
+     */
+    void setSimilarMixProbability(int probability);
+
 private:
     std::shared_ptr<IDatabaseConnection> connection_;
     SmartSelectionConfig config_;
+    std::shared_ptr<MixSelectionIndex> index_;
+    std::shared_ptr<MixSimilarityIndex> similarity_;
     mutable std::mt19937 rng_;
+    bool has_play_history_ = false;
+
+    /**
+     * @brief getSmartRandomMix over the index
+     * @param found Set false when the index has nothing to offer and SQL should decide
+     */
+    Mix getSmartRandomMixFromIndex(const std::string& exclude_mix_id, const std::string& preferred_genre,
+                                   bool& found);
+
+    /**
+     * @brief Draw one of the nearest neighbours of mix_id, closer ones and rested ones more likely
+     * @return Empty if mix_id has no downloaded neighbour with weight left
+     */
+    std::string sampleSimilar(const std::string& mix_id, const std::string& genre);
+
+    /**
+     * @brief One smart SQL pick, resting mixes played lately or skipped over and over when there is a play history
+     */
+    Mix selectSmart(SelectionCriteria criteria);
+
+    /**
+     * @brief Whether the play_events aggregate exists (a bare mixes table has none)
+     */
+    bool hasPlayHistory();
+
+    /**
+     * @brief The row of an id drawn from the index, empty if it has gone
+     */
+    Mix getIndexedMix(const std::string& id) const;
 
     /**
      * @brief Get mix counts for smart selection
@@ -121,13 +177,6 @@ private:
      * @return Random percentage
      */
     int getRandomPercentage() const;
-
-    /**
-     * @brief Convert statement result to Mix object
-     * @param stmt Database statement with result row
-     * @return Mix object
-     */
-    Mix statementToMix(IStatement& stmt) const;
 };
 
 }  // namespace AutoVibez::Data
@@ -0,0 +1,179 @@
+#include "sqlite_backup.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+
+namespace AutoVibez::Data {
+
+SqliteBackup::SqliteBackup(const std::string& source_path, const std::string& destination_path, BackupMode mode,
+                           int pages_per_step, int step_pause_ms)
+    : source_path_(source_path),
+      destination_path_(destination_path),
+      mode_(mode),
+      pages_per_step_(pages_per_step > 0 ? pages_per_step : Constants::MIX_DB_BACKUP_PAGES_PER_STEP),
+      step_pause_ms_(step_pause_ms > 0 ? step_pause_ms : 0) {}
+
+SqliteBackup::~SqliteBackup() {
+    cancel();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool SqliteBackup::start() {
+    if (running_.exchange(true)) {
+        return false;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    cancelled_ = false;
+    worker_ = std::thread([this]() { result_ = copy(); });
+    return true;
+}
+
+bool SqliteBackup::wait() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    return result_;
+}
+
+void SqliteBackup::cancel() {
+    cancelled_ = true;
+}
+
+bool SqliteBackup::run() {
+    cancelled_ = false;
+    return copy();
+}
+
+bool SqliteBackup::copy() {
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    running_ = true;
+    clearError();
+    copied_pages_ = 0;
+    total_pages_ = 0;
+    restarts_ = 0;
+
+    // Read-only, so the copy can never take the write lock the app needs
+    sqlite3* source = nullptr;
+    if (sqlite3_open_v2(source_path_.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        setError("Cannot open " + source_path_ + ": " + (source ? sqlite3_errmsg(source) : "out of memory"));
+        sqlite3_close(source);
+        running_ = false;
+        return false;
+    }
+    sqlite3_busy_timeout(source, Constants::MIX_DB_BUSY_TIMEOUT_MS);
+
+    const std::string part_path = destination_path_ + ".part";
+    std::error_code error;
+    std::filesystem::remove(part_path, error);
+    bool ok = mode_ == BackupMode::Compact ? copyCompact(source, part_path) : copyOnline(source, part_path);
+    sqlite3_close(source);
+
+    if (ok) {
+        std::filesystem::rename(part_path, destination_path_, error);
+        if (error) {
+            setError("Cannot move the backup to " + destination_path_ + ": " + error.message());
+            ok = false;
+        }
+    }
+    if (!ok) {
+        std::filesystem::remove(part_path, error);
+    }
+    running_ = false;
+    return ok;
+}
+
+bool SqliteBackup::copyOnline(sqlite3* source, const std::string& part_path) {
+    sqlite3* destination = nullptr;
+    if (sqlite3_open_v2(part_path.c_str(), &destination, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) !=
+        SQLITE_OK) {
+        setError("Cannot create " + part_path + ": " + (destination ? sqlite3_errmsg(destination) : "out of memory"));
+        sqlite3_close(destination);
+        return false;
+    }
+    sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+    if (!backup) {
+        setError(std::string("Cannot start the backup: ") + sqlite3_errmsg(destination));
+        sqlite3_close(destination);
+        return false;
+    }
+
+    int pages = pages_per_step_;
+    int previous_remaining = -1;
+    int rc = SQLITE_OK;
+    while (!cancelled_) {
+        rc = sqlite3_backup_step(backup, pages);
+        const int total = sqlite3_backup_pagecount(backup);
+        const int remaining = sqlite3_backup_remaining(backup);
+        total_pages_ = total;
+        copied_pages_ = total - remaining;
+        if (rc == SQLITE_DONE) {
+            break;
+        }
+        if (rc != SQLITE_OK && rc != SQLITE_BUSY && rc != SQLITE_LOCKED) {
+            break;
+        }
+
+        // More left than before the step: another connection wrote and the copy started over
+        if (previous_remaining >= 0 && remaining > previous_remaining &&
+            ++restarts_ >= Constants::MIX_DB_BACKUP_MAX_RESTARTS) {
+            pages = -1;
+        }
+        previous_remaining = remaining;
+        std::this_thread::sleep_for(std::chrono::milliseconds(step_pause_ms_));
+    }
+
+    sqlite3_backup_finish(backup);
+    bool ok = rc == SQLITE_DONE && !cancelled_;
+    if (cancelled_) {
+        setError("Backup cancelled");
+    } else if (!ok) {
+        setError(std::string("Backup failed: ") + sqlite3_errstr(rc));
+    }
+    sqlite3_close(destination);
+    return ok;
+}
+
+bool SqliteBackup::copyCompact(sqlite3* source, const std::string& part_path) {
+    sqlite3_stmt* count = nullptr;
+    if (sqlite3_prepare_v2(source, "PRAGMA page_count", -1, &count, nullptr) == SQLITE_OK &&
+        sqlite3_step(count) == SQLITE_ROW) {
+        total_pages_ = sqlite3_column_int(count, 0);
+    }
+    sqlite3_finalize(count);
+
+    // A running VACUUM INTO only stops from its own progress callback, checked every 1000 VM instructions
+    sqlite3_progress_handler(source, 1000, &SqliteBackup::progressHandler, this);
+    sqlite3_stmt* vacuum = nullptr;
+    if (sqlite3_prepare_v2(source, "VACUUM INTO ?", -1, &vacuum, nullptr) != SQLITE_OK) {
+        setError(std::string("Cannot prepare VACUUM INTO: ") + sqlite3_errmsg(source));
+        sqlite3_progress_handler(source, 0, nullptr, nullptr);
+        return false;
+    }
+    sqlite3_bind_text(vacuum, 1, part_path.c_str(), -1, SQLITE_TRANSIENT);
+    const int rc = sqlite3_step(vacuum);
+    const std::string message = sqlite3_errmsg(source);
+    sqlite3_finalize(vacuum);
+    sqlite3_progress_handler(source, 0, nullptr, nullptr);
+
+    if (cancelled_) {
+        setError("Backup cancelled");
+        return false;
+    }
+    if (rc != SQLITE_DONE) {
+        setError("VACUUM INTO failed: " + message);
+        return false;
+    }
+    copied_pages_ = total_pages_.load();
+    return true;
+}
+
+int SqliteBackup::progressHandler(void* self) {
+    return static_cast<SqliteBackup*>(self)->cancelled_ ? 1 : 0;
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <sqlite3.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief How SqliteBackup copies the database
+ */
+enum class BackupMode {
+    Online,   //!< sqlite3_backup page by page: an exact copy, free pages included
+    Compact,  //!< VACUUM INTO: rebuilt without free pages, one read transaction for the whole copy
+};
+
+/**
+ * @brief A consistent copy of a live SQLite database, made on a background thread
+ *
+ * The copy opens its own read-only connection, so it works against a database the
+ * app is using, from inside the app or from another process. Online mode copies a
+ * few pages per step and sleeps between steps, so a writer on a rollback journal
+ * waits at most one step; with WAL writers never wait for it at all. A write from
+ * another connection restarts a page-by-page copy, so after a few restarts the
+ * rest is copied in one step rather than chasing a busy writer forever.
+ *
+ * Either mode writes to "<destination>.part" and renames it into place once the
+ * copy is complete, so the destination is never a torn file.
+ */
+class SqliteBackup : public AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @param pages_per_step Online mode: pages copied under each read lock
+     * @param step_pause_ms Online mode: sleep between steps
+     */
+    SqliteBackup(const std::string& source_path, const std::string& destination_path,
+                 BackupMode mode = BackupMode::Online, int pages_per_step = Constants::MIX_DB_BACKUP_PAGES_PER_STEP,
+                 int step_pause_ms = Constants::MIX_DB_BACKUP_STEP_PAUSE_MS);
+
+    /**
+     * @brief Cancels a copy still running and joins it
+     */
+    ~SqliteBackup() override;
+
+    SqliteBackup(const SqliteBackup&) = delete;
+    SqliteBackup& operator=(const SqliteBackup&) = delete;
+
+    /**
+     * @brief Start copying on the background thread
+     * @return False if a copy is already running
+     */
+    bool start();
+
+    /**
+     * @brief Block until the background copy ends
+     * @return True if the destination now holds the copy; getLastError() says why not
+     */
+    bool wait();
+
+    /**
+     * @brief Copy on the calling thread
+     */
+    bool run();
+
+    /**
+     * @brief Stop a running copy; the destination is left as it was
+     */
+    void cancel();
+
+    bool isRunning() const {
+        return running_;
+    }
+
+    /**
+     * @brief Pages copied so far and the database size in pages (Compact mode copies them all at the end)
+     */
+    int getCopiedPages() const {
+        return copied_pages_;
+    }
+    int getTotalPages() const {
+        return total_pages_;
+    }
+
+    /**
+     * @brief Online mode: times a writer made the copy start over
+     */
+    int getRestarts() const {
+        return restarts_;
+    }
+
+private:
+    std::string source_path_;
+    std::string destination_path_;
+    BackupMode mode_;
+    int pages_per_step_;
+    int step_pause_ms_;
+    std::thread worker_;
+    std::mutex run_mutex_;  // One copy at a time, whether started or run directly
+    std::atomic<bool> running_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<int> copied_pages_{0};
+    std::atomic<int> total_pages_{0};
+    std::atomic<int> restarts_{0};
+    bool result_ = false;
+
+    bool copy();
+    bool copyOnline(sqlite3* source, const std::string& part_path);
+    bool copyCompact(sqlite3* source, const std::string& part_path);
+    static int progressHandler(void* self);
+};
+
+}  // namespace AutoVibez::Data
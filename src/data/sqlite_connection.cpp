@@ -1,21 +1,188 @@
 #include "sqlite_connection.hpp"
 
+#include <algorithm>
 #include <utility>
 
+#include "console_output.hpp"
+#include "metrics_registry.hpp"
+#include "string_utils.hpp"
+#include "uuid_utils.hpp"
+
 namespace AutoVibez::Data {
 
+namespace {
+int64_t nsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Only queries get a plan; the schema and write statements are not worth one
+bool isQuery(const std::string& sql) {
+    const size_t start = sql.find_first_not_of(" \t\r\n(");
+    if (start == std::string::npos) {
+        return false;
+    }
+    const std::string head = AutoVibez::Utils::StringUtils::toLower(sql.substr(start, 7));
+    return head.rfind("select", 0) == 0 || head.rfind("with ", 0) == 0;
+}
+
+// mix_key(id): a mix id in the UUID-form text HashIdUtils generates, packed into its 16-byte BLOB. Any other
+// value (a test's "mix-1", a manifest's own id) passes through as it is, so it still finds the row it keyed.
+void mixKeyFunction(sqlite3_context* context, int, sqlite3_value** arguments) {
+    AutoVibez::Utils::HashId id;
+    if (sqlite3_value_type(arguments[0]) == SQLITE_TEXT) {
+        const auto* text = reinterpret_cast<const char*>(sqlite3_value_text(arguments[0]));
+        const int length = sqlite3_value_bytes(arguments[0]);
+        if (text && AutoVibez::Utils::HashId::parse(std::string_view(text, static_cast<size_t>(length)), id)) {
+            sqlite3_result_blob(context, id.bytes.data(), static_cast<int>(id.bytes.size()), SQLITE_TRANSIENT);
+            return;
+        }
+    }
+    sqlite3_result_value(context, arguments[0]);
+}
+
+// Every statement run, whether or not query stats are on; per-statement detail stays in SqliteQueryStats
+void observeQuery(int64_t ns) {
+    static ::AutoVibez::Utils::MetricHistogram& latency = ::AutoVibez::Utils::MetricsRegistry::instance().histogram(
+        "autovibez_db_query_ms", "Time spent stepping each database statement",
+        {0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 100});
+    latency.observe(static_cast<double>(ns) / 1e6);
+}
+
+void recordStatementCacheLookup(bool hit) {
+    static ::AutoVibez::Utils::MetricCounter& hits = ::AutoVibez::Utils::MetricsRegistry::instance().counter(
+        "autovibez_db_statement_cache_hits_total", "Statements reused without parsing");
+    static ::AutoVibez::Utils::MetricCounter& misses = ::AutoVibez::Utils::MetricsRegistry::instance().counter(
+        "autovibez_db_statement_cache_misses_total", "Statements that had to be prepared");
+    (hit ? hits : misses).increment();
+}
+}  // namespace
+
+// SqliteTuning Implementation
+SqliteTuning SqliteTuning::fast() {
+    SqliteTuning tuning;
+    tuning.wal = true;
+    tuning.synchronous_normal = true;
+    tuning.mmap_bytes = static_cast<int64_t>(Constants::MIX_DB_MMAP_MB) * 1024 * 1024;
+    tuning.cache_kb = Constants::MIX_DB_CACHE_KB;
+    tuning.temp_store_memory = true;
+    tuning.busy_timeout_ms = Constants::MIX_DB_BUSY_TIMEOUT_MS;
+    tuning.checkpoint_interval_ms = Constants::MIX_DB_CHECKPOINT_INTERVAL_MS;
+    return tuning;
+}
+
+SqliteTuning SqliteTuning::safe() {
+    SqliteTuning tuning;
+    tuning.busy_timeout_ms = Constants::MIX_DB_BUSY_TIMEOUT_MS;
+    return tuning;
+}
+
+bool SqliteTuning::parseProfile(const std::string& name, SqliteTuning& tuning) {
+    const std::string lower = AutoVibez::Utils::StringUtils::toLower(name);
+    if (lower == "fast") {
+        tuning = fast();
+    } else if (lower == "safe") {
+        tuning = safe();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// SqliteStatementCache Implementation
+SqliteStatementCache::SqliteStatementCache(size_t capacity) : capacity_(capacity) {}
+
+SqliteStatementCache::~SqliteStatementCache() {
+    clear();
+}
+
+sqlite3_stmt* SqliteStatementCache::acquire(const std::string& sql) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(sql);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        recordStatementCacheLookup(false);
+        return nullptr;
+    }
+    sqlite3_stmt* stmt = it->second->second;
+    lru_.erase(it->second);
+    index_.erase(it);
+    ++stats_.hits;
+    recordStatementCacheLookup(true);
+    stats_.size = lru_.size();
+    return stmt;
+}
+
+void SqliteStatementCache::release(const std::string& sql, sqlite3_stmt* stmt) {
+    // Resetting also ends the read a half-stepped query keeps open
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || index_.count(sql) > 0) {
+        // A nested user of the same SQL already returned one
+        sqlite3_finalize(stmt);
+        return;
+    }
+    lru_.emplace_front(sql, stmt);
+    index_[sql] = lru_.begin();
+    evictLocked();
+    stats_.size = lru_.size();
+}
+
+void SqliteStatementCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Entry& entry : lru_) {
+        sqlite3_finalize(entry.second);
+    }
+    lru_.clear();
+    index_.clear();
+    stats_.size = 0;
+}
+
+StatementCacheStats SqliteStatementCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SqliteStatementCache::evictLocked() {
+    while (lru_.size() > capacity_) {
+        index_.erase(lru_.back().first);
+        sqlite3_finalize(lru_.back().second);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
 // SqliteStatement Implementation
 SqliteStatement::SqliteStatement(sqlite3_stmt* stmt, sqlite3* db) : stmt_(stmt), db_(db), executed_(false) {}
 
+SqliteStatement::SqliteStatement(sqlite3_stmt* stmt, sqlite3* db, std::weak_ptr<SqliteStatementCache> cache,
+                                 std::string sql, std::shared_ptr<SqliteQueryStats> stats)
+    : stmt_(stmt),
+      db_(db),
+      executed_(false),
+      cache_(std::move(cache)),
+      sql_(std::move(sql)),
+      stats_(std::move(stats)) {}
+
 SqliteStatement::~SqliteStatement() {
     cleanup();
 }
 
 SqliteStatement::SqliteStatement(SqliteStatement&& other) noexcept
-    : stmt_(other.stmt_), db_(other.db_), executed_(other.executed_) {
+    : stmt_(other.stmt_),
+      db_(other.db_),
+      executed_(other.executed_),
+      cache_(std::move(other.cache_)),
+      sql_(std::move(other.sql_)),
+      stats_(std::move(other.stats_)),
+      run_ns_(other.run_ns_),
+      run_rows_(other.run_rows_),
+      running_(other.running_) {
     other.stmt_ = nullptr;
     other.db_ = nullptr;
     other.executed_ = false;
+    other.running_ = false;
 }
 
 SqliteStatement& SqliteStatement::operator=(SqliteStatement&& other) noexcept {
@@ -24,16 +191,24 @@ SqliteStatement& SqliteStatement::operator=(SqliteStatement&& other) noexcept {
         stmt_ = other.stmt_;
         db_ = other.db_;
         executed_ = other.executed_;
+        cache_ = std::move(other.cache_);
+        sql_ = std::move(other.sql_);
+        stats_ = std::move(other.stats_);
+        run_ns_ = other.run_ns_;
+        run_rows_ = other.run_rows_;
+        running_ = other.running_;
         other.stmt_ = nullptr;
         other.db_ = nullptr;
         other.executed_ = false;
+        other.running_ = false;
     }
     return *this;
 }
 
 void SqliteStatement::bindText(int index, const std::string& value) {
     if (stmt_) {
-        sqlite3_bind_text(stmt_, index, value.c_str(), -1, SQLITE_STATIC);
+        // Copied: callers bind temporaries (the tags JSON, for one) that are gone before the step
+        sqlite3_bind_text(stmt_, index, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
     }
 }
 
@@ -43,11 +218,24 @@ void SqliteStatement::bindInt(int index, int value) {
     }
 }
 
+void SqliteStatement::bindInt64(int index, int64_t value) {
+    if (stmt_) {
+        sqlite3_bind_int64(stmt_, index, value);
+    }
+}
+
+void SqliteStatement::bindDouble(int index, double value) {
+    if (stmt_) {
+        sqlite3_bind_double(stmt_, index, value);
+    }
+}
+
 bool SqliteStatement::execute() {
     if (!stmt_)
         return false;
     executed_ = true;
-    int result = sqlite3_step(stmt_);
+    int result = stepTimed();
+    recordRun();
     return result == SQLITE_DONE;
 }
 
@@ -55,7 +243,12 @@ bool SqliteStatement::step() {
     if (!stmt_)
         return false;
     executed_ = true;
-    int result = sqlite3_step(stmt_);
+    int result = stepTimed();
+    if (result == SQLITE_ROW) {
+        run_rows_++;
+    } else {
+        recordRun();
+    }
     return result == SQLITE_ROW;
 }
 
@@ -71,6 +264,25 @@ std::string SqliteStatement::getText(const std::string& columnName) const {
     return column >= 0 ? getText(column) : "";
 }
 
+std::string_view SqliteStatement::getTextView(int column) const {
+    if (!stmt_ || !executed_ || column < 0)
+        return {};
+    const unsigned char* text = sqlite3_column_text(stmt_, column);
+    if (!text)
+        return {};
+    // The length is only valid after the text conversion above
+    const int length = sqlite3_column_bytes(stmt_, column);
+    return std::string_view(reinterpret_cast<const char*>(text), static_cast<size_t>(length));
+}
+
+std::string_view SqliteStatement::getBlobView(int column) const {
+    if (!stmt_ || !executed_ || column < 0 || sqlite3_column_type(stmt_, column) != SQLITE_BLOB)
+        return {};
+    const void* blob = sqlite3_column_blob(stmt_, column);
+    const int length = sqlite3_column_bytes(stmt_, column);
+    return blob ? std::string_view(static_cast<const char*>(blob), static_cast<size_t>(length)) : std::string_view();
+}
+
 int SqliteStatement::getInt(int column) const {
     if (!stmt_ || !executed_)
         return 0;
@@ -82,6 +294,23 @@ int SqliteStatement::getInt(const std::string& columnName) const {
     return column >= 0 ? getInt(column) : 0;
 }
 
+int64_t SqliteStatement::getInt64(int column) const {
+    if (!stmt_ || !executed_)
+        return 0;
+    return sqlite3_column_int64(stmt_, column);
+}
+
+double SqliteStatement::getDouble(int column) const {
+    if (!stmt_ || !executed_)
+        return 0.0;
+    return sqlite3_column_double(stmt_, column);
+}
+
+double SqliteStatement::getDouble(const std::string& columnName) const {
+    int column = getColumnIndex(columnName);
+    return column >= 0 ? getDouble(column) : 0.0;
+}
+
 bool SqliteStatement::isNull(int column) const {
     if (!stmt_ || !executed_)
         return true;
@@ -97,9 +326,44 @@ int SqliteStatement::getChanges() const {
     return db_ ? sqlite3_changes(db_) : 0;
 }
 
+void SqliteStatement::reset() {
+    recordRun();
+    if (stmt_) {
+        sqlite3_reset(stmt_);
+    }
+    executed_ = false;
+}
+
+int SqliteStatement::stepTimed() {
+    const auto start = std::chrono::steady_clock::now();
+    const int result = sqlite3_step(stmt_);
+    run_ns_ += nsSince(start);
+    running_ = true;
+    return result;
+}
+
+void SqliteStatement::recordRun() {
+    if (!running_) {
+        return;
+    }
+    // A query abandoned before its last row is recorded with the rows it got to
+    observeQuery(run_ns_);
+    if (stats_) {
+        stats_->record(sql_, run_ns_, run_rows_);
+    }
+    run_ns_ = 0;
+    run_rows_ = 0;
+    running_ = false;
+}
+
 void SqliteStatement::cleanup() {
+    recordRun();
     if (stmt_) {
-        sqlite3_finalize(stmt_);
+        if (auto cache = cache_.lock()) {
+            cache->release(sql_, stmt_);
+        } else {
+            sqlite3_finalize(stmt_);
+        }
         stmt_ = nullptr;
     }
 }
@@ -121,14 +385,23 @@ int SqliteStatement::getColumnIndex(const std::string& columnName) const {
 }
 
 // SqliteConnection Implementation
-SqliteConnection::SqliteConnection(const std::string& db_path) : db_(nullptr), db_path_(db_path) {}
+SqliteConnection::SqliteConnection(const std::string& db_path, const SqliteTuning& tuning,
+                                   size_t statement_cache_capacity)
+    : db_(nullptr),
+      db_path_(db_path),
+      tuning_(tuning),
+      statement_cache_(std::make_shared<SqliteStatementCache>(statement_cache_capacity)) {}
 
 SqliteConnection::~SqliteConnection() {
     cleanup();
 }
 
 SqliteConnection::SqliteConnection(SqliteConnection&& other) noexcept
-    : db_(other.db_), db_path_(std::move(other.db_path_)) {
+    : db_(other.db_),
+      db_path_(std::move(other.db_path_)),
+      tuning_(other.tuning_),
+      statement_cache_(std::move(other.statement_cache_)),
+      last_checkpoint_(other.last_checkpoint_) {
     other.db_ = nullptr;
 }
 
@@ -137,6 +410,9 @@ SqliteConnection& SqliteConnection::operator=(SqliteConnection&& other) noexcept
         cleanup();
         db_ = other.db_;
         db_path_ = std::move(other.db_path_);
+        tuning_ = other.tuning_;
+        statement_cache_ = std::move(other.statement_cache_);
+        last_checkpoint_ = other.last_checkpoint_;
         other.db_ = nullptr;
     }
     return *this;
@@ -144,14 +420,26 @@ SqliteConnection& SqliteConnection::operator=(SqliteConnection&& other) noexcept
 
 bool SqliteConnection::initialize() {
     int rc = sqlite3_open(db_path_.c_str(), &db_);
-    return rc == SQLITE_OK;
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+    applyTuning();
+    registerFunctions();
+    return true;
 }
 
 bool SqliteConnection::execute(const std::string& sql) {
     if (!db_)
         return false;
+    checkpointIfDue();
     char* err_msg = nullptr;
+    const auto start = std::chrono::steady_clock::now();
     int rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &err_msg);
+    const int64_t elapsed = nsSince(start);
+    observeQuery(elapsed);
+    if (tuning_.query_stats) {
+        tuning_.query_stats->record(sql, elapsed, 0);
+    }
     if (err_msg) {
         sqlite3_free(err_msg);
     }
@@ -161,14 +449,20 @@ bool SqliteConnection::execute(const std::string& sql) {
 std::unique_ptr<IStatement> SqliteConnection::prepare(const std::string& sql) {
     if (!db_)
         return nullptr;
+    checkpointIfDue();
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return nullptr;
+    sqlite3_stmt* stmt = statement_cache_ ? statement_cache_->acquire(sql) : nullptr;
+    if (!stmt) {
+        int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
+        if (rc != SQLITE_OK) {
+            return nullptr;
+        }
+        if (tuning_.query_stats && tuning_.query_stats->isLoggingPlans()) {
+            explainPlan(sql);
+        }
     }
 
-    return std::make_unique<SqliteStatement>(stmt, db_);
+    return std::make_unique<SqliteStatement>(stmt, db_, statement_cache_, sql, tuning_.query_stats);
 }
 
 std::string SqliteConnection::getLastError() const {
@@ -187,11 +481,248 @@ bool SqliteConnection::rollbackTransaction() {
     return execute("ROLLBACK");
 }
 
+StatementCacheStats SqliteConnection::getStatementCacheStats() const {
+    return statement_cache_ ? statement_cache_->getStats() : StatementCacheStats{};
+}
+
+bool SqliteConnection::checkpoint() {
+    if (!db_) {
+        return false;
+    }
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    const int rc = sqlite3_wal_checkpoint_v2(db_, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+    return rc == SQLITE_OK;
+}
+
+std::string SqliteConnection::getJournalMode() {
+    auto stmt = prepare("PRAGMA journal_mode");
+    return stmt && stmt->step() ? stmt->getText(0) : "";
+}
+
+void SqliteConnection::registerFunctions() {
+    // Deterministic, so a key built from a bound id is worked out once per statement and can use an index
+    int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+#ifdef SQLITE_INNOCUOUS
+    flags |= SQLITE_INNOCUOUS;
+#endif
+    sqlite3_create_function_v2(db_, "mix_key", 1, flags, nullptr, mixKeyFunction, nullptr, nullptr, nullptr);
+}
+
+void SqliteConnection::applyTuning() {
+    // Failures leave SQLite's default in place; an in-memory database, for one, has no WAL
+    if (tuning_.busy_timeout_ms > 0) {
+        sqlite3_busy_timeout(db_, tuning_.busy_timeout_ms);
+    }
+    if (tuning_.wal) {
+        execute("PRAGMA journal_mode=WAL");
+    }
+    if (tuning_.synchronous_normal) {
+        execute("PRAGMA synchronous=NORMAL");
+    }
+    if (tuning_.mmap_bytes > 0) {
+        execute("PRAGMA mmap_size=" + std::to_string(tuning_.mmap_bytes));
+    }
+    if (tuning_.cache_kb > 0) {
+        // Negative sizes are in KiB rather than pages
+        execute("PRAGMA cache_size=-" + std::to_string(tuning_.cache_kb));
+    }
+    if (tuning_.temp_store_memory) {
+        execute("PRAGMA temp_store=MEMORY");
+    }
+    last_checkpoint_ = std::chrono::steady_clock::now();
+}
+
+void SqliteConnection::checkpointIfDue() {
+    // Inside a transaction the log cannot be copied past its own writes anyway
+    if (!tuning_.wal || tuning_.checkpoint_interval_ms <= 0 || !sqlite3_get_autocommit(db_)) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_checkpoint_ >= std::chrono::milliseconds(tuning_.checkpoint_interval_ms)) {
+        checkpoint();
+    }
+}
+
+void SqliteConnection::explainPlan(const std::string& sql) {
+    if (!isQuery(sql) || !tuning_.query_stats->claimPlan(sql)) {
+        return;
+    }
+    // Prepared directly so neither the cache nor the stats see the EXPLAIN itself
+    sqlite3_stmt* explain = nullptr;
+    if (sqlite3_prepare_v2(db_, ("EXPLAIN QUERY PLAN " + sql).c_str(), -1, &explain, nullptr) != SQLITE_OK) {
+        return;
+    }
+    std::string plan;
+    bool full_scan = false;
+    while (sqlite3_step(explain) == SQLITE_ROW) {
+        const unsigned char* text = sqlite3_column_text(explain, 3);
+        const std::string detail = text ? reinterpret_cast<const char*>(text) : "";
+        plan += (plan.empty() ? "" : "\n") + detail;
+        full_scan = full_scan || SqliteQueryStats::isFullScan(detail);
+    }
+    sqlite3_finalize(explain);
+
+    tuning_.query_stats->setPlan(sql, plan, full_scan);
+    AutoVibez::Utils::ConsoleOutput::debug("Query plan of " + sql + ":\n" + plan);
+    if (full_scan) {
+        AutoVibez::Utils::ConsoleOutput::warning("Full table scan in query: " + sql);
+    }
+}
+
 void SqliteConnection::cleanup() {
+    // Statements still out are finalized when they are destroyed
+    if (statement_cache_) {
+        statement_cache_->clear();
+        statement_cache_.reset();
+    }
     if (db_) {
         sqlite3_close(db_);
         db_ = nullptr;
     }
 }
 
+// SqliteConnectionPool Implementation
+struct SqliteConnectionPool::Shared {
+    struct Lease {
+        std::weak_ptr<Shared> owner;
+        SqliteConnection* connection;
+    };
+
+    // Every pool's connection for one thread, given back when the thread exits
+    struct ThreadLeases {
+        std::vector<Lease> leases;
+
+        ~ThreadLeases() {
+            for (Lease& lease : leases) {
+                if (auto owner = lease.owner.lock()) {
+                    owner->release(lease.connection);
+                }
+            }
+        }
+    };
+
+    static ThreadLeases& threadLeases() {
+        thread_local ThreadLeases leases;
+        return leases;
+    }
+
+    std::string db_path;
+    SqliteTuning tuning;
+    size_t max_idle = 0;
+    bool single = false;  // In-memory: every thread uses connections.front()
+    std::mutex mutex;
+    std::vector<std::unique_ptr<SqliteConnection>> connections;
+    std::vector<SqliteConnection*> idle;
+    std::string open_error;
+
+    SqliteConnection* acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (single && !connections.empty()) {
+            return connections.front().get();
+        }
+        if (!idle.empty()) {
+            SqliteConnection* connection = idle.back();
+            idle.pop_back();
+            return connection;
+        }
+        auto connection = std::make_unique<SqliteConnection>(db_path, tuning);
+        if (!connection->initialize()) {
+            open_error = connection->getLastError();
+            return nullptr;
+        }
+        connections.push_back(std::move(connection));
+        return connections.back().get();
+    }
+
+    void release(SqliteConnection* connection) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (idle.size() < max_idle) {
+            idle.push_back(connection);
+            return;
+        }
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [connection](const std::unique_ptr<SqliteConnection>& open) {
+                                             return open.get() == connection;
+                                         }),
+                          connections.end());
+    }
+};
+
+SqliteConnectionPool::SqliteConnectionPool(const std::string& db_path, const SqliteTuning& tuning, size_t max_idle)
+    : shared_(std::make_shared<Shared>()) {
+    shared_->db_path = db_path;
+    shared_->tuning = tuning;
+    shared_->max_idle = max_idle;
+    // An empty path is a private temporary database, just as separate per connection
+    shared_->single = db_path.empty() || db_path == ":memory:" || db_path.find("mode=memory") != std::string::npos;
+}
+
+// Leases still held by live threads find the pool gone and leave their connection alone
+SqliteConnectionPool::~SqliteConnectionPool() = default;
+
+bool SqliteConnectionPool::initialize() {
+    return current() != nullptr;
+}
+
+bool SqliteConnectionPool::execute(const std::string& sql) {
+    SqliteConnection* connection = current();
+    return connection && connection->execute(sql);
+}
+
+std::unique_ptr<IStatement> SqliteConnectionPool::prepare(const std::string& sql) {
+    SqliteConnection* connection = current();
+    return connection ? connection->prepare(sql) : nullptr;
+}
+
+std::string SqliteConnectionPool::getLastError() const {
+    if (SqliteConnection* connection = current()) {
+        return connection->getLastError();
+    }
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    return shared_->open_error.empty() ? "Database not initialized" : shared_->open_error;
+}
+
+bool SqliteConnectionPool::beginTransaction() {
+    SqliteConnection* connection = current();
+    return connection && connection->beginTransaction();
+}
+
+bool SqliteConnectionPool::commitTransaction() {
+    SqliteConnection* connection = current();
+    return connection && connection->commitTransaction();
+}
+
+bool SqliteConnectionPool::rollbackTransaction() {
+    SqliteConnection* connection = current();
+    return connection && connection->rollbackTransaction();
+}
+
+size_t SqliteConnectionPool::getOpenCount() const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    return shared_->connections.size();
+}
+
+SqliteConnection* SqliteConnectionPool::current() const {
+    if (shared_->single) {
+        return shared_->acquire();
+    }
+
+    std::vector<Shared::Lease>& leases = Shared::threadLeases().leases;
+    for (const Shared::Lease& lease : leases) {
+        // Compares ownership, so a new pool at a dead pool's address is not mistaken for it
+        if (!lease.owner.owner_before(shared_) && !shared_.owner_before(lease.owner)) {
+            return lease.connection;
+        }
+    }
+    leases.erase(std::remove_if(leases.begin(), leases.end(),
+                                [](const Shared::Lease& lease) { return lease.owner.expired(); }),
+                 leases.end());
+
+    SqliteConnection* connection = shared_->acquire();
+    if (connection) {
+        leases.push_back({shared_, connection});
+    }
+    return connection;
+}
+
 }  // namespace AutoVibez::Data
@@ -2,19 +2,127 @@
 
 #include <sqlite3.h>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "constants.hpp"
 #include "database_interfaces.hpp"
+#include "sqlite_query_stats.hpp"
 
 namespace AutoVibez::Data {
 
+/**
+ * @brief Pragmas a connection applies when it opens
+ *
+ * Default-constructed, everything is left at SQLite's defaults (rollback journal,
+ * synchronous=FULL). fast() is what the mix database runs with: with WAL, readers
+ * and one writer no longer block each other and a commit appends to the log
+ * without syncing; only checkpoints sync, so a power cut can lose the last
+ * commits but never corrupts the file.
+ */
+struct SqliteTuning {
+    bool wal = false;                 //!< journal_mode=WAL
+    bool synchronous_normal = false;  //!< synchronous=NORMAL instead of FULL
+    int64_t mmap_bytes = 0;           //!< mmap_size (0 = read through system calls)
+    int cache_kb = 0;                 //!< Page cache size (0 = SQLite's default)
+    bool temp_store_memory = false;   //!< temp_store=MEMORY
+    int busy_timeout_ms = 0;          //!< Wait for locks held by other connections instead of failing
+    int checkpoint_interval_ms = 0;   //!< Passive WAL checkpoint at most this often (0 = autocheckpoint only)
+
+    /**
+     * @brief Times every statement when set; connections copy the tuning, so all of a pool's share it
+     */
+    std::shared_ptr<SqliteQueryStats> query_stats;
+
+    static SqliteTuning fast();
+
+    /**
+     * @brief SQLite's durability defaults, plus the busy timeout
+     */
+    static SqliteTuning safe();
+
+    /**
+     * @brief Parse "fast" or "safe" (case-insensitive)
+     * @return True if the name was recognized
+     */
+    static bool parseProfile(const std::string& name, SqliteTuning& tuning);
+};
+
+/**
+ * @brief Counters of a connection's statement cache
+ */
+struct StatementCacheStats {
+    size_t hits = 0;       //!< prepare() calls served without parsing
+    size_t misses = 0;     //!< prepare() calls that ran sqlite3_prepare_v2
+    size_t evictions = 0;  //!< Idle statements finalized to stay within the capacity
+    size_t size = 0;       //!< Idle statements held now
+};
+
+/**
+ * @brief Idle prepared statements of one connection, keyed by SQL text
+ *
+ * A statement is taken out while a caller uses it and comes back reset with its
+ * bindings cleared, so two live statements never share a handle and nested queries
+ * with the same SQL simply prepare a second one. The least recently returned
+ * statement is finalized when the cache is full.
+ */
+class SqliteStatementCache {
+public:
+    explicit SqliteStatementCache(size_t capacity);
+    ~SqliteStatementCache();
+
+    SqliteStatementCache(const SqliteStatementCache&) = delete;
+    SqliteStatementCache& operator=(const SqliteStatementCache&) = delete;
+
+    /**
+     * @brief Take the idle statement for sql
+     * @return nullptr (a miss) when none is idle
+     */
+    sqlite3_stmt* acquire(const std::string& sql);
+
+    /**
+     * @brief Reset a statement and keep it for the next acquire()
+     */
+    void release(const std::string& sql, sqlite3_stmt* stmt);
+
+    /**
+     * @brief Finalize every idle statement
+     */
+    void clear();
+
+    StatementCacheStats getStats() const;
+
+private:
+    using Entry = std::pair<std::string, sqlite3_stmt*>;
+
+    void evictLocked();
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    std::list<Entry> lru_;  // Most recently returned first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    StatementCacheStats stats_;
+};
+
 /**
  * @brief RAII wrapper for SQLite statement
+ *
+ * A statement from a cache goes back to it instead of being finalized. With query
+ * stats, each run is recorded once it steps past its last row, fails, or is reset.
  */
 class SqliteStatement : public IStatement {
 public:
     explicit SqliteStatement(sqlite3_stmt* stmt, sqlite3* db);
+    SqliteStatement(sqlite3_stmt* stmt, sqlite3* db, std::weak_ptr<SqliteStatementCache> cache, std::string sql,
+                    std::shared_ptr<SqliteQueryStats> stats = nullptr);
     ~SqliteStatement() override;
 
     // Non-copyable but movable
@@ -25,23 +133,39 @@ public:
 
     void bindText(int index, const std::string& value) override;
     void bindInt(int index, int value) override;
+    void bindInt64(int index, int64_t value) override;
+    void bindDouble(int index, double value) override;
     bool execute() override;
     bool step() override;
     std::string getText(int column) const override;
     std::string getText(const std::string& columnName) const override;
+    std::string_view getTextView(int column) const override;
+    std::string_view getBlobView(int column) const override;
+    int getColumnIndex(const std::string& columnName) const override;
     int getInt(int column) const override;
     int getInt(const std::string& columnName) const override;
+    int64_t getInt64(int column) const override;
+    double getDouble(int column) const override;
+    double getDouble(const std::string& columnName) const override;
     bool isNull(int column) const override;
     bool isNull(const std::string& columnName) const override;
     int getChanges() const override;
+    void reset() override;
 
 private:
     sqlite3_stmt* stmt_;
     sqlite3* db_;
     bool executed_;
+    std::weak_ptr<SqliteStatementCache> cache_;
+    std::string sql_;
+    std::shared_ptr<SqliteQueryStats> stats_;
+    int64_t run_ns_ = 0;     // Time stepped in the current run
+    uint64_t run_rows_ = 0;  // Rows stepped in the current run
+    bool running_ = false;   // Stepped since the last record
 
+    int stepTimed();
+    void recordRun();
     void cleanup();
-    int getColumnIndex(const std::string& columnName) const;
 };
 
 /**
@@ -49,7 +173,8 @@ private:
  */
 class SqliteConnection : public IDatabaseConnection {
 public:
-    explicit SqliteConnection(const std::string& db_path);
+    explicit SqliteConnection(const std::string& db_path, const SqliteTuning& tuning = SqliteTuning(),
+                              size_t statement_cache_capacity = Constants::STATEMENT_CACHE_CAPACITY);
     ~SqliteConnection() override;
 
     // Non-copyable but movable
@@ -66,11 +191,81 @@ public:
     bool commitTransaction() override;
     bool rollbackTransaction() override;
 
+    StatementCacheStats getStatementCacheStats() const;
+
+    /**
+     * @brief Copy committed WAL frames into the database without waiting for readers or writers
+     * @return True if the checkpoint ran (also true outside WAL mode, where there is nothing to do)
+     */
+    bool checkpoint();
+
+    /**
+     * @brief Journal mode in effect ("wal", "delete", "memory", ...)
+     */
+    std::string getJournalMode();
+
 private:
     sqlite3* db_;
     std::string db_path_;
+    SqliteTuning tuning_;
+    std::shared_ptr<SqliteStatementCache> statement_cache_;
+    std::chrono::steady_clock::time_point last_checkpoint_;
 
+    void applyTuning();
+    void registerFunctions();
+    void checkpointIfDue();
+    void explainPlan(const std::string& sql);
     void cleanup();
 };
 
+/**
+ * @brief One SQLite connection per thread, for a database used from several threads
+ *
+ * Each call goes to the calling thread's connection, opened on its first call, so
+ * statements, transactions, errors and change counts never cross threads. With WAL
+ * the readers don't block each other or the writer; writers still take turns on the
+ * file, so owners should serialize their write transactions. A thread's connection
+ * goes back to an idle list when the thread exits, for the next thread to reuse.
+ * An in-memory database exists only on the connection that created it, so all
+ * threads share one connection there.
+ */
+class SqliteConnectionPool : public IDatabaseConnection {
+public:
+    /**
+     * @param max_idle Connections of exited threads kept open; more are closed
+     */
+    explicit SqliteConnectionPool(const std::string& db_path, const SqliteTuning& tuning = SqliteTuning(),
+                                  size_t max_idle = Constants::MIX_DB_POOL_MAX_IDLE);
+    ~SqliteConnectionPool() override;
+
+    SqliteConnectionPool(const SqliteConnectionPool&) = delete;
+    SqliteConnectionPool& operator=(const SqliteConnectionPool&) = delete;
+
+    /**
+     * @brief Open the calling thread's connection
+     */
+    bool initialize() override;
+    bool execute(const std::string& sql) override;
+    std::unique_ptr<IStatement> prepare(const std::string& sql) override;
+    std::string getLastError() const override;
+    bool beginTransaction() override;
+    bool commitTransaction() override;
+    bool rollbackTransaction() override;
+
+    /**
+     * @brief Connections open now, leased or idle
+     */
+    size_t getOpenCount() const;
+
+private:
+    struct Shared;
+
+    std::shared_ptr<Shared> shared_;  // Threads' leases hold it weakly, so they outlive the pool safely
+
+    /**
+     * @return The calling thread's connection, or nullptr if it could not be opened
+     */
+    SqliteConnection* current() const;
+};
+
 }  // namespace AutoVibez::Data
@@ -0,0 +1,160 @@
+#include "sqlite_query_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <utility>
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr size_t BUCKET_COUNT = Constants::QUERY_LATENCY_BUCKETS;
+
+// Bucket 0 holds runs under 1us, bucket i those under 2^i us
+size_t bucketOf(int64_t elapsed_ns) {
+    uint64_t us = static_cast<uint64_t>(std::max<int64_t>(elapsed_ns, 0)) / 1000;
+    size_t bucket = 0;
+    while (us > 0 && bucket + 1 < BUCKET_COUNT) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+double bucketUpperMs(size_t bucket) {
+    return static_cast<double>(uint64_t{1} << bucket) / 1000.0;
+}
+
+double percentileMs(const std::array<uint64_t, BUCKET_COUNT>& buckets, uint64_t calls, double fraction,
+                    double max_ms) {
+    if (calls == 0) {
+        return 0.0;
+    }
+    // Nearest rank, as the frame profiler reports
+    const auto target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(calls))), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            // Never past the slowest run, which also bounds the open-ended last bucket
+            return std::min(bucketUpperMs(i), max_ms);
+        }
+    }
+    return max_ms;
+}
+
+double toMs(int64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+void writeCsvField(std::ostream& out, const std::string& field) {
+    if (field.find_first_of(",\"\n") == std::string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        out << c;
+        if (c == '"') {
+            out << '"';
+        }
+    }
+    out << '"';
+}
+}  // namespace
+
+SqliteQueryStats::SqliteQueryStats(bool log_plans) : log_plans_(log_plans) {}
+
+void SqliteQueryStats::record(const std::string& sql, int64_t elapsed_ns, uint64_t rows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[sql];
+    entry.calls++;
+    entry.rows += rows;
+    entry.total_ns += elapsed_ns;
+    entry.max_ns = std::max(entry.max_ns, elapsed_ns);
+    entry.buckets[bucketOf(elapsed_ns)]++;
+}
+
+bool SqliteQueryStats::claimPlan(const std::string& sql) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return planned_.insert(sql).second;
+}
+
+void SqliteQueryStats::setPlan(const std::string& sql, const std::string& plan, bool full_scan) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[sql];
+    entry.plan = plan;
+    entry.full_scan = full_scan;
+}
+
+bool SqliteQueryStats::isFullScan(const std::string& detail) {
+    if (detail.rfind("SCAN ", 0) != 0) {
+        return false;
+    }
+    for (const char* exempt : {"USING", "VIRTUAL TABLE", "CONSTANT ROW", "(subquery-", "sqlite_master"}) {
+        if (detail.find(exempt) != std::string::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<QueryStats> SqliteQueryStats::snapshot() const {
+    std::vector<QueryStats> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.reserve(entries_.size());
+        for (const auto& [sql, entry] : entries_) {
+            QueryStats stats;
+            stats.sql = sql;
+            stats.calls = entry.calls;
+            stats.rows = entry.rows;
+            stats.total_ms = toMs(entry.total_ns);
+            stats.max_ms = toMs(entry.max_ns);
+            stats.p50_ms = percentileMs(entry.buckets, entry.calls, 0.50, stats.max_ms);
+            stats.p95_ms = percentileMs(entry.buckets, entry.calls, 0.95, stats.max_ms);
+            stats.p99_ms = percentileMs(entry.buckets, entry.calls, 0.99, stats.max_ms);
+            stats.plan = entry.plan;
+            stats.full_scan = entry.full_scan;
+            result.push_back(std::move(stats));
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const QueryStats& a, const QueryStats& b) {
+        return a.total_ms != b.total_ms ? a.total_ms > b.total_ms : a.sql < b.sql;
+    });
+    return result;
+}
+
+void SqliteQueryStats::writeCsv(std::ostream& out) const {
+    out << "sql,calls,rows,total_ms,max_ms,p50_ms,p95_ms,p99_ms,full_scan,plan\n";
+    for (const QueryStats& stats : snapshot()) {
+        writeCsvField(out, stats.sql);
+        out << ',' << stats.calls << ',' << stats.rows << ',' << stats.total_ms << ',' << stats.max_ms << ','
+            << stats.p50_ms << ',' << stats.p95_ms << ',' << stats.p99_ms << ',' << (stats.full_scan ? 1 : 0) << ',';
+        writeCsvField(out, stats.plan);
+        out << '\n';
+    }
+}
+
+bool SqliteQueryStats::writeCsv(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        setError("Cannot open query stats file: " + path);
+        return false;
+    }
+    writeCsv(out);
+    if (!out.good()) {
+        setError("Failed to write query stats file: " + path);
+        return false;
+    }
+    setSuccess(true);
+    return true;
+}
+
+void SqliteQueryStats::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    planned_.clear();
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Totals of one SQL text, as snapshot() reports them
+ */
+struct QueryStats {
+    std::string sql;
+    uint64_t calls = 0;     //!< Statement runs (step sequence or exec) recorded
+    uint64_t rows = 0;      //!< Result rows stepped over all calls
+    double total_ms = 0.0;  //!< Time spent in sqlite3_step / sqlite3_exec
+    double max_ms = 0.0;
+    double p50_ms = 0.0;  //!< Upper bound of the histogram bucket holding the percentile
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    std::string plan;        //!< EXPLAIN QUERY PLAN lines, empty unless plans are logged
+    bool full_scan = false;  //!< The plan scans a table without an index
+};
+
+/**
+ * @brief Latency histograms and row counts per SQL text, shared by connections
+ *
+ * Connections whose tuning carries one time every statement: the clock runs only
+ * inside sqlite3_step and sqlite3_exec, and a run is recorded when it finishes,
+ * is reset or goes back to the cache. Statements are keyed by their SQL, which is
+ * a template here since values are bound, so a query shape is one row however
+ * often it runs. Latencies land in power-of-two microsecond buckets; percentiles
+ * are read off the buckets, which is coarse but costs nothing per run.
+ */
+class SqliteQueryStats : public ::AutoVibez::Utils::ErrorHandler {
+public:
+    /**
+     * @param log_plans Have connections log EXPLAIN QUERY PLAN for each distinct SELECT, once
+     */
+    explicit SqliteQueryStats(bool log_plans = false);
+
+    bool isLoggingPlans() const {
+        return log_plans_;
+    }
+
+    /**
+     * @brief Add one finished run of sql
+     */
+    void record(const std::string& sql, int64_t elapsed_ns, uint64_t rows);
+
+    /**
+     * @brief Claim the plan of sql for the caller to explain
+     * @return True the first time sql is claimed, false after
+     */
+    bool claimPlan(const std::string& sql);
+
+    void setPlan(const std::string& sql, const std::string& plan, bool full_scan);
+
+    /**
+     * @brief Whether an EXPLAIN QUERY PLAN detail line reads a whole table
+     *
+     * Scans through an index, of a virtual table (the search index), of a
+     * subquery's result, of a constant row or of the schema are not counted.
+     */
+    static bool isFullScan(const std::string& detail);
+
+    /**
+     * @return Every SQL seen, most total time first
+     */
+    std::vector<QueryStats> snapshot() const;
+
+    void writeCsv(std::ostream& out) const;
+
+    /**
+     * @brief Write the snapshot to a file
+     * @return True on success; the error is kept otherwise
+     */
+    bool writeCsv(const std::string& path);
+
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t calls = 0;
+        uint64_t rows = 0;
+        int64_t total_ns = 0;
+        int64_t max_ns = 0;
+        std::array<uint64_t, Constants::QUERY_LATENCY_BUCKETS> buckets{};
+        std::string plan;
+        bool full_scan = false;
+    };
+
+    bool log_plans_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_set<std::string> planned_;
+};
+
+}  // namespace AutoVibez::Data
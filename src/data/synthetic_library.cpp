@@ -0,0 +1,239 @@
+#include "synthetic_library.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+#include "path_utils.hpp"
+#include "uuid_utils.hpp"
+
+namespace AutoVibez::Data {
+
+namespace {
+constexpr int64_t DAY_MS = 24LL * 60 * 60 * 1000;
+constexpr int HISTORY_DAYS = 365;    // Span of the generated play history
+constexpr int MAX_PLAY_COUNT = 500;  // Heaviest rotation a generated mix gets
+constexpr int MIN_DURATION_SECONDS = 30 * 60;
+constexpr int MAX_DURATION_SECONDS = 4 * 60 * 60;
+
+const char* const GENRES[] = {"Techno",      "House",       "Deep House", "Drum & Bass", "Trance",    "Ambient",
+                              "Dubstep",     "Breakbeat",   "Minimal",    "Tech House",  "Disco",     "Garage",
+                              "Electro",     "Downtempo",   "Progressive", "Hardcore",   "Jungle",    "Acid",
+                              "Dub Techno",  "Psytrance",   "Italo",      "Footwork",    "Leftfield", "Balearic"};
+const char* const SYLLABLES[] = {"ka", "lo", "mi", "ra", "ven", "tor", "sa", "ni", "del", "ko", "bri", "zan",
+                                 "el", "mo", "ru", "ta", "fen", "dro", "li", "ax", "vo", "sel", "qui", "ber"};
+const char* const WORDS[] = {"deep",    "acid",  "warehouse", "sunrise", "vinyl", "minimal", "disco",  "garage",
+                             "melodic", "dub",   "live",      "festival", "late", "night",   "session", "radio",
+                             "basement", "open", "air",       "closing", "set",  "b2b",     "summer",  "winter"};
+const char* const TAGS[] = {"live", "radio", "festival", "vinyl", "b2b", "classic", "podcast", "boiler-room"};
+
+template <typename T, size_t N>
+constexpr int countOf(const T (&)[N]) {
+    return static_cast<int>(N);
+}
+
+std::string genreName(int rank) {
+    if (rank < countOf(GENRES)) {
+        return GENRES[rank];
+    }
+    return "Genre " + std::to_string(rank + 1);
+}
+
+// Two or three syllables, capitalized, numbered past the combinations there are
+std::string artistName(int rank) {
+    const int syllables = countOf(SYLLABLES);
+    std::string name = std::string(SYLLABLES[rank % syllables]) + SYLLABLES[(rank / syllables) % syllables];
+    if (rank % 3 == 0) {
+        name += SYLLABLES[(rank / 7) % syllables];
+    }
+    name[0] = static_cast<char>(name[0] - 'a' + 'A');
+    if (rank >= syllables * syllables) {
+        name += " " + std::to_string(rank / (syllables * syllables));
+    }
+    return name;
+}
+
+std::string word(std::mt19937& engine) {
+    return WORDS[std::uniform_int_distribution<int>(0, countOf(WORDS) - 1)(engine)];
+}
+
+// Double-quoted YAML scalar
+std::string quoted(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+}  // namespace
+
+ZipfDistribution::ZipfDistribution(int count, double exponent) {
+    _cumulative.resize(static_cast<size_t>(std::max(count, 1)));
+    double total = 0.0;
+    for (size_t i = 0; i < _cumulative.size(); ++i) {
+        total += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+        _cumulative[i] = total;
+    }
+    for (double& value : _cumulative) {
+        value /= total;
+    }
+}
+
+int ZipfDistribution::operator()(std::mt19937& engine) const {
+    const double target = std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+    const auto it = std::upper_bound(_cumulative.begin(), _cumulative.end(), target);
+    return static_cast<int>(std::min<size_t>(it - _cumulative.begin(), _cumulative.size() - 1));
+}
+
+SyntheticLibrary::SyntheticLibrary(const SyntheticLibraryOptions& options) : _options(options) {
+    _options.mixes = std::max(_options.mixes, 0);
+    _options.genres = std::max(_options.genres, 1);
+    if (_options.artists <= 0) {
+        _options.artists = std::max(_options.mixes / 20, 1);
+    }
+    if (_options.now_ms == 0) {
+        _options.now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+    }
+}
+
+Mix SyntheticLibrary::makeMix(int index, std::mt19937& engine, const ZipfDistribution& genres,
+                              const ZipfDistribution& artists) const {
+    Mix mix;
+    mix.original_filename = "mix-" + std::to_string(index) + StringConstants::MP3_EXTENSION;
+    mix.url = _options.url_base + mix.original_filename;
+    mix.id = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(mix.url);
+    mix.genre = genreName(genres(engine));
+    mix.artist = artistName(artists(engine));
+    std::string first = word(engine);
+    first[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(first[0])));
+    mix.title = first + " " + word(engine) + " " + std::to_string(index);
+    mix.description = word(engine) + " " + word(engine) + " " + word(engine);
+    mix.duration_seconds = std::uniform_int_distribution<int>(MIN_DURATION_SECONDS, MAX_DURATION_SECONDS)(engine);
+    const int tags = std::uniform_int_distribution<int>(0, 3)(engine);
+    for (int i = 0; i < tags; ++i) {
+        const char* tag = TAGS[std::uniform_int_distribution<int>(0, countOf(TAGS) - 1)(engine)];
+        if (std::find(mix.tags.begin(), mix.tags.end(), tag) == mix.tags.end()) {
+            mix.tags.emplace_back(tag);
+        }
+    }
+    return mix;
+}
+
+std::vector<Mix> SyntheticLibrary::generateManifest() const {
+    std::mt19937 engine(_options.seed);
+    const ZipfDistribution genres(_options.genres, _options.zipf_exponent);
+    const ZipfDistribution artists(_options.artists, _options.zipf_exponent);
+    std::vector<Mix> manifest;
+    manifest.reserve(static_cast<size_t>(_options.mixes));
+    for (int i = 0; i < _options.mixes; ++i) {
+        manifest.push_back(makeMix(i, engine, genres, artists));
+    }
+    return manifest;
+}
+
+std::vector<Mix> SyntheticLibrary::generateLibrary(const std::vector<Mix>& manifest,
+                                                   const std::string& mixes_dir) const {
+    std::mt19937 engine(_options.seed + 1);
+    std::bernoulli_distribution played(_options.played_fraction);
+    std::bernoulli_distribution favorite(_options.favorite_fraction);
+    const ZipfDistribution plays(MAX_PLAY_COUNT, _options.zipf_exponent + 1.0);
+    std::uniform_int_distribution<int64_t> age(0, HISTORY_DAYS * DAY_MS);
+
+    std::vector<Mix> library;
+    for (const Mix& entry : manifest) {
+        if (!played(engine)) {
+            continue;
+        }
+        Mix mix = entry;
+        mix.play_count = plays(engine) + 1;
+        mix.last_played_ms = _options.now_ms - age(engine);
+        mix.date_added_ms = mix.last_played_ms - age(engine) / 4;
+        mix.is_favorite = favorite(engine);
+        // Measured when first downloaded, so nothing is queued for analysis at startup
+        mix.has_analysis = true;
+        mix.bpm = std::uniform_real_distribution<double>(90.0, 175.0)(engine);
+        mix.loudness_lufs = std::uniform_real_distribution<double>(-16.0, -7.0)(engine);
+        mix.peak_dbfs = std::uniform_real_distribution<double>(-3.0, 0.0)(engine);
+        mix.spectral_centroid_hz = std::uniform_real_distribution<double>(800.0, 5000.0)(engine);
+        library.push_back(std::move(mix));
+    }
+
+    // The cache keeps what was played last; older files were evicted and their rows kept
+    std::vector<size_t> recent(library.size());
+    for (size_t i = 0; i < recent.size(); ++i) {
+        recent[i] = i;
+    }
+    const size_t cached = std::min(recent.size(), static_cast<size_t>(std::max(_options.downloaded, 0)));
+    std::partial_sort(recent.begin(), recent.begin() + static_cast<std::ptrdiff_t>(cached), recent.end(),
+                      [&library](size_t a, size_t b) { return library[a].last_played_ms > library[b].last_played_ms; });
+    for (size_t i = 0; i < cached; ++i) {
+        Mix& mix = library[recent[i]];
+        mix.local_path = AutoVibez::Utils::PathUtils::joinPath(mixes_dir, mix.id + StringConstants::MP3_EXTENSION);
+    }
+    return library;
+}
+
+std::vector<Mix> SyntheticLibrary::evolveManifest(const std::vector<Mix>& manifest, double changed_fraction) const {
+    std::mt19937 engine(_options.seed + 2);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    const double each = std::clamp(changed_fraction, 0.0, 1.0) / 3.0;
+
+    std::vector<Mix> evolved;
+    evolved.reserve(manifest.size() + static_cast<size_t>(each * static_cast<double>(manifest.size())) + 1);
+    int added = 0;
+    for (const Mix& entry : manifest) {
+        const double roll = chance(engine);
+        if (roll < each) {
+            continue;  // Removed
+        }
+        evolved.push_back(entry);
+        if (roll < 2.0 * each) {
+            evolved.back().title += " (remastered)";
+        } else if (roll < 3.0 * each) {
+            ++added;
+        }
+    }
+
+    // New entries continue the numbering, so their URLs and ids are new too
+    const ZipfDistribution genres(_options.genres, _options.zipf_exponent);
+    const ZipfDistribution artists(_options.artists, _options.zipf_exponent);
+    const int first = static_cast<int>(manifest.size());
+    for (int i = 0; i < added; ++i) {
+        evolved.push_back(makeMix(first + i, engine, genres, artists));
+    }
+    return evolved;
+}
+
+bool SyntheticLibrary::writeManifest(const std::vector<Mix>& mixes, const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << "mixes:\n";
+    for (const Mix& mix : mixes) {
+        file << "  - id: " << quoted(mix.id) << "\n";
+        file << "    url: " << quoted(mix.url) << "\n";
+        file << "    title: " << quoted(mix.title) << "\n";
+        file << "    artist: " << quoted(mix.artist) << "\n";
+        file << "    genre: " << quoted(mix.genre) << "\n";
+        file << "    description: " << quoted(mix.description) << "\n";
+        file << "    duration_seconds: " << mix.duration_seconds << "\n";
+        if (!mix.tags.empty()) {
+            file << "    tags: [";
+            for (size_t i = 0; i < mix.tags.size(); ++i) {
+                file << (i ? ", " : "") << quoted(mix.tags[i]);
+            }
+            file << "]\n";
+        }
+    }
+    return static_cast<bool>(file.flush());
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Ranks 1..count drawn with probability proportional to 1 / rank^exponent
+ */
+class ZipfDistribution {
+public:
+    ZipfDistribution(int count, double exponent);
+
+    /**
+     * @return A zero-based rank, 0 being the most likely
+     */
+    int operator()(std::mt19937& engine) const;
+
+    int count() const {
+        return static_cast<int>(_cumulative.size());
+    }
+
+private:
+    std::vector<double> _cumulative;  // Normalized, so the last is 1
+};
+
+/**
+ * @brief Shape of a generated catalog
+ */
+struct SyntheticLibraryOptions {
+    int mixes = 10000;
+    int genres = 60;
+    int artists = 0;                  // 0 for one per 20 mixes
+    double zipf_exponent = 1.0;       // Skew of genre and artist popularity, and of play counts
+    double played_fraction = 0.3;     // Manifest entries the library holds, having been downloaded once
+    double favorite_fraction = 0.05;  // Of the library
+    int downloaded = 200;             // Most recently played library mixes whose file is still cached
+    int64_t now_ms = 0;               // Play history ends here; 0 for the current time
+    uint32_t seed = 1;
+    // A closed local port, so downloads of these mixes fail at once without leaving the machine
+    std::string url_base = "http://127.0.0.1:9/mixes/";
+};
+
+/**
+ * @brief Deterministic catalogs shaped like a real collection, for scaling runs
+ *
+ * A few genres and artists account for most mixes, as in real manifests, and
+ * play counts follow the same skew. Ids are derived from the URLs the way the
+ * manifest loader derives them, so a library built from these mixes needs no
+ * id repair at startup. The same options and seed always give the same catalog.
+ */
+class SyntheticLibrary {
+public:
+    explicit SyntheticLibrary(const SyntheticLibraryOptions& options = SyntheticLibraryOptions());
+
+    /**
+     * @brief The manifest: id, URL, title, artist, genre, duration, tags and description per mix
+     */
+    std::vector<Mix> generateManifest() const;
+
+    /**
+     * @brief The library after months of use: a subset of the manifest with play history
+     *
+     * Play counts, last-played times and favorites are set; the `downloaded` most
+     * recently played mixes get a local path in mixes_dir named as the downloader
+     * names files, the others an empty one, as after cache eviction.
+     */
+    std::vector<Mix> generateLibrary(const std::vector<Mix>& manifest, const std::string& mixes_dir) const;
+
+    /**
+     * @brief The manifest as published later: a fraction of entries retitled, removed or added
+     * @param changed_fraction Split evenly between the three kinds of change
+     */
+    std::vector<Mix> evolveManifest(const std::vector<Mix>& manifest, double changed_fraction) const;
+
+    /**
+     * @brief Write mixes as a manifest in the format MixMetadata loads
+     * @return False if the file could not be written
+     */
+    static bool writeManifest(const std::vector<Mix>& mixes, const std::string& path);
+
+    const SyntheticLibraryOptions& getOptions() const {
+        return _options;
+    }
+
+private:
+    SyntheticLibraryOptions _options;
+
+    Mix makeMix(int index, std::mt19937& engine, const ZipfDistribution& genres,
+                const ZipfDistribution& artists) const;
+};
+
+}  // namespace AutoVibez::Data
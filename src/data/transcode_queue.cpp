@@ -0,0 +1,81 @@
+#include "transcode_queue.hpp"
+
+#include <exception>
+#include <utility>
+
+#include "console_output.hpp"
+#include "task_executor.hpp"
+
+using AutoVibez::Utils::TaskExecutor;
+using AutoVibez::Utils::TaskPriority;
+
+namespace AutoVibez::Data {
+
+TranscodeQueue::TranscodeQueue(Transcoder transcoder) : transcoder_(std::move(transcoder)) {}
+
+TranscodeQueue::~TranscodeQueue() {
+    stop();
+}
+
+void TranscodeQueue::enqueue(const Mix& mix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_ || !pending_.insert(mix.id).second) {
+        return;
+    }
+    queue_.push_back(mix);
+    if (!running_) {
+        running_ = true;
+        post();
+    }
+}
+
+size_t TranscodeQueue::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void TranscodeQueue::stop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+    cancel_.cancel();
+    idle_.wait(lock, [this]() { return !running_; });
+    pending_.clear();
+}
+
+void TranscodeQueue::post() {
+    TaskExecutor::shared().post(TaskPriority::Maintenance, [this]() { runNext(); });
+}
+
+void TranscodeQueue::runNext() {
+    Mix mix;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.empty()) {
+            running_ = false;
+            idle_.notify_all();
+            return;
+        }
+        mix = std::move(queue_.front());
+        queue_.pop_front();
+    }
+
+    // Caught here rather than by the executor, so the queue still moves on and stop() still returns
+    try {
+        transcoder_(mix, cancel_);
+    } catch (const std::exception& e) {
+        AutoVibez::Utils::ConsoleOutput::warning("Transcoding " + mix.title + " failed: " + e.what());
+    }
+
+    // Back of the line, behind whatever else was queued while this one ran
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(mix.id);
+    if (stopping_ || queue_.empty()) {
+        running_ = false;
+        idle_.notify_all();
+        return;
+    }
+    post();
+}
+
+}  // namespace AutoVibez::Data
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "cancellation_token.hpp"
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::Data {
+
+/**
+ * @brief Mixes waiting for their low-bitrate copy, transcoded one at a time in idle time
+ *
+ * Each mix is its own TaskPriority::Maintenance task on the shared executor, posted
+ * only once the previous one returns, so the stage holds at most one worker and
+ * anything more urgent queued meanwhile runs first. A mix already queued or in
+ * progress is not queued again. Thread-safe.
+ */
+class TranscodeQueue {
+public:
+    // Runs on an executor worker; the token is cancelled by stop()
+    using Transcoder = std::function<void(const Mix& mix, const AutoVibez::Utils::CancellationToken& cancel)>;
+
+    explicit TranscodeQueue(Transcoder transcoder);
+
+    /**
+     * @brief Stops, see stop()
+     */
+    ~TranscodeQueue();
+
+    TranscodeQueue(const TranscodeQueue&) = delete;
+    TranscodeQueue& operator=(const TranscodeQueue&) = delete;
+
+    void enqueue(const Mix& mix);
+
+    /**
+     * @brief Mixes queued or in progress
+     */
+    size_t getPendingCount() const;
+
+    /**
+     * @brief Drop the queued mixes, cancel the one in progress and wait for it to return
+     */
+    void stop();
+
+private:
+    void post();
+    void runNext();
+
+    Transcoder transcoder_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::deque<Mix> queue_;
+    std::unordered_set<std::string> pending_;
+    bool running_ = false;  // A task is posted or transcoding
+    bool stopping_ = false;
+    AutoVibez::Utils::CancellationToken cancel_;
+};
+
+}  // namespace AutoVibez::Data
@@ -21,6 +21,15 @@ constexpr const char* TEXTURES_DIR = "textures";
 constexpr const char* CONFIG_FILE = "config.inp";
 constexpr const char* DATABASE_FILE = "autovibez_mixes.db";
 constexpr const char* FILE_MAPPINGS_FILE = "file_mappings.txt";
+constexpr const char* PROBE_CACHE_FILE = "mp3_probe_cache.txt";
+constexpr const char* LIBRARY_SCAN_CACHE_FILE = "library_scan_cache.txt";
+constexpr const char* PRESET_COST_DATABASE_FILE = "autovibez_presets.db";
+constexpr const char* PRESET_MANIFEST_FILE = "preset_manifest.txt";
+constexpr const char* TEXTURE_CACHE_INDEX_FILE = "texture_cache.txt";
+constexpr const char* MANIFEST_CACHE_FILE = "mixes_manifest.txt";
+constexpr const char* MANIFEST_SNAPSHOT_FILE = "mixes_manifest.bin";
+constexpr const char* SHARED_CATALOG_FILE = "autovibez_mixes.catalog";
+constexpr const char* RESUME_STATE_FILE = "resume.txt";
 
 constexpr const char* ENV_HOME = "HOME";
 constexpr const char* ENV_USERPROFILE = "USERPROFILE";
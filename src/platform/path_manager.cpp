@@ -1,9 +1,12 @@
 #include "path_manager.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 
 #include "constants.hpp"
 #include "path_constants.hpp"
@@ -14,7 +17,7 @@
 #include <windows.h>
 #endif
 
-std::string PathManager::getConfigDirectory() {
+std::string PathManager::resolveConfigDirectory() {
     std::string config_dir;
 
 #ifdef _WIN32
@@ -40,11 +43,10 @@ std::string PathManager::getConfigDirectory() {
     config_dir = joinPath(joinPath(getXDGConfigHome(), PathConstants::APP_NAME), PathConstants::CONFIG_DIR);
 #endif
 
-    ensureDirectoryExists(config_dir);
     return config_dir;
 }
 
-std::string PathManager::getAssetsDirectory() {
+std::string PathManager::resolveAssetsDirectory() {
     std::string assets_dir;
 
 #ifdef _WIN32
@@ -70,11 +72,10 @@ std::string PathManager::getAssetsDirectory() {
     assets_dir = joinPath(joinPath(getXDGDataHome(), PathConstants::APP_NAME), PathConstants::ASSETS_DIR);
 #endif
 
-    ensureDirectoryExists(assets_dir);
     return assets_dir;
 }
 
-std::string PathManager::getDataDirectory() {
+std::string PathManager::resolveDataDirectory() {
     std::string data_dir;
 
 #ifdef _WIN32
@@ -98,7 +99,6 @@ std::string PathManager::getDataDirectory() {
     data_dir = joinPath(getXDGDataHome(), PathConstants::APP_NAME);
 #endif
 
-    ensureDirectoryExists(data_dir);
     return data_dir;
 }
 
@@ -140,7 +140,7 @@ std::string PathManager::expandTilde(const std::string& path) {
     return path;
 }
 
-std::string PathManager::getCacheDirectory() {
+std::string PathManager::resolveCacheDirectory() {
     std::string cache_dir;
 
     if (isWindows()) {
@@ -162,11 +162,10 @@ std::string PathManager::getCacheDirectory() {
         cache_dir = joinPath(getXDGCacheHome(), PathConstants::APP_NAME);
     }
 
-    ensureDirectoryExists(cache_dir);
     return cache_dir;
 }
 
-std::string PathManager::getStateDirectory() {
+std::string PathManager::resolveStateDirectory() {
     std::string state_dir;
 
     if (isWindows()) {
@@ -188,7 +187,6 @@ std::string PathManager::getStateDirectory() {
         state_dir = joinPath(getXDGStateHome(), PathConstants::APP_NAME);
     }
 
-    ensureDirectoryExists(state_dir);
     return state_dir;
 }
 
@@ -228,24 +226,173 @@ void PathManager::ensureDirectoryExists(const std::string& path) {
     }
 }
 
-std::string PathManager::getDatabasePath() {
-    return joinPath(getStateDirectory(), PathConstants::DATABASE_FILE);
+// ===== Resolved Paths =====
+
+struct PathManager::Resolved {
+    Directories directories;
+    std::string database;
+    std::string mixes;
+    std::string file_mappings;
+    std::string probe_cache;
+    std::string library_scan_cache;
+    std::string preset_cost_database;
+    std::string preset_manifest;
+    std::string texture_cache;
+    std::string texture_cache_index;
+    std::string manifest_cache;
+    std::string manifest_snapshot;
+    std::string shared_catalog;
+    std::string resume_state;
+    std::string presets;
+    std::string textures;
+};
+
+// Sets replaced by setDirectories() are kept, so references handed out earlier stay valid
+struct PathManager::Cache {
+    std::mutex mutex;
+    std::atomic<const Resolved*> current{nullptr};
+    std::vector<std::unique_ptr<const Resolved>> retained;
+};
+
+PathManager::Cache& PathManager::cache() {
+    static Cache* instance = new Cache();  // Never destroyed, so paths stay readable during static teardown
+    return *instance;
+}
+
+const PathManager::Resolved& PathManager::resolved() {
+    Cache& state = cache();
+    const Resolved* paths = state.current.load(std::memory_order_acquire);
+    if (paths) {
+        return *paths;
+    }
+    std::lock_guard<std::mutex> lock(state.mutex);
+    paths = state.current.load(std::memory_order_relaxed);
+    if (!paths) {
+        paths = publish(Directories{resolveConfigDirectory(), resolveAssetsDirectory(), resolveDataDirectory(),
+                                    resolveCacheDirectory(), resolveStateDirectory()});
+    }
+    return *paths;
+}
+
+void PathManager::setDirectories(const Directories& directories) {
+    std::lock_guard<std::mutex> lock(cache().mutex);
+    publish(directories);
+}
+
+void PathManager::resetDirectories() {
+    std::lock_guard<std::mutex> lock(cache().mutex);
+    cache().current.store(nullptr, std::memory_order_release);
+}
+
+const PathManager::Resolved* PathManager::publish(const Directories& directories) {
+    // The directories are created here, once, rather than on every lookup
+    for (const std::string* directory : {&directories.config, &directories.assets, &directories.data,
+                                         &directories.cache, &directories.state}) {
+        ensureDirectoryExists(*directory);
+    }
+
+    auto paths = std::make_unique<Resolved>();
+    paths->directories = directories;
+    paths->database = joinPath(directories.state, PathConstants::DATABASE_FILE);
+    paths->mixes = joinPath(directories.data, PathConstants::MIXES_DIR);
+    paths->file_mappings = joinPath(directories.state, PathConstants::FILE_MAPPINGS_FILE);
+    paths->probe_cache = joinPath(directories.cache, PathConstants::PROBE_CACHE_FILE);
+    paths->library_scan_cache = joinPath(directories.cache, PathConstants::LIBRARY_SCAN_CACHE_FILE);
+    paths->preset_cost_database = joinPath(directories.state, PathConstants::PRESET_COST_DATABASE_FILE);
+    paths->preset_manifest = joinPath(directories.state, PathConstants::PRESET_MANIFEST_FILE);
+    paths->texture_cache = joinPath(directories.cache, PathConstants::TEXTURES_DIR);
+    paths->texture_cache_index = joinPath(directories.cache, PathConstants::TEXTURE_CACHE_INDEX_FILE);
+    paths->manifest_cache = joinPath(directories.cache, PathConstants::MANIFEST_CACHE_FILE);
+    paths->manifest_snapshot = joinPath(directories.cache, PathConstants::MANIFEST_SNAPSHOT_FILE);
+    paths->shared_catalog = joinPath(directories.state, PathConstants::SHARED_CATALOG_FILE);
+    paths->resume_state = joinPath(directories.state, PathConstants::RESUME_STATE_FILE);
+    paths->presets = joinPath(directories.assets, PathConstants::PRESETS_DIR);
+    paths->textures = joinPath(directories.assets, PathConstants::TEXTURES_DIR);
+
+    const Resolved* published = paths.get();
+    cache().retained.push_back(std::move(paths));
+    cache().current.store(published, std::memory_order_release);
+    return published;
+}
+
+const std::string& PathManager::getConfigDirectory() {
+    return resolved().directories.config;
+}
+
+const std::string& PathManager::getAssetsDirectory() {
+    return resolved().directories.assets;
+}
+
+const std::string& PathManager::getDataDirectory() {
+    return resolved().directories.data;
+}
+
+const std::string& PathManager::getCacheDirectory() {
+    return resolved().directories.cache;
+}
+
+const std::string& PathManager::getStateDirectory() {
+    return resolved().directories.state;
+}
+
+const std::string& PathManager::getDatabasePath() {
+    return resolved().database;
+}
+
+const std::string& PathManager::getMixesDirectory() {
+    return resolved().mixes;
+}
+
+const std::string& PathManager::getFileMappingsPath() {
+    return resolved().file_mappings;
+}
+
+const std::string& PathManager::getProbeCachePath() {
+    return resolved().probe_cache;
+}
+
+const std::string& PathManager::getLibraryScanCachePath() {
+    return resolved().library_scan_cache;
+}
+
+const std::string& PathManager::getPresetCostDatabasePath() {
+    return resolved().preset_cost_database;
+}
+
+const std::string& PathManager::getPresetManifestPath() {
+    return resolved().preset_manifest;
+}
+
+const std::string& PathManager::getTextureCacheDirectory() {
+    return resolved().texture_cache;
+}
+
+const std::string& PathManager::getTextureCacheIndexPath() {
+    return resolved().texture_cache_index;
+}
+
+const std::string& PathManager::getManifestCachePath() {
+    return resolved().manifest_cache;
+}
+
+const std::string& PathManager::getManifestSnapshotPath() {
+    return resolved().manifest_snapshot;
 }
 
-std::string PathManager::getMixesDirectory() {
-    return joinPath(getDataDirectory(), PathConstants::MIXES_DIR);
+const std::string& PathManager::getSharedCatalogPath() {
+    return resolved().shared_catalog;
 }
 
-std::string PathManager::getFileMappingsPath() {
-    return joinPath(getStateDirectory(), PathConstants::FILE_MAPPINGS_FILE);
+const std::string& PathManager::getResumeStatePath() {
+    return resolved().resume_state;
 }
 
-std::string PathManager::getPresetsDirectory() {
-    return joinPath(getAssetsDirectory(), PathConstants::PRESETS_DIR);
+const std::string& PathManager::getPresetsDirectory() {
+    return resolved().presets;
 }
 
-std::string PathManager::getTexturesDirectory() {
-    return joinPath(getAssetsDirectory(), PathConstants::TEXTURES_DIR);
+const std::string& PathManager::getTexturesDirectory() {
+    return resolved().textures;
 }
 
 std::vector<std::string> PathManager::getConfigFileSearchPaths() {
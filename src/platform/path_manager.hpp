@@ -7,33 +7,58 @@
 /**
  * Single source of truth for all directory and path management.
  * Provides XDG-compliant, cross-platform directory resolution.
+ *
+ * The directories and every path under them are resolved once, on first use, and the
+ * getters return the cached strings afterwards without touching the environment or the
+ * file system. The references they return stay valid for the life of the process.
  */
 class PathManager {
 public:
+    /**
+     * The five base directories every other path is built from
+     */
+    struct Directories {
+        std::string config;
+        std::string assets;
+        std::string data;
+        std::string cache;
+        std::string state;
+    };
+
+    /**
+     * Use these directories instead of the platform's, creating them if needed (tests point this at a temp dir)
+     */
+    static void setDirectories(const Directories& directories);
+
+    /**
+     * Drop the cached paths so the next lookup resolves them from the platform again
+     */
+    static void resetDirectories();
+
     /**
      * Get the XDG config directory for autovibez (cross-platform)
      */
-    static std::string getConfigDirectory();
+    static const std::string& getConfigDirectory();
 
     /**
      * Get the XDG assets directory for autovibez (cross-platform)
      */
-    static std::string getAssetsDirectory();
+    static const std::string& getAssetsDirectory();
 
     /**
      * Get the data directory path
      */
-    static std::string getDataDirectory();
+    static const std::string& getDataDirectory();
 
     /**
      * Get the cache directory path
      */
-    static std::string getCacheDirectory();
+    static const std::string& getCacheDirectory();
 
     /**
      * Get the state directory path
      */
-    static std::string getStateDirectory();
+    static const std::string& getStateDirectory();
 
     /**
      * Find the configuration file to use (follows XDG spec)
@@ -43,27 +68,77 @@ public:
     /**
      * Get the database file path
      */
-    static std::string getDatabasePath();
+    static const std::string& getDatabasePath();
 
     /**
      * Get the mixes directory path (user's downloaded music)
      */
-    static std::string getMixesDirectory();
+    static const std::string& getMixesDirectory();
 
     /**
      * Get the file mappings path (maps hash IDs to title-based filenames)
      */
-    static std::string getFileMappingsPath();
+    static const std::string& getFileMappingsPath();
+
+    /**
+     * Get the MP3 probe cache path (validation verdicts keyed on size and mtime)
+     */
+    static const std::string& getProbeCachePath();
+
+    /**
+     * Get the probe cache of files imported in place, which lets a re-run skip unchanged ones
+     */
+    static const std::string& getLibraryScanCachePath();
+
+    /**
+     * Get the preset cost database path (render timings per preset, next to the mix database)
+     */
+    static const std::string& getPresetCostDatabasePath();
+
+    /**
+     * Get the preset manifest path (every preset file, so startup need not walk the preset tree)
+     */
+    static const std::string& getPresetManifestPath();
+
+    /**
+     * Get the texture cache directory (textures transcoded for faster loading, mirroring the textures directory)
+     */
+    static const std::string& getTextureCacheDirectory();
+
+    /**
+     * Get the texture cache index path (source size and mtime of each cached texture)
+     */
+    static const std::string& getTextureCacheIndexPath();
+
+    /**
+     * Get the mixes manifest cache path (last remote manifest with its ETag and Last-Modified)
+     */
+    static const std::string& getManifestCachePath();
+
+    /**
+     * Get the mixes manifest snapshot path (the parsed manifest compiled to a binary file)
+     */
+    static const std::string& getManifestSnapshotPath();
+
+    /**
+     * Get the shared catalog path (the mix library as the instances on this host map it, beside the database)
+     */
+    static const std::string& getSharedCatalogPath();
+
+    /**
+     * Get the resume record path (the mix, position and queue playing, to pick up from after a crash)
+     */
+    static const std::string& getResumeStatePath();
 
     /**
      * Get the presets directory path
      */
-    static std::string getPresetsDirectory();
+    static const std::string& getPresetsDirectory();
 
     /**
      * Get the textures directory path
      */
-    static std::string getTexturesDirectory();
+    static const std::string& getTexturesDirectory();
 
     /**
      * Expand tilde in paths (cross-platform)
@@ -105,6 +180,18 @@ public:
     static bool isWindows();
 
 private:
+    struct Resolved;
+    struct Cache;
+
+    static Cache& cache();
+    static const Resolved& resolved();
+    static const Resolved* publish(const Directories& directories);
+
+    static std::string resolveConfigDirectory();
+    static std::string resolveAssetsDirectory();
+    static std::string resolveDataDirectory();
+    static std::string resolveCacheDirectory();
+    static std::string resolveStateDirectory();
     static std::string getXDGConfigHome();
     static std::string getXDGDataHome();
     static std::string getXDGCacheHome();
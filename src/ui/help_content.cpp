@@ -0,0 +1,202 @@
+#include "help_content.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+namespace AutoVibez::UI {
+
+namespace {
+const ImVec4 PURPLE(0.8f, 0.4f, 1.0f, 1.0f);
+const ImVec4 ORANGE(1.0f, 0.6f, 0.0f, 1.0f);
+const ImVec4 GREY(0.8f, 0.8f, 0.8f, 1.0f);
+const ImVec4 BLUE(0.4f, 0.8f, 1.0f, 1.0f);
+
+template <typename T>
+bool assign(T& target, const T& value) {
+    if (target == value) {
+        return false;
+    }
+    target = value;
+    return true;
+}
+}  // namespace
+
+HelpContent::HelpContent() {
+    rebuildStatus();
+}
+
+bool HelpContent::setPreset(const std::string& preset) {
+    if (!assign(_preset, preset)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setMix(const std::string& artist, const std::string& title, const std::string& genre) {
+    if (artist == _artist && title == _title && genre == _genre) {
+        return false;
+    }
+    _artist = artist;
+    _title = title;
+    _genre = genre;
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setComingUp(const std::vector<std::string>& mixes) {
+    if (!assign(_comingUp, mixes)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setVolume(int volume) {
+    if (!assign(_volume, volume)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setAudioDevice(const std::string& device) {
+    if (!assign(_audioDevice, device)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setCaptureStats(const std::string& stats) {
+    if (!assign(_captureStats, stats)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setLatencyStats(const std::string& stats) {
+    if (!assign(_latencyStats, stats)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setFrameStats(const std::string& stats) {
+    if (!assign(_frameStats, stats)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+bool HelpContent::setBeatSensitivity(float sensitivity) {
+    if (!assign(_beatSensitivity, sensitivity)) {
+        return false;
+    }
+    rebuildStatus();
+    return true;
+}
+
+void HelpContent::rebuildStatus() {
+    _statusLines.clear();
+    if (!_preset.empty()) {
+        _statusLines.push_back({"  Preset:", _preset, PURPLE});
+    }
+    if (!_artist.empty() && !_title.empty()) {
+        _statusLines.push_back({"  Now playing:", _artist + " - " + _title, ORANGE});
+    }
+
+    // Queued mixes, the label only on the first
+    for (size_t i = 0; i < _comingUp.size(); ++i) {
+        _statusLines.push_back({i == 0 ? "  Coming up:" : "", _comingUp[i], GREY});
+    }
+    if (!_genre.empty()) {
+        _statusLines.push_back({"  Genre:", _genre, BLUE});
+    }
+    if (_volume >= 0) {
+        _statusLines.push_back({"  Volume:", std::to_string(_volume) + "%", BLUE});
+    }
+    if (!_audioDevice.empty()) {
+        _statusLines.push_back({"  Device:", _audioDevice, BLUE});
+    }
+    if (!_captureStats.empty()) {
+        _statusLines.push_back({"  Capture:", _captureStats, BLUE});
+    }
+    if (!_latencyStats.empty()) {
+        _statusLines.push_back({"  Latency:", _latencyStats, BLUE});
+    }
+    if (!_frameStats.empty()) {
+        _statusLines.push_back({"  Frames:", _frameStats, PURPLE});
+    }
+    _statusLines.push_back({"  Beat Sensitivity:", std::to_string(_beatSensitivity).substr(0, 4), PURPLE});
+    _statusRevision++;
+}
+
+void HelpContent::setMixes(const std::vector<AutoVibez::Data::Mix>& mixes) {
+    _mixes = mixes;
+    if (!_searching) {
+        rebuildRows();
+    }
+}
+
+void HelpContent::setSearchResults(const std::vector<AutoVibez::Data::Mix>& mixes) {
+    _searchResults = mixes;
+    _searching = true;
+    rebuildRows();
+}
+
+void HelpContent::clearSearch() {
+    _searchResults.clear();
+    if (_searching) {
+        _searching = false;
+        rebuildRows();
+    }
+}
+
+void HelpContent::toggleFavoritesOnly() {
+    _favoritesOnly = !_favoritesOnly;
+    rebuildRows();
+}
+
+std::string HelpContent::formatDuration(int seconds) {
+    const int minutes = seconds / Constants::SECONDS_PER_MINUTE;
+    const int rest = seconds % Constants::SECONDS_PER_MINUTE;
+    return std::to_string(minutes) + StringConstants::TIME_SEPARATOR +
+           (rest < Constants::TIME_FORMAT_PADDING ? StringConstants::TIME_PADDING : "") + std::to_string(rest);
+}
+
+void HelpContent::rebuildRows() {
+    std::vector<const AutoVibez::Data::Mix*> shown;
+    for (const AutoVibez::Data::Mix& mix : _searching ? _searchResults : _mixes) {
+        if (!_favoritesOnly || mix.is_favorite) {
+            shown.push_back(&mix);
+        }
+    }
+
+    // Favorites first, then by artist and title; search matches keep their rank
+    if (!_searching) {
+        std::sort(shown.begin(), shown.end(), [](const AutoVibez::Data::Mix* a, const AutoVibez::Data::Mix* b) {
+            if (a->is_favorite != b->is_favorite) {
+                return a->is_favorite > b->is_favorite;
+            }
+            if (a->artist != b->artist) {
+                return a->artist < b->artist;
+            }
+            return a->title < b->title;
+        });
+    }
+
+    _rows.clear();
+    _rows.reserve(shown.size());
+    for (const AutoVibez::Data::Mix* mix : shown) {
+        _rows.push_back({"  " + mix->artist, mix->title, mix->genre, formatDuration(mix->duration_seconds),
+                         std::to_string(mix->play_count), mix->is_favorite});
+    }
+    _tableRevision++;
+}
+
+}  // namespace AutoVibez::UI
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mix_metadata.hpp"
+
+namespace AutoVibez::UI {
+
+/**
+ * @brief One line of the help overlay's status section
+ */
+struct HelpStatusLine {
+    std::string label;  //!< Indented, e.g. "  Genre:"; empty past the first "Coming up" entry
+    std::string value;
+    ImVec4 color;
+};
+
+/**
+ * @brief One row of the help overlay's mix table, formatted for display
+ */
+struct HelpMixRow {
+    std::string artist;  //!< Indented like the header
+    std::string title;
+    std::string genre;
+    std::string duration;  //!< M:SS
+    std::string plays;
+    bool favorite = false;
+};
+
+/**
+ * @brief Text behind the help overlay, rebuilt when something changes rather than every frame
+ *
+ * Setters compare with what is shown and only rebuild the status lines or table
+ * rows when the value differs, bumping a revision that HelpOverlay checks before
+ * measuring anything again. While the overlay stays open on a display with
+ * nothing changing, every frame draws the same strings.
+ */
+class HelpContent {
+public:
+    HelpContent();
+
+    // Status section; each returns true if the value changed
+    bool setPreset(const std::string& preset);
+    bool setMix(const std::string& artist, const std::string& title, const std::string& genre);
+    bool setComingUp(const std::vector<std::string>& mixes);
+    bool setVolume(int volume);
+    bool setAudioDevice(const std::string& device);
+    bool setCaptureStats(const std::string& stats);
+    bool setLatencyStats(const std::string& stats);
+    bool setFrameStats(const std::string& stats);
+    bool setBeatSensitivity(float sensitivity);
+
+    const std::vector<HelpStatusLine>& getStatusLines() const {
+        return _statusLines;
+    }
+    uint64_t getStatusRevision() const {
+        return _statusRevision;
+    }
+
+    // Mix table
+    void setMixes(const std::vector<AutoVibez::Data::Mix>& mixes);
+
+    /**
+     * @brief Show ranked matches in place of the library, in their order (active with an empty list too)
+     */
+    void setSearchResults(const std::vector<AutoVibez::Data::Mix>& mixes);
+
+    /**
+     * @brief Go back to the library, e.g. when the search box is cleared
+     */
+    void clearSearch();
+
+    void toggleFavoritesOnly();
+
+    bool isSearching() const {
+        return _searching;
+    }
+    size_t getSearchResultCount() const {
+        return _searchResults.size();
+    }
+    bool hasMixes() const {
+        return !_mixes.empty();
+    }
+
+    /**
+     * @brief Library rows with favorites first, then by artist and title; search rows in rank order
+     */
+    const std::vector<HelpMixRow>& getMixRows() const {
+        return _rows;
+    }
+    uint64_t getTableRevision() const {
+        return _tableRevision;
+    }
+
+    static std::string formatDuration(int seconds);
+
+private:
+    void rebuildStatus();
+    void rebuildRows();
+
+    std::string _preset;
+    std::string _artist;
+    std::string _title;
+    std::string _genre;
+    std::vector<std::string> _comingUp;
+    int _volume = -1;
+    std::string _audioDevice;
+    std::string _captureStats;
+    std::string _latencyStats;
+    std::string _frameStats;
+    float _beatSensitivity = 0.0f;
+    std::vector<HelpStatusLine> _statusLines;
+    uint64_t _statusRevision = 0;
+
+    std::vector<AutoVibez::Data::Mix> _mixes;
+    std::vector<AutoVibez::Data::Mix> _searchResults;
+    bool _searching = false;
+    bool _favoritesOnly = false;
+    std::vector<HelpMixRow> _rows;
+    uint64_t _tableRevision = 0;
+};
+
+}  // namespace AutoVibez::UI
@@ -1,17 +1,54 @@
 #include "help_overlay.hpp"
 
-#include <backends/imgui_impl_opengl2.h>
-#include <backends/imgui_impl_sdl2.h>
 #include <imgui.h>
 
+#include <algorithm>
+
 #include "constants.hpp"
 #include "setup.hpp"
 
 namespace AutoVibez::UI {
 
-HelpOverlay::HelpOverlay() {}
+HelpOverlay::HelpOverlay() {
+    _bindingSections = {
+        {"MIX MANAGEMENT",
+         ImVec4(1.0f, 0.6f, 0.0f, 1.0f),
+         ImVec4(1.0f, 0.6f, 0.0f, 0.4f),
+         {{"  Left/Right", "Previous/Next mix"},
+          {"  F", "Toggle favorite"},
+          {"  D", "Delete current mix"},
+          {"  I", "Show current mix info"},
+          {"  L", "Toggle favorites filter"},
+          {"  G", "Play random mix in current genre"},
+          {"  Shift+G", "Switch to random genre"},
+          {"  SPACE", "Pause/Resume playback"}}},
+        {"AUDIO CONTROLS",
+         ImVec4(0.4f, 0.8f, 1.0f, 1.0f),
+         ImVec4(0.4f, 0.8f, 1.0f, 0.4f),
+         {{"  M", "Mute/Unmute audio"},
+          {"  Up/Down", "Volume up/down"},
+          {"  Tab", "Cycle through audio devices"},
+          {"  C", "Latency calibration"},
+          {"  ,/.", "Adjust A/V offset"}}},
+        {"VISUALIZER CONTROLS",
+         ImVec4(0.8f, 0.4f, 1.0f, 1.0f),
+         ImVec4(0.8f, 0.4f, 1.0f, 0.4f),
+         {{"  H", "Toggle this help overlay"},
+          {"  F11", "Toggle fullscreen mode"},
+          {"  R", "Load random preset"},
+          {"  P / Shift+P", "Performance HUD / save CSV"},
+          {"  [ / ]", "Previous/Next preset"},
+          {"  +/-", "Increase/Decrease beat sensitivity"}}},
+        {"APPLICATION",
+         ImVec4(1.0f, 0.4f, 0.4f, 1.0f),
+         ImVec4(1.0f, 0.4f, 0.4f, 0.4f),
+         {{"  Ctrl+Q", "Quit application"}}},
+    };
+}
 
 HelpOverlay::~HelpOverlay() {
+    ImGuiManager::removeLayer(this);
+
     // Free cursors
     if (_blankCursor) {
         SDL_FreeCursor(_blankCursor);
@@ -36,50 +73,68 @@ void HelpOverlay::init(SDL_Window* window, SDL_GLContext glContext) {
     // Store the original cursor
     _originalCursor = SDL_GetCursor();
 
+    ImGuiManager::setRenderTarget(_window, _glContext);
+    ImGuiManager::addLayer(this);
     _initialized = true;
 }
 
-void HelpOverlay::render() {
-    if (!_visible)
-        return;
-
-    // Auto-load mix data if not already loaded
-    if (_mixTableData.empty()) {
-        // This will be populated by the app when needed
-        // For now, we'll leave it empty and let the app handle it
-    }
-
-    // Lazy initialize ImGui on first render
-    if (!_imguiReady) {
-        initializeImGui();
+void HelpOverlay::updateLayout() {
+    // Everything below depends on the font; the status and table widths also on their text
+    const float fontSize = ImGui::GetFontSize();
+    const bool fontChanged = fontSize != _layoutFontSize;
+    if (fontChanged) {
+        _layoutFontSize = fontSize;
+        _titleWidth = ImGui::CalcTextSize("AUTOVIBEZ CONTROLS").x;
+        for (BindingSection& section : _bindingSections) {
+            section.maxKeyWidth = 0.0f;
+            for (BindingLine& line : section.lines) {
+                line.keyWidth = ImGui::CalcTextSize(line.key.c_str()).x;
+                section.maxKeyWidth = std::max(section.maxKeyWidth, line.keyWidth);
+            }
+        }
     }
 
-    // Save current OpenGL state and isolate ImGui rendering
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    glPushMatrix();
-
-    // Completely isolate ImGui's texture state
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (fontChanged || _statusLayoutRevision != _content.getStatusRevision()) {
+        _statusLayoutRevision = _content.getStatusRevision();
 
-    // Use a very simple rendering approach
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Start the Dear ImGui frame
-    ImGui_ImplOpenGL2_NewFrame();
-    ImGui_ImplSDL2_NewFrame();
-    ImGui::NewFrame();
+        // Aligned on the widest label that can appear, so values do not shift as lines come and go
+        _statusMaxLabelWidth = 0.0f;
+        for (const char* label : {"  Preset:", "  Now playing:", "  Coming up:", "  Genre:", "  Volume:", "  Device:",
+                                  "  Capture:", "  Latency:", "  Frames:", "  Beat Sensitivity:"}) {
+            _statusMaxLabelWidth = std::max(_statusMaxLabelWidth, ImGui::CalcTextSize(label).x);
+        }
+        const std::vector<HelpStatusLine>& lines = _content.getStatusLines();
+        _statusLabelWidths.resize(lines.size());
+        for (size_t i = 0; i < lines.size(); ++i) {
+            _statusLabelWidths[i] = ImGui::CalcTextSize(lines[i].label.c_str()).x;
+        }
+    }
 
-    // Helper function to create aligned text with consistent spacing
-    auto renderAlignedText = [](const std::string& label, const std::string& value, const ImVec4& valueColor) {
-        ImGui::TextUnformatted(label.c_str());
-        ImGui::SameLine();
-        ImGui::PushStyleColor(ImGuiCol_Text, valueColor);
-        ImGui::TextUnformatted(value.c_str());
-        ImGui::PopStyleColor();
-    };
+    if (fontChanged || _tableLayoutRevision != _content.getTableRevision()) {
+        _tableLayoutRevision = _content.getTableRevision();
+        _matchCountText = std::to_string(_content.getSearchResultCount()) + " matches";
+
+        // Each column as wide as its longest value, plus padding
+        std::array<float, 6> widths = {
+            ImGui::CalcTextSize("Artist").x,   ImGui::CalcTextSize("Title").x, ImGui::CalcTextSize("Genre").x,
+            ImGui::CalcTextSize("Duration").x, ImGui::CalcTextSize("Plays").x, ImGui::CalcTextSize("Favorite").x};
+        for (const HelpMixRow& row : _content.getMixRows()) {
+            widths[0] = std::max(widths[0], ImGui::CalcTextSize(row.artist.c_str()).x);
+            widths[1] = std::max(widths[1], ImGui::CalcTextSize(row.title.c_str()).x);
+            widths[2] = std::max(widths[2], ImGui::CalcTextSize(row.genre.c_str()).x);
+            widths[3] = std::max(widths[3], ImGui::CalcTextSize(row.duration.c_str()).x);
+            widths[4] = std::max(widths[4], ImGui::CalcTextSize(row.plays.c_str()).x);
+            widths[5] = std::max(widths[5], ImGui::CalcTextSize(row.favorite ? "YES" : "NO").x);
+        }
+        float x = 0.0f;
+        for (size_t i = 0; i < widths.size(); ++i) {
+            _tableColumns[i] = x;
+            x += widths[i] + Constants::UI_PADDING;
+        }
+    }
+}
 
+void HelpOverlay::drawWidgets() {
     int windowWidth, windowHeight;
     SDL_GetWindowSize(_window, &windowWidth, &windowHeight);
 
@@ -93,6 +148,7 @@ void HelpOverlay::render() {
 
     // Set larger font size
     ImGui::SetWindowFontScale(1.0f);
+    updateLayout();
 
     // Add some padding at the top
     ImGui::Spacing();
@@ -100,7 +156,7 @@ void HelpOverlay::render() {
 
     // Title with gradient-like effect and better styling
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 0.8f, 1.0f, 1.0f));
-    ImGui::SetCursorPosX((windowWidth - ImGui::CalcTextSize("AUTOVIBEZ CONTROLS").x) * 0.5f);
+    ImGui::SetCursorPosX((windowWidth - _titleWidth) * 0.5f);
     ImGui::TextUnformatted("AUTOVIBEZ CONTROLS");
     ImGui::PopStyleColor();
 
@@ -127,90 +183,22 @@ void HelpOverlay::render() {
     ImGui::Spacing();
 
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.95f, 0.95f, 0.95f, 1.0f));
-
-    // Calculate the maximum label width for alignment
-    float maxLabelWidth = 0.0f;
-    std::vector<std::string> labels = {"Preset:", "Now playing:", "Genre:", "Volume:", "Device:", "Beat Sensitivity:"};
-    for (const auto& label : labels) {
-        float width = ImGui::CalcTextSize(("  " + label).c_str()).x;
-        maxLabelWidth = std::max(maxLabelWidth, width);
+    const std::vector<HelpStatusLine>& statusLines = _content.getStatusLines();
+    for (size_t i = 0; i < statusLines.size(); ++i) {
+        renderStatusLabel(statusLines[i], _statusLabelWidths[i], _statusMaxLabelWidth);
     }
-
-    // Current preset
-    if (!_currentPreset.empty()) {
-        renderStatusLabel("Preset:", _currentPreset, ImVec4(0.8f, 0.4f, 1.0f, 1.0f), maxLabelWidth);
-    }
-
-    // Current mix
-    if (!_currentArtist.empty() && !_currentTitle.empty()) {
-        renderStatusLabel("Now playing:", _currentArtist + " - " + _currentTitle, ImVec4(1.0f, 0.6f, 0.0f, 1.0f),
-                          maxLabelWidth);
-    }
-
-    // Current genre
-    if (!_currentGenre.empty()) {
-        renderStatusLabel("Genre:", _currentGenre, ImVec4(0.4f, 0.8f, 1.0f, 1.0f), maxLabelWidth);
-    }
-
-    // Volume level
-    if (_volumeLevel >= 0) {
-        renderStatusLabel("Volume:", std::to_string(_volumeLevel) + "%", ImVec4(0.4f, 0.8f, 1.0f, 1.0f), maxLabelWidth);
-    }
-
-    // Audio device
-    if (!_audioDevice.empty()) {
-        renderStatusLabel("Device:", _audioDevice, ImVec4(0.4f, 0.8f, 1.0f, 1.0f), maxLabelWidth);
-    }
-
-    // Beat sensitivity
-    renderStatusLabel("Beat Sensitivity:", std::to_string(_beatSensitivity).substr(0, 4),
-                      ImVec4(0.8f, 0.4f, 1.0f, 1.0f), maxLabelWidth);
-
     ImGui::PopStyleColor();
 
-    // Mix Management Section
-    ImGui::Spacing();
-    ImGui::Spacing();
-    ImGui::Spacing();
-    std::vector<KeyBinding> mixManagementBindings = {
-        {"Left/Right", "Previous/Next mix"},   {"F", "Toggle favorite"},
-        {"D", "Delete current mix"},           {"I", "Show current mix info"},
-        {"L", "Toggle favorites filter"},      {"G", "Play random mix in current genre"},
-        {"Shift+G", "Switch to random genre"}, {"SPACE", "Pause/Resume playback"}};
-    renderKeyBindingSection("MIX MANAGEMENT", mixManagementBindings, ImVec4(1.0f, 0.6f, 0.0f, 1.0f),
-                            ImVec4(1.0f, 0.6f, 0.0f, 0.4f));
-
-    // Audio Controls Section
-    ImGui::Spacing();
-    ImGui::Spacing();
-    ImGui::Spacing();
-    std::vector<KeyBinding> audioControlBindings = {
-        {"M", "Mute/Unmute audio"}, {"Up/Down", "Volume up/down"}, {"Tab", "Cycle through audio devices"}};
-    renderKeyBindingSection("AUDIO CONTROLS", audioControlBindings, ImVec4(0.4f, 0.8f, 1.0f, 1.0f),
-                            ImVec4(0.4f, 0.8f, 1.0f, 0.4f));
-
-    // Visualizer Controls Section
-    ImGui::Spacing();
-    ImGui::Spacing();
-    ImGui::Spacing();
-    std::vector<KeyBinding> visualizerControlBindings = {{"H", "Toggle this help overlay"},
-                                                         {"F11", "Toggle fullscreen mode"},
-                                                         {"R", "Load random preset"},
-                                                         {"[ / ]", "Previous/Next preset"},
-                                                         {"+/-", "Increase/Decrease beat sensitivity"}};
-    renderKeyBindingSection("VISUALIZER CONTROLS", visualizerControlBindings, ImVec4(0.8f, 0.4f, 1.0f, 1.0f),
-                            ImVec4(0.8f, 0.4f, 1.0f, 0.4f));
-
-    // Application Section
-    ImGui::Spacing();
-    ImGui::Spacing();
-    ImGui::Spacing();
-    std::vector<KeyBinding> applicationBindings = {{"Ctrl+Q", "Quit application"}};
-    renderKeyBindingSection("APPLICATION", applicationBindings, ImVec4(1.0f, 0.4f, 0.4f, 1.0f),
-                            ImVec4(1.0f, 0.4f, 0.4f, 0.4f));
+    // Key binding sections
+    for (const BindingSection& section : _bindingSections) {
+        ImGui::Spacing();
+        ImGui::Spacing();
+        ImGui::Spacing();
+        renderKeyBindingSection(section);
+    }
 
     // Mix Table Section (always shown if data is available)
-    if (!_mixTableData.empty()) {
+    if (_content.hasMixes()) {
         ImGui::Spacing();
         ImGui::Spacing();
         ImGui::Spacing();
@@ -227,152 +215,73 @@ void HelpOverlay::render() {
         ImGui::PopStyleColor();
         ImGui::Spacing();
 
-        // Table header
-        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.8f, 0.8f, 0.8f, 1.0f));
-
-        // Calculate column widths based on longest values
-        float artistWidth = ImGui::CalcTextSize("Artist").x;
-        float titleWidth = ImGui::CalcTextSize("Title").x;
-        float genreWidth = ImGui::CalcTextSize("Genre").x;
-        float durationWidth = ImGui::CalcTextSize("Duration").x;
-        float playsWidth = ImGui::CalcTextSize("Plays").x;
-        float favoriteWidth = ImGui::CalcTextSize("Favorite").x;
-
-        // Find the longest values in each column
-        for (const auto& mix : _mixTableData) {
-            float artistTextWidth = ImGui::CalcTextSize(mix.artist.c_str()).x;
-            float titleTextWidth = ImGui::CalcTextSize(mix.title.c_str()).x;
-            float genreTextWidth = ImGui::CalcTextSize(mix.genre.c_str()).x;
-
-            // Duration formatting
-            int minutes = mix.duration_seconds / Constants::SECONDS_PER_MINUTE;
-            int seconds = mix.duration_seconds % Constants::SECONDS_PER_MINUTE;
-            std::string duration = std::to_string(minutes) + StringConstants::TIME_SEPARATOR +
-                                   (seconds < Constants::TIME_FORMAT_PADDING ? StringConstants::TIME_PADDING : "") +
-                                   std::to_string(seconds);
-            float durationTextWidth = ImGui::CalcTextSize(duration.c_str()).x;
-
-            // Plays
-            std::string plays = std::to_string(mix.play_count);
-            float playsTextWidth = ImGui::CalcTextSize(plays.c_str()).x;
-
-            // Favorite
-            std::string favorite = mix.is_favorite ? "YES" : "NO";
-            float favoriteTextWidth = ImGui::CalcTextSize(favorite.c_str()).x;
-
-            // Update maximum widths
-            artistWidth = std::max(artistWidth, artistTextWidth);
-            titleWidth = std::max(titleWidth, titleTextWidth);
-            genreWidth = std::max(genreWidth, genreTextWidth);
-            durationWidth = std::max(durationWidth, durationTextWidth);
-            playsWidth = std::max(playsWidth, playsTextWidth);
-            favoriteWidth = std::max(favoriteWidth, favoriteTextWidth);
+        // Search box: while it holds a query the table lists the ranked matches instead
+        if (ImGui::InputTextWithHint("##mix_search", "Search title, artist, description or tags", _searchText,
+                                     sizeof(_searchText))) {
+            if (_searchText[0] == '\0') {
+                _content.clearSearch();
+            } else {
+                _content.setSearchResults({});
+            }
+            if (_searchHandler) {
+                _searchHandler(_searchText);
+            }
         }
+        if (_content.isSearching()) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(_matchCountText.c_str());
+        }
+        ImGui::Spacing();
 
-        // Add some padding to each column
-        float padding = Constants::UI_PADDING;  // Increased from 20.0f to 40.0f for more spacing
-        artistWidth += padding;
-        titleWidth += padding;
-        genreWidth += padding;
-        durationWidth += padding;
-        playsWidth += padding;
-        favoriteWidth += padding;
-
-        // Calculate column positions
-        float startX = ImGui::GetCursorPosX();
-        float artistX = startX;
-        float titleX = artistX + artistWidth;
-        float genreX = titleX + titleWidth;
-        float durationX = genreX + genreWidth;
-        float playsX = durationX + durationWidth;
-        float favoriteX = playsX + playsWidth;
+        // Column positions are relative to where the table starts
+        const float startX = ImGui::GetCursorPosX();
+        const std::array<float, 6>& columns = _tableColumns;
 
         // Header row
-        ImGui::SetCursorPosX(artistX);
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.8f, 0.8f, 0.8f, 1.0f));
+        ImGui::SetCursorPosX(startX + columns[0]);
         ImGui::TextUnformatted("  Artist");
         ImGui::SameLine();
-        ImGui::SetCursorPosX(titleX);
+        ImGui::SetCursorPosX(startX + columns[1]);
         ImGui::TextUnformatted("Title");
         ImGui::SameLine();
-        ImGui::SetCursorPosX(genreX);
+        ImGui::SetCursorPosX(startX + columns[2]);
         ImGui::TextUnformatted("Genre");
         ImGui::SameLine();
-        ImGui::SetCursorPosX(durationX);
+        ImGui::SetCursorPosX(startX + columns[3]);
         ImGui::TextUnformatted("Duration");
         ImGui::SameLine();
-        ImGui::SetCursorPosX(playsX);
+        ImGui::SetCursorPosX(startX + columns[4]);
         ImGui::TextUnformatted("Plays");
         ImGui::SameLine();
-        ImGui::SetCursorPosX(favoriteX);
+        ImGui::SetCursorPosX(startX + columns[5]);
         ImGui::TextUnformatted("Favorite");
         ImGui::PopStyleColor();
 
         ImGui::Spacing();
 
-        // Table data
+        // Table data, already filtered, sorted and formatted
         ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.95f, 0.95f, 0.95f, 1.0f));
-
-        // Sort the data: favorites first, then by artist
-        std::vector<AutoVibez::Data::Mix> sortedMixes = _mixTableData;
-
-        // Apply filter if showing favorites only
-        if (_showFavoritesOnly) {
-            sortedMixes.erase(std::remove_if(sortedMixes.begin(), sortedMixes.end(),
-                                             [](const AutoVibez::Data::Mix& mix) { return !mix.is_favorite; }),
-                              sortedMixes.end());
-        }
-
-        std::sort(sortedMixes.begin(), sortedMixes.end(),
-                  [](const AutoVibez::Data::Mix& a, const AutoVibez::Data::Mix& b) {
-                      // First sort by favorite (favorites first)
-                      if (a.is_favorite != b.is_favorite) {
-                          return a.is_favorite > b.is_favorite;
-                      }
-                      // Then by artist
-                      if (a.artist != b.artist) {
-                          return a.artist < b.artist;
-                      }
-                      // Finally by title
-                      return a.title < b.title;
-                  });
-
-        for (const auto& mix : sortedMixes) {
-            // Artist
-            std::string artist = "  " + mix.artist;
-            ImGui::SetCursorPosX(artistX);
-            ImGui::TextUnformatted(artist.c_str());
-
-            // Title
-            std::string title = mix.title;
+        for (const HelpMixRow& row : _content.getMixRows()) {
+            ImGui::SetCursorPosX(startX + columns[0]);
+            ImGui::TextUnformatted(row.artist.c_str());
             ImGui::SameLine();
-            ImGui::SetCursorPosX(titleX);
-            ImGui::TextUnformatted(title.c_str());
-
-            // Genre
-            std::string genre = mix.genre;
+            ImGui::SetCursorPosX(startX + columns[1]);
+            ImGui::TextUnformatted(row.title.c_str());
             ImGui::SameLine();
-            ImGui::SetCursorPosX(genreX);
-            ImGui::TextUnformatted(genre.c_str());
-
-            // Duration (format as MM:SS)
-            int minutes = mix.duration_seconds / Constants::SECONDS_PER_MINUTE;
-            int seconds = mix.duration_seconds % Constants::SECONDS_PER_MINUTE;
-            std::string duration = std::to_string(minutes) + StringConstants::TIME_SEPARATOR +
-                                   (seconds < Constants::TIME_FORMAT_PADDING ? StringConstants::TIME_PADDING : "") +
-                                   std::to_string(seconds);
+            ImGui::SetCursorPosX(startX + columns[2]);
+            ImGui::TextUnformatted(row.genre.c_str());
             ImGui::SameLine();
-            ImGui::SetCursorPosX(durationX);
-            ImGui::TextUnformatted(duration.c_str());
-
-            // Plays
+            ImGui::SetCursorPosX(startX + columns[3]);
+            ImGui::TextUnformatted(row.duration.c_str());
             ImGui::SameLine();
-            ImGui::SetCursorPosX(playsX);
-            ImGui::TextUnformatted(std::to_string(mix.play_count).c_str());
+            ImGui::SetCursorPosX(startX + columns[4]);
+            ImGui::TextUnformatted(row.plays.c_str());
 
             // Favorite (use text instead of emoji)
             ImGui::SameLine();
-            ImGui::SetCursorPosX(favoriteX);
-            if (mix.is_favorite) {
+            ImGui::SetCursorPosX(startX + columns[5]);
+            if (row.favorite) {
                 ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.2f, 0.2f, 1.0f));
                 ImGui::TextUnformatted("YES");
                 ImGui::PopStyleColor();
@@ -384,14 +293,6 @@ void HelpOverlay::render() {
     }
 
     ImGui::End();
-
-    // Render the Dear ImGui frame
-    ImGui::Render();
-    ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
-
-    // Restore OpenGL state
-    glPopMatrix();
-    glPopAttrib();
 }
 
 void HelpOverlay::setMessageOverlay(MessageOverlay* messageOverlay) {
@@ -443,86 +344,66 @@ void HelpOverlay::setCursorVisibility(bool visible) {
 
 // Dynamic information methods
 void HelpOverlay::setCurrentPreset(const std::string& preset) {
-    _currentPreset = preset;
+    _content.setPreset(preset);
 }
 
 void HelpOverlay::setCurrentMix(const std::string& artist, const std::string& title, const std::string& genre) {
-    _currentArtist = artist;
-    _currentTitle = title;
-    _currentGenre = genre;
+    _content.setMix(artist, title, genre);
+}
+
+void HelpOverlay::setComingUp(const std::vector<std::string>& mixes) {
+    _content.setComingUp(mixes);
 }
 
 void HelpOverlay::setVolumeLevel(int volume) {
-    _volumeLevel = volume;
+    _content.setVolume(volume);
 }
 
 void HelpOverlay::setAudioDevice(const std::string& device) {
-    _audioDevice = device;
+    _content.setAudioDevice(device);
+}
+
+void HelpOverlay::setCaptureStats(const std::string& stats) {
+    _content.setCaptureStats(stats);
+}
+
+void HelpOverlay::setLatencyStats(const std::string& stats) {
+    _content.setLatencyStats(stats);
+}
+
+void HelpOverlay::setFrameStats(const std::string& stats) {
+    _content.setFrameStats(stats);
 }
 
 void HelpOverlay::setBeatSensitivity(float sensitivity) {
-    _beatSensitivity = sensitivity;
+    _content.setBeatSensitivity(sensitivity);
 }
 
 // Mix table methods
 void HelpOverlay::setMixTableData(const std::vector<AutoVibez::Data::Mix>& mixes) {
-    _mixTableData = mixes;
+    _content.setMixes(mixes);
 }
 
 void HelpOverlay::toggleMixTableFilter() {
-    _showFavoritesOnly = !_showFavoritesOnly;
+    _content.toggleFavoritesOnly();
 }
 
-// Helper methods for dynamic key binding alignment
-float HelpOverlay::calculateMaxKeyWidth(const std::vector<KeyBinding>& bindings) {
-    float maxWidth = 0.0f;
-    for (const auto& binding : bindings) {
-        // Add consistent indentation (2 spaces) for width calculation
-        std::string indentedKey = "  " + binding.key;
-        float width = ImGui::CalcTextSize(indentedKey.c_str()).x;
-        maxWidth = std::max(maxWidth, width);
-    }
-    return maxWidth;
+void HelpOverlay::setSearchHandler(std::function<void(const std::string& query)> handler) {
+    _searchHandler = std::move(handler);
 }
 
-void HelpOverlay::initializeImGui() {
-    // Use centralized ImGui initialization
-    if (AutoVibez::UI::ImGuiManager::initialize(_window, _glContext)) {
-        // Configure ImGui for this overlay
-        ImGuiIO& io = ImGui::GetIO();
-
-        // Add default font with explicit atlas building
-        io.Fonts->AddFontDefault();
-        io.FontGlobalScale = 1.0f;
-
-        // Explicitly build the font atlas
-        unsigned char* pixels;
-        int width, height;
-        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
-
-        // Set INI file path to user config directory
-        std::string configDir = getConfigDirectory();
-        if (!configDir.empty()) {
-            std::string iniPath = configDir + "/imgui.ini";
-            io.IniFilename = strdup(iniPath.c_str());
-        }
-
-        // Setup Dear ImGui style
-        ImGui::StyleColorsDark();
-
-        // Explicitly create the font texture
-        ImGui_ImplOpenGL2_CreateFontsTexture();
-
-        _imguiReady = true;
+void HelpOverlay::setSearchResults(const std::string& query, const std::vector<AutoVibez::Data::Mix>& mixes) {
+    if (!query.empty() && query == _searchText) {
+        _content.setSearchResults(mixes);
     }
 }
 
-void HelpOverlay::renderStatusLabel(const std::string& label, const std::string& value, const ImVec4& valueColor,
-                                    float maxLabelWidth) {
-    // Add consistent left margin (2 spaces)
-    std::string indentedLabel = "  " + label;
-    float labelWidth = ImGui::CalcTextSize(indentedLabel.c_str()).x;
-    ImGui::TextUnformatted(indentedLabel.c_str());
+bool HelpOverlay::isTextInputActive() const {
+    return _visible && ImGuiManager::isReady() && ImGui::GetIO().WantTextInput;
+}
+
+void HelpOverlay::renderStatusLabel(const HelpStatusLine& line, float labelWidth, float maxLabelWidth) {
+    ImGui::TextUnformatted(line.label.c_str());
     ImGui::SameLine();
 
     // Add spacing to align values
@@ -531,50 +412,39 @@ void HelpOverlay::renderStatusLabel(const std::string& label, const std::string&
         ImGui::SetCursorPosX(ImGui::GetCursorPosX() + spacing);
     }
 
-    ImGui::PushStyleColor(ImGuiCol_Text, valueColor);
-    ImGui::TextUnformatted(value.c_str());
+    ImGui::PushStyleColor(ImGuiCol_Text, line.color);
+    ImGui::TextUnformatted(line.value.c_str());
     ImGui::PopStyleColor();
 }
 
-void HelpOverlay::renderKeyBindingAligned(const std::string& key, const std::string& description, float maxWidth) {
-    // Add consistent indentation (2 spaces)
-    std::string indentedKey = "  " + key;
-    float keyWidth = ImGui::CalcTextSize(indentedKey.c_str()).x;
-    ImGui::TextUnformatted(indentedKey.c_str());
-    ImGui::SameLine();
-
-    // Add spacing to align descriptions
-    float spacing = maxWidth - keyWidth;
-    if (spacing > 0) {
-        ImGui::SetCursorPosX(ImGui::GetCursorPosX() + spacing);
-    }
-
-    ImGui::TextUnformatted(" - ");
-    ImGui::SameLine();
-    ImGui::TextUnformatted(description.c_str());
-}
-
-void HelpOverlay::renderKeyBindingSection(const std::string& sectionTitle, const std::vector<KeyBinding>& bindings,
-                                          const ImVec4& titleColor, const ImVec4& separatorColor) {
+void HelpOverlay::renderKeyBindingSection(const BindingSection& section) {
     // Section title
-    ImGui::PushStyleColor(ImGuiCol_Text, titleColor);
-    ImGui::TextUnformatted(sectionTitle.c_str());
+    ImGui::PushStyleColor(ImGuiCol_Text, section.titleColor);
+    ImGui::TextUnformatted(section.title.c_str());
     ImGui::PopStyleColor();
     ImGui::Spacing();
 
     // Subtle line under section header
-    ImGui::PushStyleColor(ImGuiCol_Separator, separatorColor);
+    ImGui::PushStyleColor(ImGuiCol_Separator, section.separatorColor);
     ImGui::Separator();
     ImGui::PopStyleColor();
     ImGui::Spacing();
 
-    // Calculate max key width for alignment
-    float maxKeyWidth = calculateMaxKeyWidth(bindings);
-
     // Render all key bindings with consistent alignment
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.95f, 0.95f, 0.95f, 1.0f));
-    for (const auto& binding : bindings) {
-        renderKeyBindingAligned(binding.key, binding.description, maxKeyWidth);
+    for (const BindingLine& line : section.lines) {
+        ImGui::TextUnformatted(line.key.c_str());
+        ImGui::SameLine();
+
+        // Add spacing to align descriptions
+        float spacing = section.maxKeyWidth - line.keyWidth;
+        if (spacing > 0) {
+            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + spacing);
+        }
+
+        ImGui::TextUnformatted(" - ");
+        ImGui::SameLine();
+        ImGui::TextUnformatted(line.description.c_str());
     }
     ImGui::PopStyleColor();
 
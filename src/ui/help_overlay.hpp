@@ -4,10 +4,14 @@
 #include <SDL2/SDL_ttf.h>
 #include <imgui.h>
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
 
+#include "constants.hpp"
+#include "help_content.hpp"
 #include "imgui_manager.hpp"
 #include "mix_metadata.hpp"
 
@@ -16,34 +20,67 @@ namespace AutoVibez::UI {
 // Forward declaration
 class MessageOverlay;
 
-class HelpOverlay {
+/**
+ * @brief Full-screen help with the current status, key bindings and the mix table
+ *
+ * Draws from HelpContent and from measurements kept between frames, so while it
+ * stays open each frame only hands the same strings to ImGui.
+ */
+class HelpOverlay : public OverlayLayer {
 public:
     HelpOverlay();
-    ~HelpOverlay();
+    ~HelpOverlay() override;
 
+    /**
+     * @brief Set up cursors and register with the ImGuiManager compositor
+     */
     void init(SDL_Window* window, SDL_GLContext glContext);
-    void render();
     void toggle();
     bool isVisible() const {
         return _visible;
     }
     bool isImGuiReady() const {
-        return _imguiReady;
+        return ImGuiManager::isReady();
     }
+
+    // OverlayLayer
+    bool isActive() override {
+        return _visible;
+    }
+    void drawWidgets() override;
     void setCursorVisibility(bool visible);
     void setFullscreenState(bool isFullscreen);
 
     // Dynamic information methods
     void setCurrentPreset(const std::string& preset);
     void setCurrentMix(const std::string& artist, const std::string& title, const std::string& genre);
+    void setComingUp(const std::vector<std::string>& mixes);
     void setVolumeLevel(int volume);
     void setAudioDevice(const std::string& device);
+    void setCaptureStats(const std::string& stats);
+    void setLatencyStats(const std::string& stats);
+    void setFrameStats(const std::string& stats);
     void setBeatSensitivity(float sensitivity);
 
     // Mix table methods
     void setMixTableData(const std::vector<AutoVibez::Data::Mix>& mixes);
     void toggleMixTableFilter();
 
+    /**
+     * @brief Called on the render thread with the search box contents each time they change
+     */
+    void setSearchHandler(std::function<void(const std::string& query)> handler);
+
+    /**
+     * @brief Show ranked matches in place of the mix table; results for an outdated query are dropped
+     */
+    void setSearchResults(const std::string& query, const std::vector<AutoVibez::Data::Mix>& mixes);
+
+    /**
+     * @brief True while the search box has keyboard focus, so key bindings should stay quiet
+     */
+    bool isTextInputActive() const;
+
     // Message overlay coordination
     void setMessageOverlay(MessageOverlay* messageOverlay);
 
@@ -54,23 +91,16 @@ private:
     bool _cursorWasVisible = true;
     bool _isFullscreen = false;
     bool _initialized = false;
-    bool _imguiReady = false;
 
     SDL_Cursor* _originalCursor = nullptr;
     SDL_Cursor* _blankCursor = nullptr;
 
-    // Dynamic information
-    std::string _currentPreset;
-    std::string _currentArtist;
-    std::string _currentTitle;
-    std::string _currentGenre;
-    int _volumeLevel = -1;
-    std::string _audioDevice;
-    float _beatSensitivity = 0.0f;
+    // Status and mix table text, rebuilt only when it changes
+    HelpContent _content;
 
-    // Mix table data
-    std::vector<AutoVibez::Data::Mix> _mixTableData;
-    bool _showFavoritesOnly = false;  // Add filter state
+    // Library search
+    char _searchText[Constants::SEARCH_QUERY_MAX_LENGTH] = {};
+    std::function<void(const std::string&)> _searchHandler;
 
     // Alternative rendering
     TTF_Font* _font = nullptr;
@@ -79,19 +109,34 @@ private:
     // Message overlay coordination
     MessageOverlay* _messageOverlay = nullptr;
 
-    // Key binding alignment helper
-    struct KeyBinding {
-        std::string key;
+    // Key bindings, fixed text measured once per font size
+    struct BindingLine {
+        std::string key;  // Indented
         std::string description;
+        float keyWidth = 0.0f;
     };
-
-    float calculateMaxKeyWidth(const std::vector<KeyBinding>& bindings);
-    void renderKeyBindingAligned(const std::string& key, const std::string& description, float maxWidth);
-    void renderKeyBindingSection(const std::string& sectionTitle, const std::vector<KeyBinding>& bindings,
-                                 const ImVec4& titleColor, const ImVec4& separatorColor);
-    void renderStatusLabel(const std::string& label, const std::string& value, const ImVec4& valueColor,
-                           float maxLabelWidth);
-    void initializeImGui();
+    struct BindingSection {
+        std::string title;
+        ImVec4 titleColor;
+        ImVec4 separatorColor;
+        std::vector<BindingLine> lines;
+        float maxKeyWidth = 0.0f;
+    };
+    std::vector<BindingSection> _bindingSections;
+
+    // Measurements of the content, redone when its revision or the font size changes
+    float _layoutFontSize = 0.0f;
+    float _titleWidth = 0.0f;
+    std::vector<float> _statusLabelWidths;
+    float _statusMaxLabelWidth = 0.0f;
+    uint64_t _statusLayoutRevision = 0;
+    std::array<float, 6> _tableColumns{};  // Artist, title, genre, duration, plays, favorite; from the left edge
+    std::string _matchCountText;
+    uint64_t _tableLayoutRevision = 0;
+
+    void updateLayout();
+    void renderStatusLabel(const HelpStatusLine& line, float labelWidth, float maxLabelWidth);
+    void renderKeyBindingSection(const BindingSection& section);
 };
 
 }  // namespace AutoVibez::UI
\ No newline at end of file
@@ -1,14 +1,27 @@
 #include "imgui_manager.hpp"
 
+#ifndef USE_GLES
 #include <backends/imgui_impl_opengl2.h>
+#endif
 #include <backends/imgui_impl_sdl2.h>
 
+#include <algorithm>
+
+#include "opengl.h"
+#include "overlay_renderer.hpp"
+#include "setup.hpp"
+
 namespace AutoVibez::UI {
 
 // Static member initialization
 bool ImGuiManager::_initialized = false;
 SDL_Window* ImGuiManager::_window = nullptr;
 SDL_GLContext ImGuiManager::_glContext = nullptr;
+std::string ImGuiManager::_iniPath;
+std::vector<OverlayLayer*> ImGuiManager::_layers;
+std::vector<OverlayLayer*> ImGuiManager::_activeLayers;
+std::unique_ptr<OverlayRenderer> ImGuiManager::_renderer;
+bool ImGuiManager::_legacyBackend = false;
 
 bool ImGuiManager::initialize(SDL_Window* window, SDL_GLContext glContext) {
     if (_initialized) {
@@ -32,23 +45,156 @@ bool ImGuiManager::initialize(SDL_Window* window, SDL_GLContext glContext) {
         return false;
     }
 
-    if (!ImGui_ImplOpenGL2_Init()) {
+    if (!_legacyBackend) {
+        _renderer = OverlayRenderer::create();
+    }
+    if (_renderer) {
+        io.BackendRendererName = "autovibez_gl3";
+    } else {
+#ifdef USE_GLES
         ImGui_ImplSDL2_Shutdown();
         ImGui::DestroyContext();
         return false;
+#else
+        // Contexts without vertex array objects keep the fixed-function backend
+        if (!ImGui_ImplOpenGL2_Init()) {
+            ImGui_ImplSDL2_Shutdown();
+            ImGui::DestroyContext();
+            return false;
+        }
+#endif
+    }
+
+    // One font atlas and style shared by every overlay
+    io.Fonts->AddFontDefault();
+    io.FontGlobalScale = 1.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    // Set INI file path to user config directory
+    std::string configDir = getConfigDirectory();
+    if (!configDir.empty()) {
+        _iniPath = configDir + "/imgui.ini";
+        io.IniFilename = _iniPath.c_str();
+    }
+
+    ImGui::StyleColorsDark();
+    if (_renderer) {
+        _renderer->createFontsTexture();
+    } else {
+#ifndef USE_GLES
+        ImGui_ImplOpenGL2_CreateFontsTexture();
+#endif
     }
 
     _initialized = true;
     return true;
 }
 
+void ImGuiManager::setRenderTarget(SDL_Window* window, SDL_GLContext glContext) {
+    if (!_initialized) {
+        _window = window;
+        _glContext = glContext;
+    }
+}
+
+bool ImGuiManager::prewarm() {
+    if (_initialized) {
+        return true;
+    }
+    if (_layers.empty() || !_window || !_glContext) {
+        return false;  // Nothing could draw yet, or no context to build the atlas in
+    }
+    return initialize(_window, _glContext);
+}
+
 bool ImGuiManager::isReady() {
     return _initialized;
 }
 
+void ImGuiManager::setLegacyBackend(bool legacy) {
+    _legacyBackend = legacy;
+}
+
+const char* ImGuiManager::getBackendName() {
+    if (!_initialized) {
+        return "none";
+    }
+    return _renderer ? "gl3" : "gl2";
+}
+
+void ImGuiManager::addLayer(OverlayLayer* layer) {
+    if (layer && std::find(_layers.begin(), _layers.end(), layer) == _layers.end()) {
+        _layers.push_back(layer);
+    }
+}
+
+void ImGuiManager::removeLayer(OverlayLayer* layer) {
+    _layers.erase(std::remove(_layers.begin(), _layers.end(), layer), _layers.end());
+}
+
+bool ImGuiManager::renderLayers() {
+    _activeLayers.clear();
+    for (OverlayLayer* layer : _layers) {
+        if (layer->isActive()) {
+            _activeLayers.push_back(layer);
+        }
+    }
+    if (_activeLayers.empty()) {
+        return false;
+    }
+    if (!_initialized && !initialize(_window, _glContext)) {
+        return false;
+    }
+
+    if (_renderer) {
+        // The renderer saves and restores only the state it touches
+        ImGui_ImplSDL2_NewFrame();
+        drawLayers();
+        _renderer->render(ImGui::GetDrawData());
+        return true;
+    }
+
+#ifndef USE_GLES
+    // Save current OpenGL state and isolate ImGui rendering from projectM
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glPushMatrix();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    ImGui_ImplOpenGL2_NewFrame();
+    ImGui_ImplSDL2_NewFrame();
+    drawLayers();
+    ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+
+    glPopMatrix();
+    glPopAttrib();
+#endif
+    return true;
+}
+
+void ImGuiManager::drawLayers() {
+    // One input snapshot, one widget pass per layer, one submission
+    ImGui::NewFrame();
+    for (OverlayLayer* layer : _activeLayers) {
+        layer->drawWidgets();
+    }
+    ImGui::Render();
+}
+
 void ImGuiManager::shutdown() {
     if (_initialized) {
-        ImGui_ImplOpenGL2_Shutdown();
+        if (_renderer) {
+            _renderer.reset();
+            ImGui::GetIO().BackendRendererName = nullptr;
+        } else {
+#ifndef USE_GLES
+            ImGui_ImplOpenGL2_Shutdown();
+#endif
+        }
         ImGui_ImplSDL2_Shutdown();
         ImGui::DestroyContext();
         _initialized = false;
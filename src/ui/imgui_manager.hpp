@@ -3,39 +3,109 @@
 #include <SDL2/SDL.h>
 #include <imgui.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace AutoVibez::UI {
 
+class OverlayRenderer;
+
 /**
- * @brief Simple ImGui manager for centralized initialization only
+ * @brief Something that draws ImGui widgets into the shared overlay frame
+ */
+class OverlayLayer {
+public:
+    virtual ~OverlayLayer() = default;
+
+    /**
+     * @brief Whether the layer has anything to draw this frame (checked once per frame, before ImGui runs)
+     */
+    virtual bool isActive() = 0;
+
+    /**
+     * @brief Add the layer's windows to the open ImGui frame
+     */
+    virtual void drawWidgets() = 0;
+};
+
+/**
+ * @brief ImGui initialization and the overlay compositor
  *
- * Manages ImGui initialization and backend setup. Each overlay handles
- * its own frame management independently.
+ * Overlays register as layers; renderLayers() opens one ImGui frame per rendered
+ * frame, lets every active layer contribute widgets in registration order (later
+ * layers draw on top) and submits a single draw list. When no layer is active,
+ * ImGui is not touched at all. ImGui itself, with the one font atlas every overlay
+ * shares, is initialized lazily: by prewarm() once startup is idle, or the first time
+ * a layer becomes active, whichever comes first. Draw data goes through the retained GL 3 OverlayRenderer;
+ * desktop contexts without it, or setLegacyBackend(true), use ImGui's OpenGL2 backend.
  */
 class ImGuiManager {
 public:
     /**
-     * @brief Initialize ImGui with SDL2 and OpenGL2 backends
+     * @brief Initialize ImGui with the SDL2 backend, the overlay renderer, fonts and style
      * @param window SDL window pointer
      * @param glContext OpenGL context
      * @return true if initialization successful
      */
     static bool initialize(SDL_Window* window, SDL_GLContext glContext);
 
+    /**
+     * @brief Remember the window and context for lazy initialization
+     */
+    static void setRenderTarget(SDL_Window* window, SDL_GLContext glContext);
+
+    /**
+     * @brief Initialize now if a layer is registered, so the first overlay does not pay for the font atlas
+     * @return true if ImGui is ready afterwards
+     */
+    static bool prewarm();
+
     /**
      * @brief Check if ImGui is ready for use
      * @return true if ImGui is initialized and ready
      */
     static bool isReady();
 
+    /**
+     * @brief Use ImGui's OpenGL2 backend even where the GL 3 renderer works (before the first frame)
+     */
+    static void setLegacyBackend(bool legacy);
+
+    /**
+     * @brief "gl3" or "gl2" once initialized, "none" before
+     */
+    static const char* getBackendName();
+
+    /**
+     * @brief Add a layer on top of those already registered (ignored if present)
+     */
+    static void addLayer(OverlayLayer* layer);
+
+    static void removeLayer(OverlayLayer* layer);
+
+    /**
+     * @brief Draw all active layers in one ImGui frame
+     * @return True if a frame was submitted, false if every layer was idle
+     */
+    static bool renderLayers();
+
     /**
      * @brief Shutdown ImGui and clean up resources
      */
     static void shutdown();
 
 private:
+    static void drawLayers();
+
     static bool _initialized;
     static SDL_Window* _window;
     static SDL_GLContext _glContext;
+    static std::string _iniPath;
+    static std::vector<OverlayLayer*> _layers;
+    static std::vector<OverlayLayer*> _activeLayers;  // Reused every frame
+    static std::unique_ptr<OverlayRenderer> _renderer;
+    static bool _legacyBackend;
 };
 
 }  // namespace AutoVibez::UI
@@ -0,0 +1,91 @@
+#include "message_layout.hpp"
+
+#include <algorithm>
+
+namespace AutoVibez::UI {
+
+bool MessageLayout::isCurrent(const std::string& text, float fontSize, float maxWidth) const {
+    return _built && fontSize == _fontSize && maxWidth == _maxWidth && text == _text;
+}
+
+void MessageLayout::build(const std::string& text, float fontSize, float maxWidth, const Measure& measure) {
+    _text = text;
+    _fontSize = fontSize;
+    _maxWidth = maxWidth;
+    _lines.clear();
+
+    std::vector<ImVec2> sizes;
+    size_t begin = 0;
+    while (true) {
+        const size_t newline = _text.find('\n', begin);
+        addParagraph(begin, newline == std::string::npos ? _text.size() : newline, measure, sizes);
+        if (newline == std::string::npos) {
+            break;
+        }
+        begin = newline + 1;
+    }
+
+    float width = 0.0f;
+    for (const ImVec2& size : sizes) {
+        width = std::max(width, size.x);
+    }
+    float y = 0.0f;
+    for (size_t i = 0; i < _lines.size(); ++i) {
+        _lines[i].offset = ImVec2((width - sizes[i].x) * 0.5f, y);
+        y += sizes[i].y;
+    }
+    _size = ImVec2(width, y);
+    _built = true;
+}
+
+void MessageLayout::clear() {
+    _built = false;
+    _text.clear();
+    _lines.clear();
+    _size = ImVec2();
+}
+
+void MessageLayout::addParagraph(size_t begin, size_t end, const Measure& measure, std::vector<ImVec2>& sizes) {
+    const char* text = _text.c_str();
+    size_t lineBegin = begin;
+    while (true) {
+        size_t lineEnd = end;
+        ImVec2 size = measure(text + lineBegin, text + lineEnd);
+        if (_maxWidth > 0.0f && size.x > _maxWidth) {
+            // Greedy: keep adding words while the line fits; a single long word overflows
+            size_t fitEnd = std::string::npos;
+            size_t space = _text.find(' ', lineBegin);
+            while (space != std::string::npos && space < end) {
+                const ImVec2 candidate = measure(text + lineBegin, text + space);
+                if (candidate.x > _maxWidth && fitEnd != std::string::npos) {
+                    break;
+                }
+                fitEnd = space;
+                size = candidate;
+                if (candidate.x > _maxWidth) {
+                    break;
+                }
+                space = _text.find(' ', space + 1);
+            }
+            if (fitEnd != std::string::npos) {
+                lineEnd = fitEnd;
+            }
+        }
+
+        Line line;
+        line.begin = lineBegin;
+        line.end = lineEnd;
+        _lines.push_back(line);
+        sizes.push_back(size);
+
+        if (lineEnd >= end) {
+            return;
+        }
+        lineBegin = _text.find_first_not_of(' ', lineEnd);
+        if (lineBegin == std::string::npos || lineBegin >= end) {
+            return;
+        }
+    }
+}
+
+}  // namespace AutoVibez::UI
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace AutoVibez::UI {
+
+/**
+ * @brief Line breaks and geometry of one message, kept until its text or font size changes
+ *
+ * Splits the text at newlines and, when a maximum width is set, wraps it at spaces.
+ * Each line is measured once; its offset inside the box centres it horizontally.
+ * MessageOverlay rebuilds the layout only when isCurrent() fails, so a message that
+ * is not animating is drawn from the cached lines without measuring anything.
+ */
+class MessageLayout {
+public:
+    /**
+     * @brief Size of [begin, end) at the layout's font size
+     */
+    using Measure = std::function<ImVec2(const char* begin, const char* end)>;
+
+    struct Line {
+        size_t begin = 0;  //!< Offset of the first character in getText()
+        size_t end = 0;    //!< Offset one past the last character
+        ImVec2 offset;     //!< Top-left corner relative to the box
+    };
+
+    bool isCurrent(const std::string& text, float fontSize, float maxWidth) const;
+
+    /**
+     * @brief Break and measure the text
+     * @param maxWidth Wrap lines wider than this (0 = only at newlines)
+     */
+    void build(const std::string& text, float fontSize, float maxWidth, const Measure& measure);
+
+    /**
+     * @brief Forget the layout so the next isCurrent() fails
+     */
+    void clear();
+
+    const std::string& getText() const {
+        return _text;
+    }
+    const std::vector<Line>& getLines() const {
+        return _lines;
+    }
+    ImVec2 getSize() const {
+        return _size;
+    }
+    float getFontSize() const {
+        return _fontSize;
+    }
+
+private:
+    void addParagraph(size_t begin, size_t end, const Measure& measure, std::vector<ImVec2>& sizes);
+
+    std::string _text;
+    float _fontSize = 0.0f;
+    float _maxWidth = 0.0f;
+    bool _built = false;
+    std::vector<Line> _lines;
+    ImVec2 _size;
+};
+
+}  // namespace AutoVibez::UI
@@ -1,9 +1,10 @@
 #include "message_overlay.hpp"
 
-#include <backends/imgui_impl_opengl2.h>
-#include <backends/imgui_impl_sdl2.h>
 #include <imgui.h>
 
+#include <algorithm>
+#include <array>
+#include <cfloat>
 #include <cmath>
 
 #include "constants.hpp"
@@ -11,10 +12,34 @@
 
 namespace AutoVibez::UI {
 
-MessageOverlay::MessageOverlay() {}
+namespace {
+constexpr size_t COLOR_CYCLE_STEPS = 64;
+constexpr float COLOR_CYCLE_MS = 500.0f;
+constexpr float MESSAGE_TOP_OFFSET = 50.0f;  // Pixels from the top of the work area
+
+// One period of the colour transition, sampled once instead of three sines per frame
+const std::array<ImVec4, COLOR_CYCLE_STEPS>& colorCycle() {
+    static const std::array<ImVec4, COLOR_CYCLE_STEPS> table = [] {
+        std::array<ImVec4, COLOR_CYCLE_STEPS> colors;
+        for (size_t i = 0; i < COLOR_CYCLE_STEPS; ++i) {
+            const float phase = 2.0f * static_cast<float>(M_PI) * static_cast<float>(i) / COLOR_CYCLE_STEPS;
+            colors[i] = ImVec4(0.5f + 0.5f * std::sin(phase), 0.5f + 0.5f * std::sin(phase + 2.0f * M_PI / 3.0f),
+                               0.5f + 0.5f * std::sin(phase + 4.0f * M_PI / 3.0f), 1.0f);
+        }
+        return colors;
+    }();
+    return table;
+}
+}  // namespace
+
+MessageOverlay::MessageOverlay() {
+    _currentConfig = getDefaultConfig();
+    _currentConfig.content.reserve(Constants::OVERLAY_MESSAGE_RESERVE);
+    _next.text.reserve(Constants::OVERLAY_MESSAGE_RESERVE);
+}
 
 MessageOverlay::~MessageOverlay() {
-    // Cleanup handled by ImGuiManager
+    ImGuiManager::removeLayer(this);
 }
 
 void MessageOverlay::init(SDL_Window* window, SDL_GLContext glContext) {
@@ -31,56 +56,34 @@ void MessageOverlay::init(SDL_Window* window, SDL_GLContext glContext) {
     _windowWidth = width;
     _windowHeight = height;
 
+    ImGuiManager::setRenderTarget(_window, _glContext);
+    ImGuiManager::addLayer(this);
     _initialized = true;
 }
 
-void MessageOverlay::render() {
-    if (!_visible || _temporarilyHidden) {
-        return;
+bool MessageOverlay::isActive() {
+    if (_temporarilyHidden || (!_visible && _queue.empty())) {
+        return false;
     }
 
-    // Update animation state
-    updateAnimation();
-
-    // Check if message should be hidden
-    auto now = std::chrono::steady_clock::now();
-    if (now >= _endTime) {
-        _visible = false;
-        return;
+    // The only clock read of the frame; drawing works from _elapsedMs
+    const auto now = std::chrono::steady_clock::now();
+    if (_visible) {
+        _elapsedMs = std::chrono::duration<float, std::milli>(now - _startTime).count();
+        _visible = _elapsedMs < _endMs;
     }
-
-    // Lazy initialize ImGui on first render
-    if (!_imguiReady) {
-        initializeImGui();
+    if (!_queue.empty()) {
+        showQueued(now);
     }
+    if (!_visible) {
+        return false;
+    }
+    updateAnimation();
+    return true;
+}
 
-    // Save current OpenGL state and isolate ImGui rendering
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    glPushMatrix();
-
-    // Completely isolate ImGui's texture state
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    // Use a very simple rendering approach
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Start the Dear ImGui frame
-    ImGui_ImplOpenGL2_NewFrame();
-    ImGui_ImplSDL2_NewFrame();
-    ImGui::NewFrame();
-
-    // Render the message box
+void MessageOverlay::drawWidgets() {
     renderMessageBox();
-
-    // Render ImGui
-    ImGui::Render();
-    ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
-
-    // Restore OpenGL state
-    glPopMatrix();
-    glPopAttrib();
 }
 
 void MessageOverlay::showMessage(const std::string& content, std::chrono::milliseconds duration) {
@@ -92,20 +95,62 @@ void MessageOverlay::showMessage(const std::string& content, std::chrono::millis
 
 void MessageOverlay::showMessage(const MessageConfig& config) {
     _currentConfig = config;
+    _currentType = AutoVibez::Utils::OverlayMessageType::Text;
+    _currentPriority = AutoVibez::Utils::OverlayPriority::Normal;
+    start(std::chrono::steady_clock::now());
+}
+
+void MessageOverlay::postMessage(const AutoVibez::Utils::NamedMessageConfig& config) {
+    // Shown, or merged into the message on screen, by the next isActive()
+    _queue.push(config);
+}
+
+void MessageOverlay::showQueued(std::chrono::steady_clock::time_point now) {
+    using AutoVibez::Utils::OverlayMessageType;
+    const AutoVibez::Utils::QueuedOverlayMessage* next = _queue.peek();
+    const bool update = _visible && next->type == _currentType &&
+                        (next->type != OverlayMessageType::Text || next->text == _currentConfig.content);
+    if (_visible && !update) {
+        const bool waits = next->priority < _currentPriority ||
+                           (next->priority == _currentPriority && _elapsedMs < Constants::OVERLAY_MIN_DISPLAY_MS);
+        if (waits) {
+            return;
+        }
+    }
+
+    // The text moves by swapping buffers; copying the defaults over an empty string keeps its capacity
+    static const MessageConfig defaults = getDefaultConfig();
+    _queue.pop(_next);
+    _currentConfig = defaults;
+    _currentConfig.content.swap(_next.text);
+    _currentConfig.duration = _next.duration;
+    _currentType = _next.type;
+    _currentPriority = _next.priority;
+    setColorTransition(_next.colorTransition);
+
+    if (!update) {
+        start(now);
+        return;
+    }
+    // Updated in place: no second fade-in or slide, and a fresh hold time
+    const float shownMs = std::min(_elapsedMs, static_cast<float>(_currentConfig.fadeInTime.count()));
+    start(now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<float, std::milli>(shownMs)));
+    _elapsedMs = shownMs;
+}
 
-    auto now = std::chrono::steady_clock::now();
+void MessageOverlay::start(std::chrono::steady_clock::time_point now) {
     _startTime = now;
-    _fadeInEndTime = now + _currentConfig.fadeInTime;
-    _fadeOutStartTime = now + _currentConfig.duration - _currentConfig.fadeOutTime;
-    _endTime = now + _currentConfig.duration;
+    _fadeInMs = static_cast<float>(_currentConfig.fadeInTime.count());
+    _fadeOutMs = static_cast<float>(_currentConfig.fadeOutTime.count());
+    _endMs = static_cast<float>(_currentConfig.duration.count());
+    _fadeOutStartMs = _endMs - _fadeOutMs;
+    _elapsedMs = 0.0f;
 
     _visible = true;
     _currentAlpha = 0.0f;
-
-    // Start color transition if enabled
-    if (_useColorTransition) {
-        _colorStartTime = now;
-    }
+    _layout.clear();
+    _textColorAlpha = -1.0f;
 }
 
 void MessageOverlay::hideMessage() {
@@ -123,6 +168,7 @@ bool MessageOverlay::isTemporarilyHidden() const {
 
 void MessageOverlay::setColorTransition(bool enabled) {
     _useColorTransition = enabled;
+    _textColorAlpha = -1.0f;
 }
 
 bool MessageOverlay::isVisible() const {
@@ -130,7 +176,7 @@ bool MessageOverlay::isVisible() const {
 }
 
 bool MessageOverlay::isImGuiReady() const {
-    return _imguiReady;
+    return ImGuiManager::isReady();
 }
 
 void MessageOverlay::setWindowSize(int width, int height) {
@@ -179,43 +225,13 @@ MessageOverlay::MessageConfig MessageOverlay::getInfoConfig() {
     return config;
 }
 
-void MessageOverlay::initializeImGui() {
-    if (_imguiReady) {
-        return;
-    }
-
-    // Use centralized ImGui initialization
-    if (AutoVibez::UI::ImGuiManager::initialize(_window, _glContext)) {
-        // Configure ImGui for this overlay
-        ImGuiIO& io = ImGui::GetIO();
-
-        // Add default font
-        io.Fonts->AddFontDefault();
-        io.FontGlobalScale = 1.0f;
-
-        // Setup Dear ImGui style
-        ImGui::StyleColorsDark();
-
-        // Explicitly create the font texture
-        ImGui_ImplOpenGL2_CreateFontsTexture();
-
-        _imguiReady = true;
-    }
-}
-
 void MessageOverlay::updateAnimation() {
-    auto now = std::chrono::steady_clock::now();
-
-    if (now <= _fadeInEndTime) {
+    if (_elapsedMs < _fadeInMs) {
         // Fade in phase
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _startTime);
-        float progress = static_cast<float>(elapsed.count()) / static_cast<float>(_currentConfig.fadeInTime.count());
-        _currentAlpha = std::min(1.0f, progress);
-    } else if (now >= _fadeOutStartTime) {
+        _currentAlpha = _elapsedMs / _fadeInMs;
+    } else if (_elapsedMs >= _fadeOutStartMs) {
         // Fade out phase
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _fadeOutStartTime);
-        float progress = static_cast<float>(elapsed.count()) / static_cast<float>(_currentConfig.fadeOutTime.count());
-        _currentAlpha = std::max(0.0f, 1.0f - progress);
+        _currentAlpha = std::max(0.0f, 1.0f - (_elapsedMs - _fadeOutStartMs) / _fadeOutMs);
     } else {
         // Fully visible phase
         _currentAlpha = 1.0f;
@@ -231,81 +247,56 @@ ImVec4 MessageOverlay::calculateColorTransition() {
         return _currentConfig.textColor;
     }
 
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _colorStartTime);
-    float timeSeconds = elapsed.count() / 1000.0f;
-
-    // Create a smooth color cycle through different colors
-    float cycleSpeed = 2.0f;  // Complete cycle every 2 seconds
-    float cycle = (timeSeconds * cycleSpeed);
-
-    // Use sine waves to create smooth color transitions
-    float r = 0.5f + 0.5f * std::sin(cycle * 2.0f * M_PI);
-    float g = 0.5f + 0.5f * std::sin(cycle * 2.0f * M_PI + 2.0f * M_PI / 3.0f);
-    float b = 0.5f + 0.5f * std::sin(cycle * 2.0f * M_PI + 4.0f * M_PI / 3.0f);
-
-    return ImVec4(r, g, b, 1.0f);
+    // A smooth cycle through the hues, twice a second
+    const float cycle = std::fmod(_elapsedMs, COLOR_CYCLE_MS) / COLOR_CYCLE_MS;
+    return colorCycle()[static_cast<size_t>(cycle * COLOR_CYCLE_STEPS) % COLOR_CYCLE_STEPS];
 }
 
 void MessageOverlay::renderMessageBox() {
     // Calculate font size based on window size
     float fontSize = std::max(24.0f, std::min(72.0f, _windowHeight * 0.04f));  // 4% of window height, min 24, max 72
+    const float maxWidth = static_cast<float>(_currentConfig.maxWidth);
 
-    // Use ImGui's built-in overlay features
-    ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
-                                   ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
-                                   ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoInputs |
-                                   ImGuiWindowFlags_NoScrollbar;
-
-    // Position window at top center using ImGui's viewport features
-    ImGuiViewport* viewport = ImGui::GetMainViewport();
-    ImVec2 workPos = viewport->WorkPos;
-    ImVec2 workSize = viewport->WorkSize;
-
-    float x = workPos.x + workSize.x * 0.5f;
-    float y = workPos.y + 50.0f;  // 50px from top
-
-    // Add slide animation (slide down from top)
-    if (_currentConfig.useSlideAnimation) {
-        float slideOffset = (1.0f - _currentAlpha) * _currentConfig.slideDistance;
-        y -= slideOffset;  // Slide down from above
+    ImFont* font = ImGui::GetFont();
+    if (!_layout.isCurrent(_currentConfig.content, fontSize, maxWidth)) {
+        _layout.build(_currentConfig.content, fontSize, maxWidth, [font, fontSize](const char* begin, const char* end) {
+            return font->CalcTextSizeA(fontSize, FLT_MAX, 0.0f, begin, end);
+        });
     }
 
-    ImGui::SetNextWindowPos(ImVec2(x, y), ImGuiCond_Always, ImVec2(0.5f, 0.0f));
-
-    // Set completely transparent background using ImGui's alpha system
-    ImGui::SetNextWindowBgAlpha(0.0f);
-
-    // Use ImGui's built-in text rendering with proper styling
-    if (ImGui::Begin("##MessageOverlay", nullptr, windowFlags)) {
-        // Set large font using ImGui's font system
-        ImGui::SetWindowFontScale(fontSize / 13.0f);
-
-        // Apply color transition and alpha to text color using ImGui's color system
+    // Only a fade or the colour cycle changes the colour; a steady message packs it once
+    if (_useColorTransition || _currentAlpha != _textColorAlpha) {
         ImVec4 textColor = calculateColorTransition();
         textColor.w *= _currentAlpha;
-        ImGui::PushStyleColor(ImGuiCol_Text, textColor);
-
-        // Use ImGui's built-in text centering with proper spacing
-        ImVec2 textSize = ImGui::CalcTextSize(_currentConfig.content.c_str());
-        float centerX = (ImGui::GetContentRegionAvail().x - textSize.x) * 0.5f;
-        ImGui::SetCursorPosX(centerX);
-
-        // Add padding using ImGui's spacing system
-        ImGui::Spacing();
-
-        // Render the text using ImGui's text rendering
-        ImGui::Text("%s", _currentConfig.content.c_str());
-
-        // Add bottom spacing
-        ImGui::Spacing();
+        _textColor = ImGui::GetColorU32(textColor);
+        _textColorAlpha = _currentAlpha;
+    }
 
-        ImGui::PopStyleColor();
+    const ImVec2 anchor = calculateMessagePosition();
+    const float padding = _currentConfig.padding;
+    const ImVec2 size = _layout.getSize();
+    const ImVec2 boxMin(anchor.x - size.x * 0.5f - padding, anchor.y);
+    const ImVec2 boxMax(anchor.x + size.x * 0.5f + padding, anchor.y + size.y + 2.0f * padding);
+
+    // Behind every ImGui window, so the help overlay and HUD stay readable on top
+    ImDrawList* drawList = ImGui::GetBackgroundDrawList();
+    if (_currentConfig.backgroundColor.w > 0.0f) {
+        ImVec4 background = _currentConfig.backgroundColor;
+        background.w *= _currentAlpha;
+        drawList->AddRectFilled(boxMin, boxMax, ImGui::GetColorU32(background), _currentConfig.cornerRadius);
+    }
+    if (_currentConfig.showBorder && _currentConfig.borderColor.w > 0.0f) {
+        ImVec4 border = _currentConfig.borderColor;
+        border.w *= _currentAlpha;
+        drawList->AddRect(boxMin, boxMax, ImGui::GetColorU32(border), _currentConfig.cornerRadius);
+    }
 
-        // Reset font scale
-        ImGui::SetWindowFontScale(1.0f);
+    const char* text = _layout.getText().c_str();
+    for (const MessageLayout::Line& line : _layout.getLines()) {
+        const float x = _currentConfig.centerText ? line.offset.x : 0.0f;
+        drawList->AddText(font, fontSize, ImVec2(boxMin.x + padding + x, boxMin.y + padding + line.offset.y),
+                          _textColor, text + line.begin, text + line.end);
     }
-    ImGui::End();
 }
 
 ImVec2 MessageOverlay::calculateMessagePosition() {
@@ -315,8 +306,12 @@ ImVec2 MessageOverlay::calculateMessagePosition() {
     ImVec2 workSize = viewport->WorkSize;
 
     float x = workPos.x + workSize.x * 0.5f;
-    float y = workPos.y + 50.0f;  // 50px from top
+    float y = workPos.y + MESSAGE_TOP_OFFSET;
 
+    // Add slide animation (slide down from top)
+    if (_currentConfig.useSlideAnimation) {
+        y -= (1.0f - _currentAlpha) * _currentConfig.slideDistance;
+    }
     return ImVec2(x, y);
 }
 
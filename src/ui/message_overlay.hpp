@@ -11,6 +11,8 @@
 #include <vector>
 
 #include "imgui_manager.hpp"
+#include "message_layout.hpp"
+#include "overlay_message_queue.hpp"
 
 namespace AutoVibez::UI {
 
@@ -18,9 +20,17 @@ namespace AutoVibez::UI {
  * @brief Message overlay for displaying temporary messages with smooth transitions
  *
  * Provides a flexible system for displaying messages over the application window
- * with configurable timing, content, and smooth fade in/out transitions.
+ * with configurable timing, content, and smooth fade in/out transitions. The text is
+ * laid out once per message and font size (MessageLayout) and drawn straight into the
+ * background draw list; the animation reads the clock once per frame, and a message
+ * past its fade-in with no colour cycle reuses its colour and geometry unchanged.
+ *
+ * Posted messages wait in an OverlayMessageQueue. One of the type on screen updates
+ * it in place, with a fresh hold time but no second fade-in; one of a higher priority
+ * replaces it at once, one of the same priority after OVERLAY_MIN_DISPLAY_MS, and a
+ * lower one when it ends. Queued text moves to the screen by swapping buffers.
  */
-class MessageOverlay {
+class MessageOverlay : public OverlayLayer {
 public:
     /**
      * @brief Message configuration structure
@@ -45,19 +55,24 @@ public:
     };
 
     MessageOverlay();
-    ~MessageOverlay();
+    ~MessageOverlay() override;
 
     /**
-     * @brief Initialize the message overlay
+     * @brief Initialize the message overlay and register it with the ImGuiManager compositor
      * @param window SDL window pointer
      * @param glContext OpenGL context
      */
     void init(SDL_Window* window, SDL_GLContext glContext);
 
     /**
-     * @brief Render the message overlay
+     * @brief Advance the fade animation and expire the message; true while it is on screen
+     */
+    bool isActive() override;
+
+    /**
+     * @brief Add the message box to the open ImGui frame
      */
-    void render();
+    void drawWidgets() override;
 
     /**
      * @brief Show a message with default configuration
@@ -72,6 +87,18 @@ public:
      */
     void showMessage(const MessageConfig& config);
 
+    /**
+     * @brief Queue a message, merged with the one on screen or queued of its type
+     */
+    void postMessage(const AutoVibez::Utils::NamedMessageConfig& config);
+
+    /**
+     * @brief Messages waiting behind the one on screen
+     */
+    const AutoVibez::Utils::OverlayMessageQueue& getQueue() const {
+        return _queue;
+    }
+
     /**
      * @brief Hide the current message immediately
      */
@@ -147,15 +174,22 @@ private:
     SDL_Window* _window = nullptr;
     SDL_GLContext _glContext = nullptr;
     bool _initialized = false;
-    bool _imguiReady = false;
     bool _visible = false;
 
-    // Message state
+    // Message state; times are milliseconds from _startTime
     MessageConfig _currentConfig;
     std::chrono::steady_clock::time_point _startTime;
-    std::chrono::steady_clock::time_point _fadeInEndTime;
-    std::chrono::steady_clock::time_point _fadeOutStartTime;
-    std::chrono::steady_clock::time_point _endTime;
+    float _fadeInMs = 0.0f;
+    float _fadeOutMs = 0.0f;
+    float _fadeOutStartMs = 0.0f;
+    float _endMs = 0.0f;
+    float _elapsedMs = 0.0f;  // Read once per frame in isActive()
+    AutoVibez::Utils::OverlayMessageType _currentType = AutoVibez::Utils::OverlayMessageType::Text;
+    AutoVibez::Utils::OverlayPriority _currentPriority = AutoVibez::Utils::OverlayPriority::Normal;
+
+    // Waiting messages, and the buffer each one is swapped through on its way to _currentConfig
+    AutoVibez::Utils::OverlayMessageQueue _queue;
+    AutoVibez::Utils::QueuedOverlayMessage _next;
 
     // Window dimensions for positioning
     int _windowWidth = 800;
@@ -167,10 +201,15 @@ private:
     bool _temporarilyHidden = false;
 
     // Color transition effect
-    std::chrono::steady_clock::time_point _colorStartTime;
     bool _useColorTransition = false;
 
-    void initializeImGui();
+    // Drawn geometry and colour, reused while nothing changes
+    MessageLayout _layout;
+    ImU32 _textColor = 0;
+    float _textColorAlpha = -1.0f;  // Alpha _textColor was packed with (negative = repack)
+
+    void start(std::chrono::steady_clock::time_point now);
+    void showQueued(std::chrono::steady_clock::time_point now);
     void updateAnimation();
     float calculateCurrentAlpha();
     ImVec4 calculateColorTransition();
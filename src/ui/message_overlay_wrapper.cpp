@@ -19,25 +19,17 @@ void MessageOverlayWrapper::init(SDL_Window* window, SDL_GLContext glContext) {
     _initialized = true;
 }
 
-void MessageOverlayWrapper::render() {
-    if (_messageOverlay) {
-        _messageOverlay->render();
-    }
-}
-
 void MessageOverlayWrapper::showMessage(const std::string& content, std::chrono::milliseconds duration) {
+    using AutoVibez::Utils::OverlayMessages;
+    using AutoVibez::Utils::OverlayPriority;
     if (_messageOverlay) {
-        _messageOverlay->showMessage(content, duration);
+        _messageOverlay->postMessage(OverlayMessages::createText(content, OverlayPriority::Normal, duration));
     }
 }
 
 void MessageOverlayWrapper::showMessage(const AutoVibez::Utils::NamedMessageConfig& config) {
     if (_messageOverlay) {
-        MessageOverlay::MessageConfig messageConfig = _messageOverlay->getDefaultConfig();
-        messageConfig.content = config.formatter();
-        messageConfig.duration = config.duration;
-        _messageOverlay->setColorTransition(config.colorTransition);
-        _messageOverlay->showMessage(messageConfig);
+        _messageOverlay->postMessage(config);
     }
 }
 
@@ -26,19 +26,14 @@ public:
     void init(SDL_Window* window, SDL_GLContext glContext);
 
     /**
-     * @brief Render the message overlay
-     */
-    void render();
-
-    /**
-     * @brief Show a message
+     * @brief Queue a plain text message
      * @param content Message text
      * @param duration How long to display (default: 20 seconds)
      */
     void showMessage(const std::string& content, std::chrono::milliseconds duration = std::chrono::milliseconds(20000));
 
     /**
-     * @brief Show a message using NamedMessageConfig
+     * @brief Queue a message by its type and priority; see MessageOverlay
      * @param config Message configuration from OverlayMessages
      */
     void showMessage(const AutoVibez::Utils::NamedMessageConfig& config);
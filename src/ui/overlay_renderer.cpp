@@ -0,0 +1,426 @@
+#include "overlay_renderer.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "gl_entry_points.hpp"
+
+namespace AutoVibez::UI {
+
+namespace {
+Core::GlEntryPoints& gl = Core::GlEntryPoints::get();
+
+constexpr GLuint POSITION_ATTRIBUTE = 0;
+constexpr GLuint UV_ATTRIBUTE = 1;
+constexpr GLuint COLOR_ATTRIBUTE = 2;
+constexpr uint32_t NO_TEXTURE = UINT32_MAX;  // Forces the next bindTexture() through
+
+#ifdef USE_GLES
+constexpr const char* SHADER_HEADER = "#version 300 es\nprecision mediump float;\n";
+#else
+constexpr const char* SHADER_HEADER = "#version 130\n";
+#endif
+
+constexpr const char* VERTEX_SHADER =
+    "uniform mat4 projection;\n"
+    "in vec2 position;\n"
+    "in vec2 uv;\n"
+    "in vec4 color;\n"
+    "out vec2 fragUv;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragUv = uv;\n"
+    "    fragColor = color;\n"
+    "    gl_Position = projection * vec4(position, 0.0, 1.0);\n"
+    "}\n";
+
+constexpr const char* FRAGMENT_SHADER =
+    "uniform sampler2D atlas;\n"
+    "in vec2 fragUv;\n"
+    "in vec4 fragColor;\n"
+    "out vec4 outColor;\n"
+    "void main() {\n"
+    "    outColor = fragColor * texture(atlas, fragUv);\n"
+    "}\n";
+
+bool hasVertexArrays() {
+#ifdef USE_GLES
+    return true;  // Core in GLES 3.0
+#else
+    int major = 0;
+    SDL_GL_GetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, &major);
+    return major >= 3 || SDL_GL_ExtensionSupported("GL_ARB_vertex_array_object");
+#endif
+}
+
+GLuint compileShader(GLenum type, const char* body) {
+    const GLuint shader = gl.createShader(type);
+    const GLchar* sources[] = {SHADER_HEADER, body};
+    gl.shaderSource(shader, 2, sources, nullptr);
+    gl.compileShader(shader);
+    GLint compiled = GL_FALSE;
+    gl.getShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        gl.deleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint linkProgram() {
+    const GLuint vertex = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    const GLuint fragment = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    GLuint program = 0;
+    if (vertex != 0 && fragment != 0) {
+        program = gl.createProgram();
+        gl.attachShader(program, vertex);
+        gl.attachShader(program, fragment);
+        gl.bindAttribLocation(program, POSITION_ATTRIBUTE, "position");
+        gl.bindAttribLocation(program, UV_ATTRIBUTE, "uv");
+        gl.bindAttribLocation(program, COLOR_ATTRIBUTE, "color");
+        gl.linkProgram(program);
+        GLint linked = GL_FALSE;
+        gl.getProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE) {
+            gl.deleteProgram(program);
+            program = 0;
+        }
+    }
+    // The program keeps what it needs; the shader objects go with it
+    if (vertex != 0) {
+        gl.deleteShader(vertex);
+    }
+    if (fragment != 0) {
+        gl.deleteShader(fragment);
+    }
+    return program;
+}
+
+/**
+ * @brief The part of the GL state an overlay frame changes, taken before and put back after
+ */
+struct SavedState {
+    GLint program = 0;
+    GLint activeTexture = 0;
+    GLint texture = 0;
+    GLint arrayBuffer = 0;
+    GLint vertexArray = 0;
+    GLint viewport[4] = {};
+    GLint scissorBox[4] = {};
+    GLint blendSrcRgb = 0;
+    GLint blendDstRgb = 0;
+    GLint blendSrcAlpha = 0;
+    GLint blendDstAlpha = 0;
+    GLint blendEquationRgb = 0;
+    GLint blendEquationAlpha = 0;
+    GLboolean blend = GL_FALSE;
+    GLboolean cullFace = GL_FALSE;
+    GLboolean depthTest = GL_FALSE;
+    GLboolean stencilTest = GL_FALSE;
+    GLboolean scissorTest = GL_FALSE;
+
+    void save() {
+        glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+        gl.activeTexture(GL_TEXTURE0);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        glGetIntegerv(GL_SCISSOR_BOX, scissorBox);
+        glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRgb);
+        glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRgb);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+        glGetIntegerv(GL_BLEND_EQUATION_RGB, &blendEquationRgb);
+        glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blendEquationAlpha);
+        blend = glIsEnabled(GL_BLEND);
+        cullFace = glIsEnabled(GL_CULL_FACE);
+        depthTest = glIsEnabled(GL_DEPTH_TEST);
+        stencilTest = glIsEnabled(GL_STENCIL_TEST);
+        scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    }
+
+    void restore() const {
+        gl.useProgram(static_cast<GLuint>(program));
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture));
+        gl.activeTexture(static_cast<GLenum>(activeTexture));
+        gl.bindVertexArray(static_cast<GLuint>(vertexArray));
+        gl.bindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(arrayBuffer));
+        gl.blendEquationSeparate(static_cast<GLenum>(blendEquationRgb), static_cast<GLenum>(blendEquationAlpha));
+        gl.blendFuncSeparate(static_cast<GLenum>(blendSrcRgb), static_cast<GLenum>(blendDstRgb),
+                             static_cast<GLenum>(blendSrcAlpha), static_cast<GLenum>(blendDstAlpha));
+        setEnabled(GL_BLEND, blend);
+        setEnabled(GL_CULL_FACE, cullFace);
+        setEnabled(GL_DEPTH_TEST, depthTest);
+        setEnabled(GL_STENCIL_TEST, stencilTest);
+        setEnabled(GL_SCISSOR_TEST, scissorTest);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        glScissor(scissorBox[0], scissorBox[1], scissorBox[2], scissorBox[3]);
+    }
+
+    static void setEnabled(GLenum capability, GLboolean enabled) {
+        if (enabled) {
+            glEnable(capability);
+        } else {
+            glDisable(capability);
+        }
+    }
+};
+}  // namespace
+
+std::unique_ptr<OverlayRenderer> OverlayRenderer::create() {
+    if (!hasVertexArrays() || !gl.loadShaders()) {
+        return nullptr;
+    }
+    const GLuint program = linkProgram();
+    if (program == 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<OverlayRenderer> renderer(new OverlayRenderer());
+    renderer->_program = program;
+    renderer->_textureLocation = gl.getUniformLocation(program, "atlas");
+    renderer->_projectionLocation = gl.getUniformLocation(program, "projection");
+
+    GLint previousProgram = 0;
+    GLint previousVertexArray = 0;
+    GLint previousArrayBuffer = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousArrayBuffer);
+
+    gl.useProgram(program);
+    gl.uniform1i(renderer->_textureLocation, 0);
+
+    // The vertex array remembers the index buffer and enabled attributes for good
+    GLuint vertexArray = 0;
+    GLuint buffers[2] = {};
+    gl.genVertexArrays(1, &vertexArray);
+    gl.genBuffers(2, buffers);
+    gl.bindVertexArray(vertexArray);
+    gl.bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    gl.enableVertexAttribArray(POSITION_ATTRIBUTE);
+    gl.enableVertexAttribArray(UV_ATTRIBUTE);
+    gl.enableVertexAttribArray(COLOR_ATTRIBUTE);
+    renderer->_vertexArray = vertexArray;
+    renderer->_vertexBuffer = buffers[0];
+    renderer->_indexBuffer = buffers[1];
+
+    gl.bindVertexArray(static_cast<GLuint>(previousVertexArray));
+    gl.bindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
+    gl.useProgram(static_cast<GLuint>(previousProgram));
+    return renderer;
+}
+
+OverlayRenderer::~OverlayRenderer() {
+    if (_fontTexture != 0) {
+        const GLuint texture = _fontTexture;
+        glDeleteTextures(1, &texture);
+    }
+    const GLuint buffers[2] = {_vertexBuffer, _indexBuffer};
+    gl.deleteBuffers(2, buffers);
+    const GLuint vertexArray = _vertexArray;
+    gl.deleteVertexArrays(1, &vertexArray);
+    gl.deleteProgram(_program);
+}
+
+bool OverlayRenderer::createFontsTexture() {
+    ImGuiIO& io = ImGui::GetIO();
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    if (!pixels || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    GLint previous = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+    GLuint texture = _fontTexture;
+    if (texture == 0) {
+        glGenTextures(1, &texture);
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    _fontMemory.set(static_cast<size_t>(width) * height * 4);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+
+    _fontTexture = texture;
+    io.Fonts->SetTexID((ImTextureID)(intptr_t)texture);
+    return true;
+}
+
+std::array<float, 16> OverlayRenderer::projection(const ImVec2& displayPos, const ImVec2& displaySize) {
+    const float left = displayPos.x;
+    const float right = displayPos.x + displaySize.x;
+    const float top = displayPos.y;
+    const float bottom = displayPos.y + displaySize.y;
+    // ImGui's y grows downwards, clip space's upwards
+    return {2.0f / (right - left),
+            0.0f,
+            0.0f,
+            0.0f,
+            0.0f,
+            2.0f / (top - bottom),
+            0.0f,
+            0.0f,
+            0.0f,
+            0.0f,
+            -1.0f,
+            0.0f,
+            (right + left) / (left - right),
+            (top + bottom) / (bottom - top),
+            0.0f,
+            1.0f};
+}
+
+bool OverlayRenderer::scissorBox(const ImVec4& clipRect, const ImVec2& displayPos, const ImVec2& scale,
+                                 int framebufferWidth, int framebufferHeight, std::array<int, 4>& box) {
+    const float minX = std::max((clipRect.x - displayPos.x) * scale.x, 0.0f);
+    const float minY = std::max((clipRect.y - displayPos.y) * scale.y, 0.0f);
+    const float maxX = std::min((clipRect.z - displayPos.x) * scale.x, static_cast<float>(framebufferWidth));
+    const float maxY = std::min((clipRect.w - displayPos.y) * scale.y, static_cast<float>(framebufferHeight));
+    if (maxX <= minX || maxY <= minY) {
+        return false;
+    }
+    box = {static_cast<int>(minX), static_cast<int>(static_cast<float>(framebufferHeight) - maxY),
+           static_cast<int>(maxX - minX), static_cast<int>(maxY - minY)};
+    return true;
+}
+
+size_t OverlayRenderer::growCapacity(size_t current, size_t needed) {
+    return std::max(needed, current + current / 2);
+}
+
+void OverlayRenderer::setupRenderState(int framebufferWidth, int framebufferHeight, const ImVec2& displayPos,
+                                       const ImVec2& displaySize) {
+    glEnable(GL_BLEND);
+    gl.blendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+    gl.blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+    gl.useProgram(_program);
+    // Only this renderer uses the program, so the uniform keeps its value between frames
+    const std::array<float, 16> matrix = projection(displayPos, displaySize);
+    if (matrix != _projection) {
+        gl.uniformMatrix4fv(_projectionLocation, 1, GL_FALSE, matrix.data());
+        _projection = matrix;
+    }
+
+    gl.activeTexture(GL_TEXTURE0);
+    gl.bindVertexArray(_vertexArray);
+    gl.bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    _boundTexture = NO_TEXTURE;
+}
+
+void OverlayRenderer::bindTexture(uint32_t texture) {
+    if (texture != _boundTexture) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        _boundTexture = texture;
+    }
+}
+
+void OverlayRenderer::upload(ImDrawData* drawData) {
+    const size_t vertexBytes = static_cast<size_t>(drawData->TotalVtxCount) * sizeof(ImDrawVert);
+    const size_t indexBytes = static_cast<size_t>(drawData->TotalIdxCount) * sizeof(ImDrawIdx);
+    if (vertexBytes > _vertexCapacity) {
+        _vertexCapacity = growCapacity(_vertexCapacity, vertexBytes);
+    }
+    if (indexBytes > _indexCapacity) {
+        _indexCapacity = growCapacity(_indexCapacity, indexBytes);
+    }
+
+    // Orphan last frame's storage so the copy never waits for the GPU to finish reading it
+    gl.bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_vertexCapacity), nullptr, GL_STREAM_DRAW);
+    gl.bufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(_indexCapacity), nullptr, GL_STREAM_DRAW);
+
+    size_t vertexOffset = 0;
+    size_t indexOffset = 0;
+    for (int n = 0; n < drawData->CmdListsCount; ++n) {
+        const ImDrawList* list = drawData->CmdLists[n];
+        const size_t listVertexBytes = static_cast<size_t>(list->VtxBuffer.Size) * sizeof(ImDrawVert);
+        const size_t listIndexBytes = static_cast<size_t>(list->IdxBuffer.Size) * sizeof(ImDrawIdx);
+        gl.bufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(vertexOffset), static_cast<GLsizeiptr>(listVertexBytes),
+                         list->VtxBuffer.Data);
+        gl.bufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(indexOffset),
+                         static_cast<GLsizeiptr>(listIndexBytes), list->IdxBuffer.Data);
+        vertexOffset += listVertexBytes;
+        indexOffset += listIndexBytes;
+    }
+}
+
+void OverlayRenderer::render(ImDrawData* drawData) {
+    const ImVec2 scale = drawData->FramebufferScale;
+    const int framebufferWidth = static_cast<int>(drawData->DisplaySize.x * scale.x);
+    const int framebufferHeight = static_cast<int>(drawData->DisplaySize.y * scale.y);
+    if (framebufferWidth <= 0 || framebufferHeight <= 0 || drawData->TotalVtxCount == 0) {
+        return;
+    }
+
+    SavedState saved;
+    saved.save();
+    setupRenderState(framebufferWidth, framebufferHeight, drawData->DisplayPos, drawData->DisplaySize);
+    upload(drawData);
+
+    const GLenum indexType = sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    std::array<int, 4> lastBox = {-1, -1, -1, -1};
+    size_t vertexOffset = 0;
+    size_t indexOffset = 0;
+    for (int n = 0; n < drawData->CmdListsCount; ++n) {
+        const ImDrawList* list = drawData->CmdLists[n];
+        // Indices are relative to their own list, so the attributes start at its vertices
+        const auto* base = reinterpret_cast<const char*>(vertexOffset);
+        gl.vertexAttribPointer(POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                               base + offsetof(ImDrawVert, pos));
+        gl.vertexAttribPointer(UV_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                               base + offsetof(ImDrawVert, uv));
+        gl.vertexAttribPointer(COLOR_ATTRIBUTE, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert),
+                               base + offsetof(ImDrawVert, col));
+
+        for (int c = 0; c < list->CmdBuffer.Size; ++c) {
+            const ImDrawCmd& cmd = list->CmdBuffer[c];
+            if (cmd.UserCallback) {
+                if (cmd.UserCallback == ImDrawCallback_ResetRenderState) {
+                    setupRenderState(framebufferWidth, framebufferHeight, drawData->DisplayPos,
+                                     drawData->DisplaySize);
+                } else {
+                    cmd.UserCallback(list, &cmd);
+                    _boundTexture = NO_TEXTURE;
+                }
+                lastBox = {-1, -1, -1, -1};
+                continue;
+            }
+
+            std::array<int, 4> box;
+            if (!scissorBox(cmd.ClipRect, drawData->DisplayPos, scale, framebufferWidth, framebufferHeight, box)) {
+                continue;
+            }
+            if (box != lastBox) {
+                glScissor(box[0], box[1], box[2], box[3]);
+                lastBox = box;
+            }
+            // ImTextureID is a pointer in some ImGui versions and an integer in others
+            bindTexture(static_cast<uint32_t>((intptr_t)cmd.GetTexID()));
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cmd.ElemCount), indexType,
+                           reinterpret_cast<const void*>(indexOffset + cmd.IdxOffset * sizeof(ImDrawIdx)));
+        }
+        vertexOffset += static_cast<size_t>(list->VtxBuffer.Size) * sizeof(ImDrawVert);
+        indexOffset += static_cast<size_t>(list->IdxBuffer.Size) * sizeof(ImDrawIdx);
+    }
+
+    saved.restore();
+}
+
+}  // namespace AutoVibez::UI
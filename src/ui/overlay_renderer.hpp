@@ -0,0 +1,90 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::UI {
+
+/**
+ * @brief Retained GL 3 / GLES 3 renderer for the ImGui overlay draw data
+ *
+ * Replaces the fixed-function OpenGL2 backend, which pushed the whole attribute
+ * stack around every overlay frame and streamed vertices from client arrays. The
+ * shader, vertex array and buffers are created once and kept; each frame the draw
+ * lists are copied into the same buffers (grown geometrically, orphaned between
+ * frames so the driver never waits on the previous draw) and only the state the
+ * overlay changes is saved and restored. Redundant texture and scissor changes
+ * inside a frame are skipped. Needs vertex array objects (GL 3.0,
+ * ARB_vertex_array_object or GLES 3.0); entry points come from
+ * SDL_GL_GetProcAddress like RenderScaler.
+ */
+class OverlayRenderer {
+public:
+    /**
+     * @brief Build the shader and buffers in the current context
+     * @return nullptr when the context has no vertex array objects or the shader does not compile
+     */
+    static std::unique_ptr<OverlayRenderer> create();
+
+    ~OverlayRenderer();
+
+    OverlayRenderer(const OverlayRenderer&) = delete;
+    OverlayRenderer& operator=(const OverlayRenderer&) = delete;
+
+    /**
+     * @brief Upload the font atlas of the current ImGui context and give it the texture
+     */
+    bool createFontsTexture();
+
+    /**
+     * @brief Draw one frame of ImGui output over whatever the framebuffer holds
+     */
+    void render(ImDrawData* drawData);
+
+    /**
+     * @brief Column-major orthographic projection mapping the display rectangle to clip space
+     */
+    static std::array<float, 16> projection(const ImVec2& displayPos, const ImVec2& displaySize);
+
+    /**
+     * @brief Convert an ImGui clip rectangle to a GL scissor box (bottom-left origin)
+     * @param box x, y, width, height in framebuffer pixels
+     * @return False when nothing of the rectangle is visible
+     */
+    static bool scissorBox(const ImVec4& clipRect, const ImVec2& displayPos, const ImVec2& scale, int framebufferWidth,
+                           int framebufferHeight, std::array<int, 4>& box);
+
+    /**
+     * @brief Buffer size to allocate so that needed bytes fit, growing by half at least
+     */
+    static size_t growCapacity(size_t current, size_t needed);
+
+private:
+    OverlayRenderer() = default;
+
+    void setupRenderState(int framebufferWidth, int framebufferHeight, const ImVec2& displayPos,
+                          const ImVec2& displaySize);
+    void bindTexture(uint32_t texture);
+    void upload(ImDrawData* drawData);
+
+    uint32_t _program = 0;
+    uint32_t _vertexArray = 0;
+    uint32_t _vertexBuffer = 0;
+    uint32_t _indexBuffer = 0;
+    uint32_t _fontTexture = 0;
+    Utils::MemoryCharge _fontMemory{Utils::MemoryTag::GpuTextures};
+    int _textureLocation = -1;
+    int _projectionLocation = -1;
+    size_t _vertexCapacity = 0;
+    size_t _indexCapacity = 0;
+    std::array<float, 16> _projection{};  // Last value given to the program
+    uint32_t _boundTexture = 0;
+};
+
+}  // namespace AutoVibez::UI
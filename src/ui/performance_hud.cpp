@@ -0,0 +1,188 @@
+#include "performance_hud.hpp"
+
+#include <imgui.h>
+
+#include <cstdio>
+
+#include "constants.hpp"
+
+using AutoVibez::Audio::AudioBand;
+using AutoVibez::Audio::AudioFeatureExtractor;
+using AutoVibez::Audio::AudioFeatures;
+using AutoVibez::Core::FramePhase;
+using AutoVibez::Core::FrameProfiler;
+using AutoVibez::Core::PhasePercentiles;
+using AutoVibez::Utils::MemoryAccounting;
+using AutoVibez::Utils::MemoryTag;
+using AutoVibez::Utils::MemoryUsage;
+
+namespace AutoVibez::UI {
+
+namespace {
+const ImVec4 LABEL_COLOR(0.0f, 1.0f, 0.8f, 1.0f);
+const ImVec4 VALUE_COLOR(0.95f, 0.95f, 0.95f, 1.0f);
+const ImVec4 OVER_BUDGET_COLOR(1.0f, 0.35f, 0.35f, 1.0f);
+constexpr float HUD_MARGIN = 10.0f;
+constexpr float PLOT_HEIGHT = 50.0f;
+constexpr float METER_WIDTH = 200.0f;
+constexpr float METER_HEIGHT = 10.0f;
+
+float megabytes(int64_t bytes) {
+    return static_cast<float>(bytes) / (1024.0f * 1024.0f);
+}
+
+void formatPercentiles(char* text, size_t size, const PhasePercentiles& stats) {
+    if (stats.samples == 0) {
+        std::snprintf(text, size, "%21s", "-");
+    } else {
+        std::snprintf(text, size, "%6.2f %6.2f %6.2f", stats.p50_ms, stats.p95_ms, stats.p99_ms);
+    }
+}
+}  // namespace
+
+PerformanceHud::PerformanceHud(const FrameProfiler& profiler) : _profiler(profiler) {}
+
+PerformanceHud::~PerformanceHud() {
+    ImGuiManager::removeLayer(this);
+}
+
+void PerformanceHud::init(SDL_Window* window, SDL_GLContext glContext) {
+    ImGuiManager::setRenderTarget(window, glContext);
+    ImGuiManager::addLayer(this);
+}
+
+void PerformanceHud::renderRow(const char* name, const PhasePercentiles& cpu, const PhasePercentiles* gpu,
+                               float valueColumn) {
+    char text[64];
+    ImGui::TextUnformatted(name);
+    ImGui::SameLine();
+    ImGui::SetCursorPosX(valueColumn);
+
+    const bool overBudget = _budgetMs > 0.0 && cpu.samples > 0 && cpu.p99_ms > _budgetMs;
+    formatPercentiles(text, sizeof(text), cpu);
+    ImGui::TextColored(overBudget ? OVER_BUDGET_COLOR : VALUE_COLOR, "%s", text);
+
+    if (gpu) {
+        const bool gpuOverBudget = _budgetMs > 0.0 && gpu->samples > 0 && gpu->p99_ms > _budgetMs;
+        formatPercentiles(text, sizeof(text), *gpu);
+        ImGui::SameLine();
+        ImGui::TextColored(gpuOverBudget ? OVER_BUDGET_COLOR : VALUE_COLOR, "  %s", text);
+    }
+}
+
+void PerformanceHud::drawWidgets() {
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - HUD_MARGIN,
+                                   viewport->WorkPos.y + HUD_MARGIN),
+                            ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(Constants::HELP_OVERLAY_ALPHA);
+    ImGui::Begin("Performance", nullptr,
+                 ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs |
+                     ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+
+    const bool gpu = _profiler.hasGpuTimer();
+    const float valueColumn = ImGui::GetCursorPosX() + ImGui::CalcTextSize("housekeeping  ").x;
+
+    ImGui::TextColored(LABEL_COLOR, "PERFORMANCE (ms over %zu frames, %s overlays)", _profiler.getSampleCount(),
+                       ImGuiManager::getBackendName());
+    ImGui::TextColored(LABEL_COLOR, "phase");
+    ImGui::SameLine();
+    ImGui::SetCursorPosX(valueColumn);
+    ImGui::TextColored(LABEL_COLOR, gpu ? "%6s %6s %6s    GPU p50/p95/p99" : "%6s %6s %6s", "p50", "p95", "p99");
+    ImGui::Separator();
+
+    for (size_t i = 0; i < AutoVibez::Core::FRAME_PHASE_COUNT; ++i) {
+        const FramePhase phase = static_cast<FramePhase>(i);
+        const PhasePercentiles gpuStats = _profiler.getGpuPercentiles(phase);
+        renderRow(FrameProfiler::phaseName(phase), _profiler.getCpuPercentiles(phase),
+                  gpu && FrameProfiler::isGpuPhase(phase) ? &gpuStats : nullptr, valueColumn);
+    }
+    ImGui::Separator();
+    renderRow("frame", _profiler.getFramePercentiles(), nullptr, valueColumn);
+
+    _profiler.getFrameHistory(_history);
+    if (!_history.empty()) {
+        const float scaleMax = _budgetMs > 0.0 ? static_cast<float>(2.0 * _budgetMs) : 3.4e38f;
+        char overlay[32];
+        std::snprintf(overlay, sizeof(overlay), _budgetMs > 0.0 ? "budget %.1f ms" : "uncapped", _budgetMs);
+        ImGui::PlotLines("##frames", _history.data(), static_cast<int>(_history.size()), 0, overlay, 0.0f, scaleMax,
+                         ImVec2(ImGui::GetContentRegionAvail().x, PLOT_HEIGHT));
+    }
+
+    renderMemory();
+    renderAudio();
+    ImGui::End();
+}
+
+void PerformanceHud::renderMemory() {
+    // Reading /proc every frame would cost more than the rest of the panel
+    const uint32_t now = SDL_GetTicks();
+    if (!_memorySampled || now - _memorySampledAt >= static_cast<uint32_t>(Constants::MEMORY_SAMPLE_INTERVAL_MS)) {
+        _process = MemoryAccounting::sample();
+        _memorySampledAt = now;
+        _memorySampled = true;
+    }
+
+    ImGui::Separator();
+    const float valueColumn = ImGui::GetCursorPosX() + ImGui::CalcTextSize("gpu_render_targets  ").x;
+    ImGui::TextColored(LABEL_COLOR, "memory");
+    ImGui::SameLine();
+    ImGui::SetCursorPosX(valueColumn);
+    ImGui::TextColored(LABEL_COLOR, "%9s %9s", "MB", "peak");
+    if (_process.resident_bytes >= 0) {
+        ImGui::TextUnformatted("resident");
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(valueColumn);
+        ImGui::TextColored(VALUE_COLOR, "%9.1f %9.1f", megabytes(_process.resident_bytes),
+                           megabytes(_process.peak_resident_bytes));
+        ImGui::TextUnformatted("untracked");
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(valueColumn);
+        ImGui::TextColored(VALUE_COLOR, "%9.1f",
+                           megabytes(_process.resident_bytes - MemoryAccounting::getTrackedBytes()));
+    }
+    for (size_t i = 0; i < AutoVibez::Utils::MEMORY_TAG_COUNT; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const MemoryUsage usage = MemoryAccounting::get(tag);
+        ImGui::TextUnformatted(MemoryAccounting::tagName(tag));
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(valueColumn);
+        ImGui::TextColored(VALUE_COLOR, "%9.1f %9.1f", megabytes(usage.bytes), megabytes(usage.peak_bytes));
+    }
+}
+
+void PerformanceHud::renderAudio() {
+    if (!_audioFeatures) {
+        return;
+    }
+    const AudioFeatures features = _audioFeatures->getFeatures();
+    char text[32];
+
+    ImGui::Separator();
+    const float valueColumn = ImGui::GetCursorPosX() + ImGui::CalcTextSize("low mid  ").x;
+    ImGui::TextColored(LABEL_COLOR, "audio");
+    ImGui::SameLine();
+    ImGui::SetCursorPosX(valueColumn);
+    ImGui::TextColored(LABEL_COLOR, "centroid %.0f Hz", features.centroid_hz);
+
+    // RMS fills the bar; the peak is printed on it
+    const float rms[] = {features.rms_left, features.rms_right};
+    const float peak[] = {features.peak_left, features.peak_right};
+    const char* channels[] = {"left", "right"};
+    for (int channel = 0; channel < 2; ++channel) {
+        ImGui::TextUnformatted(channels[channel]);
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(valueColumn);
+        std::snprintf(text, sizeof(text), "peak %.2f", peak[channel]);
+        ImGui::ProgressBar(rms[channel], ImVec2(METER_WIDTH, METER_HEIGHT), text);
+    }
+    for (size_t i = 0; i < AutoVibez::Audio::AUDIO_BAND_COUNT; ++i) {
+        ImGui::TextUnformatted(AudioFeatureExtractor::bandName(static_cast<AudioBand>(i)));
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(valueColumn);
+        std::snprintf(text, sizeof(text), "%.0f%%", 100.0f * features.bands[i]);
+        ImGui::ProgressBar(features.bands[i], ImVec2(METER_WIDTH, METER_HEIGHT), text);
+    }
+}
+
+}  // namespace AutoVibez::UI
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <vector>
+
+#include "audio_feature_extractor.hpp"
+#include "frame_profiler.hpp"
+#include "imgui_manager.hpp"
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::UI {
+
+/**
+ * @brief Corner panel with per-phase CPU/GPU percentiles and a frame-time plot
+ *
+ * Reads a FrameProfiler owned by the app; values over the frame budget are
+ * highlighted so the phase that blows it stands out. Below the timings, bytes
+ * held per memory tag and the resident size, read once a second, and level meters
+ * from the shared audio features when the app hands them over.
+ */
+class PerformanceHud : public OverlayLayer {
+public:
+    explicit PerformanceHud(const AutoVibez::Core::FrameProfiler& profiler);
+    ~PerformanceHud() override;
+
+    /**
+     * @brief Register with the ImGuiManager compositor
+     */
+    void init(SDL_Window* window, SDL_GLContext glContext);
+
+    void toggle() {
+        _visible = !_visible;
+    }
+    void setVisible(bool visible) {
+        _visible = visible;
+    }
+    bool isVisible() const {
+        return _visible;
+    }
+
+    /**
+     * @brief Frame budget in milliseconds (0 when uncapped, which disables highlighting)
+     */
+    void setBudgetMs(double budget_ms) {
+        _budgetMs = budget_ms;
+    }
+
+    /**
+     * @brief Features to draw level and band meters from (nullptr hides them)
+     */
+    void setAudioFeatures(const AutoVibez::Audio::AudioFeatureExtractor* features) {
+        _audioFeatures = features;
+    }
+
+    // OverlayLayer
+    bool isActive() override {
+        return _visible;
+    }
+    void drawWidgets() override;
+
+private:
+    void renderRow(const char* name, const AutoVibez::Core::PhasePercentiles& cpu,
+                   const AutoVibez::Core::PhasePercentiles* gpu, float valueColumn);
+    void renderMemory();
+    void renderAudio();
+
+    const AutoVibez::Core::FrameProfiler& _profiler;
+    const AutoVibez::Audio::AudioFeatureExtractor* _audioFeatures = nullptr;
+    bool _visible = false;
+    double _budgetMs = 0.0;
+    std::vector<float> _history;  // Reused every frame for the plot
+    AutoVibez::Utils::ProcessMemory _process;
+    uint32_t _memorySampledAt = 0;  // SDL ticks
+    bool _memorySampled = false;
+};
+
+}  // namespace AutoVibez::UI
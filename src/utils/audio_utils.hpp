@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <fstream>
 #include <string>
 
+#include "mp3_probe.hpp"
+
 namespace AutoVibez::Utils {
 
 /**
@@ -13,9 +16,18 @@ public:
     /**
      * @brief Check if a file is a valid MP3
      * @param file_path Path to the file to check
+     * @param cache Optional probe cache; a cached verdict for an unchanged file skips the read
+     * @return True if valid MP3, false otherwise
+     */
+    static bool isValidMP3File(const std::string& file_path, Mp3ProbeCache* cache = nullptr);
+
+    /**
+     * @brief Check an MP3 already in memory (e.g. a mapped file), without touching the disk
+     * @param data File contents
+     * @param size Number of bytes in data
      * @return True if valid MP3, false otherwise
      */
-    static bool isValidMP3File(const std::string& file_path);
+    static bool isValidMP3Data(const unsigned char* data, size_t size);
 
 private:
     /**
@@ -24,22 +36,6 @@ private:
      * @return True if file exists and is readable
      */
     static bool fileExists(const std::string& file_path);
-
-    /**
-     * @brief Check if the file contains valid MP3 frames
-     * @param file Open file stream to check
-     * @param start_offset Offset to start checking from
-     * @return True if valid MP3 frames found
-     */
-    static bool hasValidMP3Frames(std::ifstream& file, size_t start_offset);
-
-    /**
-     * @brief Validate MP3 frame header
-     * @param data Pointer to frame header data
-     * @param available_bytes Number of bytes available
-     * @return True if frame header is valid
-     */
-    static bool isValidMP3FrameHeader(const char* data, size_t available_bytes);
 };
 
 }  // namespace AutoVibez::Utils
@@ -0,0 +1,61 @@
+#include "bandwidth_governor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Utils {
+
+void BandwidthGovernor::setCeiling(int64_t bytes_per_second) {
+    bytes_per_second = std::max<int64_t>(bytes_per_second, 0);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_ceiling.load(std::memory_order_relaxed) == bytes_per_second) {
+        return;
+    }
+    // A new ceiling starts with a full bucket; the old one's debt is forgiven
+    _ceiling.store(bytes_per_second, std::memory_order_relaxed);
+    _tokens = bytes_per_second * (Constants::BANDWIDTH_BURST_MS / 1000.0);
+    _refilled = Clock::now();
+}
+
+bool BandwidthGovernor::tryConsume(int64_t bytes, Clock::time_point now) {
+    if (_ceiling.load(std::memory_order_relaxed) == 0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    const int64_t ceiling = _ceiling.load(std::memory_order_relaxed);
+    if (ceiling == 0) {
+        return true;
+    }
+    _tokens = tokensAt(now, ceiling);
+    _refilled = std::max(_refilled, now);
+    if (_tokens <= 0.0) {
+        return false;
+    }
+    _tokens -= static_cast<double>(bytes);
+    return true;
+}
+
+std::chrono::milliseconds BandwidthGovernor::timeUntilAvailable(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const int64_t ceiling = _ceiling.load(std::memory_order_relaxed);
+    if (ceiling == 0) {
+        return std::chrono::milliseconds(0);
+    }
+    const double tokens = tokensAt(now, ceiling);
+    if (tokens > 0.0) {
+        return std::chrono::milliseconds(0);
+    }
+    // Rounded up, and at least one, so a waiter never wakes to a bucket that is still empty
+    const double wait_ms = std::ceil((1.0 - tokens) * 1000.0 / static_cast<double>(ceiling));
+    return std::chrono::milliseconds(std::max<int64_t>(static_cast<int64_t>(wait_ms), 1));
+}
+
+double BandwidthGovernor::tokensAt(Clock::time_point now, int64_t ceiling) const {
+    const double burst = ceiling * (Constants::BANDWIDTH_BURST_MS / 1000.0);
+    const double elapsed = now > _refilled ? std::chrono::duration<double>(now - _refilled).count() : 0.0;
+    return std::min(burst, _tokens + elapsed * static_cast<double>(ceiling));
+}
+
+}  // namespace AutoVibez::Utils
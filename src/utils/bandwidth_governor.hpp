@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief One token bucket that every governed transfer draws received bytes from
+ *
+ * The bucket refills at the ceiling and holds BANDWIDTH_BURST_MS worth of it, so the
+ * transfers together never average more than the ceiling however many there are.
+ * A chunk is granted while the bucket holds any tokens, even one larger than what is
+ * left; the debt makes the next chunks wait it off. With no ceiling nothing waits
+ * and a grant takes no lock. Thread-safe.
+ */
+class BandwidthGovernor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Bytes per second shared by the governed transfers; 0 lifts the limit
+     */
+    void setCeiling(int64_t bytes_per_second);
+
+    int64_t getCeiling() const {
+        return _ceiling.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Take bytes from the bucket
+     * @return False, taking nothing, while the bucket is empty
+     */
+    bool tryConsume(int64_t bytes, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief How long until tryConsume can grant again; 0 when it can now
+     */
+    std::chrono::milliseconds timeUntilAvailable(Clock::time_point now = Clock::now()) const;
+
+private:
+    double tokensAt(Clock::time_point now, int64_t ceiling) const;
+
+    std::atomic<int64_t> _ceiling{0};
+    mutable std::mutex _mutex;
+    double _tokens = 0.0;
+    Clock::time_point _refilled;
+};
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Shared flag that asks long-running work to stop at its next check
+ *
+ * Copies share one flag, so the owner keeps a copy to cancel and hands the others to
+ * the work: a transfer's progress callback, a retry loop, a queued task. Checking is
+ * one atomic load. sleepFor() is a wait that cancel() cuts short, for backoff delays
+ * that would otherwise hold up shutdown. Thread-safe.
+ */
+class CancellationToken {
+public:
+    CancellationToken() : _state(std::make_shared<State>()) {}
+
+    /**
+     * @brief Ask every holder to stop; wakes those in sleepFor()
+     */
+    void cancel() const {
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            _state->cancelled.store(true, std::memory_order_release);
+        }
+        _state->wake.notify_all();
+    }
+
+    bool isCancelled() const {
+        return _state->cancelled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Wait for the duration unless cancelled first
+     * @return False if cancelled, before or during the wait
+     */
+    template <typename Rep, typename Period>
+    bool sleepFor(const std::chrono::duration<Rep, Period>& duration) const {
+        std::unique_lock<std::mutex> lock(_state->mutex);
+        return !_state->wake.wait_for(lock, duration, [this]() { return isCancelled(); });
+    }
+
+private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        std::condition_variable wake;
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,68 @@
+#include "circuit_breaker.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Utils {
+
+bool CircuitBreaker::refuses(const Breaker& breaker, Clock::time_point now) {
+    return breaker.trips > 0 && (now < breaker.open_until || breaker.probing);
+}
+
+bool CircuitBreaker::allow(const std::string& host, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _breakers.find(host);
+    if (it == _breakers.end()) {
+        return true;
+    }
+    Breaker& breaker = it->second;
+    if (refuses(breaker, now)) {
+        return false;
+    }
+    if (breaker.trips > 0) {
+        breaker.probing = true;
+    }
+    return true;
+}
+
+void CircuitBreaker::record(const std::string& host, bool ok, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (ok) {
+        _breakers.erase(host);
+        return;
+    }
+    Breaker& breaker = _breakers[host];
+    breaker.failures++;
+    // A failed probe reopens at once; a closed breaker takes a run of failures
+    if (breaker.probing || breaker.failures >= Constants::HOST_BREAKER_FAILURES) {
+        const int doublings = std::min(breaker.trips, 16);
+        const auto open = std::min<int64_t>(int64_t{Constants::HOST_BREAKER_OPEN_SECONDS} << doublings,
+                                            Constants::HOST_BREAKER_MAX_OPEN_SECONDS);
+        breaker.open_until = now + std::chrono::seconds(open);
+        breaker.trips++;
+        breaker.probing = false;
+    }
+}
+
+void CircuitBreaker::release(const std::string& host) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _breakers.find(host);
+    if (it != _breakers.end()) {
+        it->second.probing = false;
+    }
+}
+
+bool CircuitBreaker::isOpen(const std::string& host, Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _breakers.find(host);
+    return it != _breakers.end() && refuses(it->second, now);
+}
+
+size_t CircuitBreaker::getOpenCount(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<size_t>(std::count_if(_breakers.begin(), _breakers.end(),
+                                             [now](const auto& entry) { return refuses(entry.second, now); }));
+}
+
+}  // namespace AutoVibez::Utils
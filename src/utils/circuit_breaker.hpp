@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Per-host circuit breakers, so downloads from a host that is down fail at once
+ *
+ * HOST_BREAKER_FAILURES failures in a row open a host's breaker for HOST_BREAKER_OPEN_SECONDS,
+ * during which allow() refuses it. Once that has passed, one request is let through as a
+ * probe and the rest wait on its result: a success closes the breaker, a failure opens it
+ * again for twice as long, up to HOST_BREAKER_MAX_OPEN_SECONDS. Thread-safe.
+ */
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Whether a request to host may go ahead; the first one after a breaker's wait is its probe
+     */
+    bool allow(const std::string& host, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Note how a request that allow() let through ended
+     */
+    void record(const std::string& host, bool ok, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Forget a request that ended without saying anything of its host, e.g. a cancelled one
+     */
+    void release(const std::string& host);
+
+    bool isOpen(const std::string& host, Clock::time_point now = Clock::now()) const;
+
+    /**
+     * @brief Hosts whose breaker refuses requests now
+     */
+    size_t getOpenCount(Clock::time_point now = Clock::now()) const;
+
+private:
+    struct Breaker {
+        int failures = 0;  // In a row
+        int trips = 0;     // Times it opened since it last closed
+        Clock::time_point open_until;
+        bool probing = false;
+    };
+
+    static bool refuses(const Breaker& breaker, Clock::time_point now);
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, Breaker> _breakers;  // Hosts that failed since they last succeeded
+};
+
+}  // namespace AutoVibez::Utils
@@ -19,6 +19,15 @@
 
 namespace AutoVibez::Utils {
 
+namespace {
+// A JSON line built up by print() calls, per thread so lines from different threads never mix
+thread_local std::string partialLine;
+
+bool rendering() {
+    return ConsoleSink::instance().getFormat() == ConsoleFormat::Text;
+}
+}  // namespace
+
 // Static member initialization
 bool ConsoleOutput::_colorsEnabled = true;
 bool ConsoleOutput::_emojisEnabled = true;
@@ -37,65 +46,79 @@ void ConsoleOutput::setVerbose(bool verbose) {
 }
 
 void ConsoleOutput::print(const std::string& message, const std::string& color) {
-    if (_colorsEnabled) {
-        std::cout << color << message << Colors::RESET;
+    if (!rendering()) {
+        partialLine += message;
+    } else if (_colorsEnabled) {
+        ConsoleSink::instance().write(color + message + Colors::RESET);
     } else {
-        std::cout << message;
+        ConsoleSink::instance().write(message);
     }
 }
 
 void ConsoleOutput::println(const std::string& message, const std::string& color) {
-    print(message, color);
-    std::cout << std::endl;
+    if (!rendering()) {
+        partialLine += message;
+        ConsoleSink::instance().writeJson("info", ConsoleCategory::General, partialLine);
+        partialLine.clear();
+    } else if (_colorsEnabled) {
+        ConsoleSink::instance().write(color + message + Colors::RESET + "\n");
+    } else {
+        ConsoleSink::instance().write(message + "\n");
+    }
 }
 
 void ConsoleOutput::printBold(const std::string& message, const std::string& color) {
-    if (_colorsEnabled) {
-        std::cout << Styles::BOLD << color << message << Colors::RESET << std::endl;
-    } else {
-        std::cout << message << std::endl;
-    }
+    println(message, Styles::BOLD + color);
 }
 
 void ConsoleOutput::printItalic(const std::string& message, const std::string& color) {
-    if (_colorsEnabled) {
-        std::cout << Styles::ITALIC << color << message << Colors::RESET << std::endl;
-    } else {
-        std::cout << message << std::endl;
-    }
+    println(message, Styles::ITALIC + color);
 }
 
 void ConsoleOutput::printUnderline(const std::string& message, const std::string& color) {
-    if (_colorsEnabled) {
-        std::cout << Styles::UNDERLINE << color << message << Colors::RESET << std::endl;
+    println(message, Styles::UNDERLINE + color);
+}
+
+void ConsoleOutput::log(LogLevel level, const std::string& message, ConsoleCategory category) {
+    ConsoleSink& sink = ConsoleSink::instance();
+    if (!sink.admit(category)) {
+        return;
+    }
+    if (sink.getFormat() == ConsoleFormat::Json) {
+        sink.writeJson(getLevelName(level), category, message);
     } else {
-        std::cout << message << std::endl;
+        println(formatMessage(level, message));
     }
 }
 
-void ConsoleOutput::debug(const std::string& message) {
+void ConsoleOutput::debug(const std::string& message, ConsoleCategory category) {
     if (_verbose) {
-        println(formatMessage(LogLevel::DEBUG, message));
+        log(LogLevel::DEBUG, message, category);
     }
 }
 
-void ConsoleOutput::info(const std::string& message) {
-    println(formatMessage(LogLevel::INFO, message));
+void ConsoleOutput::info(const std::string& message, ConsoleCategory category) {
+    log(LogLevel::INFO, message, category);
 }
 
-void ConsoleOutput::success(const std::string& message) {
-    println(formatMessage(LogLevel::SUCCESS, message));
+void ConsoleOutput::success(const std::string& message, ConsoleCategory category) {
+    log(LogLevel::SUCCESS, message, category);
 }
 
-void ConsoleOutput::warning(const std::string& message) {
-    println(formatMessage(LogLevel::WARNING, message));
+void ConsoleOutput::warning(const std::string& message, ConsoleCategory category) {
+    log(LogLevel::WARNING, message, category);
 }
 
-void ConsoleOutput::error(const std::string& message) {
-    println(formatMessage(LogLevel::ERROR, message));
+void ConsoleOutput::error(const std::string& message, ConsoleCategory category) {
+    log(LogLevel::ERROR, message, category);
 }
 
 void ConsoleOutput::musicEvent(const std::string& event, const std::string& details) {
+    if (!rendering()) {
+        ConsoleSink::instance().writeJson("info", ConsoleCategory::General,
+                                          details.empty() ? event : event + " " + details);
+        return;
+    }
     std::string message = withEmoji(Symbols::MUSIC, event);
     if (!details.empty()) {
         message += " " + colorize(details, Colors::BRIGHT_CYAN);
@@ -104,17 +127,35 @@ void ConsoleOutput::musicEvent(const std::string& event, const std::string& deta
 }
 
 void ConsoleOutput::volumeChange(int oldVolume, int newVolume) {
+    if (!rendering()) {
+        ConsoleSink::instance().writeJson("info", ConsoleCategory::General,
+                                          "Volume: " + std::to_string(newVolume) + "%");
+        return;
+    }
     std::string message = std::string(Symbols::VOLUME) + " Volume: " + std::to_string(newVolume) + "%";
     std::string color = (newVolume > oldVolume) ? Colors::BRIGHT_GREEN : Colors::BRIGHT_YELLOW;
     println(message, color);
 }
 
 void ConsoleOutput::presetChange(const std::string& presetName) {
+    ConsoleSink& sink = ConsoleSink::instance();
+    if (!sink.admit(ConsoleCategory::Preset)) {
+        return;
+    }
+    if (sink.getFormat() == ConsoleFormat::Json) {
+        sink.writeJson("info", ConsoleCategory::Preset, "Preset: " + presetName);
+        return;
+    }
     std::string message = std::string(Symbols::SPARKLES) + " Preset: " + colorize(presetName, Colors::BRIGHT_MAGENTA);
     println(message, Colors::CYAN);
 }
 
 void ConsoleOutput::mixInfo(const std::string& artist, const std::string& title, const std::string& genre) {
+    if (!rendering()) {
+        ConsoleSink::instance().writeJson("info", ConsoleCategory::Mix,
+                                          "Now Playing: " + artist + " - " + title + " [" + genre + "]");
+        return;
+    }
     std::ostringstream oss;
     oss << std::string(Symbols::MUSIC) << " Now Playing: ";
     oss << colorize(artist, Colors::BRIGHT_YELLOW) << " - ";
@@ -124,12 +165,25 @@ void ConsoleOutput::mixInfo(const std::string& artist, const std::string& title,
 }
 
 void ConsoleOutput::downloadProgress(const std::string& filename, int percentage) {
+    ConsoleSink& sink = ConsoleSink::instance();
+    if (!sink.admit(ConsoleCategory::Download)) {
+        return;
+    }
+    if (sink.getFormat() == ConsoleFormat::Json) {
+        sink.writeJson("info", ConsoleCategory::Download,
+                       "Downloading " + filename + " " + std::to_string(percentage) + "%");
+        return;
+    }
     std::string message = std::string(Symbols::DOWNLOAD) + " Downloading " + colorize(filename, Colors::BRIGHT_WHITE);
     println(message + " " + std::to_string(percentage) + "%", Colors::BLUE);
     progressBar(percentage, 30, "");
 }
 
 void ConsoleOutput::printBanner(const std::string& title) {
+    if (!rendering()) {
+        return;
+    }
+
     // Old-school BBS ANSI art style banner
     println("", Colors::RESET);
     
@@ -160,6 +214,9 @@ void ConsoleOutput::printSection(const std::string& section) {
 }
 
 void ConsoleOutput::printSeparator(char character, int length) {
+    if (!rendering()) {
+        return;
+    }
     println(std::string(length, character), Colors::BRIGHT_BLACK);
 }
 
@@ -192,7 +249,10 @@ void ConsoleOutput::spinner(const std::string& message) {
     static const char* frames[] = {"|", "/", "-", "\\", "|", "/", "-", "\\"};
     static int frameIndex = 0;
 
-    std::cout << "\r" << frames[frameIndex] << " " << message << std::flush;
+    if (!rendering()) {
+        return;
+    }
+    ConsoleSink::instance().write(std::string("\r") + frames[frameIndex] + " " + message);
     frameIndex = (frameIndex + 1) % 8;
 }
 
@@ -221,7 +281,7 @@ void ConsoleOutput::rainbow(const std::string& message) {
         std::string color = rainbowColors[i % rainbowColors.size()];
         print(std::string(1, message[i]), color);
     }
-    std::cout << std::endl;
+    println("");
 }
 
 void ConsoleOutput::gradient(const std::string& message, const std::string& startColor, const std::string& endColor) {
@@ -235,7 +295,7 @@ void ConsoleOutput::gradient(const std::string& message, const std::string& star
         std::string color = (i % 2 == 0) ? startColor : endColor;
         print(std::string(1, message[i]), color);
     }
-    std::cout << std::endl;
+    println("");
 }
 
 std::string ConsoleOutput::colorize(const std::string& text, const std::string& color) {
@@ -276,6 +336,23 @@ std::string ConsoleOutput::formatMessage(LogLevel level, const std::string& mess
     return oss.str();
 }
 
+const char* ConsoleOutput::getLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:
+            return "debug";
+        case LogLevel::INFO:
+            return "info";
+        case LogLevel::SUCCESS:
+            return "success";
+        case LogLevel::WARNING:
+            return "warning";
+        case LogLevel::ERROR:
+            return "error";
+        default:
+            return "info";
+    }
+}
+
 std::string ConsoleOutput::getLevelColor(LogLevel level) {
     switch (level) {
         case LogLevel::DEBUG:
@@ -458,7 +535,12 @@ void ConsoleStream::flush() {
     if (_needsReset && ConsoleOutput::isColorsEnabled()) {
         _buffer << Colors::RESET;
     }
-    std::cout << _buffer.str() << std::endl;
+    ConsoleSink& sink = ConsoleSink::instance();
+    if (sink.getFormat() == ConsoleFormat::Json) {
+        sink.writeJson("info", ConsoleCategory::General, _buffer.str());
+    } else {
+        sink.write(_buffer.str() + "\n");
+    }
     _buffer.str("");
     _buffer.clear();
     _needsReset = false;
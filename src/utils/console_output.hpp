@@ -4,6 +4,8 @@
 #include <sstream>
 #include <string>
 
+#include "console_sink.hpp"
+
 namespace AutoVibez::Utils {
 
 /**
@@ -103,6 +105,10 @@ enum class LogLevel { DEBUG, INFO, SUCCESS, WARNING, ERROR };
 
 /**
  * @brief Sexy console output utility with colors, styles, and emojis
+ *
+ * Everything goes through ConsoleSink, which batches writes and rate-limits preset
+ * and download lines. When stdout is not a terminal the frequent messages skip the
+ * colouring and emojis and are written as JSON lines.
  */
 class ConsoleOutput {
 public:
@@ -124,11 +130,11 @@ public:
     static void printUnderline(const std::string& message, const std::string& color = Colors::WHITE);
 
     // Level-based logging
-    static void debug(const std::string& message);
-    static void info(const std::string& message);
-    static void success(const std::string& message);
-    static void warning(const std::string& message);
-    static void error(const std::string& message);
+    static void debug(const std::string& message, ConsoleCategory category = ConsoleCategory::General);
+    static void info(const std::string& message, ConsoleCategory category = ConsoleCategory::General);
+    static void success(const std::string& message, ConsoleCategory category = ConsoleCategory::General);
+    static void warning(const std::string& message, ConsoleCategory category = ConsoleCategory::General);
+    static void error(const std::string& message, ConsoleCategory category = ConsoleCategory::General);
 
     // Music-specific outputs
     static void musicEvent(const std::string& event, const std::string& details = "");
@@ -172,7 +178,9 @@ private:
     static bool _emojisEnabled;
     static bool _verbose;
 
+    static void log(LogLevel level, const std::string& message, ConsoleCategory category);
     static std::string formatMessage(LogLevel level, const std::string& message);
+    static const char* getLevelName(LogLevel level);
     static std::string getLevelColor(LogLevel level);
     static std::string getLevelEmoji(LogLevel level);
     static std::string getCurrentTimestamp();
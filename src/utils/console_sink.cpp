@@ -0,0 +1,193 @@
+#include "console_sink.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "json_utils.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Utils {
+
+namespace {
+bool isRateLimited(ConsoleCategory category) {
+    return category == ConsoleCategory::Preset || category == ConsoleCategory::Download;
+}
+
+// Copy of text without "ESC [ ... letter" sequences
+std::string stripAnsi(const std::string& text) {
+    std::string plain;
+    plain.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\033' && i + 1 < text.size() && text[i + 1] == '[') {
+            i += 2;
+            while (i < text.size() && !(text[i] >= '@' && text[i] <= '~')) {
+                ++i;
+            }
+            continue;
+        }
+        plain += text[i];
+    }
+    return plain;
+}
+}  // namespace
+
+ConsoleSink::ConsoleSink(ConsoleFormat format, std::ostream& out) : _out(out), _format(format) {
+    _thread = std::thread(&ConsoleSink::run, this);
+}
+
+ConsoleSink::~ConsoleSink() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+    flush();
+}
+
+ConsoleSink& ConsoleSink::instance() {
+    // Never destroyed, so output from static destructors still goes somewhere
+    static ConsoleSink* sink = []() {
+        ConsoleSink* created = new ConsoleSink(isatty(fileno(stdout)) ? ConsoleFormat::Text : ConsoleFormat::Json);
+        std::atexit([]() { ConsoleSink::instance().flush(); });
+        return created;
+    }();
+    return *sink;
+}
+
+uint64_t ConsoleSink::getSuppressedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _suppressed;
+}
+
+const char* ConsoleSink::categoryName(ConsoleCategory category) {
+    switch (category) {
+        case ConsoleCategory::General:
+            return "general";
+        case ConsoleCategory::Mix:
+            return "mix";
+        case ConsoleCategory::Preset:
+            return "preset";
+        case ConsoleCategory::Download:
+            return "download";
+    }
+    return "unknown";
+}
+
+bool ConsoleSink::admit(ConsoleCategory category, Clock::time_point now) {
+    if (!isRateLimited(category)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    closeWindows(now);
+    Window& window = _windows[static_cast<size_t>(category)];
+    if (window.lines == 0) {
+        window.start = now;
+    }
+    if (window.lines < Constants::CONSOLE_RATE_LIMIT_LINES) {
+        window.lines++;
+        return true;
+    }
+    window.suppressed++;
+    _suppressed++;
+    return false;
+}
+
+void ConsoleSink::closeWindows(Clock::time_point now) {
+    const auto length = std::chrono::milliseconds(Constants::CONSOLE_RATE_WINDOW_MS);
+    for (size_t index = 0; index < CONSOLE_CATEGORY_COUNT; ++index) {
+        Window& window = _windows[index];
+        if (window.lines == 0 || now - window.start < length) {
+            continue;
+        }
+        if (window.suppressed > 0) {
+            const auto category = static_cast<ConsoleCategory>(index);
+            const std::string note =
+                std::to_string(window.suppressed) + " " + categoryName(category) + " lines suppressed";
+            if (getFormat() == ConsoleFormat::Text) {
+                _pending += "(" + note + ")\n";
+            } else {
+                appendJson("info", category, note, window.suppressed);
+            }
+        }
+        window = Window();
+    }
+}
+
+bool ConsoleSink::anySuppressed() const {
+    for (const Window& window : _windows) {
+        if (window.suppressed > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ConsoleSink::write(const std::string& text) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending += text;
+    }
+    _wake.notify_one();
+}
+
+void ConsoleSink::writeJson(const char* level, ConsoleCategory category, const std::string& message) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        appendJson(level, category, message, 0);
+    }
+    _wake.notify_one();
+}
+
+void ConsoleSink::appendJson(const char* level, ConsoleCategory category, const std::string& message,
+                             uint64_t suppressed) {
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    _pending += "{\"time_ms\":" + std::to_string(now) + ",\"level\":\"" + level + "\",\"category\":\"" +
+                categoryName(category) + "\",\"message\":\"" + JsonUtils::escapeJsonString(stripAnsi(message)) +
+                "\"";
+    if (suppressed > 0) {
+        _pending += ",\"suppressed\":" + std::to_string(suppressed);
+    }
+    _pending += "}\n";
+}
+
+void ConsoleSink::flush() {
+    std::lock_guard<std::mutex> order(_writeMutex);
+    std::string batch;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        batch.swap(_pending);
+    }
+    if (!batch.empty()) {
+        _out.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        _out.flush();
+    }
+}
+
+void ConsoleSink::run() {
+    const auto interval = std::chrono::milliseconds(Constants::CONSOLE_FLUSH_INTERVAL_MS);
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopping) {
+        // Idle until something is queued, or a rate window still owes its summary
+        if (_pending.empty() && !anySuppressed()) {
+            _wake.wait(lock, [this]() { return _stopping || !_pending.empty(); });
+            continue;
+        }
+        _wake.wait_for(lock, interval, [this]() { return _stopping; });
+        closeWindows(Clock::now());
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+}  // namespace AutoVibez::Utils
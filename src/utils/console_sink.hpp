@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief What a console line is about; the repetitive categories are rate-limited
+ */
+enum class ConsoleCategory : uint8_t { General, Mix, Preset, Download };
+
+constexpr size_t CONSOLE_CATEGORY_COUNT = 4;
+
+/**
+ * @brief How lines reach stdout: rendered with colours for a terminal, or one JSON object per line
+ */
+enum class ConsoleFormat : uint8_t { Text, Json };
+
+/**
+ * @brief Buffered, thread-safe destination of everything ConsoleOutput prints
+ *
+ * Lines from any thread are appended to one buffer under a short lock. A writer
+ * thread sleeps until something is queued, waits Constants::CONSOLE_FLUSH_INTERVAL_MS
+ * (about a frame) so lines from the same frame coalesce, then writes the batch with
+ * one write and one flush. Preset and download lines are limited to
+ * Constants::CONSOLE_RATE_LIMIT_LINES per Constants::CONSOLE_RATE_WINDOW_MS; the rest
+ * are dropped before anything is formatted and summed up in one line when the window
+ * ends. Attached to a terminal the sink takes rendered text; otherwise ConsoleOutput
+ * skips the colouring and the sink writes JSON lines with the time, level, category
+ * and message.
+ */
+class ConsoleSink {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param out Stream written to, std::cout by default (its buffer is looked up on every write)
+     */
+    explicit ConsoleSink(ConsoleFormat format, std::ostream& out = std::cout);
+
+    /**
+     * @brief Writes what is queued, then joins the writer
+     */
+    ~ConsoleSink();
+
+    ConsoleSink(const ConsoleSink&) = delete;
+    ConsoleSink& operator=(const ConsoleSink&) = delete;
+
+    /**
+     * @brief The process-wide sink on stdout, Text on a terminal and Json otherwise; never destroyed, flushed at exit
+     */
+    static ConsoleSink& instance();
+
+    ConsoleFormat getFormat() const {
+        return _format.load(std::memory_order_relaxed);
+    }
+    void setFormat(ConsoleFormat format) {
+        _format.store(format, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Take a line of a category if its rate limit allows; call before formatting it
+     */
+    bool admit(ConsoleCategory category, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Queue rendered text (Text format), with its own newlines
+     */
+    void write(const std::string& text);
+
+    /**
+     * @brief Queue one JSON line (Json format); ANSI escapes in the message are dropped
+     * @param level Static label, e.g. "info"
+     */
+    void writeJson(const char* level, ConsoleCategory category, const std::string& message);
+
+    /**
+     * @brief Write everything queued before the call, on the calling thread
+     */
+    void flush();
+
+    /**
+     * @brief Lines the rate limits turned away so far
+     */
+    uint64_t getSuppressedCount() const;
+
+    static const char* categoryName(ConsoleCategory category);
+
+private:
+    struct Window {
+        Clock::time_point start;
+        int lines = 0;
+        uint64_t suppressed = 0;  // In this window
+    };
+
+    void run();
+    void closeWindows(Clock::time_point now);
+    bool anySuppressed() const;
+    void appendJson(const char* level, ConsoleCategory category, const std::string& message, uint64_t suppressed);
+
+    std::ostream& _out;
+    std::atomic<ConsoleFormat> _format;
+    mutable std::mutex _mutex;  // Guards the pending text, the windows and the counters below
+    std::mutex _writeMutex;     // Keeps batches in order when flush() and the writer race
+    std::condition_variable _wake;
+    std::string _pending;
+    std::array<Window, CONSOLE_CATEGORY_COUNT> _windows{};
+    uint64_t _suppressed = 0;
+    bool _stopping = false;
+
+    std::thread _thread;
+};
+
+}  // namespace AutoVibez::Utils
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Constants {
 // Audio
 constexpr int DEFAULT_SAMPLE_RATE = 44100;
@@ -10,25 +12,223 @@ constexpr int MAX_VOLUME = 100;
 constexpr int MIN_VOLUME = 0;
 constexpr int BITS_PER_SAMPLE = 16;
 constexpr int ID3V2_HEADER_SIZE = 10;
+constexpr int PCM_RING_BUFFER_SAMPLES = 16384;  // Interleaved stereo samples buffered between audio and render threads
+constexpr int PCM_CONVERT_CHUNK_SAMPLES = 1024;  // Stack scratch size used when converting PCM on the audio thread
+constexpr int MONITOR_CAPTURE_QUANTUM_FRAMES = 256;  // Frames per wakeup for native sink-monitor capture
+constexpr int MAX_NATIVE_PERIOD_FRAMES = 4096;       // Longer reported device periods fall back to DEFAULT_SAMPLES
+constexpr int CAPTURE_PERIOD_MIN_FRAMES = 128;       // Smallest capture period the adaptive controller tries
+constexpr int DECK_MIX_BLOCK_FRAMES = 1024;          // Frames mixed per pass in the two-deck playback engine
+constexpr int NEXT_MIX_PREFETCH_SECONDS = 5;         // Audio pre-decoded for the queued next mix
+constexpr int STREAM_FEED_CHUNK_BYTES = 16384;       // Partial-download bytes fed to the decoder per read
+constexpr int DEFAULT_STREAM_START_KB = 512;         // Downloaded before progressive playback starts
+constexpr int STREAM_START_TIMEOUT_SECONDS = 30;     // Give up waiting for the first streamed bytes
+constexpr int STREAM_START_POLL_MS = 20;
+constexpr int MAPPED_READAHEAD_BYTES = 4 * 1024 * 1024;  // Paged in ahead of the decoder for mapped mixes
+constexpr int ANALYSIS_DECODE_BLOCK_FRAMES = 4096;       // Frames decoded per step by the ingest analyzer
+constexpr int ANALYSIS_CENTROID_FFT_SIZE = 2048;         // Window of the ingest spectral centroid
+constexpr int ANALYSIS_CENTROID_HOP_FRAMES = 22050;      // One centroid window per hop (0.5 s at 44.1 kHz)
+constexpr int SEEK_INDEX_INTERVAL_SECONDS = 5;           // Audio between stored seek-index entries
+constexpr int SEEK_INDEX_GROWTH_ENTRIES = 4096;          // libmpg123 index growth while capturing
+constexpr double DEFAULT_LOUDNESS_TARGET_LUFS = -14.0;   // Playback level mixes are normalized to
+constexpr double LOUDNESS_PEAK_CEILING_DBFS = -1.0;      // Normalization never pushes peaks above this
+constexpr double MAX_LOUDNESS_GAIN_DB = 12.0;
+constexpr int BEAT_FFT_SIZE = 1024;                    // Spectral-flux window of the live beat tracker
+constexpr int BEAT_HOP_FRAMES = 512;                   // ~11.6 ms onset resolution at 44.1 kHz
+constexpr int BEAT_ENVELOPE_HOPS = 512;                // ~6 s of onsets searched for the tempo
+constexpr int AUDIO_FEATURE_FFT_SIZE = 1024;           // Window of the shared band energies and spectral centroid
+constexpr double AUDIO_BAND_BASS_MAX_HZ = 150.0;       // Upper edges of the bass, low-mid and mid feature bands
+constexpr double AUDIO_BAND_LOW_MID_MAX_HZ = 600.0;
+constexpr double AUDIO_BAND_MID_MAX_HZ = 4000.0;
+constexpr int PROJECTM_PCM_WINDOW_FRAMES = 576;         // Samples projectM's waveform and spectrum look back over
+constexpr int DEFAULT_DISPLAY_QUEUE_FRAMES = 2;        // Swapped frames waiting for scanout under vsync
+constexpr int MAX_AV_DELAY_MS = 250;                   // Most the speakers are held back to match the visuals
+constexpr int AV_OFFSET_STEP_MS = 5;                   // Calibration offset change per key press
+constexpr int CALIBRATION_CLICK_INTERVAL_MS = 500;     // Click spacing of the latency test pattern (120 BPM)
+constexpr int CALIBRATION_CLICK_MS = 10;               // Length of each 1 kHz click
+constexpr int CALIBRATION_CLICK_HOLDOFF_MS = 100;      // Quiet needed before the detector accepts a new click
+constexpr int CALIBRATION_FLASH_MS = 60;               // Screen stays white this long per detected click
+constexpr float CALIBRATION_CLICK_THRESHOLD = 0.2f;    // Sample level that counts as a click in drained PCM
 
 // Beat sensitivity
 
 // File validation
-constexpr int MIN_MP3_FILE_SIZE = 1024;  // Minimum valid MP3 file size in bytes
+constexpr int MIN_MP3_FILE_SIZE = 1024;          // Minimum valid MP3 file size in bytes
+constexpr int MP3_PROBE_HEAD_BYTES = 64 * 1024;  // One read covers the ID3v2 text frames and first frame
+constexpr int MP3_PROBE_SYNC_SCAN_BYTES = 4096;  // Searched for a frame header after the ID3v2 tag
+
+// Download verification
+constexpr int MP3_STREAM_HEAD_MAX_BYTES = 4 * 1024 * 1024;  // Most of a download's head kept for the probe
+constexpr int CONTENT_HASH_READ_BYTES = 1024 * 1024;        // Read at a time to hash bytes already on disk
+
+// Download writes
+constexpr int DOWNLOAD_WRITE_BUFFER_BYTES = 2 * 1024 * 1024;  // Collected before a background download writes
+constexpr int DOWNLOAD_STREAMING_FLUSH_BYTES = 64 * 1024;     // Written at a time while playback reads the file
+
+// Download telemetry
+constexpr int DOWNLOAD_RATE_SAMPLE_MS = 500;         // Shortest span one rate sample covers
+constexpr double DOWNLOAD_RATE_SMOOTHING = 0.25;     // Weight of the newest sample in the smoothed rate
+constexpr int DOWNLOAD_STATS_WINDOW_SECONDS = 3600;  // Completions counted as the recent rate
+
+// Download retries
+constexpr int DOWNLOAD_RETRY_BASE_SECONDS = 60;          // Wait after a mix's first failure, doubled for each after
+constexpr int DOWNLOAD_RETRY_MAX_SECONDS = 6 * 60 * 60;  // Longest wait before a mix is tried again
+constexpr double DOWNLOAD_RETRY_JITTER = 0.5;            // Share of a wait taken off at random, to spread retries
+constexpr int HOST_BREAKER_FAILURES = 3;                 // Failures in a row that take a host out of rotation
+constexpr int HOST_BREAKER_OPEN_SECONDS = 60;            // First time out, doubled each time a probe fails
+constexpr int HOST_BREAKER_MAX_OPEN_SECONDS = 30 * 60;   // Longest time out
+
+// Ingest pipeline
+constexpr int INGEST_ANALYSIS_MAX_WORKERS = 4;  // Tag analysis threads; one fewer than the cores, at least one
+constexpr int INGEST_QUEUE_PER_WORKER = 2;      // Fetched mixes waiting per analysis thread before fetches block
+constexpr int INGEST_INDEX_QUEUE = 64;          // Analyzed mixes waiting for the database writer
+constexpr int INGEST_INDEX_BATCH = 32;          // Mixes the writer adds in one transaction
+
+// Library import
+constexpr int LIBRARY_IMPORT_WALKERS = 4;                // Threads listing directories; a share answers each slowly
+constexpr int LIBRARY_IMPORT_SCAN_WORKERS = 8;           // Tag readers, mostly waiting on the share rather than a core
+constexpr int LIBRARY_IMPORT_BATCH = 256;                // Mixes added per transaction
+constexpr double LIBRARY_IMPORT_PROGRESS_SECONDS = 2.0;  // Between progress reports
 
 // Crossfade
 constexpr int DEFAULT_CROSSFADE_DURATION_MS = 3000;
 
+// Mix control thread
+constexpr int MIX_CONTROL_QUEUE_CAPACITY = 256;     // Commands (and events) in flight before posts are dropped
+constexpr int MIX_CONTROL_INTERVAL_MS = 10;         // Longest sleep between housekeeping ticks
+constexpr int HEADLESS_CONTROL_INTERVAL_MS = 100;   // The same without a screen; no frame waits on the tick
+constexpr int MIX_CONTROL_IDLE_INTERVAL_MS = 1000;  // Longest sleep with event_driven_loop, for what signals nothing
+constexpr int MIX_EVENT_FRAME_BUDGET_US = 2000;     // Render thread time per frame for control thread events
+constexpr int MIX_TABLE_REFRESH_MS = 1000;          // Help overlay mix table reload while it is shown
+constexpr int HELP_OVERLAY_STATS_REFRESH_MS = 250;  // Help overlay volume, device and stats polling while shown
+constexpr int SEARCH_QUERY_MAX_LENGTH = 128;        // Help overlay search box, including the terminator
+constexpr int CONFIG_RELOAD_CHECK_MS = 1000;        // Config file modification check with config_hot_reload
+
+// Startup
+constexpr int STARTUP_MAX_WORKERS = 4;              // Threads running startup tasks beside window and GL creation
+constexpr int STARTUP_FIRST_FRAME_TARGET_MS = 500;  // Time to first frame a slower start is logged against
+
+// Tracing
+constexpr int TRACE_EVENTS_PER_THREAD = 65536;  // Preallocated per recording thread; later events are dropped
+
+// Real-time checks
+constexpr int REALTIME_STACK_FRAMES = 32;  // Frames printed with each allocation or lock on an audio thread
+
+// Task executor
+constexpr int TASK_EXECUTOR_MIN_WORKERS = 2;  // A blocking prefetch must not stall every other task on a single core
+
+// Logging
+constexpr int LOG_QUEUE_CAPACITY = 1024;           // Records waiting for the writer before new ones are dropped
+constexpr int LOG_RECORD_TEXT_BYTES = 480;         // Message bytes kept per record; longer ones are cut
+constexpr int LOG_FLUSH_INTERVAL_MS = 250;         // Longest a record waits to be written; errors go at once
+constexpr int LOG_ROTATE_BYTES = 4 * 1024 * 1024;  // autovibez.log is rotated once it would pass this
+constexpr int LOG_ROTATE_KEEP = 3;                 // Rotated files kept, autovibez.log.1 being the newest
+constexpr int CONSOLE_FLUSH_INTERVAL_MS = 16;      // Console lines batched into one write, about a frame
+constexpr int CONSOLE_RATE_WINDOW_MS = 1000;       // Window of the preset and download line limits
+constexpr int CONSOLE_RATE_LIMIT_LINES = 4;        // Lines per window of each limited category; the rest are counted
+
+// Metrics
+constexpr int METRICS_EXPORT_INTERVAL_MS = 10000;  // How often metrics go to StatsD and the textfile
+constexpr int METRICS_STATSD_PACKET_BYTES = 1432;  // Largest StatsD datagram; fits a 1500-byte MTU with headers
+
+// Memory accounting
+constexpr int MEMORY_SAMPLE_INTERVAL_MS = 1000;    // Resident size read at most this often for the HUD and the log
+constexpr int MEMORY_LOG_STEP_MB = 64;             // A resident high this far past the last logged one logs a breakdown
+constexpr int YAML_TREE_BYTES_PER_TEXT_BYTE = 37;  // yaml-cpp 0.7 node tree per byte of manifest, measured
+
+// Render thread
+constexpr int EVENT_FORWARD_QUEUE_LIMIT = 4096;  // Forwarded events before mouse motion is dropped
+constexpr int EVENT_PUMP_TIMEOUT_MS = 10;        // Longest main-thread wait between event pumps
+
 // Database
 constexpr int MAX_RETRIES = 3;
 constexpr int DEFAULT_TIMEOUT_SECONDS = 30;
+constexpr int STATEMENT_CACHE_CAPACITY = 64;                 // Prepared statements kept per connection
+constexpr int MIX_DB_MMAP_MB = 64;                           // Mix database read through a memory map
+constexpr int MIX_DB_CACHE_KB = 8 * 1024;                    // Page cache per mix database connection
+constexpr int MIX_DB_BUSY_TIMEOUT_MS = 5000;                 // Wait for another connection's lock this long
+constexpr int MIX_DB_CHECKPOINT_INTERVAL_MS = 30 * 1000;     // Passive WAL checkpoint at most this often
+constexpr int MIX_DB_POOL_MAX_IDLE = 4;                      // Connections kept open for threads yet to come
+constexpr int MIX_DB_OPTIMIZE_INTERVAL_MS = 60 * 60 * 1000;  // PRAGMA optimize after writes at most this often
+constexpr int MIX_DB_BACKUP_PAGES_PER_STEP = 64;             // Pages an online backup copies per read lock
+constexpr int MIX_DB_BACKUP_STEP_PAUSE_MS = 5;               // Pause between backup steps, for writers to get in
+constexpr int MIX_DB_BACKUP_MAX_RESTARTS = 3;                // Restarts by writers before copying the rest at once
+constexpr int QUERY_LATENCY_BUCKETS = 24;                    // Power-of-two microsecond buckets, the last open-ended
+constexpr int SHARED_CATALOG_SYNC_INTERVAL_MS = 1000;        // Look for a new shared catalog at most this often
+constexpr int SHARED_CATALOG_MERGE_LIMIT = 64;               // Changed mixes merged one by one, past it reloaded
 
 // Download
 constexpr int MIN_DOWNLOAD_SPEED_BYTES_PER_SEC = 1000;  // 1KB/s minimum
 constexpr int DOWNLOAD_TIMEOUT_SECONDS = 300;           // 5 minutes timeout
 constexpr int DOWNLOAD_LOW_SPEED_TIME_SECONDS = 60;     // 60 seconds
+constexpr int DOWNLOAD_WORKERS = 3;                     // Background transfers at once, plus one for playback
+constexpr int DOWNLOADS_PER_HOST = 2;                   // Transfers from one server at once
+constexpr int PLAYING_DOWNLOAD_LIMIT_KB = 1024;         // KB/s for background downloads while a mix plays
+constexpr int BANDWIDTH_BURST_MS = 250;                 // Token bucket size, as time at the ceiling
 constexpr int MAX_FILENAME_LENGTH = 200;
 
+// Segmented download
+constexpr long long SEGMENTED_DOWNLOAD_MIN_BYTES = 32LL * 1024 * 1024;  // Smaller files come in one stream
+constexpr long long DOWNLOAD_SEGMENT_BYTES = 8LL * 1024 * 1024;         // Range fetched by one request
+constexpr int SEGMENTED_INITIAL_STREAMS = 2;                            // Ranges in flight at first
+constexpr int SEGMENTED_MAX_STREAMS = 6;                                // Most ranges in flight for one file
+constexpr double SEGMENTED_GROWTH_SPEEDUP = 1.1;                        // Gain a stream must bring to keep adding
+
+// LAN peer cache
+constexpr int PEER_MULTICAST_PORT = 47477;        // Announcements of the mixes each node holds
+constexpr int PEER_ANNOUNCE_INTERVAL_MS = 30000;  // Every held mix is announced this often
+constexpr int PEER_EXPIRY_MS = 95000;             // A holder not heard from for this long is forgotten
+constexpr int PEER_DATAGRAM_BYTES = 1400;         // Announcement size, under a LAN's MTU
+constexpr int PEER_UPLOAD_WORKERS = 2;            // Files served to other nodes at once
+constexpr int PEER_IO_TIMEOUT_SECONDS = 30;       // A peer connection idle this long is dropped
+constexpr int PEER_MAX_SOURCES = 3;               // Peers tried for one mix before the origin
+constexpr int PEER_REQUEST_MAX_BYTES = 8 * 1024;  // Longest request header a node reads
+
+// Remote control
+constexpr int REMOTE_CONTROL_MAX_CLIENTS = 128;               // Connections held at once; more are refused
+constexpr int REMOTE_CONTROL_REQUEST_MAX_BYTES = 8 * 1024;    // Longest request header or WebSocket message
+constexpr int REMOTE_CONTROL_BACKLOG_MAX_BYTES = 256 * 1024;  // Unsent events before a slow client is dropped
+constexpr int REMOTE_CONTROL_REQUEST_TIMEOUT_MS = 10000;      // An HTTP request still incomplete this long is dropped
+constexpr int REMOTE_CONTROL_METRICS_INTERVAL_MS = 1000;      // Metrics pushed to WebSocket clients this often
+
+// Multi-node sync
+constexpr int SYNC_MULTICAST_PORT = 47478;          // Leader state and clock exchanges
+constexpr int SYNC_STATE_INTERVAL_MS = 50;          // The leader multicasts its state this often
+constexpr int SYNC_TIME_REQUEST_INTERVAL_MS = 250;  // A follower measures its offset from the leader's clock this often
+constexpr int SYNC_CLOCK_SAMPLES = 16;              // Offset measurements kept; the one with the least delay counts
+constexpr int SYNC_LEADER_TIMEOUT_MS = 2000;        // A leader not heard from this long is lost
+constexpr int SYNC_CUT_LEAD_MS = 200;               // Preset cuts are announced this far ahead of the leader's own
+constexpr int SYNC_MIX_CHECK_INTERVAL_MS = 1000;    // A follower compares its mix position with the leader's this often
+constexpr int SYNC_MIX_DRIFT_MS = 60;               // A follower on the leader's mix seeks this far off (~3 buffers)
+constexpr int SYNC_MIX_RESEEK_MS = 250;             // Until a seek brings it back in step, it seeks again only this far
+constexpr int SYNC_MIX_SETTLED_MS = 20;             // This close counts as back in step
+
+// Delta sync of play stats and favorites
+constexpr int MIX_SYNC_DEFAULT_INTERVAL_SECONDS = 300;         // Between exchanges with the sync server
+constexpr int MIX_SYNC_MAX_BACKOFF_SECONDS = 3600;             // Each failed exchange doubles the wait, up to this
+constexpr int MIX_SYNC_BATCH_EVENTS = 2000;                    // Play events folded into one delta
+constexpr int MIX_SYNC_BATCH_FAVORITES = 500;                  // Favorite changes in one delta
+constexpr int MIX_SYNC_MAX_BATCHES = 8;                        // Deltas per exchange while a backlog drains
+constexpr int64_t MIX_SYNC_MAX_REPLY_BYTES = 4 * 1024 * 1024;  // Longer replies are dropped, the delta sent again
+
+// Mix file cache
+constexpr int MIX_CACHE_EVICTION_BATCH = 16;   // Files evicted before the running total is read again
+constexpr int MIX_CACHE_BACKFILL_BATCH = 256;  // Files sized per transaction for mixes from before the cache
+constexpr int MIX_CACHE_PLAY_CREDIT_DAYS = 7;  // Each play keeps a mix as if last used this much later
+constexpr int MIX_CACHE_MAX_PLAY_CREDITS = 8;  // Plays that count towards that
+
+// Low-bitrate transcoded copies of cached mixes
+constexpr int OPUS_SAMPLE_RATE = 48000;             // opusfile always decodes at this rate
+constexpr int TRANSCODE_DEFAULT_BITRATE_KBPS = 96;  // Stereo Opus; transparent enough for a PA
+constexpr int TRANSCODE_MIN_BITRATE_KBPS = 32;
+constexpr int TRANSCODE_MAX_BITRATE_KBPS = 256;
+constexpr int TRANSCODE_BLOCK_FRAMES = 4096;        // Frames decoded and encoded per step
+
+// Library maintenance
+constexpr int MAINTENANCE_BUDGET_MS_PER_SECOND = 5;            // Time the consistency checks may take per second
+constexpr int MAINTENANCE_TICK_BUDGET_MS = 1;                  // And per tick, so no one frame carries it
+constexpr int MAINTENANCE_REMOVAL_SETTLE_MS = 2000;            // A missing file waits this long before its row goes
+constexpr int MAINTENANCE_SWEEP_INTERVAL_MS = 15 * 60 * 1000;  // From the end of one full pass to the next
+
 // UUID
 constexpr int UUID_BYTE_LENGTH = 16;
 constexpr int UUID_POSITION_1 = 4;
@@ -42,6 +242,7 @@ constexpr int SECONDS_PER_MINUTE = 60;
 // HTTP/Network
 constexpr int HTTP_TIMEOUT_SECONDS = 30;
 constexpr int HTTP_CONNECT_TIMEOUT_SECONDS = 10;
+constexpr long HTTP_NOT_MODIFIED = 304;
 
 // Volume control
 constexpr int VOLUME_STEP_SIZE = 1;
@@ -71,21 +272,132 @@ constexpr int DEFAULT_MESH_X = 32;
 constexpr int DEFAULT_MESH_Y = 24;
 constexpr int DEFAULT_PRESET_DURATION = 30;
 constexpr int DEFAULT_HARD_CUT_DURATION = 60;
+constexpr int DEFAULT_PRESET_CUT_BARS = 8;                          // Bars between beat-synced preset cuts
+constexpr double BEAT_SYNC_PROJECTM_PRESET_DURATION = 24.0 * 3600;  // Parks projectM's own preset timer
 constexpr int DEFAULT_FPS_VALUE = 60;
 constexpr int DEFAULT_CHECK_INTERVAL_MS = 5000;
 
 // UI/Display
-constexpr int FRAME_DELAY_MS = 1000 / DEFAULT_FPS_VALUE;  // ~16.67ms
+constexpr int FRAME_STATS_WINDOW = 120;       // Frames per frame-timing report
+constexpr int FRAME_SPIN_MARGIN_US = 1500;    // Fixed pacing spins (instead of sleeping) this close to a deadline
+constexpr int FRAME_PROFILE_WINDOW = 600;     // Frames kept for phase percentiles and the CSV dump
+
+// Power saving
+constexpr int POWER_SAVING_MIN_FPS = 10;      // Slowest idle tick: the PCM ring holds under 200 ms of audio
+
+// Preset cost profiling
+constexpr int PRESET_COST_WARMUP_FRAMES = 180;   // Frames skipped after a switch (compile hitch, soft-cut blend)
+constexpr int PRESET_COST_MIN_FRAMES = 120;      // Measured frames needed before a preset's cost is recorded
+constexpr int PRESET_COST_MAX_FRAMES = 3600;     // Frames kept per preset visit for its percentiles
+constexpr int PRESET_SLOW_REDRAWS = 8;           // Random draws before a slow preset is accepted anyway
+constexpr int PRESET_REPORT_DEFAULT_LIMIT = 20;  // Presets listed by --preset-report
+
+// Preset scheduling
+constexpr double PRESET_LIGHT_BUDGET_SHARE = 0.25;       // Presets costing up to this share of the frame are light
+constexpr double PRESET_HEAVY_BUDGET_SHARE = 0.6;        // and above this share heavy
+constexpr double PRESET_ENERGY_LOW = 0.7;                // Beat tracker energy of a breakdown
+constexpr double PRESET_ENERGY_HIGH = 1.3;               // and of a drop
+constexpr double PRESET_ONSET_RATE_HIGH = 6.0;           // Onsets per second counted as the busiest music
+constexpr double PRESET_CENTROID_DARK_HZ = 800.0;        // Spectral centroid of filtered-down, dark music
+constexpr double PRESET_CENTROID_BRIGHT_HZ = 3000.0;     // and of bright, full-range music
+constexpr double PRESET_SECTION_HYSTERESIS = 0.08;       // Intensity past a boundary before the section changes
+constexpr double PRESET_RENDER_BUDGET_SMOOTHING = 0.05;  // Per-frame weight of the render budget average
+
+// Render scaling
+constexpr double DEFAULT_RENDER_SCALE = 1.0;       // Fraction of the drawable size projectM renders at
+constexpr double DEFAULT_MIN_RENDER_SCALE = 0.5;   // Floor for the dynamic render scale
+constexpr int RENDER_SCALE_WINDOW_FRAMES = 30;     // Frames averaged per governor decision
+constexpr int RENDER_SCALE_SETTLE_FRAMES = 15;     // Frames ignored after a change (new FBO, projectM resize)
+constexpr double RENDER_SCALE_TARGET_SHARE = 0.6;  // Share of the frame budget the render phase aims for
+constexpr double RENDER_SCALE_HIGH_SHARE = 0.8;    // Render phase above this share scales down
+constexpr double RENDER_SCALE_LOW_SHARE = 0.4;     // Render phase below this share scales up
+constexpr double RENDER_SCALE_MAX_STEP = 0.15;     // Largest scale change per decision
+constexpr double RENDER_SCALE_QUANTUM = 0.05;      // Scales snap to this step to avoid constant reallocation
+constexpr int RESIZE_SETTLE_MS = 150;              // A window size must hold this long before projectM is resized
+
+// Quality governor
+constexpr int QUALITY_WINDOW_FRAMES = 60;   // Frames averaged per quality decision
+constexpr int QUALITY_SETTLE_FRAMES = 30;   // Frames ignored after a change (mesh rebuild, new framebuffer)
+constexpr int QUALITY_UPGRADE_WINDOWS = 4;  // Calm windows in a row before quality steps back up
+constexpr double QUALITY_HIGH_SHARE = 0.9;  // Frame work above this share of the budget steps quality down
+constexpr double QUALITY_LOW_SHARE = 0.6;   // Frame work below this share may step quality up
+constexpr double QUALITY_MESH_STEP = 0.75;  // Mesh width factor per step
+constexpr double QUALITY_SCALE_STEP = 0.1;  // Render scale change per step
+constexpr int QUALITY_FPS_STEP = 10;        // Frame rate change per step
+
+// Video export
+constexpr int EXPORT_DEFAULT_WIDTH = 1280;
+constexpr int EXPORT_DEFAULT_HEIGHT = 720;
+constexpr int EXPORT_DEFAULT_FPS = 60;
+constexpr int EXPORT_DEFAULT_SECONDS = 60;   // Length when the audio is a generated signal
+constexpr int EXPORT_READBACK_BUFFERS = 3;   // Frames in flight between render and readback
+constexpr int EXPORT_PROGRESS_SECONDS = 10;  // Video time between progress lines
+
+// Render benchmark
+constexpr int BENCH_DEFAULT_FRAMES = 600;       // Measured frames per preset
+constexpr int BENCH_DEFAULT_WARMUP_FRAMES = 30;  // Rendered first and left out of the statistics
+constexpr int BENCH_GPU_TIMER_SLOTS = 8;         // Frames a GPU timing may lag behind before the loop waits
+
+// Screenshots
+constexpr int CAPTURE_READBACK_DELAY_FRAMES = 2;  // Frames a capture waits in its pixel buffer before being mapped
+constexpr int CAPTURE_MAX_IN_FLIGHT = 2;          // Captures read back at once; later requests wait a frame
+constexpr int DEFAULT_JPEG_QUALITY = 90;
+
+// Texture cache
+constexpr int TEXTURE_CACHE_MAX_WORKERS = 4;  // Transcoding threads, at most half the cores
+
+// UI/Display
 constexpr float UI_PADDING = 40.0f;
 constexpr float HELP_OVERLAY_ALPHA = 0.7f;  // Help overlay transparency (0.0 = fully transparent, 1.0 = opaque)
 constexpr int BLANK_CURSOR_SIZE = 4;
 constexpr int CURSOR_DIMENSIONS = 1;
 constexpr int CURSOR_HOTSPOT = 0;
 
+// Overlay messages
+constexpr int OVERLAY_QUEUE_CAPACITY = 8;         // Messages waiting behind the one on screen
+constexpr int OVERLAY_MESSAGE_RESERVE = 256;      // Bytes each queued message's text buffer starts with
+constexpr int OVERLAY_MIN_DISPLAY_MS = 1500;      // A queued message of the same priority waits this long
+constexpr int OVERLAY_VOLUME_DURATION_MS = 1500;  // How long a volume change stays up
+
 // Smart selection probabilities (percentages)
 constexpr int PREFERRED_GENRE_PROBABILITY = 80;  // 80% chance to prefer genre
 constexpr int FAVORITE_MIX_PROBABILITY = 70;     // 70% chance to prefer favorites
 
+// Smart selection weights
+constexpr double UNPLAYED_MIX_WEIGHT = 4.0;  // Never-played mix against a mix played once
+constexpr int RECENT_PLAY_WINDOW = 20;       // A mix recovers its full weight this many plays later
+constexpr int INDEX_SAMPLE_ATTEMPTS = 8;     // Draws that may hit the excluded mix before a scan
+
+// Play history
+constexpr int PLAY_RECENT_HOURS = 12;                  // Played this recently: all but left out of smart picks
+constexpr double RECENTLY_PLAYED_WEIGHT = 0.02;        // Its weight meanwhile, so a small library still plays
+constexpr int PLAY_RECOVERY_HOURS = 72;                // Weight grows back to full this long after a play
+constexpr double SKIP_STREAK_WEIGHT = 0.5;             // Share of the weight kept per consecutive skip
+constexpr int SKIP_STREAK_LIMIT = 3;                   // SQL picks leave out mixes skipped this often running
+constexpr double PLAY_SKIP_FRACTION = 0.5;             // A play ending before this share of the mix is a skip
+constexpr int PLAY_WEIGHT_REFRESH_MS = 5 * 60 * 1000;  // Time-based weights are recomputed at most this often
+
+// Play queue
+constexpr int DEFAULT_PLAY_QUEUE_DEPTH = 5;  // Upcoming mixes picked ahead of playback
+constexpr int PLAY_QUEUE_PICK_ATTEMPTS = 8;  // Picks that may repeat a queued mix before the queue stops growing
+
+// Playback resume
+constexpr int RESUME_SAVE_INTERVAL_MS = 5000;  // Between writes of the resume record while a mix plays
+constexpr int AUTO_PLAY_ATTEMPTS = 2;        // Queued mixes tried in turn when one fails to start
+
+// Similar-mix selection
+constexpr int DEFAULT_SIMILAR_MIX_PROBABILITY = 50;  // Percentage of smart picks that follow on from the last mix
+constexpr int SIMILAR_MIX_CANDIDATES = 8;            // Nearest mixes a follow-on pick is drawn from
+constexpr double SIMILAR_MIX_TEMPERATURE = 0.1;      // Extra distance that makes a candidate e times less likely
+
+// Library search
+constexpr int SEARCH_RESULT_LIMIT = 50;       // Ranked matches returned by default
+constexpr double SEARCH_WEIGHT_TITLE = 10.0;  // Catalog fallback scoring, in step with SEARCH_MIXES' bm25 weights
+constexpr double SEARCH_WEIGHT_ARTIST = 5.0;
+constexpr double SEARCH_WEIGHT_TAGS = 2.0;
+constexpr double SEARCH_WEIGHT_DESCRIPTION = 1.0;
+constexpr int SEARCH_REFILL_BATCH_SHARE = 5;  // Ingests of a fifth of the library refill the index at once
+
 // DatabaseColumns constants removed - now using column name-based access
 }  // namespace Constants
 
@@ -93,9 +405,22 @@ constexpr int FAVORITE_MIX_PROBABILITY = 70;     // 70% chance to prefer favorit
 namespace StringConstants {
 // File extensions
 constexpr const char* MP3_EXTENSION = ".mp3";
+constexpr const char* RESUME_STATE_EXTENSION = ".resume";  // Next to a partial download: how to continue it
 
 // Protocols
 constexpr const char* FILE_PROTOCOL = "file://";
+constexpr const char* PEER_MULTICAST_GROUP = "239.255.77.77";    // Administratively scoped, stays on the LAN
+constexpr const char* PEER_MIX_PATH = "/mixes/";                 // A node serves each shared mix at this plus its ID
+constexpr const char* PEER_ANNOUNCE_MAGIC = "AUTOVIBEZ-PEER/1";  // First word of every announcement
+constexpr const char* PEER_TELEMETRY_HOST = "lan-peers";         // Download stats host of mixes fetched from peers
+
+// Remote control and multi-node sync
+constexpr const char* REMOTE_ACTIONS_PATH = "/api/actions";             // GET lists them, POST plus "/<name>" runs one
+constexpr const char* REMOTE_NOW_PLAYING_PATH = "/api/now-playing";     // Latest now-playing event
+constexpr const char* REMOTE_EVENTS_PATH = "/api/events";               // WebSocket: events out, action names in
+constexpr const char* SYNC_MULTICAST_GROUP = "239.255.77.78";           // Administratively scoped, stays on the LAN
+constexpr const char* MIX_SYNC_MAGIC = "AUTOVIBEZ-SYNC/1";              // First line of every delta and reply
+constexpr const char* MIX_SYNC_CONTENT_TYPE = "text/x-autovibez-sync";  // Of deltas and replies alike
 
 // Error messages
 constexpr const char* UNKNOWN_ARTIST = "Unknown Artist";
@@ -139,10 +464,11 @@ constexpr const char* DATETIME_FORMAT = "%Y-%m-%d %H:%M:%S";
 constexpr const char* DATE_FORMAT = "%Y-%m-%d";
 constexpr const char* TIME_FORMAT = "%H:%M:%S";
 
-// Database SQL queries
+// Database SQL queries. Mix ids are stored as 16-byte BLOBs; statements take them as text and pack them with
+// mix_key(), which SqliteConnection registers, and MixRowMapper::readId turns them back into text.
 constexpr const char* CREATE_MIXES_TABLE = R"(
     CREATE TABLE IF NOT EXISTS mixes (
-        id TEXT PRIMARY KEY,
+        id BLOB PRIMARY KEY,
         title TEXT NOT NULL,
         artist TEXT NOT NULL,
         genre TEXT NOT NULL,
@@ -151,51 +477,458 @@ constexpr const char* CREATE_MIXES_TABLE = R"(
         duration_seconds INTEGER NOT NULL,
         tags TEXT,
         description TEXT,
-        date_added DATETIME DEFAULT CURRENT_TIMESTAMP,
-        last_played DATETIME,
+        date_added INTEGER DEFAULT (CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER)),
+        last_played INTEGER,
         play_count INTEGER DEFAULT 0,
         is_favorite BOOLEAN DEFAULT 0,
-        is_deleted BOOLEAN DEFAULT 0
+        is_deleted BOOLEAN DEFAULT 0,
+        loudness_lufs REAL,
+        peak_dbfs REAL,
+        bpm REAL,
+        seek_index TEXT,
+        spectral_centroid_hz REAL
     );
     
     CREATE INDEX IF NOT EXISTS idx_mixes_genre ON mixes(genre);
     CREATE INDEX IF NOT EXISTS idx_mixes_artist ON mixes(artist);
     CREATE INDEX IF NOT EXISTS idx_mixes_favorite ON mixes(is_favorite);
     CREATE INDEX IF NOT EXISTS idx_mixes_last_played ON mixes(last_played);
-    CREATE INDEX IF NOT EXISTS idx_mixes_deleted ON mixes(is_deleted);
 )";
+// After ALTER_ADD_IS_DELETED, which a library from before the column needs first
+constexpr const char* CREATE_MIXES_DELETED_INDEX = "CREATE INDEX IF NOT EXISTS idx_mixes_deleted ON mixes(is_deleted)";
+// Partial indexes over the rows the queries actually filter to (live, or live and downloaded), leading with the
+// equality column and then the sort column. Genre is compared NOCASE, so its indexes are too. They replace the
+// single-column indexes, of which SQLite could use only one per query and never the BINARY genre one.
+constexpr const char* CREATE_MIXES_SELECTION_INDEXES = R"(
+    DROP INDEX IF EXISTS idx_mixes_genre;
+    DROP INDEX IF EXISTS idx_mixes_artist;
+    DROP INDEX IF EXISTS idx_mixes_favorite;
+    DROP INDEX IF EXISTS idx_mixes_last_played;
+    DROP INDEX IF EXISTS idx_mixes_deleted;
+
+    CREATE INDEX IF NOT EXISTS idx_mixes_live_genre ON mixes(genre COLLATE NOCASE, title) WHERE is_deleted = 0;
+    CREATE INDEX IF NOT EXISTS idx_mixes_live_artist ON mixes(artist, title) WHERE is_deleted = 0;
+    CREATE INDEX IF NOT EXISTS idx_mixes_live_favorites ON mixes(title) WHERE is_favorite = 1 AND is_deleted = 0;
+    CREATE INDEX IF NOT EXISTS idx_mixes_recently_played ON mixes(last_played)
+        WHERE last_played IS NOT NULL AND is_deleted = 0;
+    CREATE INDEX IF NOT EXISTS idx_mixes_downloaded_title ON mixes(title)
+        WHERE is_deleted = 0 AND local_path IS NOT NULL;
+    CREATE INDEX IF NOT EXISTS idx_mixes_downloaded_genre ON mixes(genre COLLATE NOCASE, play_count)
+        WHERE is_deleted = 0 AND local_path IS NOT NULL;
+)";
+// Statistics for the planner to choose between those. The limit keeps each index's sample, and so the run, short.
+constexpr const char* OPTIMIZE_DATABASE = "PRAGMA analysis_limit = 400; PRAGMA optimize";
+// date_added and last_played were "YYYY-MM-DD HH:MM:SS" text: date_added in local time as the app wrote it,
+// last_played in UTC from CURRENT_TIMESTAMP. Both become epoch milliseconds, NULL when empty or unreadable.
+// The column affinity (DATETIME is NUMERIC) keeps the integers as integers, so the table is not rebuilt.
+constexpr const char* CONVERT_MIX_TIMESTAMPS = R"(
+    UPDATE mixes SET date_added = CAST(strftime('%s', date_added, 'utc') AS INTEGER) * 1000
+        WHERE typeof(date_added) = 'text';
+    UPDATE mixes SET last_played = CAST(strftime('%s', last_played) AS INTEGER) * 1000
+        WHERE typeof(last_played) = 'text';
+    CREATE INDEX IF NOT EXISTS idx_mixes_live_date_added ON mixes(date_added) WHERE is_deleted = 0;
+)";
+
+// One row per tag, in the order the mix lists them. The tags column keeps a JSON copy that only the search index
+// reads. INSERT OR REPLACE skips delete triggers, so writers clear a mix's tags themselves before adding them.
+constexpr const char* CREATE_MIX_TAGS_TABLE = R"(
+    CREATE TABLE IF NOT EXISTS mix_tags (
+        mix_id BLOB NOT NULL,
+        position INTEGER NOT NULL,
+        tag TEXT NOT NULL COLLATE NOCASE,
+        PRIMARY KEY (mix_id, position)
+    ) WITHOUT ROWID;
+
+    CREATE INDEX IF NOT EXISTS idx_mix_tags_tag ON mix_tags(tag);
+
+    CREATE TRIGGER IF NOT EXISTS mix_tags_delete AFTER DELETE ON mixes BEGIN
+        DELETE FROM mix_tags WHERE mix_id = old.id;
+    END;
+)";
+constexpr const char* SELECT_MIX_TAGS_EXISTS = "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'mix_tags'";
+constexpr const char* SELECT_LEGACY_MIX_TAGS = "SELECT id, tags FROM mixes WHERE tags IS NOT NULL AND tags != '[]'";
+constexpr const char* SELECT_MIX_TAGS = "SELECT tag FROM mix_tags WHERE mix_id = mix_key(?) ORDER BY position";
+constexpr const char* SELECT_ALL_MIX_TAGS = "SELECT mix_id, tag FROM mix_tags ORDER BY mix_id, position";
+constexpr const char* INSERT_MIX_TAG =
+    "INSERT OR REPLACE INTO mix_tags (mix_id, position, tag) VALUES (mix_key(?), ?, ?)";
+constexpr const char* CLEAR_MIX_TAGS = "DELETE FROM mix_tags WHERE mix_id = mix_key(?)";
+
+// Append-only play log and its per-mix aggregate, which a trigger updates as each event lands. skip_streak counts
+// skips since the mix was last played through. The covering indexes answer a mix's history and a time range
+// without reading the table.
+constexpr const char* CREATE_PLAY_HISTORY = R"(
+    CREATE TABLE IF NOT EXISTS play_events (
+        mix_id BLOB NOT NULL,
+        ts_epoch_ms INTEGER NOT NULL,
+        duration_played INTEGER NOT NULL DEFAULT 0,
+        skipped INTEGER NOT NULL DEFAULT 0
+    );
 
+    CREATE INDEX IF NOT EXISTS idx_play_events_mix ON play_events(mix_id, ts_epoch_ms, skipped, duration_played);
+    CREATE INDEX IF NOT EXISTS idx_play_events_ts ON play_events(ts_epoch_ms, mix_id, skipped);
+
+    CREATE TABLE IF NOT EXISTS mix_play_stats (
+        mix_id BLOB PRIMARY KEY,
+        plays INTEGER NOT NULL DEFAULT 0,
+        skips INTEGER NOT NULL DEFAULT 0,
+        skip_streak INTEGER NOT NULL DEFAULT 0,
+        played_seconds INTEGER NOT NULL DEFAULT 0,
+        last_played_ms INTEGER NOT NULL DEFAULT 0
+    ) WITHOUT ROWID;
+
+    CREATE INDEX IF NOT EXISTS idx_mix_play_stats_last ON mix_play_stats(last_played_ms);
+    CREATE INDEX IF NOT EXISTS idx_mix_play_stats_streak ON mix_play_stats(skip_streak) WHERE skip_streak > 0;
+
+    CREATE TRIGGER IF NOT EXISTS play_events_aggregate AFTER INSERT ON play_events BEGIN
+        INSERT INTO mix_play_stats (mix_id, plays, skips, skip_streak, played_seconds, last_played_ms)
+        VALUES (new.mix_id, 1, new.skipped != 0, new.skipped != 0, new.duration_played, new.ts_epoch_ms)
+        ON CONFLICT (mix_id) DO UPDATE SET
+            plays = plays + 1,
+            skips = skips + excluded.skips,
+            skip_streak = CASE WHEN excluded.skips > 0 THEN skip_streak + 1 ELSE 0 END,
+            played_seconds = played_seconds + excluded.played_seconds,
+            last_played_ms = max(last_played_ms, excluded.last_played_ms);
+    END;
+
+    CREATE TRIGGER IF NOT EXISTS play_history_delete AFTER DELETE ON mixes BEGIN
+        DELETE FROM play_events WHERE mix_id = old.id;
+        DELETE FROM mix_play_stats WHERE mix_id = old.id;
+    END;
+)";
+constexpr const char* SELECT_PLAY_HISTORY_EXISTS =
+    "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'mix_play_stats'";
+// A library from before the log starts its aggregate from the last play it recorded
+constexpr const char* SEED_MIX_PLAY_STATS = R"(
+    INSERT OR IGNORE INTO mix_play_stats (mix_id, plays, last_played_ms)
+    SELECT id, play_count,
+           CASE WHEN typeof(last_played) = 'text' THEN CAST(strftime('%s', last_played) AS INTEGER) * 1000
+                ELSE last_played END
+    FROM mixes WHERE last_played IS NOT NULL
+)";
+// The hash of every manifest entry as last applied, so a manifest check rewrites only the entries that changed.
+// The hashes stand for entries whether or not their mix is in the library, so no trigger ties them to mixes.
+constexpr const char* CREATE_MANIFEST_ENTRIES = R"(
+    CREATE TABLE IF NOT EXISTS manifest_entries (
+        id BLOB PRIMARY KEY,
+        hash INTEGER NOT NULL
+    ) WITHOUT ROWID;
+)";
+constexpr const char* SELECT_MANIFEST_ENTRIES = "SELECT id, hash FROM manifest_entries";
+constexpr const char* UPSERT_MANIFEST_ENTRY =
+    "INSERT OR REPLACE INTO manifest_entries (id, hash) VALUES (mix_key(?), ?)";
+constexpr const char* DELETE_MANIFEST_ENTRY = "DELETE FROM manifest_entries WHERE id = mix_key(?)";
+
+// Size of each downloaded mix file and the running total of them, which triggers keep as rows come and go. A mix
+// whose local path is cleared, or that is deleted, drops its row. The upsert updates in place, so the update
+// trigger sees the old size.
+constexpr const char* CREATE_MIX_FILES = R"(
+    CREATE TABLE IF NOT EXISTS mix_files (
+        mix_id BLOB PRIMARY KEY,
+        bytes INTEGER NOT NULL,
+        cached_ms INTEGER NOT NULL
+    ) WITHOUT ROWID;
+
+    CREATE TABLE IF NOT EXISTS mix_cache_usage (
+        id INTEGER PRIMARY KEY CHECK (id = 0),
+        total_bytes INTEGER NOT NULL,
+        file_count INTEGER NOT NULL
+    );
+    INSERT OR IGNORE INTO mix_cache_usage (id, total_bytes, file_count) VALUES (0, 0, 0);
+
+    CREATE TRIGGER IF NOT EXISTS mix_files_insert AFTER INSERT ON mix_files BEGIN
+        UPDATE mix_cache_usage SET total_bytes = total_bytes + new.bytes, file_count = file_count + 1;
+    END;
+    CREATE TRIGGER IF NOT EXISTS mix_files_update AFTER UPDATE OF bytes ON mix_files BEGIN
+        UPDATE mix_cache_usage SET total_bytes = total_bytes - old.bytes + new.bytes;
+    END;
+    CREATE TRIGGER IF NOT EXISTS mix_files_delete AFTER DELETE ON mix_files BEGIN
+        UPDATE mix_cache_usage SET total_bytes = total_bytes - old.bytes, file_count = file_count - 1;
+    END;
+
+    CREATE TRIGGER IF NOT EXISTS mix_files_unset AFTER UPDATE OF local_path ON mixes
+        WHEN new.local_path IS NULL OR new.local_path = '' BEGIN
+        DELETE FROM mix_files WHERE mix_id = new.id;
+    END;
+    CREATE TRIGGER IF NOT EXISTS mix_files_mix_delete AFTER DELETE ON mixes BEGIN
+        DELETE FROM mix_files WHERE mix_id = old.id;
+    END;
+)";
+constexpr const char* SELECT_MIX_CACHE_USAGE = "SELECT total_bytes, file_count FROM mix_cache_usage";
+constexpr const char* UPSERT_MIX_FILE = R"(
+    INSERT INTO mix_files (mix_id, bytes, cached_ms) VALUES (mix_key(?), ?, ?)
+    ON CONFLICT (mix_id) DO UPDATE SET bytes = excluded.bytes, cached_ms = excluded.cached_ms
+)";
+// A mix imported in place plays from its source file, which its URL names; the cache never counts or evicts it
+constexpr const char* SELECT_UNSIZED_MIX_FILES = R"(
+    SELECT id, local_path FROM mixes
+    WHERE local_path IS NOT NULL AND local_path != '' AND id NOT IN (SELECT mix_id FROM mix_files)
+        AND url IS NOT ('file://' || local_path)
+    LIMIT ?
+)";
+// Deleted mixes go first, then the least recently used, where each play (up to a cap) counts as a use that much
+// later than it was. Favorites are never offered.
+constexpr const char* SELECT_EVICTION_CANDIDATES = R"(
+    SELECT f.mix_id, m.local_path, f.bytes, f.cached_ms FROM mix_files f JOIN mixes m ON m.id = f.mix_id
+    WHERE m.is_favorite = 0 AND m.url IS NOT ('file://' || m.local_path)
+    ORDER BY m.is_deleted DESC,
+        MAX(f.cached_ms, COALESCE(m.last_played, 0)) + MIN(COALESCE(m.play_count, 0), ?) * ?
+    LIMIT ?
+)";
+constexpr const char* CLEAR_LOCAL_PATH = "UPDATE mixes SET local_path = NULL WHERE id = mix_key(?)";
+
+// XXH64 of each downloaded mix file, taken as it streamed in, so the same file published under another id is
+// found. The hash goes with the file, as the mix_files row does.
+constexpr const char* CREATE_MIX_HASHES = R"(
+    CREATE TABLE IF NOT EXISTS mix_hashes (
+        mix_id BLOB PRIMARY KEY,
+        content_hash TEXT NOT NULL
+    ) WITHOUT ROWID;
+    CREATE INDEX IF NOT EXISTS idx_mix_hashes_content ON mix_hashes(content_hash);
+
+    CREATE TRIGGER IF NOT EXISTS mix_hashes_unset AFTER UPDATE OF local_path ON mixes
+        WHEN new.local_path IS NULL OR new.local_path = '' BEGIN
+        DELETE FROM mix_hashes WHERE mix_id = new.id;
+    END;
+    CREATE TRIGGER IF NOT EXISTS mix_hashes_mix_delete AFTER DELETE ON mixes BEGIN
+        DELETE FROM mix_hashes WHERE mix_id = old.id;
+    END;
+)";
+constexpr const char* UPSERT_MIX_HASH =
+    "INSERT OR REPLACE INTO mix_hashes (mix_id, content_hash) VALUES (mix_key(?), ?)";
+constexpr const char* SELECT_MIX_HASH = "SELECT content_hash FROM mix_hashes WHERE mix_id = mix_key(?)";
+constexpr const char* SELECT_MIX_BY_CONTENT_HASH = R"(
+    SELECT h.mix_id FROM mix_hashes h JOIN mixes m ON m.id = h.mix_id
+    WHERE h.content_hash = ? AND h.mix_id != mix_key(?) AND m.is_deleted = 0
+        AND m.local_path IS NOT NULL AND m.local_path != ''
+    LIMIT 1
+)";
+constexpr const char* SELECT_MIX_FILE_HASHES = R"(
+    SELECT h.mix_id, h.content_hash, m.local_path FROM mix_hashes h JOIN mixes m ON m.id = h.mix_id
+    WHERE m.is_deleted = 0 AND m.local_path IS NOT NULL AND m.local_path != ''
+)";
+// Mixes whose downloads keep failing, so the wait before the next attempt outlasts a restart. Keyed by manifest id:
+// a mix that never downloaded has no mixes row.
+constexpr const char* CREATE_DOWNLOAD_FAILURES = R"(
+    CREATE TABLE IF NOT EXISTS download_failures (
+        mix_id BLOB PRIMARY KEY,
+        failures INTEGER NOT NULL,
+        retry_after_ms INTEGER NOT NULL
+    ) WITHOUT ROWID;
+)";
+constexpr const char* UPSERT_DOWNLOAD_FAILURE =
+    "INSERT OR REPLACE INTO download_failures (mix_id, failures, retry_after_ms) VALUES (mix_key(?), ?, ?)";
+constexpr const char* DELETE_DOWNLOAD_FAILURE = "DELETE FROM download_failures WHERE mix_id = mix_key(?)";
+constexpr const char* SELECT_DOWNLOAD_FAILURES = "SELECT mix_id, failures, retry_after_ms FROM download_failures";
+// What the delta sync has still to send and where it got to. A trigger stamps each favorite change as it is made;
+// one the server sent is stamped again with the server's time and marked sent. The play events already sent are
+// those up to a rowid kept in sync_state, beside the server's cursor and this node's id. A hard-deleted mix takes
+// its events along, so an event sent last may see its rowid used again and the event after it go unsent.
+constexpr const char* CREATE_SYNC_STATE = R"(
+    CREATE TABLE IF NOT EXISTS sync_state (
+        key TEXT PRIMARY KEY,
+        value
+    ) WITHOUT ROWID;
+
+    CREATE TABLE IF NOT EXISTS favorite_changes (
+        mix_id BLOB PRIMARY KEY,
+        is_favorite INTEGER NOT NULL,
+        changed_ms INTEGER NOT NULL,
+        synced INTEGER NOT NULL DEFAULT 0
+    ) WITHOUT ROWID;
+
+    CREATE INDEX IF NOT EXISTS idx_favorite_changes_unsynced ON favorite_changes(changed_ms) WHERE synced = 0;
+
+    CREATE TRIGGER IF NOT EXISTS favorite_change AFTER UPDATE OF is_favorite ON mixes
+    WHEN old.is_favorite IS NOT new.is_favorite BEGIN
+        INSERT OR REPLACE INTO favorite_changes (mix_id, is_favorite, changed_ms, synced)
+        VALUES (new.id, new.is_favorite, CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER), 0);
+    END;
+
+    CREATE TRIGGER IF NOT EXISTS favorite_changes_delete AFTER DELETE ON mixes BEGIN
+        DELETE FROM favorite_changes WHERE mix_id = old.id;
+    END;
+)";
+constexpr const char* SELECT_SYNC_STATE = "SELECT value FROM sync_state WHERE key = ?";
+constexpr const char* UPSERT_SYNC_STATE = "INSERT OR REPLACE INTO sync_state (key, value) VALUES (?, ?)";
+// The next batch of play events after the last one sent, folded per mix; every row carries the batch's last rowid
+// and size
+constexpr const char* SELECT_SYNC_PLAYS = R"(
+    WITH batch AS (
+        SELECT rowid, mix_id, ts_epoch_ms, duration_played, skipped FROM play_events
+        WHERE rowid > ?1 ORDER BY rowid LIMIT ?2
+    )
+    SELECT mix_id, count(*), sum(skipped != 0), sum(duration_played), max(ts_epoch_ms),
+           (SELECT max(rowid) FROM batch), (SELECT count(*) FROM batch)
+    FROM batch GROUP BY mix_id
+)";
+constexpr const char* SELECT_SYNC_FAVORITES =
+    "SELECT mix_id, is_favorite, changed_ms FROM favorite_changes WHERE synced = 0 ORDER BY changed_ms LIMIT ?";
+// Only a change not made again since it was sent
+constexpr const char* MARK_FAVORITE_SYNCED =
+    "UPDATE favorite_changes SET synced = 1 WHERE mix_id = mix_key(?) AND changed_ms = ?";
+constexpr const char* SELECT_FAVORITE_CHANGED = "SELECT changed_ms FROM favorite_changes WHERE mix_id = mix_key(?)";
+constexpr const char* SET_FAVORITE =
+    "UPDATE mixes SET is_favorite = ?1 WHERE id = mix_key(?2) AND is_favorite IS NOT ?1";
+constexpr const char* STAMP_REMOTE_FAVORITE = R"(
+    INSERT OR REPLACE INTO favorite_changes (mix_id, is_favorite, changed_ms, synced)
+    SELECT id, ?1, ?3, 1 FROM mixes WHERE id = mix_key(?2)
+)";
+// Play counts and last plays only grow, so the larger of the local and the fleet-wide value stands
+constexpr const char* MERGE_SYNC_TOTALS = R"(
+    UPDATE mixes SET play_count = max(coalesce(play_count, 0), ?1),
+                     last_played = NULLIF(max(coalesce(last_played, 0), ?2), 0)
+    WHERE id = mix_key(?3) AND (coalesce(play_count, 0) < ?1 OR coalesce(last_played, 0) < ?2)
+)";
+// Ids were std::hash text, which differs from one standard library to the next. Each one the old hash made is made
+// again from its URL and packed, and other UUID-form ids, as a manifest may give, are only packed; the tables that
+// refer to them may already hold them packed by mix_key(). Live mixes come first, so where a retired row shares a
+// URL with a live one it is the retired row that is dropped.
+constexpr const char* SELECT_MIX_KEYS = "SELECT id, url, local_path FROM mixes ORDER BY is_deleted";
+constexpr const char* REKEY_MIX = "UPDATE mixes SET id = mix_key(?2) WHERE id = ?1";
+constexpr const char* DELETE_REKEYED_DUPLICATE = "DELETE FROM mixes WHERE id = ?1";
+constexpr const char* REKEY_MIX_REFERENCES[] = {
+    "UPDATE mix_tags SET mix_id = mix_key(?2) WHERE mix_id IN (?1, mix_key(?1))",
+    "UPDATE play_events SET mix_id = mix_key(?2) WHERE mix_id IN (?1, mix_key(?1))",
+    "UPDATE mix_play_stats SET mix_id = mix_key(?2) WHERE mix_id IN (?1, mix_key(?1))",
+    "UPDATE mix_files SET mix_id = mix_key(?2) WHERE mix_id IN (?1, mix_key(?1))",
+    "UPDATE mix_hashes SET mix_id = mix_key(?2) WHERE mix_id IN (?1, mix_key(?1))",
+};
+// Keyed by manifest ids, which may have no mixes row to re-key them by. As for a library from before the tables,
+// each manifest entry counts as added once and each failing download is tried again without waiting.
+constexpr const char* CLEAR_MANIFEST_KEYED_TABLES = "DELETE FROM manifest_entries; DELETE FROM download_failures;";
+constexpr const char* SELECT_LOCAL_PATH_SHARED =
+    "SELECT 1 FROM mixes WHERE local_path = ? AND id != mix_key(?) LIMIT 1";
+constexpr const char* INSERT_PLAY_EVENT =
+    "INSERT INTO play_events (mix_id, ts_epoch_ms, duration_played, skipped) VALUES (mix_key(?), ?, ?, ?)";
+constexpr const char* SELECT_MIX_PLAY_STATS =
+    "SELECT mix_id, plays, skips, skip_streak, played_seconds, last_played_ms FROM mix_play_stats "
+    "WHERE mix_id = mix_key(?)";
+constexpr const char* SELECT_ALL_MIX_PLAY_STATS =
+    "SELECT mix_id, plays, skips, skip_streak, played_seconds, last_played_ms FROM mix_play_stats";
+constexpr const char* SELECT_PLAY_EVENTS_SINCE =
+    "SELECT mix_id, ts_epoch_ms, duration_played, skipped FROM play_events WHERE ts_epoch_ms >= ? ORDER BY ts_epoch_ms";
+
+constexpr const char* SELECT_USER_VERSION = "PRAGMA user_version";
+constexpr const char* SELECT_MIXES_COLUMN_EXISTS = "SELECT 1 FROM pragma_table_info('mixes') WHERE name = ?";
 constexpr const char* ALTER_ADD_IS_DELETED = "ALTER TABLE mixes ADD COLUMN is_deleted BOOLEAN DEFAULT 0;";
+constexpr const char* ALTER_ADD_LOUDNESS_LUFS = "ALTER TABLE mixes ADD COLUMN loudness_lufs REAL;";
+constexpr const char* ALTER_ADD_PEAK_DBFS = "ALTER TABLE mixes ADD COLUMN peak_dbfs REAL;";
+constexpr const char* ALTER_ADD_BPM = "ALTER TABLE mixes ADD COLUMN bpm REAL;";
+constexpr const char* ALTER_ADD_SPECTRAL_CENTROID = "ALTER TABLE mixes ADD COLUMN spectral_centroid_hz REAL;";
+constexpr const char* ALTER_ADD_SEEK_INDEX = "ALTER TABLE mixes ADD COLUMN seek_index TEXT;";
 
 constexpr const char* INSERT_OR_REPLACE_MIX = R"(
     INSERT OR REPLACE INTO mixes 
     (id, title, artist, genre, url, local_path, duration_seconds, tags, description, date_added, last_played, play_count, is_favorite, is_deleted)
-    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    VALUES (mix_key(?), ?, ?, ?, ?, ?, ?, ?, ?, NULLIF(?, 0), NULLIF(?, 0), ?, ?, ?)
 )";
 
 constexpr const char* UPDATE_MIX = R"(
     UPDATE mixes SET title = ?, artist = ?, genre = ?, url = ?, local_path = ?, duration_seconds = ?, tags = ?, 
-    description = ?, date_added = ?, last_played = ?, play_count = ?, is_favorite = ?, is_deleted = ? WHERE id = ?
+    description = ?, date_added = NULLIF(?, 0), last_played = NULLIF(?, 0), play_count = ?, is_favorite = ?,
+    is_deleted = ? WHERE id = mix_key(?)
 )";
 
-constexpr const char* SELECT_MIX_BY_ID = "SELECT * FROM mixes WHERE id = ?";
+constexpr const char* SELECT_MIX_BY_ID = "SELECT * FROM mixes WHERE id = mix_key(?)";
 constexpr const char* SELECT_ALL_MIXES = "SELECT * FROM mixes WHERE is_deleted = 0 ORDER BY title";
 constexpr const char* SELECT_MIXES_BY_GENRE =
     "SELECT * FROM mixes WHERE genre COLLATE NOCASE = ? COLLATE NOCASE AND is_deleted = 0 ORDER BY title";
 constexpr const char* SELECT_MIXES_BY_ARTIST = "SELECT * FROM mixes WHERE artist = ? AND is_deleted = 0 ORDER BY title";
 constexpr const char* SELECT_DOWNLOADED_MIXES =
     "SELECT * FROM mixes WHERE local_path IS NOT NULL AND local_path != '' AND is_deleted = 0 ORDER BY title";
+constexpr const char* SELECT_UNANALYZED_MIXES =
+    "SELECT * FROM mixes WHERE local_path IS NOT NULL AND local_path != '' "
+    "AND (loudness_lufs IS NULL OR seek_index IS NULL OR spectral_centroid_hz IS NULL) AND is_deleted = 0";
 constexpr const char* SELECT_FAVORITE_MIXES =
     "SELECT * FROM mixes WHERE is_favorite = 1 AND is_deleted = 0 ORDER BY title";
+// A range over idx_mixes_recently_played; a bound of 0 takes every played mix
 constexpr const char* SELECT_RECENTLY_PLAYED =
-    "SELECT * FROM mixes WHERE last_played IS NOT NULL AND is_deleted = 0 ORDER BY last_played DESC LIMIT ?";
+    "SELECT * FROM mixes WHERE last_played >= ? AND is_deleted = 0 ORDER BY last_played DESC LIMIT ?";
+
+// Full-text index of the searchable columns, keyed by the mixes rowid, with prefix indexes for the short words
+// typed first. INSERT OR REPLACE deletes the old row without firing delete triggers, so the BEFORE INSERT trigger
+// drops its entry first.
+constexpr const char* CREATE_MIXES_FTS = R"(
+    CREATE VIRTUAL TABLE IF NOT EXISTS mixes_fts USING fts5(
+        title, artist, description, tags, tokenize = 'unicode61 remove_diacritics 2', prefix = '2 3'
+    );
 
-constexpr const char* DELETE_MIX = "DELETE FROM mixes WHERE id = ?";
-constexpr const char* SOFT_DELETE_MIX = "UPDATE mixes SET is_deleted = 1 WHERE id = ?";
-constexpr const char* TOGGLE_FAVORITE = "UPDATE mixes SET is_favorite = NOT is_favorite WHERE id = ?";
+    CREATE TRIGGER IF NOT EXISTS mixes_fts_replace BEFORE INSERT ON mixes BEGIN
+        DELETE FROM mixes_fts WHERE rowid = (SELECT rowid FROM mixes WHERE id = new.id);
+    END;
+    CREATE TRIGGER IF NOT EXISTS mixes_fts_insert AFTER INSERT ON mixes BEGIN
+        INSERT INTO mixes_fts (rowid, title, artist, description, tags)
+        VALUES (new.rowid, new.title, new.artist, new.description, new.tags);
+    END;
+    CREATE TRIGGER IF NOT EXISTS mixes_fts_delete AFTER DELETE ON mixes BEGIN
+        DELETE FROM mixes_fts WHERE rowid = old.rowid;
+    END;
+    CREATE TRIGGER IF NOT EXISTS mixes_fts_update AFTER UPDATE OF title, artist, description, tags ON mixes BEGIN
+        DELETE FROM mixes_fts WHERE rowid = old.rowid;
+        INSERT INTO mixes_fts (rowid, title, artist, description, tags)
+        VALUES (new.rowid, new.title, new.artist, new.description, new.tags);
+    END;
+)";
+// Without the insert trigger the index has missed writes (or never existed) and is refilled
+constexpr const char* SELECT_MIXES_FTS_SYNCED =
+    "SELECT 1 FROM sqlite_master WHERE type = 'trigger' AND name = 'mixes_fts_insert'";
+constexpr const char* FILL_MIXES_FTS = R"(
+    DELETE FROM mixes_fts;
+    INSERT INTO mixes_fts (rowid, title, artist, description, tags)
+    SELECT rowid, title, artist, description, tags FROM mixes;
+)";
+// An SQLite without FTS5 would fail every write to mixes on these
+constexpr const char* DROP_MIXES_FTS_TRIGGERS = R"(
+    DROP TRIGGER IF EXISTS mixes_fts_replace;
+    DROP TRIGGER IF EXISTS mixes_fts_insert;
+    DROP TRIGGER IF EXISTS mixes_fts_delete;
+    DROP TRIGGER IF EXISTS mixes_fts_update;
+)";
+// bm25 weights follow the column order: title, artist, description, tags
+constexpr const char* SEARCH_MIXES = R"(
+    SELECT mixes.id FROM mixes_fts JOIN mixes ON mixes.rowid = mixes_fts.rowid
+    WHERE mixes_fts MATCH ? AND mixes.is_deleted = 0
+    ORDER BY bm25(mixes_fts, 10.0, 5.0, 1.0, 2.0) LIMIT ?
+)";
+
+constexpr const char* DELETE_MIX = "DELETE FROM mixes WHERE id = mix_key(?)";
+constexpr const char* SOFT_DELETE_MIX = "UPDATE mixes SET is_deleted = 1 WHERE id = mix_key(?)";
+constexpr const char* TOGGLE_FAVORITE = "UPDATE mixes SET is_favorite = NOT is_favorite WHERE id = mix_key(?)";
 constexpr const char* UPDATE_PLAY_STATS =
-    "UPDATE mixes SET play_count = play_count + 1, last_played = CURRENT_TIMESTAMP WHERE id = ?";
-constexpr const char* SET_LOCAL_PATH = "UPDATE mixes SET local_path = ? WHERE id = ?";
+    "UPDATE mixes SET play_count = play_count + 1, "
+    "last_played = CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER) WHERE id = mix_key(?)";
+constexpr const char* ADD_PLAY_STATS =
+    "UPDATE mixes SET play_count = play_count + ?, "
+    "last_played = CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER) WHERE id = mix_key(?)";
+constexpr const char* SET_LOCAL_PATH = "UPDATE mixes SET local_path = ? WHERE id = mix_key(?)";
+constexpr const char* SET_MIX_ANALYSIS =
+    "UPDATE mixes SET loudness_lufs = ?, peak_dbfs = ?, bpm = ?, spectral_centroid_hz = ? WHERE id = mix_key(?)";
+constexpr const char* SET_SEEK_INDEX = "UPDATE mixes SET seek_index = ? WHERE id = mix_key(?)";
+constexpr const char* SELECT_SEEK_INDEX = "SELECT seek_index FROM mixes WHERE id = mix_key(?)";
+
+constexpr const char* CREATE_PRESET_COSTS_TABLE = R"(
+    CREATE TABLE IF NOT EXISTS preset_costs (
+        path TEXT NOT NULL,
+        renderer TEXT NOT NULL,
+        frames INTEGER NOT NULL,
+        cpu_ms REAL NOT NULL,
+        gpu_ms REAL NOT NULL,
+        cpu_p95_ms REAL NOT NULL,
+        gpu_p95_ms REAL NOT NULL,
+        measured_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        PRIMARY KEY (path, renderer)
+    );
+)";
+
+constexpr const char* INSERT_OR_REPLACE_PRESET_COST = R"(
+    INSERT OR REPLACE INTO preset_costs (path, renderer, frames, cpu_ms, gpu_ms, cpu_p95_ms, gpu_p95_ms, measured_at)
+    VALUES (?, ?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP)
+)";
+
+constexpr const char* SELECT_PRESET_COST = "SELECT * FROM preset_costs WHERE path = ? AND renderer = ?";
+constexpr const char* SELECT_PRESET_COSTS_FOR_RENDERER = "SELECT * FROM preset_costs WHERE renderer = ?";
+constexpr const char* SELECT_MOST_EXPENSIVE_PRESETS =
+    "SELECT * FROM preset_costs ORDER BY MAX(cpu_p95_ms, gpu_p95_ms) DESC LIMIT ?";
 
 // Regex patterns
 constexpr const char* URL_REGEX_PATTERN = R"((https?|ftp)://[^\s/$.?#].[^\s]*)";
@@ -0,0 +1,155 @@
+#include "content_hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian whatever the host, so a digest means the same on every machine
+uint64_t read64(const unsigned char* data) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+uint32_t read32(const unsigned char* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t accumulate(uint64_t lane, uint64_t input) {
+    lane += input * PRIME2;
+    return rotateLeft(lane, 31) * PRIME1;
+}
+
+uint64_t mergeRound(uint64_t hash, uint64_t lane) {
+    hash ^= accumulate(0, lane);
+    return hash * PRIME1 + PRIME4;
+}
+}  // namespace
+
+ContentHasher::ContentHasher(uint64_t seed) : _seed(seed) {
+    _lanes[0] = seed + PRIME1 + PRIME2;
+    _lanes[1] = seed + PRIME2;
+    _lanes[2] = seed;
+    _lanes[3] = seed - PRIME1;
+}
+
+void ContentHasher::consumeStripe(const unsigned char* stripe) {
+    for (int i = 0; i < 4; ++i) {
+        _lanes[i] = accumulate(_lanes[i], read64(stripe + i * 8));
+    }
+}
+
+void ContentHasher::update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    _length += size;
+
+    if (_buffered > 0) {
+        const size_t fill = std::min(size, sizeof(_buffer) - _buffered);
+        std::memcpy(_buffer + _buffered, bytes, fill);
+        _buffered += fill;
+        bytes += fill;
+        size -= fill;
+        if (_buffered < sizeof(_buffer)) {
+            return;
+        }
+        consumeStripe(_buffer);
+        _buffered = 0;
+    }
+    for (; size >= sizeof(_buffer); bytes += sizeof(_buffer), size -= sizeof(_buffer)) {
+        consumeStripe(bytes);
+    }
+    std::memcpy(_buffer, bytes, size);
+    _buffered = size;
+}
+
+uint64_t ContentHasher::digest() const {
+    uint64_t hash;
+    if (_length >= sizeof(_buffer)) {
+        hash = rotateLeft(_lanes[0], 1) + rotateLeft(_lanes[1], 7) + rotateLeft(_lanes[2], 12) +
+               rotateLeft(_lanes[3], 18);
+        for (uint64_t lane : _lanes) {
+            hash = mergeRound(hash, lane);
+        }
+    } else {
+        hash = _seed + PRIME5;
+    }
+    hash += _length;
+
+    const unsigned char* tail = _buffer;
+    size_t left = _buffered;
+    for (; left >= 8; tail += 8, left -= 8) {
+        hash ^= accumulate(0, read64(tail));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (left >= 4) {
+        hash ^= static_cast<uint64_t>(read32(tail)) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        tail += 4;
+        left -= 4;
+    }
+    for (; left > 0; ++tail, --left) {
+        hash ^= *tail * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string ContentHasher::hexDigest() const {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    uint64_t value = digest();
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i, value >>= 4) {
+        hex[static_cast<size_t>(i)] = DIGITS[value & 0x0F];
+    }
+    return hex;
+}
+
+uint64_t ContentHasher::hash(const void* data, size_t size, uint64_t seed) {
+    ContentHasher hasher(seed);
+    hasher.update(data, size);
+    return hasher.digest();
+}
+
+std::string ContentHasher::hashFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return "";
+    }
+    ContentHasher hasher;
+    std::vector<char> chunk(Constants::CONTENT_HASH_READ_BYTES);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hasher.update(chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+    if (file.bad()) {
+        return "";
+    }
+    return hasher.hexDigest();
+}
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Streaming XXH64 of a file's bytes, fed in file order as they arrive
+ *
+ * Fast enough to run inside a transfer's write callback without slowing it, and the
+ * same digest whether the bytes come in one piece or many. Not cryptographic: it
+ * tells identical files apart from different ones, not from forged ones.
+ */
+class ContentHasher {
+public:
+    explicit ContentHasher(uint64_t seed = 0);
+
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Digest of everything fed so far; more can still be fed after
+     */
+    uint64_t digest() const;
+
+    /**
+     * @brief The digest as 16 lowercase hex digits, the form the database stores
+     */
+    std::string hexDigest() const;
+
+    uint64_t getLength() const {
+        return _length;
+    }
+
+    /**
+     * @brief Digest of one buffer
+     */
+    static uint64_t hash(const void* data, size_t size, uint64_t seed = 0);
+
+    /**
+     * @brief Hex digest of a file on disk, read CONTENT_HASH_READ_BYTES at a time
+     * @return Empty if the file can't be read
+     */
+    static std::string hashFile(const std::string& path);
+
+private:
+    void consumeStripe(const unsigned char* stripe);
+
+    uint64_t _seed;
+    uint64_t _lanes[4];
+    unsigned char _buffer[32];  // A stripe not yet filled
+    size_t _buffered = 0;
+    uint64_t _length = 0;
+};
+
+}  // namespace AutoVibez::Utils
@@ -25,6 +25,18 @@ std::string DateTimeUtils::formatDateTime(const std::chrono::system_clock::time_
     return ss.str();
 }
 
+int64_t DateTimeUtils::nowEpochMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string DateTimeUtils::formatEpochMs(int64_t epoch_ms) {
+    if (epoch_ms == 0) {
+        return "";
+    }
+    return formatDateTime(std::chrono::system_clock::time_point(std::chrono::milliseconds(epoch_ms)));
+}
+
 std::string DateTimeUtils::getCurrentDate() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
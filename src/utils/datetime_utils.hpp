@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace AutoVibez::Utils {
@@ -23,6 +24,19 @@ public:
      */
     static std::string formatDateTime(const std::chrono::system_clock::time_point& time);
 
+    /**
+     * @brief Current time as stored in the database
+     * @return Milliseconds since the Unix epoch
+     */
+    static int64_t nowEpochMs();
+
+    /**
+     * @brief Format a stored timestamp for display, in local time
+     * @param epoch_ms Milliseconds since the Unix epoch
+     * @return "YYYY-MM-DD HH:MM:SS", or empty for 0 (never set)
+     */
+    static std::string formatEpochMs(int64_t epoch_ms);
+
     /**
      * @brief Get current date as formatted string
      * @return Current date in "YYYY-MM-DD" format
@@ -0,0 +1,77 @@
+#include "directory_watcher.hpp"
+
+#include <filesystem>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Utils {
+
+#if defined(__linux__)
+
+DirectoryWatcher::DirectoryWatcher(const std::string& directory) : _directory(directory) {
+    _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_fd < 0) {
+        return;
+    }
+    if (inotify_add_watch(_fd, directory.c_str(), IN_DELETE | IN_MOVED_FROM | IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+bool DirectoryWatcher::poll(std::vector<DirectoryEvent>& events) {
+    if (_fd < 0) {
+        return true;
+    }
+    bool complete = true;
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN once the queue is drained
+            break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            if (event->mask & IN_Q_OVERFLOW) {
+                complete = false;
+                continue;
+            }
+            if (event->len == 0 || (event->mask & IN_ISDIR)) {
+                continue;
+            }
+            DirectoryEvent change;
+            change.type = (event->mask & (IN_DELETE | IN_MOVED_FROM)) ? DirectoryEvent::Type::Removed
+                                                                        : DirectoryEvent::Type::Written;
+            change.path = (std::filesystem::path(_directory) / event->name).string();
+            events.push_back(std::move(change));
+        }
+    }
+    return complete;
+}
+
+#else
+
+// No watch: isWatching() is false and the caller's scans find the changes
+DirectoryWatcher::DirectoryWatcher(const std::string& directory) : _directory(directory) {}
+
+DirectoryWatcher::~DirectoryWatcher() = default;
+
+bool DirectoryWatcher::poll(std::vector<DirectoryEvent>& events) {
+    (void)events;
+    return true;
+}
+
+#endif
+
+}  // namespace AutoVibez::Utils
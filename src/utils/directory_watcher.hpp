@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief A change to a file directly inside a watched directory
+ */
+struct DirectoryEvent {
+    enum class Type { Removed, Written };
+
+    Type type = Type::Removed;
+    std::string path;  // Directory joined with the file name
+};
+
+/**
+ * @brief Reports files deleted from or written into one directory, without scanning it
+ *
+ * On Linux this is an inotify watch for deletions, renames away, closes after writing
+ * and renames in; poll() reads what the kernel queued and never blocks. Elsewhere, or
+ * if the watch can't be set up, isWatching() is false and callers fall back to scanning.
+ * Not thread-safe; poll from one thread.
+ */
+class DirectoryWatcher {
+public:
+    explicit DirectoryWatcher(const std::string& directory);
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    bool isWatching() const {
+        return _fd >= 0;
+    }
+
+    /**
+     * @brief Append the events queued since the last call
+     * @return False if the kernel's queue overflowed and events were lost, so the directory should be rescanned
+     */
+    bool poll(std::vector<DirectoryEvent>& events);
+
+private:
+    std::string _directory;
+    int _fd = -1;
+};
+
+}  // namespace AutoVibez::Utils
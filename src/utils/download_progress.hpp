@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Byte counters for a file that is still being written by a download
+ *
+ * The downloader publishes bytes only after they are flushed to disk, so a reader
+ * may read up to bytes_written from the partial file at any time. The rate and
+ * retries are telemetry, stored by the transfer thread for the overlay and stats.
+ */
+struct DownloadProgress {
+    std::atomic<int64_t> bytes_written{0};
+    std::atomic<int64_t> total_bytes{-1};  //!< Content length, -1 until the server reports it
+    std::atomic<bool> complete{false};     //!< No more bytes will arrive (success or failure)
+    std::atomic<bool> failed{false};
+    std::atomic<bool> cancelled{false};   //!< Set by the owner to abort the transfer
+    std::atomic<bool> full_speed{false};  //!< Set by the owner to lift the bandwidth ceiling, e.g. for the next mix
+
+    // Telemetry
+    std::atomic<int64_t> bytes_per_second{0};  //!< Smoothed receive rate, 0 until measured
+    std::atomic<int> retries{0};               //!< Times the transfer resumed a partial file or started over
+
+    int64_t getBytesWritten() const {
+        return bytes_written.load(std::memory_order_acquire);
+    }
+    bool isComplete() const {
+        return complete.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Seconds until the last byte at the current rate; -1 while the length or the rate is unknown
+     */
+    int64_t getEtaSeconds() const {
+        const int64_t total = total_bytes.load(std::memory_order_relaxed);
+        const int64_t rate = bytes_per_second.load(std::memory_order_relaxed);
+        if (total <= 0 || rate <= 0) {
+            return -1;
+        }
+        const int64_t left = total - getBytesWritten();
+        return left > 0 ? (left + rate - 1) / rate : 0;
+    }
+};
+
+}  // namespace AutoVibez::Utils
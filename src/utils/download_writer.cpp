@@ -0,0 +1,114 @@
+#include "download_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "constants.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Utils {
+
+DownloadWriter::DownloadWriter(FILE* file, int64_t offset) : _file(file), _flushed(offset), _dropped(offset) {
+    // Whole buffers go straight to the file; a second copy through stdio's buffer would only add cost
+    std::setvbuf(_file, nullptr, _IONBF, 0);
+}
+
+void DownloadWriter::reserve(int64_t total_bytes) {
+    if (total_bytes > _flushed) {
+        reserveBlocks(_file, _flushed, total_bytes - _flushed);
+    }
+}
+
+bool DownloadWriter::write(const char* data, size_t size, size_t flush_bytes) {
+    flush_bytes = std::min<size_t>(flush_bytes, Constants::DOWNLOAD_WRITE_BUFFER_BYTES);
+    if (_buffered + size > static_cast<size_t>(Constants::DOWNLOAD_WRITE_BUFFER_BYTES) && !flush()) {
+        return false;
+    }
+    if (_buffered == 0 && size >= flush_bytes) {
+        // Nothing to join it with, and enough on its own
+        return writeOut(data, size);
+    }
+
+    if (_buffer.empty()) {
+        _buffer.resize(Constants::DOWNLOAD_WRITE_BUFFER_BYTES);
+    }
+    std::memcpy(_buffer.data() + _buffered, data, size);
+    _buffered += size;
+    return _buffered < flush_bytes || flush();
+}
+
+bool DownloadWriter::flush() {
+    if (_buffered == 0) {
+        return true;
+    }
+    const size_t size = _buffered;
+    _buffered = 0;
+    return writeOut(_buffer.data(), size);
+}
+
+bool DownloadWriter::writeOut(const char* data, size_t size) {
+    if (fwrite(data, 1, size, _file) != size) {
+        return false;
+    }
+    _flushed += static_cast<int64_t>(size);
+
+    // The last buffer's writeback has had a buffer's time to finish; its pages are clean to drop now,
+    // and this call starts writeback of the new ones
+    if (_drop_cache && _flushed - _dropped >= Constants::DOWNLOAD_WRITE_BUFFER_BYTES) {
+        dropCachedPages(_file, _dropped, _flushed);
+        _dropped = std::max(_dropped, _flushed - static_cast<int64_t>(Constants::DOWNLOAD_WRITE_BUFFER_BYTES));
+    }
+    return true;
+}
+
+bool DownloadWriter::reserveBlocks(FILE* file, int64_t offset, int64_t length) {
+    if (length <= 0) {
+        return true;
+    }
+#if defined(_WIN32)
+    // The allocation size is separate from the end of file on NTFS, so this leaves the size alone
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    FILE_ALLOCATION_INFO allocation;
+    allocation.AllocationSize.QuadPart = offset + length;
+    return handle != INVALID_HANDLE_VALUE &&
+           SetFileInformationByHandle(handle, FileAllocationInfo, &allocation, sizeof(allocation)) != FALSE;
+#elif defined(__linux__)
+    return fallocate(fileno(file), FALLOC_FL_KEEP_SIZE, offset, length) == 0;
+#elif defined(__APPLE__)
+    // Allocates from the physical end of the file, which a download only ever appends to
+    (void)offset;
+    fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, length, 0};
+    if (fcntl(fileno(file), F_PREALLOCATE, &store) == -1) {
+        // No contiguous run that long; any blocks still beat growing the file a write at a time
+        store.fst_flags = F_ALLOCATEALL;
+        return fcntl(fileno(file), F_PREALLOCATE, &store) != -1;
+    }
+    return true;
+#else
+    (void)file;
+    (void)offset;
+    return false;
+#endif
+}
+
+void DownloadWriter::dropCachedPages(FILE* file, int64_t from, int64_t to) {
+#if defined(__linux__)
+    // DONTNEED starts writeback of dirty pages and drops the clean ones; a later call drops the rest
+    if (to > from) {
+        posix_fadvise(fileno(file), from, to - from, POSIX_FADV_DONTNEED);
+    }
+#else
+    (void)file;
+    (void)from;
+    (void)to;
+#endif
+}
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Buffered writes to a file that grows as a download comes in
+ *
+ * Transfer chunks, often 16 KB, collect in one DOWNLOAD_WRITE_BUFFER_BYTES buffer and
+ * reach the file a buffer at a time, each in one write with the FILE's own buffering
+ * off. reserve() preallocates the rest of the file's blocks up front without changing
+ * its size, so a file written over minutes lands in few extents on flash, and a
+ * partial file's size still says how much of it arrived. With setDropCache the pages
+ * written are dropped from the page cache one buffer behind, once their writeback has
+ * started, so a background download doesn't push the playing mix out of memory.
+ *
+ * The FILE stays the caller's; flush before it closes. Not thread-safe.
+ */
+class DownloadWriter {
+public:
+    /**
+     * @param file Opened for writing at its end, before any I/O on it
+     * @param offset Bytes the file already holds
+     */
+    DownloadWriter(FILE* file, int64_t offset);
+
+    /**
+     * @brief Reserve blocks for the file up to total_bytes; a best-effort hint
+     */
+    void reserve(int64_t total_bytes);
+
+    /**
+     * @brief Drop flushed pages from the page cache from now on, or keep them for a reader
+     */
+    void setDropCache(bool drop) {
+        _drop_cache = drop;
+    }
+
+    /**
+     * @brief Buffer data, writing the buffer out once it holds flush_bytes or more
+     * @param flush_bytes 0 writes every chunk through; capped at DOWNLOAD_WRITE_BUFFER_BYTES
+     * @return False if a write to the file failed
+     */
+    bool write(const char* data, size_t size, size_t flush_bytes);
+
+    /**
+     * @brief Write out what is buffered
+     * @return False if the write failed
+     */
+    bool flush();
+
+    /**
+     * @brief Bytes the file holds, buffered ones not counted
+     */
+    int64_t getFlushedBytes() const {
+        return _flushed;
+    }
+
+    /**
+     * @brief Reserve blocks for length bytes from offset without changing the file size; best effort
+     * @return False where the platform or file system can't
+     */
+    static bool reserveBlocks(FILE* file, int64_t offset, int64_t length);
+
+    /**
+     * @brief Start writeback of a range and drop its clean pages from the page cache; a no-op where unsupported
+     */
+    static void dropCachedPages(FILE* file, int64_t from, int64_t to);
+
+private:
+    bool writeOut(const char* data, size_t size);
+
+    FILE* _file;
+    std::vector<char, TaggedAllocator<char, MemoryTag::DownloadBuffers>> _buffer;
+    size_t _buffered = 0;
+    int64_t _flushed;
+    int64_t _dropped;  // Pages before this were already dropped
+    bool _drop_cache = false;
+};
+
+}  // namespace AutoVibez::Utils
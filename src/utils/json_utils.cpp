@@ -1,154 +1,247 @@
 #include "json_utils.hpp"
 
-#include <sstream>
+#include <cstdint>
+#include <cstring>
 
 namespace AutoVibez::Utils {
 
-std::string JsonUtils::vectorToJsonArray(const std::vector<std::string>& tags) {
-    if (tags.empty()) {
-        return "[]";
+namespace {
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Bytes a character takes once escaped: the short escapes, \u00XX for other control characters
+size_t escapedSize(unsigned char c) {
+    switch (c) {
+        case '"':
+        case '\\':
+        case '\b':
+        case '\f':
+        case '\n':
+        case '\r':
+        case '\t':
+            return 2;
+        default:
+            return c < 0x20 ? 6 : 1;
     }
+}
 
-    std::ostringstream oss;
-    oss << "[";
-
-    for (size_t i = 0; i < tags.size(); ++i) {
-        if (i > 0) {
-            oss << ",";
+// Four hex digits at text, or -1
+int32_t readHex4(const char* text) {
+    int32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const char c = text[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            return -1;
         }
-        oss << "\"" << escapeJsonString(tags[i]) << "\"";
     }
-
-    oss << "]";
-    return oss.str();
+    return value;
 }
 
-std::vector<std::string> JsonUtils::jsonArrayToVector(const std::string& json_array) {
-    std::vector<std::string> result;
+void appendUtf8(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+}  // namespace
 
-    if (json_array.empty() || json_array == "[]") {
-        return result;
+std::string JsonUtils::vectorToJsonArray(const std::vector<std::string>& tags) {
+    // Sized exactly first, so the result is a single allocation
+    size_t length = tags.empty() ? 2 : tags.size() + 1;  // Brackets and commas
+    for (const std::string& tag : tags) {
+        length += escapedLength(tag) + 2;
     }
 
-    // Simple parser for JSON array format: ["tag1","tag2","tag3"]
-    std::string current_tag;
-    bool in_string = false;
-    bool escaped = false;
+    std::string json(length, '\0');
+    char* out = json.data();
+    *out++ = '[';
+    for (size_t i = 0; i < tags.size(); ++i) {
+        if (i > 0) {
+            *out++ = ',';
+        }
+        *out++ = '"';
+        out = writeEscaped(tags[i], out);
+        *out++ = '"';
+    }
+    *out = ']';
+    return json;
+}
 
-    for (size_t i = 0; i < json_array.length(); ++i) {
-        char c = json_array[i];
+std::vector<std::string> JsonUtils::jsonArrayToVector(std::string_view json_array) {
+    std::vector<std::string_view> views;
+    std::string arena;
+    parseJsonArray(json_array, views, arena);
+    return std::vector<std::string>(views.begin(), views.end());
+}
 
-        if (escaped) {
-            current_tag += c;
-            escaped = false;
-            continue;
+void JsonUtils::parseJsonArray(std::string_view json_array, std::vector<std::string_view>& tags, std::string& arena) {
+    tags.clear();
+    arena.clear();
+    const char* position = json_array.data();
+    const char* const end = position + json_array.size();
+
+    // Brackets, commas and whitespace between strings are skipped by looking for the next quote
+    while (position < end) {
+        const auto* open = static_cast<const char*>(std::memchr(position, '"', static_cast<size_t>(end - position)));
+        if (!open) {
+            break;
         }
-
-        if (c == '\\' && in_string) {
-            escaped = true;
+        const char* const begin = open + 1;
+        const auto* close = static_cast<const char*>(std::memchr(begin, '"', static_cast<size_t>(end - begin)));
+        const char* const limit = close ? close : end;
+        const auto* escape = static_cast<const char*>(std::memchr(begin, '\\', static_cast<size_t>(limit - begin)));
+        if (!escape) {
+            if (!close) {
+                break;  // Unterminated
+            }
+            tags.emplace_back(begin, static_cast<size_t>(close - begin));
+            position = close + 1;
             continue;
         }
 
-        if (c == '"') {
-            if (in_string) {
-                // End of string
-                result.push_back(unescapeJsonString(current_tag));
-                current_tag.clear();
-                in_string = false;
-            } else {
-                // Start of string
-                in_string = true;
-            }
-        } else if (in_string) {
-            current_tag += c;
+        // An escaped quote is not the end, so walk on from the first backslash
+        const char* scan = escape;
+        while (scan < end && *scan != '"') {
+            scan += *scan == '\\' && scan + 1 < end ? 2 : 1;
         }
-        // Ignore other characters (brackets, commas, spaces) when not in string
+        if (scan >= end) {
+            break;  // Unterminated
+        }
+        if (arena.capacity() < json_array.size()) {
+            // Unescaping never lengthens, so the arena never moves and earlier views stay valid
+            arena.reserve(json_array.size());
+        }
+        const size_t start = arena.size();
+        appendUnescaped(std::string_view(begin, static_cast<size_t>(scan - begin)), arena);
+        tags.emplace_back(arena.data() + start, arena.size() - start);
+        position = scan + 1;
     }
+}
 
+std::string JsonUtils::escapeJsonString(const std::string& str) {
+    std::string result(escapedLength(str), '\0');
+    writeEscaped(str, result.data());
     return result;
 }
 
-std::string JsonUtils::escapeJsonString(const std::string& str) {
-    std::string result;
-    result.reserve(str.length() * 2);  // Reserve space for potential escapes
+size_t JsonUtils::escapedLength(std::string_view str) {
+    size_t length = 0;
+    for (char c : str) {
+        length += escapedSize(static_cast<unsigned char>(c));
+    }
+    return length;
+}
 
+char* JsonUtils::writeEscaped(std::string_view str, char* out) {
     for (char c : str) {
         switch (c) {
             case '"':
-                result += "\\\"";
+                *out++ = '\\';
+                *out++ = '"';
                 break;
             case '\\':
-                result += "\\\\";
+                *out++ = '\\';
+                *out++ = '\\';
                 break;
             case '\b':
-                result += "\\b";
+                *out++ = '\\';
+                *out++ = 'b';
                 break;
             case '\f':
-                result += "\\f";
+                *out++ = '\\';
+                *out++ = 'f';
                 break;
             case '\n':
-                result += "\\n";
+                *out++ = '\\';
+                *out++ = 'n';
                 break;
             case '\r':
-                result += "\\r";
+                *out++ = '\\';
+                *out++ = 'r';
                 break;
             case '\t':
-                result += "\\t";
+                *out++ = '\\';
+                *out++ = 't';
                 break;
             default:
-                result += c;
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::memcpy(out, "\\u00", 4);
+                    out[4] = HEX_DIGITS[static_cast<unsigned char>(c) >> 4];
+                    out[5] = HEX_DIGITS[static_cast<unsigned char>(c) & 0xF];
+                    out += 6;
+                } else {
+                    *out++ = c;
+                }
                 break;
         }
     }
-
-    return result;
+    return out;
 }
 
-std::string JsonUtils::unescapeJsonString(const std::string& str) {
-    std::string result;
-    result.reserve(str.length());
-
-    for (size_t i = 0; i < str.length(); ++i) {
-        if (str[i] == '\\' && i + 1 < str.length()) {
-            switch (str[i + 1]) {
-                case '"':
-                    result += '"';
-                    ++i;
-                    break;
-                case '\\':
-                    result += '\\';
-                    ++i;
-                    break;
-                case 'b':
-                    result += '\b';
-                    ++i;
-                    break;
-                case 'f':
-                    result += '\f';
-                    ++i;
-                    break;
-                case 'n':
-                    result += '\n';
-                    ++i;
-                    break;
-                case 'r':
-                    result += '\r';
-                    ++i;
-                    break;
-                case 't':
-                    result += '\t';
-                    ++i;
-                    break;
-                default:
-                    result += str[i];
+void JsonUtils::appendUnescaped(std::string_view str, std::string& out) {
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] != '\\' || i + 1 >= str.size()) {
+            out += str[i];
+            continue;
+        }
+        const char kind = str[++i];
+        switch (kind) {
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                int32_t code = i + 4 < str.size() ? readHex4(str.data() + i + 1) : -1;
+                if (code < 0) {
+                    out += "\\u";  // Not an escape after all; kept as written
                     break;
+                }
+                i += 4;
+                // A high surrogate followed by a low one names a single code point
+                if (code >= 0xD800 && code < 0xDC00 && i + 6 < str.size() && str[i + 1] == '\\' &&
+                    str[i + 2] == 'u') {
+                    const int32_t low = readHex4(str.data() + i + 3);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                appendUtf8(static_cast<uint32_t>(code), out);
+                break;
             }
-        } else {
-            result += str[i];
+            default:
+                out += kind;  // \" \\ \/ and anything unknown stand for themselves
+                break;
         }
     }
-
-    return result;
 }
 
 }  // namespace AutoVibez::Utils
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace AutoVibez::Utils {
@@ -26,9 +27,18 @@ public:
      * @param json_array JSON array string
      * @return Vector of parsed strings
      */
-    static std::vector<std::string> jsonArrayToVector(const std::string& json_array);
+    static std::vector<std::string> jsonArrayToVector(std::string_view json_array);
+
+    /**
+     * @brief Parse a JSON string array without copying tags that need no unescaping
+     *
+     * Plain tags are views into json_array; escaped ones are unescaped into arena,
+     * which is cleared and reserved up front so its views stay valid. Both must
+     * outlive the views. Unterminated strings and anything outside quotes are skipped.
+     * @param tags Replaced with the parsed tags
+     */
+    static void parseJsonArray(std::string_view json_array, std::vector<std::string_view>& tags, std::string& arena);
 
-private:
     /**
      * @brief Escape special characters in JSON string
      * @param str String to escape
@@ -36,12 +46,22 @@ private:
      */
     static std::string escapeJsonString(const std::string& str);
 
+private:
+    /**
+     * @brief Length of str once escaped
+     */
+    static size_t escapedLength(std::string_view str);
+
+    /**
+     * @brief Write str escaped at out, which has escapedLength(str) bytes
+     * @return One past the last byte written
+     */
+    static char* writeEscaped(std::string_view str, char* out);
+
     /**
-     * @brief Unescape JSON string
-     * @param str Escaped string
-     * @return Unescaped string
+     * @brief Append the unescaped form of the body of a JSON string to out
      */
-    static std::string unescapeJsonString(const std::string& str);
+    static void appendUnescaped(std::string_view str, std::string& out);
 };
 
 }  // namespace AutoVibez::Utils
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer queue
+ *
+ * Each cell carries a sequence number that says whether it is free for the
+ * producer at a position or holds the value for the consumer at it (D. Vyukov's
+ * bounded queue). Pushing and popping never take a lock or wait; a full queue
+ * rejects the push instead. Values are moved in and out of preallocated cells.
+ */
+template <typename T>
+class LockFreeQueue {
+public:
+    /**
+     * @brief Create a queue
+     * @param capacity Minimum number of queued values (rounded up to a power of two)
+     */
+    explicit LockFreeQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    /**
+     * @brief Append a value
+     * @return False if the queue is full (the value is left untouched)
+     */
+    bool tryPush(T& value) {
+        size_t position = _head.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &_cells[position & _mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(T&& value) {
+        return tryPush(value);
+    }
+
+    /**
+     * @brief Remove the oldest value
+     * @return False if the queue is empty
+     */
+    bool tryPop(T& out) {
+        size_t position = _tail.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &_cells[position & _mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->value);
+        cell->value = T();  // Release whatever the value holds now rather than when the cell is reused
+        cell->sequence.store(position + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const {
+        return _mask + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask = 0;
+
+    // Producers claim positions at _head, consumers at _tail
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+};
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,221 @@
+#include "log_sink.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+#include "platform/path_manager.hpp"
+#include "trace_recorder.hpp"
+
+namespace AutoVibez::Utils {
+
+LogSink::LogSink(std::string path, int64_t rotate_bytes, int keep_files, size_t capacity)
+    : _queue(capacity), _path(std::move(path)), _rotateBytes(rotate_bytes), _keepFiles(keep_files) {
+    _thread = std::thread(&LogSink::run, this);
+}
+
+LogSink::~LogSink() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+LogSink& LogSink::instance() {
+    // Never destroyed, so loggers in static destructors still have somewhere to go
+    static LogSink* sink = []() {
+        LogSink* created = new LogSink();
+        std::atexit([]() { LogSink::instance().flush(); });
+        return created;
+    }();
+    return *sink;
+}
+
+bool LogSink::push(const char* level, const char* text, size_t length, bool urgent) {
+    LogRecord record;
+    record.level = level;
+    record.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    const size_t kept = std::min(length, sizeof(record.text));
+    std::memcpy(record.text, text, kept);
+    record.length = static_cast<uint16_t>(kept);
+    record.truncated = kept < length;
+
+    if (!_queue.tryPush(record)) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // A queue filling up faster than the interval drains it gets the writer early too
+    const size_t pending = _pending.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (urgent || pending == _queue.capacity() / 2) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _urgent = true;
+        }
+        _wake.notify_one();
+    }
+    return true;
+}
+
+void LogSink::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    const uint64_t ticket = ++_flushRequests;
+    _wake.notify_one();
+    _flushed.wait(lock, [this, ticket]() { return _flushedTicket >= ticket || _stopping; });
+}
+
+void LogSink::run() {
+    AUTOVIBEZ_TRACE_THREAD("log writer");
+    while (true) {
+        uint64_t ticket = 0;
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait_for(lock, std::chrono::milliseconds(Constants::LOG_FLUSH_INTERVAL_MS),
+                           [this]() { return _stopping || _urgent || _flushRequests > _flushedTicket; });
+            ticket = _flushRequests;
+            stopping = _stopping;
+            _urgent = false;
+        }
+
+        // Everything pushed before the flush request was read is in the queue by now
+        drain();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _flushedTicket = ticket;
+        }
+        _flushed.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void LogSink::drain() {
+    _batch.clear();
+    LogRecord record;
+    while (_queue.tryPop(record)) {
+        _pending.fetch_sub(1, std::memory_order_relaxed);
+        appendRecord(_batch, record);
+    }
+    const uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != _reportedDropped) {
+        const std::string note = std::to_string(dropped - _reportedDropped) + " log messages dropped (queue full)";
+        record.level = "WARNING";
+        record.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+        record.length = static_cast<uint16_t>(std::min(note.size(), sizeof(record.text)));
+        std::memcpy(record.text, note.data(), record.length);
+        record.truncated = false;
+        appendRecord(_batch, record);
+        _reportedDropped = dropped;
+    }
+    if (!_batch.empty()) {
+        write(_batch);
+    }
+}
+
+void LogSink::open() {
+    _opened = true;
+    try {
+        if (_path.empty()) {
+            const std::string stateDir = PathManager::getStateDirectory();
+            PathManager::ensureDirectoryExists(stateDir);
+            _path = stateDir + "/autovibez.log";
+        }
+        _file.open(_path, std::ios::app | std::ios::binary);
+        std::error_code error;
+        const uintmax_t size = std::filesystem::file_size(_path, error);
+        _fileBytes = error ? 0 : static_cast<int64_t>(size);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to initialize log file: " << e.what() << std::endl;
+    }
+    if (!_file.is_open()) {
+        return;
+    }
+    std::string line;
+    LogRecord record;
+    record.level = "INFO";
+    record.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    static const char started[] = "Logger initialized";
+    std::memcpy(record.text, started, sizeof(started) - 1);
+    record.length = sizeof(started) - 1;
+    appendRecord(line, record);
+    _file << line;
+    _fileBytes += static_cast<int64_t>(line.size());
+}
+
+void LogSink::rotate() {
+    _file.close();
+    std::error_code error;
+    // autovibez.log.2 becomes .3 and so on; whatever was at the last slot is replaced
+    for (int index = _keepFiles; index > 1; --index) {
+        const std::string from = _path + "." + std::to_string(index - 1);
+        if (std::filesystem::exists(from, error)) {
+            std::filesystem::rename(from, _path + "." + std::to_string(index), error);
+        }
+    }
+    if (_keepFiles > 0) {
+        std::filesystem::rename(_path, _path + ".1", error);
+    } else {
+        std::filesystem::remove(_path, error);
+    }
+    _file.open(_path, std::ios::trunc | std::ios::binary);
+    _fileBytes = 0;
+    _rotations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogSink::write(const std::string& text) {
+    if (!_opened) {
+        open();
+    }
+    if (!_file.is_open()) {
+        return;
+    }
+    if (_rotateBytes > 0 && _fileBytes > 0 && _fileBytes + static_cast<int64_t>(text.size()) > _rotateBytes) {
+        rotate();
+    }
+    _file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    _file.flush();
+    _fileBytes += static_cast<int64_t>(text.size());
+}
+
+void LogSink::appendRecord(std::string& out, const LogRecord& record) {
+    const std::time_t seconds = static_cast<std::time_t>(record.time_ms / 1000);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char stamp[40];
+    const size_t length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(stamp + length, sizeof(stamp) - length, ".%03d", static_cast<int>(record.time_ms % 1000));
+
+    out += '[';
+    out += stamp;
+    out += "] ";
+    out += record.level;
+    out += ": ";
+    out.append(record.text, record.length);
+    if (record.truncated) {
+        out += "...";
+    }
+    out += '\n';
+}
+
+}  // namespace AutoVibez::Utils
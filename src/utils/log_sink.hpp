@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "constants.hpp"
+#include "lock_free_queue.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief One queued log line: fixed size, so queuing it never allocates
+ */
+struct LogRecord {
+    const char* level = "";  //!< Static label, e.g. "INFO"
+    int64_t time_ms = 0;     //!< Wall clock, milliseconds since the epoch
+    uint16_t length = 0;
+    bool truncated = false;
+    char text[Constants::LOG_RECORD_TEXT_BYTES] = {};
+};
+
+/**
+ * @brief The log file, written by one background thread from a lock-free queue
+ *
+ * push() copies the message into a preallocated record with no lock, allocation or
+ * system call, so it is safe on the audio thread; a full queue drops the record and
+ * counts it. The writer wakes every Constants::LOG_FLUSH_INTERVAL_MS, or at once for
+ * an urgent record, formats everything queued into one buffer and writes it with a
+ * single flush. A file that would grow past the rotation size is moved to .1 (older
+ * ones shift up) and a new one started. The file is opened on the writer thread, so
+ * no producer ever waits on the file system. Thread-safe.
+ */
+class LogSink {
+public:
+    /**
+     * @param path Log file; empty for autovibez.log in the state directory, resolved on the writer thread
+     * @param rotate_bytes Rotate before the file would pass this size, 0 to never rotate
+     * @param keep_files Rotated files kept beside the live one
+     */
+    explicit LogSink(std::string path = "", int64_t rotate_bytes = Constants::LOG_ROTATE_BYTES,
+                     int keep_files = Constants::LOG_ROTATE_KEEP, size_t capacity = Constants::LOG_QUEUE_CAPACITY);
+
+    /**
+     * @brief Writes what is queued, then joins the writer
+     */
+    ~LogSink();
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    /**
+     * @brief The process-wide sink behind Logger; never destroyed, flushed at exit
+     */
+    static LogSink& instance();
+
+    /**
+     * @brief Queue a message; cut to Constants::LOG_RECORD_TEXT_BYTES
+     * @param urgent Wake the writer now (takes its mutex, so not for the audio thread)
+     * @return False if the queue was full and the message was dropped
+     */
+    bool push(const char* level, const char* text, size_t length, bool urgent = false);
+
+    /**
+     * @brief Block until everything queued before the call is in the file
+     */
+    void flush();
+
+    uint64_t getDroppedCount() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Times the file was rotated
+     */
+    uint64_t getRotationCount() const {
+        return _rotations.load(std::memory_order_relaxed);
+    }
+
+private:
+    LockFreeQueue<LogRecord> _queue;
+    std::atomic<size_t> _pending{0};  // Queued and not yet taken by the writer
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _rotations{0};
+
+    std::mutex _mutex;  // Guards the wake-up state below
+    std::condition_variable _wake;
+    std::condition_variable _flushed;
+    bool _urgent = false;
+    bool _stopping = false;
+    uint64_t _flushRequests = 0;
+    uint64_t _flushedTicket = 0;
+
+    // The writer thread's alone
+    std::string _path;
+    int64_t _rotateBytes;
+    int _keepFiles;
+    std::ofstream _file;
+    int64_t _fileBytes = 0;
+    bool _opened = false;
+    uint64_t _reportedDropped = 0;
+    std::string _batch;
+
+    std::thread _thread;
+
+    void run();
+    void drain();
+    void open();
+    void rotate();
+    void write(const std::string& text);
+    static void appendRecord(std::string& out, const LogRecord& record);
+};
+
+}  // namespace AutoVibez::Utils
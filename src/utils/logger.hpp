@@ -1,8 +1,6 @@
 #pragma once
 
-#include <fstream>
-#include <memory>
-#include <mutex>
+#include <atomic>
 #include <string>
 
 #include "error_handler.hpp"
@@ -13,7 +11,8 @@ namespace AutoVibez::Utils {
  * @brief Centralized logging system with multiple log levels
  *
  * Extends ErrorHandler to provide thread-safe logging to filesystem with timestamping.
- * Uses PathManager for cross-platform directory structures.
+ * Messages go through the shared LogSink, whose background thread does the file I/O,
+ * so constructing a Logger and logging from it are both cheap.
  * All setError() calls are automatically logged to file.
  */
 class Logger : public ErrorHandler {
@@ -42,23 +41,21 @@ public:
     void setMinLogLevel(LogLevel level);
     LogLevel getMinLogLevel() const;
 
+    /**
+     * @brief Log from a thread that must not block, e.g. the audio callback
+     *
+     * Never locks or allocates; the message is dropped if the queue is full.
+     */
+    static void logRealtime(LogLevel level, const char* message);
+
 private:
     void writeToLogFile(LogLevel level, const std::string& message);
-    void initializeLogFile();
-    std::string formatLogEntry(LogLevel level, const std::string& message) const;
-    std::string getCurrentTimestamp() const;
-    std::string levelToString(LogLevel level) const;
-
-    // Thread safety
-    mutable std::mutex logMutex_;
+    static const char* levelToString(LogLevel level);
 
-    // File handling
-    std::unique_ptr<std::ofstream> logFile_;
-    std::string logFilePath_;
     bool fileLoggingEnabled_;
 
     // Log level filtering
-    LogLevel minLogLevel_ = LogLevel::INFO;  // Default: INFO and above
+    std::atomic<LogLevel> minLogLevel_{LogLevel::INFO};  // Default: INFO and above
 };
 
 // Convenience macros for better logging experience
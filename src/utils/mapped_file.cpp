@@ -0,0 +1,151 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+
+#include "constants.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Utils {
+
+namespace {
+#ifdef _WIN32
+// PrefetchVirtualMemory is Windows 8+; resolve it at runtime so older SDK targets still link
+struct MemoryRangeEntry {
+    PVOID VirtualAddress;
+    SIZE_T NumberOfBytes;
+};
+using PrefetchVirtualMemoryFn = BOOL(WINAPI*)(HANDLE, ULONG_PTR, MemoryRangeEntry*, ULONG);
+
+PrefetchVirtualMemoryFn prefetchVirtualMemory() {
+    static PrefetchVirtualMemoryFn fn = reinterpret_cast<PrefetchVirtualMemoryFn>(
+        GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory"));
+    return fn;
+}
+#endif
+}  // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    clearError();
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        setError("Failed to open file: " + path);
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        setError("File is empty or unreadable: " + path);
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        setError("Failed to map file: " + path);
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        setError("Failed to map file: " + path);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _data = static_cast<const unsigned char*>(view);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        setError("Failed to open file: " + path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        setError("File is empty or unreadable: " + path);
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file referenced; the descriptor is no longer needed
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        setError("Failed to map file: " + path);
+        return false;
+    }
+
+    _data = static_cast<const unsigned char*>(view);
+    _size = static_cast<size_t>(info.st_size);
+    madvise(view, _size, MADV_SEQUENTIAL);
+#endif
+
+    _path = path;
+    prefetch(0, Constants::MAPPED_READAHEAD_BYTES);
+    return true;
+}
+
+void MappedFile::close() {
+    if (_data) {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+#else
+        munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+    }
+#ifdef _WIN32
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+        _mappingHandle = nullptr;
+    }
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+        _fileHandle = nullptr;
+    }
+#endif
+    _data = nullptr;
+    _size = 0;
+    _path.clear();
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    length = std::min(length, _size - offset);
+
+#ifdef _WIN32
+    if (PrefetchVirtualMemoryFn fn = prefetchVirtualMemory()) {
+        MemoryRangeEntry range{const_cast<unsigned char*>(_data) + offset, length};
+        fn(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    // madvise wants a page-aligned start
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t aligned = offset - offset % page;
+    madvise(const_cast<unsigned char*>(_data) + aligned, length + (offset - aligned), MADV_WILLNEED);
+#endif
+}
+
+}  // namespace AutoVibez::Utils
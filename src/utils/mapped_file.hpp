@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "error_handler.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * The mapping is advised for sequential access so the kernel reads ahead in large
+ * chunks; prefetch() asks for a window ahead of the reader to be paged in early.
+ */
+class MappedFile : public ErrorHandler {
+public:
+    MappedFile() = default;
+    ~MappedFile() override;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file into memory
+     * @param path Path to the file
+     * @return True if successful, false otherwise
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file (safe to call when closed)
+     */
+    void close();
+
+    bool isOpen() const {
+        return _data != nullptr;
+    }
+    const unsigned char* data() const {
+        return _data;
+    }
+    size_t size() const {
+        return _size;
+    }
+    const std::string& getPath() const {
+        return _path;
+    }
+
+    /**
+     * @brief Start asynchronous read-ahead for a byte range (clamped to the file)
+     *
+     * Only issues a hint; it never waits for I/O, so it is safe to call from the audio thread.
+     */
+    void prefetch(size_t offset, size_t length) const;
+
+private:
+    const unsigned char* _data = nullptr;
+    size_t _size = 0;
+    std::string _path;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+};
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,180 @@
+#include "memory_accounting.hpp"
+
+#include <atomic>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Utils {
+
+namespace {
+// Constant-initialized, so charges from other static constructors land safely
+std::atomic<int64_t> g_bytes[MEMORY_TAG_COUNT];
+std::atomic<int64_t> g_peaks[MEMORY_TAG_COUNT];
+std::atomic<int64_t> g_lastResident{-1};
+std::atomic<int64_t> g_lastPeakResident{-1};
+
+void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::string formatMegabytes(int64_t bytes) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+    return text;
+}
+}  // namespace
+
+void MemoryAccounting::add(MemoryTag tag, int64_t bytes) {
+    const size_t index = static_cast<size_t>(tag);
+    const int64_t now = g_bytes[index].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes > 0) {
+        raisePeak(g_peaks[index], now);
+    }
+}
+
+MemoryUsage MemoryAccounting::get(MemoryTag tag) {
+    const size_t index = static_cast<size_t>(tag);
+    MemoryUsage usage;
+    usage.bytes = g_bytes[index].load(std::memory_order_relaxed);
+    usage.peak_bytes = g_peaks[index].load(std::memory_order_relaxed);
+    return usage;
+}
+
+int64_t MemoryAccounting::getTrackedBytes() {
+    int64_t total = 0;
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        if (!isGpuTag(static_cast<MemoryTag>(i))) {
+            total += g_bytes[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+const char* MemoryAccounting::tagName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::Catalog:
+            return "catalog";
+        case MemoryTag::Manifest:
+            return "manifest";
+        case MemoryTag::PcmBuffers:
+            return "pcm_buffers";
+        case MemoryTag::DownloadBuffers:
+            return "download_buffers";
+        case MemoryTag::GpuTextures:
+            return "gpu_textures";
+        case MemoryTag::GpuRenderTargets:
+            return "gpu_render_targets";
+        case MemoryTag::GpuPixelBuffers:
+            return "gpu_pixel_buffers";
+    }
+    return "unknown";
+}
+
+void MemoryAccounting::resetPeaks() {
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        g_peaks[i].store(g_bytes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+int64_t MemoryAccounting::getResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<int64_t>(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+        KERN_SUCCESS) {
+        return -1;
+    }
+    return static_cast<int64_t>(info.resident_size);
+#else
+    // The second field of statm is the resident page count
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return -1;
+    }
+    long size = 0;
+    long resident = 0;
+    const int read = std::fscanf(statm, "%ld %ld", &size, &resident);
+    std::fclose(statm);
+    if (read != 2) {
+        return -1;
+    }
+    return static_cast<int64_t>(resident) * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+int64_t MemoryAccounting::getPeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<int64_t>(counters.PeakWorkingSetSize);
+    }
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef __APPLE__
+    return static_cast<int64_t>(usage.ru_maxrss);  // Bytes on macOS
+#else
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;  // Kilobytes on Linux and the BSDs
+#endif
+#endif
+}
+
+ProcessMemory MemoryAccounting::sample() {
+    ProcessMemory process;
+    process.resident_bytes = getResidentBytes();
+    process.peak_resident_bytes = getPeakResidentBytes();
+    g_lastResident.store(process.resident_bytes, std::memory_order_relaxed);
+    g_lastPeakResident.store(process.peak_resident_bytes, std::memory_order_relaxed);
+    return process;
+}
+
+ProcessMemory MemoryAccounting::getLastSample() {
+    ProcessMemory process;
+    process.resident_bytes = g_lastResident.load(std::memory_order_relaxed);
+    process.peak_resident_bytes = g_lastPeakResident.load(std::memory_order_relaxed);
+    return process;
+}
+
+std::string MemoryAccounting::formatBreakdown(const ProcessMemory& process) {
+    std::string text;
+    if (process.resident_bytes >= 0) {
+        text += "resident " + formatMegabytes(process.resident_bytes);
+        if (process.peak_resident_bytes >= 0) {
+            text += ", peak " + formatMegabytes(process.peak_resident_bytes);
+        }
+        text += ", untracked " + formatMegabytes(process.resident_bytes - getTrackedBytes()) + ";";
+    }
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const MemoryUsage usage = get(tag);
+        if (!text.empty()) {
+            text += i == 0 ? " " : ", ";
+        }
+        text += std::string(tagName(tag)) + " " + formatMegabytes(usage.bytes) + " (peak " +
+                formatMegabytes(usage.peak_bytes) + ")";
+    }
+    return text;
+}
+
+}  // namespace AutoVibez::Utils
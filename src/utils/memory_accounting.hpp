@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief What a block of memory belongs to
+ */
+enum class MemoryTag {
+    Catalog,           //!< Mix catalog snapshots, available_mixes among them
+    Manifest,          //!< Manifest text and the YAML tree parsed from it
+    PcmBuffers,        //!< Capture and playback rings
+    DownloadBuffers,   //!< Write-behind buffers of downloads in flight
+    GpuTextures,       //!< Textures we upload; projectM's own are out of reach
+    GpuRenderTargets,  //!< Offscreen framebuffer attachments
+    GpuPixelBuffers,   //!< Readback pixel buffer objects
+};
+
+constexpr size_t MEMORY_TAG_COUNT = static_cast<size_t>(MemoryTag::GpuPixelBuffers) + 1;
+
+/**
+ * @brief Bytes held under one tag now and at most since the last reset
+ */
+struct MemoryUsage {
+    int64_t bytes = 0;
+    int64_t peak_bytes = 0;
+};
+
+/**
+ * @brief Process-wide memory figures, -1 where they cannot be read
+ */
+struct ProcessMemory {
+    int64_t resident_bytes = -1;
+    int64_t peak_resident_bytes = -1;
+};
+
+/**
+ * @brief Bytes held per subsystem, to tell which one grows when the process does
+ *
+ * Owners report what they hold through a MemoryCharge or a TaggedAllocator; each
+ * report is one relaxed atomic add, so it is safe on any thread, the audio
+ * callbacks included. GPU figures are what we asked the driver for, not what it
+ * spent. Whatever the tags miss (projectM, SDL, the allocator's own slack) is the
+ * resident size less getTrackedBytes(), shown as "untracked" by the HUD.
+ */
+class MemoryAccounting {
+public:
+    /**
+     * @param bytes Negative to release
+     */
+    static void add(MemoryTag tag, int64_t bytes);
+
+    static MemoryUsage get(MemoryTag tag);
+
+    /**
+     * @brief Whether the tag counts driver allocations rather than our heap
+     */
+    static bool isGpuTag(MemoryTag tag) {
+        return tag >= MemoryTag::GpuTextures;
+    }
+
+    /**
+     * @brief Sum of the host tags; GPU ones are left out, as a discrete card keeps them out of the resident set
+     */
+    static int64_t getTrackedBytes();
+
+    /**
+     * @brief Snake-case name for metrics and logs, e.g. "gpu_render_targets"
+     */
+    static const char* tagName(MemoryTag tag);
+
+    /**
+     * @brief Start every peak again from the current value
+     */
+    static void resetPeaks();
+
+    /**
+     * @brief Resident set size of this process, or -1 where it cannot be read
+     */
+    static int64_t getResidentBytes();
+
+    /**
+     * @brief Highest resident set size of this process so far, or -1 where it cannot be read
+     */
+    static int64_t getPeakResidentBytes();
+
+    /**
+     * @brief Read both resident figures and remember them for getLastSample()
+     */
+    static ProcessMemory sample();
+
+    /**
+     * @brief What the last sample() read, without touching /proc
+     */
+    static ProcessMemory getLastSample();
+
+    /**
+     * @brief The resident figures and every tag on one line, for the log
+     */
+    static std::string formatBreakdown(const ProcessMemory& process);
+};
+
+/**
+ * @brief Bytes charged to a tag while the charge lives
+ *
+ * For owners whose memory is not a single container, e.g. a catalog snapshot
+ * estimating its indexes, or a GPU object sized on creation. Movable, not copyable.
+ */
+class MemoryCharge {
+public:
+    explicit MemoryCharge(MemoryTag tag, size_t bytes = 0) : _tag(tag) {
+        set(bytes);
+    }
+
+    ~MemoryCharge() {
+        set(0);
+    }
+
+    MemoryCharge(MemoryCharge&& other) noexcept : _tag(other._tag), _bytes(other._bytes) {
+        other._bytes = 0;
+    }
+
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+        if (this != &other) {
+            set(0);
+            _tag = other._tag;
+            _bytes = other._bytes;
+            other._bytes = 0;
+        }
+        return *this;
+    }
+
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    /**
+     * @brief Replace the charge with a new size
+     */
+    void set(size_t bytes) {
+        if (bytes != _bytes) {
+            MemoryAccounting::add(_tag, static_cast<int64_t>(bytes) - static_cast<int64_t>(_bytes));
+            _bytes = bytes;
+        }
+    }
+
+    size_t bytes() const {
+        return _bytes;
+    }
+
+private:
+    MemoryTag _tag;
+    size_t _bytes = 0;
+};
+
+/**
+ * @brief std::allocator that charges what it hands out to a tag
+ *
+ * Drop-in for containers owned by one subsystem:
+ *
+ *     std::vector<float, TaggedAllocator<float, MemoryTag::PcmBuffers>> _buffer;
+ */
+template <typename T, MemoryTag Tag>
+class TaggedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() noexcept = default;
+
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t count) {
+        T* block = std::allocator<T>().allocate(count);
+        MemoryAccounting::add(Tag, static_cast<int64_t>(count * sizeof(T)));
+        return block;
+    }
+
+    void deallocate(T* block, size_t count) noexcept {
+        MemoryAccounting::add(Tag, -static_cast<int64_t>(count * sizeof(T)));
+        std::allocator<T>().deallocate(block, count);
+    }
+
+    template <typename U>
+    bool operator==(const TaggedAllocator<U, Tag>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const TaggedAllocator<U, Tag>&) const noexcept {
+        return false;
+    }
+};
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,239 @@
+#include "metrics_exporter.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "logger.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace AutoVibez::Utils {
+
+namespace {
+std::string formatNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.15g", value);
+    return text;
+}
+}  // namespace
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry) : _registry(registry) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(const std::string& statsd_address, const std::string& textfile_path,
+                            std::chrono::milliseconds interval) {
+    stop();
+    if (statsd_address.empty() && textfile_path.empty()) {
+        setError("No metrics sink configured");
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_exportMutex);
+        if (!statsd_address.empty() && !openSocket(statsd_address)) {
+            return false;
+        }
+        _textfilePath = textfile_path;
+        _textfileFailed = false;
+    }
+
+    _stop = CancellationToken();
+    _thread = std::thread([this, interval]() {
+        while (_stop.sleepFor(interval)) {
+            exportNow();
+        }
+    });
+    setSuccess(true);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    _stop.cancel();
+    _thread.join();
+    // The last partial interval would otherwise never be reported
+    exportNow();
+    std::lock_guard<std::mutex> lock(_exportMutex);
+    closeSocket();
+    _textfilePath.clear();
+}
+
+void MetricsExporter::exportNow() {
+    std::lock_guard<std::mutex> lock(_exportMutex);
+    if (_socket < 0 && _textfilePath.empty()) {
+        return;
+    }
+    const std::vector<MetricSample> samples = _registry.collect();
+    if (_socket >= 0) {
+        send(formatStatsd(samples));
+    }
+    if (!_textfilePath.empty()) {
+        writeTextfile(MetricsRegistry::formatPrometheus(samples));
+    }
+}
+
+std::vector<std::string> MetricsExporter::formatStatsd(const std::vector<MetricSample>& samples) {
+    std::vector<std::string> lines;
+    for (const MetricSample& sample : samples) {
+        switch (sample.kind) {
+            case MetricKind::Gauge:
+                lines.push_back(sample.name + ":" + formatNumber(sample.value) + "|g");
+                break;
+            case MetricKind::Counter: {
+                double& previous = _previous[sample.name];
+                if (sample.value > previous) {
+                    lines.push_back(sample.name + ":" + formatNumber(sample.value - previous) + "|c");
+                }
+                previous = sample.value;
+                break;
+            }
+            case MetricKind::Histogram: {
+                // Count and sum are enough for a mean per interval; the buckets stay in the Prometheus file
+                double& previousCount = _previous[sample.name + ".count"];
+                double& previousSum = _previous[sample.name + ".sum"];
+                const double count = static_cast<double>(sample.histogram.count);
+                if (count > previousCount) {
+                    lines.push_back(sample.name + ".count:" + formatNumber(count - previousCount) + "|c");
+                    lines.push_back(sample.name + ".sum:" + formatNumber(sample.histogram.sum - previousSum) + "|c");
+                }
+                previousCount = count;
+                previousSum = sample.histogram.sum;
+                break;
+            }
+        }
+    }
+    return lines;
+}
+
+void MetricsExporter::writeTextfile(const std::string& text) {
+    // Written aside and renamed over, so a collector never reads half a file
+    const std::string temporary = _textfilePath + ".tmp";
+    std::error_code error;
+    {
+        std::ofstream file(temporary, std::ios::trunc | std::ios::binary);
+        file << text;
+        if (!file.good()) {
+            error = std::make_error_code(std::errc::io_error);
+        }
+    }
+    if (!error) {
+        std::filesystem::rename(temporary, _textfilePath, error);
+    }
+    if (error && !_textfileFailed) {
+        _textfileFailed = true;
+        Logger logger;
+        logger.logWarning("Cannot write metrics to " + _textfilePath + ": " + error.message());
+    }
+}
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+#define AUTOVIBEZ_CLOSE_SOCKET closesocket
+#else
+using SocketHandle = int;
+#define AUTOVIBEZ_CLOSE_SOCKET close
+#endif
+
+bool MetricsExporter::openSocket(const std::string& statsd_address) {
+    const size_t colon = statsd_address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == statsd_address.size()) {
+        setError("StatsD address must be host:port: " + statsd_address);
+        return false;
+    }
+    const std::string host = statsd_address.substr(0, colon);
+    const std::string port = statsd_address.substr(colon + 1);
+
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        setError("Cannot start Winsock for StatsD");
+        return false;
+    }
+#endif
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    const int resolved = getaddrinfo(host.c_str(), port.c_str(), &hints, &found);
+    if (resolved != 0 || !found) {
+        setError("Cannot resolve StatsD address " + statsd_address + ": " + gai_strerror(resolved));
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    const SocketHandle udp = socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+#ifdef _WIN32
+    const bool opened = udp != INVALID_SOCKET;
+#else
+    const bool opened = udp >= 0;
+#endif
+    if (!opened) {
+        freeaddrinfo(found);
+        setError("Cannot create the StatsD socket");
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    const unsigned char* address = reinterpret_cast<const unsigned char*>(found->ai_addr);
+    _address.assign(address, address + found->ai_addrlen);
+    freeaddrinfo(found);
+    _socket = static_cast<intptr_t>(udp);
+    return true;
+}
+
+void MetricsExporter::closeSocket() {
+    if (_socket < 0) {
+        return;
+    }
+    AUTOVIBEZ_CLOSE_SOCKET(static_cast<SocketHandle>(_socket));
+    _socket = -1;
+    _address.clear();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void MetricsExporter::send(const std::vector<std::string>& lines) {
+    // As many lines per datagram as fit without fragmenting on a typical link; a lost one loses only its lines
+    const sockaddr* address = reinterpret_cast<const sockaddr*>(_address.data());
+    const auto addressLength = static_cast<socklen_t>(_address.size());
+    const size_t limit = static_cast<size_t>(Constants::METRICS_STATSD_PACKET_BYTES);
+    std::string packet;
+    auto flush = [&]() {
+        if (!packet.empty()) {
+            sendto(static_cast<SocketHandle>(_socket), packet.data(), static_cast<int>(packet.size()), 0, address,
+                   addressLength);
+            packet.clear();
+        }
+    };
+    for (const std::string& line : lines) {
+        if (!packet.empty() && packet.size() + 1 + line.size() > limit) {
+            flush();
+        }
+        if (!packet.empty()) {
+            packet += '\n';
+        }
+        packet += line;
+    }
+    flush();
+}
+
+#undef AUTOVIBEZ_CLOSE_SOCKET
+
+}  // namespace AutoVibez::Utils
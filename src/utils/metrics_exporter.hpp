@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cancellation_token.hpp"
+#include "constants.hpp"
+#include "error_handler.hpp"
+#include "metrics_registry.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Ships the metrics registry off the machine at a fixed interval
+ *
+ * Two sinks, either or both: StatsD lines pushed over UDP to a collector, and a
+ * Prometheus text file rewritten in place for a node exporter's textfile collector.
+ * StatsD wants changes, so counters and histogram counts go out as the increase since
+ * the last push; gauges go out as their value. A push is one read of the registry and
+ * a few datagrams on a background thread, so nothing on the render or audio threads
+ * waits for the network.
+ */
+class MetricsExporter : public ErrorHandler {
+public:
+    explicit MetricsExporter(MetricsRegistry& registry = MetricsRegistry::instance());
+
+    /**
+     * @brief Pushes once more, then stops
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @param statsd_address host:port of a StatsD collector, empty for none
+     * @param textfile_path Prometheus text file to keep current, empty for none
+     * @return False, with nothing running, if the address cannot be resolved or both sinks are empty
+     */
+    bool start(const std::string& statsd_address, const std::string& textfile_path,
+               std::chrono::milliseconds interval = std::chrono::milliseconds(Constants::METRICS_EXPORT_INTERVAL_MS));
+
+    /**
+     * @brief Push what changed since the last interval, then join the thread
+     */
+    void stop();
+
+    bool isRunning() const {
+        return _thread.joinable();
+    }
+
+    /**
+     * @brief Push to every sink now; the thread calls this each interval
+     */
+    void exportNow();
+
+    /**
+     * @brief StatsD lines for the change since the previous call
+     */
+    std::vector<std::string> formatStatsd(const std::vector<MetricSample>& samples);
+
+private:
+    MetricsRegistry& _registry;
+    std::mutex _exportMutex;                            // One push at a time, and guards the members below
+    std::unordered_map<std::string, double> _previous;  // Last pushed count of each counter and histogram
+    intptr_t _socket = -1;
+    std::vector<unsigned char> _address;  // sockaddr of the collector
+    std::string _textfilePath;
+    bool _textfileFailed = false;  // Warned once already
+
+    CancellationToken _stop;
+    std::thread _thread;
+
+    bool openSocket(const std::string& statsd_address);
+    void closeSocket();
+    void send(const std::vector<std::string>& lines);
+    void writeTextfile(const std::string& text);
+};
+
+}  // namespace AutoVibez::Utils
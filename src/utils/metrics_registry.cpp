@@ -0,0 +1,187 @@
+#include "metrics_registry.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+#include "memory_accounting.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+const char* kindName(MetricKind kind) {
+    switch (kind) {
+        case MetricKind::Counter:
+            return "counter";
+        case MetricKind::Gauge:
+            return "gauge";
+        case MetricKind::Histogram:
+            return "histogram";
+    }
+    return "untyped";
+}
+
+std::string formatValue(double value) {
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    return text;
+}
+
+// HELP text escapes only backslashes and newlines
+std::string escapeHelp(const std::string& help) {
+    std::string escaped;
+    escaped.reserve(help.size());
+    for (char c : help) {
+        if (c == '\\') {
+            escaped += "\\\\";
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+}  // namespace
+
+MetricHistogram::MetricHistogram(std::vector<double> bounds)
+    : _bounds(std::move(bounds)), _buckets(new std::atomic<uint64_t>[_bounds.size() + 1]) {
+    std::sort(_bounds.begin(), _bounds.end());
+    for (size_t i = 0; i <= _bounds.size(); ++i) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+HistogramSnapshot MetricHistogram::snapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.bounds = _bounds;
+    snapshot.counts.resize(_bounds.size() + 1);
+    for (size_t i = 0; i <= _bounds.size(); ++i) {
+        snapshot.counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    snapshot.sum = _sum.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::find(const std::string& name, const std::string& help, MetricKind kind) {
+    auto it = _index.find(name);
+    if (it != _index.end()) {
+        Entry& existing = _entries[it->second];
+        if (existing.kind == kind) {
+            return existing;
+        }
+        _detached.push_back(std::make_unique<Entry>(Entry{name, help, kind, nullptr, nullptr, nullptr}));
+        return *_detached.back();
+    }
+    _index.emplace(name, _entries.size());
+    _entries.push_back(Entry{name, help, kind, nullptr, nullptr, nullptr});
+    return _entries.back();
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = find(name, help, MetricKind::Counter);
+    if (!entry.counter) {
+        entry.counter = std::make_unique<MetricCounter>();
+    }
+    return *entry.counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = find(name, help, MetricKind::Gauge);
+    if (!entry.gauge) {
+        entry.gauge = std::make_unique<MetricGauge>();
+    }
+    return *entry.gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                            std::vector<double> bounds) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = find(name, help, MetricKind::Histogram);
+    if (!entry.histogram) {
+        entry.histogram = std::make_unique<MetricHistogram>(std::move(bounds));
+    }
+    return *entry.histogram;
+}
+
+std::vector<MetricSample> MetricsRegistry::collect() {
+    const ProcessMemory process = MemoryAccounting::sample();
+    if (process.resident_bytes >= 0) {
+        MetricGauge& residentBytes = gauge("autovibez_process_resident_bytes", "Resident set size of the process");
+        residentBytes.set(static_cast<double>(process.resident_bytes));
+    }
+    if (process.peak_resident_bytes >= 0) {
+        MetricGauge& peakBytes = gauge("autovibez_process_peak_resident_bytes", "Highest resident set size so far");
+        peakBytes.set(static_cast<double>(process.peak_resident_bytes));
+    }
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const MemoryUsage usage = MemoryAccounting::get(tag);
+        const std::string name = std::string("autovibez_memory_") + MemoryAccounting::tagName(tag);
+        gauge(name + "_bytes", "Bytes held by this subsystem").set(static_cast<double>(usage.bytes));
+        gauge(name + "_peak_bytes", "Most bytes this subsystem has held").set(static_cast<double>(usage.peak_bytes));
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<MetricSample> samples;
+    samples.reserve(_entries.size());
+    for (const Entry& entry : _entries) {
+        MetricSample sample;
+        sample.name = entry.name;
+        sample.help = entry.help;
+        sample.kind = entry.kind;
+        switch (entry.kind) {
+            case MetricKind::Counter:
+                sample.value = static_cast<double>(entry.counter->get());
+                break;
+            case MetricKind::Gauge:
+                sample.value = entry.gauge->get();
+                break;
+            case MetricKind::Histogram:
+                sample.histogram = entry.histogram->snapshot();
+                break;
+        }
+        samples.push_back(std::move(sample));
+    }
+    return samples;
+}
+
+std::string MetricsRegistry::formatPrometheus(const std::vector<MetricSample>& samples) {
+    std::string out;
+    for (const MetricSample& sample : samples) {
+        out += "# HELP " + sample.name + " " + escapeHelp(sample.help) + "\n";
+        out += "# TYPE " + sample.name + " " + kindName(sample.kind) + "\n";
+        if (sample.kind != MetricKind::Histogram) {
+            out += sample.name + " " + formatValue(sample.value) + "\n";
+            continue;
+        }
+        // Prometheus buckets are cumulative
+        const HistogramSnapshot& histogram = sample.histogram;
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < histogram.counts.size(); ++i) {
+            cumulative += histogram.counts[i];
+            const double bound = i < histogram.bounds.size() ? histogram.bounds[i] : INFINITY;
+            out += sample.name + "_bucket{le=\"" + formatValue(bound) + "\"} " + std::to_string(cumulative) + "\n";
+        }
+        out += sample.name + "_sum " + formatValue(histogram.sum) + "\n";
+        out += sample.name + "_count " + std::to_string(histogram.count) + "\n";
+    }
+    return out;
+}
+
+int64_t MetricsRegistry::getResidentBytes() {
+    return MemoryAccounting::getResidentBytes();
+}
+
+}  // namespace AutoVibez::Utils
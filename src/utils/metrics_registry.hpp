@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Monotonic count, e.g. xruns or bytes downloaded
+ */
+class MetricCounter {
+public:
+    void increment(uint64_t amount = 1) {
+        _value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const {
+        return _value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> _value{0};
+};
+
+/**
+ * @brief Value that goes up and down, e.g. resident memory
+ */
+class MetricGauge {
+public:
+    void set(double value) {
+        _value.store(value, std::memory_order_relaxed);
+    }
+
+    void add(double amount) {
+        double current = _value.load(std::memory_order_relaxed);
+        while (!_value.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {
+        }
+    }
+
+    double get() const {
+        return _value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> _value{0.0};
+};
+
+/**
+ * @brief Counts per bucket of a histogram at one moment
+ */
+struct HistogramSnapshot {
+    std::vector<double> bounds;    //!< Inclusive upper bound of each bucket but the last
+    std::vector<uint64_t> counts;  //!< One more than bounds; the last bucket has no upper bound
+    uint64_t count = 0;
+    double sum = 0.0;
+};
+
+/**
+ * @brief Distribution over fixed buckets, e.g. frame times
+ *
+ * observe() is a short search of the bounds and two relaxed atomic updates, so it
+ * stays on in production. The buckets are read one at a time, so a snapshot taken
+ * while values arrive may be off by those few values.
+ */
+class MetricHistogram {
+public:
+    /**
+     * @param bounds Ascending upper bounds; a value above the last goes in an overflow bucket
+     */
+    explicit MetricHistogram(std::vector<double> bounds);
+
+    void observe(double value) {
+        const size_t bucket = static_cast<size_t>(std::lower_bound(_bounds.begin(), _bounds.end(), value) -
+                                                  _bounds.begin());
+        _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        double sum = _sum.load(std::memory_order_relaxed);
+        while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+        }
+    }
+
+    HistogramSnapshot snapshot() const;
+
+private:
+    std::vector<double> _bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> _buckets;
+    std::atomic<double> _sum{0.0};
+};
+
+enum class MetricKind { Counter, Gauge, Histogram };
+
+/**
+ * @brief One metric's value, as handed to the exporters
+ */
+struct MetricSample {
+    std::string name;
+    std::string help;
+    MetricKind kind = MetricKind::Counter;
+    double value = 0.0;           //!< Counters and gauges
+    HistogramSnapshot histogram;  //!< Histograms
+};
+
+/**
+ * @brief Every metric in the process, by name
+ *
+ * Subsystems look an instrument up once, typically into a function-local static, and
+ * update it on their hot path without a lock:
+ *
+ *     static MetricCounter& xruns = MetricsRegistry::instance().counter("autovibez_audio_xruns_total", "...");
+ *     xruns.increment();
+ *
+ * Names follow Prometheus rules and start with autovibez_<subsystem>_. Asking for a
+ * name again returns the same instrument; asking for it as a different kind returns a
+ * fresh instrument that is never exported. Instruments live as long as the registry.
+ * Thread-safe.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief The registry the app exports; never destroyed, so static instruments stay valid at exit
+     */
+    static MetricsRegistry& instance();
+
+    MetricCounter& counter(const std::string& name, const std::string& help);
+    MetricGauge& gauge(const std::string& name, const std::string& help);
+
+    /**
+     * @param bounds Used when the name is new; an existing histogram keeps its own
+     */
+    MetricHistogram& histogram(const std::string& name, const std::string& help, std::vector<double> bounds);
+
+    /**
+     * @brief Sample the process gauges, then read every metric in registration order
+     */
+    std::vector<MetricSample> collect();
+
+    /**
+     * @brief Prometheus text exposition format, as a /metrics scrape or a textfile collector reads it
+     */
+    static std::string formatPrometheus(const std::vector<MetricSample>& samples);
+
+    /**
+     * @brief Resident set size of this process, or -1 where it cannot be read
+     */
+    static int64_t getResidentBytes();
+
+private:
+    struct Entry {
+        std::string name;
+        std::string help;
+        MetricKind kind;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    std::mutex _mutex;
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, size_t> _index;
+    std::vector<std::unique_ptr<Entry>> _detached;  // Kind clashes, kept alive but never collected
+
+    Entry& find(const std::string& name, const std::string& help, MetricKind kind);
+};
+
+}  // namespace AutoVibez::Utils
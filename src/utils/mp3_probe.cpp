@@ -0,0 +1,541 @@
+#include "mp3_probe.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "constants.hpp"
+#include "string_utils.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+constexpr int ID3V2_FOOTER_SIZE = 10;
+constexpr const char* PROBE_CACHE_VERSION = "mp3probe1";
+
+// Bitrates in kbps by [version is MPEG-1 ? 0 : 1][layer - 1][index]
+constexpr int BITRATES[2][3][16] = {
+    {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+     {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+     {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0}},
+    {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+     {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+     {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}}};
+constexpr int MPEG1_SAMPLE_RATES[3] = {44100, 48000, 32000};
+
+struct FrameHeader {
+    bool mpeg1 = false;
+    int layer = 0;  // 1, 2 or 3
+    int bitrate_kbps = 0;
+    int sample_rate = 0;
+    int channels = 0;
+    int samples_per_frame = 0;
+    int frame_bytes = 0;  // Header included; 0 for free-format frames, whose length the header doesn't give
+};
+
+uint32_t readBigEndian(const unsigned char* data, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+uint32_t readSynchsafe(const unsigned char* data) {
+    return (static_cast<uint32_t>(data[0] & 0x7F) << 21) | (static_cast<uint32_t>(data[1] & 0x7F) << 14) |
+           (static_cast<uint32_t>(data[2] & 0x7F) << 7) | (data[3] & 0x7F);
+}
+
+bool parseFrameHeader(const unsigned char* data, FrameHeader& header) {
+    if (data[0] != 0xFF || (data[1] & 0xE0) != 0xE0) {
+        return false;
+    }
+
+    const int version = (data[1] >> 3) & 0x03;  // 0 = MPEG-2.5, 1 = reserved, 2 = MPEG-2, 3 = MPEG-1
+    const int layerBits = (data[1] >> 1) & 0x03;
+    const int bitrateIndex = (data[2] >> 4) & 0x0F;
+    const int rateIndex = (data[2] >> 2) & 0x03;
+    if (version == 1 || layerBits == 0 || bitrateIndex == 15 || rateIndex == 3) {
+        return false;
+    }
+
+    header.mpeg1 = version == 3;
+    header.layer = 4 - layerBits;
+    header.bitrate_kbps = BITRATES[header.mpeg1 ? 0 : 1][header.layer - 1][bitrateIndex];
+    header.sample_rate = MPEG1_SAMPLE_RATES[rateIndex] >> (version == 3 ? 0 : (version == 2 ? 1 : 2));
+    header.channels = ((data[3] >> 6) & 0x03) == 3 ? 1 : 2;
+    if (header.layer == 1) {
+        header.samples_per_frame = 384;
+    } else if (header.layer == 2 || header.mpeg1) {
+        header.samples_per_frame = 1152;
+    } else {
+        header.samples_per_frame = 576;
+    }
+    if (header.bitrate_kbps > 0) {
+        // Layer I counts 4-byte slots; the padding bit adds one slot
+        const int padding = (data[2] >> 1) & 0x01;
+        const int slot = header.layer == 1 ? 4 : 1;
+        header.frame_bytes =
+            (header.samples_per_frame / 8 * header.bitrate_kbps * 1000 / header.sample_rate / slot + padding) * slot;
+    }
+    return true;
+}
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+// Decode one null-terminated ID3v2 string; returns the bytes consumed including the terminator
+size_t decodeText(int encoding, const unsigned char* data, size_t size, std::string& out) {
+    out.clear();
+    if (encoding == 0 || encoding == 3) {
+        size_t end = 0;
+        while (end < size && data[end] != 0) {
+            if (encoding == 3 || data[end] < 0x80) {
+                out += static_cast<char>(data[end]);
+            } else {
+                appendUtf8(out, data[end]);  // ISO-8859-1 maps straight to the first 256 code points
+            }
+            ++end;
+        }
+        return std::min(size, end + 1);
+    }
+
+    // UTF-16 with a byte order mark (1) or big-endian without one (2)
+    bool bigEndian = true;
+    size_t pos = 0;
+    if (encoding == 1 && size >= 2) {
+        if (data[0] == 0xFF && data[1] == 0xFE) {
+            bigEndian = false;
+            pos = 2;
+        } else if (data[0] == 0xFE && data[1] == 0xFF) {
+            pos = 2;
+        }
+    }
+    uint32_t pendingHigh = 0;
+    for (; pos + 1 < size; pos += 2) {
+        uint32_t unit = bigEndian ? (data[pos] << 8) | data[pos + 1] : (data[pos + 1] << 8) | data[pos];
+        if (unit == 0) {
+            return pos + 2;
+        }
+        if (unit >= 0xD800 && unit < 0xDC00) {
+            pendingHigh = unit;
+            continue;
+        }
+        if (unit >= 0xDC00 && unit < 0xE000) {
+            if (pendingHigh != 0) {
+                appendUtf8(out, 0x10000 + ((pendingHigh - 0xD800) << 10) + (unit - 0xDC00));
+            }
+            pendingHigh = 0;
+            continue;
+        }
+        pendingHigh = 0;
+        appendUtf8(out, unit);
+    }
+    return size;
+}
+
+void readTextFrame(const std::string& id, const unsigned char* body, size_t size, Mp3ProbeResult& result) {
+    if (size < 2) {
+        return;
+    }
+    const int encoding = body[0];
+    if (encoding > 3) {
+        return;
+    }
+
+    std::string* target = nullptr;
+    if (id == "TIT2" || id == "TT2") {
+        target = &result.title;
+    } else if (id == "TPE1" || id == "TP1") {
+        target = &result.artist;
+    } else if (id == "TCON" || id == "TCO") {
+        target = &result.genre;
+    } else if (id == "COMM" || id == "COM") {
+        if (!result.comment.empty() || size < 5) {
+            return;
+        }
+        // Language code and short description come before the text
+        std::string description;
+        size_t skipped = 4 + decodeText(encoding, body + 4, size - 4, description);
+        if (skipped < size) {
+            decodeText(encoding, body + skipped, size - skipped, result.comment);
+        }
+        return;
+    }
+
+    // The first of several null-separated values is used, as TagLib does
+    if (target && target->empty()) {
+        decodeText(encoding, body + 1, size - 1, *target);
+    }
+}
+
+// Parses the tag header and whatever text frames lie inside size; returns the byte offset where audio starts
+size_t parseId3v2(const unsigned char* data, size_t size, Mp3ProbeResult& result) {
+    if (size < static_cast<size_t>(Constants::ID3V2_HEADER_SIZE) || data[0] != 'I' || data[1] != 'D' ||
+        data[2] != '3') {
+        return 0;
+    }
+
+    const int major = data[3];
+    const int flags = data[5];
+    size_t tagEnd = Constants::ID3V2_HEADER_SIZE + readSynchsafe(data + 6);
+    if (major == 4 && (flags & 0x10)) {
+        tagEnd += ID3V2_FOOTER_SIZE;
+    }
+
+    // Unsynchronised tags need rewriting before frames can be read; leave those to TagLib
+    if (major < 2 || major > 4 || (flags & 0x80)) {
+        return tagEnd;
+    }
+
+    size_t pos = Constants::ID3V2_HEADER_SIZE;
+    if (major >= 3 && (flags & 0x40) && pos + 4 <= size) {
+        pos += major == 4 ? readSynchsafe(data + pos) : readBigEndian(data + pos, 4) + 4;
+    }
+
+    const size_t idSize = major == 2 ? 3 : 4;
+    const size_t frameHeaderSize = major == 2 ? 6 : 10;
+    const size_t limit = std::min(size, tagEnd);
+    while (pos + frameHeaderSize <= limit && data[pos] != 0) {
+        std::string id(reinterpret_cast<const char*>(data + pos), idSize);
+        size_t frameSize = 0;
+        bool readable = true;
+        if (major == 2) {
+            frameSize = readBigEndian(data + pos + 3, 3);
+        } else if (major == 3) {
+            frameSize = readBigEndian(data + pos + 4, 4);
+            readable = (data[pos + 9] & 0xC0) == 0;  // Compressed or encrypted
+        } else {
+            frameSize = readSynchsafe(data + pos + 4);
+            readable = (data[pos + 9] & 0x0F) == 0;  // Compressed, encrypted, unsynchronised or length-prefixed
+        }
+
+        const size_t bodyStart = pos + frameHeaderSize;
+        if (frameSize == 0 || bodyStart + frameSize > limit) {
+            break;
+        }
+        if (readable) {
+            readTextFrame(id, data + bodyStart, frameSize, result);
+        }
+        pos = bodyStart + frameSize;
+    }
+    return tagEnd;
+}
+
+// Looks for the first frame header in data, which starts at file offset base
+void parseAudio(const unsigned char* data, size_t size, int64_t base, int64_t fileSize, Mp3ProbeResult& result) {
+    const size_t scan = std::min(size, static_cast<size_t>(Constants::MP3_PROBE_SYNC_SCAN_BYTES));
+    FrameHeader header;
+    size_t offset = 0;
+    bool found = false;
+    for (; offset + 4 <= scan; ++offset) {
+        if (parseFrameHeader(data + offset, header)) {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        return;
+    }
+
+    result.valid = true;
+    result.audio_offset = base + static_cast<int64_t>(offset);
+    result.sample_rate = header.sample_rate;
+    result.bitrate_kbps = header.bitrate_kbps;
+    result.channels = header.channels;
+
+    // Encoders put a Xing/Info header after the side info of the first frame, or VBRI 32 bytes in
+    const unsigned char* frame = data + offset;
+    const size_t available = size - offset;
+    int64_t frameCount = 0;
+    int64_t streamBytes = 0;
+    if (header.layer == 3) {
+        const size_t xing = 4 + (header.mpeg1 ? (header.channels == 2 ? 32 : 17) : (header.channels == 2 ? 17 : 9));
+        const bool hasXing = xing + 8 <= available && (std::equal(frame + xing, frame + xing + 4, "Xing") ||
+                                                       std::equal(frame + xing, frame + xing + 4, "Info"));
+        if (hasXing) {
+            const uint32_t xingFlags = readBigEndian(frame + xing + 4, 4);
+            size_t field = xing + 8;
+            if ((xingFlags & 0x01) && field + 4 <= available) {
+                frameCount = readBigEndian(frame + field, 4);
+                field += 4;
+            }
+            if ((xingFlags & 0x02) && field + 4 <= available) {
+                streamBytes = readBigEndian(frame + field, 4);
+            }
+        } else if (36 + 18 <= available && std::equal(frame + 36, frame + 40, "VBRI")) {
+            streamBytes = readBigEndian(frame + 36 + 6, 4);
+            frameCount = readBigEndian(frame + 36 + 10, 4);
+        }
+    }
+
+    if (frameCount > 0 && header.sample_rate > 0) {
+        result.has_xing = true;
+        result.duration_seconds = static_cast<double>(frameCount) * header.samples_per_frame / header.sample_rate;
+        if (streamBytes > 0) {
+            result.bitrate_kbps = static_cast<int>(streamBytes * 8 / result.duration_seconds / 1000.0 + 0.5);
+        }
+    } else if (header.bitrate_kbps > 0 && fileSize > result.audio_offset) {
+        result.duration_seconds = (fileSize - result.audio_offset) * 8.0 / (header.bitrate_kbps * 1000.0);
+    }
+}
+
+bool statFile(const std::string& path, uintmax_t& size, int64_t& mtime) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return false;
+    }
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto written = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(written.time_since_epoch().count());
+    return true;
+}
+}  // namespace
+
+Mp3ProbeResult Mp3Probe::probeData(const unsigned char* data, size_t size, int64_t file_size) {
+    Mp3ProbeResult result;
+    const int64_t total = file_size > 0 ? file_size : static_cast<int64_t>(size);
+    if (!data || total < Constants::MIN_MP3_FILE_SIZE) {
+        return result;
+    }
+
+    const size_t audioStart = parseId3v2(data, size, result);
+    if (audioStart < size) {
+        parseAudio(data + audioStart, size - audioStart, static_cast<int64_t>(audioStart), total, result);
+    }
+    return result;
+}
+
+size_t Mp3Probe::tagLength(const unsigned char* data, size_t size) {
+    if (size < static_cast<size_t>(Constants::ID3V2_HEADER_SIZE) || data[0] != 'I' || data[1] != 'D' ||
+        data[2] != '3') {
+        return 0;
+    }
+    size_t length = Constants::ID3V2_HEADER_SIZE + readSynchsafe(data + 6);
+    if (data[3] == 4 && (data[5] & 0x10)) {
+        length += ID3V2_FOOTER_SIZE;
+    }
+    return length;
+}
+
+size_t Mp3Probe::frameLength(const unsigned char* header) {
+    FrameHeader parsed;
+    return parseFrameHeader(header, parsed) ? static_cast<size_t>(parsed.frame_bytes) : 0;
+}
+
+Mp3ProbeResult Mp3Probe::probeFile(const std::string& path) {
+    std::error_code error;
+    const auto fileSize = static_cast<int64_t>(std::filesystem::file_size(path, error));
+    if (error || fileSize < Constants::MIN_MP3_FILE_SIZE) {
+        return Mp3ProbeResult();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return Mp3ProbeResult();
+    }
+
+    std::vector<unsigned char> head(static_cast<size_t>(std::min<int64_t>(fileSize, Constants::MP3_PROBE_HEAD_BYTES)));
+    file.read(reinterpret_cast<char*>(head.data()), static_cast<std::streamsize>(head.size()));
+    head.resize(static_cast<size_t>(file.gcount()));
+
+    Mp3ProbeResult result;
+    const size_t audioStart = parseId3v2(head.data(), head.size(), result);
+    if (audioStart < head.size()) {
+        parseAudio(head.data() + audioStart, head.size() - audioStart, static_cast<int64_t>(audioStart), fileSize,
+                   result);
+        return result;
+    }
+
+    // A tag bigger than the head (usually cover art) needs one more small read where audio begins
+    if (static_cast<int64_t>(audioStart) >= fileSize) {
+        return result;
+    }
+    std::vector<unsigned char> frames(Constants::MP3_PROBE_SYNC_SCAN_BYTES);
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(audioStart));
+    file.read(reinterpret_cast<char*>(frames.data()), static_cast<std::streamsize>(frames.size()));
+    frames.resize(static_cast<size_t>(file.gcount()));
+    parseAudio(frames.data(), frames.size(), static_cast<int64_t>(audioStart), fileSize, result);
+    return result;
+}
+
+Mp3ProbeResult Mp3ProbeCache::probe(const std::string& path) {
+    uintmax_t size = 0;
+    int64_t mtime = 0;
+    if (!statFile(path, size, mtime)) {
+        forget(path);
+        return Mp3ProbeResult();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(path);
+        if (it != _entries.end() && it->second.size == size && it->second.mtime == mtime) {
+            return it->second.result;
+        }
+    }
+
+    // Probe outside the lock so slow disks don't serialize other lookups
+    Entry entry;
+    entry.size = size;
+    entry.mtime = mtime;
+    entry.result = Mp3Probe::probeFile(path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries[path] = entry;
+    return entry.result;
+}
+
+void Mp3ProbeCache::store(const std::string& path, const Mp3ProbeResult& result) {
+    Entry entry;
+    if (!statFile(path, entry.size, entry.mtime)) {
+        return;
+    }
+    entry.result = result;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries[path] = std::move(entry);
+}
+
+void Mp3ProbeCache::forget(const std::string& path) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.erase(path);
+}
+
+bool Mp3ProbeCache::isCurrent(const std::string& path) const {
+    uintmax_t size = 0;
+    int64_t mtime = 0;
+    if (!statFile(path, size, mtime)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(path);
+    return it != _entries.end() && it->second.size == size && it->second.mtime == mtime;
+}
+
+void Mp3ProbeCache::moved(const std::string& from, const std::string& to) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(from);
+    if (it == _entries.end()) {
+        _entries.erase(to);
+        return;
+    }
+    Entry entry = std::move(it->second);
+    _entries.erase(it);
+    _entries[to] = std::move(entry);
+}
+
+void Mp3ProbeCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+size_t Mp3ProbeCache::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+bool Mp3ProbeCache::load(const std::string& file_path) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != PROBE_CACHE_VERSION) {
+        return false;
+    }
+
+    std::unordered_map<std::string, Entry> loaded;
+    while (std::getline(file, line)) {
+        const std::vector<std::string> fields = StringUtils::splitFields(line, '\t');
+        if (fields.size() != 14) {
+            return false;
+        }
+
+        Entry entry;
+        Mp3ProbeResult& result = entry.result;
+        try {
+            entry.size = std::stoull(fields[1]);
+            entry.mtime = std::stoll(fields[2]);
+            result.valid = fields[3] == "1";
+            result.audio_offset = std::stoll(fields[4]);
+            result.sample_rate = std::stoi(fields[5]);
+            result.bitrate_kbps = std::stoi(fields[6]);
+            result.channels = std::stoi(fields[7]);
+            result.duration_seconds = std::stod(fields[8]);
+            result.has_xing = fields[9] == "1";
+        } catch (const std::exception&) {
+            return false;
+        }
+        result.title = StringUtils::unescapeField(fields[10]);
+        result.artist = StringUtils::unescapeField(fields[11]);
+        result.genre = StringUtils::unescapeField(fields[12]);
+        result.comment = StringUtils::unescapeField(fields[13]);
+        loaded[StringUtils::unescapeField(fields[0])] = std::move(entry);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries = std::move(loaded);
+    return true;
+}
+
+bool Mp3ProbeCache::save(const std::string& file_path) const {
+    std::error_code error;
+    auto parent = std::filesystem::path(file_path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Written beside the target and renamed so a crash never leaves a half-written cache
+    const std::string temp_path = file_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.precision(17);
+        file << PROBE_CACHE_VERSION << '\n';
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& [path, entry] : _entries) {
+            const Mp3ProbeResult& result = entry.result;
+            file << StringUtils::escapeField(path) << '\t' << entry.size << '\t' << entry.mtime << '\t'
+                 << (result.valid ? 1 : 0) << '\t' << result.audio_offset << '\t' << result.sample_rate << '\t'
+                 << result.bitrate_kbps << '\t' << result.channels << '\t' << result.duration_seconds << '\t'
+                 << (result.has_xing ? 1 : 0) << '\t' << StringUtils::escapeField(result.title) << '\t'
+                 << StringUtils::escapeField(result.artist) << '\t' << StringUtils::escapeField(result.genre) << '\t'
+                 << StringUtils::escapeField(result.comment) << '\n';
+        }
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, file_path, error);
+    return !error;
+}
+
+}  // namespace AutoVibez::Utils
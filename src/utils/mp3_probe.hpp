@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief What one bounded read of an MP3's head tells us about the file
+ */
+struct Mp3ProbeResult {
+    bool valid = false;             //!< An ID3v2 tag (if any) is followed by a valid MPEG frame header
+    int64_t audio_offset = 0;       //!< Byte offset of the first frame header
+    int sample_rate = 0;            //!< From the first frame header
+    int bitrate_kbps = 0;           //!< First frame's bitrate, or the Xing average for VBR files
+    int channels = 0;               //!< 1 or 2
+    double duration_seconds = 0.0;  //!< Exact from a Xing/Info/VBRI frame count, otherwise a CBR estimate
+    bool has_xing = false;          //!< A Xing, Info or VBRI header supplied the frame count
+
+    // ID3v2 text frames converted to UTF-8; empty when absent or past the probed range
+    std::string title;
+    std::string artist;
+    std::string genre;
+    std::string comment;
+};
+
+/**
+ * @brief Single-pass MP3 probe: ID3v2 header and text frames, first frame header, Xing/Info header
+ *
+ * Replaces separate validation and tag reads with one read of the file head (a second, small
+ * read only when the tag is larger than the head, e.g. because of embedded cover art).
+ */
+class Mp3Probe {
+public:
+    /**
+     * @brief Probe an MP3 file
+     * @param path Path to the file
+     * @return Probe result; valid is false for missing, short or non-MP3 files
+     */
+    static Mp3ProbeResult probeFile(const std::string& path);
+
+    /**
+     * @brief Probe an MP3 already in memory
+     * @param data Whole file, or at least its head
+     * @param size Number of bytes in data
+     * @param file_size Size of the whole file, used for the duration estimate (0 means size)
+     * @return Probe result
+     */
+    static Mp3ProbeResult probeData(const unsigned char* data, size_t size, int64_t file_size = 0);
+
+    /**
+     * @brief Bytes taken by the ID3v2 tag that data starts with, its footer included
+     * @return 0 if data does not start with a tag header
+     */
+    static size_t tagLength(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Length of the MPEG frame whose header starts at header, header included
+     * @param header At least 4 bytes
+     * @return 0 if the bytes are not a frame header, or are a free-format one
+     */
+    static size_t frameLength(const unsigned char* header);
+};
+
+/**
+ * @brief Thread-safe cache of probe results keyed on path and validated by size and mtime
+ *
+ * Repeated plays, cleanup passes and ingest steps return the stored verdict after a stat()
+ * instead of reading the file again. The cache can be persisted so startup cleanup is cheap.
+ */
+class Mp3ProbeCache {
+public:
+    /**
+     * @brief Probe a file, reusing the stored result while its size and mtime are unchanged
+     * @param path Path to the file
+     * @return Probe result; invalid for files that cannot be stat'ed
+     */
+    Mp3ProbeResult probe(const std::string& path);
+
+    /**
+     * @brief Keep a verdict reached without reading the file, e.g. from its bytes as they were downloaded
+     */
+    void store(const std::string& path, const Mp3ProbeResult& result);
+
+    /**
+     * @brief Drop the entry for a deleted or rewritten file
+     */
+    void forget(const std::string& path);
+
+    /**
+     * @brief True if an entry is held for the file at its current size and mtime
+     */
+    bool isCurrent(const std::string& path) const;
+
+    /**
+     * @brief Carry an entry over a rename (which keeps size and mtime)
+     */
+    void moved(const std::string& from, const std::string& to);
+
+    void clear();
+    size_t size() const;
+
+    /**
+     * @brief Replace the contents with a file written by save()
+     * @param file_path Cache file
+     * @return True if successful, false if the file is missing or malformed
+     */
+    bool load(const std::string& file_path);
+
+    /**
+     * @brief Write all entries to a file
+     * @param file_path Cache file
+     * @return True if successful, false otherwise
+     */
+    bool save(const std::string& file_path) const;
+
+private:
+    struct Entry {
+        uintmax_t size = 0;
+        int64_t mtime = 0;
+        Mp3ProbeResult result;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+};
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,111 @@
+#include "mp3_stream_check.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+constexpr int64_t ID3V1_TAG_SIZE = 128;
+}  // namespace
+
+void Mp3StreamCheck::feed(const unsigned char* data, size_t size) {
+    _fed += static_cast<int64_t>(size);
+    size_t used = 0;
+    while (!_head_done && used < size) {
+        const size_t limit = _head_target > 0 ? _head_target : static_cast<size_t>(Constants::MP3_PROBE_HEAD_BYTES);
+        const size_t take = std::min(size - used, limit - _head.size());
+        _head.insert(_head.end(), data + used, data + used + take);
+        used += take;
+
+        if (_head_target == 0 && _head.size() >= static_cast<size_t>(Constants::ID3V2_HEADER_SIZE)) {
+            // A large tag (cover art, mostly) pushes the first frame past the usual head
+            const size_t audio = Mp3Probe::tagLength(_head.data(), _head.size());
+            _head_target =
+                std::max<size_t>(Constants::MP3_PROBE_HEAD_BYTES, audio + Constants::MP3_PROBE_SYNC_SCAN_BYTES);
+            _head_clipped = _head_target > static_cast<size_t>(Constants::MP3_STREAM_HEAD_MAX_BYTES);
+            _head_target = std::min<size_t>(_head_target, Constants::MP3_STREAM_HEAD_MAX_BYTES);
+        }
+        if (_head_target > 0 && _head.size() >= _head_target) {
+            _head_done = true;
+            startWalk();
+        }
+    }
+    if (_walking && used < size) {
+        walk(data + used, size - used);
+    }
+}
+
+Mp3StreamReport Mp3StreamCheck::finish() const {
+    if (!_head_done) {
+        // The whole file fit in the head: walk it now, on a copy so more can still be fed
+        Mp3StreamCheck whole = *this;
+        whole._head_done = true;
+        whole.startWalk();
+        return whole.report();
+    }
+    return report();
+}
+
+void Mp3StreamCheck::startWalk() {
+    const Mp3ProbeResult probe = Mp3Probe::probeData(_head.data(), _head.size());
+    const auto audio = static_cast<size_t>(probe.audio_offset);
+    if (probe.valid && audio < _head.size()) {
+        _walking = true;
+        walk(_head.data() + audio, _head.size() - audio);
+    }
+}
+
+void Mp3StreamCheck::walk(const unsigned char* data, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        if (_skip > 0) {
+            const size_t skipped = static_cast<size_t>(std::min<int64_t>(_skip, static_cast<int64_t>(size - i)));
+            _skip -= static_cast<int64_t>(skipped);
+            i += skipped;
+            continue;
+        }
+        while (_candidate_size < sizeof(_candidate) && i < size) {
+            _candidate[_candidate_size++] = data[i++];
+        }
+        if (_candidate_size < sizeof(_candidate)) {
+            break;
+        }
+
+        const size_t length = Mp3Probe::frameLength(_candidate);
+        if (length >= sizeof(_candidate)) {
+            _frames++;
+            _trailing_lost = 0;
+            _skip = static_cast<int64_t>(length - sizeof(_candidate));
+            _candidate_size = 0;
+            continue;
+        }
+
+        // Out of sync: give up one byte and look for a header at the next
+        if (_trailing_lost == 0) {
+            std::memcpy(_lost_start, _candidate, sizeof(_lost_start));
+        }
+        _lost++;
+        _trailing_lost++;
+        std::memmove(_candidate, _candidate + 1, sizeof(_candidate) - 1);
+        _candidate_size = sizeof(_candidate) - 1;
+    }
+}
+
+Mp3StreamReport Mp3StreamCheck::report() const {
+    Mp3StreamReport report;
+    report.probed = !_head_clipped || _fed <= static_cast<int64_t>(_head.size());
+    report.probe = Mp3Probe::probeData(_head.data(), _head.size(), _fed);
+    report.frames = _frames;
+    report.truncated = _skip > 0;
+
+    // Whatever follows the last frame is lost, unless it is exactly an ID3v1 tag
+    const int64_t tail = _trailing_lost + static_cast<int64_t>(_candidate_size);
+    const bool id3v1 = tail == ID3V1_TAG_SIZE && _trailing_lost >= 3 && std::memcmp(_lost_start, "TAG", 3) == 0;
+    report.lost_bytes = id3v1 ? _lost - _trailing_lost : _lost + static_cast<int64_t>(_candidate_size);
+    return report;
+}
+
+}  // namespace AutoVibez::Utils
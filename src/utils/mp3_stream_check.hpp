@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mp3_probe.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief What Mp3StreamCheck found in a file's bytes
+ */
+struct Mp3StreamReport {
+    bool probed = false;     //!< The head was seen whole, so probe is the verdict Mp3Probe reaches from the file
+    Mp3ProbeResult probe;    //!< Only meaningful when probed
+    int64_t frames = 0;      //!< Frame headers walked, the first included
+    int64_t lost_bytes = 0;  //!< Bytes between frames that were no frame, an ID3v1 tag at the end aside
+    bool truncated = false;  //!< The last frame runs past the end of the file
+};
+
+/**
+ * @brief Frame-sync check of an MP3 fed in file order, e.g. from a download's write callback
+ *
+ * Keeps the file's head until it covers an ID3v2 tag and MP3_PROBE_SYNC_SCAN_BYTES past it
+ * (at most MP3_STREAM_HEAD_MAX_BYTES), then probes it as Mp3Probe::probeData would and walks
+ * frame headers from the first frame on, skipping each frame by its length. Nothing is held
+ * past the head, so the cost is a few compares per frame. The walk only measures: a file that
+ * loses sync still probes valid, as it would on disk; callers decide what the counts mean.
+ */
+class Mp3StreamCheck {
+public:
+    void feed(const unsigned char* data, size_t size);
+
+    /**
+     * @brief The findings once the whole file has been fed
+     */
+    Mp3StreamReport finish() const;
+
+    int64_t getBytesFed() const {
+        return _fed;
+    }
+
+private:
+    void walk(const unsigned char* data, size_t size);
+    void startWalk();
+    Mp3StreamReport report() const;
+
+    int64_t _fed = 0;
+    std::vector<unsigned char> _head;
+    // 0 until the head's first bytes say how long the tag is; clipped when it runs past MP3_STREAM_HEAD_MAX_BYTES
+    size_t _head_target = 0;
+    bool _head_clipped = false;
+    bool _head_done = false;
+    bool _walking = false;
+
+    // Walk state: bytes left of the current frame, then up to 4 bytes of the next candidate header
+    int64_t _skip = 0;
+    unsigned char _candidate[4] = {};
+    size_t _candidate_size = 0;
+    int64_t _frames = 0;
+    int64_t _lost = 0;
+    int64_t _trailing_lost = 0;         // Lost since the last frame, which an ID3v1 tag at the end accounts for
+    unsigned char _lost_start[3] = {};  // First bytes of that run
+};
+
+}  // namespace AutoVibez::Utils
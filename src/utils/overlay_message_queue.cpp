@@ -0,0 +1,132 @@
+#include "overlay_message_queue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace AutoVibez::Utils {
+
+namespace {
+// Pop order: higher priority first, then older first
+bool popsBefore(const QueuedOverlayMessage& a, const QueuedOverlayMessage& b) {
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.order < b.order;
+}
+}  // namespace
+
+OverlayMessageQueue::OverlayMessageQueue() {
+    for (QueuedOverlayMessage& slot : _slots) {
+        slot.text.reserve(Constants::OVERLAY_MESSAGE_RESERVE);
+    }
+    _scratch.reserve(Constants::OVERLAY_MESSAGE_RESERVE);
+}
+
+bool OverlayMessageQueue::push(const NamedMessageConfig& config) {
+    // Plain text merges only with the same text, so it is formatted before looking
+    const bool plain = config.type == OverlayMessageType::Text;
+    if (plain) {
+        _scratch.clear();
+        if (config.formatter) {
+            config.formatter(_scratch);
+        }
+    }
+
+    size_t index = findMerge(config);
+    if (index < _count) {
+        // Keeps its place in line, and the higher of the two priorities
+        _merged++;
+        QueuedOverlayMessage& slot = _slots[index];
+        slot.priority = std::max(slot.priority, config.priority);
+        slot.duration = config.duration;
+        slot.colorTransition = config.colorTransition;
+        if (!plain) {
+            slot.text.clear();
+            if (config.formatter) {
+                config.formatter(slot.text);
+            }
+        }
+        return true;
+    }
+
+    if (_count == CAPACITY) {
+        // Full: the entry that would be popped last makes room, unless it outranks the new one
+        size_t last = 0;
+        for (size_t i = 1; i < _count; ++i) {
+            if (popsBefore(_slots[last], _slots[i])) {
+                last = i;
+            }
+        }
+        _dropped++;
+        if (_slots[last].priority > config.priority) {
+            return false;
+        }
+        remove(last);
+    }
+
+    QueuedOverlayMessage& slot = _slots[_count++];
+    slot.type = config.type;
+    slot.priority = config.priority;
+    slot.duration = config.duration;
+    slot.colorTransition = config.colorTransition;
+    slot.order = ++_order;
+    if (plain) {
+        slot.text.swap(_scratch);
+    } else {
+        slot.text.clear();
+        if (config.formatter) {
+            config.formatter(slot.text);
+        }
+    }
+    return true;
+}
+
+const QueuedOverlayMessage* OverlayMessageQueue::peek() const {
+    return _count > 0 ? &_slots[findNext()] : nullptr;
+}
+
+bool OverlayMessageQueue::pop(QueuedOverlayMessage& message) {
+    if (_count == 0) {
+        return false;
+    }
+    const size_t index = findNext();
+    QueuedOverlayMessage& slot = _slots[index];
+    message.type = slot.type;
+    message.priority = slot.priority;
+    message.duration = slot.duration;
+    message.colorTransition = slot.colorTransition;
+    message.order = slot.order;
+    message.text.swap(slot.text);
+    remove(index);
+    return true;
+}
+
+size_t OverlayMessageQueue::findNext() const {
+    size_t next = 0;
+    for (size_t i = 1; i < _count; ++i) {
+        if (popsBefore(_slots[i], _slots[next])) {
+            next = i;
+        }
+    }
+    return next;
+}
+
+size_t OverlayMessageQueue::findMerge(const NamedMessageConfig& config) const {
+    for (size_t i = 0; i < _count; ++i) {
+        const QueuedOverlayMessage& slot = _slots[i];
+        if (slot.type == config.type && (config.type != OverlayMessageType::Text || slot.text == _scratch)) {
+            return i;
+        }
+    }
+    return _count;
+}
+
+void OverlayMessageQueue::remove(size_t index) {
+    // The last queued entry fills the gap; the freed slot keeps a buffer for the next push
+    _count--;
+    if (index != _count) {
+        std::swap(_slots[index], _slots[_count]);
+    }
+}
+
+}  // namespace AutoVibez::Utils
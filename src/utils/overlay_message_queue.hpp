@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "constants.hpp"
+#include "overlay_messages.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief One formatted message, as it waits in OverlayMessageQueue
+ */
+struct QueuedOverlayMessage {
+    OverlayMessageType type = OverlayMessageType::Text;
+    OverlayPriority priority = OverlayPriority::Normal;
+    std::string text;
+    std::chrono::milliseconds duration{0};
+    bool colorTransition = false;
+    uint64_t order = 0;  // Arrival, for first-in first-out within a priority
+};
+
+/**
+ * @brief Fixed-capacity queue of overlay messages with priorities and merging
+ *
+ * Holds up to OVERLAY_QUEUE_CAPACITY messages in slots whose text buffers are
+ * reserved up front and only ever swapped, never freed: a message is formatted
+ * straight into its slot, and pop() trades the slot's buffer for the caller's. A
+ * message of a type already queued (plain text only if the text is the same too)
+ * rewrites that entry in place, taking the higher priority, so a burst of volume
+ * changes leaves one entry with the last value. When the queue is full the oldest
+ * entry of the lowest priority makes room, unless the new message ranks below all
+ * of them. Not thread-safe; MessageOverlay drives it from the render thread.
+ */
+class OverlayMessageQueue {
+public:
+    OverlayMessageQueue();
+
+    /**
+     * @brief Format a message into the queue, or into the entry it merges with
+     * @return False if the queue is full of messages that rank above it
+     */
+    bool push(const NamedMessageConfig& config);
+
+    /**
+     * @brief The entry pop() would take, or nullptr if the queue is empty
+     */
+    const QueuedOverlayMessage* peek() const;
+
+    /**
+     * @brief Take the highest priority entry, oldest first
+     * @param message Receives the entry; its text buffer goes back to the freed slot
+     * @return False if the queue is empty
+     */
+    bool pop(QueuedOverlayMessage& message);
+
+    size_t size() const {
+        return _count;
+    }
+    bool empty() const {
+        return _count == 0;
+    }
+
+    /**
+     * @brief Messages merged into a queued entry so far
+     */
+    uint64_t getMergedCount() const {
+        return _merged;
+    }
+
+    /**
+     * @brief Messages dropped so far, turned away or pushed out by a higher one
+     */
+    uint64_t getDroppedCount() const {
+        return _dropped;
+    }
+
+private:
+    static constexpr size_t CAPACITY = static_cast<size_t>(Constants::OVERLAY_QUEUE_CAPACITY);
+
+    size_t findNext() const;
+    size_t findMerge(const NamedMessageConfig& config) const;
+    void remove(size_t index);
+
+    // Slots [0, _count) are queued, in no particular order; the rest keep their buffers for reuse
+    std::array<QueuedOverlayMessage, CAPACITY> _slots;
+    size_t _count = 0;
+    uint64_t _order = 0;
+    uint64_t _merged = 0;
+    uint64_t _dropped = 0;
+    std::string _scratch;  // Plain text is formatted here first, to compare it with the queued entries
+};
+
+}  // namespace AutoVibez::Utils
@@ -1,11 +1,32 @@
 #include "overlay_messages.hpp"
 
+#include "constants.hpp"
+
 namespace AutoVibez::Utils {
 
 // Static member definitions
 std::unordered_map<std::string, MessageFactory> OverlayMessages::messageRegistry;
 bool OverlayMessages::initialized = false;
 
+NamedMessageConfig OverlayMessages::unknownMessage() {
+    return NamedMessageConfig{[](std::string& out) { out.append("Unknown message"); }, std::chrono::milliseconds(3000),
+                              false};
+}
+
+NamedMessageConfig OverlayMessages::createText(const std::string& text, OverlayPriority priority,
+                                               std::chrono::milliseconds duration) {
+    return NamedMessageConfig{[text](std::string& out) { out.append(text); }, duration, false,
+                              OverlayMessageType::Text, priority};
+}
+
+std::string OverlayMessages::format(const NamedMessageConfig& config) {
+    std::string text;
+    if (config.formatter) {
+        config.formatter(text);
+    }
+    return text;
+}
+
 void OverlayMessages::initializeMessages() {
     if (initialized)
         return;
@@ -15,31 +36,34 @@ void OverlayMessages::initializeMessages() {
         if (args.size() >= 2) {
             std::string artist = args[0];
             std::string title = args[1];
-            return NamedMessageConfig{[artist, title]() { return artist + " - " + title; },
-                                      std::chrono::milliseconds(5000), true};
+            return NamedMessageConfig{
+                [artist, title](std::string& out) { out.append(artist).append(" - ").append(title); },
+                std::chrono::milliseconds(5000), true, OverlayMessageType::MixInfo, OverlayPriority::Normal};
+        }
+        return unknownMessage();
+    };
+
+    // Download status, already formatted by DownloadTelemetry::formatSummary
+    messageRegistry["download_status"] = [](const std::vector<std::string>& args) -> NamedMessageConfig {
+        if (args.size() >= 1) {
+            std::string summary = args[0];
+            return NamedMessageConfig{[summary](std::string& out) { out.append(summary); },
+                                      std::chrono::milliseconds(5000), false, OverlayMessageType::DownloadStatus,
+                                      OverlayPriority::Status};
         }
-        return NamedMessageConfig{[]() { return "Unknown message"; }, std::chrono::milliseconds(3000), false};
+        return unknownMessage();
     };
 
-    // Add more message definitions here as needed
-    // Example for future messages:
-    /*
+    // Volume, repeated while the key is held; each change updates the message already up
     messageRegistry["volume_change"] = [](const std::vector<std::string>& args) -> NamedMessageConfig {
         if (args.size() >= 1) {
             std::string volume = args[0];
-            return NamedMessageConfig{
-                [volume]() { return "🔊 Volume: " + volume + "%"; },
-                std::chrono::milliseconds(3000),
-                true
-            };
+            return NamedMessageConfig{[volume](std::string& out) { out.append("Volume: ").append(volume).append("%"); },
+                                      std::chrono::milliseconds(Constants::OVERLAY_VOLUME_DURATION_MS), false,
+                                      OverlayMessageType::Volume, OverlayPriority::Status};
         }
-        return NamedMessageConfig{
-            []() { return "Invalid volume"; },
-            std::chrono::milliseconds(3000),
-            false
-        };
+        return unknownMessage();
     };
-    */
 
     initialized = true;
 }
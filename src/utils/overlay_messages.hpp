@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <tuple>
@@ -10,10 +11,22 @@
 
 namespace AutoVibez::Utils {
 
+/**
+ * @brief What a message is about; a new message of a type already queued or on screen replaces it in place
+ */
+enum class OverlayMessageType : uint8_t { Text, MixInfo, DownloadStatus, Volume };
+
+/**
+ * @brief Order of queued messages; one above the message on screen replaces it at once
+ */
+enum class OverlayPriority : uint8_t { Status, Normal, Alert };
+
 struct NamedMessageConfig {
-    std::function<std::string()> formatter;
+    std::function<void(std::string& out)> formatter;  // Appends the text, into a buffer the queue reuses
     std::chrono::milliseconds duration;
     bool colorTransition;
+    OverlayMessageType type = OverlayMessageType::Text;
+    OverlayPriority priority = OverlayPriority::Normal;
 };
 
 // Type alias for message factory function
@@ -36,7 +49,20 @@ public:
     template <typename... Args>
     static NamedMessageConfig createMessage(const std::string& name, Args... args);
 
+    /**
+     * @brief Plain text, e.g. a one-off notice or failure
+     */
+    static NamedMessageConfig createText(const std::string& text, OverlayPriority priority = OverlayPriority::Normal,
+                                         std::chrono::milliseconds duration = std::chrono::milliseconds(20000));
+
+    /**
+     * @brief The message's text in a new string, for where no buffer is kept (console, tests)
+     */
+    static std::string format(const NamedMessageConfig& config);
+
 private:
+    static NamedMessageConfig unknownMessage();
+
     /**
      * @brief Convert variadic arguments to string vector
      */
@@ -58,7 +84,7 @@ NamedMessageConfig OverlayMessages::createMessage(const std::string& name, Args.
     }
 
     // Default fallback
-    return NamedMessageConfig{[]() { return "Unknown message"; }, std::chrono::milliseconds(3000), false};
+    return unknownMessage();
 }
 
 // Helper function to convert any type to string
@@ -0,0 +1,32 @@
+#include "rate_meter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.hpp"
+
+namespace AutoVibez::Utils {
+
+bool RateMeter::sample(int64_t bytes, Clock::time_point now) {
+    if (!_started) {
+        _started = true;
+        _bytes = bytes;
+        _sampled = now;
+        return false;
+    }
+    const double seconds = std::chrono::duration<double>(now - _sampled).count();
+    if (seconds * 1000.0 < Constants::DOWNLOAD_RATE_SAMPLE_MS) {
+        return false;
+    }
+
+    const double measured = static_cast<double>(bytes - _bytes) / seconds;
+    // The first span is the best guess there is; later ones only nudge it
+    _rate = _measured ? _rate + Constants::DOWNLOAD_RATE_SMOOTHING * (measured - _rate) : measured;
+    _measured = true;
+    _bytes = bytes;
+    _sampled = now;
+    _bytes_per_second = std::max<int64_t>(static_cast<int64_t>(std::llround(_rate)), 0);
+    return true;
+}
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Smoothed rate of a growing byte count, e.g. a transfer's bytes received
+ *
+ * Samples closer together than DOWNLOAD_RATE_SAMPLE_MS are folded into the next one, so
+ * a burst of small chunks doesn't read as a spike; each sample then moves the rate by
+ * DOWNLOAD_RATE_SMOOTHING of the way towards what the span measured. Not thread-safe.
+ */
+class RateMeter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Note the count's value now
+     * @return True if the rate changed
+     */
+    bool sample(int64_t bytes, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Bytes per second; 0 until a whole sample span has passed
+     */
+    int64_t getBytesPerSecond() const {
+        return _bytes_per_second;
+    }
+
+private:
+    bool _started = false;
+    bool _measured = false;
+    int64_t _bytes = 0;
+    Clock::time_point _sampled;
+    double _rate = 0.0;
+    int64_t _bytes_per_second = 0;
+};
+
+}  // namespace AutoVibez::Utils
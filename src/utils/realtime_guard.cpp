@@ -0,0 +1,211 @@
+#include "realtime_guard.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "constants.hpp"
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#define AUTOVIBEZ_RT_BACKTRACE 1
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define AUTOVIBEZ_RT_SANITIZED 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define AUTOVIBEZ_RT_SANITIZED 1
+#endif
+
+// Sanitizers bring their own allocator and lock interceptors, so only the scope is kept under them
+#if defined(AUTOVIBEZ_RT_CHECKS) && !defined(AUTOVIBEZ_RT_SANITIZED)
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#define AUTOVIBEZ_RT_INTERPOSE_LIBC 1
+#else
+#define AUTOVIBEZ_RT_INTERPOSE_NEW 1
+#endif
+#endif
+
+namespace {
+// Plain thread-locals with constant initializers, so reading them from malloc never allocates
+thread_local int t_depth = 0;
+thread_local bool t_reporting = false;
+
+std::atomic<uint64_t> g_violations{0};
+std::atomic<AutoVibez::Utils::RealtimeGuard::ViolationHandler> g_handler{nullptr};
+}  // namespace
+
+namespace AutoVibez::Utils {
+
+bool RealtimeGuard::isRealtimeContext() {
+    return t_depth > 0;
+}
+
+bool RealtimeGuard::interceptsAllocations() {
+#if defined(AUTOVIBEZ_RT_INTERPOSE_LIBC) || defined(AUTOVIBEZ_RT_INTERPOSE_NEW)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RealtimeGuard::interceptsLocks() {
+#ifdef AUTOVIBEZ_RT_INTERPOSE_LIBC
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RealtimeGuard::check(const char* what) {
+    if (t_depth == 0 || t_reporting) {
+        return;
+    }
+    // Whatever the handler allocates or locks is not reported again
+    t_reporting = true;
+    g_violations.fetch_add(1, std::memory_order_relaxed);
+    const ViolationHandler handler = g_handler.load(std::memory_order_acquire);
+    (handler ? handler : &RealtimeGuard::reportToStderr)(what);
+    t_reporting = false;
+}
+
+uint64_t RealtimeGuard::getViolationCount() {
+    return g_violations.load(std::memory_order_relaxed);
+}
+
+void RealtimeGuard::setViolationHandler(ViolationHandler handler) {
+    g_handler.store(handler, std::memory_order_release);
+}
+
+void RealtimeGuard::reportToStderr(const char* what) {
+    std::fprintf(stderr, "Real-time violation: %s called on an audio thread\n", what);
+#ifdef AUTOVIBEZ_RT_BACKTRACE
+    void* frames[Constants::REALTIME_STACK_FRAMES];
+    const int count = backtrace(frames, Constants::REALTIME_STACK_FRAMES);
+    std::fflush(stderr);
+    backtrace_symbols_fd(frames, count, STDERR_FILENO);
+#endif
+}
+
+RealtimeScope::RealtimeScope() {
+    ++t_depth;
+}
+
+RealtimeScope::~RealtimeScope() {
+    --t_depth;
+}
+
+}  // namespace AutoVibez::Utils
+
+#ifdef AUTOVIBEZ_RT_INTERPOSE_LIBC
+// Definitions in the executable take the place of libc's; the originals stay reachable under these names
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(size_t size) noexcept {
+    AutoVibez::Utils::RealtimeGuard::check("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    AutoVibez::Utils::RealtimeGuard::check("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+    AutoVibez::Utils::RealtimeGuard::check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    AutoVibez::Utils::RealtimeGuard::check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept {
+    AutoVibez::Utils::RealtimeGuard::check("posix_memalign");
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* block = __libc_memalign(alignment, size);
+    if (!block) {
+        return ENOMEM;
+    }
+    *pointer = block;
+    return 0;
+}
+
+void free(void* pointer) noexcept {
+    if (pointer) {
+        AutoVibez::Utils::RealtimeGuard::check("free");
+    }
+    __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+    using LockFunction = int (*)(pthread_mutex_t*);
+    static std::atomic<LockFunction> next{nullptr};
+    AutoVibez::Utils::RealtimeGuard::check("pthread_mutex_lock");
+    LockFunction function = next.load(std::memory_order_acquire);
+    if (!function) {
+        function = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        next.store(function, std::memory_order_release);
+    }
+    return function(mutex);
+}
+}
+#endif
+
+#ifdef AUTOVIBEZ_RT_INTERPOSE_NEW
+void* operator new(std::size_t size) {
+    AutoVibez::Utils::RealtimeGuard::check("operator new");
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    AutoVibez::Utils::RealtimeGuard::check("operator new");
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer) {
+        AutoVibez::Utils::RealtimeGuard::check("operator delete");
+    }
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+}
+#endif
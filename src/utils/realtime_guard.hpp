@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Catches allocations and locks on threads that must never block (audio callbacks)
+ *
+ * A thread counts as real-time while a RealtimeScope is alive on it. With
+ * AUTOVIBEZ_RT_CHECKS compiled in, the allocator and mutex lock are interposed
+ * (malloc, calloc, realloc, free and pthread_mutex_lock on glibc; operator new
+ * and delete elsewhere) and each call made in a real-time scope is reported as a
+ * violation, by default to stderr with a stack trace. Without the option the
+ * scope is a thread-local counter and nothing is interposed. Mark callbacks
+ * through the AUTOVIBEZ_REALTIME_SCOPE macro below.
+ */
+class RealtimeGuard {
+public:
+    /**
+     * @brief Called once per violation with the offending call ("malloc", "pthread_mutex_lock", ...)
+     *
+     * Runs on the real-time thread with checking paused, so it may allocate.
+     */
+    using ViolationHandler = void (*)(const char* what);
+
+    /**
+     * @brief Whether the calling thread is inside a RealtimeScope
+     */
+    static bool isRealtimeContext();
+
+    /**
+     * @brief Whether allocations are interposed in this build
+     */
+    static bool interceptsAllocations();
+
+    /**
+     * @brief Whether mutex locks are interposed in this build
+     */
+    static bool interceptsLocks();
+
+    /**
+     * @brief Report a call that may block if the calling thread is in a real-time scope
+     */
+    static void check(const char* what);
+
+    /**
+     * @brief Violations reported since start, on any thread
+     */
+    static uint64_t getViolationCount();
+
+    /**
+     * @brief Replace the handler; null restores the default report with a stack trace
+     */
+    static void setViolationHandler(ViolationHandler handler);
+
+    /**
+     * @brief Print a violation and the calling thread's stack to stderr
+     */
+    static void reportToStderr(const char* what);
+};
+
+/**
+ * @brief Marks the calling thread as real-time until the scope exits; scopes nest
+ */
+class RealtimeScope {
+public:
+    RealtimeScope();
+    ~RealtimeScope();
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+};
+
+}  // namespace AutoVibez::Utils
+
+#ifdef AUTOVIBEZ_RT_CHECKS
+#define AUTOVIBEZ_REALTIME_SCOPE() ::AutoVibez::Utils::RealtimeScope realtime_scope_
+#else
+#define AUTOVIBEZ_REALTIME_SCOPE() ((void)0)
+#endif
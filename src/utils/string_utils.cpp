@@ -64,4 +64,47 @@ size_t StringUtils::findFirstOf(const std::string& str, char ch) {
     return str.find_first_of(ch);
 }
 
+std::string StringUtils::escapeField(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\t') {
+            out += "\\t";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (c == '\r') {
+            out += "\\r";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string StringUtils::unescapeField(const std::string& value) {
+    std::string out;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '\\' && i + 1 < value.size()) {
+            char next = value[++i];
+            out += next == 't' ? '\t' : next == 'n' ? '\n' : next == 'r' ? '\r' : next;
+        } else {
+            out += value[i];
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> StringUtils::splitFields(const std::string& line, char separator) {
+    // Split by hand: getline would drop a trailing empty field
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (size_t found = line.find(separator); found != std::string::npos; found = line.find(separator, start)) {
+        fields.push_back(line.substr(start, found - start));
+        start = found + 1;
+    }
+    fields.push_back(line.substr(start));
+    return fields;
+}
+
 }  // namespace AutoVibez::Utils
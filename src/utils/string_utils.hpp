@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cctype>
 #include <string>
+#include <vector>
 
 namespace AutoVibez::Utils {
 
@@ -81,6 +82,21 @@ public:
      * @return Position of first occurrence, or std::string::npos if not found
      */
     static size_t findFirstOf(const std::string& str, char ch);
+
+    /**
+     * @brief Escape backslashes, tabs and line breaks for one field of a tab-separated line
+     */
+    static std::string escapeField(const std::string& value);
+
+    /**
+     * @brief Undo escapeField()
+     */
+    static std::string unescapeField(const std::string& value);
+
+    /**
+     * @brief Split a line at every separator, keeping empty fields (including a trailing one)
+     */
+    static std::vector<std::string> splitFields(const std::string& line, char separator);
 };
 
 }  // namespace AutoVibez::Utils
@@ -1,161 +1,380 @@
 #include "system_volume_controller.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
-#include <iostream>
 #include <memory>
-#include <regex>
-#include <sstream>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
 #elif __APPLE__
-#include <unistd.h>
-#elif __linux__
-#include <unistd.h>
+#include <CoreAudio/CoreAudio.h>
+#include <dispatch/dispatch.h>
+#endif
+
+#ifdef HAVE_LIBPULSE
+#include <pulse/context.h>
+#include <pulse/error.h>
+#include <pulse/introspect.h>
+#include <pulse/subscribe.h>
+#include <pulse/thread-mainloop.h>
+#include <pulse/volume.h>
+#endif
+
+#ifdef HAVE_ALSA
+#include <alsa/asoundlib.h>
 #endif
 
 namespace AutoVibez::Utils {
 
-// Linux Implementation
-LinuxVolumeController::LinuxVolumeController() : _audioSystem(AudioSystem::UNKNOWN), _available(false) {
-    _audioSystem = detectAudioSystem();
-    _available = (_audioSystem != AudioSystem::UNKNOWN);
+namespace {
+enum class Backend { None, PulseAudio, Alsa };
+
+int clampVolume(int level) {
+    return std::max(0, std::min(100, level));
 }
+}  // namespace
 
-LinuxVolumeController::AudioSystem LinuxVolumeController::detectAudioSystem() {
-    if (system("which pactl > /dev/null 2>&1") == 0) {
-        return AudioSystem::PULSE_AUDIO;
+// Linux Implementation
+struct LinuxVolumeController::BackendState {
+    Backend backend = Backend::None;
+    std::atomic<int> volume{-1};  // Last level the server reported or we asked for
+
+#ifdef HAVE_LIBPULSE
+    pa_threaded_mainloop* loop = nullptr;
+    pa_context* context = nullptr;
+    std::atomic<bool> contextReady{false};
+
+    // Guarded by the mainloop lock
+    bool contextSettled = false;
+    bool sinkKnown = false;
+    pa_cvolume sinkVolume{};
+    int pendingWrites = 0;
+
+    static constexpr const char* DEFAULT_SINK = "@DEFAULT_SINK@";
+
+    static void onContextState(pa_context* context, void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        const pa_context_state_t contextState = pa_context_get_state(context);
+        state->contextReady.store(contextState == PA_CONTEXT_READY, std::memory_order_release);
+        if (contextState == PA_CONTEXT_READY || !PA_CONTEXT_IS_GOOD(contextState)) {
+            state->contextSettled = true;
+            pa_threaded_mainloop_signal(state->loop, 0);
+        }
     }
-    if (system("which amixer > /dev/null 2>&1") == 0) {
-        return AudioSystem::ALSA;
+
+    static void onSinkInfo(pa_context*, const pa_sink_info* info, int eol, void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        // Events from our own writes still in flight would briefly undo the newer level
+        if (info && state->pendingWrites == 0) {
+            state->sinkVolume = info->volume;
+            const pa_volume_t level = pa_cvolume_max(&info->volume);
+            state->volume.store(static_cast<int>((static_cast<uint64_t>(level) * 100 + PA_VOLUME_NORM / 2) /
+                                                 PA_VOLUME_NORM),
+                                std::memory_order_relaxed);
+        }
+        if (info || eol != 0) {
+            state->sinkKnown = true;
+            pa_threaded_mainloop_signal(state->loop, 0);
+        }
     }
-    return AudioSystem::UNKNOWN;
-}
 
-bool LinuxVolumeController::executeCommand(const std::string& command) {
-    int result = system(command.c_str());
-    if (result != 0) {
-        _lastError = "Command failed with exit code: " + std::to_string(result);
-        return false;
+    static void onSubscribe(pa_context* context, pa_subscription_event_type_t type, uint32_t, void* userData) {
+        // Server events cover a change of default sink
+        const unsigned facility = type & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+        if (facility == PA_SUBSCRIPTION_EVENT_SINK || facility == PA_SUBSCRIPTION_EVENT_SERVER) {
+            requestSinkInfo(context, userData);
+        }
     }
-    return true;
-}
 
-int LinuxVolumeController::getCurrentVolume() {
-    if (!_available) {
-        _lastError = "No audio system available";
-        return -1;
+    static void onWriteDone(pa_context* context, int, void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        if (--state->pendingWrites == 0) {
+            requestSinkInfo(context, userData);
+        }
     }
 
-    std::string command;
-    if (_audioSystem == AudioSystem::PULSE_AUDIO) {
-        command = "pactl get-sink-volume @DEFAULT_SINK@ 2>/dev/null";
-    } else if (_audioSystem == AudioSystem::ALSA) {
-        command = "amixer sget Master 2>/dev/null";
-    } else {
-        _lastError = "Unknown audio system";
-        return -1;
+    static void requestSinkInfo(pa_context* context, void* userData) {
+        if (pa_operation* operation = pa_context_get_sink_info_by_name(context, DEFAULT_SINK, onSinkInfo, userData)) {
+            pa_operation_unref(operation);
+        }
     }
 
-    FILE* pipe = popen(command.c_str(), "r");
-    if (!pipe) {
-        _lastError = "Failed to execute command";
-        return -1;
+    bool startPulse(std::string& error) {
+        loop = pa_threaded_mainloop_new();
+        if (!loop) {
+            error = "pa_threaded_mainloop_new failed";
+            return false;
+        }
+        context = pa_context_new(pa_threaded_mainloop_get_api(loop), "AutoVibez");
+        if (!context) {
+            error = "pa_context_new failed";
+            stopPulse();
+            return false;
+        }
+        pa_context_set_state_callback(context, onContextState, this);
+        pa_context_set_subscribe_callback(context, onSubscribe, this);
+
+        // Never spawn a server just to read its volume
+        if (pa_context_connect(context, nullptr, PA_CONTEXT_NOAUTOSPAWN, nullptr) < 0 ||
+            pa_threaded_mainloop_start(loop) < 0) {
+            error = std::string("PulseAudio: ") + pa_strerror(pa_context_errno(context));
+            stopPulse();
+            return false;
+        }
+
+        // The first level is fetched before returning, so the controller never starts at -1
+        pa_threaded_mainloop_lock(loop);
+        while (!contextSettled) {
+            pa_threaded_mainloop_wait(loop);
+        }
+        if (contextReady.load(std::memory_order_acquire)) {
+            const auto mask =
+                static_cast<pa_subscription_mask_t>(PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SERVER);
+            if (pa_operation* operation = pa_context_subscribe(context, mask, nullptr, nullptr)) {
+                pa_operation_unref(operation);
+            }
+            requestSinkInfo(context, this);
+            while (!sinkKnown && contextReady.load(std::memory_order_acquire)) {
+                pa_threaded_mainloop_wait(loop);
+            }
+        }
+        const bool ready = contextReady.load(std::memory_order_acquire);
+        if (!ready) {
+            error = std::string("PulseAudio: ") + pa_strerror(pa_context_errno(context));
+        }
+        pa_threaded_mainloop_unlock(loop);
+
+        if (!ready) {
+            stopPulse();
+        }
+        return ready;
     }
 
-    std::string output;
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
+    void writePulse(int level) {
+        const auto target = static_cast<pa_volume_t>(static_cast<uint64_t>(level) * PA_VOLUME_NORM / 100);
+
+        pa_threaded_mainloop_lock(loop);
+        // Scaling the last known volume keeps the channel balance
+        pa_cvolume requested = sinkVolume;
+        if (pa_cvolume_valid(&requested)) {
+            pa_cvolume_scale(&requested, target);
+        } else {
+            pa_cvolume_set(&requested, 2, target);
+        }
+        sinkVolume = requested;
+        if (pa_operation* operation =
+                pa_context_set_sink_volume_by_name(context, DEFAULT_SINK, &requested, onWriteDone, this)) {
+            ++pendingWrites;
+            pa_operation_unref(operation);
+        }
+        pa_threaded_mainloop_unlock(loop);
     }
-    pclose(pipe);
 
-    return parseVolumeFromOutput(output);
-}
+    void stopPulse() {
+        if (loop) {
+            pa_threaded_mainloop_stop(loop);
+        }
+        if (context) {
+            pa_context_disconnect(context);
+            pa_context_unref(context);
+            context = nullptr;
+        }
+        if (loop) {
+            pa_threaded_mainloop_free(loop);
+            loop = nullptr;
+        }
+        contextReady.store(false);
+    }
+#endif
+
+#ifdef HAVE_ALSA
+    snd_mixer_t* mixer = nullptr;
+    snd_mixer_elem_t* element = nullptr;
+    long minimum = 0;
+    long maximum = 0;
+
+    static int onAlsaElement(snd_mixer_elem_t* element, unsigned int mask) {
+        auto* state = static_cast<BackendState*>(snd_mixer_elem_get_callback_private(element));
+        if (mask == SND_CTL_EVENT_MASK_REMOVE) {
+            state->element = nullptr;
+            state->volume.store(-1, std::memory_order_relaxed);
+        } else if (mask & SND_CTL_EVENT_MASK_VALUE) {
+            state->readAlsa();
+        }
+        return 0;
+    }
 
-int LinuxVolumeController::parseVolumeFromOutput(const std::string& output) {
-    if (_audioSystem == AudioSystem::PULSE_AUDIO) {
-        std::regex pattern(R"((\d+)%)");
-        std::smatch match;
-        if (std::regex_search(output, match, pattern)) {
-            return std::stoi(match[1].str());
+    bool startAlsa(std::string& error) {
+        if (snd_mixer_open(&mixer, 0) < 0) {
+            error = "Failed to open the ALSA mixer";
+            mixer = nullptr;
+            return false;
         }
-    } else if (_audioSystem == AudioSystem::ALSA) {
-        std::regex pattern(R"(\[(\d+)%\])");
-        std::smatch match;
-        if (std::regex_search(output, match, pattern)) {
-            return std::stoi(match[1].str());
+        snd_mixer_selem_id_t* id = nullptr;
+        if (snd_mixer_attach(mixer, "default") < 0 || snd_mixer_selem_register(mixer, nullptr, nullptr) < 0 ||
+            snd_mixer_load(mixer) < 0 || snd_mixer_selem_id_malloc(&id) < 0) {
+            error = "Failed to load the ALSA mixer";
+            stopAlsa();
+            return false;
         }
+        snd_mixer_selem_id_set_index(id, 0);
+        snd_mixer_selem_id_set_name(id, "Master");
+        element = snd_mixer_find_selem(mixer, id);
+        snd_mixer_selem_id_free(id);
+        if (!element || !snd_mixer_selem_has_playback_volume(element) ||
+            snd_mixer_selem_get_playback_volume_range(element, &minimum, &maximum) < 0 || maximum <= minimum) {
+            error = "No ALSA Master playback control";
+            stopAlsa();
+            return false;
+        }
+
+        snd_mixer_elem_set_callback_private(element, this);
+        snd_mixer_elem_set_callback(element, onAlsaElement);
+        readAlsa();
+        return true;
     }
 
-    _lastError = "Failed to parse volume from output";
-    return -1;
+    void readAlsa() {
+        long raw = 0;
+        if (element && snd_mixer_selem_get_playback_volume(element, SND_MIXER_SCHN_FRONT_LEFT, &raw) == 0) {
+            volume.store(static_cast<int>(((raw - minimum) * 100 + (maximum - minimum) / 2) / (maximum - minimum)),
+                         std::memory_order_relaxed);
+        }
+    }
+
+    bool writeAlsa(int level) {
+        const long raw = minimum + ((maximum - minimum) * level + 50) / 100;
+        return element && snd_mixer_selem_set_playback_volume_all(element, raw) == 0;
+    }
+
+    void stopAlsa() {
+        if (mixer) {
+            snd_mixer_close(mixer);
+            mixer = nullptr;
+        }
+        element = nullptr;
+    }
+#endif
+};
+
+LinuxVolumeController::LinuxVolumeController() : _state(std::make_unique<BackendState>()) {
+#ifdef HAVE_LIBPULSE
+    // Also covers pipewire-pulse
+    if (_state->startPulse(_lastError)) {
+        _state->backend = Backend::PulseAudio;
+        _lastError.clear();
+        return;
+    }
+#endif
+#ifdef HAVE_ALSA
+    if (_state->startAlsa(_lastError)) {
+        _state->backend = Backend::Alsa;
+        _lastError.clear();
+        return;
+    }
+#endif
+#if !defined(HAVE_LIBPULSE) && !defined(HAVE_ALSA)
+    _lastError = "Built without libpulse or ALSA";
+#endif
 }
 
-bool LinuxVolumeController::setVolume(int volumeLevel) {
-    if (!_available) {
+LinuxVolumeController::~LinuxVolumeController() {
+#ifdef HAVE_LIBPULSE
+    _state->stopPulse();
+#endif
+#ifdef HAVE_ALSA
+    _state->stopAlsa();
+#endif
+}
+
+int LinuxVolumeController::getCurrentVolume() {
+    if (!isAvailable()) {
         _lastError = "No audio system available";
-        return false;
+        return -1;
     }
 
-    if (volumeLevel < 0 || volumeLevel > 100) {
-        _lastError = "Volume level must be between 0 and 100";
-        return false;
+#ifdef HAVE_ALSA
+    if (_state->backend == Backend::Alsa) {
+        // The mixer is non-blocking, so this only drains change events already queued
+        snd_mixer_handle_events(_state->mixer);
     }
+#endif
 
-    std::string command;
-    if (_audioSystem == AudioSystem::PULSE_AUDIO) {
-        command = "pactl set-sink-volume @DEFAULT_SINK@ " + std::to_string(volumeLevel) + "%";
-    } else if (_audioSystem == AudioSystem::ALSA) {
-        command = "amixer sset Master " + std::to_string(volumeLevel) + "% > /dev/null 2>&1";
-    } else {
-        _lastError = "Unknown audio system";
-        return false;
+    const int volume = _state->volume.load(std::memory_order_relaxed);
+    if (volume < 0) {
+        _lastError = "No default output device";
     }
-
-    return executeCommand(command);
+    return volume;
 }
 
-bool LinuxVolumeController::increaseVolume(int step) {
-    if (!_available) {
+bool LinuxVolumeController::setVolume(int volumeLevel) {
+    if (!isAvailable()) {
         _lastError = "No audio system available";
         return false;
     }
 
-    std::string command;
-    if (_audioSystem == AudioSystem::PULSE_AUDIO) {
-        command = "pactl set-sink-volume @DEFAULT_SINK@ +" + std::to_string(step) + "%";
-    } else if (_audioSystem == AudioSystem::ALSA) {
-        command = "amixer sset Master " + std::to_string(step) + "%+ > /dev/null 2>&1";
-    } else {
-        _lastError = "Unknown audio system";
+    if (volumeLevel < 0 || volumeLevel > 100) {
+        _lastError = "Volume level must be between 0 and 100";
         return false;
     }
 
-    return executeCommand(command);
+    // Cached up front, so a held key steps from the level it asked for rather than a stale event
+    _state->volume.store(volumeLevel, std::memory_order_relaxed);
+
+#ifdef HAVE_LIBPULSE
+    if (_state->backend == Backend::PulseAudio) {
+        _state->writePulse(volumeLevel);
+        return true;
+    }
+#endif
+#ifdef HAVE_ALSA
+    if (_state->backend == Backend::Alsa) {
+        if (!_state->writeAlsa(volumeLevel)) {
+            _lastError = "Failed to set the ALSA Master volume";
+            _state->readAlsa();
+            return false;
+        }
+        return true;
+    }
+#endif
+
+    _lastError = "Unknown audio system";
+    return false;
 }
 
-bool LinuxVolumeController::decreaseVolume(int step) {
-    if (!_available) {
-        _lastError = "No audio system available";
+bool LinuxVolumeController::increaseVolume(int step) {
+    int currentVolume = getCurrentVolume();
+    if (currentVolume == -1) {
         return false;
     }
+    return setVolume(clampVolume(currentVolume + step));
+}
 
-    std::string command;
-    if (_audioSystem == AudioSystem::PULSE_AUDIO) {
-        command = "pactl set-sink-volume @DEFAULT_SINK@ -" + std::to_string(step) + "%";
-    } else if (_audioSystem == AudioSystem::ALSA) {
-        command = "amixer sset Master " + std::to_string(step) + "%- > /dev/null 2>&1";
-    } else {
-        _lastError = "Unknown audio system";
+bool LinuxVolumeController::decreaseVolume(int step) {
+    int currentVolume = getCurrentVolume();
+    if (currentVolume == -1) {
         return false;
     }
-
-    return executeCommand(command);
+    return setVolume(clampVolume(currentVolume - step));
 }
 
 bool LinuxVolumeController::isAvailable() {
-    return _available;
+    switch (_state->backend) {
+#ifdef HAVE_LIBPULSE
+        case Backend::PulseAudio:
+            return _state->contextReady.load(std::memory_order_acquire);
+#endif
+#ifdef HAVE_ALSA
+        case Backend::Alsa:
+            return _state->element != nullptr;
+#endif
+        default:
+            return false;
+    }
 }
 
 std::string LinuxVolumeController::getLastError() {
@@ -257,57 +476,148 @@ std::string WindowsVolumeController::getLastError() {
 }
 
 // macOS Implementation
-MacOSVolumeController::MacOSVolumeController() : _available(false) {
+struct MacOSVolumeController::BackendState {
+    std::atomic<int> volume{-1};
+    std::atomic<bool> available{false};
+
 #ifdef __APPLE__
-    _available = (system("which osascript > /dev/null 2>&1") == 0);
+    // Everything below is touched only on the queue; listeners hop onto it
+    dispatch_queue_t queue = nullptr;
+    AudioObjectID device = kAudioObjectUnknown;
+    std::vector<AudioObjectPropertyElement> elements;
+    std::atomic<int> target{-1};  // Latest requested level, taken by the next write
+
+    static constexpr AudioObjectPropertyElement MAIN_ELEMENT = 0;
+
+    static AudioObjectPropertyAddress volumeAddress(AudioObjectPropertyElement element) {
+        return {kAudioDevicePropertyVolumeScalar, kAudioDevicePropertyScopeOutput, element};
+    }
+
+    static AudioObjectPropertyAddress defaultDeviceAddress() {
+        return {kAudioHardwarePropertyDefaultOutputDevice, kAudioObjectPropertyScopeGlobal, MAIN_ELEMENT};
+    }
+
+    static OSStatus onDefaultDeviceChanged(AudioObjectID, UInt32, const AudioObjectPropertyAddress*, void* userData) {
+        dispatch_async_f(static_cast<BackendState*>(userData)->queue, userData, bindDefaultDevice);
+        return noErr;
+    }
+
+    static OSStatus onVolumeChanged(AudioObjectID, UInt32, const AudioObjectPropertyAddress*, void* userData) {
+        dispatch_async_f(static_cast<BackendState*>(userData)->queue, userData, readVolume);
+        return noErr;
+    }
+
+    static void unbindDevice(void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        for (AudioObjectPropertyElement element : state->elements) {
+            const AudioObjectPropertyAddress address = volumeAddress(element);
+            AudioObjectRemovePropertyListener(state->device, &address, onVolumeChanged, state);
+        }
+        state->elements.clear();
+        state->device = kAudioObjectUnknown;
+        state->available.store(false, std::memory_order_release);
+    }
+
+    static void bindDefaultDevice(void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        unbindDevice(state);
+
+        const AudioObjectPropertyAddress address = defaultDeviceAddress();
+        AudioObjectID device = kAudioObjectUnknown;
+        UInt32 size = sizeof(device);
+        if (AudioObjectGetPropertyData(kAudioObjectSystemObject, &address, 0, nullptr, &size, &device) != noErr ||
+            device == kAudioObjectUnknown) {
+            state->volume.store(-1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Most devices have a main volume; some only have one per channel
+        state->device = device;
+        const AudioObjectPropertyElement candidates[] = {MAIN_ELEMENT, 1, 2};
+        for (AudioObjectPropertyElement element : candidates) {
+            const AudioObjectPropertyAddress volume = volumeAddress(element);
+            Boolean settable = false;
+            if (AudioObjectHasProperty(device, &volume) &&
+                AudioObjectIsPropertySettable(device, &volume, &settable) == noErr && settable) {
+                state->elements.push_back(element);
+                AudioObjectAddPropertyListener(device, &volume, onVolumeChanged, state);
+                if (element == MAIN_ELEMENT) {
+                    break;
+                }
+            }
+        }
+        state->available.store(!state->elements.empty(), std::memory_order_release);
+        readVolume(state);
+    }
+
+    static void readVolume(void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        if (state->target.load(std::memory_order_relaxed) >= 0) {
+            return;  // A write is queued; its own change event follows
+        }
+        Float32 loudest = -1.0f;
+        for (AudioObjectPropertyElement element : state->elements) {
+            const AudioObjectPropertyAddress address = volumeAddress(element);
+            Float32 scalar = 0.0f;
+            UInt32 size = sizeof(scalar);
+            if (AudioObjectGetPropertyData(state->device, &address, 0, nullptr, &size, &scalar) == noErr) {
+                loudest = std::max(loudest, scalar);
+            }
+        }
+        state->volume.store(loudest < 0.0f ? -1 : static_cast<int>(std::lround(loudest * 100.0f)),
+                            std::memory_order_relaxed);
+    }
+
+    static void writeVolume(void* userData) {
+        auto* state = static_cast<BackendState*>(userData);
+        const int level = state->target.exchange(-1, std::memory_order_relaxed);
+        if (level < 0) {
+            return;  // Already written by an earlier pass
+        }
+        const Float32 scalar = static_cast<Float32>(level) / 100.0f;
+        for (AudioObjectPropertyElement element : state->elements) {
+            const AudioObjectPropertyAddress address = volumeAddress(element);
+            AudioObjectSetPropertyData(state->device, &address, 0, nullptr, sizeof(scalar), &scalar);
+        }
+    }
+
+    static void noop(void*) {}
 #endif
-}
+};
 
-bool MacOSVolumeController::executeAppleScript(const std::string& script) {
+MacOSVolumeController::MacOSVolumeController() : _state(std::make_unique<BackendState>()) {
 #ifdef __APPLE__
-    std::string command = "osascript -e \"" + script + "\"";
-    int result = system(command.c_str());
-    if (result != 0) {
-        _lastError = "AppleScript command failed with exit code: " + std::to_string(result);
-        return false;
+    _state->queue = dispatch_queue_create("autovibez.volume", DISPATCH_QUEUE_SERIAL);
+    const AudioObjectPropertyAddress address = BackendState::defaultDeviceAddress();
+    AudioObjectAddPropertyListener(kAudioObjectSystemObject, &address, BackendState::onDefaultDeviceChanged,
+                                   _state.get());
+    dispatch_sync_f(_state->queue, _state.get(), BackendState::bindDefaultDevice);
+    if (!_state->available.load(std::memory_order_acquire)) {
+        _lastError = "Default output device has no settable volume";
     }
-    return true;
 #else
     _lastError = "macOS volume control not available on this platform";
-    return false;
 #endif
 }
 
-int MacOSVolumeController::getCurrentVolume() {
+MacOSVolumeController::~MacOSVolumeController() {
 #ifdef __APPLE__
-    std::string command = "osascript -e \"output volume of (get volume settings)\"";
-    FILE* pipe = popen(command.c_str(), "r");
-    if (!pipe) {
-        _lastError = "Failed to execute command";
-        return -1;
-    }
-
-    std::string output;
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
-    }
-    pclose(pipe);
-
-    return parseVolumeFromOutput(output);
-#else
-    _lastError = "macOS volume control not available on this platform";
-    return -1;
+    const AudioObjectPropertyAddress address = BackendState::defaultDeviceAddress();
+    AudioObjectRemovePropertyListener(kAudioObjectSystemObject, &address, BackendState::onDefaultDeviceChanged,
+                                      _state.get());
+    dispatch_sync_f(_state->queue, _state.get(), BackendState::unbindDevice);
+    // A listener already running may still have queued work; let it drain before the state goes
+    dispatch_sync_f(_state->queue, nullptr, BackendState::noop);
+    dispatch_release(_state->queue);
 #endif
 }
 
-int MacOSVolumeController::parseVolumeFromOutput(const std::string& output) {
-    try {
-        return std::stoi(output);
-    } catch (const std::exception&) {
-        _lastError = "Failed to parse volume from output";
+int MacOSVolumeController::getCurrentVolume() {
+    if (!isAvailable()) {
+        _lastError = "No output device with a volume control";
         return -1;
     }
+    return _state->volume.load(std::memory_order_relaxed);
 }
 
 bool MacOSVolumeController::setVolume(int volumeLevel) {
@@ -316,10 +626,19 @@ bool MacOSVolumeController::setVolume(int volumeLevel) {
         _lastError = "Volume level must be between 0 and 100";
         return false;
     }
+    if (!isAvailable()) {
+        _lastError = "No output device with a volume control";
+        return false;
+    }
 
-    std::string script = "set volume output volume " + std::to_string(volumeLevel);
-    return executeAppleScript(script);
+    // Steps queued faster than CoreAudio applies them collapse into the latest one
+    _state->volume.store(volumeLevel, std::memory_order_relaxed);
+    if (_state->target.exchange(volumeLevel, std::memory_order_relaxed) < 0) {
+        dispatch_async_f(_state->queue, _state.get(), BackendState::writeVolume);
+    }
+    return true;
 #else
+    (void)volumeLevel;
     _lastError = "macOS volume control not available on this platform";
     return false;
 #endif
@@ -330,7 +649,7 @@ bool MacOSVolumeController::increaseVolume(int step) {
     if (currentVolume == -1) {
         return false;
     }
-    return setVolume(std::min(100, currentVolume + step));
+    return setVolume(clampVolume(currentVolume + step));
 }
 
 bool MacOSVolumeController::decreaseVolume(int step) {
@@ -338,11 +657,11 @@ bool MacOSVolumeController::decreaseVolume(int step) {
     if (currentVolume == -1) {
         return false;
     }
-    return setVolume(std::max(0, currentVolume - step));
+    return setVolume(clampVolume(currentVolume - step));
 }
 
 bool MacOSVolumeController::isAvailable() {
-    return _available;
+    return _state->available.load(std::memory_order_acquire);
 }
 
 std::string MacOSVolumeController::getLastError() {
@@ -53,12 +53,19 @@ public:
 };
 
 /**
- * @brief Linux implementation using subprocess calls to amixer/pactl
+ * @brief Linux implementation over libpulse, or the ALSA mixer without a sound server
+ *
+ * Keeps one connection open and caches the default sink's level from its change
+ * events, so getCurrentVolume() is a load and changes return without waiting on the
+ * server. Without either library compiled in, the controller is never available.
  */
 class LinuxVolumeController : public ISystemVolumeController {
 public:
     LinuxVolumeController();
-    ~LinuxVolumeController() override = default;
+    ~LinuxVolumeController() override;
+
+    LinuxVolumeController(const LinuxVolumeController&) = delete;
+    LinuxVolumeController& operator=(const LinuxVolumeController&) = delete;
 
     int getCurrentVolume() override;
     bool setVolume(int volumeLevel) override;
@@ -68,15 +75,10 @@ public:
     std::string getLastError() override;
 
 private:
-    enum class AudioSystem { ALSA, PULSE_AUDIO, UNKNOWN };
-
-    AudioSystem detectAudioSystem();
-    bool executeCommand(const std::string& command);
-    int parseVolumeFromOutput(const std::string& output);
-
-    AudioSystem _audioSystem;
+    // Backend handles live in the translation unit so this header stays free of Pulse/ALSA types
+    struct BackendState;
+    std::unique_ptr<BackendState> _state;
     std::string _lastError;
-    bool _available;
 };
 
 /**
@@ -103,12 +105,18 @@ private:
 };
 
 /**
- * @brief macOS implementation using osascript subprocess calls
+ * @brief macOS implementation over CoreAudio
+ *
+ * Follows the default output device and caches its level from property listeners;
+ * changes are applied on a serial dispatch queue, the latest one winning.
  */
 class MacOSVolumeController : public ISystemVolumeController {
 public:
     MacOSVolumeController();
-    ~MacOSVolumeController() override = default;
+    ~MacOSVolumeController() override;
+
+    MacOSVolumeController(const MacOSVolumeController&) = delete;
+    MacOSVolumeController& operator=(const MacOSVolumeController&) = delete;
 
     int getCurrentVolume() override;
     bool setVolume(int volumeLevel) override;
@@ -118,11 +126,9 @@ public:
     std::string getLastError() override;
 
 private:
-    bool executeAppleScript(const std::string& script);
-    int parseVolumeFromOutput(const std::string& output);
-
+    struct BackendState;
+    std::unique_ptr<BackendState> _state;
     std::string _lastError;
-    bool _available;
 };
 
 /**
@@ -0,0 +1,125 @@
+#include "task_executor.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "constants.hpp"
+#include "trace_recorder.hpp"
+#include "utils/logger.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+// The executor and worker index of the calling thread, so a task's own posts stay on its worker
+thread_local const TaskExecutor* current_executor = nullptr;
+thread_local size_t current_worker = 0;
+}  // namespace
+
+TaskExecutor::TaskExecutor(size_t workers) {
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t count =
+        workers > 0 ? workers : std::max(cores, static_cast<size_t>(Constants::TASK_EXECUTOR_MIN_WORKERS));
+    _workers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // Started only once every queue exists, as a worker may steal from any of them
+    for (size_t i = 0; i < count; ++i) {
+        _workers[i]->thread = std::thread(&TaskExecutor::run, this, i);
+    }
+}
+
+TaskExecutor::~TaskExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (const std::unique_ptr<Worker>& worker : _workers) {
+        worker->thread.join();
+    }
+}
+
+TaskExecutor& TaskExecutor::shared() {
+    static TaskExecutor executor;
+    return executor;
+}
+
+void TaskExecutor::post(TaskPriority priority, Task task) {
+    const size_t index = current_executor == this
+                             ? current_worker
+                             : _nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+    Worker& worker = *_workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[static_cast<size_t>(priority)].push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    _wake.notify_one();
+}
+
+bool TaskExecutor::take(size_t index, Task& task) {
+    const size_t count = _workers.size();
+    for (size_t priority = 0; priority < PRIORITY_COUNT; ++priority) {
+        // Own queue oldest first, so one producer's tasks start in the order posted
+        {
+            Worker& own = *_workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            std::deque<Task>& queue = own.queues[priority];
+            if (!queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                return true;
+            }
+        }
+        // Steal from the other end, away from where the owner takes
+        for (size_t offset = 1; offset < count; ++offset) {
+            Worker& victim = *_workers[(index + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            std::deque<Task>& queue = victim.queues[priority];
+            if (!queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+                _steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskExecutor::run(size_t index) {
+    AUTOVIBEZ_TRACE_THREAD("executor");
+    current_executor = this;
+    current_worker = index;
+    while (true) {
+        Task task;
+        if (take(index, task)) {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            try {
+                task();
+            } catch (const std::exception& e) {
+                Logger logger;
+                logger.logError(std::string("Background task failed: ") + e.what());
+            } catch (...) {
+                Logger logger;
+                logger.logError("Background task failed");
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        if (_stopping && _queued.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        _wake.wait(lock, [this]() { return _stopping || _queued.load(std::memory_order_relaxed) > 0; });
+        if (_stopping && _queued.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+}  // namespace AutoVibez::Utils
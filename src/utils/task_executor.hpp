@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cancellation_token.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief Which background work a worker picks first; lower values run first
+ */
+enum class TaskPriority {
+    Interactive,  //!< Someone is waiting on it, e.g. reopening the audio device
+    Prefetch,     //!< Needed soon, e.g. the next mix
+    Ingest,       //!< Bulk imports and analysis
+    Maintenance   //!< Whenever nothing else is queued
+};
+
+/**
+ * @brief Fixed pool that runs the app's one-off background tasks
+ *
+ * Each worker keeps a queue per priority. A task posted from a worker goes on that
+ * worker's own queue; one posted from elsewhere is spread round robin. An idle worker
+ * takes the most urgent task it can find, first from its own queue and otherwise by
+ * stealing the newest entry of another worker's, so a burst of posts from one place
+ * still spreads over every core. The pool size follows the core count, not the
+ * number of tasks. Tasks are not preempted: a long Maintenance task holds its
+ * worker until it returns. Thread-safe.
+ */
+class TaskExecutor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param workers Number of worker threads, 0 for one per core (at least Constants::TASK_EXECUTOR_MIN_WORKERS)
+     */
+    explicit TaskExecutor(size_t workers = 0);
+
+    /**
+     * @brief Runs the tasks already queued, then joins the workers
+     */
+    ~TaskExecutor();
+
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    /**
+     * @brief The pool every subsystem shares
+     */
+    static TaskExecutor& shared();
+
+    /**
+     * @brief Queue a task; an exception it throws is logged and dropped
+     */
+    void post(TaskPriority priority, Task task);
+
+    /**
+     * @brief Queue a task that is skipped if the token is cancelled before a worker gets to it
+     */
+    void post(TaskPriority priority, Task task, CancellationToken token) {
+        post(priority, [task = std::move(task), token]() {
+            if (!token.isCancelled()) {
+                task();
+            }
+        });
+    }
+
+    /**
+     * @brief Queue a task and get its result, or the exception it threw, through a future
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(TaskPriority priority, F work) {
+        using Result = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(work));
+        std::future<Result> result = task->get_future();
+        post(priority, [task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Queue work, then queue then(result) at its own priority once the work returns
+     *
+     * The continuation is a separate task, so a slow one does not hold up the worker's
+     * other queued work, and an urgent follow-up can jump ahead of it.
+     */
+    template <typename F, typename C>
+    void postThen(TaskPriority priority, F work, TaskPriority thenPriority, C then) {
+        post(priority, [this, work = std::move(work), thenPriority, then = std::move(then)]() mutable {
+            if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
+                work();
+                post(thenPriority, std::move(then));
+            } else {
+                post(thenPriority, [then = std::move(then), result = work()]() mutable { then(std::move(result)); });
+            }
+        });
+    }
+
+    size_t getWorkerCount() const {
+        return _workers.size();
+    }
+
+    /**
+     * @brief Tasks queued and not yet started
+     */
+    size_t getQueuedCount() const {
+        return _queued.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Tasks a worker took from another worker's queue
+     */
+    uint64_t getStealCount() const {
+        return _steals.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t PRIORITY_COUNT = static_cast<size_t>(TaskPriority::Maintenance) + 1;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queues[PRIORITY_COUNT];
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    std::atomic<size_t> _queued{0};  // Raised under _sleepMutex so a worker about to sleep sees it
+    std::atomic<size_t> _nextWorker{0};
+    std::atomic<uint64_t> _steals{0};
+    bool _stopping = false;  // Guarded by _sleepMutex
+
+    void run(size_t index);
+    bool take(size_t index, Task& task);
+};
+
+}  // namespace AutoVibez::Utils
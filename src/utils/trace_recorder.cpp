@@ -0,0 +1,163 @@
+#include "trace_recorder.hpp"
+
+#include <fstream>
+
+#include "json_utils.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+
+std::atomic<uint64_t> nextRecorderId{1};
+
+struct CachedBuffer {
+    uint64_t recorder = 0;
+    void* buffer = nullptr;
+};
+
+thread_local CachedBuffer cachedBuffer;
+
+void writeEvent(std::ostream& out, const TraceEvent& event, int tid, bool& first) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\":\"" << JsonUtils::escapeJsonString(event.name ? event.name : "") << "\",\"cat\":\""
+        << JsonUtils::escapeJsonString(event.category ? event.category : "") << "\",\"ph\":\"" << event.phase
+        << "\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << (event.ns / 1000) << '.' << (event.ns % 1000 / 100);
+    if (event.phase == 'i') {
+        out << ",\"s\":\"t\"";
+    }
+    if (event.detail) {
+        out << ",\"args\":{\"detail\":\"" << JsonUtils::escapeJsonString(event.detail) << "\"}";
+    }
+    out << '}';
+}
+
+}  // namespace
+
+TraceRecorder::TraceRecorder(size_t events_per_thread)
+    : _id(nextRecorderId.fetch_add(1)), _events_per_thread(events_per_thread) {}
+
+TraceRecorder& TraceRecorder::instance() {
+    // Never destroyed, so threads still running at exit can keep recording
+    static TraceRecorder* recorder = new TraceRecorder();
+    return *recorder;
+}
+
+void TraceRecorder::begin(const char* category, const char* name, const char* detail) {
+    record(category, name, detail, 'B');
+}
+
+void TraceRecorder::end(const char* category, const char* name) {
+    record(category, name, nullptr, 'E');
+}
+
+void TraceRecorder::instant(const char* category, const char* name, const char* detail) {
+    record(category, name, detail, 'i');
+}
+
+void TraceRecorder::setThreadName(const char* name) {
+    local().name.store(intern(name), std::memory_order_release);
+}
+
+const char* TraceRecorder::intern(const std::string& text) {
+    if (text.empty()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Set nodes never move, so the pointer outlives later inserts
+    return _strings.insert(text).first->c_str();
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::local() {
+    if (cachedBuffer.recorder == _id) {
+        return *static_cast<ThreadBuffer*>(cachedBuffer.buffer);
+    }
+
+    // First event from this thread, or the thread last recorded to another recorder
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(_mutex);
+    ThreadBuffer* found = nullptr;
+    for (const auto& buffer : _buffers) {
+        if (buffer->owner == self) {
+            found = buffer.get();
+            break;
+        }
+    }
+    if (!found) {
+        _buffers.push_back(std::make_unique<ThreadBuffer>(_events_per_thread, static_cast<int>(_buffers.size()) + 1));
+        found = _buffers.back().get();
+        found->owner = self;
+    }
+    cachedBuffer = {_id, found};
+    return *found;
+}
+
+void TraceRecorder::record(const char* category, const char* name, const char* detail, char phase) {
+    const int64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _created).count();
+    ThreadBuffer& buffer = local();
+    // Only this thread writes the count, so a relaxed read of it is current
+    const size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= buffer.events.size()) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = {category, name, detail, ns, phase};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::writeJson(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : _buffers) {
+        const char* name = buffer->name.load(std::memory_order_acquire);
+        if (name) {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"" << JsonUtils::escapeJsonString(name) << "\"}}";
+            first = false;
+        }
+        // Events past this count may be mid-write; they make the next dump
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            writeEvent(out, buffer->events[i], buffer->tid, first);
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool TraceRecorder::writeJson(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        setError("Cannot write trace to " + path);
+        return false;
+    }
+    writeJson(out);
+    out.flush();
+    if (!out) {
+        setError("Failed writing trace to " + path);
+        return false;
+    }
+    setSuccess(true);
+    return true;
+}
+
+size_t TraceRecorder::getEventCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t total = 0;
+    for (const auto& buffer : _buffers) {
+        total += buffer->count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+uint64_t TraceRecorder::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint64_t total = 0;
+    for (const auto& buffer : _buffers) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "constants.hpp"
+#include "error_handler.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief One begin, end or instant mark
+ */
+struct TraceEvent {
+    const char* category = nullptr;  // Literal or interned, so recording never copies a string
+    const char* name = nullptr;      // Likewise
+    const char* detail = nullptr;    // Shown as the event's argument; null for none
+    int64_t ns = 0;                  // Since the recorder was created
+    char phase = 'B';                // 'B'egin, 'E'nd or 'i'nstant, as the trace format spells them
+};
+
+/**
+ * @brief Startup and lifecycle events, written out in the Chrome trace format (chrome://tracing, Perfetto)
+ *
+ * Each thread appends to a fixed-size buffer of its own, which only it writes and
+ * publishes with one release store per event, so recording takes no lock once a
+ * thread's buffer exists. A full buffer drops that thread's later events and counts
+ * them. Buffers stay with the recorder when their thread ends, so a dump still shows
+ * the startup pool and finished downloads. Instrument code through the
+ * AUTOVIBEZ_TRACE_* macros below, which compile to nothing without AUTOVIBEZ_TRACING.
+ */
+class TraceRecorder : public ErrorHandler {
+public:
+    explicit TraceRecorder(size_t events_per_thread = Constants::TRACE_EVENTS_PER_THREAD);
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * @brief The recorder the macros write to
+     */
+    static TraceRecorder& instance();
+
+    void begin(const char* category, const char* name, const char* detail = nullptr);
+    void end(const char* category, const char* name);
+    void instant(const char* category, const char* name, const char* detail = nullptr);
+
+    /**
+     * @brief Label the calling thread's row in the trace
+     */
+    void setThreadName(const char* name);
+
+    /**
+     * @brief A copy of text that lives as long as the recorder, for names and details built at run time
+     * @return Null for empty text, so an empty detail adds no argument
+     */
+    const char* intern(const std::string& text);
+
+    /**
+     * @brief Write every event recorded so far as a trace JSON object; safe while threads keep recording
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * @brief Write the trace to a file
+     * @return True on success; the error is available from getLastError() otherwise
+     */
+    bool writeJson(const std::string& path);
+
+    size_t getEventCount() const;
+    uint64_t getDroppedCount() const;
+
+private:
+    struct ThreadBuffer {
+        explicit ThreadBuffer(size_t capacity, int tid) : events(capacity), tid(tid) {}
+
+        std::vector<TraceEvent> events;
+        std::atomic<size_t> count{0};  // Events the owning thread has published
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> dropped{0};
+        std::thread::id owner;
+        int tid;  // Row in the trace, numbered in the order threads first recorded
+    };
+
+    const uint64_t _id;  // Tells a thread's cached buffer of this recorder from one of an earlier recorder
+    const size_t _events_per_thread;
+    const std::chrono::steady_clock::time_point _created = std::chrono::steady_clock::now();
+
+    mutable std::mutex _mutex;  // Guards the two containers below, not the events
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+    std::unordered_set<std::string> _strings;
+
+    ThreadBuffer& local();
+    void record(const char* category, const char* name, const char* detail, char phase);
+};
+
+/**
+ * @brief Begin event now, end event when the scope exits
+ */
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, const char* detail = nullptr)
+        : _category(category), _name(name) {
+        TraceRecorder::instance().begin(category, name, detail);
+    }
+
+    ~TraceScope() {
+        TraceRecorder::instance().end(_category, _name);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* _category;
+    const char* _name;
+};
+
+}  // namespace AutoVibez::Utils
+
+#ifdef AUTOVIBEZ_TRACING
+#define AUTOVIBEZ_TRACE_JOIN_(a, b) a##b
+#define AUTOVIBEZ_TRACE_JOIN(a, b) AUTOVIBEZ_TRACE_JOIN_(a, b)
+// Detail, where given, is a std::string and is only evaluated when tracing is compiled in
+#define AUTOVIBEZ_TRACE_SCOPE(category, name) \
+    ::AutoVibez::Utils::TraceScope AUTOVIBEZ_TRACE_JOIN(trace_scope_, __LINE__)(category, name)
+#define AUTOVIBEZ_TRACE_SCOPE_DETAIL(category, name, detail)                    \
+    ::AutoVibez::Utils::TraceScope AUTOVIBEZ_TRACE_JOIN(trace_scope_, __LINE__)( \
+        category, name, ::AutoVibez::Utils::TraceRecorder::instance().intern(detail))
+#define AUTOVIBEZ_TRACE_INSTANT(category, name, detail)    \
+    ::AutoVibez::Utils::TraceRecorder::instance().instant( \
+        category, name, ::AutoVibez::Utils::TraceRecorder::instance().intern(detail))
+#define AUTOVIBEZ_TRACE_THREAD(name) ::AutoVibez::Utils::TraceRecorder::instance().setThreadName(name)
+#else
+#define AUTOVIBEZ_TRACE_SCOPE(category, name) ((void)0)
+#define AUTOVIBEZ_TRACE_SCOPE_DETAIL(category, name, detail) ((void)0)
+#define AUTOVIBEZ_TRACE_INSTANT(category, name, detail) ((void)0)
+#define AUTOVIBEZ_TRACE_THREAD(name) ((void)0)
+#endif
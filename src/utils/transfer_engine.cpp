@@ -0,0 +1,356 @@
+#include "transfer_engine.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <future>
+
+#include "constants.hpp"
+#include "trace_recorder.hpp"
+
+namespace AutoVibez::Utils {
+
+namespace {
+constexpr int POLL_TIMEOUT_MS = 1000;  // Longest wait for socket activity; wakeups cut it short
+
+std::once_flag curl_initialized;
+}  // namespace
+
+TransferEngine::TransferEngine() {
+    // Reference counted by libcurl, but the first call is not thread-safe on older versions
+    std::call_once(curl_initialized, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    _multi = curl_multi_init();
+    curl_multi_setopt(_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+    // Only the loop thread uses the easy handles, so the share needs no lock callbacks
+    _share = curl_share_init();
+    curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+
+    _thread = std::thread(&TransferEngine::run, this);
+}
+
+TransferEngine::~TransferEngine() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    curl_multi_wakeup(_multi);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    curl_multi_cleanup(_multi);
+    curl_share_cleanup(_share);
+}
+
+TransferEngine& TransferEngine::shared() {
+    static TransferEngine engine;
+    return engine;
+}
+
+uint64_t TransferEngine::start(TransferRequest request, Completion done) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->done = std::move(done);
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_stopping) {
+            id = _next_id++;
+            transfer->id = id;
+            _live.insert(id);
+            _pending.push_back(std::move(transfer));
+        }
+    }
+    if (id == 0) {
+        TransferResult result;
+        result.error = "Transfer engine stopped";
+        if (transfer->done) {
+            transfer->done(result);
+        }
+        return 0;
+    }
+    curl_multi_wakeup(_multi);
+    return id;
+}
+
+TransferResult TransferEngine::perform(TransferRequest request) {
+    std::promise<TransferResult> promise;
+    std::future<TransferResult> result = promise.get_future();
+    start(std::move(request), [&promise](const TransferResult& finished) { promise.set_value(finished); });
+    return result.get();
+}
+
+bool TransferEngine::cancel(uint64_t id) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_live.count(id)) {
+            return false;
+        }
+        _cancelled.push_back(id);
+    }
+    curl_multi_wakeup(_multi);
+    return true;
+}
+
+size_t TransferEngine::getActiveCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _live.size();
+}
+
+void TransferEngine::run() {
+    AUTOVIBEZ_TRACE_THREAD("transfers");
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stopping) {
+                break;
+            }
+        }
+        addPending();
+        removeCancelled();
+
+        int still_running = 0;
+        curl_multi_perform(_multi, &still_running);
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(_multi, &queued)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            const CURLcode code = message->data.result;
+            Transfer* done = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &done);
+            curl_multi_remove_handle(_multi, message->easy_handle);
+            auto node = _running.extract(done->id);
+            finish(std::move(node.mapped()), code);
+        }
+
+        curl_multi_poll(_multi, nullptr, 0, governTransfers(), nullptr);
+    }
+
+    // Stopping: whatever is still in flight ends with an error
+    addPending();
+    for (auto& running : _running) {
+        curl_multi_remove_handle(_multi, running.second->easy);
+        running.second->cancelled = true;
+        finish(std::move(running.second), CURLE_ABORTED_BY_CALLBACK);
+    }
+    _running.clear();
+}
+
+void TransferEngine::addPending() {
+    std::vector<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pending.swap(_pending);
+    }
+    for (auto& transfer : pending) {
+        if (!configure(*transfer)) {
+            finish(std::move(transfer), CURLE_FAILED_INIT);
+            continue;
+        }
+        curl_multi_add_handle(_multi, transfer->easy);
+        const uint64_t id = transfer->id;
+        _running.emplace(id, std::move(transfer));
+    }
+}
+
+void TransferEngine::removeCancelled() {
+    std::vector<uint64_t> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        cancelled.swap(_cancelled);
+    }
+    for (uint64_t id : cancelled) {
+        auto it = _running.find(id);
+        if (it == _running.end()) {
+            continue;  // Completed in the meantime
+        }
+        curl_multi_remove_handle(_multi, it->second->easy);
+        it->second->cancelled = true;
+        finish(std::move(it->second), CURLE_ABORTED_BY_CALLBACK);
+        _running.erase(it);
+    }
+}
+
+int TransferEngine::governTransfers() {
+    int wait_ms = POLL_TIMEOUT_MS;
+    for (auto& running : _running) {
+        Transfer& transfer = *running.second;
+        const std::shared_ptr<BandwidthGovernor>& governor = transfer.request.governor;
+        if (!governor) {
+            continue;
+        }
+        const bool uncapped = transfer.request.uncapped && transfer.request.uncapped();
+
+        // One transfer alone is held to the ceiling by curl; the bucket holds them all to it together
+        const int64_t ceiling = uncapped ? 0 : governor->getCeiling();
+        if (ceiling != transfer.applied_ceiling) {
+            curl_easy_setopt(transfer.easy, CURLOPT_MAX_RECV_SPEED_LARGE, static_cast<curl_off_t>(ceiling));
+            transfer.applied_ceiling = ceiling;
+        }
+
+        if (!transfer.paused) {
+            continue;
+        }
+        const auto wait = uncapped ? std::chrono::milliseconds(0) : governor->timeUntilAvailable();
+        if (wait.count() > 0) {
+            wait_ms = std::min<int>(wait_ms, static_cast<int>(wait.count()));
+            continue;
+        }
+        // Delivers the held chunk at once, through writeCallback, which may pause it again
+        transfer.paused = false;
+        curl_easy_pause(transfer.easy, CURLPAUSE_CONT);
+        if (transfer.paused) {
+            wait_ms = std::min<int>(wait_ms, static_cast<int>(governor->timeUntilAvailable().count()));
+        }
+    }
+    return wait_ms;
+}
+
+void TransferEngine::finish(std::unique_ptr<Transfer> transfer, CURLcode code) {
+    TransferResult result;
+    result.ok = code == CURLE_OK;
+    result.code = code;
+    const bool created = transfer->easy != nullptr;
+    if (created) {
+        curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &result.response_code);
+        curl_easy_cleanup(transfer->easy);
+        transfer->easy = nullptr;
+    }
+    curl_slist_free_all(transfer->headers);
+    transfer->headers = nullptr;
+    if (transfer->cancelled) {
+        result.error = "Transfer cancelled";
+    } else if (!created) {
+        result.error = StringConstants::CURL_INIT_ERROR;
+    } else if (!result.ok) {
+        result.error = curl_easy_strerror(code);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _live.erase(transfer->id);
+    }
+    if (transfer->done) {
+        transfer->done(result);
+    }
+}
+
+bool TransferEngine::configure(Transfer& transfer) {
+    transfer.easy = curl_easy_init();
+    if (!transfer.easy) {
+        return false;
+    }
+    CURL* easy = transfer.easy;
+    const TransferRequest& request = transfer.request;
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, &transfer);
+    curl_easy_setopt(easy, CURLOPT_SHARE, _share);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &TransferEngine::writeCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(easy, CURLOPT_XFERINFOFUNCTION, &TransferEngine::progressCallback);
+    curl_easy_setopt(easy, CURLOPT_XFERINFODATA, &transfer);
+
+    // HTTP/2 where TLS negotiates it. Over TLS the handshake tells whether a connection
+    // multiplexes, so waiting for a stream on it beats opening another; over plain HTTP only
+    // the response would, and waiting would run one transfer per host at a time.
+    curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    if (request.url.rfind("https://", 0) == 0) {
+        curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    }
+
+    if (request.timeout_seconds > 0) {
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT, request.timeout_seconds);
+    }
+    if (request.connect_timeout_seconds > 0) {
+        curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT, request.connect_timeout_seconds);
+    }
+    if (request.low_speed_limit > 0 && request.low_speed_seconds > 0) {
+        curl_easy_setopt(easy, CURLOPT_LOW_SPEED_LIMIT, request.low_speed_limit);
+        curl_easy_setopt(easy, CURLOPT_LOW_SPEED_TIME, request.low_speed_seconds);
+    }
+    if (!request.user_agent.empty()) {
+        curl_easy_setopt(easy, CURLOPT_USERAGENT, request.user_agent.c_str());
+    }
+    for (const std::string& header : request.headers) {
+        transfer.headers = curl_slist_append(transfer.headers, header.c_str());
+    }
+    if (transfer.headers) {
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer.headers);
+    }
+    if (!request.range.empty()) {
+        curl_easy_setopt(easy, CURLOPT_RANGE, request.range.c_str());
+    }
+    if (request.resume_from > 0) {
+        curl_easy_setopt(easy, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(request.resume_from));
+    }
+    if (request.fail_on_http_error) {
+        curl_easy_setopt(easy, CURLOPT_FAILONERROR, 1L);
+    }
+    if (!request.body.empty()) {
+        // The request lives in the transfer, so curl may read the body in place
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.data());
+    }
+    if (request.decode_response) {
+        curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+    }
+    if (request.on_header) {
+        curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &TransferEngine::headerCallback);
+        curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer);
+    }
+    return true;
+}
+
+size_t TransferEngine::writeCallback(char* data, size_t size, size_t nmemb, void* userdata) {
+    auto* transfer = static_cast<Transfer*>(userdata);
+    const size_t bytes = size * nmemb;
+    const TransferRequest& request = transfer->request;
+    if (request.governor && !(request.uncapped && request.uncapped()) &&
+        !request.governor->tryConsume(static_cast<int64_t>(bytes))) {
+        transfer->paused = true;
+        return CURL_WRITEFUNC_PAUSE;  // curl keeps the chunk and hands it over again once resumed
+    }
+    if (transfer->request.on_data && !transfer->request.on_data(data, bytes)) {
+        return 0;  // Fewer bytes than offered aborts with CURLE_WRITE_ERROR
+    }
+    return bytes;
+}
+
+size_t TransferEngine::headerCallback(char* data, size_t size, size_t nmemb, void* userdata) {
+    auto* transfer = static_cast<Transfer*>(userdata);
+    const size_t bytes = size * nmemb;
+    const std::string line(data, bytes);
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+        return bytes;  // Status line or the blank line ending the headers
+    }
+
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    const size_t value_start = line.find_first_not_of(" \t", colon + 1);
+    const size_t value_end = line.find_last_not_of(" \t\r\n");
+    const std::string value = value_start == std::string::npos || value_end < value_start
+                                  ? std::string()
+                                  : line.substr(value_start, value_end - value_start + 1);
+    transfer->request.on_header(name, value);
+    return bytes;
+}
+
+int TransferEngine::progressCallback(void* userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                                     curl_off_t ulnow) {
+    (void)ultotal, (void)ulnow;
+    auto* transfer = static_cast<Transfer*>(userdata);
+    if (!transfer->request.on_progress) {
+        return 0;
+    }
+    const bool keep_going =
+        transfer->request.on_progress(static_cast<int64_t>(dlnow), dltotal > 0 ? static_cast<int64_t>(dltotal) : -1);
+    return keep_going ? 0 : 1;
+}
+
+}  // namespace AutoVibez::Utils
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "bandwidth_governor.hpp"
+
+namespace AutoVibez::Utils {
+
+/**
+ * @brief One transfer for TransferEngine; callbacks run on the engine thread
+ */
+struct TransferRequest {
+    std::string url;
+    long timeout_seconds = 0;          //!< Whole transfer, 0 for no limit
+    long connect_timeout_seconds = 0;  //!< 0 for curl's default
+    long low_speed_limit = 0;          //!< Bytes per second; slower than this for low_speed_seconds aborts
+    long low_speed_seconds = 0;
+    std::string user_agent;
+    std::vector<std::string> headers;  //!< Extra request headers, "Name: value"
+    std::string range;                 //!< Bytes to ask for, "first-last"; a server without ranges sends them all
+    int64_t resume_from = 0;           //!< Ask for the body from this offset; a server that can't fails the transfer
+    bool fail_on_http_error = false;   //!< An HTTP status of 400 or more fails the transfer before any body arrives
+    std::string body;                  //!< Sent as a POST when not empty; set its Content-Type among the headers
+    bool decode_response = false;      //!< Offer every encoding curl decodes; on_data then sees the decoded body
+
+    /**
+     * @brief Receive through this governor's shared ceiling, also set per handle as CURLOPT_MAX_RECV_SPEED_LARGE
+     */
+    std::shared_ptr<BandwidthGovernor> governor;
+
+    /**
+     * @brief Asked per chunk of a governed transfer; true lets it past the ceiling, e.g. once playback needs it
+     */
+    std::function<bool()> uncapped;
+
+    /**
+     * @brief Each response header, name lowercased; headers of redirects are reported too
+     */
+    std::function<void(const std::string& name, const std::string& value)> on_header;
+
+    /**
+     * @brief Each chunk as it arrives; return false to abort the transfer
+     */
+    std::function<bool(const char* data, size_t size)> on_data;
+
+    /**
+     * @brief Bytes received and the content length (-1 until known); return false to abort
+     */
+    std::function<bool(int64_t received, int64_t total)> on_progress;
+};
+
+/**
+ * @brief How a transfer ended
+ */
+struct TransferResult {
+    bool ok = false;
+    CURLcode code = CURLE_OK;  //!< CURLE_RANGE_ERROR when resume_from was refused
+    long response_code = 0;    //!< HTTP status, 0 for other protocols or no response
+    std::string error;         //!< Empty when ok
+};
+
+/**
+ * @brief Every HTTP transfer of the app, multiplexed on one curl_multi event loop
+ *
+ * One thread drives all transfers, so there is a single connection cache: a
+ * second file from the same server reuses the warm connection instead of paying
+ * DNS, TCP and TLS setup again, and an HTTP/2 server carries concurrent
+ * transfers as streams of one connection. A share handle also keeps DNS results
+ * and TLS sessions for the handles that outlive a connection. curl_global_init
+ * runs once, when the first engine is made.
+ *
+ * Callbacks run on the engine thread and should only do short work (a write to
+ * a file, a notify); a slow callback stalls every transfer in flight. Thread-safe.
+ */
+class TransferEngine {
+public:
+    using Completion = std::function<void(const TransferResult& result)>;
+
+    TransferEngine();
+
+    /**
+     * @brief Aborts transfers still in flight (their completions see an error) and joins the loop
+     */
+    ~TransferEngine();
+
+    TransferEngine(const TransferEngine&) = delete;
+    TransferEngine& operator=(const TransferEngine&) = delete;
+
+    /**
+     * @brief The engine the downloader and the manifest loader share
+     */
+    static TransferEngine& shared();
+
+    /**
+     * @brief Start a transfer
+     * @param done Called once on the engine thread when the transfer ends, however it ends
+     * @return Id for cancel(); 0 if the engine is stopping, after done has seen the error
+     */
+    uint64_t start(TransferRequest request, Completion done);
+
+    /**
+     * @brief Start a transfer and wait for it on the calling thread (never the engine thread)
+     */
+    TransferResult perform(TransferRequest request);
+
+    /**
+     * @brief Abort a transfer; its completion still runs, with an error
+     * @return False if the transfer already ended
+     */
+    bool cancel(uint64_t id);
+
+    /**
+     * @brief Transfers started and not yet completed
+     */
+    size_t getActiveCount() const;
+
+private:
+    struct Transfer {
+        uint64_t id = 0;
+        TransferRequest request;
+        Completion done;
+        CURL* easy = nullptr;
+        curl_slist* headers = nullptr;
+        bool cancelled = false;
+        bool paused = false;           // The governor's bucket was empty when its last chunk came
+        int64_t applied_ceiling = -1;  // CURLOPT_MAX_RECV_SPEED_LARGE as last set
+    };
+
+    CURLM* _multi = nullptr;
+    CURLSH* _share = nullptr;
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<Transfer>> _pending;  // Started, not yet on the multi handle
+    std::vector<uint64_t> _cancelled;
+    std::unordered_set<uint64_t> _live;                      // Started and not completed
+    std::map<uint64_t, std::unique_ptr<Transfer>> _running;  // On the multi handle; the loop thread's alone
+    uint64_t _next_id = 1;
+    bool _stopping = false;
+    std::thread _thread;
+
+    void run();
+    void addPending();
+    void removeCancelled();
+
+    /**
+     * @brief Follow ceiling changes and resume paused transfers the bucket has room for
+     * @return Milliseconds to poll for: until a paused transfer may resume, capped at the usual timeout
+     */
+    int governTransfers();
+    void finish(std::unique_ptr<Transfer> transfer, CURLcode code);
+    bool configure(Transfer& transfer);
+
+    static size_t writeCallback(char* data, size_t size, size_t nmemb, void* userdata);
+    static size_t headerCallback(char* data, size_t size, size_t nmemb, void* userdata);
+    static int progressCallback(void* userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                                curl_off_t ulnow);
+};
+
+}  // namespace AutoVibez::Utils
@@ -1,46 +1,91 @@
 #include "uuid_utils.hpp"
 
-#include <iomanip>
-#include <sstream>
-
 #include "constants.hpp"
+#include "content_hash.hpp"
 
 namespace AutoVibez {
 namespace Utils {
 
-std::string HashIdUtils::generateIdFromUrl(const std::string& url) {
-    // Generate a deterministic hash-based ID from URL
-    std::hash<std::string> hasher;
-    size_t hash = hasher(url);
-    return generateIdFromHash(hash);
-}
+namespace {
+const char HEX_DIGITS[] = "0123456789abcdef";
 
-std::string HashIdUtils::generateIdFromHash(size_t hash) {
-    // Use the hash to generate a deterministic hash-based ID in UUID format
-    unsigned char id_bytes[Constants::UUID_BYTE_LENGTH];
+// Two XXH64 lanes with unrelated seeds make up the 128 bits
+constexpr uint64_t URL_HASH_SEED_HIGH = 0;
+constexpr uint64_t URL_HASH_SEED_LOW = 0x9E3779B97F4A7C15ULL;
 
-    // Use first 16 bytes of hash (or repeat if shorter)
-    for (int i = 0; i < Constants::UUID_BYTE_LENGTH; i++) {
-        id_bytes[i] = (hash >> (i % 8 * 8)) & 0xFF;
-    }
+bool isHyphenAt(size_t position) {
+    return position == 8 || position == 13 || position == 18 || position == 23;
+}
 
-    // Set version (5) and variant bits for deterministic ID
-    id_bytes[6] = (id_bytes[6] & Constants::UUID_VERSION_MASK) | Constants::UUID_VERSION_5;  // Version 5
-    id_bytes[8] = (id_bytes[8] & Constants::UUID_VARIANT_MASK) | Constants::UUID_VARIANT_1;  // Variant 1
+int lowerHexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+}  // namespace
 
-    // Convert to UUID string format
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
+bool HashId::parse(std::string_view text, HashId& id) {
+    if (text.size() != TEXT_LENGTH) {
+        return false;
+    }
+    size_t byte = 0;
+    for (size_t i = 0; i < TEXT_LENGTH; i += 2) {
+        if (isHyphenAt(i)) {
+            if (text[i] != '-') {
+                return false;
+            }
+            ++i;
+        }
+        const int high = lowerHexValue(text[i]);
+        const int low = lowerHexValue(text[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        id.bytes[byte++] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
 
+void HashId::format(char* out) const {
     for (int i = 0; i < Constants::UUID_BYTE_LENGTH; i++) {
         if (i == Constants::UUID_POSITION_1 || i == Constants::UUID_POSITION_2 || i == Constants::UUID_POSITION_3 ||
             i == Constants::UUID_POSITION_4) {
-            ss << "-";
+            *out++ = '-';
         }
-        ss << std::setw(2) << static_cast<int>(id_bytes[i]);
+        *out++ = HEX_DIGITS[bytes[i] >> 4];
+        *out++ = HEX_DIGITS[bytes[i] & 0xF];
     }
+}
+
+std::string HashId::toString() const {
+    std::string text(TEXT_LENGTH, '\0');
+    format(text.data());
+    return text;
+}
+
+HashId HashIdUtils::hashUrl(std::string_view url) {
+    const uint64_t high = ContentHasher::hash(url.data(), url.size(), URL_HASH_SEED_HIGH);
+    const uint64_t low = ContentHasher::hash(url.data(), url.size(), URL_HASH_SEED_LOW);
 
-    return ss.str();
+    // Big-endian, so the bytes and their text sort alike on every platform
+    HashId id;
+    for (int i = 0; i < 8; i++) {
+        id.bytes[i] = static_cast<uint8_t>(high >> (56 - i * 8));
+        id.bytes[i + 8] = static_cast<uint8_t>(low >> (56 - i * 8));
+    }
+
+    // Set version (5) and variant bits, so the text still reads as a UUID
+    id.bytes[6] = (id.bytes[6] & Constants::UUID_VERSION_MASK) | Constants::UUID_VERSION_5;
+    id.bytes[8] = (id.bytes[8] & Constants::UUID_VARIANT_MASK) | Constants::UUID_VARIANT_1;
+    return id;
+}
+
+std::string HashIdUtils::generateIdFromUrl(const std::string& url) {
+    return hashUrl(url).toString();
 }
 
 }  // namespace Utils
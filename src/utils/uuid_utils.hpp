@@ -1,28 +1,75 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace AutoVibez::Utils {
 
+/**
+ * @brief A 128-bit id, as the database stores it
+ *
+ * The rest of the app passes ids around as their UUID-form text; this is the
+ * 16-byte key that text stands for, and format() is only for display.
+ */
+struct HashId {
+    static constexpr size_t BYTE_LENGTH = 16;
+    static constexpr size_t TEXT_LENGTH = 36;  // xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+
+    std::array<uint8_t, BYTE_LENGTH> bytes{};
+
+    /**
+     * @brief Read the text format() writes: lowercase hex with hyphens
+     *
+     * Nothing else is accepted, so a parsed id always formats back to the same text.
+     * @return False if text is not in that form
+     */
+    static bool parse(std::string_view text, HashId& id);
+
+    /**
+     * @brief Write the UUID-form text
+     * @param out Room for TEXT_LENGTH characters; no terminator is written
+     */
+    void format(char* out) const;
+
+    std::string toString() const;
+
+    /**
+     * @brief The raw bytes, e.g. for a BLOB column
+     */
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    bool operator==(const HashId& other) const {
+        return bytes == other.bytes;
+    }
+    bool operator!=(const HashId& other) const {
+        return bytes != other.bytes;
+    }
+    bool operator<(const HashId& other) const {
+        return bytes < other.bytes;
+    }
+};
+
 /**
  * @brief Utility functions for generating deterministic hash-based IDs
  */
 class HashIdUtils {
 public:
     /**
-     * @brief Generate a deterministic hash-based ID from a URL
-     * @param url The URL to generate ID from
-     * @return Deterministic hash-based ID string in UUID format
+     * @brief 128-bit hash of a URL, the same on every platform and standard library
      */
-    static std::string generateIdFromUrl(const std::string& url);
+    static HashId hashUrl(std::string_view url);
 
-private:
     /**
-     * @brief Generate a deterministic hash-based ID from a hash value
-     * @param hash The hash value to generate ID from
+     * @brief Generate a deterministic hash-based ID from a URL
+     * @param url The URL to generate ID from
      * @return Deterministic hash-based ID string in UUID format
      */
-    static std::string generateIdFromHash(size_t hash);
+    static std::string generateIdFromUrl(const std::string& url);
 };
 
 }  // namespace AutoVibez::Utils
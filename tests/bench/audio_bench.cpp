@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "audio/mp3_analyzer.hpp"
+#include "audio/mp3_decoder.hpp"
+#include "bench_fixtures.hpp"
+
+// Tag and duration read from a freshly written file of state.range(0) frames
+static void BM_AnalyzeFile(benchmark::State& state) {
+    const int frames = static_cast<int>(state.range(0));
+    const std::string path = AutoVibez::Bench::writeMp3("analyze_" + std::to_string(frames) + ".mp3", frames);
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer.analyzeFile(path));
+    }
+}
+BENCHMARK(BM_AnalyzeFile)->Arg(100)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Full decode on one libmpg123 synth; realtime_factor is seconds of audio per second of decoding
+static void BM_DecodeSynth(benchmark::State& state, const std::string& synth) {
+    const std::string path = AutoVibez::Bench::writeMp3("decode.mp3", 2000);  // About 52 s
+    constexpr int outputRate = 44100;
+    constexpr int chunkFrames = 4096;
+    std::vector<int16_t> buffer(chunkFrames * 2);
+    double decodedSeconds = 0.0;
+    for (auto _ : state) {
+        AutoVibez::Audio::Mp3Decoder decoder(synth);
+        if (!decoder.open(path, outputRate)) {
+            state.SkipWithError(decoder.getLastError().c_str());
+            break;
+        }
+        int64_t frames = 0;
+        for (int read = 0; (read = decoder.read(buffer.data(), chunkFrames)) > 0;) {
+            frames += read;
+        }
+        decodedSeconds += static_cast<double>(frames) / outputRate;
+    }
+    state.counters["realtime_factor"] = benchmark::Counter(decodedSeconds, benchmark::Counter::kIsRate);
+}
+
+// One benchmark per synth this libmpg123 build runs here, e.g. BM_DecodeSynth/AVX
+static const bool decodeSynthsRegistered = [] {
+    for (const std::string& synth : AutoVibez::Audio::Mp3Decoder::getSupportedSynths()) {
+        benchmark::RegisterBenchmark(("BM_DecodeSynth/" + synth).c_str(), BM_DecodeSynth, synth)
+            ->Unit(benchmark::kMillisecond);
+    }
+    return true;
+}();
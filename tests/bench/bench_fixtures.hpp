@@ -0,0 +1,59 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "data/mix_metadata.hpp"
+
+namespace AutoVibez::Bench {
+
+/**
+ * @brief A path in the benchmarks' scratch directory, which is created on first use
+ */
+inline std::string scratchPath(const std::string& name) {
+    static const std::filesystem::path directory = []() {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "autovibez_bench";
+        std::filesystem::create_directories(path);
+        return path;
+    }();
+    return (directory / name).string();
+}
+
+/**
+ * @brief Catalog-like mix: a few dozen artists, two genres, a short description
+ */
+inline Data::Mix makeMix(int index) {
+    Data::Mix mix;
+    mix.id = "bench-" + std::to_string(index);
+    mix.title = "Benchmark mix " + std::to_string(index);
+    mix.artist = "Artist " + std::to_string(index % 50);
+    mix.genre = index % 2 ? "Techno" : "House";
+    mix.url = "https://example.com/" + mix.id + ".mp3";
+    mix.local_path = "/bench/" + mix.id + ".mp3";
+    mix.duration_seconds = 3600;
+    mix.tags = {"bench", "tag"};
+    mix.description = "deep warehouse session " + std::to_string(index % 97);
+    return mix;
+}
+
+/**
+ * @brief Write an MPEG-1 Layer III file of silent 128 kbps, 44.1 kHz frames behind a small ID3v2 tag
+ */
+inline std::string writeMp3(const std::string& name, int frames) {
+    const std::string path = scratchPath(name);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const unsigned char tag[10] = {'I', 'D', '3', 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    file.write(reinterpret_cast<const char*>(tag), sizeof(tag));
+    std::string frame(417, '\0');  // 144 * 128000 / 44100 bytes, unpadded
+    frame[0] = static_cast<char>(0xFF);
+    frame[1] = static_cast<char>(0xFB);
+    frame[2] = static_cast<char>(0x90);
+    frame[3] = static_cast<char>(0x44);
+    for (int i = 0; i < frames; ++i) {
+        file.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    }
+    return path;
+}
+
+}  // namespace AutoVibez::Bench
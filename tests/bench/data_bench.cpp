@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_fixtures.hpp"
+#include "data/mix_database.hpp"
+#include "data/mix_downloader.hpp"
+#include "data/mix_query_builder.hpp"
+#include "data/mix_row_mapper.hpp"
+#include "data/sqlite_connection.hpp"
+
+using AutoVibez::Bench::makeMix;
+using AutoVibez::Bench::scratchPath;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Data::MixQueryBuilder;
+using AutoVibez::Data::MixRowMapper;
+using AutoVibez::Data::OrderBy;
+using AutoVibez::Data::SelectionCriteria;
+using AutoVibez::Data::SqliteConnection;
+
+namespace {
+std::string libraryPath(int mixes) {
+    return scratchPath("library_" + std::to_string(mixes) + ".db");
+}
+
+// One library per size for the whole run; filling 100k rows takes longer than the benchmarks themselves
+MixDatabase& library(int mixes) {
+    static std::map<int, std::unique_ptr<MixDatabase>> libraries;
+    std::unique_ptr<MixDatabase>& database = libraries[mixes];
+    if (!database) {
+        const std::string path = libraryPath(mixes);
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path + suffix);
+        }
+        database = std::make_unique<MixDatabase>(path);
+        database->initialize();
+        std::vector<Mix> batch;
+        batch.reserve(static_cast<size_t>(mixes));
+        for (int i = 0; i < mixes; ++i) {
+            batch.push_back(makeMix(i));
+        }
+        std::vector<bool> added;
+        database->addMixes(batch, {}, added);
+    }
+    return *database;
+}
+}  // namespace
+
+static void BM_SmartRandomMix(benchmark::State& state) {
+    MixDatabase& database = library(static_cast<int>(state.range(0)));
+    std::string previous;
+    for (auto _ : state) {
+        Mix mix = database.getSmartRandomMix(previous, "Techno");
+        previous = mix.id;
+        benchmark::DoNotOptimize(mix);
+    }
+}
+BENCHMARK(BM_SmartRandomMix)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_BuildQuery(benchmark::State& state) {
+    SelectionCriteria criteria;
+    criteria.genre = "Techno";
+    criteria.exclude_mix_id = "bench-42";
+    criteria.downloaded_only = true;
+    criteria.max_skip_streak = 3;
+    criteria.limit = 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MixQueryBuilder::buildQuery(criteria, OrderBy::Random));
+    }
+}
+BENCHMARK(BM_BuildQuery);
+
+static void BM_GetAllMixes(benchmark::State& state) {
+    MixDatabase& database = library(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<Mix> mixes = database.getAllMixes();
+        benchmark::DoNotOptimize(mixes);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetAllMixes)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Row to Mix conversion alone, over a statement already stepped to a row
+static void BM_MapRow(benchmark::State& state) {
+    library(1000);
+    SqliteConnection connection(libraryPath(1000));
+    connection.initialize();
+    auto statement = connection.prepare("SELECT * FROM mixes LIMIT 1");
+    statement->step();
+    const MixRowMapper mapper(*statement, true);
+    for (auto _ : state) {
+        Mix mix = mapper.map(*statement);
+        benchmark::DoNotOptimize(mix);
+    }
+}
+BENCHMARK(BM_MapRow);
+
+static void BM_LocalPath(benchmark::State& state) {
+    const int mappings = static_cast<int>(state.range(0));
+    const std::string journal = scratchPath("file_mappings_" + std::to_string(mappings) + ".txt");
+    {
+        std::ofstream file(journal, std::ios::trunc);
+        for (int i = 0; i < mappings; ++i) {
+            file << "bench-" << i << ":Benchmark mix " << i << ".mp3\n";
+        }
+    }
+    AutoVibez::Data::MixDownloader downloader(scratchPath("mixes"));
+    downloader.setFileMappingsPath(journal);
+    downloader.getLocalPath("bench-0");  // The journal is read on first use
+
+    int index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(downloader.getLocalPath("bench-" + std::to_string(index)));
+        index = (index + 7919) % mappings;
+    }
+}
+BENCHMARK(BM_LocalPath)->Arg(1000)->Arg(100000);
@@ -0,0 +1,176 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_fixtures.hpp"
+#include "utils/audio_utils.hpp"
+#include "utils/json_utils.hpp"
+#include "utils/log_sink.hpp"
+#include "utils/logger.hpp"
+#include "utils/mp3_probe.hpp"
+#include "utils/uuid_utils.hpp"
+
+using AutoVibez::Bench::scratchPath;
+using AutoVibez::Bench::writeMp3;
+using AutoVibez::Utils::AudioUtils;
+using AutoVibez::Utils::JsonUtils;
+using AutoVibez::Utils::LogSink;
+
+namespace {
+// The tags codec as it was before the single-allocation rewrite, kept as the baseline
+std::string legacyVectorToJsonArray(const std::vector<std::string>& tags) {
+    if (tags.empty()) {
+        return "[]";
+    }
+    std::ostringstream oss;
+    oss << "[";
+    for (size_t i = 0; i < tags.size(); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "\"" << JsonUtils::escapeJsonString(tags[i]) << "\"";
+    }
+    oss << "]";
+    return oss.str();
+}
+
+std::vector<std::string> legacyJsonArrayToVector(const std::string& json_array) {
+    std::vector<std::string> result;
+    std::string current_tag;
+    bool in_string = false;
+    bool escaped = false;
+    for (char c : json_array) {
+        if (escaped) {
+            current_tag += c;
+            escaped = false;
+        } else if (c == '\\' && in_string) {
+            escaped = true;
+        } else if (c == '"') {
+            if (in_string) {
+                result.push_back(current_tag);
+                current_tag.clear();
+            }
+            in_string = !in_string;
+        } else if (in_string) {
+            current_tag += c;
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> benchTags(int64_t count) {
+    std::vector<std::string> tags;
+    for (int64_t i = 0; i < count; ++i) {
+        tags.push_back("tag-" + std::to_string(i) + (i % 8 == 7 ? " \"live\"" : ""));
+    }
+    return tags;
+}
+}  // namespace
+
+static void BM_VectorToJsonArray(benchmark::State& state) {
+    const std::vector<std::string> tags = benchTags(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JsonUtils::vectorToJsonArray(tags));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VectorToJsonArray)->Arg(4)->Arg(64)->Arg(1024);
+
+static void BM_VectorToJsonArrayLegacy(benchmark::State& state) {
+    const std::vector<std::string> tags = benchTags(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyVectorToJsonArray(tags));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VectorToJsonArrayLegacy)->Arg(4)->Arg(64)->Arg(1024);
+
+static void BM_JsonArrayToVector(benchmark::State& state) {
+    const std::string json = JsonUtils::vectorToJsonArray(benchTags(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JsonUtils::jsonArrayToVector(json));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(json.size()));
+}
+BENCHMARK(BM_JsonArrayToVector)->Arg(4)->Arg(64)->Arg(1024);
+
+static void BM_JsonArrayToVectorLegacy(benchmark::State& state) {
+    const std::string json = JsonUtils::vectorToJsonArray(benchTags(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyJsonArrayToVector(json));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(json.size()));
+}
+BENCHMARK(BM_JsonArrayToVectorLegacy)->Arg(4)->Arg(64)->Arg(1024);
+
+// Views with the vector and arena reused, as a row loop would hold them
+static void BM_ParseJsonArrayViews(benchmark::State& state) {
+    const std::string json = JsonUtils::vectorToJsonArray(benchTags(state.range(0)));
+    std::vector<std::string_view> tags;
+    std::string arena;
+    for (auto _ : state) {
+        JsonUtils::parseJsonArray(json, tags, arena);
+        benchmark::DoNotOptimize(tags.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(json.size()));
+}
+BENCHMARK(BM_ParseJsonArrayViews)->Arg(4)->Arg(64)->Arg(1024);
+
+// Every manifest entry is keyed this way as the manifest is read
+static void BM_GenerateIdFromUrl(benchmark::State& state) {
+    const std::string url = "https://example.com/mixes/some-artist/a-fairly-long-mix-title-2024.mp3";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AutoVibez::Utils::HashIdUtils::generateIdFromUrl(url));
+    }
+}
+BENCHMARK(BM_GenerateIdFromUrl);
+
+static void BM_IsValidMP3File(benchmark::State& state) {
+    const std::string path = writeMp3("probe.mp3", 200);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AudioUtils::isValidMP3File(path));
+    }
+}
+BENCHMARK(BM_IsValidMP3File)->Unit(benchmark::kMicrosecond);
+
+static void BM_IsValidMP3FileCached(benchmark::State& state) {
+    const std::string path = writeMp3("probe_cached.mp3", 200);
+    AutoVibez::Utils::Mp3ProbeCache cache;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AudioUtils::isValidMP3File(path, &cache));
+    }
+}
+BENCHMARK(BM_IsValidMP3FileCached)->Unit(benchmark::kMicrosecond);
+
+// push() from one or more threads into a sink of its own, so the user's log is left alone
+static void BM_LogSinkPush(benchmark::State& state) {
+    static std::unique_ptr<LogSink> sink;
+    if (state.thread_index() == 0) {
+        sink = std::make_unique<LogSink>(scratchPath("throughput.log"), 0, 0, 1 << 16);
+    }
+    static const std::string message = "Loaded mix bench-42 from the local cache in 12 ms";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sink->push("INFO", message.data(), message.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        sink->flush();
+        state.counters["dropped"] = static_cast<double>(sink->getDroppedCount());
+        sink.reset();
+    }
+}
+BENCHMARK(BM_LogSinkPush)->Threads(1)->Threads(4);
+
+// The cost of a debug line in a release configuration: the level check and nothing else
+static void BM_LoggerFiltered(benchmark::State& state) {
+    AutoVibez::Utils::Logger logger(false);
+    const std::string message = "Frame rendered";
+    for (auto _ : state) {
+        logger.logDebug(message);
+    }
+}
+BENCHMARK(BM_LoggerFiltered);
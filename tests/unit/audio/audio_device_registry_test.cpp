@@ -0,0 +1,64 @@
+#include "audio/audio_device_registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using AutoVibez::Audio::AudioDeviceInfo;
+using AutoVibez::Audio::AudioDeviceRegistry;
+
+namespace {
+std::vector<AudioDeviceInfo> devices(std::initializer_list<const char*> names) {
+    std::vector<AudioDeviceInfo> list;
+    for (const char* name : names) {
+        AudioDeviceInfo info;
+        info.name = name;
+        list.push_back(info);
+    }
+    return list;
+}
+}  // namespace
+
+TEST(AudioDeviceRegistryTest, EmptyUntilRefreshed) {
+    AudioDeviceRegistry registry([] { return devices({"Mic"}); });
+    EXPECT_FALSE(registry.isPopulated());
+    EXPECT_EQ(registry.getDeviceCount(), 0);
+    EXPECT_EQ(registry.getDeviceName(0), "");
+
+    EXPECT_TRUE(registry.refresh());
+    EXPECT_TRUE(registry.isPopulated());
+    EXPECT_EQ(registry.getDeviceCount(), 1);
+    EXPECT_EQ(registry.getDeviceName(0), "Mic");
+    EXPECT_EQ(registry.getDeviceName(1), "");
+    EXPECT_EQ(registry.getDeviceName(-1), "");
+}
+
+TEST(AudioDeviceRegistryTest, FollowsDevicesAcrossHotplug) {
+    auto current = std::make_shared<std::vector<AudioDeviceInfo>>(devices({"Mic", "USB Interface"}));
+    AudioDeviceRegistry registry([current] { return *current; });
+    registry.refresh();
+    EXPECT_EQ(registry.findByName("USB Interface"), 1);
+    const uint64_t generation = registry.getGeneration();
+
+    // Unplugged: the name no longer resolves
+    *current = devices({"Mic"});
+    EXPECT_TRUE(registry.refresh());
+    EXPECT_EQ(registry.findByName("USB Interface"), -1);
+    EXPECT_GT(registry.getGeneration(), generation);
+
+    // Replugged behind a new device: same name, different index
+    *current = devices({"Webcam", "Mic", "USB Interface"});
+    registry.refresh();
+    EXPECT_EQ(registry.findByName("USB Interface"), 2);
+    EXPECT_EQ(registry.findByName(""), -1);
+}
+
+TEST(AudioDeviceRegistryTest, UnchangedListKeepsGeneration) {
+    AudioDeviceRegistry registry([] { return devices({"Mic", "Line In"}); });
+    registry.refresh();
+    const uint64_t generation = registry.getGeneration();
+    EXPECT_FALSE(registry.refresh());
+    EXPECT_EQ(registry.getGeneration(), generation);
+    EXPECT_EQ(registry.getDevices().size(), 2u);
+}
@@ -0,0 +1,94 @@
+#include "audio/audio_feature_extractor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using AutoVibez::Audio::AudioBand;
+using AutoVibez::Audio::AudioFeatureExtractor;
+using AutoVibez::Audio::AudioFeatures;
+
+namespace {
+
+constexpr int RATE = 44100;
+constexpr int BLOCK_FRAMES = 735;  // One 60 fps frame of drained PCM, not a multiple of four samples per channel
+
+// Stereo sine with its own amplitude per channel
+std::vector<float> sine(double hz, float left, float right, int frames = 4096, int rate = RATE) {
+    std::vector<float> samples(static_cast<size_t>(frames) * 2);
+    for (int i = 0; i < frames; ++i) {
+        const float value = static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * hz * i / rate));
+        samples[2 * i] = left * value;
+        samples[2 * i + 1] = right * value;
+    }
+    return samples;
+}
+
+AudioFeatures feed(AudioFeatureExtractor& extractor, const std::vector<float>& samples, int rate = RATE) {
+    const int frames = static_cast<int>(samples.size() / 2);
+    for (int start = 0; start < frames; start += BLOCK_FRAMES) {
+        extractor.process(samples.data() + static_cast<size_t>(start) * 2, std::min(BLOCK_FRAMES, frames - start),
+                          rate);
+    }
+    return extractor.getFeatures();
+}
+
+float band(const AudioFeatures& features, AudioBand which) {
+    return features.bands[static_cast<size_t>(which)];
+}
+
+}  // namespace
+
+TEST(AudioFeatureExtractorTest, MeasuresLevelsPerChannel) {
+    AudioFeatureExtractor extractor;
+    const AudioFeatures features = feed(extractor, sine(441.0, 0.8f, 0.2f, 4410));
+
+    EXPECT_NEAR(features.rms_left, 0.8f / std::sqrt(2.0f), 0.01f);
+    EXPECT_NEAR(features.rms_right, 0.2f / std::sqrt(2.0f), 0.01f);
+    EXPECT_NEAR(features.peak_left, 0.8f, 0.01f);
+    EXPECT_NEAR(features.peak_right, 0.2f, 0.01f);
+    EXPECT_EQ(features.blocks, 6u);  // 4410 frames in blocks of 735
+}
+
+TEST(AudioFeatureExtractorTest, SinesLandInTheirBandWithTheCentroidOnThem) {
+    struct Case {
+        double hz;
+        AudioBand band;
+    };
+    for (const Case& test : {Case{80.0, AudioBand::Bass}, Case{300.0, AudioBand::LowMid}, Case{1500.0, AudioBand::Mid},
+                             Case{8000.0, AudioBand::High}}) {
+        AudioFeatureExtractor extractor;
+        const AudioFeatures features = feed(extractor, sine(test.hz, 0.5f, 0.5f));
+        EXPECT_GT(band(features, test.band), 0.9f) << test.hz << " Hz";
+        EXPECT_NEAR(features.centroid_hz, test.hz, 0.1 * test.hz + 50.0) << test.hz << " Hz";
+
+        float total = 0.0f;
+        for (float share : features.bands) {
+            total += share;
+        }
+        EXPECT_NEAR(total, 1.0f, 1e-4f);
+    }
+}
+
+TEST(AudioFeatureExtractorTest, SilenceReadsAsZero) {
+    AudioFeatureExtractor extractor;
+    feed(extractor, sine(1000.0, 0.5f, 0.5f));
+    const AudioFeatures features = feed(extractor, std::vector<float>(4096 * 2, 0.0f));
+
+    EXPECT_EQ(features.rms_left, 0.0f);
+    EXPECT_EQ(features.peak_right, 0.0f);
+    EXPECT_EQ(features.centroid_hz, 0.0f);
+    for (float share : features.bands) {
+        EXPECT_EQ(share, 0.0f);
+    }
+}
+
+TEST(AudioFeatureExtractorTest, FollowsANewSampleRate) {
+    AudioFeatureExtractor extractor;
+    feed(extractor, sine(1500.0, 0.5f, 0.5f));
+    const AudioFeatures features = feed(extractor, sine(1500.0, 0.5f, 0.5f, 4096, 48000), 48000);
+    EXPECT_NEAR(features.centroid_hz, 1500.0f, 200.0f);
+    EXPECT_GT(band(features, AudioBand::Mid), 0.9f);
+}
@@ -0,0 +1,195 @@
+#include "audio/beat_tracker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using AutoVibez::Audio::BeatState;
+using AutoVibez::Audio::BeatTracker;
+
+namespace {
+
+constexpr int RATE = 44100;
+constexpr int BLOCK_FRAMES = 1024;
+
+// Stereo noise bursts on every beat; the first beat of each bar is louder
+std::vector<float> clicks(double seconds, double bpm, int rate = RATE) {
+    const int frames = static_cast<int>(seconds * rate);
+    const double beatFrames = 60.0 * rate / bpm;
+    std::vector<float> samples(static_cast<size_t>(frames) * 2, 0.0f);
+    unsigned seed = 1;
+    int beat = 0;
+    for (double start = 0.0; start < frames; start += beatFrames, ++beat) {
+        const float level = beat % 4 == 0 ? 1.0f : 0.4f;
+        const int first = static_cast<int>(start);
+        for (int i = first; i < std::min(frames, first + 441); ++i) {
+            seed = seed * 1103515245u + 12345u;
+            float value = level * (static_cast<float>((seed >> 16) & 0x7fff) / 16384.0f - 1.0f);
+            samples[2 * i] = value;
+            samples[2 * i + 1] = value;
+        }
+    }
+    return samples;
+}
+
+// Clicks scaled by a level over a steady noise bed of the same level, as a pad under the beat
+std::vector<float> withBed(std::vector<float> samples, float level) {
+    unsigned seed = 7;
+    for (size_t i = 0; i < samples.size(); i += 2) {
+        seed = seed * 1103515245u + 12345u;
+        const float noise = 0.1f * (static_cast<float>((seed >> 16) & 0x7fff) / 16384.0f - 1.0f);
+        samples[i] = level * (samples[i] + noise);
+        samples[i + 1] = level * (samples[i + 1] + noise);
+    }
+    return samples;
+}
+
+void feed(BeatTracker& tracker, const std::vector<float>& samples) {
+    const int frames = static_cast<int>(samples.size() / 2);
+    for (int offset = 0; offset < frames; offset += BLOCK_FRAMES) {
+        tracker.process(samples.data() + static_cast<size_t>(offset) * 2, std::min(BLOCK_FRAMES, frames - offset));
+    }
+}
+
+}  // namespace
+
+TEST(BeatTrackerTest, LocksOntoClickTrackTempo) {
+    for (double bpm : {96.0, 124.0, 150.0}) {
+        BeatTracker tracker(RATE);
+        feed(tracker, clicks(12.0, bpm));
+
+        BeatState state = tracker.getState();
+        ASSERT_TRUE(state.locked) << "at " << bpm << " BPM";
+        EXPECT_NEAR(state.bpm, bpm, 2.0) << "at " << bpm << " BPM";
+        EXPECT_GT(state.beat_count, 0u);
+        EXPECT_GE(state.phase, 0.0);
+        EXPECT_LT(state.phase, 1.0);
+    }
+}
+
+TEST(BeatTrackerTest, SilenceDoesNotLock) {
+    BeatTracker tracker(RATE);
+    feed(tracker, std::vector<float>(static_cast<size_t>(RATE) * 10 * 2, 0.0f));
+
+    BeatState state = tracker.getState();
+    EXPECT_FALSE(state.locked);
+    EXPECT_EQ(state.beat_count, 0u);
+}
+
+TEST(BeatTrackerTest, PhaseFollowsClicks) {
+    const double bpm = 120.0;
+    const double beatFrames = 60.0 * RATE / bpm;
+    auto samples = clicks(12.0, bpm);
+    BeatTracker tracker(RATE);
+
+    // After each block, the time since the last click should match the reported phase
+    const int frames = static_cast<int>(samples.size() / 2);
+    int checked = 0;
+    for (int offset = 0; offset < frames; offset += BLOCK_FRAMES) {
+        int count = std::min(BLOCK_FRAMES, frames - offset);
+        tracker.process(samples.data() + static_cast<size_t>(offset) * 2, count);
+        BeatState state = tracker.getState();
+        if (!state.locked || offset < 8 * RATE) {
+            continue;
+        }
+        double expected = std::fmod((offset + count) / beatFrames, 1.0);
+        double error = std::fabs(state.phase - expected);
+        EXPECT_LT(std::min(error, 1.0 - error), 0.1) << "at frame " << offset;
+        ++checked;
+    }
+    EXPECT_GT(checked, 0);
+}
+
+TEST(BeatTrackerTest, AccentedBeatIsTheDownbeat) {
+    const double bpm = 120.0;
+    const double beatFrames = 60.0 * RATE / bpm;
+    auto samples = clicks(24.0, bpm);
+    BeatTracker tracker(RATE);
+
+    const int frames = static_cast<int>(samples.size() / 2);
+    uint64_t lastCount = 0;
+    int downbeats = 0;
+    for (int offset = 0; offset < frames; offset += BLOCK_FRAMES) {
+        int count = std::min(BLOCK_FRAMES, frames - offset);
+        tracker.process(samples.data() + static_cast<size_t>(offset) * 2, count);
+        BeatState state = tracker.getState();
+        if (!state.locked || state.beat_count == lastCount) {
+            continue;
+        }
+        lastCount = state.beat_count;
+        if (offset < 15 * RATE || state.beat_in_bar != 0) {
+            continue;
+        }
+        // The downbeat just passed should be a bar line (every fourth click)
+        int beat = static_cast<int>(std::lround((offset + count) / beatFrames - state.phase));
+        EXPECT_EQ(beat % 4, 0) << "at frame " << offset;
+        ++downbeats;
+    }
+    EXPECT_GT(downbeats, 0);
+}
+
+TEST(BeatTrackerTest, ResetSwitchesSampleRate) {
+    BeatTracker tracker(RATE);
+    feed(tracker, clicks(12.0, 124.0));
+    ASSERT_TRUE(tracker.getState().locked);
+
+    tracker.reset(48000);
+    EXPECT_EQ(tracker.getSampleRate(), 48000);
+    EXPECT_FALSE(tracker.getState().locked);
+    EXPECT_EQ(tracker.getState().beat_count, 0u);
+
+    feed(tracker, clicks(12.0, 124.0, 48000));
+    BeatState state = tracker.getState();
+    ASSERT_TRUE(state.locked);
+    EXPECT_NEAR(state.bpm, 124.0, 2.0);
+}
+
+TEST(BeatTrackerTest, BlockCostFitsAudioCallback) {
+    auto samples = clicks(10.0, 128.0);
+    BeatTracker tracker(RATE);
+
+    auto start = std::chrono::steady_clock::now();
+    feed(tracker, samples);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Generous bound for debug builds on loaded CI machines; optimized builds are far below it
+    const double blocks = static_cast<double>(samples.size() / 2) / BLOCK_FRAMES;
+    EXPECT_LT(elapsed / blocks, 1.0);
+}
+
+TEST(BeatTrackerTest, LeadRunsThePredictionAhead) {
+    BeatTracker tracker(RATE);
+    feed(tracker, clicks(12.0, 120.0));
+    const BeatState now = tracker.getState();
+    ASSERT_TRUE(now.locked);
+
+    // One more beat of lead: same phase, the next beat in the bar
+    const BeatState ahead = tracker.getState(RATE / 4);
+    const BeatState further = tracker.getState(RATE / 4 + RATE / 2);
+    EXPECT_GE(ahead.beat_count, now.beat_count);
+    EXPECT_EQ(further.beat_count, ahead.beat_count + 1);
+    EXPECT_EQ(further.beat_in_bar, (ahead.beat_in_bar + 1) % 4);
+    EXPECT_NEAR(further.phase, ahead.phase, 0.05);
+}
+
+TEST(BeatTrackerTest, EnergyAndOnsetRateRiseWhenTheMusicBuilds) {
+    BeatTracker tracker(RATE);
+    feed(tracker, withBed(clicks(20.0, 60.0), 0.25f));
+    const BeatState calm = tracker.getState();
+    EXPECT_NEAR(calm.energy, 1.0, 0.3);
+    EXPECT_NEAR(calm.onset_rate, 1.0, 0.5);
+
+    feed(tracker, withBed(clicks(4.0, 150.0), 1.0f));
+    const BeatState busy = tracker.getState();
+    EXPECT_GT(busy.energy, 2.0 * calm.energy);
+    EXPECT_GT(busy.onset_rate, 1.5 * calm.onset_rate);
+
+    // Without a grid the intensity is still reported
+    feed(tracker, std::vector<float>(static_cast<size_t>(RATE) * 4 * 2, 0.0f));
+    const BeatState quiet = tracker.getState();
+    EXPECT_LT(quiet.energy, 0.5);
+    EXPECT_LT(quiet.onset_rate, busy.onset_rate);
+}
@@ -0,0 +1,84 @@
+#include "audio/channel_downmixer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using AutoVibez::Audio::ChannelDownmixer;
+
+TEST(ChannelDownmixerTest, RejectsUnsupportedChannelCounts) {
+    ChannelDownmixer downmixer;
+    EXPECT_FALSE(downmixer.configure(0));
+    EXPECT_FALSE(downmixer.configure(ChannelDownmixer::MAX_CHANNELS + 1));
+    EXPECT_EQ(downmixer.getChannels(), 0);
+}
+
+TEST(ChannelDownmixerTest, StereoPassesThrough) {
+    ChannelDownmixer downmixer;
+    ASSERT_TRUE(downmixer.configure(2));
+
+    std::vector<float> input = {0.1f, -0.2f, 0.3f, -0.4f};
+    std::vector<float> output(4);
+    downmixer.process(input.data(), 2, output.data());
+    for (size_t i = 0; i < input.size(); ++i) {
+        EXPECT_FLOAT_EQ(output[i], input[i]);
+    }
+}
+
+TEST(ChannelDownmixerTest, FiveOneDefaultFold) {
+    ChannelDownmixer downmixer;
+    ASSERT_TRUE(downmixer.configure(6));
+
+    // FL FR FC LFE BL BR
+    std::vector<float> input = {1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+    std::vector<float> output(2);
+    downmixer.process(input.data(), 1, output.data());
+
+    EXPECT_NEAR(output[0], 1.0f + 0.7071f, 1e-4f);
+    EXPECT_NEAR(output[1], 0.7071f + 0.7071f, 1e-4f);
+}
+
+TEST(ChannelDownmixerTest, SevenOneMatchesScalarReference) {
+    ChannelDownmixer downmixer;
+    ASSERT_TRUE(downmixer.configure(8));
+
+    const int frames = 37;
+    std::vector<float> input(frames * 8);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>((i * 7) % 13) / 13.0f - 0.5f;
+    }
+    std::vector<float> output(frames * 2);
+    downmixer.process(input.data(), frames, output.data());
+
+    for (int f = 0; f < frames; ++f) {
+        float left = 0.0f;
+        float right = 0.0f;
+        for (int c = 0; c < 8; ++c) {
+            left += input[f * 8 + c] * downmixer.getLeftWeight(c);
+            right += input[f * 8 + c] * downmixer.getRightWeight(c);
+        }
+        EXPECT_NEAR(output[f * 2], left, 1e-5f);
+        EXPECT_NEAR(output[f * 2 + 1], right, 1e-5f);
+    }
+}
+
+TEST(ChannelDownmixerTest, CustomWeights) {
+    ChannelDownmixer downmixer;
+    ASSERT_TRUE(downmixer.configure(3, "0.5:0.5, 1:0, 0:1"));
+    EXPECT_FLOAT_EQ(downmixer.getLeftWeight(0), 0.5f);
+    EXPECT_FLOAT_EQ(downmixer.getRightWeight(2), 1.0f);
+
+    std::vector<float> input = {1.0f, 0.25f, 0.75f};
+    std::vector<float> output(2);
+    downmixer.process(input.data(), 1, output.data());
+    EXPECT_FLOAT_EQ(output[0], 0.75f);
+    EXPECT_FLOAT_EQ(output[1], 1.25f);
+}
+
+TEST(ChannelDownmixerTest, InvalidWeightsFallBackToDefaults) {
+    ChannelDownmixer downmixer;
+    EXPECT_FALSE(downmixer.configure(6, "1:0,0:1"));
+    EXPECT_EQ(downmixer.getChannels(), 6);
+    EXPECT_FLOAT_EQ(downmixer.getLeftWeight(0), 1.0f);
+    EXPECT_FALSE(downmixer.configure(2, "abc:def,1:1"));
+}
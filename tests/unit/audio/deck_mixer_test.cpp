@@ -0,0 +1,215 @@
+#include "audio/deck_mixer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using AutoVibez::Audio::DeckMixer;
+using AutoVibez::Audio::PcmSource;
+
+namespace {
+
+// Constant-level stereo source with a fixed length
+class ConstantSource : public PcmSource {
+public:
+    ConstantSource(int16_t left, int16_t right, int64_t length) : _left(left), _right(right), _length(length) {}
+
+    int read(int16_t* out, int frames) override {
+        int count = static_cast<int>(std::min<int64_t>(frames, _length - _position));
+        for (int i = 0; i < count; ++i) {
+            out[2 * i] = _left;
+            out[2 * i + 1] = _right;
+        }
+        _position += count;
+        return count;
+    }
+    bool seek(int64_t frame) override {
+        _position = frame;
+        return true;
+    }
+    int64_t getLengthFrames() const override {
+        return _length;
+    }
+    int getSampleRate() const override {
+        return 44100;
+    }
+
+private:
+    int16_t _left;
+    int16_t _right;
+    int64_t _length;
+    int64_t _position = 0;
+};
+
+std::vector<int16_t> renderFrames(DeckMixer& mixer, int frames) {
+    std::vector<int16_t> out(static_cast<size_t>(frames) * 2);
+    mixer.render(out.data(), frames, 2);
+    return out;
+}
+
+}  // namespace
+
+TEST(DeckMixerTest, RendersSilenceWhenEmpty) {
+    DeckMixer mixer;
+    auto out = renderFrames(mixer, 64);
+    for (int16_t sample : out) {
+        EXPECT_EQ(sample, 0);
+    }
+    EXPECT_FALSE(mixer.isLoaded());
+    EXPECT_FALSE(mixer.isFinished());
+}
+
+TEST(DeckMixerTest, PlaysSingleDeckAtUnityGain) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(10000, -10000, 1000));
+
+    auto out = renderFrames(mixer, 100);
+    EXPECT_NEAR(out[0], 10000, 2);
+    EXPECT_NEAR(out[1], -10000, 2);
+    EXPECT_EQ(mixer.getPositionFrames(), 100);
+    EXPECT_EQ(mixer.getLengthFrames(), 1000);
+}
+
+TEST(DeckMixerTest, FinishesAtEndOfSource) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(1000, 1000, 50));
+
+    renderFrames(mixer, 100);
+    EXPECT_TRUE(mixer.isFinished());
+}
+
+TEST(DeckMixerTest, CrossfadeUsesEqualPowerCurve) {
+    DeckMixer mixer;
+    const int16_t level = 16000;
+    mixer.play(std::make_unique<ConstantSource>(level, 0, 100000));
+    mixer.crossfadeTo(std::make_unique<ConstantSource>(0, level, 100000), 2000);
+    EXPECT_TRUE(mixer.isCrossfading());
+
+    // Left carries the outgoing deck, right the incoming one
+    auto out = renderFrames(mixer, 2000);
+    float outgoingMid = out[2 * 1000] / static_cast<float>(level);
+    float incomingMid = out[2 * 1000 + 1] / static_cast<float>(level);
+    EXPECT_NEAR(outgoingMid, std::sqrt(0.5f), 0.01f);
+    EXPECT_NEAR(incomingMid, std::sqrt(0.5f), 0.01f);
+
+    // Power stays constant across the whole overlap
+    for (int i = 0; i < 2000; i += 97) {
+        float a = out[2 * i] / static_cast<float>(level);
+        float b = out[2 * i + 1] / static_cast<float>(level);
+        EXPECT_NEAR(a * a + b * b, 1.0f, 0.01f);
+    }
+
+    EXPECT_FALSE(mixer.isCrossfading());
+    EXPECT_EQ(mixer.getCrossfadeProgress(), 100);
+
+    auto after = renderFrames(mixer, 16);
+    EXPECT_EQ(after[0], 0);
+    EXPECT_NEAR(after[1], level, 2);
+}
+
+TEST(DeckMixerTest, CrossfadeWithoutCurrentDeckCutsImmediately) {
+    DeckMixer mixer;
+    mixer.crossfadeTo(std::make_unique<ConstantSource>(5000, 5000, 1000), 2000);
+    EXPECT_FALSE(mixer.isCrossfading());
+
+    auto out = renderFrames(mixer, 8);
+    EXPECT_NEAR(out[0], 5000, 2);
+}
+
+TEST(DeckMixerTest, PauseHoldsPosition) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(5000, 5000, 1000));
+    renderFrames(mixer, 10);
+
+    mixer.setPaused(true);
+    auto out = renderFrames(mixer, 10);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(mixer.getPositionFrames(), 10);
+
+    mixer.setPaused(false);
+    renderFrames(mixer, 10);
+    EXPECT_EQ(mixer.getPositionFrames(), 20);
+}
+
+TEST(DeckMixerTest, MasterGainScalesOutput) {
+    DeckMixer mixer;
+    mixer.setGain(0.5f);
+    mixer.play(std::make_unique<ConstantSource>(20000, 20000, 10000));
+
+    auto out = renderFrames(mixer, 64);
+    EXPECT_NEAR(out[126], 10000, 2);
+}
+
+TEST(DeckMixerTest, FoldsToMonoOutput) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(10000, 0, 1000));
+
+    std::vector<int16_t> out(16);
+    mixer.render(out.data(), 16, 1);
+    EXPECT_NEAR(out[0], 5000, 2);
+}
+
+TEST(DeckMixerTest, QueuedSourceContinuesWithoutGap) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(1000, 1000, 100));
+    mixer.queueNext(std::make_unique<ConstantSource>(2000, 2000, 1000));
+    EXPECT_TRUE(mixer.hasQueued());
+
+    // The hand-off lands mid-block; every frame must carry audio
+    auto out = renderFrames(mixer, 300);
+    EXPECT_NEAR(out[2 * 99], 1000, 2);
+    EXPECT_NEAR(out[2 * 100], 2000, 2);
+    for (int i = 0; i < 300; ++i) {
+        EXPECT_NE(out[2 * i], 0);
+    }
+
+    EXPECT_EQ(mixer.getAdvanceCount(), 1u);
+    EXPECT_FALSE(mixer.hasQueued());
+    EXPECT_FALSE(mixer.isFinished());
+    EXPECT_EQ(mixer.getPositionFrames(), 200);
+    EXPECT_EQ(mixer.getLengthFrames(), 1000);
+
+    mixer.releaseRetired();
+    EXPECT_FALSE(mixer.hasQueued());
+}
+
+TEST(DeckMixerTest, PlayClearsQueuedSource) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(1000, 1000, 10));
+    mixer.queueNext(std::make_unique<ConstantSource>(2000, 2000, 10));
+    mixer.play(std::make_unique<ConstantSource>(3000, 3000, 10));
+    EXPECT_FALSE(mixer.hasQueued());
+
+    renderFrames(mixer, 50);
+    EXPECT_TRUE(mixer.isFinished());
+    EXPECT_EQ(mixer.getAdvanceCount(), 0u);
+}
+
+TEST(DeckMixerTest, SeekMovesLiveDeckAndRevivesFinished) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(1000, 1000, 100));
+    renderFrames(mixer, 150);
+    EXPECT_TRUE(mixer.isFinished());
+
+    EXPECT_TRUE(mixer.seek(40));
+    EXPECT_FALSE(mixer.isFinished());
+    EXPECT_EQ(mixer.getPositionFrames(), 40);
+
+    renderFrames(mixer, 10);
+    EXPECT_EQ(mixer.getPositionFrames(), 50);
+}
+
+TEST(DeckMixerTest, SeekEndsRunningCrossfade) {
+    DeckMixer mixer;
+    mixer.play(std::make_unique<ConstantSource>(1000, 1000, 10000));
+    mixer.crossfadeTo(std::make_unique<ConstantSource>(8000, 8000, 10000), 4000);
+    renderFrames(mixer, 100);
+    ASSERT_TRUE(mixer.isCrossfading());
+
+    EXPECT_TRUE(mixer.seek(500));
+    EXPECT_FALSE(mixer.isCrossfading());
+    auto out = renderFrames(mixer, 10);
+    EXPECT_NEAR(out[0], 8000, 2);
+}
@@ -0,0 +1,48 @@
+#include "audio/decoder_backend.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using AutoVibez::Audio::DecoderBackend;
+
+namespace {
+const std::vector<std::string> X86_SYNTHS = {"AVX", "x86-64", "generic", "generic_dither"};
+const std::vector<std::string> ARM_SYNTHS = {"ARM", "generic", "generic_dither"};
+}  // namespace
+
+TEST(DecoderBackendTest, AutoLeavesTheChoiceToLibmpg123) {
+    std::string synth = "stale";
+    EXPECT_TRUE(DecoderBackend::select("auto", "high", X86_SYNTHS, synth));
+    EXPECT_EQ(synth, "");
+    EXPECT_TRUE(DecoderBackend::select("AUTO", "medium", X86_SYNTHS, synth));
+    EXPECT_EQ(synth, "");
+}
+
+TEST(DecoderBackendTest, LowProfilePinsTheLeanestSynth) {
+    std::string synth;
+    EXPECT_TRUE(DecoderBackend::select("auto", "low", X86_SYNTHS, synth));
+    EXPECT_EQ(synth, "AVX");
+
+    // No NEON: the integer ARM synth rather than the generic or dithering ones
+    EXPECT_TRUE(DecoderBackend::select("auto", "low", ARM_SYNTHS, synth));
+    EXPECT_EQ(synth, "ARM");
+
+    EXPECT_TRUE(DecoderBackend::select("auto", "low", {"generic_dither", "generic"}, synth));
+    EXPECT_EQ(synth, "generic");
+}
+
+TEST(DecoderBackendTest, ConfiguredNameUsesTheLibrarySpelling) {
+    std::string synth;
+    EXPECT_TRUE(DecoderBackend::select("X86-64", "low", X86_SYNTHS, synth));
+    EXPECT_EQ(synth, "x86-64");
+}
+
+TEST(DecoderBackendTest, UnsupportedNameFallsBackToTheProfile) {
+    std::string synth;
+    EXPECT_FALSE(DecoderBackend::select("NEON64", "low", X86_SYNTHS, synth));
+    EXPECT_EQ(synth, "AVX");
+    EXPECT_FALSE(DecoderBackend::select("NEON64", "high", X86_SYNTHS, synth));
+    EXPECT_EQ(synth, "");
+}
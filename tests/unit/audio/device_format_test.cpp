@@ -0,0 +1,32 @@
+#include "audio/device_format.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Audio::chooseSampleRate;
+using AutoVibez::Audio::DeviceFormat;
+using AutoVibez::Audio::queryDeviceFormat;
+
+TEST(DeviceFormatTest, ChoosesNativeRateWhenKnown) {
+    DeviceFormat format;
+    format.sample_rate = 48000;
+    EXPECT_EQ(chooseSampleRate(format, 44100), 48000);
+    format.sample_rate = 96000;
+    EXPECT_EQ(chooseSampleRate(format, 44100), 96000);
+}
+
+TEST(DeviceFormatTest, FallsBackWhenUnknownOrImplausible) {
+    DeviceFormat format;
+    EXPECT_EQ(chooseSampleRate(format, 44100), 44100);
+    format.sample_rate = 1000;
+    EXPECT_EQ(chooseSampleRate(format, 44100), 44100);
+    format.sample_rate = 10000000;
+    EXPECT_EQ(chooseSampleRate(format, 44100), 44100);
+}
+
+TEST(DeviceFormatTest, UnknownDeviceReportsNothing) {
+    DeviceFormat format;
+    format.sample_rate = 12345;
+    EXPECT_FALSE(queryDeviceFormat("No Such Device 7f3a", true, format));
+    EXPECT_EQ(format.sample_rate, 0);
+    EXPECT_EQ(format.period_frames, 0);
+}
@@ -0,0 +1,54 @@
+#include "audio/fft.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using AutoVibez::Audio::Fft;
+
+TEST(FftTest, MatchesDirectTransform) {
+    constexpr int size = 64;
+    std::vector<float> re(size);
+    std::vector<float> im(size);
+    unsigned seed = 7;
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        re[i] = static_cast<float>((seed >> 16) & 0xff) / 128.0f - 1.0f;
+        im[i] = static_cast<float>((seed >> 8) & 0xff) / 128.0f - 1.0f;
+    }
+    std::vector<float> inRe = re;
+    std::vector<float> inIm = im;
+
+    Fft fft(size);
+    fft.forward(re.data(), im.data());
+
+    for (int k = 0; k < size; ++k) {
+        double sumRe = 0.0;
+        double sumIm = 0.0;
+        for (int n = 0; n < size; ++n) {
+            double angle = -2.0 * M_PI * k * n / size;
+            sumRe += inRe[n] * std::cos(angle) - inIm[n] * std::sin(angle);
+            sumIm += inRe[n] * std::sin(angle) + inIm[n] * std::cos(angle);
+        }
+        EXPECT_NEAR(re[k], sumRe, 1e-3) << "bin " << k;
+        EXPECT_NEAR(im[k], sumIm, 1e-3) << "bin " << k;
+    }
+}
+
+TEST(FftTest, RoundsSizeUpToPowerOfTwo) {
+    Fft fft(1000);
+    EXPECT_EQ(fft.size(), 1024);
+
+    // A cosine on bin 8 puts half its energy in bins 8 and size - 8
+    std::vector<float> re(fft.size());
+    std::vector<float> im(fft.size(), 0.0f);
+    for (int i = 0; i < fft.size(); ++i) {
+        re[i] = static_cast<float>(std::cos(2.0 * M_PI * 8 * i / fft.size()));
+    }
+    fft.forward(re.data(), im.data());
+
+    EXPECT_NEAR(re[8], fft.size() / 2.0, 1e-2);
+    EXPECT_NEAR(re[fft.size() - 8], fft.size() / 2.0, 1e-2);
+    EXPECT_NEAR(re[9], 0.0, 1e-2);
+}
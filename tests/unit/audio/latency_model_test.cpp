@@ -0,0 +1,93 @@
+#include "audio/latency_model.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using AutoVibez::Audio::CalibrationClickDetector;
+using AutoVibez::Audio::LatencyBreakdown;
+using AutoVibez::Audio::LatencyModel;
+using AutoVibez::Audio::LatencyPath;
+
+namespace {
+constexpr int RATE = 48000;
+
+LatencyModel steadyModel() {
+    LatencyModel model;
+    model.setStreamRate(RATE);
+    model.setCapturePeriod(480, RATE);    // 10 ms
+    model.setOutputBuffer(2400, RATE);    // 50 ms
+    model.setDisplayQueueFrames(2);
+    model.noteRingBacklog(0);
+    model.noteRenderTime(4.0);
+    model.noteFrameInterval(1000.0 / 60.0);
+    return model;
+}
+}  // namespace
+
+TEST(LatencyModelTest, CaptureSumsEveryStage) {
+    LatencyModel model = steadyModel();
+    model.setPath(LatencyPath::Capture);
+
+    const LatencyBreakdown latency = model.getBreakdown();
+    EXPECT_DOUBLE_EQ(latency.capture_ms, 10.0);
+    EXPECT_DOUBLE_EQ(latency.window_ms, 6.0);
+    EXPECT_NEAR(latency.display_ms, 33.33, 0.01);
+    EXPECT_DOUBLE_EQ(latency.output_ms, 0.0);
+    EXPECT_NEAR(latency.lag_ms, 10.0 + 6.0 + 4.0 + 33.33, 0.01);
+
+    // Capture cannot be delayed; the whole lag becomes a lead for beat predictions
+    EXPECT_EQ(model.getPlaybackDelayFrames(RATE), 0);
+    EXPECT_NEAR(static_cast<double>(model.getResidualLeadFrames(RATE)), 53.33 * RATE / 1000.0, 1.0);
+}
+
+TEST(LatencyModelTest, PlaybackDelaysTheSpeakers) {
+    LatencyModel model = steadyModel();
+    model.setPath(LatencyPath::Playback);
+    model.setOutputBuffer(480, RATE);  // 10 ms between tap and speakers
+
+    const LatencyBreakdown latency = model.getBreakdown();
+    EXPECT_DOUBLE_EQ(latency.capture_ms, 0.0);
+    EXPECT_NEAR(latency.lag_ms, 6.0 + 4.0 + 33.33 - 10.0, 0.01);
+    EXPECT_NEAR(model.getPlaybackDelayFrames(RATE), latency.lag_ms * RATE / 1000.0, 1.0);
+    EXPECT_EQ(model.getResidualLeadFrames(RATE), 0);
+
+    // A large manual offset is capped and the rest is left to the beat lead
+    model.setManualOffsetMs(400.0);
+    EXPECT_EQ(model.getPlaybackDelayFrames(RATE), Constants::MAX_AV_DELAY_MS * RATE / 1000);
+    EXPECT_GT(model.getResidualLeadFrames(RATE), 0);
+
+    // Visuals ahead of the sound: nothing to delay
+    model.setManualOffsetMs(-100.0);
+    EXPECT_EQ(model.getPlaybackDelayFrames(RATE), 0);
+}
+
+TEST(LatencyModelTest, SmoothsRenderSpikes) {
+    LatencyModel model = steadyModel();
+    model.noteRenderTime(40.0);
+    EXPECT_NEAR(model.getBreakdown().render_ms, 7.6, 0.01);
+}
+
+TEST(LatencyModelTest, DetectorFindsEachRenderedClickOnce) {
+    // Two seconds of the click track, drained in odd-sized blocks
+    std::vector<int16_t> track(static_cast<size_t>(RATE) * 2 * 2);
+    int64_t position = 0;
+    AutoVibez::Audio::renderCalibrationClicks(track.data(), RATE * 2, 2, RATE, position);
+    EXPECT_EQ(position, RATE * 2);
+
+    CalibrationClickDetector detector;
+    std::vector<float> block;
+    int clicks = 0;
+    const size_t blockSamples = 2 * 733;
+    for (size_t start = 0; start < track.size(); start += blockSamples) {
+        const size_t count = std::min(blockSamples, track.size() - start);
+        block.assign(track.begin() + start, track.begin() + start + count);
+        for (float& sample : block) {
+            sample /= 32768.0f;
+        }
+        clicks += detector.process(block.data(), block.size(), RATE) ? 1 : 0;
+    }
+
+    // The click at t=0 is already sounding when detection starts, so only the later three count
+    EXPECT_EQ(clicks, 3);
+}
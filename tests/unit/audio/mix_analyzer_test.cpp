@@ -0,0 +1,131 @@
+#include "audio/mix_analyzer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using AutoVibez::Audio::LoudnessMeter;
+using AutoVibez::Audio::MixAnalysis;
+using AutoVibez::Audio::MixAnalyzer;
+using AutoVibez::Audio::SpectralCentroidMeter;
+using AutoVibez::Audio::TempoEstimator;
+
+namespace {
+
+constexpr int RATE = 44100;
+
+// Stereo 1 kHz sine with the given per-channel peak level
+std::vector<int16_t> sine(double seconds, double peakDbfs, double frequency = 1000.0) {
+    const int frames = static_cast<int>(seconds * RATE);
+    const double amplitude = std::pow(10.0, peakDbfs / 20.0) * 32767.0;
+    std::vector<int16_t> samples(static_cast<size_t>(frames) * 2);
+    for (int i = 0; i < frames; ++i) {
+        auto value = static_cast<int16_t>(std::lrint(amplitude * std::sin(2.0 * M_PI * frequency * i / RATE)));
+        samples[2 * i] = value;
+        samples[2 * i + 1] = value;
+    }
+    return samples;
+}
+
+// Short noise bursts on every beat over silence
+std::vector<int16_t> clicks(double seconds, double bpm) {
+    const int frames = static_cast<int>(seconds * RATE);
+    const double beatFrames = 60.0 * RATE / bpm;
+    std::vector<int16_t> samples(static_cast<size_t>(frames) * 2, 0);
+    unsigned seed = 1;
+    for (double beat = 0.0; beat < frames; beat += beatFrames) {
+        int start = static_cast<int>(beat);
+        for (int i = start; i < std::min(frames, start + 441); ++i) {
+            seed = seed * 1103515245u + 12345u;
+            auto value = static_cast<int16_t>(static_cast<int>((seed >> 16) & 0x7fff) - 16384);
+            samples[2 * i] = value;
+            samples[2 * i + 1] = value;
+        }
+    }
+    return samples;
+}
+
+}  // namespace
+
+TEST(LoudnessMeterTest, StereoSineMatchesReferenceLevel) {
+    // EBU Tech 3341: a stereo 1 kHz sine at -23 dBFS reads -23 LUFS
+    auto samples = sine(5.0, -23.0);
+    LoudnessMeter meter(RATE);
+    meter.process(samples.data(), static_cast<int>(samples.size() / 2));
+
+    EXPECT_NEAR(meter.getIntegratedLoudness(), -23.0, 0.1);
+    EXPECT_NEAR(meter.getPeakDbfs(), -23.0, 0.05);
+}
+
+TEST(LoudnessMeterTest, RelativeGateIgnoresQuietPassages) {
+    // With -20 dBFS and -50 dBFS halves, the quiet half falls below the relative gate
+    auto loud = sine(10.0, -20.0);
+    auto quiet = sine(10.0, -50.0);
+    LoudnessMeter meter(RATE);
+    meter.process(loud.data(), static_cast<int>(loud.size() / 2));
+    meter.process(quiet.data(), static_cast<int>(quiet.size() / 2));
+
+    EXPECT_NEAR(meter.getIntegratedLoudness(), -20.0, 0.2);
+}
+
+TEST(LoudnessMeterTest, SilenceReportsFloor) {
+    std::vector<int16_t> silence(static_cast<size_t>(RATE) * 2 * 2, 0);
+    LoudnessMeter meter(RATE);
+    meter.process(silence.data(), static_cast<int>(silence.size() / 2));
+
+    EXPECT_DOUBLE_EQ(meter.getIntegratedLoudness(), LoudnessMeter::LOUDNESS_FLOOR_LUFS);
+    EXPECT_DOUBLE_EQ(meter.getPeakDbfs(), LoudnessMeter::PEAK_FLOOR_DBFS);
+}
+
+TEST(TempoEstimatorTest, DetectsClickTrackTempo) {
+    for (double bpm : {100.0, 124.0, 140.0}) {
+        auto samples = clicks(30.0, bpm);
+        TempoEstimator tempo(RATE);
+        tempo.process(samples.data(), static_cast<int>(samples.size() / 2));
+
+        EXPECT_NEAR(tempo.estimateBpm(), bpm, 1.0) << "at " << bpm << " BPM";
+    }
+}
+
+TEST(TempoEstimatorTest, SteadyToneHasNoTempo) {
+    auto samples = sine(20.0, -12.0);
+    TempoEstimator tempo(RATE);
+    tempo.process(samples.data(), static_cast<int>(samples.size() / 2));
+
+    EXPECT_DOUBLE_EQ(tempo.estimateBpm(), 0.0);
+}
+
+TEST(SpectralCentroidMeterTest, FollowsWhereTheEnergyIs) {
+    for (double frequency : {440.0, 4000.0}) {
+        auto samples = sine(5.0, -12.0, frequency);
+        SpectralCentroidMeter meter(RATE);
+        meter.process(samples.data(), static_cast<int>(samples.size() / 2));
+
+        EXPECT_NEAR(meter.getCentroidHz(), frequency, frequency * 0.05) << "at " << frequency << " Hz";
+    }
+
+    // Fed in odd-sized blocks with a silent stretch, which does not pull the mean towards zero
+    auto tone = sine(4.0, -20.0, 2000.0);
+    std::vector<int16_t> samples(tone.size() * 2, 0);
+    std::copy(tone.begin(), tone.end(), samples.begin());
+    SpectralCentroidMeter meter(RATE);
+    const int frames = static_cast<int>(samples.size() / 2);
+    for (int start = 0; start < frames; start += 1000) {
+        meter.process(samples.data() + 2 * start, std::min(1000, frames - start));
+    }
+    EXPECT_NEAR(meter.getCentroidHz(), 2000.0, 100.0);
+
+    SpectralCentroidMeter silent(RATE);
+    std::vector<int16_t> silence(static_cast<size_t>(RATE) * 4, 0);
+    silent.process(silence.data(), RATE * 2);
+    EXPECT_DOUBLE_EQ(silent.getCentroidHz(), 0.0);
+}
+
+TEST(MixAnalyzerTest, MissingFileFails) {
+    MixAnalyzer analyzer;
+    MixAnalysis result;
+
+    EXPECT_FALSE(analyzer.analyzeFile("/nonexistent/mix.mp3", result));
+    EXPECT_FALSE(analyzer.isSuccess());
+}
@@ -2,8 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <sstream>
 
 #include "utils/constants.hpp"
@@ -259,3 +261,91 @@ TEST_F(MixPlayerTest, RepeatedPlayAttempts) {
         EXPECT_FALSE(player.getLastError().empty());
     }
 }
+
+namespace {
+// Silence of a known length, at the player's output rate
+class SilentSource : public AutoVibez::Audio::PcmSource {
+public:
+    SilentSource(int64_t length, int rate) : _length(length), _rate(rate) {}
+
+    int read(int16_t* out, int frames) override {
+        const int count = static_cast<int>(std::min<int64_t>(frames, _length - _position));
+        std::fill(out, out + 2 * count, 0);
+        _position += count;
+        return count;
+    }
+    bool seek(int64_t frame) override {
+        _position = frame;
+        return true;
+    }
+    int64_t getLengthFrames() const override {
+        return _length;
+    }
+    int getSampleRate() const override {
+        return _rate;
+    }
+
+private:
+    int64_t _length;
+    int _rate;
+    int64_t _position = 0;
+};
+
+void countingPcmTap(void* userdata, const int16_t* /*samples*/, int /*frames*/, int /*channels*/) {
+    ++*static_cast<int*>(userdata);
+}
+}  // namespace
+
+TEST_F(MixPlayerTest, PcmTapInstallAndRemove) {
+    AutoVibez::Audio::MixPlayer player;
+    int calls = 0;
+
+    // Installing and removing the tap without playback should be safe
+    player.setPcmTap(&countingPcmTap, &calls);
+    player.setPcmTap(nullptr, nullptr);
+
+    EXPECT_FALSE(player.isPlaying());
+    EXPECT_GE(calls, 0);
+}
+
+TEST_F(MixPlayerTest, FrameClockWhenNotPlaying) {
+    AutoVibez::Audio::MixPlayer player;
+
+    EXPECT_EQ(player.getPositionFrames(), 0);
+    EXPECT_EQ(player.getLengthFrames(), -1);
+    EXPECT_FALSE(player.seekToFrame(0));
+    EXPECT_TRUE(player.getLastError().find("No music is currently playing") != std::string::npos);
+}
+
+TEST_F(MixPlayerTest, DurationAndPositionFollowTheFrameClock) {
+    AutoVibez::Audio::MixPlayer player;
+    const int rate = player.getOutputRate();
+    ASSERT_TRUE(player.playSource(std::make_unique<SilentSource>(int64_t{90} * rate + rate / 2, rate)));
+
+    EXPECT_EQ(player.getLengthFrames(), int64_t{90} * rate + rate / 2);
+    EXPECT_EQ(player.getDuration(), 90);
+
+    ASSERT_TRUE(player.seekToFrame(int64_t{42} * rate + rate / 4));
+    EXPECT_EQ(player.getPositionFrames(), int64_t{42} * rate + rate / 4);
+    EXPECT_EQ(player.getCurrentPosition(), 42);
+
+    player.stop();
+    EXPECT_EQ(player.getPositionFrames(), 0);
+    EXPECT_EQ(player.getLengthFrames(), -1);
+    EXPECT_EQ(player.getDuration(), 0);
+}
+
+TEST_F(MixPlayerTest, SeekToFrameIsClampedToTheMix) {
+    AutoVibez::Audio::MixPlayer player;
+    const int rate = player.getOutputRate();
+    const int64_t length = int64_t{10} * rate;
+    ASSERT_TRUE(player.playSource(std::make_unique<SilentSource>(length, rate)));
+
+    // A second short of the end, so the seek does not finish the mix
+    ASSERT_TRUE(player.seekToFrame(length * 2));
+    EXPECT_EQ(player.getPositionFrames(), length - rate);
+    EXPECT_TRUE(player.isPlaying());
+
+    ASSERT_TRUE(player.seekToFrame(-rate));
+    EXPECT_EQ(player.getPositionFrames(), 0);
+}
@@ -0,0 +1,44 @@
+#include "audio/monitor_capture.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Audio::MonitorCapture;
+
+namespace {
+void discardSamples(void*, const float*, int) {}
+}  // namespace
+
+TEST(MonitorCaptureTest, NotRunningByDefault) {
+    MonitorCapture capture;
+    EXPECT_FALSE(capture.isRunning());
+    EXPECT_TRUE(capture.getBackendName().empty());
+}
+
+TEST(MonitorCaptureTest, StartRequiresCallback) {
+    MonitorCapture capture;
+    EXPECT_FALSE(capture.start(nullptr, nullptr, 44100));
+    EXPECT_FALSE(capture.isRunning());
+    EXPECT_FALSE(capture.getLastError().empty());
+}
+
+TEST(MonitorCaptureTest, StopIsIdempotent) {
+    MonitorCapture capture;
+    capture.stop();
+    capture.stop();
+    EXPECT_FALSE(capture.isRunning());
+}
+
+TEST(MonitorCaptureTest, StartReportsBackendOrError) {
+    MonitorCapture capture;
+    // May or may not find a sound server; either outcome must be consistent
+    if (capture.start(&discardSamples, nullptr, 44100)) {
+        EXPECT_TRUE(capture.isRunning());
+        EXPECT_FALSE(capture.getBackendName().empty());
+        capture.stop();
+        EXPECT_FALSE(capture.isRunning());
+    } else {
+        EXPECT_FALSE(capture.isRunning());
+        EXPECT_FALSE(capture.getLastError().empty());
+    }
+    EXPECT_TRUE(capture.getBackendName().empty());
+}
@@ -169,7 +169,7 @@ TEST_F(MP3AnalyzerTest, MetadataStructure) {
     EXPECT_TRUE(metadata.artist.empty());
     EXPECT_TRUE(metadata.genre.empty());
     EXPECT_TRUE(metadata.format.empty());
-    EXPECT_TRUE(metadata.date_added.empty());
+    EXPECT_EQ(metadata.date_added_ms, 0);
     EXPECT_EQ(metadata.file_size, 0);
 }
 
@@ -0,0 +1,81 @@
+#include "audio/mp3_decoder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+using AutoVibez::Audio::Mp3Decoder;
+using AutoVibez::Utils::DownloadProgress;
+
+class Mp3DecoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        partial_path = (std::filesystem::temp_directory_path() / "mp3_decoder_test.tmp").string();
+        std::ofstream(partial_path, std::ios::binary).close();
+        progress = std::make_shared<DownloadProgress>();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(partial_path);
+    }
+
+    std::string partial_path;
+    std::shared_ptr<DownloadProgress> progress;
+};
+
+TEST_F(Mp3DecoderTest, OpenMissingFileFails) {
+    Mp3Decoder decoder;
+    EXPECT_FALSE(decoder.open("/nonexistent/mix.mp3", 44100));
+    EXPECT_FALSE(decoder.isOpen());
+    EXPECT_FALSE(decoder.getLastError().empty());
+}
+
+TEST_F(Mp3DecoderTest, OpenGrowingRequiresProgress) {
+    Mp3Decoder decoder;
+    EXPECT_FALSE(decoder.openGrowing(partial_path, nullptr, 44100));
+    EXPECT_FALSE(decoder.isOpen());
+}
+
+TEST_F(Mp3DecoderTest, OpenGrowingUsesOutputRate) {
+    Mp3Decoder decoder;
+    ASSERT_TRUE(decoder.openGrowing(partial_path, progress, 48000));
+    EXPECT_EQ(decoder.getSampleRate(), 48000);
+    EXPECT_EQ(decoder.getLengthFrames(), -1);
+}
+
+TEST_F(Mp3DecoderTest, CaughtUpStreamPlaysSilence) {
+    Mp3Decoder decoder;
+    ASSERT_TRUE(decoder.openGrowing(partial_path, progress, 44100));
+
+    // Nothing has arrived yet, but the download is still running
+    std::vector<int16_t> out(2 * 256, 1);
+    EXPECT_EQ(decoder.read(out.data(), 256), 256);
+    for (int16_t sample : out) {
+        EXPECT_EQ(sample, 0);
+    }
+    EXPECT_EQ(decoder.getUnderrunCount(), 1);
+}
+
+TEST_F(Mp3DecoderTest, CompletedStreamEnds) {
+    Mp3Decoder decoder;
+    ASSERT_TRUE(decoder.openGrowing(partial_path, progress, 44100));
+    progress->complete.store(true);
+
+    std::vector<int16_t> out(2 * 256);
+    EXPECT_EQ(decoder.read(out.data(), 256), 0);
+    EXPECT_EQ(decoder.getUnderrunCount(), 0);
+}
+
+TEST_F(Mp3DecoderTest, GrowingStreamCannotSeek) {
+    Mp3Decoder decoder;
+    ASSERT_TRUE(decoder.openGrowing(partial_path, progress, 44100));
+    EXPECT_FALSE(decoder.seek(1000));
+}
+
+TEST_F(Mp3DecoderTest, BackendNameShowsThePinnedSynth) {
+    EXPECT_EQ(Mp3Decoder().getBackendName(), "mpg123");
+    EXPECT_EQ(Mp3Decoder("generic").getBackendName(), "mpg123/generic");
+}
@@ -0,0 +1,132 @@
+#include "audio/pcm_ingest.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "constants.hpp"
+
+using AutoVibez::Audio::ChannelDownmixer;
+using AutoVibez::Audio::PcmIngest;
+using AutoVibez::Audio::PcmRingBuffer;
+using AutoVibez::Audio::PcmSampleFormat;
+
+namespace {
+std::vector<float> drain(PcmRingBuffer& ring) {
+    std::vector<float> samples(ring.available());
+    ring.read(samples.data(), samples.size());
+    return samples;
+}
+}  // namespace
+
+TEST(PcmIngestTest, RejectsUnsupportedLayouts) {
+    PcmIngest ingest;
+    EXPECT_FALSE(ingest.configure(0, PcmSampleFormat::Float32));
+    EXPECT_FALSE(ingest.configure(ChannelDownmixer::MAX_CHANNELS + 1, PcmSampleFormat::Int16));
+    EXPECT_FALSE(ingest.isConfigured());
+    EXPECT_EQ(ingest.getFrameBytes(), 0u);
+
+    // Unconfigured input is dropped
+    PcmRingBuffer ring(64);
+    const float samples[4] = {0.5f, 0.5f, 0.5f, 0.5f};
+    ingest.process(samples, 2, ring, nullptr);
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+TEST(PcmIngestTest, StereoFloatPassesThrough) {
+    PcmIngest ingest;
+    ASSERT_TRUE(ingest.configure(2, PcmSampleFormat::Float32));
+    EXPECT_EQ(ingest.getFrameBytes(), 2 * sizeof(float));
+
+    PcmRingBuffer ring(64);
+    const std::vector<float> input = {0.1f, -0.2f, 0.3f, -0.4f};
+    ingest.process(input.data(), 2, ring, nullptr);
+    EXPECT_EQ(drain(ring), input);
+}
+
+TEST(PcmIngestTest, MonoInt16IsScaledAndDuplicated) {
+    PcmIngest ingest;
+    ASSERT_TRUE(ingest.configure(1, PcmSampleFormat::Int16));
+    EXPECT_EQ(ingest.getFrameBytes(), sizeof(int16_t));
+
+    // Odd length, so both the vector body and the scalar tail run
+    std::vector<int16_t> input(37);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<int16_t>(static_cast<int>(i * 1777) % 65536 - 32768);
+    }
+    PcmRingBuffer ring(128);
+    ingest.process(input.data(), static_cast<int>(input.size()), ring, nullptr);
+
+    const std::vector<float> output = drain(ring);
+    ASSERT_EQ(output.size(), input.size() * 2);
+    for (size_t i = 0; i < input.size(); ++i) {
+        EXPECT_FLOAT_EQ(output[2 * i], input[i] / 32768.0f);
+        EXPECT_FLOAT_EQ(output[2 * i + 1], input[i] / 32768.0f);
+    }
+}
+
+TEST(PcmIngestTest, Int24In32IsLeftJustified) {
+    PcmIngest ingest;
+    ASSERT_TRUE(ingest.configure(2, PcmSampleFormat::Int24In32));
+
+    const std::vector<int32_t> input = {0x7FFFFF00, -0x7FFFFF00 - 0x100, 0x400000 << 8, 0, -(0x200000 << 8), 0x100};
+    PcmRingBuffer ring(64);
+    ingest.process(input.data(), 3, ring, nullptr);
+
+    const std::vector<float> output = drain(ring);
+    ASSERT_EQ(output.size(), input.size());
+    EXPECT_NEAR(output[0], 1.0f, 1e-6f);
+    EXPECT_FLOAT_EQ(output[1], -1.0f);
+    EXPECT_FLOAT_EQ(output[2], 0.5f);
+    EXPECT_FLOAT_EQ(output[3], 0.0f);
+    EXPECT_FLOAT_EQ(output[4], -0.25f);
+    EXPECT_NEAR(output[5], 1.0f / 8388608.0f, 1e-9f);
+}
+
+TEST(PcmIngestTest, SurroundInt16MatchesTheDownmixer) {
+    PcmIngest ingest;
+    ASSERT_TRUE(ingest.configure(6, PcmSampleFormat::Int16));
+    ChannelDownmixer reference;
+    ASSERT_TRUE(reference.configure(6));
+
+    // More frames than one conversion chunk holds
+    const int frames = 300;
+    std::vector<int16_t> input(frames * 6);
+    std::vector<float> converted(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<int16_t>(static_cast<int>(i * 911) % 20000 - 10000);
+        converted[i] = input[i] / 32768.0f;
+    }
+    std::vector<float> expected(frames * 2);
+    reference.process(converted.data(), frames, expected.data());
+
+    PcmRingBuffer ring(1024);
+    ingest.process(input.data(), frames, ring, nullptr);
+    const std::vector<float> output = drain(ring);
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(output[i], expected[i], 1e-5f);
+    }
+}
+
+TEST(PcmIngestTest, InvalidWeightsKeepTheDefaultFold) {
+    PcmIngest ingest;
+    EXPECT_FALSE(ingest.configure(6, PcmSampleFormat::Float32, "not weights"));
+    EXPECT_TRUE(ingest.isConfigured());
+    EXPECT_EQ(ingest.getChannels(), 6);
+}
+
+TEST(PcmIngestTest, SilenceIsWrittenAsStereoZeros) {
+    PcmIngest ingest;
+    ASSERT_TRUE(ingest.configure(8, PcmSampleFormat::Int24In32));
+
+    const int frames = Constants::PCM_CONVERT_CHUNK_SAMPLES;  // Two chunks of stereo
+    PcmRingBuffer ring(4096);
+    ingest.processSilence(frames, ring, nullptr);
+    const std::vector<float> output = drain(ring);
+    ASSERT_EQ(output.size(), static_cast<size_t>(frames) * 2);
+    for (float sample : output) {
+        EXPECT_EQ(sample, 0.0f);
+    }
+}
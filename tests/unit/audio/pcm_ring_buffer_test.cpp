@@ -0,0 +1,85 @@
+#include "audio/pcm_ring_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using AutoVibez::Audio::PcmRingBuffer;
+
+TEST(PcmRingBufferTest, CapacityRoundsUpToPowerOfTwo) {
+    PcmRingBuffer ring(1000);
+    EXPECT_EQ(ring.capacity(), 1024u);
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+TEST(PcmRingBufferTest, WriteThenReadPreservesOrder) {
+    PcmRingBuffer ring(16);
+    std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+    EXPECT_EQ(ring.write(input.data(), input.size()), input.size());
+    EXPECT_EQ(ring.available(), input.size());
+
+    std::vector<float> output(8, 0.0f);
+    EXPECT_EQ(ring.read(output.data(), output.size()), input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        EXPECT_FLOAT_EQ(output[i], input[i]);
+    }
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+TEST(PcmRingBufferTest, WrapsAroundEnd) {
+    PcmRingBuffer ring(8);
+    std::vector<float> scratch(8, 0.0f);
+    std::vector<float> first = {1, 2, 3, 4, 5, 6};
+    ring.write(first.data(), first.size());
+    ring.read(scratch.data(), 6);
+
+    std::vector<float> second = {7, 8, 9, 10, 11};
+    EXPECT_EQ(ring.write(second.data(), second.size()), second.size());
+    EXPECT_EQ(ring.read(scratch.data(), scratch.size()), second.size());
+    for (size_t i = 0; i < second.size(); ++i) {
+        EXPECT_FLOAT_EQ(scratch[i], second[i]);
+    }
+}
+
+TEST(PcmRingBufferTest, CountsOverflowAndUnderrun) {
+    PcmRingBuffer ring(4);
+    std::vector<float> input(6, 0.5f);
+    EXPECT_EQ(ring.write(input.data(), input.size()), 4u);
+    EXPECT_EQ(ring.getOverflowCount(), 2u);
+
+    std::vector<float> output(8);
+    EXPECT_EQ(ring.read(output.data(), output.size()), 4u);
+    EXPECT_EQ(ring.read(output.data(), output.size()), 0u);
+    EXPECT_EQ(ring.getUnderrunCount(), 1u);
+
+    ring.resetCounters();
+    EXPECT_EQ(ring.getOverflowCount(), 0u);
+    EXPECT_EQ(ring.getUnderrunCount(), 0u);
+}
+
+TEST(PcmRingBufferTest, ConcurrentProducerConsumer) {
+    PcmRingBuffer ring(256);
+    constexpr int total = 100000;
+
+    std::thread producer([&ring]() {
+        int next = 0;
+        while (next < total) {
+            float value = static_cast<float>(next);
+            if (ring.write(&value, 1) == 1) {
+                ++next;
+            }
+        }
+    });
+
+    int expected = 0;
+    std::vector<float> batch(64);
+    while (expected < total) {
+        size_t count = ring.read(batch.data(), batch.size());
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_FLOAT_EQ(batch[i], static_cast<float>(expected));
+            ++expected;
+        }
+    }
+    producer.join();
+}
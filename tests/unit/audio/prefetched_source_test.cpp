@@ -0,0 +1,103 @@
+#include "audio/prefetched_source.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using AutoVibez::Audio::PcmSource;
+using AutoVibez::Audio::PrefetchedSource;
+
+namespace {
+
+// Emits frame index as the sample value so ordering is easy to check
+class RampSource : public PcmSource {
+public:
+    explicit RampSource(int64_t length, int* reads = nullptr) : _length(length), _reads(reads) {}
+
+    int read(int16_t* out, int frames) override {
+        if (_reads) {
+            ++*_reads;
+        }
+        int count = static_cast<int>(std::min<int64_t>(frames, _length - _position));
+        for (int i = 0; i < count; ++i) {
+            out[2 * i] = static_cast<int16_t>(_position + i);
+            out[2 * i + 1] = static_cast<int16_t>(_position + i);
+        }
+        _position += count;
+        return count;
+    }
+    bool seek(int64_t frame) override {
+        _position = frame;
+        return true;
+    }
+    int64_t getLengthFrames() const override {
+        return _length;
+    }
+    int getSampleRate() const override {
+        return 44100;
+    }
+
+private:
+    int64_t _length;
+    int64_t _position = 0;
+    int* _reads;
+};
+
+}  // namespace
+
+TEST(PrefetchedSourceTest, DecodesHeadUpFront) {
+    int reads = 0;
+    PrefetchedSource source(std::make_unique<RampSource>(1000, &reads), 100);
+    int readsAfterPrefetch = reads;
+    EXPECT_GT(readsAfterPrefetch, 0);
+    EXPECT_EQ(source.getBufferedFrames(), 100);
+
+    std::vector<int16_t> out(2 * 50);
+    EXPECT_EQ(source.read(out.data(), 50), 50);
+    EXPECT_EQ(reads, readsAfterPrefetch);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[2 * 49], 49);
+}
+
+TEST(PrefetchedSourceTest, ContinuesSeamlesslyPastHead) {
+    PrefetchedSource source(std::make_unique<RampSource>(1000), 100);
+
+    std::vector<int16_t> out(2 * 150);
+    EXPECT_EQ(source.read(out.data(), 150), 150);
+    for (int i = 0; i < 150; ++i) {
+        EXPECT_EQ(out[2 * i], i);
+    }
+    EXPECT_EQ(source.getBufferedFrames(), 0);
+}
+
+TEST(PrefetchedSourceTest, ShortSourceEndsCleanly) {
+    PrefetchedSource source(std::make_unique<RampSource>(30), 100);
+    EXPECT_EQ(source.getBufferedFrames(), 30);
+
+    std::vector<int16_t> out(2 * 100);
+    EXPECT_EQ(source.read(out.data(), 100), 30);
+    EXPECT_EQ(source.read(out.data(), 100), 0);
+}
+
+TEST(PrefetchedSourceTest, SeekOutsideHeadDropsBuffer) {
+    PrefetchedSource source(std::make_unique<RampSource>(1000), 100);
+    EXPECT_TRUE(source.seek(500));
+    EXPECT_EQ(source.getBufferedFrames(), 0);
+
+    std::vector<int16_t> out(2);
+    EXPECT_EQ(source.read(out.data(), 1), 1);
+    EXPECT_EQ(out[0], 500);
+    EXPECT_EQ(source.getLengthFrames(), 1000);
+}
+
+TEST(PrefetchedSourceTest, SeekInsideHeadKeepsBuffer) {
+    PrefetchedSource source(std::make_unique<RampSource>(1000), 100);
+    EXPECT_TRUE(source.seek(40));
+    EXPECT_EQ(source.getBufferedFrames(), 60);
+
+    std::vector<int16_t> out(2 * 80);
+    EXPECT_EQ(source.read(out.data(), 80), 80);
+    EXPECT_EQ(out[0], 40);
+    EXPECT_EQ(out[2 * 79], 119);
+}
@@ -0,0 +1,40 @@
+#include "audio/seek_index.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Audio::SeekIndex;
+
+TEST(SeekIndexTest, RoundTripsThroughText) {
+    SeekIndex index;
+    index.frames_per_entry = 192;
+    index.length_frames = 317520000;
+    index.sample_rate = 44100;
+    index.offsets = {0, 417, 80313, 161024, 240000};
+
+    SeekIndex parsed;
+    ASSERT_TRUE(SeekIndex::parse(index.serialize(), parsed));
+    EXPECT_EQ(parsed.frames_per_entry, 192);
+    EXPECT_EQ(parsed.length_frames, 317520000);
+    EXPECT_EQ(parsed.sample_rate, 44100);
+    EXPECT_EQ(parsed.offsets, index.offsets);
+}
+
+TEST(SeekIndexTest, EmptyIndexSerializesToNothing) {
+    SeekIndex index;
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.serialize(), "");
+
+    SeekIndex parsed;
+    EXPECT_FALSE(SeekIndex::parse("", parsed));
+    EXPECT_TRUE(parsed.empty());
+}
+
+TEST(SeekIndexTest, RejectsMalformedText) {
+    SeekIndex parsed;
+    EXPECT_FALSE(SeekIndex::parse("v2;192;1000;44100;0,10", parsed));
+    EXPECT_FALSE(SeekIndex::parse("v1;192;1000;44100", parsed));
+    EXPECT_FALSE(SeekIndex::parse("v1;192;1000;44100;0,10;7", parsed));
+    EXPECT_FALSE(SeekIndex::parse("v1;192;1000;44100;0,-10", parsed));
+    EXPECT_FALSE(SeekIndex::parse("v1;0;1000;44100;0,10", parsed));
+    EXPECT_TRUE(parsed.empty());
+}
@@ -0,0 +1,78 @@
+#include "audio/test_signal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using AutoVibez::Audio::TestSignalSource;
+using AutoVibez::Audio::TestSignalType;
+
+namespace {
+std::vector<int16_t> render(TestSignalSource& source, int frames) {
+    std::vector<int16_t> pcm(static_cast<size_t>(frames) * 2);
+    EXPECT_EQ(source.read(pcm.data(), frames), frames);
+    return pcm;
+}
+}  // namespace
+
+TEST(TestSignalSourceTest, ParsesSignalNames) {
+    TestSignalType type;
+    ASSERT_TRUE(TestSignalSource::parseType("sweep", type));
+    EXPECT_EQ(type, TestSignalType::Sweep);
+    ASSERT_TRUE(TestSignalSource::parseType("pink", type));
+    EXPECT_EQ(type, TestSignalType::PinkNoise);
+    ASSERT_TRUE(TestSignalSource::parseType("kicks", type));
+    EXPECT_EQ(type, TestSignalType::Kicks);
+    ASSERT_TRUE(TestSignalSource::parseType("sine", type));
+    EXPECT_EQ(type, TestSignalType::Sine);
+    EXPECT_FALSE(TestSignalSource::parseType("mic", type));
+}
+
+TEST(TestSignalSourceTest, EverySignalIsDeterministicAndAudible) {
+    for (auto type : {TestSignalType::Sweep, TestSignalType::PinkNoise, TestSignalType::Kicks, TestSignalType::Sine}) {
+        TestSignalSource first(type);
+        TestSignalSource second(type);
+        auto a = render(first, 44100);
+        auto b = render(second, 44100);
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(first.getLengthFrames(), -1);
+
+        double energy = 0.0;
+        for (int16_t sample : a) {
+            energy += static_cast<double>(sample) * sample;
+        }
+        EXPECT_GT(std::sqrt(energy / a.size()), 1000.0) << static_cast<int>(type);
+    }
+}
+
+TEST(TestSignalSourceTest, SeekMatchesContinuousRead) {
+    for (auto type : {TestSignalType::Sweep, TestSignalType::PinkNoise, TestSignalType::Kicks}) {
+        TestSignalSource continuous(type);
+        auto all = render(continuous, 3000);
+
+        TestSignalSource seeking(type);
+        ASSERT_TRUE(seeking.seek(2000));
+        auto tail = render(seeking, 1000);
+        EXPECT_TRUE(std::equal(tail.begin(), tail.end(), all.begin() + 4000)) << static_cast<int>(type);
+    }
+}
+
+TEST(TestSignalSourceTest, KicksLandOnTheBeat) {
+    TestSignalSource kicks(TestSignalType::Kicks, 44100, 120.0);
+    auto pcm = render(kicks, 44100);
+
+    // 120 BPM: a kick every 22050 frames, loudest right at its start
+    auto level = [&](int start) {
+        int peak = 0;
+        for (int i = start; i < start + 441; ++i) {
+            peak = std::max(peak, std::abs(static_cast<int>(pcm[2 * i])));
+        }
+        return peak;
+    };
+    EXPECT_GT(level(0), 8000);
+    EXPECT_GT(level(22050), 8000);
+    EXPECT_LT(level(20000), level(22050) / 4);
+}
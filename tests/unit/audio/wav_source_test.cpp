@@ -0,0 +1,93 @@
+#include "audio/wav_source.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using AutoVibez::Audio::WavSource;
+
+namespace {
+void putLe(std::vector<uint8_t>& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+// Minimal RIFF/WAVE with one fmt and one data chunk
+std::vector<uint8_t> makeWav(uint16_t format, int channels, int rate, int bits, const std::vector<uint8_t>& pcm) {
+    std::vector<uint8_t> wav = {'R', 'I', 'F', 'F'};
+    putLe(wav, static_cast<uint32_t>(36 + pcm.size()), 4);
+    for (char c : std::string("WAVEfmt ")) {
+        wav.push_back(static_cast<uint8_t>(c));
+    }
+    putLe(wav, 16, 4);
+    putLe(wav, format, 2);
+    putLe(wav, channels, 2);
+    putLe(wav, rate, 4);
+    putLe(wav, rate * channels * bits / 8, 4);
+    putLe(wav, channels * bits / 8, 2);
+    putLe(wav, bits, 2);
+    for (char c : std::string("data")) {
+        wav.push_back(static_cast<uint8_t>(c));
+    }
+    putLe(wav, static_cast<uint32_t>(pcm.size()), 4);
+    wav.insert(wav.end(), pcm.begin(), pcm.end());
+    return wav;
+}
+}  // namespace
+
+TEST(WavSourceTest, ReadsStereo16BitAtNativeRate) {
+    std::vector<uint8_t> pcm;
+    for (int16_t sample : {100, -100, 200, -200, 300, -300}) {
+        putLe(pcm, static_cast<uint16_t>(sample), 2);
+    }
+    auto wav = makeWav(1, 2, 44100, 16, pcm);
+
+    WavSource source;
+    ASSERT_TRUE(source.openData(wav.data(), wav.size(), 44100)) << source.getLastError();
+    EXPECT_EQ(source.getLengthFrames(), 3);
+
+    int16_t out[8] = {};
+    EXPECT_EQ(source.read(out, 4), 3);
+    EXPECT_EQ(out[0], 100);
+    EXPECT_EQ(out[1], -100);
+    EXPECT_EQ(out[5], -300);
+    EXPECT_EQ(source.read(out, 4), 0);
+
+    ASSERT_TRUE(source.seek(1));
+    EXPECT_EQ(source.read(out, 1), 1);
+    EXPECT_EQ(out[0], 200);
+}
+
+TEST(WavSourceTest, DuplicatesMonoFloatAndResamples) {
+    std::vector<uint8_t> pcm;
+    for (float value : {0.0f, 0.5f, 0.5f, 0.5f}) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putLe(pcm, bits, 4);
+    }
+    auto wav = makeWav(3, 1, 22050, 32, pcm);
+
+    WavSource source;
+    ASSERT_TRUE(source.openData(wav.data(), wav.size(), 44100)) << source.getLastError();
+    EXPECT_EQ(source.getLengthFrames(), 7);
+
+    int16_t out[14] = {};
+    ASSERT_EQ(source.read(out, 7), 7);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[2], out[3]);
+    EXPECT_NEAR(out[2], 8192, 1);  // Halfway between the first two input samples
+    EXPECT_NEAR(out[4], 16384, 1);
+}
+
+TEST(WavSourceTest, RejectsUnsupportedInput) {
+    WavSource source;
+    const uint8_t junk[16] = {'R', 'I', 'F', 'F'};
+    EXPECT_FALSE(source.openData(junk, sizeof(junk), 44100));
+    EXPECT_FALSE(source.getLastError().empty());
+
+    auto adpcm = makeWav(2, 2, 44100, 4, std::vector<uint8_t>(64, 0));
+    EXPECT_FALSE(source.openData(adpcm.data(), adpcm.size(), 44100));
+    EXPECT_FALSE(source.open("/nonexistent/file.wav", 44100));
+}
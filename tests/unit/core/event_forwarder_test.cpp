@@ -0,0 +1,73 @@
+#include "event_forwarder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using AutoVibez::Core::EventForwarder;
+
+namespace {
+SDL_Event makeEvent(Uint32 type) {
+    SDL_Event event{};
+    event.type = type;
+    return event;
+}
+}  // namespace
+
+TEST(EventForwarderTest, DeliversEventsInOrder) {
+    EventForwarder forwarder;
+    EXPECT_TRUE(forwarder.push(makeEvent(SDL_KEYDOWN)));
+    EXPECT_TRUE(forwarder.push(makeEvent(SDL_KEYUP)));
+
+    SDL_Event event;
+    ASSERT_TRUE(forwarder.poll(event));
+    EXPECT_EQ(event.type, static_cast<Uint32>(SDL_KEYDOWN));
+    ASSERT_TRUE(forwarder.poll(event));
+    EXPECT_EQ(event.type, static_cast<Uint32>(SDL_KEYUP));
+    EXPECT_FALSE(forwarder.poll(event));
+}
+
+TEST(EventForwarderTest, FullQueueDropsOnlyMouseMotion) {
+    EventForwarder forwarder(2);
+    forwarder.push(makeEvent(SDL_MOUSEMOTION));
+    forwarder.push(makeEvent(SDL_MOUSEMOTION));
+
+    EXPECT_FALSE(forwarder.push(makeEvent(SDL_MOUSEMOTION)));
+    EXPECT_EQ(forwarder.getDroppedCount(), 1u);
+    // A lost key-up would leave a key stuck
+    EXPECT_TRUE(forwarder.push(makeEvent(SDL_KEYUP)));
+
+    SDL_Event event;
+    int count = 0;
+    while (forwarder.poll(event)) {
+        ++count;
+    }
+    EXPECT_EQ(count, 3);
+    EXPECT_EQ(event.type, static_cast<Uint32>(SDL_KEYUP));
+}
+
+TEST(EventForwarderTest, WaitReturnsWhenAnEventArrives) {
+    EventForwarder forwarder;
+    std::thread producer([&forwarder]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        forwarder.push(makeEvent(SDL_WINDOWEVENT));
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    forwarder.wait(5000);
+    const auto waited = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    EXPECT_LT(waited, std::chrono::seconds(4));
+    SDL_Event event;
+    EXPECT_TRUE(forwarder.poll(event));
+}
+
+TEST(EventForwarderTest, WaitTimesOutWhenIdle) {
+    EventForwarder forwarder;
+    const auto start = std::chrono::steady_clock::now();
+    forwarder.wait(10);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(9));
+    EXPECT_FALSE(forwarder.isInstalled());
+}
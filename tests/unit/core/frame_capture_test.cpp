@@ -0,0 +1,92 @@
+#include "frame_capture.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "image_encoder.hpp"
+
+using AutoVibez::Core::FrameCapture;
+using AutoVibez::Core::ImageEncoder;
+using AutoVibez::Core::ImageFormat;
+
+namespace {
+std::vector<uint8_t> readBytes(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+class ImageEncoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _directory = std::filesystem::temp_directory_path() / "autovibez_image_encoder_test";
+        std::filesystem::create_directories(_directory);
+        _image.assign(4 * 3 * 4, 200);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(_directory);
+    }
+
+    std::filesystem::path _directory;
+    std::vector<uint8_t> _image;  // 4x3 RGBA
+};
+}  // namespace
+
+TEST(ImageFormatTest, ParsesNames) {
+    ImageFormat format = ImageFormat::Png;
+    EXPECT_TRUE(ImageEncoder::parseFormat("JPEG", format));
+    EXPECT_EQ(format, ImageFormat::Jpeg);
+    EXPECT_TRUE(ImageEncoder::parseFormat("png", format));
+    EXPECT_EQ(format, ImageFormat::Png);
+    EXPECT_TRUE(ImageEncoder::parseFormat("jpg", format));
+    EXPECT_EQ(format, ImageFormat::Jpeg);
+    EXPECT_FALSE(ImageEncoder::parseFormat("bmp", format));
+    EXPECT_STREQ(ImageEncoder::getExtension(ImageFormat::Jpeg), ".jpg");
+}
+
+TEST_F(ImageEncoderTest, RejectsShortImages) {
+    std::string error;
+    EXPECT_FALSE(ImageEncoder::write((_directory / "short.png").string(), ImageFormat::Png, _image, 4, 4, 90, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST_F(ImageEncoderTest, WritesPng) {
+    if (!ImageEncoder::isSupported(ImageFormat::Png)) {
+        GTEST_SKIP() << "Built without libpng";
+    }
+    const std::filesystem::path path = _directory / "shot.png";
+    std::string error;
+    ASSERT_TRUE(ImageEncoder::write(path.string(), ImageFormat::Png, _image, 4, 3, 90, error)) << error;
+    const std::vector<uint8_t> bytes = readBytes(path);
+    const std::vector<uint8_t> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    ASSERT_GE(bytes.size(), signature.size());
+    EXPECT_TRUE(std::equal(signature.begin(), signature.end(), bytes.begin()));
+}
+
+TEST_F(ImageEncoderTest, WritesJpeg) {
+    if (!ImageEncoder::isSupported(ImageFormat::Jpeg)) {
+        GTEST_SKIP() << "Built without libjpeg";
+    }
+    const std::filesystem::path path = _directory / "shot.jpg";
+    std::string error;
+    ASSERT_TRUE(ImageEncoder::write(path.string(), ImageFormat::Jpeg, _image, 4, 3, 80, error)) << error;
+    const std::vector<uint8_t> bytes = readBytes(path);
+    ASSERT_GE(bytes.size(), 4u);
+    EXPECT_EQ(bytes[0], 0xff);
+    EXPECT_EQ(bytes[1], 0xd8);
+    EXPECT_EQ(bytes[bytes.size() - 2], 0xff);
+    EXPECT_EQ(bytes[bytes.size() - 1], 0xd9);
+}
+
+TEST(FrameCaptureTest, NamesFilesByTimeAndSequence) {
+    const std::string name = FrameCapture::makeFileName(0, 7, ImageFormat::Jpeg);
+    EXPECT_EQ(name.rfind("autovibez-", 0), 0u);
+    EXPECT_EQ(name.size(), std::string("autovibez-YYYYMMDD-HHMMSS-7.jpg").size());
+    EXPECT_EQ(name.substr(name.size() - 6), "-7.jpg");
+    EXPECT_NE(FrameCapture::makeFileName(0, 8, ImageFormat::Png), FrameCapture::makeFileName(0, 7, ImageFormat::Png));
+}
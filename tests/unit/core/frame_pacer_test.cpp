@@ -0,0 +1,116 @@
+#include "frame_pacer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+using AutoVibez::Core::FramePacer;
+using AutoVibez::Core::FramePacingMode;
+using AutoVibez::Core::FrameTimingStats;
+
+namespace {
+using Clock = FramePacer::Clock;
+
+// A manual clock: waiting jumps straight to the deadline, rendering is simulated with advance()
+struct FakeClock {
+    Clock::time_point now{Clock::duration(std::chrono::seconds(1))};
+    int waits = 0;
+
+    void advance(double ms) {
+        now += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+};
+
+double msBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+FramePacer makePacer(const std::shared_ptr<FakeClock>& clock) {
+    return FramePacer([clock] { return clock->now; },
+                      [clock](Clock::time_point deadline) {
+                          ++clock->waits;
+                          clock->now = std::max(clock->now, deadline);
+                      });
+}
+}  // namespace
+
+TEST(FramePacerTest, ParsesModes) {
+    FramePacingMode mode = FramePacingMode::Vsync;
+    EXPECT_TRUE(FramePacer::parseMode("Fixed", mode));
+    EXPECT_EQ(mode, FramePacingMode::Fixed);
+    EXPECT_TRUE(FramePacer::parseMode("uncapped", mode));
+    EXPECT_EQ(mode, FramePacingMode::Uncapped);
+    EXPECT_FALSE(FramePacer::parseMode("sometimes", mode));
+    EXPECT_EQ(mode, FramePacingMode::Uncapped);
+    EXPECT_STREQ(FramePacer::modeName(FramePacingMode::Vsync), "vsync");
+}
+
+TEST(FramePacerTest, FixedModeHoldsAnExactRate) {
+    auto clock = std::make_shared<FakeClock>();
+    FramePacer pacer = makePacer(clock);
+    pacer.configure(FramePacingMode::Fixed, 60.0, 144.0);
+    EXPECT_EQ(pacer.getSwapInterval(), 0);
+    EXPECT_DOUBLE_EQ(pacer.getTargetFps(), 60.0);
+
+    // Uneven render times, one of them over budget, still average out to 1/60 s
+    const Clock::time_point start = clock->now;
+    for (int frame = 0; frame <= 240; ++frame) {
+        clock->advance(frame % 10 == 5 ? 20.0 : 4.0);
+        pacer.endFrame();
+    }
+    EXPECT_NEAR(msBetween(start, clock->now), 4.0 + 241 * 1000.0 / 60.0, 0.5);
+
+    const FrameTimingStats stats = pacer.getStats();
+    EXPECT_EQ(stats.frames, 240u);
+    EXPECT_EQ(stats.missed, 0u);
+    EXPECT_NEAR(stats.mean_frame_ms, 1000.0 / 60.0, 0.1);
+    EXPECT_GT(stats.jitter_ms, 0.0);
+    EXPECT_NEAR(stats.worst_ms, 20.0, 0.1);
+}
+
+TEST(FramePacerTest, FixedModeResynchronizesAfterAStall) {
+    auto clock = std::make_shared<FakeClock>();
+    FramePacer pacer = makePacer(clock);
+    pacer.configure(FramePacingMode::Fixed, 50.0, 0.0);
+    pacer.endFrame();
+
+    // A 100 ms hitch: the next frame runs immediately, after that the 20 ms cadence resumes without a burst
+    clock->advance(100.0);
+    pacer.endFrame();
+    EXPECT_EQ(pacer.getStats().missed, 1u);
+    const Clock::time_point resumed = clock->now;
+    clock->advance(2.0);
+    pacer.endFrame();
+    EXPECT_NEAR(msBetween(resumed, clock->now), 20.0, 0.01);
+}
+
+TEST(FramePacerTest, VsyncAndUncappedNeverWait) {
+    auto clock = std::make_shared<FakeClock>();
+    FramePacer pacer = makePacer(clock);
+
+    pacer.configure(FramePacingMode::Vsync, 30.0, 120.0);
+    EXPECT_EQ(pacer.getSwapInterval(), 1);
+    EXPECT_DOUBLE_EQ(pacer.getTargetFps(), 120.0);
+    for (int frame = 0; frame < 10; ++frame) {
+        clock->advance(frame == 5 ? 16.0 : 1000.0 / 120.0);  // One dropped refresh
+        pacer.endFrame();
+    }
+    EXPECT_EQ(pacer.getStats().missed, 1u);
+
+    pacer.configure(FramePacingMode::Uncapped, 60.0, 60.0);
+    EXPECT_DOUBLE_EQ(pacer.getTargetFps(), 0.0);
+    for (int frame = 0; frame < 10; ++frame) {
+        clock->advance(1.0);
+        pacer.endFrame();
+    }
+    EXPECT_EQ(clock->waits, 0);
+    EXPECT_NEAR(pacer.getStats().last_frame_ms, 1.0, 0.001);
+}
+
+TEST(FramePacerTest, SpinSleepReachesTheDeadline) {
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(5);
+    FramePacer::spinSleepUntil(deadline);
+    EXPECT_GE(Clock::now(), deadline);
+}
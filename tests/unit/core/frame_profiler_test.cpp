@@ -0,0 +1,216 @@
+#include "frame_profiler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using AutoVibez::Core::FRAME_PHASE_COUNT;
+using AutoVibez::Core::FramePhase;
+using AutoVibez::Core::FrameProfiler;
+using AutoVibez::Core::GpuTimer;
+using AutoVibez::Core::PhasePercentiles;
+
+namespace {
+using Clock = FrameProfiler::Clock;
+
+struct FakeClock {
+    Clock::time_point now{Clock::duration(std::chrono::seconds(1))};
+
+    void advance(double ms) {
+        now += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+};
+
+// Every query takes a fixed GPU time and becomes readable after a set number of polls
+class FakeGpuTimer : public GpuTimer {
+public:
+    explicit FakeGpuTimer(int pollsUntilReady) : _pollsUntilReady(pollsUntilReady) {}
+
+    size_t getSlotCount() const override {
+        return 2 * FRAME_PHASE_COUNT;
+    }
+    void begin(size_t slot) override {
+        ++begins;
+        _polls[slot] = 0;
+        _pending[slot] = true;
+    }
+    void end() override {
+        ++ends;
+    }
+    bool poll(size_t slot, double& ms) override {
+        if (!_pending[slot] || ++_polls[slot] < _pollsUntilReady) {
+            return false;
+        }
+        _pending[slot] = false;
+        ms = 3.0;
+        return true;
+    }
+
+    int begins = 0;
+    int ends = 0;
+
+private:
+    int _pollsUntilReady;
+    std::vector<int> _polls = std::vector<int>(2 * FRAME_PHASE_COUNT, 0);
+    std::vector<bool> _pending = std::vector<bool>(2 * FRAME_PHASE_COUNT, false);
+};
+
+FrameProfiler makeProfiler(const std::shared_ptr<FakeClock>& clock, size_t window = 100) {
+    return FrameProfiler(window, [clock] { return clock->now; });
+}
+
+void runFrame(FrameProfiler& profiler, FakeClock& clock, double renderMs) {
+    profiler.beginFrame();
+    {
+        FrameProfiler::Scope scope(profiler, FramePhase::PcmDrain);
+        clock.advance(0.5);
+    }
+    {
+        FrameProfiler::Scope scope(profiler, FramePhase::Render);
+        clock.advance(renderMs);
+    }
+    profiler.endFrame();
+    clock.advance(10.0);  // Pacing wait, outside the frame
+}
+}  // namespace
+
+TEST(FrameProfilerTest, ReportsPercentilesPerPhase) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock);
+
+    // 1..100 ms render times: nearest-rank percentiles are exact
+    for (int frame = 1; frame <= 100; ++frame) {
+        runFrame(profiler, *clock, frame);
+    }
+
+    const PhasePercentiles render = profiler.getCpuPercentiles(FramePhase::Render);
+    EXPECT_EQ(render.samples, 100u);
+    EXPECT_NEAR(render.p50_ms, 50.0, 1e-6);
+    EXPECT_NEAR(render.p95_ms, 95.0, 1e-6);
+    EXPECT_NEAR(render.p99_ms, 99.0, 1e-6);
+    EXPECT_NEAR(render.max_ms, 100.0, 1e-6);
+
+    EXPECT_NEAR(profiler.getCpuPercentiles(FramePhase::PcmDrain).p99_ms, 0.5, 1e-6);
+    EXPECT_NEAR(profiler.getFramePercentiles().max_ms, 100.5, 1e-6);
+
+    // Phases that never ran have no samples
+    EXPECT_EQ(profiler.getCpuPercentiles(FramePhase::Events).samples, 0u);
+    EXPECT_EQ(profiler.getGpuPercentiles(FramePhase::Render).samples, 0u);
+}
+
+TEST(FrameProfilerTest, WindowRollsOver) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock, 10);
+    for (int frame = 0; frame < 10; ++frame) {
+        runFrame(profiler, *clock, 50.0);
+    }
+    for (int frame = 0; frame < 10; ++frame) {
+        runFrame(profiler, *clock, 1.0);
+    }
+
+    EXPECT_EQ(profiler.getSampleCount(), 10u);
+    EXPECT_NEAR(profiler.getCpuPercentiles(FramePhase::Render).max_ms, 1.0, 1e-6);
+
+    std::vector<float> history;
+    profiler.getFrameHistory(history);
+    ASSERT_EQ(history.size(), 10u);
+    EXPECT_NEAR(history.front(), 1.5f, 1e-4);
+}
+
+TEST(FrameProfilerTest, GpuResultsArriveWithoutStalling) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock);
+    auto timer = std::make_unique<FakeGpuTimer>(2);  // Ready on the second poll, one frame after the first
+    FakeGpuTimer* fake = timer.get();
+    profiler.setGpuTimer(std::move(timer));
+    ASSERT_TRUE(profiler.hasGpuTimer());
+
+    for (int frame = 0; frame < 5; ++frame) {
+        runFrame(profiler, *clock, 2.0);
+    }
+
+    // Only Render is a GPU phase here; the last two frames are still in flight
+    EXPECT_EQ(fake->begins, 5);
+    EXPECT_EQ(fake->ends, 5);
+    const PhasePercentiles gpu = profiler.getGpuPercentiles(FramePhase::Render);
+    EXPECT_EQ(gpu.samples, 3u);
+    EXPECT_DOUBLE_EQ(gpu.p50_ms, 3.0);
+    EXPECT_EQ(profiler.getGpuPercentiles(FramePhase::PcmDrain).samples, 0u);
+}
+
+TEST(FrameProfilerTest, LateGpuResultsAreDropped) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock);
+    profiler.setGpuTimer(std::make_unique<FakeGpuTimer>(100));
+
+    for (int frame = 0; frame < 10; ++frame) {
+        runFrame(profiler, *clock, 2.0);
+    }
+    EXPECT_EQ(profiler.getGpuPercentiles(FramePhase::Render).samples, 0u);
+    EXPECT_EQ(profiler.getCpuPercentiles(FramePhase::Render).samples, 10u);
+}
+
+TEST(FrameProfilerTest, DisabledRecordsNothing) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock);
+    profiler.setEnabled(false);
+    runFrame(profiler, *clock, 2.0);
+    EXPECT_EQ(profiler.getSampleCount(), 0u);
+
+    profiler.setEnabled(true);
+    runFrame(profiler, *clock, 2.0);
+    EXPECT_EQ(profiler.getSampleCount(), 1u);
+}
+
+TEST(FrameProfilerTest, WritesTaggedCsv) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock);
+    profiler.setTag("Geiss - \"Reaction\", remix");
+    runFrame(profiler, *clock, 2.0);
+    profiler.setTag("plain");
+    runFrame(profiler, *clock, 4.0);
+
+    std::ostringstream csv;
+    profiler.writeCsv(csv);
+    std::istringstream lines(csv.str());
+    std::string header;
+    std::string first;
+    std::string second;
+    std::getline(lines, header);
+    std::getline(lines, first);
+    std::getline(lines, second);
+
+    EXPECT_EQ(header,
+              "frame,preset,total_ms,pcm_drain_ms,render_ms,overlays_ms,swap_ms,events_ms,housekeeping_ms,"
+              "render_gpu_ms,overlays_gpu_ms");
+    EXPECT_EQ(first, "0,\"Geiss - \"\"Reaction\"\", remix\",2.5,0.5,2,,,,,,");
+    EXPECT_EQ(second, "1,plain,4.5,0.5,4,,,,,,");
+}
+
+TEST(FrameProfilerTest, ListenerSeesFinalTimings) {
+    auto clock = std::make_shared<FakeClock>();
+    FrameProfiler profiler = makeProfiler(clock);
+    std::vector<std::string> presets;
+    std::vector<double> gpuMs;
+    profiler.addFrameListener([&](const AutoVibez::Core::FrameRecord& record) {
+        presets.push_back(profiler.getTagName(record.tag));
+        gpuMs.push_back(record.gpu_ms[static_cast<size_t>(FramePhase::Render)]);
+    });
+
+    // Without a GPU timer every frame is final when it ends
+    profiler.setTag("a.milk");
+    runFrame(profiler, *clock, 2.0);
+    EXPECT_EQ(presets, (std::vector<std::string>{"a.milk"}));
+
+    // With one, a frame is reported once its queries have been read back
+    profiler.setGpuTimer(std::make_unique<FakeGpuTimer>(2));
+    profiler.setTag("b.milk");
+    for (int frame = 0; frame < 4; ++frame) {
+        runFrame(profiler, *clock, 2.0);
+    }
+    ASSERT_EQ(presets.size(), 3u);
+    EXPECT_EQ(presets[2], "b.milk");
+    EXPECT_DOUBLE_EQ(gpuMs[2], 3.0);
+}
@@ -0,0 +1,57 @@
+#include "headless_player.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <thread>
+
+using AutoVibez::Core::AppStartup;
+using AutoVibez::Core::HeadlessPlayer;
+
+// run() is only left through requestStop() or a signal; start() is not needed for either
+TEST(HeadlessPlayerTest, RunReturnsOnceStopIsRequested) {
+    HeadlessPlayer player(std::make_shared<AppStartup>());
+    std::thread stopper([&player]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        player.requestStop();
+    });
+    const auto started = std::chrono::steady_clock::now();
+    player.run();
+    stopper.join();
+
+    EXPECT_TRUE(player.isStopRequested());
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(5));
+}
+
+TEST(HeadlessPlayerTest, StopRequestedBeforeRunIsKept) {
+    HeadlessPlayer player(std::make_shared<AppStartup>());
+    player.requestStop();
+    player.run();
+    EXPECT_TRUE(player.isStopRequested());
+}
+
+#ifndef _WIN32
+TEST(HeadlessPlayerTest, TerminateSignalEndsRunAndHandlerIsRestored) {
+    // Signals raised before run() installs its handler, or after it restores this one, are ignored
+    std::signal(SIGTERM, SIG_IGN);
+    HeadlessPlayer player(std::make_shared<AppStartup>());
+    std::atomic<bool> returned{false};
+    std::thread signaller([&returned]() {
+        while (!returned.load()) {
+            std::raise(SIGTERM);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+    player.run();
+    returned.store(true);
+    signaller.join();
+
+    EXPECT_TRUE(player.isStopRequested());
+    struct sigaction current {};
+    sigaction(SIGTERM, nullptr, &current);
+    EXPECT_EQ(current.sa_handler, SIG_IGN);
+    std::signal(SIGTERM, SIG_DFL);
+}
+#endif
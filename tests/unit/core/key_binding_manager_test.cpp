@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include <cstring>
+#include <vector>
 
 using namespace AutoVibez::Core;
 
@@ -312,3 +313,50 @@ TEST_F(KeyBindingManagerTest, CallbackExceptionHandling) {
     // Note: This test verifies the current behavior where exceptions propagate
     EXPECT_THROW(keyBindingManager->handleKey(&event), std::runtime_error);
 }
+
+// Test that key repeats of a coalesced action reach its callback once per flush
+TEST_F(KeyBindingManagerTest, CoalescedActionRunsOncePerFlush) {
+    std::vector<int> counts;
+    keyBindingManager->registerCoalescedAction(KeyAction::VOLUME_UP, [&counts](int count) { counts.push_back(count); });
+
+    auto event = createKeyEvent(SDLK_UP);
+    for (int i = 0; i < 12; ++i) {
+        event.key.repeat = i > 0 ? 1 : 0;
+        EXPECT_TRUE(keyBindingManager->handleKey(&event));
+    }
+    EXPECT_TRUE(counts.empty());
+
+    keyBindingManager->flushCoalescedActions();
+    ASSERT_EQ(counts.size(), 1u);
+    EXPECT_EQ(counts[0], 12);
+
+    // Nothing pressed since, so nothing runs
+    keyBindingManager->flushCoalescedActions();
+    EXPECT_EQ(counts.size(), 1u);
+
+    // A plain registration takes the action back
+    bool ranDirectly = false;
+    keyBindingManager->registerAction(KeyAction::VOLUME_UP, [&ranDirectly]() { ranDirectly = true; });
+    keyBindingManager->handleKey(&event);
+    keyBindingManager->flushCoalescedActions();
+    EXPECT_TRUE(ranDirectly);
+    EXPECT_EQ(counts.size(), 1u);
+}
+
+// Test that either side's modifier key matches a binding, as SDL reports only the side held
+TEST_F(KeyBindingManagerTest, EitherSideModifierMatches) {
+    int seeks = 0;
+    keyBindingManager->registerAction(KeyAction::SEEK_FORWARD, [&seeks]() { ++seeks; });
+    bool quit = false;
+    keyBindingManager->registerAction(KeyAction::QUIT_WITH_MODIFIER, [&quit]() { quit = true; });
+
+    auto leftShift = createKeyEvent(SDLK_RIGHT, KMOD_LSHIFT);
+    auto rightShift = createKeyEvent(SDLK_RIGHT, static_cast<SDL_Keymod>(KMOD_RSHIFT | KMOD_NUM));
+    auto leftCtrl = createKeyEvent(SDLK_q, KMOD_LCTRL);
+    EXPECT_TRUE(keyBindingManager->handleKey(&leftShift));
+    EXPECT_TRUE(keyBindingManager->handleKey(&rightShift));
+    EXPECT_TRUE(keyBindingManager->handleKey(&leftCtrl));
+
+    EXPECT_EQ(seeks, 2);
+    EXPECT_TRUE(quit);
+}
@@ -0,0 +1,144 @@
+#include "mix_control_thread.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using AutoVibez::Core::MixControlThread;
+
+namespace {
+// Poll until a condition holds or a generous deadline passes
+template <typename Condition>
+bool waitFor(Condition condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+}  // namespace
+
+TEST(MixControlThreadTest, RunsCommandsInOrderOnTheControlThread) {
+    MixControlThread control(16);
+    std::vector<int> order;
+    std::atomic<int> done{0};
+    std::atomic<bool> onControlThread{true};
+
+    // Posted before start: they run first, in order
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(control.post([&, i] {
+            onControlThread = onControlThread && control.isCurrentThread();
+            order.push_back(i);
+            ++done;
+        }));
+    }
+    control.start(nullptr, std::chrono::milliseconds(50));
+    EXPECT_TRUE(control.isRunning());
+    EXPECT_FALSE(control.isCurrentThread());
+
+    ASSERT_TRUE(waitFor([&] { return done.load() == 3; }));
+    control.stop();
+    EXPECT_TRUE(onControlThread);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(MixControlThreadTest, TicksWhileIdle) {
+    MixControlThread control(16);
+    std::atomic<int> ticks{0};
+    control.start([&] { ++ticks; }, std::chrono::milliseconds(1));
+    EXPECT_TRUE(waitFor([&] { return ticks.load() >= 3; }));
+    control.stop();
+    EXPECT_FALSE(control.isRunning());
+}
+
+TEST(MixControlThreadTest, TickBySleepsUntilWoken) {
+    MixControlThread control(16);
+    std::atomic<int> ticks{0};
+    control.start(
+        [&] {
+            ++ticks;
+            control.tickBy(std::chrono::steady_clock::now() + std::chrono::hours(1));
+        },
+        std::chrono::milliseconds(1));
+    ASSERT_TRUE(waitFor([&] { return ticks.load() == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(ticks.load(), 1);  // Not once per interval
+
+    control.wake();
+    EXPECT_TRUE(waitFor([&] { return ticks.load() == 2; }));
+    control.stop();  // Nor does stopping wait out the hour
+}
+
+TEST(MixControlThreadTest, WakeRacingTheSleepIsSeenWithinATick) {
+    MixControlThread control(16);
+    std::atomic<int> ticks{0};
+    control.start(
+        [&] {
+            ++ticks;
+            control.tickBy(std::chrono::steady_clock::now() + std::chrono::hours(1));
+        },
+        std::chrono::milliseconds(1));
+    ASSERT_TRUE(waitFor([&] { return ticks.load() == 1; }));
+
+    // Each wake() lands a little later after the tick returns, so some catch the thread on its way to sleep
+    for (int i = 1; i < 2000; ++i) {
+        const auto spin = std::chrono::steady_clock::now() + std::chrono::nanoseconds(i % 100 * 200);
+        while (std::chrono::steady_clock::now() < spin) {
+        }
+        control.wake();
+        const auto woken = std::chrono::steady_clock::now();
+        while (ticks.load() == i) {
+            ASSERT_LT(std::chrono::steady_clock::now() - woken, std::chrono::milliseconds(200)) << "wake " << i;
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(ticks.load(), i + 1);
+    }
+    control.stop();
+}
+
+TEST(MixControlThreadTest, EventsRunWhereTheyAreDrained) {
+    MixControlThread control(16);
+    std::atomic<bool> posted{false};
+    std::thread::id ranOn;
+
+    control.start(nullptr, std::chrono::milliseconds(50));
+    control.post([&] {
+        control.postEvent([&] { ranOn = std::this_thread::get_id(); });
+        posted = true;
+    });
+    ASSERT_TRUE(waitFor([&] { return posted.load(); }));
+
+    EXPECT_EQ(control.runEvents(), 1u);
+    EXPECT_EQ(ranOn, std::this_thread::get_id());
+    EXPECT_EQ(control.runEvents(), 0u);
+}
+
+TEST(MixControlThreadTest, EventBudgetLeavesTheRestForTheNextCall) {
+    MixControlThread control(16);
+    std::vector<int> order;
+    for (int i = 0; i < 3; ++i) {
+        control.postEvent([&order, i] {
+            order.push_back(i);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        });
+    }
+
+    // One slow event spends the budget; the others keep their order
+    EXPECT_EQ(control.runEvents(std::chrono::microseconds(500)), 1u);
+    EXPECT_EQ(control.runEvents(), 2u);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(MixControlThreadTest, FullQueueDropsInsteadOfBlocking) {
+    MixControlThread control(2);
+    EXPECT_TRUE(control.post([] {}));
+    EXPECT_TRUE(control.post([] {}));
+    EXPECT_FALSE(control.post([] {}));
+    EXPECT_EQ(control.getDroppedCount(), 1u);
+}
@@ -0,0 +1,75 @@
+#include "multi_output.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using AutoVibez::Core::MultiOutput;
+using AutoVibez::Core::OutputRect;
+
+TEST(MultiOutputTest, ParsesDisplayLists) {
+    std::vector<int> displays;
+    std::string error;
+    ASSERT_TRUE(MultiOutput::parseDisplays("all", 3, displays, error));
+    EXPECT_EQ(displays, (std::vector<int>{0, 1, 2}));
+    ASSERT_TRUE(MultiOutput::parseDisplays(" 2, 0 ", 3, displays, error));
+    EXPECT_EQ(displays, (std::vector<int>{2, 0}));
+
+    EXPECT_FALSE(MultiOutput::parseDisplays("3", 3, displays, error));
+    EXPECT_FALSE(MultiOutput::parseDisplays("1,1", 3, displays, error));
+    EXPECT_FALSE(MultiOutput::parseDisplays("left", 3, displays, error));
+    EXPECT_FALSE(MultiOutput::parseDisplays("", 3, displays, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(MultiOutputTest, SplitsAWallIntoEqualRegions) {
+    const std::vector<OutputRect> wall = {{0, 0, 3840, 2160}, {3840, 0, 3840, 2160}, {7680, 0, 3840, 2160}};
+    const OutputRect canvas = MultiOutput::getCanvas(wall, 0);
+    EXPECT_EQ(canvas.w, 11520);
+    EXPECT_EQ(canvas.h, 2160);
+    const int height = MultiOutput::fitContentHeight(canvas, 3840);
+    EXPECT_EQ(height, 720);
+
+    const std::vector<OutputRect> sources = MultiOutput::computeSources(wall, 0, 3840, height);
+    ASSERT_EQ(sources.size(), 3u);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        EXPECT_EQ(sources[i].x, static_cast<int>(i) * 1280);
+        EXPECT_EQ(sources[i].y, 0);
+        EXPECT_EQ(sources[i].w, 1280);
+        EXPECT_EQ(sources[i].h, 720);
+    }
+}
+
+TEST(MultiOutputTest, BezelsCropBetweenDisplays) {
+    const std::vector<OutputRect> wall = {{0, 0, 3840, 2160}, {3840, 0, 3840, 2160}, {7680, 0, 3840, 2160}};
+    const OutputRect canvas = MultiOutput::getCanvas(wall, 60);
+    EXPECT_EQ(canvas.w, 11520 + 2 * 60);
+
+    const std::vector<OutputRect> sources = MultiOutput::computeSources(wall, 60, 3840, 720);
+    ASSERT_EQ(sources.size(), 3u);
+    EXPECT_EQ(sources[0].x, 0);
+    EXPECT_EQ(sources[2].x + sources[2].w, 3840);
+    // 60 desktop pixels are 20 content pixels that no display shows
+    EXPECT_NEAR(sources[1].x - (sources[0].x + sources[0].w), 20, 1);
+    EXPECT_NEAR(sources[2].x - (sources[1].x + sources[1].w), 20, 1);
+}
+
+TEST(MultiOutputTest, MapsNonRectangularLayouts) {
+    // An L of three displays, the first one left of the primary
+    const std::vector<OutputRect> layout = {{-1920, 0, 1920, 1080}, {0, 0, 1920, 1080}, {-1920, 1080, 1920, 1080}};
+    const OutputRect canvas = MultiOutput::getCanvas(layout, 0);
+    EXPECT_EQ(canvas.x, -1920);
+    EXPECT_EQ(canvas.w, 3840);
+    EXPECT_EQ(canvas.h, 2160);
+
+    const std::vector<OutputRect> sources = MultiOutput::computeSources(layout, 0, 1920, 1080);
+    ASSERT_EQ(sources.size(), 3u);
+    EXPECT_EQ(sources[0].x, 0);
+    EXPECT_EQ(sources[0].y, 0);
+    EXPECT_EQ(sources[1].x, 960);
+    EXPECT_EQ(sources[1].y, 0);
+    EXPECT_EQ(sources[2].x, 0);
+    EXPECT_EQ(sources[2].y, 540);
+    EXPECT_EQ(sources[2].w, 960);
+    EXPECT_EQ(sources[2].h, 540);
+}
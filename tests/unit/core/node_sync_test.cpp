@@ -0,0 +1,163 @@
+#include "node_sync.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace AutoVibez::Core;
+
+namespace {
+constexpr int64_t MS = 1000000;
+
+// The datagram a node would put on the wire
+std::array<uint8_t, SyncPacket::BYTES> wire(const SyncPacket& packet) {
+    std::array<uint8_t, SyncPacket::BYTES> datagram;
+    packet.encode(datagram);
+    return datagram;
+}
+}  // namespace
+
+TEST(NodeSyncTest, PacketsSurviveTheWire) {
+    SyncPacket packet;
+    packet.kind = SyncPacket::Kind::TimeReply;
+    packet.node_id = 0x0123456789abcdefULL;
+    packet.target_id = 42;
+    packet.sent_ns = -5;
+    packet.echoed_ns = 1234567890123LL;
+    packet.received_ns = 987654321;
+    packet.visuals.beat_locked = true;
+    packet.visuals.bpm = 128.5f;
+    packet.visuals.beat_phase = 0.25f;
+    packet.visuals.beat_in_bar = 3;
+    packet.visuals.cut_count = 7;
+    packet.visuals.preset_index = 4096;
+    packet.visuals.preset_seed = 0xdeadbeef;
+    packet.visuals.cut_time_ns = 555 * MS;
+    packet.mix.position_seconds = 3600;
+    packet.mix.position_ms = 3600250;
+    packet.mix.playing = true;
+    packet.mix.id.bytes[0] = 0xab;
+    packet.mix.id.bytes[15] = 0xcd;
+
+    const auto datagram = wire(packet);
+    SyncPacket decoded;
+    ASSERT_TRUE(SyncPacket::decode(datagram.data(), datagram.size(), decoded));
+    EXPECT_EQ(decoded.kind, SyncPacket::Kind::TimeReply);
+    EXPECT_EQ(decoded.node_id, packet.node_id);
+    EXPECT_EQ(decoded.target_id, 42u);
+    EXPECT_EQ(decoded.sent_ns, -5);
+    EXPECT_EQ(decoded.echoed_ns, packet.echoed_ns);
+    EXPECT_EQ(decoded.received_ns, packet.received_ns);
+    EXPECT_TRUE(decoded.visuals.beat_locked);
+    EXPECT_FLOAT_EQ(decoded.visuals.bpm, 128.5f);
+    EXPECT_FLOAT_EQ(decoded.visuals.beat_phase, 0.25f);
+    EXPECT_EQ(decoded.visuals.beat_in_bar, 3);
+    EXPECT_EQ(decoded.visuals.cut_count, 7u);
+    EXPECT_EQ(decoded.visuals.preset_index, 4096u);
+    EXPECT_EQ(decoded.visuals.preset_seed, 0xdeadbeefu);
+    EXPECT_EQ(decoded.visuals.cut_time_ns, 555 * MS);
+    EXPECT_EQ(decoded.mix.position_seconds, 3600);
+    EXPECT_EQ(decoded.mix.position_ms, 3600250);
+    EXPECT_TRUE(decoded.mix.playing);
+    EXPECT_EQ(decoded.mix.id, packet.mix.id);
+
+    EXPECT_FALSE(SyncPacket::decode(datagram.data(), datagram.size() - 1, decoded));
+    auto corrupt = datagram;
+    corrupt[0] = 'X';
+    EXPECT_FALSE(SyncPacket::decode(corrupt.data(), corrupt.size(), decoded));
+}
+
+TEST(NodeSyncTest, ClockOffsetComesFromTheQuickestExchange) {
+    // The leader's clock runs 1 s ahead of this node's
+    ClockOffsetEstimator clock;
+    EXPECT_FALSE(clock.hasEstimate());
+
+    // Queued 30 ms on the way out only: lopsided, so its offset is 15 ms off
+    clock.addSample(0, 1000 * MS + 31 * MS, 1000 * MS + 32 * MS, 33 * MS);
+    EXPECT_EQ(clock.getOffsetNs(), 1000 * MS + 15 * MS);
+    // 1 ms each way
+    clock.addSample(100 * MS, 1101 * MS, 1102 * MS, 103 * MS);
+    EXPECT_EQ(clock.getOffsetNs(), 1000 * MS);
+    EXPECT_EQ(clock.getDelayNs(), 2 * MS);
+
+    // A reply that seems to arrive before it was sent is dropped
+    clock.addSample(200 * MS, 1300 * MS, 1301 * MS, 200 * MS);
+    EXPECT_EQ(clock.getOffsetNs(), 1000 * MS);
+
+    // Older samples age out
+    for (int i = 0; i < Constants::SYNC_CLOCK_SAMPLES; ++i) {
+        const int64_t start = (300 + i * 10) * MS;
+        clock.addSample(start, start + 1000 * MS + 2 * MS, start + 1000 * MS + 3 * MS, start + 5 * MS);
+    }
+    EXPECT_EQ(clock.getDelayNs(), 4 * MS);
+    EXPECT_EQ(clock.getOffsetNs(), 1000 * MS);
+}
+
+TEST(NodeSyncTest, FollowerTimesTheLeaderAndMovesItsStateOntoItsOwnClock) {
+    NodeSync leader(SyncRole::Leader);
+    NodeSync follower(SyncRole::Follower);
+    const int64_t local = NodeSync::nowNs();
+    const int64_t ahead = 1000 * MS;  // The leader's clock, against the follower's
+
+    SyncVisuals visuals;
+    visuals.cut_count = 3;
+    visuals.preset_index = 17;
+    visuals.preset_seed = 99;
+    visuals.cut_time_ns = local + ahead + Constants::SYNC_CUT_LEAD_MS * MS;
+    leader.publishVisuals(visuals);
+
+    SyncPacket reply;
+    auto state = wire(leader.buildState(local + ahead));
+    EXPECT_FALSE(follower.receive(state.data(), state.size(), local + 1 * MS, reply));
+    SyncMix mix;
+    EXPECT_FALSE(follower.getLeaderState(visuals, mix));  // Heard, but not timed yet
+
+    // Asked on the follower's clock, answered on the leader's, 1 ms each way
+    const SyncPacket request = follower.buildTimeRequest(local + 2 * MS);
+    EXPECT_EQ(request.target_id, leader.getNodeId());
+    const auto asked = wire(request);
+    ASSERT_TRUE(leader.receive(asked.data(), asked.size(), local + ahead + 3 * MS, reply));
+    reply.sent_ns = local + ahead + 4 * MS;
+    const auto answered = wire(reply);
+    EXPECT_FALSE(follower.receive(answered.data(), answered.size(), local + 5 * MS, reply));
+
+    EXPECT_EQ(follower.getClockOffsetNs(), ahead);
+    ASSERT_TRUE(follower.getLeaderState(visuals, mix));
+    EXPECT_EQ(visuals.cut_count, 3u);
+    EXPECT_EQ(visuals.preset_index, 17u);
+    EXPECT_EQ(visuals.preset_seed, 99u);
+    EXPECT_EQ(visuals.cut_time_ns, local + Constants::SYNC_CUT_LEAD_MS * MS);
+}
+
+TEST(NodeSyncTest, FollowsOneLeaderAndIgnoresItsOwnPackets) {
+    NodeSync first(SyncRole::Leader);
+    NodeSync second(SyncRole::Leader);
+    NodeSync follower(SyncRole::Follower);
+    const int64_t now = NodeSync::nowNs();
+    SyncPacket reply;
+
+    auto state = wire(first.buildState(now));
+    follower.receive(state.data(), state.size(), now, reply);
+    state = wire(second.buildState(now));
+    follower.receive(state.data(), state.size(), now + 1 * MS, reply);
+    EXPECT_EQ(follower.buildTimeRequest(now).target_id, first.getNodeId());
+
+    // A request meant for the other leader, or a leader's own state, gets no answer
+    const auto request = wire(follower.buildTimeRequest(now));
+    EXPECT_FALSE(second.receive(request.data(), request.size(), now, reply));
+    EXPECT_FALSE(first.receive(state.data(), state.size(), now, reply));
+    EXPECT_TRUE(first.receive(request.data(), request.size(), now, reply));
+
+    // Once the first goes quiet, the second takes over
+    const int64_t later = now + (Constants::SYNC_LEADER_TIMEOUT_MS + 1) * MS;
+    follower.receive(state.data(), state.size(), later, reply);
+    EXPECT_EQ(follower.buildTimeRequest(later).target_id, second.getNodeId());
+}
+
+TEST(NodeSyncTest, ParsesRoles) {
+    SyncRole role = SyncRole::Off;
+    EXPECT_TRUE(NodeSync::parseRole("leader", role));
+    EXPECT_EQ(role, SyncRole::Leader);
+    EXPECT_TRUE(NodeSync::parseRole("follower", role));
+    EXPECT_EQ(role, SyncRole::Follower);
+    EXPECT_FALSE(NodeSync::parseRole("boss", role));
+    EXPECT_EQ(role, SyncRole::Follower);
+}
@@ -0,0 +1,82 @@
+#include "power_policy.hpp"
+
+#include <SDL2/SDL.h>
+#include <gtest/gtest.h>
+
+#include "constants.hpp"
+
+using AutoVibez::Core::PowerPolicy;
+using AutoVibez::Core::PowerSavingMode;
+using AutoVibez::Core::PowerState;
+
+TEST(PowerPolicyTest, ParsesModes) {
+    PowerSavingMode mode = PowerSavingMode::Off;
+    EXPECT_TRUE(PowerPolicy::parseMode("Pause", mode));
+    EXPECT_EQ(mode, PowerSavingMode::Pause);
+    EXPECT_TRUE(PowerPolicy::parseMode("throttle", mode));
+    EXPECT_EQ(mode, PowerSavingMode::Throttle);
+    EXPECT_TRUE(PowerPolicy::parseMode("OFF", mode));
+    EXPECT_EQ(mode, PowerSavingMode::Off);
+    EXPECT_FALSE(PowerPolicy::parseMode("sleep", mode));
+    EXPECT_EQ(mode, PowerSavingMode::Off);
+    EXPECT_STREQ(PowerPolicy::modeName(PowerSavingMode::Throttle), "throttle");
+}
+
+TEST(PowerPolicyTest, OffAlwaysRendersFully) {
+    PowerPolicy policy;
+    policy.configure(PowerSavingMode::Off, 10.0, true);
+    EXPECT_FALSE(policy.onWindowEvent(SDL_WINDOWEVENT_MINIMIZED));
+    EXPECT_FALSE(policy.onWindowEvent(SDL_WINDOWEVENT_FOCUS_LOST));
+    EXPECT_EQ(policy.getState(), PowerState::Full);
+}
+
+TEST(PowerPolicyTest, PausesWhileMinimizedAndResumesOnRestore) {
+    PowerPolicy policy;
+    policy.configure(PowerSavingMode::Pause, 10.0, false);
+    EXPECT_EQ(policy.getState(), PowerState::Full);
+
+    EXPECT_TRUE(policy.onWindowEvent(SDL_WINDOWEVENT_MINIMIZED));
+    EXPECT_EQ(policy.getState(), PowerState::Paused);
+    EXPECT_FALSE(policy.onWindowEvent(SDL_WINDOWEVENT_FOCUS_LOST));
+
+    EXPECT_TRUE(policy.onWindowEvent(SDL_WINDOWEVENT_RESTORED));
+    EXPECT_EQ(policy.getState(), PowerState::Full);
+}
+
+TEST(PowerPolicyTest, ThrottlesWhileHiddenUntilExposed) {
+    PowerPolicy policy;
+    policy.configure(PowerSavingMode::Throttle, 15.0, false);
+
+    EXPECT_TRUE(policy.onWindowEvent(SDL_WINDOWEVENT_HIDDEN));
+    EXPECT_EQ(policy.getState(), PowerState::Throttled);
+    EXPECT_EQ(policy.getIdleIntervalMs(), 67);
+
+    EXPECT_TRUE(policy.onWindowEvent(SDL_WINDOWEVENT_EXPOSED));
+    EXPECT_EQ(policy.getState(), PowerState::Full);
+}
+
+TEST(PowerPolicyTest, UnfocusedOnlyThrottlesWhenEnabled) {
+    PowerPolicy ignoring;
+    ignoring.configure(PowerSavingMode::Pause, 10.0, false);
+    EXPECT_FALSE(ignoring.onWindowEvent(SDL_WINDOWEVENT_FOCUS_LOST));
+    EXPECT_EQ(ignoring.getState(), PowerState::Full);
+
+    // A visible window is still watched, so losing focus never pauses it
+    PowerPolicy policy;
+    policy.configure(PowerSavingMode::Pause, 10.0, true);
+    EXPECT_TRUE(policy.onWindowEvent(SDL_WINDOWEVENT_FOCUS_LOST));
+    EXPECT_EQ(policy.getState(), PowerState::Throttled);
+    EXPECT_TRUE(policy.onWindowEvent(SDL_WINDOWEVENT_FOCUS_GAINED));
+    EXPECT_EQ(policy.getState(), PowerState::Full);
+}
+
+TEST(PowerPolicyTest, IdleRateStaysAboveTheAudioDrainTick) {
+    PowerPolicy policy;
+    policy.configure(PowerSavingMode::Throttle, 1.0, false);
+    policy.onWindowEvent(SDL_WINDOWEVENT_MINIMIZED);
+    EXPECT_EQ(policy.getIdleIntervalMs(), 1000 / Constants::POWER_SAVING_MIN_FPS);
+
+    policy.configure(PowerSavingMode::Pause, 30.0, false);
+    EXPECT_EQ(policy.getState(), PowerState::Paused);
+    EXPECT_EQ(policy.getIdleIntervalMs(), 1000 / Constants::POWER_SAVING_MIN_FPS);
+}
@@ -0,0 +1,59 @@
+#include "preset_cost_tracker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using AutoVibez::Core::PresetCostTracker;
+using AutoVibez::Data::PresetCost;
+
+TEST(PresetCostTrackerTest, EmitsOneSamplePerVisitAfterWarmup) {
+    PresetCostTracker tracker(2, 3, 100);
+    std::vector<PresetCost> samples;
+    tracker.setSink([&](const PresetCost& cost) { samples.push_back(cost); });
+
+    // The two warm-up frames (compile hitch) are not counted
+    tracker.addFrame("a.milk", 50.0, 50.0);
+    tracker.addFrame("a.milk", 50.0, 50.0);
+    for (double ms : {1.0, 2.0, 3.0, 4.0}) {
+        tracker.addFrame("a.milk", ms, ms * 2);
+    }
+    EXPECT_TRUE(samples.empty());
+
+    // Switching presets closes the visit
+    tracker.addFrame("b.milk", 1.0, 1.0);
+    ASSERT_EQ(samples.size(), 1u);
+    EXPECT_EQ(samples[0].path, "a.milk");
+    EXPECT_EQ(samples[0].frames, 4);
+    EXPECT_DOUBLE_EQ(samples[0].cpu_ms, 2.5);
+    EXPECT_DOUBLE_EQ(samples[0].cpu_p95_ms, 4.0);
+    EXPECT_DOUBLE_EQ(samples[0].gpu_p95_ms, 8.0);
+    EXPECT_EQ(tracker.getCurrentPreset(), "b.milk");
+}
+
+TEST(PresetCostTrackerTest, ShortVisitsAreDropped) {
+    PresetCostTracker tracker(0, 3, 100);
+    int samples = 0;
+    tracker.setSink([&](const PresetCost&) { ++samples; });
+
+    tracker.addFrame("a.milk", 1.0, 1.0);
+    tracker.addFrame("a.milk", 1.0, 1.0);
+    tracker.flush();
+    EXPECT_EQ(samples, 0);
+    EXPECT_TRUE(tracker.getCurrentPreset().empty());
+}
+
+TEST(PresetCostTrackerTest, MissingGpuTimesLeaveGpuUnknown) {
+    PresetCostTracker tracker(0, 2, 100);
+    std::vector<PresetCost> samples;
+    tracker.setSink([&](const PresetCost& cost) { samples.push_back(cost); });
+
+    // A GPU time of 0 means the query result never arrived
+    for (int frame = 0; frame < 4; ++frame) {
+        tracker.addFrame("a.milk", 2.0, frame == 0 ? 5.0 : 0.0);
+    }
+    tracker.flush();
+    ASSERT_EQ(samples.size(), 1u);
+    EXPECT_DOUBLE_EQ(samples[0].gpu_p95_ms, -1.0);
+    EXPECT_DOUBLE_EQ(samples[0].getCostMs(), 2.0);
+}
@@ -0,0 +1,109 @@
+#include "preset_preloader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using AutoVibez::Core::PresetPreloader;
+
+class PresetPreloaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "autovibez_preset_preloader_test";
+        std::filesystem::create_directories(test_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir);
+    }
+
+    std::string writePreset(const std::string& name, const std::string& contents) {
+        std::string path = (test_dir / name).string();
+        std::ofstream(path) << contents;
+        return path;
+    }
+
+    // Poll until the preloader settles on a path or a generous deadline passes
+    static PresetPreloader::State waitForResult(const PresetPreloader& preloader, const std::string& path) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        PresetPreloader::State state = preloader.getState(path);
+        while (state == PresetPreloader::State::Loading && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            state = preloader.getState(path);
+        }
+        return state;
+    }
+
+    std::filesystem::path test_dir;
+};
+
+TEST_F(PresetPreloaderTest, ReadsRequestedPreset) {
+    const std::string contents = "[preset00]\nzoom=1.0\n";
+    std::string path = writePreset("a.milk", contents);
+
+    PresetPreloader preloader;
+    EXPECT_EQ(preloader.getState(path), PresetPreloader::State::Idle);
+    preloader.request(path);
+    EXPECT_EQ(waitForResult(preloader, path), PresetPreloader::State::Ready);
+    EXPECT_EQ(preloader.getLoadedBytes(), contents.size());
+}
+
+TEST_F(PresetPreloaderTest, ReportsUnreadablePresets) {
+    std::string empty = writePreset("empty.milk", "");
+    std::string missing = (test_dir / "missing.milk").string();
+
+    PresetPreloader preloader;
+    preloader.request(missing);
+    EXPECT_EQ(waitForResult(preloader, missing), PresetPreloader::State::Failed);
+    preloader.request(empty);
+    EXPECT_EQ(waitForResult(preloader, empty), PresetPreloader::State::Failed);
+}
+
+TEST_F(PresetPreloaderTest, NewerRequestReplacesOlder) {
+    std::string first = writePreset("first.milk", "[preset00]\n");
+    std::string second = writePreset("second.milk", "[preset00]\nzoom=2.0\n");
+
+    PresetPreloader preloader;
+    preloader.request(first);
+    preloader.request(second);
+    EXPECT_EQ(preloader.getState(first), PresetPreloader::State::Idle);
+    EXPECT_EQ(waitForResult(preloader, second), PresetPreloader::State::Ready);
+}
+
+TEST_F(PresetPreloaderTest, ReadPresetCountsBytes) {
+    uint64_t bytes = 0;
+    EXPECT_TRUE(PresetPreloader::readPreset(writePreset("b.milk", "12345"), bytes));
+    EXPECT_EQ(bytes, 5u);
+    EXPECT_FALSE(PresetPreloader::readPreset((test_dir / "none.milk").string(), bytes));
+    EXPECT_EQ(bytes, 0u);
+}
+
+TEST_F(PresetPreloaderTest, ReadPresetReturnsContents) {
+    uint64_t bytes = 0;
+    std::string contents = "stale";
+    EXPECT_TRUE(PresetPreloader::readPreset(writePreset("c.milk", "warp_1=sampler_clouds"), bytes, &contents));
+    EXPECT_EQ(contents, "warp_1=sampler_clouds");
+    EXPECT_FALSE(PresetPreloader::readPreset((test_dir / "none.milk").string(), bytes, &contents));
+    EXPECT_TRUE(contents.empty());
+}
+
+TEST_F(PresetPreloaderTest, HandsReadPresetsToCallback) {
+    std::string path = writePreset("d.milk", "[preset00]\n");
+    std::mutex mutex;
+    std::string received;
+
+    PresetPreloader preloader;
+    preloader.setReadCallback([&](const std::string& contents) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received = contents;
+    });
+    preloader.request(path);
+    // The callback runs before the preset is marked Ready
+    ASSERT_EQ(waitForResult(preloader, path), PresetPreloader::State::Ready);
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received, "[preset00]\n");
+}
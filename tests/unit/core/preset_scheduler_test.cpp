@@ -0,0 +1,135 @@
+#include "preset_scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using AutoVibez::Core::MusicSection;
+using AutoVibez::Core::PresetScheduler;
+using AutoVibez::Core::PresetTier;
+
+namespace {
+
+constexpr double BUDGET_MS = 16.0;
+
+// Ten presets of each tier against a 16 ms budget, plus two never measured
+class PresetSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::unordered_map<std::string, double> costs;
+        for (int i = 0; i < 10; ++i) {
+            addPreset("light" + std::to_string(i), 1.0 + 0.1 * i, costs);
+            addPreset("medium" + std::to_string(i), 6.0 + 0.1 * i, costs);
+            addPreset("heavy" + std::to_string(i), 11.0 + 0.1 * i, costs);
+        }
+        paths.push_back("new0");
+        paths.push_back("new1");
+        scheduler.rebuild(paths, costs, BUDGET_MS);
+    }
+
+    void addPreset(const std::string& path, double costMs, std::unordered_map<std::string, double>& costs) {
+        paths.push_back(path);
+        costs[path] = costMs;
+    }
+
+    // Draws per tier over many draws
+    std::array<int, PresetScheduler::TIER_COUNT> drawTiers(int draws) {
+        std::array<int, PresetScheduler::TIER_COUNT> counts{};
+        for (int i = 0; i < draws; ++i) {
+            const uint32_t index = scheduler.draw(random, UINT32_MAX);
+            EXPECT_LT(index, paths.size());
+            counts[static_cast<size_t>(scheduler.getTier(index))]++;
+        }
+        return counts;
+    }
+
+    std::vector<std::string> paths;
+    PresetScheduler scheduler;
+    std::mt19937 random{42};
+};
+
+}  // namespace
+
+TEST_F(PresetSchedulerTest, SortsPresetsIntoTiersByShareOfTheBudget) {
+    ASSERT_EQ(scheduler.size(), paths.size());
+    EXPECT_EQ(scheduler.getTier(0), PresetTier::Light);
+    EXPECT_EQ(scheduler.getTier(1), PresetTier::Medium);
+    EXPECT_EQ(scheduler.getTier(2), PresetTier::Heavy);
+    EXPECT_EQ(scheduler.getTier(30), PresetTier::Medium);  // Unmeasured
+
+    scheduler.setCost("light0", 12.0);
+    EXPECT_EQ(scheduler.getTier(0), PresetTier::Heavy);
+}
+
+TEST_F(PresetSchedulerTest, IntensityPicksTheSectionWithHysteresis) {
+    EXPECT_EQ(scheduler.getSection(), MusicSection::Groove);
+    EXPECT_TRUE(scheduler.update(0.3, 0.5, BUDGET_MS));
+    EXPECT_EQ(scheduler.getSection(), MusicSection::Breakdown);
+
+    // Just past the boundary is not enough to leave the breakdown
+    EXPECT_FALSE(scheduler.update(1.0, 1.5, BUDGET_MS));
+    EXPECT_EQ(scheduler.getSection(), MusicSection::Breakdown);
+
+    EXPECT_TRUE(scheduler.update(1.6, 8.0, BUDGET_MS));
+    EXPECT_EQ(scheduler.getSection(), MusicSection::Peak);
+    EXPECT_NEAR(scheduler.getIntensity(), 1.0, 1e-9);
+}
+
+TEST_F(PresetSchedulerTest, PeaksFavourHeavyPresetsAndBreakdownsLightOnes) {
+    scheduler.update(1.6, 8.0, BUDGET_MS);
+    const auto peak = drawTiers(3000);
+    EXPECT_GT(peak[static_cast<size_t>(PresetTier::Heavy)], peak[static_cast<size_t>(PresetTier::Medium)]);
+    EXPECT_GT(peak[static_cast<size_t>(PresetTier::Medium)], peak[static_cast<size_t>(PresetTier::Light)]);
+
+    scheduler.update(0.2, 0.0, BUDGET_MS);
+    const auto breakdown = drawTiers(3000);
+    EXPECT_GT(breakdown[static_cast<size_t>(PresetTier::Light)], breakdown[static_cast<size_t>(PresetTier::Medium)]);
+    EXPECT_GT(breakdown[static_cast<size_t>(PresetTier::Medium)], breakdown[static_cast<size_t>(PresetTier::Heavy)]);
+}
+
+TEST_F(PresetSchedulerTest, PresetsOverTheRenderBudgetAreNotDrawn) {
+    scheduler.update(1.6, 8.0, 11.45);
+    EXPECT_TRUE(scheduler.fits(2));    // heavy0, 11.0 ms
+    EXPECT_FALSE(scheduler.fits(29));  // heavy9, 11.9 ms
+    for (int i = 0; i < 2000; ++i) {
+        const uint32_t index = scheduler.draw(random, UINT32_MAX);
+        EXPECT_LT(index, paths.size());
+        EXPECT_TRUE(scheduler.fits(index)) << paths[index];
+    }
+
+    // No heavy preset fits: their share goes to the other tiers
+    scheduler.update(1.6, 8.0, 7.0);
+    const auto counts = drawTiers(1000);
+    EXPECT_EQ(counts[static_cast<size_t>(PresetTier::Heavy)], 0);
+    EXPECT_GT(counts[static_cast<size_t>(PresetTier::Medium)], 0);
+}
+
+TEST_F(PresetSchedulerTest, AvoidsTheCurrentPreset) {
+    std::unordered_map<std::string, double> costs{{"a", 1.0}, {"b", 1.1}};
+    scheduler.rebuild({"a", "b"}, costs, BUDGET_MS);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(scheduler.draw(random, 0), 1u);
+    }
+
+    // Only the current preset is eligible
+    scheduler.rebuild({"a"}, costs, BUDGET_MS);
+    EXPECT_EQ(scheduler.draw(random, 0), UINT32_MAX);
+    EXPECT_EQ(scheduler.draw(random, UINT32_MAX), 0u);
+}
+
+TEST_F(PresetSchedulerTest, BrightnessCountsWhenTheCentroidIsKnown) {
+    scheduler.update(1.0, 3.0, BUDGET_MS);
+    EXPECT_NEAR(scheduler.getIntensity(), 0.5, 1e-9);
+
+    // Same loudness and onsets, filtered down to a dark breakdown
+    scheduler.update(0.8, 1.0, BUDGET_MS, 500.0);
+    EXPECT_EQ(scheduler.getSection(), MusicSection::Breakdown);
+    EXPECT_LT(scheduler.getIntensity(), 0.2);
+
+    scheduler.update(1.0, 3.0, BUDGET_MS, 3000.0);
+    EXPECT_NEAR(scheduler.getIntensity(), 2.0 / 3.0, 1e-9);
+}
@@ -0,0 +1,25 @@
+#include "preset_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using AutoVibez::Core::PresetTable;
+
+TEST(PresetTableTest, LooksUpPathsAndDisplayNames) {
+    PresetTable table;
+    table.assign({"/presets/pack/Geiss - Wave.milk", "bare.milk", "C:\\presets\\win.milk"});
+    ASSERT_EQ(table.size(), 3u);
+    EXPECT_EQ(table.getPath(0), "/presets/pack/Geiss - Wave.milk");
+    EXPECT_EQ(table.getDisplayName(0), "Geiss - Wave.milk");
+    EXPECT_EQ(table.getDisplayName(1), "bare.milk");
+    EXPECT_EQ(table.getDisplayName(2), "win.milk");
+}
+
+TEST(PresetTableTest, OutOfRangeIsEmpty) {
+    PresetTable table;
+    EXPECT_TRUE(table.getPath(0).empty());
+    table.assign({"/presets/a.milk"});
+    EXPECT_TRUE(table.getDisplayName(5).empty());
+}
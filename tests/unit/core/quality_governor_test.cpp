@@ -0,0 +1,101 @@
+#include "quality_governor.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Core::QualityBounds;
+using AutoVibez::Core::QualityGovernor;
+
+class QualityGovernorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        QualityBounds bounds;
+        bounds.min_mesh_x = 16;
+        bounds.max_mesh_x = 32;
+        bounds.min_fps = 40;
+        bounds.max_fps = 60;
+        bounds.min_render_scale = 0.5;
+        bounds.max_render_scale = 1.0;
+        governor.setBounds(bounds, 0.75);
+    }
+
+    // Feed frames until the settings change or the count runs out
+    bool runFrames(double cpuMs, double gpuMs, int frames = 2000) {
+        for (int i = 0; i < frames; ++i) {
+            if (governor.addFrame(cpuMs, gpuMs)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    QualityGovernor governor;
+};
+
+TEST_F(QualityGovernorTest, StartsAtTheTop) {
+    EXPECT_EQ(governor.getSettings().mesh_x, 32);
+    EXPECT_EQ(governor.getSettings().mesh_y, 24);
+    EXPECT_EQ(governor.getSettings().fps, 60);
+    EXPECT_DOUBLE_EQ(governor.getSettings().render_scale, 1.0);
+    EXPECT_FALSE(runFrames(10.0, 5.0));
+}
+
+TEST_F(QualityGovernorTest, GpuBoundFramesLowerRenderScaleFirst) {
+    ASSERT_TRUE(runFrames(4.0, 16.0));
+    EXPECT_NEAR(governor.getSettings().render_scale, 0.9, 1e-9);
+    EXPECT_EQ(governor.getSettings().mesh_x, 32);
+    EXPECT_NE(governor.getLastDecision().find("render scale"), std::string::npos);
+}
+
+TEST_F(QualityGovernorTest, CpuBoundFramesLowerMeshFirst) {
+    ASSERT_TRUE(runFrames(16.0, 4.0));
+    EXPECT_EQ(governor.getSettings().mesh_x, 24);
+    EXPECT_EQ(governor.getSettings().mesh_y, 18);
+    EXPECT_DOUBLE_EQ(governor.getSettings().render_scale, 1.0);
+}
+
+TEST_F(QualityGovernorTest, FrameRateDropsLastAndStopsAtTheFloor) {
+    while (runFrames(30.0, 0.0)) {
+    }
+    EXPECT_EQ(governor.getSettings().mesh_x, 16);
+    EXPECT_EQ(governor.getSettings().fps, 40);
+    EXPECT_DOUBLE_EQ(governor.getSettings().render_scale, 1.0);
+}
+
+TEST_F(QualityGovernorTest, RecoversOnlyWhatFits) {
+    while (runFrames(4.0, 30.0)) {
+    }
+    ASSERT_EQ(governor.getSettings().fps, 40);
+
+    // Cheap frames bring everything back, the frame rate first
+    ASSERT_TRUE(runFrames(2.0, 2.0));
+    EXPECT_EQ(governor.getSettings().fps, 50);
+    while (runFrames(2.0, 2.0)) {
+    }
+    EXPECT_EQ(governor.getSettings().fps, 60);
+    EXPECT_EQ(governor.getSettings().mesh_x, 32);
+    EXPECT_DOUBLE_EQ(governor.getSettings().render_scale, 1.0);
+}
+
+TEST_F(QualityGovernorTest, HysteresisHoldsBetweenTheMarks) {
+    ASSERT_TRUE(runFrames(16.0, 4.0));
+    ASSERT_EQ(governor.getSettings().mesh_x, 24);
+
+    // Inside the band nothing moves
+    EXPECT_FALSE(runFrames(12.0, 4.0));
+    // Calm frames whose next step (a third more columns and rows) would overshoot the high mark stay put
+    EXPECT_FALSE(runFrames(9.5, 4.0));
+    EXPECT_EQ(governor.getSettings().mesh_x, 24);
+    EXPECT_TRUE(runFrames(7.0, 4.0));
+    EXPECT_EQ(governor.getSettings().mesh_x, 32);
+}
+
+TEST_F(QualityGovernorTest, ProfilesFromRenderer) {
+    EXPECT_EQ(QualityGovernor::detectProfile("llvmpipe (LLVM 15.0.7, 256 bits)"), "low");
+    EXPECT_EQ(QualityGovernor::detectProfile("Mesa Intel(R) UHD Graphics 620 (KBL GT2)"), "medium");
+    EXPECT_EQ(QualityGovernor::detectProfile("NVIDIA GeForce RTX 3070/PCIe/SSE2"), "high");
+
+    QualityBounds bounds;
+    EXPECT_TRUE(QualityGovernor::getProfileBounds("low", bounds));
+    EXPECT_LT(bounds.min_mesh_x, Constants::DEFAULT_MESH_X);
+    EXPECT_FALSE(QualityGovernor::getProfileBounds("ultra", bounds));
+}
@@ -0,0 +1,189 @@
+#include "remote_control_server.hpp"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "constants.hpp"
+
+using namespace AutoVibez::Core;
+
+namespace {
+// Actions the handler was given, from the server thread
+struct ReceivedActions {
+    std::mutex mutex;
+    std::vector<KeyAction> actions;
+
+    RemoteControlServer::ActionHandler handler() {
+        return [this](KeyAction action) {
+            std::lock_guard<std::mutex> lock(mutex);
+            actions.push_back(action);
+            return true;
+        };
+    }
+    std::vector<KeyAction> get() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return actions;
+    }
+};
+
+int connectTo(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// One request on a fresh connection, read until the server closes it
+std::string fetch(uint16_t port, const std::string& request) {
+    const int fd = connectTo(port);
+    std::string response;
+    if (fd >= 0 && send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+        char buffer[4096];
+        ssize_t got;
+        while ((got = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, static_cast<size_t>(got));
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return response;
+}
+
+// Read until the text appears or a generous deadline passes
+bool readUntil(int fd, std::string& received, const std::string& text) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (received.find(text) == std::string::npos) {
+        const auto left =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd polled{fd, POLLIN, 0};
+        if (left.count() <= 0 || poll(&polled, 1, static_cast<int>(left.count())) <= 0) {
+            return false;
+        }
+        char buffer[4096];
+        const ssize_t got = recv(fd, buffer, sizeof(buffer), 0);
+        if (got <= 0) {
+            return false;
+        }
+        received.append(buffer, static_cast<size_t>(got));
+    }
+    return true;
+}
+
+// A masked client text frame
+std::string textFrame(const std::string& text) {
+    const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::string frame;
+    frame += static_cast<char>(0x81);
+    frame += static_cast<char>(0x80 | text.size());
+    frame.append(reinterpret_cast<const char*>(mask), 4);
+    for (size_t i = 0; i < text.size(); ++i) {
+        frame += static_cast<char>(text[i] ^ mask[i % 4]);
+    }
+    return frame;
+}
+
+std::string upgradeRequest() {
+    return std::string("GET ") + StringConstants::REMOTE_EVENTS_PATH +
+           " HTTP/1.1\r\nHost: node\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+           "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+}
+}  // namespace
+
+TEST(RemoteControlServerTest, RunsActionsPostedOverHttp) {
+    ReceivedActions received;
+    RemoteControlServer server;
+    ASSERT_TRUE(server.start(0, "", received.handler()));
+    ASSERT_NE(server.getPort(), 0);
+
+    const std::string actions = StringConstants::REMOTE_ACTIONS_PATH;
+    const std::string list = fetch(server.getPort(), "GET " + actions + " HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(list.rfind("HTTP/1.1 200", 0), 0u);
+    EXPECT_NE(list.find("\"next_mix\""), std::string::npos);
+
+    EXPECT_EQ(fetch(server.getPort(), "POST " + actions + "/next_mix HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 202", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), "POST " + actions + "/quit HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), "GET " + actions + "/next_mix HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0), 0u);
+    EXPECT_EQ(received.get(), std::vector<KeyAction>{KeyAction::NEXT_MIX});
+
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+}
+
+TEST(RemoteControlServerTest, RequiresTheTokenWhenSet) {
+    ReceivedActions received;
+    RemoteControlServer server;
+    ASSERT_TRUE(server.start(0, "secret", received.handler()));
+
+    const std::string post = std::string("POST ") + StringConstants::REMOTE_ACTIONS_PATH + "/volume_up HTTP/1.1\r\n";
+    EXPECT_EQ(fetch(server.getPort(), post + "\r\n").rfind("HTTP/1.1 401", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), post + "Authorization: Bearer wrong\r\n\r\n").rfind("HTTP/1.1 401", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), post + "Authorization: Bearer secre\r\n\r\n").rfind("HTTP/1.1 401", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), post + "Authorization: Bearer secrets\r\n\r\n").rfind("HTTP/1.1 401", 0), 0u);
+    const std::string partial = std::string("POST ") + StringConstants::REMOTE_ACTIONS_PATH + "/volume_up?token=secre";
+    EXPECT_EQ(fetch(server.getPort(), partial + " HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 401", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), post + "Authorization: Bearer secret\r\n\r\n").rfind("HTTP/1.1 202", 0), 0u);
+    const std::string query = std::string("POST ") + StringConstants::REMOTE_ACTIONS_PATH + "/volume_up?token=secret";
+    EXPECT_EQ(fetch(server.getPort(), query + " HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 202", 0), 0u);
+    EXPECT_EQ(received.get(), (std::vector<KeyAction>{KeyAction::VOLUME_UP, KeyAction::VOLUME_UP}));
+}
+
+TEST(RemoteControlServerTest, WebSocketPushesEventsAndTakesActions) {
+    ReceivedActions received;
+    RemoteControlServer server;
+    ASSERT_TRUE(server.start(0, "", received.handler()));
+    server.publish("now_playing", "{\"title\":\"First\"}");
+
+    const int fd = connectTo(server.getPort());
+    ASSERT_GE(fd, 0);
+    const std::string upgrade = upgradeRequest();
+    ASSERT_EQ(send(fd, upgrade.data(), upgrade.size(), 0), static_cast<ssize_t>(upgrade.size()));
+
+    // The accept key of the RFC 6455 example, then the latest event of each type
+    std::string stream;
+    ASSERT_TRUE(readUntil(fd, stream, "\r\n\r\n"));
+    EXPECT_EQ(stream.rfind("HTTP/1.1 101", 0), 0u);
+    EXPECT_NE(stream.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"), std::string::npos);
+    EXPECT_TRUE(readUntil(fd, stream, "{\"type\":\"now_playing\",\"data\":{\"title\":\"First\"}}"));
+
+    server.publish("now_playing", "{\"title\":\"Second\"}");
+    EXPECT_TRUE(readUntil(fd, stream, "\"Second\""));
+
+    const std::string command = textFrame("{\"action\":\"pause_resume\"}") + textFrame("nonsense");
+    ASSERT_EQ(send(fd, command.data(), command.size(), 0), static_cast<ssize_t>(command.size()));
+    EXPECT_TRUE(readUntil(fd, stream, "{\"type\":\"ack\",\"data\":\"pause_resume\"}"));
+    EXPECT_TRUE(readUntil(fd, stream, "{\"type\":\"error\""));
+    EXPECT_EQ(received.get(), std::vector<KeyAction>{KeyAction::PAUSE_RESUME_MIX});
+
+    // The newest now_playing data also answers a plain GET
+    const std::string nowPlaying =
+        fetch(server.getPort(), std::string("GET ") + StringConstants::REMOTE_NOW_PLAYING_PATH + " HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(nowPlaying.substr(nowPlaying.find("\r\n\r\n") + 4), "{\"title\":\"Second\"}");
+
+    close(fd);
+    server.stop();
+}
+
+TEST(RemoteControlServerTest, EveryActionNameIsDistinctAndKnown) {
+    for (const auto& [name, action] : RemoteControlServer::getRemoteActions()) {
+        EXPECT_EQ(RemoteControlServer::findRemoteAction(name), action) << name;
+        EXPECT_NE(action, KeyAction::UNKNOWN) << name;
+    }
+    EXPECT_EQ(RemoteControlServer::findRemoteAction("quit"), KeyAction::UNKNOWN);
+}
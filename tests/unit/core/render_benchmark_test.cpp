@@ -0,0 +1,105 @@
+#include "render_benchmark.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+using AutoVibez::Core::BenchmarkOptions;
+using AutoVibez::Core::PresetBenchmark;
+using AutoVibez::Core::RenderBenchmark;
+using AutoVibez::Core::TimingSummary;
+
+class RenderBenchmarkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "render_benchmark_test";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root / "nested");
+        std::ofstream(root / "b.milk").close();
+        std::ofstream(root / "a.milk").close();
+        std::ofstream(root / "nested" / "c.prjm").close();
+        std::ofstream(root / "notes.txt").close();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    std::filesystem::path root;
+};
+
+TEST_F(RenderBenchmarkTest, ParsesArguments) {
+    const char* args[] = {"bench",   "presets", "--frames", "120",      "--warmup", "0",
+                          "--size",  "640x360", "--audio",  "sweep",    "--output", "out.json"};
+    BenchmarkOptions options;
+    std::string error;
+    ASSERT_TRUE(RenderBenchmark::parseArgs(12, const_cast<char**>(args), 1, options, error)) << error;
+    EXPECT_EQ(options.presets, "presets");
+    EXPECT_EQ(options.frames, 120);
+    EXPECT_EQ(options.warmup, 0);
+    EXPECT_EQ(options.width, 640);
+    EXPECT_EQ(options.height, 360);
+    EXPECT_EQ(options.audio, "sweep");
+    EXPECT_EQ(options.output, "out.json");
+
+    const char* bad[] = {"bench", "presets", "--size", "large"};
+    EXPECT_FALSE(RenderBenchmark::parseArgs(4, const_cast<char**>(bad), 1, options, error));
+    const char* missing[] = {"bench", "--frames", "10"};
+    BenchmarkOptions empty;
+    EXPECT_FALSE(RenderBenchmark::parseArgs(3, const_cast<char**>(missing), 1, empty, error));
+}
+
+TEST_F(RenderBenchmarkTest, SummarizesWithNearestRank) {
+    std::vector<double> samples;
+    for (int i = 100; i >= 1; --i) {
+        samples.push_back(static_cast<double>(i));
+    }
+    const TimingSummary summary = RenderBenchmark::summarize(samples);
+    EXPECT_EQ(summary.samples, 100u);
+    EXPECT_DOUBLE_EQ(summary.mean_ms, 50.5);
+    EXPECT_DOUBLE_EQ(summary.p50_ms, 50.0);
+    EXPECT_DOUBLE_EQ(summary.p99_ms, 99.0);
+    EXPECT_DOUBLE_EQ(summary.max_ms, 100.0);
+
+    EXPECT_EQ(RenderBenchmark::summarize({}).samples, 0u);
+}
+
+TEST_F(RenderBenchmarkTest, ListsPresetsInAStableOrder) {
+    std::vector<std::string> presets;
+    std::string error;
+    ASSERT_TRUE(RenderBenchmark::listPresets(root.string(), presets, error)) << error;
+    ASSERT_EQ(presets.size(), 3u);
+    EXPECT_EQ(std::filesystem::path(presets[0]).filename(), "a.milk");
+    EXPECT_EQ(std::filesystem::path(presets[1]).filename(), "b.milk");
+    EXPECT_EQ(std::filesystem::path(presets[2]).filename(), "c.prjm");
+
+    // A list keeps its own order and resolves relative paths next to itself
+    std::ofstream(root / "list.txt") << "# baseline set\nb.milk\n\n  nested/c.prjm  # slow one\n";
+    ASSERT_TRUE(RenderBenchmark::listPresets((root / "list.txt").string(), presets, error)) << error;
+    ASSERT_EQ(presets.size(), 2u);
+    EXPECT_EQ(std::filesystem::path(presets[0]), root / "b.milk");
+    EXPECT_EQ(std::filesystem::path(presets[1]), root / "nested" / "c.prjm");
+
+    EXPECT_FALSE(RenderBenchmark::listPresets((root / "missing.txt").string(), presets, error));
+}
+
+TEST_F(RenderBenchmarkTest, ReportHasOneEntryPerPreset) {
+    BenchmarkOptions options;
+    PresetBenchmark loaded;
+    loaded.path = "a \"quoted\".milk";
+    loaded.cpu = RenderBenchmark::summarize({1.0, 2.0});
+    loaded.peak_memory_kb = 2048;
+    PresetBenchmark failed;
+    failed.path = "b.milk";
+    failed.error = "bad shader";
+
+    const std::string json = RenderBenchmark::toJson(options, {loaded, failed}, "Test GPU", false);
+    EXPECT_NE(json.find("\"format\": \"autovibez-render-bench-1\""), std::string::npos);
+    EXPECT_NE(json.find("\"renderer\": \"Test GPU\""), std::string::npos);
+    EXPECT_NE(json.find("\"path\": \"a \\\"quoted\\\".milk\""), std::string::npos);
+    EXPECT_NE(json.find("\"samples\": 2"), std::string::npos);
+    EXPECT_NE(json.find("\"gpu_ms\": null"), std::string::npos);
+    EXPECT_NE(json.find("\"error\": \"bad shader\""), std::string::npos);
+    EXPECT_NE(json.find("\"peak_memory_kb\": 2048"), std::string::npos);
+}
@@ -0,0 +1,52 @@
+#include "resize_coalescer.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Core::ResizeCoalescer;
+using std::chrono::milliseconds;
+
+class ResizeCoalescerTest : public ::testing::Test {
+protected:
+    ResizeCoalescer coalescer{milliseconds(100)};
+    ResizeCoalescer::Clock::time_point start = ResizeCoalescer::Clock::now();
+    int width = 0;
+    int height = 0;
+};
+
+TEST_F(ResizeCoalescerTest, DragEndsInOneResize) {
+    coalescer.setApplied(800, 600);
+    for (int i = 1; i <= 20; ++i) {
+        EXPECT_TRUE(coalescer.onResize(800 + i * 10, 600, start + milliseconds(i * 16)));
+        EXPECT_FALSE(coalescer.poll(start + milliseconds(i * 16 + 1), width, height));
+    }
+    EXPECT_TRUE(coalescer.isPending());
+
+    const auto lastChange = start + milliseconds(20 * 16);
+    EXPECT_FALSE(coalescer.poll(lastChange + milliseconds(99), width, height));
+    ASSERT_TRUE(coalescer.poll(lastChange + milliseconds(100), width, height));
+    EXPECT_EQ(width, 1000);
+    EXPECT_EQ(height, 600);
+    EXPECT_FALSE(coalescer.isPending());
+    EXPECT_FALSE(coalescer.poll(lastChange + milliseconds(500), width, height));
+}
+
+TEST_F(ResizeCoalescerTest, RepeatedSizesAreNotChanges) {
+    coalescer.setApplied(800, 600);
+    EXPECT_FALSE(coalescer.onResize(800, 600, start));
+    EXPECT_FALSE(coalescer.isPending());
+
+    // SDL reports the same change as RESIZED and SIZE_CHANGED; the second must not restart the wait
+    EXPECT_TRUE(coalescer.onResize(1920, 1080, start));
+    EXPECT_FALSE(coalescer.onResize(1920, 1080, start + milliseconds(90)));
+    EXPECT_TRUE(coalescer.poll(start + milliseconds(100), width, height));
+    EXPECT_FALSE(coalescer.onResize(1920, 1080, start + milliseconds(200)));
+}
+
+TEST_F(ResizeCoalescerTest, DirectApplyDropsThePendingSize) {
+    coalescer.setApplied(800, 600);
+    EXPECT_TRUE(coalescer.onResize(1024, 768, start));
+    coalescer.setApplied(1280, 720);
+    EXPECT_FALSE(coalescer.isPending());
+    EXPECT_FALSE(coalescer.poll(start + milliseconds(200), width, height));
+    EXPECT_FALSE(coalescer.onResize(1280, 720, start + milliseconds(300)));
+}
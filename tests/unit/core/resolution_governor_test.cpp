@@ -0,0 +1,73 @@
+#include "resolution_governor.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Core::ResolutionGovernor;
+
+namespace {
+// Feed frames until the scale changes or the count runs out
+bool runFrames(ResolutionGovernor& governor, double renderMs, int frames) {
+    for (int i = 0; i < frames; ++i) {
+        if (governor.addFrame(renderMs)) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace
+
+TEST(ResolutionGovernorTest, HoldsScaleInsideTheBand) {
+    ResolutionGovernor governor(0.5, 1.0);
+    governor.setBudgetMs(10.0);
+    EXPECT_FALSE(runFrames(governor, 6.0, 300));
+    EXPECT_DOUBLE_EQ(governor.getScale(), 1.0);
+}
+
+TEST(ResolutionGovernorTest, ScalesDownWhenRenderIsOverBudget) {
+    ResolutionGovernor governor(0.5, 1.0);
+    governor.setBudgetMs(10.0);
+    ASSERT_TRUE(runFrames(governor, 12.0, Constants::RENDER_SCALE_WINDOW_FRAMES));
+    // One step at most per decision
+    EXPECT_NEAR(governor.getScale(), 1.0 - Constants::RENDER_SCALE_MAX_STEP, 1e-9);
+
+    // Keeps falling to the floor and no further
+    EXPECT_TRUE(runFrames(governor, 12.0, 1000));
+    runFrames(governor, 12.0, 1000);
+    runFrames(governor, 12.0, 1000);
+    EXPECT_DOUBLE_EQ(governor.getScale(), 0.5);
+    EXPECT_FALSE(runFrames(governor, 12.0, 1000));
+}
+
+TEST(ResolutionGovernorTest, ScalesBackUpWhenThereIsHeadroom) {
+    ResolutionGovernor governor(0.5, 1.0);
+    governor.setBudgetMs(10.0);
+    ASSERT_TRUE(runFrames(governor, 12.0, 1000));
+    ASSERT_TRUE(runFrames(governor, 12.0, 1000));
+    const double lowered = governor.getScale();
+
+    ASSERT_TRUE(runFrames(governor, 2.0, 1000));
+    EXPECT_GT(governor.getScale(), lowered);
+    EXPECT_TRUE(runFrames(governor, 2.0, 1000));
+    EXPECT_DOUBLE_EQ(governor.getScale(), 1.0);
+    EXPECT_FALSE(runFrames(governor, 2.0, 1000));
+}
+
+TEST(ResolutionGovernorTest, SkipsFramesAfterAChange) {
+    ResolutionGovernor governor(0.5, 1.0);
+    governor.setBudgetMs(10.0);
+    ASSERT_TRUE(runFrames(governor, 12.0, 1000));
+    // The next decision waits for the settle frames plus a full window
+    EXPECT_FALSE(runFrames(governor, 12.0,
+                           Constants::RENDER_SCALE_SETTLE_FRAMES + Constants::RENDER_SCALE_WINDOW_FRAMES - 1));
+    EXPECT_TRUE(governor.addFrame(12.0));
+}
+
+TEST(ResolutionGovernorTest, ClampsToLimits) {
+    ResolutionGovernor governor(0.5, 0.75);
+    EXPECT_DOUBLE_EQ(governor.getScale(), 0.75);
+    governor.setLimits(0.25, 0.5);
+    EXPECT_DOUBLE_EQ(governor.getScale(), 0.5);
+    governor.setBudgetMs(10.0);
+    EXPECT_FALSE(runFrames(governor, 1.0, 1000));
+    EXPECT_FALSE(governor.addFrame(0.0));
+}
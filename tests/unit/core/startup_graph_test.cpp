@@ -0,0 +1,112 @@
+#include "startup_graph.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using AutoVibez::Core::StartupGraph;
+using AutoVibez::Core::StartupTaskTiming;
+
+TEST(StartupGraphTest, RunsEachTaskAfterWhatItNeeds) {
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name) {
+        return [&, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    StartupGraph graph(3);
+    ASSERT_TRUE(graph.add("config", {}, record("config")));
+    ASSERT_TRUE(graph.add("assets", {"config"}, record("assets")));
+    ASSERT_TRUE(graph.add("presets", {"assets"}, record("presets")));
+    ASSERT_TRUE(graph.add("manifest", {"config"}, record("manifest")));
+    ASSERT_TRUE(graph.add("volume", {}, record("volume")));
+    graph.start();
+    EXPECT_TRUE(graph.wait("presets"));
+    graph.waitAll();
+
+    auto position = [&](const std::string& name) {
+        return std::find(order.begin(), order.end(), name) - order.begin();
+    };
+    ASSERT_EQ(order.size(), 5u);
+    EXPECT_LT(position("config"), position("assets"));
+    EXPECT_LT(position("assets"), position("presets"));
+    EXPECT_LT(position("config"), position("manifest"));
+    EXPECT_EQ(graph.getTimings().size(), 5u);
+}
+
+TEST(StartupGraphTest, IndependentTasksRunAtTheSameTime) {
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    auto task = [&]() {
+        const int now = ++running;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        --running;
+    };
+
+    StartupGraph graph(2);
+    graph.add("database", {}, task);
+    graph.add("manifest", {}, task);
+    graph.start();
+    graph.waitAll();
+    EXPECT_EQ(peak.load(), 2);
+}
+
+TEST(StartupGraphTest, RejectsUnknownDependenciesAndTakenNames) {
+    StartupGraph graph(1);
+    EXPECT_FALSE(graph.add("assets", {"config"}, []() {}));
+    EXPECT_TRUE(graph.add("config", {}, []() {}));
+    EXPECT_FALSE(graph.add("config", {}, []() {}));
+    EXPECT_FALSE(graph.wait("assets"));
+    graph.start();
+}
+
+TEST(StartupGraphTest, SkipsWhatDependsOnAFailedTask) {
+    std::atomic<bool> ranDependent{false};
+    StartupGraph graph(2);
+    graph.add("config", {}, []() { throw std::runtime_error("unreadable"); });
+    graph.add("assets", {"config"}, [&]() { ranDependent = true; });
+    graph.add("volume", {}, []() {});
+    graph.start();
+
+    EXPECT_FALSE(graph.wait("config"));
+    EXPECT_FALSE(graph.wait("assets"));
+    EXPECT_TRUE(graph.wait("volume"));
+    EXPECT_FALSE(ranDependent.load());
+
+    // Added late, after the failure, and still skipped
+    graph.add("presets", {"assets"}, [&]() { ranDependent = true; });
+    EXPECT_FALSE(graph.wait("presets"));
+    EXPECT_FALSE(ranDependent.load());
+
+    size_t failed = 0;
+    for (const StartupTaskTiming& timing : graph.getTimings()) {
+        failed += timing.ok ? 0 : 1;
+    }
+    EXPECT_EQ(failed, 3u);
+}
+
+TEST(StartupGraphTest, TaskAddedAfterStartRunsOnceItsDependencyIsDone) {
+    StartupGraph graph(1);
+    graph.add("presets", {}, []() {});
+    graph.start();
+    ASSERT_TRUE(graph.wait("presets"));
+
+    std::atomic<bool> rescanned{false};
+    EXPECT_TRUE(graph.add("preset_rescan", {"presets"}, [&]() { rescanned = true; }));
+    EXPECT_TRUE(graph.wait("preset_rescan"));
+    EXPECT_TRUE(rescanned.load());
+    EXPECT_TRUE(graph.isDone("preset_rescan"));
+}
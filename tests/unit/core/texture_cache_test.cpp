@@ -0,0 +1,231 @@
+#include "texture_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <vector>
+
+#include "image_decoder.hpp"
+#include "image_encoder.hpp"
+
+using AutoVibez::Core::ImageDecoder;
+using AutoVibez::Core::ImageEncoder;
+using AutoVibez::Core::ImageFormat;
+using AutoVibez::Core::TextureCache;
+
+namespace {
+std::string readText(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+class TextureCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _root = std::filesystem::temp_directory_path() / "autovibez_texture_cache_test";
+        std::filesystem::remove_all(_root);
+        std::filesystem::create_directories(_root / "textures" / "sub");
+        _sources = (_root / "textures").string();
+        _cache = (_root / "cache").string();
+        _index = (_root / "texture_cache.txt").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(_root);
+    }
+
+    void writeSource(const std::string& relative, const std::string& contents) {
+        std::ofstream(std::filesystem::path(_sources) / relative, std::ios::binary) << contents;
+    }
+
+    // Transcode everything pending and wait for the workers to report
+    static bool runToCompletion(TextureCache& cache, size_t& transcoded, size_t& failed) {
+        std::promise<void> finished;
+        cache.start(2, [&](size_t done, size_t errors) {
+            transcoded = done;
+            failed = errors;
+            finished.set_value();
+        });
+        const bool ok = finished.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+        cache.stop();
+        return ok;
+    }
+
+    std::filesystem::path _root;
+    std::string _sources;
+    std::string _cache;
+    std::string _index;
+};
+}  // namespace
+
+TEST(TextureCacheReferencesTest, FindsSampledTextures) {
+    const std::string preset =
+        "comp_1=`ret = tex2D(sampler_fw_clouds, uv) + tex2D(sampler_main, uv);\n"
+        "comp_2=`ret += tex2D(sampler_pc_Worms, uv) * tex2D(sampler_clouds, uv);\n"
+        "comp_3=`ret += tex2D(sampler_rand03, uv) + tex2D(sampler_noise_lq, uv) + mysampler_x;\n";
+
+    EXPECT_EQ(TextureCache::findTextureReferences(preset), (std::vector<std::string>{"clouds", "worms"}));
+    EXPECT_TRUE(TextureCache::findTextureReferences("[preset00]\nzoom=1.0\n").empty());
+}
+
+TEST(TextureCacheReferencesTest, RecognisesTextureFiles) {
+    EXPECT_TRUE(TextureCache::isTextureFile("a/clouds.JPG"));
+    EXPECT_TRUE(TextureCache::isTextureFile("worms.tga"));
+    EXPECT_TRUE(TextureCache::isTextureFile("x.dds"));
+    EXPECT_FALSE(TextureCache::isTextureFile("readme.txt"));
+    EXPECT_FALSE(TextureCache::isTextureFile("preset.milk"));
+}
+
+TEST_F(TextureCacheTest, EmptyDirectoryKeepsSourcePath) {
+    TextureCache cache;
+    EXPECT_FALSE(cache.open(_sources, _cache, _index));
+    EXPECT_EQ(cache.getPendingCount(), 0u);
+    EXPECT_EQ(cache.getSearchPath(), _sources);
+}
+
+TEST_F(TextureCacheTest, CopiesTexturesItCannotDecodeAndIsCurrentNextRun) {
+    writeSource("worms.tga", "tga bytes");
+    writeSource("sub/stars.bmp", "bmp bytes");
+    writeSource("notes.txt", "not a texture");
+
+    {
+        TextureCache cache;
+        EXPECT_FALSE(cache.open(_sources, _cache, _index));
+        EXPECT_EQ(cache.getPendingCount(), 2u);
+        EXPECT_EQ(cache.getSearchPath(), _sources);
+
+        size_t transcoded = 0;
+        size_t failed = 0;
+        ASSERT_TRUE(runToCompletion(cache, transcoded, failed));
+        EXPECT_EQ(transcoded, 2u);
+        EXPECT_EQ(failed, 0u);
+    }
+    EXPECT_EQ(readText(std::filesystem::path(_cache) / "worms.tga"), "tga bytes");
+    EXPECT_EQ(readText(std::filesystem::path(_cache) / "sub" / "stars.bmp"), "bmp bytes");
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(_cache) / "notes.txt"));
+
+    TextureCache reopened;
+    EXPECT_TRUE(reopened.open(_sources, _cache, _index));
+    EXPECT_EQ(reopened.getPendingCount(), 0u);
+    EXPECT_EQ(reopened.getSearchPath(), _cache);
+}
+
+TEST_F(TextureCacheTest, ChangedAndRemovedTexturesAreNoticed) {
+    writeSource("worms.tga", "tga bytes");
+    writeSource("sub/stars.bmp", "bmp bytes");
+    {
+        TextureCache cache;
+        cache.open(_sources, _cache, _index);
+        size_t transcoded = 0;
+        size_t failed = 0;
+        ASSERT_TRUE(runToCompletion(cache, transcoded, failed));
+    }
+
+    writeSource("worms.tga", "longer tga bytes");
+    std::filesystem::remove(std::filesystem::path(_sources) / "sub" / "stars.bmp");
+
+    TextureCache cache;
+    EXPECT_FALSE(cache.open(_sources, _cache, _index));
+    EXPECT_EQ(cache.getPendingCount(), 1u);
+    // A stale copy would still be found by projectM
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(_cache) / "sub" / "stars.bmp"));
+}
+
+TEST_F(TextureCacheTest, IndexForAnotherDirectoryIsIgnored) {
+    writeSource("worms.tga", "tga bytes");
+    {
+        TextureCache cache;
+        cache.open(_sources, _cache, _index);
+        size_t transcoded = 0;
+        size_t failed = 0;
+        ASSERT_TRUE(runToCompletion(cache, transcoded, failed));
+    }
+
+    const std::filesystem::path other = _root / "other";
+    std::filesystem::create_directories(other);
+    std::ofstream(other / "worms.tga") << "tga bytes";
+
+    TextureCache cache;
+    EXPECT_FALSE(cache.open(other.string(), _cache, _index));
+    EXPECT_EQ(cache.getPendingCount(), 1u);
+}
+
+TEST_F(TextureCacheTest, StopSavesFinishedWork) {
+    for (int i = 0; i < 32; ++i) {
+        writeSource("t" + std::to_string(i) + ".tga", "tga bytes");
+    }
+    {
+        TextureCache cache;
+        cache.open(_sources, _cache, _index);
+        cache.start(1, nullptr);
+        cache.stop();
+    }
+
+    // Whatever the first run finished is not redone
+    TextureCache cache;
+    cache.open(_sources, _cache, _index);
+    if (cache.getPendingCount() > 0) {
+        size_t transcoded = 0;
+        size_t failed = 0;
+        ASSERT_TRUE(runToCompletion(cache, transcoded, failed));
+        EXPECT_EQ(transcoded, cache.getPendingCount());
+    }
+
+    TextureCache complete;
+    EXPECT_TRUE(complete.open(_sources, _cache, _index));
+}
+
+TEST_F(TextureCacheTest, MissingSourceFailsTranscode) {
+    std::string error;
+    EXPECT_FALSE(TextureCache::transcode((_root / "none.tga").string(), (_root / "out.tga").string(), false, error));
+    EXPECT_FALSE(error.empty());
+}
+
+#ifdef HAVE_LIBPNG
+TEST_F(TextureCacheTest, TranscodesPngToDds) {
+    std::vector<uint8_t> rgba(8 * 8 * 4, 180);
+    std::string error;
+    ASSERT_TRUE(ImageEncoder::write((std::filesystem::path(_sources) / "clouds.png").string(), ImageFormat::Png, rgba,
+                                    8, 8, 0, error))
+        << error;
+
+    std::vector<uint8_t> decoded;
+    int width = 0;
+    int height = 0;
+    ASSERT_TRUE(ImageDecoder::read((std::filesystem::path(_sources) / "clouds.png").string(), decoded, width, height,
+                                   error))
+        << error;
+    EXPECT_EQ(width, 8);
+    EXPECT_EQ(height, 8);
+    EXPECT_EQ(decoded[0], 180);
+    EXPECT_EQ(decoded[3], 255);  // Written without alpha
+
+    {
+        TextureCache cache;
+        cache.open(_sources, _cache, _index);
+        size_t transcoded = 0;
+        size_t failed = 0;
+        ASSERT_TRUE(runToCompletion(cache, transcoded, failed));
+        EXPECT_EQ(failed, 0u);
+    }
+    const std::string dds = readText(std::filesystem::path(_cache) / "clouds.dds");
+    ASSERT_GE(dds.size(), 128u);
+    EXPECT_EQ(dds.substr(0, 4), "DDS ");
+    EXPECT_EQ(dds.substr(84, 4), "DXT1");
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(_cache) / "clouds.png"));
+}
+#endif
+
+TEST(ImageDecoderTest, RejectsOtherFormats) {
+    std::vector<uint8_t> rgba;
+    int width = 0;
+    int height = 0;
+    std::string error;
+    EXPECT_FALSE(ImageDecoder::canRead("worms.tga"));
+    EXPECT_FALSE(ImageDecoder::read("worms.tga", rgba, width, height, error));
+    EXPECT_FALSE(error.empty());
+}
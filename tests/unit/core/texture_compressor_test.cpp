@@ -0,0 +1,150 @@
+#include "texture_compressor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using AutoVibez::Core::BlockFormat;
+using AutoVibez::Core::TextureCompressor;
+
+namespace {
+uint32_t readWord(const uint8_t* bytes) {
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+std::array<int, 3> unpack565(uint16_t packed) {
+    const int r = packed >> 11 & 31;
+    const int g = packed >> 5 & 63;
+    const int b = packed & 31;
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+// Reference BC1 decode of pixel i in the four-colour mode
+std::array<int, 3> decodeBc1(const uint8_t* block, int i) {
+    const auto color0 = unpack565(static_cast<uint16_t>(block[0] | block[1] << 8));
+    const auto color1 = unpack565(static_cast<uint16_t>(block[2] | block[3] << 8));
+    const int index = readWord(block + 4) >> (2 * i) & 3;
+    std::array<int, 3> color;
+    for (int c = 0; c < 3; ++c) {
+        const int weights[4][2] = {{3, 0}, {0, 3}, {2, 1}, {1, 2}};
+        color[c] = (weights[index][0] * color0[c] + weights[index][1] * color1[c]) / 3;
+    }
+    return color;
+}
+
+std::vector<uint8_t> makeBlock(const std::array<uint8_t, 4>& rgba) {
+    std::vector<uint8_t> pixels;
+    for (int i = 0; i < 16; ++i) {
+        pixels.insert(pixels.end(), rgba.begin(), rgba.end());
+    }
+    return pixels;
+}
+}  // namespace
+
+TEST(TextureCompressorTest, ChoosesBc3OnlyForTransparentImages) {
+    std::vector<uint8_t> opaque = makeBlock({10, 20, 30, 255});
+    EXPECT_EQ(TextureCompressor::chooseFormat(opaque), BlockFormat::Bc1);
+    opaque[7] = 254;
+    EXPECT_EQ(TextureCompressor::chooseFormat(opaque), BlockFormat::Bc3);
+}
+
+TEST(TextureCompressorTest, CompressedSizeRoundsUpToBlocks) {
+    EXPECT_EQ(TextureCompressor::getCompressedSize(4, 4, BlockFormat::Bc1), 8u);
+    EXPECT_EQ(TextureCompressor::getCompressedSize(5, 5, BlockFormat::Bc1), 32u);
+    EXPECT_EQ(TextureCompressor::getCompressedSize(5, 5, BlockFormat::Bc3), 64u);
+    EXPECT_EQ(TextureCompressor::getCompressedSize(256, 128, BlockFormat::Bc1), 256u * 128 / 2);
+}
+
+TEST(TextureCompressorTest, SolidBlockUsesOneColour) {
+    std::vector<uint8_t> pixels = makeBlock({255, 0, 0, 255});
+    uint8_t block[8];
+    TextureCompressor::compressBlock(pixels.data(), BlockFormat::Bc1, block);
+
+    const std::array<uint8_t, 8> expected = {0x00, 0xF8, 0x00, 0xF8, 0, 0, 0, 0};
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), block));
+}
+
+TEST(TextureCompressorTest, GradientDecodesCloseToSource) {
+    std::vector<uint8_t> pixels;
+    for (int i = 0; i < 16; ++i) {
+        // Red rises while blue falls, which the box diagonal has to follow
+        const uint8_t value = static_cast<uint8_t>(i * 16);
+        pixels.insert(pixels.end(), {value, 128, static_cast<uint8_t>(255 - value), 255});
+    }
+    uint8_t block[8];
+    TextureCompressor::compressBlock(pixels.data(), BlockFormat::Bc1, block);
+
+    // color0 > color1 keeps the block in four-colour mode
+    EXPECT_GT(block[0] | block[1] << 8, block[2] | block[3] << 8);
+    for (int i = 0; i < 16; ++i) {
+        const auto color = decodeBc1(block, i);
+        for (int c = 0; c < 3; ++c) {
+            EXPECT_LE(std::abs(color[c] - pixels[i * 4 + c]), 40) << "pixel " << i << " channel " << c;
+        }
+    }
+}
+
+TEST(TextureCompressorTest, AlphaBlockKeepsEndpoints) {
+    std::vector<uint8_t> pixels = makeBlock({50, 50, 50, 255});
+    for (int i = 8; i < 16; ++i) {
+        pixels[i * 4 + 3] = 0;
+    }
+    uint8_t block[16];
+    TextureCompressor::compressBlock(pixels.data(), BlockFormat::Bc3, block);
+
+    EXPECT_EQ(block[0], 255);
+    EXPECT_EQ(block[1], 0);
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) {
+        indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(indices >> (3 * i) & 7, i < 8 ? 0u : 1u) << "pixel " << i;
+    }
+}
+
+TEST(TextureCompressorTest, CompressPadsPartialBlocks) {
+    std::vector<uint8_t> image;
+    for (int i = 0; i < 6; ++i) {
+        image.insert(image.end(), {0, 255, 0, 255});
+    }
+    const std::vector<uint8_t> blocks = TextureCompressor::compress(image, 3, 2, BlockFormat::Bc1);
+
+    ASSERT_EQ(blocks.size(), 8u);
+    // Repeating edge pixels keeps the block solid
+    EXPECT_EQ(readWord(blocks.data() + 4), 0u);
+}
+
+TEST(TextureCompressorTest, WritesDdsHeader) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "autovibez_texture_compressor.dds";
+    const std::vector<uint8_t> blocks(TextureCompressor::getCompressedSize(8, 4, BlockFormat::Bc3), 7);
+    std::string error;
+    ASSERT_TRUE(TextureCompressor::writeDds(path.string(), BlockFormat::Bc3, 8, 4, blocks, error)) << error;
+
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(bytes.size(), 128 + blocks.size());
+    EXPECT_EQ(std::string(bytes.begin(), bytes.begin() + 4), "DDS ");
+    EXPECT_EQ(readWord(&bytes[4]), 124u);
+    EXPECT_EQ(readWord(&bytes[12]), 4u);  // Height
+    EXPECT_EQ(readWord(&bytes[16]), 8u);  // Width
+    EXPECT_EQ(readWord(&bytes[20]), blocks.size());
+    EXPECT_EQ(std::string(bytes.begin() + 84, bytes.begin() + 88), "DXT5");
+    EXPECT_EQ(bytes[128], 7);
+}
+
+TEST(TextureCompressorTest, DdsWriteFailsForBadPath) {
+    std::string error;
+    EXPECT_FALSE(TextureCompressor::writeDds("/nonexistent/dir/x.dds", BlockFormat::Bc1, 4, 4,
+                                             std::vector<uint8_t>(8), error));
+    EXPECT_FALSE(error.empty());
+}
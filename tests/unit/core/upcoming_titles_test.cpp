@@ -0,0 +1,58 @@
+#include "upcoming_titles.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::Core::UpcomingTitles;
+using AutoVibez::Data::Mix;
+
+class UpcomingTitlesTest : public ::testing::Test {
+protected:
+    UpcomingTitles::QueueReader reader() {
+        return [this]() {
+            ++reads;
+            return queue;
+        };
+    }
+
+    static Mix makeMix(const std::string& artist, const std::string& title) {
+        Mix mix;
+        mix.artist = artist;
+        mix.title = title;
+        return mix;
+    }
+
+    UpcomingTitles titles;
+    std::vector<Mix> queue;
+    int reads = 0;
+};
+
+TEST_F(UpcomingTitlesTest, FirstUpdateReadsTheQueue) {
+    queue = {makeMix("Artist", "Next"), makeMix("Other", "After")};
+    EXPECT_TRUE(titles.update(0, reader()));
+    EXPECT_EQ(reads, 1);
+    EXPECT_EQ(titles.get(), (std::vector<std::string>{"Artist - Next", "Other - After"}));
+}
+
+TEST_F(UpcomingTitlesTest, SameRevisionKeepsTheTitlesWithoutReading) {
+    queue = {makeMix("Artist", "Next")};
+    ASSERT_TRUE(titles.update(3, reader()));
+    queue.clear();  // Not seen until the revision moves
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(titles.update(3, reader()));
+    }
+    EXPECT_EQ(reads, 1);
+    EXPECT_EQ(titles.get(), (std::vector<std::string>{"Artist - Next"}));
+}
+
+TEST_F(UpcomingTitlesTest, NewRevisionReadsTheQueueAgain) {
+    queue = {makeMix("Artist", "Next")};
+    ASSERT_TRUE(titles.update(1, reader()));
+    queue = {makeMix("Other", "Queued")};
+    EXPECT_TRUE(titles.update(2, reader()));
+    EXPECT_EQ(reads, 2);
+    EXPECT_EQ(titles.get(), (std::vector<std::string>{"Other - Queued"}));
+
+    queue.clear();
+    EXPECT_TRUE(titles.update(3, reader()));
+    EXPECT_TRUE(titles.get().empty());
+}
@@ -0,0 +1,90 @@
+#include "video_exporter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "frame_readback.hpp"
+
+using AutoVibez::Core::ExportOptions;
+using AutoVibez::Core::FrameReadback;
+using AutoVibez::Core::VideoExporter;
+
+namespace {
+bool parse(std::vector<const char*> args, ExportOptions& options, std::string& error) {
+    args.insert(args.begin(), {"autovibez", "--export"});
+    return VideoExporter::parseArgs(static_cast<int>(args.size()), const_cast<char**>(args.data()), 2, options,
+                                    error);
+}
+}  // namespace
+
+TEST(VideoExporterTest, ParsesOptions) {
+    ExportOptions options;
+    std::string error;
+    ASSERT_TRUE(parse({"out.mp4", "--audio", "mix.mp3", "--size", "1920x1080", "--fps", "30", "--seconds", "12.5",
+                       "--preset", "a.milk"},
+                      options, error))
+        << error;
+    EXPECT_EQ(options.output, "out.mp4");
+    EXPECT_EQ(options.audio, "mix.mp3");
+    EXPECT_EQ(options.preset, "a.milk");
+    EXPECT_EQ(options.width, 1920);
+    EXPECT_EQ(options.height, 1080);
+    EXPECT_EQ(options.fps, 30);
+    EXPECT_DOUBLE_EQ(options.seconds, 12.5);
+}
+
+TEST(VideoExporterTest, RejectsIncompleteArguments) {
+    ExportOptions options;
+    std::string error;
+    EXPECT_FALSE(parse({"--audio", "sweep"}, options, error));
+    EXPECT_FALSE(parse({"out.mp4"}, options = ExportOptions(), error));
+    EXPECT_FALSE(parse({"out.mp4", "--audio"}, options = ExportOptions(), error));
+    EXPECT_FALSE(parse({"out.mp4", "--audio", "sweep", "--size", "big"}, options = ExportOptions(), error));
+    EXPECT_FALSE(parse({"out.mp4", "--audio", "sweep", "--bitrate", "8M"}, options = ExportOptions(), error));
+    // Odd sizes only work for raw frames
+    EXPECT_FALSE(parse({"out.mp4", "--audio", "sweep", "--size", "641x480"}, options = ExportOptions(), error));
+    EXPECT_TRUE(parse({"out.rgba", "--audio", "sweep", "--size", "641x480"}, options = ExportOptions(), error));
+}
+
+TEST(VideoExporterTest, BuildsFfmpegCommand) {
+    ExportOptions options;
+    options.output = "my loop.mp4";
+    options.audio = "mix's.wav";
+    options.width = 640;
+    options.height = 360;
+    options.fps = 30;
+
+    const std::string video = VideoExporter::buildFfmpegCommand(options, false);
+    EXPECT_NE(video.find("-f rawvideo -pix_fmt rgba -s 640x360 -r 30 -i -"), std::string::npos);
+    EXPECT_EQ(video.find("-map 1:a"), std::string::npos);
+
+    const std::string muxed = VideoExporter::buildFfmpegCommand(options, true);
+    EXPECT_NE(muxed.find("-map 1:a"), std::string::npos);
+#ifndef _WIN32
+    EXPECT_NE(muxed.find("'mix'\\''s.wav'"), std::string::npos);
+    EXPECT_NE(muxed.find("'my loop.mp4'"), std::string::npos);
+#endif
+
+    EXPECT_TRUE(VideoExporter::isRawOutput("frames.rgba"));
+    EXPECT_FALSE(VideoExporter::isRawOutput("loop.mkv"));
+}
+
+TEST(VideoExporterTest, SampleScheduleCoversAudioExactly) {
+    // 44100 / 24 is not whole: frames alternate between 1837 and 1838 samples without drifting
+    int64_t previous = 0;
+    for (int64_t frame = 0; frame < 240; ++frame) {
+        const int64_t end = VideoExporter::getSampleEnd(frame, 44100, 24);
+        EXPECT_GE(end - previous, 1837);
+        EXPECT_LE(end - previous, 1838);
+        previous = end;
+    }
+    EXPECT_EQ(previous, 441000);
+}
+
+TEST(VideoExporterTest, FlipsRowsTopDown) {
+    const std::vector<uint8_t> rows = {1, 1, 1, 1, 2, 2, 2, 2};  // 1x2 RGBA, bottom row first
+    std::vector<uint8_t> image;
+    FrameReadback::copyFlipped(rows.data(), 1, 2, image);
+    EXPECT_EQ(image, (std::vector<uint8_t>{2, 2, 2, 2, 1, 1, 1, 1}));
+}
@@ -0,0 +1,97 @@
+#include "data/app_config.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "utils/constants.hpp"
+
+using AutoVibez::Data::AppConfig;
+using AutoVibez::Data::AppConfigWatcher;
+
+class AppConfigTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "autovibez_app_config_test";
+        std::filesystem::remove_all(tempDir);
+        std::filesystem::create_directories(tempDir);
+        configPath = (tempDir / "config.inp").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(tempDir);
+    }
+
+    std::filesystem::path tempDir;
+    std::string configPath;
+
+    // Rewrites the file and moves its time on, as file systems with coarse timestamps may not
+    void writeConfig(const std::string& content) {
+        const bool existed = std::filesystem::exists(configPath);
+        const auto before = existed ? std::filesystem::last_write_time(configPath) : std::filesystem::file_time_type{};
+        {
+            std::ofstream out(configPath);
+            out << content;
+        }
+        if (existed) {
+            std::filesystem::last_write_time(configPath, before + std::chrono::seconds(1));
+        }
+    }
+};
+
+TEST_F(AppConfigTest, ParsesTypedFieldsOnce) {
+    writeConfig(R"(
+Mesh X = 64
+FPS = 59.94
+seek_increment = 30
+loudness_normalization = no
+mixes_url = https://example.com/mixes.yaml
+quality_medium_min_mesh = 24
+)");
+    const auto config = AppConfig::load(configPath);
+    ASSERT_NE(config, nullptr);
+    EXPECT_EQ(config->path, configPath);
+    EXPECT_EQ(config->mesh_x, 64);
+    EXPECT_EQ(config->mesh_y, Constants::DEFAULT_MESH_Y);
+    EXPECT_DOUBLE_EQ(config->fps, 59.94);
+    EXPECT_EQ(config->seek_increment, 30);
+    EXPECT_FALSE(config->loudness_normalization);
+    EXPECT_EQ(config->mixes_url, "https://example.com/mixes.yaml");
+    EXPECT_FALSE(config->config_hot_reload);
+
+    // Keys named at run time stay reachable through the parsed file
+    int minMesh = 0;
+    EXPECT_TRUE(config->file->readInto(minMesh, "quality_medium_min_mesh"));
+    EXPECT_EQ(minMesh, 24);
+}
+
+TEST_F(AppConfigTest, MissingFileLoadsNothing) {
+    EXPECT_EQ(AppConfig::load((tempDir / "missing.inp").string()), nullptr);
+}
+
+TEST_F(AppConfigTest, WatcherPublishesAChangedFileOnceItSettles) {
+    writeConfig("seek_increment = 30\n");
+    AppConfigWatcher watcher(AppConfig::load(configPath));
+    const auto first = watcher.current();
+    EXPECT_FALSE(watcher.poll());
+
+    writeConfig("seek_increment = 90\n");
+    EXPECT_FALSE(watcher.poll());  // Seen changing; read on the next poll if it holds still
+    EXPECT_TRUE(watcher.poll());
+    EXPECT_EQ(watcher.current()->seek_increment, 90);
+    EXPECT_FALSE(watcher.poll());
+
+    // A reader holding the old snapshot keeps it unchanged
+    EXPECT_EQ(first->seek_increment, 30);
+}
+
+TEST_F(AppConfigTest, WatcherKeepsTheLastSnapshotWhenTheFileGoesAway) {
+    writeConfig("seek_increment = 30\n");
+    AppConfigWatcher watcher(AppConfig::load(configPath));
+    std::filesystem::remove(configPath);
+    EXPECT_FALSE(watcher.poll());
+    EXPECT_FALSE(watcher.poll());
+    EXPECT_EQ(watcher.current()->seek_increment, 30);
+}
@@ -89,12 +89,54 @@ preset_path = /custom/presets
     EXPECT_EQ(config.getYamlUrl(), "");
     EXPECT_EQ(config.getMixesUrl(), "");
     EXPECT_EQ(config.getAutoDownload(), true);
+    EXPECT_EQ(config.getStreamWhileDownloading(), true);
+    EXPECT_EQ(config.getStreamStartKb(), 512);
+    EXPECT_EQ(config.getPlayingDownloadLimitKb(), 1024);
+    EXPECT_EQ(config.getMixCacheQuotaGb(), 0);
+    EXPECT_EQ(config.getMixDatabaseProfile(), "fast");
+    EXPECT_EQ(config.getLoudnessNormalization(), true);
+    EXPECT_DOUBLE_EQ(config.getLoudnessTargetLufs(), -14.0);
+    EXPECT_EQ(config.getDecoderBackend(), "auto");
+    EXPECT_EQ(config.getTranscodeCache(), false);
+    EXPECT_EQ(config.getTranscodeBitrateKbps(), 96);
+    EXPECT_EQ(config.getBeatSyncedPresets(), true);
+    EXPECT_EQ(config.getPresetCutBars(), 8);
+    EXPECT_EQ(config.getProfilePresetCost(), true);
+    EXPECT_EQ(config.getSkipSlowPresets(), true);
+    EXPECT_DOUBLE_EQ(config.getRenderScale(), 1.0);
+    EXPECT_EQ(config.getDynamicRenderScale(), false);
+    EXPECT_DOUBLE_EQ(config.getMinRenderScale(), 0.5);
+    EXPECT_EQ(config.getQualityGovernor(), false);
+    EXPECT_EQ(config.getQualityProfile(), "auto");
+    EXPECT_EQ(config.getMultiOutput(), "off");
+    EXPECT_EQ(config.getMultiOutputBezel(), 0);
+    EXPECT_EQ(config.getMultiOutputWidth(), 0);
+    EXPECT_EQ(config.getScreenshotFormat(), "png");
+    EXPECT_EQ(config.getScreenshotJpegQuality(), 90);
+    EXPECT_TRUE(config.getTextureCache());
     EXPECT_EQ(config.getSeekIncrement(), 60);
     EXPECT_EQ(config.getVolumeStep(), 10);
     EXPECT_EQ(config.getCrossfadeEnabled(), true);
     EXPECT_EQ(config.getCrossfadeDuration(), 3000);  // DEFAULT_CROSSFADE_DURATION_MS
     EXPECT_EQ(config.getPreferredGenre(), "");
     EXPECT_EQ(config.getFontPath(), "");
+    EXPECT_EQ(config.getInternalAudio(), true);
+    EXPECT_EQ(config.getNativeMonitor(), true);
+    EXPECT_EQ(config.getNativeSampleRate(), true);
+    EXPECT_EQ(config.getAdaptiveCapturePeriod(), true);
+    EXPECT_EQ(config.getCapturePeriodFrames(), 512);
+    EXPECT_EQ(config.getLatencyCompensation(), true);
+    EXPECT_EQ(config.getDisplayQueueFrames(), 2);
+    EXPECT_DOUBLE_EQ(config.getAvOffsetMs(), 0.0);
+    EXPECT_EQ(config.getFramePacing(), "vsync");
+    EXPECT_EQ(config.getRenderThread(), "auto");
+    EXPECT_EQ(config.getOverlayRenderer(), "gl3");
+    EXPECT_EQ(config.getPowerSaving(), "pause");
+    EXPECT_DOUBLE_EQ(config.getPowerSavingFps(), 10.0);
+    EXPECT_FALSE(config.getPowerSavingUnfocused());
+    EXPECT_FALSE(config.getEventDrivenLoop());
+    EXPECT_EQ(config.getSyntheticAudio(), "");
+    EXPECT_DOUBLE_EQ(config.getSyntheticAudioSpeed(), 1.0);
 }
 
 TEST_F(ConfigManagerTest, BooleanValues) {
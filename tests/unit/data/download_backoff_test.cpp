@@ -0,0 +1,58 @@
+#include "download_backoff.hpp"
+
+#include <gtest/gtest.h>
+
+#include "constants.hpp"
+
+using namespace AutoVibez::Data;
+
+namespace {
+constexpr int64_t BASE_MS = int64_t{Constants::DOWNLOAD_RETRY_BASE_SECONDS} * 1000;
+constexpr int64_t MAX_MS = int64_t{Constants::DOWNLOAD_RETRY_MAX_SECONDS} * 1000;
+}  // namespace
+
+TEST(DownloadBackoffTest, WaitsDoubleAndAreCapped) {
+    EXPECT_EQ(DownloadBackoff::retryDelayMs(1, 0.0), BASE_MS);
+    EXPECT_EQ(DownloadBackoff::retryDelayMs(2, 0.0), BASE_MS * 2);
+    EXPECT_EQ(DownloadBackoff::retryDelayMs(4, 0.0), BASE_MS * 8);
+    EXPECT_EQ(DownloadBackoff::retryDelayMs(40, 0.0), MAX_MS);
+
+    // Jitter only ever shortens a wait
+    const auto shortest = static_cast<int64_t>(BASE_MS * 2 * (1.0 - Constants::DOWNLOAD_RETRY_JITTER));
+    EXPECT_EQ(DownloadBackoff::retryDelayMs(2, 1.0), shortest);
+    EXPECT_GT(DownloadBackoff::retryDelayMs(2, 0.5), shortest);
+    EXPECT_LT(DownloadBackoff::retryDelayMs(2, 0.5), BASE_MS * 2);
+}
+
+TEST(DownloadBackoffTest, AFailedMixWaitsUntilItsRetryTime) {
+    DownloadBackoff backoff;
+    const int64_t now = 1'000'000;
+    EXPECT_TRUE(backoff.mayAttempt("mix", now));
+
+    const DownloadFailure first = backoff.recordFailure("mix", now);
+    EXPECT_EQ(first.mix_id, "mix");
+    EXPECT_EQ(first.failures, 1);
+    EXPECT_GT(first.retry_after_ms, now);
+    EXPECT_LE(first.retry_after_ms, now + BASE_MS);
+    EXPECT_FALSE(backoff.mayAttempt("mix", now));
+    EXPECT_TRUE(backoff.mayAttempt("mix", first.retry_after_ms));
+    EXPECT_TRUE(backoff.mayAttempt("other", now));
+    EXPECT_EQ(backoff.getBackedOffCount(now), 1u);
+
+    const DownloadFailure second = backoff.recordFailure("mix", first.retry_after_ms);
+    EXPECT_EQ(second.failures, 2);
+    EXPECT_GE(second.retry_after_ms - first.retry_after_ms,
+              static_cast<int64_t>(BASE_MS * 2 * (1.0 - Constants::DOWNLOAD_RETRY_JITTER)));
+
+    EXPECT_TRUE(backoff.recordSuccess("mix"));
+    EXPECT_FALSE(backoff.recordSuccess("mix"));
+    EXPECT_TRUE(backoff.mayAttempt("mix", now));
+}
+
+TEST(DownloadBackoffTest, LoadedFailuresPickUpWhereTheyLeftOff) {
+    DownloadBackoff backoff;
+    backoff.load({{"stored", 3, 5000}});
+    EXPECT_FALSE(backoff.mayAttempt("stored", 4999));
+    EXPECT_TRUE(backoff.mayAttempt("stored", 5000));
+    EXPECT_EQ(backoff.recordFailure("stored", 5000).failures, 4);
+}
@@ -0,0 +1,186 @@
+#include "download_scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AutoVibez::Data;
+
+namespace {
+// Holds tasks until the test lets them finish
+class Gate {
+public:
+    void open() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return open_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool open_ = false;
+};
+
+// Records the order tasks ran in and the most that ran at once, overall and per host
+class Recorder {
+public:
+    DownloadScheduler::Task task(const std::string& id, const std::string& host, Gate* gate = nullptr) {
+        return [this, id, host, gate]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                order.push_back(id);
+                peak = std::max(peak, ++running);
+                peak_per_host[host] = std::max(peak_per_host[host], ++running_per_host[host]);
+            }
+            if (gate) {
+                gate->wait();
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running;
+            --running_per_host[host];
+            return true;
+        };
+    }
+
+    void waitForStarts(size_t count) {
+        while (started() < count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    size_t started() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order.size();
+    }
+
+    std::mutex mutex_;
+    std::vector<std::string> order;
+    int running = 0;
+    int peak = 0;
+    std::map<std::string, int> running_per_host;
+    std::map<std::string, int> peak_per_host;
+};
+}  // namespace
+
+TEST(DownloadSchedulerTest, RunsNoMoreThanItsWorkers) {
+    DownloadScheduler scheduler(3, 100);
+    Recorder recorder;
+    for (int i = 0; i < 40; ++i) {
+        const std::string id = "mix" + std::to_string(i);
+        ASSERT_TRUE(scheduler.schedule(id, "host" + std::to_string(i), DownloadPriority::Background,
+                                       recorder.task(id, "host" + std::to_string(i))));
+    }
+    scheduler.waitUntilIdle();
+
+    EXPECT_EQ(recorder.order.size(), 40u);
+    EXPECT_LE(recorder.peak, 3);
+    EXPECT_EQ(scheduler.getQueuedCount(), 0u);
+    EXPECT_EQ(scheduler.getRunningCount(), 0u);
+}
+
+TEST(DownloadSchedulerTest, StartsHigherPrioritiesFirst) {
+    DownloadScheduler scheduler(1, 1);
+    Recorder recorder;
+    Gate gate;
+    ASSERT_TRUE(scheduler.schedule("busy", "a", DownloadPriority::Background, recorder.task("busy", "a", &gate)));
+    recorder.waitForStarts(1);
+
+    // All queued behind the one running, so only their priorities decide the order
+    ASSERT_TRUE(scheduler.schedule("rest", "b", DownloadPriority::Background, recorder.task("rest", "b")));
+    ASSERT_TRUE(scheduler.schedule("favorite", "c", DownloadPriority::Favorite, recorder.task("favorite", "c")));
+    ASSERT_TRUE(scheduler.schedule("next", "d", DownloadPriority::UpNext, recorder.task("next", "d")));
+    ASSERT_TRUE(scheduler.schedule("later", "e", DownloadPriority::Background, recorder.task("later", "e")));
+    EXPECT_TRUE(scheduler.reprioritize("later", DownloadPriority::UpNext));
+    EXPECT_TRUE(scheduler.isQueued("later"));
+    EXPECT_TRUE(scheduler.isRunning("busy"));
+
+    gate.open();
+    scheduler.waitUntilIdle();
+    EXPECT_EQ(recorder.order, (std::vector<std::string>{"busy", "next", "later", "favorite", "rest"}));
+}
+
+TEST(DownloadSchedulerTest, KeepsEachHostUnderItsLimit) {
+    DownloadScheduler scheduler(4, 1);
+    Recorder recorder;
+    Gate gate;
+    for (int i = 0; i < 12; ++i) {
+        const std::string id = "mix" + std::to_string(i);
+        const std::string host = i % 3 == 0 ? "small.example.com" : "mirror.example.com";
+        ASSERT_TRUE(scheduler.schedule(id, host, DownloadPriority::Background, recorder.task(id, host, &gate)));
+    }
+
+    // One job per host, and the two idle workers leave the rest queued
+    recorder.waitForStarts(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(scheduler.getRunningCount(), 2u);
+    EXPECT_EQ(scheduler.getQueuedCount(), 10u);
+
+    gate.open();
+    scheduler.waitUntilIdle();
+    EXPECT_EQ(recorder.order.size(), 12u);
+    EXPECT_EQ(recorder.peak_per_host["mirror.example.com"], 1);
+    EXPECT_EQ(recorder.peak_per_host["small.example.com"], 1);
+}
+
+TEST(DownloadSchedulerTest, PlaybackDoesNotWaitForBusyWorkers) {
+    DownloadScheduler scheduler(1, 1);
+    Recorder recorder;
+    Gate gate;
+    ASSERT_TRUE(scheduler.schedule("busy", "mirror", DownloadPriority::Background,
+                                   recorder.task("busy", "mirror", &gate)));
+    recorder.waitForStarts(1);
+    ASSERT_TRUE(scheduler.schedule("queued", "mirror", DownloadPriority::UpNext, recorder.task("queued", "mirror")));
+
+    // Same host and the only worker is busy: the playback worker takes it anyway
+    ASSERT_TRUE(scheduler.schedule("now", "mirror", DownloadPriority::Playing, recorder.task("now", "mirror")));
+    recorder.waitForStarts(2);
+    EXPECT_EQ(recorder.order[1], "now");
+    EXPECT_TRUE(scheduler.isQueued("queued"));
+
+    gate.open();
+    scheduler.waitUntilIdle();
+    EXPECT_EQ(recorder.order.size(), 3u);
+}
+
+TEST(DownloadSchedulerTest, CancelDropsQueuedJobsOnly) {
+    DownloadScheduler scheduler(1, 1);
+    Recorder recorder;
+    Gate gate;
+    ASSERT_TRUE(scheduler.schedule("busy", "a", DownloadPriority::Background, recorder.task("busy", "a", &gate)));
+    recorder.waitForStarts(1);
+    ASSERT_TRUE(scheduler.schedule("dropped", "b", DownloadPriority::Background, recorder.task("dropped", "b")));
+    ASSERT_TRUE(scheduler.schedule("kept", "b", DownloadPriority::Background, recorder.task("kept", "b")));
+
+    EXPECT_FALSE(scheduler.schedule("kept", "b", DownloadPriority::UpNext, recorder.task("kept", "b")));
+    EXPECT_FALSE(scheduler.schedule("busy", "a", DownloadPriority::UpNext, recorder.task("busy", "a")));
+    EXPECT_FALSE(scheduler.cancel("busy"));
+    EXPECT_FALSE(scheduler.reprioritize("busy", DownloadPriority::UpNext));
+    EXPECT_TRUE(scheduler.cancel("dropped"));
+    EXPECT_FALSE(scheduler.cancel("dropped"));
+
+    gate.open();
+    scheduler.waitUntilIdle();
+    EXPECT_EQ(recorder.order, (std::vector<std::string>{"busy", "kept"}));
+
+    // A finished id may be scheduled again; nothing is accepted after shutdown
+    EXPECT_TRUE(scheduler.schedule("busy", "a", DownloadPriority::Background, recorder.task("busy", "a")));
+    scheduler.shutdown();
+    EXPECT_FALSE(scheduler.schedule("late", "a", DownloadPriority::Background, recorder.task("late", "a")));
+}
@@ -0,0 +1,102 @@
+#include "download_telemetry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "constants.hpp"
+
+using namespace AutoVibez::Data;
+
+TEST(DownloadTelemetryTest, TotalsFinishedDownloadsPerHost) {
+    DownloadTelemetry telemetry;
+    const auto now = DownloadTelemetry::Clock::now();
+    telemetry.record("cdn.example.com", true, 4000, 2.0, 0, now);
+    telemetry.record("cdn.example.com", true, 6000, 3.0, 1, now);
+    telemetry.record("slow.example.com", false, 500, 10.0, 2, now);
+    telemetry.record("slow.example.com", true, 1500, 10.0, 0, now);
+
+    const std::vector<DownloadHostStats> hosts = telemetry.snapshot();
+    ASSERT_EQ(hosts.size(), 2u);
+    const DownloadHostStats& slow = hosts[0];  // Most failures first
+    EXPECT_EQ(slow.host, "slow.example.com");
+    EXPECT_EQ(slow.completed, 1u);
+    EXPECT_EQ(slow.failed, 1u);
+    EXPECT_EQ(slow.retries, 2u);
+    EXPECT_DOUBLE_EQ(slow.getFailureRate(), 0.5);
+    EXPECT_EQ(slow.getBytesPerSecond(), 100);
+
+    const DownloadHostStats& cdn = hosts[1];
+    EXPECT_EQ(cdn.completed, 2u);
+    EXPECT_EQ(cdn.bytes, 10000);
+    EXPECT_EQ(cdn.getBytesPerSecond(), 2000);
+    EXPECT_DOUBLE_EQ(cdn.getFailureRate(), 0.0);
+
+    std::ostringstream csv;
+    telemetry.writeCsv(csv);
+    EXPECT_EQ(csv.str(),
+              "host,completed,failed,failure_rate,retries,bytes,seconds,bytes_per_second\n"
+              "slow.example.com,1,1,0.5,2,2000,20,100\n"
+              "cdn.example.com,2,0,0,1,10000,5,2000\n");
+
+    telemetry.clear();
+    EXPECT_TRUE(telemetry.snapshot().empty());
+}
+
+TEST(DownloadTelemetryTest, CountsOnlyRecentCompletions) {
+    DownloadTelemetry telemetry;
+    const auto start = DownloadTelemetry::Clock::now();
+    const auto window = std::chrono::seconds(Constants::DOWNLOAD_STATS_WINDOW_SECONDS);
+    telemetry.record("a.example.com", true, 1, 1.0, 0, start);
+    telemetry.record("a.example.com", false, 1, 1.0, 0, start);  // Failures aren't completions
+    telemetry.record("a.example.com", true, 1, 1.0, 0, start + window / 2);
+
+    EXPECT_EQ(telemetry.getCompletedRecently(start + window / 2), 2u);
+    EXPECT_EQ(telemetry.getCompletedRecently(start + window + std::chrono::seconds(1)), 1u);
+    EXPECT_EQ(telemetry.getCompletedRecently(start + window * 2), 0u);
+}
+
+TEST(DownloadTelemetryTest, SummarizesTheQueueInOneLine) {
+    DownloadStats stats;
+    EXPECT_EQ(DownloadTelemetry::formatSummary(stats), "Downloads idle, 0 done in the last hour");
+
+    stats.queued = 4;
+    stats.running = 2;
+    stats.completed_last_hour = 7;
+    stats.bytes_per_second = 3 * 1024 * 1024 / 2;
+    DownloadTransferStats background;
+    background.eta_seconds = 900;
+    DownloadTransferStats next;
+    next.full_speed = true;
+    next.eta_seconds = 95;
+    stats.transfers = {background, next};
+    DownloadHostStats host;
+    host.host = "slow.example.com";
+    host.completed = 3;
+    host.failed = 1;
+    stats.hosts = {host};
+
+    EXPECT_EQ(DownloadTelemetry::formatSummary(stats),
+              "Downloads: 2 running at 1.5 MB/s, 4 queued, next mix in 1:35, 7 done in the last hour, "
+              "slow.example.com failed 1 of 4");
+
+    stats.hosts_down = 1;
+    stats.backed_off = 3;
+    EXPECT_EQ(DownloadTelemetry::formatSummary(stats),
+              "Downloads: 2 running at 1.5 MB/s, 4 queued, next mix in 1:35, 7 done in the last hour, "
+              "slow.example.com failed 1 of 4, 1 host down, 3 waiting to retry");
+
+    // Only stages with work in them are worth a mention
+    IngestStageStats analyze;
+    analyze.name = "analyze";
+    analyze.workers = 3;
+    analyze.busy = 3;
+    analyze.queued = 2;
+    IngestStageStats index;
+    index.name = "index";
+    index.workers = 1;
+    stats.stages = {analyze, index};
+    EXPECT_EQ(DownloadTelemetry::formatSummary(stats),
+              "Downloads: 2 running at 1.5 MB/s, 4 queued, next mix in 1:35, 7 done in the last hour, "
+              "slow.example.com failed 1 of 4, 1 host down, 3 waiting to retry, analyze 3/3 busy with 2 queued");
+}
@@ -0,0 +1,122 @@
+#include "ingest_pipeline.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <string>
+
+using namespace AutoVibez::Data;
+
+namespace {
+IngestJob makeJob(const std::string& id, std::function<void(IngestJob&)> done) {
+    IngestJob job;
+    job.mix.id = id;
+    job.done = std::move(done);
+    return job;
+}
+}  // namespace
+
+TEST(IngestPipelineTest, SettlesEveryJobOnceAndBatchesTheIndex) {
+    std::mutex mutex;
+    std::set<std::string> indexed;
+    std::vector<size_t> batches;
+    std::multiset<std::string> settled;
+    {
+        IngestPipeline pipeline(
+            [](IngestJob& job) {
+                job.record.id = job.mix.id;
+                return job.mix.id != "bad";
+            },
+            [&](std::vector<IngestJob>& batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                batches.push_back(batch.size());
+                for (IngestJob& job : batch) {
+                    indexed.insert(job.record.id);
+                    job.ok = true;
+                }
+            },
+            2);
+        for (int i = 0; i < 20; ++i) {
+            ASSERT_TRUE(pipeline.submit(makeJob("mix" + std::to_string(i), [&](IngestJob& job) {
+                std::lock_guard<std::mutex> lock(mutex);
+                settled.insert(job.mix.id + (job.ok ? "" : " failed"));
+            })));
+        }
+        ASSERT_TRUE(pipeline.submit(makeJob("bad", [&](IngestJob& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            settled.insert(job.mix.id + (job.ok ? "" : " failed"));
+        })));
+        pipeline.stop();
+
+        const std::vector<IngestStageStats> stages = pipeline.getStats();
+        ASSERT_EQ(stages.size(), 2u);
+        EXPECT_EQ(stages[0].name, "analyze");
+        EXPECT_EQ(stages[0].workers, 2u);
+        EXPECT_EQ(stages[0].processed, 20u);
+        EXPECT_EQ(stages[0].failed, 1u);
+        EXPECT_EQ(stages[1].name, "index");
+        EXPECT_EQ(stages[1].processed, 20u);
+        EXPECT_EQ(stages[1].queued, 0u);
+
+        // Refused once stopped, and still settled
+        EXPECT_FALSE(pipeline.submit(makeJob("late", [&](IngestJob& job) { settled.insert(job.mix.id); })));
+    }
+
+    EXPECT_EQ(indexed.size(), 20u);
+    EXPECT_EQ(settled.size(), 22u);
+    EXPECT_EQ(settled.count("bad failed"), 1u);
+    EXPECT_EQ(settled.count("late"), 1u);
+    size_t total = 0;
+    for (size_t batch : batches) {
+        EXPECT_LE(batch, static_cast<size_t>(Constants::INGEST_INDEX_BATCH));
+        total += batch;
+    }
+    EXPECT_EQ(total, 20u);
+}
+
+TEST(IngestPipelineTest, FullAnalysisQueueHoldsBackSubmit) {
+    std::mutex gate;
+    gate.lock();
+    std::atomic<int> submitted{0};
+    IngestPipeline pipeline(
+        [&](IngestJob&) {
+            std::lock_guard<std::mutex> hold(gate);
+            return true;
+        },
+        [](std::vector<IngestJob>& batch) {
+            for (IngestJob& job : batch) {
+                job.ok = true;
+            }
+        },
+        1);
+
+    // One job held in the analyzer, INGEST_QUEUE_PER_WORKER queued behind it, then the producer waits
+    const int room = 1 + Constants::INGEST_QUEUE_PER_WORKER;
+    std::thread producer([&]() {
+        for (int i = 0; i < room + 1; ++i) {
+            pipeline.submit(makeJob("mix" + std::to_string(i), {}));
+            submitted++;
+        }
+    });
+    while (submitted.load() < room || pipeline.getStats()[0].busy == 0) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(submitted.load(), room);
+    EXPECT_EQ(pipeline.getStats()[0].queued, static_cast<size_t>(Constants::INGEST_QUEUE_PER_WORKER));
+
+    gate.unlock();
+    producer.join();
+    EXPECT_EQ(submitted.load(), room + 1);
+    pipeline.stop();
+    const std::vector<IngestStageStats> stages = pipeline.getStats();
+    EXPECT_EQ(stages[1].processed, static_cast<uint64_t>(room + 1));
+    EXPECT_GT(stages[0].blocked_seconds, 0.0);
+}
+
+TEST(IngestPipelineTest, DefaultPoolLeavesACoreAndStaysWithinTheCap) {
+    const size_t workers = IngestPipeline::defaultAnalysisWorkers();
+    EXPECT_GE(workers, 1u);
+    EXPECT_LE(workers, static_cast<size_t>(Constants::INGEST_ANALYSIS_MAX_WORKERS));
+}
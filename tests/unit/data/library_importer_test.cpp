@@ -0,0 +1,112 @@
+#include "data/library_importer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "data/mix_database.hpp"
+#include "data/mix_downloader.hpp"
+#include "utils/mp3_probe.hpp"
+
+using AutoVibez::Data::LibraryImporter;
+using AutoVibez::Data::LibraryImportStats;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Data::MixDownloader;
+
+class LibraryImporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "library_importer_test";
+        library_dir = test_dir / "library";
+        std::filesystem::remove_all(test_dir);  // Whatever an aborted run left would be imported too
+        std::filesystem::create_directories(library_dir / "DJ Shadow" / "Live");
+        std::filesystem::create_directories(test_dir / "mixes");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir);
+    }
+
+    // ID3v2.3 title frame, no artist, ahead of one MPEG frame whose Xing header gives the file a duration
+    std::string createMP3File(const std::filesystem::path& path, const std::string& title) {
+        std::string frame = {'T', 'I', 'T', '2', 0, 0, 0, static_cast<char>(title.size() + 1), 0, 0, 0};
+        frame += title;
+        std::string tag = {'I', 'D', '3', 3, 0, 0, 0, 0, 1, 0};  // 128 bytes after the header
+        tag += frame;
+        tag.resize(10 + 128, '\0');
+
+        std::string mpeg = {static_cast<char>(0xFF), static_cast<char>(0xFB), static_cast<char>(0x90), 0x44};
+        mpeg.resize(36, '\0');
+        mpeg += std::string{'X', 'i', 'n', 'g', 0, 0, 0, 0x03, 0, 0, 0x03, static_cast<char>(0xE8), 0, 0, 0, 0};
+        mpeg.resize(417, '\0');
+        std::string content = tag + mpeg;
+        content.resize(4096, 0x55);
+        std::ofstream(path, std::ios::binary) << content;
+        return path.string();
+    }
+
+    std::filesystem::path test_dir;
+    std::filesystem::path library_dir;
+};
+
+TEST_F(LibraryImporterTest, ImportsInPlaceAndSkipsUnchangedFilesOnRerun) {
+    const std::string first = createMP3File(library_dir / "DJ Shadow" / "endtroducing.mp3", "Endtroducing");
+    const std::string second = createMP3File(library_dir / "DJ Shadow" / "Live" / "brixton.MP3", "Brixton");
+    std::ofstream(library_dir / "notes.txt") << "not audio";
+    std::ofstream(library_dir / "broken.mp3") << "not an mp3 either";
+
+    MixDatabase database((test_dir / "library.db").string());
+    ASSERT_TRUE(database.initialize());
+    MixDownloader downloader((test_dir / "mixes").string());
+    downloader.setFileMappingsPath((test_dir / "file_mappings.txt").string());
+    AutoVibez::Utils::Mp3ProbeCache scan_cache;
+
+    LibraryImporter importer(database, downloader, scan_cache);
+    importer.setWorkers(2, 2);
+    LibraryImportStats stats;
+    ASSERT_TRUE(importer.importDirectory(library_dir.string(), stats));
+    EXPECT_EQ(stats.files, 3u);
+    EXPECT_EQ(stats.imported, 2u);
+    EXPECT_EQ(stats.unchanged, 0u);
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_GT(stats.filesPerSecond(), 0.0);
+
+    // Referenced where it is, and a file without an artist tag is filed under its folder
+    const std::string first_path = std::filesystem::canonical(first).string();
+    const std::string mix_id = LibraryImporter::mixIdForPath(first_path);
+    AutoVibez::Data::Mix mix = database.getMixById(mix_id);
+    EXPECT_EQ(mix.title, "Endtroducing");
+    EXPECT_EQ(mix.artist, "DJ Shadow");
+    EXPECT_EQ(mix.local_path, first_path);
+    EXPECT_EQ(downloader.getLocalPath(mix_id), first_path);
+    EXPECT_TRUE(downloader.isMixDownloaded(mix_id));
+    EXPECT_FALSE(downloader.ownsFile(first_path));
+    EXPECT_TRUE(std::filesystem::exists(second));
+
+    ASSERT_TRUE(importer.importDirectory(library_dir.string(), stats));
+    EXPECT_EQ(stats.files, 3u);
+    EXPECT_EQ(stats.imported, 0u);
+    EXPECT_EQ(stats.unchanged, 2u);
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(database.getAllMixes().size(), 2u);
+}
+
+TEST_F(LibraryImporterTest, RejectsAMissingDirectory) {
+    MixDatabase database((test_dir / "library.db").string());
+    ASSERT_TRUE(database.initialize());
+    MixDownloader downloader((test_dir / "mixes").string());
+    AutoVibez::Utils::Mp3ProbeCache scan_cache;
+    LibraryImporter importer(database, downloader, scan_cache);
+
+    LibraryImportStats stats;
+    EXPECT_FALSE(importer.importDirectory((test_dir / "missing").string(), stats));
+    EXPECT_FALSE(importer.getLastError().empty());
+}
+
+TEST_F(LibraryImporterTest, MixIdDependsOnlyOnThePath) {
+    EXPECT_EQ(LibraryImporter::mixIdForPath("/music/a.mp3"), LibraryImporter::mixIdForPath("/music/a.mp3"));
+    EXPECT_NE(LibraryImporter::mixIdForPath("/music/a.mp3"), LibraryImporter::mixIdForPath("/music/b.mp3"));
+    EXPECT_EQ(LibraryImporter::mixIdForPath("/music/a.mp3").rfind("local-", 0), 0u);
+}
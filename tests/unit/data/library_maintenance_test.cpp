@@ -0,0 +1,161 @@
+#include "data/library_maintenance.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "data/mix_database.hpp"
+#include "utils/uuid_utils.hpp"
+
+using AutoVibez::Data::LibraryMaintenance;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Utils::HashIdUtils;
+using AutoVibez::Utils::Mp3ProbeCache;
+
+class LibraryMaintenanceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "autovibez_library_maintenance_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir / "mixes");
+        database = std::make_unique<MixDatabase>((dir / "mixes.db").string());
+        ASSERT_TRUE(database->initialize());
+    }
+
+    void TearDown() override {
+        database.reset();
+        std::filesystem::remove_all(dir);
+    }
+
+    // A mix stored under the id its URL hashes to, unless id is given, with a file of junk at local_path
+    Mix addMix(const std::string& name, const std::string& id = "", const std::string& local_path = "") {
+        Mix mix;
+        mix.url = "https://example.com/" + name + ".mp3";
+        mix.id = id.empty() ? HashIdUtils::generateIdFromUrl(mix.url) : id;
+        mix.title = "Mix " + name;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.duration_seconds = 3600;
+        mix.local_path = local_path.empty() ? (dir / "mixes" / (name + ".mp3")).string() : local_path;
+        if (local_path.empty()) {
+            std::ofstream file(mix.local_path, std::ios::binary);
+            file << std::string(4096, 'x');
+        }
+        EXPECT_TRUE(database->addMix(mix));
+        return mix;
+    }
+
+    bool inLibrary(const std::string& id) {
+        return database->getCatalog()->snapshot()->findById(id) != nullptr;
+    }
+
+    // Run every check due at now
+    static void drain(LibraryMaintenance& maintenance, LibraryMaintenance::Clock::time_point now) {
+        while (maintenance.step(now)) {
+        }
+    }
+
+    std::filesystem::path dir;
+    std::unique_ptr<MixDatabase> database;
+    Mp3ProbeCache probe_cache;
+};
+
+namespace {
+const auto SETTLE = std::chrono::milliseconds(Constants::MAINTENANCE_REMOVAL_SETTLE_MS);
+}
+
+TEST_F(LibraryMaintenanceTest, MissingFileRemovesTheMixOnceSettled) {
+    const Mix mix = addMix("gone");
+    LibraryMaintenance maintenance(*database, probe_cache, (dir / "elsewhere").string());
+    std::filesystem::remove(mix.local_path);
+
+    const auto now = LibraryMaintenance::Clock::now();
+    maintenance.touch(mix.id);
+    drain(maintenance, now);
+    EXPECT_TRUE(inLibrary(mix.id));  // The cache may be about to clear the path
+
+    drain(maintenance, now + SETTLE);
+    EXPECT_FALSE(inLibrary(mix.id));
+    EXPECT_EQ(maintenance.getStats().rows_removed, 1u);
+}
+
+TEST_F(LibraryMaintenanceTest, MixesOnAMissingDirectoryStay) {
+    const Mix mix = addMix("share", "", (dir / "unmounted" / "share.mp3").string());
+    LibraryMaintenance maintenance(*database, probe_cache, (dir / "elsewhere").string());
+
+    const auto now = LibraryMaintenance::Clock::now();
+    drain(maintenance, now);
+    drain(maintenance, now + SETTLE);
+    EXPECT_TRUE(inLibrary(mix.id));
+    EXPECT_EQ(maintenance.getStats().sweeps, 1u);
+}
+
+TEST_F(LibraryMaintenanceTest, NextDueFollowsTheWork) {
+    const Mix mix = addMix("due");
+    LibraryMaintenance maintenance(*database, probe_cache, (dir / "elsewhere").string());
+
+    // The first sweep is due at once; the next one an interval after it ends
+    const auto now = LibraryMaintenance::Clock::now();
+    EXPECT_LE(maintenance.getNextDue(), now);
+    drain(maintenance, now);
+    EXPECT_EQ(maintenance.getNextDue(), now + std::chrono::milliseconds(Constants::MAINTENANCE_SWEEP_INTERVAL_MS));
+
+    std::filesystem::remove(mix.local_path);
+    maintenance.touch(mix.id);
+    EXPECT_EQ(maintenance.getNextDue(), LibraryMaintenance::Clock::time_point::min());
+    drain(maintenance, now);
+    EXPECT_EQ(maintenance.getNextDue(), now + SETTLE);
+}
+
+TEST_F(LibraryMaintenanceTest, StaleIdsAreRewrittenFromTheUrl) {
+    const Mix mix = addMix("renamed", "legacy-id");
+    LibraryMaintenance maintenance(*database, probe_cache, (dir / "elsewhere").string());
+
+    maintenance.touch("legacy-id");
+    EXPECT_TRUE(maintenance.step());
+    EXPECT_FALSE(inLibrary("legacy-id"));
+    EXPECT_TRUE(inLibrary(HashIdUtils::generateIdFromUrl(mix.url)));
+    EXPECT_EQ(maintenance.getStats().ids_corrected, 1u);
+}
+
+TEST_F(LibraryMaintenanceTest, SweepDeletesCorruptedFilesAndTheirMixes) {
+    const Mix mix = addMix("corrupted");
+    LibraryMaintenance maintenance(*database, probe_cache, (dir / "mixes").string());
+
+    const auto now = LibraryMaintenance::Clock::now();
+    drain(maintenance, now);
+    EXPECT_FALSE(std::filesystem::exists(mix.local_path));
+    EXPECT_EQ(maintenance.getStats().files_removed, 1u);
+    EXPECT_EQ(maintenance.getStats().sweeps, 1u);
+
+    drain(maintenance, now + SETTLE);
+    EXPECT_FALSE(inLibrary(mix.id));
+
+    // The next pass waits for its interval
+    EXPECT_FALSE(maintenance.step(now + SETTLE));
+}
+
+TEST_F(LibraryMaintenanceTest, WatcherReportsDeletionsWithoutASweep) {
+    const Mix mix = addMix("watched");
+    LibraryMaintenance maintenance(*database, probe_cache, (dir / "mixes").string());
+    if (!maintenance.isWatching()) {
+        GTEST_SKIP() << "No directory watcher on this platform";
+    }
+    AutoVibez::Utils::Mp3ProbeResult valid;
+    valid.valid = true;
+    probe_cache.store(mix.local_path, valid);  // Taken as a valid file, so the sweep leaves it
+
+    const auto now = LibraryMaintenance::Clock::now();
+    drain(maintenance, now);
+    ASSERT_EQ(maintenance.getStats().sweeps, 1u);
+
+    std::filesystem::remove(mix.local_path);
+    maintenance.tick(now);
+    maintenance.tick(now + SETTLE);
+    EXPECT_FALSE(inLibrary(mix.id));
+    EXPECT_EQ(maintenance.getStats().sweeps, 1u);
+}
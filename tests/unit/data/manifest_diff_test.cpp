@@ -0,0 +1,86 @@
+#include "data/manifest_diff.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using AutoVibez::Data::ManifestDiff;
+using AutoVibez::Data::Mix;
+
+namespace {
+Mix makeEntry(const std::string& id) {
+    Mix mix;
+    mix.id = id;
+    mix.url = "https://example.com/" + id + ".mp3";
+    mix.title = "Title " + id;
+    mix.artist = "Artist";
+    mix.genre = "Techno";
+    mix.duration_seconds = 3600;
+    mix.tags = {"dark"};
+    return mix;
+}
+
+std::unordered_map<std::string, uint64_t> hashesOf(const std::vector<Mix>& manifest) {
+    std::unordered_map<std::string, uint64_t> hashes;
+    for (const Mix& mix : manifest) {
+        hashes[mix.id] = ManifestDiff::hashEntry(mix);
+    }
+    return hashes;
+}
+}  // namespace
+
+TEST(ManifestDiffTest, HashCoversEveryManifestField) {
+    const Mix base = makeEntry("a");
+    const uint64_t hash = ManifestDiff::hashEntry(base);
+    EXPECT_EQ(ManifestDiff::hashEntry(makeEntry("a")), hash);
+
+    Mix changed = base;
+    changed.url = "https://mirror.example.com/a.mp3";
+    EXPECT_NE(ManifestDiff::hashEntry(changed), hash);
+    changed = base;
+    changed.tags = {"dark", "peak time"};
+    EXPECT_NE(ManifestDiff::hashEntry(changed), hash);
+    changed = base;
+    changed.duration_seconds = 3601;
+    EXPECT_NE(ManifestDiff::hashEntry(changed), hash);
+
+    // Fields are kept apart, so moving text from one to the next changes the hash
+    changed = base;
+    changed.title = "Title a" + changed.artist;
+    changed.artist.clear();
+    EXPECT_NE(ManifestDiff::hashEntry(changed), hash);
+
+    // What the library adds is not part of the entry
+    changed = base;
+    changed.local_path = "/music/a.mp3";
+    changed.play_count = 7;
+    changed.is_favorite = true;
+    EXPECT_EQ(ManifestDiff::hashEntry(changed), hash);
+}
+
+TEST(ManifestDiffTest, UnchangedManifestIsEmpty) {
+    const std::vector<Mix> manifest = {makeEntry("a"), makeEntry("b"), makeEntry("c")};
+    EXPECT_TRUE(ManifestDiff::compute(manifest, hashesOf(manifest)).empty());
+}
+
+TEST(ManifestDiffTest, SortsEntriesIntoAddedUpdatedAndRemoved) {
+    const std::vector<Mix> before = {makeEntry("a"), makeEntry("b"), makeEntry("c")};
+    std::vector<Mix> after = {makeEntry("a"), makeEntry("c"), makeEntry("d")};
+    after[1].tags = {"retagged"};
+
+    const ManifestDiff diff = ManifestDiff::compute(after, hashesOf(before));
+    ASSERT_EQ(diff.added.size(), 1u);
+    EXPECT_EQ(diff.added[0].id, "d");
+    ASSERT_EQ(diff.updated.size(), 1u);
+    EXPECT_EQ(diff.updated[0].id, "c");
+    EXPECT_EQ(diff.removed, std::vector<std::string>{"b"});
+}
+
+TEST(ManifestDiffTest, RepeatedIdCountsOnce) {
+    const std::vector<Mix> manifest = {makeEntry("a"), makeEntry("a")};
+    const ManifestDiff diff = ManifestDiff::compute(manifest, {});
+    EXPECT_EQ(diff.added.size(), 1u);
+    EXPECT_TRUE(diff.removed.empty());
+}
@@ -0,0 +1,126 @@
+#include "data/manifest_snapshot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using AutoVibez::Data::ManifestSnapshot;
+using AutoVibez::Data::Mix;
+
+class ManifestSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_path = (std::filesystem::temp_directory_path() / "autovibez_manifest_snapshot_test.bin").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(test_path);
+    }
+
+    static std::vector<Mix> makeMixes(size_t count) {
+        std::vector<Mix> mixes;
+        for (size_t i = 0; i < count; ++i) {
+            Mix mix;
+            mix.id = "mix" + std::to_string(i);
+            mix.url = "https://example.com/" + mix.id + ".mp3";
+            mix.original_filename = mix.id + ".mp3";
+            mix.title = "Title " + std::to_string(i);
+            mix.artist = i % 2 ? "Artist A" : "Artist B";
+            mix.genre = "Techno";
+            mix.duration_seconds = static_cast<int>(i) * 60;
+            if (i % 3 == 0) {
+                mix.tags = {"dark", "peak time"};
+            }
+            mixes.push_back(mix);
+        }
+        return mixes;
+    }
+
+    std::string test_path;
+};
+
+TEST_F(ManifestSnapshotTest, RoundTripsEveryField) {
+    std::vector<Mix> mixes = makeMixes(3);
+    mixes[1].description = "Live at the warehouse";
+    ASSERT_TRUE(ManifestSnapshot::write(test_path, mixes, "/music/mixes.yaml", "1234:5678"));
+
+    ManifestSnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(test_path)) << snapshot.getLastError();
+    ASSERT_EQ(snapshot.size(), 3u);
+    const std::vector<Mix> loaded = snapshot.toMixes();
+    for (size_t i = 0; i < mixes.size(); ++i) {
+        EXPECT_EQ(loaded[i].id, mixes[i].id);
+        EXPECT_EQ(loaded[i].url, mixes[i].url);
+        EXPECT_EQ(loaded[i].original_filename, mixes[i].original_filename);
+        EXPECT_EQ(loaded[i].title, mixes[i].title);
+        EXPECT_EQ(loaded[i].artist, mixes[i].artist);
+        EXPECT_EQ(loaded[i].genre, mixes[i].genre);
+        EXPECT_EQ(loaded[i].description, mixes[i].description);
+        EXPECT_EQ(loaded[i].duration_seconds, mixes[i].duration_seconds);
+        EXPECT_EQ(loaded[i].tags, mixes[i].tags);
+    }
+}
+
+TEST_F(ManifestSnapshotTest, FindsMixesById) {
+    ASSERT_TRUE(ManifestSnapshot::write(test_path, makeMixes(5000), "mixes.yaml", "stamp"));
+
+    ManifestSnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(test_path));
+    Mix found;
+    ASSERT_TRUE(snapshot.find("mix4321", found));
+    EXPECT_EQ(found.title, "Title 4321");
+    EXPECT_TRUE(snapshot.find("mix0", found));
+    EXPECT_FALSE(snapshot.find("mix5000", found));
+    EXPECT_FALSE(snapshot.find("", found));
+}
+
+TEST_F(ManifestSnapshotTest, MatchesOnlyItsSourceAndStamp) {
+    ASSERT_TRUE(ManifestSnapshot::write(test_path, makeMixes(2), "https://example.com/mixes.yaml", "\"v1\""));
+
+    ManifestSnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(test_path));
+    EXPECT_TRUE(snapshot.matches("https://example.com/mixes.yaml", "\"v1\""));
+    EXPECT_FALSE(snapshot.matches("https://example.com/mixes.yaml", "\"v2\""));
+    EXPECT_FALSE(snapshot.matches("https://example.com/other.yaml", "\"v1\""));
+}
+
+TEST_F(ManifestSnapshotTest, EmptyManifestIsValid) {
+    ASSERT_TRUE(ManifestSnapshot::write(test_path, {}, "mixes.yaml", "stamp"));
+
+    ManifestSnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(test_path));
+    EXPECT_EQ(snapshot.size(), 0u);
+    Mix found;
+    EXPECT_FALSE(snapshot.find("mix0", found));
+}
+
+TEST_F(ManifestSnapshotTest, RejectsDamagedFiles) {
+    ManifestSnapshot snapshot;
+    EXPECT_FALSE(snapshot.open(test_path));  // Missing
+
+    {
+        std::ofstream file(test_path, std::ios::binary);
+        file << "mixes:\n  - https://example.com/mix.mp3\n";
+    }
+    EXPECT_FALSE(snapshot.open(test_path));
+    EXPECT_FALSE(snapshot.isOpen());
+
+    // Cut short: the header points past the end
+    ASSERT_TRUE(ManifestSnapshot::write(test_path, makeMixes(100), "mixes.yaml", "stamp"));
+    std::filesystem::resize_file(test_path, std::filesystem::file_size(test_path) / 2);
+    EXPECT_FALSE(snapshot.open(test_path));
+
+    // Another version
+    ASSERT_TRUE(ManifestSnapshot::write(test_path, makeMixes(1), "mixes.yaml", "stamp"));
+    {
+        std::fstream file(test_path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t version = ManifestSnapshot::VERSION + 1;
+        file.seekp(8);
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    EXPECT_FALSE(snapshot.open(test_path));
+    EXPECT_FALSE(snapshot.getLastError().empty());
+}
@@ -0,0 +1,166 @@
+#include "data/mix_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "data/mix_database.hpp"
+
+using AutoVibez::Data::CachedMixFile;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixCache;
+using AutoVibez::Data::MixDatabase;
+
+class MixCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "autovibez_mix_cache_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        database = std::make_unique<MixDatabase>((dir / "mixes.db").string());
+        ASSERT_TRUE(database->initialize());
+    }
+
+    void TearDown() override {
+        database.reset();
+        std::filesystem::remove_all(dir);
+    }
+
+    // A downloaded mix whose file is bytes long and was written days_old days ago
+    std::string addMix(const std::string& id, size_t bytes, int days_old, int play_count = 0, bool favorite = false) {
+        const std::filesystem::path path = dir / (id + ".mp3");
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << std::string(bytes, 'x');
+        }
+        std::filesystem::last_write_time(
+            path, std::filesystem::file_time_type::clock::now() - std::chrono::hours(24 * days_old));
+
+        Mix mix;
+        mix.id = id;
+        mix.title = "Mix " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.url = "https://example.com/" + id + ".mp3";
+        mix.duration_seconds = 3600;
+        mix.local_path = path.string();
+        mix.play_count = play_count;
+        mix.is_favorite = favorite;
+        EXPECT_TRUE(database->addMix(mix));
+        return mix.local_path;
+    }
+
+    std::filesystem::path dir;
+    std::unique_ptr<MixDatabase> database;
+};
+
+TEST_F(MixCacheTest, EvictsDownToTheQuotaLeastValuedFirst) {
+    MixCache cache(*database);
+    const std::string favorite = addMix("favorite", 1000, 60, 0, true);
+    const std::string played = addMix("played", 1000, 30, 8);
+    const std::string old_unplayed = addMix("old", 1000, 30);
+    const std::string new_unplayed = addMix("new", 1000, 1);
+    for (const char* id : {"favorite", "played", "old", "new"}) {
+        ASSERT_TRUE(cache.recordFile(id, (dir / (std::string(id) + ".mp3")).string()));
+    }
+    EXPECT_EQ(cache.getUsedBytes(), 4000);
+
+    std::vector<std::string> evicted;
+    cache.setEvictedCallback([&evicted](const CachedMixFile& file) { evicted.push_back(file.mix_id); });
+    cache.stop();  // Trimmed by hand below
+    cache.setQuota(2500);
+    EXPECT_EQ(cache.trimStep(), 2u);
+    EXPECT_EQ(evicted, (std::vector<std::string>{"old", "new"}));
+    EXPECT_EQ(cache.getUsedBytes(), 2000);
+    EXPECT_EQ(cache.trimStep(), 0u);
+
+    // Gone from the disk, still in the library to be downloaded again
+    EXPECT_FALSE(std::filesystem::exists(old_unplayed));
+    EXPECT_FALSE(std::filesystem::exists(new_unplayed));
+    EXPECT_TRUE(std::filesystem::exists(played));
+    EXPECT_TRUE(std::filesystem::exists(favorite));
+    const Mix kept = database->getMixById("old");
+    EXPECT_EQ(kept.id, "old");
+    EXPECT_TRUE(kept.local_path.empty());
+
+    // Favorites stay however far over the quota
+    cache.setQuota(1);
+    EXPECT_EQ(cache.trimStep(), 1u);
+    EXPECT_TRUE(std::filesystem::exists(favorite));
+    EXPECT_EQ(cache.getUsedBytes(), 1000);
+}
+
+TEST_F(MixCacheTest, NeverEvictsProtectedMixes) {
+    MixCache cache(*database);
+    const std::string playing = addMix("playing", 1000, 90);
+    const std::string next = addMix("next", 1000, 80);
+    addMix("other", 1000, 10);
+    for (const char* id : {"playing", "next", "other"}) {
+        ASSERT_TRUE(cache.recordFile(id, (dir / (std::string(id) + ".mp3")).string()));
+    }
+    cache.stop();
+
+    cache.setProtected({"playing", "next"});
+    cache.setQuota(1500);
+    EXPECT_EQ(cache.trimStep(), 1u);
+    EXPECT_TRUE(std::filesystem::exists(playing));
+    EXPECT_TRUE(std::filesystem::exists(next));
+    EXPECT_EQ(cache.trimStep(), 0u);  // Still over, with nothing more that may go
+
+    cache.setProtected({"next"});
+    EXPECT_EQ(cache.trimStep(), 1u);
+    EXPECT_FALSE(std::filesystem::exists(playing));
+    EXPECT_EQ(cache.getUsedBytes(), 1000);
+}
+
+TEST_F(MixCacheTest, KeepsAFileAnotherMixShares) {
+    MixCache cache(*database);
+    const std::string shared = addMix("original", 1000, 30);
+    addMix("reupload", 1000, 20);
+    ASSERT_TRUE(database->setLocalPath("reupload", shared));
+    for (const char* id : {"original", "reupload"}) {
+        ASSERT_TRUE(cache.recordFile(id, shared));
+    }
+    cache.stop();
+
+    // Each mix counts the file; it goes with the last of them
+    cache.setQuota(1500);
+    EXPECT_EQ(cache.trimStep(), 1u);
+    EXPECT_TRUE(std::filesystem::exists(shared));
+    EXPECT_EQ(cache.getUsedBytes(), 1000);
+    cache.setQuota(500);
+    EXPECT_EQ(cache.trimStep(), 1u);
+    EXPECT_FALSE(std::filesystem::exists(shared));
+}
+
+TEST_F(MixCacheTest, SizesFilesFromBeforeTheCache) {
+    addMix("first", 300, 1);
+    addMix("second", 700, 1);
+    MixCache cache(*database);
+    cache.stop();
+    EXPECT_EQ(cache.getUsedBytes(), 0);
+
+    EXPECT_EQ(cache.backfillStep(), 2u);
+    EXPECT_EQ(cache.getUsedBytes(), 1000);
+    EXPECT_EQ(cache.backfillStep(), 0u);
+}
+
+TEST_F(MixCacheTest, WorkerTrimsInTheBackground) {
+    for (int i = 0; i < 40; ++i) {
+        addMix("mix" + std::to_string(i), 100, 40 - i);
+    }
+    MixCache cache(*database);
+    cache.setQuota(1000);  // Sizes the library, then evicts in batches
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (cache.getUsedBytes() != 1000 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(cache.getUsedBytes(), 1000);
+    EXPECT_FALSE(std::filesystem::exists(dir / "mix0.mp3"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "mix39.mp3"));
+}
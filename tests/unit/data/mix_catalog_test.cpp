@@ -0,0 +1,135 @@
+#include "mix_catalog.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace AutoVibez::Data;
+
+namespace {
+Mix makeMix(const std::string& id, const std::string& title, const std::string& genre, const std::string& artist) {
+    Mix mix;
+    mix.id = id;
+    mix.title = title;
+    mix.genre = genre;
+    mix.artist = artist;
+    return mix;
+}
+}  // namespace
+
+class MixCatalogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Mix deleted = makeMix("mix4", "Deleted", "House", "Artist C");
+        deleted.is_deleted = true;
+        catalog.load({makeMix("mix1", "Charlie", "Electronic", "Artist A"),
+                      makeMix("mix2", "Alpha", "House", "Artist B"),
+                      makeMix("mix3", "Bravo", "electronic", "Artist A"), deleted});
+    }
+
+    MixCatalog catalog;
+};
+
+TEST_F(MixCatalogTest, SnapshotIsSortedAndIndexed) {
+    auto snapshot = catalog.snapshot();
+    ASSERT_EQ(snapshot->size(), 3u);
+    EXPECT_EQ(snapshot->entries()[0]->id(), "mix2");
+    EXPECT_EQ(snapshot->entries()[2]->id(), "mix1");
+
+    ASSERT_NE(snapshot->findById("mix3"), nullptr);
+    EXPECT_EQ(snapshot->findById("mix3")->title(), "Bravo");
+    EXPECT_EQ(snapshot->findById("mix4"), nullptr);
+    EXPECT_EQ(snapshot->findByGenre("ELECTRONIC").size(), 2u);
+    EXPECT_EQ(snapshot->genrePositions("Electronic"), (std::vector<uint32_t>{1, 2}));
+    EXPECT_TRUE(snapshot->genrePositions("Ambient").empty());
+    uint32_t position = 0;
+    ASSERT_TRUE(snapshot->positionOf("mix1", position));
+    EXPECT_EQ(position, 2u);
+    EXPECT_FALSE(snapshot->positionOf("mix4", position));
+    EXPECT_EQ(snapshot->findByArtist("Artist A").size(), 2u);
+    EXPECT_TRUE(snapshot->findByArtist("artist a").empty());
+    EXPECT_EQ(snapshot->getGenres(), (std::vector<std::string>{"Electronic", "House", "electronic"}));
+}
+
+TEST_F(MixCatalogTest, GenreIndexFollowsWrites) {
+    auto snapshot = catalog.snapshot();
+    size_t position = 0;
+    ASSERT_TRUE(snapshot->genrePosition("electronic", position));
+    EXPECT_EQ(position, 2u);
+    ASSERT_TRUE(snapshot->genrePosition("ELECTRONIC", position));
+    EXPECT_EQ(position, 0u);
+    EXPECT_FALSE(snapshot->genrePosition("Ambient", position));
+    ASSERT_NE(snapshot->findGenre("house"), nullptr);
+    EXPECT_EQ(*snapshot->findGenre("house"), "House");
+    EXPECT_EQ(snapshot->findGenre("Ambient"), nullptr);
+    EXPECT_EQ(snapshot->genreCount("Electronic"), 2u);
+
+    catalog.put(makeMix("mix5", "Delta", "Ambient", "Artist D"));
+    catalog.remove("mix2");
+    snapshot = catalog.snapshot();
+    EXPECT_EQ(snapshot->getGenres(), (std::vector<std::string>{"Ambient", "Electronic", "electronic"}));
+    ASSERT_NE(snapshot->findGenre("AMBIENT"), nullptr);
+    EXPECT_EQ(snapshot->genreCount("ambient"), 1u);
+    EXPECT_EQ(snapshot->findGenre("House"), nullptr);
+    EXPECT_EQ(snapshot->genreCount("House"), 0u);
+}
+
+TEST_F(MixCatalogTest, BuilderAttachesTagsAndSkipsRepeatedIds) {
+    MixCatalogBuilder builder;
+    builder.add(makeMix("mix1", "Bravo", "House", "Artist A"));
+    builder.add(makeMix("mix2", "Alpha", "House", "Artist A"));
+    builder.add(makeMix("mix1", "Repeated", "Techno", "Artist B"));
+    builder.addTag("mix1", "deep");
+    builder.addTag("mix1", "vinyl");
+    builder.addTag("missing", "lost");
+    builder.addTag("mix2", "deep");
+    catalog.load(builder);
+    EXPECT_EQ(builder.size(), 0u);
+
+    auto snapshot = catalog.snapshot();
+    ASSERT_EQ(snapshot->size(), 2u);
+    EXPECT_EQ(snapshot->entries()[0]->id(), "mix2");
+    const Mix mix = snapshot->toMix(*snapshot->findById("mix1"));
+    EXPECT_EQ(mix.title, "Bravo");
+    EXPECT_EQ(mix.tags, (std::vector<std::string>{"deep", "vinyl"}));
+    // Shared strings are stored once
+    EXPECT_EQ(snapshot->findById("mix1")->tags[0], snapshot->findById("mix2")->tags[0]);
+    EXPECT_EQ(snapshot->findById("mix1")->artist, snapshot->findById("mix2")->artist);
+}
+
+TEST_F(MixCatalogTest, WritesPublishNewSnapshotsAndNotify) {
+    std::vector<MixCatalogChange> changes;
+    const int listener = catalog.subscribe([&changes](const MixCatalogChange& change) { changes.push_back(change); });
+
+    auto before = catalog.snapshot();
+    Mix renamed = makeMix("mix2", "Zulu", "House", "Artist B");
+    renamed.play_count = 3;
+    catalog.put(renamed);
+    catalog.put(makeMix("mix5", "Delta", "Techno", "Artist D"));
+    catalog.remove("mix1");
+    catalog.remove("missing");
+
+    // The old snapshot is untouched, and never saw the new artist's string
+    EXPECT_EQ(before->size(), 3u);
+    EXPECT_EQ(before->findById("mix2")->title(), "Alpha");
+    EXPECT_TRUE(before->findByArtist("Artist D").empty());
+
+    auto after = catalog.snapshot();
+    ASSERT_EQ(after->size(), 3u);
+    EXPECT_EQ(after->entries().back()->id(), "mix2");
+    EXPECT_EQ(after->findById("mix2")->play_count, 3);
+    EXPECT_EQ(after->findById("mix1"), nullptr);
+    EXPECT_EQ(after->findByGenre("techno").size(), 1u);
+    EXPECT_EQ(after->artistOf(*after->findById("mix5")), "Artist D");
+
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].type, MixCatalogChange::Type::Updated);
+    EXPECT_EQ(changes[1].type, MixCatalogChange::Type::Added);
+    EXPECT_EQ(changes[2].type, MixCatalogChange::Type::Removed);
+    EXPECT_EQ(changes[2].id, "mix1");
+
+    catalog.unsubscribe(listener);
+    Mix deleted = makeMix("mix3", "Bravo", "electronic", "Artist A");
+    deleted.is_deleted = true;
+    catalog.put(deleted);
+    EXPECT_EQ(changes.size(), 3u);
+    EXPECT_EQ(catalog.snapshot()->findById("mix3"), nullptr);
+}
@@ -2,9 +2,38 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
 
+#include "data/mix_downloader.hpp"
 #include "data/mix_metadata.hpp"
+#include "utils/uuid_utils.hpp"
+
+namespace {
+// An id as HashIdUtils made them before they were packed: a std::hash written twice into UUID text
+std::string oldHashId(size_t hash) {
+    std::ostringstream text;
+    text << std::hex << std::setfill('0');
+    for (int i = 0; i < 16; i++) {
+        int byte = (hash >> (i % 8 * 8)) & 0xFF;
+        if (i == 6) {
+            byte = (byte & 0x0F) | 0x50;
+        } else if (i == 8) {
+            byte = (byte & 0x3F) | 0x80;
+        }
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            text << '-';
+        }
+        text << std::setw(2) << byte;
+    }
+    return text.str();
+}
+}  // namespace
 
 class MixDatabaseTest : public ::testing::Test {
 protected:
@@ -322,3 +351,740 @@ TEST_F(MixDatabaseTest, GetRandomMixByGenreExcludesSoftDeleted) {
     randomMix = db.getRandomMixByGenre("Experimental");
     EXPECT_TRUE(randomMix.id.empty());
 }
+
+TEST_F(MixDatabaseTest, StoresMixAnalysis) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+
+    AutoVibez::Data::Mix mix;
+    mix.id = "analyzed-mix";
+    mix.title = "Analyzed Mix";
+    mix.artist = "Artist";
+    mix.genre = "House";
+    mix.duration_seconds = 3600;
+    mix.local_path = "/path/to/mix.mp3";
+    EXPECT_TRUE(db.addMix(mix));
+
+    // New downloads are pending analysis
+    EXPECT_FALSE(db.getMixById("analyzed-mix").has_analysis);
+    ASSERT_EQ(db.getUnanalyzedMixes().size(), 1);
+
+    EXPECT_TRUE(db.setMixAnalysis("analyzed-mix", -9.5, -0.3, 124.0, 1850.0));
+
+    auto stored = db.getMixById("analyzed-mix");
+    EXPECT_TRUE(stored.has_analysis);
+    EXPECT_DOUBLE_EQ(stored.loudness_lufs, -9.5);
+    EXPECT_DOUBLE_EQ(stored.peak_dbfs, -0.3);
+    EXPECT_DOUBLE_EQ(stored.bpm, 124.0);
+    EXPECT_DOUBLE_EQ(stored.spectral_centroid_hz, 1850.0);
+    EXPECT_TRUE(db.setSeekIndex("analyzed-mix", ""));
+    EXPECT_TRUE(db.getUnanalyzedMixes().empty());
+
+    // Metadata updates leave the analysis in place
+    stored.title = "Renamed Mix";
+    EXPECT_TRUE(db.updateMix(stored));
+    EXPECT_TRUE(db.getMixById("analyzed-mix").has_analysis);
+}
+
+TEST_F(MixDatabaseTest, StoresSeekIndexSeparately) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+
+    AutoVibez::Data::Mix mix;
+    mix.id = "indexed-mix";
+    mix.title = "Indexed Mix";
+    mix.artist = "Artist";
+    mix.genre = "Techno";
+    mix.duration_seconds = 7200;
+    mix.local_path = "/path/to/mix.mp3";
+    EXPECT_TRUE(db.addMix(mix));
+
+    EXPECT_EQ(db.getSeekIndex("indexed-mix"), "");
+    EXPECT_TRUE(db.setSeekIndex("indexed-mix", "v1;192;1000;44100;0,10"));
+    EXPECT_EQ(db.getSeekIndex("indexed-mix"), "v1;192;1000;44100;0,10");
+
+    // Both the analysis and the index are needed before a mix counts as done
+    EXPECT_EQ(db.getUnanalyzedMixes().size(), 1);
+    EXPECT_TRUE(db.setMixAnalysis("indexed-mix", -10.0, -1.0, 128.0));
+    EXPECT_TRUE(db.getUnanalyzedMixes().empty());
+    EXPECT_EQ(db.getSeekIndex("missing-mix"), "");
+}
+
+TEST_F(MixDatabaseTest, IngestsABatchInOneTransaction) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+
+    std::vector<AutoVibez::Data::Mix> batch;
+    for (int i = 0; i < 50; ++i) {
+        AutoVibez::Data::Mix mix;
+        mix.id = "batch-" + std::to_string(i);
+        mix.title = "Batch Mix " + std::to_string(i);
+        mix.artist = "Artist";
+        mix.genre = "House";
+        mix.duration_seconds = 3600;
+        batch.push_back(mix);
+    }
+    batch.push_back(AutoVibez::Data::Mix());  // Fails validation
+
+    AutoVibez::Data::MixIngestStats stats;
+    ASSERT_TRUE(db.ingestMixes(batch, {}, stats));
+    EXPECT_EQ(stats.inserted, 50);
+    EXPECT_EQ(stats.failed, 1);
+    EXPECT_GT(stats.rowsPerSecond(), 0.0);
+    EXPECT_EQ(db.getAllMixes().size(), 50);
+    EXPECT_EQ(db.searchMixes("batch mix 7").size(), 1u);  // Refilled in one go: the batch is the whole library
+
+    // Existing rows are updated in place and keep their analysis
+    EXPECT_TRUE(db.setMixAnalysis("batch-0", -9.0, -1.0, 126.0));
+    batch.resize(2);
+    batch[0].title = "Renamed";
+    ASSERT_TRUE(db.ingestMixes(batch, {"batch-10", "missing"}, stats));
+    EXPECT_EQ(stats.updated, 2);
+    EXPECT_EQ(stats.soft_deleted, 1);
+    EXPECT_EQ(stats.failed, 1);
+    EXPECT_EQ(db.getMixById("batch-0").title, "Renamed");
+    EXPECT_TRUE(db.getMixById("batch-0").has_analysis);
+    EXPECT_EQ(db.getAllMixes().size(), 49);
+    EXPECT_EQ(db.getCatalog()->snapshot()->findById("batch-10"), nullptr);
+    EXPECT_EQ(db.searchMixes("renamed").size(), 1u);
+    EXPECT_TRUE(db.searchMixes("batch mix 10").empty());
+}
+
+TEST_F(MixDatabaseTest, IngestsManifestDiffsAndStoresTheirHashes) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+
+    auto makeEntry = [](const std::string& id) {
+        AutoVibez::Data::Mix mix;
+        mix.id = id;
+        mix.url = "https://example.com/" + id + ".mp3";
+        mix.title = "Entry " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.duration_seconds = 3600;
+        return mix;
+    };
+    std::vector<AutoVibez::Data::Mix> manifest = {makeEntry("a"), makeEntry("b"), makeEntry("c")};
+
+    // "a" was downloaded and played; the others are only listed
+    AutoVibez::Data::Mix downloaded = manifest[0];
+    downloaded.local_path = "/music/a.mp3";
+    ASSERT_TRUE(db.addMix(downloaded));
+    ASSERT_TRUE(db.updatePlayStats("a"));
+
+    std::unordered_map<std::string, uint64_t> hashes;
+    ASSERT_TRUE(db.getManifestHashes(hashes));
+    AutoVibez::Data::ManifestDiff diff = AutoVibez::Data::ManifestDiff::compute(manifest, hashes);
+    EXPECT_EQ(diff.added.size(), 3u);
+    AutoVibez::Data::MixIngestStats stats;
+    ASSERT_TRUE(db.ingestManifest(diff, stats));
+    EXPECT_EQ(stats.updated + stats.inserted, 0);  // Only remembered; mixes join once downloaded
+
+    ASSERT_TRUE(db.getManifestHashes(hashes));
+    EXPECT_EQ(hashes.size(), 3u);
+    EXPECT_TRUE(AutoVibez::Data::ManifestDiff::compute(manifest, hashes).empty());
+
+    // Retagged and moved; "b" dropped
+    manifest[0].url = "https://mirror.example.com/a.mp3";
+    manifest[0].tags = {"warehouse"};
+    manifest.erase(manifest.begin() + 1);
+    diff = AutoVibez::Data::ManifestDiff::compute(manifest, hashes);
+    ASSERT_EQ(diff.updated.size(), 1u);
+    EXPECT_EQ(diff.removed, std::vector<std::string>{"b"});
+    ASSERT_TRUE(db.ingestManifest(diff, stats));
+    EXPECT_EQ(stats.updated, 1);
+
+    const AutoVibez::Data::Mix stored = db.getMixById("a");
+    EXPECT_EQ(stored.url, "https://mirror.example.com/a.mp3");
+    EXPECT_EQ(stored.tags, std::vector<std::string>{"warehouse"});
+    EXPECT_EQ(stored.local_path, "/music/a.mp3");
+    EXPECT_EQ(stored.play_count, 1);
+    EXPECT_EQ(db.getMixesByTag("warehouse").size(), 1u);
+
+    ASSERT_TRUE(db.getManifestHashes(hashes));
+    EXPECT_EQ(hashes.size(), 2u);
+    EXPECT_EQ(hashes.count("b"), 0u);
+    EXPECT_TRUE(AutoVibez::Data::ManifestDiff::compute(manifest, hashes).empty());
+}
+
+TEST_F(MixDatabaseTest, KeepsARunningTotalOfMixFiles) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+    for (const std::string id : {"a", "b", "c"}) {
+        AutoVibez::Data::Mix mix;
+        mix.id = id;
+        mix.title = "Mix " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.duration_seconds = 60;
+        mix.local_path = "/music/" + id + ".mp3";
+        ASSERT_TRUE(db.addMix(mix));
+    }
+    EXPECT_EQ(db.getUnsizedMixFiles(10).size(), 3u);
+
+    ASSERT_TRUE(db.recordMixFiles({{"a", "", 100, 1}, {"b", "", 200, 2}, {"c", "", 400, 3}}));
+    ASSERT_TRUE(db.recordMixFiles({{"b", "", 250, 2}}));  // Downloaded again
+    int64_t bytes = 0;
+    int64_t files = 0;
+    ASSERT_TRUE(db.getMixCacheUsage(bytes, files));
+    EXPECT_EQ(bytes, 750);
+    EXPECT_EQ(files, 3);
+    EXPECT_TRUE(db.getUnsizedMixFiles(10).empty());
+
+    // Evicted and deleted mixes leave the total
+    ASSERT_TRUE(db.clearLocalPath("a"));
+    EXPECT_TRUE(db.getMixById("a").local_path.empty());
+    EXPECT_EQ(db.getDownloadedMixes().size(), 2u);
+    ASSERT_TRUE(db.deleteMix("c"));
+    ASSERT_TRUE(db.getMixCacheUsage(bytes, files));
+    EXPECT_EQ(bytes, 250);
+    EXPECT_EQ(files, 1);
+    const std::vector<AutoVibez::Data::CachedMixFile> candidates = db.getEvictionCandidates(10);
+    ASSERT_EQ(candidates.size(), 1u);
+    EXPECT_EQ(candidates[0].mix_id, "b");
+    EXPECT_EQ(candidates[0].local_path, "/music/b.mp3");
+}
+
+TEST_F(MixDatabaseTest, FindsAnotherMixWithTheSameFileContent) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+    for (const std::string id : {"original", "reupload", "other"}) {
+        AutoVibez::Data::Mix mix;
+        mix.id = id;
+        mix.title = "Mix " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.duration_seconds = 60;
+        mix.local_path = "/music/" + id + ".mp3";
+        ASSERT_TRUE(db.addMix(mix));
+    }
+    ASSERT_TRUE(db.setContentHash("original", "0123456789abcdef"));
+    ASSERT_TRUE(db.setContentHash("other", "fedcba9876543210"));
+    EXPECT_EQ(db.getContentHash("original"), "0123456789abcdef");
+    EXPECT_EQ(db.getContentHash("reupload"), "");
+
+    EXPECT_EQ(db.findMixByContentHash("0123456789abcdef", "reupload").id, "original");
+    EXPECT_TRUE(db.findMixByContentHash("0123456789abcdef", "original").id.empty());
+    EXPECT_TRUE(db.findMixByContentHash("", "reupload").id.empty());
+
+    ASSERT_TRUE(db.setLocalPath("reupload", "/music/original.mp3"));
+    EXPECT_TRUE(db.isLocalPathShared("/music/original.mp3", "original"));
+    EXPECT_FALSE(db.isLocalPathShared("/music/other.mp3", "other"));
+
+    // The hash goes with the file
+    ASSERT_TRUE(db.clearLocalPath("original"));
+    EXPECT_EQ(db.getContentHash("original"), "");
+    EXPECT_TRUE(db.findMixByContentHash("0123456789abcdef", "reupload").id.empty());
+}
+
+TEST_F(MixDatabaseTest, DownloadFailuresOutlastARestart) {
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        ASSERT_TRUE(db.initialize());
+        ASSERT_TRUE(db.setDownloadFailure({"flaky", 1, 1000}));
+        ASSERT_TRUE(db.setDownloadFailure({"flaky", 2, 5000}));
+        ASSERT_TRUE(db.setDownloadFailure({"fixed", 1, 2000}));
+        ASSERT_TRUE(db.clearDownloadFailure("fixed"));
+    }
+
+    AutoVibez::Data::MixDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+    const std::vector<AutoVibez::Data::DownloadFailure> failures = db.getDownloadFailures();
+    ASSERT_EQ(failures.size(), 1u);
+    EXPECT_EQ(failures[0].mix_id, "flaky");
+    EXPECT_EQ(failures[0].failures, 2);
+    EXPECT_EQ(failures[0].retry_after_ms, 5000);
+}
+
+TEST_F(MixDatabaseTest, AddMixesWritesABatchAndSkipsInvalidRows) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+
+    std::vector<AutoVibez::Data::Mix> mixes(3);
+    mixes[0].id = "batch-one";
+    mixes[0].title = "One";
+    mixes[0].artist = "Artist";
+    mixes[0].genre = "Techno";
+    mixes[0].duration_seconds = 3600;
+    mixes[0].tags = {"deep", "dub"};
+    mixes[1].id = "";  // Fails validation; the rest still go in
+    mixes[1].title = "Nameless";
+    mixes[2].id = "batch-two";
+    mixes[2].title = "Two";
+    mixes[2].artist = "Artist";
+    mixes[2].genre = "House";
+    mixes[2].duration_seconds = 1800;
+
+    std::vector<bool> added;
+    ASSERT_TRUE(db.addMixes(mixes, {"0123456789abcdef", "", ""}, added));
+    EXPECT_EQ(added, (std::vector<bool>{true, false, true}));
+
+    EXPECT_EQ(db.getMixById("batch-one").tags, (std::vector<std::string>{"deep", "dub"}));
+    EXPECT_EQ(db.getMixById("batch-two").title, "Two");
+    EXPECT_EQ(db.getContentHash("batch-one"), "0123456789abcdef");
+    EXPECT_EQ(db.getContentHash("batch-two"), "");
+    EXPECT_NE(db.getCatalog()->snapshot()->findById("batch-two"), nullptr);
+}
+
+TEST_F(MixDatabaseTest, QueuedWritesShowInTheCatalogBeforeTheyCommit) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+
+    AutoVibez::Data::Mix mix;
+    mix.id = "queued-mix";
+    mix.title = "Queued Mix";
+    mix.artist = "Artist";
+    mix.genre = "Techno";
+    mix.duration_seconds = 3600;
+    EXPECT_TRUE(db.addMix(mix));
+
+    auto favorite = db.queueToggleFavorite("queued-mix");
+    db.queueRecordPlay("queued-mix");
+    db.queueRecordPlay("queued-mix");
+    db.queueLocalPath("queued-mix", "/path/to/queued.mp3");
+
+    auto preview = db.getCatalog()->snapshot()->findById("queued-mix");
+    ASSERT_NE(preview, nullptr);
+    EXPECT_TRUE(preview->is_favorite);
+    EXPECT_EQ(preview->play_count, 2);
+    EXPECT_EQ(preview->localPath(), "/path/to/queued.mp3");
+
+    EXPECT_TRUE(favorite.get());
+    db.flushWrites();
+    auto stored = db.getMixById("queued-mix");
+    EXPECT_TRUE(stored.is_favorite);
+    EXPECT_EQ(stored.play_count, 2);
+    EXPECT_GT(stored.last_played_ms, 0);
+    EXPECT_EQ(db.getFavoriteMixes().size(), 1);
+
+    EXPECT_TRUE(db.queueSoftDelete("queued-mix").get());
+    db.flushWrites();
+    EXPECT_TRUE(db.getAllMixes().empty());
+    EXPECT_TRUE(db.getMixById("queued-mix").is_deleted);
+}
+
+TEST_F(MixDatabaseTest, SearchMixesRanksKeywordMatches) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+
+    auto makeMix = [](const std::string& id, const std::string& title, const std::string& artist,
+                      const std::string& description) {
+        AutoVibez::Data::Mix mix;
+        mix.id = id;
+        mix.title = title;
+        mix.artist = artist;
+        mix.genre = "House";
+        mix.description = description;
+        mix.duration_seconds = 3600;
+        return mix;
+    };
+    EXPECT_TRUE(db.addMix(makeMix("described", "Sunday Session", "DJ One", "Deep grooves all night")));
+    EXPECT_TRUE(db.addMix(makeMix("titled", "Deep Grooves Vol. 2", "DJ Two", "")));
+    AutoVibez::Data::Mix tagged = makeMix("tagged", "Warehouse", "Déjà Vu", "");
+    tagged.tags = {"berlin", "techno"};
+    EXPECT_TRUE(db.addMix(tagged));
+    EXPECT_EQ(db.getMixById("tagged").tags, tagged.tags);
+
+    auto results = db.searchMixes("deep groo");
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].id, "titled");
+    EXPECT_EQ(results[1].id, "described");
+    ASSERT_EQ(db.searchMixes("BERLIN").size(), 1u);
+    EXPECT_EQ(db.searchMixes("deja").size(), 1u);
+    EXPECT_EQ(db.searchMixes("deep", 1).size(), 1u);
+    EXPECT_TRUE(db.searchMixes("\" OR ").empty());
+    EXPECT_TRUE(db.searchMixes("").empty());
+
+    // Replaced, updated and deleted rows leave the index in step
+    EXPECT_TRUE(db.addMix(makeMix("titled", "Shallow Waters", "DJ Two", "")));
+    ASSERT_EQ(db.searchMixes("deep").size(), 1u);
+    EXPECT_EQ(db.searchMixes("shallow").size(), 1u);
+    AutoVibez::Data::Mix renamed = db.getMixById("described");
+    renamed.description = "Warm vinyl";
+    EXPECT_TRUE(db.updateMix(renamed));
+    EXPECT_TRUE(db.searchMixes("grooves").empty());
+    EXPECT_TRUE(db.softDeleteMix("tagged"));
+    EXPECT_TRUE(db.searchMixes("techno").empty());
+    EXPECT_TRUE(db.deleteMix("titled"));
+    EXPECT_TRUE(db.searchMixes("shallow").empty());
+}
+
+TEST_F(MixDatabaseTest, SearchIndexIsFilledForExistingLibraries) {
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        EXPECT_TRUE(db.initialize());
+        AutoVibez::Data::Mix mix;
+        mix.id = "old-mix";
+        mix.title = "Forgotten Anthems";
+        mix.artist = "Artist";
+        mix.genre = "Trance";
+        mix.duration_seconds = 3600;
+        EXPECT_TRUE(db.addMix(mix));
+    }
+    {
+        // As if the library predated the index
+        AutoVibez::Data::SqliteConnection connection(dbPath);
+        ASSERT_TRUE(connection.initialize());
+        ASSERT_TRUE(connection.execute(StringConstants::DROP_MIXES_FTS_TRIGGERS));
+        ASSERT_TRUE(connection.execute("DROP TABLE mixes_fts"));
+        ASSERT_TRUE(connection.execute("PRAGMA user_version = 0"));
+    }
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+    ASSERT_EQ(db.searchMixes("anthems").size(), 1u);
+}
+
+TEST_F(MixDatabaseTest, TagsLiveInTheirOwnTable) {
+    auto makeMix = [](const std::string& id, const std::vector<std::string>& tags) {
+        AutoVibez::Data::Mix mix;
+        mix.id = id;
+        mix.title = "Mix " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.duration_seconds = 3600;
+        mix.tags = tags;
+        return mix;
+    };
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        EXPECT_TRUE(db.initialize());
+        EXPECT_TRUE(db.addMix(makeMix("dark", {"Peak", "dark"})));
+        EXPECT_TRUE(db.addMix(makeMix("light", {"peak"})));
+        EXPECT_TRUE(db.updateMix(makeMix("light", {"sunrise"})));
+        EXPECT_EQ(db.getMixesByTag("peak").size(), 1u);
+        EXPECT_EQ(db.getMixesByTag("SUNRISE").size(), 1u);
+        EXPECT_EQ(db.getMixById("dark").tags, (std::vector<std::string>{"Peak", "dark"}));
+        EXPECT_TRUE(db.deleteMix("light"));
+        EXPECT_TRUE(db.getMixesByTag("sunrise").empty());
+    }
+    {
+        // As if the library predated mix_tags, with the tags only in the JSON column
+        AutoVibez::Data::SqliteConnection connection(dbPath);
+        ASSERT_TRUE(connection.initialize());
+        ASSERT_TRUE(connection.execute("DROP TABLE mix_tags"));
+        ASSERT_TRUE(connection.execute("PRAGMA user_version = 0"));
+        ASSERT_TRUE(connection.execute("UPDATE mixes SET tags = '[\"legacy\",\"peak\"]' WHERE id = 'dark'"));
+    }
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+    EXPECT_EQ(db.getMixById("dark").tags, (std::vector<std::string>{"legacy", "peak"}));
+    ASSERT_EQ(db.getMixesByTag("legacy").size(), 1u);
+    EXPECT_EQ(db.getMixesByTag("legacy")[0].id, "dark");
+}
+
+TEST_F(MixDatabaseTest, StreamsAndPagesThroughTheTable) {
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+    std::vector<AutoVibez::Data::Mix> library;
+    for (int i = 0; i < 25; ++i) {
+        AutoVibez::Data::Mix mix;
+        mix.id = "mix-" + std::to_string(100 + i);
+        mix.title = "Title " + std::to_string(i);
+        mix.artist = "Artist";
+        mix.genre = i % 5 ? "House" : "Techno";
+        mix.duration_seconds = 3600;
+        library.push_back(mix);
+    }
+    AutoVibez::Data::MixIngestStats stats;
+    ASSERT_TRUE(db.ingestMixes(library, {"mix-101"}, stats));
+
+    int streamed = 0;
+    EXPECT_TRUE(db.forEachMix(AutoVibez::Data::SelectionCriteria(), [&streamed](const AutoVibez::Data::Mix&) {
+        streamed++;
+        return streamed < 10;
+    }));
+    EXPECT_EQ(streamed, 10);
+
+    // Pages of 10 over 24 live mixes, each starting after the last id seen
+    std::vector<std::string> ids;
+    std::string after;
+    std::vector<AutoVibez::Data::Mix> page;
+    int pages = 0;
+    do {
+        page = db.getMixPage(after, 10);
+        for (const auto& mix : page) {
+            ids.push_back(mix.id);
+        }
+        if (!page.empty()) {
+            after = page.back().id;
+        }
+        pages++;
+    } while (page.size() == 10u);
+    EXPECT_EQ(pages, 3);
+    ASSERT_EQ(ids.size(), 24u);
+    EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+    EXPECT_EQ(std::find(ids.begin(), ids.end(), "mix-101"), ids.end());
+
+    AutoVibez::Data::SelectionCriteria techno;
+    techno.genre = "techno";
+    EXPECT_EQ(db.getMixPage("", 10, techno).size(), 5u);
+    EXPECT_EQ(db.getMixPage("mix-110", 10, techno).size(), 2u);
+}
+
+TEST_F(MixDatabaseTest, PlayEventsKeepARollingAggregate) {
+    auto makeMix = [](const std::string& id) {
+        AutoVibez::Data::Mix mix;
+        mix.id = id;
+        mix.title = "Mix " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.duration_seconds = 3600;
+        return mix;
+    };
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        EXPECT_TRUE(db.initialize());
+        EXPECT_TRUE(db.addMix(makeMix("played")));
+        EXPECT_TRUE(db.addMix(makeMix("rested")));
+
+        EXPECT_TRUE(db.recordPlayEvent({"played", 1000, 3600, false}));
+        db.queuePlayEvent({"played", 2000, 60, true});
+        EXPECT_TRUE(db.queuePlayEvent({"played", 3000, 30, true}).get());
+        db.flushWrites();
+
+        auto stats = db.getPlayStats("played");
+        EXPECT_EQ(stats.plays, 3);
+        EXPECT_EQ(stats.skips, 2);
+        EXPECT_EQ(stats.skip_streak, 2);
+        EXPECT_EQ(stats.played_seconds, 3690);
+        EXPECT_EQ(stats.last_played_ms, 3000);
+        EXPECT_EQ(db.getPlayStats("rested").plays, 0);
+
+        // A full listen ends the run of skips; an older event does not move the last play back
+        EXPECT_TRUE(db.recordPlayEvent({"played", 500, 3600, false}));
+        stats = db.getPlayStats("played");
+        EXPECT_EQ(stats.skip_streak, 0);
+        EXPECT_EQ(stats.last_played_ms, 3000);
+        auto events = db.getPlayEventsSince(2000);
+        ASSERT_EQ(events.size(), 2u);
+        EXPECT_EQ(events[0].ts_epoch_ms, 2000);
+        EXPECT_TRUE(events[1].skipped);
+
+        EXPECT_TRUE(db.deleteMix("played"));
+        EXPECT_EQ(db.getPlayStats("played").plays, 0);
+        EXPECT_TRUE(db.getPlayEventsSince(0).empty());
+
+        EXPECT_TRUE(db.updatePlayStats("rested"));
+    }
+    {
+        // As if the library predated the play log, with only last_played and play_count
+        AutoVibez::Data::SqliteConnection connection(dbPath);
+        ASSERT_TRUE(connection.initialize());
+        ASSERT_TRUE(connection.execute("DROP TABLE play_events; DROP TABLE mix_play_stats"));
+        ASSERT_TRUE(connection.execute("PRAGMA user_version = 0"));
+    }
+    AutoVibez::Data::MixDatabase db(dbPath);
+    EXPECT_TRUE(db.initialize());
+    auto seeded = db.getPlayStats("rested");
+    EXPECT_EQ(seeded.plays, 1);
+    EXPECT_GT(seeded.last_played_ms, 0);
+}
+
+TEST_F(MixDatabaseTest, OldLibrariesUpgradeToTheVersionedSchema) {
+    {
+        // The first released schema: no soft deletion, analysis, tag table, play log or search index
+        AutoVibez::Data::SqliteConnection connection(dbPath);
+        ASSERT_TRUE(connection.initialize());
+        ASSERT_TRUE(connection.execute(R"(
+            CREATE TABLE mixes (
+                id TEXT PRIMARY KEY, title TEXT NOT NULL, artist TEXT NOT NULL, genre TEXT NOT NULL,
+                url TEXT NOT NULL, local_path TEXT, duration_seconds INTEGER NOT NULL, tags TEXT,
+                description TEXT, date_added DATETIME DEFAULT CURRENT_TIMESTAMP, last_played DATETIME,
+                play_count INTEGER DEFAULT 0, is_favorite BOOLEAN DEFAULT 0
+            );
+            INSERT INTO mixes (id, title, artist, genre, url, duration_seconds, tags, last_played, play_count)
+            VALUES ('old', 'Old Mix', 'Artist', 'Techno', 'http://example.com/old.mp3', 3600, '["warehouse"]',
+                    '2024-01-01 12:00:00', 4);
+        )"));
+    }
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        ASSERT_TRUE(db.initialize());
+        EXPECT_EQ(db.getMixById("old").tags, (std::vector<std::string>{"warehouse"}));
+        EXPECT_EQ(db.getPlayStats("old").plays, 4);
+        EXPECT_EQ(db.getMixById("old").last_played_ms, 1704110400000);  // Stored as UTC text
+        EXPECT_GT(db.getMixById("old").date_added_ms, 0);
+        EXPECT_EQ(db.searchMixes("old", 10).size(), 1u);
+        EXPECT_TRUE(db.setMixAnalysis("old", -14.0, -1.0, 128.0));
+        EXPECT_TRUE(db.softDeleteMix("old"));
+    }
+
+    AutoVibez::Data::SqliteConnection connection(dbPath);
+    ASSERT_TRUE(connection.initialize());
+    auto version = connection.prepare("PRAGMA user_version");
+    ASSERT_TRUE(version && version->step());
+    EXPECT_GE(version->getInt(0), 5);
+}
+
+TEST_F(MixDatabaseTest, SelectionQueriesUseThePartialIndexes) {
+    auto connection = std::make_shared<AutoVibez::Data::SqliteConnection>(dbPath);
+    AutoVibez::Data::MixDatabase db(connection);
+    ASSERT_TRUE(db.initialize());
+    auto plan = [&connection](const std::string& sql) {
+        std::string details;
+        auto stmt = connection->prepare("EXPLAIN QUERY PLAN " + sql);
+        while (stmt && stmt->step()) {
+            details += stmt->getText(3) + "\n";
+        }
+        return details;
+    };
+
+    AutoVibez::Data::SelectionCriteria smart;
+    smart.genre = "Techno";
+    smart.exclude_mix_id = "mix1";
+    smart.downloaded_only = true;
+    const std::string smart_plan =
+        plan(AutoVibez::Data::MixQueryBuilder::buildQuery(smart, AutoVibez::Data::OrderBy::Random));
+    EXPECT_NE(smart_plan.find("idx_mixes_downloaded_genre"), std::string::npos) << smart_plan;
+
+    const std::string genre_plan = plan(StringConstants::SELECT_MIXES_BY_GENRE);
+    EXPECT_NE(genre_plan.find("idx_mixes_live_genre"), std::string::npos) << genre_plan;
+    EXPECT_EQ(genre_plan.find("TEMP B-TREE"), std::string::npos) << genre_plan;
+
+    const std::string artist_plan = plan(StringConstants::SELECT_MIXES_BY_ARTIST);
+    EXPECT_NE(artist_plan.find("idx_mixes_live_artist"), std::string::npos) << artist_plan;
+    EXPECT_EQ(artist_plan.find("TEMP B-TREE"), std::string::npos) << artist_plan;
+
+    EXPECT_NE(plan(StringConstants::SELECT_FAVORITE_MIXES).find("idx_mixes_live_favorites"), std::string::npos);
+    EXPECT_NE(plan(StringConstants::SELECT_RECENTLY_PLAYED).find("idx_mixes_recently_played"), std::string::npos);
+    EXPECT_EQ(plan(StringConstants::SELECT_RECENTLY_PLAYED).find("TEMP B-TREE"), std::string::npos);
+    EXPECT_NE(plan(StringConstants::SELECT_DOWNLOADED_MIXES).find("idx_mixes_downloaded_title"), std::string::npos);
+}
+
+TEST_F(MixDatabaseTest, HashIdsAreStoredAsSixteenByteKeys) {
+    auto connection = std::make_shared<AutoVibez::Data::SqliteConnection>(dbPath);
+    AutoVibez::Data::MixDatabase db(connection);
+    ASSERT_TRUE(db.initialize());
+
+    AutoVibez::Data::Mix mix;
+    mix.url = "https://example.com/packed.mp3";
+    mix.id = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(mix.url);
+    mix.title = "Packed Anthems";
+    mix.artist = "Artist";
+    mix.genre = "Techno";
+    mix.duration_seconds = 3600;
+    mix.tags = {"warehouse"};
+    ASSERT_TRUE(db.addMix(mix));
+    ASSERT_TRUE(db.recordPlayEvent({mix.id, 1000, 3600, false}));
+
+    auto stored = connection->prepare("SELECT typeof(id), length(id) FROM mixes");
+    ASSERT_TRUE(stored && stored->step());
+    EXPECT_EQ(stored->getText(0), "blob");
+    EXPECT_EQ(stored->getInt(1), 16);
+    stored.reset();
+    auto played = connection->prepare("SELECT typeof(mix_id) FROM play_events");
+    ASSERT_TRUE(played && played->step());
+    EXPECT_EQ(played->getText(0), "blob");
+    played.reset();
+
+    // Every way back out gives the text id again
+    EXPECT_EQ(db.getMixById(mix.id).title, "Packed Anthems");
+    ASSERT_EQ(db.getMixesByTag("warehouse").size(), 1u);
+    EXPECT_EQ(db.getMixesByTag("warehouse")[0].id, mix.id);
+    ASSERT_EQ(db.searchMixes("anthems", 10).size(), 1u);
+    EXPECT_EQ(db.searchMixes("anthems", 10)[0].id, mix.id);
+    ASSERT_EQ(db.getPlayEventsSince(0).size(), 1u);
+    EXPECT_EQ(db.getPlayEventsSince(0)[0].mix_id, mix.id);
+    EXPECT_EQ(db.getPlayStats(mix.id).plays, 1);
+
+    // The packed key is still looked up through the primary key
+    auto plan = connection->prepare(std::string("EXPLAIN QUERY PLAN ") + StringConstants::SELECT_MIX_BY_ID);
+    ASSERT_TRUE(plan && plan->step());
+    EXPECT_NE(plan->getText(3).find("USING INDEX"), std::string::npos) << plan->getText(3);
+}
+
+TEST_F(MixDatabaseTest, OldHashIdsAreMadeAgainFromTheirUrls) {
+    const std::string url = "https://example.com/legacy.mp3";
+    const std::string old_id = oldHashId(std::hash<std::string>{}(url));
+    const std::string retired_id = oldHashId(0x2222222222222222ULL);
+    const std::string manifest_id = "11111111-2222-5333-8444-555555555555";  // Given by a manifest
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        ASSERT_TRUE(db.initialize());
+    }
+    {
+        // As if written before the ids were packed: text keys from the old hash, and a retired duplicate
+        AutoVibez::Data::SqliteConnection connection(dbPath);
+        ASSERT_TRUE(connection.initialize());
+        ASSERT_TRUE(connection.execute(R"(
+            INSERT INTO mixes (id, title, artist, genre, url, duration_seconds, is_deleted) VALUES
+                (')" + old_id + R"(', 'Legacy', 'Artist', 'Dub', 'https://example.com/legacy.mp3', 3600, 0),
+                (')" + retired_id + R"(', 'Legacy', 'Artist', 'Dub', 'https://example.com/legacy.mp3', 3600, 1),
+                (')" + manifest_id + R"(', 'Named', 'Artist', 'Dub', 'https://example.com/named.mp3', 3600, 0),
+                ('plain', 'Plain', 'Artist', 'Dub', 'https://example.com/plain.mp3', 3600, 0);
+            INSERT INTO mix_tags (mix_id, position, tag) VALUES (')" + old_id + R"(', 0, 'dub');
+            INSERT INTO play_events (mix_id, ts_epoch_ms, duration_played, skipped)
+                VALUES (')" + old_id + R"(', 1000, 3600, 0);
+            INSERT INTO manifest_entries (id, hash) VALUES (')" + old_id + R"(', 7);
+            PRAGMA user_version = 12;
+        )"));
+    }
+
+    AutoVibez::Data::MixDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+    const std::string new_id = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(url);
+    const AutoVibez::Data::Mix legacy = db.getMixById(new_id);
+    EXPECT_EQ(legacy.title, "Legacy");
+    EXPECT_FALSE(legacy.is_deleted);
+    EXPECT_EQ(legacy.tags, (std::vector<std::string>{"dub"}));
+    EXPECT_EQ(db.getPlayStats(new_id).plays, 1);
+    EXPECT_TRUE(db.getMixById(old_id).id.empty());
+    EXPECT_EQ(db.getMixById(manifest_id).title, "Named");  // Kept, so the manifest still matches it
+    EXPECT_EQ(db.getMixById("plain").title, "Plain");      // Not in UUID form
+
+    std::unordered_map<std::string, uint64_t> hashes;
+    ASSERT_TRUE(db.getManifestHashes(hashes));
+    EXPECT_TRUE(hashes.empty());
+
+    AutoVibez::Data::SqliteConnection connection(dbPath);
+    ASSERT_TRUE(connection.initialize());
+    auto count = connection.prepare("SELECT COUNT(*) FROM mixes");
+    ASSERT_TRUE(count && count->step());
+    EXPECT_EQ(count->getInt(0), 3);
+}
+
+TEST_F(MixDatabaseTest, DownloadedFilesFollowTheirMixesToNewIds) {
+    const std::string renamed_url = "https://example.com/renamed.mp3";
+    const std::string plain_url = "https://example.com/plain.mp3";
+    const std::string renamed_id = oldHashId(std::hash<std::string>{}(renamed_url));
+    const std::string plain_id = oldHashId(std::hash<std::string>{}(plain_url));
+    const std::filesystem::path mixes_dir = tempDir / "mixes";
+    const std::string journal = (tempDir / "file_mappings.txt").string();
+    {
+        AutoVibez::Data::MixDatabase db(dbPath);
+        ASSERT_TRUE(db.initialize());
+    }
+    {
+        // Downloaded before the upgrade: one file renamed through the journal, one still named for its id
+        std::filesystem::create_directories(mixes_dir);
+        std::ofstream(mixes_dir / "Artist - Renamed.mp3") << "mp3";
+        std::ofstream(mixes_dir / (plain_id + ".mp3")) << "mp3";
+        std::ofstream(journal) << renamed_id << ":Artist - Renamed.mp3\n";
+
+        AutoVibez::Data::SqliteConnection connection(dbPath);
+        ASSERT_TRUE(connection.initialize());
+        ASSERT_TRUE(connection.execute(R"(
+            INSERT INTO mixes (id, title, artist, genre, url, local_path, duration_seconds) VALUES
+                (')" + renamed_id + R"(', 'Renamed', 'Artist', 'Dub', ')" + renamed_url + R"(',
+                 ')" + (mixes_dir / "Artist - Renamed.mp3").string() + R"(', 3600),
+                (')" + plain_id + R"(', 'Plain', 'Artist', 'Dub', ')" + plain_url + R"(',
+                 ')" + (mixes_dir / (plain_id + ".mp3")).string() + R"(', 3600);
+            PRAGMA user_version = 12;
+        )"));
+    }
+
+    AutoVibez::Data::MixDatabase db(dbPath);
+    db.setFileMappingsPath(journal);
+    ASSERT_TRUE(db.initialize());
+
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setFileMappingsPath(journal);
+    const std::string renamed_new = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(renamed_url);
+    const std::string plain_new = AutoVibez::Utils::HashIdUtils::generateIdFromUrl(plain_url);
+    ASSERT_EQ(db.getMixById(renamed_new).title, "Renamed");
+    ASSERT_EQ(db.getMixById(plain_new).title, "Plain");
+    EXPECT_TRUE(downloader.isMixDownloaded(renamed_new));
+    EXPECT_TRUE(downloader.isMixDownloaded(plain_new));
+    EXPECT_EQ(downloader.getLocalPath(renamed_new), (mixes_dir / "Artist - Renamed.mp3").string());
+    EXPECT_EQ(downloader.getLocalPath(plain_new), (mixes_dir / (plain_id + ".mp3")).string());
+}
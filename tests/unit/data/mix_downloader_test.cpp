@@ -2,13 +2,21 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
+#include "../utils/local_http_server.hpp"
 #include "audio/mp3_analyzer.hpp"
 #include "data/mix_metadata.hpp"
+#include "data/peer_cache.hpp"
 #include "utils/constants.hpp"
+#include "utils/content_hash.hpp"
+#include "utils/mp3_probe.hpp"
 #include "utils/url_utils.hpp"  // Added for URL validation tests
 
 class MixDownloaderTest : public ::testing::Test {
@@ -41,6 +49,26 @@ protected:
         return filepath;
     }
 
+    // ID3v2.3 title frame ahead of one MPEG frame whose Xing header gives the file a duration
+    std::string createTaggedMP3File(const std::string& filename, const std::string& title) {
+        std::string frame = {'T', 'I', 'T', '2', 0, 0, 0, static_cast<char>(title.size() + 1), 0, 0, 0};
+        frame += title;
+        std::string tag = {'I', 'D', '3', 3, 0, 0, 0, 0, 1, 0};  // 128 bytes after the header
+        tag += frame;
+        tag.resize(10 + 128, '\0');
+
+        std::string mpeg = {static_cast<char>(0xFF), static_cast<char>(0xFB), static_cast<char>(0x90), 0x44};
+        mpeg.resize(36, '\0');
+        mpeg += std::string{'X', 'i', 'n', 'g', 0, 0, 0, 0x03, 0, 0, 0x03, static_cast<char>(0xE8), 0, 0, 0, 0};
+        mpeg.resize(417, '\0');
+
+        std::string content = tag + mpeg;
+        content.resize(4096, 0x55);
+        std::string filepath = (test_dir / filename).string();
+        std::ofstream(filepath, std::ios::binary) << content;
+        return filepath;
+    }
+
     AutoVibez::Data::Mix createMockMix(const std::string& id, const std::string& url,
                                        const std::string& original_filename = "") {
         AutoVibez::Data::Mix mix;
@@ -192,6 +220,58 @@ TEST_F(MixDownloaderTest, GetLocalPathWithOriginalFilenameEmpty) {
     EXPECT_TRUE(local_path.find(".mp3") != std::string::npos);
 }
 
+TEST_F(MixDownloaderTest, FileMappingsAreReadOnceWithTheLastEntryWinning) {
+    const std::string journal = (test_dir / "file_mappings.txt").string();
+    {
+        std::ofstream file(journal);
+        file << "renamed_id:First Title.mp3\n";
+        file << "other_id:Other.mp3\n";
+        file << "renamed_id:Second Title.mp3\n";
+        file << "broken line\n";
+    }
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setFileMappingsPath(journal);
+
+    EXPECT_EQ(downloader.getLocalPath("renamed_id"), (mixes_dir / "Second Title.mp3").string());
+    EXPECT_FALSE(downloader.isMixDownloaded("renamed_id"));
+    std::ofstream(mixes_dir / "Second Title.mp3") << "mock content";
+    EXPECT_TRUE(downloader.isMixDownloaded("renamed_id"));
+
+    // Held in memory from the first lookup on
+    std::filesystem::remove(journal);
+    EXPECT_EQ(downloader.getLocalPath("other_id"), (mixes_dir / "Other.mp3").string());
+    EXPECT_EQ(downloader.getLocalPath("unmapped_id"), (mixes_dir / "unmapped_id.mp3").string());
+}
+
+TEST_F(MixDownloaderTest, FileMappingLookupsAreThreadSafe) {
+    const std::string journal = (test_dir / "file_mappings.txt").string();
+    {
+        std::ofstream file(journal);
+        for (int i = 0; i < 100; ++i) {
+            file << "id" << i << ":Title " << i << ".mp3\n";
+        }
+    }
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setFileMappingsPath(journal);
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&downloader, &mismatches, this]() {
+            for (int i = 0; i < 100; ++i) {
+                const std::string expected = (mixes_dir / ("Title " + std::to_string(i) + ".mp3")).string();
+                if (downloader.getLocalPath("id" + std::to_string(i)) != expected) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
 TEST_F(MixDownloaderTest, DownloadMixWithTitleNamingNullAnalyzer) {
     std::string mixes_path = mixes_dir.string();
     AutoVibez::Data::MixDownloader downloader(mixes_path);
@@ -238,6 +318,323 @@ TEST_F(MixDownloaderTest, DownloadMixWithTitleNamingLocalFile) {
     EXPECT_TRUE(std::filesystem::exists(local_path));
 }
 
+TEST_F(MixDownloaderTest, DownloadMixWithTitleNamingReturnsThePathAndAnalysis) {
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setFileMappingsPath((test_dir / "file_mappings.txt").string());
+    AutoVibez::Audio::MP3Analyzer analyzer;
+
+    const std::string source = createTaggedMP3File("tagged.mp3", "Sunrise Set");
+    AutoVibez::Data::DownloadedMix downloaded;
+    ASSERT_TRUE(downloader.downloadMixWithTitleNaming(createMockMix("first_id", "file://" + source), &analyzer,
+                                                      nullptr, &downloaded));
+    EXPECT_EQ(downloaded.local_path, (mixes_dir / "Sunrise Set.mp3").string());
+    EXPECT_EQ(downloaded.metadata.title, "Sunrise Set");
+    EXPECT_EQ(downloader.getLocalPath("first_id"), downloaded.local_path);
+
+    // Another mix of the same title keeps the first file and gets a name of its own
+    ASSERT_TRUE(downloader.downloadMixWithTitleNaming(createMockMix("second_id", "file://" + source), &analyzer,
+                                                      nullptr, &downloaded));
+    EXPECT_EQ(downloaded.local_path, (mixes_dir / "Sunrise Set (2).mp3").string());
+    EXPECT_EQ(downloader.getLocalPath("second_id"), downloaded.local_path);
+    EXPECT_TRUE(downloader.isMixDownloaded("first_id"));
+    EXPECT_TRUE(downloader.isMixDownloaded("second_id"));
+
+    // Read back from the journal by a downloader of its own
+    AutoVibez::Data::MixDownloader reopened(mixes_dir.string());
+    reopened.setFileMappingsPath((test_dir / "file_mappings.txt").string());
+    EXPECT_EQ(reopened.getLocalPath("second_id"), downloaded.local_path);
+}
+
+TEST_F(MixDownloaderTest, ConcurrentDownloadsOfOneTitleGetDistinctNames) {
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setFileMappingsPath((test_dir / "file_mappings.txt").string());
+    const std::string source = createTaggedMP3File("tagged.mp3", "Sunrise Set");
+
+    constexpr int count = 4;
+    std::vector<std::string> paths(count);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < count; ++i) {
+        threads.emplace_back([&, i]() {
+            AutoVibez::Audio::MP3Analyzer analyzer;
+            AutoVibez::Data::DownloadedMix downloaded;
+            const AutoVibez::Data::Mix mix = createMockMix("mix_" + std::to_string(i), "file://" + source);
+            if (downloader.downloadMixWithTitleNaming(mix, &analyzer, nullptr, &downloaded)) {
+                paths[i] = downloaded.local_path;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(downloader.getLocalPath("mix_" + std::to_string(i)), paths[i]);
+        EXPECT_TRUE(std::filesystem::exists(paths[i]));
+    }
+    std::sort(paths.begin(), paths.end());
+    EXPECT_EQ(std::unique(paths.begin(), paths.end()), paths.end());
+}
+
+TEST_F(MixDownloaderTest, DownloadMixWithTitleNamingReportsProgress) {
+    std::string mixes_path = mixes_dir.string();
+    AutoVibez::Data::MixDownloader downloader(mixes_path);
+
+    std::string source_file = createMockMP3File("progress.mp3");
+    AutoVibez::Data::Mix mix = createMockMix("progress_id", "file://" + source_file);
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    AutoVibez::Utils::DownloadProgress progress;
+
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress));
+    EXPECT_TRUE(progress.isComplete());
+    EXPECT_FALSE(progress.failed.load());
+    EXPECT_EQ(progress.getBytesWritten(), static_cast<int64_t>(std::filesystem::file_size(source_file)));
+    EXPECT_EQ(progress.total_bytes.load(), progress.getBytesWritten());
+}
+
+TEST_F(MixDownloaderTest, DownloadMixWithTitleNamingReportsFailedCopy) {
+    std::string mixes_path = mixes_dir.string();
+    AutoVibez::Data::MixDownloader downloader(mixes_path);
+
+    AutoVibez::Data::Mix mix = createMockMix("missing_id", "file://" + (test_dir / "missing.mp3").string());
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    AutoVibez::Utils::DownloadProgress progress;
+
+    EXPECT_FALSE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress));
+    EXPECT_TRUE(progress.isComplete());
+    EXPECT_TRUE(progress.failed.load());
+    EXPECT_EQ(progress.getBytesWritten(), 0);
+}
+
+TEST_F(MixDownloaderTest, InterruptedDownloadResumesFromThePartialFile) {
+    const std::string body = std::string(100000, 'a') + std::string(100000, 'b');
+    LocalHttpServer server(body);
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    AutoVibez::Data::Mix mix = createMockMix("resume_id", server.url("/resume.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    const std::string temp_path = downloader.getTemporaryPath(mix.id);
+    const std::string state_path = temp_path + StringConstants::RESUME_STATE_EXTENSION;
+
+    server.dropNextResponseAfter(60000);
+    EXPECT_FALSE(downloader.downloadMixWithTitleNaming(mix, &analyzer));
+    EXPECT_EQ(std::filesystem::file_size(temp_path), 60000u);
+    EXPECT_TRUE(std::filesystem::exists(state_path));
+
+    AutoVibez::Utils::DownloadProgress progress;
+    AutoVibez::Data::DownloadedMix result;
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress, &result));
+    EXPECT_NE(server.lastRequest().find("Range: bytes=60000-"), std::string::npos);
+    EXPECT_NE(server.lastRequest().find("If-Range: \"v1\""), std::string::npos);
+    EXPECT_EQ(progress.getBytesWritten(), static_cast<int64_t>(body.size()));
+    EXPECT_EQ(progress.total_bytes.load(), static_cast<int64_t>(body.size()));
+    EXPECT_EQ(progress.retries.load(), 1);
+    EXPECT_FALSE(std::filesystem::exists(state_path));
+    // The hash covers the bytes kept from the first attempt too
+    AutoVibez::Utils::ContentHasher hasher;
+    hasher.update(body.data(), body.size());
+    EXPECT_EQ(result.content_hash, hasher.hexDigest());
+
+    std::ifstream file(downloader.getLocalPath(mix.id), std::ios::binary);
+    std::stringstream downloaded;
+    downloaded << file.rdbuf();
+    EXPECT_EQ(downloaded.str(), body);
+}
+
+TEST_F(MixDownloaderTest, ChangedFileIsFetchedAgainInsteadOfResumed) {
+    LocalHttpServer server(std::string(200000, 'a'));
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    AutoVibez::Data::Mix mix = createMockMix("changed_id", server.url("/changed.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+
+    server.dropNextResponseAfter(30000);
+    EXPECT_FALSE(downloader.downloadMixWithTitleNaming(mix, &analyzer));
+
+    // The partial file holds the old version; appending the new one to it would corrupt the mix
+    const std::string replacement(150000, 'z');
+    server.setBody(replacement, "\"v2\"");
+    AutoVibez::Utils::DownloadProgress progress;
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress));
+    EXPECT_EQ(progress.retries.load(), 2);  // The refused resume, then the fresh start
+
+    std::ifstream file(downloader.getLocalPath(mix.id), std::ios::binary);
+    std::stringstream downloaded;
+    downloaded << file.rdbuf();
+    EXPECT_EQ(downloaded.str(), replacement);
+    const std::string state_path = downloader.getTemporaryPath(mix.id) + StringConstants::RESUME_STATE_EXTENSION;
+    EXPECT_FALSE(std::filesystem::exists(state_path));
+}
+
+TEST_F(MixDownloaderTest, LargeFileIsFetchedAsConcurrentRanges) {
+    std::string body(250000, '\0');
+    for (size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<char>('a' + i % 23);  // No period of the segment length, so a misplaced range shows
+    }
+    LocalHttpServer server(body);
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setSegmentedDownload(100000, 30000);
+    AutoVibez::Data::Mix mix = createMockMix("segmented_id", server.url("/segmented.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    AutoVibez::Utils::DownloadProgress progress;
+    AutoVibez::Data::DownloadedMix result;
+
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress, &result));
+    EXPECT_GT(server.connections(), 1);
+    EXPECT_NE(server.lastRequest().find("If-Range: \"v1\""), std::string::npos);
+    EXPECT_EQ(progress.getBytesWritten(), static_cast<int64_t>(body.size()));
+    EXPECT_EQ(progress.total_bytes.load(), static_cast<int64_t>(body.size()));
+    // Ranges that land out of order are hashed in file order
+    EXPECT_EQ(result.content_hash, AutoVibez::Utils::ContentHasher::hashFile(result.local_path));
+
+    std::ifstream file(downloader.getLocalPath(mix.id), std::ios::binary);
+    std::stringstream downloaded;
+    downloaded << file.rdbuf();
+    EXPECT_EQ(downloaded.str(), body);
+}
+
+TEST_F(MixDownloaderTest, StreamedDownloadIsHashedAndProbedInFlight) {
+    const std::string tagged = createTaggedMP3File("streamed_source.mp3", "Streamed");
+    std::ifstream source(tagged, std::ios::binary);
+    std::stringstream head;
+    head << source.rdbuf();
+    std::string body = head.str().substr(0, 10 + 128 + 417);
+    const std::string frame = body.substr(10 + 128);
+    while (body.size() < 150000) {
+        body += frame;
+    }
+    LocalHttpServer server(body);
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    AutoVibez::Data::Mix mix = createMockMix("streamed_id", server.url("/streamed.mp3"));
+    AutoVibez::Utils::Mp3ProbeCache cache;
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    analyzer.setProbeCache(&cache);
+
+    AutoVibez::Data::DownloadedMix result;
+    ASSERT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, nullptr, &result));
+    EXPECT_EQ(result.metadata.title, "Streamed");
+    EXPECT_EQ(result.content_hash, AutoVibez::Utils::ContentHasher::hashFile(result.local_path));
+
+    // The verdict reached from the stream is the one the analysis used, under the final name
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.probe(result.local_path).valid);
+}
+
+TEST_F(MixDownloaderTest, MixHeldByALanPeerIsFetchedFromIt) {
+    const std::string body(120000, 'p');
+    const std::string held = (test_dir / "held.mp3").string();
+    std::ofstream(held, std::ios::binary) << body;
+    AutoVibez::Data::PeerFileServer peer([&](const std::string&) { return held; });
+    ASSERT_TRUE(peer.start());
+    LocalHttpServer origin(body);
+
+    auto peer_cache = std::make_shared<AutoVibez::Data::PeerCache>();
+    const std::string hash = AutoVibez::Utils::ContentHasher::hashFile(held);
+    peer_cache->receiveAnnouncement(std::string(StringConstants::PEER_ANNOUNCE_MAGIC) + " other " +
+                                        std::to_string(peer.getPort()) + "\npeer_id " + hash + "\n",
+                                    "127.0.0.1");
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setPeerCache(peer_cache);
+    AutoVibez::Data::Mix mix = createMockMix("peer_id", origin.url("/peer.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    AutoVibez::Utils::DownloadProgress progress;
+    AutoVibez::Data::DownloadedMix result;
+
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress, &result));
+    EXPECT_TRUE(result.from_peer);
+    EXPECT_EQ(result.content_hash, hash);
+    EXPECT_EQ(origin.connections(), 0);
+    EXPECT_TRUE(progress.isComplete());
+    EXPECT_FALSE(progress.failed.load());
+}
+
+TEST_F(MixDownloaderTest, PeerFileThatFailsItsHashFallsBackToTheOrigin) {
+    const std::string body(120000, 'o');
+    const std::string held = (test_dir / "stale.mp3").string();
+    std::ofstream(held, std::ios::binary) << std::string(120000, 'x');
+    AutoVibez::Data::PeerFileServer peer([&](const std::string&) { return held; });
+    ASSERT_TRUE(peer.start());
+    LocalHttpServer origin(body);
+
+    // The peer announces the right hash but serves another file
+    auto peer_cache = std::make_shared<AutoVibez::Data::PeerCache>();
+    AutoVibez::Utils::ContentHasher hasher;
+    hasher.update(body.data(), body.size());
+    const std::string hash = hasher.hexDigest();
+    peer_cache->receiveAnnouncement(std::string(StringConstants::PEER_ANNOUNCE_MAGIC) + " other " +
+                                        std::to_string(peer.getPort()) + "\nstale_id " + hash + "\n",
+                                    "127.0.0.1");
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setPeerCache(peer_cache);
+    AutoVibez::Data::Mix mix = createMockMix("stale_id", origin.url("/stale.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    AutoVibez::Utils::DownloadProgress progress;
+    AutoVibez::Data::DownloadedMix result;
+
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer, &progress, &result));
+    EXPECT_FALSE(result.from_peer);
+    EXPECT_EQ(result.content_hash, hash);
+    EXPECT_GT(origin.connections(), 0);
+    EXPECT_EQ(progress.retries.load(), 1);
+
+    std::ifstream file(result.local_path, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded << file.rdbuf();
+    EXPECT_EQ(downloaded.str(), body);
+}
+
+TEST_F(MixDownloaderTest, ShareFilePointsAMixAtAnotherMixsFile) {
+    const std::string existing = (mixes_dir / "Original Title.mp3").string();
+    std::ofstream(existing) << std::string(2048, 'x');
+    const std::string duplicate = (mixes_dir / "Duplicate.mp3").string();
+    std::ofstream(duplicate) << std::string(2048, 'x');
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+
+    EXPECT_FALSE(downloader.shareFile("reupload_id", duplicate, (test_dir / "elsewhere.mp3").string()));
+    EXPECT_TRUE(std::filesystem::exists(duplicate));
+
+    EXPECT_TRUE(downloader.shareFile("reupload_id", duplicate, existing));
+    EXPECT_FALSE(std::filesystem::exists(duplicate));
+    EXPECT_TRUE(downloader.isMixDownloaded("reupload_id"));
+    EXPECT_TRUE(std::filesystem::equivalent(downloader.getLocalPath("reupload_id"), existing));
+}
+
+TEST_F(MixDownloaderTest, ServerWithoutRangesGetsOneStream) {
+    const std::string body(250000, 'r');
+    LocalHttpServer server(body);
+    server.setRangesSupported(false);
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setSegmentedDownload(100000, 30000);
+    AutoVibez::Data::Mix mix = createMockMix("single_id", server.url("/single.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer));
+    EXPECT_EQ(server.lastRequest().find("Range:"), std::string::npos);
+    EXPECT_EQ(std::filesystem::file_size(downloader.getLocalPath(mix.id)), body.size());
+}
+
+TEST_F(MixDownloaderTest, FailedRangeLeavesTheUnbrokenStartToResume) {
+    std::string body(250000, '\0');
+    for (size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<char>('a' + i % 23);
+    }
+    LocalHttpServer server(body);
+    AutoVibez::Data::MixDownloader downloader(mixes_dir.string());
+    downloader.setSegmentedDownload(100000, 30000);
+    AutoVibez::Data::Mix mix = createMockMix("broken_id", server.url("/broken.mp3"));
+    AutoVibez::Audio::MP3Analyzer analyzer;
+    const std::string temp_path = downloader.getTemporaryPath(mix.id);
+
+    server.dropNextResponseAfter(10000);
+    EXPECT_FALSE(downloader.downloadMixWithTitleNaming(mix, &analyzer));
+    if (std::filesystem::exists(temp_path)) {
+        EXPECT_LT(std::filesystem::file_size(temp_path), body.size());
+    }
+
+    EXPECT_TRUE(downloader.downloadMixWithTitleNaming(mix, &analyzer));
+    std::ifstream file(downloader.getLocalPath(mix.id), std::ios::binary);
+    std::stringstream downloaded;
+    downloaded << file.rdbuf();
+    EXPECT_EQ(downloaded.str(), body);
+}
+
 TEST_F(MixDownloaderTest, MultipleDownloaderInstances) {
     std::string mixes_path = mixes_dir.string();
 
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base_metadata.hpp"
+#include "mix_database.hpp"
 
 using AutoVibez::Data::Mix;
 using AutoVibez::Data::MixManager;
@@ -117,6 +118,20 @@ TEST_F(MixManagerTest, PlaybackState) {
     EXPECT_FALSE(manager.hasFinished());
 }
 
+TEST_F(MixManagerTest, SampleClockWhenNotPlaying) {
+    MixManager manager(db_path, data_path);
+
+    // No player before initialize()
+    EXPECT_EQ(manager.getPositionMs(), 0);
+    EXPECT_FALSE(manager.seekToMs(1000));
+
+    ASSERT_TRUE(manager.initialize());
+    EXPECT_EQ(manager.getPositionMs(), 0);
+    EXPECT_EQ(manager.getDuration(), 0);
+    EXPECT_FALSE(manager.seekToMs(1000));
+    EXPECT_FALSE(manager.getLastError().empty());
+}
+
 TEST_F(MixManagerTest, CrossfadeControl) {
     MixManager manager(db_path, data_path);
     ASSERT_TRUE(manager.initialize());
@@ -147,6 +162,31 @@ TEST_F(MixManagerTest, CrossfadeDuration) {
     EXPECT_EQ(manager.getCrossfadeDuration(), 5000);
 }
 
+TEST_F(MixManagerTest, PlaybackGainFromLoudness) {
+    MixManager manager(db_path, data_path);
+    manager.setLoudnessNormalization(true, -14.0);
+
+    Mix mix;
+    mix.id = "gain-mix";
+
+    // Unanalyzed mixes play unchanged
+    EXPECT_DOUBLE_EQ(manager.getPlaybackGainDb(mix), 0.0);
+
+    // Loud masters are turned down to the target
+    mix.has_analysis = true;
+    mix.loudness_lufs = -8.0;
+    mix.peak_dbfs = -0.1;
+    EXPECT_DOUBLE_EQ(manager.getPlaybackGainDb(mix), -6.0);
+
+    // Quiet mixes are lifted only as far as their peak headroom allows
+    mix.loudness_lufs = -20.0;
+    mix.peak_dbfs = -4.0;
+    EXPECT_DOUBLE_EQ(manager.getPlaybackGainDb(mix), 3.0);
+
+    manager.setLoudnessNormalization(false, -14.0);
+    EXPECT_DOUBLE_EQ(manager.getPlaybackGainDb(mix), 0.0);
+}
+
 TEST_F(MixManagerTest, ErrorStateManagement) {
     MixManager manager(db_path, data_path);
     ASSERT_TRUE(manager.initialize());
@@ -208,6 +248,28 @@ TEST_F(MixManagerTest, GetRandomMixByGenreEmptyDatabase) {
     EXPECT_TRUE(random_electronic.id.empty());
 }
 
+TEST_F(MixManagerTest, GetRandomFavoriteMixSkipsTheExcludedOne) {
+    {
+        AutoVibez::Data::MixDatabase database(db_path);
+        ASSERT_TRUE(database.initialize());
+        for (const std::string id : {"fav1", "fav2", "plain"}) {
+            Mix mix = createMockMix(id, "https://example.com/" + id + ".mp3");
+            mix.is_favorite = id != "plain";
+            mix.duration_seconds = 3600;
+            ASSERT_TRUE(database.addMix(mix));
+        }
+    }
+    MixManager manager(db_path, data_path);
+    ASSERT_TRUE(manager.initialize());
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(manager.getRandomFavoriteMix("fav1").id, "fav2");
+        EXPECT_NE(manager.getRandomFavoriteMix().id, "plain");
+    }
+    EXPECT_TRUE(manager.getRandomAvailableMix("fav1").id.empty());  // Nothing synced from the remote list
+    EXPECT_TRUE(manager.getAvailableMixes()->empty());
+}
+
 TEST_F(MixManagerTest, ToggleFavoriteNonexistentMix) {
     MixManager manager(db_path, data_path);
     ASSERT_TRUE(manager.initialize());
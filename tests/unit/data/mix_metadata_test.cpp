@@ -5,6 +5,8 @@
 #include <filesystem>
 #include <fstream>
 
+#include "../utils/local_http_server.hpp"
+
 class MixMetadataTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -346,3 +348,87 @@ TEST_F(MixMetadataTest, ValidateMixWithEmptyUrl) {
     EXPECT_FALSE(metadata.isSuccess());
     EXPECT_FALSE(metadata.getLastError().empty());
 }
+
+TEST_F(MixMetadataTest, UnchangedRemoteManifestComesFromTheCache) {
+    const std::string manifest = "mixes:\n  - https://example.com/mix1.mp3\n  - https://example.com/mix2.mp3\n";
+    LocalHttpServer server(manifest);
+    const std::string cache_path = (tempDir / "mixes_manifest.txt").string();
+    AutoVibez::Data::MixMetadata metadata;
+    metadata.setCachePath(cache_path);
+
+    auto mixes = metadata.loadFromRemoteFile(server.url("/mixes.yaml"));
+    ASSERT_EQ(mixes.size(), 2u);
+    EXPECT_FALSE(metadata.isUnchanged());
+    EXPECT_TRUE(std::filesystem::exists(cache_path));
+
+    // The second start asks with the stored ETag and parses the cached body
+    mixes = metadata.loadFromRemoteFile(server.url("/mixes.yaml"));
+    EXPECT_NE(server.lastRequest().find("If-None-Match: \"v1\""), std::string::npos);
+    EXPECT_TRUE(metadata.isSuccess());
+    EXPECT_TRUE(metadata.isUnchanged());
+    ASSERT_EQ(mixes.size(), 2u);
+    EXPECT_EQ(mixes[1].url, "https://example.com/mix2.mp3");
+
+    server.setBody(manifest + "  - https://example.com/mix3.mp3\n", "\"v2\"");
+    mixes = metadata.loadFromRemoteFile(server.url("/mixes.yaml"));
+    EXPECT_FALSE(metadata.isUnchanged());
+    EXPECT_EQ(mixes.size(), 3u);
+}
+
+TEST_F(MixMetadataTest, CachedManifestOfAnotherUrlIsNotUsed) {
+    LocalHttpServer server("mixes:\n  - https://example.com/mix1.mp3\n  - https://example.com/mix2.mp3\n");
+    AutoVibez::Data::MixMetadata metadata;
+    metadata.setCachePath((tempDir / "mixes_manifest.txt").string());
+
+    metadata.loadFromRemoteFile(server.url("/mixes.yaml"));
+    metadata.loadFromRemoteFile(server.url("/other.yaml"));
+    EXPECT_EQ(server.lastRequest().find("If-None-Match"), std::string::npos);
+    EXPECT_FALSE(metadata.isUnchanged());
+}
+
+TEST_F(MixMetadataTest, UnchangedLocalManifestLoadsFromTheSnapshot) {
+    std::string yamlPath = createTestYaml(R"(
+mixes:
+  - id: "snap1"
+    url: "https://example.com/snap1.mp3"
+    title: "Snapshot Mix"
+    tags: ["deep", "house"]
+  - https://example.com/snap2.mp3
+)");
+    AutoVibez::Data::MixMetadata metadata;
+    metadata.setSnapshotPath((tempDir / "mixes_manifest.bin").string());
+
+    auto parsed = metadata.loadFromLocalFile(yamlPath);
+    ASSERT_EQ(parsed.size(), 2u);
+    EXPECT_FALSE(metadata.isFromSnapshot());
+
+    auto loaded = metadata.loadFromLocalFile(yamlPath);
+    EXPECT_TRUE(metadata.isFromSnapshot());
+    EXPECT_TRUE(metadata.isSuccess());
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded[0].title, "Snapshot Mix");
+    EXPECT_EQ(loaded[0].tags, parsed[0].tags);
+    EXPECT_EQ(loaded[1].id, parsed[1].id);
+
+    // A rewritten manifest is parsed again
+    createTestYaml("mixes:\n  - https://example.com/snap3.mp3\n");
+    auto reparsed = metadata.loadFromLocalFile(yamlPath);
+    EXPECT_FALSE(metadata.isFromSnapshot());
+    ASSERT_EQ(reparsed.size(), 1u);
+    EXPECT_EQ(reparsed[0].url, "https://example.com/snap3.mp3");
+}
+
+TEST_F(MixMetadataTest, UnchangedRemoteManifestLoadsFromTheSnapshot) {
+    LocalHttpServer server("mixes:\n  - https://example.com/mix1.mp3\n  - https://example.com/mix2.mp3\n");
+    AutoVibez::Data::MixMetadata metadata;
+    metadata.setCachePath((tempDir / "mixes_manifest.txt").string());
+    metadata.setSnapshotPath((tempDir / "mixes_manifest.bin").string());
+
+    metadata.loadFromRemoteFile(server.url("/mixes.yaml"));
+    EXPECT_FALSE(metadata.isFromSnapshot());
+
+    auto mixes = metadata.loadFromRemoteFile(server.url("/mixes.yaml"));
+    EXPECT_TRUE(metadata.isUnchanged());
+    EXPECT_TRUE(metadata.isFromSnapshot());
+    EXPECT_EQ(mixes.size(), 2u);
+}
@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include "constants.hpp"
 #include "sqlite_connection.hpp"
 
 using namespace AutoVibez::Data;
@@ -228,7 +229,7 @@ TEST_F(MixQueryBuilderTest, BuildQueryFromCriteria) {
     EXPECT_NE(query.find("SELECT * FROM mixes"), std::string::npos);
     EXPECT_NE(query.find("is_deleted = 0"), std::string::npos);
     EXPECT_NE(query.find("genre COLLATE NOCASE = ? COLLATE NOCASE"), std::string::npos);
-    EXPECT_NE(query.find("id != ?"), std::string::npos);
+    EXPECT_NE(query.find("id != mix_key(?)"), std::string::npos);
     EXPECT_NE(query.find("is_favorite = 1"), std::string::npos);
     EXPECT_NE(query.find("local_path IS NOT NULL"), std::string::npos);
     EXPECT_NE(query.find("ORDER BY title ASC"), std::string::npos);
@@ -247,6 +248,56 @@ TEST_F(MixQueryBuilderTest, BuildQueryWithIncludeDeleted) {
     EXPECT_NE(query.find("genre COLLATE NOCASE = ? COLLATE NOCASE"), std::string::npos);
 }
 
+TEST_F(MixQueryBuilderTest, BuildQueryFiltersByTag) {
+    ASSERT_TRUE(connection->execute(StringConstants::CREATE_MIX_TAGS_TABLE));
+    ASSERT_TRUE(connection->execute("INSERT INTO mix_tags VALUES ('mix1', 0, 'Peak'), ('mix3', 0, 'dark'), "
+                                    "('mix3', 1, 'peak'), ('mix4', 0, 'peak')"));
+
+    SelectionCriteria criteria;
+    criteria.tag = "PEAK";
+    EXPECT_EQ(countResults(MixQueryBuilder::buildQuery(criteria), {"PEAK"}), 2);  // mix4 is deleted
+
+    criteria.genre = "Electronic";
+    criteria.exclude_mix_id = "mix1";
+    EXPECT_EQ(countResults(MixQueryBuilder::buildQuery(criteria), {"Electronic", "peak", "mix1"}), 1);
+}
+
+TEST_F(MixQueryBuilderTest, KeysetPagesFollowIdOrder) {
+    SelectionCriteria criteria;
+    criteria.after_id = "mix1";
+    criteria.limit = 1;
+    const std::string query = MixQueryBuilder::buildQuery(criteria, OrderBy::Id);
+    EXPECT_NE(query.find("id > mix_key(?)"), std::string::npos);
+    EXPECT_NE(query.find("ORDER BY id ASC LIMIT 1"), std::string::npos);
+
+    auto stmt = connection->prepare(query);
+    ASSERT_NE(stmt, nullptr);
+    stmt->bindText(1, "mix1");
+    ASSERT_TRUE(stmt->step());
+    EXPECT_EQ(stmt->getText("id"), "mix2");
+    EXPECT_FALSE(stmt->step());
+
+    criteria.genre = "Electronic";
+    criteria.exclude_mix_id = "mix3";
+    EXPECT_EQ(MixQueryBuilder::buildParameters(criteria), (std::vector<std::string>{"Electronic", "mix3", "mix1"}));
+    const std::string filtered = MixQueryBuilder::buildQuery(criteria, OrderBy::Id);
+    EXPECT_EQ(countResults(filtered, MixQueryBuilder::buildParameters(criteria)), 0);
+}
+
+TEST_F(MixQueryBuilderTest, BuildQueryRestsRecentAndSkippedMixes) {
+    ASSERT_TRUE(connection->execute(StringConstants::CREATE_PLAY_HISTORY));
+    ASSERT_TRUE(connection->execute("INSERT INTO play_events VALUES ('mix1', 5000, 3600, 0), ('mix3', 1000, 60, 1), "
+                                    "('mix3', 2000, 60, 1)"));
+
+    SelectionCriteria criteria;
+    criteria.not_played_since_ms = 4000;
+    EXPECT_EQ(countResults(MixQueryBuilder::buildQuery(criteria), MixQueryBuilder::buildParameters(criteria)), 2);
+
+    criteria.max_skip_streak = 2;
+    EXPECT_EQ(MixQueryBuilder::buildParameters(criteria), (std::vector<std::string>{"4000", "2"}));
+    EXPECT_EQ(countResults(MixQueryBuilder::buildQuery(criteria), MixQueryBuilder::buildParameters(criteria)), 1);
+}
+
 TEST_F(MixQueryBuilderTest, EmptyCriteria) {
     SelectionCriteria criteria;
     std::string query = MixQueryBuilder::buildQuery(criteria);
@@ -296,10 +347,10 @@ TEST_F(MixQueryBuilderTest, WhereConditionVariants) {
     std::string query;
 
     query = builder->reset().select().whereId().build();
-    EXPECT_NE(query.find("WHERE id = ?"), std::string::npos);
+    EXPECT_NE(query.find("WHERE id = mix_key(?)"), std::string::npos);
 
     query = builder->reset().select().whereNotId().build();
-    EXPECT_NE(query.find("WHERE id != ?"), std::string::npos);
+    EXPECT_NE(query.find("WHERE id != mix_key(?)"), std::string::npos);
 
     query = builder->reset().select().whereArtist().build();
     EXPECT_NE(query.find("WHERE artist = ?"), std::string::npos);
@@ -307,3 +358,10 @@ TEST_F(MixQueryBuilderTest, WhereConditionVariants) {
     query = builder->reset().select().whereHasBeenPlayed().build();
     EXPECT_NE(query.find("WHERE last_played IS NOT NULL"), std::string::npos);
 }
+
+TEST_F(MixQueryBuilderTest, SearchMatchQuotesEveryWordAsAPrefix) {
+    EXPECT_EQ(MixQueryBuilder::buildSearchMatch("  deep   hou "), "\"deep\"* \"hou\"*");
+    EXPECT_EQ(MixQueryBuilder::buildSearchMatch("NOT say\"what OR"), "\"NOT\"* \"say\"\"what\"* \"OR\"*");
+    EXPECT_EQ(MixQueryBuilder::buildSearchMatch("- * ()"), "");
+    EXPECT_EQ(MixQueryBuilder::buildSearchMatch(""), "");
+}
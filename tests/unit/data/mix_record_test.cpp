@@ -0,0 +1,94 @@
+#include "mix_record.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace AutoVibez::Data;
+
+namespace {
+Mix makeFullMix() {
+    Mix mix;
+    mix.id = "mix1";
+    mix.title = "Sunrise Session";
+    mix.artist = "Artist A";
+    mix.genre = "Techno";
+    mix.url = "https://example.com/mix1.mp3";
+    mix.original_filename = "mix1.mp3";
+    mix.local_path = "/mixes/mix1.mp3";
+    mix.description = "A long set";
+    mix.tags = {"deep", "live"};
+    mix.duration_seconds = 3600;
+    mix.date_added_ms = 1709251198000;  // 2024-02-29 23:59:58 UTC
+    mix.last_played_ms = 1735689600123;
+    mix.play_count = 7;
+    mix.is_favorite = true;
+    mix.has_analysis = true;
+    mix.loudness_lufs = -14.25;
+    mix.peak_dbfs = -0.5;
+    mix.bpm = 126.0;
+    mix.spectral_centroid_hz = 2150.5;
+    return mix;
+}
+
+void expectSameMix(const Mix& actual, const Mix& expected) {
+    EXPECT_EQ(actual.id, expected.id);
+    EXPECT_EQ(actual.title, expected.title);
+    EXPECT_EQ(actual.artist, expected.artist);
+    EXPECT_EQ(actual.genre, expected.genre);
+    EXPECT_EQ(actual.url, expected.url);
+    EXPECT_EQ(actual.original_filename, expected.original_filename);
+    EXPECT_EQ(actual.local_path, expected.local_path);
+    EXPECT_EQ(actual.description, expected.description);
+    EXPECT_EQ(actual.tags, expected.tags);
+    EXPECT_EQ(actual.duration_seconds, expected.duration_seconds);
+    EXPECT_EQ(actual.date_added_ms, expected.date_added_ms);
+    EXPECT_EQ(actual.last_played_ms, expected.last_played_ms);
+    EXPECT_EQ(actual.play_count, expected.play_count);
+    EXPECT_EQ(actual.is_favorite, expected.is_favorite);
+    EXPECT_EQ(actual.has_analysis, expected.has_analysis);
+    EXPECT_DOUBLE_EQ(actual.loudness_lufs, expected.loudness_lufs);
+    EXPECT_DOUBLE_EQ(actual.peak_dbfs, expected.peak_dbfs);
+    EXPECT_DOUBLE_EQ(actual.bpm, expected.bpm);
+    EXPECT_DOUBLE_EQ(actual.spectral_centroid_hz, expected.spectral_centroid_hz);
+}
+}  // namespace
+
+TEST(MixRecordTest, RoundTripsEveryField) {
+    const Mix mix = makeFullMix();
+    MixStringPool strings;
+    strings.internFields(mix);
+    const MixRecord record(mix, strings);
+
+    EXPECT_EQ(record.id(), "mix1");
+    EXPECT_EQ(record.localPath(), "/mixes/mix1.mp3");
+    EXPECT_EQ(record.date_added_ms, 1709251198000);
+    expectSameMix(record.toMix(strings), mix);
+}
+
+TEST(MixRecordTest, UnsetTimestampsStayZero) {
+    MixStringPool strings;
+    const MixRecord blank(Mix(), strings);
+    EXPECT_EQ(blank.date_added_ms, 0);
+    EXPECT_EQ(blank.toMix(strings).last_played_ms, 0);
+    EXPECT_TRUE(blank.text.empty());
+}
+
+TEST(MixRecordTest, PoolInternsOnceAndCopiesIndependently) {
+    MixStringPool strings;
+    const uint32_t house = strings.intern("House");
+    EXPECT_EQ(strings.intern("House"), house);
+    EXPECT_EQ(strings.intern(""), 0u);
+
+    MixStringPool copy(strings);
+    const uint32_t techno = copy.intern("Techno");
+    uint32_t id = 0;
+    EXPECT_TRUE(copy.find("House", id));
+    EXPECT_EQ(id, house);
+    EXPECT_EQ(copy.get(techno), "Techno");
+    EXPECT_FALSE(strings.find("Techno", id));
+
+    Mix mix;
+    mix.genre = "House";
+    mix.tags = {"Techno"};
+    EXPECT_FALSE(strings.hasFields(mix));
+    EXPECT_TRUE(copy.hasFields(mix));
+}
@@ -0,0 +1,83 @@
+#include "mix_row_mapper.hpp"
+
+#include <gtest/gtest.h>
+
+#include "sqlite_connection.hpp"
+
+using namespace AutoVibez::Data;
+
+class MixRowMapperTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        connection = std::make_unique<SqliteConnection>(":memory:");
+        ASSERT_TRUE(connection->initialize());
+        ASSERT_TRUE(
+            connection->execute("CREATE TABLE mixes (id TEXT, title TEXT, artist TEXT, genre TEXT, url TEXT, "
+                                "local_path TEXT, duration_seconds INTEGER, tags TEXT, description TEXT, "
+                                "date_added INTEGER, last_played INTEGER, play_count INTEGER, is_favorite INTEGER, "
+                                "is_deleted INTEGER, loudness_lufs REAL, peak_dbfs REAL, bpm REAL, "
+                                "spectral_centroid_hz REAL)"));
+        ASSERT_TRUE(connection->execute(
+            "INSERT INTO mixes VALUES ('m1', 'Title', 'Artist', 'Techno', 'http://x/m1.mp3', '/tmp/m1.mp3', 3600, "
+            "'[\"dark\",\"peak\"]', NULL, 1704067200000, NULL, 4, 1, 0, -9.5, -0.3, 128.0, 2400.0)"));
+        ASSERT_TRUE(connection->execute("INSERT INTO mixes (id, title) VALUES ('m2', 'Bare')"));
+    }
+
+    std::unique_ptr<SqliteConnection> connection;
+};
+
+TEST_F(MixRowMapperTest, MapsEveryColumn) {
+    auto stmt = connection->prepare("SELECT * FROM mixes WHERE id = 'm1'");
+    ASSERT_NE(stmt, nullptr);
+    const MixRowMapper mapper(*stmt, true);
+    ASSERT_TRUE(stmt->step());
+
+    const Mix mix = mapper.map(*stmt);
+    EXPECT_EQ(mix.id, "m1");
+    EXPECT_EQ(mix.title, "Title");
+    EXPECT_EQ(mix.artist, "Artist");
+    EXPECT_EQ(mix.genre, "Techno");
+    EXPECT_EQ(mix.url, "http://x/m1.mp3");
+    EXPECT_EQ(mix.local_path, "/tmp/m1.mp3");
+    EXPECT_EQ(mix.duration_seconds, 3600);
+    EXPECT_EQ(mix.tags, (std::vector<std::string>{"dark", "peak"}));
+    EXPECT_TRUE(mix.description.empty());
+    EXPECT_EQ(mix.date_added_ms, 1704067200000);
+    EXPECT_EQ(mix.last_played_ms, 0);
+    EXPECT_EQ(mix.play_count, 4);
+    EXPECT_TRUE(mix.is_favorite);
+    EXPECT_FALSE(mix.is_deleted);
+    EXPECT_TRUE(mix.has_analysis);
+    EXPECT_DOUBLE_EQ(mix.loudness_lufs, -9.5);
+    EXPECT_DOUBLE_EQ(mix.bpm, 128.0);
+    EXPECT_DOUBLE_EQ(mix.spectral_centroid_hz, 2400.0);
+
+    // Tags are only parsed for a caller that asks for them
+    EXPECT_TRUE(MixRowMapper(*stmt).map(*stmt).tags.empty());
+}
+
+TEST_F(MixRowMapperTest, NullsAndMissingColumnsKeepDefaults) {
+    auto stmt = connection->prepare("SELECT * FROM mixes WHERE id = 'm2'");
+    ASSERT_NE(stmt, nullptr);
+    const MixRowMapper mapper(*stmt);
+    ASSERT_TRUE(stmt->step());
+    const Mix bare = mapper.map(*stmt);
+    EXPECT_EQ(bare.title, "Bare");
+    EXPECT_TRUE(bare.tags.empty());
+    EXPECT_FALSE(bare.has_analysis);
+
+    // A query that selects only some columns
+    auto partial = connection->prepare("SELECT title, id FROM mixes ORDER BY id");
+    ASSERT_NE(partial, nullptr);
+    const MixRowMapper partialMapper(*partial);
+    std::vector<Mix> mixes;
+    while (partial->step()) {
+        mixes.push_back(partialMapper.map(*partial));
+    }
+    ASSERT_EQ(mixes.size(), 2u);
+    EXPECT_EQ(mixes[0].id, "m1");
+    EXPECT_EQ(mixes[0].title, "Title");
+    EXPECT_TRUE(mixes[0].artist.empty());
+    EXPECT_EQ(mixes[0].play_count, 0);
+    EXPECT_EQ(mixes[1].id, "m2");
+}
@@ -0,0 +1,139 @@
+#include "mix_selection_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+using namespace AutoVibez::Data;
+
+namespace {
+Mix makeMix(const std::string& id, const std::string& genre, bool downloaded, bool favorite = false) {
+    Mix mix;
+    mix.id = id;
+    mix.genre = genre;
+    mix.local_path = downloaded ? "/path/to/" + id + ".mp3" : "";
+    mix.is_favorite = favorite;
+    return mix;
+}
+}  // namespace
+
+class MixSelectionIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Mix deleted = makeMix("mix5", "House", true);
+        deleted.is_deleted = true;
+        index.rebuild({makeMix("mix1", "Electronic", true, true), makeMix("mix2", "House", true),
+                       makeMix("mix3", "Electronic", false, true), makeMix("mix4", "Techno", true), deleted});
+        rng.seed(12345);
+    }
+
+    MixSelectionIndex index;
+    std::mt19937 rng;
+};
+
+TEST_F(MixSelectionIndexTest, PoolsFollowTheRows) {
+    EXPECT_EQ(index.count(SelectionPool::Available), 4u);
+    EXPECT_EQ(index.count(SelectionPool::Downloaded), 3u);
+    EXPECT_EQ(index.count(SelectionPool::Favorites), 1u);
+    EXPECT_EQ(index.count(SelectionPool::Genre, "electronic"), 1u);
+    EXPECT_EQ(index.count(SelectionPool::Downloaded, "", "mix2"), 2u);
+    EXPECT_EQ(index.count(SelectionPool::Genre, "Ambient"), 0u);
+
+    index.setLocalPath("mix3", "/path/to/mix3.mp3");
+    EXPECT_EQ(index.count(SelectionPool::Favorites), 2u);
+    EXPECT_EQ(index.count(SelectionPool::Genre, "ELECTRONIC"), 2u);
+
+    index.toggleFavorite("mix1");
+    index.remove("mix3");
+    EXPECT_EQ(index.count(SelectionPool::Favorites), 0u);
+    EXPECT_EQ(index.count(SelectionPool::Genre, "Electronic"), 1u);
+    EXPECT_EQ(index.count(SelectionPool::Available), 3u);
+
+    Mix deleted = makeMix("mix2", "House", true);
+    deleted.is_deleted = true;
+    index.upsert(deleted);
+    EXPECT_EQ(index.count(SelectionPool::Downloaded), 2u);
+}
+
+TEST_F(MixSelectionIndexTest, RemovedEntriesAreReusedByNewIds) {
+    index.remove("mix4");
+    index.remove("mix2");
+    index.upsert(makeMix("9f86d081-884c-5d65-9a2f-eaa0c55ad015", "Techno", true));
+    index.upsert(makeMix("m6", "Techno", true));
+
+    EXPECT_EQ(index.count(SelectionPool::Available), 4u);
+    EXPECT_EQ(index.count(SelectionPool::Genre, "techno"), 2u);
+    EXPECT_EQ(index.count(SelectionPool::Genre, "House"), 0u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(index.sampleUniform(SelectionPool::Genre, "Techno", "m6", rng),
+                  "9f86d081-884c-5d65-9a2f-eaa0c55ad015");
+        EXPECT_EQ(index.sampleWeighted(SelectionPool::Genre, "Techno", "9f86d081-884c-5d65-9a2f-eaa0c55ad015", rng),
+                  "m6");
+    }
+    index.toggleFavorite("m6");
+    EXPECT_EQ(index.sampleWeighted(SelectionPool::Favorites, "", "mix1", rng), "m6");
+}
+
+TEST_F(MixSelectionIndexTest, DrawsRespectTheExclusion) {
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_NE(index.sampleWeighted(SelectionPool::Downloaded, "", "mix1", rng), "mix1");
+        EXPECT_NE(index.sampleUniform(SelectionPool::Available, "", "mix4", rng), "mix4");
+    }
+    EXPECT_EQ(index.sampleWeighted(SelectionPool::Favorites, "", "mix1", rng), "");
+    EXPECT_EQ(index.sampleUniform(SelectionPool::Genre, "Techno", "mix4", rng), "");
+    EXPECT_EQ(index.sampleWeighted(SelectionPool::Genre, "Techno", "", rng), "mix4");
+}
+
+TEST_F(MixSelectionIndexTest, RecentAndFrequentPlaysWeighLess) {
+    // mix1 is played over and over, so the two unplayed mixes should dominate
+    for (int i = 0; i < 10; ++i) {
+        index.recordPlay("mix1");
+    }
+    std::map<std::string, int> picks;
+    for (int i = 0; i < 3000; ++i) {
+        picks[index.sampleWeighted(SelectionPool::Downloaded, "", "", rng)]++;
+    }
+    EXPECT_LT(picks["mix1"], 30);
+    EXPECT_GT(picks["mix2"], 1200);
+    EXPECT_GT(picks["mix4"], 1200);
+
+    // Without play preferences every mix is equally likely
+    MixSelectionIndex flat(false, false);
+    flat.rebuild({makeMix("a", "House", true), makeMix("b", "House", true)});
+    flat.recordPlay("a");
+    picks.clear();
+    for (int i = 0; i < 2000; ++i) {
+        picks[flat.sampleWeighted(SelectionPool::Downloaded, "", "", rng)]++;
+    }
+    EXPECT_GT(picks["a"], 850);
+    EXPECT_GT(picks["b"], 850);
+}
+
+TEST_F(MixSelectionIndexTest, PlayHistoryRestsRecentAndSkippedMixes) {
+    const int64_t hour_ms = 60 * 60 * 1000;
+    int64_t now_ms = 1000000 * hour_ms;
+    index.setClock([&now_ms]() { return now_ms; });
+
+    // mix2 was heard an hour ago; mix4 was skipped three times in a row days ago
+    index.recordPlayEvent({"mix2", now_ms - hour_ms, 3000, false});
+    for (int i = 0; i < 3; ++i) {
+        index.recordPlayEvent({"mix4", now_ms - 100 * hour_ms, 60, true});
+    }
+    std::map<std::string, int> picks;
+    for (int i = 0; i < 3000; ++i) {
+        picks[index.sampleWeighted(SelectionPool::Downloaded, "", "", rng)]++;
+    }
+    EXPECT_GT(picks["mix1"], 2700);
+    EXPECT_LT(picks["mix2"], 40);
+    EXPECT_GT(picks["mix4"], picks["mix2"]);
+
+    // A full listen ends the streak, and a day later the recent play has partly recovered
+    index.recordPlayEvent({"mix4", now_ms - 99 * hour_ms, 4000, false});
+    now_ms += 24 * hour_ms;
+    picks.clear();
+    for (int i = 0; i < 3000; ++i) {
+        picks[index.sampleWeighted(SelectionPool::Downloaded, "", "", rng)]++;
+    }
+    EXPECT_GT(picks["mix4"], 450);
+    EXPECT_GT(picks["mix2"], 100);
+}
@@ -0,0 +1,159 @@
+#include "mix_similarity_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "mix_catalog.hpp"
+
+using namespace AutoVibez::Data;
+
+namespace {
+Mix makeMix(const std::string& id, const std::string& genre, double bpm, bool downloaded = true) {
+    Mix mix;
+    mix.id = id;
+    mix.title = id;
+    mix.genre = genre;
+    mix.local_path = downloaded ? "/path/to/" + id + ".mp3" : "";
+    mix.has_analysis = true;
+    mix.bpm = bpm;
+    mix.loudness_lufs = -11.0;
+    mix.spectral_centroid_hz = 2400.0;
+    return mix;
+}
+
+std::vector<std::string> idsOf(const std::vector<SimilarMix>& mixes) {
+    std::vector<std::string> ids;
+    for (const auto& mix : mixes) {
+        ids.push_back(mix.id);
+    }
+    return ids;
+}
+}  // namespace
+
+TEST(MixSimilarityIndexTest, NearestComesFirst) {
+    MixSimilarityIndex index;
+    index.upsert(makeMix("anchor", "House", 124.0));
+    index.upsert(makeMix("close", "House", 126.0));
+    index.upsert(makeMix("further", "House", 140.0));
+    index.upsert(makeMix("other_genre", "Ambient", 124.0));
+    index.upsert(makeMix("not_downloaded", "House", 124.0, false));
+
+    const auto nearest = index.nearest("anchor", "", 10);
+    EXPECT_EQ(idsOf(nearest), (std::vector<std::string>{"close", "further", "other_genre"}));
+    EXPECT_LT(nearest[0].distance, nearest[1].distance);
+    EXPECT_LT(nearest[1].distance, nearest[2].distance);
+
+    EXPECT_EQ(idsOf(index.nearest("anchor", "", 1)), (std::vector<std::string>{"close"}));
+    EXPECT_EQ(idsOf(index.nearest("anchor", "AMBIENT", 10)), (std::vector<std::string>{"other_genre"}));
+    EXPECT_TRUE(index.nearest("anchor", "Techno", 10).empty());
+    EXPECT_TRUE(index.nearest("unknown", "", 10).empty());
+
+    // Not downloaded mixes can still be asked about
+    EXPECT_EQ(index.nearest("not_downloaded", "", 1)[0].id, "anchor");
+    EXPECT_FLOAT_EQ(index.nearest("not_downloaded", "", 1)[0].distance, 0.0f);
+}
+
+TEST(MixSimilarityIndexTest, TagsPullMixesTogether) {
+    MixSimilarityIndex index;
+    Mix anchor = makeMix("anchor", "Techno", 130.0);
+    anchor.tags = {"dark", "warehouse"};
+    Mix shared = makeMix("shared", "Techno", 132.0);
+    shared.tags = {"Dark", "Warehouse"};
+    Mix untagged = makeMix("untagged", "Techno", 130.0);
+    index.upsert(anchor);
+    index.upsert(shared);
+    index.upsert(untagged);
+
+    EXPECT_EQ(index.nearest("anchor", "", 1)[0].id, "shared");
+    EXPECT_GT(index.nearest("anchor", "", 2)[1].distance, index.nearest("anchor", "", 2)[0].distance);
+}
+
+TEST(MixSimilarityIndexTest, FeaturesIgnoreCaseAndMissingAnalysis) {
+    Mix lower = makeMix("a", "house", 124.0);
+    lower.tags = {"deep"};
+    Mix upper = makeMix("b", "HOUSE", 124.0);
+    upper.tags = {"DEEP"};
+    EXPECT_EQ(MixSimilarityIndex::featuresOf(lower), MixSimilarityIndex::featuresOf(upper));
+
+    // An unanalyzed mix sits at the middle of the measured ranges, where the reference values are
+    Mix unanalyzed = makeMix("c", "", 0.0);
+    unanalyzed.has_analysis = false;
+    const MixSimilarityIndex::Vector features = MixSimilarityIndex::featuresOf(unanalyzed);
+    EXPECT_EQ(features, MixSimilarityIndex::Vector{});
+    Mix reference = makeMix("d", "", 124.0);
+    reference.loudness_lufs = -12.0;
+    reference.spectral_centroid_hz = 2500.0;
+    EXPECT_EQ(MixSimilarityIndex::featuresOf(reference), MixSimilarityIndex::Vector{});
+
+    Mix fast = makeMix("e", "", 250.0);
+    EXPECT_EQ(MixSimilarityIndex::featuresOf(fast)[0], 127);
+}
+
+TEST(MixSimilarityIndexTest, RemovedSlotsAreReused) {
+    MixSimilarityIndex index;
+    index.upsert(makeMix("one", "House", 124.0));
+    index.upsert(makeMix("two", "House", 125.0));
+    index.upsert(makeMix("three", "House", 150.0));
+    EXPECT_EQ(index.size(), 3u);
+
+    index.remove("two");
+    Mix deleted = makeMix("three", "House", 150.0);
+    deleted.is_deleted = true;
+    index.upsert(deleted);
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_TRUE(index.nearest("one", "", 5).empty());
+
+    index.upsert(makeMix("four", "House", 123.0));
+    index.upsert(makeMix("one", "House", 150.0, false));  // Replaced in place
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(idsOf(index.nearest("one", "", 5)), (std::vector<std::string>{"four"}));
+    EXPECT_TRUE(index.nearest("four", "", 5).empty());
+}
+
+TEST(MixSimilarityIndexTest, RebuildReadsACatalogSnapshot) {
+    MixCatalogBuilder builder;
+    builder.add(makeMix("anchor", "Techno", 130.0));
+    builder.add(makeMix("close", "Techno", 131.0));
+    builder.add(makeMix("far", "Ambient", 80.0));
+    builder.addTag("anchor", "dark");
+    builder.addTag("close", "dark");
+    const auto snapshot = builder.build();
+
+    MixSimilarityIndex index;
+    index.upsert(makeMix("stale", "House", 124.0));
+    index.rebuild(*snapshot);
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_EQ(idsOf(index.nearest("anchor", "", 5)), (std::vector<std::string>{"close", "far"}));
+    EXPECT_FLOAT_EQ(index.nearest("close", "", 1)[0].distance, index.nearest("anchor", "", 1)[0].distance);
+}
+
+TEST(MixSimilarityIndexTest, ExactOverALargeLibrary) {
+    // The scan against a brute force distance over the quantized vectors
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> bpm(70.0, 180.0);
+    const char* genres[] = {"House", "Techno", "Ambient", "Drum and Bass"};
+    MixSimilarityIndex index;
+    std::vector<Mix> mixes;
+    for (int i = 0; i < 2000; ++i) {
+        Mix mix = makeMix("mix" + std::to_string(i), genres[i % 4], bpm(rng));
+        mix.loudness_lufs = -20.0 + (i % 13);
+        mixes.push_back(mix);
+        index.upsert(mix);
+    }
+
+    const auto query = MixSimilarityIndex::featuresOf(mixes[0]);
+    float best = 1e9f;
+    for (size_t i = 1; i < mixes.size(); ++i) {
+        const auto features = MixSimilarityIndex::featuresOf(mixes[i]);
+        int32_t distance = 0;
+        for (int d = 0; d < MixSimilarityIndex::DIMENSIONS; ++d) {
+            distance += (query[d] - features[d]) * (query[d] - features[d]);
+        }
+        best = std::min(best, distance / (127.0f * 127.0f));
+    }
+    const auto nearest = index.nearest("mix0", "", 10);
+    ASSERT_EQ(nearest.size(), 10u);
+    EXPECT_FLOAT_EQ(nearest[0].distance, best);
+}
@@ -0,0 +1,353 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "data/mix_database.hpp"
+#include "data/mix_sync_agent.hpp"
+#include "data/mix_sync_delta.hpp"
+
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Data::MixSyncAgent;
+using AutoVibez::Data::MixSyncDelta;
+using AutoVibez::Data::MixSyncFavorite;
+using AutoVibez::Data::MixSyncPlays;
+using AutoVibez::Data::MixSyncReply;
+
+namespace {
+
+/**
+ * @brief The server side of the exchange as the tests need it: totals over every node, each change numbered
+ */
+class FakeSyncServer {
+public:
+    bool online = true;
+
+    std::string handle(const std::string& text) {
+        MixSyncDelta delta;
+        EXPECT_TRUE(MixSyncDelta::parse(text, delta));
+        // A batch whose reply was lost comes again; its plays count once
+        int64_t& last_event = last_events_[delta.node];
+        const bool repeated = delta.last_event <= last_event;
+        for (const MixSyncPlays& plays : delta.plays) {
+            if (repeated) {
+                break;
+            }
+            Entry& entry = entries_[plays.mix_id];
+            entry.totals.mix_id = plays.mix_id;
+            entry.totals.plays += plays.plays;
+            entry.totals.skips += plays.skips;
+            entry.totals.played_seconds += plays.played_seconds;
+            entry.totals.last_played_ms = std::max(entry.totals.last_played_ms, plays.last_played_ms);
+            entry.changed = ++sequence_;
+        }
+        last_event = std::max(last_event, delta.last_event);
+        for (const MixSyncFavorite& favorite : delta.favorites) {
+            Entry& entry = entries_[favorite.mix_id];
+            if (favorite.changed_ms > entry.favorite.changed_ms) {
+                entry.favorite = favorite;
+                entry.changed = ++sequence_;
+            }
+        }
+
+        MixSyncReply reply;
+        reply.cursor = sequence_;
+        for (const auto& [id, entry] : entries_) {
+            if (entry.changed > delta.cursor) {
+                if (entry.totals.plays > 0) {
+                    reply.totals.push_back(entry.totals);
+                }
+                if (entry.favorite.changed_ms > 0) {
+                    reply.favorites.push_back(entry.favorite);
+                }
+            }
+        }
+        return reply.encode();
+    }
+
+    MixSyncAgent::Transport transport() {
+        return [this](const std::string& delta, std::string& reply) {
+            if (!online) {
+                return false;
+            }
+            reply = handle(delta);
+            return true;
+        };
+    }
+
+    int64_t plays(const std::string& id) {
+        return entries_[id].totals.plays;
+    }
+
+private:
+    struct Entry {
+        MixSyncPlays totals;
+        MixSyncFavorite favorite;
+        int64_t changed = 0;
+    };
+    std::map<std::string, Entry> entries_;
+    std::map<std::string, int64_t> last_events_;
+    int64_t sequence_ = 0;
+};
+
+}  // namespace
+
+class MixSyncTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::filesystem::temp_directory_path() / "autovibez_mix_sync_test";
+        std::filesystem::remove_all(temp_dir);
+        std::filesystem::create_directories(temp_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    std::string dbPath(const std::string& name) const {
+        return (temp_dir / name).string();
+    }
+
+    static Mix cachedMix(MixDatabase& db, const std::string& id) {
+        const auto snapshot = db.getCatalog()->snapshot();
+        const auto* record = snapshot->findById(id);
+        return record ? snapshot->toMix(*record) : Mix();
+    }
+
+    static Mix makeMix(const std::string& id) {
+        Mix mix;
+        mix.id = id;
+        mix.title = "Title " + id;
+        mix.artist = "Artist";
+        mix.genre = "Techno";
+        mix.url = "https://example.com/" + id + ".mp3";
+        mix.duration_seconds = 3600;
+        return mix;
+    }
+
+    std::filesystem::path temp_dir;
+};
+
+TEST_F(MixSyncTest, DeltaAndReplyRoundTrip) {
+    MixSyncDelta delta;
+    delta.node = "node-1";
+    delta.cursor = 42;
+    delta.after_event = 10;
+    delta.last_event = 12;
+    delta.events = 2;
+    delta.plays.push_back({"a", 2, 1, 4000, 1700000000000});
+    delta.favorites.push_back({"b", true, 1700000000001});
+
+    MixSyncDelta parsed;
+    ASSERT_TRUE(MixSyncDelta::parse(delta.encode(), parsed));
+    EXPECT_EQ(parsed.node, "node-1");
+    EXPECT_EQ(parsed.cursor, 42);
+    EXPECT_EQ(parsed.after_event, 10);
+    EXPECT_EQ(parsed.last_event, 12);
+    EXPECT_EQ(parsed.events, 2);
+    ASSERT_EQ(parsed.plays.size(), 1u);
+    EXPECT_EQ(parsed.plays[0].mix_id, "a");
+    EXPECT_EQ(parsed.plays[0].plays, 2);
+    EXPECT_EQ(parsed.plays[0].skips, 1);
+    EXPECT_EQ(parsed.plays[0].played_seconds, 4000);
+    EXPECT_EQ(parsed.plays[0].last_played_ms, 1700000000000);
+    ASSERT_EQ(parsed.favorites.size(), 1u);
+    EXPECT_TRUE(parsed.favorites[0].favorite);
+    EXPECT_EQ(parsed.favorites[0].changed_ms, 1700000000001);
+
+    MixSyncReply reply;
+    reply.cursor = 7;
+    reply.totals = delta.plays;
+    reply.favorites.push_back({"c", false, 5});
+    MixSyncReply parsed_reply;
+    ASSERT_TRUE(MixSyncReply::parse(reply.encode(), parsed_reply));
+    EXPECT_EQ(parsed_reply.cursor, 7);
+    EXPECT_EQ(parsed_reply.totals.size(), 1u);
+    ASSERT_EQ(parsed_reply.favorites.size(), 1u);
+    EXPECT_FALSE(parsed_reply.favorites[0].favorite);
+}
+
+TEST_F(MixSyncTest, ParseRejectsMalformedText) {
+    MixSyncReply reply;
+    EXPECT_FALSE(MixSyncReply::parse("", reply));
+    EXPECT_FALSE(MixSyncReply::parse("<html>Bad gateway</html>", reply));
+    EXPECT_FALSE(MixSyncReply::parse("AUTOVIBEZ-SYNC/1\ncursor x\n", reply));
+    EXPECT_FALSE(MixSyncReply::parse("AUTOVIBEZ-SYNC/1\np a 1 2\n", reply));
+    EXPECT_FALSE(MixSyncReply::parse("AUTOVIBEZ-SYNC/1\nf a 2 5\n", reply));
+
+    // Lines of a newer server's kinds are skipped
+    ASSERT_TRUE(MixSyncReply::parse("AUTOVIBEZ-SYNC/1\r\ncursor 3\r\nrating a 5\r\n\r\nf a 1 5\r\n", reply));
+    EXPECT_EQ(reply.cursor, 3);
+    EXPECT_EQ(reply.favorites.size(), 1u);
+}
+
+TEST_F(MixSyncTest, DeltasHoldWhatTheServerHasNotTaken) {
+    MixDatabase db(dbPath("node.db"));
+    ASSERT_TRUE(db.initialize());
+    ASSERT_TRUE(db.addMix(makeMix("a")));
+    ASSERT_TRUE(db.addMix(makeMix("b")));
+    ASSERT_TRUE(db.recordPlayEvent({"a", 1000, 3600, false}));
+    ASSERT_TRUE(db.recordPlayEvent({"a", 5000, 60, true}));
+    ASSERT_TRUE(db.recordPlayEvent({"b", 3000, 1800, false}));
+    ASSERT_TRUE(db.toggleFavorite("b"));
+
+    MixSyncDelta delta;
+    ASSERT_TRUE(db.getSyncDelta(delta, 100, 100)) << db.getLastError();
+    EXPECT_FALSE(delta.node.empty());
+    EXPECT_EQ(delta.after_event, 0);
+    EXPECT_EQ(delta.events, 3);
+    ASSERT_EQ(delta.plays.size(), 2u);
+    const MixSyncPlays& a = delta.plays[0].mix_id == "a" ? delta.plays[0] : delta.plays[1];
+    EXPECT_EQ(a.plays, 2);
+    EXPECT_EQ(a.skips, 1);
+    EXPECT_EQ(a.played_seconds, 3660);
+    EXPECT_EQ(a.last_played_ms, 5000);
+    ASSERT_EQ(delta.favorites.size(), 1u);
+    EXPECT_EQ(delta.favorites[0].mix_id, "b");
+    EXPECT_TRUE(delta.favorites[0].favorite);
+
+    // Until a reply is merged the same changes go out again
+    MixSyncDelta again;
+    ASSERT_TRUE(db.getSyncDelta(again, 100, 100));
+    EXPECT_EQ(again.node, delta.node);
+    EXPECT_EQ(again.events, 3);
+
+    MixSyncReply reply;
+    reply.cursor = 9;
+    ASSERT_TRUE(db.applySyncReply(delta, reply)) << db.getLastError();
+    ASSERT_TRUE(db.recordPlayEvent({"b", 9000, 1800, false}));
+    MixSyncDelta next;
+    ASSERT_TRUE(db.getSyncDelta(next, 100, 100));
+    EXPECT_EQ(next.cursor, 9);
+    EXPECT_EQ(next.after_event, delta.last_event);
+    EXPECT_EQ(next.events, 1);
+    EXPECT_TRUE(next.favorites.empty());
+
+    // Batches are bounded; the rest waits for the next one
+    ASSERT_TRUE(db.recordPlayEvent({"a", 9500, 10, true}));
+    MixSyncDelta first;
+    ASSERT_TRUE(db.getSyncDelta(first, 1, 100));
+    EXPECT_EQ(first.events, 1);
+    EXPECT_EQ(first.plays.size(), 1u);
+}
+
+TEST_F(MixSyncTest, RepliesMergeByFieldWithTheLastWriterWinning) {
+    MixDatabase db(dbPath("node.db"));
+    ASSERT_TRUE(db.initialize());
+    ASSERT_TRUE(db.addMix(makeMix("a")));
+    ASSERT_TRUE(db.addMix(makeMix("b")));
+    ASSERT_TRUE(db.updatePlayStats("a"));
+
+    MixSyncDelta delta;
+    ASSERT_TRUE(db.getSyncDelta(delta, 100, 100));
+    MixSyncReply reply;
+    reply.totals.push_back({"a", 7, 0, 0, 4102444800000});  // Played more, and later, elsewhere
+    reply.favorites.push_back({"a", true, 1000});
+    ASSERT_TRUE(db.applySyncReply(delta, reply));
+    Mix a = db.getMixById("a");
+    EXPECT_EQ(a.play_count, 7);
+    EXPECT_EQ(a.last_played_ms, 4102444800000);
+    EXPECT_TRUE(a.is_favorite);
+    const Mix cached = cachedMix(db, "a");
+    EXPECT_EQ(cached.play_count, 7);
+    EXPECT_TRUE(cached.is_favorite);
+
+    // Counts never go down, and a remote favorite older than this node's change loses to it
+    ASSERT_TRUE(db.toggleFavorite("a"));
+    ASSERT_TRUE(db.getSyncDelta(delta, 100, 100));
+    reply.totals = {{"a", 3, 0, 0, 1000}};
+    reply.favorites = {{"a", true, 2000}};
+    ASSERT_TRUE(db.applySyncReply(MixSyncDelta(), reply));
+    a = db.getMixById("a");
+    EXPECT_EQ(a.play_count, 7);
+    EXPECT_FALSE(a.is_favorite);
+
+    // The server's own echo of that change leaves it sent, and a later one wins
+    ASSERT_EQ(delta.favorites.size(), 1u);
+    reply.totals.clear();
+    reply.favorites = {delta.favorites[0], {"b", true, delta.favorites[0].changed_ms + 1}};
+    ASSERT_TRUE(db.applySyncReply(delta, reply));
+    EXPECT_FALSE(db.getMixById("a").is_favorite);
+    EXPECT_TRUE(db.getMixById("b").is_favorite);
+    MixSyncDelta next;
+    ASSERT_TRUE(db.getSyncDelta(next, 100, 100));
+    EXPECT_TRUE(next.favorites.empty());
+
+    // A mix this node does not have is left alone
+    reply.favorites = {{"missing", true, 1}};
+    reply.totals = {{"missing", 1, 0, 0, 1}};
+    EXPECT_TRUE(db.applySyncReply(next, reply));
+}
+
+TEST_F(MixSyncTest, NodesShareTheirPlaysAndFavoritesThroughTheServer) {
+    FakeSyncServer server;
+    MixDatabase first(dbPath("first.db"));
+    MixDatabase second(dbPath("second.db"));
+    ASSERT_TRUE(first.initialize());
+    ASSERT_TRUE(second.initialize());
+    for (MixDatabase* db : {&first, &second}) {
+        ASSERT_TRUE(db->addMix(makeMix("a")));
+        ASSERT_TRUE(db->addMix(makeMix("b")));
+    }
+    MixSyncAgent first_agent(first, "http://sync.invalid/", server.transport());
+    MixSyncAgent second_agent(second, "http://sync.invalid/", server.transport());
+
+    // Offline, the changes wait in the database
+    server.online = false;
+    ASSERT_TRUE(first.recordPlayEvent({"a", 1000, 3600, false}));
+    ASSERT_TRUE(first.updatePlayStats("a"));
+    ASSERT_TRUE(first.toggleFavorite("b"));
+    EXPECT_FALSE(first_agent.exchange());
+    EXPECT_FALSE(first_agent.getLastError().empty());
+    EXPECT_EQ(first_agent.getLastSyncMs(), 0);
+
+    server.online = true;
+    ASSERT_TRUE(first_agent.exchange()) << first_agent.getLastError();
+    EXPECT_GT(first_agent.getLastSyncMs(), 0);
+    ASSERT_TRUE(second_agent.exchange()) << second_agent.getLastError();
+    EXPECT_EQ(cachedMix(second, "a").play_count, 1);
+    EXPECT_TRUE(cachedMix(second, "b").is_favorite);
+
+    // The second node's plays add to the first's; nothing is counted twice
+    ASSERT_TRUE(second.recordPlayEvent({"a", 2000, 3600, false}));
+    ASSERT_TRUE(second_agent.exchange());
+    ASSERT_TRUE(first_agent.exchange());
+    EXPECT_EQ(server.plays("a"), 2);
+    EXPECT_EQ(first.getMixById("a").play_count, 2);
+}
+
+TEST_F(MixSyncTest, ThreadExchangesOnStartAndOnRequest) {
+    FakeSyncServer server;
+    MixDatabase db(dbPath("node.db"));
+    ASSERT_TRUE(db.initialize());
+    ASSERT_TRUE(db.addMix(makeMix("a")));
+    ASSERT_TRUE(db.recordPlayEvent({"a", 1000, 3600, false}));
+
+    std::mutex mutex;
+    std::condition_variable exchanged;
+    int exchanges = 0;
+    auto transport = server.transport();
+    MixSyncAgent agent(db, "http://sync.invalid/", [&](const std::string& delta, std::string& reply) {
+        const bool ok = transport(delta, reply);
+        std::lock_guard<std::mutex> lock(mutex);
+        ++exchanges;
+        exchanged.notify_all();
+        return ok;
+    });
+    auto waitFor = [&](int count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return exchanged.wait_for(lock, std::chrono::seconds(5), [&]() { return exchanges >= count; });
+    };
+
+    agent.start(std::chrono::seconds(3600));
+    ASSERT_TRUE(waitFor(1));
+    agent.syncSoon();
+    ASSERT_TRUE(waitFor(2));
+    agent.stop();
+    EXPECT_EQ(server.plays("a"), 1);
+}
@@ -0,0 +1,72 @@
+#include "mix_write_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+using namespace AutoVibez::Data;
+
+TEST(MixWriteQueueTest, CoalescesChangesQueuedDuringABatch) {
+    std::mutex gate;
+    std::vector<std::vector<MixWrite>> batches;
+    std::vector<size_t> settled;
+    gate.lock();
+    MixWriteQueue queue(
+        [&](const std::vector<MixWrite>& batch) {
+            std::lock_guard<std::mutex> hold(gate);
+            batches.push_back(batch);
+            return true;
+        },
+        [&](const std::vector<MixWrite>& batch, bool) { settled.push_back(batch.size()); });
+
+    // The first write holds the writer in the executor while the rest pile up
+    auto first = queue.enqueue("warmup", [](MixWrite& write) { write.plays++; });
+    while (queue.getPendingCount() != 0) {
+        std::this_thread::yield();
+    }
+    int previews = 0;
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 3; ++i) {
+        results.push_back(queue.enqueue(
+            "mix1", [](MixWrite& write) { write.toggle_favorite = !write.toggle_favorite; }, [&]() { previews++; }));
+        results.push_back(queue.enqueue("mix1", [](MixWrite& write) { write.plays++; }));
+    }
+    results.push_back(queue.enqueue("mix2", [](MixWrite& write) {
+        write.set_local_path = true;
+        write.local_path = "/a.mp3";
+    }));
+    results.push_back(queue.enqueue("mix2", [](MixWrite& write) { write.local_path = "/b.mp3"; }));
+    EXPECT_EQ(queue.getPendingCount(), 2u);
+    EXPECT_EQ(previews, 3);
+
+    gate.unlock();
+    queue.flush();
+    EXPECT_TRUE(first.get());
+    for (auto& result : results) {
+        EXPECT_TRUE(result.get());
+    }
+
+    ASSERT_EQ(batches.size(), 2u);
+    ASSERT_EQ(batches[1].size(), 2u);
+    EXPECT_EQ(batches[1][0].id, "mix1");
+    EXPECT_TRUE(batches[1][0].toggle_favorite);
+    EXPECT_EQ(batches[1][0].plays, 3);
+    EXPECT_EQ(batches[1][1].local_path, "/b.mp3");
+    EXPECT_EQ(settled, (std::vector<size_t>{1, 2}));
+}
+
+TEST(MixWriteQueueTest, FailedBatchFailsItsFuturesAndDestructorDrains) {
+    std::atomic<int> executed{0};
+    std::future<bool> result;
+    {
+        MixWriteQueue queue(
+            [&](const std::vector<MixWrite>& batch) {
+                executed += static_cast<int>(batch.size());
+                return false;
+            },
+            {});
+        result = queue.enqueue("mix1", [](MixWrite& write) { write.soft_delete = true; });
+    }
+    EXPECT_FALSE(result.get());
+    EXPECT_EQ(executed.load(), 1);
+}
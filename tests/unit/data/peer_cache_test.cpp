@@ -0,0 +1,152 @@
+#include "peer_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "constants.hpp"
+#include "peer_file_server.hpp"
+
+using namespace AutoVibez::Data;
+
+namespace {
+constexpr const char* HASH_A = "0123456789abcdef";
+constexpr const char* HASH_B = "fedcba9876543210";
+
+std::string announcement(const std::string& node_id, int port, const std::string& entries) {
+    return std::string(StringConstants::PEER_ANNOUNCE_MAGIC) + " " + node_id + " " + std::to_string(port) + "\n" +
+           entries;
+}
+
+// A cache that isn't started announces port 0, which no receiver takes
+std::string servedOn(std::string datagram, int port) {
+    const size_t end = datagram.find('\n');
+    const size_t space = datagram.rfind(' ', end);
+    return datagram.replace(space + 1, end - space - 1, std::to_string(port));
+}
+
+// One request on a fresh connection, read until the server closes it
+std::string fetch(uint16_t port, const std::string& request) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    std::string response;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+        send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+        char buffer[4096];
+        ssize_t got;
+        while ((got = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, static_cast<size_t>(got));
+        }
+    }
+    close(fd);
+    return response;
+}
+}  // namespace
+
+TEST(PeerCacheTest, AnnouncementsOfOneNodeAreHeardByAnother) {
+    PeerCache sender;
+    sender.share("mix_a", HASH_A, "/tmp/a.mp3");
+    sender.share("mix_b", HASH_B, "/tmp/b.mp3");
+    sender.share("bad id", HASH_A, "/tmp/c.mp3");       // Would split the announcement line
+    sender.share("mix_c", "not-a-hash", "/tmp/c.mp3");  // Nothing could be checked against it
+
+    const std::vector<std::string> datagrams = sender.buildAnnouncements();
+    ASSERT_EQ(datagrams.size(), 1u);
+    PeerCache receiver;
+    const std::string datagram = servedOn(datagrams[0], 8080);
+    EXPECT_TRUE(receiver.receiveAnnouncement(datagram, "192.168.1.20"));
+    EXPECT_FALSE(receiver.receiveAnnouncement(datagram, "192.168.1.20"));  // Known from now on
+    EXPECT_EQ(receiver.getPeerCount(), 1u);
+
+    const std::vector<PeerSource> sources = receiver.findSources("mix_b");
+    ASSERT_EQ(sources.size(), 1u);
+    EXPECT_EQ(sources[0].content_hash, HASH_B);
+    EXPECT_EQ(sources[0].url, "http://192.168.1.20:8080" + std::string(StringConstants::PEER_MIX_PATH) + "mix_b");
+    EXPECT_TRUE(receiver.findSources("mix_c").empty());
+}
+
+TEST(PeerCacheTest, IgnoresItsOwnAndMalformedAnnouncements) {
+    PeerCache cache;
+    cache.share("mix_a", HASH_A, "/tmp/a.mp3");
+    EXPECT_FALSE(cache.receiveAnnouncement(servedOn(cache.buildAnnouncements()[0], 8080), "10.0.0.2"));
+    EXPECT_FALSE(cache.receiveAnnouncement("HTTP/1.1 200 OK\nmix_a " + std::string(HASH_A) + "\n", "10.0.0.3"));
+    EXPECT_FALSE(cache.receiveAnnouncement(announcement("other", 0, "mix_a " + std::string(HASH_A)), "10.0.0.3"));
+    EXPECT_FALSE(cache.receiveAnnouncement(announcement("other", 70000, "mix_a " + std::string(HASH_A)), "10.0.0.3"));
+
+    EXPECT_TRUE(cache.receiveAnnouncement(announcement("other", 8000, "mix_x\nmix_y ZZZZ\n"), "10.0.0.3"));
+    EXPECT_TRUE(cache.findSources("mix_a").empty());
+    EXPECT_TRUE(cache.findSources("mix_x").empty());
+    EXPECT_TRUE(cache.findSources("mix_y").empty());
+}
+
+TEST(PeerCacheTest, LargeLibrariesSpanSeveralDatagrams) {
+    PeerCache cache;
+    for (int i = 0; i < 200; ++i) {
+        cache.share("mix_" + std::to_string(i), HASH_A, "/tmp/mix.mp3");
+    }
+    const std::vector<std::string> datagrams = cache.buildAnnouncements();
+    EXPECT_GT(datagrams.size(), 1u);
+
+    PeerCache receiver;
+    for (const std::string& datagram : datagrams) {
+        EXPECT_LE(datagram.size(), static_cast<size_t>(Constants::PEER_DATAGRAM_BYTES));
+        receiver.receiveAnnouncement(servedOn(datagram, 8080), "10.0.0.4");
+    }
+    EXPECT_EQ(receiver.findSources("mix_0").size(), 1u);
+    EXPECT_EQ(receiver.findSources("mix_199").size(), 1u);
+}
+
+TEST(PeerCacheTest, OffersTheFreshestHoldersAndForgetsSilentOnes) {
+    PeerCache cache;
+    const auto start = PeerCache::Clock::now();
+    const std::string entry = "mix_a " + std::string(HASH_A) + "\n";
+    for (int node = 0; node <= Constants::PEER_MAX_SOURCES; ++node) {
+        cache.receiveAnnouncement(announcement("node" + std::to_string(node), 9000 + node, entry), "10.0.0.9",
+                                  start + std::chrono::seconds(node));
+    }
+
+    const auto later = start + std::chrono::seconds(Constants::PEER_MAX_SOURCES);
+    const std::vector<PeerSource> sources = cache.findSources("mix_a", later);
+    ASSERT_EQ(sources.size(), static_cast<size_t>(Constants::PEER_MAX_SOURCES));
+    EXPECT_NE(sources[0].url.find(":" + std::to_string(9000 + Constants::PEER_MAX_SOURCES) + "/"), std::string::npos);
+
+    const auto expired = start + std::chrono::milliseconds(Constants::PEER_EXPIRY_MS) + std::chrono::seconds(1);
+    EXPECT_EQ(cache.findSources("mix_a", expired).size(), static_cast<size_t>(Constants::PEER_MAX_SOURCES));
+    EXPECT_EQ(cache.getPeerCount(expired), static_cast<size_t>(Constants::PEER_MAX_SOURCES));
+    EXPECT_TRUE(cache.findSources("mix_a", expired + std::chrono::seconds(Constants::PEER_MAX_SOURCES)).empty());
+}
+
+TEST(PeerFileServerTest, ServesSharedFilesOnly) {
+    const auto path = std::filesystem::temp_directory_path() / "peer_file_server_test.mp3";
+    const std::string body(100000, 'm');
+    std::ofstream(path, std::ios::binary) << body;
+    PeerFileServer server([&](const std::string& mix_id) { return mix_id == "shared" ? path.string() : ""; });
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(server.getPort(), 0);
+
+    const std::string mix_path = StringConstants::PEER_MIX_PATH;
+    const std::string ok = fetch(server.getPort(), "GET " + mix_path + "shared HTTP/1.1\r\nHost: peer\r\n\r\n");
+    EXPECT_EQ(ok.rfind("HTTP/1.1 200", 0), 0u);
+    EXPECT_NE(ok.find("Content-Length: 100000\r\n"), std::string::npos);
+    EXPECT_EQ(ok.substr(ok.find("\r\n\r\n") + 4), body);
+
+    const std::string head = fetch(server.getPort(), "HEAD " + mix_path + "shared HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(head.rfind("HTTP/1.1 200", 0), 0u);
+    EXPECT_EQ(head.find("\r\n\r\n") + 4, head.size());
+
+    EXPECT_EQ(fetch(server.getPort(), "GET " + mix_path + "other HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0), 0u);
+    EXPECT_EQ(fetch(server.getPort(), "GET /etc/passwd HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0), 0u);
+
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,154 @@
+#include "play_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+using namespace AutoVibez::Data;
+
+namespace {
+Mix makeMix(const std::string& id, const std::string& genre) {
+    Mix mix;
+    mix.id = id;
+    mix.genre = genre;
+    return mix;
+}
+
+// Hands out the library round-robin, only the genre asked for when it has any
+class RoundRobinPicker {
+public:
+    explicit RoundRobinPicker(std::vector<Mix> library) : library_(std::move(library)) {}
+
+    Mix operator()(const std::string& genre, const std::string& exclude_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < library_.size(); ++i) {
+            const Mix& mix = library_[next_++ % library_.size()];
+            if (mix.id != exclude_id && (genre.empty() || mix.genre == genre)) {
+                return mix;
+            }
+        }
+        return Mix();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<Mix> library_;
+    size_t next_ = 0;
+};
+
+std::vector<Mix> makeLibrary() {
+    return {makeMix("h1", "House"), makeMix("t1", "Techno"), makeMix("h2", "House"), makeMix("t2", "Techno"),
+            makeMix("h3", "House"), makeMix("t3", "Techno")};
+}
+
+std::vector<std::string> idsOf(const std::vector<Mix>& mixes) {
+    std::vector<std::string> ids;
+    for (const Mix& mix : mixes) {
+        ids.push_back(mix.id);
+    }
+    return ids;
+}
+
+PlayQueue::Picker pickFrom(std::shared_ptr<RoundRobinPicker> picker) {
+    return [picker](const std::string& genre, const std::string& exclude) { return (*picker)(genre, exclude); };
+}
+}  // namespace
+
+TEST(PlayQueueTest, KeepsDistinctPicksUpToDepth) {
+    auto picker = std::make_shared<RoundRobinPicker>(makeLibrary());
+    PlayQueue queue(pickFrom(picker), 3);
+    queue.setCurrent("h1");
+    queue.waitUntilSettled();
+
+    const std::vector<std::string> ids = idsOf(queue.upcoming());
+    ASSERT_EQ(ids.size(), 3u);
+    EXPECT_EQ(std::set<std::string>(ids.begin(), ids.end()).size(), 3u);
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), "h1"), 0);
+    EXPECT_EQ(queue.peek().id, ids.front());
+}
+
+TEST(PlayQueueTest, SmallLibraryLeavesTheQueueShort) {
+    auto picker = std::make_shared<RoundRobinPicker>(std::vector<Mix>{makeMix("a", ""), makeMix("b", "")});
+    PlayQueue queue(pickFrom(picker), 5);
+    queue.setCurrent("a");
+    queue.waitUntilSettled();
+    EXPECT_EQ(idsOf(queue.upcoming()), std::vector<std::string>{"b"});
+
+    // The popped mix becomes current, so the one played before is the only candidate again
+    EXPECT_EQ(queue.pop().id, "b");
+    queue.waitUntilSettled();
+    EXPECT_EQ(idsOf(queue.upcoming()), std::vector<std::string>{"a"});
+}
+
+TEST(PlayQueueTest, PopTakesTheHeadAndTheWorkerRefills) {
+    auto picker = std::make_shared<RoundRobinPicker>(makeLibrary());
+    std::atomic<int> changes{0};
+    PlayQueue queue(pickFrom(picker), 2, [&changes]() { changes++; });
+    queue.waitUntilSettled();
+    const std::string head = queue.peek().id;
+
+    EXPECT_EQ(queue.pop().id, head);
+    queue.waitUntilSettled();
+    const std::vector<std::string> ids = idsOf(queue.upcoming());
+    EXPECT_EQ(ids.size(), 2u);
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), head), 0);
+    EXPECT_GE(changes.load(), 4);  // Two picks, the pop, one more pick
+}
+
+TEST(PlayQueueTest, GenreChangeRefillsAndRemovedMixesAreReplaced) {
+    auto picker = std::make_shared<RoundRobinPicker>(makeLibrary());
+    PlayQueue queue(pickFrom(picker), 2);
+    queue.setGenre("Techno");
+    queue.waitUntilSettled();
+    for (const Mix& mix : queue.upcoming()) {
+        EXPECT_EQ(mix.genre, "Techno");
+    }
+
+    const std::string removed = queue.peek().id;
+    queue.remove(removed);
+    queue.waitUntilSettled();
+    const std::vector<Mix> upcoming = queue.upcoming();
+    ASSERT_EQ(upcoming.size(), 2u);
+    for (const Mix& mix : upcoming) {
+        EXPECT_EQ(mix.genre, "Techno");
+    }
+
+    queue.setGenre("House");
+    queue.waitUntilSettled();
+    for (const Mix& mix : queue.upcoming()) {
+        EXPECT_EQ(mix.genre, "House");
+    }
+}
+
+TEST(PlayQueueTest, PopPicksDirectlyWhenNothingIsQueued) {
+    std::atomic<bool> empty{true};
+    PlayQueue queue(
+        [&empty](const std::string&, const std::string&) { return empty ? Mix() : makeMix("late", "House"); }, 3);
+    queue.waitUntilSettled();
+    EXPECT_TRUE(queue.upcoming().empty());
+    EXPECT_TRUE(queue.pop().id.empty());
+
+    // Mixes arrived but the worker has not been told: pop still finds one
+    empty = false;
+    EXPECT_EQ(queue.pop().id, "late");
+}
+
+TEST(PlayQueueTest, RestorePutsSavedMixesFirst) {
+    auto picker = std::make_shared<RoundRobinPicker>(makeLibrary());
+    PlayQueue queue(pickFrom(picker), 3);
+    queue.setCurrent("h1");
+    queue.waitUntilSettled();
+
+    // The current mix, repeats and mixes no longer in the library (empty ids) are skipped
+    queue.restore({makeMix("t3", "Techno"), makeMix("h1", "House"), Mix(), makeMix("t3", "Techno"),
+                   makeMix("h3", "House")});
+    queue.waitUntilSettled();
+    const std::vector<std::string> ids = idsOf(queue.upcoming());
+    ASSERT_EQ(ids.size(), 3u);
+    EXPECT_EQ(ids[0], "t3");
+    EXPECT_EQ(ids[1], "h3");
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), "h1"), 0);
+    EXPECT_EQ(std::set<std::string>(ids.begin(), ids.end()).size(), 3u);
+}
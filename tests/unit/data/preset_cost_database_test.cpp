@@ -0,0 +1,80 @@
+#include "data/preset_cost_database.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+using AutoVibez::Data::PresetCost;
+using AutoVibez::Data::PresetCostDatabase;
+
+class PresetCostDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "autovibez_preset_cost_test";
+        std::filesystem::create_directories(tempDir);
+        dbPath = (tempDir / "presets.db").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(tempDir);
+    }
+
+    static PresetCost makeCost(const std::string& path, int frames, double cpuP95, double gpuP95) {
+        PresetCost cost;
+        cost.path = path;
+        cost.renderer = "Test GPU";
+        cost.frames = frames;
+        cost.cpu_ms = cpuP95 / 2;
+        cost.cpu_p95_ms = cpuP95;
+        cost.gpu_ms = gpuP95 < 0 ? -1.0 : gpuP95 / 2;
+        cost.gpu_p95_ms = gpuP95;
+        return cost;
+    }
+
+    std::filesystem::path tempDir;
+    std::string dbPath;
+};
+
+TEST_F(PresetCostDatabaseTest, RecordsAndMergesCosts) {
+    PresetCostDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+
+    EXPECT_EQ(db.getCost("a.milk", "Test GPU").frames, 0);
+
+    EXPECT_TRUE(db.recordCost(makeCost("a.milk", 100, 4.0, -1.0)));
+    EXPECT_TRUE(db.recordCost(makeCost("a.milk", 300, 8.0, 12.0)));
+
+    PresetCost cost = db.getCost("a.milk", "Test GPU");
+    EXPECT_EQ(cost.frames, 400);
+    EXPECT_DOUBLE_EQ(cost.cpu_p95_ms, 7.0);   // Frame-weighted
+    EXPECT_DOUBLE_EQ(cost.gpu_p95_ms, 12.0);  // The first visit had no GPU timing
+    EXPECT_DOUBLE_EQ(cost.getCostMs(), 12.0);
+    EXPECT_FALSE(cost.measured_at.empty());
+
+    // Another renderer is a separate measurement
+    EXPECT_EQ(db.getCost("a.milk", "Other GPU").frames, 0);
+}
+
+TEST_F(PresetCostDatabaseTest, ListsCostsSlowestFirst) {
+    PresetCostDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+    EXPECT_TRUE(db.recordCost(makeCost("cheap.milk", 200, 1.0, 2.0)));
+    EXPECT_TRUE(db.recordCost(makeCost("heavy.milk", 200, 3.0, 40.0)));
+    EXPECT_TRUE(db.recordCost(makeCost("cpu.milk", 200, 20.0, -1.0)));
+
+    auto slowest = db.getMostExpensive(2);
+    ASSERT_EQ(slowest.size(), 2u);
+    EXPECT_EQ(slowest[0].path, "heavy.milk");
+    EXPECT_EQ(slowest[1].path, "cpu.milk");
+
+    EXPECT_EQ(db.getCosts("Test GPU").size(), 3u);
+    EXPECT_TRUE(db.getCosts("Other GPU").empty());
+}
+
+TEST_F(PresetCostDatabaseTest, RejectsEmptySamples) {
+    PresetCostDatabase db(dbPath);
+    ASSERT_TRUE(db.initialize());
+    EXPECT_FALSE(db.recordCost(makeCost("a.milk", 0, 1.0, 1.0)));
+    EXPECT_FALSE(db.recordCost(makeCost("", 10, 1.0, 1.0)));
+    EXPECT_FALSE(db.isSuccess());
+}
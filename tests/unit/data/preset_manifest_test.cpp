@@ -0,0 +1,121 @@
+#include "data/preset_manifest.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using AutoVibez::Data::PresetManifest;
+using AutoVibez::Data::PresetManifestChanges;
+using AutoVibez::Data::PresetManifestEntry;
+
+class PresetManifestTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "autovibez_preset_manifest_test";
+        std::filesystem::remove_all(tempDir);
+        root = tempDir / "presets";
+        std::filesystem::create_directories(root / "pack");
+        manifestPath = (tempDir / "manifest.txt").string();
+        writePreset(root / "a.milk");
+        writePreset(root / "pack" / "b.milk");
+        writePreset(root / "notes.txt");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(tempDir);
+    }
+
+    static void writePreset(const std::filesystem::path& path) {
+        std::ofstream(path) << "[preset00]\n";
+    }
+
+    // Filesystems with coarse timestamps may not move a directory's mtime within one test
+    static void touch(const std::filesystem::path& directory) {
+        std::filesystem::last_write_time(directory,
+                                         std::filesystem::last_write_time(directory) + std::chrono::seconds(5));
+    }
+
+    std::string path(const std::filesystem::path& relative) const {
+        return (root / relative).string();
+    }
+
+    std::filesystem::path tempDir;
+    std::filesystem::path root;
+    std::string manifestPath;
+};
+
+TEST_F(PresetManifestTest, ScansPresetFiles) {
+    PresetManifest manifest;
+    const PresetManifestChanges changes = manifest.rescan(root.string());
+    EXPECT_EQ(changes.added.size(), 2u);
+    EXPECT_TRUE(changes.removed.empty());
+    EXPECT_EQ(manifest.getPaths(), (std::vector<std::string>{path("a.milk"), path("pack/b.milk")}));
+
+    PresetManifestEntry entry;
+    ASSERT_TRUE(manifest.find(path("pack/b.milk"), entry));
+    EXPECT_EQ(entry.name, "b");
+    EXPECT_GT(entry.size, 0u);
+    EXPECT_LT(entry.cost_ms, 0.0);
+}
+
+TEST_F(PresetManifestTest, RoundTripsThroughTheFile) {
+    PresetManifest manifest;
+    manifest.rescan(root.string());
+    manifest.setCost(path("a.milk"), 7.5);
+    ASSERT_TRUE(manifest.save(manifestPath));
+
+    PresetManifest loaded;
+    ASSERT_TRUE(loaded.load(manifestPath, root.string()));
+    EXPECT_EQ(loaded.getPaths(), manifest.getPaths());
+    PresetManifestEntry entry;
+    ASSERT_TRUE(loaded.find(path("a.milk"), entry));
+    EXPECT_DOUBLE_EQ(entry.cost_ms, 7.5);
+
+    // An unchanged tree needs no playlist changes
+    EXPECT_TRUE(loaded.rescan(root.string()).empty());
+
+    PresetManifest other;
+    EXPECT_FALSE(other.load(manifestPath, (tempDir / "elsewhere").string()));
+}
+
+TEST_F(PresetManifestTest, RescanFindsAddedAndRemovedPresets) {
+    PresetManifest manifest;
+    manifest.rescan(root.string());
+
+    writePreset(root / "pack" / "c.prjm");
+    std::filesystem::remove(root / "a.milk");
+    touch(root);
+    touch(root / "pack");
+
+    const PresetManifestChanges changes = manifest.rescan(root.string());
+    EXPECT_EQ(changes.added, (std::vector<std::string>{path("pack/c.prjm")}));
+    EXPECT_EQ(changes.removed, (std::vector<std::string>{path("a.milk")}));
+    EXPECT_EQ(manifest.size(), 2u);
+}
+
+TEST_F(PresetManifestTest, SkipsDirectoriesWhoseMtimeIsUnchanged) {
+    PresetManifest manifest;
+    manifest.rescan(root.string());
+
+    // A new file behind an unchanged directory mtime is not looked for
+    const auto mtime = std::filesystem::last_write_time(root / "pack");
+    writePreset(root / "pack" / "hidden.milk");
+    std::filesystem::last_write_time(root / "pack", mtime);
+    EXPECT_TRUE(manifest.rescan(root.string()).empty());
+
+    touch(root / "pack");
+    EXPECT_EQ(manifest.rescan(root.string()).added, (std::vector<std::string>{path("pack/hidden.milk")}));
+}
+
+TEST_F(PresetManifestTest, ForgetsRemovedDirectories) {
+    PresetManifest manifest;
+    manifest.rescan(root.string());
+
+    std::filesystem::remove_all(root / "pack");
+    touch(root);
+    const PresetManifestChanges changes = manifest.rescan(root.string());
+    EXPECT_EQ(changes.removed, (std::vector<std::string>{path("pack/b.milk")}));
+    EXPECT_EQ(manifest.getPaths(), (std::vector<std::string>{path("a.milk")}));
+}
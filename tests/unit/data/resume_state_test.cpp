@@ -0,0 +1,103 @@
+#include "resume_state.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+using AutoVibez::Data::ResumeState;
+
+namespace {
+ResumeState makeState() {
+    ResumeState state;
+    state.mix.id = "mix-1";
+    state.mix.title = "Late\tNight";
+    state.mix.artist = "DJ Test";
+    state.mix.genre = "House";
+    state.mix.duration_seconds = 3600;
+    state.mix.is_favorite = true;
+    state.mix.local_path = "/mixes/mix-1.mp3";
+    state.position_seconds = 1234;
+    state.paused = true;
+    state.gain_db = -3.25;
+    state.seek_index = "1152 1\n0 417 834";
+    state.genre = "Techno";
+    state.volume = 42;
+    state.queue = {"mix-2", "mix-3"};
+    return state;
+}
+}  // namespace
+
+class ResumeStateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "autovibez_resume_state_test";
+        std::filesystem::remove_all(tempDir);
+        path = (tempDir / "state" / "resume.txt").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(tempDir);
+    }
+
+    std::filesystem::path tempDir;
+    std::string path;
+};
+
+TEST_F(ResumeStateTest, EncodeParseRoundTrip) {
+    const ResumeState saved = makeState();
+    ResumeState loaded;
+    ASSERT_TRUE(ResumeState::parse(saved.encode(), loaded));
+
+    EXPECT_EQ(loaded.mix.id, "mix-1");
+    EXPECT_EQ(loaded.mix.title, "Late\tNight");
+    EXPECT_EQ(loaded.mix.artist, "DJ Test");
+    EXPECT_EQ(loaded.mix.genre, "House");
+    EXPECT_EQ(loaded.mix.duration_seconds, 3600);
+    EXPECT_TRUE(loaded.mix.is_favorite);
+    EXPECT_EQ(loaded.mix.local_path, "/mixes/mix-1.mp3");
+    EXPECT_EQ(loaded.position_seconds, 1234);
+    EXPECT_TRUE(loaded.paused);
+    EXPECT_DOUBLE_EQ(loaded.gain_db, -3.25);
+    EXPECT_EQ(loaded.seek_index, saved.seek_index);
+    EXPECT_EQ(loaded.genre, "Techno");
+    EXPECT_EQ(loaded.volume, 42);
+    EXPECT_EQ(loaded.queue, (std::vector<std::string>{"mix-2", "mix-3"}));
+    EXPECT_EQ(loaded.encode(), saved.encode());
+}
+
+TEST_F(ResumeStateTest, RejectsOtherVersionsAndMalformedRecords) {
+    const std::string text = makeState().encode();
+    ResumeState loaded;
+    EXPECT_FALSE(ResumeState::parse("", loaded));
+    EXPECT_FALSE(ResumeState::parse("resume0" + text.substr(text.find('\n')), loaded));
+    EXPECT_FALSE(ResumeState::parse(text + "position\tsoon\t0\n", loaded));
+    EXPECT_FALSE(ResumeState::parse(text + "unknown\t1\n", loaded));
+
+    // A record without a file to open cannot resume anything
+    ResumeState no_file = makeState();
+    no_file.mix.local_path.clear();
+    EXPECT_FALSE(ResumeState::parse(no_file.encode(), loaded));
+}
+
+TEST_F(ResumeStateTest, SaveReplacesTheRecordAtomically) {
+    ResumeState state = makeState();
+    ASSERT_TRUE(state.save(path));
+    state.position_seconds = 1240;
+    ASSERT_TRUE(state.save(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    ResumeState loaded;
+    ASSERT_TRUE(ResumeState::load(path, loaded));
+    EXPECT_EQ(loaded.position_seconds, 1240);
+
+    // A write cut short leaves only the temporary file; the last record still loads
+    std::ofstream(path + ".tmp") << "resume1\nmix\tmix-9";
+    ASSERT_TRUE(ResumeState::load(path, loaded));
+    EXPECT_EQ(loaded.mix.id, "mix-1");
+}
+
+TEST_F(ResumeStateTest, MissingFileDoesNotLoad) {
+    ResumeState loaded;
+    EXPECT_FALSE(ResumeState::load(path, loaded));
+}
@@ -0,0 +1,74 @@
+#include "schema_migrator.hpp"
+
+#include <gtest/gtest.h>
+
+#include "sqlite_connection.hpp"
+
+using namespace AutoVibez::Data;
+
+class SchemaMigratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        connection = std::make_shared<SqliteConnection>(":memory:");
+        ASSERT_TRUE(connection->initialize());
+    }
+
+    void addSteps(SchemaMigrator& migrator) {
+        migrator.addStep(1, "items", [this](IDatabaseConnection& db) {
+            applied.push_back(1);
+            return db.execute("CREATE TABLE items (id TEXT PRIMARY KEY)");
+        });
+        migrator.addStep(2, "items name", [this](IDatabaseConnection& db) {
+            applied.push_back(2);
+            return db.execute("ALTER TABLE items ADD COLUMN name TEXT");
+        });
+    }
+
+    std::shared_ptr<SqliteConnection> connection;
+    std::vector<int> applied;
+};
+
+TEST_F(SchemaMigratorTest, AppliesPendingStepsInOrderOnce) {
+    SchemaMigrator first(connection);
+    first.addStep(1, "items", [this](IDatabaseConnection& db) {
+        applied.push_back(1);
+        return db.execute("CREATE TABLE items (id TEXT PRIMARY KEY)");
+    });
+    EXPECT_EQ(first.getCurrentVersion(), 0);
+    ASSERT_TRUE(first.migrate());
+    EXPECT_EQ(first.getAppliedCount(), 1);
+    EXPECT_EQ(first.getCurrentVersion(), 1);
+
+    // A later build adds a step; only that one runs
+    SchemaMigrator second(connection);
+    addSteps(second);
+    ASSERT_TRUE(second.migrate());
+    EXPECT_EQ(applied, (std::vector<int>{1, 2}));
+    EXPECT_EQ(second.getCurrentVersion(), 2);
+    EXPECT_TRUE(connection->execute("INSERT INTO items (id, name) VALUES ('a', 'b')"));
+
+    // Current: nothing runs
+    ASSERT_TRUE(second.migrate());
+    EXPECT_EQ(second.getAppliedCount(), 0);
+    EXPECT_EQ(applied.size(), 2u);
+}
+
+TEST_F(SchemaMigratorTest, FailedStepRollsBackEveryStep) {
+    SchemaMigrator migrator(connection);
+    addSteps(migrator);
+    migrator.addStep(3, "broken", [](IDatabaseConnection& db) { return db.execute("ALTER TABLE missing ADD x"); });
+
+    EXPECT_FALSE(migrator.migrate());
+    EXPECT_NE(migrator.getLastError().find("version 3 (broken)"), std::string::npos);
+    EXPECT_EQ(migrator.getCurrentVersion(), 0);
+    EXPECT_EQ(connection->prepare("SELECT * FROM items"), nullptr);
+}
+
+TEST_F(SchemaMigratorTest, NewerSchemaIsLeftAlone) {
+    ASSERT_TRUE(connection->execute("PRAGMA user_version = 7"));
+    SchemaMigrator migrator(connection);
+    addSteps(migrator);
+    EXPECT_TRUE(migrator.migrate());
+    EXPECT_TRUE(applied.empty());
+    EXPECT_EQ(migrator.getCurrentVersion(), 7);
+}
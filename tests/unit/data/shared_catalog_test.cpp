@@ -0,0 +1,167 @@
+#include "data/shared_catalog.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "data/mix_database.hpp"
+
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixCatalog;
+using AutoVibez::Data::MixDatabase;
+using AutoVibez::Data::SharedCatalog;
+
+class SharedCatalogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::filesystem::temp_directory_path() / "autovibez_shared_catalog_test";
+        std::filesystem::remove_all(temp_dir);
+        std::filesystem::create_directories(temp_dir);
+        catalog_path = (temp_dir / "mixes.catalog").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    static Mix makeMix(const std::string& id, const std::string& genre) {
+        Mix mix;
+        mix.id = id;
+        mix.title = "Title " + id;
+        mix.artist = "Artist";
+        mix.genre = genre;
+        mix.url = "https://example.com/" + id + ".mp3";
+        mix.original_filename = id + ".mp3";
+        mix.duration_seconds = 3600;
+        return mix;
+    }
+
+    std::filesystem::path temp_dir;
+    std::string catalog_path;
+};
+
+TEST_F(SharedCatalogTest, PublishesEveryFieldToTheOtherInstances) {
+    Mix mix = makeMix("a", "Techno");
+    mix.local_path = "/mixes/a.mp3";
+    mix.description = "Live";
+    mix.tags = {"dark", "peak time"};
+    mix.play_count = 3;
+    mix.is_favorite = true;
+    mix.date_added_ms = 1000;
+    mix.last_played_ms = 2000;
+    mix.has_analysis = true;
+    mix.loudness_lufs = -9.5;
+    mix.peak_dbfs = -0.3;
+    mix.bpm = 128.0;
+    mix.spectral_centroid_hz = 1800.0;
+    MixCatalog catalog;
+    catalog.load({mix, makeMix("b", "House")});
+
+    SharedCatalog publisher;
+    ASSERT_TRUE(publisher.open(catalog_path)) << publisher.getLastError();
+    ASSERT_TRUE(publisher.claimPublisher());
+    SharedCatalog reader;
+    ASSERT_TRUE(reader.open(catalog_path));
+    EXPECT_FALSE(reader.claimPublisher());  // One publisher per host
+    EXPECT_FALSE(reader.isMapped());
+
+    ASSERT_TRUE(publisher.publish(*catalog.snapshot())) << publisher.getLastError();
+    EXPECT_TRUE(reader.hasNewer());
+    ASSERT_TRUE(reader.refresh()) << reader.getLastError();
+    EXPECT_FALSE(reader.refresh());  // Nothing newer
+    EXPECT_EQ(reader.getGeneration(), 1u);
+    ASSERT_EQ(reader.size(), 2u);
+
+    const Mix loaded = reader.mixAt(0);  // Title order, as the catalog's
+    EXPECT_EQ(loaded.id, "a");
+    EXPECT_EQ(loaded.title, mix.title);
+    EXPECT_EQ(loaded.artist, mix.artist);
+    EXPECT_EQ(loaded.genre, mix.genre);
+    EXPECT_EQ(loaded.url, mix.url);
+    EXPECT_EQ(loaded.local_path, mix.local_path);
+    EXPECT_EQ(loaded.description, mix.description);
+    EXPECT_EQ(loaded.original_filename, mix.original_filename);
+    EXPECT_EQ(loaded.tags, mix.tags);
+    EXPECT_EQ(loaded.play_count, 3);
+    EXPECT_TRUE(loaded.is_favorite);
+    EXPECT_EQ(loaded.date_added_ms, 1000);
+    EXPECT_EQ(loaded.last_played_ms, 2000);
+    EXPECT_TRUE(loaded.has_analysis);
+    EXPECT_DOUBLE_EQ(loaded.loudness_lufs, -9.5);
+    EXPECT_DOUBLE_EQ(loaded.peak_dbfs, -0.3);
+    EXPECT_DOUBLE_EQ(loaded.bpm, 128.0);
+    EXPECT_DOUBLE_EQ(loaded.spectral_centroid_hz, 1800.0);
+    EXPECT_EQ(reader.mixAt(1).genre, "House");
+
+    // A later instance maps the latest version as it opens
+    catalog.remove("b");
+    ASSERT_TRUE(publisher.publish(*catalog.snapshot()));
+    SharedCatalog late;
+    ASSERT_TRUE(late.open(catalog_path));
+    EXPECT_EQ(late.getGeneration(), 2u);
+    EXPECT_EQ(late.size(), 1u);
+
+    // Once the publisher is gone, another instance takes over
+    publisher.close();
+    EXPECT_TRUE(reader.claimPublisher());
+}
+
+TEST_F(SharedCatalogTest, CountsWritesFromEveryInstance) {
+    SharedCatalog first;
+    SharedCatalog second;
+    ASSERT_TRUE(first.open(catalog_path));
+    ASSERT_TRUE(second.open(catalog_path));
+    first.noteWrite();
+    second.noteWrite();
+    EXPECT_EQ(first.getWriteCount(), 2u);
+    EXPECT_EQ(second.getWriteCount(), 2u);
+}
+
+TEST_F(SharedCatalogTest, RejectsADamagedVersion) {
+    MixCatalog catalog;
+    catalog.load({makeMix("a", "Techno")});
+    SharedCatalog publisher;
+    ASSERT_TRUE(publisher.open(catalog_path));
+    ASSERT_TRUE(publisher.claimPublisher());
+    ASSERT_TRUE(publisher.publish(*catalog.snapshot()));
+
+    const auto size = std::filesystem::file_size(catalog_path);
+    std::filesystem::resize_file(catalog_path, size - 16);
+    SharedCatalog reader;
+    ASSERT_TRUE(reader.open(catalog_path));  // The control file is fine
+    EXPECT_FALSE(reader.isMapped());
+    EXPECT_NE(reader.getLastError().find("Invalid shared catalog"), std::string::npos);
+}
+
+TEST_F(SharedCatalogTest, DatabasesOnOneHostShareOneCatalog) {
+    const std::string db_path = (temp_dir / "mixes.db").string();
+    MixDatabase publisher(db_path);
+    publisher.setSharedCatalogPath(catalog_path);
+    ASSERT_TRUE(publisher.initialize());
+    ASSERT_TRUE(publisher.addMix(makeMix("a", "Techno")));
+    ASSERT_TRUE(publisher.addMix(makeMix("b", "House")));
+    publisher.syncSharedCatalog();
+
+    // The second instance loads the library from the mapping
+    MixDatabase reader(db_path);
+    reader.setSharedCatalogPath(catalog_path);
+    ASSERT_TRUE(reader.initialize());
+    EXPECT_EQ(reader.getCatalog()->snapshot()->size(), 2u);
+
+    // Its write reaches the publisher through the table, and comes back as the next version
+    ASSERT_TRUE(reader.toggleFavorite("a"));
+    reader.flushWrites();
+    publisher.syncSharedCatalog();
+    EXPECT_TRUE(publisher.getCatalog()->snapshot()->findById("a")->is_favorite);
+
+    // The publisher's own writes go out too
+    ASSERT_TRUE(publisher.deleteMix("b"));
+    publisher.flushWrites();
+    publisher.syncSharedCatalog();
+    reader.syncSharedCatalog();
+    const auto snapshot = reader.getCatalog()->snapshot();
+    EXPECT_EQ(snapshot->size(), 1u);
+    EXPECT_TRUE(snapshot->findById("a")->is_favorite);
+}
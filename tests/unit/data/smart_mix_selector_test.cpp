@@ -3,6 +3,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+
+#include "constants.hpp"
 #include "sqlite_connection.hpp"
 
 using namespace AutoVibez::Data;
@@ -267,3 +270,65 @@ TEST_F(SmartMixSelectorTest, SmartSelectionConfigurationRespected) {
     Mix mix = custom_selector->getSmartRandomMix();
     EXPECT_FALSE(mix.id.empty());
 }
+
+TEST_F(SmartMixSelectorTest, PlayHistoryRestsRecentAndSkippedMixes) {
+    ASSERT_TRUE(connection->execute(StringConstants::CREATE_PLAY_HISTORY));
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const std::string now_ms = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    ASSERT_TRUE(connection->execute("INSERT INTO play_events VALUES ('mix1', " + now_ms +
+                                    ", 3600, 0), ('mix4', 1000, 60, 1), ('mix4', 2000, 60, 1), ('mix4', 3000, 60, 1)"));
+
+    // mix1 was just heard and mix4 keeps being skipped, so the other downloaded mixes take every pick
+    for (int i = 0; i < 50; ++i) {
+        Mix mix = selector->getSmartRandomMix();
+        EXPECT_TRUE(mix.id == "mix2" || mix.id == "mix6") << mix.id;
+    }
+
+    // With nothing else left, a rested mix still plays
+    Mix only = selector->getSmartRandomMix("", "Techno");
+    EXPECT_FALSE(only.id.empty());
+}
+
+TEST_F(SmartMixSelectorTest, SimilarMixFollowsOnFromTheExcludedOne) {
+    auto makeMix = [](const std::string& id, double bpm, bool downloaded) {
+        Mix mix;
+        mix.id = id;
+        mix.local_path = downloaded ? "/path/to/" + id + ".mp3" : "";
+        mix.has_analysis = true;
+        mix.bpm = bpm;
+        mix.loudness_lufs = -12.0;
+        return mix;
+    };
+    const std::vector<Mix> mixes = {makeMix("mix1", 124.0, true), makeMix("mix2", 125.0, true),
+                                    makeMix("mix3", 124.0, false), makeMix("mix4", 175.0, true),
+                                    makeMix("mix6", 80.0, true)};
+    auto index = std::make_shared<MixSelectionIndex>();
+    index->rebuild(mixes);
+    auto similarity = std::make_shared<MixSimilarityIndex>();
+    for (const Mix& mix : mixes) {
+        similarity->upsert(mix);
+    }
+
+    SmartSelectionConfig config;
+    config.preferred_genre_probability = 0;
+    config.favorite_mix_probability = 0;
+    SmartMixSelector similar(connection, config);
+    similar.setSeed(12345);
+    similar.setIndex(index);
+    similar.setSimilarityIndex(similarity);
+    similar.setSimilarMixProbability(100);
+
+    // mix3 matches mix1 exactly but is not downloaded; mix2 is the only close one left
+    int nearest = 0;
+    for (int i = 0; i < 50; ++i) {
+        nearest += similar.getSmartRandomMix("mix1").id == "mix2" ? 1 : 0;
+    }
+    EXPECT_GE(nearest, 45);
+
+    similar.setSimilarMixProbability(0);
+    nearest = 0;
+    for (int i = 0; i < 50; ++i) {
+        nearest += similar.getSmartRandomMix("mix1").id == "mix2" ? 1 : 0;
+    }
+    EXPECT_LT(nearest, 45);
+}
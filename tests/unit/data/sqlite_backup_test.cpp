@@ -0,0 +1,140 @@
+#include "sqlite_backup.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "sqlite_connection.hpp"
+
+using namespace AutoVibez::Data;
+
+class SqliteBackupTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "autovibez_backup_test";
+        std::filesystem::remove_all(tempDir);
+        std::filesystem::create_directories(tempDir);
+        sourcePath = (tempDir / "source.db").string();
+        backupPath = (tempDir / "backup.db").string();
+
+        source = std::make_unique<SqliteConnection>(sourcePath, SqliteTuning::fast());
+        ASSERT_TRUE(source->initialize());
+        ASSERT_TRUE(source->execute("CREATE TABLE mixes (id INTEGER PRIMARY KEY, payload TEXT)"));
+        ASSERT_TRUE(insertRows(*source, 2000));
+    }
+
+    void TearDown() override {
+        source.reset();
+        std::filesystem::remove_all(tempDir);
+    }
+
+    static bool insertRows(SqliteConnection& connection, int rows) {
+        if (!connection.beginTransaction()) {
+            return false;
+        }
+        auto stmt = connection.prepare("INSERT INTO mixes (payload) VALUES (?)");
+        for (int i = 0; i < rows; ++i) {
+            stmt->bindText(1, std::string(200, static_cast<char>('a' + i % 26)));
+            if (!stmt->execute()) {
+                return false;
+            }
+            stmt->reset();
+        }
+        return connection.commitTransaction();
+    }
+
+    static int queryInt(const std::string& path, const std::string& sql) {
+        SqliteConnection connection(path);
+        if (!connection.initialize()) {
+            return -1;
+        }
+        auto stmt = connection.prepare(sql);
+        return stmt && stmt->step() ? stmt->getInt(0) : -1;
+    }
+
+    static bool isIntact(const std::string& path) {
+        SqliteConnection connection(path);
+        if (!connection.initialize()) {
+            return false;
+        }
+        auto stmt = connection.prepare("PRAGMA integrity_check");
+        return stmt && stmt->step() && stmt->getText(0) == "ok";
+    }
+
+    std::filesystem::path tempDir;
+    std::string sourcePath;
+    std::string backupPath;
+    std::unique_ptr<SqliteConnection> source;
+};
+
+TEST_F(SqliteBackupTest, OnlineCopyMatchesTheSource) {
+    SqliteBackup backup(sourcePath, backupPath, BackupMode::Online, 4, 0);
+    ASSERT_TRUE(backup.start());
+    ASSERT_TRUE(backup.wait()) << backup.getLastError();
+
+    EXPECT_FALSE(backup.isRunning());
+    EXPECT_GT(backup.getTotalPages(), 4);
+    EXPECT_EQ(backup.getCopiedPages(), backup.getTotalPages());
+    EXPECT_EQ(queryInt(backupPath, "SELECT COUNT(*) FROM mixes"), 2000);
+    EXPECT_TRUE(isIntact(backupPath));
+    EXPECT_FALSE(std::filesystem::exists(backupPath + ".part"));
+}
+
+TEST_F(SqliteBackupTest, FinishesWhileAnotherConnectionKeepsWriting) {
+    SqliteBackup backup(sourcePath, backupPath, BackupMode::Online, 1, 1);
+    std::atomic<bool> writing{true};
+    std::thread writer([this, &writing]() {
+        while (writing) {
+            insertRows(*source, 5);
+        }
+    });
+
+    ASSERT_TRUE(backup.start());
+    const bool ok = backup.wait();
+    writing = false;
+    writer.join();
+
+    ASSERT_TRUE(ok) << backup.getLastError();
+    EXPECT_GE(queryInt(backupPath, "SELECT COUNT(*) FROM mixes"), 2000);
+    EXPECT_TRUE(isIntact(backupPath));
+}
+
+TEST_F(SqliteBackupTest, CompactCopyLeavesOutFreePages) {
+    ASSERT_TRUE(source->execute("DELETE FROM mixes WHERE id % 2 = 0"));
+    ASSERT_TRUE(source->checkpoint());
+
+    SqliteBackup backup(sourcePath, backupPath, BackupMode::Compact);
+    ASSERT_TRUE(backup.run()) << backup.getLastError();
+
+    EXPECT_EQ(queryInt(backupPath, "SELECT COUNT(*) FROM mixes"), 1000);
+    EXPECT_EQ(queryInt(backupPath, "PRAGMA freelist_count"), 0);
+    EXPECT_LT(queryInt(backupPath, "PRAGMA page_count"), queryInt(sourcePath, "PRAGMA page_count"));
+    EXPECT_TRUE(isIntact(backupPath));
+}
+
+TEST_F(SqliteBackupTest, FailuresLeaveTheDestinationAlone) {
+    {
+        std::ofstream previous(backupPath);
+        previous << "last night's copy";
+    }
+
+    SqliteBackup cancelled(sourcePath, backupPath, BackupMode::Online, 1, 20);
+    ASSERT_TRUE(cancelled.start());
+    EXPECT_FALSE(cancelled.start());  // Already running
+    cancelled.cancel();
+    EXPECT_FALSE(cancelled.wait());
+    EXPECT_EQ(cancelled.getLastError(), "Backup cancelled");
+
+    SqliteBackup missing((tempDir / "missing.db").string(), backupPath);
+    EXPECT_FALSE(missing.run());
+    EXPECT_FALSE(missing.getLastError().empty());
+
+    std::ifstream previous(backupPath);
+    std::string contents;
+    std::getline(previous, contents);
+    EXPECT_EQ(contents, "last night's copy");
+    EXPECT_FALSE(std::filesystem::exists(backupPath + ".part"));
+}
@@ -3,6 +3,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <thread>
+
 #include "database_interfaces.hpp"
 
 using namespace AutoVibez::Data;
@@ -253,3 +256,154 @@ TEST_F(SqliteConnectionTest, StatementParameterBinding) {
     EXPECT_EQ(select_stmt->getText(0), "first");
     EXPECT_EQ(select_stmt->getInt(1), 100);
 }
+
+TEST_F(SqliteConnectionTest, StatementCacheReusesPreparedStatements) {
+    ASSERT_TRUE(connection->initialize());
+    ASSERT_TRUE(connection->execute("CREATE TABLE test (name TEXT)"));
+
+    const std::string insert = "INSERT INTO test (name) VALUES (?)";
+    const std::string names[] = {"a", "b", "c"};
+    for (const std::string& name : names) {
+        auto stmt = connection->prepare(insert);
+        ASSERT_NE(stmt, nullptr);
+        stmt->bindText(1, name);
+        EXPECT_TRUE(stmt->execute());
+    }
+    StatementCacheStats stats = connection->getStatementCacheStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.size, 1u);
+
+    // A returned statement has no bindings left over
+    {
+        auto stmt = connection->prepare(insert);
+        ASSERT_NE(stmt, nullptr);
+        EXPECT_TRUE(stmt->execute());
+    }
+    auto count = connection->prepare("SELECT COUNT(*) FROM test WHERE name IS NULL");
+    ASSERT_NE(count, nullptr);
+    ASSERT_TRUE(count->step());
+    EXPECT_EQ(count->getInt(0), 1);
+}
+
+TEST_F(SqliteConnectionTest, StatementCacheHandlesNestedUseOfTheSameSql) {
+    ASSERT_TRUE(connection->initialize());
+    ASSERT_TRUE(connection->execute("CREATE TABLE test (id INTEGER)"));
+    ASSERT_TRUE(connection->execute("INSERT INTO test VALUES (1), (2)"));
+
+    const std::string select = "SELECT id FROM test ORDER BY id";
+    auto outer = connection->prepare(select);
+    ASSERT_NE(outer, nullptr);
+    ASSERT_TRUE(outer->step());
+    {
+        auto inner = connection->prepare(select);
+        ASSERT_NE(inner, nullptr);
+        ASSERT_TRUE(inner->step());
+        EXPECT_EQ(inner->getInt(0), 1);
+    }
+    // The outer query keeps its own position
+    ASSERT_TRUE(outer->step());
+    EXPECT_EQ(outer->getInt(0), 2);
+    EXPECT_EQ(connection->getStatementCacheStats().misses, 2u);
+}
+
+TEST_F(SqliteConnectionTest, StatementCacheEvictsLeastRecentlyUsed) {
+    SqliteConnection small(":memory:", SqliteTuning(), 2);
+    ASSERT_TRUE(small.initialize());
+
+    small.prepare("SELECT 1");
+    small.prepare("SELECT 2");
+    small.prepare("SELECT 1");
+    small.prepare("SELECT 3");  // Evicts SELECT 2
+    StatementCacheStats stats = small.getStatementCacheStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+
+    small.prepare("SELECT 1");
+    small.prepare("SELECT 2");
+    stats = small.getStatementCacheStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 4u);
+}
+
+TEST_F(SqliteConnectionTest, FastTuningSwitchesFileDatabasesToWal) {
+    const std::string path = (std::filesystem::temp_directory_path() / "sqlite_connection_wal_test.db").string();
+    std::filesystem::remove(path);
+    {
+        SqliteConnection fast(path, SqliteTuning::fast());
+        ASSERT_TRUE(fast.initialize());
+        EXPECT_EQ(fast.getJournalMode(), "wal");
+        ASSERT_TRUE(fast.execute("CREATE TABLE test (id INTEGER)"));
+        ASSERT_TRUE(fast.execute("INSERT INTO test VALUES (1)"));
+        EXPECT_TRUE(fast.checkpoint());
+
+        // A second connection reads while the first holds a write transaction
+        SqliteConnection reader(path, SqliteTuning::fast());
+        ASSERT_TRUE(reader.initialize());
+        ASSERT_TRUE(fast.beginTransaction());
+        ASSERT_TRUE(fast.execute("INSERT INTO test VALUES (2)"));
+        auto count = reader.prepare("SELECT COUNT(*) FROM test");
+        ASSERT_NE(count, nullptr);
+        ASSERT_TRUE(count->step());
+        EXPECT_EQ(count->getInt(0), 1);
+        EXPECT_TRUE(fast.commitTransaction());
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + "-wal");
+    std::filesystem::remove(path + "-shm");
+
+    SqliteTuning tuning;
+    EXPECT_TRUE(SqliteTuning::parseProfile("Safe", tuning));
+    EXPECT_FALSE(tuning.wal);
+    EXPECT_GT(tuning.busy_timeout_ms, 0);
+    EXPECT_FALSE(SqliteTuning::parseProfile("turbo", tuning));
+}
+
+TEST(SqliteConnectionPoolTest, GivesEachThreadItsOwnConnection) {
+    const std::string path = (std::filesystem::temp_directory_path() / "sqlite_connection_pool_test.db").string();
+    std::filesystem::remove(path);
+    {
+        SqliteConnectionPool pool(path, SqliteTuning::fast(), 1);
+        ASSERT_TRUE(pool.initialize());
+        ASSERT_TRUE(pool.execute("CREATE TABLE test (id INTEGER)"));
+
+        // The other thread's connection doesn't see this thread's open transaction
+        ASSERT_TRUE(pool.beginTransaction());
+        ASSERT_TRUE(pool.execute("INSERT INTO test VALUES (1)"));
+        int seen = -1;
+        std::thread reader([&pool, &seen]() {
+            auto count = pool.prepare("SELECT COUNT(*) FROM test");
+            if (count && count->step()) {
+                seen = count->getInt(0);
+            }
+        });
+        reader.join();
+        EXPECT_EQ(seen, 0);
+        EXPECT_TRUE(pool.commitTransaction());
+        EXPECT_EQ(pool.getOpenCount(), 2u);
+
+        // Exited threads' connections are reused up to max_idle, the rest closed
+        std::thread first([&pool]() { pool.execute("INSERT INTO test VALUES (2)"); });
+        std::thread second([&pool]() { pool.execute("INSERT INTO test VALUES (3)"); });
+        first.join();
+        second.join();
+        EXPECT_LE(pool.getOpenCount(), 3u);
+        auto count = pool.prepare("SELECT COUNT(*) FROM test");
+        ASSERT_NE(count, nullptr);
+        ASSERT_TRUE(count->step());
+        EXPECT_EQ(count->getInt(0), 3);
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + "-wal");
+    std::filesystem::remove(path + "-shm");
+
+    // An in-memory database only exists on one connection, so every thread shares it
+    SqliteConnectionPool memory(":memory:");
+    ASSERT_TRUE(memory.initialize());
+    ASSERT_TRUE(memory.execute("CREATE TABLE test (id INTEGER)"));
+    bool inserted = false;
+    std::thread writer([&memory, &inserted]() { inserted = memory.execute("INSERT INTO test VALUES (1)"); });
+    writer.join();
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(memory.getOpenCount(), 1u);
+}
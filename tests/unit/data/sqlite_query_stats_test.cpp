@@ -0,0 +1,93 @@
+#include "sqlite_query_stats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+
+#include "sqlite_connection.hpp"
+
+using namespace AutoVibez::Data;
+
+TEST(SqliteQueryStatsTest, FoldsRunsPerSqlIntoBuckets) {
+    SqliteQueryStats stats;
+    for (int i = 0; i < 99; ++i) {
+        stats.record("SELECT 1", 3000, 2);  // 3us lands under 4us
+    }
+    stats.record("SELECT 1", 5000000, 2);  // One 5ms outlier
+    stats.record("UPDATE t SET a = 1", 1000, 0);
+
+    const std::vector<QueryStats> snapshot = stats.snapshot();
+    ASSERT_EQ(snapshot.size(), 2u);
+    const QueryStats& select = snapshot[0];  // Most total time first
+    EXPECT_EQ(select.sql, "SELECT 1");
+    EXPECT_EQ(select.calls, 100u);
+    EXPECT_EQ(select.rows, 200u);
+    EXPECT_NEAR(select.total_ms, 99 * 0.003 + 5.0, 1e-9);
+    EXPECT_DOUBLE_EQ(select.max_ms, 5.0);
+    EXPECT_DOUBLE_EQ(select.p50_ms, 0.004);
+    EXPECT_DOUBLE_EQ(select.p95_ms, 0.004);
+    EXPECT_DOUBLE_EQ(select.p99_ms, 0.004);  // The outlier is the 100th of 100 runs
+
+    stats.clear();
+    EXPECT_TRUE(stats.snapshot().empty());
+}
+
+TEST(SqliteQueryStatsTest, RecognizesFullScans) {
+    EXPECT_TRUE(SqliteQueryStats::isFullScan("SCAN mixes"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("SCAN mixes USING INDEX idx_mixes_live_genre"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("SEARCH mixes USING INDEX sqlite_autoindex_mixes_1 (id=?)"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("SCAN mixes_fts VIRTUAL TABLE INDEX 0:M3"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("SCAN CONSTANT ROW"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("SCAN (subquery-1)"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("SCAN sqlite_master"));
+    EXPECT_FALSE(SqliteQueryStats::isFullScan("USE TEMP B-TREE FOR ORDER BY"));
+}
+
+TEST(SqliteQueryStatsTest, ConnectionTimesStatementsAndExplainsQueriesOnce) {
+    SqliteTuning tuning;
+    tuning.query_stats = std::make_shared<SqliteQueryStats>(true);
+    SqliteConnection connection(":memory:", tuning);
+    ASSERT_TRUE(connection.initialize());
+    ASSERT_TRUE(connection.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, name TEXT)"));
+    ASSERT_TRUE(connection.execute("INSERT INTO t (name) VALUES ('a'), ('b'), ('c')"));
+
+    const std::string scan = "SELECT name FROM t WHERE name = ?";
+    for (int i = 0; i < 2; ++i) {
+        auto stmt = connection.prepare(scan);
+        ASSERT_TRUE(stmt);
+        stmt->bindText(1, "b");
+        while (stmt->step()) {
+        }
+    }
+    {
+        // Abandoned after one row, recorded when it goes back to the cache
+        auto stmt = connection.prepare("SELECT id FROM t WHERE id > ?");
+        stmt->bindInt(1, 0);
+        ASSERT_TRUE(stmt->step());
+    }
+
+    QueryStats scanned;
+    QueryStats seeked;
+    for (const QueryStats& query : tuning.query_stats->snapshot()) {
+        if (query.sql == scan) {
+            scanned = query;
+        } else if (query.sql == "SELECT id FROM t WHERE id > ?") {
+            seeked = query;
+        }
+    }
+    EXPECT_EQ(scanned.calls, 2u);
+    EXPECT_EQ(scanned.rows, 2u);
+    EXPECT_TRUE(scanned.full_scan);
+    EXPECT_NE(scanned.plan.find("SCAN t"), std::string::npos);
+    EXPECT_EQ(seeked.calls, 1u);
+    EXPECT_EQ(seeked.rows, 1u);
+    EXPECT_FALSE(seeked.full_scan);
+    EXPECT_NE(seeked.plan.find("SEARCH t"), std::string::npos);
+    EXPECT_FALSE(tuning.query_stats->claimPlan(scan));
+
+    std::ostringstream csv;
+    tuning.query_stats->writeCsv(csv);
+    EXPECT_EQ(csv.str().rfind("sql,calls,rows,total_ms", 0), 0u);
+    EXPECT_NE(csv.str().find(",1,SCAN t\n"), std::string::npos) << csv.str();
+}
@@ -0,0 +1,144 @@
+#include "data/synthetic_library.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "data/manifest_diff.hpp"
+#include "utils/uuid_utils.hpp"
+
+using AutoVibez::Data::ManifestDiff;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixMetadata;
+using AutoVibez::Data::SyntheticLibrary;
+using AutoVibez::Data::SyntheticLibraryOptions;
+using AutoVibez::Data::ZipfDistribution;
+
+namespace {
+SyntheticLibraryOptions smallLibrary() {
+    SyntheticLibraryOptions options;
+    options.mixes = 5000;
+    options.genres = 30;
+    options.downloaded = 50;
+    options.now_ms = 1700000000000LL;
+    return options;
+}
+}  // namespace
+
+TEST(SyntheticLibraryTest, ZipfFavorsLowRanks) {
+    const ZipfDistribution zipf(100, 1.0);
+    std::mt19937 engine(7);
+    std::vector<int> counts(100, 0);
+    for (int i = 0; i < 100000; ++i) {
+        const int rank = zipf(engine);
+        ASSERT_GE(rank, 0);
+        ASSERT_LT(rank, 100);
+        counts[rank]++;
+    }
+    // Rank 1 is drawn about ten times as often as rank 10 at exponent 1
+    EXPECT_GT(counts[0], 5 * counts[9]);
+    EXPECT_GT(counts[9], counts[99]);
+}
+
+TEST(SyntheticLibraryTest, ManifestIsDeterministicWithIdsFromUrls) {
+    const SyntheticLibrary library(smallLibrary());
+    const std::vector<Mix> first = library.generateManifest();
+    const std::vector<Mix> second = library.generateManifest();
+    ASSERT_EQ(first.size(), 5000u);
+    ASSERT_EQ(second.size(), first.size());
+
+    std::unordered_set<std::string> ids;
+    for (size_t i = 0; i < first.size(); ++i) {
+        EXPECT_EQ(first[i].id, second[i].id);
+        EXPECT_EQ(first[i].title, second[i].title);
+        EXPECT_EQ(first[i].id, AutoVibez::Utils::HashIdUtils::generateIdFromUrl(first[i].url));
+        EXPECT_FALSE(first[i].artist.empty());
+        EXPECT_GT(first[i].duration_seconds, 0);
+        ids.insert(first[i].id);
+    }
+    EXPECT_EQ(ids.size(), first.size());
+}
+
+TEST(SyntheticLibraryTest, GenresAreSkewed) {
+    const std::vector<Mix> manifest = SyntheticLibrary(smallLibrary()).generateManifest();
+    std::map<std::string, int> genres;
+    for (const Mix& mix : manifest) {
+        genres[mix.genre]++;
+    }
+    std::vector<int> counts;
+    for (const auto& [genre, count] : genres) {
+        counts.push_back(count);
+    }
+    std::sort(counts.rbegin(), counts.rend());
+    EXPECT_LE(counts.size(), 30u);
+    ASSERT_GE(counts.size(), 10u);
+    EXPECT_GT(counts[0], 3 * counts[9]);
+}
+
+TEST(SyntheticLibraryTest, LibraryHasPlayHistoryAndCachedFiles) {
+    const SyntheticLibrary generator(smallLibrary());
+    const std::vector<Mix> manifest = generator.generateManifest();
+    const std::vector<Mix> library = generator.generateLibrary(manifest, "/cache/mixes");
+
+    // About the played fraction of the manifest
+    EXPECT_GT(library.size(), 1200u);
+    EXPECT_LT(library.size(), 1800u);
+
+    int cached = 0;
+    int64_t oldest_cached = INT64_MAX;
+    int64_t newest_evicted = 0;
+    for (const Mix& mix : library) {
+        EXPECT_GE(mix.play_count, 1);
+        EXPECT_LE(mix.last_played_ms, 1700000000000LL);
+        EXPECT_LE(mix.date_added_ms, mix.last_played_ms);
+        EXPECT_TRUE(mix.has_analysis);
+        if (!mix.local_path.empty()) {
+            cached++;
+            EXPECT_EQ(mix.local_path, (std::filesystem::path("/cache/mixes") / (mix.id + ".mp3")).string());
+            oldest_cached = std::min(oldest_cached, mix.last_played_ms);
+        } else {
+            newest_evicted = std::max(newest_evicted, mix.last_played_ms);
+        }
+    }
+    EXPECT_EQ(cached, 50);
+    EXPECT_GE(oldest_cached, newest_evicted);
+}
+
+TEST(SyntheticLibraryTest, EvolvedManifestAddsUpdatesAndRemoves) {
+    const SyntheticLibrary generator(smallLibrary());
+    const std::vector<Mix> manifest = generator.generateManifest();
+    const std::vector<Mix> evolved = generator.evolveManifest(manifest, 0.06);
+
+    std::unordered_map<std::string, uint64_t> stored;
+    for (const Mix& mix : manifest) {
+        stored[mix.id] = ManifestDiff::hashEntry(mix);
+    }
+    const ManifestDiff diff = ManifestDiff::compute(evolved, stored);
+    // 2% of 5000 each, give or take the draw
+    for (size_t count : {diff.added.size(), diff.updated.size(), diff.removed.size()}) {
+        EXPECT_GT(count, 50u);
+        EXPECT_LT(count, 150u);
+    }
+}
+
+TEST(SyntheticLibraryTest, WrittenManifestLoadsBack) {
+    SyntheticLibraryOptions options = smallLibrary();
+    options.mixes = 200;
+    const std::vector<Mix> manifest = SyntheticLibrary(options).generateManifest();
+    const std::string path = (std::filesystem::temp_directory_path() / "autovibez_synthetic_manifest.yaml").string();
+    ASSERT_TRUE(SyntheticLibrary::writeManifest(manifest, path));
+
+    MixMetadata metadata;
+    const std::vector<Mix> loaded = metadata.loadFromLocalFile(path);
+    std::filesystem::remove(path);
+    ASSERT_EQ(loaded.size(), manifest.size());
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        EXPECT_EQ(ManifestDiff::hashEntry(loaded[i]), ManifestDiff::hashEntry(manifest[i])) << manifest[i].title;
+    }
+}
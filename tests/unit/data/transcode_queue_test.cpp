@@ -0,0 +1,92 @@
+#include "transcode_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::TranscodeQueue;
+using AutoVibez::Utils::CancellationToken;
+
+namespace {
+Mix makeMix(const std::string& id) {
+    Mix mix;
+    mix.id = id;
+    mix.title = "Title " + id;
+    return mix;
+}
+}  // namespace
+
+TEST(TranscodeQueueTest, TranscodesEachMixOnceInOrder) {
+    std::mutex mutex;
+    std::vector<std::string> done;
+    std::promise<void> finished;
+    std::promise<void> gate;
+    std::shared_future<void> enqueued = gate.get_future().share();
+    TranscodeQueue queue([&](const Mix& mix, const CancellationToken&) {
+        enqueued.wait();  // So "a" is still pending when it is enqueued again
+        std::lock_guard<std::mutex> lock(mutex);
+        done.push_back(mix.id);
+        if (done.size() == 3) {
+            finished.set_value();
+        }
+    });
+
+    queue.enqueue(makeMix("a"));
+    queue.enqueue(makeMix("b"));
+    queue.enqueue(makeMix("a"));  // Still pending
+    queue.enqueue(makeMix("c"));
+    gate.set_value();
+    ASSERT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    queue.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(done, (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(TranscodeQueueTest, StopCancelsTheMixInProgressAndDropsTheRest) {
+    std::promise<void> started;
+    std::vector<std::string> done;
+    bool cancelled = false;
+    TranscodeQueue queue([&](const Mix& mix, const CancellationToken& cancel) {
+        if (mix.id == "long") {
+            started.set_value();
+            cancel.sleepFor(std::chrono::seconds(10));
+            cancelled = cancel.isCancelled();
+        }
+        done.push_back(mix.id);
+    });
+
+    queue.enqueue(makeMix("long"));
+    queue.enqueue(makeMix("next"));
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(queue.getPendingCount(), 2u);
+    queue.stop();
+
+    EXPECT_TRUE(cancelled);
+    EXPECT_EQ(done, (std::vector<std::string>{"long"}));
+    EXPECT_EQ(queue.getPendingCount(), 0u);
+
+    // Nothing more is taken once stopped
+    queue.enqueue(makeMix("late"));
+    EXPECT_EQ(queue.getPendingCount(), 0u);
+}
+
+TEST(TranscodeQueueTest, AFailingMixDoesNotStallTheQueue) {
+    std::promise<void> finished;
+    TranscodeQueue queue([&](const Mix& mix, const CancellationToken&) {
+        if (mix.id == "bad") {
+            throw std::runtime_error("corrupt frame");
+        }
+        finished.set_value();
+    });
+
+    queue.enqueue(makeMix("bad"));
+    queue.enqueue(makeMix("good"));
+    EXPECT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
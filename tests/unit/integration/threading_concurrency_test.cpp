@@ -4,12 +4,15 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <filesystem>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "data/mix_database.hpp"
+
 // Test threading and concurrency behaviors across components
 // Focus on: thread safety, concurrent operations, audio callbacks, synchronization, race conditions
 
@@ -612,3 +615,59 @@ TEST_F(ThreadingConcurrencyTest, ConcurrentResourceAccessWorkflow) {
     EXPECT_GT(MockThreading::mix_queue.access_counter.load(), 0);
     EXPECT_GT(MockThreading::config_data.access_counter.load(), 0);
 }
+
+TEST(MixDatabaseConcurrencyTest, ConcurrentDownloadsShareTheDatabase) {
+    // What each background download does to the database, on its own thread, while the main thread keeps reading
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "autovibez_concurrency_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const int downloads = 32;
+    {
+        AutoVibez::Data::MixDatabase db((dir / "mixes.db").string());
+        ASSERT_TRUE(db.initialize());
+
+        std::atomic<int> failures{0};
+        std::atomic<bool> downloading{true};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < downloads; ++i) {
+            threads.emplace_back([&db, &failures, i]() {
+                AutoVibez::Data::Mix mix;
+                mix.id = "download-" + std::to_string(i);
+                mix.title = "Download " + std::to_string(i);
+                mix.artist = "Artist " + std::to_string(i % 4);
+                mix.genre = i % 2 ? "Techno" : "House";
+                mix.url = "https://example.com/" + mix.id + ".mp3";
+                mix.duration_seconds = 3600;
+
+                if (!db.getMixById(mix.id).id.empty() || !db.addMix(mix) ||
+                    !db.setLocalPath(mix.id, "/mixes/" + mix.id + ".mp3") ||
+                    !db.setMixAnalysis(mix.id, -14.0, -1.0, 126.0) || db.getMixById(mix.id).id != mix.id) {
+                    failures++;
+                }
+                db.queueRecordPlay(mix.id);
+                db.getRecentlyPlayed(5);
+            });
+        }
+        std::thread reader([&db, &downloading]() {
+            while (downloading) {
+                db.getRandomMix("");
+                db.getDownloadedMixes();
+                db.getRecentlyPlayed(5);
+            }
+        });
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        downloading = false;
+        reader.join();
+        db.flushWrites();
+
+        EXPECT_EQ(failures.load(), 0) << db.getLastError();
+        EXPECT_EQ(db.getAllMixes().size(), static_cast<size_t>(downloads));
+        EXPECT_EQ(db.getDownloadedMixes().size(), static_cast<size_t>(downloads));
+        EXPECT_EQ(db.getRecentlyPlayed(downloads * 2).size(), static_cast<size_t>(downloads));
+        EXPECT_EQ(db.getMixById("download-0").play_count, 1);
+        EXPECT_EQ(db.getMixById("download-0").loudness_lufs, -14.0);
+    }
+    std::filesystem::remove_all(dir);
+}
@@ -134,6 +134,42 @@ TEST_F(PathManagerTest, GetFileMappingsPath) {
     EXPECT_TRUE(mappings_path.find("file_mappings.txt") != std::string::npos);
 }
 
+TEST_F(PathManagerTest, GetPresetCostDatabasePath) {
+    std::string cost_path = PathManager::getPresetCostDatabasePath();
+
+    // Lives in the state directory with the mix database
+    EXPECT_EQ(cost_path.rfind(PathManager::getStateDirectory(), 0), 0u);
+    EXPECT_TRUE(cost_path.find("autovibez_presets.db") != std::string::npos);
+}
+
+TEST_F(PathManagerTest, GetPresetManifestPath) {
+    std::string manifest_path = PathManager::getPresetManifestPath();
+
+    EXPECT_EQ(manifest_path.rfind(PathManager::getStateDirectory(), 0), 0u);
+    EXPECT_TRUE(manifest_path.find("preset_manifest.txt") != std::string::npos);
+}
+
+TEST_F(PathManagerTest, GetTextureCachePaths) {
+    std::string cache_dir = PathManager::getTextureCacheDirectory();
+    std::string index_path = PathManager::getTextureCacheIndexPath();
+
+    EXPECT_EQ(cache_dir.rfind(PathManager::getCacheDirectory(), 0), 0u);
+    EXPECT_EQ(index_path.rfind(PathManager::getCacheDirectory(), 0), 0u);
+    EXPECT_TRUE(index_path.find("texture_cache.txt") != std::string::npos);
+    EXPECT_NE(cache_dir, PathManager::getTexturesDirectory());
+}
+
+TEST_F(PathManagerTest, GetManifestCachePath) {
+    std::string cache_path = PathManager::getManifestCachePath();
+
+    EXPECT_EQ(cache_path.rfind(PathManager::getCacheDirectory(), 0), 0u);
+    EXPECT_TRUE(cache_path.find("mixes_manifest.txt") != std::string::npos);
+
+    std::string snapshot_path = PathManager::getManifestSnapshotPath();
+    EXPECT_EQ(snapshot_path.rfind(PathManager::getCacheDirectory(), 0), 0u);
+    EXPECT_NE(snapshot_path, cache_path);
+}
+
 TEST_F(PathManagerTest, GetPresetsDirectory) {
     // Test that presets directory path is returned
     std::string presets_dir = PathManager::getPresetsDirectory();
@@ -330,3 +366,34 @@ TEST_F(PathManagerTest, DirectoryConsistency) {
     EXPECT_NE(data_dir, state_dir);
     EXPECT_NE(cache_dir, state_dir);
 }
+
+TEST_F(PathManagerTest, PathsAreCachedAfterFirstLookup) {
+    // Every call returns the same resolved string rather than building a new one
+    EXPECT_EQ(&PathManager::getDatabasePath(), &PathManager::getDatabasePath());
+    EXPECT_EQ(&PathManager::getStateDirectory(), &PathManager::getStateDirectory());
+    EXPECT_EQ(PathManager::getDatabasePath().rfind(PathManager::getStateDirectory(), 0), 0u);
+}
+
+TEST_F(PathManagerTest, SetDirectoriesOverridesAndResetRestores) {
+    const std::string platform_state = PathManager::getStateDirectory();
+    const std::string& old_database = PathManager::getDatabasePath();
+    const std::string old_database_copy = old_database;
+
+    PathManager::Directories directories{(test_dir / "config").string(), (test_dir / "assets").string(),
+                                         (test_dir / "data").string(), (test_dir / "cache").string(),
+                                         (test_dir / "state").string()};
+    PathManager::setDirectories(directories);
+
+    EXPECT_EQ(PathManager::getStateDirectory(), directories.state);
+    EXPECT_EQ(PathManager::getCacheDirectory(), directories.cache);
+    EXPECT_EQ(PathManager::getDatabasePath().rfind(directories.state, 0), 0u);
+    EXPECT_EQ(PathManager::getMixesDirectory().rfind(directories.data, 0), 0u);
+    EXPECT_TRUE(std::filesystem::is_directory(directories.state));
+    EXPECT_TRUE(std::filesystem::is_directory(directories.assets));
+
+    // A reference taken before the override still reads the old path
+    EXPECT_EQ(old_database, old_database_copy);
+
+    PathManager::resetDirectories();
+    EXPECT_EQ(PathManager::getStateDirectory(), platform_state);
+}
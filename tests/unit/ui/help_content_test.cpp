@@ -0,0 +1,111 @@
+#include "help_content.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using AutoVibez::Data::Mix;
+using AutoVibez::UI::HelpContent;
+using AutoVibez::UI::HelpMixRow;
+
+namespace {
+Mix makeMix(const std::string& artist, const std::string& title, bool favorite, int seconds = 3600) {
+    Mix mix;
+    mix.id = artist + title;
+    mix.artist = artist;
+    mix.title = title;
+    mix.genre = "Techno";
+    mix.is_favorite = favorite;
+    mix.duration_seconds = seconds;
+    mix.play_count = 3;
+    return mix;
+}
+
+std::vector<std::string> titles(const std::vector<HelpMixRow>& rows) {
+    std::vector<std::string> result;
+    for (const HelpMixRow& row : rows) {
+        result.push_back(row.title);
+    }
+    return result;
+}
+}  // namespace
+
+TEST(HelpContentTest, UnchangedValuesKeepTheRevision) {
+    HelpContent content;
+    const uint64_t initial = content.getStatusRevision();
+
+    EXPECT_TRUE(content.setPreset("Flexi - Mindblob"));
+    EXPECT_TRUE(content.setVolume(40));
+    const uint64_t changed = content.getStatusRevision();
+    EXPECT_GT(changed, initial);
+
+    EXPECT_FALSE(content.setPreset("Flexi - Mindblob"));
+    EXPECT_FALSE(content.setVolume(40));
+    EXPECT_FALSE(content.setBeatSensitivity(0.0f));
+    EXPECT_EQ(content.getStatusRevision(), changed);
+}
+
+TEST(HelpContentTest, StatusLinesInDisplayOrder) {
+    HelpContent content;
+    content.setMix("Artist", "Title", "House");
+    content.setComingUp({"Next - One", "Next - Two"});
+    content.setVolume(75);
+
+    const auto& lines = content.getStatusLines();
+    ASSERT_EQ(lines.size(), 6u);
+    EXPECT_EQ(lines[0].label, "  Now playing:");
+    EXPECT_EQ(lines[0].value, "Artist - Title");
+    EXPECT_EQ(lines[1].label, "  Coming up:");
+    EXPECT_EQ(lines[2].label, "");  // Only the first queued mix is labelled
+    EXPECT_EQ(lines[2].value, "Next - Two");
+    EXPECT_EQ(lines[3].value, "House");
+    EXPECT_EQ(lines[4].value, "75%");
+    EXPECT_EQ(lines[5].label, "  Beat Sensitivity:");
+}
+
+TEST(HelpContentTest, LibraryRowsPutFavoritesFirst) {
+    HelpContent content;
+    content.setMixes(
+        {makeMix("B", "Second", false, 3605), makeMix("C", "Favorite", true), makeMix("A", "First", false)});
+
+    const auto& rows = content.getMixRows();
+    EXPECT_EQ(titles(rows), (std::vector<std::string>{"Favorite", "First", "Second"}));
+    EXPECT_EQ(rows[0].artist, "  C");
+    EXPECT_TRUE(rows[0].favorite);
+    EXPECT_EQ(rows[2].duration, "60:05");
+    EXPECT_EQ(rows[2].plays, "3");
+
+    const uint64_t revision = content.getTableRevision();
+    content.toggleFavoritesOnly();
+    EXPECT_EQ(titles(content.getMixRows()), (std::vector<std::string>{"Favorite"}));
+    EXPECT_GT(content.getTableRevision(), revision);
+}
+
+TEST(HelpContentTest, SearchKeepsRankUntilCleared) {
+    HelpContent content;
+    content.setMixes({makeMix("A", "Library", false)});
+
+    content.setSearchResults({});
+    EXPECT_TRUE(content.isSearching());
+    EXPECT_TRUE(content.getMixRows().empty());
+
+    content.setSearchResults({makeMix("Z", "Best match", false), makeMix("A", "Second match", true)});
+    EXPECT_EQ(titles(content.getMixRows()), (std::vector<std::string>{"Best match", "Second match"}));
+    EXPECT_EQ(content.getSearchResultCount(), 2u);
+
+    // A library reload while searching leaves the matches up
+    content.setMixes({makeMix("A", "Library", false), makeMix("B", "Reloaded", false)});
+    EXPECT_EQ(content.getMixRows().size(), 2u);
+    EXPECT_EQ(content.getMixRows()[0].title, "Best match");
+
+    content.clearSearch();
+    EXPECT_FALSE(content.isSearching());
+    EXPECT_EQ(titles(content.getMixRows()), (std::vector<std::string>{"Library", "Reloaded"}));
+}
+
+TEST(HelpContentTest, FormatDurationPadsSeconds) {
+    EXPECT_EQ(HelpContent::formatDuration(0), "0:00");
+    EXPECT_EQ(HelpContent::formatDuration(65), "1:05");
+    EXPECT_EQ(HelpContent::formatDuration(7199), "119:59");
+}
@@ -0,0 +1,62 @@
+#include "imgui_manager.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::UI::ImGuiManager;
+using AutoVibez::UI::OverlayLayer;
+
+namespace {
+class FakeLayer : public OverlayLayer {
+public:
+    bool active = false;
+    int polls = 0;
+    int draws = 0;
+
+    bool isActive() override {
+        ++polls;
+        return active;
+    }
+    void drawWidgets() override {
+        ++draws;
+    }
+};
+}  // namespace
+
+TEST(ImGuiManagerTest, IdleLayersSkipImGuiEntirely) {
+    FakeLayer help;
+    FakeLayer message;
+    ImGuiManager::addLayer(&help);
+    ImGuiManager::addLayer(&message);
+    ImGuiManager::addLayer(&help);  // Duplicate registration is ignored
+
+    EXPECT_FALSE(ImGuiManager::renderLayers());
+    EXPECT_EQ(help.polls, 1);
+    EXPECT_EQ(message.polls, 1);
+    EXPECT_EQ(help.draws + message.draws, 0);
+    EXPECT_FALSE(ImGuiManager::isReady());
+
+    ImGuiManager::removeLayer(&help);
+    ImGuiManager::removeLayer(&message);
+}
+
+TEST(ImGuiManagerTest, RemovedLayersAreNotPolled) {
+    FakeLayer layer;
+    ImGuiManager::addLayer(&layer);
+    ImGuiManager::removeLayer(&layer);
+
+    // Active, but unregistered: nothing to composite
+    layer.active = true;
+    EXPECT_FALSE(ImGuiManager::renderLayers());
+    EXPECT_EQ(layer.polls, 0);
+}
+
+TEST(ImGuiManagerTest, PrewarmNeedsARenderTarget) {
+    EXPECT_FALSE(ImGuiManager::prewarm());  // No layers registered
+
+    FakeLayer layer;
+    ImGuiManager::addLayer(&layer);
+    EXPECT_FALSE(ImGuiManager::prewarm());  // No window or context to build the atlas in
+    EXPECT_FALSE(ImGuiManager::isReady());
+    EXPECT_EQ(layer.polls, 0);
+    ImGuiManager::removeLayer(&layer);
+}
@@ -0,0 +1,69 @@
+#include "message_layout.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::UI::MessageLayout;
+
+namespace {
+// 10 pixels per character, 20 per line
+int measureCalls = 0;
+ImVec2 measure(const char* begin, const char* end) {
+    ++measureCalls;
+    return ImVec2(10.0f * static_cast<float>(end - begin), 20.0f);
+}
+
+std::string lineText(const MessageLayout& layout, size_t index) {
+    const MessageLayout::Line& line = layout.getLines()[index];
+    return layout.getText().substr(line.begin, line.end - line.begin);
+}
+}  // namespace
+
+TEST(MessageLayoutTest, CentresLinesSplitAtNewlines) {
+    MessageLayout layout;
+    layout.build("Now playing\nSong", 24.0f, 0.0f, measure);
+
+    ASSERT_EQ(layout.getLines().size(), 2u);
+    EXPECT_EQ(lineText(layout, 0), "Now playing");
+    EXPECT_EQ(lineText(layout, 1), "Song");
+    EXPECT_FLOAT_EQ(layout.getSize().x, 110.0f);
+    EXPECT_FLOAT_EQ(layout.getSize().y, 40.0f);
+    EXPECT_FLOAT_EQ(layout.getLines()[0].offset.x, 0.0f);
+    EXPECT_FLOAT_EQ(layout.getLines()[1].offset.x, 35.0f);
+    EXPECT_FLOAT_EQ(layout.getLines()[1].offset.y, 20.0f);
+}
+
+TEST(MessageLayoutTest, WrapsAtSpacesWithinMaxWidth) {
+    MessageLayout layout;
+    layout.build("aaa bbb ccc", 24.0f, 75.0f, measure);
+
+    ASSERT_EQ(layout.getLines().size(), 2u);
+    EXPECT_EQ(lineText(layout, 0), "aaa bbb");
+    EXPECT_EQ(lineText(layout, 1), "ccc");
+    EXPECT_FLOAT_EQ(layout.getSize().x, 70.0f);
+}
+
+TEST(MessageLayoutTest, OverlongWordKeepsItsOwnLine) {
+    MessageLayout layout;
+    layout.build("aaaaaaaaaa bb", 24.0f, 50.0f, measure);
+
+    ASSERT_EQ(layout.getLines().size(), 2u);
+    EXPECT_EQ(lineText(layout, 0), "aaaaaaaaaa");
+    EXPECT_EQ(lineText(layout, 1), "bb");
+}
+
+TEST(MessageLayoutTest, StaysCurrentUntilTextOrFontSizeChanges) {
+    MessageLayout layout;
+    EXPECT_FALSE(layout.isCurrent("", 24.0f, 0.0f));
+
+    measureCalls = 0;
+    layout.build("Hello", 24.0f, 0.0f, measure);
+    EXPECT_EQ(measureCalls, 1);
+    EXPECT_TRUE(layout.isCurrent("Hello", 24.0f, 0.0f));
+    EXPECT_FALSE(layout.isCurrent("Hello", 30.0f, 0.0f));
+    EXPECT_FALSE(layout.isCurrent("Hello!", 24.0f, 0.0f));
+    EXPECT_FALSE(layout.isCurrent("Hello", 24.0f, 100.0f));
+
+    layout.clear();
+    EXPECT_FALSE(layout.isCurrent("Hello", 24.0f, 0.0f));
+    EXPECT_TRUE(layout.getLines().empty());
+}
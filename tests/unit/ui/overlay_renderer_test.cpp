@@ -0,0 +1,55 @@
+#include "overlay_renderer.hpp"
+
+#include <gtest/gtest.h>
+
+using AutoVibez::UI::OverlayRenderer;
+
+namespace {
+// Apply the column-major matrix to (x, y, 0, 1)
+ImVec2 transform(const std::array<float, 16>& m, float x, float y) {
+    return ImVec2(m[0] * x + m[4] * y + m[12], m[1] * x + m[5] * y + m[13]);
+}
+}  // namespace
+
+TEST(OverlayRendererTest, ProjectionMapsDisplayCornersToClipSpace) {
+    const std::array<float, 16> m = OverlayRenderer::projection(ImVec2(0.0f, 0.0f), ImVec2(800.0f, 600.0f));
+
+    const ImVec2 topLeft = transform(m, 0.0f, 0.0f);
+    EXPECT_FLOAT_EQ(topLeft.x, -1.0f);
+    EXPECT_FLOAT_EQ(topLeft.y, 1.0f);
+    const ImVec2 bottomRight = transform(m, 800.0f, 600.0f);
+    EXPECT_FLOAT_EQ(bottomRight.x, 1.0f);
+    EXPECT_FLOAT_EQ(bottomRight.y, -1.0f);
+
+    // A display that does not start at the origin (secondary viewport) still fills clip space
+    const std::array<float, 16> offset = OverlayRenderer::projection(ImVec2(100.0f, 50.0f), ImVec2(200.0f, 100.0f));
+    const ImVec2 centre = transform(offset, 200.0f, 100.0f);
+    EXPECT_NEAR(centre.x, 0.0f, 1e-6f);
+    EXPECT_NEAR(centre.y, 0.0f, 1e-6f);
+}
+
+TEST(OverlayRendererTest, ScissorBoxFlipsAndScales) {
+    std::array<int, 4> box{};
+    ASSERT_TRUE(OverlayRenderer::scissorBox(ImVec4(10.0f, 20.0f, 110.0f, 70.0f), ImVec2(0.0f, 0.0f),
+                                            ImVec2(2.0f, 2.0f), 800, 600, box));
+    EXPECT_EQ(box, (std::array<int, 4>{20, 460, 200, 100}));
+}
+
+TEST(OverlayRendererTest, ScissorBoxClampsToTheFramebuffer) {
+    std::array<int, 4> box{};
+    ASSERT_TRUE(OverlayRenderer::scissorBox(ImVec4(-50.0f, -50.0f, 1000.0f, 1000.0f), ImVec2(0.0f, 0.0f),
+                                            ImVec2(1.0f, 1.0f), 800, 600, box));
+    EXPECT_EQ(box, (std::array<int, 4>{0, 0, 800, 600}));
+
+    EXPECT_FALSE(OverlayRenderer::scissorBox(ImVec4(900.0f, 0.0f, 950.0f, 10.0f), ImVec2(0.0f, 0.0f),
+                                             ImVec2(1.0f, 1.0f), 800, 600, box));
+    EXPECT_FALSE(OverlayRenderer::scissorBox(ImVec4(10.0f, 10.0f, 10.0f, 20.0f), ImVec2(0.0f, 0.0f),
+                                             ImVec2(1.0f, 1.0f), 800, 600, box));
+}
+
+TEST(OverlayRendererTest, CapacityGrowsGeometrically) {
+    EXPECT_EQ(OverlayRenderer::growCapacity(0, 1000), 1000u);
+    // A slightly bigger frame reserves room for the next few
+    EXPECT_EQ(OverlayRenderer::growCapacity(1000, 1100), 1500u);
+    EXPECT_EQ(OverlayRenderer::growCapacity(1000, 4000), 4000u);
+}
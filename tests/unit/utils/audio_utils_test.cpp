@@ -2,8 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <string>
 
 #include "utils/constants.hpp"
 
@@ -62,3 +64,28 @@ TEST(AudioUtilsTest, IsValidMP3File) {
     // Cleanup
     std::filesystem::remove_all(tempDir);
 }
+
+TEST(AudioUtilsTest, IsValidMP3Data) {
+    std::string data(Constants::MIN_MP3_FILE_SIZE, 'M');
+    const unsigned char frameHeader[4] = {0xFF, 0xFB, 0x90, 0x44};  // MPEG-1 Layer 3, 128kbps, 44.1kHz
+    std::copy(frameHeader, frameHeader + 4, data.begin() + 100);
+    auto bytes = reinterpret_cast<const unsigned char*>(data.data());
+
+    EXPECT_TRUE(AutoVibez::Utils::AudioUtils::isValidMP3Data(bytes, data.size()));
+
+    // Too short to be a mix
+    EXPECT_FALSE(AutoVibez::Utils::AudioUtils::isValidMP3Data(bytes, Constants::MIN_MP3_FILE_SIZE - 1));
+    EXPECT_FALSE(AutoVibez::Utils::AudioUtils::isValidMP3Data(nullptr, data.size()));
+
+    // An ID3 tag that claims to cover the frame header hides it
+    std::string tagged = data;
+    tagged[0] = 'I';
+    tagged[1] = 'D';
+    tagged[2] = '3';
+    tagged[6] = 0;
+    tagged[7] = 0;
+    tagged[8] = 1;  // 128-byte tag
+    tagged[9] = 0;
+    EXPECT_FALSE(AutoVibez::Utils::AudioUtils::isValidMP3Data(reinterpret_cast<const unsigned char*>(tagged.data()),
+                                                              tagged.size()));
+}
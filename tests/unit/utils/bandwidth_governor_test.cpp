@@ -0,0 +1,60 @@
+#include "bandwidth_governor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "constants.hpp"
+
+using AutoVibez::Utils::BandwidthGovernor;
+using namespace std::chrono_literals;
+
+TEST(BandwidthGovernorTest, WithoutACeilingEverythingIsGranted) {
+    BandwidthGovernor governor;
+    EXPECT_EQ(governor.getCeiling(), 0);
+    const auto now = BandwidthGovernor::Clock::now();
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(governor.tryConsume(1 << 20, now));
+    }
+    EXPECT_EQ(governor.timeUntilAvailable(now), 0ms);
+}
+
+TEST(BandwidthGovernorTest, DebtWaitsUntilTheBucketRefills) {
+    BandwidthGovernor governor;
+    governor.setCeiling(1000);  // The bucket holds 250 bytes
+    const auto now = BandwidthGovernor::Clock::now() + 1s;
+
+    EXPECT_TRUE(governor.tryConsume(1250, now));  // Granted on credit, 1000 bytes short
+    EXPECT_FALSE(governor.tryConsume(1, now));
+    EXPECT_EQ(governor.timeUntilAvailable(now), 1001ms);
+
+    EXPECT_FALSE(governor.tryConsume(1, now + 500ms));
+    EXPECT_TRUE(governor.tryConsume(1, now + 1001ms));
+}
+
+TEST(BandwidthGovernorTest, TheBucketHoldsOnlyTheBurst) {
+    BandwidthGovernor governor;
+    governor.setCeiling(1000);
+    const auto later = BandwidthGovernor::Clock::now() + 60s;
+
+    // A minute idle saves up no more than the burst
+    const int64_t burst = 1000 * Constants::BANDWIDTH_BURST_MS / 1000;
+    EXPECT_TRUE(governor.tryConsume(burst, later));
+    EXPECT_FALSE(governor.tryConsume(1, later));
+}
+
+TEST(BandwidthGovernorTest, ANewCeilingForgivesTheDebt) {
+    BandwidthGovernor governor;
+    governor.setCeiling(1000);
+    const auto now = BandwidthGovernor::Clock::now() + 1s;
+    EXPECT_TRUE(governor.tryConsume(100000, now));
+    EXPECT_FALSE(governor.tryConsume(1, now));
+
+    governor.setCeiling(0);
+    EXPECT_TRUE(governor.tryConsume(1, now));
+    governor.setCeiling(2000);
+    EXPECT_EQ(governor.getCeiling(), 2000);
+    EXPECT_TRUE(governor.tryConsume(1, now));
+    governor.setCeiling(-5);
+    EXPECT_EQ(governor.getCeiling(), 0);
+}
@@ -0,0 +1,84 @@
+#include "circuit_breaker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "constants.hpp"
+
+using AutoVibez::Utils::CircuitBreaker;
+using namespace std::chrono_literals;
+
+namespace {
+void failTimes(CircuitBreaker& breaker, const std::string& host, int times, CircuitBreaker::Clock::time_point now) {
+    for (int i = 0; i < times; ++i) {
+        ASSERT_TRUE(breaker.allow(host, now));
+        breaker.record(host, false, now);
+    }
+}
+}  // namespace
+
+TEST(CircuitBreakerTest, ARunOfFailuresTakesTheHostOut) {
+    CircuitBreaker breaker;
+    const auto now = CircuitBreaker::Clock::now();
+    failTimes(breaker, "down.example.com", Constants::HOST_BREAKER_FAILURES - 1, now);
+    EXPECT_FALSE(breaker.isOpen("down.example.com", now));
+
+    breaker.record("down.example.com", false, now);
+    EXPECT_TRUE(breaker.isOpen("down.example.com", now));
+    EXPECT_FALSE(breaker.allow("down.example.com", now));
+    EXPECT_TRUE(breaker.allow("up.example.com", now));  // Other hosts go on as before
+    EXPECT_EQ(breaker.getOpenCount(now), 1u);
+}
+
+TEST(CircuitBreakerTest, ASuccessInBetweenResetsTheRun) {
+    CircuitBreaker breaker;
+    const auto now = CircuitBreaker::Clock::now();
+    failTimes(breaker, "flaky.example.com", Constants::HOST_BREAKER_FAILURES - 1, now);
+    breaker.record("flaky.example.com", true, now);
+    failTimes(breaker, "flaky.example.com", Constants::HOST_BREAKER_FAILURES - 1, now);
+    EXPECT_FALSE(breaker.isOpen("flaky.example.com", now));
+}
+
+TEST(CircuitBreakerTest, OneProbeAfterTheWaitDecides) {
+    CircuitBreaker breaker;
+    const auto start = CircuitBreaker::Clock::now();
+    failTimes(breaker, "down.example.com", Constants::HOST_BREAKER_FAILURES, start);
+
+    const auto open = std::chrono::seconds(Constants::HOST_BREAKER_OPEN_SECONDS);
+    const auto retry = start + open;
+    EXPECT_TRUE(breaker.allow("down.example.com", retry));
+    EXPECT_FALSE(breaker.allow("down.example.com", retry));  // The rest wait on the probe
+
+    // A failed probe doubles the wait
+    breaker.record("down.example.com", false, retry);
+    EXPECT_FALSE(breaker.allow("down.example.com", retry + open));
+    EXPECT_TRUE(breaker.allow("down.example.com", retry + open * 2));
+    breaker.record("down.example.com", true, retry + open * 2);
+    EXPECT_FALSE(breaker.isOpen("down.example.com", retry + open * 2));
+    EXPECT_EQ(breaker.getOpenCount(retry + open * 2), 0u);
+}
+
+TEST(CircuitBreakerTest, AReleasedProbeLetsTheNextOneThrough) {
+    CircuitBreaker breaker;
+    const auto start = CircuitBreaker::Clock::now();
+    failTimes(breaker, "down.example.com", Constants::HOST_BREAKER_FAILURES, start);
+    const auto retry = start + std::chrono::seconds(Constants::HOST_BREAKER_OPEN_SECONDS);
+    ASSERT_TRUE(breaker.allow("down.example.com", retry));
+    breaker.release("down.example.com");
+    EXPECT_TRUE(breaker.allow("down.example.com", retry));
+}
+
+TEST(CircuitBreakerTest, TheWaitIsCapped) {
+    CircuitBreaker breaker;
+    auto now = CircuitBreaker::Clock::now();
+    failTimes(breaker, "gone.example.com", Constants::HOST_BREAKER_FAILURES, now);
+    for (int probe = 0; probe < 20; ++probe) {
+        now += std::chrono::seconds(Constants::HOST_BREAKER_MAX_OPEN_SECONDS);
+        ASSERT_TRUE(breaker.allow("gone.example.com", now));
+        breaker.record("gone.example.com", false, now);
+    }
+    const auto longest = std::chrono::seconds(Constants::HOST_BREAKER_MAX_OPEN_SECONDS);
+    EXPECT_TRUE(breaker.isOpen("gone.example.com", now + longest - 1s));
+    EXPECT_FALSE(breaker.isOpen("gone.example.com", now + longest));
+}
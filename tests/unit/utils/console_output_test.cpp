@@ -15,18 +15,21 @@ protected:
         originalCout = std::cout.rdbuf();
         std::cout.rdbuf(testOutput.rdbuf());
 
-        // Reset static state
+        // Reset static state; output is rendered text as on a terminal
+        ConsoleSink::instance().setFormat(ConsoleFormat::Text);
         ConsoleOutput::enableColors(true);
         ConsoleOutput::enableEmojis(true);
         ConsoleOutput::setVerbose(true);
     }
 
     void TearDown() override {
-        // Restore cout
+        // Restore cout once the sink has written everything into the capture
+        ConsoleSink::instance().flush();
         std::cout.rdbuf(originalCout);
     }
 
     std::string getOutput() {
+        ConsoleSink::instance().flush();
         std::string output = testOutput.str();
         testOutput.str("");
         testOutput.clear();
@@ -185,3 +188,17 @@ TEST_F(ConsoleOutputTest, ConsoleFactoryFunctions) {
     // Test passes if no exception is thrown
     SUCCEED();
 }
+
+TEST_F(ConsoleOutputTest, JsonLinesWhenNotATerminal) {
+    ConsoleSink::instance().setFormat(ConsoleFormat::Json);
+    ConsoleOutput::warning("Disk \"low\"");
+    ConsoleOutput::mixInfo("Artist Name", "Song Title", "Electronic");
+    const std::string output = getOutput();
+
+    EXPECT_THAT(output,
+                HasSubstr("\"level\":\"warning\",\"category\":\"general\",\"message\":\"Disk \\\"low\\\"\"}\n"));
+    EXPECT_THAT(output,
+                HasSubstr("\"category\":\"mix\",\"message\":\"Now Playing: Artist Name - Song Title [Electronic]\""));
+    EXPECT_THAT(output, Not(HasSubstr(Symbols::WARNING)));
+    EXPECT_THAT(output, Not(HasSubstr("\033[")));
+}
@@ -0,0 +1,81 @@
+#include "utils/console_sink.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using AutoVibez::Utils::ConsoleCategory;
+using AutoVibez::Utils::ConsoleFormat;
+using AutoVibez::Utils::ConsoleSink;
+
+namespace {
+
+size_t countLines(const std::string& text) {
+    size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n' ? 1 : 0;
+    }
+    return lines;
+}
+
+}  // namespace
+
+TEST(ConsoleSinkTest, BatchesLinesUntilFlushed) {
+    std::ostringstream out;
+    ConsoleSink sink(ConsoleFormat::Text, out);
+    sink.write("first\n");
+    sink.write("second\n");
+    sink.flush();
+    EXPECT_EQ(out.str(), "first\nsecond\n");
+}
+
+TEST(ConsoleSinkTest, DestructorWritesWhatIsLeft) {
+    std::ostringstream out;
+    {
+        ConsoleSink sink(ConsoleFormat::Text, out);
+        sink.write("written on shutdown\n");
+    }
+    EXPECT_EQ(out.str(), "written on shutdown\n");
+}
+
+TEST(ConsoleSinkTest, JsonLinesCarryLevelCategoryAndAPlainMessage) {
+    std::ostringstream out;
+    ConsoleSink sink(ConsoleFormat::Json, out);
+    sink.writeJson("warning", ConsoleCategory::Download, "\033[93mslow \"mirror\"\033[0m\n");
+    sink.flush();
+
+    const std::string line = out.str();
+    EXPECT_EQ(line.rfind("{\"time_ms\":", 0), 0u);
+    EXPECT_NE(line.find(",\"level\":\"warning\",\"category\":\"download\",\"message\":\"slow \\\"mirror\\\"\\n\"}\n"),
+              std::string::npos)
+        << line;
+    EXPECT_EQ(countLines(line), 1u);
+}
+
+TEST(ConsoleSinkTest, RepetitiveCategoriesAreRateLimitedAndSummed) {
+    std::ostringstream out;
+    ConsoleSink sink(ConsoleFormat::Text, out);
+    const auto start = ConsoleSink::Clock::now();
+    const int limit = Constants::CONSOLE_RATE_LIMIT_LINES;
+
+    int admitted = 0;
+    for (int i = 0; i < limit + 6; ++i) {
+        admitted += sink.admit(ConsoleCategory::Preset, start) ? 1 : 0;
+    }
+    EXPECT_EQ(admitted, limit);
+    EXPECT_EQ(sink.getSuppressedCount(), 6u);
+
+    // Other categories have their own window; general lines are never limited
+    EXPECT_TRUE(sink.admit(ConsoleCategory::Download, start));
+    for (int i = 0; i < 3 * limit; ++i) {
+        EXPECT_TRUE(sink.admit(ConsoleCategory::General, start));
+    }
+
+    // The next window opens with a summary of the last one
+    const auto later = start + std::chrono::milliseconds(Constants::CONSOLE_RATE_WINDOW_MS);
+    EXPECT_TRUE(sink.admit(ConsoleCategory::Preset, later));
+    sink.flush();
+    EXPECT_EQ(out.str(), "(6 preset lines suppressed)\n");
+}
@@ -0,0 +1,55 @@
+#include "utils/content_hash.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using AutoVibez::Utils::ContentHasher;
+
+TEST(ContentHasherTest, MatchesTheXxh64ReferenceValues) {
+    EXPECT_EQ(ContentHasher::hash("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(ContentHasher::hash("abc", 3), 0x44BC2CF5AD770999ULL);
+    const std::string sentence = "Nobody inspects the spammish repetition";
+    EXPECT_EQ(ContentHasher::hash(sentence.data(), sentence.size()), 0xFBCEA83C8A378BF1ULL);
+
+    ContentHasher hasher;
+    hasher.update("abc", 3);
+    EXPECT_EQ(hasher.hexDigest(), "44bc2cf5ad770999");
+    EXPECT_EQ(hasher.getLength(), 3u);
+}
+
+TEST(ContentHasherTest, AnySplitOfTheBytesGivesTheSameDigest) {
+    std::string data(10000, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 31 + i / 7);
+    }
+    const uint64_t whole = ContentHasher::hash(data.data(), data.size());
+
+    for (size_t chunk : {1u, 3u, 31u, 32u, 33u, 4095u}) {
+        ContentHasher hasher;
+        for (size_t offset = 0; offset < data.size(); offset += chunk) {
+            hasher.update(data.data() + offset, std::min(chunk, data.size() - offset));
+        }
+        EXPECT_EQ(hasher.digest(), whole) << "chunk " << chunk;
+    }
+    EXPECT_NE(ContentHasher::hash(data.data(), data.size() - 1), whole);
+    EXPECT_NE(ContentHasher::hash(data.data(), data.size(), 1), whole);
+}
+
+TEST(ContentHasherTest, HashesFilesOnDisk) {
+    const auto path = std::filesystem::temp_directory_path() / "autovibez_content_hash_test.bin";
+    const std::string data(3 * 1024 * 1024 + 5, 'q');
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << data;
+    }
+    ContentHasher hasher;
+    hasher.update(data.data(), data.size());
+    EXPECT_EQ(ContentHasher::hashFile(path.string()), hasher.hexDigest());
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(ContentHasher::hashFile(path.string()), "");
+}
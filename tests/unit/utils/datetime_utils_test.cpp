@@ -64,3 +64,15 @@ TEST(DateTimeUtilsTest, IsValidDateTime) {
     EXPECT_TRUE(
         AutoVibez::Utils::DateTimeUtils::isValidDateTime("2024-01-15 25:30:25"));  // Invalid hour but correct format
 }
+
+TEST(DateTimeUtilsTest, EpochMillisecondsFormatForDisplay) {
+    const int64_t now = AutoVibez::Utils::DateTimeUtils::nowEpochMs();
+    EXPECT_GT(now, int64_t{1700000000000});  // After November 2023
+
+    // Shown the way any other time point is
+    const std::string formatted = AutoVibez::Utils::DateTimeUtils::formatEpochMs(now);
+    EXPECT_TRUE(AutoVibez::Utils::DateTimeUtils::isValidDateTime(formatted));
+    const std::chrono::system_clock::time_point point{std::chrono::milliseconds(now)};
+    EXPECT_EQ(formatted, AutoVibez::Utils::DateTimeUtils::formatDateTime(point));
+    EXPECT_TRUE(AutoVibez::Utils::DateTimeUtils::formatEpochMs(0).empty());
+}
@@ -0,0 +1,98 @@
+#include "utils/download_writer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "utils/constants.hpp"
+
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
+
+using AutoVibez::Utils::DownloadWriter;
+
+class DownloadWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() / "autovibez_download_writer_test.part";
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::string contents() const {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream read;
+        read << file.rdbuf();
+        return read.str();
+    }
+
+    std::filesystem::path path;
+};
+
+TEST_F(DownloadWriterTest, CollectsChunksUntilTheFlushSize) {
+    FILE* file = std::fopen(path.string().c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    DownloadWriter writer(file, 0);
+
+    const std::string chunk(16 * 1024, 'a');
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(writer.write(chunk.data(), chunk.size(), 64 * 1024));
+    }
+    EXPECT_EQ(writer.getFlushedBytes(), 0);
+    EXPECT_EQ(std::filesystem::file_size(path), 0u);
+
+    ASSERT_TRUE(writer.write(chunk.data(), chunk.size(), 64 * 1024));
+    EXPECT_EQ(writer.getFlushedBytes(), 64 * 1024);
+    EXPECT_EQ(std::filesystem::file_size(path), 64u * 1024);
+
+    // A flush size of 0 writes straight through
+    ASSERT_TRUE(writer.write("xyz", 3, 0));
+    EXPECT_EQ(writer.getFlushedBytes(), 64 * 1024 + 3);
+    ASSERT_TRUE(writer.write("tail", 4, 64 * 1024));
+    ASSERT_TRUE(writer.flush());
+    std::fclose(file);
+    EXPECT_EQ(contents(), std::string(64 * 1024, 'a') + "xyztail");
+}
+
+TEST_F(DownloadWriterTest, ChunksLargerThanTheBufferGoStraightThrough) {
+    std::ofstream(path, std::ios::binary) << "resumed:";
+    FILE* file = std::fopen(path.string().c_str(), "ab");
+    ASSERT_NE(file, nullptr);
+    DownloadWriter writer(file, 8);
+    writer.setDropCache(true);
+
+    const std::string small(1000, 's');
+    const std::string large(Constants::DOWNLOAD_WRITE_BUFFER_BYTES + 1, 'L');
+    ASSERT_TRUE(writer.write(small.data(), small.size(), Constants::DOWNLOAD_WRITE_BUFFER_BYTES));
+    ASSERT_TRUE(writer.write(large.data(), large.size(), Constants::DOWNLOAD_WRITE_BUFFER_BYTES));
+    EXPECT_EQ(writer.getFlushedBytes(), static_cast<int64_t>(8 + small.size() + large.size()));
+    std::fclose(file);
+    EXPECT_EQ(contents(), "resumed:" + small + large);
+}
+
+TEST_F(DownloadWriterTest, ReservingKeepsTheFileSize) {
+    FILE* file = std::fopen(path.string().c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    DownloadWriter writer(file, 0);
+    writer.reserve(8 * 1024 * 1024);
+    ASSERT_TRUE(writer.write("abc", 3, 0));
+    std::fclose(file);
+
+    // A partial file's size must still say how much of it arrived
+    EXPECT_EQ(std::filesystem::file_size(path), 3u);
+#ifdef __linux__
+    struct stat info {};
+    ASSERT_EQ(stat(path.string().c_str(), &info), 0);
+    if (info.st_blocks > 8) {
+        EXPECT_GE(info.st_blocks * 512, 8 * 1024 * 1024);  // Only where the file system supports it
+    }
+#endif
+}
@@ -112,3 +112,47 @@ TEST_F(JsonUtilsTest, VectorToJsonArrayWithEmptyStrings) {
     std::string result = JsonUtils::vectorToJsonArray(tags);
     EXPECT_EQ(result, "[\"\",\"electronic\",\"\"]");
 }
+
+TEST_F(JsonUtilsTest, RoundTripKeepsEveryEscape) {
+    std::vector<std::string> original = {"tab\there", "line\nbreak", "back\\slash", "bell\x07", "\"quoted\"", "end\\"};
+    std::string json = JsonUtils::vectorToJsonArray(original);
+    EXPECT_NE(json.find("\\u0007"), std::string::npos);
+    EXPECT_EQ(JsonUtils::jsonArrayToVector(json), original);
+}
+
+TEST_F(JsonUtilsTest, ParseJsonArrayViewsPlainTagsInPlace) {
+    const std::string json = "[\"house\",\"say \\\"hi\\\"\",\"techno\"]";
+    std::vector<std::string_view> tags;
+    std::string arena;
+    JsonUtils::parseJsonArray(json, tags, arena);
+    ASSERT_EQ(tags.size(), 3u);
+    EXPECT_EQ(tags[0], "house");
+    EXPECT_EQ(tags[1], "say \"hi\"");
+    EXPECT_EQ(tags[2], "techno");
+
+    // Only the escaped tag went through the arena
+    EXPECT_EQ(tags[0].data(), json.data() + 2);
+    EXPECT_EQ(tags[1].data(), arena.data());
+    EXPECT_EQ(tags[2].data(), json.data() + json.size() - 8);
+}
+
+TEST_F(JsonUtilsTest, ParseJsonArrayDecodesUnicodeEscapes) {
+    std::vector<std::string_view> tags;
+    std::string arena;
+    JsonUtils::parseJsonArray("[\"caf\\u00e9\",\"\\ud83c\\udfb5\",\"bad \\uzzzz\"]", tags, arena);
+    ASSERT_EQ(tags.size(), 3u);
+    EXPECT_EQ(tags[0], "caf\xc3\xa9");
+    EXPECT_EQ(tags[1], "\xf0\x9f\x8e\xb5");
+    EXPECT_EQ(tags[2], "bad \\uzzzz");
+}
+
+TEST_F(JsonUtilsTest, ParseJsonArraySkipsUnterminatedStrings) {
+    std::vector<std::string_view> tags;
+    std::string arena;
+    JsonUtils::parseJsonArray("[\"house\",\"cut off", tags, arena);
+    ASSERT_EQ(tags.size(), 1u);
+    EXPECT_EQ(tags[0], "house");
+
+    JsonUtils::parseJsonArray("[\"ends in \\\"]", tags, arena);
+    EXPECT_TRUE(tags.empty());
+}
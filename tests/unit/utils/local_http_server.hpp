@@ -0,0 +1,219 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Keep-alive HTTP/1.1 server on 127.0.0.1 for transfer tests
+ *
+ * Every GET gets the same body with an ETag. "Range: bytes=N-" and "bytes=N-M" are
+ * honoured with a 206 unless an If-Range does not match the ETag, in which case the
+ * whole body comes back as a 200, as a real server would after the file changed. A
+ * silent server accepts connections and never answers. A matching If-None-Match gets
+ * a 304 without a body.
+ */
+class LocalHttpServer {
+public:
+    explicit LocalHttpServer(std::string body = "hello", bool respond = true)
+        : body_(std::move(body)), respond_(respond) {
+        listener_ = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        listen(listener_, 8);
+        socklen_t length = sizeof(address);
+        getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        thread_ = std::thread(&LocalHttpServer::run, this);
+    }
+
+    ~LocalHttpServer() {
+        stopping_ = true;
+        thread_.join();
+        for (const Client& client : clients_) {
+            close(client.fd);
+        }
+        close(listener_);
+    }
+
+    LocalHttpServer(const LocalHttpServer&) = delete;
+    LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    int connections() const {
+        return connections_;
+    }
+
+    /**
+     * @brief Serve another file from now on, e.g. to act as if it changed on the server
+     */
+    void setBody(const std::string& body, const std::string& etag) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = body;
+        etag_ = etag;
+    }
+
+    /**
+     * @brief Answer Range requests with the whole body, like a server without range support
+     */
+    void setRangesSupported(bool supported) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ranges_ = supported;
+    }
+
+    /**
+     * @brief Close the connection after this many body bytes of the next response
+     */
+    void dropNextResponseAfter(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drop_after_ = bytes;
+    }
+
+    /**
+     * @brief Headers of the last request, as received
+     */
+    std::string lastRequest() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_request_;
+    }
+
+private:
+    struct Client {
+        int fd;
+        std::string pending;
+    };
+
+    void run() {
+        while (!stopping_) {
+            std::vector<pollfd> fds{{listener_, POLLIN, 0}};
+            for (const Client& client : clients_) {
+                fds.push_back({client.fd, POLLIN, 0});
+            }
+            if (poll(fds.data(), fds.size(), 20) <= 0) {
+                continue;
+            }
+            for (size_t i = fds.size() - 1; i >= 1; --i) {
+                if (fds[i].revents & (POLLIN | POLLHUP)) {
+                    serve(i - 1);
+                }
+            }
+            if (fds[0].revents & POLLIN) {
+                clients_.push_back({accept(listener_, nullptr, nullptr), std::string()});
+                connections_++;
+            }
+        }
+    }
+
+    void serve(size_t index) {
+        Client& client = clients_[index];
+        char buffer[4096];
+        const ssize_t got = read(client.fd, buffer, sizeof(buffer));
+        if (got <= 0) {
+            close(client.fd);
+            clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(index));
+            return;
+        }
+        client.pending.append(buffer, static_cast<size_t>(got));
+
+        size_t end = 0;
+        while (respond_ && (end = client.pending.find("\r\n\r\n")) != std::string::npos) {
+            const std::string request = client.pending.substr(0, end + 4);
+            client.pending.erase(0, end + 4);
+            if (!respond(client.fd, request)) {
+                close(client.fd);
+                clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(index));
+                return;
+            }
+        }
+    }
+
+    // False when the connection was dropped mid-body
+    bool respond(int fd, const std::string& request) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_request_ = request;
+
+        const size_t if_none_match = request.find("If-None-Match: ");
+        if (if_none_match != std::string::npos && request.compare(if_none_match + 15, etag_.size(), etag_) == 0) {
+            writeAll(fd, "HTTP/1.1 304 Not Modified\r\nETag: " + etag_ + "\r\n\r\n");
+            return true;
+        }
+
+        size_t first = 0;
+        size_t last = body_.size() - 1;
+        bool partial = false;
+        const size_t range = request.find("Range: bytes=");
+        const size_t if_range = request.find("If-Range: ");
+        const bool validator_matches =
+            if_range == std::string::npos || request.compare(if_range + 10, etag_.size(), etag_) == 0;
+        if (ranges_ && range != std::string::npos && validator_matches) {
+            first = std::stoul(request.substr(range + 13));
+            const size_t dash = request.find('-', range + 13);
+            if (std::isdigit(static_cast<unsigned char>(request[dash + 1]))) {
+                last = std::min<size_t>(std::stoul(request.substr(dash + 1)), last);
+            }
+            partial = true;
+        }
+
+        std::string head;
+        if (partial) {
+            head = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + std::to_string(first) + "-" +
+                   std::to_string(last) + "/" + std::to_string(body_.size()) + "\r\n";
+        } else {
+            head = ranges_ ? "HTTP/1.1 200 OK\r\nAccept-Ranges: bytes\r\n" : "HTTP/1.1 200 OK\r\n";
+        }
+        const std::string content = body_.substr(first, last - first + 1);
+        head += "ETag: " + etag_ + "\r\nContent-Length: " + std::to_string(content.size()) + "\r\n\r\n";
+        writeAll(fd, head);
+
+        if (drop_after_ > 0 && drop_after_ < content.size()) {
+            writeAll(fd, content.substr(0, drop_after_));
+            drop_after_ = 0;
+            return false;
+        }
+        writeAll(fd, content);
+        return true;
+    }
+
+    static void writeAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t wrote = write(fd, data.data() + sent, data.size() - sent);
+            if (wrote <= 0) {
+                return;
+            }
+            sent += static_cast<size_t>(wrote);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::string body_;
+    std::string etag_ = "\"v1\"";
+    std::string last_request_;
+    size_t drop_after_ = 0;
+    bool ranges_ = true;
+    bool respond_;
+    int listener_ = -1;
+    int port_ = 0;
+    std::vector<Client> clients_;
+    std::atomic<int> connections_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
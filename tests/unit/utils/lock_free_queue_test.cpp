@@ -0,0 +1,85 @@
+#include "lock_free_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using AutoVibez::Utils::LockFreeQueue;
+
+TEST(LockFreeQueueTest, KeepsOrderAndRejectsWhenFull) {
+    LockFreeQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(99));
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+
+    // Positions wrap around the ring
+    EXPECT_TRUE(queue.tryPush(7));
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 7);
+}
+
+TEST(LockFreeQueueTest, RejectedPushLeavesTheValue) {
+    LockFreeQueue<std::unique_ptr<int>> queue(2);
+    EXPECT_TRUE(queue.tryPush(std::make_unique<int>(1)));
+    EXPECT_TRUE(queue.tryPush(std::make_unique<int>(2)));
+
+    auto kept = std::make_unique<int>(3);
+    EXPECT_FALSE(queue.tryPush(kept));
+    ASSERT_NE(kept, nullptr);
+    EXPECT_EQ(*kept, 3);
+}
+
+TEST(LockFreeQueueTest, ManyProducersLoseNothing) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    LockFreeQueue<int> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                int value = p * PER_PRODUCER + i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> lastSeen(PRODUCERS, -1);
+    int received = 0;
+    bool ordered = true;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        int value = 0;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Each producer's values arrive in the order it pushed them
+        const int producer = value / PER_PRODUCER;
+        ordered = ordered && value % PER_PRODUCER > lastSeen[producer];
+        lastSeen[producer] = value % PER_PRODUCER;
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_TRUE(ordered);
+    for (int last : lastSeen) {
+        EXPECT_EQ(last, PER_PRODUCER - 1);
+    }
+}
@@ -0,0 +1,97 @@
+#include "utils/log_sink.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using AutoVibez::Utils::LogSink;
+
+class LogSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const std::string test = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        directory_ = std::filesystem::temp_directory_path() / ("autovibez_log_sink_" + test);
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+        path_ = (directory_ / "test.log").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    static std::string read(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    static void push(LogSink& sink, const std::string& text, bool urgent = false) {
+        sink.push("INFO", text.data(), text.size(), urgent);
+    }
+
+    std::filesystem::path directory_;
+    std::string path_;
+};
+
+TEST_F(LogSinkTest, FlushWritesQueuedMessages) {
+    LogSink sink(path_);
+    push(sink, "first message");
+    push(sink, "second message");
+    sink.flush();
+
+    const std::string content = read(path_);
+    EXPECT_NE(content.find("INFO: Logger initialized"), std::string::npos);
+    EXPECT_NE(content.find("] INFO: first message\n"), std::string::npos);
+    EXPECT_LT(content.find("first message"), content.find("second message"));
+}
+
+TEST_F(LogSinkTest, DestructorWritesWhatIsLeft) {
+    {
+        LogSink sink(path_);
+        push(sink, "written on shutdown");
+    }
+    EXPECT_NE(read(path_).find("written on shutdown"), std::string::npos);
+}
+
+TEST_F(LogSinkTest, LongMessagesAreCut) {
+    LogSink sink(path_);
+    push(sink, std::string(2 * Constants::LOG_RECORD_TEXT_BYTES, 'A'));
+    sink.flush();
+
+    const std::string content = read(path_);
+    EXPECT_NE(content.find(std::string(Constants::LOG_RECORD_TEXT_BYTES, 'A') + "...\n"),
+              std::string::npos);
+    EXPECT_EQ(content.find(std::string(Constants::LOG_RECORD_TEXT_BYTES + 1, 'A')), std::string::npos);
+}
+
+TEST_F(LogSinkTest, FullFileIsRotated) {
+    LogSink sink(path_, 512, 2);
+    for (int batch = 0; batch < 4; ++batch) {
+        push(sink, "batch " + std::to_string(batch) + " " + std::string(400, 'x'));
+        sink.flush();
+    }
+
+    EXPECT_GE(sink.getRotationCount(), 2u);
+    EXPECT_NE(read(path_).find("batch 3"), std::string::npos);
+    EXPECT_NE(read(path_ + ".1").find("batch 2"), std::string::npos);
+    EXPECT_TRUE(std::filesystem::exists(path_ + ".2"));
+    EXPECT_FALSE(std::filesystem::exists(path_ + ".3"));
+}
+
+TEST_F(LogSinkTest, FullQueueDropsAndReports) {
+    LogSink sink(path_, 0, 0, 4);
+    int accepted = 0;
+    for (int i = 0; i < 64; ++i) {
+        accepted += sink.push("INFO", "burst", 5) ? 1 : 0;
+    }
+    EXPECT_EQ(static_cast<uint64_t>(64 - accepted), sink.getDroppedCount());
+    EXPECT_GT(sink.getDroppedCount(), 0u);
+
+    sink.flush();
+    EXPECT_NE(read(path_).find("log messages dropped (queue full)"), std::string::npos);
+}
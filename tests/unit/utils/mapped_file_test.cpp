@@ -0,0 +1,82 @@
+#include "utils/mapped_file.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using AutoVibez::Utils::MappedFile;
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_path = (std::filesystem::temp_directory_path() / "autovibez_mapped_file_test.bin").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(test_path);
+    }
+
+    void writeFile(const std::string& content) {
+        std::ofstream file(test_path, std::ios::binary);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    std::string test_path;
+};
+
+TEST_F(MappedFileTest, MapsWholeFile) {
+    std::string content(10000, 'x');
+    content[0] = 'A';
+    content[9999] = 'Z';
+    writeFile(content);
+
+    MappedFile mapping;
+    ASSERT_TRUE(mapping.open(test_path));
+    EXPECT_TRUE(mapping.isOpen());
+    EXPECT_EQ(mapping.size(), content.size());
+    EXPECT_EQ(mapping.data()[0], 'A');
+    EXPECT_EQ(mapping.data()[9999], 'Z');
+    EXPECT_EQ(mapping.getPath(), test_path);
+}
+
+TEST_F(MappedFileTest, MissingFileFails) {
+    MappedFile mapping;
+    EXPECT_FALSE(mapping.open("/nonexistent/autovibez/file.mp3"));
+    EXPECT_FALSE(mapping.isOpen());
+    EXPECT_FALSE(mapping.getLastError().empty());
+}
+
+TEST_F(MappedFileTest, EmptyFileFails) {
+    writeFile("");
+
+    MappedFile mapping;
+    EXPECT_FALSE(mapping.open(test_path));
+    EXPECT_EQ(mapping.size(), 0u);
+}
+
+TEST_F(MappedFileTest, CloseReleasesMapping) {
+    writeFile("some bytes");
+
+    MappedFile mapping;
+    ASSERT_TRUE(mapping.open(test_path));
+    mapping.close();
+    EXPECT_FALSE(mapping.isOpen());
+    EXPECT_EQ(mapping.data(), nullptr);
+    EXPECT_EQ(mapping.size(), 0u);
+}
+
+TEST_F(MappedFileTest, PrefetchClampsToFile) {
+    writeFile(std::string(5000, 'p'));
+
+    MappedFile mapping;
+    ASSERT_TRUE(mapping.open(test_path));
+    // Out-of-range and oversized hints are ignored or clamped rather than faulting
+    mapping.prefetch(4000, 1 << 20);
+    mapping.prefetch(6000, 100);
+    EXPECT_EQ(mapping.data()[4999], 'p');
+
+    MappedFile closed;
+    closed.prefetch(0, 100);
+}
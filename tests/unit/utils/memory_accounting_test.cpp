@@ -0,0 +1,136 @@
+#include "utils/memory_accounting.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "audio/pcm_ring_buffer.hpp"
+#include "data/mix_catalog.hpp"
+
+using AutoVibez::Audio::PcmRingBuffer;
+using AutoVibez::Data::Mix;
+using AutoVibez::Data::MixCatalog;
+using AutoVibez::Utils::MemoryAccounting;
+using AutoVibez::Utils::MemoryCharge;
+using AutoVibez::Utils::MemoryTag;
+using AutoVibez::Utils::ProcessMemory;
+using AutoVibez::Utils::TaggedAllocator;
+
+namespace {
+int64_t bytesOf(MemoryTag tag) {
+    return MemoryAccounting::get(tag).bytes;
+}
+
+std::vector<Mix> makeMixes(int count) {
+    std::vector<Mix> mixes;
+    for (int i = 0; i < count; ++i) {
+        Mix mix;
+        mix.id = "mix-id-" + std::to_string(i);
+        mix.title = "A reasonably long mix title " + std::to_string(i);
+        mix.artist = "Artist " + std::to_string(i % 50);
+        mix.genre = i % 2 ? "Techno" : "House";
+        mix.url = "https://example.com/mixes/mix-" + std::to_string(i) + ".mp3";
+        mix.tags = {"live", "radio"};
+        mixes.push_back(mix);
+    }
+    return mixes;
+}
+}  // namespace
+
+TEST(MemoryAccountingTest, ChargesFollowTheirOwners) {
+    const int64_t before = bytesOf(MemoryTag::Manifest);
+    {
+        MemoryCharge charge(MemoryTag::Manifest, 1000);
+        EXPECT_EQ(bytesOf(MemoryTag::Manifest), before + 1000);
+        charge.set(400);
+        EXPECT_EQ(bytesOf(MemoryTag::Manifest), before + 400);
+
+        MemoryCharge moved(std::move(charge));
+        EXPECT_EQ(moved.bytes(), 400u);
+        EXPECT_EQ(charge.bytes(), 0u);
+        EXPECT_EQ(bytesOf(MemoryTag::Manifest), before + 400);
+
+        MemoryCharge other(MemoryTag::Manifest, 50);
+        other = std::move(moved);
+        EXPECT_EQ(bytesOf(MemoryTag::Manifest), before + 400);
+    }
+    EXPECT_EQ(bytesOf(MemoryTag::Manifest), before);
+}
+
+TEST(MemoryAccountingTest, PeaksHoldUntilReset) {
+    const int64_t before = bytesOf(MemoryTag::GpuTextures);
+    {
+        MemoryCharge charge(MemoryTag::GpuTextures, 4096);
+    }
+    EXPECT_EQ(bytesOf(MemoryTag::GpuTextures), before);
+    EXPECT_GE(MemoryAccounting::get(MemoryTag::GpuTextures).peak_bytes, before + 4096);
+
+    MemoryAccounting::resetPeaks();
+    EXPECT_EQ(MemoryAccounting::get(MemoryTag::GpuTextures).peak_bytes, before);
+}
+
+TEST(MemoryAccountingTest, TaggedAllocatorCountsCapacity) {
+    const int64_t before = bytesOf(MemoryTag::DownloadBuffers);
+    {
+        std::vector<char, TaggedAllocator<char, MemoryTag::DownloadBuffers>> buffer;
+        buffer.reserve(65536);
+        EXPECT_EQ(bytesOf(MemoryTag::DownloadBuffers), before + 65536);
+        buffer.clear();  // Capacity is kept, and so is the charge
+        EXPECT_EQ(bytesOf(MemoryTag::DownloadBuffers), before + 65536);
+    }
+    EXPECT_EQ(bytesOf(MemoryTag::DownloadBuffers), before);
+}
+
+TEST(MemoryAccountingTest, GpuTagsStayOutOfTheHostTotal) {
+    const int64_t tracked = MemoryAccounting::getTrackedBytes();
+    MemoryCharge texture(MemoryTag::GpuRenderTargets, 8 * 1024 * 1024);
+    EXPECT_EQ(MemoryAccounting::getTrackedBytes(), tracked);
+    MemoryCharge manifest(MemoryTag::Manifest, 1024);
+    EXPECT_EQ(MemoryAccounting::getTrackedBytes(), tracked + 1024);
+}
+
+TEST(MemoryAccountingTest, PcmRingChargesItsStorage) {
+    const int64_t before = bytesOf(MemoryTag::PcmBuffers);
+    {
+        PcmRingBuffer ring(1000);
+        EXPECT_EQ(bytesOf(MemoryTag::PcmBuffers), before + static_cast<int64_t>(ring.capacity() * sizeof(float)));
+    }
+    EXPECT_EQ(bytesOf(MemoryTag::PcmBuffers), before);
+}
+
+TEST(MemoryAccountingTest, CatalogCountsSharedRecordsOnce) {
+    const int64_t before = bytesOf(MemoryTag::Catalog);
+    {
+        MixCatalog catalog;
+        catalog.load(makeMixes(2000));
+        const int64_t loaded = bytesOf(MemoryTag::Catalog) - before;
+        EXPECT_GT(loaded, 2000 * 64);
+
+        // A reader holding the old snapshot shares its records with the new one
+        const MixCatalog::Snapshot held = catalog.snapshot();
+        Mix added = makeMixes(1).front();
+        added.id = "mix-id-new";
+        catalog.put(added);
+        const int64_t both = bytesOf(MemoryTag::Catalog) - before;
+        EXPECT_GT(both, loaded);
+        EXPECT_LT(both - loaded, loaded / 2);
+    }
+    EXPECT_EQ(bytesOf(MemoryTag::Catalog), before);
+}
+
+TEST(MemoryAccountingTest, SampleReadsTheResidentSize) {
+    const ProcessMemory process = MemoryAccounting::sample();
+    if (process.resident_bytes < 0) {
+        GTEST_SKIP() << "Resident memory is not readable here";
+    }
+    EXPECT_GT(process.resident_bytes, 0);
+    EXPECT_GE(process.peak_resident_bytes, process.resident_bytes / 2);
+    EXPECT_EQ(MemoryAccounting::getLastSample().resident_bytes, process.resident_bytes);
+
+    const std::string breakdown = MemoryAccounting::formatBreakdown(process);
+    EXPECT_NE(breakdown.find("resident "), std::string::npos);
+    EXPECT_NE(breakdown.find("catalog "), std::string::npos);
+    EXPECT_NE(breakdown.find("gpu_pixel_buffers "), std::string::npos);
+}
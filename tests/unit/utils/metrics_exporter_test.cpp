@@ -0,0 +1,105 @@
+#include "utils/metrics_exporter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using AutoVibez::Utils::MetricsExporter;
+using AutoVibez::Utils::MetricsRegistry;
+
+TEST(MetricsExporterTest, StatsdSendsCounterIncreases) {
+    MetricsRegistry registry;
+    MetricsExporter exporter(registry);
+    auto& counter = registry.counter("test_xruns_total", "Lost audio");
+    auto& gauge = registry.gauge("test_depth", "Queue depth");
+    auto& histogram = registry.histogram("test_frame_ms", "Frame time", {10});
+
+    counter.increment(5);
+    gauge.set(3);
+    histogram.observe(4);
+    histogram.observe(6);
+    std::vector<std::string> lines = exporter.formatStatsd(registry.collect());
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "test_xruns_total:5|c"), lines.end());
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "test_depth:3|g"), lines.end());
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "test_frame_ms.count:2|c"), lines.end());
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "test_frame_ms.sum:10|c"), lines.end());
+
+    // Only what changed since the last push; gauges every time
+    counter.increment(2);
+    lines = exporter.formatStatsd(registry.collect());
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "test_xruns_total:2|c"), lines.end());
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "test_depth:3|g"), lines.end());
+    EXPECT_EQ(std::find(lines.begin(), lines.end(), "test_frame_ms.count:2|c"), lines.end());
+}
+
+TEST(MetricsExporterTest, TextfileIsWrittenAndKeptOnStop) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "autovibez_metrics_test.prom";
+    std::filesystem::remove(path);
+    MetricsRegistry registry;
+    registry.counter("test_plays_total", "Plays").increment();
+    {
+        MetricsExporter exporter(registry);
+        ASSERT_TRUE(exporter.start("", path.string(), std::chrono::hours(1)));
+        EXPECT_TRUE(exporter.isRunning());
+    }
+
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_NE(content.str().find("test_plays_total 1\n"), std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+    std::filesystem::remove(path);
+}
+
+TEST(MetricsExporterTest, BadAddressIsRejected) {
+    MetricsRegistry registry;
+    MetricsExporter exporter(registry);
+    EXPECT_FALSE(exporter.start("", ""));
+    EXPECT_FALSE(exporter.start("no-port", ""));
+    EXPECT_FALSE(exporter.isRunning());
+    EXPECT_FALSE(exporter.getLastError().empty());
+
+    EXPECT_TRUE(exporter.start("127.0.0.1:8125", "", std::chrono::hours(1)));
+    exporter.stop();
+    EXPECT_FALSE(exporter.isRunning());
+}
+
+#ifndef _WIN32
+TEST(MetricsExporterTest, StatsdReachesTheCollector) {
+    const int collector = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(collector, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(collector, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    socklen_t length = sizeof(address);
+    getsockname(collector, reinterpret_cast<sockaddr*>(&address), &length);
+
+    MetricsRegistry registry;
+    registry.counter("test_downloads_total", "Downloads").increment(3);
+    MetricsExporter exporter(registry);
+    ASSERT_TRUE(exporter.start("127.0.0.1:" + std::to_string(ntohs(address.sin_port)), "", std::chrono::hours(1)));
+    exporter.exportNow();
+
+    pollfd ready{collector, POLLIN, 0};
+    ASSERT_EQ(poll(&ready, 1, 2000), 1);
+    char packet[2048];
+    const ssize_t received = recv(collector, packet, sizeof(packet), 0);
+    ASSERT_GT(received, 0);
+    EXPECT_NE(std::string(packet, static_cast<size_t>(received)).find("test_downloads_total:3|c"), std::string::npos);
+    close(collector);
+}
+#endif
@@ -0,0 +1,97 @@
+#include "utils/metrics_registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using AutoVibez::Utils::MetricKind;
+using AutoVibez::Utils::MetricSample;
+using AutoVibez::Utils::MetricsRegistry;
+
+namespace {
+const MetricSample* findSample(const std::vector<MetricSample>& samples, const std::string& name) {
+    for (const MetricSample& sample : samples) {
+        if (sample.name == name) {
+            return &sample;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+TEST(MetricsRegistryTest, SameNameReturnsSameInstrument) {
+    MetricsRegistry registry;
+    registry.counter("test_events_total", "Events").increment();
+    registry.counter("test_events_total", "Events").increment(2);
+    EXPECT_EQ(registry.counter("test_events_total", "Events").get(), 3u);
+
+    // A different kind under a taken name works but is never exported
+    registry.gauge("test_events_total", "Clash").set(42.0);
+    const std::vector<MetricSample> samples = registry.collect();
+    const MetricSample* events = findSample(samples, "test_events_total");
+    ASSERT_NE(events, nullptr);
+    EXPECT_EQ(events->kind, MetricKind::Counter);
+    EXPECT_DOUBLE_EQ(events->value, 3.0);
+}
+
+TEST(MetricsRegistryTest, HistogramBucketsIncludeTheirUpperBound) {
+    MetricsRegistry registry;
+    auto& histogram = registry.histogram("test_latency_ms", "Latency", {1, 5, 10});
+    for (double value : {0.5, 1.0, 3.0, 10.0, 50.0}) {
+        histogram.observe(value);
+    }
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.counts, (std::vector<uint64_t>{2, 1, 1, 1}));
+    EXPECT_EQ(snapshot.count, 5u);
+    EXPECT_DOUBLE_EQ(snapshot.sum, 64.5);
+}
+
+TEST(MetricsRegistryTest, ConcurrentUpdatesAreNotLost) {
+    MetricsRegistry registry;
+    auto& counter = registry.counter("test_updates_total", "Updates");
+    auto& histogram = registry.histogram("test_values", "Values", {0.5});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10000; ++i) {
+                counter.increment();
+                histogram.observe(1.0);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.get(), 40000u);
+    EXPECT_EQ(histogram.snapshot().count, 40000u);
+    EXPECT_DOUBLE_EQ(histogram.snapshot().sum, 40000.0);
+}
+
+TEST(MetricsRegistryTest, PrometheusTextFormat) {
+    MetricsRegistry registry;
+    registry.counter("test_xruns_total", "Lost audio").increment(7);
+    registry.gauge("test_depth", "Queue depth").set(2.5);
+    registry.histogram("test_frame_ms", "Frame time", {10, 20}).observe(15);
+
+    const std::string text = MetricsRegistry::formatPrometheus(registry.collect());
+    EXPECT_NE(text.find("# HELP test_xruns_total Lost audio\n# TYPE test_xruns_total counter\ntest_xruns_total 7\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_depth gauge\ntest_depth 2.5\n"), std::string::npos);
+    EXPECT_NE(text.find("test_frame_ms_bucket{le=\"10\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("test_frame_ms_bucket{le=\"20\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_frame_ms_bucket{le=\"+Inf\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_frame_ms_sum 15\ntest_frame_ms_count 1\n"), std::string::npos);
+}
+
+TEST(MetricsRegistryTest, CollectSamplesResidentMemory) {
+    MetricsRegistry registry;
+    const std::vector<MetricSample> samples = registry.collect();
+    const MetricSample* resident = findSample(samples, "autovibez_process_resident_bytes");
+    if (MetricsRegistry::getResidentBytes() < 0) {
+        GTEST_SKIP() << "Resident memory is not readable here";
+    }
+    ASSERT_NE(resident, nullptr);
+    EXPECT_GT(resident->value, 0.0);
+}
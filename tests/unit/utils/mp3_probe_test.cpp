@@ -0,0 +1,238 @@
+#include "utils/mp3_probe.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "utils/constants.hpp"
+
+using AutoVibez::Utils::Mp3Probe;
+using AutoVibez::Utils::Mp3ProbeCache;
+using AutoVibez::Utils::Mp3ProbeResult;
+
+namespace {
+
+using Bytes = std::vector<unsigned char>;
+
+void appendBigEndian(Bytes& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<unsigned char>(value >> shift));
+    }
+}
+
+void appendFrame(Bytes& out, const std::string& id, const Bytes& body) {
+    out.insert(out.end(), id.begin(), id.end());
+    appendBigEndian(out, static_cast<uint32_t>(body.size()));
+    out.push_back(0);
+    out.push_back(0);
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+Bytes latin1Text(const std::string& text) {
+    Bytes body{0};
+    body.insert(body.end(), text.begin(), text.end());
+    return body;
+}
+
+// ID3v2.3 tag holding the given frames, padded to tagSize bytes after the header
+Bytes id3Tag(const Bytes& frames, size_t tagSize) {
+    Bytes tag{'I', 'D', '3', 3, 0, 0};
+    tag.push_back(static_cast<unsigned char>((tagSize >> 21) & 0x7F));
+    tag.push_back(static_cast<unsigned char>((tagSize >> 14) & 0x7F));
+    tag.push_back(static_cast<unsigned char>((tagSize >> 7) & 0x7F));
+    tag.push_back(static_cast<unsigned char>(tagSize & 0x7F));
+    tag.insert(tag.end(), frames.begin(), frames.end());
+    tag.resize(Constants::ID3V2_HEADER_SIZE + tagSize, 0);
+    return tag;
+}
+
+// MPEG-1 Layer III, 128 kbps, 44.1 kHz, joint stereo; optionally with a Xing header
+Bytes mpegFrame(uint32_t xingFrames = 0, uint32_t xingBytes = 0) {
+    Bytes frame{0xFF, 0xFB, 0x90, 0x44};
+    frame.resize(36, 0);
+    if (xingFrames > 0) {
+        frame.insert(frame.end(), {'X', 'i', 'n', 'g'});
+        appendBigEndian(frame, 0x03);
+        appendBigEndian(frame, xingFrames);
+        appendBigEndian(frame, xingBytes);
+    }
+    frame.resize(417, 0);
+    return frame;
+}
+
+Bytes concat(Bytes a, const Bytes& b, size_t minSize = 0) {
+    a.insert(a.end(), b.begin(), b.end());
+    if (a.size() < minSize) {
+        a.resize(minSize, 0x55);
+    }
+    return a;
+}
+
+void writeFile(const std::filesystem::path& path, const Bytes& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+}  // namespace
+
+TEST(Mp3ProbeTest, ReadsTagFrameHeaderAndXingInOnePass) {
+    Bytes frames;
+    appendFrame(frames, "TIT2", latin1Text("Sunrise Set"));
+    appendFrame(frames, "TPE1", {1, 0xFF, 0xFE, 'D', 0, 'J', 0, 0xE9, 0});  // UTF-16LE "DJé"
+    appendFrame(frames, "TCON", latin1Text("House"));
+    appendFrame(frames, "COMM", {0, 'e', 'n', 'g', 0, 'N', 'o', 't', 'e'});
+    Bytes tag = id3Tag(frames, 256);
+    Bytes file = concat(tag, mpegFrame(1000, 418000), 4096);
+
+    Mp3ProbeResult result = Mp3Probe::probeData(file.data(), file.size());
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.audio_offset, static_cast<int64_t>(tag.size()));
+    EXPECT_EQ(result.sample_rate, 44100);
+    EXPECT_EQ(result.channels, 2);
+    EXPECT_TRUE(result.has_xing);
+    EXPECT_NEAR(result.duration_seconds, 1000 * 1152 / 44100.0, 1e-9);
+    EXPECT_EQ(result.bitrate_kbps, 128);
+    EXPECT_EQ(result.title, "Sunrise Set");
+    EXPECT_EQ(result.artist, "DJ\xC3\xA9");
+    EXPECT_EQ(result.genre, "House");
+    EXPECT_EQ(result.comment, "Note");
+}
+
+TEST(Mp3ProbeTest, EstimatesConstantBitrateDuration) {
+    Bytes file = concat(Bytes(), mpegFrame(), 160000);
+
+    Mp3ProbeResult result = Mp3Probe::probeData(file.data(), file.size());
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_FALSE(result.has_xing);
+    EXPECT_EQ(result.bitrate_kbps, 128);
+    EXPECT_NEAR(result.duration_seconds, 10.0, 1e-9);
+    EXPECT_TRUE(result.title.empty());
+}
+
+TEST(Mp3ProbeTest, RejectsTagWithoutAudio) {
+    Bytes file = id3Tag({}, Constants::MIN_MP3_FILE_SIZE);
+    EXPECT_FALSE(Mp3Probe::probeData(file.data(), file.size()).valid);
+
+    Bytes shortFile = concat(Bytes(), mpegFrame());
+    EXPECT_FALSE(Mp3Probe::probeData(shortFile.data(), shortFile.size()).valid);
+    EXPECT_FALSE(Mp3Probe::probeData(nullptr, 4096).valid);
+}
+
+class Mp3ProbeFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "autovibez_mp3_probe_test";
+        std::filesystem::create_directories(test_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir);
+    }
+
+    std::filesystem::path test_dir;
+};
+
+TEST_F(Mp3ProbeFileTest, FindsAudioPastTagLargerThanHead) {
+    Bytes frames;
+    appendFrame(frames, "TIT2", latin1Text("Cover Art Mix"));
+    Bytes tag = id3Tag(frames, Constants::MP3_PROBE_HEAD_BYTES * 2);
+    auto path = test_dir / "big_tag.mp3";
+    writeFile(path, concat(tag, mpegFrame(), tag.size() + 8192));
+
+    Mp3ProbeResult result = Mp3Probe::probeFile(path.string());
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.audio_offset, static_cast<int64_t>(tag.size()));
+    EXPECT_EQ(result.title, "Cover Art Mix");
+}
+
+TEST_F(Mp3ProbeFileTest, CacheKeepsVerdictUntilSizeOrMtimeChange) {
+    auto path = test_dir / "mix.mp3";
+    Bytes valid = concat(Bytes(), mpegFrame(), 8192);
+    writeFile(path, valid);
+
+    Mp3ProbeCache cache;
+    ASSERT_TRUE(cache.probe(path.string()).valid);
+    EXPECT_EQ(cache.size(), 1u);
+
+    // Same size and mtime: the stored verdict is returned without reading the new bytes
+    auto written = std::filesystem::last_write_time(path);
+    writeFile(path, Bytes(valid.size(), 0));
+    std::filesystem::last_write_time(path, written);
+    EXPECT_TRUE(cache.probe(path.string()).valid);
+
+    // A new mtime invalidates it
+    std::filesystem::last_write_time(path, written + std::chrono::seconds(5));
+    EXPECT_FALSE(cache.probe(path.string()).valid);
+
+    // Missing files drop their entry
+    std::filesystem::remove(path);
+    EXPECT_FALSE(cache.probe(path.string()).valid);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(Mp3ProbeFileTest, CacheFollowsRenamesAndPersists) {
+    Bytes frames;
+    appendFrame(frames, "TIT2", latin1Text("Tab\there"));
+    auto temp = test_dir / "download.tmp";
+    auto final_path = test_dir / "final.mp3";
+    Bytes bytes = concat(id3Tag(frames, 64), mpegFrame(), 8192);
+    writeFile(temp, bytes);
+
+    Mp3ProbeCache cache;
+    ASSERT_TRUE(cache.probe(temp.string()).valid);
+    std::filesystem::rename(temp, final_path);
+    cache.moved(temp.string(), final_path.string());
+    EXPECT_EQ(cache.size(), 1u);
+
+    auto cache_file = test_dir / "cache" / "probe.txt";
+    ASSERT_TRUE(cache.save(cache_file.string()));
+
+    // Corrupt the file without changing size or mtime; only the cache can still call it valid
+    auto written = std::filesystem::last_write_time(final_path);
+    writeFile(final_path, Bytes(bytes.size(), 0));
+    std::filesystem::last_write_time(final_path, written);
+
+    Mp3ProbeCache restored;
+    ASSERT_TRUE(restored.load(cache_file.string()));
+    Mp3ProbeResult result = restored.probe(final_path.string());
+    EXPECT_TRUE(result.valid);
+    EXPECT_EQ(result.title, "Tab\there");
+
+    EXPECT_FALSE(restored.load((test_dir / "missing.txt").string()));
+}
+
+TEST(Mp3ProbeTest, FrameLengthFollowsBitrateAndPadding) {
+    EXPECT_EQ(Mp3Probe::frameLength(mpegFrame().data()), 417u);
+    const Bytes padded{0xFF, 0xFB, 0x92, 0x44};
+    EXPECT_EQ(Mp3Probe::frameLength(padded.data()), 418u);
+    const Bytes freeFormat{0xFF, 0xFB, 0x00, 0x44};
+    EXPECT_EQ(Mp3Probe::frameLength(freeFormat.data()), 0u);
+    const Bytes text{'T', 'A', 'G', 'x'};
+    EXPECT_EQ(Mp3Probe::frameLength(text.data()), 0u);
+
+    const Bytes tag = id3Tag(Bytes(), 300);
+    EXPECT_EQ(Mp3Probe::tagLength(tag.data(), tag.size()), tag.size());
+    EXPECT_EQ(Mp3Probe::tagLength(text.data(), text.size()), 0u);
+}
+
+TEST_F(Mp3ProbeFileTest, CacheKeepsAStoredVerdictWithoutReading) {
+    auto path = test_dir / "streamed.mp3";
+    writeFile(path, Bytes(4096, 0));
+
+    Mp3ProbeResult streamed;
+    streamed.valid = true;
+    streamed.title = "Seen in flight";
+    Mp3ProbeCache cache;
+    cache.store(path.string(), streamed);
+    EXPECT_EQ(cache.probe(path.string()).title, "Seen in flight");
+
+    cache.store((test_dir / "missing.mp3").string(), streamed);
+    EXPECT_EQ(cache.size(), 1u);
+}
@@ -0,0 +1,111 @@
+#include "utils/mp3_stream_check.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "utils/constants.hpp"
+
+using AutoVibez::Utils::Mp3Probe;
+using AutoVibez::Utils::Mp3StreamCheck;
+using AutoVibez::Utils::Mp3StreamReport;
+
+namespace {
+
+using Bytes = std::vector<unsigned char>;
+
+// MPEG-1 Layer III, 128 kbps, 44.1 kHz: 417 bytes a frame
+Bytes frames(size_t count) {
+    Bytes out;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t start = out.size();
+        out.insert(out.end(), {0xFF, 0xFB, 0x90, 0x44});
+        out.resize(start + 417, static_cast<unsigned char>(i));
+    }
+    return out;
+}
+
+Bytes id3Tag(size_t tagSize) {
+    Bytes tag{'I', 'D', '3', 3, 0, 0};
+    tag.push_back(static_cast<unsigned char>((tagSize >> 21) & 0x7F));
+    tag.push_back(static_cast<unsigned char>((tagSize >> 14) & 0x7F));
+    tag.push_back(static_cast<unsigned char>((tagSize >> 7) & 0x7F));
+    tag.push_back(static_cast<unsigned char>(tagSize & 0x7F));
+    tag.resize(Constants::ID3V2_HEADER_SIZE + tagSize, 0);
+    return tag;
+}
+
+Bytes concat(Bytes a, const Bytes& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+// Fed in uneven pieces, so headers and frames straddle the chunk boundaries
+Mp3StreamReport check(const Bytes& file, size_t chunk = 1000) {
+    Mp3StreamCheck stream;
+    for (size_t offset = 0; offset < file.size(); chunk = chunk % 1500 + 7) {
+        const size_t size = std::min(chunk, file.size() - offset);
+        stream.feed(file.data() + offset, size);
+        offset += size;
+    }
+    return stream.finish();
+}
+
+}  // namespace
+
+TEST(Mp3StreamCheckTest, WalksEveryFrameAndProbesLikeTheFile) {
+    const Bytes file = concat(id3Tag(500), frames(400));
+    const Mp3StreamReport report = check(file);
+    EXPECT_TRUE(report.probed);
+    EXPECT_EQ(report.frames, 400);
+    EXPECT_EQ(report.lost_bytes, 0);
+    EXPECT_FALSE(report.truncated);
+
+    const auto probe = Mp3Probe::probeData(file.data(), file.size());
+    EXPECT_TRUE(report.probe.valid);
+    EXPECT_EQ(report.probe.audio_offset, probe.audio_offset);
+    EXPECT_DOUBLE_EQ(report.probe.duration_seconds, probe.duration_seconds);
+}
+
+TEST(Mp3StreamCheckTest, CountsBytesOutOfSyncButNotAnId3v1Tag) {
+    Bytes file = concat(frames(200), Bytes(333, 0x11));
+    file = concat(file, frames(200));
+    Bytes id3v1(128, 0);
+    id3v1[0] = 'T';
+    id3v1[1] = 'A';
+    id3v1[2] = 'G';
+    Mp3StreamReport report = check(concat(file, id3v1));
+    EXPECT_EQ(report.frames, 400);
+    EXPECT_EQ(report.lost_bytes, 333);
+    EXPECT_FALSE(report.truncated);
+
+    // The same tail without the tag marker is lost too; a cut-off frame is flagged
+    id3v1[0] = 'X';
+    report = check(concat(file, id3v1));
+    EXPECT_EQ(report.lost_bytes, 333 + 128);
+    file.resize(file.size() - 100);
+    report = check(file);
+    EXPECT_TRUE(report.truncated);
+}
+
+TEST(Mp3StreamCheckTest, HoldsTheHeadPastALargeTag) {
+    const Bytes file = concat(id3Tag(200 * 1024), frames(50));
+    const Mp3StreamReport report = check(file, 4096);
+    EXPECT_TRUE(report.probed);
+    EXPECT_TRUE(report.probe.valid);
+    EXPECT_EQ(report.probe.audio_offset, static_cast<int64_t>(Constants::ID3V2_HEADER_SIZE + 200 * 1024));
+    EXPECT_EQ(report.frames, 50);
+}
+
+TEST(Mp3StreamCheckTest, OtherFilesAreNotWalked) {
+    const Mp3StreamReport report = check(Bytes(200000, 'a'));
+    EXPECT_TRUE(report.probed);
+    EXPECT_FALSE(report.probe.valid);
+    EXPECT_EQ(report.frames, 0);
+    EXPECT_EQ(report.lost_bytes, 0);
+
+    // Too short to be an MP3 at all
+    EXPECT_FALSE(check(frames(1)).probe.valid);
+}
@@ -0,0 +1,94 @@
+#include "overlay_message_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace AutoVibez::Utils;
+
+namespace {
+
+NamedMessageConfig message(OverlayMessageType type, OverlayPriority priority, const std::string& text) {
+    return NamedMessageConfig{[text](std::string& out) { out.append(text); }, std::chrono::milliseconds(1000), false,
+                              type, priority};
+}
+
+std::string popText(OverlayMessageQueue& queue) {
+    QueuedOverlayMessage popped;
+    return queue.pop(popped) ? popped.text : "";
+}
+
+}  // namespace
+
+TEST(OverlayMessageQueueTest, PopsByPriorityThenArrival) {
+    OverlayMessageQueue queue;
+    queue.push(message(OverlayMessageType::DownloadStatus, OverlayPriority::Status, "status"));
+    queue.push(message(OverlayMessageType::MixInfo, OverlayPriority::Normal, "mix"));
+    queue.push(message(OverlayMessageType::Text, OverlayPriority::Alert, "failed"));
+    queue.push(message(OverlayMessageType::Text, OverlayPriority::Normal, "notice"));
+
+    EXPECT_EQ(queue.peek()->text, "failed");
+    EXPECT_EQ(popText(queue), "failed");
+    EXPECT_EQ(popText(queue), "mix");
+    EXPECT_EQ(popText(queue), "notice");
+    EXPECT_EQ(popText(queue), "status");
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.peek(), nullptr);
+}
+
+TEST(OverlayMessageQueueTest, SameTypeUpdatesTheQueuedEntryInPlace) {
+    OverlayMessageQueue queue;
+    queue.push(message(OverlayMessageType::Volume, OverlayPriority::Status, "Volume: 50%"));
+    queue.push(message(OverlayMessageType::MixInfo, OverlayPriority::Status, "mix"));
+    for (int volume = 55; volume <= 80; volume += 5) {
+        const std::string text = "Volume: " + std::to_string(volume) + "%";
+        queue.push(message(OverlayMessageType::Volume, OverlayPriority::Status, text));
+    }
+
+    EXPECT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.getMergedCount(), 6u);
+    EXPECT_EQ(popText(queue), "Volume: 80%");  // Kept its place ahead of the mix
+    EXPECT_EQ(popText(queue), "mix");
+}
+
+TEST(OverlayMessageQueueTest, PlainTextMergesOnlyWhenTheSame) {
+    OverlayMessageQueue queue;
+    queue.push(message(OverlayMessageType::Text, OverlayPriority::Normal, "Config reloaded"));
+    queue.push(message(OverlayMessageType::Text, OverlayPriority::Normal, "Screenshot saved"));
+    queue.push(message(OverlayMessageType::Text, OverlayPriority::Alert, "Config reloaded"));
+
+    EXPECT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.peek()->priority, OverlayPriority::Alert);  // The merge keeps the higher priority
+    EXPECT_EQ(popText(queue), "Config reloaded");
+}
+
+TEST(OverlayMessageQueueTest, FullQueueDropsTheLowestOldestFirst) {
+    OverlayMessageQueue queue;
+    const int capacity = Constants::OVERLAY_QUEUE_CAPACITY;
+    for (int i = 0; i < capacity; ++i) {
+        queue.push(message(OverlayMessageType::Text, OverlayPriority::Normal, "normal " + std::to_string(i)));
+    }
+    EXPECT_FALSE(queue.push(message(OverlayMessageType::DownloadStatus, OverlayPriority::Status, "status")));
+    EXPECT_TRUE(queue.push(message(OverlayMessageType::Text, OverlayPriority::Alert, "alert")));
+    EXPECT_EQ(queue.size(), static_cast<size_t>(capacity));
+    EXPECT_EQ(queue.getDroppedCount(), 2u);
+
+    EXPECT_EQ(popText(queue), "alert");
+    for (int i = 0; i < capacity - 1; ++i) {
+        EXPECT_EQ(popText(queue), "normal " + std::to_string(i));
+    }
+}
+
+TEST(OverlayMessageQueueTest, BuffersAreReusedNotReallocated) {
+    OverlayMessageQueue queue;
+    QueuedOverlayMessage popped;
+    popped.text.reserve(Constants::OVERLAY_MESSAGE_RESERVE);
+
+    // Buffers only change hands, so every one seen keeps the reserved capacity
+    for (int i = 0; i < 4 * Constants::OVERLAY_QUEUE_CAPACITY; ++i) {
+        const std::string text = "Artist - Title " + std::to_string(i);
+        queue.push(message(OverlayMessageType::MixInfo, OverlayPriority::Normal, text));
+        ASSERT_TRUE(queue.pop(popped));
+        EXPECT_GE(popped.text.capacity(), static_cast<size_t>(Constants::OVERLAY_MESSAGE_RESERVE));
+    }
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include "constants.hpp"
+
 using namespace AutoVibez::Utils;
 
 class OverlayMessagesTest : public ::testing::Test {
@@ -27,14 +29,14 @@ TEST_F(OverlayMessagesTest, InitializationBehavior) {
 
     // No direct way to test initialization state, but we can test that messages work
     auto config = OverlayMessages::createMessage("mix_info", "Artist", "Title");
-    EXPECT_EQ(config.formatter(), "Artist - Title");
+    EXPECT_EQ(OverlayMessages::format(config), "Artist - Title");
 }
 
 // Test basic mix_info message creation
 TEST_F(OverlayMessagesTest, MixInfoMessageCreation) {
     auto config = OverlayMessages::createMessage("mix_info", "Test Artist", "Test Title");
 
-    EXPECT_EQ(config.formatter(), "Test Artist - Test Title");
+    EXPECT_EQ(OverlayMessages::format(config), "Test Artist - Test Title");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -43,7 +45,7 @@ TEST_F(OverlayMessagesTest, MixInfoMessageCreation) {
 TEST_F(OverlayMessagesTest, MixInfoMessageWithEmptyStrings) {
     auto config = OverlayMessages::createMessage("mix_info", "", "");
 
-    EXPECT_EQ(config.formatter(), " - ");
+    EXPECT_EQ(OverlayMessages::format(config), " - ");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -52,7 +54,7 @@ TEST_F(OverlayMessagesTest, MixInfoMessageWithEmptyStrings) {
 TEST_F(OverlayMessagesTest, MixInfoMessageWithSpecialCharacters) {
     auto config = OverlayMessages::createMessage("mix_info", "Artist & Co.", "Title (Remix)");
 
-    EXPECT_EQ(config.formatter(), "Artist & Co. - Title (Remix)");
+    EXPECT_EQ(OverlayMessages::format(config), "Artist & Co. - Title (Remix)");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -61,7 +63,7 @@ TEST_F(OverlayMessagesTest, MixInfoMessageWithSpecialCharacters) {
 TEST_F(OverlayMessagesTest, MixInfoMessageWithUnicodeCharacters) {
     auto config = OverlayMessages::createMessage("mix_info", "Ártist", "Títle");
 
-    EXPECT_EQ(config.formatter(), "Ártist - Títle");
+    EXPECT_EQ(OverlayMessages::format(config), "Ártist - Títle");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -73,7 +75,7 @@ TEST_F(OverlayMessagesTest, MixInfoMessageWithLongStrings) {
 
     auto config = OverlayMessages::createMessage("mix_info", longArtist, longTitle);
 
-    EXPECT_EQ(config.formatter(), longArtist + " - " + longTitle);
+    EXPECT_EQ(OverlayMessages::format(config), longArtist + " - " + longTitle);
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -82,7 +84,7 @@ TEST_F(OverlayMessagesTest, MixInfoMessageWithLongStrings) {
 TEST_F(OverlayMessagesTest, UnknownMessageName) {
     auto config = OverlayMessages::createMessage("unknown_message", "arg1", "arg2");
 
-    EXPECT_EQ(config.formatter(), "Unknown message");
+    EXPECT_EQ(OverlayMessages::format(config), "Unknown message");
     EXPECT_EQ(config.duration.count(), 3000);
     EXPECT_FALSE(config.colorTransition);
 }
@@ -91,7 +93,7 @@ TEST_F(OverlayMessagesTest, UnknownMessageName) {
 TEST_F(OverlayMessagesTest, EmptyMessageName) {
     auto config = OverlayMessages::createMessage("", "arg1", "arg2");
 
-    EXPECT_EQ(config.formatter(), "Unknown message");
+    EXPECT_EQ(OverlayMessages::format(config), "Unknown message");
     EXPECT_EQ(config.duration.count(), 3000);
     EXPECT_FALSE(config.colorTransition);
 }
@@ -101,7 +103,7 @@ TEST_F(OverlayMessagesTest, MixInfoWithInsufficientArguments) {
     auto config = OverlayMessages::createMessage("mix_info", "OnlyOneArg");
 
     // This should trigger the fallback case since we only provided 1 argument
-    EXPECT_EQ(config.formatter(), "Unknown message");
+    EXPECT_EQ(OverlayMessages::format(config), "Unknown message");
     EXPECT_EQ(config.duration.count(), 3000);
     EXPECT_FALSE(config.colorTransition);
 }
@@ -111,7 +113,7 @@ TEST_F(OverlayMessagesTest, MixInfoWithNoArguments) {
     auto config = OverlayMessages::createMessage("mix_info");
 
     // This should trigger the fallback case
-    EXPECT_EQ(config.formatter(), "Unknown message");
+    EXPECT_EQ(OverlayMessages::format(config), "Unknown message");
     EXPECT_EQ(config.duration.count(), 3000);
     EXPECT_FALSE(config.colorTransition);
 }
@@ -121,7 +123,7 @@ TEST_F(OverlayMessagesTest, MixInfoWithTooManyArguments) {
     auto config = OverlayMessages::createMessage("mix_info", "Artist", "Title", "ExtraArg");
 
     // Should still work with first two arguments
-    EXPECT_EQ(config.formatter(), "Artist - Title");
+    EXPECT_EQ(OverlayMessages::format(config), "Artist - Title");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -134,7 +136,7 @@ TEST_F(OverlayMessagesTest, ArgumentTypeConversion) {
 
     auto config = OverlayMessages::createMessage("mix_info", artist, title);
 
-    EXPECT_EQ(config.formatter(), "String Artist - String Title");
+    EXPECT_EQ(OverlayMessages::format(config), "String Artist - String Title");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -146,7 +148,7 @@ TEST_F(OverlayMessagesTest, ConstCharPointerArguments) {
 
     auto config = OverlayMessages::createMessage("mix_info", artist, title);
 
-    EXPECT_EQ(config.formatter(), "Const Artist - Const Title");
+    EXPECT_EQ(OverlayMessages::format(config), "Const Artist - Const Title");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -158,7 +160,7 @@ TEST_F(OverlayMessagesTest, MixedArgumentTypes) {
 
     auto config = OverlayMessages::createMessage("mix_info", artist, title);
 
-    EXPECT_EQ(config.formatter(), "Mixed Artist - Mixed Title");
+    EXPECT_EQ(OverlayMessages::format(config), "Mixed Artist - Mixed Title");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -168,7 +170,7 @@ TEST_F(OverlayMessagesTest, MessageConsistency) {
     auto config1 = OverlayMessages::createMessage("mix_info", "Artist", "Title");
     auto config2 = OverlayMessages::createMessage("mix_info", "Artist", "Title");
 
-    EXPECT_EQ(config1.formatter(), config2.formatter());
+    EXPECT_EQ(OverlayMessages::format(config1), OverlayMessages::format(config2));
     EXPECT_EQ(config1.duration.count(), config2.duration.count());
     EXPECT_EQ(config1.colorTransition, config2.colorTransition);
 }
@@ -178,7 +180,7 @@ TEST_F(OverlayMessagesTest, FutureMessageTypeSupport) {
     // Test that the system handles unknown message types gracefully
     auto config = OverlayMessages::createMessage("future_message", "param1", "param2", "param3");
 
-    EXPECT_EQ(config.formatter(), "Unknown message");
+    EXPECT_EQ(OverlayMessages::format(config), "Unknown message");
     EXPECT_EQ(config.duration.count(), 3000);
     EXPECT_FALSE(config.colorTransition);
 }
@@ -190,7 +192,7 @@ TEST_F(OverlayMessagesTest, MessageRegistryRobustness) {
         auto config =
             OverlayMessages::createMessage("mix_info", "Artist" + std::to_string(i), "Title" + std::to_string(i));
 
-        EXPECT_EQ(config.formatter(), "Artist" + std::to_string(i) + " - Title" + std::to_string(i));
+        EXPECT_EQ(OverlayMessages::format(config), "Artist" + std::to_string(i) + " - Title" + std::to_string(i));
         EXPECT_EQ(config.duration.count(), 5000);
         EXPECT_TRUE(config.colorTransition);
     }
@@ -200,7 +202,7 @@ TEST_F(OverlayMessagesTest, MessageRegistryRobustness) {
 TEST_F(OverlayMessagesTest, WhitespaceHandling) {
     auto config = OverlayMessages::createMessage("mix_info", "  Artist  ", "  Title  ");
 
-    EXPECT_EQ(config.formatter(), "  Artist   -   Title  ");
+    EXPECT_EQ(OverlayMessages::format(config), "  Artist   -   Title  ");
     EXPECT_EQ(config.duration.count(), 5000);
     EXPECT_TRUE(config.colorTransition);
 }
@@ -211,8 +213,8 @@ TEST_F(OverlayMessagesTest, CaseSensitivity) {
     auto config2 = OverlayMessages::createMessage("MIX_INFO", "Artist", "Title");
 
     // Message names should be case sensitive
-    EXPECT_EQ(config1.formatter(), "Artist - Title");
-    EXPECT_EQ(config2.formatter(), "Unknown message");
+    EXPECT_EQ(OverlayMessages::format(config1), "Artist - Title");
+    EXPECT_EQ(OverlayMessages::format(config2), "Unknown message");
 }
 
 // Test lambda capture behavior
@@ -226,6 +228,16 @@ TEST_F(OverlayMessagesTest, LambdaCaptureCorrectness) {
     artist = "Modified Artist";
     title = "Modified Title";
 
-    // The formatter should still return the original captured values
-    EXPECT_EQ(config.formatter(), "Captured Artist - Captured Title");
+    // The formatted text should still hold the original captured values
+    EXPECT_EQ(OverlayMessages::format(config), "Captured Artist - Captured Title");
+}
+
+// Test the volume message and its queue type
+TEST_F(OverlayMessagesTest, VolumeChangeIsAShortStatusMessage) {
+    auto config = OverlayMessages::createMessage("volume_change", 45);
+
+    EXPECT_EQ(OverlayMessages::format(config), "Volume: 45%");
+    EXPECT_EQ(config.duration.count(), Constants::OVERLAY_VOLUME_DURATION_MS);
+    EXPECT_EQ(config.type, OverlayMessageType::Volume);
+    EXPECT_EQ(config.priority, OverlayPriority::Status);
 }
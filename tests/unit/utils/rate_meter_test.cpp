@@ -0,0 +1,33 @@
+#include "utils/rate_meter.hpp"
+
+#include <gtest/gtest.h>
+
+#include "utils/constants.hpp"
+
+using AutoVibez::Utils::RateMeter;
+
+TEST(RateMeterTest, MeasuresWholeSpansOnly) {
+    RateMeter meter;
+    const auto start = RateMeter::Clock::now();
+    const auto span = std::chrono::milliseconds(Constants::DOWNLOAD_RATE_SAMPLE_MS);
+    EXPECT_FALSE(meter.sample(0, start));
+    EXPECT_FALSE(meter.sample(1000, start + span / 2));  // Folded into the next sample
+    EXPECT_EQ(meter.getBytesPerSecond(), 0);
+
+    // The first span is taken as it is: 2000 bytes over two spans of half a second
+    ASSERT_TRUE(meter.sample(2000, start + span * 2));
+    EXPECT_EQ(meter.getBytesPerSecond(), 2000 * 1000 / (2 * Constants::DOWNLOAD_RATE_SAMPLE_MS));
+}
+
+TEST(RateMeterTest, SmoothsTowardsTheNewestSpan) {
+    RateMeter meter;
+    const auto start = RateMeter::Clock::now();
+    const auto second = std::chrono::seconds(1);
+    meter.sample(0, start);
+    meter.sample(1000, start + second);
+    EXPECT_EQ(meter.getBytesPerSecond(), 1000);
+
+    // A stall moves the rate part of the way down, not to nothing
+    ASSERT_TRUE(meter.sample(1000, start + second * 2));
+    EXPECT_EQ(meter.getBytesPerSecond(), static_cast<int64_t>(1000 * (1.0 - Constants::DOWNLOAD_RATE_SMOOTHING)));
+}
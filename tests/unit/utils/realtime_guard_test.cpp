@@ -0,0 +1,173 @@
+#include "utils/realtime_guard.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "audio/beat_tracker.hpp"
+#include "audio/channel_downmixer.hpp"
+#include "audio/pcm_ring_buffer.hpp"
+#include "utils/constants.hpp"
+
+using AutoVibez::Audio::BeatTracker;
+using AutoVibez::Audio::ChannelDownmixer;
+using AutoVibez::Audio::PcmRingBuffer;
+using AutoVibez::Utils::RealtimeGuard;
+using AutoVibez::Utils::RealtimeScope;
+
+namespace {
+
+std::atomic<int> g_reported{0};
+std::atomic<const char*> g_lastCall{nullptr};
+
+void countViolation(const char* what) {
+    g_reported.fetch_add(1);
+    g_lastCall.store(what);
+}
+
+constexpr int RATE = 44100;
+constexpr int PERIOD_FRAMES = 512;
+
+// Interleaved sine at 220 Hz, louder on every other period, so the beat tracker has onsets to chew on
+std::vector<float> sinePeriods(int periods, int channels) {
+    std::vector<float> samples(static_cast<size_t>(periods) * PERIOD_FRAMES * channels);
+    for (int frame = 0; frame < periods * PERIOD_FRAMES; ++frame) {
+        const float level = (frame / PERIOD_FRAMES) % 2 ? 0.8f : 0.1f;
+        const float value = level * static_cast<float>(std::sin(2.0 * M_PI * 220.0 * frame / RATE));
+        for (int channel = 0; channel < channels; ++channel) {
+            samples[static_cast<size_t>(frame) * channels + channel] = value;
+        }
+    }
+    return samples;
+}
+
+}  // namespace
+
+class RealtimeGuardTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_reported = 0;
+        g_lastCall = nullptr;
+        RealtimeGuard::setViolationHandler(&countViolation);
+    }
+
+    void TearDown() override {
+        RealtimeGuard::setViolationHandler(nullptr);
+    }
+};
+
+TEST_F(RealtimeGuardTest, ScopesMarkTheThreadAndNest) {
+    EXPECT_FALSE(RealtimeGuard::isRealtimeContext());
+    {
+        RealtimeScope outer;
+        EXPECT_TRUE(RealtimeGuard::isRealtimeContext());
+        {
+            RealtimeScope inner;
+            EXPECT_TRUE(RealtimeGuard::isRealtimeContext());
+        }
+        EXPECT_TRUE(RealtimeGuard::isRealtimeContext());
+    }
+    EXPECT_FALSE(RealtimeGuard::isRealtimeContext());
+}
+
+TEST_F(RealtimeGuardTest, ExplicitCheckOnlyReportsInsideAScope) {
+    RealtimeGuard::check("SDL_Quit");
+    EXPECT_EQ(g_reported.load(), 0);
+
+    const uint64_t before = RealtimeGuard::getViolationCount();
+    {
+        RealtimeScope scope;
+        RealtimeGuard::check("SDL_Quit");
+    }
+    EXPECT_EQ(g_reported.load(), 1);
+    EXPECT_EQ(std::string(g_lastCall.load()), "SDL_Quit");
+    EXPECT_EQ(RealtimeGuard::getViolationCount(), before + 1);
+}
+
+TEST_F(RealtimeGuardTest, ReportsAllocationInScope) {
+    if (!RealtimeGuard::interceptsAllocations()) {
+        GTEST_SKIP() << "Allocations are not interposed in this build";
+    }
+    {
+        RealtimeScope scope;
+        int* volatile block = new int(42);
+        delete block;
+    }
+    EXPECT_GE(g_reported.load(), 2);  // The allocation and the release
+
+    g_reported = 0;
+    int* volatile block = new int(42);
+    delete block;
+    EXPECT_EQ(g_reported.load(), 0);
+}
+
+TEST_F(RealtimeGuardTest, ReportsMutexLockInScope) {
+    if (!RealtimeGuard::interceptsLocks()) {
+        GTEST_SKIP() << "Locks are not interposed in this build";
+    }
+    std::mutex mutex;
+    {
+        RealtimeScope scope;
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    EXPECT_EQ(g_reported.load(), 1);
+    EXPECT_EQ(std::string(g_lastCall.load()), "pthread_mutex_lock");
+}
+
+TEST_F(RealtimeGuardTest, DefaultHandlerPrintsAStackTrace) {
+    RealtimeGuard::setViolationHandler(nullptr);
+    testing::internal::CaptureStderr();
+    {
+        RealtimeScope scope;
+        RealtimeGuard::check("SDL_Quit");
+    }
+    const std::string report = testing::internal::GetCapturedStderr();
+    EXPECT_NE(report.find("Real-time violation: SDL_Quit"), std::string::npos);
+#if defined(__GLIBC__) || defined(__APPLE__)
+    EXPECT_GT(std::count(report.begin(), report.end(), '\n'), 1);
+#endif
+}
+
+// The capture callback's work for each channel layout, as audioInputCallbackF32 does it, under a scope
+TEST_F(RealtimeGuardTest, CaptureCallbackPathNeverAllocatesOrLocks) {
+    PcmRingBuffer ring(Constants::PCM_RING_BUFFER_SAMPLES);
+    BeatTracker beats(RATE);
+    ChannelDownmixer downmixer;
+    ASSERT_TRUE(downmixer.configure(6));
+    const std::vector<float> mono = sinePeriods(200, 1);
+    const std::vector<float> stereoInput = sinePeriods(200, 2);
+    const std::vector<float> surround = sinePeriods(200, 6);
+    std::vector<float> drained(Constants::PCM_RING_BUFFER_SAMPLES);
+
+    for (int period = 0; period < 200; ++period) {
+        {
+            RealtimeScope scope;
+            float stereo[Constants::PCM_CONVERT_CHUNK_SAMPLES];
+            const float* in = mono.data() + static_cast<size_t>(period) * PERIOD_FRAMES;
+            for (int i = 0; i < PERIOD_FRAMES; ++i) {
+                stereo[2 * i] = in[i];
+                stereo[2 * i + 1] = in[i];
+            }
+            ring.write(stereo, PERIOD_FRAMES * 2);
+            beats.process(stereo, PERIOD_FRAMES);
+
+            const float* pair = stereoInput.data() + static_cast<size_t>(period) * PERIOD_FRAMES * 2;
+            ring.write(pair, PERIOD_FRAMES * 2);
+            beats.process(pair, PERIOD_FRAMES);
+
+            downmixer.process(surround.data() + static_cast<size_t>(period) * PERIOD_FRAMES * 6, PERIOD_FRAMES,
+                              stereo);
+            ring.write(stereo, PERIOD_FRAMES * 2);
+            beats.process(stereo, PERIOD_FRAMES);
+        }
+        // The render thread's side, outside the scope
+        ring.read(drained.data(), drained.size());
+        beats.getState();
+    }
+    EXPECT_EQ(g_reported.load(), 0) << "last: " << (g_lastCall.load() ? g_lastCall.load() : "");
+}
@@ -33,3 +33,17 @@ TEST(StringUtilsTest, StartsWithChecksPrefix) {
     EXPECT_FALSE(AutoVibez::Utils::StringUtils::startsWith("", "hello"));
     EXPECT_TRUE(AutoVibez::Utils::StringUtils::startsWith("hello", ""));
 }
+
+TEST(StringUtilsTest, EscapedFieldsRoundTrip) {
+    const std::string raw = "a\tb\nc\\d\re";
+    const std::string escaped = AutoVibez::Utils::StringUtils::escapeField(raw);
+    EXPECT_EQ(escaped.find('\t'), std::string::npos);
+    EXPECT_EQ(escaped.find('\n'), std::string::npos);
+    EXPECT_EQ(AutoVibez::Utils::StringUtils::unescapeField(escaped), raw);
+}
+
+TEST(StringUtilsTest, SplitFieldsKeepsEmptyFields) {
+    EXPECT_EQ(AutoVibez::Utils::StringUtils::splitFields("a\t\tb\t", '\t'),
+              (std::vector<std::string>{"a", "", "b", ""}));
+    EXPECT_EQ(AutoVibez::Utils::StringUtils::splitFields("", '\t'), (std::vector<std::string>{""}));
+}
@@ -124,4 +124,18 @@ TEST_F(SystemVolumeControllerTest, GetLastErrorReturnsErrorMessage) {
 
     std::string error = mockController->getLastError();
     EXPECT_EQ(error, "Audio system not available");
-}
\ No newline at end of file
+}
+
+TEST_F(SystemVolumeControllerTest, NativeControllerRejectsOutOfRangeLevels) {
+    auto controller = SystemVolumeControllerFactory::create();
+    if (!controller) {
+        GTEST_SKIP() << "No sound server or mixer here";
+    }
+
+    // Rejected before reaching the server, so the system volume is untouched
+    const int before = controller->getCurrentVolume();
+    EXPECT_FALSE(controller->setVolume(101));
+    EXPECT_FALSE(controller->getLastError().empty());
+    EXPECT_FALSE(controller->setVolume(-1));
+    EXPECT_EQ(controller->getCurrentVolume(), before);
+}
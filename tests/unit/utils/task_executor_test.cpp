@@ -0,0 +1,125 @@
+#include "utils/task_executor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using AutoVibez::Utils::TaskExecutor;
+using AutoVibez::Utils::TaskPriority;
+
+TEST(TaskExecutorTest, SubmitReturnsResultsAndExceptions) {
+    TaskExecutor executor(2);
+    std::future<int> value = executor.submit(TaskPriority::Interactive, []() { return 42; });
+    std::future<void> failing =
+        executor.submit(TaskPriority::Maintenance, []() { throw std::runtime_error("broken"); });
+    EXPECT_EQ(value.get(), 42);
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(TaskExecutorTest, ContinuationGetsTheResult) {
+    TaskExecutor executor(2);
+    std::promise<std::string> done;
+    executor.postThen(
+        TaskPriority::Prefetch, []() { return std::string("mix"); }, TaskPriority::Interactive,
+        [&done](std::string result) { done.set_value(result + " ready"); });
+    EXPECT_EQ(done.get_future().get(), "mix ready");
+}
+
+TEST(TaskExecutorTest, HigherPriorityRunsFirst) {
+    TaskExecutor executor(1);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    executor.post(TaskPriority::Interactive, [released]() { released.wait(); });
+
+    // Queued while the only worker is busy, lowest priority first
+    std::mutex mutex;
+    std::vector<int> order;
+    for (TaskPriority priority : {TaskPriority::Maintenance, TaskPriority::Ingest, TaskPriority::Prefetch,
+                                  TaskPriority::Interactive}) {
+        executor.post(priority, [&mutex, &order, priority]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(static_cast<int>(priority));
+        });
+    }
+    release.set_value();
+    executor.submit(TaskPriority::Maintenance, []() {}).wait();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(TaskExecutorTest, IdleWorkersStealFromABusyOne) {
+    TaskExecutor executor(2);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> ran{0};
+
+    // Every task lands on the worker running the producer; the other can only get them by stealing
+    executor.post(TaskPriority::Ingest, [&executor, &ran, released]() {
+        for (int i = 0; i < 16; ++i) {
+            executor.post(TaskPriority::Ingest, [&ran]() { ran.fetch_add(1); });
+        }
+        released.wait();
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ran.load() < 16 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    release.set_value();
+    EXPECT_EQ(ran.load(), 16);
+    EXPECT_GT(executor.getStealCount(), 0u);
+}
+
+TEST(TaskExecutorTest, DestructorRunsQueuedTasks) {
+    std::atomic<int> ran{0};
+    {
+        TaskExecutor executor(1);
+        for (int i = 0; i < 32; ++i) {
+            executor.post(TaskPriority::Maintenance, [&ran]() { ran.fetch_add(1); });
+        }
+    }
+    EXPECT_EQ(ran.load(), 32);
+}
+
+TEST(TaskExecutorTest, PoolSizeFollowsCoresNotTasks) {
+    TaskExecutor executor;
+    EXPECT_GE(executor.getWorkerCount(), 2u);
+    EXPECT_LE(executor.getWorkerCount(), std::max(2u, std::thread::hardware_concurrency()));
+}
+
+TEST(TaskExecutorTest, CancelledTasksAreSkipped) {
+    TaskExecutor executor(1);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    executor.post(TaskPriority::Interactive, [released]() { released.wait(); });
+
+    AutoVibez::Utils::CancellationToken token;
+    std::atomic<bool> ran{false};
+    executor.post(TaskPriority::Maintenance, [&ran]() { ran = true; }, token);
+    token.cancel();
+    release.set_value();
+    executor.submit(TaskPriority::Maintenance, []() {}).wait();
+    EXPECT_FALSE(ran.load());
+}
+
+TEST(TaskExecutorTest, CancelCutsASleepShort) {
+    AutoVibez::Utils::CancellationToken token;
+    AutoVibez::Utils::CancellationToken copy = token;
+    EXPECT_TRUE(token.sleepFor(std::chrono::milliseconds(1)));
+
+    std::thread canceller([copy]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        copy.cancel();
+    });
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_FALSE(token.sleepFor(std::chrono::seconds(30)));
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(5));
+    EXPECT_TRUE(token.isCancelled());
+    canceller.join();
+}
@@ -0,0 +1,88 @@
+#include "utils/trace_recorder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using AutoVibez::Utils::TraceRecorder;
+
+namespace {
+
+size_t countOf(const std::string& text, const std::string& needle) {
+    size_t found = 0;
+    for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + needle.size())) {
+        found++;
+    }
+    return found;
+}
+
+}  // namespace
+
+TEST(TraceRecorderTest, WritesBeginEndAndInstantEvents) {
+    TraceRecorder recorder;
+    recorder.setThreadName("render");
+    recorder.begin("startup", "setup");
+    recorder.instant("preset", "switch", recorder.intern("a \"quoted\" preset.milk"));
+    recorder.end("startup", "setup");
+    EXPECT_EQ(recorder.getEventCount(), 3u);
+
+    std::ostringstream out;
+    recorder.writeJson(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"B\""), 1u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"E\""), 1u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"i\""), 1u);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"render\"}"), std::string::npos);
+    EXPECT_NE(json.find("a \\\"quoted\\\" preset.milk"), std::string::npos);
+}
+
+TEST(TraceRecorderTest, GivesEachThreadItsOwnRow) {
+    TraceRecorder recorder;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&recorder]() {
+            for (int event = 0; event < 100; ++event) {
+                recorder.begin("db", "addMix");
+                recorder.end("db", "addMix");
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(recorder.getEventCount(), 800u);
+    EXPECT_EQ(recorder.getDroppedCount(), 0u);
+
+    std::ostringstream out;
+    recorder.writeJson(out);
+    for (int tid = 1; tid <= 4; ++tid) {
+        EXPECT_EQ(countOf(out.str(), "\"tid\":" + std::to_string(tid) + ","), 200u);
+    }
+}
+
+TEST(TraceRecorderTest, DropsAndCountsEventsPastTheBuffer) {
+    TraceRecorder recorder(4);
+    for (int i = 0; i < 10; ++i) {
+        recorder.instant("download", "chunk");
+    }
+    EXPECT_EQ(recorder.getEventCount(), 4u);
+    EXPECT_EQ(recorder.getDroppedCount(), 6u);
+}
+
+TEST(TraceRecorderTest, InternReturnsOneCopyPerString) {
+    TraceRecorder recorder;
+    const char* first = recorder.intern("mix-42");
+    EXPECT_EQ(recorder.intern(std::string("mix-") + "42"), first);
+    EXPECT_STREQ(first, "mix-42");
+}
+
+TEST(TraceRecorderTest, ReportsAFileThatCannotBeWritten) {
+    TraceRecorder recorder;
+    recorder.instant("app", "exit");
+    EXPECT_FALSE(recorder.writeJson(std::string("/nonexistent-dir/trace.json")));
+    EXPECT_FALSE(recorder.getLastError().empty());
+}
@@ -0,0 +1,227 @@
+#include "transfer_engine.hpp"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "local_http_server.hpp"
+
+using namespace AutoVibez::Utils;
+
+namespace {
+TransferRequest collectInto(const std::string& url, std::string& body) {
+    TransferRequest request;
+    request.url = url;
+    request.on_data = [&body](const char* data, size_t size) {
+        body.append(data, size);
+        return true;
+    };
+    return request;
+}
+}  // namespace
+
+class TransferEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "autovibez_transfer_engine_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::string writeFile(const std::string& name, size_t bytes) {
+        const std::filesystem::path path = dir / name;
+        std::ofstream file(path, std::ios::binary);
+        for (size_t i = 0; i < bytes; ++i) {
+            file.put(static_cast<char>('a' + i % 26));
+        }
+        return "file://" + path.string();
+    }
+
+    std::filesystem::path dir;
+};
+
+TEST_F(TransferEngineTest, PerformDeliversTheWholeBody) {
+    TransferEngine engine;
+    std::string body;
+    int64_t last_total = -1;
+    TransferRequest request = collectInto(writeFile("mix.bin", 300000), body);
+    request.on_progress = [&last_total](int64_t, int64_t total) {
+        last_total = total > 0 ? total : last_total;
+        return true;
+    };
+
+    const TransferResult result = engine.perform(request);
+    EXPECT_TRUE(result.ok) << result.error;
+    EXPECT_TRUE(result.error.empty());
+    EXPECT_EQ(body.size(), 300000u);
+    EXPECT_EQ(body.substr(0, 3), "abc");
+    EXPECT_EQ(last_total, 300000);
+    EXPECT_EQ(engine.getActiveCount(), 0u);
+}
+
+TEST_F(TransferEngineTest, RunsManyTransfersOnOneThread) {
+    TransferEngine engine;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::string> bodies(8);
+    size_t done = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const std::string url = writeFile("mix" + std::to_string(i) + ".bin", 10000 * (i + 1));
+        const uint64_t id = engine.start(collectInto(url, bodies[i]), [&](const TransferResult& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done++;
+            failed += result.ok ? 0 : 1;
+            finished.notify_one();
+        });
+        EXPECT_NE(id, 0u);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(finished.wait_for(lock, std::chrono::seconds(10), [&]() { return done == bodies.size(); }));
+    EXPECT_EQ(failed, 0u);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        EXPECT_EQ(bodies[i].size(), 10000 * (i + 1));
+    }
+}
+
+TEST_F(TransferEngineTest, ReusesTheConnectionForTheNextRequest) {
+    LocalHttpServer server;
+    TransferEngine engine;
+    for (int i = 0; i < 3; ++i) {
+        std::string body;
+        const TransferResult result = engine.perform(collectInto(server.url("/mix" + std::to_string(i)), body));
+        ASSERT_TRUE(result.ok) << result.error;
+        EXPECT_EQ(result.response_code, 200);
+        EXPECT_EQ(body, "hello");
+    }
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST_F(TransferEngineTest, ResumesFromAnOffsetWithTheRequestHeaders) {
+    LocalHttpServer server("0123456789");
+    TransferEngine engine;
+    std::string body;
+    std::string etag;
+    TransferRequest request = collectInto(server.url("/mix.mp3"), body);
+    request.resume_from = 4;
+    request.headers = {"If-Range: \"v1\""};
+    request.on_header = [&etag](const std::string& name, const std::string& value) {
+        if (name == "etag") {
+            etag = value;
+        }
+    };
+
+    const TransferResult result = engine.perform(request);
+    ASSERT_TRUE(result.ok) << result.error;
+    EXPECT_EQ(result.response_code, 206);
+    EXPECT_EQ(body, "456789");
+    EXPECT_EQ(etag, "\"v1\"");
+    EXPECT_NE(server.lastRequest().find("Range: bytes=4-"), std::string::npos);
+
+    // Changed on the server: the whole file comes back, which a resume must not append
+    body.clear();
+    server.setBody("abcdefghij", "\"v2\"");
+    const TransferResult changed = engine.perform(request);
+    EXPECT_FALSE(changed.ok);
+    EXPECT_EQ(changed.code, CURLE_RANGE_ERROR);
+}
+
+TEST_F(TransferEngineTest, GovernedTransfersShareTheCeilingUnlessUncapped) {
+    LocalHttpServer server(std::string(200000, 'x'));
+    TransferEngine engine;
+    auto governor = std::make_shared<BandwidthGovernor>();
+    governor->setCeiling(400000);  // The two together need about half a second at this ceiling
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t done = 0;
+    std::vector<std::string> bodies(2);
+
+    const auto started = std::chrono::steady_clock::now();
+    for (std::string& body : bodies) {
+        TransferRequest request = collectInto(server.url("/mix.mp3"), body);
+        request.governor = governor;
+        engine.start(request, [&](const TransferResult& result) {
+            EXPECT_TRUE(result.ok) << result.error;
+            std::lock_guard<std::mutex> lock(mutex);
+            done++;
+            finished.notify_one();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return done == bodies.size(); });
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(300));
+    EXPECT_EQ(bodies[0].size(), 200000u);
+    EXPECT_EQ(bodies[1].size(), 200000u);
+
+    // Let past the ceiling, e.g. the mix that is playing
+    governor->setCeiling(1000);
+    std::string body;
+    TransferRequest request = collectInto(server.url("/mix.mp3"), body);
+    request.governor = governor;
+    request.uncapped = [] { return true; };
+    const auto uncapped_start = std::chrono::steady_clock::now();
+    const TransferResult result = engine.perform(request);
+    ASSERT_TRUE(result.ok) << result.error;
+    EXPECT_EQ(body.size(), 200000u);
+    EXPECT_LT(std::chrono::steady_clock::now() - uncapped_start, std::chrono::seconds(5));
+}
+
+TEST_F(TransferEngineTest, FailuresAndAbortsReportAnError) {
+    TransferEngine engine;
+    std::string body;
+    const TransferResult missing = engine.perform(collectInto("file://" + (dir / "missing.bin").string(), body));
+    EXPECT_FALSE(missing.ok);
+    EXPECT_FALSE(missing.error.empty());
+
+    TransferRequest refused = collectInto(writeFile("mix.bin", 100000), body);
+    refused.on_data = [](const char*, size_t) { return false; };
+    const TransferResult aborted = engine.perform(refused);
+    EXPECT_FALSE(aborted.ok);
+    EXPECT_FALSE(aborted.error.empty());
+    EXPECT_FALSE(engine.cancel(12345));
+}
+
+TEST_F(TransferEngineTest, CancelAndShutdownEndTransfersThatNeverFinish) {
+    LocalHttpServer silent("", false);
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::string> errors;
+    auto record = [&](const TransferResult& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        errors.push_back(result.ok ? "" : result.error);
+        finished.notify_one();
+    };
+
+    std::string body;
+    {
+        TransferEngine engine;
+        const uint64_t cancelled = engine.start(collectInto(silent.url("/cancelled"), body), record);
+        engine.start(collectInto(silent.url("/in-flight"), body), record);
+        while (silent.connections() < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        EXPECT_TRUE(engine.cancel(cancelled));
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(finished.wait_for(lock, std::chrono::seconds(5), [&]() { return errors.size() == 1; }));
+        EXPECT_EQ(errors[0], "Transfer cancelled");
+        EXPECT_EQ(engine.getActiveCount(), 1u);
+    }
+    // The engine went away with one transfer in flight, which still completed
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_FALSE(errors[1].empty());
+}
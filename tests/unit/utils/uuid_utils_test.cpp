@@ -70,3 +70,34 @@ TEST(HashIdUtilsTest, HashBasedBehavior) {
     EXPECT_NE(id1, id3);
     EXPECT_NE(id2, id3);
 }
+
+TEST(HashIdUtilsTest, IdsAreTheSameOnEveryPlatform) {
+    // XXH64 of the empty string is ef46db3751d8e999; the version nibble replaces the second-last 'e'
+    EXPECT_EQ(AutoVibez::Utils::HashIdUtils::generateIdFromUrl(""), "ef46db37-51d8-5999-8434-9fc93c010000");
+    EXPECT_EQ(AutoVibez::Utils::HashIdUtils::generateIdFromUrl("https://example.com/mix1.mp3"),
+              "0608924a-101a-597a-af4b-29b1abaece74");
+}
+
+TEST(HashIdUtilsTest, TextAndBytesRoundTrip) {
+    using AutoVibez::Utils::HashId;
+    const HashId id = AutoVibez::Utils::HashIdUtils::hashUrl("https://example.com/mix1.mp3");
+    const std::string text = id.toString();
+    EXPECT_EQ(text, AutoVibez::Utils::HashIdUtils::generateIdFromUrl("https://example.com/mix1.mp3"));
+    EXPECT_EQ(id.view().size(), HashId::BYTE_LENGTH);
+
+    HashId parsed;
+    ASSERT_TRUE(HashId::parse(text, parsed));
+    EXPECT_EQ(parsed, id);
+}
+
+TEST(HashIdUtilsTest, ParseTakesOnlyTheFormItWrites) {
+    using AutoVibez::Utils::HashId;
+    HashId id;
+    EXPECT_FALSE(HashId::parse("", id));
+    EXPECT_FALSE(HashId::parse("mix-1", id));
+    EXPECT_FALSE(HashId::parse("0608924A-101A-597A-AF4B-29B1ABAECE74", id));  // Would not format back the same
+    EXPECT_FALSE(HashId::parse("0608924a101a597aaf4b29b1abaece74", id));
+    EXPECT_FALSE(HashId::parse("0608924a-101a-597a-af4b-29b1abaece7", id));
+    EXPECT_FALSE(HashId::parse("0608924a-101a-597a-af4b_29b1abaece74", id));
+    EXPECT_FALSE(HashId::parse("0608924a-101a-597a-af4b-29b1abaece7g", id));
+}